@@ -51,6 +51,17 @@ void TFE_OpReset(TFE_Op* op_to_reset, const char* op_or_function_name,
   }
 }
 
+void TFE_OpPrepare(TFE_Op* op, TF_Status* status) {
+  tensorflow::OperationFromInterface(tensorflow::unwrap(op))->Prepare();
+  status->status = ::tensorflow::OkStatus();
+}
+
+void TFE_OpSetInput(TFE_Op* op, int index, TFE_TensorHandle* input,
+                    TF_Status* status) {
+  status->status =
+      tensorflow::unwrap(op)->SetInput(index, tensorflow::unwrap(input));
+}
+
 void TFE_ContextEnableGraphCollection(TFE_Context* ctx) {
   tensorflow::unwrap(ctx)->SetShouldStoreGraphs(true);
 }
@@ -34,6 +34,19 @@ TF_CAPI_EXPORT extern void TFE_OpReset(TFE_Op* op_to_reset,
                                        const char* raw_device_name,
                                        TF_Status* status);
 
+// Prepares `op` for repeated execution. The attributes and device of a
+// prepared op must stay unchanged; only its inputs are replaced between
+// executions, with `TFE_OpSetInput`. The kernel resolved by its next execution
+// is kept with the op, so that later executions skip computing the kernel cache
+// key and the context's kernel cache lookup. `TFE_OpReset` drops the prepared
+// state.
+TF_CAPI_EXPORT extern void TFE_OpPrepare(TFE_Op* op, TF_Status* status);
+
+// Replaces the input at `index` of `op`, which must have been added before.
+TF_CAPI_EXPORT extern void TFE_OpSetInput(TFE_Op* op, int index,
+                                          TFE_TensorHandle* input,
+                                          TF_Status* status);
+
 // Enables only graph collection in RunMetadata on the functions executed from
 // this context.
 TF_CAPI_EXPORT extern void TFE_ContextEnableGraphCollection(TFE_Context* ctx);
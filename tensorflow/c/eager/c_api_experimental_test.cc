@@ -364,6 +364,89 @@ void Executor_MatMul_CPU(bool async) {
 TEST(CAPI, Executor_MatMul_CPU) { Executor_MatMul_CPU(false); }
 TEST(CAPI, Executor_MatMul_CPUAsync) { Executor_MatMul_CPU(true); }
 
+TEST(CAPI, PreparedOp_MatMul_CPU) {
+  TF_Status* status = TF_NewStatus();
+  TFE_ContextOptions* opts = TFE_NewContextOptions();
+  TFE_Context* ctx = TFE_NewContext(opts, status);
+  ASSERT_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  TFE_DeleteContextOptions(opts);
+
+  TFE_TensorHandle* m = TestMatrixTensorHandle(ctx);
+  float identity_data[] = {1.0f, 0.0f, 0.0f, 1.0f};
+  int64_t dims[] = {2, 2};
+  TFE_TensorHandle* identity =
+      TestMatrixTensorHandleWithInput(ctx, identity_data, dims, 2);
+  TFE_Op* matmul = MatMulOp(ctx, m, m);
+  TFE_OpPrepare(matmul, status);
+  ASSERT_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+
+  // The first execution resolves the kernel, the second one reuses it with a
+  // different right-hand side.
+  float expected[2][4] = {{7, 10, 15, 22}, {1, 2, 3, 4}};
+  for (int i = 0; i < 2; ++i) {
+    if (i == 1) {
+      TFE_OpSetInput(matmul, 1, identity, status);
+      ASSERT_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+    }
+    TFE_TensorHandle* retval = nullptr;
+    int num_retvals = 1;
+    TFE_Execute(matmul, &retval, &num_retvals, status);
+    ASSERT_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+    ASSERT_EQ(1, num_retvals);
+    TF_Tensor* t = TFE_TensorHandleResolve(retval, status);
+    ASSERT_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+    TFE_DeleteTensorHandle(retval);
+    float product[4] = {0};
+    ASSERT_EQ(sizeof(product), TF_TensorByteSize(t));
+    memcpy(&product[0], TF_TensorData(t), TF_TensorByteSize(t));
+    TF_DeleteTensor(t);
+    for (int j = 0; j < 4; ++j) {
+      EXPECT_EQ(expected[i][j], product[j]);
+    }
+  }
+
+  // Setting an input that was never added fails.
+  TFE_OpSetInput(matmul, 2, identity, status);
+  EXPECT_EQ(TF_INVALID_ARGUMENT, TF_GetCode(status));
+
+  TFE_DeleteOp(matmul);
+  TFE_DeleteTensorHandle(identity);
+  TFE_DeleteTensorHandle(m);
+  TFE_DeleteContext(ctx);
+  TF_DeleteStatus(status);
+}
+
+void BM_ExecutePrepared(::testing::benchmark::State& state) {
+  const int prepared = state.range(0);
+  state.SetLabel(prepared ? "ExecutePrepared" : "Execute");
+  TF_Status* status = TF_NewStatus();
+  TFE_ContextOptions* opts = TFE_NewContextOptions();
+  TFE_Context* ctx = TFE_NewContext(opts, status);
+  CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  TFE_DeleteContextOptions(opts);
+
+  TFE_TensorHandle* m = TestMatrixTensorHandle(ctx);
+  TFE_Op* matmul = MatMulOp(ctx, m, m);
+  if (prepared) {
+    TFE_OpPrepare(matmul, status);
+    CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  }
+  TFE_TensorHandle* retvals[1];
+  int num_retvals = 1;
+  for (auto s : state) {
+    TFE_OpSetInput(matmul, 0, m, status);
+    CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+    TFE_Execute(matmul, &retvals[0], &num_retvals, status);
+    CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+    TFE_DeleteTensorHandle(retvals[0]);
+  }
+  TFE_DeleteOp(matmul);
+  TFE_DeleteTensorHandle(m);
+  TFE_DeleteContext(ctx);
+  TF_DeleteStatus(status);
+}
+BENCHMARK(BM_ExecutePrepared)->Arg(0)->Arg(1);
+
 void Deleter(void* data, size_t unused, void* tensor_handle) {
   TFE_DeleteTensorHandle(static_cast<TFE_TensorHandle*>(tensor_handle));
 }
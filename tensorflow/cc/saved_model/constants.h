@@ -33,6 +33,10 @@ constexpr char kSavedModelLegacyInitOpKey[] = "legacy_init_op";
 /// SavedModel main op collection key. Used in v1 SavedModels.
 constexpr char kSavedModelMainOpKey[] = "saved_model_main_op";
 
+/// Collection key of the table initializer ops, i.e.
+/// tf.compat.v1.GraphKeys.TABLE_INITIALIZERS. Used in v1 SavedModels.
+constexpr char kSavedModelTableInitializersKey[] = "table_initializer";
+
 // CollectionDef key for the SavedModel train op.
 // Not exported while export_all_saved_models is experimental.
 constexpr char kSavedModelTrainOpKey[] = "saved_model_train_op";
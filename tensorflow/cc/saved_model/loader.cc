@@ -41,6 +41,7 @@ limitations under the License.
 #include "tensorflow/core/protobuf/saver.pb.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
 
 namespace tensorflow {
@@ -221,6 +222,36 @@ Status RunInitOp(const RunOptions& run_options, const string& export_dir,
   return OkStatus();
 }
 
+// Runs the table initializers in `table_initializer_names`, which must not
+// depend on any variable, so that they can run concurrently with RunRestore.
+// The init op may later run them again, which is a no-op for initialized
+// tables.
+Status RunTableInitializers(
+    const RunOptions& run_options, const string& export_dir,
+    const std::vector<AssetFileDef>& asset_file_defs, Session* session,
+    const std::vector<string>& table_initializer_names) {
+  LOG(INFO) << "Running " << table_initializer_names.size()
+            << " table initializers on SavedModel bundle at path: "
+            << export_dir;
+  std::vector<std::pair<string, Tensor>> inputs;
+  AddAssetsTensorsToInputs(export_dir, asset_file_defs, &inputs);
+  RunMetadata run_metadata;
+  return RunOnce(run_options, inputs, {}, table_initializer_names,
+                 nullptr /* outputs */, &run_metadata, session);
+}
+
+// Returns true if table initializers can run concurrently with the restore.
+// Set TF_SAVED_MODEL_PARALLEL_TABLE_INIT=false to run them with the init op.
+bool IsParallelTableInitEnabled() {
+  static const bool enabled = []() {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_SAVED_MODEL_PARALLEL_TABLE_INIT",
+                                   /*default_val=*/true, &enabled));
+    return enabled;
+  }();
+  return enabled;
+}
+
 Status RunRestore(const RunOptions& run_options, const string& export_dir,
                   const StringPiece restore_op_name,
                   const StringPiece variable_filename_const_op_name,
@@ -432,12 +463,35 @@ Status RestoreSession(const RunOptions& run_options,
   const uint64 read_start_microseconds = Env::Default()->NowMicros();
   std::vector<AssetFileDef> asset_file_defs;
   TF_RETURN_IF_ERROR(internal::GetAssetFileDefs(meta_graph, &asset_file_defs));
+
+  // Table initializers that do not depend on variables, e.g. the ones reading
+  // vocabularies from asset files, run concurrently with the restore.
+  std::vector<string> table_initializer_names;
+  if (meta_graph.has_saver_def() && IsParallelTableInitEnabled()) {
+    TF_RETURN_IF_ERROR(internal::GetIndependentTableInitializers(
+        meta_graph, &table_initializer_names));
+  }
+  Status table_init_status;
+  // Declared after everything the thread uses, so that it is joined first
+  // when returning early.
+  std::unique_ptr<Thread> table_init_thread;
+  if (!table_initializer_names.empty()) {
+    table_init_thread.reset(Env::Default()->StartThread(
+        ThreadOptions(), "saved_model_table_init", [&]() {
+          table_init_status = RunTableInitializers(
+              run_options, export_dir, asset_file_defs, session->get(),
+              table_initializer_names);
+        }));
+  }
+
   if (meta_graph.has_saver_def()) {
     TF_RETURN_IF_ERROR(RunRestore(run_options, export_dir,
                                   meta_graph.saver_def().restore_op_name(),
                                   meta_graph.saver_def().filename_tensor_name(),
                                   asset_file_defs, session->get()));
   }
+  table_init_thread.reset();
+  TF_RETURN_IF_ERROR(table_init_status);
   // Record walltime spent in restoring graph from disk, but postpone metric
   // increments until graph init finishes.
   const uint64 restore_graph_walltime =
@@ -15,11 +15,16 @@ limitations under the License.
 
 #include "tensorflow/cc/saved_model/loader_util.h"
 
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "tensorflow/cc/saved_model/constants.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/hash.h"
 #include "tensorflow/core/platform/protobuf_internal.h"
 
 namespace tensorflow {
@@ -91,5 +96,67 @@ Status GetAssetFileDefs(const MetaGraphDef& meta_graph_def,
   return OkStatus();
 }
 
+namespace {
+
+// Returns the name of the node producing `input`, e.g. "foo" for "^foo" and
+// "foo:1".
+StringPiece InputNodeName(StringPiece input) {
+  str_util::ConsumePrefix(&input, "^");
+  const size_t colon = input.find(':');
+  return colon == StringPiece::npos ? input : input.substr(0, colon);
+}
+
+bool IsVariableOp(const NodeDef& node) {
+  static const auto* const kVariableOps = new std::unordered_set<string>(
+      {"Variable", "VariableV2", "TemporaryVariable", "VarHandleOp",
+       "_VarHandlesOp"});
+  return kVariableOps->count(node.op()) > 0;
+}
+
+}  // namespace
+
+Status GetIndependentTableInitializers(
+    const MetaGraphDef& meta_graph_def,
+    std::vector<string>* table_initializer_names) {
+  const auto& collection_def_map = meta_graph_def.collection_def();
+  const auto it = collection_def_map.find(kSavedModelTableInitializersKey);
+  if (it == collection_def_map.end()) {
+    return OkStatus();
+  }
+
+  std::unordered_map<StringPiece, const NodeDef*, StringPieceHasher> nodes;
+  for (const auto& node : meta_graph_def.graph_def().node()) {
+    nodes[node.name()] = &node;
+  }
+
+  for (const string& name : it->second.node_list().value()) {
+    const StringPiece node_name = InputNodeName(name);
+    // Leave initializers that cannot be analyzed to the init op.
+    if (nodes.find(node_name) == nodes.end()) continue;
+
+    bool depends_on_variable = false;
+    std::unordered_set<StringPiece, StringPieceHasher> visited = {node_name};
+    std::vector<StringPiece> stack = {node_name};
+    while (!stack.empty()) {
+      const auto node_it = nodes.find(stack.back());
+      stack.pop_back();
+      if (node_it == nodes.end()) continue;
+      const NodeDef& node = *node_it->second;
+      if (IsVariableOp(node)) {
+        depends_on_variable = true;
+        break;
+      }
+      for (const auto& input : node.input()) {
+        const StringPiece input_name = InputNodeName(input);
+        if (visited.insert(input_name).second) stack.push_back(input_name);
+      }
+    }
+    if (!depends_on_variable) {
+      table_initializer_names->push_back(string(node_name));
+    }
+  }
+  return OkStatus();
+}
+
 }  // namespace internal
 }  // namespace tensorflow
@@ -33,6 +33,13 @@ Status GetInitOp(const string& export_dir, const MetaGraphDef& meta_graph_def,
 Status GetAssetFileDefs(const MetaGraphDef& meta_graph_def,
                         std::vector<AssetFileDef>* asset_file_defs);
 
+// Returns the ops in the v1 table initializer collection that do not depend,
+// even transitively, on any variable. These can run concurrently with the
+// variable restore, ahead of the init op.
+Status GetIndependentTableInitializers(
+    const MetaGraphDef& meta_graph_def,
+    std::vector<string>* table_initializer_names);
+
 }  // namespace internal
 }  // namespace tensorflow
 
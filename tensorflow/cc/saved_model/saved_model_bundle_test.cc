@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/cc/saved_model/constants.h"
 #include "tensorflow/cc/saved_model/loader.h"
+#include "tensorflow/cc/saved_model/loader_util.h"
 #include "tensorflow/cc/saved_model/metrics.h"
 #include "tensorflow/cc/saved_model/reader.h"
 #include "tensorflow/cc/saved_model/signature_constants.h"
@@ -26,6 +27,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 
@@ -348,6 +350,44 @@ TEST_F(LoaderTest, BadNodeAttr) {
       std::string::npos);
 }
 
+TEST_F(LoaderTest, IndependentTableInitializers) {
+  MetaGraphDef meta_graph_def;
+  ASSERT_TRUE(protobuf::TextFormat::ParseFromString(
+      R"pb(
+        graph_def {
+          node { name: "vocab_file" op: "Placeholder" }
+          node { name: "table" op: "HashTableV2" }
+          node {
+            name: "table_init"
+            op: "InitializeTableFromTextFileV2"
+            input: [ "table", "vocab_file" ]
+          }
+          node { name: "var" op: "VarHandleOp" }
+          node { name: "keys" op: "ReadVariableOp" input: "var" }
+          node { name: "other_table" op: "HashTableV2" }
+          node {
+            name: "other_table_init"
+            op: "LookupTableImportV2"
+            input: [ "other_table", "keys:0", "^vocab_file" ]
+          }
+        }
+        collection_def {
+          key: "table_initializer"
+          value {
+            node_list {
+              value: [ "table_init", "other_table_init", "missing_init" ]
+            }
+          }
+        }
+      )pb",
+      &meta_graph_def));
+
+  std::vector<string> table_initializer_names;
+  TF_ASSERT_OK(internal::GetIndependentTableInitializers(
+      meta_graph_def, &table_initializer_names));
+  EXPECT_EQ(table_initializer_names, std::vector<string>({"table_init"}));
+}
+
 TEST_F(LoaderTest, UpdateMetricsV2) {
   SavedModelBundle bundle;
   SessionOptions session_options;
@@ -214,6 +214,8 @@ void AllocateAndParseFlags() {
   ops_flags = new XlaOpsCommonFlags;
   ops_flags->tf_xla_always_defer_compilation = false;
   ops_flags->tf_xla_async_compilation = false;
+  ops_flags->tf_xla_launch_async_compilation = false;
+  ops_flags->tf_xla_shape_buckets = "";
 
   jitter_flags = new IntroduceFloatingPointJitterPassFlags;
   jitter_flags->jitter_amount = 1e-5;
@@ -274,6 +276,16 @@ void AllocateAndParseFlags() {
             "When lazy compilation is enabled, asynchronous compilation starts "
             "the cluster compilation in the background, and the fallback path "
             "is executed until the compilation has finished."),
+       Flag("tf_xla_launch_async_compilation",
+            &ops_flags->tf_xla_launch_async_compilation,
+            "Compiles _XlaLaunch clusters asynchronously on a compilation "
+            "cache miss, running the cluster's function with the regular TF "
+            "executor until the compilation has finished."),
+       Flag("tf_xla_shape_buckets", &ops_flags->tf_xla_shape_buckets,
+            "Pads the leading dimension of XLA cluster arguments up to a "
+            "bucket so that differently sized inputs share executables. "
+            "Either \"pow2\" or a comma-separated list of bucket sizes; "
+            "empty disables bucketing."),
 
        Flag("tf_introduce_floating_point_jitter_to_tensors",
             setter_for_jitter_tensor_names, "",
@@ -122,6 +122,17 @@ struct XlaOpsCommonFlags {
   // If true, _XlaCompile compiles the cluster asynchronously with respect to
   // the main execution. The fallback path is taken while compilation happens.
   bool tf_xla_async_compilation;
+  // If true, _XlaLaunch kernels (including the ones created for functions
+  // marked for XLA compilation) compile asynchronously on a cache miss and run
+  // the function with the regular TF executor until compilation has finished.
+  bool tf_xla_launch_async_compilation;
+  // If non-empty, the leading dimension of every XLA cluster argument is padded
+  // up to a bucket and passed as a bounded dynamic dimension, so that inputs
+  // whose leading dimension falls into the same bucket share one executable.
+  // Either "pow2" (round up to the next power of two) or a comma-separated
+  // increasing list of bucket sizes; sizes above the largest bucket are not
+  // padded.
+  std::string tf_xla_shape_buckets;
 };
 
 // Flags for the build_xla_ops pass.
@@ -16,7 +16,10 @@ limitations under the License.
 #include "tensorflow/compiler/jit/kernels/xla_ops.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/algorithm/container.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
 #include "absl/synchronization/notification.h"
 #include "absl/types/optional.h"
 #include "tensorflow/compiler/jit/defs.h"
@@ -45,6 +48,7 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/bits.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
@@ -219,6 +223,62 @@ XlaLocalLaunchBase::XlaLocalLaunchBase(OpKernelConstruction* ctx,
       platform_info_(XlaPlatformInfoFromDevice(ctx->device())),
       has_ref_vars_(has_ref_vars) {}
 
+// Parses --tf_xla_shape_buckets into an increasing list of bucket sizes. An
+// empty list with `*pow2` set means every size rounds up to a power of two.
+static Status ParseShapeBuckets(absl::string_view spec, bool* pow2,
+                                std::vector<int64_t>* buckets) {
+  *pow2 = spec == "pow2";
+  if (*pow2) return OkStatus();
+  for (absl::string_view piece : absl::StrSplit(spec, ',', absl::SkipEmpty())) {
+    int64_t bucket;
+    if (!absl::SimpleAtoi(piece, &bucket) || bucket <= 0 ||
+        (!buckets->empty() && bucket <= buckets->back())) {
+      return errors::InvalidArgument(
+          "--tf_xla_shape_buckets must be \"pow2\" or an increasing list of "
+          "positive sizes, got: ",
+          spec);
+    }
+    buckets->push_back(bucket);
+  }
+  return OkStatus();
+}
+
+// Replaces the shape of every array parameter in `args` with one whose leading
+// dimension is bounded by the bucket it falls into, so that all inputs in the
+// same bucket map to the same compilation cache signature. The runtime pads the
+// buffers of those arguments (see XlaComputationLaunchContext::PopulateInputs)
+// and XLA reads the real size from the dynamic dimension.
+static Status PadArgumentsToShapeBuckets(
+    absl::Span<XlaCompiler::Argument> args) {
+  bool pow2;
+  std::vector<int64_t> buckets;
+  TF_RETURN_IF_ERROR(ParseShapeBuckets(
+      GetXlaOpsCommonFlags().tf_xla_shape_buckets, &pow2, &buckets));
+  for (XlaCompiler::Argument& arg : args) {
+    if (arg.kind != XlaCompiler::Argument::kParameter ||
+        !absl::holds_alternative<TensorShape>(arg.shape)) {
+      continue;
+    }
+    const TensorShape& shape = absl::get<TensorShape>(arg.shape);
+    if (shape.dims() == 0) continue;
+    const int64_t size = shape.dim_size(0);
+    int64_t bucket = size;
+    if (pow2) {
+      bucket = int64_t{1} << tensorflow::Log2Ceiling64(size);
+    } else {
+      auto it = absl::c_lower_bound(buckets, size);
+      if (it == buckets.end()) continue;
+      bucket = *it;
+    }
+    xla::Shape xla_shape;
+    TF_RETURN_IF_ERROR(TensorShapeToXLAShape(arg.type, shape, &xla_shape));
+    xla_shape.set_dimensions(0, bucket);
+    xla_shape.set_dynamic_dimension(0, true);
+    arg.shape = std::move(xla_shape);
+  }
+  return OkStatus();
+}
+
 static Status CompileToLocalExecutable(
     OpKernelContext* ctx, const NameAttrList& function, bool has_ref_vars,
     const XlaPlatformInfo& platform_info,
@@ -267,6 +327,9 @@ static Status CompileToLocalExecutable(
           constants, inputs, variable_infos,
           static_cast<Device*>(ctx->device()));
   TF_RETURN_IF_ERROR(args.status());
+  if (!GetXlaOpsCommonFlags().tf_xla_shape_buckets.empty()) {
+    TF_RETURN_IF_ERROR(PadArgumentsToShapeBuckets(absl::MakeSpan(*args)));
+  }
   return cache->Compile(options, function, *args, compile_options, compile_mode,
                         compilation_result, executable);
 }
@@ -280,7 +343,21 @@ void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
   std::vector<const Tensor*> inputs = InputsFromContext(ctx);
   xla::LocalClient* client;
   const XlaCompiler::CompilationResult* compilation_result;
-  xla::LocalExecutable* executable;
+  xla::LocalExecutable* executable = nullptr;
+  // The fallback passes the inputs on to a function call, which cannot take
+  // reference-typed inputs.
+  const bool has_ref_inputs = [&] {
+    for (int i = 0; i < ctx->num_inputs(); ++i) {
+      if (IsRefType(ctx->input_dtype(i))) {
+        return true;
+      }
+    }
+    return false;
+  }();
+  const XlaCompilationCache::CompileMode compile_mode =
+      GetXlaOpsCommonFlags().tf_xla_launch_async_compilation && !has_ref_inputs
+          ? XlaCompilationCache::CompileMode::kAsync
+          : XlaCompilationCache::CompileMode::kStrict;
 
   std::vector<VariableInfo> variable_infos;
   {
@@ -290,12 +367,22 @@ void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
     OP_REQUIRES_OK(ctx, LockVariables(absl::MakeSpan(variable_infos)));
     Status s = CompileToLocalExecutable(
         ctx, function_, /*has_ref_vars=*/has_ref_vars_, platform_info_, inputs,
-        variable_infos, constants_, XlaCompilationCache::CompileMode::kStrict,
+        variable_infos, constants_, compile_mode,
         /*may_alias_resource_update=*/true, &client, &compilation_result,
         &executable);
     OP_REQUIRES_OK(ctx, s);
   }
 
+  // Async compilation returns nullptr executable without an error while the
+  // cluster is still being compiled.
+  if (executable == nullptr) {
+    DCHECK(compile_mode == XlaCompilationCache::CompileMode::kAsync);
+    // The function locks the variables it accesses itself.
+    variable_infos.clear();
+    OP_REQUIRES_OK(ctx, RunFallback(ctx));
+    return;
+  }
+
   std::map<int, const Tensor*> resource_var_ptrs;
   for (int i = 0; i < resources_.size(); i++) {
     resource_var_ptrs[resources_[i]] = variable_infos[i].var()->tensor();
@@ -346,6 +433,50 @@ void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
   VLOG(1) << "Done";
 }
 
+Status XlaLocalLaunchBase::RunFallback(OpKernelContext* ctx) {
+  FunctionLibraryRuntime* flr = ctx->function_library();
+  if (flr == nullptr) {
+    return errors::Internal("No function library to run ", function_.name(),
+                            " while it is being compiled");
+  }
+  FunctionLibraryRuntime::Handle handle;
+  {
+    mutex_lock lock(fallback_mu_);
+    if (fallback_handle_ == kInvalidHandle) {
+      TF_RETURN_IF_ERROR(flr->Instantiate(
+          function_.name(), AttrSlice(&function_.attr()), &fallback_handle_));
+    }
+    handle = fallback_handle_;
+  }
+  VLOG(2) << "Running " << function_.name()
+          << " with the TF executor while it is being compiled";
+
+  FunctionLibraryRuntime::Options opts(ctx->step_id());
+  opts.rendezvous = ctx->rendezvous();
+  opts.cancellation_manager = ctx->cancellation_manager();
+  opts.collective_executor = ctx->collective_executor();
+  opts.runner = ctx->runner();
+  opts.run_all_kernels_inline = ctx->run_all_kernels_inline();
+  opts.step_container = ctx->step_container();
+
+  std::vector<Tensor> args;
+  args.reserve(ctx->num_inputs());
+  for (int i = 0; i < ctx->num_inputs(); ++i) {
+    args.push_back(ctx->input(i));
+  }
+  std::vector<Tensor> rets;
+  TF_RETURN_IF_ERROR(flr->RunSync(std::move(opts), handle, args, &rets));
+  if (rets.size() != ctx->num_outputs()) {
+    return errors::Internal("Function ", function_.name(), " returned ",
+                            rets.size(), " values, expected ",
+                            ctx->num_outputs());
+  }
+  for (int i = 0; i < rets.size(); ++i) {
+    ctx->set_output(i, std::move(rets[i]));
+  }
+  return OkStatus();
+}
+
 namespace {
 // Helper static functions to construct parameters for
 // XlaLocalLaunchBase constructor from OpKernelConstruction.
@@ -23,10 +23,12 @@ limitations under the License.
 #include "tensorflow/compiler/jit/xla_launch_util.h"
 #include "tensorflow/compiler/jit/xla_platform_info.h"
 #include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/util/stream_executor_util.h"
 #include "tensorflow/stream_executor/tf_allocator_adapter.h"
 
@@ -66,6 +68,15 @@ class XlaLocalLaunchBase : public OpKernel {
   const XlaPlatformInfo platform_info_;
 
   bool has_ref_vars_;
+
+ private:
+  // Runs `function_` with the regular TF executor. Used while the cluster is
+  // compiled in the background, see `tf_xla_launch_async_compilation`.
+  Status RunFallback(OpKernelContext* ctx);
+
+  mutex fallback_mu_;
+  FunctionLibraryRuntime::Handle fallback_handle_
+      TF_GUARDED_BY(fallback_mu_) = kInvalidHandle;
 };
 
 // XlaLocalLaunchOp is used to replace a region of the TensorFlow graph
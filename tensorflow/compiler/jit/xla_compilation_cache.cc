@@ -42,6 +42,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/protobuf_util.h"
 #include "tensorflow/compiler/xla/service/compiler.h"
 #include "tensorflow/compiler/xla/service/hlo.pb.h"
+#include "tensorflow/compiler/xla/shape_util.h"
 #include "tensorflow/compiler/xla/status_macros.h"
 #include "tensorflow/compiler/xla/util.h"
 #include "tensorflow/core/common_runtime/device.h"
@@ -136,11 +137,39 @@ struct SignatureHashCombiner {
 };
 
 std::string XlaSerializedCacheKeyToString(const XlaSerializedCacheKey& key) {
+  // The compilation environment is folded into a single fingerprint, since the
+  // device kind and version are not necessarily valid in a file name.
+  uint64 environment_fingerprint = key.compile_options_fingerprint();
+  environment_fingerprint =
+      Hash64Combine(environment_fingerprint, Fingerprint64(key.device_kind()));
+  environment_fingerprint = Hash64Combine(
+      environment_fingerprint, Fingerprint64(key.compiler_version()));
   return absl::StrCat(
       key.prefix(), key.prefix().empty() ? "" : kXlaSerializedCacheKeySeparator,
       key.signature_fingerprint(), kXlaSerializedCacheKeySeparator,
       key.cluster_fingerprint(), kXlaSerializedCacheKeySeparator,
-      key.device_type());
+      key.device_type(), kXlaSerializedCacheKeySeparator,
+      environment_fingerprint);
+}
+
+// Returns a fingerprint of the options that influence the executable produced
+// for a given HLO module.
+uint64 BuildOptionsFingerprint(
+    const xla::ExecutableBuildOptions& build_options) {
+  uint64 fingerprint = build_options.has_debug_options()
+                           ? DeterministicProtoHash64(
+                                 build_options.debug_options())
+                           : 0;
+  fingerprint = Hash64Combine(fingerprint, build_options.num_replicas());
+  fingerprint = Hash64Combine(fingerprint, build_options.num_partitions());
+  fingerprint =
+      Hash64Combine(fingerprint, build_options.alias_passthrough_params());
+  if (build_options.result_layout() != nullptr) {
+    fingerprint = Hash64Combine(
+        fingerprint, Fingerprint64(xla::ShapeUtil::HumanStringWithLayout(
+                         *build_options.result_layout())));
+  }
+  return fingerprint;
 }
 
 }  // namespace
@@ -521,7 +550,10 @@ Status XlaCompilationCache::CompileStrict(
     const xla::HloModuleProto& hlo_module =
         entry->compilation_result.computation->proto();
 
-    XlaSerializedCacheKey cache_key = BuildSerializedCacheKey(sig, hlo_module);
+    XlaSerializedCacheKey cache_key = BuildSerializedCacheKey(
+        sig, hlo_module,
+        GetBuildOptions(options, entry->compilation_result,
+                        client_->default_device_ordinal()));
 
     {
       XLA_SCOPED_LOGGING_TIMER(absl::StrCat(
@@ -554,7 +586,14 @@ Status XlaCompilationCache::CompileStrict(
           "Serializing and saving cache entry: ", sig.HumanString()));
       TF_ASSIGN_OR_RETURN(XlaSerializedCacheEntry serialized_entry,
                           SerializeEntry(options, sig, *entry));
-      TF_RETURN_IF_ERROR(SaveSerializedEntry(std::move(serialized_entry)));
+      // The cache may be shared with other processes and live on a remote
+      // file system; failing to publish an entry only costs a later
+      // recompilation.
+      Status save_status = SaveSerializedEntry(std::move(serialized_entry));
+      if (!save_status.ok()) {
+        LOG(WARNING) << "Failed to save persistent XLA cache entry for "
+                     << sig.HumanString() << ": " << save_status;
+      }
     }
   }
 
@@ -827,13 +866,23 @@ Status XlaCompilationCache::CompileImpl(
 }
 
 XlaSerializedCacheKey XlaCompilationCache::BuildSerializedCacheKey(
-    const Signature& sig, const xla::HloModuleProto& hlo_module) const {
+    const Signature& sig, const xla::HloModuleProto& hlo_module,
+    const xla::ExecutableBuildOptions& build_options) const {
   XlaSerializedCacheKey serialized_cache_key;
   serialized_cache_key.set_signature_fingerprint(Signature::Hash()(sig));
   serialized_cache_key.set_cluster_fingerprint(
       DeterministicProtoHash64(hlo_module));
   serialized_cache_key.set_device_type(device_type_.type_string());
   serialized_cache_key.set_prefix(persistance_prefix_);
+  serialized_cache_key.set_compile_options_fingerprint(
+      BuildOptionsFingerprint(build_options));
+  serialized_cache_key.set_device_kind(absl::StrCat(
+      client_->platform()->Name(), ":",
+      client_->backend()
+          .default_stream_executor()
+          ->GetDeviceDescription()
+          .name()));
+  serialized_cache_key.set_compiler_version(TF_VERSION_STRING);
   return serialized_cache_key;
 }
 
@@ -888,7 +937,10 @@ StatusOr<XlaSerializedCacheEntry> XlaCompilationCache::SerializeEntry(
   XlaSerializedCacheEntry serialized_entry;
   const xla::HloModuleProto& hlo_module =
       entry.compilation_result.computation->proto();
-  *serialized_entry.mutable_key() = BuildSerializedCacheKey(sig, hlo_module);
+  *serialized_entry.mutable_key() = BuildSerializedCacheKey(
+      sig, hlo_module,
+      GetBuildOptions(options, entry.compilation_result,
+                      client_->default_device_ordinal()));
   *serialized_entry.mutable_hlo_module() = hlo_module;
 
   TF_ASSIGN_OR_RETURN(
@@ -916,7 +968,26 @@ Status XlaCompilationCache::SaveSerializedEntry(
   TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(persistent_cache_directory_));
   const std::string file_path =
       GetFilePath(entry.key(), persistent_cache_directory_);
-  return WriteBinaryProto(env, file_path, entry);
+  if (env->FileExists(file_path).ok()) {
+    VLOG(1) << "Persistent XLA cache entry already exists: " << file_path;
+    return OkStatus();
+  }
+
+  // Publish the entry atomically: readers either see no file or a complete
+  // one, even when several processes race to save the same entry.
+  std::string temp_path = file_path;
+  if (!env->CreateUniqueFileName(&temp_path, ".tmp")) {
+    return errors::Internal("Failed to create a temporary file name for ",
+                            file_path);
+  }
+  Status status = WriteBinaryProto(env, temp_path, entry);
+  if (status.ok()) {
+    status = env->RenameFile(temp_path, file_path);
+  }
+  if (!status.ok()) {
+    env->DeleteFile(temp_path).IgnoreError();
+  }
+  return status;
 }
 
 StatusOr<std::optional<XlaSerializedCacheEntry>>
@@ -928,7 +999,12 @@ XlaCompilationCache::TryLoadSerializedEntry(const XlaSerializedCacheKey& key) {
   }
 
   XlaSerializedCacheEntry entry;
-  TF_RETURN_IF_ERROR(ReadTextOrBinaryProto(env, file_path, &entry));
+  Status status = ReadTextOrBinaryProto(env, file_path, &entry);
+  if (!status.ok()) {
+    LOG(WARNING) << "Ignoring unreadable persistent XLA cache entry "
+                 << file_path << ": " << status;
+    return StatusOr<std::optional<XlaSerializedCacheEntry>>(std::nullopt);
+  }
   return StatusOr<std::optional<XlaSerializedCacheEntry>>(entry);
 }
 
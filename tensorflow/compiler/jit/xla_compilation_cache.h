@@ -225,7 +225,8 @@ class XlaCompilationCache : public ResourceBase {
   // Returns a cache key proto that identifies an entry in the compilation
   // cache.
   XlaSerializedCacheKey BuildSerializedCacheKey(
-      const Signature& sig, const xla::HloModuleProto& hlo_module) const;
+      const Signature& sig, const xla::HloModuleProto& hlo_module,
+      const xla::ExecutableBuildOptions& build_options) const;
 
   // Serializes the signature and its corresponding entry to a proto message.
   StatusOr<XlaSerializedCacheEntry> SerializeEntry(
@@ -252,12 +253,16 @@ class XlaCompilationCache : public ResourceBase {
                              CompileScope scope);
 
   // Saves the cache entry in the file directory supplied during the
-  // construction of this class. Overwrites existing entries.
+  // construction of this class. The entry is written to a temporary file which
+  // is then renamed into place, so that processes sharing the directory never
+  // observe a partially written entry. Existing entries are left untouched:
+  // entries are content-addressed, so an existing file already holds the same
+  // executable.
   Status SaveSerializedEntry(const XlaSerializedCacheEntry& entry);
 
   // Tries to load a cache entry given a `key` by searching the file directory
   // supplied during the construction of this class. Returns std::nullopt if no
-  // cache entry is found.
+  // cache entry is found, or if the file found cannot be parsed.
   StatusOr<std::optional<XlaSerializedCacheEntry>> TryLoadSerializedEntry(
       const XlaSerializedCacheKey& key);
 
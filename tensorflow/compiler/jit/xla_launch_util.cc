@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/compiler/jit/xla_launch_util.h"
 
+#include <cstring>
 #include <memory>
 
 #include "absl/algorithm/container.h"
@@ -25,6 +26,7 @@ limitations under the License.
 #include "tensorflow/compiler/tf2xla/xla_compiler.h"
 #include "tensorflow/compiler/xla/client/client_library.h"
 #include "tensorflow/compiler/xla/client/local_client.h"
+#include "tensorflow/compiler/xla/layout_util.h"
 #include "tensorflow/compiler/xla/shape_util.h"
 #include "tensorflow/compiler/xla/statusor.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
@@ -243,6 +245,56 @@ static void PopulateExecutionInputBuffer(xla::ExecutionInput& execution_input,
   }
 }
 
+// Copies `t` into a new buffer laid out for the bounded dynamic `device_shape`:
+// the data padded to the bound, followed by the int32 size of every dimension.
+// Only padding of the most major dimension is supported, which keeps the
+// row-major tensor data a prefix of the padded buffer.
+static StatusOr<se::OwningDeviceMemory> PadToBoundedDynamicShape(
+    OpKernelContext* ctx, const Tensor& t, const xla::Shape& device_shape,
+    int device_ordinal, se::DeviceMemoryAllocator* allocator) {
+  TF_RET_CHECK(device_shape.IsArray() && device_shape.rank() == t.dims());
+  TF_RET_CHECK(!device_shape.has_layout() ||
+               xla::LayoutUtil::IsMonotonicWithDim0Major(device_shape.layout()))
+      << "Padded dynamic inputs must use the default layout: "
+      << device_shape.ToString(/*print_layout=*/true);
+  for (int64_t d = 1; d < t.dims(); ++d) {
+    TF_RET_CHECK(device_shape.dimensions(d) == t.dim_size(d));
+  }
+  const int64_t data_size = xla::ShapeUtil::ByteSizeOf(device_shape);
+  const int64_t metadata_size = sizeof(int32_t) * t.dims();
+  TF_ASSIGN_OR_RETURN(
+      se::OwningDeviceMemory padded,
+      allocator->Allocate(device_ordinal, data_size + metadata_size));
+  se::DeviceMemoryBase src = XlaTensor::DeviceMemoryFromTensor(t);
+  TF_RET_CHECK(src.size() <= data_size);
+  char* base = static_cast<char*>(padded->opaque());
+
+  se::Stream* stream =
+      ctx->op_device_context() ? ctx->op_device_context()->stream() : nullptr;
+  if (stream == nullptr) {
+    std::memcpy(base, src.opaque(), src.size());
+    int32_t* dims = reinterpret_cast<int32_t*>(base + data_size);
+    for (int64_t d = 0; d < t.dims(); ++d) {
+      dims[d] = static_cast<int32_t>(t.dim_size(d));
+    }
+    return std::move(padded);
+  }
+  se::DeviceMemoryBase data(base, src.size());
+  stream->ThenMemcpy(&data, src, src.size());
+  for (int64_t d = 0; d < t.dims(); ++d) {
+    se::DeviceMemoryBase dim(base + data_size + sizeof(int32_t) * d,
+                             sizeof(int32_t));
+    stream->ThenMemset32(&dim, static_cast<uint32>(t.dim_size(d)),
+                         sizeof(int32_t));
+  }
+  if (!stream->ok()) {
+    return errors::Internal("Failed to pad input of shape ",
+                            t.shape().DebugString(), " to ",
+                            device_shape.ToString());
+  }
+  return std::move(padded);
+}
+
 StatusOr<std::vector<xla::ExecutionInput>>
 XlaComputationLaunchContext::PopulateInputs(
     OpKernelContext* ctx,
@@ -295,6 +347,16 @@ XlaComputationLaunchContext::PopulateInputs(
 
     arguments.emplace_back(device_shape, host_shape);
     xla::ExecutionInput& execution_input = arguments.back();
+    if (device_shape.is_dynamic() && !is_resource_variable) {
+      // The argument was compiled for a bounded dynamic shape (see
+      // --tf_xla_shape_buckets), so XLA expects a padded buffer that carries
+      // the actual dimension sizes.
+      TF_ASSIGN_OR_RETURN(
+          *execution_input.MutableBuffer(xla::ShapeIndex{}),
+          PadToBoundedDynamicShape(ctx, *t, device_shape, device_ordinal_,
+                                   xla_allocator_));
+      continue;
+    }
     se::DeviceMemoryBase dmem = XlaTensor::DeviceMemoryFromTensor(*t);
     PopulateExecutionInputBuffer(execution_input, xla::ShapeIndex{}, dmem,
                                  donate_buffer, device_ordinal_,
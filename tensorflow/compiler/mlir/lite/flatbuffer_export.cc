@@ -130,6 +130,11 @@ ABSL_CONST_INIT const absl::string_view kFlexOpNamePrefix = "Flex";
 // used by the TOCO export. (It does not explain rationale for this choice.)
 constexpr size_t kInitialBufferSize = 10240;
 
+// A flatbuffer can't be larger than 2GB. Models with more constant data than
+// this store it after the flatbuffer, leaving room for the rest of the model.
+constexpr int64_t kMaxBufferDataSizeInFlatbuffer =
+    (int64_t{1} << 31) - (int64_t{1} << 28);
+
 // Set `isSigned` to false if the `type` is an 8-bit unsigned integer type.
 // Since tflite doesn't support unsigned for other types, returns error if
 // `isSigned` is set to false for other types.
@@ -206,6 +211,47 @@ static bool IsConst(Operation* op) {
              tfl::SparseQConstOp, mlir::TFL::NoValueOp>(op);
 }
 
+// Returns the value of `inst` if it's a constant op with a buffer, and a null
+// attribute otherwise.
+static ElementsAttr GetConstantValue(Operation* inst) {
+  if (auto cst = dyn_cast<mlir::arith::ConstantOp>(inst)) {
+    // arith::ConstantOp have ElementAttr at this point due to validation of the
+    // TFLite module.
+    return cst.getValue().cast<ElementsAttr>();
+  } else if (auto cst = dyn_cast<mlir::TF::ConstOp>(inst)) {
+    return cst.value();
+  } else if (auto cst = dyn_cast<tfl::ConstOp>(inst)) {
+    return cst.value();
+  } else if (auto cst = dyn_cast<tfl::QConstOp>(inst)) {
+    return cst.value();
+  } else if (auto cst = dyn_cast<tfl::SparseConstOp>(inst)) {
+    return cst.compressed_data();
+  } else if (auto cst = dyn_cast<tfl::SparseQConstOp>(inst)) {
+    return cst.compressed_data();
+  }
+  return {};
+}
+
+// Returns an estimate of the size of the buffers of the numeric constants in
+// `module`.
+static int64_t EstimateBufferDataSize(ModuleOp module) {
+  int64_t size = 0;
+  module.walk([&](Operation* inst) {
+    if (ElementsAttr attr = GetConstantValue(inst)) {
+      Type element_type = attr.getType().getElementType();
+      if (auto quantized_type =
+              element_type.dyn_cast<mlir::quant::QuantizedType>()) {
+        element_type = quantized_type.getStorageType();
+      }
+      if (element_type.isIntOrFloat()) {
+        size += attr.getNumElements() *
+                ((element_type.getIntOrFloatBitWidth() + 7) / 8);
+      }
+    }
+  });
+  return size;
+}
+
 static bool IsTFResourceOp(Operation* op) {
   for (const auto& operand : op->getOperands()) {
     auto elementType = getElementTypeOrSelf(operand.getType());
@@ -491,14 +537,16 @@ class Translator {
       ModuleOp module, const toco::TocoFlags& toco_flags,
       const std::unordered_set<std::string>& tags,
       OpOrArgNameMapper* op_or_arg_name_mapper,
-      const std::map<std::string, std::string>& metadata);
+      const std::map<std::string, std::string>& metadata,
+      bool use_buffer_offset);
 
  private:
   enum class OpType : char { kTfliteBuiltin, kSelectTf, kCustomOp };
   explicit Translator(ModuleOp module, const toco::TocoFlags& toco_flags,
                       const std::unordered_set<std::string>& saved_model_tags,
                       OpOrArgNameMapper* op_or_arg_name_mapper,
-                      const std::map<std::string, std::string>& metadata)
+                      const std::map<std::string, std::string>& metadata,
+                      bool use_buffer_offset)
       : module_(module),
         name_mapper_(*op_or_arg_name_mapper),
         builder_(kInitialBufferSize),
@@ -508,7 +556,8 @@ class Translator {
                             toco_flags.select_user_tf_ops().end()),
         metadata_(metadata),
         supported_backends_(toco_flags.supported_backends().begin(),
-                            toco_flags.supported_backends().end()) {
+                            toco_flags.supported_backends().end()),
+        use_buffer_offset_(use_buffer_offset) {
     // The first buffer must be empty according to the schema definition.
     empty_buffer_ = tflite::CreateBuffer(builder_);
     buffers_.push_back(empty_buffer_);
@@ -535,7 +584,18 @@ class Translator {
   // Returns TFLite buffer populated with constant value if the operation is
   // TFLite constant operation. Otherwise, returns an empty buffer. Emits error
   // and returns llvm::None on failure.
-  Optional<BufferOffset<tflite::Buffer>> BuildBuffer(Operation* inst);
+  // Builds the buffer at `index` in the model for the value of `inst`.
+  Optional<BufferOffset<tflite::Buffer>> BuildBuffer(Operation* inst,
+                                                     int index);
+
+  // Builds the buffer at `index` in the model for `data`, which is stored in
+  // the flatbuffer or, with buffer offsets, after it.
+  BufferOffset<tflite::Buffer> BuildBufferData(int index,
+                                               absl::string_view data);
+
+  // Returns the serialized flatbuffer followed by the data of the buffers
+  // stored after it, and sets the offsets of these buffers.
+  std::string AppendBufferData();
 
   // Build TFLite tensor from the given type. This function is for tfl.lstm
   // intermediates, which should have UniformQuantizedType.
@@ -692,6 +752,11 @@ class Translator {
   const std::map<std::string, std::string> metadata_;
   // User's defined supported backends.
   const std::unordered_set<std::string> supported_backends_;
+  // Whether the data of the buffers is stored after the flatbuffer.
+  const bool use_buffer_offset_;
+  // The data of the buffers stored after the flatbuffer, with the index of
+  // each buffer.
+  std::vector<std::pair<int, std::string>> buffer_data_;
   // A mapping table to mlir::Operation objects for TFL subgraph and operator
   // index in a flatbuffer.
   std::vector<std::vector<Operation*>> subgraph_op_inst_map_;
@@ -718,25 +783,9 @@ std::string Translator::UniqueName(mlir::Value val) {
 }
 
 Optional<BufferOffset<tflite::Buffer>> Translator::BuildBuffer(
-    Operation* inst) {
-  ElementsAttr attr;
-  if (auto cst = dyn_cast<mlir::arith::ConstantOp>(inst)) {
-    // arith::ConstantOp have ElementAttr at this point due to validation of the
-    // TFLite module.
-    attr = cst.getValue().cast<ElementsAttr>();
-  } else if (auto cst = dyn_cast<mlir::TF::ConstOp>(inst)) {
-    attr = cst.value();
-  } else if (auto cst = dyn_cast<tfl::ConstOp>(inst)) {
-    attr = cst.value();
-  } else if (auto cst = dyn_cast<tfl::QConstOp>(inst)) {
-    attr = cst.value();
-  } else if (auto cst = dyn_cast<tfl::SparseConstOp>(inst)) {
-    attr = cst.compressed_data();
-  } else if (auto cst = dyn_cast<tfl::SparseQConstOp>(inst)) {
-    attr = cst.compressed_data();
-  } else {
-    return empty_buffer_;
-  }
+    Operation* inst, int index) {
+  ElementsAttr attr = GetConstantValue(inst);
+  if (!attr) return empty_buffer_;
 
   tensorflow::Tensor tensor;
   auto status = tensorflow::ConvertToTensor(attr, &tensor);
@@ -758,18 +807,61 @@ Optional<BufferOffset<tflite::Buffer>> Translator::BuildBuffer(
     }
     char* tensor_buffer;
     int bytes = dynamic_buffer.WriteToBuffer(&tensor_buffer);
-    auto buffer_data =
-        builder_.CreateVector(reinterpret_cast<uint8_t*>(tensor_buffer), bytes);
+    auto buffer =
+        BuildBufferData(index, absl::string_view(tensor_buffer, bytes));
     free(tensor_buffer);
-    return tflite::CreateBuffer(builder_, buffer_data);
+    return buffer;
   }
 
-  absl::string_view tensor_data = tensor.tensor_data();
+  return BuildBufferData(index, tensor.tensor_data());
+}
+
+BufferOffset<tflite::Buffer> Translator::BuildBufferData(
+    int index, absl::string_view data) {
+  if (use_buffer_offset_ && !data.empty()) {
+    buffer_data_.emplace_back(index, std::string(data));
+    // Placeholders (which must not be the default values to be stored), set
+    // by AppendBufferData() once the size of the flatbuffer is known.
+    return tflite::CreateBuffer(builder_, /*data=*/0, /*offset=*/1,
+                                /*size=*/1);
+  }
   auto buffer_data = builder_.CreateVector(
-      reinterpret_cast<const uint8_t*>(tensor_data.data()), tensor_data.size());
+      reinterpret_cast<const uint8_t*>(data.data()), data.size());
   return tflite::CreateBuffer(builder_, buffer_data);
 }
 
+std::string Translator::AppendBufferData() {
+  // Like the data in the flatbuffer, each buffer is 16 bytes aligned.
+  auto align = [](uint64_t offset) { return (offset + 15) & ~uint64_t{15}; };
+  const auto* buffers =
+      tflite::GetModel(builder_.GetBufferPointer())->buffers();
+  uint64_t model_size = align(builder_.GetSize());
+  for (const auto& index_and_data : buffer_data_) {
+    // The schema is generated without the mutable API, so the placeholders are
+    // overwritten through flatbuffers::Table, as Buffer::mutate_offset() would.
+    auto* buffer = reinterpret_cast<flatbuffers::Table*>(
+        const_cast<tflite::Buffer*>(buffers->Get(index_and_data.first)));
+    buffer->SetField<uint64_t>(tflite::Buffer::VT_OFFSET, model_size, 0);
+    buffer->SetField<uint64_t>(tflite::Buffer::VT_SIZE,
+                               index_and_data.second.size(), 0);
+    model_size = align(model_size + index_and_data.second.size());
+  }
+
+  std::string result;
+  result.reserve(model_size);
+  result.assign(reinterpret_cast<const char*>(builder_.GetBufferPointer()),
+                builder_.GetSize());
+  for (auto& index_and_data : buffer_data_) {
+    result.resize(align(result.size()), '\0');
+    result.append(index_and_data.second);
+    // Releases each buffer once it's copied, so that the model isn't held
+    // twice in memory.
+    std::string().swap(index_and_data.second);
+  }
+  buffer_data_.clear();
+  return result;
+}
+
 Optional<BufferOffset<tflite::Tensor>> Translator::BuildTensorFromType(
     mlir::Type type, const std::string& name) {
   auto tensor_type = type.cast<TensorType>();
@@ -1423,7 +1515,7 @@ Optional<BufferOffset<tflite::SubGraph>> Translator::BuildSubGraph(
     // Tensor. This does not seem to affect runtime behavior for RNN/LSTM,
     // but would be good for reducing memory footprint.
     if (auto* inst = value.getDefiningOp()) {
-      auto buffer_or = BuildBuffer(inst);
+      auto buffer_or = BuildBuffer(inst, buffers_.size());
       if (!buffer_or) return false;
       buffers_.push_back(*buffer_or);
     } else {
@@ -1791,14 +1883,21 @@ Optional<std::string> Translator::Translate(
     ModuleOp module, const toco::TocoFlags& toco_flags,
     const std::unordered_set<std::string>& tags,
     OpOrArgNameMapper* op_or_arg_name_mapper,
-    const std::map<std::string, std::string>& metadata) {
+    const std::map<std::string, std::string>& metadata,
+    bool use_buffer_offset) {
   OpOrArgLocNameMapper default_op_or_arg_name_mapper;
   if (!op_or_arg_name_mapper)
     op_or_arg_name_mapper = &default_op_or_arg_name_mapper;
   if (!UpdateEntryFunction(module)) return llvm::None;
   if (!IsValidTFLiteMlirModule(module)) return llvm::None;
+  if (!use_buffer_offset &&
+      EstimateBufferDataSize(module) > kMaxBufferDataSizeInFlatbuffer) {
+    LOG(INFO) << "Storing the constant buffers after the flatbuffer, which "
+                 "can't hold them";
+    use_buffer_offset = true;
+  }
   Translator translator(module, toco_flags, tags, op_or_arg_name_mapper,
-                        metadata);
+                        metadata, use_buffer_offset);
   return translator.TranslateInternal();
 }
 
@@ -2041,6 +2140,7 @@ Optional<std::string> Translator::TranslateInternal() {
   }
 
   // Return serialized string for the built FlatBuffer.
+  if (use_buffer_offset_) return AppendBufferData();
   return std::string(reinterpret_cast<const char*>(builder_.GetBufferPointer()),
                      builder_.GetSize());
 }
@@ -2152,7 +2252,8 @@ bool MlirToFlatBufferTranslateFunction(mlir::ModuleOp module,
                                        std::string* serialized_flatbuffer) {
   auto maybe_translated = Translator::Translate(
       module, options.toco_flags, options.saved_model_tags,
-      options.op_or_arg_name_mapper, options.metadata);
+      options.op_or_arg_name_mapper, options.metadata,
+      options.use_buffer_offset);
   if (!maybe_translated) return false;
   *serialized_flatbuffer = std::move(*maybe_translated);
   return true;
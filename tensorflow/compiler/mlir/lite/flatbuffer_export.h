@@ -42,6 +42,10 @@ struct FlatbufferExportOptions {
   // OpOrArgNameMapper to convert location of the op to name in flatbuffer.
   // If not set, a default mapper will be used.
   tensorflow::OpOrArgNameMapper* op_or_arg_name_mapper = nullptr;
+  // Stores the data of the constant buffers after the flatbuffer (see
+  // Buffer.offset in the TFLite schema) instead of in it. This is done
+  // regardless when the constants don't fit in a flatbuffer.
+  bool use_buffer_offset = false;
 };
 
 // Translates the given MLIR `module` into a FlatBuffer and stores the
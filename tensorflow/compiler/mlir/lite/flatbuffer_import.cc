@@ -1435,6 +1435,20 @@ OwningOpRef<mlir::ModuleOp> tflite::FlatBufferToMlir(
 
   std::unique_ptr<ModelT> model(model_ptr->GetModel()->UnPack());
 
+  // The data of large buffers may be stored after the flatbuffer, in which
+  // case it's read into the unpacked model to be imported like the others.
+  for (auto& model_buffer : model->buffers) {
+    if (model_buffer->offset <= 1) continue;
+    if (model_buffer->offset > buffer.size() ||
+        model_buffer->size > buffer.size() - model_buffer->offset) {
+      return emitError(base_loc, "buffer is outside of the flatbuffer model"),
+             nullptr;
+    }
+    const auto* data =
+        reinterpret_cast<const uint8_t*>(buffer.data() + model_buffer->offset);
+    model_buffer->data.assign(data, data + model_buffer->size);
+  }
+
   auto builder = Builder(context);
 
   std::vector<std::string> func_names;
@@ -340,7 +340,8 @@ void AddPostVariableFreezingTFToTFLConversionPasses(
                    .RunAndRewriteDynamicRangeQuantizationPasses()) {
       AddDynamicRangeQuantizationPasses(pass_config.quant_specs, *pass_manager);
     }
-    pass_manager->addPass(mlir::createCanonicalizerPass());
+    pass_manager->addNestedPass<mlir::func::FuncOp>(
+        mlir::createCanonicalizerPass());
 
     // This pass should be always at the end of the model
     // conversion (even after quantization). Some TFL ops like unidirectional
@@ -302,7 +302,7 @@ Status ConvertTFExecutorToTFLOrFlatbuffer(
         quant_specs, translated_result, result);
     if (!status.ok()) return status;
   } else {
-    *result = translated_result;
+    *result = std::move(translated_result);
   }
 
   if (mlir::failed(module.verifyInvariants())) {
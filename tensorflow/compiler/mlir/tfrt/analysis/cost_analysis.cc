@@ -148,6 +148,15 @@ void CostAnalysis::EvaluateCost(mlir::Operation* op) {
     return;
   }
 
+  // Prefer the cost measured at runtime if there is one.
+  if (op_cost_map_ != nullptr) {
+    auto iter = op_cost_map_->find(op->getName().getStringRef().str());
+    if (iter != op_cost_map_->end()) {
+      cost_map_[op] = std::max<int64_t>(kDefaultCheapCost, iter->second);
+      return;
+    }
+  }
+
   // These ops are cheap regardless of their input sizes.
   //
   // TODO(chky): Find a more scalable way to figure out cheap ops.
@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_MLIR_TFRT_ANALYSIS_COST_ANALYSIS_H_
 #define TENSORFLOW_COMPILER_MLIR_TFRT_ANALYSIS_COST_ANALYSIS_H_
 
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/IR/BuiltinOps.h"  // from @llvm-project
@@ -32,9 +35,17 @@ namespace tfrt_compiler {
 // threshold to decide whether a cost is cheap or expensive), as it might not be
 // accurate in some cases.
 //
+// If `op_cost_map` is provided, it maps op names (eg. "tf.MatMul") to the
+// costs measured at runtime (eg. by tfrt_stub::CostRecorder), and ops found in
+// it use the measured cost instead of the static estimate.
+//
 class CostAnalysis {
  public:
-  explicit CostAnalysis(mlir::func::FuncOp func_op) {
+  using OpCostMap = absl::flat_hash_map<std::string, uint64_t>;
+
+  explicit CostAnalysis(mlir::func::FuncOp func_op,
+                        const OpCostMap* op_cost_map = nullptr)
+      : op_cost_map_(op_cost_map) {
     AnalyzeArguments(func_op);
     AnalyzeBlock(&func_op.front());
   }
@@ -49,6 +60,7 @@ class CostAnalysis {
   void AnalyzeBlock(mlir::Block* block);
   void EvaluateCost(mlir::Operation* op);
 
+  const OpCostMap* op_cost_map_ = nullptr;
   int64_t max_arg_size_ = 1;
   llvm::DenseMap<mlir::Operation*, int64_t> cost_map_;
 };
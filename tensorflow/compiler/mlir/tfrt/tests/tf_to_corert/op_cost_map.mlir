@@ -0,0 +1,13 @@
+// RUN: echo 'op_cost_map { key: "tf.MatMul" value: 4096 } op_cost_map { key: "tf.AddV2" value: 0 }' > %t.pbtxt
+// RUN: tf-tfrt-opt -pass-pipeline='tf-to-tfrt{enable-native-ops=false tfrt-op-cost-map-file=%t.pbtxt}' %s | FileCheck %s --dump-input=fail --dump-input-filter=all
+
+// CHECK-LABEL: func @measured_cost
+func.func @measured_cost(%arg0: tensor<3x1xf32>, %arg1: tensor<1x3xf32>) -> tensor<3x3xf32> {
+  // CHECK: tfrt_fallback_async.executeop key({{.*}}) cost(4096) device("/device:CPU:0") "tf.MatMul"
+  // CHECK: tfrt_fallback_async.executeop key({{.*}}) cost(1) device("/device:CPU:0") "tf.AddV2"
+  // CHECK: tfrt_fallback_async.executeop key({{.*}}) cost(19) device("/device:CPU:0") "tf.Sub"
+  %0 = "tf.MatMul"(%arg0, %arg1) {T = f32, device = "/device:CPU:0", transpose_a = false, transpose_b = false} : (tensor<3x1xf32>, tensor<1x3xf32>) -> tensor<3x3xf32>
+  %1 = "tf.AddV2"(%0, %0) {T = f32, device = "/device:CPU:0"} : (tensor<3x3xf32>, tensor<3x3xf32>) -> tensor<3x3xf32>
+  %2 = "tf.Sub"(%1, %1) {T = f32, device = "/device:CPU:0"} : (tensor<3x3xf32>, tensor<3x3xf32>) -> tensor<3x3xf32>
+  func.return %2 : tensor<3x3xf32>
+}
@@ -205,6 +205,12 @@ struct TfrtPipelineOptions
           "The threshold to limit the merging of dependent sequence."),
       llvm::cl::init(-1)};
 
+  Option<std::string> op_cost_map_file{
+      *this, "tfrt-op-cost-map-file",
+      llvm::cl::desc("If not empty, the path to a text OpCostMapProto whose "
+                     "measured op costs override the static cost estimates."),
+      llvm::cl::init("")};
+
   Option<bool> merge_inter_dependent_streams{
       *this, "tfrt-merge-inter-dependent-streams",
       llvm::cl::desc("If true, streams with inter data depenedencies will be "
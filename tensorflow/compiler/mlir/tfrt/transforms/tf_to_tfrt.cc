@@ -59,7 +59,10 @@ limitations under the License.
 #include "tensorflow/compiler/mlir/tfrt/transforms/set_shape_invariant_in_while_ops.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/tstring.h"
+#include "tensorflow/core/tfrt/fallback/op_cost_map.pb.h"
 #include "tfrt/jitrt/opdefs/jitrt_ops.h"  // from @tf_runtime
 #include "tfrt/basic_kernels/opdefs/basic_kernels.h"  // from @tf_runtime
 #include "tfrt/basic_kernels/opdefs/tfrt_base.h"  // from @tf_runtime
@@ -1646,6 +1649,7 @@ class TfToTfrtConversionPass
         options.use_tpu_host_allocator_for_inputs;
     cost_threshold_ = options.cost_threshold;
     upper_cost_threshold_ = options.upper_cost_threshold;
+    op_cost_map_file_ = options.op_cost_map_file;
     merge_inter_dependent_streams_ = options.merge_inter_dependent_streams;
     func_use_fallback_tensor_ = options.func_use_fallback_tensor;
     enable_while_parallel_iterations_ =
@@ -1664,7 +1668,7 @@ class TfToTfrtConversionPass
     mlir::ConversionTarget target(context);
     mlir::RewritePatternSet patterns(&getContext());
     CoreRTConverter corert_converter(&context, &side_effect_analysis);
-    tfrt_compiler::CostAnalysis cost_analysis(func);
+    tfrt_compiler::CostAnalysis cost_analysis(func, &op_cost_map_);
 
     if (target_tpurt_)
       AddTPUTargetDialectAndPatterns(
@@ -1705,6 +1709,8 @@ class TfToTfrtConversionPass
 
     mlir::SymbolTable symbol_table(module);
 
+    LoadOpCostMap();
+
     auto func_op_range = module.getOps<mlir::func::FuncOp>();
     llvm::SmallVector<mlir::func::FuncOp, 4> func_ops(func_op_range.begin(),
                                                       func_op_range.end());
@@ -1737,6 +1743,26 @@ class TfToTfrtConversionPass
   }
 
  private:
+  // Loads the measured op costs from `op_cost_map_file_`, if any. If the file
+  // cannot be read, the static cost estimates are used for all ops.
+  void LoadOpCostMap() {
+    op_cost_map_.clear();
+    if (op_cost_map_file_.empty()) return;
+
+    tensorflow::tfrt_stub::OpCostMapProto op_cost_map_proto;
+    auto status = tensorflow::ReadTextProto(
+        tensorflow::Env::Default(), op_cost_map_file_, &op_cost_map_proto);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to read the op cost map from "
+                   << op_cost_map_file_ << ": " << status;
+      return;
+    }
+    op_cost_map_.insert(op_cost_map_proto.op_cost_map().begin(),
+                        op_cost_map_proto.op_cost_map().end());
+    VLOG(1) << "Loaded measured costs of " << op_cost_map_.size()
+            << " ops from " << op_cost_map_file_;
+  }
+
   // Chain all dangling values (ie. values with no users) together and merge it
   // with the first returned chain. This merged chain can be used to signal the
   // completion of all execution including side-effets.
@@ -1912,6 +1938,12 @@ class TfToTfrtConversionPass
           "The threshold to limit the merging of dependent sequence."),
       llvm::cl::init(-1)};
 
+  Option<std::string> op_cost_map_file_{
+      *this, "tfrt-op-cost-map-file",
+      llvm::cl::desc("If not empty, the path to a text OpCostMapProto whose "
+                     "measured op costs override the static cost estimates."),
+      llvm::cl::init("")};
+
   Option<bool> merge_inter_dependent_streams_{
       *this, "tfrt-merge-inter-dependent-streams",
       llvm::cl::desc("If true, streams with inter data depenedencies will be "
@@ -1930,6 +1962,8 @@ class TfToTfrtConversionPass
       llvm::cl::desc("If true, tf.While op will be parallelized. This is "
                      "currently experimental."),
       llvm::cl::init(false)};
+
+  tfrt_compiler::CostAnalysis::OpCostMap op_cost_map_;
 };
 
 // Assigns devices so that later passes can utilize device information.
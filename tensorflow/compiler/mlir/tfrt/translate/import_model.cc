@@ -133,6 +133,7 @@ Status ConvertTfMlirToBef(const TfrtCompileOptions& options,
       options.auto_fusion_min_cluster_size;
   pass_options.cost_threshold = options.cost_threshold;
   pass_options.upper_cost_threshold = options.upper_cost_threshold;
+  pass_options.op_cost_map_file = options.op_cost_map_file;
   pass_options.merge_inter_dependent_streams =
       options.merge_inter_dependent_streams;
   tensorflow::CreateTfExecutorToTfrtPipeline(pm, pass_options);
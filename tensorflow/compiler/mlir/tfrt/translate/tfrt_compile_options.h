@@ -120,6 +120,13 @@ struct TfrtCompileOptions {
   // sequences. The default is -1 which means no limit.
   int64_t upper_cost_threshold = -1;
 
+  // If not empty, the path to a text tensorflow.tfrt_stub.OpCostMapProto, as
+  // written by tfrt_stub::CostRecorder::WriteToFile(). Ops found in it use
+  // their measured cost in microseconds instead of the static estimate when
+  // deciding which operations are cheap enough to be executed inline, so
+  // `cost_threshold` should be chosen accordingly.
+  std::string op_cost_map_file;
+
   // If true, streams with inter data depenedencies will be preferred to be
   // merged for inline execution.
   bool merge_inter_dependent_streams = false;
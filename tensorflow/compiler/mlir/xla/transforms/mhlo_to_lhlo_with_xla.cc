@@ -61,6 +61,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/backend_configs.pb.h"
 #include "tensorflow/compiler/xla/service/gpu/cublas_cudnn.h"
 #include "tensorflow/compiler/xla/service/gpu/ir_emission_utils.h"
+#include "tensorflow/compiler/xla/service/gpu/matmul_utils.h"
 #include "tensorflow/compiler/xla/service/hlo_casting_utils.h"
 #include "tensorflow/compiler/xla/service/hlo_computation.h"
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
@@ -822,6 +823,24 @@ StatusOr<lmhlo_gpu::CublasLtMatmulEpilogue> AsLhloEpilogue(
     case xla::gpu::GemmBackendConfig::BIAS:
       return lmhlo_gpu::CublasLtMatmulEpilogue::Bias;
       break;
+    case xla::gpu::GemmBackendConfig::RELU:
+      return lmhlo_gpu::CublasLtMatmulEpilogue::Relu;
+      break;
+    case xla::gpu::GemmBackendConfig::GELU:
+      return lmhlo_gpu::CublasLtMatmulEpilogue::Gelu;
+      break;
+    case xla::gpu::GemmBackendConfig::GELU_AUX:
+      return lmhlo_gpu::CublasLtMatmulEpilogue::GeluAux;
+      break;
+    case xla::gpu::GemmBackendConfig::BIAS_RELU:
+      return lmhlo_gpu::CublasLtMatmulEpilogue::BiasRelu;
+      break;
+    case xla::gpu::GemmBackendConfig::BIAS_GELU:
+      return lmhlo_gpu::CublasLtMatmulEpilogue::BiasGelu;
+      break;
+    case xla::gpu::GemmBackendConfig::BIAS_GELU_AUX:
+      return lmhlo_gpu::CublasLtMatmulEpilogue::BiasGeluAux;
+      break;
     default:
       return xla::InternalError("unknown epilogue");
   }
@@ -859,26 +878,43 @@ StatusOr<Operation*> LhloDialectEmitter::EmitCublasLtMatmul(
       custom_call->backend_config<xla::gpu::GemmBackendConfig>());
 
   bool has_matrix_bias = config.beta() != 0.;
-  bool has_vector_bias = config.epilogue() == xla::gpu::GemmBackendConfig::BIAS;
+  bool has_vector_bias = xla::gpu::EpilogueAddsVectorBias(config.epilogue());
+  bool has_aux_output = xla::gpu::EpilogueHasAuxiliaryOutput(config.epilogue());
   TF_RET_CHECK(custom_call->operand_count() ==
                2 + int{has_matrix_bias} + int{has_vector_bias});
+  TF_RET_CHECK(custom_call->shape().IsTuple() == has_aux_output);
 
-  llvm::SmallVector<Value, 5> operands;
+  // With an auxiliary output the custom call returns a (result, aux) tuple.
+  xla::ShapeIndex output_index =
+      has_aux_output ? xla::ShapeIndex{0} : xla::ShapeIndex{};
+
+  llvm::SmallVector<Value, 6> operands;
   TF_RETURN_IF_ERROR(GetOrCreateView(custom_call->operand(0), &operands));
   TF_RETURN_IF_ERROR(GetOrCreateView(custom_call->operand(1), &operands));
-  TF_RETURN_IF_ERROR(GetOrCreateView(
-      has_matrix_bias ? custom_call->operand(2) : custom_call, &operands));
-  TF_RETURN_IF_ERROR(GetOrCreateView(custom_call, &operands));
+  if (has_matrix_bias) {
+    TF_RETURN_IF_ERROR(GetOrCreateView(custom_call->operand(2), &operands));
+  } else {
+    TF_RETURN_IF_ERROR(GetOrCreateView(custom_call, &operands, output_index));
+  }
+  TF_RETURN_IF_ERROR(GetOrCreateView(custom_call, &operands, output_index));
 
   if (has_vector_bias) {
     TF_RETURN_IF_ERROR(GetOrCreateView(
         custom_call->operand(has_matrix_bias ? 3 : 2), &operands));
   }
+  if (has_aux_output) {
+    TF_RETURN_IF_ERROR(GetOrCreateView(custom_call, &operands, {1}));
+  }
 
   auto op =
       CreateOpWithoutAttrs<lmhlo_gpu::CublasLtMatmulOp>(custom_call, operands);
   SetMatmulAttributes(op, config, builder_);
 
+  const int32_t segments[6] = {1, 1, 1, 1, int32_t{has_vector_bias},
+                               int32_t{has_aux_output}};
+  op->setAttr(lmhlo_gpu::CublasLtMatmulOp::getOperandSegmentSizeAttr(),
+              builder_.getI32VectorAttr(segments));
+
   TF_ASSIGN_OR_RETURN(lmhlo_gpu::CublasLtMatmulEpilogue epilogue,
                       AsLhloEpilogue(config.epilogue()));
   op.setEpilogueAttr(lmhlo_gpu::CublasLtMatmulEpilogueAttr::get(
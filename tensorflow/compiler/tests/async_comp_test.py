@@ -18,6 +18,7 @@ import os
 
 from tensorflow.core.protobuf import config_pb2
 from tensorflow.python.client import session as session_lib
+from tensorflow.python.eager import def_function
 from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import function
 from tensorflow.python.framework import ops
@@ -84,9 +85,26 @@ class AsyncCompilationTest(test.TestCase):
                 trace_level=config_pb2.RunOptions.FULL_TRACE))
         hasXlaRunOp = MetadataHasXlaRunOp(run_metadata)
 
+  # With --tf_xla_launch_async_compilation, functions marked for compilation
+  # run with the TF executor until their compilation has finished, and produce
+  # the same results on either path.
+  def testAsyncCompilationLaunch(self):
+
+    @def_function.function(jit_compile=True)
+    def CompiledFunction(x):
+      return math_ops.square(x) + 1.
+
+    with session_lib.Session() as sess:
+      x = array_ops.placeholder(dtypes.float32)
+      y = CompiledFunction(x)
+      for _ in range(10):
+        self.assertAllClose(sess.run(y, feed_dict={x: [1., 2., 3.]}),
+                            [2., 5., 10.])
+
 
 if __name__ == "__main__":
   os.environ["TF_XLA_FLAGS"] = ("--tf_xla_async_compilation=true " +
+                                "--tf_xla_launch_async_compilation=true " +
                                 "--tf_xla_enable_lazy_compilation=true " +
                                 os.environ.get("TF_XLA_FLAGS", ""))
   # This test is using Tensorflow sessions which are not compatible with eager
@@ -0,0 +1,60 @@
+# Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Tests for padding XLA cluster arguments to shape buckets."""
+
+import os
+
+import numpy as np
+
+from tensorflow.python.eager import def_function
+from tensorflow.python.framework import dtypes
+from tensorflow.python.framework import tensor_spec
+from tensorflow.python.ops import math_ops
+from tensorflow.python.platform import test
+
+
+class ShapeBucketingTest(test.TestCase):
+
+  # Inputs whose leading dimension falls into the same power-of-two bucket run
+  # on a padded buffer; the results must only cover the real elements.
+  def testElementwise(self):
+
+    @def_function.function(
+        jit_compile=True,
+        input_signature=[tensor_spec.TensorSpec([None, 2], dtypes.float32)])
+    def CompiledFunction(x):
+      return x * 2. + 1.
+
+    for size in [3, 4, 5, 7, 8]:
+      x = np.arange(size * 2, dtype=np.float32).reshape(size, 2)
+      self.assertAllClose(CompiledFunction(x), x * 2. + 1.)
+
+  def testReduction(self):
+
+    @def_function.function(
+        jit_compile=True,
+        input_signature=[tensor_spec.TensorSpec([None], dtypes.float32)])
+    def CompiledFunction(x):
+      return math_ops.reduce_sum(x)
+
+    for size in [5, 6, 7, 8]:
+      x = np.ones([size], dtype=np.float32)
+      self.assertAllClose(CompiledFunction(x), float(size))
+
+
+if __name__ == "__main__":
+  os.environ["TF_XLA_FLAGS"] = ("--tf_xla_shape_buckets=pow2 " +
+                                os.environ.get("TF_XLA_FLAGS", ""))
+  test.main()
@@ -686,12 +686,27 @@ static void AllocateFlags() {
       bool_setter_for(&DebugOptions::set_xla_gpu_enable_async_all_reduce),
       flag_values->xla_gpu_enable_async_all_reduce(),
       "Converts synchronous all-reduce ops into asynchronous."));
+  flag_objects->push_back(tensorflow::Flag(
+      "xla_gpu_enable_latency_hiding_scheduler",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_latency_hiding_scheduler),
+      flag_values->xla_gpu_enable_latency_hiding_scheduler(),
+      "Schedules asynchronous collectives to overlap with independent compute "
+      "on GPU, using a latency model."));
   flag_objects->push_back(tensorflow::Flag(
       "xla_gpu_all_reduce_combine_threshold_bytes",
       int64_setter_for(
           &DebugOptions::set_xla_gpu_all_reduce_combine_threshold_bytes),
       flag_values->xla_gpu_all_reduce_combine_threshold_bytes(),
       "Size threshold (in bytes) for the GPU all-reduce combiner."));
+  flag_objects->push_back(tensorflow::Flag(
+      "xla_gpu_all_reduce_latency_profile",
+      string_setter_for(
+          &DebugOptions::set_xla_gpu_all_reduce_latency_profile),
+      flag_values->xla_gpu_all_reduce_latency_profile(),
+      "Path to an all-reduce latency profile with one \"<bytes> <seconds>\" "
+      "sample per line. If set, the GPU all-reduce combiner threshold is "
+      "derived from it."));
   flag_objects->push_back(tensorflow::Flag(
       "xla_gpu_all_reduce_contiguous",
       bool_setter_for(&DebugOptions::set_xla_gpu_all_reduce_contiguous),
@@ -789,6 +804,33 @@ static void AllocateFlags() {
       "By default, XLA:CPU will run fp16 dot/conv as fp32, as this is "
       "generally (much) faster on our hardware.  Set this flag to true to "
       "disable this behavior."));
+  flag_objects->push_back(tensorflow::Flag(
+      "xla_cpu_parallel_codegen_split_count",
+      int32_setter_for(
+          &DebugOptions::set_xla_cpu_parallel_codegen_split_count),
+      flag_values->xla_cpu_parallel_codegen_split_count(),
+      "Splits the LLVM module emitted by XLA:CPU into up to this many modules "
+      "that are compiled concurrently. Values <= 1 compile the module as a "
+      "whole."));
+  flag_objects->push_back(tensorflow::Flag(
+      "xla_gpu_enable_cuda_graphs",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_cuda_graphs),
+      flag_values->xla_gpu_enable_cuda_graphs(),
+      "Captures the thunks of single-stream XLA:GPU executables into a CUDA "
+      "graph and replays it when the buffer addresses do not change."));
+  flag_objects->push_back(tensorflow::Flag(
+      "xla_gpu_load_autotune_results_from",
+      string_setter_for(&DebugOptions::set_xla_gpu_load_autotune_results_from),
+      flag_values->xla_gpu_load_autotune_results_from(),
+      "File with GEMM and convolution autotuning results to use instead of "
+      "autotuning. Files ending in .pbtxt or .txt are read as text protos."));
+  flag_objects->push_back(tensorflow::Flag(
+      "xla_gpu_dump_autotune_results_to",
+      string_setter_for(&DebugOptions::set_xla_gpu_dump_autotune_results_to),
+      flag_values->xla_gpu_dump_autotune_results_to(),
+      "File to write the GEMM and convolution autotuning results of the "
+      "process to. Files ending in .pbtxt or .txt are written as text "
+      "protos."));
 
   ParseFlagsFromEnvAndDieIfUnknown("XLA_FLAGS", *flag_objects);
 }  // NOLINT(readability/fn_size)
@@ -0,0 +1,186 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/pjrt/compilation_cache.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/xla/client/executable_build_options.h"
+#include "tensorflow/compiler/xla/service/hlo_instruction.h"
+#include "tensorflow/compiler/xla/service/hlo_module.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/compiler/xla/xla.pb.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace xla {
+
+StatusOr<std::string> ComputeCompilationCacheKey(
+    const PjRtClient& client, const XlaComputation& computation,
+    const CompileOptions& options) {
+  if (options.multi_slice_config != nullptr) {
+    return InvalidArgument(
+        "Compile options with a multi_slice_config can't be fingerprinted");
+  }
+
+  // Round-trip through HloModule to get a textual form that doesn't depend on
+  // the unique ids and names the builder happened to assign. Unlike
+  // HloPrintOptions::Fingerprint(), keep all constants and backend configs:
+  // they change the compiled program.
+  TF_ASSIGN_OR_RETURN(HloModuleConfig module_config,
+                      HloModule::CreateModuleConfigFromProto(
+                          computation.proto(), DebugOptions()));
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<HloModule> module,
+      HloModule::CreateFromProto(computation.proto(), module_config));
+  HloPrintOptions print_options = HloPrintOptions::Canonical()
+                                      .set_print_backend_config(true)
+                                      .set_print_large_constants(true)
+                                      .set_print_ids(false)
+                                      .set_canonicalize_computations(true);
+  std::string hlo = module->ToString(print_options);
+
+  TF_ASSIGN_OR_RETURN(ProgramShape program_shape,
+                      computation.GetProgramShape());
+  ExecutionOptions execution_options = CreateExecutionOptions(
+      options.executable_build_options, &program_shape);
+  std::string serialized_execution_options;
+  if (!tensorflow::SerializeToStringDeterministic(
+          execution_options, &serialized_execution_options)) {
+    return Internal("Failed to serialize the ExecutionOptions.");
+  }
+
+  std::string options_string = absl::StrCat(
+      "device_ordinal=", options.executable_build_options.device_ordinal(),
+      ",parameter_is_tupled_arguments=", options.parameter_is_tupled_arguments,
+      ",compile_portable_executable=", options.compile_portable_executable,
+      ",profile_version=", options.profile_version, ",argument_layouts=");
+  if (options.argument_layouts) {
+    for (const Shape& layout : *options.argument_layouts) {
+      absl::StrAppend(&options_string, ShapeUtil::HumanStringWithLayout(layout),
+                      ";");
+    }
+  } else {
+    absl::StrAppend(&options_string, "nullopt");
+  }
+
+  std::string device_kind;
+  if (!client.addressable_devices().empty()) {
+    device_kind = std::string(client.addressable_devices()[0]->device_kind());
+  }
+
+  tensorflow::Fprint128 fingerprint = tensorflow::Fingerprint128(absl::StrCat(
+      client.platform_name(), "\n", client.platform_version(), "\n",
+      device_kind, "\n", options_string, "\n", serialized_execution_options,
+      "\n", hlo));
+  return absl::StrCat(absl::Hex(fingerprint.high64, absl::kZeroPad16),
+                      absl::Hex(fingerprint.low64, absl::kZeroPad16));
+}
+
+PjRtCompilationCache::PjRtCompilationCache(
+    PjRtClient* client, int capacity,
+    std::unique_ptr<PjRtCompilationCacheBackend> backend)
+    : client_(client),
+      backend_(std::move(backend)),
+      lru_list_(capacity),
+      cache_(&lru_list_) {}
+
+StatusOr<std::shared_ptr<PjRtExecutable>> PjRtCompilationCache::GetOrCompile(
+    const XlaComputation& computation, CompileOptions options) {
+  if (options.multi_slice_config != nullptr) {
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtExecutable> executable,
+                        client_->Compile(computation, std::move(options)));
+    return std::shared_ptr<PjRtExecutable>(std::move(executable));
+  }
+  TF_ASSIGN_OR_RETURN(std::string key,
+                      ComputeCompilationCacheKey(*client_, computation,
+                                                 options));
+
+  std::shared_ptr<Entry> entry;
+  bool inserted = false;
+  {
+    absl::MutexLock lock(&mu_);
+    entry = cache_.GetOrCreateIfAbsent(key, [&](const std::string&) {
+      inserted = true;
+      return std::make_shared<Entry>();
+    });
+  }
+  if (!inserted) {
+    entry->ready.WaitForNotification();
+    return entry->executable;
+  }
+
+  // Compile outside of the lock, so that unrelated requests aren't blocked.
+  entry->executable = LoadOrCompile(key, computation, options);
+  entry->ready.Notify();
+  if (!entry->executable.ok()) {
+    // Don't cache failures, which may be transient, e.g., out of memory. If
+    // the entry was already evicted and the key re-requested, this drops the
+    // newer entry too, which only costs a recompilation.
+    absl::MutexLock lock(&mu_);
+    cache_.Remove(key);
+  }
+  return entry->executable;
+}
+
+StatusOr<std::shared_ptr<PjRtExecutable>> PjRtCompilationCache::LoadOrCompile(
+    const std::string& key, const XlaComputation& computation,
+    const CompileOptions& options) {
+  if (backend_) {
+    StatusOr<std::optional<std::string>> serialized = backend_->Get(key);
+    if (!serialized.ok()) {
+      LOG(WARNING) << "Failed to read executable " << key
+                   << " from the compilation cache: " << serialized.status();
+    } else if (serialized->has_value()) {
+      StatusOr<std::unique_ptr<PjRtExecutable>> executable =
+          client_->DeserializeExecutable(**serialized, options);
+      if (executable.ok()) {
+        VLOG(1) << "Loaded executable " << key << " from the compilation cache";
+        return std::shared_ptr<PjRtExecutable>(std::move(executable).value());
+      }
+      LOG(WARNING) << "Failed to deserialize executable " << key
+                   << " from the compilation cache: " << executable.status();
+    }
+  }
+
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtExecutable> executable,
+                      client_->Compile(computation, options));
+
+  if (backend_) {
+    StatusOr<std::string> serialized =
+        client_->SerializeExecutable(*executable);
+    Status status = serialized.status();
+    if (serialized.ok()) {
+      status = backend_->Put(key, *serialized);
+    }
+    if (!status.ok() && status.code() != tensorflow::error::UNIMPLEMENTED) {
+      LOG(WARNING) << "Failed to write executable " << key
+                   << " to the compilation cache: " << status;
+    }
+  }
+  return std::shared_ptr<PjRtExecutable>(std::move(executable));
+}
+
+void PjRtCompilationCache::Clear() {
+  absl::MutexLock lock(&mu_);
+  cache_.Clear();
+}
+
+}  // namespace xla
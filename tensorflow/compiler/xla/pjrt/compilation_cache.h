@@ -0,0 +1,112 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_PJRT_COMPILATION_CACHE_H_
+#define TENSORFLOW_COMPILER_XLA_PJRT_COMPILATION_CACHE_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "tensorflow/compiler/xla/client/xla_computation.h"
+#include "tensorflow/compiler/xla/pjrt/lru_cache.h"
+#include "tensorflow/compiler/xla/pjrt/pjrt_client.h"
+#include "tensorflow/compiler/xla/status.h"
+#include "tensorflow/compiler/xla/statusor.h"
+
+namespace xla {
+
+// Persistent storage for serialized executables, e.g., on a local or shared
+// filesystem. Implementations must be thread-safe.
+class PjRtCompilationCacheBackend {
+ public:
+  virtual ~PjRtCompilationCacheBackend() = default;
+
+  // Returns the serialized executable stored under `key`, or std::nullopt if
+  // there is none.
+  virtual StatusOr<std::optional<std::string>> Get(absl::string_view key) = 0;
+
+  // Stores `serialized_executable` under `key`.
+  virtual Status Put(absl::string_view key,
+                     absl::string_view serialized_executable) = 0;
+};
+
+// Returns a key that identifies the executable `client` would produce when
+// compiling `computation` with `options`. The key is a fingerprint of the
+// canonicalized HLO module, so it doesn't depend on instruction ids or names,
+// together with the compile options and the client's platform and device kind.
+StatusOr<std::string> ComputeCompilationCacheKey(
+    const PjRtClient& client, const XlaComputation& computation,
+    const CompileOptions& options);
+
+// A cache of the executables compiled by a PjRtClient, keyed by
+// ComputeCompilationCacheKey(). Works with any PjRtClient implementation.
+//
+// Executables are kept in memory in least-recently-used order, up to
+// `capacity` entries. If a `backend` is given, executables compiled by this
+// cache are also serialized into it, and misses in memory are looked up in the
+// backend before compiling. Clients that can't serialize executables are only
+// cached in memory.
+//
+// Concurrent requests for the same key compile once; the other callers wait
+// for the result. Compilation errors are returned but not cached.
+class PjRtCompilationCache {
+ public:
+  PjRtCompilationCache(
+      PjRtClient* client, int capacity,
+      std::unique_ptr<PjRtCompilationCacheBackend> backend = nullptr);
+
+  PjRtCompilationCache(const PjRtCompilationCache&) = delete;
+  PjRtCompilationCache& operator=(const PjRtCompilationCache&) = delete;
+
+  // Returns the cached executable for `computation` and `options`, compiling
+  // it if necessary. Options that can't be fingerprinted, e.g., a
+  // multi_slice_config, bypass the cache.
+  StatusOr<std::shared_ptr<PjRtExecutable>> GetOrCompile(
+      const XlaComputation& computation, CompileOptions options);
+
+  // Drops all executables held in memory. The backend is left untouched.
+  void Clear();
+
+  int Size() const {
+    absl::MutexLock lock(&mu_);
+    return cache_.Size();
+  }
+
+ private:
+  struct Entry {
+    absl::Notification ready;
+    StatusOr<std::shared_ptr<PjRtExecutable>> executable;
+  };
+
+  StatusOr<std::shared_ptr<PjRtExecutable>> LoadOrCompile(
+      const std::string& key, const XlaComputation& computation,
+      const CompileOptions& options);
+
+  PjRtClient* const client_;
+  const std::unique_ptr<PjRtCompilationCacheBackend> backend_;
+
+  mutable absl::Mutex mu_;
+  LRUCache<std::string, std::shared_ptr<Entry>>::LRUList lru_list_;
+  LRUCache<std::string, std::shared_ptr<Entry>> cache_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_PJRT_COMPILATION_CACHE_H_
@@ -0,0 +1,131 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/pjrt/compilation_cache.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "tensorflow/compiler/xla/client/xla_builder.h"
+#include "tensorflow/compiler/xla/pjrt/cpu_device.h"
+#include "tensorflow/compiler/xla/test.h"
+
+namespace xla {
+namespace {
+
+XlaComputation AddConstant(float value) {
+  XlaBuilder builder("add_constant");
+  XlaOp x = Parameter(&builder, 0, ShapeUtil::MakeShape(F32, {4}), "x");
+  Add(x, ConstantR0<float>(&builder, value));
+  return builder.Build().value();
+}
+
+class FakeBackend : public PjRtCompilationCacheBackend {
+ public:
+  StatusOr<std::optional<std::string>> Get(absl::string_view key) override {
+    ++*num_gets_;
+    return std::optional<std::string>();
+  }
+  Status Put(absl::string_view key,
+             absl::string_view serialized_executable) override {
+    return OkStatus();
+  }
+
+  int* num_gets_;
+};
+
+class PjRtCompilationCacheTest : public ::testing::Test {
+ protected:
+  PjRtCompilationCacheTest() : client_(GetCpuClient(true).value()) {}
+
+  std::unique_ptr<PjRtClient> client_;
+};
+
+TEST_F(PjRtCompilationCacheTest, KeyIgnoresInstructionIds) {
+  CompileOptions options;
+  // Each builder assigns fresh instruction ids.
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string first,
+      ComputeCompilationCacheKey(*client_, AddConstant(1), options));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string second,
+      ComputeCompilationCacheKey(*client_, AddConstant(1), options));
+  EXPECT_EQ(first, second);
+}
+
+TEST_F(PjRtCompilationCacheTest, KeyDependsOnConstantsAndOptions) {
+  CompileOptions options;
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string key,
+      ComputeCompilationCacheKey(*client_, AddConstant(1), options));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string other_constant,
+      ComputeCompilationCacheKey(*client_, AddConstant(2), options));
+  EXPECT_NE(key, other_constant);
+
+  options.parameter_is_tupled_arguments = true;
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string other_options,
+      ComputeCompilationCacheKey(*client_, AddConstant(1), options));
+  EXPECT_NE(key, other_options);
+}
+
+TEST_F(PjRtCompilationCacheTest, ReturnsCachedExecutable) {
+  PjRtCompilationCache cache(client_.get(), /*capacity=*/2);
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<PjRtExecutable> first,
+                          cache.GetOrCompile(AddConstant(1), {}));
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<PjRtExecutable> second,
+                          cache.GetOrCompile(AddConstant(1), {}));
+  EXPECT_EQ(first, second);
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<PjRtExecutable> other,
+                          cache.GetOrCompile(AddConstant(2), {}));
+  EXPECT_NE(first, other);
+  EXPECT_EQ(cache.Size(), 2);
+}
+
+TEST_F(PjRtCompilationCacheTest, EvictsLeastRecentlyUsed) {
+  PjRtCompilationCache cache(client_.get(), /*capacity=*/1);
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<PjRtExecutable> first,
+                          cache.GetOrCompile(AddConstant(1), {}));
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<PjRtExecutable> other,
+                          cache.GetOrCompile(AddConstant(2), {}));
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<PjRtExecutable> recompiled,
+                          cache.GetOrCompile(AddConstant(1), {}));
+  EXPECT_NE(first, recompiled);
+  EXPECT_EQ(cache.Size(), 1);
+}
+
+TEST_F(PjRtCompilationCacheTest, DoesNotCacheErrors) {
+  PjRtCompilationCache cache(client_.get(), /*capacity=*/2);
+  CompileOptions options;
+  options.argument_layouts = {ShapeUtil::MakeShape(S32, {4})};
+  EXPECT_FALSE(cache.GetOrCompile(AddConstant(1), options).ok());
+  EXPECT_EQ(cache.Size(), 0);
+}
+
+TEST_F(PjRtCompilationCacheTest, ConsultsBackendOnMiss) {
+  int num_gets = 0;
+  auto backend = std::make_unique<FakeBackend>();
+  backend->num_gets_ = &num_gets;
+  PjRtCompilationCache cache(client_.get(), /*capacity=*/2,
+                             std::move(backend));
+  TF_ASSERT_OK(cache.GetOrCompile(AddConstant(1), {}).status());
+  TF_ASSERT_OK(cache.GetOrCompile(AddConstant(1), {}).status());
+  EXPECT_EQ(num_gets, 1);
+}
+
+}  // namespace
+}  // namespace xla
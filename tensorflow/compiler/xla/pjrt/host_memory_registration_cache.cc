@@ -0,0 +1,117 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/pjrt/host_memory_registration_cache.h"
+
+#include <memory>
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace xla {
+
+HostMemoryRegistrationCache::HostMemoryRegistrationCache(
+    se::StreamExecutor* executor, int64_t capacity_bytes)
+    : executor_(executor), capacity_bytes_(capacity_bytes) {}
+
+HostMemoryRegistrationCache::~HostMemoryRegistrationCache() {
+  absl::MutexLock lock(&mu_);
+  for (const auto& [data, entry] : entries_) {
+    CHECK_EQ(entry.num_users, 0)
+        << "Host memory at " << data << " is still in use by a transfer";
+    if (!executor_->HostMemoryUnregister(const_cast<void*>(data))) {
+      LOG(WARNING) << "Failed to unregister host memory at " << data;
+    }
+  }
+}
+
+std::shared_ptr<const void> HostMemoryRegistrationCache::Register(
+    const void* data, int64_t size) {
+  absl::MutexLock lock(&mu_);
+  auto it = entries_.find(data);
+  if (it != entries_.end()) {
+    Entry& entry = it->second;
+    if (entry.size < size && entry.num_users == 0) {
+      // The caller reuses the address for a larger buffer; register it anew.
+      UnregisterLocked(data);
+      it = entries_.end();
+    } else if (entry.size < size || entry.released) {
+      return nullptr;
+    }
+  }
+
+  if (it == entries_.end()) {
+    // Make room by dropping the least recently used idle registrations.
+    auto lru_it = lru_.end();
+    while (registered_bytes_ + size > capacity_bytes_ &&
+           lru_it != lru_.begin()) {
+      --lru_it;
+      const void* victim = *lru_it;
+      if (entries_.at(victim).num_users == 0) {
+        // Unregistering erases `victim` from `lru_`, so step past it first.
+        ++lru_it;
+        UnregisterLocked(victim);
+      }
+    }
+    if (registered_bytes_ + size > capacity_bytes_) {
+      return nullptr;
+    }
+    if (!executor_->HostMemoryRegister(const_cast<void*>(data), size)) {
+      return nullptr;
+    }
+    lru_.push_front(data);
+    it = entries_.emplace(data, Entry{size, 0, false, lru_.begin()}).first;
+    registered_bytes_ += size;
+  } else {
+    lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+  }
+
+  ++it->second.num_users;
+  return std::shared_ptr<const void>(
+      data, [this](const void* data) { Unuse(data); });
+}
+
+void HostMemoryRegistrationCache::Release(const void* data) {
+  absl::MutexLock lock(&mu_);
+  auto it = entries_.find(data);
+  if (it == entries_.end()) {
+    return;
+  }
+  if (it->second.num_users == 0) {
+    UnregisterLocked(data);
+  } else {
+    it->second.released = true;
+  }
+}
+
+void HostMemoryRegistrationCache::Unuse(const void* data) {
+  absl::MutexLock lock(&mu_);
+  Entry& entry = entries_.at(data);
+  if (--entry.num_users == 0 && entry.released) {
+    UnregisterLocked(data);
+  }
+}
+
+void HostMemoryRegistrationCache::UnregisterLocked(const void* data) {
+  auto it = entries_.find(data);
+  CHECK(it != entries_.end());
+  if (!executor_->HostMemoryUnregister(const_cast<void*>(data))) {
+    LOG(WARNING) << "Failed to unregister host memory at " << data;
+  }
+  registered_bytes_ -= it->second.size;
+  lru_.erase(it->second.lru_position);
+  entries_.erase(it);
+}
+
+}  // namespace xla
@@ -0,0 +1,88 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_PJRT_HOST_MEMORY_REGISTRATION_CACHE_H_
+#define TENSORFLOW_COMPILER_XLA_PJRT_HOST_MEMORY_REGISTRATION_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/compiler/xla/types.h"
+#include "tensorflow/core/platform/stream_executor.h"
+
+namespace xla {
+
+// Keeps caller-owned host buffers registered (page-locked) with a
+// StreamExecutor, so that host-to-device transfers can DMA straight from them
+// instead of going through a staging copy.
+//
+// Registering memory is expensive, so registrations outlive the transfers that
+// use them and are dropped in least-recently-used order once more than
+// `capacity_bytes` would be registered. Registrations that are in use by a
+// transfer are never dropped.
+class HostMemoryRegistrationCache {
+ public:
+  HostMemoryRegistrationCache(se::StreamExecutor* executor,
+                              int64_t capacity_bytes);
+  ~HostMemoryRegistrationCache();
+
+  HostMemoryRegistrationCache(const HostMemoryRegistrationCache&) = delete;
+  HostMemoryRegistrationCache& operator=(const HostMemoryRegistrationCache&) =
+      delete;
+
+  // Registers the `size` bytes at `data`, or reuses an existing registration.
+  // The region stays registered at least as long as the returned handle is
+  // alive. Returns nullptr if the region can't be registered, e.g. because it
+  // doesn't fit in the cache or overlaps another registration; the caller
+  // should then fall back to a staging copy.
+  std::shared_ptr<const void> Register(const void* data, int64_t size);
+
+  // Drops the registration of `data`, as soon as no transfer uses it anymore.
+  // Must be called before the memory at `data` is freed.
+  void Release(const void* data);
+
+  int64_t registered_bytes() const {
+    absl::MutexLock lock(&mu_);
+    return registered_bytes_;
+  }
+
+ private:
+  struct Entry {
+    int64_t size;
+    int64_t num_users = 0;
+    bool released = false;
+    std::list<const void*>::iterator lru_position;
+  };
+
+  void Unuse(const void* data);
+  void UnregisterLocked(const void* data) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  se::StreamExecutor* const executor_;
+  const int64_t capacity_bytes_;
+
+  mutable absl::Mutex mu_;
+  int64_t registered_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+  absl::flat_hash_map<const void*, Entry> entries_ ABSL_GUARDED_BY(mu_);
+  // Registered regions, most recently used first.
+  std::list<const void*> lru_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_PJRT_HOST_MEMORY_REGISTRATION_CACHE_H_
@@ -0,0 +1,96 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/pjrt/host_memory_registration_cache.h"
+
+#include <memory>
+
+#include "tensorflow/compiler/xla/test.h"
+#include "tensorflow/core/platform/stream_executor.h"
+
+namespace xla {
+namespace {
+
+class HostMemoryRegistrationCacheTest : public ::testing::Test {
+ protected:
+  HostMemoryRegistrationCacheTest() {
+    se::Platform* platform =
+        se::MultiPlatformManager::PlatformWithName("Host").value();
+    executor_ = platform->ExecutorForDevice(0).value();
+  }
+
+  se::StreamExecutor* executor_;
+  char buffers_[4][64];
+};
+
+TEST_F(HostMemoryRegistrationCacheTest, ReusesRegistration) {
+  HostMemoryRegistrationCache cache(executor_, /*capacity_bytes=*/128);
+  std::shared_ptr<const void> first = cache.Register(buffers_[0], 64);
+  ASSERT_NE(first, nullptr);
+  std::shared_ptr<const void> second = cache.Register(buffers_[0], 32);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(cache.registered_bytes(), 64);
+}
+
+TEST_F(HostMemoryRegistrationCacheTest, EvictsLeastRecentlyUsed) {
+  HostMemoryRegistrationCache cache(executor_, /*capacity_bytes=*/128);
+  ASSERT_NE(cache.Register(buffers_[0], 64), nullptr);
+  ASSERT_NE(cache.Register(buffers_[1], 64), nullptr);
+  // Touch the first buffer, so that the second one is evicted.
+  ASSERT_NE(cache.Register(buffers_[0], 64), nullptr);
+  ASSERT_NE(cache.Register(buffers_[2], 64), nullptr);
+  EXPECT_EQ(cache.registered_bytes(), 128);
+
+  // Only the second buffer needs to be registered again, evicting the first.
+  ASSERT_NE(cache.Register(buffers_[2], 64), nullptr);
+  ASSERT_NE(cache.Register(buffers_[1], 64), nullptr);
+  EXPECT_EQ(cache.registered_bytes(), 128);
+}
+
+TEST_F(HostMemoryRegistrationCacheTest, DoesNotEvictBuffersInUse) {
+  HostMemoryRegistrationCache cache(executor_, /*capacity_bytes=*/128);
+  std::shared_ptr<const void> first = cache.Register(buffers_[0], 64);
+  std::shared_ptr<const void> second = cache.Register(buffers_[1], 64);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(cache.Register(buffers_[2], 64), nullptr);
+
+  second.reset();
+  EXPECT_NE(cache.Register(buffers_[2], 64), nullptr);
+  EXPECT_EQ(cache.registered_bytes(), 128);
+}
+
+TEST_F(HostMemoryRegistrationCacheTest, RejectsBuffersLargerThanCapacity) {
+  HostMemoryRegistrationCache cache(executor_, /*capacity_bytes=*/32);
+  EXPECT_EQ(cache.Register(buffers_[0], 64), nullptr);
+  EXPECT_EQ(cache.registered_bytes(), 0);
+}
+
+TEST_F(HostMemoryRegistrationCacheTest, ReleaseWaitsForLastUser) {
+  HostMemoryRegistrationCache cache(executor_, /*capacity_bytes=*/128);
+  std::shared_ptr<const void> handle = cache.Register(buffers_[0], 64);
+  ASSERT_NE(handle, nullptr);
+  cache.Release(buffers_[0]);
+  EXPECT_EQ(cache.registered_bytes(), 64);
+  // A released buffer can't be used for new transfers.
+  EXPECT_EQ(cache.Register(buffers_[0], 64), nullptr);
+
+  handle.reset();
+  EXPECT_EQ(cache.registered_bytes(), 0);
+  EXPECT_NE(cache.Register(buffers_[0], 64), nullptr);
+}
+
+}  // namespace
+}  // namespace xla
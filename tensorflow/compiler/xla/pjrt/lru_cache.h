@@ -86,6 +86,9 @@ class LRUCache {
   Value GetOrCreateIfAbsent(const Key& key,
                             const std::function<Value(const Key&)>& factory);
 
+  // Removes the entry for `key`, if present.
+  void Remove(const Key& key);
+
   // Removes all entries from the cache.
   void Clear();
 
@@ -129,6 +132,19 @@ void LRUCache<Key, Value, Hash, Eq>::Clear() {
   entries_.clear();
 }
 
+template <typename Key, typename Value, typename Hash, typename Eq>
+void LRUCache<Key, Value, Hash, Eq>::Remove(const Key& key) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return;
+  }
+  LRUListEntry* l = &it->second;
+  l->next->prev = l->prev;
+  l->prev->next = l->next;
+  --lru_list_->size_;
+  entries_.erase(it);
+}
+
 template <typename Key, typename Value, typename Hash, typename Eq>
 LRUCache<Key, Value, Hash, Eq>::~LRUCache() {
   Clear();
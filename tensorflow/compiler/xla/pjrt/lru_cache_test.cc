@@ -47,6 +47,22 @@ TEST(LRUCache, Basics) {
   EXPECT_EQ(1, cache.Size());
 }
 
+TEST(LRUCache, Remove) {
+  LRUCache<int, int>::LRUList list(2);
+  LRUCache<int, int> cache(&list);
+  EXPECT_EQ(0, cache.GetOrCreateIfAbsent(0, [](int) { return 0; }));
+  EXPECT_EQ(1, cache.GetOrCreateIfAbsent(1, [](int) { return 1; }));
+  cache.Remove(0);
+  cache.Remove(42);
+  EXPECT_EQ(1, cache.Size());
+  EXPECT_EQ(1, list.Size());
+  // Removing an entry makes room for another one without evicting.
+  EXPECT_EQ(2, cache.GetOrCreateIfAbsent(2, [](int) { return 2; }));
+  EXPECT_EQ(1, cache.GetOrCreateIfAbsent(1, [](int) { return -1; }));
+  EXPECT_EQ(3, cache.GetOrCreateIfAbsent(0, [](int) { return 3; }));
+  EXPECT_EQ(2, cache.Size());
+}
+
 TEST(LRUCache, SharedLRUList) {
   LRUCache<int, int>::LRUList list(2);
   LRUCache<int, int> cache1(&list);
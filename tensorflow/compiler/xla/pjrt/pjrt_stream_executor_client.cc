@@ -266,6 +266,25 @@ PjRtStreamExecutorClient::GetHloCostAnalysis() {
       client_->backend().compiler()->ShapeSizeBytesFunction());
 }
 
+void PjRtStreamExecutorClient::EnableHostBufferRegistration(
+    int64_t capacity_bytes) {
+  CHECK(!addressable_devices_.empty());
+  // Registrations are made portable across devices by the backends that
+  // support them, so any executor will do.
+  se::StreamExecutor* executor =
+      tensorflow::down_cast<PjRtStreamExecutorDevice*>(addressable_devices_[0])
+          ->local_device_state()
+          ->executor();
+  host_registration_cache_ =
+      std::make_unique<HostMemoryRegistrationCache>(executor, capacity_bytes);
+}
+
+void PjRtStreamExecutorClient::ReleaseHostBuffer(const void* data) {
+  if (host_registration_cache_) {
+    host_registration_cache_->Release(data);
+  }
+}
+
 namespace {
 
 // Ensures that it is safe to deallocate any buffers that have been enqueued in
@@ -773,21 +792,33 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
     }
   }
 
+  // Independent transfers are spread over the device's host-to-device streams
+  // so that they can proceed concurrently.
+  se::Stream* h2d_stream = local_device->GetHostToDeviceStream();
   TF_ASSIGN_OR_RETURN(
       std::unique_ptr<PjRtStreamExecutorBuffer> py_buffer,
-      AllocateDestinationBuffer(compact_shape, device, local_device,
-                                local_device->host_to_device_stream(),
+      AllocateDestinationBuffer(compact_shape, device, local_device, h2d_stream,
                                 /*is_uninitialized_create=*/false, this));
 
   PjRtStreamExecutorBuffer::ScopedHold device_buffer(
       py_buffer->GetBufferWithUsageHold());
   CHECK(device_buffer.ok());
 
+  // A zero-copy buffer that is registered with the device can be transferred
+  // directly, without staging. The registration is held until the transfer
+  // completes.
+  std::shared_ptr<const void> host_registration;
+  if (host_registration_cache_ &&
+      host_buffer_semantics == HostBufferSemantics::kZeroCopy &&
+      host_and_device_strides_equal && size > 0) {
+    host_registration = host_registration_cache_->Register(data, size);
+  }
+
   // If necessary, allocate a host-side buffer for staging host-to-device
   // transfers. On GPU this is a buffer in pinned memory.
   std::shared_ptr<void> staging_buffer;
   if (host_buffer_semantics == HostBufferSemantics::kImmutableOnlyDuringCall ||
-      should_stage_host_to_device_transfers() ||
+      (should_stage_host_to_device_transfers() && !host_registration) ||
       !host_and_device_strides_equal) {
     void* ptr = host_memory_allocator()->AllocateRaw(
         tensorflow::Allocator::kAllocatorAlignment, size);
@@ -832,11 +863,12 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
   // TODO(misard) assess if it would be preferable to introduce a heuristic to
   // put the transfer into the calling thread for small literals.
   auto transfer_h2d =
-      [local_client = client(), transfer_manager, local_device, data, size,
-       movable_device_buffer{device_buffer.ToClosure()}, shape,
+      [local_client = client(), transfer_manager, local_device, h2d_stream,
+       data, size, movable_device_buffer{device_buffer.ToClosure()}, shape,
        py_buffer{py_buffer.get()},
        on_device_shape{py_buffer->on_device_shape()},
        staging_buffer{std::move(staging_buffer)},
+       host_registration{std::move(host_registration)},
        on_done_with_host_buffer{std::move(on_done_with_host_buffer)},
        host_buffer_semantics, transpose{std::move(transpose)}]() {
         PjRtStreamExecutorBuffer::ScopedHold device_buffer(
@@ -868,25 +900,25 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
               static_cast<const char*>(staging_buffer.get()),
               ShapeUtil::DeviceShapeToHostShape(on_device_shape));
           TF_CHECK_OK(transfer_manager->TransferLiteralToDeviceAsync(
-              local_device->host_to_device_stream(), literal, buffer));
+              h2d_stream, literal, buffer));
         } else {
           BorrowingLiteral literal(
               reinterpret_cast<const char*>(data),
               ShapeUtil::DeviceShapeToHostShape(on_device_shape));
           // Otherwise, just transfer the literal.
           TF_CHECK_OK(transfer_manager->TransferLiteralToDeviceAsync(
-              local_device->host_to_device_stream(), literal, buffer));
+              h2d_stream, literal, buffer));
         }
 
         std::shared_ptr<BufferSequencingEvent> event =
             device_buffer->definition_events()[0];
         TF_CHECK_OK(AddDestinationBufferSynchronization(
-            local_device, std::move(device_buffer), event,
-            local_device->host_to_device_stream()));
+            local_device, std::move(device_buffer), event, h2d_stream));
 
         local_device->ThenExecuteCallback(
-            local_device->host_to_device_stream(),
+            h2d_stream,
             [staging_buffer{std::move(staging_buffer)},
+             host_registration{std::move(host_registration)},
              on_done_with_host_buffer{std::move(on_done_with_host_buffer)}]() {
               if (on_done_with_host_buffer) {
                 on_done_with_host_buffer();
@@ -949,10 +981,10 @@ PjRtStreamExecutorClient::BufferFromHostLiteral(const LiteralSlice& literal,
   TF_ASSIGN_OR_RETURN(
       Shape compact_shape,
       transfer_manager->ChooseCompactLayoutForShape(literal.shape()));
+  se::Stream* h2d_stream = local_device->GetHostToDeviceStream();
   TF_ASSIGN_OR_RETURN(
       std::unique_ptr<PjRtStreamExecutorBuffer> py_buffer,
-      AllocateDestinationBuffer(compact_shape, device, local_device,
-                                local_device->host_to_device_stream(),
+      AllocateDestinationBuffer(compact_shape, device, local_device, h2d_stream,
                                 /*is_uninitialized_create=*/false, this));
 
   PjRtStreamExecutorBuffer::ScopedHold device_buffer(
@@ -966,6 +998,7 @@ PjRtStreamExecutorClient::BufferFromHostLiteral(const LiteralSlice& literal,
   // TODO(misard) assess if it would be preferable to introduce a heuristic to
   // put the transfer into the calling thread for small literals.
   auto transfer_h2d = [local_client = client(), transfer_manager, local_device,
+                       h2d_stream,
                        movable_device_buffer{device_buffer.ToClosure()},
                        literal, py_buffer{py_buffer.get()},
                        on_device_shape{py_buffer->on_device_shape()}]() {
@@ -976,7 +1009,6 @@ PjRtStreamExecutorClient::BufferFromHostLiteral(const LiteralSlice& literal,
     // memory that has already been allocated, and a possible Event
     // allocation.
 
-    se::Stream* h2d_stream = local_device->host_to_device_stream();
     ShapedBuffer buffer = device_buffer->AsShapedBuffer(on_device_shape);
     TF_CHECK_OK(transfer_manager->TransferLiteralToDeviceAsync(
         h2d_stream, literal, buffer));
@@ -35,6 +35,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/client/xla_computation.h"
 #include "tensorflow/compiler/xla/layout.h"
 #include "tensorflow/compiler/xla/literal.h"
+#include "tensorflow/compiler/xla/pjrt/host_memory_registration_cache.h"
 #include "tensorflow/compiler/xla/pjrt/local_device_state.h"
 #include "tensorflow/compiler/xla/pjrt/pjrt_client.h"
 #include "tensorflow/compiler/xla/pjrt/pjrt_future.h"
@@ -277,6 +278,16 @@ class PjRtStreamExecutorClient : public PjRtClient {
     return should_stage_host_to_device_transfers_;
   }
 
+  // Lets BufferFromHostBuffer DMA directly from kZeroCopy host buffers instead
+  // of copying them into a staging buffer first, by registering (pinning) up
+  // to `capacity_bytes` of caller-owned host memory with the device. Callers
+  // that enable this must call ReleaseHostBuffer before freeing or reusing any
+  // host memory they passed as kZeroCopy. Must be called before any transfer
+  // is enqueued.
+  void EnableHostBufferRegistration(int64_t capacity_bytes);
+  // Drops the registration of the host buffer at `data`, if any.
+  void ReleaseHostBuffer(const void* data);
+
   gpu::GpuExecutableRunOptions* gpu_run_options() const {
     return gpu_run_options_.get();
   }
@@ -343,6 +354,11 @@ class PjRtStreamExecutorClient : public PjRtClient {
   se::DeviceMemoryAllocator* allocator_;
   std::unique_ptr<se::DeviceMemoryAllocator> owned_allocator_;
 
+  // Registered host buffers used for zero-copy transfers, or nullptr if
+  // registration isn't enabled. Must outlive the devices, whose destructors
+  // wait for transfers that hold registrations to complete.
+  std::unique_ptr<HostMemoryRegistrationCache> host_registration_cache_;
+
   // Includes all devices, including non-local devices on multi-host platforms.
   std::vector<std::unique_ptr<PjRtStreamExecutorDevice>> owned_devices_;
   // Pointers to `owned_devices_`.
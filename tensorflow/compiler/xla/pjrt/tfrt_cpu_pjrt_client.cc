@@ -183,6 +183,23 @@ TfrtCpuClient::TfrtCpuClient(
 
 TfrtCpuClient::~TfrtCpuClient() { LOG(INFO) << "TfrtCpuClient destroyed."; }
 
+std::shared_ptr<Eigen::ThreadPoolDevice>
+TfrtCpuClient::AcquireEigenIntraopDevice() {
+  int num_inflight = ++num_inflight_executions_;
+  int num_threads = eigen_intraop_pool_->NumThreads();
+  // Round up, so that the pool stays busy when executions don't divide it
+  // evenly. Eigen's pool balances the resulting tasks by work stealing.
+  int parallelism =
+      std::max(1, (num_threads + num_inflight - 1) / num_inflight);
+  return std::shared_ptr<Eigen::ThreadPoolDevice>(
+      new Eigen::ThreadPoolDevice(eigen_intraop_pool_->AsEigenThreadPool(),
+                                  parallelism),
+      [this](Eigen::ThreadPoolDevice* device) {
+        --num_inflight_executions_;
+        delete device;
+      });
+}
+
 StatusOr<PjRtDevice*> TfrtCpuClient::LookupDevice(int device_id) const {
   auto it = id_to_device_.find(device_id);
   if (it != id_to_device_.end()) {
@@ -1613,7 +1630,6 @@ StatusOr<PjRtExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
   run_options.set_device_ordinal(device->local_hardware_id());
   // Need to keep device_assignment alive until execution completes.
   run_options.set_device_assignment(device_assignment.get());
-  run_options.set_intra_op_thread_pool(client_->eigen_intraop_device());
 
   // Schedule only one collective at a time.
   bool is_a_collective_launch = !!last_collective_launch_event;
@@ -1630,6 +1646,10 @@ StatusOr<PjRtExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
     tensorflow::port::ScopedFlushDenormal flush;
     tensorflow::port::ScopedSetRound round(FE_TONEAREST);
 
+    std::shared_ptr<Eigen::ThreadPoolDevice> intra_op_device =
+        client_->AcquireEigenIntraopDevice();
+    run_options.set_intra_op_thread_pool(intra_op_device.get());
+
     XlaCustomCallStatus status;
 
     // Call generated function.
@@ -1661,7 +1681,7 @@ StatusOr<PjRtExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
         [cpu_executable, result_buffer,
          buffer_pointers = std::move(buffer_pointers),
          buffer_table = std::move(buffer_table),
-         run_options = std::move(run_options),
+         run_options = std::move(run_options), client = client_,
          cpu_executable_copy = cpu_executable_,
          device_assignment = std::move(device_assignment),
          compute_reservation = std::move(compute_reservation),
@@ -1681,6 +1701,13 @@ StatusOr<PjRtExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
           tensorflow::port::ScopedFlushDenormal flush;
           tensorflow::port::ScopedSetRound round(FE_TONEAREST);
 
+          // Acquire the intra-op device only once the computation runs, so
+          // that executions still waiting for their inputs don't reduce the
+          // parallelism of running ones.
+          std::shared_ptr<Eigen::ThreadPoolDevice> intra_op_device =
+              client->AcquireEigenIntraopDevice();
+          run_options.set_intra_op_thread_pool(intra_op_device.get());
+
           XlaCustomCallStatus status;
 
           // Call generated function.
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_XLA_PJRT_TFRT_CPU_PJRT_CLIENT_H_
 #define TENSORFLOW_COMPILER_XLA_PJRT_TFRT_CPU_PJRT_CLIENT_H_
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -227,6 +228,13 @@ class TfrtCpuClient final : public PjRtClient {
     return eigen_intraop_device_.get();
   }
 
+  // Returns a device on the intra-op pool for one running execution. Its
+  // parallelism is the execution's share of the pool among the executions
+  // running concurrently, so that many small concurrent executions don't
+  // oversubscribe the pool. The execution counts as running until the returned
+  // device is destroyed.
+  std::shared_ptr<Eigen::ThreadPoolDevice> AcquireEigenIntraopDevice();
+
   tfrt::AsyncValueRef<CpuEvent> GetLastCollectiveLaunchEvent() {
     absl::MutexLock lock(&mu_);
     return last_collective_launch_event_.CopyRef();
@@ -253,6 +261,9 @@ class TfrtCpuClient final : public PjRtClient {
   // TODO(zhangqiaorjc): Use tfrt::compat::EigenHostContextThreadPool.
   std::unique_ptr<tensorflow::thread::ThreadPool> eigen_intraop_pool_;
   std::unique_ptr<Eigen::ThreadPoolDevice> eigen_intraop_device_;
+  // Number of running executions, i.e., of live devices returned by
+  // AcquireEigenIntraopDevice().
+  std::atomic<int> num_inflight_executions_{0};
 
   // Launching collectives are prone to deadlock when we use fixed-sized
   // threadpools since ExecuteHelper will block until all replicas reach the
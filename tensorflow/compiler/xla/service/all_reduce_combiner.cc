@@ -16,15 +16,21 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/all_reduce_combiner.h"
 
 #include <algorithm>
+#include <iterator>
 #include <list>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
 #include "tensorflow/compiler/xla/literal.h"
 #include "tensorflow/compiler/xla/service/all_reduce_key.h"
 #include "tensorflow/compiler/xla/service/collective_combiner_utils.h"
@@ -38,6 +44,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/shape_inference.h"
 #include "tensorflow/compiler/xla/shape_util.h"
 #include "tensorflow/compiler/xla/status_macros.h"
+#include "tensorflow/compiler/xla/util.h"
 #include "tensorflow/compiler/xla/xla_data.pb.h"
 #include "tensorflow/core/lib/core/errors.h"
 
@@ -106,6 +113,70 @@ Status CombineAllReduces(absl::Span<HloInstruction* const> to_combine) {
 }
 }  // namespace
 
+/* static */
+StatusOr<AllReduceLatencyProfile> AllReduceLatencyProfile::Parse(
+    absl::string_view text) {
+  AllReduceLatencyProfile profile;
+  for (absl::string_view line : absl::StrSplit(text, '\n')) {
+    line = absl::StripAsciiWhitespace(line);
+    if (line.empty() || absl::StartsWith(line, "#")) {
+      continue;
+    }
+    std::vector<absl::string_view> fields =
+        absl::StrSplit(line, ' ', absl::SkipWhitespace());
+    int64_t bytes;
+    double seconds;
+    if (fields.size() != 2 || !absl::SimpleAtoi(fields[0], &bytes) ||
+        !absl::SimpleAtod(fields[1], &seconds) || bytes < 0 || seconds < 0) {
+      return InvalidArgument(
+          "Invalid all-reduce latency sample \"%s\", expected \"<bytes> "
+          "<seconds>\"",
+          line);
+    }
+    profile.samples_.emplace_back(bytes, seconds);
+  }
+  if (profile.samples_.empty()) {
+    return InvalidArgument("All-reduce latency profile has no samples");
+  }
+  absl::c_sort(profile.samples_);
+  return profile;
+}
+
+double AllReduceLatencyProfile::Seconds(int64_t bytes) const {
+  auto it = absl::c_lower_bound(
+      samples_, bytes, [](const std::pair<int64_t, double>& sample,
+                          int64_t bytes) { return sample.first < bytes; });
+  if (it == samples_.begin()) {
+    return it->second;
+  }
+  if (it == samples_.end()) {
+    return samples_.back().second;
+  }
+  auto prev = std::prev(it);
+  const double fraction = static_cast<double>(bytes - prev->first) /
+                          static_cast<double>(it->first - prev->first);
+  return prev->second + fraction * (it->second - prev->second);
+}
+
+int64_t AllReduceLatencyProfile::CombineThresholdBytes() const {
+  const double knee_seconds = 2 * samples_.front().second;
+  for (int64_t i = 1; i < samples_.size(); ++i) {
+    const auto& [bytes, seconds] = samples_[i];
+    if (seconds < knee_seconds) {
+      continue;
+    }
+    const auto& [prev_bytes, prev_seconds] = samples_[i - 1];
+    if (seconds == prev_seconds) {
+      return bytes;
+    }
+    const double fraction =
+        (knee_seconds - prev_seconds) / (seconds - prev_seconds);
+    return prev_bytes + static_cast<int64_t>(fraction * (bytes - prev_bytes));
+  }
+  // The fixed cost dominates over the whole profile.
+  return samples_.back().first;
+}
+
 AllReduceCombiner::AllReduceCombiner(int64_t combine_threshold_in_bytes,
                                      int64_t combine_threshold_count)
     : combine_threshold_in_bytes_(combine_threshold_in_bytes),
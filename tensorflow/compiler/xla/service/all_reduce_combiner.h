@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_XLA_SERVICE_ALL_REDUCE_COMBINER_H_
 #define TENSORFLOW_COMPILER_XLA_SERVICE_ALL_REDUCE_COMBINER_H_
 
+#include <utility>
+#include <vector>
+
 #include "absl/strings/string_view.h"
 #include "tensorflow/compiler/xla/array2d.h"
 #include "tensorflow/compiler/xla/service/hlo_module.h"
@@ -25,6 +28,31 @@ limitations under the License.
 
 namespace xla {
 
+// Latency of AllReduce ops as a function of their size, measured on the
+// devices a module is compiled for (e.g. with an all-reduce benchmark over the
+// same replica groups).
+class AllReduceLatencyProfile {
+ public:
+  // Parses a profile with one "<size in bytes> <latency in seconds>" sample per
+  // line. Empty lines and lines starting with '#' are ignored.
+  static StatusOr<AllReduceLatencyProfile> Parse(absl::string_view text);
+
+  // Returns the latency of an AllReduce of `bytes`, interpolated linearly
+  // between the samples and clamped to the first and last one.
+  double Seconds(int64_t bytes) const;
+
+  // Returns the size up to which combining AllReduce ops pays off: the size at
+  // which the latency is twice that of the smallest sample, i.e. where moving
+  // the data starts to dominate the fixed cost of the collective. Combining
+  // beyond this amortizes little latency while the combined op has to wait for
+  // all of its operands, which exposes more communication.
+  int64_t CombineThresholdBytes() const;
+
+ private:
+  // (size in bytes, latency in seconds), sorted by size.
+  std::vector<std::pair<int64_t, double>> samples_;
+};
+
 // Combines small non-dependent AllReduce ops into larger combined
 // AllReduce ops. A typical AllReduce implementation has a minimum
 // latency-induced time for a AllReduce op so a single combined op can be
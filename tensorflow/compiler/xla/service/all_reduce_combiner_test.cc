@@ -470,5 +470,47 @@ ENTRY %comp {
       op::Tuple(op::GetTupleElement(crs1, 0), op::GetTupleElement(crs1, 1)));
 }
 
+TEST(AllReduceLatencyProfileTest, InterpolatesSamples) {
+  TF_ASSERT_OK_AND_ASSIGN(AllReduceLatencyProfile profile,
+                          AllReduceLatencyProfile::Parse(R"(
+    # bytes seconds
+    4096 20e-6
+
+    1024 10e-6
+    16384 60e-6
+  )"));
+  EXPECT_DOUBLE_EQ(profile.Seconds(0), 10e-6);
+  EXPECT_DOUBLE_EQ(profile.Seconds(1024), 10e-6);
+  EXPECT_DOUBLE_EQ(profile.Seconds(2560), 15e-6);
+  EXPECT_DOUBLE_EQ(profile.Seconds(16384), 60e-6);
+  EXPECT_DOUBLE_EQ(profile.Seconds(1 << 20), 60e-6);
+  // The latency doubles over the smallest sample at 4096 bytes.
+  EXPECT_EQ(profile.CombineThresholdBytes(), 4096);
+}
+
+TEST(AllReduceLatencyProfileTest, ThresholdBetweenSamples) {
+  TF_ASSERT_OK_AND_ASSIGN(AllReduceLatencyProfile profile,
+                          AllReduceLatencyProfile::Parse("0 10\n"
+                                                         "1000 15\n"
+                                                         "2000 30\n"));
+  // 20 seconds is a third of the way from 15 to 30.
+  EXPECT_EQ(profile.CombineThresholdBytes(), 1333);
+}
+
+TEST(AllReduceLatencyProfileTest, LatencyBoundProfile) {
+  TF_ASSERT_OK_AND_ASSIGN(AllReduceLatencyProfile profile,
+                          AllReduceLatencyProfile::Parse("1 10\n"
+                                                         "1048576 11\n"));
+  EXPECT_EQ(profile.CombineThresholdBytes(), 1048576);
+}
+
+TEST(AllReduceLatencyProfileTest, RejectsInvalidProfiles) {
+  EXPECT_FALSE(AllReduceLatencyProfile::Parse("").ok());
+  EXPECT_FALSE(AllReduceLatencyProfile::Parse("# no samples").ok());
+  EXPECT_FALSE(AllReduceLatencyProfile::Parse("1024").ok());
+  EXPECT_FALSE(AllReduceLatencyProfile::Parse("1024 fast").ok());
+  EXPECT_FALSE(AllReduceLatencyProfile::Parse("-1 1e-5").ok());
+}
+
 }  // namespace
 }  // namespace xla
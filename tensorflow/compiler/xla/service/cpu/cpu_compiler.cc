@@ -18,9 +18,11 @@ limitations under the License.
 #include <stddef.h>
 #include <string.h>
 
+#include <algorithm>
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <stack>
 #include <string>
 #include <tuple>
@@ -33,10 +35,13 @@ limitations under the License.
 #include "absl/base/call_once.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Triple.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Mangler.h"
@@ -47,9 +52,12 @@ limitations under the License.
 #include "llvm/Support/CodeGen.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "mlir/Conversion/AffineToStandard/AffineToStandard.h"  // from @llvm-project
 #include "mlir/Conversion/ArithmeticToLLVM/ArithmeticToLLVM.h"  // from @llvm-project
 #include "mlir/Conversion/BufferizationToMemRef/BufferizationToMemRef.h"  // from @llvm-project
@@ -190,8 +198,11 @@ limitations under the License.
 #include "tensorflow/compiler/xla/types.h"
 #include "tensorflow/compiler/xla/util.h"
 #include "tensorflow/compiler/xla/xla_data.pb.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
 
 namespace {
@@ -722,7 +733,8 @@ llvm::CodeGenOpt::Level CodeGenOptLevel(const HloModuleConfig& module_config) {
 std::pair<LLVMCompiler::ModuleHook, LLVMCompiler::ModuleHook> GetIRModuleHooks(
     const HloModule& hlo_module,
     const LLVMCompiler::ModuleHook& user_pre_optimization_hook,
-    const LLVMCompiler::ModuleHook& user_post_optimization_hook) {
+    const LLVMCompiler::ModuleHook& user_post_optimization_hook,
+    absl::string_view filename_suffix = "") {
   // Create the IR hooks. If applicable, each IR hook does the following:
   //
   //  * Calls the user supplied module hook.
@@ -730,14 +742,15 @@ std::pair<LLVMCompiler::ModuleHook, LLVMCompiler::ModuleHook> GetIRModuleHooks(
   //    --xla_dump_to
   const HloModule* hlo_module_ptr = &hlo_module;
   auto hook = [user_pre_optimization_hook, user_post_optimization_hook,
-               hlo_module_ptr](bool optimized,
-                               const llvm::Module& llvm_module) {
+               hlo_module_ptr, filename_suffix = std::string(filename_suffix)](
+                  bool optimized, const llvm::Module& llvm_module) {
     const auto& user_hook =
         !optimized ? user_pre_optimization_hook : user_post_optimization_hook;
     if (user_hook) {
       user_hook(llvm_module);
     }
-    llvm_ir::DumpIrIfEnabled(*hlo_module_ptr, llvm_module, optimized);
+    llvm_ir::DumpIrIfEnabled(*hlo_module_ptr, llvm_module, optimized,
+                             filename_suffix);
   };
   return {[hook](const llvm::Module& llvm_module) {
             return hook(/*optimized=*/false, llvm_module);
@@ -842,11 +855,14 @@ namespace {
 // Dumps machine code if dumping is enabled for the module.
 struct OrcJITPostCompilationHook {
   // Gets an std::function that implements this hook.
+  // `file_suffix` distinguishes the objects of a module that is compiled in
+  // several parts.
   static std::function<void(const llvm::object::ObjectFile& obj_file)> Create(
-      const HloModule* module) {
+      const HloModule* module, absl::string_view file_suffix = "o") {
     // This struct is not copyable, but std::functions must be.  So to create an
     // std::function out of this struct, we have to wrap it in a shared_ptr.
-    auto wrapped = std::make_shared<OrcJITPostCompilationHook>(module);
+    auto wrapped =
+        std::make_shared<OrcJITPostCompilationHook>(module, file_suffix);
     return [wrapped](const llvm::object::ObjectFile& obj_file) {
       (*wrapped)(obj_file);
     };
@@ -854,22 +870,134 @@ struct OrcJITPostCompilationHook {
 
   // Constructor can't be private because we want to call it from
   // std::make_shared, but users should call Create() instead.
-  explicit OrcJITPostCompilationHook(const HloModule* module)
-      : module(module) {}
+  OrcJITPostCompilationHook(const HloModule* module,
+                            absl::string_view file_suffix)
+      : module(module), file_suffix(file_suffix) {}
 
  private:
   void operator()(const llvm::object::ObjectFile& obj_file) {
     if (!DumpingEnabledForHloModule(*module)) {
       return;
     }
-    DumpToFileInDir(*module, /*file_prefix=*/"", /*file_suffix=*/"o",
+    DumpToFileInDir(*module, /*file_prefix=*/"", file_suffix,
                     absl::string_view(obj_file.getData().data(),
                                       obj_file.getData().size()));
   }
 
   const HloModule* module;
+  const std::string file_suffix;
 };
 
+// Optimizes and compiles one part of a split LLVM module, serialized as
+// `bitcode`, to an object file. The part is parsed into its own LLVMContext
+// and compiled with its own TargetMachine, so parts can be compiled
+// concurrently.
+StatusOr<std::unique_ptr<llvm::MemoryBuffer>> CompileModulePart(
+    const HloModule& hlo_module, const std::string& bitcode, int part,
+    const LLVMCompiler::ModuleHook& user_pre_optimization_hook,
+    const LLVMCompiler::ModuleHook& user_post_optimization_hook) {
+  llvm::LLVMContext llvm_context;
+  llvm::Expected<std::unique_ptr<llvm::Module>> llvm_module =
+      llvm::parseBitcodeFile(
+          llvm::MemoryBufferRef(bitcode, absl::StrCat("part-", part)),
+          llvm_context);
+  if (!llvm_module) {
+    return InternalError("Failed to parse part %d of the LLVM module: %s", part,
+                         llvm::toString(llvm_module.takeError()));
+  }
+
+  const HloModuleConfig& config = hlo_module.config();
+  llvm::CodeGenOpt::Level opt_level = CodeGenOptLevel(config);
+  std::unique_ptr<llvm::TargetMachine> target_machine =
+      SimpleOrcJIT::InferTargetMachineForJIT(CompilerTargetOptions(config),
+                                             opt_level);
+  std::string suffix = absl::StrCat("part-", part);
+  LLVMCompiler::ModuleHook pre_optimization_ir_hook;
+  LLVMCompiler::ModuleHook post_optimization_ir_hook;
+  std::tie(pre_optimization_ir_hook, post_optimization_ir_hook) =
+      GetIRModuleHooks(hlo_module, user_pre_optimization_hook,
+                       user_post_optimization_hook, suffix);
+  CompilerFunctor compiler_functor(
+      target_machine.get(), opt_level,
+      options::OptimizeForSizeRequested(config),
+      config.debug_options().xla_llvm_disable_expensive_passes(),
+      llvm_ir::GetCpuFastMathFlags(config), pre_optimization_ir_hook,
+      post_optimization_ir_hook,
+      OrcJITPostCompilationHook::Create(&hlo_module,
+                                        absl::StrCat(suffix, ".o")));
+  llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> object =
+      compiler_functor(**llvm_module);
+  if (!object) {
+    return InternalError("Failed to compile part %d of the LLVM module: %s",
+                         part, llvm::toString(object.takeError()));
+  }
+  return std::move(*object);
+}
+
+// Splits `llvm_module` into up to `split_count` modules, compiles them to
+// object files concurrently and adds the objects to `jit`, which links them
+// together when the entry function is looked up. This is the CPU counterpart
+// of the parallel PTX compilation in the GPU compiler.
+Status CompileModuleInParallel(
+    const HloModule& hlo_module, std::unique_ptr<llvm::Module> llvm_module,
+    int split_count, const LLVMCompiler::ModuleHook& user_pre_optimization_hook,
+    const LLVMCompiler::ModuleHook& user_post_optimization_hook,
+    tensorflow::thread::ThreadPool* thread_pool, SimpleOrcJIT* jit) {
+  XLA_SCOPED_LOGGING_TIMER("CpuCompiler - Parallel LLVM codegen");
+  int num_functions = 0;
+  for (const llvm::Function& function : llvm_module->functions()) {
+    if (!function.isDeclaration()) {
+      ++num_functions;
+    }
+  }
+
+  // LLVM contexts are not thread-safe, so every part is serialized here and
+  // parsed again into a fresh context by the thread compiling it. Local
+  // symbols referenced from several parts are externalized by SplitModule.
+  std::vector<std::string> parts;
+  llvm::SplitModule(
+      *llvm_module, std::max(1, std::min(split_count, num_functions)),
+      [&](std::unique_ptr<llvm::Module> part) {
+        std::string bitcode;
+        llvm::raw_string_ostream os(bitcode);
+        llvm::WriteBitcodeToFile(*part, os);
+        os.flush();
+        parts.push_back(std::move(bitcode));
+      },
+      /*PreserveLocals=*/false);
+  llvm_module.reset();
+  VLOG(1) << "Compiling " << hlo_module.name() << " in " << parts.size()
+          << " parts";
+
+  std::optional<tensorflow::thread::ThreadPool> owned_thread_pool;
+  if (thread_pool == nullptr) {
+    owned_thread_pool.emplace(tensorflow::Env::Default(), "xla-cpu-codegen",
+                              parts.size());
+    thread_pool = &*owned_thread_pool;
+  }
+  std::vector<StatusOr<std::unique_ptr<llvm::MemoryBuffer>>> objects(
+      parts.size());
+  tensorflow::BlockingCounter counter(parts.size());
+  for (int i = 0; i < parts.size(); ++i) {
+    thread_pool->Schedule([&, i] {
+      objects[i] =
+          CompileModulePart(hlo_module, parts[i], i, user_pre_optimization_hook,
+                            user_post_optimization_hook);
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+
+  for (StatusOr<std::unique_ptr<llvm::MemoryBuffer>>& object : objects) {
+    TF_RETURN_IF_ERROR(object.status());
+    if (llvm::Error error = jit->AddObjectFile(std::move(object).value())) {
+      return InternalError("Adding an object file to the JIT failed: %s",
+                           llvm::toString(std::move(error)));
+    }
+  }
+  return OkStatus();
+}
+
 void InitializeLLVMCommandLineOptions(const HloModuleConfig& config) {
   llvm_ir::InitializeLLVMCommandLineOptions(
       config.debug_options().xla_backend_extra_options());
@@ -1258,9 +1386,18 @@ StatusOr<std::unique_ptr<Executable>> CpuCompiler::RunBackend(
   TF_RETURN_IF_ERROR(VerifyLlvmModule(*llvm_module));
 
   // JIT compile the LLVM IR module to in-memory machine code.
-  llvm::orc::ThreadSafeModule thread_safe_module(std::move(llvm_module),
-                                                 std::move(llvm_context));
-  cantFail((*jit)->AddModule(std::move(thread_safe_module)));
+  const int parallel_codegen_split_count =
+      module->config().debug_options().xla_cpu_parallel_codegen_split_count();
+  if (parallel_codegen_split_count > 1) {
+    TF_RETURN_IF_ERROR(CompileModuleInParallel(
+        *module, std::move(llvm_module), parallel_codegen_split_count,
+        user_pre_optimization_hook_, user_post_optimization_hook_,
+        options.thread_pool, jit->get()));
+  } else {
+    llvm::orc::ThreadSafeModule thread_safe_module(std::move(llvm_module),
+                                                   std::move(llvm_context));
+    cantFail((*jit)->AddModule(std::move(thread_safe_module)));
+  }
 
   auto cpu_executable = std::make_unique<CpuExecutable>(
       std::move(*jit), std::move(assignment), std::move(module), function_name,
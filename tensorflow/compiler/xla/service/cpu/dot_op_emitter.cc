@@ -62,6 +62,14 @@ bool ShouldUseMultiThreadedEigen(const HloModuleConfig& config) {
   return config.debug_options().xla_cpu_multi_thread_eigen();
 }
 
+// Returns true if a GEMM with these dimensions is small enough that the
+// overhead of calling into the runtime and dispatching it onto the thread pool
+// dominates the arithmetic.
+bool IsSmallGemm(int64_t m, int64_t k, int64_t n) {
+  // TODO(sanjoy):  We should make these numbers micro-arch specific.
+  return k <= 128 && ((m <= 32 && n <= 128) || (m <= 128 && n <= 32));
+}
+
 // Represents a dot operation.  We use this in lieu of an `HloInstruction`
 // because we want to be able to create this for the "inner" dot operation in a
 // batch dot, for which there is no separate HLO instruction.
@@ -800,7 +808,11 @@ Status DotOpEmitter::EmitCallToRuntime() {
   // The two transpose_... parameters are actually booleans, but we use int32_t
   // to avoid target-dependent calling convention details.
 
-  bool multi_threaded = ShouldUseMultiThreadedEigen(hlo_module_config_);
+  MatMultDims mat_mult_dims = GetMatMultDims();
+  // Small GEMMs that can't be emitted inline still skip the thread pool.
+  bool multi_threaded =
+      ShouldUseMultiThreadedEigen(hlo_module_config_) &&
+      !IsSmallGemm(mat_mult_dims.m, mat_mult_dims.k, mat_mult_dims.n);
   bool use_mkl_dnn = hlo_module_config_.debug_options().xla_cpu_use_mkl_dnn();
   bool use_acl = hlo_module_config_.debug_options().xla_cpu_use_acl();
   PrimitiveType type = target_array_.GetShape().element_type();
@@ -887,8 +899,6 @@ Status DotOpEmitter::EmitCallToRuntime() {
   //
   // Effectively this involves swapping the 'lhs' with 'rhs' and 'm' with 'n'.
 
-  MatMultDims mat_mult_dims = GetMatMultDims();
-
   CHECK_EQ(mat_mult_dims.lhs_column_major, mat_mult_dims.rhs_column_major);
 
   const llvm_ir::IrArray* lhs = &lhs_array_;
@@ -1157,22 +1167,19 @@ bool CanEmitTiledLlvmIrGemm(
     const TargetMachineFeatures& target_machine_features) {
   CHECK(IsAlignedGemm(dot_info, target_machine_features));
 
-  if (ShouldUseMultiThreadedEigen(config)) {
-    return false;
-  }
-
   int m = dot_info.result_shape.dimensions(0);
   int k = dot_info.lhs_shape.dimensions(
       dot_info.dim_nums.lhs_contracting_dimensions(0));
   int n = dot_info.result_shape.dimensions(1);
 
-  if (!options::ForceEnableExperimentalLlvmIrGemm(config)) {
-    // TODO(sanjoy):  We should make these numbers micro-arch specific.
-    bool small_gemm =
-        k <= 128 && ((m <= 32 && n <= 128) || (m <= 128 && n <= 32));
-    if (!small_gemm) {
-      return false;
-    }
+  // Small GEMMs are emitted inline even when Eigen is multi-threaded: they
+  // don't benefit from the thread pool.
+  bool small_gemm = IsSmallGemm(m, k, n);
+  if (ShouldUseMultiThreadedEigen(config) && !small_gemm) {
+    return false;
+  }
+  if (!options::ForceEnableExperimentalLlvmIrGemm(config) && !small_gemm) {
+    return false;
   }
 
   bool lhs_canonical = dot_info.dim_nums.lhs_contracting_dimensions(0) == 1;
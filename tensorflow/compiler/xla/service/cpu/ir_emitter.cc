@@ -1775,6 +1775,20 @@ StatusOr<bool> IrEmitter::EmitVectorizedReduce(
     return false;
   }
 
+  // When the reduction is the root of a parallel task, the most-major output
+  // dimensions are split across tasks by dynamic loop bounds. The vectorized
+  // loop nest honors them for all but the minor dimension, which it strides.
+  const int64_t num_dynamic_loop_bounds =
+      ShouldEmitParallelLoopFor(*reduce) ? num_dynamic_loop_bounds_ : 0;
+  if (num_dynamic_loop_bounds >= reduce->shape().dimensions_size()) {
+    *failure_reason = "parallel partitioning of the minor output dimension";
+    return false;
+  }
+  std::vector<std::pair<llvm::Value*, llvm::Value*>> dynamic_loop_bounds;
+  if (num_dynamic_loop_bounds > 0) {
+    dynamic_loop_bounds = compute_function_->GetDynamicLoopBounds();
+  }
+
   CHECK(!reduce->shape().IsTuple());
   TF_RETURN_IF_ERROR(EmitTargetAddressForOp(reduce));
 
@@ -1799,15 +1813,23 @@ StatusOr<bool> IrEmitter::EmitVectorizedReduce(
   //  }
 
   llvm_ir::ForLoopNest loop_nest(IrName(reduce), &b_);
-  std::vector<llvm::Value*> array_multi_index(
-      reduce->shape().dimensions_size());
+  const int64_t num_dims = reduce->shape().dimensions_size();
+  std::vector<llvm::Value*> array_multi_index(num_dims);
   for (int i = LayoutUtil::MinorToMajor(reduce->shape()).size() - 1; i > 0;
        --i) {
     int64_t dimension = LayoutUtil::Minor(reduce->shape().layout(), i);
-    int64_t start_index = 0;
-    int64_t end_index = reduce->shape().dimensions(dimension);
-    std::unique_ptr<llvm_ir::ForLoop> loop = loop_nest.AddLoop(
-        start_index, end_index, absl::StrFormat("dim.%d", dimension));
+    const int64_t bounds_index = num_dims - 1 - i;
+    std::unique_ptr<llvm_ir::ForLoop> loop;
+    if (bounds_index < num_dynamic_loop_bounds) {
+      loop = loop_nest.AddLoop(absl::StrFormat("dim.%d", dimension),
+                               dynamic_loop_bounds[bounds_index].first,
+                               dynamic_loop_bounds[bounds_index].second);
+    } else {
+      int64_t start_index = 0;
+      int64_t end_index = reduce->shape().dimensions(dimension);
+      loop = loop_nest.AddLoop(start_index, end_index,
+                               absl::StrFormat("dim.%d", dimension));
+    }
     array_multi_index[dimension] = loop->GetIndVarValue();
   }
 
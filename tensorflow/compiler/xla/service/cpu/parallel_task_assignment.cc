@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/service/cpu/parallel_task_assignment.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "absl/strings/str_cat.h"
@@ -28,6 +29,29 @@ limitations under the License.
 
 namespace xla {
 namespace cpu {
+namespace {
+
+// Returns the number of bytes 'instruction' works on, for the cost models that
+// compare it against the L2 cache size. The output of a reduction (or of a
+// loop fusion rooted at one) is much smaller than the data being reduced, so
+// the size of its operands is used instead.
+int64_t MemoryFootprint(const HloInstruction& instruction,
+                        const HloCostAnalysis::ShapeSizeFunction& shape_size) {
+  const HloInstruction* root = instruction.IsLoopFusion()
+                                   ? instruction.fused_expression_root()
+                                   : &instruction;
+  int64_t footprint = shape_size(instruction.shape());
+  if (root->opcode() == HloOpcode::kReduce) {
+    int64_t operand_bytes = 0;
+    for (const HloInstruction* operand : instruction.operands()) {
+      operand_bytes += shape_size(operand->shape());
+    }
+    footprint = std::max(footprint, operand_bytes);
+  }
+  return footprint;
+}
+
+}  // namespace
 
 class SimpleCostModel : public ParallelCostModel {
  public:
@@ -38,7 +62,7 @@ class SimpleCostModel : public ParallelCostModel {
 
   int64_t GetParallelTaskCount(HloInstruction* instruction) override {
     // Simple cost model based on hlo size and typical L2 cache size.
-    const int64_t instruction_cost = shape_size_(instruction->shape());
+    const int64_t instruction_cost = MemoryFootprint(*instruction, shape_size_);
     const int64_t min_cost_per_thread = 256LL << 10;  // 256KB L2 Cache size.
     // Return target parallel task count in [1, max_parallelism_].
     return std::min(
@@ -81,7 +105,7 @@ class DefaultCostModel : public ParallelCostModel {
           max_parallelism_,
           std::ceil(std::sqrt(tensorflow::port::MaxParallelism())));
       // Use shape size instruction cost and L2 cache size min per-thread cost.
-      instruction_cost = shape_size_(instruction->shape());
+      instruction_cost = MemoryFootprint(*instruction, shape_size_);
       min_cost_per_thread = 256LL << 10;  // 256KB L2 Cache size.
     } else {
       // Use max parallelism for compute bound instructions.
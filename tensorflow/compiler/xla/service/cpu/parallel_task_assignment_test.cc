@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/test.h"
 #include "tensorflow/compiler/xla/tests/hlo_test_base.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/cpu_info.h"
 
 namespace xla {
 namespace {
@@ -206,5 +207,36 @@ TEST_F(ParallelTaskAssignmentTest, ConstantNotParallelized) {
   EXPECT_FALSE(changed);
 }
 
+TEST_F(ParallelTaskAssignmentTest, ReduceWithSmallOutputParallelized) {
+  // The reduction reads 64MB but writes only 1KB, so its cost must be based on
+  // the size of its operand for it to be split across threads.
+  constexpr char hlo_string[] = R"(
+  HloModule TestTaskParallel_reduce
+    add {
+      lhs = f32[] parameter(0)
+      rhs = f32[] parameter(1)
+      ROOT add = f32[] add(lhs, rhs)
+    }
+    ENTRY reduce {
+      input = f32[256,65536] parameter(0)
+      zero = f32[] constant(0)
+      ROOT reduce = f32[256] reduce(input, zero), dimensions={1}, to_apply=add
+    }
+  )";
+
+  if (tensorflow::port::MaxParallelism() < 2) {
+    GTEST_SKIP() << "I/O bound instructions are not split on a single core";
+  }
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> m,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunParallelTaskAssigner(m.get()));
+  EXPECT_TRUE(changed);
+  const HloInstruction* root = m->entry_computation()->root_instruction();
+  ASSERT_EQ(root->opcode(), HloOpcode::kCall);
+  const HloInstruction* reduce = root->to_apply()->root_instruction();
+  EXPECT_EQ(reduce->opcode(), HloOpcode::kReduce);
+  EXPECT_FALSE(reduce->outer_dimension_partitions().empty());
+}
+
 }  // namespace
 }  // namespace xla
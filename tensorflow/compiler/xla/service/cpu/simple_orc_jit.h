@@ -28,6 +28,7 @@ limitations under the License.
 #include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/Orc/SymbolStringPool.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Target/TargetMachine.h"
 #include "tensorflow/compiler/xla/service/cpu/compiler_functor.h"
 #include "tensorflow/compiler/xla/types.h"
@@ -79,6 +80,11 @@ class SimpleOrcJIT : public llvm::JITEventListener {
 
   llvm::Error AddModule(llvm::orc::ThreadSafeModule module);
 
+  // Adds an object file that was already compiled for `target_machine()`.
+  // Symbols are resolved across all added modules and objects, so a module
+  // split into several objects is linked back together on lookup.
+  llvm::Error AddObjectFile(std::unique_ptr<llvm::MemoryBuffer> object);
+
   // Discards objects we no longer need once we are done compiling.
   void DoneCompiling();
 
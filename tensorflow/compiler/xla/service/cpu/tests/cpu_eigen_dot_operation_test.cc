@@ -40,9 +40,7 @@ std::string DotTestSpecToString(
   return PrimitiveType_Name(info.param.primitive_type);
 }
 
-class CpuEigenDotOperationTest
-    : public CpuCodegenTest,
-      public ::testing::WithParamInterface<DotTestSpec> {
+class CpuDotOperationTestBase : public CpuCodegenTest {
  protected:
   void CompileAndCheck(std::unique_ptr<HloComputation> entry_computation,
                        const std::string& filecheck_lines) {
@@ -61,6 +59,10 @@ class CpuEigenDotOperationTest
   }
 };
 
+class CpuEigenDotOperationTest
+    : public CpuDotOperationTestBase,
+      public ::testing::WithParamInterface<DotTestSpec> {};
+
 TEST_P(CpuEigenDotOperationTest, SimpleDotOp) {
   HloComputation::Builder builder(TestName());
   DotTestSpec spec = GetParam();
@@ -93,6 +95,22 @@ TEST_P(CpuEigenDotOperationTest, DotTransposeOp) {
   CompileAndCheck(builder.Build(), spec.filecheck_lines);
 }
 
+TEST_F(CpuDotOperationTestBase, SmallDotOpIsEmittedInline) {
+  // Small GEMMs are emitted as tiled LLVM IR even with a multi-threaded Eigen,
+  // instead of paying for a runtime call and thread pool dispatch.
+  HloComputation::Builder builder(TestName());
+  auto param_shape = ShapeUtil::MakeShape(F32, {16, 16});
+
+  HloInstruction* lhs = builder.AddInstruction(
+      HloInstruction::CreateParameter(0, param_shape, "input"));
+  HloInstruction* rhs = builder.AddInstruction(
+      HloInstruction::CreateParameter(1, param_shape, "input"));
+
+  builder.AddInstruction(CreateCanonicalDot(param_shape, lhs, rhs));
+  CompileAndCheck(builder.Build(),
+                  R"(CHECK-NOT: call void @__xla_cpu_runtime_{{.*}}MatMul)");
+}
+
 std::vector<DotTestSpec> GetDotTestCases() {
   std::vector<DotTestSpec> result;
   // The fp16 test runs a 32-bit matmul because we promote fp16 gemms to fp32
@@ -0,0 +1,89 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <string>
+
+#include "tensorflow/compiler/xla/service/cpu/cpu_compiler.h"
+#include "tensorflow/compiler/xla/service/cpu/tests/cpu_codegen_test.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+class CpuParallelCodegenTest : public CpuCodegenTest {
+  DebugOptions GetDebugOptionsForTest() override {
+    DebugOptions debug_options = CpuCodegenTest::GetDebugOptionsForTest();
+    debug_options.set_xla_cpu_parallel_codegen_split_count(4);
+    return debug_options;
+  }
+};
+
+// The computations and the constant below end up in different parts of the
+// split module, which must be linked back together by the JIT.
+TEST_F(CpuParallelCodegenTest, WhileWithFusionsAndConstant) {
+  const std::string hlo_text = R"(
+HloModule module
+
+f1 {
+  f1.p0 = s32[4] parameter(0)
+  ROOT f1.sum = s32[4] add(f1.p0, f1.p0)
+}
+
+f2 {
+  f2.p0 = s32[4] parameter(0)
+  f2.p1 = s32[4] parameter(1)
+  ROOT f2.sum = s32[4] add(f2.p0, f2.p1)
+}
+
+body {
+  body.p0 = (s32[], s32[4]) parameter(0)
+  i = s32[] get-tuple-element(body.p0), index=0
+  one = s32[] constant(1)
+  next_i = s32[] add(i, one)
+  v = s32[4] get-tuple-element(body.p0), index=1
+  sum2 = s32[4] fusion(v), kind=kLoop, calls=f1
+  sum3 = s32[4] fusion(sum2, v), kind=kLoop, calls=f2
+  ROOT t = (s32[], s32[4]) tuple(next_i, sum3)
+}
+
+cond {
+  cond.p0 = (s32[], s32[4]) parameter(0)
+  cond.i = s32[] get-tuple-element(cond.p0), index=0
+  cond.c2 = s32[] constant(2)
+  ROOT cond.root = pred[] compare(cond.i, cond.c2), direction=LT
+}
+
+ENTRY entry {
+  entry.c0 = s32[] constant(0)
+  entry.v = s32[4] constant({1, 2, 3, 4})
+  entry.t = (s32[], s32[4]) tuple(entry.c0, entry.v)
+  while = (s32[], s32[4]) while(entry.t), condition=cond, body=body
+  ROOT entry.root = s32[4] get-tuple-element(while), index=1
+}
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo_text));
+
+  // Compile and execute the computation.
+  auto result = ExecuteAndTransfer(module->Clone(), {});
+
+  // Each iteration of the loop triples the vector.
+  LiteralTestUtil::ExpectR1Equal<int32_t>({9, 18, 27, 36}, result);
+}
+
+}  // namespace
+}  // namespace cpu
+}  // namespace xla
@@ -0,0 +1,150 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/autotune_results.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/core/platform/env.h"
+
+namespace xla {
+namespace gpu {
+
+std::string AutotuneDeviceKey(se::StreamExecutor* stream_exec) {
+  const se::DeviceDescription& desc = stream_exec->GetDeviceDescription();
+  std::string dnn_version = "none";
+  if (auto* dnn = stream_exec->AsDnn()) {
+    StatusOr<se::dnn::VersionInfo> version_or = dnn->GetVersion();
+    if (version_or.ok()) {
+      dnn_version = absl::StrCat(version_or->major_version(), ".",
+                                 version_or->minor_version(), ".",
+                                 version_or->patch());
+    }
+  }
+  std::string blas_version = "none";
+  if (auto* blas = stream_exec->AsBlas()) {
+    (void)blas->GetVersion(&blas_version);
+  }
+  return absl::StrCat(desc.name(), "; cc ",
+                      desc.cuda_compute_capability().ToString(), "; driver ",
+                      desc.driver_version(), "; runtime ",
+                      desc.runtime_version(), "; dnn ", dnn_version,
+                      "; blas ", blas_version);
+}
+
+std::string AutotuneInstructionKey(const HloInstruction& instr) {
+  auto options = HloPrintOptions::Canonical();
+  options.set_print_backend_config(true);
+  return instr.ToString(options);
+}
+
+/*static*/ AutotuneResultsStore& AutotuneResultsStore::Global() {
+  static auto* store = new AutotuneResultsStore();
+  return *store;
+}
+
+std::optional<tensorflow::AutotuneResult> AutotuneResultsStore::Find(
+    const std::string& device, const std::string& hlo) const {
+  absl::MutexLock lock(&mutex_);
+  auto it = results_.find(Key(device, hlo));
+  if (it == results_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void AutotuneResultsStore::Insert(const std::string& device,
+                                  const std::string& hlo,
+                                  const tensorflow::AutotuneResult& result) {
+  absl::MutexLock lock(&mutex_);
+  results_.insert({Key(device, hlo), result});
+}
+
+Status AutotuneResultsStore::Load(const AutotuneResults& results) {
+  if (results.version() != kVersion) {
+    return InvalidArgument(
+        "Unsupported autotune results version %d, expected %d",
+        results.version(), kVersion);
+  }
+  absl::MutexLock lock(&mutex_);
+  for (const AutotuneResultsEntry& entry : results.results()) {
+    results_.insert({Key(entry.device(), entry.hlo()), entry.result()});
+  }
+  return OkStatus();
+}
+
+AutotuneResults AutotuneResultsStore::Serialize() const {
+  AutotuneResults results;
+  results.set_version(kVersion);
+  absl::MutexLock lock(&mutex_);
+  std::vector<const std::pair<const Key, tensorflow::AutotuneResult>*> sorted;
+  sorted.reserve(results_.size());
+  for (const auto& entry : results_) {
+    sorted.push_back(&entry);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const auto* a, const auto* b) { return a->first < b->first; });
+  for (const auto* entry : sorted) {
+    AutotuneResultsEntry* out = results.add_results();
+    out->set_device(entry->first.first);
+    out->set_hlo(entry->first.second);
+    *out->mutable_result() = entry->second;
+  }
+  return results;
+}
+
+Status AutotuneResultsStore::LoadFromFlags(const DebugOptions& debug_options) {
+  const std::string& path = debug_options.xla_gpu_load_autotune_results_from();
+  if (path.empty()) {
+    return OkStatus();
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!loaded_files_.insert(path).second) {
+      return OkStatus();
+    }
+  }
+  AutotuneResults results;
+  TF_RETURN_IF_ERROR(tensorflow::ReadTextOrBinaryProto(
+      tensorflow::Env::Default(), path, &results));
+  VLOG(1) << "Loaded " << results.results_size()
+          << " autotuning results from " << path;
+  return Load(results);
+}
+
+Status AutotuneResultsStore::DumpFromFlags(
+    const DebugOptions& debug_options) const {
+  const std::string& path = debug_options.xla_gpu_dump_autotune_results_to();
+  if (path.empty()) {
+    return OkStatus();
+  }
+  AutotuneResults results = Serialize();
+  VLOG(1) << "Writing " << results.results_size()
+          << " autotuning results to " << path;
+  if (absl::EndsWith(path, ".pbtxt") || absl::EndsWith(path, ".txt")) {
+    return tensorflow::WriteTextProto(tensorflow::Env::Default(), path,
+                                      results);
+  }
+  return tensorflow::WriteBinaryProto(tensorflow::Env::Default(), path,
+                                      results);
+}
+
+}  // namespace gpu
+}  // namespace xla
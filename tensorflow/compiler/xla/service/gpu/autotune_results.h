@@ -0,0 +1,84 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_AUTOTUNE_RESULTS_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_AUTOTUNE_RESULTS_H_
+
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_autotuning.pb.h"
+#include "tensorflow/compiler/xla/service/hlo_instruction.h"
+#include "tensorflow/compiler/xla/status.h"
+#include "tensorflow/compiler/xla/xla.pb.h"
+#include "tensorflow/core/platform/stream_executor_no_cuda.h"
+#include "tensorflow/core/protobuf/autotuning.pb.h"
+
+namespace xla {
+namespace gpu {
+
+// Returns a string identifying the device model of `stream_exec` and the
+// driver, cuDNN and cuBLAS versions it runs with. Autotuning results are only
+// reused on devices with the same identifier.
+std::string AutotuneDeviceKey(se::StreamExecutor* stream_exec);
+
+// Returns the canonical text of `instr`, including its backend config, that
+// autotuning results for it are keyed by.
+std::string AutotuneInstructionKey(const HloInstruction& instr);
+
+// Process-wide autotuning results of GemmAlgorithmPicker and
+// GpuConvAlgorithmPicker. Unlike the pickers' own caches, the results can be
+// serialized, so that they can be measured once and shared by many processes.
+class AutotuneResultsStore {
+ public:
+  // Version of the AutotuneResults proto produced by Serialize().
+  static constexpr int kVersion = 1;
+
+  static AutotuneResultsStore& Global();
+
+  std::optional<tensorflow::AutotuneResult> Find(const std::string& device,
+                                                 const std::string& hlo) const;
+  void Insert(const std::string& device, const std::string& hlo,
+              const tensorflow::AutotuneResult& result);
+
+  // Adds the entries of `results`. Results already in the store are kept.
+  Status Load(const AutotuneResults& results);
+  // Returns all results, sorted by their keys to make the output stable.
+  AutotuneResults Serialize() const;
+
+  // Loads the file named by xla_gpu_load_autotune_results_from, if any. Each
+  // file is only loaded once per process.
+  Status LoadFromFlags(const DebugOptions& debug_options);
+  // Writes the store to the file named by xla_gpu_dump_autotune_results_to, if
+  // any.
+  Status DumpFromFlags(const DebugOptions& debug_options) const;
+
+ private:
+  using Key = std::pair<std::string, std::string>;
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<Key, tensorflow::AutotuneResult> results_
+      ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_set<std::string> loaded_files_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_AUTOTUNE_RESULTS_H_
@@ -0,0 +1,100 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/autotune_results.h"
+
+#include <string>
+
+#include "tensorflow/compiler/xla/service/gpu/gpu_autotuning.pb.h"
+#include "tensorflow/compiler/xla/xla.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/autotuning.pb.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+tensorflow::AutotuneResult GemmResult(int64_t algorithm) {
+  tensorflow::AutotuneResult result;
+  result.mutable_gemm()->set_algorithm(algorithm);
+  return result;
+}
+
+TEST(AutotuneResultsStoreTest, FindsInsertedResults) {
+  AutotuneResultsStore store;
+  store.Insert("device", "hlo", GemmResult(13));
+  ASSERT_TRUE(store.Find("device", "hlo").has_value());
+  EXPECT_EQ(store.Find("device", "hlo")->gemm().algorithm(), 13);
+  EXPECT_FALSE(store.Find("other device", "hlo").has_value());
+  EXPECT_FALSE(store.Find("device", "other hlo").has_value());
+}
+
+TEST(AutotuneResultsStoreTest, SerializedResultsAreSorted) {
+  AutotuneResultsStore store;
+  store.Insert("device", "b", GemmResult(2));
+  store.Insert("device", "a", GemmResult(1));
+  AutotuneResults results = store.Serialize();
+  EXPECT_EQ(results.version(), AutotuneResultsStore::kVersion);
+  ASSERT_EQ(results.results_size(), 2);
+  EXPECT_EQ(results.results(0).hlo(), "a");
+  EXPECT_EQ(results.results(1).hlo(), "b");
+
+  AutotuneResultsStore loaded;
+  TF_ASSERT_OK(loaded.Load(results));
+  ASSERT_TRUE(loaded.Find("device", "b").has_value());
+  EXPECT_EQ(loaded.Find("device", "b")->gemm().algorithm(), 2);
+}
+
+TEST(AutotuneResultsStoreTest, LoadKeepsExistingResults) {
+  AutotuneResultsStore store;
+  store.Insert("device", "hlo", GemmResult(1));
+  AutotuneResultsStore other;
+  other.Insert("device", "hlo", GemmResult(2));
+  TF_ASSERT_OK(store.Load(other.Serialize()));
+  EXPECT_EQ(store.Find("device", "hlo")->gemm().algorithm(), 1);
+}
+
+TEST(AutotuneResultsStoreTest, RejectsUnknownVersion) {
+  AutotuneResults results;
+  results.set_version(AutotuneResultsStore::kVersion + 1);
+  AutotuneResultsStore store;
+  EXPECT_FALSE(store.Load(results).ok());
+}
+
+TEST(AutotuneResultsStoreTest, RoundTripsThroughFiles) {
+  for (const char* file_name :
+       {"autotune_results.pbtxt", "autotune_results.pb"}) {
+    std::string path =
+        tensorflow::io::JoinPath(tensorflow::testing::TmpDir(), file_name);
+    DebugOptions debug_options;
+    debug_options.set_xla_gpu_dump_autotune_results_to(path);
+    debug_options.set_xla_gpu_load_autotune_results_from(path);
+
+    AutotuneResultsStore store;
+    store.Insert("device", "hlo", GemmResult(7));
+    TF_ASSERT_OK(store.DumpFromFlags(debug_options));
+
+    AutotuneResultsStore loaded;
+    TF_ASSERT_OK(loaded.LoadFromFlags(debug_options));
+    ASSERT_TRUE(loaded.Find("device", "hlo").has_value());
+    EXPECT_EQ(loaded.Find("device", "hlo")->gemm().algorithm(), 7);
+  }
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
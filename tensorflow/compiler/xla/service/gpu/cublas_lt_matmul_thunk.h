@@ -35,7 +35,8 @@ class CublasLtMatmulThunk : public Thunk {
                       BufferAllocation::Slice b_buffer,
                       BufferAllocation::Slice c_buffer,
                       BufferAllocation::Slice d_buffer,
-                      BufferAllocation::Slice bias_buffer /* may be null */);
+                      BufferAllocation::Slice bias_buffer /* may be null */,
+                      BufferAllocation::Slice aux_buffer /* may be null */);
 
   Status ExecuteOnStream(const ExecuteParams& params) override;
 
@@ -47,6 +48,7 @@ class CublasLtMatmulThunk : public Thunk {
   BufferAllocation::Slice c_buffer_;
   BufferAllocation::Slice d_buffer_;
   BufferAllocation::Slice bias_buffer_;
+  BufferAllocation::Slice aux_buffer_;
   std::optional<se::cuda::BlasLt::MatmulAlgorithm> algorithm_;
 };
 
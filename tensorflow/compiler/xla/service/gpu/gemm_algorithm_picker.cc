@@ -21,6 +21,7 @@ limitations under the License.
 #include <tuple>
 #include <utility>
 
+#include "tensorflow/compiler/xla/service/gpu/autotune_results.h"
 #include "tensorflow/compiler/xla/service/gpu/backend_configs.pb.h"
 #include "tensorflow/compiler/xla/service/gpu/buffer_comparator.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_asm_opts_util.h"
@@ -75,19 +76,24 @@ se::RedzoneAllocator CreateRedzoneAllocator(
 }
 
 StatusOr<se::DeviceMemoryBase> CreateBuffer(se::RedzoneAllocator& allocator,
-                                            const HloInstruction& op,
+                                            const Shape& shape,
                                             const AutotuneConfig& config,
                                             int64_t& rng_state) {
-  TF_ASSIGN_OR_RETURN(
-      se::DeviceMemoryBase buffer,
-      allocator.AllocateBytes(ShapeUtil::ByteSizeOf(op.shape())));
+  TF_ASSIGN_OR_RETURN(se::DeviceMemoryBase buffer,
+                      allocator.AllocateBytes(ShapeUtil::ByteSizeOf(shape)));
   if (config.should_init_buffers()) {
-    InitializeBuffer(allocator.stream(), op.shape().element_type(), &rng_state,
+    InitializeBuffer(allocator.stream(), shape.element_type(), &rng_state,
                      buffer);
   }
   return buffer;
 }
 
+// Returns the shape of the GEMM result, which is the first element of the
+// output tuple for cublasLt matmuls with an auxiliary output.
+const Shape& GemmResultShape(const HloInstruction& gemm) {
+  return gemm.shape().IsTuple() ? gemm.shape().tuple_shapes(0) : gemm.shape();
+}
+
 // Returns the index (into `algorithms`) of the fastest algorithm.
 template <typename AlgoT>
 StatusOr<std::optional<size_t>> GetBestAlgorithm(
@@ -104,14 +110,15 @@ StatusOr<std::optional<size_t>> GetBestAlgorithm(
   TF_ASSIGN_OR_RETURN(GemmBackendConfig backend_config,
                       gemm.backend_config<GemmBackendConfig>());
 
+  const Shape& output_shape = GemmResultShape(gemm);
   se::DeviceMemoryBase reference_buffer;
   if (autotune_config.should_check_correctness()) {
     TF_ASSIGN_OR_RETURN(
         reference_buffer,
-        allocator.AllocateBytes(ShapeUtil::ByteSizeOf(gemm.shape())));
+        allocator.AllocateBytes(ShapeUtil::ByteSizeOf(output_shape)));
   }
 
-  BufferComparator comparator(gemm.shape(), gemm.GetModule()->config());
+  BufferComparator comparator(output_shape, gemm.GetModule()->config());
 
   std::vector<AutotuneResult> results;
   std::optional<int64_t> reference_algorithm;
@@ -122,7 +129,7 @@ StatusOr<std::optional<size_t>> GetBestAlgorithm(
     if (autotune_config.should_reinit_output_buffer() &&
         backend_config.beta() != 0) {
       int64_t rng_state = 0;
-      InitializeBuffer(stream, gemm.shape().element_type(), &rng_state,
+      InitializeBuffer(stream, output_shape.element_type(), &rng_state,
                        output_buffer);
     }
 
@@ -246,6 +253,20 @@ StatusOr<std::optional<se::blas::AlgorithmType>> DoGemmAutotune(
   cache_misses++;
   VLOG(4) << "Autotuning cache miss";
 
+  AutotuneResultsStore& results_store = AutotuneResultsStore::Global();
+  const std::string device_key = AutotuneDeviceKey(stream->parent());
+  const std::string hlo_key = AutotuneInstructionKey(*gemm);
+  if (std::optional<AutotuneResult> stored =
+          results_store.Find(device_key, hlo_key)) {
+    std::optional<se::blas::AlgorithmType> stored_algorithm;
+    if (stored->has_gemm()) {
+      stored_algorithm = stored->gemm().algorithm();
+    }
+    VLOG(4) << "Using stored autotuning result for " << gemm->name();
+    CHECK(cache.emplace(key, stored_algorithm).second);
+    return stored_algorithm;
+  }
+
   const DebugOptions& debug_options =
       gemm->GetModule()->config().debug_options();
   AutotuneConfig autotune_config = GetConfig(debug_options);
@@ -255,28 +276,37 @@ StatusOr<std::optional<se::blas::AlgorithmType>> DoGemmAutotune(
 
   int64_t rng_state = 0;
   TF_ASSIGN_OR_RETURN(se::DeviceMemoryBase lhs_buffer,
-                      CreateBuffer(buffer_allocator, *gemm->operand(0),
+                      CreateBuffer(buffer_allocator, gemm->operand(0)->shape(),
                                    autotune_config, rng_state));
   TF_ASSIGN_OR_RETURN(se::DeviceMemoryBase rhs_buffer,
-                      CreateBuffer(buffer_allocator, *gemm->operand(1),
+                      CreateBuffer(buffer_allocator, gemm->operand(1)->shape(),
+                                   autotune_config, rng_state));
+  TF_ASSIGN_OR_RETURN(se::DeviceMemoryBase output_buffer,
+                      CreateBuffer(buffer_allocator, GemmResultShape(*gemm),
                                    autotune_config, rng_state));
-  TF_ASSIGN_OR_RETURN(
-      se::DeviceMemoryBase output_buffer,
-      CreateBuffer(buffer_allocator, *gemm, autotune_config, rng_state));
 
   std::optional<se::blas::AlgorithmType> best_algorithm;
   if (IsCublasLtMatmul(*gemm)) {
     bool has_matrix_bias = config.beta != 0.;
-    bool has_vector_bias = gemm_config.epilogue() == GemmBackendConfig::BIAS;
+    bool has_vector_bias = EpilogueAddsVectorBias(gemm_config.epilogue());
 
-    auto epilogue = has_vector_bias ? se::cuda::BlasLt::Epilogue::kBias
-                                    : se::cuda::BlasLt::Epilogue::kDefault;
+    TF_ASSIGN_OR_RETURN(auto epilogue,
+                        cublas_lt::AsBlasLtEpilogue(gemm_config.epilogue()));
 
     se::DeviceMemoryBase bias_buffer;
     if (has_vector_bias) {
-      TF_ASSIGN_OR_RETURN(bias_buffer,
+      TF_ASSIGN_OR_RETURN(
+          bias_buffer,
+          CreateBuffer(buffer_allocator,
+                       gemm->operand(has_matrix_bias ? 3 : 2)->shape(),
+                       autotune_config, rng_state));
+    }
+
+    se::DeviceMemoryBase aux_buffer;
+    if (EpilogueHasAuxiliaryOutput(gemm_config.epilogue())) {
+      TF_ASSIGN_OR_RETURN(aux_buffer,
                           CreateBuffer(buffer_allocator,
-                                       *gemm->operand(has_matrix_bias ? 3 : 2),
+                                       gemm->shape().tuple_shapes(1),
                                        autotune_config, rng_state));
     }
 
@@ -298,7 +328,8 @@ StatusOr<std::optional<se::blas::AlgorithmType>> DoGemmAutotune(
               se::blas::ProfileResult profile_result;
               TF_RETURN_IF_ERROR(plan.ExecuteOnStream(
                   stream, lhs_buffer, rhs_buffer, output_buffer, output_buffer,
-                  bias_buffer, algorithm, scratch_allocator, &profile_result));
+                  bias_buffer, aux_buffer, algorithm, scratch_allocator,
+                  &profile_result));
               return std::move(profile_result);
             }));
 
@@ -331,6 +362,13 @@ StatusOr<std::optional<se::blas::AlgorithmType>> DoGemmAutotune(
     if (best_algorithm_idx) best_algorithm = algorithms[*best_algorithm_idx];
   }
 
+  // A result without an algorithm records that the generic API is used.
+  AutotuneResult stored;
+  if (best_algorithm) {
+    stored.mutable_gemm()->set_algorithm(*best_algorithm);
+  }
+  results_store.Insert(device_key, hlo_key, stored);
+
   CHECK(cache.emplace(key, best_algorithm).second);
   return best_algorithm;
 }
@@ -387,6 +425,10 @@ StatusOr<bool> GemmAlgorithmPicker::Run(
     return false;
   }
 
+  const DebugOptions& debug_options = module->config().debug_options();
+  TF_RETURN_IF_ERROR(
+      AutotuneResultsStore::Global().LoadFromFlags(debug_options));
+
   bool changed = false;
   for (HloComputation* computation :
        module->MakeNonfusionComputations(execution_threads)) {
@@ -394,6 +436,9 @@ StatusOr<bool> GemmAlgorithmPicker::Run(
         bool result, RunOnComputation(computation, stream_exec_, allocator_));
     changed |= result;
   }
+
+  TF_RETURN_IF_ERROR(
+      AutotuneResultsStore::Global().DumpFromFlags(debug_options));
   return changed;
 }
 
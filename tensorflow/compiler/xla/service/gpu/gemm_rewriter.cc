@@ -15,11 +15,15 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/service/gpu/gemm_rewriter.h"
 
+#include <cmath>
+#include <iterator>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_set.h"
 #include "tensorflow/compiler/xla/service/dfs_hlo_visitor_with_default.h"
 #include "tensorflow/compiler/xla/service/gpu/backend_configs.pb.h"
 #include "tensorflow/compiler/xla/service/gpu/cublas_cudnn.h"
@@ -112,6 +116,68 @@ HloInstruction *MaybeConstantFoldBias(HloInstruction *bias) {
   return bias;
 }
 
+// Returns a pattern for a broadcast scalar constant approximately equal to
+// `value`, to tolerate the rounding of the constants in activation functions.
+auto BcastConstScalarNear(double value) {
+  return m::Broadcast(m::ConstantScalar().WithPredicate(
+      [expected = value](const HloInstruction *instr) {
+        std::optional<double> actual =
+            Cast<const HloConstantInstruction>(instr)->literal().GetAsDouble(
+                {});
+        return actual.has_value() &&
+               std::abs(*actual - expected) <= 1e-4 * std::abs(expected);
+      }));
+}
+
+// Matches the tanh approximation of GELU,
+//
+//   x * 0.5 * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))),
+//
+// and returns `x`, or nullptr if `instr` is not the root of such an
+// expression.
+HloInstruction *MatchGeluApproximation(HloInstruction *instr) {
+  HloInstruction *x[5] = {};
+  auto cdf = m::AddAnyOrder(
+      BcastConstScalarNear(1.0),
+      m::Tanh(m::MultiplyAnyOrder(
+          BcastConstScalarNear(0.7978845608028654),  // sqrt(2 / pi)
+          m::AddAnyOrder(
+              m::Op(&x[0]),
+              m::MultiplyAnyOrder(
+                  BcastConstScalarNear(0.044715),
+                  m::MultiplyAnyOrder(
+                      m::Op(&x[1]),
+                      m::MultiplyAnyOrder(m::Op(&x[2]), m::Op(&x[3]))))))));
+  bool matched =
+      Match(instr, m::MultiplyAnyOrder(
+                       m::Op(&x[4]),
+                       m::MultiplyAnyOrder(BcastConstScalarNear(0.5), cdf))) ||
+      Match(instr, m::MultiplyAnyOrder(
+                       m::MultiplyAnyOrder(m::Op(&x[4]),
+                                           BcastConstScalarNear(0.5)),
+                       cdf));
+  if (!matched || absl::c_any_of(x, [&](const HloInstruction *op) {
+        return op != x[0];
+      })) {
+    return nullptr;
+  }
+  return x[0];
+}
+
+// Returns whether cublasLt can apply an activation epilogue to `matmul`; the
+// activation epilogues are only implemented for real floating-point types.
+bool SupportsActivationEpilogue(const HloInstruction &matmul) {
+  PrimitiveType type = matmul.shape().element_type();
+  return type == F16 || type == BF16 || type == F32;
+}
+
+// Returns whether cublasLt can write an auxiliary output for `matmul`, which
+// requires the leading dimension of the output to be a multiple of 8.
+bool SupportsAuxiliaryOutput(const HloInstruction &matmul) {
+  const Shape &shape = matmul.shape();
+  return shape.dimensions(shape.layout().minor_to_major(0)) % 8 == 0;
+}
+
 // The rewriting proceeds in a bottom-up way:
 //
 // (kDot A B) is rewritten into a (kCustomCall:gemm A B)
@@ -124,6 +190,12 @@ HloInstruction *MaybeConstantFoldBias(HloInstruction *bias) {
 // and provided C has no other users).
 // We then guide the buffer assignment to alias the buffer of the custom call
 // and C.
+//
+// For cublasLt matmuls, a ReLU (kMaximum with zero) or a tanh-approximated
+// GELU applied to the result, possibly after a vector bias add, is folded
+// into the matmul epilogue. If the pre-activation values have other users,
+// the GELU epilogue also writes them to an auxiliary output and the matmul
+// returns a (result, aux) tuple.
 class GemmRewriterVisitor : public DfsHloRewriteVisitor {
  public:
   Status HandleDot(HloInstruction *instr) override {
@@ -159,6 +231,11 @@ class GemmRewriterVisitor : public DfsHloRewriteVisitor {
   }
 
   Status HandleMultiply(HloInstruction *instr) override {
+    HloInstruction *gelu_input = MatchGeluApproximation(instr);
+    if (gelu_input != nullptr && IsCublasLtMatmul(*gelu_input)) {
+      return FuseGeluActivation(instr, gelu_input);
+    }
+
     HloInstruction *alpha, *existing_gemm;
     if (Match(instr,
               m::MultiplyAnyOrder(
@@ -238,6 +315,18 @@ class GemmRewriterVisitor : public DfsHloRewriteVisitor {
     return Status::OK();
   }
 
+  Status HandleMaximum(HloInstruction *instr) override {
+    HloInstruction *existing_gemm;
+    if (Match(instr, m::MaximumAnyOrder(
+                         m::Op(&existing_gemm)
+                             .WithCustomCallTarget(kCublasLtMatmulCallTarget)
+                             .WithOneUser(),
+                         m::Broadcast(m::ConstantScalar(0))))) {
+      return FuseReluActivation(instr, existing_gemm);
+    }
+    return OkStatus();
+  }
+
   Status HandleConvert(HloInstruction *instr) override {
     HloInstruction *bias, *existing_gemm;
     if (Match(
@@ -353,6 +442,94 @@ class GemmRewriterVisitor : public DfsHloRewriteVisitor {
     TF_RETURN_IF_ERROR(ReplaceWithNewInstruction(instr, std::move(fused_op)));
     return true;
   }
+
+  Status FuseReluActivation(HloInstruction *instr, HloInstruction *matmul) {
+    auto config = matmul->backend_config<GemmBackendConfig>().ValueOrDie();
+    if (!SupportsActivationEpilogue(*matmul)) {
+      return OkStatus();
+    }
+    switch (config.epilogue()) {
+      case GemmBackendConfig::DEFAULT:
+        config.set_epilogue(GemmBackendConfig::RELU);
+        break;
+      case GemmBackendConfig::BIAS:
+        config.set_epilogue(GemmBackendConfig::BIAS_RELU);
+        break;
+      default:
+        return OkStatus();
+    }
+
+    std::unique_ptr<HloInstruction> fused_op = matmul->Clone();
+    TF_RETURN_IF_ERROR(fused_op->set_backend_config(config));
+    TF_RETURN_IF_ERROR(SetName(instr->GetModule(), fused_op.get()));
+    return ReplaceWithNewInstruction(instr, std::move(fused_op));
+  }
+
+  Status FuseGeluActivation(HloInstruction *gelu, HloInstruction *matmul) {
+    auto config = matmul->backend_config<GemmBackendConfig>().ValueOrDie();
+    if (!SupportsActivationEpilogue(*matmul) ||
+        (config.epilogue() != GemmBackendConfig::DEFAULT &&
+         config.epilogue() != GemmBackendConfig::BIAS)) {
+      return OkStatus();
+    }
+    bool has_vector_bias = config.epilogue() == GemmBackendConfig::BIAS;
+
+    // Users of `matmul` outside of the GELU expression (e.g. the backward
+    // pass) still need the pre-activation values, which cublasLt can write to
+    // an auxiliary output at no extra read.
+    absl::flat_hash_set<const HloInstruction *> gelu_ops;
+    std::vector<const HloInstruction *> worklist = {gelu};
+    while (!worklist.empty()) {
+      const HloInstruction *op = worklist.back();
+      worklist.pop_back();
+      if (op != matmul && gelu_ops.insert(op).second) {
+        absl::c_copy(op->operands(), std::back_inserter(worklist));
+      }
+    }
+    std::vector<HloInstruction *> aux_users;
+    absl::c_copy_if(
+        matmul->users(), std::back_inserter(aux_users),
+        [&](const HloInstruction *user) { return !gelu_ops.contains(user); });
+    HloComputation *computation = gelu->parent();
+    bool matmul_is_root = computation->root_instruction() == matmul;
+    bool needs_aux = matmul_is_root || !aux_users.empty();
+    if (needs_aux && !SupportsAuxiliaryOutput(*matmul)) {
+      return OkStatus();
+    }
+
+    if (needs_aux) {
+      config.set_epilogue(has_vector_bias ? GemmBackendConfig::BIAS_GELU_AUX
+                                          : GemmBackendConfig::GELU_AUX);
+    } else {
+      config.set_epilogue(has_vector_bias ? GemmBackendConfig::BIAS_GELU
+                                          : GemmBackendConfig::GELU);
+    }
+
+    Shape output_shape = matmul->shape();
+    if (needs_aux) {
+      output_shape = ShapeUtil::MakeTupleShape({output_shape, output_shape});
+    }
+    std::unique_ptr<HloInstruction> fused_op =
+        matmul->CloneWithNewOperands(output_shape, matmul->operands());
+    TF_RETURN_IF_ERROR(fused_op->set_backend_config(config));
+    TF_RETURN_IF_ERROR(SetName(gelu->GetModule(), fused_op.get()));
+    if (!needs_aux) {
+      return ReplaceWithNewInstruction(gelu, std::move(fused_op));
+    }
+
+    HloInstruction *fused = computation->AddInstruction(std::move(fused_op));
+    HloInstruction *result = computation->AddInstruction(
+        HloInstruction::CreateGetTupleElement(fused, 0));
+    HloInstruction *aux = computation->AddInstruction(
+        HloInstruction::CreateGetTupleElement(fused, 1));
+    for (HloInstruction *user : aux_users) {
+      TF_RETURN_IF_ERROR(matmul->ReplaceUseWith(user, aux));
+    }
+    if (matmul_is_root) {
+      computation->set_root_instruction(aux);
+    }
+    return ReplaceInstruction(gelu, result);
+  }
 };
 
 StatusOr<bool> RunOnComputation(HloComputation *computation) {
@@ -160,6 +160,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/slice_sinker.h"
 #include "tensorflow/compiler/xla/service/slow_operation_alarm.h"
 #include "tensorflow/compiler/xla/service/sort_simplifier.h"
+#include "tensorflow/compiler/xla/service/spmd/auto_sharding.h"
 #include "tensorflow/compiler/xla/service/spmd/stateful_rng_spmd_partitioner.h"
 #include "tensorflow/compiler/xla/service/stable_sort_expander.h"
 #include "tensorflow/compiler/xla/service/transpose_folding.h"
@@ -359,6 +360,11 @@ Status GpuCompiler::OptimizeHloModule(
       spmd_simplify.AddPass<ConditionalSimplifier>();
       spmd_simplify.AddPass<HloDCE>();
 
+      if (hlo_module->config().use_auto_spmd_partitioning()) {
+        spmd::AutoSharding::Options auto_sharding_options;
+        auto_sharding_options.num_devices = num_partitions;
+        spmd_pipeline.AddPass<spmd::AutoSharding>(auto_sharding_options);
+      }
       spmd_pipeline.AddPass<ShardingPropagation>(
           /*is_spmd=*/true, /*propagate_metadata=*/false,
           hlo_module->config().allow_spmd_sharding_propagation_to_output());
@@ -624,13 +630,26 @@ Status GpuCompiler::OptimizeHloModule(
   }
 
   {
+    int64_t all_reduce_combine_threshold_bytes =
+        debug_options.xla_gpu_all_reduce_combine_threshold_bytes();
+    if (!debug_options.xla_gpu_all_reduce_latency_profile().empty()) {
+      std::string profile_text;
+      TF_RETURN_IF_ERROR(tensorflow::ReadFileToString(
+          tensorflow::Env::Default(),
+          debug_options.xla_gpu_all_reduce_latency_profile(), &profile_text));
+      TF_ASSIGN_OR_RETURN(AllReduceLatencyProfile profile,
+                          AllReduceLatencyProfile::Parse(profile_text));
+      all_reduce_combine_threshold_bytes = profile.CombineThresholdBytes();
+      VLOG(1) << "All-reduce combine threshold from latency profile: "
+              << all_reduce_combine_threshold_bytes << " bytes";
+    }
+
     HloPassPipeline pipeline("post-fusion optimization");
     pipeline.AddPass<AllGatherCombiner>(
         /*combine_threshold_in_bytes=*/1024 * 1024 * 1024,
         /*combine_threshold_count=*/256);
-    pipeline.AddPass<AllReduceCombiner>(
-        debug_options.xla_gpu_all_reduce_combine_threshold_bytes(),
-        /*combine_threshold_count=*/256);
+    pipeline.AddPass<AllReduceCombiner>(all_reduce_combine_threshold_bytes,
+                                        /*combine_threshold_count=*/256);
     pipeline.AddPass<ReduceScatterCombiner>(
         /*combine_threshold_in_bytes=*/30 * 1024 * 1024,
         /*combine_threshold_count=*/256);
@@ -25,6 +25,7 @@ limitations under the License.
 #include "absl/strings/str_format.h"
 #include "absl/time/time.h"
 #include "tensorflow/compiler/xla/literal_util.h"
+#include "tensorflow/compiler/xla/service/gpu/autotune_results.h"
 #include "tensorflow/compiler/xla/service/gpu/backend_configs.pb.h"
 #include "tensorflow/compiler/xla/service/gpu/convolution_thunk.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_asm_opts_util.h"
@@ -320,9 +321,7 @@ struct ConvCacheStats {
 
 ConvCacheKey AutotuneCacheKeyfromInstruction(
     const HloCustomCallInstruction* conv, se::StreamExecutor* se) {
-  auto options = HloPrintOptions::Canonical();
-  options.set_print_backend_config(true);
-  return std::make_tuple(se, conv->ToString(options));
+  return std::make_tuple(se, AutotuneInstructionKey(*conv));
 }
 
 absl::Mutex autotune_cache_lock(absl::kConstInit);
@@ -360,6 +359,17 @@ StatusOr<AutotuneResult> GpuConvAlgorithmPicker::PickBestAlgorithm(
     autotune_cache_stats.cache_misses++;
   }
 
+  // Results loaded from xla_gpu_load_autotune_results_from or measured by
+  // other executors of the same kind are as good as our own.
+  AutotuneResultsStore& results_store = AutotuneResultsStore::Global();
+  const std::string device_key = AutotuneDeviceKey(stream_exec_);
+  if (std::optional<AutotuneResult> stored =
+          results_store.Find(device_key, std::get<1>(key))) {
+    absl::MutexLock lock(&autotune_cache_lock);
+    autotune_cache.insert({key, *stored});
+    return *stored;
+  }
+
   // Make sure any previous activity on this executor is done. We don't want
   // other work still running on the GPU to interfere with autotuning.
   if (!stream_exec_->SynchronizeAllActivity()) {
@@ -394,6 +404,7 @@ StatusOr<AutotuneResult> GpuConvAlgorithmPicker::PickBestAlgorithm(
   }
 
   if (result_or.ok()) {
+    results_store.Insert(device_key, std::get<1>(key), *result_or);
     absl::MutexLock lock(&autotune_cache_lock);
     CHECK(autotune_cache.insert({key, result_or.ValueOrDie()}).second);
   }
@@ -1006,6 +1017,10 @@ StatusOr<bool> GpuConvAlgorithmPicker::Run(
     return false;
   }
 
+  const DebugOptions& debug_options = module->config().debug_options();
+  TF_RETURN_IF_ERROR(
+      AutotuneResultsStore::Global().LoadFromFlags(debug_options));
+
   bool changed = false;
   for (HloComputation* computation :
        module->MakeNonfusionComputations(execution_threads)) {
@@ -1018,6 +1033,8 @@ StatusOr<bool> GpuConvAlgorithmPicker::Run(
     autotune_cache_stats.LogStats();
   }
 
+  TF_RETURN_IF_ERROR(
+      AutotuneResultsStore::Global().DumpFromFlags(debug_options));
   return changed;
 }
 
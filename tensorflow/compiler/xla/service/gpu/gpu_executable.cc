@@ -23,6 +23,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
@@ -31,6 +32,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/gpu_constants.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_executable_run_options.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_types.h"
+#include "tensorflow/compiler/xla/service/gpu/sequential_thunk.h"
 #include "tensorflow/compiler/xla/service/gpu/stream_executor_util.h"
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
 #include "tensorflow/compiler/xla/service/hlo_parser.h"
@@ -49,6 +51,9 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/profiler/lib/scoped_annotation.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
+#include "tensorflow/stream_executor/gpu/gpu_driver.h"
+#include "tensorflow/stream_executor/gpu/gpu_executor.h"
+#include "tensorflow/stream_executor/gpu/gpu_stream.h"
 #include "tensorflow/stream_executor/platform.h"
 
 #if XLA_ENABLE_XLIR
@@ -59,8 +64,6 @@ limitations under the License.
 #include "tensorflow/compiler/mlir/utils/name_utils.h"
 #include "tensorflow/compiler/xla/service/gpu/jitrt_custom_calls.h"
 #include "tensorflow/compiler/xla/service/gpu/xlir_ops.h"
-#include "tensorflow/stream_executor/gpu/gpu_executor.h"
-#include "tensorflow/stream_executor/gpu/gpu_stream.h"
 #include "tfrt/gpu/gpu_executor.h"  // from @tf_runtime
 #include "tfrt/gpu/gpu_types.h"  // from @tf_runtime
 #include "tfrt/jitrt/diagnostics.h"  // from @tf_runtime
@@ -292,6 +295,28 @@ class GpuExecutable::JitRtExecutable {
 };
 #endif  // XLA_ENABLE_XLIR
 
+// The GPU graph captured from the thunks of this executable for one executor,
+// together with the buffer addresses baked into it.
+struct GpuExecutable::CapturedGraph {
+  ~CapturedGraph() { Reset(); }
+
+  void Reset() {
+    if (exec != nullptr) {
+      Status status = se::gpu::GpuDriver::DestroyGraphExec(context, exec);
+      if (!status.ok()) {
+        LOG(ERROR) << "Failed to destroy GPU graph: " << status;
+      }
+      exec = nullptr;
+    }
+    buffer_addresses.clear();
+  }
+
+  se::gpu::GpuContext* context = nullptr;
+  se::gpu::GpuGraphExecHandle exec = nullptr;
+  std::vector<const void*> buffer_addresses;
+  int64_t num_captures = 0;
+};
+
 StatusOr<std::unique_ptr<GpuExecutable>> GpuExecutable::Create(Params params) {
   auto executable = std::move(params.executable);
   auto gpu_ctx_cache = std::move(params.gpu_ctx_cache);
@@ -521,8 +546,115 @@ Status MaybeSyncAndProfile(const ServiceExecutableRunOptions* run_options,
   return OkStatus();
 }
 
+// Returns true if `thunk` only enqueues device work onto the stream it is
+// given, so that it can be captured into a GPU graph and replayed later.
+bool IsCaptureSafe(const Thunk& thunk) {
+  switch (thunk.kind()) {
+    case Thunk::kCopy:
+    case Thunk::kKernel:
+    case Thunk::kMemset32BitValue:
+    case Thunk::kMemzero:
+      return true;
+    case Thunk::kSequential:
+      return absl::c_all_of(
+          static_cast<const SequentialThunk&>(thunk).thunks(),
+          [](const std::unique_ptr<Thunk>& t) { return IsCaptureSafe(*t); });
+    default:
+      return false;
+  }
+}
+
+// A graph is re-captured when the buffer addresses change between executions.
+// Once this many captures did not pay off, the executable goes back to
+// launching its thunks one by one.
+constexpr int64_t kMaxGraphCaptures = 3;
+
 }  // namespace
 
+StatusOr<bool> GpuExecutable::MaybeExecuteThunksAsGraph(
+    const ServiceExecutableRunOptions* run_options,
+    const BufferAllocations& buffer_allocations, bool block_host_until_done) {
+  if (!has_module() ||
+      !module_config().debug_options().xla_gpu_enable_cuda_graphs() ||
+      thunks_->StreamCount() != 1 ||
+      !absl::c_all_of(thunks_->TotalOrder(),
+                      [](const std::unique_ptr<Thunk>& thunk) {
+                        return IsCaptureSafe(*thunk);
+                      })) {
+    return false;
+  }
+
+  se::Stream* stream = run_options->stream();
+  se::StreamExecutor* executor = stream->parent();
+
+  std::vector<const void*> buffer_addresses(allocations_.size());
+  for (BufferAllocation::Index i = 0; i < allocations_.size(); ++i) {
+    buffer_addresses[i] = buffer_allocations.GetDeviceAddress(i).opaque();
+  }
+
+  absl::MutexLock lock(&graph_mutex_);
+  std::unique_ptr<CapturedGraph>& graph = graphs_[executor];
+  if (graph == nullptr) {
+    graph = std::make_unique<CapturedGraph>();
+    graph->context = se::gpu::ExtractGpuExecutor(executor)->gpu_context();
+  }
+
+  if (graph->exec == nullptr || graph->buffer_addresses != buffer_addresses) {
+    graph->Reset();
+    if (graph->num_captures >= kMaxGraphCaptures) {
+      return false;
+    }
+    ++graph->num_captures;
+    VLOG(2) << "Capturing " << module_name_ << " into a GPU graph (capture "
+            << graph->num_captures << ")";
+
+    se::gpu::GpuStreamHandle stream_handle = se::gpu::AsGpuStreamValue(stream);
+    Status begin_status =
+        se::gpu::GpuDriver::StreamBeginCapture(graph->context, stream_handle);
+    if (!begin_status.ok()) {
+      // E.g. the platform does not support graphs; don't try again.
+      VLOG(1) << "Not using GPU graphs: " << begin_status;
+      graph->num_captures = kMaxGraphCaptures;
+      return false;
+    }
+    Status capture_status = OkStatus();
+    for (const std::unique_ptr<Thunk>& thunk : thunks_->TotalOrder()) {
+      Thunk::ExecuteParams thunk_params{*run_options, buffer_allocations,
+                                        stream,
+                                        /*async_comms_stream=*/nullptr};
+      capture_status = thunk->ExecuteOnStream(thunk_params);
+      if (!capture_status.ok()) break;
+    }
+
+    // The capture has to be ended even if a thunk failed, otherwise the stream
+    // stays in capture mode.
+    se::gpu::GpuGraphHandle captured = nullptr;
+    Status end_status = se::gpu::GpuDriver::StreamEndCapture(
+        graph->context, stream_handle, &captured);
+    auto destroy_captured = absl::MakeCleanup([&] {
+      if (captured != nullptr) {
+        se::gpu::GpuDriver::DestroyGraph(graph->context, captured)
+            .IgnoreError();
+      }
+    });
+    TF_RETURN_IF_ERROR(capture_status);
+    TF_RETURN_IF_ERROR(end_status);
+    TF_RETURN_IF_ERROR(se::gpu::GpuDriver::GraphInstantiate(
+        graph->context, captured, &graph->exec));
+    graph->buffer_addresses = std::move(buffer_addresses);
+  }
+
+  uint64_t start_micros = tensorflow::Env::Default()->NowMicros();
+  tensorflow::profiler::TraceMe hlo_module_activity(
+      [&] { return absl::StrCat(module_name_, ":XLA GPU module (graph)"); },
+      tensorflow::profiler::TraceMeLevel::kInfo);
+  TF_RETURN_IF_ERROR(se::gpu::GpuDriver::GraphLaunch(
+      graph->context, graph->exec, se::gpu::AsGpuStreamValue(stream)));
+  TF_RETURN_IF_ERROR(MaybeSyncAndProfile(
+      run_options, start_micros, block_host_until_done ? stream : nullptr));
+  return true;
+}
+
 StatusOr<const GpuExecutable::BufferAllocToDeviceMemoryMap*>
 GpuExecutable::ResolveConstantGlobals(se::Stream* stream) {
   se::StreamExecutor* executor = stream->parent();
@@ -1102,6 +1234,13 @@ Status GpuExecutable::ExecuteThunksOrBef(
     for (const std::unique_ptr<Thunk>& thunk : thunks_->TotalOrder()) {
       TF_RETURN_IF_ERROR(thunk->Initialize(*this, executor));
     }
+    TF_ASSIGN_OR_RETURN(bool executed_as_graph,
+                        MaybeExecuteThunksAsGraph(run_options,
+                                                  buffer_allocations,
+                                                  block_host_until_done));
+    if (executed_as_graph) {
+      return OkStatus();
+    }
     return ExecuteThunks(module_name_, *thunks_, run_options,
                          buffer_allocations, block_host_until_done);
   }
@@ -255,6 +255,14 @@ class GpuExecutable : public Executable {
                             const BufferAllocations& buffer_allocations,
                             bool block_host_until_done);
 
+  // If enabled by xla_gpu_enable_cuda_graphs and all thunks can be captured,
+  // executes the thunks by launching a GPU graph captured from them on the
+  // first execution with the same buffer addresses. Returns false if nothing
+  // was executed, in which case the thunks must be launched one by one.
+  StatusOr<bool> MaybeExecuteThunksAsGraph(
+      const ServiceExecutableRunOptions* run_options,
+      const BufferAllocations& buffer_allocations, bool block_host_until_done);
+
   using BufferAllocToDeviceMemoryMap =
       absl::flat_hash_map<BufferAllocation::Index, se::DeviceMemoryBase>;
 
@@ -334,6 +342,12 @@ class GpuExecutable : public Executable {
   std::map<stream_executor::StreamExecutor*, BufferAllocToDeviceMemoryMap>
       module_globals_ ABSL_GUARDED_BY(module_handle_mutex_);
 
+  struct CapturedGraph;
+  absl::Mutex graph_mutex_;
+  // Cache of GPU graphs used by `MaybeExecuteThunksAsGraph`.
+  std::map<stream_executor::StreamExecutor*, std::unique_ptr<CapturedGraph>>
+      graphs_ ABSL_GUARDED_BY(graph_mutex_);
+
   std::vector<ConstantInfo> constants_;
   const absl::flat_hash_map<ShapeIndex, OutputInfo> output_info_;
   // Retains shared ownership of on-device constants that are managed by XLA and
@@ -17,9 +17,12 @@ limitations under the License.
 
 #include <deque>
 #include <memory>
+#include <set>
+#include <utility>
 
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/compiler/xla/service/buffer_value.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_hlo_cost_analysis.h"
 #include "tensorflow/compiler/xla/service/hlo_instructions.h"
 #include "tensorflow/compiler/xla/service/hlo_memory_scheduler.h"
 #include "tensorflow/compiler/xla/service/hlo_reachability.h"
@@ -305,6 +308,240 @@ HloInstructionSequence PostprocessorToScheduleAsEarlyOrLateAsPossible(
   return result;
 }
 
+bool IsAsyncCollectiveStart(const HloInstruction& instr) {
+  switch (instr.opcode()) {
+    case HloOpcode::kAllReduceStart:
+    case HloOpcode::kAllGatherStart:
+    case HloOpcode::kCollectivePermuteStart:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsAsyncCollectiveDone(const HloInstruction& instr) {
+  switch (instr.opcode()) {
+    case HloOpcode::kAllReduceDone:
+    case HloOpcode::kAllGatherDone:
+    case HloOpcode::kCollectivePermuteDone:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Coarse latency model used by the latency-hiding scheduler. The absolute
+// values only matter relative to each other: they decide how much independent
+// compute is needed to cover a collective.
+struct LatencyModel {
+  // Fixed cost of a collective, independent of its size.
+  double collective_latency_seconds = 20e-6;
+  // Bytes moved per second by a collective.
+  double collective_bytes_per_second = 50e9;
+  // Fixed cost of launching a kernel.
+  double kernel_launch_seconds = 5e-6;
+  double flops_per_second = 10e12;
+  double bytes_per_second = 1e12;
+  // Upper bound on the bytes produced by collectives that are in flight at the
+  // same time. Issuing starts early extends the live range of their buffers,
+  // so this keeps the scheduler from trading too much memory for overlap.
+  int64_t max_in_flight_collective_bytes = 256 * 1024 * 1024;
+};
+
+// Returns the size in bytes of all arrays in `shape`.
+int64_t ArrayBytes(const Shape& shape) {
+  int64_t bytes = 0;
+  ShapeUtil::ForEachSubshape(
+      shape, [&](const Shape& subshape, const ShapeIndex& /*index*/) {
+        if (subshape.IsArray()) {
+          bytes += ShapeUtil::ByteSizeOf(subshape);
+        }
+      });
+  return bytes;
+}
+
+// Reorders a memory-minimizing sequence so that the latency of asynchronous
+// collectives is overlapped with independent compute. This is a top-down list
+// scheduler over the dependency graph of `input`:
+//
+//  * a collective start is issued as soon as it is ready, unless that would
+//    exceed the in-flight byte budget;
+//  * a collective done is held back until the estimated compute scheduled
+//    since its start covers the estimated collective latency, or until nothing
+//    else is ready;
+//  * ties are broken by the position in `input`, so the schedule only departs
+//    from the memory scheduler's choice where that hides latency.
+HloInstructionSequence ScheduleToHideCollectiveLatency(
+    const HloInstructionSequence& input, int64_t pointer_size,
+    const LatencyModel& model = LatencyModel()) {
+  const std::vector<HloInstruction*>& instructions = input.instructions();
+  if (instructions.empty()) {
+    return input;
+  }
+
+  HloCostAnalysis::Options options{
+      [pointer_size](const Shape& shape) {
+        return ShapeUtil::ByteSizeOf(shape, pointer_size);
+      }};
+  options.set_flops_per_second(model.flops_per_second);
+  options.set_transcendentals_per_second(model.flops_per_second);
+  options.set_bytes_per_second(model.bytes_per_second);
+  GpuHloCostAnalysis cost_analysis(options);
+  const bool has_cost_analysis =
+      instructions.front()->parent()->Accept(&cost_analysis).ok();
+
+  auto compute_seconds = [&](const HloInstruction* instr) -> double {
+    switch (instr->opcode()) {
+      case HloOpcode::kParameter:
+      case HloOpcode::kConstant:
+      case HloOpcode::kGetTupleElement:
+      case HloOpcode::kTuple:
+      case HloOpcode::kBitcast:
+        return 0;
+      default:
+        break;
+    }
+    double seconds = model.kernel_launch_seconds;
+    if (has_cost_analysis) {
+      seconds += cost_analysis.optimal_seconds(*instr);
+    }
+    return seconds;
+  };
+  auto collective_seconds = [&](int64_t bytes) -> double {
+    return model.collective_latency_seconds +
+           bytes / model.collective_bytes_per_second;
+  };
+  auto collective_bytes = [](const HloInstruction* start) -> int64_t {
+    int64_t bytes = 0;
+    for (const HloInstruction* user : start->users()) {
+      bytes += ArrayBytes(user->shape());
+    }
+    return bytes;
+  };
+
+  absl::flat_hash_map<const HloInstruction*, int64_t> position;
+  for (int64_t i = 0; i < instructions.size(); ++i) {
+    position[instructions[i]] = i;
+  }
+
+  // Number of unscheduled operands and control predecessors of each
+  // instruction. Duplicate operands are only counted once.
+  absl::flat_hash_map<const HloInstruction*, int64_t> unscheduled_preds;
+  for (HloInstruction* instr : instructions) {
+    absl::flat_hash_set<const HloInstruction*> preds;
+    for (const HloInstruction* operand : instr->operands()) {
+      preds.insert(operand);
+    }
+    for (const HloInstruction* pred : instr->control_predecessors()) {
+      preds.insert(pred);
+    }
+    unscheduled_preds[instr] = preds.size();
+  }
+
+  // Ready instructions, keyed by their position in `input`.
+  std::set<int64_t> ready_starts;
+  std::set<int64_t> ready;
+  // Ready collective dones whose collective is still in flight, keyed by
+  // estimated completion time.
+  std::set<std::pair<double, int64_t>> waiting_dones;
+
+  double now = 0;
+  int64_t in_flight_bytes = 0;
+  absl::flat_hash_map<const HloInstruction*, double> completion_time;
+  absl::flat_hash_map<const HloInstruction*, int64_t> in_flight;
+
+  auto make_ready = [&](HloInstruction* instr) {
+    const int64_t index = position.at(instr);
+    if (IsAsyncCollectiveStart(*instr)) {
+      ready_starts.insert(index);
+    } else if (IsAsyncCollectiveDone(*instr) &&
+               completion_time.contains(instr->operand(0)) &&
+               completion_time.at(instr->operand(0)) > now) {
+      waiting_dones.emplace(completion_time.at(instr->operand(0)), index);
+    } else {
+      ready.insert(index);
+    }
+  };
+  for (HloInstruction* instr : instructions) {
+    if (unscheduled_preds.at(instr) == 0) {
+      make_ready(instr);
+    }
+  }
+
+  HloInstructionSequence result;
+  auto schedule = [&](HloInstruction* instr) {
+    result.push_back(instr);
+    if (IsAsyncCollectiveStart(*instr)) {
+      const int64_t bytes = collective_bytes(instr);
+      completion_time[instr] = now + collective_seconds(bytes);
+      in_flight[instr] = bytes;
+      in_flight_bytes += bytes;
+    } else if (IsAsyncCollectiveDone(*instr)) {
+      auto it = in_flight.find(instr->operand(0));
+      if (it != in_flight.end()) {
+        now = std::max(now, completion_time.at(instr->operand(0)));
+        in_flight_bytes -= it->second;
+        in_flight.erase(it);
+      }
+    } else {
+      now += compute_seconds(instr);
+    }
+
+    // Dones whose collective has completed by now no longer need to wait.
+    while (!waiting_dones.empty() && waiting_dones.begin()->first <= now) {
+      ready.insert(waiting_dones.begin()->second);
+      waiting_dones.erase(waiting_dones.begin());
+    }
+
+    auto release = [&](HloInstruction* successor) {
+      if (--unscheduled_preds.at(successor) == 0) {
+        make_ready(successor);
+      }
+    };
+    absl::flat_hash_set<HloInstruction*> users(instr->users().begin(),
+                                               instr->users().end());
+    for (HloInstruction* user : users) {
+      release(user);
+    }
+    for (HloInstruction* successor : instr->control_successors()) {
+      if (!users.contains(successor)) {
+        release(successor);
+      }
+    }
+  };
+
+  while (result.size() < instructions.size()) {
+    // Issue the first ready collective start that fits in the byte budget.
+    auto start_it = absl::c_find_if(ready_starts, [&](int64_t index) {
+      return in_flight.empty() ||
+             in_flight_bytes + collective_bytes(instructions[index]) <=
+                 model.max_in_flight_collective_bytes;
+    });
+    std::set<int64_t>* from = nullptr;
+    int64_t index;
+    if (start_it != ready_starts.end()) {
+      from = &ready_starts;
+      index = *start_it;
+    } else if (!ready.empty()) {
+      from = &ready;
+      index = *ready.begin();
+    } else if (!waiting_dones.empty()) {
+      // Nothing left to overlap with: wait for the earliest collective.
+      index = waiting_dones.begin()->second;
+      waiting_dones.erase(waiting_dones.begin());
+    } else {
+      CHECK(!ready_starts.empty()) << "Cycle in the instruction sequence";
+      from = &ready_starts;
+      index = *ready_starts.begin();
+    }
+    if (from != nullptr) {
+      from->erase(index);
+    }
+    schedule(instructions[index]);
+  }
+  return result;
+}
+
 }  // end namespace
 
 GpuHloSchedule::GpuHloSchedule() {}
@@ -320,6 +557,19 @@ StatusOr<std::unique_ptr<GpuHloSchedule>> GpuHloSchedule::Build(
   if (stream_assignment.StreamCount() == 1) {
     // All kernels are launched on a single stream, so there's no loss of
     // concurrency by optimizing for minimal memory usage.
+    MemorySchedulerPostprocessor postprocessor =
+        PostprocessorToScheduleAsEarlyOrLateAsPossible;
+    if (module->config()
+            .debug_options()
+            .xla_gpu_enable_latency_hiding_scheduler()) {
+      // Asynchronous collectives still run concurrently with the kernels on
+      // the main stream, so hide their latency behind independent compute.
+      postprocessor = [pointer_size](const HloInstructionSequence& input) {
+        return ScheduleToHideCollectiveLatency(
+            PostprocessorToScheduleAsEarlyOrLateAsPossible(input),
+            pointer_size);
+      };
+    }
     TF_ASSIGN_OR_RETURN(
         HloSchedule sequences,
         ScheduleModule(
@@ -327,9 +577,8 @@ StatusOr<std::unique_ptr<GpuHloSchedule>> GpuHloSchedule::Build(
             [pointer_size](const BufferValue& buffer) {
               return ShapeUtil::ByteSizeOf(buffer.shape(), pointer_size);
             },
-            ComputationSchedulerToModuleScheduler(
-                DefaultMemoryScheduler,
-                PostprocessorToScheduleAsEarlyOrLateAsPossible)));
+            ComputationSchedulerToModuleScheduler(DefaultMemoryScheduler,
+                                                  postprocessor)));
     schedule->thunk_launch_order_ =
         sequences.sequence(entry_computation).instructions();
     schedule->hlo_ordering_ =
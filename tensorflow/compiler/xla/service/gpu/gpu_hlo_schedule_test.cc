@@ -481,5 +481,60 @@ TEST_F(GpuHloScheduleTest, AsyncAllReduce) {
   EXPECT_TRUE(order->ExecutesBefore(all_reduce_done, add4));
 }
 
+TEST_F(GpuHloScheduleTest, LatencyHidingSchedulerOverlapsAllReduce) {
+  constexpr char kHloString[] = R"(
+    HloModule m
+
+    add {
+      x = f32[] parameter(0)
+      y = f32[] parameter(1)
+      ROOT add = f32[] add(x, y)
+    }
+
+    ENTRY entry {
+      p0 = f32[1024] parameter(0)
+      p1 = f32[1024] parameter(1)
+      neg0 = f32[1024] negate(p0)
+      start = f32[1024] all-reduce-start(neg0), to_apply=add
+      done = f32[1024] all-reduce-done(start)
+      mul = f32[1024] multiply(done, done)
+      neg1 = f32[1024] negate(p1)
+      exp1 = f32[1024] exponential(neg1)
+      ROOT add = f32[1024] add(mul, exp1)
+    })";
+
+  HloModuleConfig config;
+  DebugOptions debug_options = GetDebugOptionsForTest();
+  debug_options.set_xla_gpu_disable_multi_streaming(true);
+  debug_options.set_xla_gpu_enable_latency_hiding_scheduler(true);
+  config.set_debug_options(debug_options);
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kHloString, config));
+
+  std::unique_ptr<StreamAssignment> streams = AssignStreams(*module);
+  ASSERT_EQ(streams->StreamCount(), 1);
+  std::unique_ptr<GpuHloSchedule> schedule =
+      BuildGpuHloSchedule(module.get(), *streams);
+  std::unique_ptr<HloOrdering> order = schedule->ConsumeHloOrdering();
+  VLOG(2) << order->ToString();
+
+  const HloInstruction* start = FindInstruction(module.get(), "start");
+  const HloInstruction* done = FindInstruction(module.get(), "done");
+  const HloInstruction* neg0 = FindInstruction(module.get(), "neg0");
+  ASSERT_NE(start, nullptr);
+  ASSERT_NE(done, nullptr);
+  EXPECT_TRUE(order->ExecutesBefore(neg0, start));
+  // The compute that does not depend on the all-reduce is scheduled before the
+  // done, regardless of where the memory scheduler put it, so that it overlaps
+  // with the all-reduce.
+  for (const char* name : {"neg1", "exp1"}) {
+    const HloInstruction* instr = FindInstruction(module.get(), name);
+    ASSERT_NE(instr, nullptr);
+    EXPECT_TRUE(order->ExecutesBefore(instr, done)) << name;
+  }
+  EXPECT_TRUE(order->ExecutesBefore(
+      done, module->entry_computation()->root_instruction()));
+}
+
 }  // namespace gpu
 }  // namespace xla
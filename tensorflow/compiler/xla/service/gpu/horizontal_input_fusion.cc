@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/algorithm/container.h"
 #include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
 #include "tensorflow/compiler/xla/layout_util.h"
@@ -44,6 +45,81 @@ Shape GetInputShapeForMultiOutputFusion(const HloInstruction& instr) {
   }
 }
 
+// Reductions whose inputs have at most this many elements are considered
+// launch-latency-bound, so packing them into a single kernel pays off even if
+// they reduce different shapes.
+constexpr int64_t kPackedReductionShapeThreshold = 128 * 2048;
+
+// Returns the reductions that are roots of the fusion `instr`, or `instr`
+// itself if it is an unfused reduction.
+std::vector<const HloInstruction*> GetReductionRoots(
+    const HloInstruction& instr) {
+  std::vector<const HloInstruction*> roots;
+  if (instr.opcode() != HloOpcode::kFusion) {
+    roots.push_back(&instr);
+  } else if (instr.fused_expression_root()->opcode() == HloOpcode::kTuple) {
+    for (const HloInstruction* root :
+         instr.fused_expression_root()->operands()) {
+      roots.push_back(root);
+    }
+  } else {
+    roots.push_back(instr.fused_expression_root());
+  }
+  roots.erase(std::remove_if(roots.begin(), roots.end(),
+                             [](const HloInstruction* root) {
+                               return !IsReductionFromOrToContiguousDimensions(
+                                   *root);
+                             }),
+              roots.end());
+  return roots;
+}
+
+// Returns true if all the reductions of `instr` reduce the same shape, i.e.
+// `instr` is not the result of packing reductions by
+// CanPackReductionFusions().
+bool HasConsistentReductions(const HloInstruction& instr) {
+  std::vector<const HloInstruction*> reductions = GetReductionRoots(instr);
+  return reductions.empty() ||
+         AreFusedReductionOutputsConsistent(reductions, reductions[0]);
+}
+
+// Returns true if `fused` can be packed into `anchor` even though their
+// shapes are not compatible for multi-output fusion. The reductions of the two
+// fusions are then emitted as different reduction groups of one kernel, each
+// with its own tiling and number of blocks, see EmitUnnestedReduction. This
+// requires the fusions not to share any operands, as reductions sharing inputs
+// are placed into the same group.
+bool CanPackReductionFusions(const HloInstruction& anchor,
+                             const HloInstruction& fused) {
+  std::vector<const HloInstruction*> anchor_reductions =
+      GetReductionRoots(anchor);
+  std::vector<const HloInstruction*> fused_reductions =
+      GetReductionRoots(fused);
+  if (anchor_reductions.empty() || fused_reductions.empty()) {
+    return false;
+  }
+  // Keep row and column reductions apart: they use different block sizes, in
+  // which case they would end up in different kernels anyway.
+  bool is_row_reduction =
+      GetReductionKindAndContiguousComponents(*anchor_reductions[0])
+          .is_row_reduction;
+  for (const auto* reductions : {&anchor_reductions, &fused_reductions}) {
+    for (const HloInstruction* reduce : *reductions) {
+      if (ShapeUtil::ElementsIn(reduce->operand(0)->shape()) >
+              kPackedReductionShapeThreshold ||
+          GetReductionKindAndContiguousComponents(*reduce).is_row_reduction !=
+              is_row_reduction) {
+        return false;
+      }
+    }
+  }
+  absl::flat_hash_set<const HloInstruction*> anchor_operands(
+      anchor.operands().begin(), anchor.operands().end());
+  return absl::c_none_of(fused.operands(), [&](const HloInstruction* operand) {
+    return anchor_operands.contains(operand);
+  });
+}
+
 class HorizontalInputFusionImpl {
  public:
   explicit HorizontalInputFusionImpl(HloComputation* computation)
@@ -137,8 +213,13 @@ StatusOr<bool> HorizontalInputFusionImpl::Run() {
     for (size_t j = 1; j < candidates.size(); ++j) {
       HloInstruction* fusion_anchor = candidates[fusion_anchor_id];
       HloInstruction* fused = candidates[j];
-      if (ShapesCompatibleForMultiOutputFusion(*fusion_anchor, *fused) &&
-          FusionFitsInBudget(*fusion_anchor, *fused)) {
+      // Once reductions of different shapes were packed into the anchor, its
+      // hero no longer represents all of its reductions.
+      bool compatible =
+          (ShapesCompatibleForMultiOutputFusion(*fusion_anchor, *fused) &&
+           HasConsistentReductions(*fusion_anchor)) ||
+          CanPackReductionFusions(*fusion_anchor, *fused);
+      if (compatible && FusionFitsInBudget(*fusion_anchor, *fused)) {
         VLOG(3) << "Fuse " << fused->ToString() << " into "
                 << fusion_anchor->ToString();
         fusion_anchor->MergeFusionInstructionIntoMultiOutput(fused);
@@ -245,6 +245,94 @@ TEST_F(HorizontalInputFusionTest, NonfusionInstrs) {
               op::Tuple(op::Reduce(), op::Reduce()));
 }
 
+TEST_F(HorizontalInputFusionTest, PacksReductionsOfDifferentShapes) {
+  const char* const kHloText = R"(
+ HloModule PacksReductionsOfDifferentShapes
+
+ %add_f32 {
+   %x = f32[] parameter(0)
+   %y = f32[] parameter(1)
+   ROOT %add = f32[] add(%x, %y)
+ }
+
+ fused_computation.1 {
+   arg.1 = f32[128,1024]{1,0} parameter(0)
+   constant0 = f32[] constant(0)
+   ROOT reduce.1 = f32[128]{0} reduce(arg.1, constant0), dimensions={1}, to_apply=%add_f32
+ }
+
+ fused_computation.2 {
+   arg.1 = f32[32,1024]{1,0} parameter(0)
+   constant0 = f32[] constant(0)
+   ROOT reduce.1 = f32[32]{0} reduce(arg.1, constant0), dimensions={1}, to_apply=%add_f32
+ }
+
+ ENTRY entry_computation {
+   arg.1 = f32[128,1024]{1,0} parameter(0)
+   arg.2 = f32[32,1024]{1,0} parameter(1)
+   fusion.1 = f32[128]{0} fusion(arg.1), kind=kInput, calls=fused_computation.1
+   fusion.2 = f32[32]{0} fusion(arg.2), kind=kInput, calls=fused_computation.2
+   ROOT tuple.1 = (f32[128]{0}, f32[32]{0}) tuple(fusion.1, fusion.2)
+ }
+)";
+  auto module = ParseAndReturnVerifiedModule(kHloText).ValueOrDie();
+
+  EXPECT_TRUE(GpuHorizontalInputFusion().Run(module.get()).ValueOrDie());
+
+  const HloInstruction* entry_root =
+      module->entry_computation()->root_instruction();
+  EXPECT_THAT(entry_root, op::Tuple((op::GetTupleElement(op::Fusion())),
+                                    (op::GetTupleElement(op::Fusion()))));
+
+  const HloInstruction* fusion = entry_root->operand(0)->operand(0);
+  ASSERT_TRUE(fusion->IsMultiOutputFusion());
+  EXPECT_THAT(fusion->fused_expression_root(),
+              op::Tuple(op::Reduce(), op::Reduce()));
+
+  // Both reductions are emitted into one kernel, one per block row.
+  CompileAndVerifyIr(kHloText, R"(
+CHECK: reduce-group-1
+CHECK-NOT: define void
+)",
+                     /*match_optimized_ir=*/false);
+  EXPECT_TRUE(RunAndCompare(kHloText, ErrorSpec{1e-5, 1e-5}));
+}
+
+TEST_F(HorizontalInputFusionTest, DoesNotPackReductionsSharingOperands) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+ HloModule DoesNotPackReductionsSharingOperands
+
+ %add_f32 {
+   %x = f32[] parameter(0)
+   %y = f32[] parameter(1)
+   ROOT %add = f32[] add(%x, %y)
+ }
+
+ fused_computation.1 {
+   arg.1 = f32[128,512]{1,0} parameter(0)
+   constant0 = f32[] constant(0)
+   ROOT reduce.1 = f32[128]{0} reduce(arg.1, constant0), dimensions={1}, to_apply=%add_f32
+ }
+
+ fused_computation.2 {
+   arg.1 = f32[128,512]{1,0} parameter(0)
+   slice.1 = f32[64,512]{1,0} slice(arg.1), slice={[0:64], [0:512]}
+   constant0 = f32[] constant(0)
+   ROOT reduce.1 = f32[64]{0} reduce(slice.1, constant0), dimensions={1}, to_apply=%add_f32
+ }
+
+ ENTRY entry_computation {
+   arg.1 = f32[128,512]{1,0} parameter(0)
+   fusion.1 = f32[128]{0} fusion(arg.1), kind=kInput, calls=fused_computation.1
+   fusion.2 = f32[64]{0} fusion(arg.1), kind=kInput, calls=fused_computation.2
+   ROOT tuple.1 = (f32[128]{0}, f32[64]{0}) tuple(fusion.1, fusion.2)
+ }
+)")
+                    .ValueOrDie();
+
+  EXPECT_FALSE(GpuHorizontalInputFusion().Run(module.get()).ValueOrDie());
+}
+
 }  // namespace
 }  // namespace gpu
 }  // namespace xla
@@ -15,9 +15,13 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/service/gpu/instruction_fusion.h"
 
+#include <algorithm>
+
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
 #include "tensorflow/compiler/xla/service/fusion_node_indexing_evaluation.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_fusible.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_hlo_cost_analysis.h"
 #include "tensorflow/compiler/xla/service/gpu/ir_emission_utils.h"
 #include "tensorflow/compiler/xla/service/hlo_opcode.h"
 #include "tensorflow/compiler/xla/service/hlo_query.h"
@@ -34,6 +38,19 @@ bool ElementIsF32OrF16(const Shape& shape) {
   PrimitiveType type = shape.element_type();
   return type == F32 || type == F16;
 }
+
+// Rough device characteristics used to weigh recomputation against the memory
+// traffic and kernel launch that fusion saves. They only need to be in the
+// right ballpark: the check below is meant to catch fusions which duplicate
+// work by orders of magnitude, not to fine-tune borderline cases.
+constexpr float kFlopsPerSecond = 1e13;
+constexpr float kTranscendentalsPerSecond = 1e12;
+constexpr float kBytesPerSecond = 1e12;
+constexpr float kKernelLaunchSeconds = 5e-6;
+
+int64_t ShapeSizeBytes(const Shape& shape) {
+  return ShapeUtil::ByteSizeOf(shape, /*pointer_size=*/8);
+}
 }  // namespace
 
 /*static*/ bool GpuInstructionFusion::IsExpensive(
@@ -97,6 +114,11 @@ FusionDecision GpuInstructionFusion::ShouldFuse(HloInstruction* consumer,
     return !too_large;
   }
 
+  if (NoFusionPossible too_expensive =
+          !RecomputationIsProfitable(consumer, operand_index)) {
+    return !too_expensive;
+  }
+
   if (consumer->opcode() != HloOpcode::kFusion) {
     return {};
   }
@@ -119,6 +141,61 @@ FusionDecision GpuInstructionFusion::ShouldFuse(HloInstruction* consumer,
   return {};
 }
 
+FusionDecision GpuInstructionFusion::RecomputationIsProfitable(
+    HloInstruction* consumer, int64_t operand_index) {
+  HloInstruction* producer = consumer->mutable_operand(operand_index);
+  if (!producer->shape().IsArray() || !consumer->shape().IsArray()) {
+    return {};
+  }
+  const int64_t producer_elements = ShapeUtil::ElementsIn(producer->shape());
+  const int64_t consumer_elements = ShapeUtil::ElementsIn(consumer->shape());
+  if (producer_elements == 0) {
+    return {};
+  }
+
+  // The number of times each element of 'producer' is computed once it is
+  // fused: every element of 'consumer' reads its operand anew, and inside a
+  // fusion node the producer may additionally be emitted more than once.
+  double recompute_factor =
+      std::max<double>(1.0, static_cast<double>(consumer_elements) /
+                                static_cast<double>(producer_elements));
+  if (consumer->opcode() == HloOpcode::kFusion) {
+    auto it = fusion_node_evaluations_.find(consumer);
+    if (it != fusion_node_evaluations_.end()) {
+      recompute_factor *= std::max<int64_t>(
+          1, it->second.EvaluateEmittedInstructions(producer));
+    }
+  }
+  if (recompute_factor <= 1.0) {
+    return {};
+  }
+
+  HloCostAnalysis::Options options{ShapeSizeBytes};
+  GpuHloCostAnalysis cost_analysis(options);
+  if (!cost_analysis.Preprocess(producer).ok() ||
+      !producer->Visit(&cost_analysis).ok() ||
+      !cost_analysis.Postprocess(producer).ok()) {
+    return {};
+  }
+  const double compute_seconds =
+      cost_analysis.flop_count(*producer) / kFlopsPerSecond +
+      cost_analysis.transcendental_count(*producer) /
+          kTranscendentalsPerSecond;
+  const double extra_compute_seconds = (recompute_factor - 1) * compute_seconds;
+  // Fusion saves writing the producer's output to memory, reading it back in
+  // the consumer and launching a separate kernel for the producer.
+  const double saved_seconds =
+      2.0 * cost_analysis.output_bytes_accessed(*producer) / kBytesPerSecond +
+      kKernelLaunchSeconds;
+  if (extra_compute_seconds > saved_seconds) {
+    return FusionDecision{} << absl::StrCat(
+               "recomputing the producer ", recompute_factor,
+               " times costs more than fusion saves (", extra_compute_seconds,
+               "s vs ", saved_seconds, "s)");
+  }
+  return {};
+}
+
 HloInstruction::FusionKind GpuInstructionFusion::ChooseKind(
     const HloInstruction* producer, const HloInstruction* consumer) {
   return ChooseFusionKind(*producer, *consumer);
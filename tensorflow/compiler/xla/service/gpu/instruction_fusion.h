@@ -52,6 +52,12 @@ class GpuInstructionFusion : public InstructionFusion {
   FusionDecision ShouldFuseInexpensiveChecks(HloInstruction* consumer,
                                              int64_t operand_index);
 
+  // Uses GpuHloCostAnalysis to estimate whether the work duplicated by fusing
+  // the operand into 'consumer' outweighs the memory traffic and kernel launch
+  // that the fusion saves.
+  FusionDecision RecomputationIsProfitable(HloInstruction* consumer,
+                                           int64_t operand_index);
+
   HloInstruction* FuseInstruction(HloInstruction* fusion_instruction,
                                   HloInstruction* producer) override;
 
@@ -175,6 +175,45 @@ TEST_F(InstructionFusionTest, BroadcastIntoReduce) {
               op::Reduce(op::Broadcast(op::Constant()), op::Constant()));
 }
 
+// Tests that a cheap producer is not fused into a consumer that would evaluate
+// it many thousands of times per element.
+TEST_F(InstructionFusionTest, DoNotFuseExcessiveRecomputation) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule test_module
+
+    ENTRY entry {
+      p0 = f32[1024] parameter(0)
+      exp = f32[1024] exponential(p0)
+      ROOT broadcast = f32[1024,65536] broadcast(exp), dimensions={0}
+    })")
+                    .ValueOrDie();
+
+  EXPECT_FALSE(GpuInstructionFusion(/*may_duplicate=*/true)
+                   .Run(module.get())
+                   .ValueOrDie());
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              op::Broadcast(op::Exp(op::Parameter())));
+}
+
+// Tests that the same producer is still fused when the amount of duplicated
+// work is small.
+TEST_F(InstructionFusionTest, FuseModerateRecomputation) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule test_module
+
+    ENTRY entry {
+      p0 = f32[1024] parameter(0)
+      exp = f32[1024] exponential(p0)
+      ROOT broadcast = f32[1024,16] broadcast(exp), dimensions={0}
+    })")
+                    .ValueOrDie();
+
+  EXPECT_TRUE(GpuInstructionFusion(/*may_duplicate=*/true)
+                  .Run(module.get())
+                  .ValueOrDie());
+  EXPECT_THAT(module->entry_computation()->root_instruction(), op::Fusion());
+}
+
 TEST_F(InstructionFusionTest, DoNotFuseLayoutChangingOpWithReduce) {
   auto module = ParseAndReturnVerifiedModule(R"(
     HloModule test_module
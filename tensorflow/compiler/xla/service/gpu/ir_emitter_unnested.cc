@@ -27,6 +27,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/str_cat.h"
@@ -1150,16 +1151,21 @@ Status IrEmitterUnnested::EmitCublasLtMatmulThunk(mlir::Operation* op) {
     TF_ASSIGN_OR_RETURN(bias, GetAllocationSlice(matmul.getBias()));
   }
 
+  BufferAllocation::Slice aux;
+  if (matmul.getAux() != nullptr) {
+    TF_ASSIGN_OR_RETURN(aux, GetAllocationSlice(matmul.getAux()));
+  }
+
   std::unique_ptr<Thunk> thunk;
   if (IsBefThunkEnabled(hlo_module_config_)) {
     TF_ASSIGN_OR_RETURN(
-        thunk, CreateBefThunk(GetThunkInfo(op), op, {a, b, c, d, bias}));
+        thunk, CreateBefThunk(GetThunkInfo(op), op, {a, b, c, d, bias, aux}));
   } else {
     TF_ASSIGN_OR_RETURN(cublas_lt::MatmulPlan plan,
                         cublas_lt::MatmulPlan::For(matmul));
     thunk = std::make_unique<CublasLtMatmulThunk>(
         GetThunkInfo(op), std::move(plan), matmul.getAlgorithm(), a, b, c, d,
-        bias);
+        bias, aux);
   }
 
   AddThunkToThunkSequence(std::move(thunk));
@@ -5162,96 +5168,152 @@ Status IrEmitterUnnested::EmitUnnestedReduction(mlir::lmhlo::FusionOp fusion) {
   VLOG(2) << StrCat("Generate in ", instr_index_groups.size(), " groups for ",
                     MlirToString(fusion));
 
-  mlir::mhlo::ReduceOp first_reduce = mlir::cast<mlir::mhlo::ReduceOp>(
-      *absl::c_find_if(fusion_roots, [](mlir::Operation* op) {
-        return IsReductionFromOrToContiguousDimensions(op);
-      }));
-  TF_ASSIGN_OR_RETURN(ReductionCodegenInfo reduction_info,
-                      ComputeReductionCodegenInfo(fusion, first_reduce));
-  const TilingScheme& tiling_scheme = reduction_info.GetTilingScheme();
-
-  // block_y_count is set to instr_index_groups.size(), so that each reduction
-  // group can be run in parallel by a different BlockIdy.
-  LaunchDimensions launch_dimensions(
-      {/*x=*/tiling_scheme.GetNumberOfBlocksPhysical(),
-       /*y=*/static_cast<int64_t>(instr_index_groups.size()),
-       /*z=*/1},
-      {/*x=*/tiling_scheme.GetNumThreadsPerBlockPhysical(), /*y=*/1, /*z=*/1});
-  VLOG(3) << "Launch dimensions of " << mlir::GetNameFromLoc(fusion.getLoc())
-          << launch_dimensions.ToString();
-
-  std::vector<llvm_ir::IrArray> ir_arrays;
-  TF_ASSIGN_OR_RETURN(std::unique_ptr<Thunk> kernel_thunk,
-                      BuildKernelThunk(fusion, Thunk::ThunkInfo(), &ir_arrays,
-                                       launch_dimensions));
+  // The roots of the fused computation are in the same order as the outputs
+  // of `fusion`.
+  std::vector<HloInstruction*> roots = GetFusionRoots(fused_computation);
+  auto root_index = [&](const HloInstruction* root) {
+    return absl::c_find(roots, root) - roots.begin();
+  };
 
-  GpuElementalIrEmitter elemental_emitter(hlo_module_config_, module_, &b_,
-                                          GetNestedComputer());
-  FusedIrEmitter fused_emitter(elemental_emitter);
-  CHECK_LT(fused_computation->num_parameters(), ir_arrays.size());
-  for (int i = 0; i < fused_computation->num_parameters(); i++) {
-    llvm_ir::IrArray ir_array = ir_arrays[i];
-    HloInstruction* fused_operand = fused_computation->parameter_instruction(i);
-    fused_emitter.BindGenerator(
-        *fused_operand,
-        [this, ir_array, fused_operand](const llvm_ir::IrArray::Index& index) {
-          return ir_array.EmitReadArrayElement(index, &b_,
-                                               fused_operand->name());
-        });
+  // Each group is emitted with the tiling of its first reduce. All the
+  // reductions within a group must have the same shape and layout, as verified
+  // by `IsFusedReductionOutputConsistent()`, but horizontally fused groups
+  // (see GpuHorizontalInputFusion) can reduce different shapes.
+  std::vector<ReductionCodegenInfo> group_infos;
+  std::vector<Shape> group_input_shapes;
+  for (const std::vector<HloInstruction*>& group : instr_index_groups) {
+    auto first_reduce = absl::c_find_if(group, [](const HloInstruction* hlo) {
+      return IsReductionFromOrToContiguousDimensions(*hlo);
+    });
+    TF_RET_CHECK(first_reduce != group.end())
+        << "Reduction group without reduce in " << MlirToString(fusion);
+    TF_RET_CHECK(absl::c_all_of(group, [&](const HloInstruction* hlo) {
+      return IsFusedReductionOutputConsistent(hlo, *first_reduce);
+    })) << "Inconsistent reduction group in "
+        << MlirToString(fusion);
+    mlir::mhlo::ReduceOp reduce_op = mlir::cast<mlir::mhlo::ReduceOp>(
+        fusion_roots[root_index(*first_reduce)]);
+    TF_ASSIGN_OR_RETURN(ReductionCodegenInfo reduction_info,
+                        ComputeReductionCodegenInfo(fusion, reduce_op));
+    group_infos.push_back(reduction_info);
+    group_input_shapes.push_back(GetShape(reduce_op->getOperand(0)));
+  }
+
+  // Groups with the same block size share a kernel, in which each group is run
+  // by a different BlockIdy. Groups that need fewer blocks than the kernel is
+  // launched with leave the extra blocks idle.
+  std::vector<std::vector<int>> kernel_groups;
+  absl::flat_hash_map<int64_t, int> kernel_for_block_size;
+  for (int i = 0; i < group_infos.size(); ++i) {
+    int64_t block_size =
+        group_infos[i].GetTilingScheme().GetNumThreadsPerBlockPhysical();
+    auto it = kernel_for_block_size.try_emplace(block_size,
+                                                kernel_groups.size());
+    if (it.second) {
+      kernel_groups.emplace_back();
+    }
+    kernel_groups[it.first->second].push_back(i);
   }
 
-  // Get outputs.
-  ReductionOutputMap result_ir_arrays;
+  ThunkSequence thunks;
+  for (const std::vector<int>& group_ids : kernel_groups) {
+    int64_t num_blocks = 0;
+    for (int group_id : group_ids) {
+      num_blocks = std::max(
+          num_blocks,
+          group_infos[group_id].GetTilingScheme().GetNumberOfBlocksPhysical());
+    }
+    LaunchDimensions launch_dimensions(
+        {/*x=*/num_blocks,
+         /*y=*/static_cast<int64_t>(group_ids.size()),
+         /*z=*/1},
+        {/*x=*/group_infos[group_ids[0]]
+             .GetTilingScheme()
+             .GetNumThreadsPerBlockPhysical(),
+         /*y=*/1, /*z=*/1});
+    VLOG(3) << "Launch dimensions of " << mlir::GetNameFromLoc(fusion.getLoc())
+            << launch_dimensions.ToString();
+
+    std::vector<llvm_ir::IrArray> ir_arrays;
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<Thunk> kernel_thunk,
+                        BuildKernelThunk(fusion, Thunk::ThunkInfo(), &ir_arrays,
+                                         launch_dimensions));
 
-  // Skip all parameter buffers first.
-  int ir_arrays_idx = fused_computation->num_parameters();
-  std::vector<HloInstruction*> roots = GetFusionRoots(fused_computation);
-  for (HloInstruction* root : roots) {
-    int get_num_results = GetNumOutputs(root->shape());
-    result_ir_arrays[root] =
-        absl::MakeSpan(ir_arrays).subspan(ir_arrays_idx, get_num_results);
-    ir_arrays_idx += get_num_results;
-  }
+    GpuElementalIrEmitter elemental_emitter(hlo_module_config_, module_, &b_,
+                                            GetNestedComputer());
+    FusedIrEmitter fused_emitter(elemental_emitter);
+    CHECK_LT(fused_computation->num_parameters(), ir_arrays.size());
+    for (int i = 0; i < fused_computation->num_parameters(); i++) {
+      llvm_ir::IrArray ir_array = ir_arrays[i];
+      HloInstruction* fused_operand =
+          fused_computation->parameter_instruction(i);
+      fused_emitter.BindGenerator(
+          *fused_operand,
+          [this, ir_array, fused_operand](const llvm_ir::IrArray::Index& idx) {
+            return ir_array.EmitReadArrayElement(idx, &b_,
+                                                 fused_operand->name());
+          });
+    }
 
-  // We always use the first reduce as representative to construct
-  // ReductionCodegenInfo, since all the reductions are required to have the
-  // same shape and layout as verified by `IsFusedReductionOutputConsistent()`.
-  TF_ASSIGN_OR_RETURN(ReductionCodegenInfo reduction_codegen_info,
-                      ComputeReductionCodegenInfo(fusion, first_reduce));
+    // Get outputs.
+    ReductionOutputMap result_ir_arrays;
 
-  KernelSupportLibrary ksl(&b_, llvm_ir::UnrollMode::kDefaultUnroll);
+    // Skip all parameter buffers first.
+    int ir_arrays_idx = fused_computation->num_parameters();
+    for (HloInstruction* root : roots) {
+      int get_num_results = GetNumOutputs(root->shape());
+      result_ir_arrays[root] =
+          absl::MakeSpan(ir_arrays).subspan(ir_arrays_idx, get_num_results);
+      ir_arrays_idx += get_num_results;
+    }
 
-  // Use raw block_id_y to select the i-th parallel reduction to run. Using
-  // block_id_y instead of block_id_x simplifies the index calculation
-  // for reduction code generation as the block_id_y is orthogonal to
-  // the indices used within the reductions.
-  llvm::CallInst* raw_block_id_y = gpu::EmitCallToTargetIntrinsic(
-      gpu::TargetIntrinsicID::kBlockIdy, {}, {}, &b_);
-  llvm_ir::AddRangeMetadata(0, instr_index_groups.size(),
-                            llvm::cast<llvm::Instruction>(raw_block_id_y));
-  for (int i = 0; i < instr_index_groups.size(); ++i) {
-    TF_RETURN_IF_ERROR(ksl.IfWithStatus(
-        StrCat("reduce-group-", i),
-        b_.CreateICmpEQ(raw_block_id_y, b_.getInt32(i)), [&] {
-          return EmitIRForReduction(
-              fusion, instr_index_groups[i], fused_emitter, result_ir_arrays,
-              reduction_codegen_info, GetShape(first_reduce->getOperand(0)));
-        }));
-  }
+    KernelSupportLibrary ksl(&b_, llvm_ir::UnrollMode::kDefaultUnroll);
+
+    // Use raw block_id_y to select the i-th parallel reduction to run. Using
+    // block_id_y instead of block_id_x simplifies the index calculation
+    // for reduction code generation as the block_id_y is orthogonal to
+    // the indices used within the reductions.
+    llvm::CallInst* raw_block_id_y = gpu::EmitCallToTargetIntrinsic(
+        gpu::TargetIntrinsicID::kBlockIdy, {}, {}, &b_);
+    llvm_ir::AddRangeMetadata(0, group_ids.size(),
+                              llvm::cast<llvm::Instruction>(raw_block_id_y));
+    llvm::Value* raw_block_id_x = gpu::EmitCallToTargetIntrinsic(
+        gpu::TargetIntrinsicID::kBlockIdx, {}, {}, &b_);
+    for (int i = 0; i < group_ids.size(); ++i) {
+      const ReductionCodegenInfo& reduction_info = group_infos[group_ids[i]];
+      int64_t group_num_blocks =
+          reduction_info.GetTilingScheme().GetNumberOfBlocksPhysical();
+      llvm::Value* run_group = b_.CreateICmpEQ(raw_block_id_y, b_.getInt32(i));
+      if (group_num_blocks < num_blocks) {
+        run_group = b_.CreateAnd(
+            run_group,
+            b_.CreateICmpULT(raw_block_id_x, b_.getInt32(group_num_blocks)));
+      }
+      TF_RETURN_IF_ERROR(ksl.IfWithStatus(
+          StrCat("reduce-group-", group_ids[i]), run_group, [&] {
+            return EmitIRForReduction(
+                fusion, instr_index_groups[group_ids[i]], fused_emitter,
+                result_ir_arrays, reduction_info,
+                group_input_shapes[group_ids[i]]);
+          }));
+    }
 
-  ThunkSequence thunks;
-  if (!reduction_codegen_info.IsRaceFree()) {
-    for (int i = 0; i < fusion_roots.size(); ++i) {
-      mlir::Operation* output_instruction = fusion_roots[i];
-      if (IsReductionFromOrToContiguousDimensions(output_instruction)) {
-        TF_ASSIGN_OR_RETURN(std::unique_ptr<Thunk> initializer_thunk,
-                            BuildFusedInitializerThunk(fusion, i));
-        thunks.push_back(std::move(initializer_thunk));
+    for (int group_id : group_ids) {
+      if (group_infos[group_id].IsRaceFree()) {
+        continue;
+      }
+      for (const HloInstruction* root : instr_index_groups[group_id]) {
+        if (IsReductionFromOrToContiguousDimensions(*root)) {
+          TF_ASSIGN_OR_RETURN(
+              std::unique_ptr<Thunk> initializer_thunk,
+              BuildFusedInitializerThunk(fusion, root_index(root)));
+          thunks.push_back(std::move(initializer_thunk));
+        }
       }
     }
+    thunks.push_back(std::move(kernel_thunk));
   }
 
-  thunks.push_back(std::move(kernel_thunk));
   auto sequential_thunk = std::make_unique<SequentialThunk>(
       GetThunkInfo(fusion), std::move(thunks));
   AddThunkToThunkSequence(std::move(sequential_thunk));
@@ -63,7 +63,8 @@ Status KernelThunk::Initialize(const GpuExecutable& executable,
         CreateKernel(kernel_name_, args_.size(), executable.text(),
                      executable.binary(), executor));
 
-    kernel_cache_.emplace(executor, std::move(kernel));
+    kernel_cache_.emplace(executor, std::make_unique<LoadedKernel>(
+                                        std::move(kernel), args_.size()));
   }
 
   return OkStatus();
@@ -90,7 +91,7 @@ Status KernelThunk::ExecuteOnStream(const ExecuteParams& params) {
   // Load the kernel.
   se::StreamExecutor* executor = params.stream->parent();
   LaunchDimensions launch_dimensions;
-  const se::KernelBase* kernel = nullptr;
+  LoadedKernel* loaded = nullptr;
 
   {
     absl::MutexLock lock(&mutex_);
@@ -98,8 +99,9 @@ Status KernelThunk::ExecuteOnStream(const ExecuteParams& params) {
     CHECK(it != kernel_cache_.end())
         << "Initialize() not called for StreamExecutor " << executor;
     launch_dimensions = launch_dimensions_;
-    kernel = it->second.get();
+    loaded = it->second.get();
   }
+  const se::KernelBase* kernel = loaded->kernel.get();
 
   VLOG(3) << "Launching " << kernel->name();
   absl::InlinedVector<se::DeviceMemoryBase, 4> buffer_args;
@@ -115,7 +117,11 @@ Status KernelThunk::ExecuteOnStream(const ExecuteParams& params) {
     PrintBufferContents(params.stream, buffer_args);
   }
 
-  return ExecuteKernelOnStream(*kernel, buffer_args, launch_dimensions,
+  // The launch copies the argument values, so the array can be rebound as
+  // soon as it returns.
+  absl::MutexLock lock(&loaded->args_mutex);
+  loaded->args.Bind(buffer_args);
+  return ExecuteKernelOnStream(*kernel, loaded->args, launch_dimensions,
                                params.stream);
 }
 
@@ -77,11 +77,22 @@ class KernelThunk : public Thunk {
   // The thread and block dimension used to launch the kernel.
   const LaunchDimensions launch_dimensions_;
 
+  // A kernel loaded into one `StreamExecutor`, with its arguments array that is
+  // rebound and reused for every launch.
+  struct LoadedKernel {
+    LoadedKernel(std::unique_ptr<se::KernelBase> kernel, size_t num_args)
+        : kernel(std::move(kernel)), args(num_args) {}
+
+    std::unique_ptr<se::KernelBase> kernel;
+    absl::Mutex args_mutex;
+    se::KernelArgsDeviceMemoryArray args ABSL_GUARDED_BY(args_mutex);
+  };
+
   mutable absl::Mutex mutex_;
 
   // Loaded kernels for each `StreamExecutor`.  Requires pointer stability of
   // values.
-  absl::flat_hash_map<se::StreamExecutor*, std::unique_ptr<se::KernelBase>>
+  absl::flat_hash_map<se::StreamExecutor*, std::unique_ptr<LoadedKernel>>
       kernel_cache_ ABSL_GUARDED_BY(mutex_);
 };
 
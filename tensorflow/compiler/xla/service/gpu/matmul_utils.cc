@@ -329,13 +329,16 @@ StatusOr<bool> CanFoldTransposeOperandIntoDot(const HloInstruction& dot,
 
   const Shape& lhs_shape = gemm->operand(0)->shape();
   const Shape& rhs_shape = gemm->operand(1)->shape();
+  // A cublasLt matmul with an auxiliary output returns a (result, aux) tuple.
+  const Shape& output_shape =
+      gemm->shape().IsTuple() ? gemm->shape().tuple_shapes(0) : gemm->shape();
   const DotDimensionNumbers& dot_dims = config.dot_dimension_numbers();
 
   return GemmConfig::For(
       lhs_shape, dot_dims.lhs_batch_dimensions(),
       dot_dims.lhs_contracting_dimensions(), rhs_shape,
       dot_dims.rhs_batch_dimensions(), dot_dims.rhs_contracting_dimensions(),
-      /*output_shape=*/gemm->shape(), config.alpha_real(), config.alpha_imag(),
+      /*output_shape=*/output_shape, config.alpha_real(), config.alpha_imag(),
       config.beta(), algorithm, se::blas::kDefaultComputePrecision);
 }
 
@@ -556,6 +559,23 @@ Status RunGemm(const GemmConfig& config, se::DeviceMemoryBase lhs_buffer,
   }
 }
 
+bool EpilogueAddsVectorBias(GemmBackendConfig::Epilogue epilogue) {
+  switch (epilogue) {
+    case GemmBackendConfig::BIAS:
+    case GemmBackendConfig::BIAS_RELU:
+    case GemmBackendConfig::BIAS_GELU:
+    case GemmBackendConfig::BIAS_GELU_AUX:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool EpilogueHasAuxiliaryOutput(GemmBackendConfig::Epilogue epilogue) {
+  return epilogue == GemmBackendConfig::GELU_AUX ||
+         epilogue == GemmBackendConfig::BIAS_GELU_AUX;
+}
+
 #if GOOGLE_CUDA
 
 namespace {
@@ -586,6 +606,18 @@ StatusOr<se::cuda::BlasLt::Epilogue> AsBlasLtEpilogue(
       return se::cuda::BlasLt::Epilogue::kDefault;
     case mlir::lmhlo_gpu::CublasLtMatmulEpilogue::Bias:
       return se::cuda::BlasLt::Epilogue::kBias;
+    case mlir::lmhlo_gpu::CublasLtMatmulEpilogue::Relu:
+      return se::cuda::BlasLt::Epilogue::kReLU;
+    case mlir::lmhlo_gpu::CublasLtMatmulEpilogue::Gelu:
+      return se::cuda::BlasLt::Epilogue::kGeLU;
+    case mlir::lmhlo_gpu::CublasLtMatmulEpilogue::GeluAux:
+      return se::cuda::BlasLt::Epilogue::kGeLUWithAux;
+    case mlir::lmhlo_gpu::CublasLtMatmulEpilogue::BiasRelu:
+      return se::cuda::BlasLt::Epilogue::kBiasThenReLU;
+    case mlir::lmhlo_gpu::CublasLtMatmulEpilogue::BiasGelu:
+      return se::cuda::BlasLt::Epilogue::kBiasThenGeLUApproximate;
+    case mlir::lmhlo_gpu::CublasLtMatmulEpilogue::BiasGeluAux:
+      return se::cuda::BlasLt::Epilogue::kBiasThenGeLUApproximateWithAux;
     default:
       return InternalError("unknown epilogue");
   }
@@ -608,6 +640,30 @@ StatusOr<se::cuda::BlasLt::MatrixLayout> AsBlasLtMatrixLayout(
 
 namespace cublas_lt {
 
+StatusOr<se::cuda::BlasLt::Epilogue> AsBlasLtEpilogue(
+    GemmBackendConfig::Epilogue epilogue) {
+  switch (epilogue) {
+    case GemmBackendConfig::DEFAULT:
+      return se::cuda::BlasLt::Epilogue::kDefault;
+    case GemmBackendConfig::BIAS:
+      return se::cuda::BlasLt::Epilogue::kBias;
+    case GemmBackendConfig::RELU:
+      return se::cuda::BlasLt::Epilogue::kReLU;
+    case GemmBackendConfig::GELU:
+      return se::cuda::BlasLt::Epilogue::kGeLU;
+    case GemmBackendConfig::GELU_AUX:
+      return se::cuda::BlasLt::Epilogue::kGeLUWithAux;
+    case GemmBackendConfig::BIAS_RELU:
+      return se::cuda::BlasLt::Epilogue::kBiasThenReLU;
+    case GemmBackendConfig::BIAS_GELU:
+      return se::cuda::BlasLt::Epilogue::kBiasThenGeLUApproximate;
+    case GemmBackendConfig::BIAS_GELU_AUX:
+      return se::cuda::BlasLt::Epilogue::kBiasThenGeLUApproximateWithAux;
+    default:
+      return InternalError("unknown epilogue");
+  }
+}
+
 /*static*/ StatusOr<MatmulPlan> MatmulPlan::For(
     mlir::lmhlo_gpu::CublasLtMatmulOp op) {
   mlir::mhlo::DotDimensionNumbersAttr dot_dims = op.getDotDimensionNumbers();
@@ -689,6 +745,7 @@ Status MatmulPlan::DoMatmul(se::Stream* stream, se::DeviceMemoryBase a_buffer,
                             se::DeviceMemoryBase c_buffer,
                             se::DeviceMemoryBase d_buffer,
                             se::DeviceMemoryBase bias_buffer,
+                            se::DeviceMemoryBase aux_buffer,
                             const se::cuda::BlasLt::MatmulAlgorithm& algorithm,
                             se::ScratchAllocator& scratch_allocator,
                             se::blas::ProfileResult* profile_result) {
@@ -711,13 +768,15 @@ Status MatmulPlan::DoMatmul(se::Stream* stream, se::DeviceMemoryBase a_buffer,
       se::DeviceMemory<Input>(a_buffer), se::DeviceMemory<Input>(b_buffer),
       se::HostOrDeviceScalar<Scale>(beta), se::DeviceMemory<Input>(c_buffer),
       output, algorithm, scratch_allocator,
-      se::DeviceMemory<Input>(bias_buffer), profile_result);
+      se::DeviceMemory<Input>(bias_buffer), se::DeviceMemory<Input>(aux_buffer),
+      profile_result);
 }
 
 Status MatmulPlan::ExecuteOnStream(
     se::Stream* stream, se::DeviceMemoryBase a_buffer,
     se::DeviceMemoryBase b_buffer, se::DeviceMemoryBase c_buffer,
     se::DeviceMemoryBase d_buffer, se::DeviceMemoryBase bias_buffer,
+    se::DeviceMemoryBase aux_buffer,
     const se::cuda::BlasLt::MatmulAlgorithm& algorithm,
     se::ScratchAllocator& scratch_allocator,
     se::blas::ProfileResult* profile_result) {
@@ -727,28 +786,28 @@ Status MatmulPlan::ExecuteOnStream(
 
   switch (plan_.d_desc.type()) {
     case CUDA_R_16F:
-      return DoMatmul<Eigen::half, float>(stream, a_buffer, b_buffer, c_buffer,
-                                          d_buffer, bias_buffer, algorithm,
-                                          scratch_allocator, profile_result);
+      return DoMatmul<Eigen::half, float>(
+          stream, a_buffer, b_buffer, c_buffer, d_buffer, bias_buffer,
+          aux_buffer, algorithm, scratch_allocator, profile_result);
     case CUDA_R_16BF:
       return DoMatmul<Eigen::bfloat16, float>(
           stream, a_buffer, b_buffer, c_buffer, d_buffer, bias_buffer,
-          algorithm, scratch_allocator, profile_result);
+          aux_buffer, algorithm, scratch_allocator, profile_result);
     case CUDA_R_32F:
       return DoMatmul<float>(stream, a_buffer, b_buffer, c_buffer, d_buffer,
-                             bias_buffer, algorithm, scratch_allocator,
-                             profile_result);
+                             bias_buffer, aux_buffer, algorithm,
+                             scratch_allocator, profile_result);
     case CUDA_R_64F:
       return DoMatmul<double>(stream, a_buffer, b_buffer, c_buffer, d_buffer,
-                              bias_buffer, algorithm, scratch_allocator,
-                              profile_result);
+                              bias_buffer, aux_buffer, algorithm,
+                              scratch_allocator, profile_result);
     case CUDA_C_32F:
       return DoMatmul<complex64>(stream, a_buffer, b_buffer, c_buffer, d_buffer,
-                                 bias_buffer, algorithm, scratch_allocator,
-                                 profile_result);
+                                 bias_buffer, aux_buffer, algorithm,
+                                 scratch_allocator, profile_result);
     case CUDA_C_64F:
       return DoMatmul<complex128>(stream, a_buffer, b_buffer, c_buffer,
-                                  d_buffer, bias_buffer, algorithm,
+                                  d_buffer, bias_buffer, aux_buffer, algorithm,
                                   scratch_allocator, profile_result);
     default:
       return InternalError("Unexpected dtype");
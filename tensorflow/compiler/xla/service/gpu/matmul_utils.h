@@ -23,6 +23,7 @@ limitations under the License.
 
 #include "absl/types/span.h"
 #include "tensorflow/compiler/mlir/hlo/include/mlir-hlo/Dialect/lhlo_gpu/IR/lhlo_gpu_ops.h"
+#include "tensorflow/compiler/xla/service/gpu/backend_configs.pb.h"
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
 #include "tensorflow/compiler/xla/shape.h"
 #include "tensorflow/compiler/xla/statusor.h"
@@ -107,6 +108,14 @@ struct GemmConfig {
   int64_t compute_precision;
 };
 
+// Returns whether the cublasLt `epilogue` adds a broadcast bias vector, which
+// the custom call takes as an extra trailing operand.
+bool EpilogueAddsVectorBias(GemmBackendConfig::Epilogue epilogue);
+
+// Returns whether the cublasLt `epilogue` writes an auxiliary output, in which
+// case the custom call returns a (result, aux) tuple.
+bool EpilogueHasAuxiliaryOutput(GemmBackendConfig::Epilogue epilogue);
+
 // Run the given GEMM instruction `gemm` subject to the configuration
 // in `gemm_config` and the passed buffers.
 //
@@ -121,6 +130,9 @@ Status RunGemm(const GemmConfig& config, se::DeviceMemoryBase lhs_buffer,
 
 namespace cublas_lt {
 
+StatusOr<se::cuda::BlasLt::Epilogue> AsBlasLtEpilogue(
+    GemmBackendConfig::Epilogue epilogue);
+
 class MatmulPlan {
  public:
   static StatusOr<MatmulPlan> For(mlir::lmhlo_gpu::CublasLtMatmulOp op);
@@ -132,6 +144,7 @@ class MatmulPlan {
                          se::DeviceMemoryBase c_buffer,
                          se::DeviceMemoryBase d_buffer,
                          se::DeviceMemoryBase bias_buffer,  // may be null
+                         se::DeviceMemoryBase aux_buffer,   // may be null
                          const se::cuda::BlasLt::MatmulAlgorithm& algorithm,
                          se::ScratchAllocator& scratch_allocator,
                          se::blas::ProfileResult* profile_result = nullptr);
@@ -152,6 +165,7 @@ class MatmulPlan {
                   se::DeviceMemoryBase b_buffer, se::DeviceMemoryBase c_buffer,
                   se::DeviceMemoryBase d_buffer,
                   se::DeviceMemoryBase bias_buffer,  // may be null
+                  se::DeviceMemoryBase aux_buffer,   // may be null
                   const se::cuda::BlasLt::MatmulAlgorithm& algorithm,
                   se::ScratchAllocator& scratch_allocator,
                   se::blas::ProfileResult* profile_result);
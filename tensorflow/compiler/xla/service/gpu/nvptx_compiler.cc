@@ -168,11 +168,15 @@ std::optional<bool> CanShareBufferHint(const HloInstruction* user,
              (user_index.size() == 1 &&
               user->operand(user_index[0]) == operand);
     case HloOpcode::kCustomCall:
-      // The matrix bias operand can be overwritten in-place.
+      // The matrix bias operand can be overwritten in-place by the result,
+      // but not by an auxiliary output.
       if (user->custom_call_target() == kCublasLtMatmulCallTarget) {
         GemmBackendConfig config =
             std::move(user->backend_config<GemmBackendConfig>()).ValueOrDie();
-        return (config.beta() != 0.) && user->operand(2) == operand;
+        bool is_result_index =
+            user->shape().IsArray() || user_index == ShapeIndex{0};
+        return (config.beta() != 0.) && user->operand(2) == operand &&
+               is_result_index;
       }
       // The operand of cholesky can be shared with the first output.
       if (user->custom_call_target() == kCusolverCholeskyCallTarget) {
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/service/gpu/stream_assignment.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "absl/container/flat_hash_set.h"
@@ -60,10 +61,37 @@ inline bool IsStreamNumValid(int stream_num) {
   return stream_num != kInvalidStreamNum;
 }
 
+// Upper bound on the number of streams handed out. Past a handful of streams
+// the GPU is saturated anyway and every extra stream only adds cross-stream
+// synchronization.
+constexpr int kMaxStreamCount = 4;
+
+// Returns whether `hlo` is a library call large enough to be worth running on
+// its own stream. Everything else is cheap relative to the event
+// synchronization a stream switch would cost.
+bool IsConcurrencyCandidate(const HloInstruction& hlo) {
+  return IsCublasGemm(hlo) || IsMatrixMultiplication(hlo) ||
+         IsCustomCallToDnnConvolution(hlo);
+}
+
+// Returns the highest stream assigned to an operand of `hlo`, or the main stream
+// if none of them has one.
+int StreamOfOperands(const HloInstruction& hlo,
+                     const StreamAssignment& stream_assignment) {
+  int stream_num = 0;
+  for (const HloInstruction* operand : hlo.operands()) {
+    if (stream_assignment.HasStreamAssigned(*operand)) {
+      stream_num =
+          std::max(stream_num, stream_assignment.StreamNumberForHlo(*operand));
+    }
+  }
+  return stream_num;
+}
+
 // Returns which existing stream to assign to `hlo`, or -1 if a stream is not
 // needed. `stream_assignment` is the existing stream assignment for all
-// instructions topologically before `hlo`. `seen_gemms` contains all GEMMs that
-// are topologically before `hlo`.
+// instructions topologically before `hlo`. `seen_gemms` contains all GEMMs and
+// convolutions that are topologically before `hlo`.
 int ComputeStreamToAssign(
     const HloInstruction& hlo, const StreamAssignment& stream_assignment,
     const HloReachabilityMap& reachability,
@@ -75,10 +103,34 @@ int ComputeStreamToAssign(
   }
 
   const auto& debug_options = hlo.GetModule()->config().debug_options();
-  if (!debug_options.xla_gpu_disable_multi_streaming()) {
-    LOG(ERROR) << "Multi streaming is not supported";
+  if (debug_options.xla_gpu_disable_multi_streaming()) {
+    return 0;
+  }
+
+  if (!IsConcurrencyCandidate(hlo)) {
+    // Keep `hlo` close to its operands to avoid excessive synchronization.
+    return StreamOfOperands(hlo, stream_assignment);
+  }
+
+  // Assign different streams to concurrent GEMMs and convolutions, greedily:
+  // the streams of already assigned candidates that may run concurrently with
+  // `hlo` are forbidden, and `hlo` takes the lowest stream that is not.
+  absl::flat_hash_set<int> forbidden_stream_numbers;
+  for (const HloInstruction* seen_gemm : seen_gemms) {
+    int stream_num = stream_assignment.StreamNumberForHlo(*seen_gemm);
+    if (!forbidden_stream_numbers.contains(stream_num) &&
+        CanRunConcurrently(*seen_gemm, hlo, reachability)) {
+      forbidden_stream_numbers.insert(stream_num);
+    }
   }
-  return 0;
+  for (int stream_num = 0; stream_num < kMaxStreamCount; ++stream_num) {
+    if (!forbidden_stream_numbers.contains(stream_num)) {
+      return stream_num;
+    }
+  }
+
+  // All streams are busy; queue behind the operands rather than adding one.
+  return StreamOfOperands(hlo, stream_assignment);
 }
 
 }  // namespace
@@ -111,7 +163,7 @@ std::unique_ptr<StreamAssignment> AssignStreams(const HloModule& module) {
         stream_num_for_rng = stream_num;
       }
     }
-    if (IsCublasGemm(*hlo) || IsMatrixMultiplication(*hlo)) {
+    if (IsStreamNumValid(stream_num) && IsConcurrencyCandidate(*hlo)) {
       seen_gemms.push_back(hlo);
     }
   }
@@ -43,7 +43,7 @@ class StreamAssignmentTest : public HloTestBase {
   Shape f32_2x2_ = ShapeUtil::MakeShape(F32, {2, 2});
 };
 
-TEST_F(StreamAssignmentTest, DISABLED_SequentialMatMul) {
+TEST_F(StreamAssignmentTest, SequentialMatMul) {
   HloComputation::Builder builder("entry_computation");
   HloInstruction* x = builder.AddInstruction(HloInstruction::CreateParameter(
       /*parameter_number=*/0, f32_2x2_, /*name=*/"x"));
@@ -64,7 +64,7 @@ TEST_F(StreamAssignmentTest, DISABLED_SequentialMatMul) {
             assignment->StreamNumberForHlo(*dot2));
 }
 
-TEST_F(StreamAssignmentTest, DISABLED_ConcurrentMatMul) {
+TEST_F(StreamAssignmentTest, ConcurrentMatMul) {
   HloComputation::Builder builder("entry_computation");
   HloInstruction* x = builder.AddInstruction(HloInstruction::CreateParameter(
       /*parameter_number=*/0, f32_2x2_, /*name=*/"x"));
@@ -85,7 +85,7 @@ TEST_F(StreamAssignmentTest, DISABLED_ConcurrentMatMul) {
             assignment->StreamNumberForHlo(*dot2));
 }
 
-TEST_F(StreamAssignmentTest, DISABLED_LatticeMatMul) {
+TEST_F(StreamAssignmentTest, LatticeMatMul) {
   //      d00      -- layer 0
   //     /   \
   //   d10   d11   -- layer 1
@@ -140,5 +140,48 @@ TEST_F(StreamAssignmentTest, DISABLED_LatticeMatMul) {
             assignment->StreamNumberForHlo(*d31));
 }
 
+TEST_F(StreamAssignmentTest, CapsStreamCount) {
+  HloComputation::Builder builder("entry_computation");
+  HloInstruction* x = builder.AddInstruction(HloInstruction::CreateParameter(
+      /*parameter_number=*/0, f32_2x2_, /*name=*/"x"));
+  std::vector<HloInstruction*> dots;
+  for (int i = 0; i < 8; ++i) {
+    dots.push_back(builder.AddInstruction(CreateCanonicalDot(f32_2x2_, x, x)));
+  }
+  HloInstruction* tuple =
+      builder.AddInstruction(HloInstruction::CreateTuple(dots));
+
+  auto module = CreateNewVerifiedModule();
+  module->AddEntryComputation(builder.Build(tuple));
+
+  std::unique_ptr<StreamAssignment> assignment = AssignStreams(*module);
+  EXPECT_GT(assignment->StreamCount(), 1);
+  EXPECT_LE(assignment->StreamCount(), 4);
+}
+
+TEST_F(StreamAssignmentTest, SingleStreamWhenMultiStreamingIsDisabled) {
+  HloComputation::Builder builder("entry_computation");
+  HloInstruction* x = builder.AddInstruction(HloInstruction::CreateParameter(
+      /*parameter_number=*/0, f32_2x2_, /*name=*/"x"));
+  HloInstruction* y = builder.AddInstruction(HloInstruction::CreateParameter(
+      /*parameter_number=*/1, f32_2x2_, /*name=*/"y"));
+  HloInstruction* dot1 =
+      builder.AddInstruction(CreateCanonicalDot(f32_2x2_, x, y));
+  HloInstruction* dot2 =
+      builder.AddInstruction(CreateCanonicalDot(f32_2x2_, y, x));
+  builder.AddInstruction(
+      HloInstruction::CreateBinary(f32_2x2_, HloOpcode::kAdd, dot1, dot2));
+
+  HloModuleConfig config;
+  auto debug_options = GetDebugOptionsForTest();
+  debug_options.set_xla_gpu_disable_multi_streaming(true);
+  config.set_debug_options(debug_options);
+  auto module = std::make_unique<HloModule>("test_module", config);
+  module->AddEntryComputation(builder.Build());
+
+  std::unique_ptr<StreamAssignment> assignment = AssignStreams(*module);
+  EXPECT_EQ(assignment->StreamCount(), 1);
+}
+
 }  // namespace gpu
 }  // namespace xla
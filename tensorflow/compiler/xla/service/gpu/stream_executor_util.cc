@@ -370,13 +370,18 @@ Status ExecuteKernelOnStream(const se::KernelBase& kernel,
   } else {
     kernel_args = MakeKernelArgs<kKernelArgsLimit>(args);
   }
+  return ExecuteKernelOnStream(kernel, *kernel_args, dims, stream);
+}
 
+Status ExecuteKernelOnStream(const se::KernelBase& kernel,
+                             const se::KernelArgsArrayBase& args,
+                             const LaunchDimensions& dims, se::Stream* stream) {
   LaunchDimensions::Dim3D thread_counts = dims.thread_counts_per_block();
   LaunchDimensions::Dim3D block_counts = dims.block_counts();
   return stream->parent()->Launch(
       stream, se::ThreadDim(thread_counts.x, thread_counts.y, thread_counts.z),
       se::BlockDim(block_counts.x, block_counts.y, block_counts.z), kernel,
-      *kernel_args);
+      args);
 }
 
 // Unimplemented for integers yet.
@@ -87,6 +87,12 @@ Status ExecuteKernelOnStream(const se::KernelBase& kernel,
                              absl::Span<const se::DeviceMemoryBase> args,
                              const LaunchDimensions& dims, se::Stream* stream);
 
+// Same as above, with arguments that are already packed, e.g., into a
+// se::KernelArgsDeviceMemoryArray reused across launches.
+Status ExecuteKernelOnStream(const se::KernelBase& kernel,
+                             const se::KernelArgsArrayBase& args,
+                             const LaunchDimensions& dims, se::Stream* stream);
+
 // Initializes `buffer` with random data on `stream`.
 // `rng_state` is an inout parameter for the pseudorandom generator state.
 // `buffer_type` determines what buffer would be filled out with.
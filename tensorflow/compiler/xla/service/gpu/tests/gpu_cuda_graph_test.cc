@@ -0,0 +1,59 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <vector>
+
+#include "tensorflow/compiler/xla/service/gpu/tests/gpu_codegen_test.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+class GpuCudaGraphTest : public GpuCodegenTest {
+  DebugOptions GetDebugOptionsForTest() override {
+    DebugOptions debug_options = GpuCodegenTest::GetDebugOptionsForTest();
+    debug_options.set_xla_gpu_enable_cuda_graphs(true);
+    return debug_options;
+  }
+};
+
+constexpr char kHloText[] = R"(
+HloModule mod
+
+ENTRY main {
+  p0 = f32[1024] parameter(0)
+  p1 = f32[1024] parameter(1)
+  add = f32[1024] add(p0, p1)
+  exp = f32[1024] exponential(add)
+  ROOT tuple = (f32[1024], f32[1024]) tuple(add, exp)
+}
+)";
+
+TEST_F(GpuCudaGraphTest, CapturedGraphComputesSameResult) {
+  EXPECT_TRUE(RunAndCompare(kHloText, ErrorSpec{1e-5, 1e-5}));
+}
+
+TEST_F(GpuCudaGraphTest, ReplayedGraphIsDeterministic) {
+  // The first run captures the graph, the later ones replay it.
+  std::vector<ExecutionProfile> profiles(3);
+  EXPECT_TRUE(RunMultipleTimes(kHloText, /*run_hlo_passes=*/true, &profiles,
+                               /*backend_config=*/nullptr,
+                               /*assert_determinism=*/true));
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
@@ -20,6 +20,7 @@ limitations under the License.
 #include <functional>
 #include <memory>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
@@ -612,12 +613,79 @@ void GlobalDecreasingSizeBestFitHeap<BufferType>::Free(const BufferType* buffer,
 
 using Chunk = HeapSimulator::Chunk;
 
+namespace {
+
+// Nodes are ordered by start time, then end time, then chunk offset, which is
+// also the key that BufferIntervalTree::Remove looks for.
+std::tuple<int64_t, int64_t, int64_t> NodeKey(int64_t start, int64_t end,
+                                              const Chunk& chunk) {
+  return std::make_tuple(start, end, chunk.offset);
+}
+
+std::tuple<int64_t, int64_t, int64_t> NodeKey(
+    const BufferIntervalTreeNode& node) {
+  return NodeKey(node.start, node.end, node.chunk);
+}
+
+// Returns the treap priority of the `index`-th node added to a tree. This is
+// the splitmix64 mix of the index: it looks random enough to keep the tree
+// balanced but doesn't make the tree shape depend on a seed.
+uint64_t TreapPriority(uint64_t index) {
+  uint64_t z = index + 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+void UpdateSubtreeEnd(BufferIntervalTreeNode* node) {
+  node->subtree_end = node->end;
+  if (node->left) {
+    node->subtree_end = std::max(node->subtree_end, node->left->subtree_end);
+  }
+  if (node->right) {
+    node->subtree_end = std::max(node->subtree_end, node->right->subtree_end);
+  }
+}
+
+}  // namespace
+
+void BufferIntervalTree::RotateUp(BufferIntervalTreeNode* node) {
+  BufferIntervalTreeNode* parent = node->parent;
+  BufferIntervalTreeNode* grandparent = parent->parent;
+  if (parent->left == node) {
+    parent->left = node->right;
+    if (node->right) {
+      node->right->parent = parent;
+    }
+    node->right = parent;
+  } else {
+    parent->right = node->left;
+    if (node->left) {
+      node->left->parent = parent;
+    }
+    node->left = parent;
+  }
+  parent->parent = node;
+  node->parent = grandparent;
+  if (grandparent == nullptr) {
+    root_ = node;
+  } else if (grandparent->left == parent) {
+    grandparent->left = node;
+  } else {
+    grandparent->right = node;
+  }
+  UpdateSubtreeEnd(parent);
+  UpdateSubtreeEnd(node);
+}
+
 void BufferIntervalTree::Add(int64_t start, int64_t end, const Chunk& chunk) {
   node_storage_.emplace_back(BufferIntervalTreeNode{
       start, end, end, chunk,
-      /*left=*/nullptr, /*right=*/nullptr, /*parent=*/nullptr});
+      /*left=*/nullptr, /*right=*/nullptr, /*parent=*/nullptr,
+      /*priority=*/TreapPriority(node_storage_.size())});
+  BufferIntervalTreeNode* node = &node_storage_.back();
   if (root_ == nullptr) {
-    root_ = &node_storage_.back();
+    root_ = node;
     // This is root.
     return;
   }
@@ -625,22 +693,26 @@ void BufferIntervalTree::Add(int64_t start, int64_t end, const Chunk& chunk) {
   BufferIntervalTreeNode* parent = root_;
   while (true) {
     parent->subtree_end = std::max(parent->subtree_end, end);
-    if (parent->start > start) {
+    if (NodeKey(*parent) > NodeKey(*node)) {
       if (parent->left == nullptr) {
-        parent->left = &node_storage_.back();
-        node_storage_.back().parent = parent;
-        return;
+        parent->left = node;
+        break;
       }
       parent = parent->left;
     } else {
       if (parent->right == nullptr) {
-        parent->right = &node_storage_.back();
-        node_storage_.back().parent = parent;
-        return;
+        parent->right = node;
+        break;
       }
       parent = parent->right;
     }
   }
+  node->parent = parent;
+  // Restore the heap order of the priorities. The `subtree_end` of the nodes
+  // above the rotations already accounts for `end`.
+  while (node->parent != nullptr && node->parent->priority < node->priority) {
+    RotateUp(node);
+  }
 }
 
 bool BufferIntervalTree::Remove(int64_t start, int64_t end,
@@ -651,7 +723,7 @@ bool BufferIntervalTree::Remove(int64_t start, int64_t end,
         to_delete->chunk.offset == chunk.offset) {
       break;
     }
-    if (start < to_delete->start) {
+    if (NodeKey(start, end, chunk) < NodeKey(*to_delete)) {
       to_delete = to_delete->left;
     } else {
       to_delete = to_delete->right;
@@ -671,15 +743,7 @@ bool BufferIntervalTree::Remove(int64_t start, int64_t end,
         if (node == nullptr) {
           return;
         }
-        node->subtree_end = node->end;
-        if (node->left) {
-          node->subtree_end =
-              std::max(node->subtree_end, node->left->subtree_end);
-        }
-        if (node->right) {
-          node->subtree_end =
-              std::max(node->subtree_end, node->right->subtree_end);
-        }
+        UpdateSubtreeEnd(node);
         // Recursively go up.
         fix_up(node->parent);
       };
@@ -702,6 +766,9 @@ bool BufferIntervalTree::Remove(int64_t start, int64_t end,
     if (root_ == to_delete) {
       // Deleting root is simply reseting root;
       root_ = to_delete->left;
+      if (root_ != nullptr) {
+        root_->parent = nullptr;
+      }
       return true;
     }
 
@@ -906,18 +973,33 @@ GlobalDecreasingSizeBestFitHeap<BufferType>::FindChunkCandidate(
     }
   };
 
-  subtract_used_chunks(interval_tree_.ChunksOverlappingInTime(
-      buffer_interval.start, buffer_interval.end));
-
+  // Merge the live ranges of the buffer and its colocations into disjoint time
+  // ranges before querying the interval tree. Large colocation sets (e.g. the
+  // buffers of a while loop) tend to overlap heavily, and querying each of them
+  // separately would subtract the same chunks over and over again.
+  std::vector<std::pair<int64_t, int64_t>> live_ranges = {
+      {buffer_interval.start, buffer_interval.end}};
   for (const BufferType* colocation :
        GetTransitiveColocations(buffer_interval)) {
     const BufferInterval& interval = buffer_intervals_.at(colocation);
     VLOG(1) << "  Alias size " << interval.size << ", start " << interval.start
             << ", end " << interval.end << " " << interval.buffer->ToString();
-
-    subtract_used_chunks(
-        interval_tree_.ChunksOverlappingInTime(interval.start, interval.end));
+    live_ranges.emplace_back(interval.start, interval.end);
+  }
+  absl::c_sort(live_ranges);
+  int64_t range_start = live_ranges.front().first;
+  int64_t range_end = live_ranges.front().second;
+  for (const auto& [start, end] : live_ranges) {
+    // Times are inclusive, so adjacent ranges can be merged as well.
+    if (start > range_end + 1) {
+      subtract_used_chunks(
+          interval_tree_.ChunksOverlappingInTime(range_start, range_end));
+      range_start = start;
+    }
+    range_end = std::max(range_end, end);
   }
+  subtract_used_chunks(
+      interval_tree_.ChunksOverlappingInTime(range_start, range_end));
 
   // Try to find a large enough free chunk containing the preferred offset.
   Chunk chunk{preferred_offset, buffer_interval.size};
@@ -331,9 +331,14 @@ struct BufferIntervalTreeNode {
   BufferIntervalTreeNode* right;
   // parent
   BufferIntervalTreeNode* parent;
+  // Treap priority; every node's priority is at least that of its children.
+  uint64_t priority;
 };
 
-// An interval tree that can query buffers overlapping in time.
+// An interval tree that can query buffers overlapping in time. The tree is kept
+// balanced as a treap with deterministic pseudo-random priorities, so that
+// buffers added in order of their start times (e.g. many equally sized buffers
+// sorted by GlobalDecreasingSizeBestFitHeap) don't degrade it into a list.
 class BufferIntervalTree {
  public:
   using Chunk = HeapSimulator::Chunk;
@@ -351,6 +356,9 @@ class BufferIntervalTree {
   BufferIntervalTreeNode* GetRoot() { return root_; }
 
  private:
+  // Rotates `node` above its parent, preserving the search tree order.
+  void RotateUp(BufferIntervalTreeNode* node);
+
   BufferIntervalTreeNode* root_ = nullptr;
   std::list<BufferIntervalTreeNode> node_storage_;
 };
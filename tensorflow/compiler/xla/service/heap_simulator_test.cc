@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/service/heap_simulator.h"
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -32,6 +34,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/tests/hlo_test_base.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 
 namespace xla {
 namespace {
@@ -1632,5 +1635,59 @@ TEST_F(IntervalTreeTest, ThreeLevelsRightLeftChunkDifferent) {
   ASSERT_EQ(tree.GetRoot(), nullptr);
 }
 
+TEST_F(IntervalTreeTest, SortedInsertionsStayBalanced) {
+  HeapSimulator::Chunk chunk({1, 2});  // Value in chunk doesn't matter here.
+  constexpr int kNumIntervals = 1 << 16;
+  BufferIntervalTree tree;
+  for (int i = 0; i < kNumIntervals; ++i) {
+    tree.Add(i, i + 1, chunk);
+  }
+  std::function<int(const BufferIntervalTreeNode*)> depth =
+      [&](const BufferIntervalTreeNode* node) {
+        return node == nullptr
+                   ? 0
+                   : 1 + std::max(depth(node->left), depth(node->right));
+      };
+  EXPECT_LT(depth(tree.GetRoot()), 64);
+  EXPECT_EQ(tree.ChunksOverlappingInTime(100, 101).size(), 3);
+  for (int i = 0; i < kNumIntervals; i += 2) {
+    EXPECT_TRUE(tree.Remove(i, i + 1, chunk));
+  }
+  EXPECT_EQ(tree.ChunksOverlappingInTime(100, 101).size(), 2);
+}
+
+// Allocates `state.range(0)` equally sized buffers that each live across the
+// next few allocations. The buffers are sorted by duration and then in program
+// order, which used to degenerate the interval tree into a list.
+void BM_GlobalDecreasingSizeBestFitHeap(::testing::benchmark::State& state) {
+  const int num_buffers = state.range(0);
+  constexpr int kNumLiveBuffers = 4;
+  HloComputation::Builder builder("heap_simulator_benchmark");
+  HloInstruction* constant = builder.AddInstruction(
+      HloInstruction::CreateConstant(LiteralUtil::CreateR0<float>(1.0)));
+  std::vector<std::unique_ptr<HloValue>> buffers;
+  buffers.reserve(num_buffers);
+  for (int i = 0; i < num_buffers; ++i) {
+    buffers.push_back(std::make_unique<HloValue>(i, constant, ShapeIndex{}));
+  }
+  for (auto s : state) {
+    GlobalDecreasingSizeBestFitHeap<HloValue> heap(/*alignment=*/1);
+    for (int i = 0; i < num_buffers; ++i) {
+      if (i >= kNumLiveBuffers) {
+        heap.Free(buffers[i - kNumLiveBuffers].get(), 1024);
+      }
+      heap.Alloc(buffers[i].get(), 1024);
+    }
+    for (int i = std::max(0, num_buffers - kNumLiveBuffers); i < num_buffers;
+         ++i) {
+      heap.Free(buffers[i].get(), 1024);
+    }
+    const HeapSimulator::Result<HloValue> result = heap.Finish();
+    CHECK_EQ(result.heap_size, 1024 * std::min(num_buffers, kNumLiveBuffers));
+  }
+}
+
+BENCHMARK(BM_GlobalDecreasingSizeBestFitHeap)->Range(1 << 10, 1 << 20);
+
 }  // namespace
 }  // namespace xla
@@ -74,6 +74,9 @@ StatusOr<bool> HloConstantFolding::Run(
   auto evaluator = std::make_unique<HloEvaluator>(/*max_loop_iterations=*/0);
   // fast-path lets us e.g. use Eigen for matmuls.
   evaluator->set_use_fast_path(true);
+  // Don't spend minutes interpreting large ops that have no fast path.
+  static const int64_t kMaximumSlowPathOperations = 1000 * 1000 * 1000;
+  evaluator->set_slow_path_operation_limit(kMaximumSlowPathOperations);
 
   bool changed = false;
 
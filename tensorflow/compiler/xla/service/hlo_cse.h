@@ -43,6 +43,11 @@ class HloCSE : public HloModulePass {
       HloModule* module,
       const absl::flat_hash_set<absl::string_view>& execution_threads) override;
 
+  // CSE only commons instructions within a computation, so it can be run on
+  // several computations concurrently.
+  bool IsComputationLocal() const override { return true; }
+  StatusOr<bool> RunOnComputation(HloComputation* computation) override;
+
  private:
   const bool is_layout_sensitive_;
   const bool only_fusion_computations_;
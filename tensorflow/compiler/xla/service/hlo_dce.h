@@ -54,6 +54,20 @@ class HloDCE : public HloModulePass {
       HloModule* module,
       const absl::flat_hash_set<absl::string_view>& execution_threads) override;
 
+  // Dead instructions are removed one computation at a time; dead
+  // computations are removed afterwards in FinishRunOnComputations.
+  bool IsComputationLocal() const override { return true; }
+  StatusOr<bool> RunOnComputation(HloComputation* computation) override {
+    return RunOnComputation(computation,
+                            remove_cross_partition_collective_ops_);
+  }
+  StatusOr<bool> FinishRunOnComputations(
+      HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads)
+      override {
+    return RecursivelyRemoveDeadComputations(module, execution_threads);
+  }
+
  private:
   // Finds all computations that are not called by any instruction and removes
   // them from the module. Returns whether any dead code was removed.
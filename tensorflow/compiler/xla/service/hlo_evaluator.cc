@@ -3707,6 +3707,18 @@ static StatusOr<bool> GenerateReduceOutputElement(
   return true;
 }
 
+Status HloEvaluator::CheckSlowPathOperationCount(
+    const HloInstruction& instruction, int64_t operation_count) const {
+  if (slow_path_operation_limit_ >= 0 &&
+      operation_count > slow_path_operation_limit_) {
+    return Unimplemented(
+        "Evaluating %s needs %d scalar operations, which exceeds the limit of "
+        "%d",
+        instruction.name(), operation_count, slow_path_operation_limit_);
+  }
+  return OkStatus();
+}
+
 Status HloEvaluator::HandleReduce(HloInstruction* instr) {
   HloReduceInstruction* reduce = Cast<HloReduceInstruction>(instr);
   int64_t num_args = reduce->inputs().size();
@@ -3739,6 +3751,11 @@ Status HloEvaluator::HandleReduce(HloInstruction* instr) {
 
   // All args and results have the same dimensions, so pick an arbitrary one.
   const Shape& arg_shape = input_args[0]->shape();
+  if (!IsScalarAdd(function)) {
+    TF_RETURN_IF_ERROR(CheckSlowPathOperationCount(
+        *reduce, ShapeUtil::ElementsIn(arg_shape) * num_args *
+                     function->instruction_count()));
+  }
   const Shape& out_shape = inferred_return_shape;
   bool is_tuple = out_shape.IsTuple();
   const Shape& output_shape = inferred_return_shape.IsTuple()
@@ -197,6 +197,13 @@ class HloEvaluator : public DfsHloVisitorWithDefault {
   // Enable the fast path for certain operations like dot or convolution.
   void set_use_fast_path(bool value) { use_fast_path_ = value; }
 
+  // Makes dots, convolutions and reductions that would be interpreted element
+  // by element fail with an Unimplemented error if they need more than `limit`
+  // scalar operations. A negative limit means no limit.
+  void set_slow_path_operation_limit(int64_t limit) {
+    slow_path_operation_limit_ = limit;
+  }
+
   // Handles evaluation of a custom-call op.
   // Operand literals are provided in |operands| and implementations must
   // populate |output| before returning.
@@ -428,6 +435,14 @@ class HloEvaluator : public DfsHloVisitorWithDefault {
   // Use fast path that uses eigen in the evaluator.
   bool use_fast_path_ = false;
 
+  // Maximum number of scalar operations of an instruction that is interpreted
+  // element by element, or -1 for no limit.
+  int64_t slow_path_operation_limit_ = -1;
+
+  // Returns an error if `operation_count` exceeds slow_path_operation_limit_.
+  Status CheckSlowPathOperationCount(const HloInstruction& instruction,
+                                     int64_t operation_count) const;
+
  private:
   template <typename ReturnT, typename NativeT>
   static StatusOr<Literal> ElementWiseUnaryOpImpl(
@@ -5462,5 +5462,61 @@ TEST_F(PatternMatchParseWhileLoopTest, BooleanCond) {
   EXPECT_EQ(parsed_while_loop->static_while_loop->loop_bound, 1);
 }
 
+TEST_F(HloEvaluatorTest, FastPathDotWithTransposedOperands) {
+  const char* hlo_text = R"(
+HloModule DotTransposed
+
+ENTRY main {
+  lhs = f64[3,2] parameter(0)
+  rhs = f64[4,3] parameter(1)
+  ROOT dot = f64[2,4] dot(lhs, rhs), lhs_contracting_dims={0},
+    rhs_contracting_dims={1}
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(m_, ParseAndReturnVerifiedModule(hlo_text));
+  Literal lhs = LiteralUtil::CreateR2<double>({{1, 2}, {3, 4}, {5, 6}});
+  Literal rhs = LiteralUtil::CreateR2<double>(
+      {{1, 0, -1}, {2, 1, 0}, {0, 3, 1}, {-2, 1, 4}});
+  Literal expected =
+      LiteralUtil::CreateR2<double>({{-4, 5, 14, 21}, {-4, 8, 18, 24}});
+
+  evaluator_.set_use_fast_path(true);
+  TF_ASSERT_OK_AND_ASSIGN(Literal result, Evaluate({&lhs, &rhs}));
+  EXPECT_TRUE(LiteralTestUtil::Equal(expected, result));
+
+  evaluator_.set_use_fast_path(false);
+  TF_ASSERT_OK_AND_ASSIGN(Literal slow_result, Evaluate({&lhs, &rhs}));
+  EXPECT_TRUE(LiteralTestUtil::Equal(expected, slow_result));
+}
+
+TEST_F(HloEvaluatorTest, SlowPathOperationLimit) {
+  const char* hlo_text = R"(
+HloModule DotS8
+
+ENTRY main {
+  lhs = s8[4,4] parameter(0)
+  rhs = s8[4,4] parameter(1)
+  ROOT dot = s8[4,4] dot(lhs, rhs), lhs_contracting_dims={1},
+    rhs_contracting_dims={0}
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(m_, ParseAndReturnVerifiedModule(hlo_text));
+  Array2D<int8_t> ones(4, 4, 1);
+  Literal lhs = LiteralUtil::CreateR2FromArray2D(ones);
+  Literal rhs = LiteralUtil::CreateR2FromArray2D(ones);
+
+  // The dot has 16 outputs that each accumulate 4 products.
+  evaluator_.set_slow_path_operation_limit(63);
+  StatusOr<Literal> result = Evaluate({&lhs, &rhs});
+  ASSERT_FALSE(result.ok());
+  EXPECT_EQ(result.status().code(), tensorflow::error::UNIMPLEMENTED);
+
+  evaluator_.set_slow_path_operation_limit(64);
+  TF_ASSERT_OK_AND_ASSIGN(Literal bounded_result, Evaluate({&lhs, &rhs}));
+  EXPECT_TRUE(LiteralTestUtil::Equal(
+      LiteralUtil::CreateR2FromArray2D(Array2D<int8_t>(4, 4, 4)),
+      bounded_result));
+}
+
 }  // namespace
 }  // namespace xla
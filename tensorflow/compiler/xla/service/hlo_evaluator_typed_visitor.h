@@ -1118,6 +1118,16 @@ class HloEvaluatorTypedVisitor : public DfsHloVisitorWithDefault {
         << " but is inferred to be: "
         << ShapeUtil::HumanString(inferred_return_shape);
 
+    // Each output element accumulates over the kernel elements of one output
+    // feature.
+    const int64_t kernel_output_features = std::max<int64_t>(
+        1, rhs_shape.dimensions(dnums.kernel_output_feature_dimension()));
+    const int64_t kernel_elements_per_output =
+        ShapeUtil::ElementsIn(rhs_shape) / kernel_output_features;
+    TF_RETURN_IF_ERROR(parent_->CheckSlowPathOperationCount(
+        *conv,
+        ShapeUtil::ElementsIn(result_shape) * kernel_elements_per_output));
+
     const Literal& lhs_literal = parent_->GetEvaluatedLiteralFor(lhs);
     const Literal& rhs_literal = parent_->GetEvaluatedLiteralFor(rhs);
     const bool lhs_same = ShapeUtil::SameElementType(lhs_shape, result_shape);
@@ -1150,8 +1160,36 @@ class HloEvaluatorTypedVisitor : public DfsHloVisitorWithDefault {
     return HandleDotSlowPath(dot);
   }
 
-  template <typename NativeT, typename std::enable_if_t<
-                                  std::is_same_v<NativeT, float>>* = nullptr>
+  // Types with an Eigen-backed HloEvaluator::MatmulArray2D.
+  template <typename NativeT>
+  static constexpr bool kHasFastMatmul =
+      std::is_same_v<NativeT, float> || std::is_same_v<NativeT, double> ||
+      std::is_same_v<NativeT, std::complex<float>> ||
+      std::is_same_v<NativeT, std::complex<double>> ||
+      std::is_same_v<NativeT, int32_t>;
+
+  // Returns the rows x cols matrix held by `literal`, which is laid out as
+  // cols x rows if `transpose` is true.
+  template <typename NativeT>
+  static Array2D<NativeT> MatrixFromLiteral(const Literal& literal,
+                                            int64_t rows, int64_t cols,
+                                            bool transpose) {
+    Array2D<NativeT> array(rows, cols);
+    absl::Span<const NativeT> data = literal.data<NativeT>();
+    if (!transpose) {
+      array.SetValues(data);
+      return array;
+    }
+    for (int64_t i = 0; i < rows; ++i) {
+      for (int64_t j = 0; j < cols; ++j) {
+        array(i, j) = data[j * rows + i];
+      }
+    }
+    return array;
+  }
+
+  template <typename NativeT,
+            typename std::enable_if_t<kHasFastMatmul<NativeT>>* = nullptr>
   Status HandleDot(HloInstruction* dot) {
     const HloInstruction* lhs = dot->operand(0);
     const HloInstruction* rhs = dot->operand(1);
@@ -1180,9 +1218,9 @@ class HloEvaluatorTypedVisitor : public DfsHloVisitorWithDefault {
         << " rhs contracted dimension: "
         << rhs->shape().dimensions(rhs_contracting_dimension);
 
-    // The fast path is for a simple rank 2 dot with default layout operands.
-    if (lhs_rank != 2 || rhs_rank != 2 || lhs_contracting_dimension != 1 ||
-        rhs_contracting_dimension != 0 ||
+    // The fast path is for a rank 2 dot with default layout operands, either
+    // of which may be transposed.
+    if (lhs_rank != 2 || rhs_rank != 2 ||
         !LayoutUtil::Equal(lhs->shape().layout(),
                            LayoutUtil::GetDefaultLayoutForR2()) ||
         !LayoutUtil::Equal(rhs->shape().layout(),
@@ -1200,12 +1238,14 @@ class HloEvaluatorTypedVisitor : public DfsHloVisitorWithDefault {
         parent_->GetEvaluatedLiteralFor(rhs).Convert(native_ty).ValueOrDie();
     const int64_t contracted_dimension_size =
         lhs->shape().dimensions(lhs_contracting_dimension);
-    Array2D<NativeT> lhs_array(lhs->shape().dimensions(0),
-                               contracted_dimension_size);
-    lhs_array.SetValues(lhs_literal.data<NativeT>());
-    Array2D<NativeT> rhs_array(contracted_dimension_size,
-                               rhs->shape().dimensions(1));
-    rhs_array.SetValues(rhs_literal.data<NativeT>());
+    Array2D<NativeT> lhs_array = MatrixFromLiteral<NativeT>(
+        lhs_literal, lhs->shape().dimensions(1 - lhs_contracting_dimension),
+        contracted_dimension_size,
+        /*transpose=*/lhs_contracting_dimension == 0);
+    Array2D<NativeT> rhs_array = MatrixFromLiteral<NativeT>(
+        rhs_literal, contracted_dimension_size,
+        rhs->shape().dimensions(1 - rhs_contracting_dimension),
+        /*transpose=*/rhs_contracting_dimension == 1);
     std::unique_ptr<Array2D<NativeT>> result_array =
         HloEvaluator::MatmulArray2D(lhs_array, rhs_array);
     Literal result(ShapeUtil::MakeShape(native_ty, dot->shape().dimensions()));
@@ -1215,8 +1255,8 @@ class HloEvaluatorTypedVisitor : public DfsHloVisitorWithDefault {
     return OkStatus();
   }
 
-  template <typename NativeT, typename std::enable_if_t<
-                                  !std::is_same_v<NativeT, float>>* = nullptr>
+  template <typename NativeT,
+            typename std::enable_if_t<!kHasFastMatmul<NativeT>>* = nullptr>
   Status HandleDot(HloInstruction* dot) {
     return HandleDotSlowPath(dot);
   }
@@ -1323,6 +1363,13 @@ class HloEvaluatorTypedVisitor : public DfsHloVisitorWithDefault {
     CHECK(dot->shape().IsArray());
     CHECK(lhs->shape().IsArray());
     CHECK(rhs->shape().IsArray());
+    int64_t contracted_elements = 1;
+    for (int64_t dim :
+         dot->dot_dimension_numbers().lhs_contracting_dimensions()) {
+      contracted_elements *= lhs->shape().dimensions(dim);
+    }
+    TF_RETURN_IF_ERROR(parent_->CheckSlowPathOperationCount(
+        *dot, ShapeUtil::ElementsIn(dot->shape()) * contracted_elements));
     const bool lhs_same =
         ShapeUtil::SameElementType(lhs->shape(), dot->shape());
     const bool rhs_same =
@@ -28,6 +28,7 @@ limitations under the License.
 
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "tensorflow/compiler/xla/iterator_util.h"
 #include "tensorflow/compiler/xla/service/compilation_environments.h"
@@ -362,11 +363,22 @@ class HloModule {
 
   // Assign a new unique dense id for an instruction
   int NewUniqueInstructionId() {
+    absl::MutexLock lock(&instruction_uniquer_mutex_);
     int result = next_unique_id_;
     next_unique_id_++;
     return result;
   }
 
+  // Gives `instruction` a name and an id which are unique within this module.
+  // Unlike going through instruction_name_uniquer() directly this is
+  // thread-safe, so computation-local passes may add instructions to different
+  // computations of the module concurrently.
+  void UniquifyInstructionNameAndId(HloInstruction* instruction) {
+    absl::MutexLock lock(&instruction_uniquer_mutex_);
+    instruction->UniquifyName(&instruction_name_uniquer_);
+    instruction->SetUniqueId(next_unique_id_++);
+  }
+
   // input_output_alias_config indicates the list of aliased buffers that are
   // expected from the module.
   HloInputOutputAliasConfig& input_output_alias_config() {
@@ -534,6 +546,9 @@ class HloModule {
   NameUniquer computation_name_uniquer_{/*separator=*/"."};
   NameUniquer instruction_name_uniquer_{/*separator=*/"."};
   int next_unique_id_ = 0;
+  // Guards instruction_name_uniquer_ and next_unique_id_ when instructions are
+  // added through UniquifyInstructionNameAndId.
+  absl::Mutex instruction_uniquer_mutex_;
 
   // Used to keep track of the next unique module id that should be assigned.
   static std::atomic<int> next_unique_module_id_;
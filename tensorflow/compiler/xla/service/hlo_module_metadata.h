@@ -98,6 +98,24 @@ class HloModuleMetadata {
           pass_metadata->set_module_id(module_id);
         });
   }
+  Status set_current_pass_instruction_count(int64_t instruction_count) {
+    return MutateCurrentHloPassMetadata(
+        [&instruction_count](HloPassMetadata* pass_metadata) {
+          pass_metadata->set_instruction_count(instruction_count);
+        });
+  }
+  Status set_current_pass_peak_rss_bytes(int64_t peak_rss_bytes) {
+    return MutateCurrentHloPassMetadata(
+        [&peak_rss_bytes](HloPassMetadata* pass_metadata) {
+          pass_metadata->set_peak_rss_bytes(peak_rss_bytes);
+        });
+  }
+  Status set_current_pass_fixed_point_iterations(int64_t iterations) {
+    return MutateCurrentHloPassMetadata(
+        [&iterations](HloPassMetadata* pass_metadata) {
+          pass_metadata->set_fixed_point_iterations(iterations);
+        });
+  }
   Status add_current_pass_module_group_module_id(int64_t module_id) {
     return MutateCurrentHloPassMetadata(
         [&module_id](HloPassMetadata* pass_metadata) {
@@ -38,6 +38,10 @@ class HloPassFix : public Pass {
   template <typename... Args>
   explicit HloPassFix(Args&&... args) : Pass(args...) {}
 
+  // Running to a fixed point needs the whole module, so the wrapped pass is
+  // never run one computation at a time.
+  bool IsComputationLocal() const override { return false; }
+
   Status RunOnChangedComputations(HloModule* module, RunState* outer_run_state,
                                   const absl::flat_hash_set<absl::string_view>&
                                       execution_threads) override {
@@ -55,6 +59,7 @@ class HloPassFix : public Pass {
                          execution_threads) override {
     RunState run_state(module);
     TF_RETURN_IF_ERROR(RunToFixPoint(module, &run_state, execution_threads));
+    RecordIterations(module, run_state.iteration);
     return !run_state.changed.empty();
   }
 
@@ -76,14 +81,29 @@ class HloPassFix : public Pass {
       if (iteration_count == kIterationLimit) {
         VLOG(1) << "Unexpectedly high number of iterations in HLO passes, "
                    "exiting fixed point loop.";
+        for (HloModule* module : module_group->modules()) {
+          RecordIterations(module, iteration_count);
+        }
         // Return false in case this is fixed point is nested.
         return false;
       }
     }
+    for (HloModule* module : module_group->modules()) {
+      RecordIterations(module, iteration_count);
+    }
     return changed;
   }
 
  private:
+  // Records the iteration count in the metadata of the pass currently running
+  // on `module`. This is a no-op when the pass is not run by a pipeline, as
+  // there is no pass metadata to update then.
+  static void RecordIterations(HloModule* module, int64_t iterations) {
+    module->metadata()
+        ->set_current_pass_fixed_point_iterations(iterations)
+        .IgnoreError();
+  }
+
   Status RunToFixPoint(
       HloModule* module, RunState* run_state,
       const absl::flat_hash_set<absl::string_view>& execution_threads) {
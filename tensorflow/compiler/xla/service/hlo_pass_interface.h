@@ -140,6 +140,28 @@ class HloPassInterface {
       const absl::flat_hash_set<absl::string_view>& execution_threads) = 0;
 
   virtual bool IsPassPipeline() { return false; }
+
+  // Returns whether the pass can be run one computation at a time through
+  // RunOnComputation. Such a pass only mutates the instructions of the
+  // computation it is given. It may read, but not mutate, the computations
+  // called by that computation, and it must not add or remove computations.
+  // HloPassPipeline may then run it on several computations concurrently.
+  virtual bool IsComputationLocal() const { return false; }
+
+  // Runs a computation-local pass on `computation`. Returns whether the
+  // computation was changed.
+  virtual StatusOr<bool> RunOnComputation(HloComputation* computation) {
+    return InternalError("Pass %s is not computation-local", name());
+  }
+
+  // Called once after RunOnComputation has been run on every computation of
+  // `module`, for module-level work such as removing dead computations.
+  // Returns whether the module was changed.
+  virtual StatusOr<bool> FinishRunOnComputations(
+      HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads) {
+    return false;
+  }
 };
 
 // Base class for passes which are module-scoped.
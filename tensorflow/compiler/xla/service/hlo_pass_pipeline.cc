@@ -15,8 +15,15 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/service/hlo_pass_pipeline.h"
 
+#include <algorithm>
 #include <functional>
 #include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
@@ -28,6 +35,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/status_macros.h"
 #include "tensorflow/compiler/xla/types.h"
 #include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
 
@@ -35,6 +43,19 @@ namespace xla {
 
 namespace {
 
+// Returns the peak resident set size of the process in bytes, or 0 if it is
+// not available on this platform.
+int64_t PeakRssBytes() {
+#if defined(__linux__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    // ru_maxrss is reported in kilobytes on Linux.
+    return static_cast<int64_t>(usage.ru_maxrss) * 1024;
+  }
+#endif
+  return 0;
+}
+
 void RecordPassStartMetadata(HloModule& module, const std::string& pass_name,
                              const std::string& pipeline_name) {
   module.metadata()->RecordPassStart();
@@ -60,6 +81,10 @@ Status AttemptRecordPassEndMetadata(HloModule& module,
       module.metadata()->set_current_pass_module_id(module.unique_id()));
   TF_RETURN_IF_ERROR(
       module.metadata()->set_current_pass_module_changed(module_changed));
+  TF_RETURN_IF_ERROR(module.metadata()->set_current_pass_instruction_count(
+      module.instruction_count()));
+  TF_RETURN_IF_ERROR(
+      module.metadata()->set_current_pass_peak_rss_bytes(PeakRssBytes()));
   TF_RETURN_IF_ERROR(module.metadata()->RecordPassEnd());
   return OkStatus();
 }
@@ -203,6 +228,57 @@ StatusOr<bool> HloPassPipeline::RunPassesInternal(
   return changed;
 }
 
+StatusOr<bool> HloPassPipeline::RunComputationLocalPass(
+    HloPassInterface* pass, HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  // Group the computations into waves: a computation's wave is one past the
+  // latest wave of any computation it calls, so that the computations a pass
+  // reads through called_computations() are never mutated concurrently.
+  absl::flat_hash_map<const HloComputation*, int64_t> wave_of;
+  std::vector<std::vector<HloComputation*>> waves;
+  for (HloComputation* computation :
+       module->MakeComputationPostOrder(execution_threads)) {
+    int64_t wave = 0;
+    for (const HloInstruction* instruction : computation->instructions()) {
+      for (const HloComputation* callee : instruction->called_computations()) {
+        auto it = wave_of.find(callee);
+        if (it != wave_of.end()) {
+          wave = std::max(wave, it->second + 1);
+        }
+      }
+    }
+    wave_of[computation] = wave;
+    if (waves.size() <= wave) {
+      waves.resize(wave + 1);
+    }
+    waves[wave].push_back(computation);
+  }
+
+  bool changed = false;
+  for (const std::vector<HloComputation*>& wave : waves) {
+    std::vector<StatusOr<bool>> results(wave.size(), false);
+    if (wave.size() == 1) {
+      results[0] = pass->RunOnComputation(wave[0]);
+    } else {
+      tensorflow::BlockingCounter counter(wave.size());
+      for (int64_t i = 0; i < wave.size(); ++i) {
+        thread_pool_->Schedule([&results, &wave, &counter, pass, i] {
+          results[i] = pass->RunOnComputation(wave[i]);
+          counter.DecrementCount();
+        });
+      }
+      counter.Wait();
+    }
+    for (StatusOr<bool>& result : results) {
+      TF_ASSIGN_OR_RETURN(bool computation_changed, std::move(result));
+      changed |= computation_changed;
+    }
+  }
+  TF_ASSIGN_OR_RETURN(bool finish_changed,
+                      pass->FinishRunOnComputations(module, execution_threads));
+  return changed || finish_changed;
+}
+
 std::vector<HloPassInterface*> HloPassPipeline::GetEnabledPasses(
     const DebugOptions& debug_options) {
   if (debug_options.xla_disable_all_hlo_passes()) {
@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/hlo_pass_interface.h"
 #include "tensorflow/compiler/xla/statusor.h"
 #include "tensorflow/compiler/xla/types.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace xla {
 
@@ -89,6 +90,16 @@ class HloPassPipeline : public HloPassInterface {
 
   bool IsPassPipeline() override { return true; }
 
+  // Runs computation-local passes (see HloPassInterface::IsComputationLocal)
+  // concurrently across the computations of a module using `thread_pool`.
+  // Computations are processed in waves so that a computation is only visited
+  // once every computation it calls has been visited. Passes which are not
+  // computation-local, and runs on module groups, stay sequential. The thread
+  // pool must outlive the pipeline; nullptr (the default) disables this mode.
+  void set_thread_pool(tensorflow::thread::ThreadPool* thread_pool) {
+    thread_pool_ = thread_pool;
+  }
+
   // Return size of passes_.
   int PassesSize() { return passes_.size(); }
   // Return reference to pass specified by index.
@@ -134,10 +145,16 @@ class HloPassPipeline : public HloPassInterface {
   // empty thread list means all `execution_threads` are considered. These
   // helpers enable templating of the core of the pipeline logic by providing
   // HloModule and HloModuleGroup specific methods with the same name.
-  static StatusOr<bool> RunHelper(
+  StatusOr<bool> RunHelper(
       HloPassInterface* pass, HloModule* module,
       const absl::flat_hash_set<absl::string_view>& execution_threads) {
-    TF_ASSIGN_OR_RETURN(bool changed, pass->Run(module, execution_threads));
+    bool changed;
+    if (thread_pool_ != nullptr && pass->IsComputationLocal()) {
+      TF_ASSIGN_OR_RETURN(
+          changed, RunComputationLocalPass(pass, module, execution_threads));
+    } else {
+      TF_ASSIGN_OR_RETURN(changed, pass->Run(module, execution_threads));
+    }
     module->Cleanup();
     return changed;
   }
@@ -150,10 +167,17 @@ class HloPassPipeline : public HloPassInterface {
     return changed;
   }
 
+  // Runs the computation-local `pass` on the computations of `module` using
+  // thread_pool_.
+  StatusOr<bool> RunComputationLocalPass(
+      HloPassInterface* pass, HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads);
+
   const std::string name_;
   std::vector<std::unique_ptr<HloPassInterface>> passes_;
   std::vector<std::unique_ptr<HloPassInterface>> invariant_checkers_;
   bool run_called_ = false;
+  tensorflow::thread::ThreadPool* thread_pool_ = nullptr;
 
   CompilationStats* compilation_stats_;
   // Default stats instance for when one is not passed in the constructor.
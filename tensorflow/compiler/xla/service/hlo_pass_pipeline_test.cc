@@ -15,13 +15,19 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/service/hlo_pass_pipeline.h"
 
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorflow/compiler/xla/service/hlo_computation.h"
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
 #include "tensorflow/compiler/xla/service/hlo_module.h"
 #include "tensorflow/compiler/xla/service/hlo_parser.h"
+#include "tensorflow/compiler/xla/service/hlo_pass_fix.h"
 #include "tensorflow/compiler/xla/tests/hlo_test_base.h"
 #include "tensorflow/compiler/xla/util.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace xla {
 namespace {
@@ -66,6 +72,31 @@ class FooToBarModulePass : public HloModulePass {
   }
 };
 
+// A module pass which renames a single instruction whose name starts with 'foo'
+// to start with 'bar' instead, so it takes one run per such instruction to
+// reach a fixed point.
+class OneFooToBarModulePass : public HloModulePass {
+ public:
+  absl::string_view name() const override { return "one-foo2bar"; }
+
+  using HloPassInterface::Run;
+  StatusOr<bool> Run(HloModule* module,
+                     const absl::flat_hash_set<absl::string_view>&
+                         execution_threads) override {
+    for (HloComputation* computation :
+         module->computations(execution_threads)) {
+      for (HloInstruction* instruction : computation->instructions()) {
+        if (absl::StartsWith(instruction->name(), "foo")) {
+          instruction->SetAndSanitizeName(
+              absl::StrCat("bar", instruction->name().substr(3)));
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+};
+
 // A module pass which renames root instructions names in reverse string order,
 // e.g. "xyz" becomes "zyx".
 class ReverseStringModulePass : public HloModulePass {
@@ -133,6 +164,61 @@ class BarBlowerUpper : public HloModulePass {
   }
 };
 
+// A computation-local pass which renames root instructions named 'foo' to
+// 'bar' and checks that every called computation was visited before its
+// caller.
+class ComputationLocalFooToBarPass : public HloModulePass {
+ public:
+  absl::string_view name() const override { return "local-foo2bar"; }
+
+  using HloPassInterface::Run;
+  StatusOr<bool> Run(HloModule* module,
+                     const absl::flat_hash_set<absl::string_view>&
+                         execution_threads) override {
+    bool changed = false;
+    for (HloComputation* computation :
+         module->MakeComputationPostOrder(execution_threads)) {
+      TF_ASSIGN_OR_RETURN(bool computation_changed,
+                          RunOnComputation(computation));
+      changed |= computation_changed;
+    }
+    return changed;
+  }
+
+  bool IsComputationLocal() const override { return true; }
+  StatusOr<bool> RunOnComputation(HloComputation* computation) override {
+    {
+      absl::MutexLock lock(&mu_);
+      for (const HloInstruction* instruction : computation->instructions()) {
+        for (HloComputation* callee : instruction->called_computations()) {
+          if (!visited_.contains(callee)) {
+            return InternalError("%s visited before %s", computation->name(),
+                                 callee->name());
+          }
+        }
+      }
+    }
+    bool changed = false;
+    HloInstruction* root = computation->root_instruction();
+    if (root->name() == "foo") {
+      root->SetAndSanitizeName("bar");
+      changed = true;
+    }
+    absl::MutexLock lock(&mu_);
+    visited_.insert(computation);
+    return changed;
+  }
+
+  int64_t num_visited() {
+    absl::MutexLock lock(&mu_);
+    return visited_.size();
+  }
+
+ private:
+  absl::Mutex mu_;
+  absl::flat_hash_set<HloComputation*> visited_;
+};
+
 TEST_F(HloPassPipelineTest, ModulePassChanged) {
   // Test an HLO module pass which changes a module.
   const std::string module_str = R"(
@@ -246,6 +332,52 @@ ENTRY %Entry (p0: f32[10], p1: f32[10]) -> f32[10] {
   EXPECT_EQ(parallel_thread_root->name(), "oof");
 }
 
+TEST_F(HloPassPipelineTest, ComputationLocalPassOnThreadPool) {
+  const std::string module_str = R"(
+HloModule ComputationLocalPassOnThreadPool
+
+add {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT foo = f32[] add(lhs, rhs)
+}
+
+mul {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT foo = f32[] multiply(lhs, rhs)
+}
+
+outer {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT foo = f32[] call(lhs, rhs), to_apply=mul
+}
+
+ENTRY main {
+  a = f32[] parameter(0)
+  b = f32[] parameter(1)
+  sum = f32[] call(a, b), to_apply=add
+  product = f32[] call(a, b), to_apply=outer
+  ROOT foo = f32[] subtract(sum, product)
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(module_str));
+  tensorflow::thread::ThreadPool thread_pool(tensorflow::Env::Default(),
+                                             "test", /*num_threads=*/4);
+  HloPassPipeline pipeline(TestName());
+  pipeline.set_thread_pool(&thread_pool);
+  auto& pass = pipeline.AddPass<ComputationLocalFooToBarPass>();
+
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, pipeline.Run(module.get()));
+  EXPECT_TRUE(changed);
+  EXPECT_EQ(pass.num_visited(), 4);
+  for (const HloComputation* computation : module->computations()) {
+    EXPECT_EQ(computation->root_instruction()->name(), "bar");
+  }
+}
+
 TEST_F(HloPassPipelineTest, MixedPipeline) {
   // Test a pipeline with both a module pass and a module group pass.
   const std::string module_0_str = R"(
@@ -401,5 +533,37 @@ TEST_F(HloPassPipelineTest, SetHloModuleMetadata) {
   }
 }
 
+// Test that the compile profile fields of the pass metadata are set.
+TEST_F(HloPassPipelineTest, SetPassProfileMetadata) {
+  const std::string module_str = R"(
+HloModule SetPassProfileMetadata
+
+ENTRY main {
+  a = f32[] parameter(0)
+  foo.1 = f32[] negate(a)
+  ROOT foo.2 = f32[] negate(foo.1)
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(module_str));
+  HloPassPipeline pipeline(TestName());
+  pipeline.AddPass<HloPassFix<OneFooToBarModulePass>>();
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, pipeline.Run(module.get()));
+  EXPECT_TRUE(changed);
+
+  const HloModuleMetadataProto& metadata = module->metadata()->proto();
+  ASSERT_THAT(metadata.pass_metadata(), SizeIs(2));
+  const HloPassMetadata& start_metadata = metadata.pass_metadata(0);
+  EXPECT_THAT(start_metadata.pass_name(), StrEq("pipeline-start"));
+  EXPECT_EQ(start_metadata.fixed_point_iterations(), 0);
+
+  const HloPassMetadata& pass_metadata = metadata.pass_metadata(1);
+  EXPECT_THAT(pass_metadata.pass_name(), StrEq("one-foo2bar"));
+  // Two runs rename an instruction each, and a third one finds nothing left.
+  EXPECT_EQ(pass_metadata.fixed_point_iterations(), 3);
+  EXPECT_EQ(pass_metadata.instruction_count(), 3);
+  EXPECT_GE(pass_metadata.peak_rss_bytes(), 0);
+}
+
 }  // namespace
 }  // namespace xla
@@ -16,8 +16,10 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/hlo_rematerialization.h"
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 
@@ -489,6 +491,18 @@ UsesList GetUsers(const InstructionList& instruction_list,
   return users;
 }
 
+// Run time estimates used to rank rematerialization candidates under a
+// HloRematerialization::TimeBudget.
+struct TimeModel {
+  // Returns the estimated run time of an instruction.
+  std::function<double(HloInstruction*)> instruction_seconds;
+  // The estimated time it takes to read or write one byte.
+  double seconds_per_byte;
+  // The run time that rematerialization may still add. Reduced as candidates
+  // are rematerialized.
+  double* remaining_seconds;
+};
+
 // Class for tracking memory usage of a computation as the instructions are
 // placed sequentially. Memory usage is the sum of the sizes of live values
 // (LogicalBuffers) at the current point in the instruction sequence.
@@ -500,7 +514,8 @@ class MemoryUsageTracker {
       const HloRematerialization::CompactShapeFunction& compact_shape_function,
       const TuplePointsToAnalysis& points_to_analysis,
       const InstructionList& instruction_list,
-      HloRematerialization::RematerializationMode mode);
+      HloRematerialization::RematerializationMode mode,
+      const TimeModel* time_model = nullptr);
 
   // Starts the placement of the given instruction. This adds the sizes of the
   // LogicalBuffers defined by the instruction to the current memory
@@ -535,6 +550,21 @@ class MemoryUsageTracker {
     return memory_limit_bytes / memory_reduced;
   }
 
+  // Returns the estimated run time that rematerializing 'items' with 'strategy'
+  // adds, or zero if there is no time model.
+  double RematerializationSeconds(const std::vector<Item*>& items,
+                                  const RematStrategy& strategy) const;
+
+  // Charges the estimated run time of rematerializing 'items' with 'strategy'
+  // to the time budget. Must be called before the rematerialization happens.
+  void ChargeTimeBudget(const std::vector<Item*>& items,
+                        const RematStrategy& strategy) const {
+    if (time_model_ != nullptr) {
+      *time_model_->remaining_seconds -=
+          RematerializationSeconds(items, strategy);
+    }
+  }
+
   // Finishes the placement of the current instruction. This frees any dead
   // operands or dead result of the instruction. This must be called after
   // each call to BeginInstruction.
@@ -785,6 +815,11 @@ class MemoryUsageTracker {
   Item* in_progress_item_ = nullptr;
 
   HloRematerialization::RematerializationMode mode_;
+
+  // Estimates of the run time added by rematerialization, or nullptr to rank
+  // candidates by memory saved only.
+  const TimeModel* time_model_;
+
   // All buffers in the computation.
   std::vector<Buffer> buffers_;
 };
@@ -795,12 +830,14 @@ MemoryUsageTracker::MemoryUsageTracker(
     const HloRematerialization::CompactShapeFunction& compact_shape_function,
     const TuplePointsToAnalysis& points_to_analysis,
     const InstructionList& instruction_list,
-    HloRematerialization::RematerializationMode mode)
+    HloRematerialization::RematerializationMode mode,
+    const TimeModel* time_model)
     : computation_(computation),
       instruction_list_(instruction_list),
       size_function_(size_function),
       compact_shape_function_(compact_shape_function),
-      mode_(mode) {
+      mode_(mode),
+      time_model_(time_model) {
   PointsToSet::BufferSet live_out_set =
       points_to_analysis.GetPointsToSet(computation_->root_instruction())
           .CreateFlattenedSet();
@@ -1346,6 +1383,36 @@ int64_t RematerializationCost(const HloInstruction* instruction,
   return memory_limit_bytes / memory_reduced;
 }
 
+double MemoryUsageTracker::RematerializationSeconds(
+    const std::vector<Item*>& items, const RematStrategy& strategy) const {
+  if (time_model_ == nullptr) {
+    return 0;
+  }
+  if (strategy.kind == RematStrategy::kCompress) {
+    // Compressing reads the original buffer and writes the compact one, and
+    // uncompressing does the opposite.
+    CHECK_EQ(items.size(), 1);
+    const int64_t bytes =
+        size_function_(items[0]->instruction->shape()) +
+        size_function_(strategy.compact_shape);
+    return 2 * bytes * time_model_->seconds_per_byte;
+  }
+  // Moving instructions whose users have not been placed yet adds no work.
+  const bool zero_cost_move = absl::c_none_of(items, [this](const Item* item) {
+    return absl::c_any_of(
+        item->instruction->users(),
+        [this](const HloInstruction* inst) { return IsPlaced(inst); });
+  });
+  if (zero_cost_move) {
+    return 0;
+  }
+  double seconds = 0;
+  for (const Item* item : items) {
+    seconds += time_model_->instruction_seconds(item->instruction);
+  }
+  return seconds;
+}
+
 // Returns a block of up to min_block_size consecutive candidate instructions
 // from instruction_list starting from start_item. Returns fewer than
 // min_block_size instructions if the block of unplaced instructions starting
@@ -1388,9 +1455,28 @@ MemoryUsageTracker::PickRematerializationCandidates(
     absl::flat_hash_map<const HloInstruction*, bool>* rematerializable_map,
     int min_block_size, int max_block_size, int64_t peak_memory_bytes) {
   std::vector<Item*> best_items;
-  int64_t best_cost = 0;
+  double best_cost = 0;
   RematStrategy best_strategy;
 
+  // Returns the cost of a candidate which reduces memory by 'memory_reduced',
+  // or nullopt if it doesn't fit into the time budget. With a time model this
+  // is the estimated run time added per byte saved.
+  auto candidate_cost = [&](const std::vector<Item*>& items,
+                            const RematStrategy& strategy,
+                            int64_t memory_reduced) -> std::optional<double> {
+    if (time_model_ == nullptr) {
+      return strategy.kind == RematStrategy::kCompress
+                 ? memory_limit_bytes / memory_reduced
+                 : RematerializationCost(items, memory_reduced,
+                                         memory_limit_bytes);
+    }
+    const double seconds = RematerializationSeconds(items, strategy);
+    if (seconds > *time_model_->remaining_seconds) {
+      return std::nullopt;
+    }
+    return seconds / memory_reduced;
+  };
+
   int effort = 0;
   VLOG(5) << "Picking candidate block with size in [" << min_block_size << ", "
           << max_block_size << "]";
@@ -1440,21 +1526,23 @@ MemoryUsageTracker::PickRematerializationCandidates(
               const int64_t size = size_function_(item->instruction->shape());
               const int64_t reduced_size = size_function_(compact_shape);
               effort++;
+              RematStrategy strategy;
+              strategy.kind = RematStrategy::kCompress;
+              strategy.compact_shape = compact_shape;
+              std::optional<double> cost;
               if (memory_reduced > 0 &&
                   size + reduced_size < peak_memory_bytes) {
-                const int64_t cost = memory_limit_bytes / memory_reduced;
-                if (best_items.empty() || cost < best_cost) {
-                  VLOG(3) << "candidate " << candidate->name() << "("
-                          << candidate->ToShortString() << ")"
-                          << " now best when compressed into "
-                          << compact_shape.ToString(true);
-                  RematStrategy strategy;
-                  strategy.kind = RematStrategy::kCompress;
-                  best_strategy = strategy;
-                  best_strategy.compact_shape = compact_shape;
-                  best_items = block;
-                  best_cost = cost;
-                }
+                cost = candidate_cost(block, strategy, memory_reduced);
+              }
+              if (cost.has_value() &&
+                  (best_items.empty() || *cost < best_cost)) {
+                VLOG(3) << "candidate " << candidate->name() << "("
+                        << candidate->ToShortString() << ")"
+                        << " now best when compressed into "
+                        << compact_shape.ToString(true);
+                best_strategy = strategy;
+                best_items = block;
+                best_cost = *cost;
               }
             }
           }
@@ -1489,22 +1577,25 @@ MemoryUsageTracker::PickRematerializationCandidates(
       }
       const int64_t memory_reduced = MemoryReducedIfRematerialized(block);
       effort++;
+      RematStrategy strategy;
+      strategy.kind = RematStrategy::kRecompute;
+      std::optional<double> cost;
       if (memory_reduced > 0) {
-        const int cost =
-            RematerializationCost(block, memory_reduced, memory_limit_bytes);
-
+        cost = candidate_cost(block, strategy, memory_reduced);
+      }
+      if (cost.has_value()) {
         VLOG(5) << "Candidate block of size " << block.size()
                 << " starting from " << block[0]->instruction->name()
                 << ", memory reduced " << memory_reduced << ", cost per byte "
-                << cost;
+                << *cost;
 
-        if (best_items.empty() || cost < best_cost) {
+        if (best_items.empty() || *cost < best_cost) {
           VLOG(5) << "Candidate block of size " << block.size()
                   << " starting from " << block[0]->instruction->name()
                   << " now best";
-          best_strategy.kind = RematStrategy::kRecompute;
+          best_strategy = strategy;
           best_items = block;
-          best_cost = cost;
+          best_cost = *cost;
         }
       }
 
@@ -1732,12 +1823,18 @@ StatusOr<int64_t> CompressInstruction(MemoryUsageTracker* memory_tracker,
           << ") to" << compact_shape.ToString(true);
 
   HloComputation* computation = best->parent();
+  // A compact shape with a different element type (e.g. BF16 for F32) trades
+  // precision for memory and is converted rather than copied.
+  const HloOpcode opcode =
+      compact_shape.element_type() == best->shape().element_type()
+          ? HloOpcode::kCopy
+          : HloOpcode::kConvert;
   HloInstruction* compressed = computation->AddInstruction(
-      HloInstruction::CreateUnary(compact_shape, HloOpcode::kCopy, best),
+      HloInstruction::CreateUnary(compact_shape, opcode, best),
       /*new_name=*/best->name() + ".remat_compressed");
 
   HloInstruction* uncompressed = computation->AddInstruction(
-      HloInstruction::CreateUnary(best->shape(), HloOpcode::kCopy, compressed),
+      HloInstruction::CreateUnary(best->shape(), opcode, compressed),
       /*new_name=*/best->name() + ".remat_uncompressed");
 
   Item* compressed_item = instruction_list->CreateItem(compressed);
@@ -1815,6 +1912,7 @@ StatusOr<InstructionsAdded> RematerializeBestBlock(
     num_instructions_added.net_instructions_added = 0;
     return num_instructions_added;
   }
+  memory_tracker->ChargeTimeBudget(best_items, best_strategy);
 
   if (best_strategy.kind == RematStrategy::kCompress) {
     CHECK(best_items.size() == 1)
@@ -1878,6 +1976,22 @@ StatusOr<int64_t> HloRematerialization::CalledComputationsMemoryUsage(
   return callee_usage;
 }
 
+double HloRematerialization::InstructionSeconds(HloInstruction* instruction) {
+  auto it = instruction_seconds_.find(instruction);
+  if (it != instruction_seconds_.end()) {
+    return it->second;
+  }
+  HloCostAnalysis cost_analysis(time_budget_.cost_analysis_options);
+  double seconds = 0;
+  if (cost_analysis.Preprocess(instruction).ok() &&
+      instruction->Visit(&cost_analysis).ok() &&
+      cost_analysis.Postprocess(instruction).ok()) {
+    seconds = cost_analysis.optimal_seconds(*instruction);
+  }
+  instruction_seconds_[instruction] = seconds;
+  return seconds;
+}
+
 StatusOr<bool> HloRematerialization::RematerializeComputation(
     HloComputation* computation, HloSchedule* schedule,
     int64_t memory_limit_bytes, int64_t min_remat_size) {
@@ -1888,9 +2002,22 @@ StatusOr<bool> HloRematerialization::RematerializeComputation(
   CHECK(!ContainsKey(rematerialized_computations_, computation));
 
   InstructionList instruction_list(schedule->sequence(computation));
+  std::optional<TimeModel> time_model;
+  if (time_budget_.max_slowdown > 0) {
+    const float bytes_per_second =
+        time_budget_.cost_analysis_options.per_second_rate(
+            HloCostAnalysis::kBytesAccessedKey);
+    time_model = TimeModel{
+        [this](HloInstruction* instruction) {
+          return InstructionSeconds(instruction);
+        },
+        bytes_per_second > 0 ? 1.0 / bytes_per_second : 0.0,
+        &remaining_time_budget_seconds_};
+  }
   MemoryUsageTracker memory_tracker(
       computation, size_function_, compact_shape_function_,
-      *points_to_analysis_, instruction_list, mode_);
+      *points_to_analysis_, instruction_list, mode_,
+      time_model.has_value() ? &*time_model : nullptr);
 
   instruction_list.PromoteNodesToSkip([&](Item* item) {
     return memory_tracker.AllocatedSize(item) >= min_remat_size;
@@ -2083,6 +2210,20 @@ StatusOr<bool> HloRematerialization::Run(
 
   TF_RET_CHECK(module->has_schedule());
   TF_ASSIGN_OR_RETURN(points_to_analysis_, TuplePointsToAnalysis::Run(module));
+
+  instruction_seconds_.clear();
+  remaining_time_budget_seconds_ = 0;
+  if (time_budget_.max_slowdown > 0) {
+    if (!time_budget_.cost_analysis_options.shape_size) {
+      time_budget_.cost_analysis_options.shape_size = size_function_;
+    }
+    HloCostAnalysis cost_analysis(time_budget_.cost_analysis_options);
+    TF_RETURN_IF_ERROR(module->entry_computation()->Accept(&cost_analysis));
+    remaining_time_budget_seconds_ =
+        time_budget_.max_slowdown * cost_analysis.optimal_seconds();
+    VLOG(1) << "Rematerialization may add up to "
+            << remaining_time_budget_seconds_ << "s of estimated run time";
+  }
   next_channel_id_ = hlo_query::NextChannelId(*module);
 
   // Adjust memory limit to account for the output of the entry
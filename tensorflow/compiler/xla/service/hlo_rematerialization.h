@@ -18,6 +18,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "tensorflow/compiler/xla/service/call_graph.h"
+#include "tensorflow/compiler/xla/service/hlo_cost_analysis.h"
 #include "tensorflow/compiler/xla/service/hlo_computation.h"
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
 #include "tensorflow/compiler/xla/service/hlo_memory_scheduler.h"
@@ -65,6 +66,21 @@ class HloRematerialization : public HloModulePass {
 
   static Shape DefaultCompactShapeFunction(const Shape& shape) { return shape; }
 
+  // Bounds the run time that rematerialization may add. With a positive
+  // max_slowdown, candidates are ranked by the estimated time they add per byte
+  // of memory they save, instead of by the memory saved alone, and no candidate
+  // is rematerialized once it would make the module's estimated run time grow
+  // by more than a factor of (1 + max_slowdown).
+  struct TimeBudget {
+    // The allowed relative growth of the estimated run time, e.g. 0.1 for 10%.
+    // Zero disables the time budget.
+    double max_slowdown = 0;
+    // Options of the HloCostAnalysis the estimates (the roofline
+    // optimal_seconds) are taken from. The per-second rates of the target must
+    // be set; if no shape size function is given, the pass's is used.
+    HloCostAnalysis::Options cost_analysis_options;
+  };
+
   // Constructor parameters:
   //
   //   size_function: Function which returns the size in bytes of the top-level
@@ -102,6 +118,10 @@ class HloRematerialization : public HloModulePass {
 
   absl::string_view name() const override { return "rematerialization"; }
 
+  void set_time_budget(TimeBudget time_budget) {
+    time_budget_ = std::move(time_budget);
+  }
+
   // Get the next available channel id and increment count.
   int64_t NextChannelId() { return next_channel_id_++; }
 
@@ -144,6 +164,10 @@ class HloRematerialization : public HloModulePass {
   StatusOr<int64_t> CalledComputationsMemoryUsage(
       const HloInstruction* instruction) const;
 
+  // Returns the estimated run time of the given instruction under the time
+  // budget's cost model. Estimates are cached.
+  double InstructionSeconds(HloInstruction* instruction);
+
   // Selects an algorithm to use for HLO scheduling.
   MemorySchedulerAlgorithm scheduler_algorithm_;
 
@@ -209,6 +233,14 @@ class HloRematerialization : public HloModulePass {
 
   int64_t min_remat_size_;
 
+  TimeBudget time_budget_;
+
+  // The run time that rematerialization may still add under the time budget.
+  double remaining_time_budget_seconds_ = 0;
+
+  // Cache of InstructionSeconds().
+  absl::flat_hash_map<const HloInstruction*, double> instruction_seconds_;
+
   // Tracking available channel id numbers to use to apply to rematerialized
   // channel instructions
   int64_t next_channel_id_;
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/hlo_rematerialization.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "tensorflow/compiler/xla/service/hlo_computation.h"
@@ -40,9 +41,10 @@ using ::testing::_;
 // RematerializationTestBase for more.
 class HloRematerializationTest : public RematerializationTestBase {
  protected:
-  StatusOr<bool> RunHloRematerialization(int64_t memory_limit_bytes,
-                                         HloModule* module,
-                                         int64_t min_remat_size = 0) {
+  StatusOr<bool> RunHloRematerialization(
+      int64_t memory_limit_bytes, HloModule* module, int64_t min_remat_size = 0,
+      std::optional<HloRematerialization::TimeBudget> time_budget =
+          std::nullopt) {
     TF_EXPECT_OK(verifier().Run(module).status());
     HloMemoryScheduler scheduler(
         [](const BufferValue& buffer) { return ByteSizeOf(buffer.shape()); },
@@ -55,8 +57,20 @@ class HloRematerializationTest : public RematerializationTestBase {
         /*block_size_limit=*/1, /*block_rematerialization_factor=*/1, nullptr,
         HloRematerialization::RematerializationMode::kRecomputeAndCompress,
         min_remat_size);
+    if (time_budget.has_value()) {
+      remat.set_time_budget(*time_budget);
+    }
     return remat.Run(module);
   }
+
+  static HloRematerialization::TimeBudget MakeTimeBudget(double max_slowdown) {
+    HloRematerialization::TimeBudget time_budget;
+    time_budget.max_slowdown = max_slowdown;
+    time_budget.cost_analysis_options.set_flops_per_second(1e9);
+    time_budget.cost_analysis_options.set_transcendentals_per_second(1e8);
+    time_budget.cost_analysis_options.set_bytes_per_second(1e9);
+    return time_budget;
+  }
 };
 
 // Test rematerialization of a single computation produced by
@@ -119,6 +133,38 @@ TEST_F(HloRematerializationTest, SingleComputationNoWorthRemat) {
   EXPECT_FALSE(changed);
 }
 
+// Test that recomputing the broadcast fits into a generous time budget.
+TEST_F(HloRematerializationTest, SingleComputationWithinTimeBudget) {
+  auto module = CreateNewVerifiedModule();
+  HloComputation* computation =
+      module->AddEntryComputation(MakeRematerializableComputation());
+  const HloInstruction* concat = computation->root_instruction()->operand(0);
+  const HloInstruction* bcast = concat->operand(0);
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed, RunHloRematerialization(
+                        /*memory_limit_bytes=*/14 * 1024, module.get(),
+                        /*min_remat_size=*/0, MakeTimeBudget(1.0)));
+  EXPECT_TRUE(changed);
+  EXPECT_THAT(concat->operand(0), op::Broadcast(::testing::Ne(bcast)));
+}
+
+// Test that nothing is rematerialized if the time budget doesn't allow for
+// recomputing the broadcast.
+TEST_F(HloRematerializationTest, SingleComputationOverTimeBudget) {
+  auto module = CreateNewVerifiedModule();
+  HloComputation* computation =
+      module->AddEntryComputation(MakeRematerializableComputation());
+  EXPECT_EQ(computation->instruction_count(), 8);
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed, RunHloRematerialization(
+                        /*memory_limit_bytes=*/14 * 1024, module.get(),
+                        /*min_remat_size=*/0, MakeTimeBudget(1e-6)));
+  EXPECT_FALSE(changed);
+  EXPECT_EQ(computation->instruction_count(), 8);
+}
+
 // Test rematerialization of a single computation produced by
 // MakeRematerializableComputation but with a sufficiently high memory limit
 // such that no instructions are rematerialized.
@@ -700,6 +746,51 @@ ENTRY %entry {
               op::Reduce(op::Copy(op::Copy(broadcast)), op::Constant()));
 }
 
+// Test compressing a buffer into a narrower element type, which converts
+// instead of copying.
+TEST_F(CompressingRematerializationTest, CompressToNarrowerType) {
+  const std::string& hlo_string = R"(
+HloModule fusion, is_scheduled=true
+
+%add_float {
+  %x = f32[] parameter(0)
+  %y = f32[] parameter(1)
+  ROOT %add = f32[] add(f32[] %x, f32[] %y)
+}
+
+ENTRY %entry {
+  %param.0 = f32[] parameter(0)
+  %constant = f32[] constant(0)
+  %broadcast.0 = f32[64,2]{1,0} broadcast(f32[] %param.0), dimensions={}
+  %negate = f32[64,2]{1,0} negate(f32[64,2]{1,0} broadcast.0)
+  %reduce.0 = f32[] reduce(f32[64,2]{1,0} %negate, f32[] %constant), dimensions={1, 0}, to_apply=%add_float
+  %reduce.1 = f32[] reduce(f32[64,2]{1,0} %broadcast.0, f32[] %constant), dimensions={1, 0}, to_apply=%add_float
+  %add = f32[] add(f32[] %reduce.0, f32[] %reduce.1)
+}
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  HloRematerialization remat(
+      ShapeSizePadMinorTo64, /*memory_limit_bytes=*/30 * 1024,
+      /*sizes=*/nullptr,
+      HloRematerialization::RematerializationPass::kPreFusion,
+      /*block_size_limit=*/1, /*block_rematerialization_factor=*/1,
+      [](const Shape& shape) -> StatusOr<Shape> {
+        return ShapeUtil::ChangeElementType(shape, BF16);
+      },
+      HloRematerialization::RematerializationMode::kCompressOnly);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, remat.Run(module.get()));
+  EXPECT_TRUE(changed);
+  HloInstruction* broadcast =
+      module->entry_computation()->GetInstructionWithName("broadcast.0");
+  HloInstruction* reduce =
+      module->entry_computation()->GetInstructionWithName("reduce.1");
+  EXPECT_THAT(reduce, op::Reduce(op::Convert(op::Convert(broadcast)),
+                                 op::Constant()));
+  EXPECT_EQ(reduce->operand(0)->operand(0)->shape().element_type(), BF16);
+}
+
 // Test a pathological case where the peak memory is largely due to a single
 // tensor (broadcast.0) and compressing it would actually increase the peak
 // memory.
@@ -1085,6 +1085,11 @@ struct Options {
 
   // If true, tries allocating buffers across (e.g., before and inside a while
   // loop body) sequential calls (kWhile, kCall, and kConditional).
+  //
+  // Note that prefetches are always scheduled within the while nest level of
+  // their use, so a prefetch for a use early in a while body can't overlap the
+  // end of the previous iteration; that would need prefetch intervals that
+  // wrap around the back edge of the body.
   bool allocate_across_sequential_calls = false;
 
   // If true, verifies the memory space assignment against overlapping
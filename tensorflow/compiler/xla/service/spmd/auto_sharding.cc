@@ -0,0 +1,271 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/spmd/auto_sharding.h"
+
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/compiler/xla/array.h"
+#include "tensorflow/compiler/xla/service/hlo_computation.h"
+#include "tensorflow/compiler/xla/service/hlo_instruction.h"
+#include "tensorflow/compiler/xla/service/hlo_sharding.h"
+#include "tensorflow/compiler/xla/service/sharding_propagation.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+
+namespace xla {
+namespace spmd {
+namespace {
+
+// Aggressiveness used to infer the sharding an instruction requires from its
+// operands. The highest level also propagates through ops that may need to
+// reshard, which is what lets the cost model see those resharding costs.
+constexpr int64_t kOperandShardingAggressiveness = 3;
+
+// Returns the number of distinct pieces the data of an array is split into.
+int64_t ShardCount(const HloSharding& sharding) {
+  if (sharding.IsTileMaximal() || sharding.IsManual()) {
+    return 1;
+  }
+  return sharding.NumTiles();
+}
+
+// Estimated bytes each device sends to turn data of `bytes` sharded as `from`
+// into data sharded as `to`.
+double ReshardingBytes(int64_t bytes, const HloSharding& from,
+                       const HloSharding& to) {
+  if (from == to || from.IsTileMaximal()) {
+    // Every device already holds the data it needs.
+    return 0;
+  }
+  const int64_t from_shards = ShardCount(from);
+  if (to.IsTileMaximal()) {
+    // All-gather.
+    return bytes * (1.0 - 1.0 / from_shards);
+  }
+  // All-to-all, or a more general exchange of the local shard.
+  return static_cast<double>(bytes) / from_shards;
+}
+
+// An instruction whose sharding is being decided, and the costs of its
+// candidate strategies.
+struct Node {
+  HloInstruction* instruction;
+  int64_t bytes;
+  // Whether the instruction had a sharding before the pass.
+  bool fixed;
+  std::vector<HloSharding> strategies;
+  // Per-device memory cost of each strategy.
+  std::vector<double> memory_costs;
+  // operand_requirements[s][i] is the sharding operand_edges[i] needs to have
+  // under strategy `s`.
+  std::vector<std::vector<HloSharding>> operand_requirements;
+  // Operands whose sharding is being decided, as node ids.
+  std::vector<int64_t> operand_edges;
+  // (user node id, index into that user's operand_edges).
+  std::vector<std::pair<int64_t, int64_t>> user_edges;
+};
+
+std::vector<HloSharding> CandidateStrategies(const HloInstruction& instruction,
+                                             int64_t num_devices) {
+  std::vector<HloSharding> strategies = {HloSharding::Replicate()};
+  if (instruction.HasSideEffect() ||
+      instruction.opcode() == HloOpcode::kCustomCall) {
+    return strategies;
+  }
+  const Shape& shape = instruction.shape();
+  for (int64_t dim = 0; dim < shape.rank(); ++dim) {
+    if (shape.dimensions(dim) < num_devices ||
+        shape.dimensions(dim) % num_devices != 0) {
+      continue;
+    }
+    std::vector<int64_t> tile_dims(shape.rank(), 1);
+    tile_dims[dim] = num_devices;
+    Array<int64_t> tile_assignment(tile_dims);
+    tile_assignment.FillIota(0);
+    strategies.push_back(HloSharding::Tile(tile_assignment));
+  }
+  return strategies;
+}
+
+}  // namespace
+
+StatusOr<bool> AutoSharding::Run(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  if (options_.num_devices <= 1) {
+    return false;
+  }
+  HloComputation* computation = module->entry_computation();
+
+  // Build the nodes in post order, so that operands precede their users.
+  std::vector<Node> nodes;
+  absl::flat_hash_map<const HloInstruction*, int64_t> node_ids;
+  for (HloInstruction* instruction : computation->MakeInstructionPostOrder()) {
+    if (!instruction->shape().IsArray()) {
+      continue;
+    }
+    Node node;
+    node.instruction = instruction;
+    node.bytes = ShapeUtil::ByteSizeOf(instruction->shape());
+    node.fixed = instruction->has_sharding();
+    if (node.fixed) {
+      node.strategies = {instruction->sharding()};
+    } else {
+      node.strategies =
+          CandidateStrategies(*instruction, options_.num_devices);
+    }
+    for (const HloSharding& strategy : node.strategies) {
+      node.memory_costs.push_back(options_.memory_weight * node.bytes /
+                                  ShardCount(strategy));
+    }
+    for (const HloInstruction* operand : instruction->operands()) {
+      auto it = node_ids.find(operand);
+      if (it != node_ids.end()) {
+        nodes[it->second].user_edges.emplace_back(nodes.size(),
+                                                  node.operand_edges.size());
+        node.operand_edges.push_back(it->second);
+      }
+    }
+    node_ids[instruction] = nodes.size();
+    nodes.push_back(std::move(node));
+  }
+
+  // Infer the sharding each strategy requires from the operands.
+  for (Node& node : nodes) {
+    HloInstruction* instruction = node.instruction;
+    std::optional<HloSharding> original_sharding;
+    if (instruction->has_sharding()) {
+      original_sharding = instruction->sharding();
+    }
+    for (const HloSharding& strategy : node.strategies) {
+      instruction->set_sharding(strategy);
+      std::vector<HloSharding>& requirements =
+          node.operand_requirements.emplace_back();
+      for (int64_t operand_id : node.operand_edges) {
+        std::optional<HloSharding> requirement =
+            ShardingPropagation::GetShardingFromUser(
+                *nodes[operand_id].instruction, *instruction,
+                kOperandShardingAggressiveness, /*is_spmd=*/true);
+        requirements.push_back(requirement.has_value()
+                                   ? *std::move(requirement)
+                                   : HloSharding::Replicate());
+      }
+    }
+    if (original_sharding.has_value()) {
+      instruction->set_sharding(*original_sharding);
+    } else {
+      instruction->clear_sharding();
+    }
+  }
+
+  auto edge_cost = [&](int64_t operand_id, int64_t operand_strategy,
+                       int64_t user_id, int64_t user_strategy, int64_t edge) {
+    const Node& operand = nodes[operand_id];
+    return ReshardingBytes(
+        operand.bytes, operand.strategies[operand_strategy],
+        nodes[user_id].operand_requirements[user_strategy][edge]);
+  };
+
+  // Dynamic program in post order: subtree_costs[v][s] is the cost of the
+  // subgraph rooted at `v` if `v` uses strategy `s` and its operands pick
+  // their best strategies. Shared operands are counted once per user.
+  std::vector<std::vector<double>> subtree_costs(nodes.size());
+  for (int64_t v = 0; v < nodes.size(); ++v) {
+    const Node& node = nodes[v];
+    subtree_costs[v] = node.memory_costs;
+    for (int64_t s = 0; s < node.strategies.size(); ++s) {
+      for (int64_t e = 0; e < node.operand_edges.size(); ++e) {
+        const int64_t operand_id = node.operand_edges[e];
+        double best = std::numeric_limits<double>::infinity();
+        for (int64_t p = 0; p < nodes[operand_id].strategies.size(); ++p) {
+          best = std::min(best, subtree_costs[operand_id][p] +
+                                    edge_cost(operand_id, p, v, s, e));
+        }
+        subtree_costs[v][s] += best;
+      }
+    }
+  }
+
+  // Pick strategies from the users down, accounting for the resharding the
+  // chosen users need.
+  std::vector<int64_t> choice(nodes.size(), 0);
+  for (int64_t v = nodes.size() - 1; v >= 0; --v) {
+    const Node& node = nodes[v];
+    double best = std::numeric_limits<double>::infinity();
+    for (int64_t s = 0; s < node.strategies.size(); ++s) {
+      double cost = subtree_costs[v][s];
+      for (const auto& [user_id, edge] : node.user_edges) {
+        cost += edge_cost(v, s, user_id, choice[user_id], edge);
+      }
+      if (cost < best) {
+        best = cost;
+        choice[v] = s;
+      }
+    }
+  }
+
+  // Local search: move one instruction at a time to the strategy that
+  // minimizes the cost of its own edges, until nothing improves.
+  auto local_cost = [&](int64_t v, int64_t s) {
+    const Node& node = nodes[v];
+    double cost = node.memory_costs[s];
+    for (int64_t e = 0; e < node.operand_edges.size(); ++e) {
+      const int64_t operand_id = node.operand_edges[e];
+      cost += edge_cost(operand_id, choice[operand_id], v, s, e);
+    }
+    for (const auto& [user_id, edge] : node.user_edges) {
+      cost += edge_cost(v, s, user_id, choice[user_id], edge);
+    }
+    return cost;
+  };
+  for (int64_t iteration = 0; iteration < options_.max_iterations;
+       ++iteration) {
+    bool improved = false;
+    for (int64_t v = 0; v < nodes.size(); ++v) {
+      double best = local_cost(v, choice[v]);
+      for (int64_t s = 0; s < nodes[v].strategies.size(); ++s) {
+        const double cost = local_cost(v, s);
+        if (cost < best) {
+          best = cost;
+          choice[v] = s;
+          improved = true;
+        }
+      }
+    }
+    if (!improved) {
+      break;
+    }
+  }
+
+  bool changed = false;
+  for (int64_t v = 0; v < nodes.size(); ++v) {
+    Node& node = nodes[v];
+    if (node.fixed) {
+      continue;
+    }
+    VLOG(2) << "Auto-sharding " << node.instruction->name() << ": "
+            << node.strategies[choice[v]].ToString();
+    node.instruction->set_sharding(node.strategies[choice[v]]);
+    changed = true;
+  }
+  return changed;
+}
+
+}  // namespace spmd
+}  // namespace xla
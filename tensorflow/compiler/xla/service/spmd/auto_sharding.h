@@ -0,0 +1,67 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_SPMD_AUTO_SHARDING_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_SPMD_AUTO_SHARDING_H_
+
+#include "tensorflow/compiler/xla/service/hlo_module.h"
+#include "tensorflow/compiler/xla/service/hlo_pass_interface.h"
+
+namespace xla {
+namespace spmd {
+
+// Assigns shardings to the array-shaped instructions of the entry computation
+// that do not have one, before sharding propagation and SPMD partitioning.
+//
+// Each instruction gets a set of candidate strategies: replicated, or tiled
+// along one dimension over all devices. The cost of a strategy assignment is
+// the bytes communicated to reshard operands into the sharding their users
+// require (as inferred by ShardingPropagation::GetShardingFromUser), plus a
+// weighted per-device memory term. The assignment is initialized with a
+// dynamic program over the graph, which is exact for trees and treats shared
+// operands independently, and then refined by local search until no single
+// instruction can lower the total cost.
+//
+// Instructions that already have a sharding keep it and constrain their
+// neighbors. Instructions with side effects are only ever replicated.
+class AutoSharding : public HloModulePass {
+ public:
+  struct Options {
+    // Number of devices to partition over.
+    int64_t num_devices = 1;
+    // Weight of a byte of per-device memory relative to a communicated byte.
+    double memory_weight = 0.5;
+    // Maximum number of local search passes over the computation.
+    int64_t max_iterations = 10;
+  };
+
+  explicit AutoSharding(const Options& options) : options_(options) {}
+  ~AutoSharding() override = default;
+
+  absl::string_view name() const override { return "auto-sharding"; }
+
+  using HloPassInterface::Run;
+  StatusOr<bool> Run(
+      HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads) override;
+
+ private:
+  Options options_;
+};
+
+}  // namespace spmd
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_SPMD_AUTO_SHARDING_H_
@@ -0,0 +1,91 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/spmd/auto_sharding.h"
+
+#include "tensorflow/compiler/xla/service/hlo_parser.h"
+#include "tensorflow/compiler/xla/service/hlo_sharding.h"
+#include "tensorflow/compiler/xla/tests/hlo_test_base.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+
+namespace xla {
+namespace spmd {
+namespace {
+
+class AutoShardingTest : public HloTestBase {
+ public:
+  StatusOr<std::unique_ptr<HloModule>> RunPass(absl::string_view hlo_module,
+                                               int64_t num_devices) {
+    TF_ASSIGN_OR_RETURN(auto module, ParseAndReturnVerifiedModule(
+                                         hlo_module, GetModuleConfigForTest()));
+    AutoSharding::Options options;
+    options.num_devices = num_devices;
+    TF_RETURN_IF_ERROR(AutoSharding(options).Run(module.get()).status());
+    return StatusOr<std::unique_ptr<HloModule>>(std::move(module));
+  }
+};
+
+constexpr char kDotModule[] = R"(
+HloModule module
+
+ENTRY entry {
+  p0 = f32[1024,15] parameter(0)
+  p1 = f32[15,8] parameter(1)
+  ROOT dot = f32[1024,8] dot(p0, p1), lhs_contracting_dims={1},
+    rhs_contracting_dims={0}
+})";
+
+TEST_F(AutoShardingTest, ShardsLargeOperandOfDot) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          RunPass(kDotModule, /*num_devices=*/2));
+  // Splitting the rows of the large operand needs no communication, while
+  // splitting the small operand would require gathering it for the dot.
+  const HloSharding rows = HloSharding::Tile(Array<int64_t>({{0}, {1}}));
+  EXPECT_EQ(FindInstruction(module.get(), "p0")->sharding(), rows);
+  EXPECT_EQ(FindInstruction(module.get(), "dot")->sharding(), rows);
+  EXPECT_EQ(FindInstruction(module.get(), "p1")->sharding(),
+            HloSharding::Replicate());
+}
+
+TEST_F(AutoShardingTest, KeepsExistingShardings) {
+  constexpr char kHloString[] = R"(
+HloModule module
+
+ENTRY entry {
+  p0 = f32[1024,15] parameter(0), sharding={replicated}
+  p1 = f32[15,8] parameter(1)
+  ROOT dot = f32[1024,8] dot(p0, p1), lhs_contracting_dims={1},
+    rhs_contracting_dims={0}
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          RunPass(kHloString, /*num_devices=*/2));
+  EXPECT_EQ(FindInstruction(module.get(), "p0")->sharding(),
+            HloSharding::Replicate());
+  // A replicated operand can be sliced locally, so the dot is still split.
+  EXPECT_FALSE(FindInstruction(module.get(), "dot")->sharding().IsReplicated());
+}
+
+TEST_F(AutoShardingTest, SingleDeviceIsNoOp) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          RunPass(kDotModule, /*num_devices=*/1));
+  for (const HloInstruction* instruction :
+       module->entry_computation()->instructions()) {
+    EXPECT_FALSE(instruction->has_sharding()) << instruction->name();
+  }
+}
+
+}  // namespace
+}  // namespace spmd
+}  // namespace xla
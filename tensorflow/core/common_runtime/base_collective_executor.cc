@@ -18,6 +18,7 @@ limitations under the License.
 #include <functional>
 #include <utility>
 
+#include "tensorflow/core/common_runtime/collective_util.h"
 #include "tensorflow/core/common_runtime/copy_tensor.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
@@ -311,6 +312,13 @@ void BaseCollectiveExecutor::ExecuteAsync(OpKernelContext* ctx,
                           col_params->is_source))
                             ? &ctx->input(0)
                             : nullptr;
+  // A reduction with an encode_op runs in place on the encoded input, which is
+  // decoded into the output once the collective is done.
+  std::shared_ptr<Tensor> encoded;
+  if (col_params->instance.type == REDUCTION_COLLECTIVE &&
+      col_params->encode_op != nullptr) {
+    encoded = std::make_shared<Tensor>();
+  }
   CollectiveImplementationInterface* col_impl = nullptr;
   Status status = CreateCollective(*col_params, &col_impl);
   if (!status.ok()) {
@@ -321,7 +329,8 @@ void BaseCollectiveExecutor::ExecuteAsync(OpKernelContext* ctx,
   core::ScopedUnref unref(col_impl);
   auto col_ctx = std::make_shared<CollectiveContext>(
       this, cem_->GetNcclCommunicator(), dev_mgr_, ctx, CtxParams(ctx),
-      col_params, exec_key, step_id_, input, output);
+      col_params, exec_key, step_id_, encoded ? encoded.get() : input,
+      encoded ? encoded.get() : output);
   status = col_impl->InitializeCollectiveContext(col_ctx);
   if (!status.ok()) {
     done_safe(status);
@@ -331,7 +340,7 @@ void BaseCollectiveExecutor::ExecuteAsync(OpKernelContext* ctx,
   // starve executor threads.
   col_impl->Ref();
   profiler::TraceMeProducer producer("BaseCollectiveExecutor::ExecuteAsync");
-  RunClosure([col_impl, col_ctx, done_safe, ctx,
+  RunClosure([col_impl, col_ctx, done_safe, ctx, input, output, encoded,
               context_id = producer.GetContextId()]() {
     core::ScopedUnref unref(col_impl);
     profiler::TraceMeConsumer consumer(
@@ -342,10 +351,26 @@ void BaseCollectiveExecutor::ExecuteAsync(OpKernelContext* ctx,
                                          {{"id", ctx->step_id()}});
         },
         context_id);
+    if (encoded) {
+      Status s = collective_util::ComputeUnaryOp(
+          ctx, col_ctx->op_params, col_ctx->device,
+          col_ctx->col_params->encode_op, *input, encoded.get());
+      if (!s.ok()) {
+        done_safe(s);
+        return;
+      }
+    }
     col_impl->Ref();
-    col_impl->Run([col_impl, col_ctx, done_safe](const Status& s) {
+    col_impl->Run([col_impl, col_ctx, done_safe, output,
+                   encoded](const Status& s) {
       core::ScopedUnref unref(col_impl);
-      done_safe(s);
+      Status status = s;
+      if (status.ok() && encoded) {
+        status = collective_util::ComputeUnaryOp(
+            col_ctx->op_ctx, col_ctx->op_params, col_ctx->device,
+            col_ctx->col_params->decode_op, *encoded, output);
+      }
+      done_safe(status);
     });
   });
 }
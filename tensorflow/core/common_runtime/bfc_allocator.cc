@@ -49,6 +49,9 @@ BFCAllocator::BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator,
       name_(name),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1) {
+  if (opts.use_thread_local_cache) {
+    thread_caches_.reset(new CacheShard[kNumCacheShards]);
+  }
   if (opts.allow_growth) {
     // 2MiB smallest initial allocation, unless total memory available
     // is less.
@@ -258,6 +261,18 @@ void* BFCAllocator::AllocateRawInternalWithRetry(
 void* BFCAllocator::AllocateRaw(size_t unused_alignment, size_t num_bytes,
                                 const AllocationAttributes& allocation_attr) {
   VLOG(3) << "AllocateRaw " << Name() << "  " << num_bytes;
+  if (UseThreadLocalCache() && num_bytes > 0 &&
+      allocation_attr.freed_by_func == nullptr) {
+    const size_t rounded_bytes = RoundedBytes(num_bytes);
+    if (BinNumForSize(rounded_bytes) < kNumCachedBins) {
+      void* cached = AllocateFromThreadLocalCache(rounded_bytes);
+      if (cached != nullptr) {
+        VLOG(3) << "AllocateRaw " << Name() << "  " << num_bytes << " "
+                << cached << " (cached)";
+        return cached;
+      }
+    }
+  }
   void* result = [&] {
     if (!opts_.allow_retry_on_failure || !allocation_attr.retry_on_failure) {
       // If we have globally disabled retry-on-failure and fail to allocate an
@@ -326,26 +341,8 @@ bool BFCAllocator::DeallocateFreeRegions(size_t rounded_bytes)
 
   // Searching for free regions.
   absl::flat_hash_set<void*> free_region_ptrs;
-  size_t total_free_bytes = 0;
-  for (const AllocationRegion& region : region_manager_.regions()) {
-    ChunkHandle h = region_manager_.get_handle(region.ptr());
-    bool any_use = false;
-    while (h != kInvalidChunkHandle) {
-      const Chunk* c = ChunkFromHandle(h);
-      if (c->in_use()) {
-        any_use = true;
-        break;
-      }
-      h = c->next;
-    }
-
-    if (!any_use) {
-      VLOG(2) << "Found free region with ptr = " << region.ptr();
-      free_region_ptrs.insert(region.ptr());
-      total_free_bytes += region.memory_size();
-    }
-  }
-
+  size_t total_free_bytes =
+      FindFreeRegions(&free_region_ptrs, /*skip_unsafe_chunks=*/false);
   if (total_free_bytes == 0) {
     return false;
   }
@@ -373,6 +370,52 @@ bool BFCAllocator::DeallocateFreeRegions(size_t rounded_bytes)
   return true;
 }
 
+size_t BFCAllocator::FindFreeRegions(
+    absl::flat_hash_set<void*>* free_region_ptrs, bool skip_unsafe_chunks) {
+  size_t total_free_bytes = 0;
+  for (const AllocationRegion& region : region_manager_.regions()) {
+    ChunkHandle h = region_manager_.get_handle(region.ptr());
+    bool any_use = false;
+    while (h != kInvalidChunkHandle) {
+      const Chunk* c = ChunkFromHandle(h);
+      if (c->in_use() || (skip_unsafe_chunks && c->freed_at_count > 0)) {
+        any_use = true;
+        break;
+      }
+      h = c->next;
+    }
+
+    if (!any_use) {
+      VLOG(2) << "Found free region with ptr = " << region.ptr();
+      free_region_ptrs->insert(region.ptr());
+      total_free_bytes += region.memory_size();
+    }
+  }
+  return total_free_bytes;
+}
+
+int64_t BFCAllocator::ReleaseFreeRegions() {
+  mutex_lock l(lock_);
+  // Chunks held by the thread-local caches, or freed before the safe frontier
+  // but not merged yet, would otherwise keep their regions alive.
+  if (thread_caches_ != nullptr) {
+    FlushThreadLocalCaches();
+  }
+  MergeTimestampedChunks(0);
+
+  absl::flat_hash_set<void*> free_region_ptrs;
+  size_t total_free_bytes =
+      FindFreeRegions(&free_region_ptrs, /*skip_unsafe_chunks=*/true);
+  if (total_free_bytes == 0) {
+    return 0;
+  }
+  VLOG(1) << "Releasing " << free_region_ptrs.size() << " free regions ("
+          << strings::HumanReadableNumBytes(total_free_bytes) << ") of "
+          << Name();
+  DeallocateRegions(free_region_ptrs);
+  return total_free_bytes;
+}
+
 void BFCAllocator::DeallocateRegions(
     const absl::flat_hash_set<void*>& region_ptrs)
     TF_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
@@ -444,6 +487,16 @@ void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
     }
   }
 
+  // Return any chunks held in the thread-local caches to the free bins before
+  // trying harder.
+  if (thread_caches_ != nullptr && FlushThreadLocalCaches()) {
+    ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes, freed_before);
+    if (ptr != nullptr) {
+      AddTraceMe("MemoryAllocation", ptr);
+      return ptr;
+    }
+  }
+
   if ((freed_before == 0) && (!timestamped_chunks_.empty())) {
     // We're unable to satisfy an allocation request without a specific
     // timestamp requirement.  Rather than fail, try merging any held-out
@@ -604,6 +657,10 @@ void* BFCAllocator::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
         stats_.largest_alloc_size =
             std::max<std::size_t>(stats_.largest_alloc_size, chunk->size);
 
+        if (thread_caches_ != nullptr) {
+          MaybeTrackCacheableChunk(chunk->ptr, chunk->size);
+        }
+
 #ifdef TENSORFLOW_MEM_DEBUG
         if (ShouldRecordOpName()) {
           const auto& annotation =
@@ -678,6 +735,12 @@ void BFCAllocator::SplitChunk(BFCAllocator::ChunkHandle h, size_t num_bytes) {
 void BFCAllocator::DeallocateRaw(void* ptr) {
   VLOG(3) << "DeallocateRaw " << Name() << " "
           << (ptr ? RequestedSize(ptr) : 0);
+  if (ptr != nullptr && thread_caches_ != nullptr &&
+      DeallocateToThreadLocalCache(ptr)) {
+    // The chunk stays in use until the cache is flushed, so there is no need
+    // to wake up threads waiting in `retry_helper_`.
+    return;
+  }
   DeallocateRawInternal(ptr);
   retry_helper_.NotifyDealloc();
 }
@@ -688,7 +751,10 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
     return;
   }
   mutex_lock l(lock_);
+  FreeChunk(ptr);
+}
 
+void BFCAllocator::FreeChunk(void* ptr) {
   // Find the chunk from the ptr.
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle);
@@ -717,6 +783,108 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
   }
 }
 
+BFCAllocator::CacheShard* BFCAllocator::ThreadCacheShard() {
+  static std::atomic<int> next_shard{0};
+  static thread_local int shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % kNumCacheShards;
+  return &thread_caches_[shard];
+}
+
+BFCAllocator::CacheShard* BFCAllocator::PointerCacheShard(const void* ptr) {
+  // Chunk pointers are multiples of kMinAllocationSize, so discard the low
+  // bits to spread neighboring chunks across shards.
+  const std::uintptr_t p = reinterpret_cast<std::uintptr_t>(ptr);
+  return &thread_caches_[(p >> kMinAllocationBits) % kNumCacheShards];
+}
+
+void* BFCAllocator::AllocateFromThreadLocalCache(size_t rounded_bytes) {
+  const BinNum bin_num = BinNumForSize(rounded_bytes);
+  DCHECK_LT(bin_num, kNumCachedBins);
+  CachedChunk cached = {nullptr, 0};
+  {
+    CacheShard* shard = ThreadCacheShard();
+    mutex_lock l(shard->mu);
+    auto& free_chunks = shard->free_chunks[bin_num];
+    // Prefer the most recently freed chunk, which is most likely to be warm
+    // in cache. Any chunk in the same bin is less than twice the requested
+    // size, so using it does not waste more than FindChunkPtr() would.
+    for (auto it = free_chunks.rbegin(); it != free_chunks.rend(); ++it) {
+      if (it->size >= rounded_bytes) {
+        cached = *it;
+        free_chunks.erase(std::next(it).base());
+        break;
+      }
+    }
+  }
+  if (cached.ptr == nullptr) return nullptr;
+
+  cached_bytes_.fetch_sub(cached.size, std::memory_order_relaxed);
+  num_cached_allocs_.fetch_add(1, std::memory_order_relaxed);
+  CacheShard* shard = PointerCacheShard(cached.ptr);
+  mutex_lock l(shard->mu);
+  shard->live_chunks[cached.ptr] = cached.size;
+  return cached.ptr;
+}
+
+bool BFCAllocator::DeallocateToThreadLocalCache(void* ptr) {
+  size_t chunk_size;
+  {
+    CacheShard* shard = PointerCacheShard(ptr);
+    mutex_lock l(shard->mu);
+    auto it = shard->live_chunks.find(ptr);
+    if (it == shard->live_chunks.end()) return false;
+    chunk_size = it->second;
+    shard->live_chunks.erase(it);
+  }
+  if (!UseThreadLocalCache()) return false;
+
+  const BinNum bin_num = BinNumForSize(chunk_size);
+  DCHECK_LT(bin_num, kNumCachedBins);
+  {
+    CacheShard* shard = ThreadCacheShard();
+    mutex_lock l(shard->mu);
+    auto& free_chunks = shard->free_chunks[bin_num];
+    if (free_chunks.size() >= kMaxCachedChunksPerBin) return false;
+    free_chunks.push_back({ptr, chunk_size});
+  }
+  cached_bytes_.fetch_add(chunk_size, std::memory_order_relaxed);
+  return true;
+}
+
+void BFCAllocator::MaybeTrackCacheableChunk(const void* ptr,
+                                            size_t chunk_size) {
+  CacheShard* shard = PointerCacheShard(ptr);
+  mutex_lock l(shard->mu);
+  if (BinNumForSize(chunk_size) < kNumCachedBins) {
+    shard->live_chunks[ptr] = chunk_size;
+  } else {
+    // `ptr` may have been the start of a smaller chunk that has since been
+    // merged.
+    shard->live_chunks.erase(ptr);
+  }
+}
+
+bool BFCAllocator::FlushThreadLocalCaches() {
+  bool flushed = false;
+  for (int i = 0; i < kNumCacheShards; ++i) {
+    std::array<absl::InlinedVector<CachedChunk, kMaxCachedChunksPerBin>,
+               kNumCachedBins>
+        free_chunks;
+    {
+      mutex_lock l(thread_caches_[i].mu);
+      std::swap(free_chunks, thread_caches_[i].free_chunks);
+    }
+    for (const auto& bin_chunks : free_chunks) {
+      for (const CachedChunk& cached : bin_chunks) {
+        cached_bytes_.fetch_sub(cached.size, std::memory_order_relaxed);
+        FreeChunk(cached.ptr);
+        flushed = true;
+      }
+    }
+  }
+  return flushed;
+}
+
 // Merges h1 and h2 when Chunk(h1)->next is h2 and Chunk(h2)->prev is c1.
 // We merge Chunk(h2) into Chunk(h1).
 void BFCAllocator::Merge(BFCAllocator::ChunkHandle h1,
@@ -1202,12 +1370,21 @@ MemoryDump BFCAllocator::RecordMemoryMapInternal() {
 
 absl::optional<AllocatorStats> BFCAllocator::GetStats() {
   mutex_lock l(lock_);
-  return stats_;
+  AllocatorStats stats = stats_;
+  stats.largest_free_block_bytes = LargestFreeChunk();
+  if (thread_caches_ != nullptr) {
+    // Chunks in the thread-local caches are free from the caller's point of
+    // view, even though they are not in the free bins.
+    stats.num_allocs += num_cached_allocs_.load(std::memory_order_relaxed);
+    stats.bytes_in_use -= cached_bytes_.load(std::memory_order_relaxed);
+  }
+  return stats;
 }
 
 bool BFCAllocator::ClearStats() {
   mutex_lock l(lock_);
   stats_.num_allocs = 0;
+  num_cached_allocs_.store(0, std::memory_order_relaxed);
   stats_.peak_bytes_in_use = stats_.bytes_in_use;
   stats_.largest_alloc_size = 0;
   return true;
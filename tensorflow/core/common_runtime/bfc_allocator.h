@@ -23,7 +23,9 @@ limitations under the License.
 #include <unordered_map>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
 #include "tensorflow/core/common_runtime/allocator_retry.h"
 #include "tensorflow/core/common_runtime/shared_counter.h"
 #include "tensorflow/core/framework/allocator.h"
@@ -31,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/mutex_contention.h"
 #include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/platform/types.h"
 
@@ -66,6 +69,19 @@ class BFCAllocator : public Allocator {
     // Controls when a chunk should be split, if its size exceeds the requested
     // allocation size.
     double fragmentation_fraction = 0;
+
+    // If true, small chunks that are freed are kept in caches sharded by
+    // thread, and reused by later allocations of the same size class without
+    // taking the allocator-wide lock. Cached chunks are returned to the free
+    // bins when an allocation cannot otherwise be satisfied.
+    //
+    // Has no effect if a timing counter is set (see `SetTimingCounter()`).
+    //
+    // NOTE: When a chunk is reused from a cache, `RequestedSize()` and
+    // `AllocationId()` report the values from when the chunk was last taken
+    // from the free bins, and `AllocatorStats::peak_bytes_in_use` counts cached
+    // chunks as in use.
+    bool use_thread_local_cache = false;
   };
   BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator, size_t total_memory,
                const string& name, const Options& opts);
@@ -105,6 +121,16 @@ class BFCAllocator : public Allocator {
 
   MemoryDump RecordMemoryMap();
 
+  // Returns the memory regions that hold no live allocations to the
+  // sub-allocator, regardless of `Options::garbage_collection`, and returns
+  // the number of bytes released. Live allocations are never moved, but once
+  // fragmented regions are released the allocator can grow a region that is
+  // large enough for requests that the fragmented free space could not
+  // satisfy. Intended to be called at step boundaries, when most allocations
+  // have been freed; `GetStats()->largest_free_block_bytes` tells how
+  // fragmented the free memory is.
+  int64_t ReleaseFreeRegions();
+
  private:
   struct Bin;
 
@@ -118,6 +144,9 @@ class BFCAllocator : public Allocator {
 
   void DeallocateRawInternal(void* ptr);
 
+  // Returns the chunk containing `ptr` to the free bins.
+  void FreeChunk(void* ptr) TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Chunks whose freed_at_count is later than the safe frontier value are kept
   // on a special list and not subject to merging immediately upon being freed.
   //
@@ -275,6 +304,56 @@ class BFCAllocator : public Allocator {
   static constexpr size_t kMinAllocationBits = 8;
   static constexpr size_t kMinAllocationSize = 1 << kMinAllocationBits;
 
+  // Thread-local caching of small chunks (see
+  // `Options::use_thread_local_cache`). Only chunks in the first
+  // `kNumCachedBins` bins are cached.
+  static constexpr int kNumCachedBins = 9;  // Chunks up to 128KiB.
+  static constexpr int kMaxCachedChunksPerBin = 16;
+  static constexpr int kNumCacheShards = 16;
+
+  struct CachedChunk {
+    void* ptr;
+    size_t size;
+  };
+
+  // NOTE: Locks in a `CacheShard` may be acquired while holding `lock_`, but
+  // `lock_` must never be acquired while holding a `CacheShard` lock.
+  struct alignas(64) CacheShard {
+    mutex mu;
+    // Cacheable chunks that are in use by callers, keyed by pointer. Used to
+    // find the size of a chunk when it is freed, without taking `lock_`.
+    absl::flat_hash_map<const void*, size_t> live_chunks TF_GUARDED_BY(mu);
+    // Chunks that have been freed by callers, but are still in use from the
+    // point of view of the free bins, indexed by bin number.
+    std::array<absl::InlinedVector<CachedChunk, kMaxCachedChunksPerBin>,
+               kNumCachedBins>
+        free_chunks TF_GUARDED_BY(mu);
+  };
+
+  bool UseThreadLocalCache() const {
+    return thread_caches_ != nullptr && timing_counter_ == nullptr;
+  }
+
+  // The shard whose `free_chunks` serve allocations from the calling thread.
+  CacheShard* ThreadCacheShard();
+  // The shard whose `live_chunks` tracks `ptr`.
+  CacheShard* PointerCacheShard(const void* ptr);
+
+  // Returns a cached chunk of at least `rounded_bytes`, or nullptr.
+  void* AllocateFromThreadLocalCache(size_t rounded_bytes);
+
+  // Caches the chunk at `ptr` if it is cacheable and there is room in the
+  // cache. Returns false if the chunk must be freed normally.
+  bool DeallocateToThreadLocalCache(void* ptr);
+
+  // Records `ptr`, which was just taken from the free bins, as cacheable if
+  // its `chunk_size` is small enough.
+  void MaybeTrackCacheableChunk(const void* ptr, size_t chunk_size);
+
+  // Returns all cached chunks to the free bins. Returns true if any chunk was
+  // returned.
+  bool FlushThreadLocalCaches() TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // BFCAllocator allocates memory into a collection of disjoint
   // AllocationRegions.  Each AllocationRegion corresponds to one call to
   // SubAllocator::Alloc().  (Actually, if a subsequent call to
@@ -459,6 +538,14 @@ class BFCAllocator : public Allocator {
   // found and freed; false otherwise.
   bool DeallocateFreeRegions(size_t rounded_bytes);
 
+  // Adds the regions that hold no chunks in use to `free_region_ptrs`, and
+  // returns their total size. If `skip_unsafe_chunks` is true, regions holding
+  // free chunks that are not yet safe to reuse (see `SetSafeFrontier()`) are
+  // treated as in use.
+  size_t FindFreeRegions(absl::flat_hash_set<void*>* free_region_ptrs,
+                         bool skip_unsafe_chunks)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Helper function to deallocate regions.
   void DeallocateRegions(const absl::flat_hash_set<void*>& region_ptrs)
       TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
@@ -598,6 +685,7 @@ class BFCAllocator : public Allocator {
 
   // Structures mutable after construction
   mutable mutex lock_;
+  MutexContentionSite lock_site_{&lock_, "BFCAllocator"};
   RegionManager region_manager_ TF_GUARDED_BY(lock_);
 
   std::vector<Chunk> chunks_ TF_GUARDED_BY(lock_);
@@ -609,6 +697,14 @@ class BFCAllocator : public Allocator {
   // newly-created chunk.
   int64_t next_allocation_id_ TF_GUARDED_BY(lock_);
 
+  // Caches of small freed chunks, or nullptr if
+  // `Options::use_thread_local_cache` is false.
+  std::unique_ptr<CacheShard[]> thread_caches_;
+  // Total bytes of the chunks in `thread_caches_[*].free_chunks`.
+  std::atomic<int64_t> cached_bytes_{0};
+  // Number of allocations served from `thread_caches_`.
+  std::atomic<int64_t> num_cached_allocs_{0};
+
   // Stats.
   AllocatorStats stats_ TF_GUARDED_BY(lock_);
 #ifdef TENSORFLOW_MEM_DEBUG
@@ -0,0 +1,153 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/bfc_allocator.h"
+
+#include <cstring>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "tensorflow/core/common_runtime/pool_allocator.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mem.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+std::unique_ptr<BFCAllocator> CreateAllocator(size_t total_memory,
+                                              bool use_thread_local_cache) {
+  BFCAllocator::Options opts;
+  opts.allow_growth = true;
+  opts.use_thread_local_cache = use_thread_local_cache;
+  return std::make_unique<BFCAllocator>(
+      absl::make_unique<BasicCPUAllocator>(port::kNUMANoAffinity,
+                                           std::vector<SubAllocator::Visitor>(),
+                                           std::vector<SubAllocator::Visitor>()),
+      total_memory, "cpu_bfc", opts);
+}
+
+TEST(BFCAllocatorTest, ThreadLocalCacheReusesChunk) {
+  auto a = CreateAllocator(1 << 30, /*use_thread_local_cache=*/true);
+  void* p1 = a->AllocateRaw(1, 1000);
+  ASSERT_NE(p1, nullptr);
+  a->DeallocateRaw(p1);
+  void* p2 = a->AllocateRaw(1, 900);
+  // Both requests round up to the same bin, so the cached chunk is reused.
+  EXPECT_EQ(p1, p2);
+  a->DeallocateRaw(p2);
+}
+
+TEST(BFCAllocatorTest, ThreadLocalCacheStats) {
+  auto a = CreateAllocator(1 << 30, /*use_thread_local_cache=*/true);
+  void* p1 = a->AllocateRaw(1, 1024);
+  a->DeallocateRaw(p1);
+  absl::optional<AllocatorStats> stats = a->GetStats();
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(stats->num_allocs, 1);
+  EXPECT_EQ(stats->bytes_in_use, 0);
+
+  void* p2 = a->AllocateRaw(1, 1024);
+  stats = a->GetStats();
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(stats->num_allocs, 2);
+  EXPECT_EQ(stats->bytes_in_use, 1024);
+  a->DeallocateRaw(p2);
+
+  stats = a->GetStats();
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(stats->bytes_in_use, 0);
+}
+
+TEST(BFCAllocatorTest, ThreadLocalCacheFlushedUnderMemoryPressure) {
+  // Fill the whole memory limit with small chunks, free them all into the
+  // caches, and check that a large allocation can still be satisfied.
+  constexpr size_t kTotalMemory = 1 << 20;
+  constexpr size_t kChunkSize = 1 << 10;
+  auto a = CreateAllocator(kTotalMemory, /*use_thread_local_cache=*/true);
+  std::vector<void*> ptrs;
+  for (size_t i = 0; i < kTotalMemory / kChunkSize; ++i) {
+    void* p = a->AllocateRaw(1, kChunkSize);
+    if (p == nullptr) break;
+    ptrs.push_back(p);
+  }
+  for (void* p : ptrs) a->DeallocateRaw(p);
+  void* large = a->AllocateRaw(1, kTotalMemory / 2);
+  EXPECT_NE(large, nullptr);
+  a->DeallocateRaw(large);
+}
+
+TEST(BFCAllocatorTest, ThreadLocalCacheConcurrentUse) {
+  auto a = CreateAllocator(1 << 30, /*use_thread_local_cache=*/true);
+  {
+    thread::ThreadPool pool(Env::Default(), "test", 8);
+    for (int t = 0; t < 8; ++t) {
+      pool.Schedule([&a, t]() {
+        std::vector<void*> ptrs;
+        for (int i = 0; i < 1000; ++i) {
+          ptrs.push_back(a->AllocateRaw(1, 256 * (1 + (i + t) % 64)));
+          if (ptrs.size() > 16) {
+            a->DeallocateRaw(ptrs.front());
+            ptrs.erase(ptrs.begin());
+          }
+        }
+        for (void* p : ptrs) a->DeallocateRaw(p);
+      });
+    }
+  }
+  absl::optional<AllocatorStats> stats = a->GetStats();
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(stats->num_allocs, 8 * 1000);
+  EXPECT_EQ(stats->bytes_in_use, 0);
+}
+
+TEST(BFCAllocatorTest, ReleaseFreeRegions) {
+  auto a = CreateAllocator(1 << 30, /*use_thread_local_cache=*/false);
+  // With allow_growth the first region is too small for both allocations, so
+  // they end up in different regions.
+  void* p1 = a->AllocateRaw(1, 1 << 20);
+  void* p2 = a->AllocateRaw(1, 3 << 20);
+  ASSERT_NE(p1, nullptr);
+  ASSERT_NE(p2, nullptr);
+  a->DeallocateRaw(p2);
+
+  absl::optional<AllocatorStats> stats = a->GetStats();
+  ASSERT_TRUE(stats);
+  EXPECT_GE(stats->largest_free_block_bytes, 3 << 20);
+
+  // Only the region of `p2` is free.
+  EXPECT_GE(a->ReleaseFreeRegions(), 3 << 20);
+  EXPECT_EQ(a->ReleaseFreeRegions(), 0);
+  memset(p1, 0, 1 << 20);
+  stats = a->GetStats();
+  ASSERT_TRUE(stats);
+  EXPECT_LT(stats->largest_free_block_bytes, 3 << 20);
+  EXPECT_EQ(stats->bytes_in_use, 1 << 20);
+
+  a->DeallocateRaw(p1);
+  EXPECT_GT(a->ReleaseFreeRegions(), 0);
+  stats = a->GetStats();
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(stats->largest_free_block_bytes, 0);
+
+  // The allocator grows again on demand.
+  void* p3 = a->AllocateRaw(1, 3 << 20);
+  EXPECT_NE(p3, nullptr);
+  a->DeallocateRaw(p3);
+}
+
+}  // namespace
+}  // namespace tensorflow
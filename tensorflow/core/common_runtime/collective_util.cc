@@ -95,6 +95,22 @@ SubContext::SubContext(OpKernelContext* ctx, OpKernelContext::Params* params,
   sub_ctx_.reset(new OpKernelContext(&sub_params_, 1));
 }
 
+SubContext::SubContext(OpKernelContext* ctx, OpKernelContext::Params* params,
+                       OpKernel* op, const Tensor* input)
+    : sub_params_(*params),
+      sub_inputs_({TensorValue(const_cast<Tensor*>(input))}),
+      sub_input_attr_({ctx->input_alloc_attr(0)}),
+      forward_from_(OpKernelContext::Params::kNoReservation) {
+  sub_params_.op_kernel = op;
+  sub_params_.inputs = sub_inputs_;
+  sub_params_.input_alloc_attrs = sub_input_attr_;
+  sub_params_.op_device_context = ctx->op_device_context();
+  sub_params_.eigen_gpu_device = nullptr;
+  sub_params_.ensure_eigen_gpu_device();
+  sub_params_.forward_from_array = &forward_from_;
+  sub_ctx_.reset(new OpKernelContext(&sub_params_, 1));
+}
+
 Status ComputeBinOp(OpKernelContext* op_ctx, OpKernelContext::Params* params,
                     Device* device, OpKernel* op, Tensor* output,
                     Tensor* input) {
@@ -109,5 +125,15 @@ Status ComputeBinOp(OpKernelContext* op_ctx, OpKernelContext::Params* params,
   return sub_ctx->sub_ctx_->status();
 }
 
+Status ComputeUnaryOp(OpKernelContext* op_ctx, OpKernelContext::Params* params,
+                      Device* device, OpKernel* op, const Tensor& input,
+                      Tensor* output) {
+  SubContext sub_ctx(op_ctx, params, op, &input);
+  device->Compute(op, sub_ctx.sub_ctx_.get());
+  TF_RETURN_IF_ERROR(sub_ctx.sub_ctx_->status());
+  *output = *sub_ctx.sub_ctx_->mutable_output(0);
+  return OkStatus();
+}
+
 }  // namespace collective_util
 }  // namespace tensorflow
@@ -0,0 +1,43 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/cpu_cost_measurement.h"
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/common_runtime/cost_constants.h"
+
+namespace tensorflow {
+
+CpuCostMeasurement::CpuCostMeasurement(const Context& context)
+    : CostMeasurement(context), start_clock_(std::clock()) {}
+
+absl::Duration CpuCostMeasurement::GetTotalCost() {
+  const std::clock_t end_clock = std::clock();
+  if (start_clock_ == static_cast<std::clock_t>(-1) ||
+      end_clock == static_cast<std::clock_t>(-1) || end_clock < start_clock_) {
+    // The CPU time is unavailable (or wrapped around).
+    return absl::ZeroDuration();
+  }
+  return absl::Seconds(static_cast<double>(end_clock - start_clock_) /
+                       CLOCKS_PER_SEC);
+}
+
+absl::string_view CpuCostMeasurement::GetCostType() const {
+  return kCpuCostName;
+}
+
+REGISTER_COST_MEASUREMENT(kCpuCostName, CpuCostMeasurement);
+
+}  // namespace tensorflow
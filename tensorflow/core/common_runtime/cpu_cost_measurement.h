@@ -0,0 +1,48 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_CPU_COST_MEASUREMENT_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_CPU_COST_MEASUREMENT_H_
+
+#include <ctime>
+
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/common_runtime/cost_measurement.h"
+#include "tensorflow/core/common_runtime/cost_measurement_registry.h"
+
+namespace tensorflow {
+
+// Measures the CPU time used by the process from the construction of the
+// CostMeasurement to the call to GetTotalCost().
+//
+// The CPU time of all the threads of the process is counted, including the
+// intra-op and inter-op threads a request's ops run on, but also any work done
+// concurrently for other requests, so the cost is best used smeared across
+// the requests it is split between (e.g. by the batching kernels).
+class CpuCostMeasurement : public CostMeasurement {
+ public:
+  explicit CpuCostMeasurement(const Context& context);
+
+  absl::Duration GetTotalCost() override;
+  absl::string_view GetCostType() const override;
+
+ private:
+  const std::clock_t start_clock_;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_CPU_COST_MEASUREMENT_H_
@@ -0,0 +1,40 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/cpu_cost_measurement.h"
+
+#include "absl/time/clock.h"
+#include "tensorflow/core/common_runtime/cost_measurement.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(CpuCostMeasurementTest, Basic) {
+  CostMeasurement::Context context;
+  CpuCostMeasurement measurement(context);
+  EXPECT_EQ(measurement.GetCostType(), "cpu");
+
+  // Spins for a while so that some CPU time is used.
+  const absl::Time deadline = absl::Now() + absl::Milliseconds(50);
+  volatile int64_t counter = 0;
+  while (absl::Now() < deadline) {
+    counter = counter + 1;
+  }
+  EXPECT_GT(measurement.GetTotalCost(), absl::ZeroDuration());
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -26,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/collective_executor_mgr.h"
 #include "tensorflow/core/common_runtime/collective_param_resolver_local.h"
 #include "tensorflow/core/common_runtime/constant_folding.h"
+#include "tensorflow/core/common_runtime/cost_util.h"
 #include "tensorflow/core/common_runtime/debugger_state_interface.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
 #include "tensorflow/core/common_runtime/device_resolver_local.h"
@@ -355,6 +356,12 @@ DirectSession::DirectSession(const SessionOptions& options,
   if (!status.ok()) {
     LOG(ERROR) << status.error_message();
   }
+  request_cost_accessor_ = CreateRequestCostAccessor();
+  const Status cache_status = ReadInt64FromEnvVar(
+      "TF_DIRECT_SESSION_EXECUTOR_CACHE_SIZE", 0, &executor_cache_capacity_);
+  if (!cache_status.ok()) {
+    LOG(ERROR) << cache_status.error_message();
+  }
   session_handle_ =
       strings::StrCat("direct", strings::FpToString(random::New64()));
   int devices_added = 0;
@@ -396,7 +403,6 @@ DirectSession::~DirectSession() {
   for (auto d : device_mgr_->ListDevices()) {
     d->op_segment()->RemoveHold(session_handle_);
   }
-  functions_.clear();
   delete cancellation_manager_;
   for (const auto& p_and_owned : thread_pools_) {
     if (p_and_owned.second) delete p_and_owned.first;
@@ -665,6 +671,9 @@ Status DirectSession::RunInternal(
   args.tensor_store = &run_state.tensor_store;
   args.step_container = &run_state.step_container;
   args.sync_on_finish = sync_on_finish_;
+  if (request_cost_accessor_) {
+    args.request_cost = request_cost_accessor_->GetRequestCost();
+  }
   args.user_intra_op_threadpool = threadpool_options.intra_op_threadpool;
   args.run_all_kernels_inline = pool == nullptr;
   args.start_time_usecs = start_time_usecs;
@@ -865,7 +874,7 @@ Status DirectSession::Run(const RunOptions& run_options,
   metrics::RecordGraphInputTensors(input_size);
 
   // Check if we already have an executor for these arguments.
-  ExecutorsAndKeys* executors_and_keys;
+  std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
   RunStateArgs run_state_args(run_options.debug_options());
   run_state_args.collective_graph_key =
       run_options.experimental().collective_graph_key();
@@ -908,7 +917,7 @@ Status DirectSession::Run(const RunOptions& run_options,
   }
 
   TF_RETURN_IF_ERROR(RunInternal(step_id, run_options, &call_frame,
-                                 executors_and_keys, run_metadata,
+                                 executors_and_keys.get(), run_metadata,
                                  threadpool_options));
 
   // Receive outputs.
@@ -964,8 +973,10 @@ Status DirectSession::PRunSetup(const std::vector<string>& input_names,
   // RunOptions is not available in PRunSetup, so use thread pool 0.
   thread::ThreadPool* pool = thread_pools_[0].first;
 
-  // Check if we already have an executor for these arguments.
-  ExecutorsAndKeys* executors_and_keys;
+  // Check if we already have an executor for these arguments. The executors
+  // of partial runs are never evicted from the cache, so `PRun()` can look
+  // them up again by key.
+  std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
   // TODO(cais): TFDBG support for partial runs.
   DebugOptions debug_options;
   RunStateArgs run_state_args(debug_options);
@@ -1019,6 +1030,9 @@ Status DirectSession::PRunSetup(const std::vector<string>& input_names,
     LogMemory::RecordStep(args.step_id, run_state_args.handle);
   }
   args.sync_on_finish = sync_on_finish_;
+  if (request_cost_accessor_) {
+    args.request_cost = request_cost_accessor_->GetRequestCost();
+  }
 
   if (options_.config.graph_options().build_cost_model()) {
     run_state->collector.reset(new StepStatsCollector(nullptr));
@@ -1478,9 +1492,61 @@ Status DirectSession::CreateExecutors(
   return OkStatus();
 }
 
+void DirectSession::TouchExecutorsLocked(
+    const ExecutorsAndKeys* executors_and_keys) {
+  if (executor_cache_capacity_ <= 0) return;
+  auto it = executor_cache_index_.find(executors_and_keys);
+  if (it != executor_cache_index_.end()) {
+    executor_cache_lru_.splice(executor_cache_lru_.begin(),
+                               executor_cache_lru_, it->second);
+  }
+}
+
+void DirectSession::EvictExecutorsLocked(
+    std::vector<std::shared_ptr<ExecutorsAndKeys>>* evicted) {
+  if (executor_cache_capacity_ <= 0) return;
+  while (executor_cache_lru_.size() >
+         static_cast<size_t>(executor_cache_capacity_)) {
+    const ExecutorCacheEntry& entry = executor_cache_lru_.back();
+    for (const string& key : entry.keys) {
+      auto it = executors_.find(key);
+      if (it != executors_.end()) {
+        evicted->push_back(std::move(it->second));
+        executors_.erase(it);
+      }
+    }
+    executor_cache_index_.erase(entry.executors_and_keys);
+    executor_cache_lru_.pop_back();
+    metrics::RecordExecutorCacheEviction();
+  }
+}
+
+Status DirectSession::WarmUpExecutors(
+    const std::vector<CallableOptions>& signatures) {
+  TF_RETURN_IF_ERROR(CheckNotClosed());
+  TF_RETURN_IF_ERROR(CheckGraphCreated("WarmUpExecutors()"));
+  for (const CallableOptions& signature : signatures) {
+    std::vector<string> feeds(signature.feed().begin(),
+                              signature.feed().end());
+    std::vector<string> fetches(signature.fetch().begin(),
+                                signature.fetch().end());
+    std::vector<string> targets(signature.target().begin(),
+                                signature.target().end());
+    RunStateArgs run_state_args(signature.run_options().debug_options());
+    run_state_args.collective_graph_key =
+        signature.run_options().experimental().collective_graph_key();
+    std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
+    TF_RETURN_IF_ERROR(GetOrCreateExecutors(feeds, fetches, targets,
+                                            &executors_and_keys,
+                                            &run_state_args));
+  }
+  return OkStatus();
+}
+
 Status DirectSession::GetOrCreateExecutors(
     gtl::ArraySlice<string> inputs, gtl::ArraySlice<string> outputs,
-    gtl::ArraySlice<string> target_nodes, ExecutorsAndKeys** executors_and_keys,
+    gtl::ArraySlice<string> target_nodes,
+    std::shared_ptr<ExecutorsAndKeys>* executors_and_keys,
     RunStateArgs* run_state_args) {
   int64_t handle_name_counter_value = -1;
   if (LogMemory::IsEnabled() || run_state_args->is_partial_run) {
@@ -1509,7 +1575,9 @@ Status DirectSession::GetOrCreateExecutors(
     mutex_lock l(executor_lock_);  // could use reader lock
     auto it = executors_.find(key);
     if (it != executors_.end()) {
-      *executors_and_keys = it->second.get();
+      *executors_and_keys = it->second;
+      TouchExecutorsLocked(it->second.get());
+      metrics::RecordExecutorCacheLookup(/*hit=*/true);
       return OkStatus();
     }
   }
@@ -1542,10 +1610,13 @@ Status DirectSession::GetOrCreateExecutors(
     mutex_lock l(executor_lock_);
     auto it = executors_.find(sorted_key);
     if (it != executors_.end()) {
-      *executors_and_keys = it->second.get();
+      *executors_and_keys = it->second;
+      TouchExecutorsLocked(it->second.get());
+      metrics::RecordExecutorCacheLookup(/*hit=*/true);
       return OkStatus();
     }
   }
+  metrics::RecordExecutorCacheLookup(/*hit=*/false);
 
   // Nothing found, so create the executors and store in the cache.
   // The executor_lock_ is intentionally released while executors are
@@ -1573,21 +1644,45 @@ Status DirectSession::GetOrCreateExecutors(
   TF_RETURN_IF_ERROR(
       CreateExecutors(callable_options, &ek, &func_info, run_state_args));
 
+  // The executors call into the function library runtime when they delete
+  // their kernels, so the deleter releases `func_info` after the executors.
+  std::shared_ptr<ExecutorsAndKeys> shared_ek(
+      ek.release(),
+      [func_info = std::shared_ptr<FunctionInfo>(std::move(func_info))](
+          ExecutorsAndKeys* executors_and_keys) mutable {
+        delete executors_and_keys;
+        func_info.reset();
+      });
+
+  // Evicted executors are deleted after the lock is released.
+  std::vector<std::shared_ptr<ExecutorsAndKeys>> evicted;
+
   // Reacquire the lock, try to insert into the map.
   mutex_lock l(executor_lock_);
 
   // Another thread may have created the entry before us, in which case we will
   // reuse the already created one.
-  auto insert_result = executors_.emplace(
-      sorted_key, std::shared_ptr<ExecutorsAndKeys>(std::move(ek)));
-  if (insert_result.second) {
-    functions_.push_back(std::move(func_info));
+  auto insert_result = executors_.emplace(sorted_key, std::move(shared_ek));
+  const ExecutorsAndKeys* cached_ek = insert_result.first->second.get();
+  const bool evictable =
+      executor_cache_capacity_ > 0 && !run_state_args->is_partial_run;
+  if (insert_result.second && evictable) {
+    executor_cache_lru_.push_front({cached_ek, {sorted_key}});
+    executor_cache_index_[cached_ek] = executor_cache_lru_.begin();
   }
 
   // Insert the value under the original key, so the fast path lookup will work
   // if the user uses the same order of inputs, outputs, and targets again.
-  executors_.emplace(key, insert_result.first->second);
-  *executors_and_keys = insert_result.first->second.get();
+  if (executors_.emplace(key, insert_result.first->second).second &&
+      evictable) {
+    auto index_it = executor_cache_index_.find(cached_ek);
+    if (index_it != executor_cache_index_.end()) {
+      index_it->second->keys.push_back(key);
+    }
+  }
+  *executors_and_keys = insert_result.first->second;
+  TouchExecutorsLocked(cached_ek);
+  EvictExecutorsLocked(&evicted);
 
   return OkStatus();
 }
@@ -17,12 +17,14 @@ limitations under the License.
 #define TENSORFLOW_CORE_COMMON_RUNTIME_DIRECT_SESSION_H_
 
 #include <atomic>
+#include <list>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/common_runtime/costmodel_manager.h"
 #include "tensorflow/core/common_runtime/debugger_state_interface.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
@@ -31,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/graph_execution_state.h"
 #include "tensorflow/core/common_runtime/process_function_library_runtime.h"
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
+#include "tensorflow/core/common_runtime/request_cost_accessor.h"
 #include "tensorflow/core/common_runtime/session_factory.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/collective.h"
@@ -114,6 +117,12 @@ class DirectSession : public Session {
     return OkStatus();
   }
 
+  // Creates and caches the executors for each of `signatures`, so that the
+  // first `Run()` call with the same feeds, fetches, targets and run options
+  // does not pay for pruning, partitioning and optimizing the graph.
+  ::tensorflow::Status WarmUpExecutors(
+      const std::vector<CallableOptions>& signatures);
+
   void ExportCostModels(CostModelManager::CostModelMap* cost_models) {
     cost_model_manager_.ExportCostModels(cost_models);
   }
@@ -239,11 +248,26 @@ class DirectSession : public Session {
   };
 
   // Retrieves an already existing set of executors to run 'inputs' and
-  // 'outputs', or creates and caches them for future use.
+  // 'outputs', or creates and caches them for future use. The caller keeps the
+  // executors alive while it uses them, since they may be evicted from the
+  // cache concurrently.
   ::tensorflow::Status GetOrCreateExecutors(
       gtl::ArraySlice<string> inputs, gtl::ArraySlice<string> outputs,
       gtl::ArraySlice<string> target_nodes,
-      ExecutorsAndKeys** executors_and_keys, RunStateArgs* run_state_args);
+      std::shared_ptr<ExecutorsAndKeys>* executors_and_keys,
+      RunStateArgs* run_state_args);
+
+  // Marks `executors_and_keys` as the most recently used entry of the executor
+  // cache, if it is subject to eviction.
+  void TouchExecutorsLocked(const ExecutorsAndKeys* executors_and_keys)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(executor_lock_);
+
+  // Evicts the least recently used executors until at most
+  // `executor_cache_capacity_` remain, and moves them to `*evicted` so that
+  // the caller can delete them after releasing `executor_lock_`.
+  void EvictExecutorsLocked(
+      std::vector<std::shared_ptr<ExecutorsAndKeys>>* evicted)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(executor_lock_);
 
   // Creates a set of executors to run the subgraph defined by
   // `callable_options`.
@@ -355,18 +379,38 @@ class DirectSession : public Session {
   // If true, blocks until device has finished all queued operations in a step.
   bool sync_on_finish_ = true;
 
-  std::vector<std::unique_ptr<FunctionInfo>> functions_
-      TF_GUARDED_BY(executor_lock_);
+  // If not null, gives the RequestCost of the request a step is run for, which
+  // the executors record the step's CPU time into.
+  std::unique_ptr<RequestCostAccessor> request_cost_accessor_;
 
   mutex executor_lock_;  // protects executors_
   // Holds mappings from signature to the executors that process
   // it. The reason for a level of indirection around mapped_type is
   // to guarantee address stability.
   // The map value is a shared_ptr since multiple map keys can point to the
-  // same ExecutorsAndKey object.
+  // same ExecutorsAndKey object. The `FunctionInfo` used by the executors is
+  // owned by the deleter of the shared_ptr, so that it is destroyed after the
+  // executors.
   std::unordered_map<string, std::shared_ptr<ExecutorsAndKeys>> executors_
       TF_GUARDED_BY(executor_lock_);
 
+  // If positive, the maximum number of distinct executors that `executors_`
+  // holds, not counting those for partial runs, which are never evicted. Set
+  // from the TF_DIRECT_SESSION_EXECUTOR_CACHE_SIZE environment variable.
+  int64_t executor_cache_capacity_ = 0;
+
+  // The evictable executors in `executors_`, most recently used first, with
+  // all of the keys that map to them.
+  struct ExecutorCacheEntry {
+    const ExecutorsAndKeys* executors_and_keys;
+    std::vector<string> keys;
+  };
+  std::list<ExecutorCacheEntry> executor_cache_lru_
+      TF_GUARDED_BY(executor_lock_);
+  absl::flat_hash_map<const ExecutorsAndKeys*,
+                      std::list<ExecutorCacheEntry>::iterator>
+      executor_cache_index_ TF_GUARDED_BY(executor_lock_);
+
   class RunCallableCallFrame;
   struct Callable {
     std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
@@ -43,6 +43,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/monitoring/cell_reader.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/stacktrace.h"
@@ -153,6 +154,38 @@ TEST_F(DirectSessionMinusAXTest, RunSimpleNetwork) {
   EXPECT_FLOAT_EQ(5.0, mat(0, 0));
 }
 
+TEST_F(DirectSessionMinusAXTest, BoundedExecutorCache) {
+  using ::tensorflow::monitoring::testing::CellReader;
+  CellReader<int64_t> cache_events(
+      "/tensorflow/core/direct_session_executor_cache_events");
+  Initialize({3, 2, -1, 0});
+  // Read when the session is created.
+  setenv("TF_DIRECT_SESSION_EXECUTOR_CACHE_SIZE", "1", /*overwrite=*/1);
+  auto session = CreateSession();
+  unsetenv("TF_DIRECT_SESSION_EXECUTOR_CACHE_SIZE");
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def_));
+
+  TF_ASSERT_OK(
+      static_cast<DirectSession*>(session.get())
+          ->WarmUpExecutors({MakeCallableOptions({}, {y_ + ":0"}, {})}));
+  EXPECT_EQ(1, cache_events.Delta("miss"));
+
+  // Alternate between two signatures, so that each run evicts the executors
+  // of the other one.
+  for (int i = 0; i < 4; ++i) {
+    const bool fetch_y = (i % 2 == 0);
+    std::vector<Tensor> outputs;
+    TF_ASSERT_OK(session->Run({}, {fetch_y ? y_ + ":0" : z_ + ":0"}, {},
+                              &outputs));
+    ASSERT_EQ(1, outputs.size());
+    EXPECT_FLOAT_EQ(fetch_y ? 5.0 : -5.0, outputs[0].matrix<float>()(0, 0));
+  }
+  EXPECT_EQ(1, cache_events.Delta("hit"));
+  EXPECT_EQ(3, cache_events.Delta("miss"));
+  EXPECT_EQ(3, cache_events.Delta("eviction"));
+}
+
 TEST_F(DirectSessionMinusAXTest, RunSimpleNetwork_Callable) {
   Initialize({3, 2, -1, 0});
   auto session = CreateSession();
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/eager/eager_executor.h"
 
+#include <algorithm>
 #include <forward_list>
 
 #include "tensorflow/core/lib/core/errors.h"
@@ -29,11 +30,29 @@ bool IsAsyncWaitForRemoteFunctionEnabled() {
                                  true, &enabled));
   return enabled;
 }
+
+int NumAsyncExecutorWorkers() {
+  int64_t num_workers = 1;
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_EAGER_ASYNC_EXECUTOR_NUM_WORKERS", 1,
+                                  &num_workers));
+  return static_cast<int>(std::max<int64_t>(num_workers, 1));
+}
 }  // namespace
 
 EagerExecutor::EagerExecutor(bool async, bool enable_streaming_enqueue)
+    : EagerExecutor(async, enable_streaming_enqueue,
+                    async ? NumAsyncExecutorWorkers() : 1) {}
+
+EagerExecutor::EagerExecutor(bool async, bool enable_streaming_enqueue,
+                             int num_workers)
     : next_node_id_(0),
       ok_(true),
+      num_workers_(num_workers),
+      workers_(async && num_workers > 1
+                   ? new thread::ThreadPool(tensorflow::Env::Default(),
+                                            "eager_async_executor_worker",
+                                            num_workers)
+                   : nullptr),
       thread_(async ? tensorflow::Env::Default()->StartThread(
                           tensorflow::ThreadOptions(), "eager_async_executor",
                           std::bind(&EagerExecutor::Run, this))
@@ -47,6 +66,7 @@ EagerExecutor::~EagerExecutor() {
   tensorflow::mutex_lock l(node_queue_mutex_);
   state_ = ExecutorState::kShutDown;
   nodes_pending_.notify_all();
+  concurrent_node_done_.notify_all();
   for (const auto& cleanups_for_key : cleanups_) {
     for (const std::function<void()>& cleanup : cleanups_for_key.second) {
       cleanup();
@@ -214,7 +234,7 @@ void EagerExecutor::NodeDone(const core::RefCountPtr<NodeItem>& item,
   DCHECK(item->state != NodeState::kDONE);
   item->state = NodeState::kDONE;
 
-  bool async = item->node->AsAsync() != nullptr;
+  bool async = item->node->AsAsync() != nullptr || item->concurrent;
   // If executing synchronously we don't need to notify if status is OK since
   // the node  was never added to the unfinished_nodes_ list and nobody should
   // ever be waiting for it.
@@ -233,9 +253,10 @@ void EagerExecutor::NodeDone(const core::RefCountPtr<NodeItem>& item,
       DCHECK(!node_queue_.empty() && item.get() == node_queue_.front().get());
       node_queue_.pop();
     } else if (async) {
-      // If it is an Async node then we will find the node in the unfinished
-      // nodes list. However we only notify if we are at the front of the list
-      // since we don't want to notify any waiters of earlier nodes.
+      // If it is an Async or concurrently run node then we will find the node
+      // in the unfinished nodes list. However we only notify if we are at the
+      // front of the list since we don't want to notify any waiters of earlier
+      // nodes.
       need_notification = item->id == unfinished_nodes_.begin()->first;
       // Remove item if it exists in unfinished_nodes_.
       // With async execution, if two separate nodes failed and enter this
@@ -268,6 +289,8 @@ void EagerExecutor::NodeDone(const core::RefCountPtr<NodeItem>& item,
         node_queue_.pop();
       }
       for (auto& it : unfinished_nodes_) {
+        // Nodes still running on a worker produce their outputs themselves.
+        if (it.second->concurrent) continue;
         items_to_destroy.push_front(std::move(it.second));
       }
       unfinished_nodes_.clear();
@@ -322,6 +345,7 @@ void EagerExecutor::Run() {
       gtl::MakeCleanup([this] { thread_exited_notification_.Notify(); });
   while (true) {
     core::RefCountPtr<NodeItem> curr_item;
+    bool concurrent = false;
     {
       tensorflow::mutex_lock l(node_queue_mutex_);
       while (node_queue_.empty() || !status_.ok()) {
@@ -337,6 +361,24 @@ void EagerExecutor::Run() {
       // and register a notification for its completion.
       curr_item.reset(node_queue_.front().get());
       curr_item->Ref();
+      if (workers_ != nullptr) {
+        // A concurrent node waits for a free worker, so that every running
+        // node has a thread and only ever waits for inputs of earlier nodes.
+        // Any other node waits for all running nodes to be done.
+        concurrent = curr_item->node->CanRunConcurrently();
+        const int max_running = concurrent ? num_workers_ - 1 : 0;
+        while (num_concurrent_nodes_ > max_running && status_.ok() &&
+               state_ != ExecutorState::kShutDown) {
+          concurrent_node_done_.wait(l);
+        }
+        if (state_ == ExecutorState::kShutDown) return;
+        // On error, the queue has been cleared and `curr_item` aborted.
+        if (!status_.ok()) continue;
+      }
+    }
+    if (concurrent) {
+      RunItemConcurrently(std::move(curr_item));
+      continue;
     }
     Status status = RunItem(std::move(curr_item), /*from_queue=*/true);
     if (!status.ok()) {
@@ -398,6 +440,34 @@ Status EagerExecutor::RunItem(core::RefCountPtr<NodeItem> item,
   return status();
 }
 
+void EagerExecutor::RunItemConcurrently(core::RefCountPtr<NodeItem> item) {
+  DVLOG(3) << "Running Node concurrently: [id " << item->id << "] "
+           << item->node->DebugString();
+  NodeItem* concurrent_ref = item.get();
+  {
+    tensorflow::mutex_lock l(node_queue_mutex_);
+    if (!status_.ok()) return;
+    DCHECK(!node_queue_.empty() && item.get() == node_queue_.front().get());
+    node_queue_.pop();
+    item->state = NodeState::kSCHEDULED;
+    item->concurrent = true;
+    concurrent_ref->Ref();
+    unfinished_nodes_.emplace_hint(unfinished_nodes_.end(), item->id,
+                                   std::move(item));
+    ++num_concurrent_nodes_;
+  }
+  workers_->Schedule([this, concurrent_ref]() {
+    {
+      core::RefCountPtr<NodeItem> concurrent_item(concurrent_ref);
+      Status status = concurrent_item->node->Run();
+      NodeDone(concurrent_item, status, /*from_queue=*/false);
+    }
+    tensorflow::mutex_lock l(node_queue_mutex_);
+    --num_concurrent_nodes_;
+    concurrent_node_done_.notify_all();
+  });
+}
+
 Status EagerExecutor::MoveToUnfinished(core::RefCountPtr<NodeItem> item,
                                        bool from_queue) {
   tensorflow::mutex_lock l(node_queue_mutex_);
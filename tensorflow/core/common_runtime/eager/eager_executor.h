@@ -33,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/public/version.h"
 
@@ -75,6 +76,12 @@ class EagerNode {
 
   // Indicates whether a node failure should make the executor unusable.
   virtual bool Fatal() const { return true; }
+
+  // Indicates whether an async EagerExecutor with several workers may run this
+  // node concurrently with the nodes added before it. Such a node must only
+  // depend on earlier nodes through the readiness of its input handles, and
+  // must not have side effects whose order is observable (e.g. on resources).
+  virtual bool CanRunConcurrently() const { return false; }
 };
 
 class AsyncEagerNode : public EagerNode {
@@ -106,12 +113,20 @@ class AsyncRemoteExecuteNode : public AsyncEagerNode {
 // TODO(agarwal): TFE_OpAddInput may currently block if it tries to access the
 // device of the input handle. Fix that.
 // TODO(agarwal): Implement support for control dependencies.
-// TODO(agarwal): Support out-of-order execution and dispatching multiple
-// EagerNode in parallel.
 // TODO(agarwal): Implement optimizations over EagerNode traces.
+//
+// In async mode, nodes are dispatched in the order they are added. Nodes that
+// CanRunConcurrently() are handed to up to `num_workers` worker threads and
+// may overlap with each other and with the nodes added after them; any other
+// node waits until all concurrently running nodes are done, which preserves
+// the order of stateful ops and of ops on resources.
 class EagerExecutor {
  public:
+  // The number of workers of an async executor is read from the
+  // TF_EAGER_ASYNC_EXECUTOR_NUM_WORKERS environment variable, and defaults
+  // to 1, i.e. one node at a time.
   explicit EagerExecutor(bool async, bool enable_streaming_enqueue = true);
+  EagerExecutor(bool async, bool enable_streaming_enqueue, int num_workers);
 
   ~EagerExecutor();
 
@@ -190,6 +205,8 @@ class EagerExecutor {
     uint64 id;
     std::unique_ptr<EagerNode> node;
     NodeState state;
+    // Whether the node was handed to a worker thread.
+    bool concurrent = false;
   };
 
   const char* StateStringLocked()
@@ -206,6 +223,9 @@ class EagerExecutor {
   void Run();
 
   Status RunItem(core::RefCountPtr<NodeItem> item, bool from_queue);
+  // Moves `item` from the front of the queue to `unfinished_nodes_` and runs
+  // it on a worker thread.
+  void RunItemConcurrently(core::RefCountPtr<NodeItem> item);
   Status MoveToUnfinished(core::RefCountPtr<NodeItem> item, bool from_queue);
 
   // The impl of WaitForAllPendingNodes
@@ -242,6 +262,11 @@ class EagerExecutor {
   std::multimap<uint64, condition_variable*, std::less<uint64>>
       node_done_notifications_ TF_GUARDED_BY(node_queue_mutex_);
 
+  // Number of nodes currently running on `workers_`, and the condition
+  // notified whenever one of them is done.
+  int num_concurrent_nodes_ TF_GUARDED_BY(node_queue_mutex_) = 0;
+  condition_variable concurrent_node_done_ TF_GUARDED_BY(node_queue_mutex_);
+
   // thread_exited_notification_ is notified by the `thread_` right before it
   // exits.
   Notification thread_exited_notification_;
@@ -251,8 +276,14 @@ class EagerExecutor {
   ExecutorState state_ TF_GUARDED_BY(node_queue_mutex_) =
       ExecutorState::kActive;
 
+  // Workers running the nodes that CanRunConcurrently(). It is `nullptr` in
+  // sync mode and for async executors with a single worker.
+  const int num_workers_;
+  const std::unique_ptr<thread::ThreadPool> workers_;
+
   // Thread object that calls the `Run` method in async mode.This thread runs
   // until state_ is set to kShuttingDown. It is `nullptr` in sync mode.
+  // Declared after `workers_` so that it is joined first.
   const std::unique_ptr<Thread> thread_;
 
   // Last device where remote function with remote inputs was executed.
@@ -0,0 +1,127 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/eager/eager_executor.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/notification.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Records the order in which nodes run, and optionally blocks until
+// `release` is notified.
+class TestNode : public EagerNode {
+ public:
+  TestNode(int id, bool concurrent, mutex* mu, std::vector<int>* order,
+           Notification* release = nullptr, BlockingCounter* started = nullptr)
+      : id_(id),
+        concurrent_(concurrent),
+        mu_(mu),
+        order_(order),
+        release_(release),
+        started_(started) {}
+
+  Status Run() override {
+    if (started_ != nullptr) started_->DecrementCount();
+    if (release_ != nullptr) release_->WaitForNotification();
+    mutex_lock l(*mu_);
+    order_->push_back(id_);
+    return OkStatus();
+  }
+
+  void Abort(Status status) override {}
+
+  bool CanRunConcurrently() const override { return concurrent_; }
+
+  string DebugString() const override { return "[TestNode]"; }
+
+ private:
+  const int id_;
+  const bool concurrent_;
+  mutex* const mu_;
+  std::vector<int>* const order_;
+  Notification* const release_;
+  BlockingCounter* const started_;
+};
+
+TEST(EagerExecutorTest, ConcurrentNodesOverlap) {
+  EagerExecutor executor(/*async=*/true, /*enable_streaming_enqueue=*/true,
+                         /*num_workers=*/2);
+  mutex mu;
+  std::vector<int> order;
+  Notification release;
+  BlockingCounter started(2);
+  // The first node only finishes once the second one has started running.
+  TF_ASSERT_OK(executor.AddOrExecute(std::make_unique<TestNode>(
+      0, /*concurrent=*/true, &mu, &order, &release, &started)));
+  TF_ASSERT_OK(executor.AddOrExecute(std::make_unique<TestNode>(
+      1, /*concurrent=*/true, &mu, &order, nullptr, &started)));
+  started.Wait();
+  release.Notify();
+  TF_ASSERT_OK(executor.WaitForAllPendingNodes());
+  EXPECT_EQ(order.size(), 2);
+  TF_ASSERT_OK(executor.ShutDown());
+}
+
+TEST(EagerExecutorTest, OrderedNodeWaitsForConcurrentNodes) {
+  EagerExecutor executor(/*async=*/true, /*enable_streaming_enqueue=*/true,
+                         /*num_workers=*/4);
+  mutex mu;
+  std::vector<int> order;
+  Notification release;
+  TF_ASSERT_OK(executor.AddOrExecute(std::make_unique<TestNode>(
+      0, /*concurrent=*/true, &mu, &order, &release)));
+  TF_ASSERT_OK(executor.AddOrExecute(
+      std::make_unique<TestNode>(1, /*concurrent=*/false, &mu, &order)));
+  TF_ASSERT_OK(executor.AddOrExecute(
+      std::make_unique<TestNode>(2, /*concurrent=*/true, &mu, &order)));
+  release.Notify();
+  TF_ASSERT_OK(executor.WaitForAllPendingNodes());
+  EXPECT_EQ(order, std::vector<int>({0, 1, 2}));
+  TF_ASSERT_OK(executor.ShutDown());
+}
+
+class FailingNode : public EagerNode {
+ public:
+  bool CanRunConcurrently() const override { return true; }
+  Status Run() override { return errors::Internal("failed"); }
+  void Abort(Status status) override {}
+  string DebugString() const override { return "[FailingNode]"; }
+};
+
+TEST(EagerExecutorTest, ConcurrentNodeErrorIsReported) {
+  EagerExecutor executor(/*async=*/true, /*enable_streaming_enqueue=*/true,
+                         /*num_workers=*/2);
+  TF_ASSERT_OK(executor.AddOrExecute(std::make_unique<FailingNode>()));
+  EXPECT_EQ(executor.WaitForAllPendingNodes().code(), error::INTERNAL);
+  executor.ClearError();
+  mutex mu;
+  std::vector<int> order;
+  TF_ASSERT_OK(executor.AddOrExecute(
+      std::make_unique<TestNode>(0, /*concurrent=*/true, &mu, &order)));
+  TF_ASSERT_OK(executor.WaitForAllPendingNodes());
+  EXPECT_EQ(order, std::vector<int>({0}));
+  TF_ASSERT_OK(executor.ShutDown());
+}
+
+}  // namespace
+}  // namespace tensorflow
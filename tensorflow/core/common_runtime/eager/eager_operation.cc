@@ -341,6 +341,8 @@ Status EagerOperation::Reset(
   }
   attrs_.Reset(op);
   stack_trace_.reset();
+  is_prepared_ = false;
+  prepared_kernel_.reset();
   is_function_ = is_function;
   cancellation_manager_ = nullptr;
   executor_ = executor ? executor : &ctx_.Executor();
@@ -15,6 +15,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_EAGER_OPERATION_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_EAGER_OPERATION_H_
 
+#include <unordered_map>
+#include <vector>
+
 #include "absl/container/inlined_vector.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
@@ -26,9 +29,12 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/eager/eager_executor.h"
 #include "tensorflow/core/common_runtime/eager/kernel_and_device.h"
 #include "tensorflow/core/common_runtime/eager/tensor_handle.h"
+#include "tensorflow/core/common_runtime/eager/thread_local_free_list.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/framework/op_def.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/util/device_name_utils.h"
 #include "tensorflow/core/util/managed_stack_trace.h"
 
@@ -44,6 +50,15 @@ class EagerOperation : public ImmediateExecutionOperation {
     }
   }
 
+  // Operations are typically created for every eager op, so their storage is
+  // recycled through a per-thread free list.
+  static void* operator new(size_t size) {
+    return ThreadLocalFreeList<EagerOperation>::Allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    ThreadLocalFreeList<EagerOperation>::Free(ptr, size);
+  }
+
   void Release() override { delete this; }
 
   void Clear() override;
@@ -216,6 +231,37 @@ class EagerOperation : public ImmediateExecutionOperation {
   // Op name recorded for memory debugging purpose.
   const char* op_name() const { return op_name_; }
 
+  // The kernel resolved for a prepared operation, together with everything
+  // that went into its kernel cache key other than the context's kernel
+  // cache itself.
+  struct PreparedKernel {
+    core::RefCountPtr<KernelAndDevice> kernel;
+    Fprint128 op_cache_key;
+    std::vector<tensorflow::Device*> input_devices;
+    std::unordered_map<int, DtypeAndPartialTensorShape>
+        input_resource_dtypes_and_shapes;
+    bool allow_soft_placement;
+    bool run_eager_op_as_function;
+    bool reuse_rendezvous_for_functions;
+  };
+
+  // Marks the operation as prepared for repeated execution with the same
+  // attributes and device and only its inputs replaced through SetInput. The
+  // kernel resolved by the next local execution is kept with the operation,
+  // and later executions whose inputs land on the same devices reuse it
+  // without computing the kernel cache key or consulting the context's kernel
+  // cache. The prepared state is dropped by Reset.
+  void Prepare() { is_prepared_ = true; }
+  bool is_prepared() const { return is_prepared_; }
+
+  const PreparedKernel* prepared_kernel() const {
+    return prepared_kernel_.has_value() ? &*prepared_kernel_ : nullptr;
+  }
+  void SetPreparedKernel(PreparedKernel prepared_kernel) {
+    DCHECK(is_prepared_);
+    prepared_kernel_ = std::move(prepared_kernel);
+  }
+
   // For LLVM style RTTI.
   static bool classof(const AbstractOperation* ptr) {
     return ptr->getKind() == kEager;
@@ -284,6 +330,9 @@ class EagerOperation : public ImmediateExecutionOperation {
   int inference_arg_idx_;  // arg definition index for the next input to be
                            // added
   gtl::FlatSet<std::string> inference_attrs_;  // attributes inferred so far
+
+  bool is_prepared_ = false;
+  absl::optional<PreparedKernel> prepared_kernel_;
 };
 
 inline void EagerOperation::UpdateInput(int i, TensorHandle* h) {
@@ -985,10 +985,48 @@ Fprint128 GetDeviceCacheKey(EagerOperation* op, const EagerContext& ctx) {
   return device_cache_key;
 }
 
+// Returns the kernel kept by a prepared `op` if it was resolved for the same
+// attributes, input devices, resource variable dtypes and shapes and context
+// policies, and nullptr otherwise. Matching these is equivalent to matching
+// the kernel cache key, without fingerprinting them.
+KernelAndDevice* GetPreparedKernel(
+    const EagerOperation& op, const Fprint128& op_cache_key,
+    const std::vector<Device*>& input_dev_ptrs,
+    const std::unordered_map<int, DtypeAndPartialTensorShape>&
+        input_resource_variable_dtypes_and_shapes,
+    bool reuse_rendezvous_for_functions) {
+  const EagerOperation::PreparedKernel* prepared = op.prepared_kernel();
+  if (prepared == nullptr) return nullptr;
+  const EagerContext& ctx = op.EagerContext();
+  if (!(prepared->op_cache_key == op_cache_key) ||
+      prepared->allow_soft_placement != ctx.AllowSoftPlacement() ||
+      prepared->run_eager_op_as_function != ctx.RunEagerOpAsFunction() ||
+      prepared->reuse_rendezvous_for_functions !=
+          reuse_rendezvous_for_functions ||
+      prepared->input_devices != input_dev_ptrs ||
+      prepared->input_resource_dtypes_and_shapes.size() !=
+          input_resource_variable_dtypes_and_shapes.size()) {
+    return nullptr;
+  }
+  for (const auto& it : input_resource_variable_dtypes_and_shapes) {
+    const auto& prepared_resources = prepared->input_resource_dtypes_and_shapes;
+    auto prepared_it = prepared_resources.find(it.first);
+    if (prepared_it == prepared_resources.end() ||
+        prepared_it->second.dtype != it.second.dtype ||
+        !prepared_it->second.shape.IsIdenticalTo(it.second.shape)) {
+      return nullptr;
+    }
+  }
+  return prepared->kernel.get();
+}
+
 Status GetOrCreateKernelAndDevice(
     EagerOperation* op, TensorHandle** retvals, int* num_retvals,
     core::RefCountPtr<KernelAndDevice>* out_kernel) {
   EagerContext& ctx = op->EagerContext();
+  // `op` is replaced by its wrapping call op in eager_op_as_function mode, but
+  // a prepared kernel is kept with the operation the caller executes.
+  EagerOperation* const prepared_op = op->is_prepared() ? op : nullptr;
   Device* device = absl::get<Device*>(op->Device());
   const KernelDef* kernel_def = nullptr;
 
@@ -1066,10 +1104,41 @@ Status GetOrCreateKernelAndDevice(
     }
   }
 
+  const Fprint128 op_cache_key =
+      op->MutableAttrs()->CacheKey(op->DeviceName());
+  if (prepared_op != nullptr) {
+    KernelAndDevice* prepared_kernel = GetPreparedKernel(
+        *op, op_cache_key, input_dev_ptrs,
+        input_resource_variable_dtypes_and_shapes,
+        reuse_rendezvous_for_functions);
+    if (prepared_kernel != nullptr) {
+      int num_outputs = prepared_kernel->num_outputs();
+      if (num_outputs > *num_retvals) {
+        return errors::InvalidArgument("Expecting ", num_outputs,
+                                       " outputs, but *num_retvals is ",
+                                       *num_retvals);
+      }
+      *num_retvals = num_outputs;
+      // Ownership of reference is passed to out_kernel.
+      prepared_kernel->Ref();
+      out_kernel->reset(prepared_kernel);
+      return OkStatus();
+    }
+  }
+
+  // Kept for the prepared kernel, since creating the kernel consumes them.
+  std::vector<Device*> prepared_input_devices;
+  std::unordered_map<int, DtypeAndPartialTensorShape>
+      prepared_input_resource_dtypes_and_shapes;
+  if (prepared_op != nullptr) {
+    prepared_input_devices = input_dev_ptrs;
+    prepared_input_resource_dtypes_and_shapes =
+        input_resource_variable_dtypes_and_shapes;
+  }
+
   TF_ASSIGN_OR_RETURN(
       Fprint128 cache_key,
-      GetKernelCacheKey(*op, op->MutableAttrs()->CacheKey(op->DeviceName()),
-                        input_dev_ptrs,
+      GetKernelCacheKey(*op, op_cache_key, input_dev_ptrs,
                         input_resource_variable_dtypes_and_shapes));
   core::RefCountPtr<KernelAndDevice> kernel = ctx.GetCachedKernel(cache_key);
   AbstractOperationPtr wrapped_op_releaser;
@@ -1243,6 +1312,19 @@ Status GetOrCreateKernelAndDevice(
   }
   *num_retvals = num_outputs;
 
+  if (prepared_op != nullptr) {
+    // Attributes may have been set while creating the kernel (e.g.
+    // _XlaMustCompile), so the key is recomputed for the next execution.
+    kernel->Ref();
+    prepared_op->SetPreparedKernel(EagerOperation::PreparedKernel{
+        core::RefCountPtr<KernelAndDevice>(kernel.get()),
+        prepared_op->MutableAttrs()->CacheKey(prepared_op->DeviceName()),
+        std::move(prepared_input_devices),
+        std::move(prepared_input_resource_dtypes_and_shapes),
+        ctx.AllowSoftPlacement(), ctx.RunEagerOpAsFunction(),
+        reuse_rendezvous_for_functions});
+  }
+
   kernel->Ref();  // Ownership of reference is passed to out_kernel.
   out_kernel->reset(kernel.get());
   return OkStatus();
@@ -0,0 +1,74 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Benchmarks of the per-op overhead of eager execution. See also
+// ../runtime_overhead_benchmark_test.cc.
+
+#include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/common_runtime/eager/context.h"
+#include "tensorflow/core/common_runtime/eager/eager_operation.h"
+#include "tensorflow/core/common_runtime/eager/execute.h"
+#include "tensorflow/core/common_runtime/eager/tensor_handle.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/public/session_options.h"
+
+namespace tensorflow {
+namespace {
+
+// Builds and executes an Identity of a scalar, on an already-warm kernel
+// cache, so that the time is the overhead of eager execution itself:
+// resolving the attributes, the device and the cached kernel, and creating
+// the output handle. With `async` set to 1, the op is enqueued on the
+// context's async executor instead. With `run_as_function` set to 1, the
+// context has run_eager_op_as_function enabled, so the op is wrapped in a
+// single-op function.
+void BM_EagerExecute(::testing::benchmark::State& state) {
+  const bool async = state.range(0);
+  const bool run_as_function = state.range(1);
+
+  StaticDeviceMgr device_mgr(DeviceFactory::NewDevice(
+      "CPU", {}, "/job:localhost/replica:0/task:0/device:CPU:0"));
+  auto ctx = new EagerContext(
+      SessionOptions(),
+      tensorflow::ContextDevicePlacementPolicy::DEVICE_PLACEMENT_SILENT, async,
+      &device_mgr, false, nullptr, nullptr, nullptr, run_as_function);
+  TensorHandle* input =
+      TensorHandle::CreateLocalHandle(test::AsScalar<float>(1.0));
+
+  for (auto s : state) {
+    EagerOperation op(ctx);
+    TF_CHECK_OK(op.Reset("Identity", /*raw_device_name=*/nullptr));
+    TF_CHECK_OK(op.SetAttrType("T", DT_FLOAT));
+    TF_CHECK_OK(op.AddInput(input));
+    TensorHandle* retval = nullptr;
+    int num_retvals = 1;
+    TF_CHECK_OK(EagerExecute(&op, &retval, &num_retvals));
+    retval->Unref();
+  }
+  TF_CHECK_OK(ctx->Executor().WaitForAllPendingNodes());
+
+  input->Unref();
+  ctx->Unref();
+}
+BENCHMARK(BM_EagerExecute)
+    ->ArgPair(0, 0)
+    ->ArgPair(1, 0)
+    ->ArgPair(0, 1);
+
+}  // namespace
+}  // namespace tensorflow
@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/platform/platform.h"
 // clang-format on
 
+#include "absl/algorithm/container.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/memory/memory.h"
 #include "absl/types/optional.h"
@@ -35,6 +36,8 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/eager/execute.h"
 #include "tensorflow/core/common_runtime/eager/kernel_and_device.h"
 #include "tensorflow/core/common_runtime/eager/tensor_handle.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/step_stats.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
@@ -222,6 +225,27 @@ class AsyncExecuteNode : public EagerNode {
     }
   }
 
+  // Single ops that are stateless and take or produce neither resources,
+  // variants nor references only interact with other nodes through their input
+  // and output handles.
+  bool CanRunConcurrently() const override {
+    const OpKernel* op_kernel = kernel_->kernel();
+    if (op_kernel == nullptr || kernel_->IsFunction()) return false;
+    const OpDef* op_def = nullptr;
+    if (!OpRegistry::Global()->LookUpOpDef(op_kernel->type_string(), &op_def)
+             .ok() ||
+        op_def->is_stateful()) {
+      return false;
+    }
+    auto has_ordered_dtype = [](const DataTypeVector& dtypes) {
+      return absl::c_any_of(dtypes, [](DataType dtype) {
+        return dtype == DT_RESOURCE || dtype == DT_VARIANT || IsRefType(dtype);
+      });
+    };
+    return !has_ordered_dtype(kernel_->input_dtypes()) &&
+           !has_ordered_dtype(kernel_->output_dtypes());
+  }
+
   std::string DebugString() const override {
     std::string out = "[AsyncExecuteNode]";
     strings::StrAppend(&out, " kernel: ", kernel_->name());
@@ -0,0 +1,104 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_THREAD_LOCAL_FREE_LIST_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_THREAD_LOCAL_FREE_LIST_H_
+
+#include <cstddef>
+#include <new>
+
+namespace tensorflow {
+
+// Recycles the storage of objects of type `T` through a per-thread free list
+// of at most `kMaxCachedObjects` blocks, so that the objects created and
+// destroyed for every eager op do not go through the global allocator.
+//
+// `T` opts in by forwarding its class-specific allocation functions:
+//
+//   static void* operator new(size_t size) {
+//     return ThreadLocalFreeList<T>::Allocate(size);
+//   }
+//   static void operator delete(void* ptr, size_t size) {
+//     ThreadLocalFreeList<T>::Free(ptr, size);
+//   }
+//
+// Storage freed on a different thread than the one it was allocated on (e.g.
+// by the async EagerExecutor) joins the freeing thread's list; each list is
+// bounded, and blocks beyond the bound are returned to the global allocator.
+// Allocations whose size differs from sizeof(T), i.e. of subclasses, bypass
+// the free list.
+template <typename T, int kMaxCachedObjects = 64>
+class ThreadLocalFreeList {
+ public:
+  static void* Allocate(size_t size) {
+    if (size == sizeof(T)) {
+      FreeList& free_list = GetFreeList();
+      if (free_list.head != nullptr) {
+        Block* block = free_list.head;
+        free_list.head = block->next;
+        --free_list.size;
+        return block;
+      }
+    }
+    return ::operator new(size);
+  }
+
+  static void Free(void* ptr, size_t size) {
+    if (ptr == nullptr) return;
+    if (size == sizeof(T)) {
+      FreeList& free_list = GetFreeList();
+      if (free_list.size >= 0 && free_list.size < kMaxCachedObjects) {
+        Block* block = static_cast<Block*>(ptr);
+        block->next = free_list.head;
+        free_list.head = block;
+        ++free_list.size;
+        return;
+      }
+    }
+    ::operator delete(ptr);
+  }
+
+  // Returns the number of blocks cached by the calling thread.
+  static int NumCachedForTesting() { return GetFreeList().size; }
+
+ private:
+  struct Block {
+    Block* next;
+  };
+  static_assert(sizeof(T) >= sizeof(Block), "T is too small to be pooled");
+
+  struct FreeList {
+    ~FreeList() {
+      while (head != nullptr) {
+        Block* next = head->next;
+        ::operator delete(head);
+        head = next;
+      }
+      // Objects destroyed later during thread exit bypass the free list.
+      size = -1;
+    }
+
+    Block* head = nullptr;
+    int size = 0;
+  };
+
+  static FreeList& GetFreeList() {
+    static thread_local FreeList free_list;
+    return free_list;
+  }
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_THREAD_LOCAL_FREE_LIST_H_
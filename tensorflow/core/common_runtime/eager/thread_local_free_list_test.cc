@@ -0,0 +1,93 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/eager/thread_local_free_list.h"
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+struct Pooled {
+  static void* operator new(size_t size) {
+    return ThreadLocalFreeList<Pooled, 2>::Allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    ThreadLocalFreeList<Pooled, 2>::Free(ptr, size);
+  }
+
+  virtual ~Pooled() = default;
+
+  int64_t value[4] = {};
+};
+
+struct DerivedPooled : public Pooled {
+  int64_t more[4] = {};
+};
+
+using FreeList = ThreadLocalFreeList<Pooled, 2>;
+
+TEST(ThreadLocalFreeListTest, ReusesFreedStorage) {
+  Pooled* first = new Pooled;
+  delete first;
+  EXPECT_EQ(FreeList::NumCachedForTesting(), 1);
+  Pooled* second = new Pooled;
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(FreeList::NumCachedForTesting(), 0);
+  delete second;
+}
+
+TEST(ThreadLocalFreeListTest, BoundsCachedStorage) {
+  std::vector<std::unique_ptr<Pooled>> objects;
+  for (int i = 0; i < 4; ++i) {
+    objects.push_back(std::make_unique<Pooled>());
+  }
+  objects.clear();
+  EXPECT_EQ(FreeList::NumCachedForTesting(), 2);
+}
+
+TEST(ThreadLocalFreeListTest, SubclassesBypassFreeList) {
+  const int num_cached = FreeList::NumCachedForTesting();
+  Pooled* derived = new DerivedPooled;
+  delete derived;
+  EXPECT_EQ(FreeList::NumCachedForTesting(), num_cached);
+}
+
+TEST(ThreadLocalFreeListTest, StorageFreedOnOtherThread) {
+  Pooled* object = new Pooled;
+  std::unique_ptr<Thread> thread(
+      Env::Default()->StartThread(ThreadOptions(), "free_list_test", [&] {
+        delete object;
+        EXPECT_EQ(FreeList::NumCachedForTesting(), 1);
+      }));
+  // Joining the thread returns its cached storage to the global allocator.
+  thread.reset();
+}
+
+void BM_NewDelete(::testing::benchmark::State& state) {
+  for (auto s : state) {
+    Pooled* object = new Pooled;
+    testing::DoNotOptimize(object);
+    delete object;
+  }
+}
+BENCHMARK(BM_NewDelete);
+
+}  // namespace
+}  // namespace tensorflow
@@ -22,6 +22,7 @@ limitations under the License.
 #include "absl/memory/memory.h"
 #include "absl/time/time.h"
 #include "absl/types/optional.h"
+#include "tensorflow/core/common_runtime/cost_constants.h"
 #include "tensorflow/core/common_runtime/costmodel_manager.h"
 #include "tensorflow/core/common_runtime/entry.h"
 #include "tensorflow/core/common_runtime/executor_factory.h"
@@ -30,8 +31,12 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/pending_counts.h"
 #include "tensorflow/core/common_runtime/propagator_state.h"
 #include "tensorflow/core/common_runtime/renamed_device.h"
+#include "tensorflow/core/common_runtime/request_cost.h"
 #include "tensorflow/core/common_runtime/simple_propagator_state.h"
+#include "tensorflow/core/common_runtime/static_plan_propagator_state.h"
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
+#include "tensorflow/core/common_runtime/work_stealing_ready_queue.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/collective.h"
@@ -58,6 +63,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/manual_constructor.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
@@ -74,6 +80,7 @@ limitations under the License.
 #include "tensorflow/core/profiler/lib/traceme_encode.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
 #include "tensorflow/core/util/determinism.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/managed_stack_trace.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
 
@@ -145,7 +152,29 @@ class ExecutorImpl : public Executor {
 
   Status Initialize(const Graph& graph) {
     TF_RETURN_IF_ERROR(immutable_state_.Initialize(graph));
-    kernel_stats_.Initialize(immutable_state_.graph_view());
+    bool use_measured_kernel_cost = false;
+    TF_RETURN_IF_ERROR(ReadBoolFromEnvVar("TF_EXECUTOR_USE_MEASURED_KERNEL_COST",
+                                          false, &use_measured_kernel_cost));
+    kernel_stats_.Initialize(immutable_state_.graph_view(),
+                             use_measured_kernel_cost);
+    TF_RETURN_IF_ERROR(ReadBoolFromEnvVar("TF_EXECUTOR_USE_WORK_STEALING",
+                                          false, &use_work_stealing_));
+    TF_RETURN_IF_ERROR(ReadBoolFromEnvVar("TF_EXECUTOR_USE_STEP_ARENA", false,
+                                          &use_step_arena_));
+    use_step_arena_ = use_step_arena_ &&
+                      immutable_state_.params().device->device_type() ==
+                          DEVICE_CPU;
+    bool lock_free_root_frame = false;
+    TF_RETURN_IF_ERROR(ReadBoolFromEnvVar("TF_EXECUTOR_LOCK_FREE_ROOT_FRAME",
+                                          false, &lock_free_root_frame));
+    immutable_state_.set_lock_free_root_frame(lock_free_root_frame);
+    bool use_static_plan = false;
+    TF_RETURN_IF_ERROR(ReadBoolFromEnvVar("TF_EXECUTOR_USE_STATIC_PLAN", false,
+                                          &use_static_plan));
+    if (use_static_plan && !immutable_state_.BuildStaticPlan()) {
+      VLOG(1) << "Graph requires control flow support or contains "
+                 "asynchronous kernels; not using a static execution plan.";
+    }
     return OkStatus();
   }
 
@@ -160,15 +189,23 @@ class ExecutorImpl : public Executor {
    public:
     KernelStats() = default;
 
-    void Initialize(const GraphView& gview) {
+    // If `use_measured_cost` is true, the cost of every kernel is tracked,
+    // and whether a node is expensive is decided by its measured cost alone.
+    // Otherwise, only kernels for which `OpKernel::IsExpensive()` returns true
+    // are tracked, and all other kernels are always considered inexpensive.
+    void Initialize(const GraphView& gview, bool use_measured_cost) {
       is_expensive_.resize(gview.num_nodes());
       cost_estimates_ =
           std::make_unique<std::atomic_uint_fast64_t[]>(gview.num_nodes());
       for (int32_t i = 0; i < gview.num_nodes(); ++i) {
         if (gview.node(i)) {
-          is_expensive_[i] =
+          const bool has_expensive_marker =
               gview.node(i)->kernel && gview.node(i)->kernel->IsExpensive();
-          cost_estimates_[i] = kInitialCostEstimateCycles;
+          is_expensive_[i] = has_expensive_marker || use_measured_cost;
+          // Kernels without the marker start out inexpensive, and are promoted
+          // if their measured cost exceeds the threshold.
+          cost_estimates_[i] =
+              has_expensive_marker ? kInitialCostEstimateCycles : 0;
         }
       }
     }
@@ -182,7 +219,9 @@ class ExecutorImpl : public Executor {
               kOpIsExpensiveThresholdCycles);
     }
 
-    // Returns the value of kernel->IsExpensive().
+    // Returns true if the executor should measure the cost of the given node
+    // and call `UpdateCostEstimate()`. This is the value of
+    // `kernel->IsExpensive()`, unless measured costs are in use.
     bool HasExpensiveMarker(const NodeItem& node) const {
       return is_expensive_[node.node_id];
     }
@@ -190,7 +229,7 @@ class ExecutorImpl : public Executor {
     // Updates the dynamic cost estimate, which is used to determine whether the
     // given node is expensive. The new cost estimate is a weighted average of
     // the old cost estimate and the latest cost. We only update cost estimates
-    // for kernels for which IsExpensive() return true.
+    // for kernels for which HasExpensiveMarker() returns true.
     void UpdateCostEstimate(const NodeItem& node, uint64 elapsed_cycles) {
       // N.B. Updates to `cost_estimate` are atomic but unlocked.  Simultaneous
       // updates may result in one or more updates being ignored.  This does not
@@ -220,6 +259,21 @@ class ExecutorImpl : public Executor {
   ImmutableExecutorState immutable_state_;
   KernelStats kernel_stats_;
 
+  // If true, expensive nodes that become ready are pushed to a per-worker
+  // `WorkStealingReadyQueue` instead of being handed directly to the runner.
+  // Controlled by the TF_EXECUTOR_USE_WORK_STEALING environment variable.
+  bool use_work_stealing_ = false;
+
+  // If true, every step serves the host allocations that kernels make with
+  // default attributes from a `StepArenaAllocator`. Controlled by the
+  // TF_EXECUTOR_USE_STEP_ARENA environment variable, and only used for CPU
+  // devices.
+  bool use_step_arena_ = false;
+
+  // NOTE: If the TF_EXECUTOR_USE_STATIC_PLAN environment variable is true and
+  // `immutable_state_.BuildStaticPlan()` succeeds, every step runs the nodes
+  // one at a time in plan order using `StaticPlanPropagatorState`.
+
   TF_DISALLOW_COPY_AND_ASSIGN(ExecutorImpl);
 };
 
@@ -277,7 +331,8 @@ class ExecutorState {
  public:
   ExecutorState(const Executor::Args& args,
                 const ImmutableExecutorState& immutable_state_,
-                ExecutorImpl::KernelStats* kernel_stats_);
+                ExecutorImpl::KernelStats* kernel_stats_,
+                bool use_work_stealing, bool use_step_arena);
   ~ExecutorState();
 
   void RunAsync(Executor::DoneCallback done);
@@ -288,6 +343,7 @@ class ExecutorState {
   typedef
       typename PropagatorStateType::TaggedNodeReadyQueue TaggedNodeReadyQueue;
   typedef typename PropagatorStateType::TaggedNodeSeq TaggedNodeSeq;
+  typedef WorkStealingReadyQueue<TaggedNode> StealingQueue;
 
   struct AsyncState;
 
@@ -329,6 +385,18 @@ class ExecutorState {
   // REQUIRES: `!ready->empty()`.
   void ScheduleReady(TaggedNodeSeq* ready, TaggedNodeReadyQueue* inline_ready);
 
+  // Pushes `tagged_node` to the calling thread's deque in `stealing_queue_`,
+  // and dispatches a closure that will steal and process one node from the
+  // queue if it has not already been drained by its owner.
+  //
+  // REQUIRES: `stealing_queue_ != nullptr`.
+  void PushStealable(const TaggedNode& tagged_node, int64_t scheduled_nsec);
+
+  // Moves the most recently pushed node from the calling thread's deque in
+  // `queue` to `inline_ready`. Returns false if the deque is empty.
+  static bool PopLocalStealable(StealingQueue* queue,
+                                TaggedNodeReadyQueue* inline_ready);
+
   // A wrapper for runner_ to keep track of the pending queue length. Op
   // execution should dispatch work using this function instead of using runner_
   // directly.
@@ -380,6 +448,22 @@ class ExecutorState {
   Executor::Args::Runner runner_;
   bool sync_on_finish_;
   const bool run_all_kernels_inline_;
+  // If not null, receives `compute_time_ns_` when the step finishes.
+  RequestCost* const request_cost_;
+  // The total time spent in the Compute() of synchronous kernels, across all
+  // the threads running the step. Only maintained if `request_cost_` is set.
+  std::atomic<uint64> compute_time_ns_{0};
+
+  // Per-worker deques of ready expensive nodes, or nullptr if work stealing is
+  // disabled. This is a shared pointer because stealing closures may outlive
+  // the ExecutorState: a closure that finds the queue empty must not touch
+  // `this`, which may already have been deleted.
+  std::shared_ptr<StealingQueue> stealing_queue_;
+
+  // Serves the default host allocations of this step's kernels, or nullptr if
+  // the step arena is disabled. Released in the destructor; tensors that
+  // outlive the step keep their part of the arena alive.
+  StepArenaAllocator* step_arena_ = nullptr;
 
   PropagatorStateType propagator_;
 
@@ -401,7 +485,8 @@ class ExecutorState {
 template <class PropagatorStateType>
 ExecutorState<PropagatorStateType>::ExecutorState(
     const Executor::Args& args, const ImmutableExecutorState& immutable_state,
-    ExecutorImpl::KernelStats* kernel_stats)
+    ExecutorImpl::KernelStats* kernel_stats, bool use_work_stealing,
+    bool use_step_arena)
     : vlog_(VLOG_IS_ON(1)),
       log_memory_(LogMemory::IsEnabled()),
       step_id_(args.step_id),
@@ -428,8 +513,19 @@ ExecutorState<PropagatorStateType>::ExecutorState(
       runner_(args.runner),
       sync_on_finish_(args.sync_on_finish),
       run_all_kernels_inline_(args.run_all_kernels_inline),
+      request_cost_(immutable_state.params().device->device_type() ==
+                            DEVICE_CPU
+                        ? args.request_cost
+                        : nullptr),
       propagator_(immutable_state, step_id_, vlog_),
       num_outstanding_ops_(0) {
+  if (use_work_stealing && !run_all_kernels_inline_) {
+    stealing_queue_ = std::make_shared<StealingQueue>(port::MaxParallelism());
+  }
+  if (use_step_arena) {
+    step_arena_ = new StepArenaAllocator(
+        immutable_state_.params().device->GetAllocator(AllocatorAttributes()));
+  }
   if (args.user_intra_op_threadpool != nullptr) {
     Device* device = immutable_state_.params().device;
     user_device_ = RenamedDevice::NewRenamedDevice(
@@ -443,6 +539,9 @@ ExecutorState<PropagatorStateType>::~ExecutorState() {
     device_context_->Unref();
   }
   delete slice_reader_cache_;
+  if (step_arena_ != nullptr) {
+    step_arena_->EndStep();
+  }
 }
 
 template <class PropagatorStateType>
@@ -568,6 +667,8 @@ Status ExecutorState<PropagatorStateType>::ProcessSync(
   Status s;
   OpKernelContext ctx(params, item.num_outputs);
   nodestats::SetOpStart(stats);
+  const uint64 compute_start_ns =
+      request_cost_ != nullptr ? EnvTime::NowNanos() : 0;
 
   OpKernel* op_kernel = item.kernel;
   Device* device = immutable_state_.params().device;
@@ -597,6 +698,10 @@ Status ExecutorState<PropagatorStateType>::ProcessSync(
   } else {
     device->Compute(op_kernel, &ctx);
   }
+  if (request_cost_ != nullptr) {
+    compute_time_ns_.fetch_add(EnvTime::NowNanos() - compute_start_ns,
+                               std::memory_order_relaxed);
+  }
   nodestats::SetOpEnd(stats);
   if (outputs->size() < item.num_outputs) outputs->resize(item.num_outputs);
   s = ProcessOutputs(item, &ctx, outputs->data(), stats);
@@ -730,6 +835,7 @@ void ExecutorState<PropagatorStateType>::Process(TaggedNode tagged_node,
   params.runner = &runner_;
   params.run_all_kernels_inline = run_all_kernels_inline_;
   params.stats_collector = stats_collector_;
+  params.step_allocator = step_arena_;
   params.inc_num_deferred_ops_function = [this]() {
     mutex_lock lock(num_deferred_ops_mu_);
     num_deferred_ops_++;
@@ -757,9 +863,15 @@ void ExecutorState<PropagatorStateType>::Process(TaggedNode tagged_node,
 
   EntryVector outputs(1);
 
+  // Keep the stealing queue alive until we are done draining it, even if
+  // another thread completes the step and deletes `this`.
+  std::shared_ptr<StealingQueue> stealing_queue = stealing_queue_;
+
   bool completed = false;
   inline_ready.push_back(tagged_node);
-  while (!inline_ready.empty()) {
+  while (!inline_ready.empty() ||
+         (stealing_queue != nullptr && !completed &&
+          PopLocalStealable(stealing_queue.get(), &inline_ready))) {
     tagged_node = inline_ready.front();
     inline_ready.pop_front();
     const NodeItem& item = tagged_node.get_node_item();
@@ -1207,8 +1319,12 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
           if (curr_expensive_node) {
             // Dispatch to another thread since there is plenty of work to
             // do for this thread.
-            RunTask(std::bind(&ExecutorState::Process, this,
-                              *curr_expensive_node, scheduled_nsec));
+            if (stealing_queue_) {
+              PushStealable(*curr_expensive_node, scheduled_nsec);
+            } else {
+              RunTask(std::bind(&ExecutorState::Process, this,
+                                *curr_expensive_node, scheduled_nsec));
+            }
           }
           curr_expensive_node = &tagged_node;
         }
@@ -1217,6 +1333,11 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
     if (curr_expensive_node) {
       if (inline_ready->empty()) {
         inline_ready->push_back(*curr_expensive_node);
+      } else if (stealing_queue_) {
+        // There are inline nodes to run already. Keep this expensive node
+        // on this thread's deque, so that we run it ourselves unless another
+        // thread becomes idle first.
+        PushStealable(*curr_expensive_node, scheduled_nsec);
       } else {
         // There are inline nodes to run already. We dispatch this expensive
         // node to other thread.
@@ -1228,6 +1349,32 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
   ready->clear();
 }
 
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::PushStealable(
+    const TaggedNode& tagged_node, int64_t scheduled_nsec) {
+  DCHECK(stealing_queue_ != nullptr);
+  stealing_queue_->PushLocal(tagged_node);
+  // NOTE: The closure may run after the step has completed, if the node it was
+  // dispatched for has already been processed by the thread that pushed it.
+  // It must only touch `this` after successfully stealing a node, since an
+  // unprocessed node keeps the step (and hence `this`) alive.
+  RunTask([this, queue = stealing_queue_, scheduled_nsec]() {
+    absl::optional<TaggedNode> stolen = queue->Steal();
+    if (stolen) {
+      Process(*stolen, scheduled_nsec);
+    }
+  });
+}
+
+template <class PropagatorStateType>
+bool ExecutorState<PropagatorStateType>::PopLocalStealable(
+    StealingQueue* queue, TaggedNodeReadyQueue* inline_ready) {
+  absl::optional<TaggedNode> tagged_node = queue->PopLocal();
+  if (!tagged_node) return false;
+  inline_ready->push_back(*tagged_node);
+  return true;
+}
+
 template <class PropagatorStateType>
 void ExecutorState<PropagatorStateType>::ScheduleFinish() {
   // Checks condition to decide if needs to invoke Finish(). If there are
@@ -1259,6 +1406,13 @@ void ExecutorState<PropagatorStateType>::Finish() {
   CHECK(done_cb != nullptr);
   Device* device = immutable_state_.params().device;
 
+  if (request_cost_ != nullptr) {
+    request_cost_->RecordCost(
+        {{kCpuCostName,
+          absl::Nanoseconds(
+              compute_time_ns_.load(std::memory_order_relaxed))}});
+  }
+
   if (vlog_ && !status.ok() && VLOG_IS_ON(1)) {
     // Logs verbose information about the current state of active and pending
     // nodes in the propagator.
@@ -1364,16 +1518,27 @@ void ExecutorState<PropagatorStateType>::Finish() {
 }
 
 void ExecutorImpl::RunAsync(const Args& args, DoneCallback done) {
-  if (OpOrderDeterminismRequired()) {
-    (new ExecutorState<OrderedPropagatorState>(args, immutable_state_,
-                                               &kernel_stats_))
+  if (immutable_state_.has_static_plan()) {
+    // The static plan runs nodes in a fixed order, so it also satisfies
+    // `OpOrderDeterminismRequired()`.
+    (new ExecutorState<StaticPlanPropagatorState>(
+         args, immutable_state_, &kernel_stats_, /*use_work_stealing=*/false,
+         use_step_arena_))
+        ->RunAsync(std::move(done));
+  } else if (OpOrderDeterminismRequired()) {
+    // Work stealing would change the order in which nodes run.
+    (new ExecutorState<OrderedPropagatorState>(
+         args, immutable_state_, &kernel_stats_, /*use_work_stealing=*/false,
+         use_step_arena_))
         ->RunAsync(std::move(done));
   } else if (immutable_state_.requires_control_flow_support()) {
-    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_))
+    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_,
+                                        use_work_stealing_, use_step_arena_))
         ->RunAsync(std::move(done));
   } else {
-    (new ExecutorState<SimplePropagatorState>(args, immutable_state_,
-                                              &kernel_stats_))
+    (new ExecutorState<SimplePropagatorState>(
+         args, immutable_state_, &kernel_stats_, use_work_stealing_,
+         use_step_arena_))
         ->RunAsync(std::move(done));
   }
 }
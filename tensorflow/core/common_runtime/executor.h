@@ -34,6 +34,7 @@ limitations under the License.
 
 namespace tensorflow {
 
+class RequestCost;
 class StepStatsCollector;
 
 // Executor runs a graph computation.
@@ -107,6 +108,9 @@ class Executor {
     // The deadline for the kernel to complete by. Empty if unspecified.
     absl::optional<absl::Time> deadline;
     absl::optional<ManagedStackTrace> stack_trace = absl::nullopt;
+    // If not null, the time spent computing the synchronous kernels of a CPU
+    // device is recorded into it, under kCpuCostName, when the step finishes.
+    RequestCost* request_cost = nullptr;
 
     // If true, calls Sync() on the device.
     bool sync_on_finish = false;
@@ -29,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/common_runtime/lower_functional_ops.h"
 #include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/common_runtime/request_cost.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/op.h"
@@ -86,11 +87,12 @@ class ExecutorTest : public ::testing::Test {
     runner_ = [this](std::function<void()> fn) { thread_pool_->Schedule(fn); };
   }
 
-  Status Run(Rendezvous* rendez) {
+  Status Run(Rendezvous* rendez, RequestCost* request_cost = nullptr) {
     Executor::Args args;
     args.rendezvous = rendez;
     args.stats_collector = &step_stats_collector_;
     args.runner = runner_;
+    args.request_cost = request_cost;
     return exec_->Run(args);
   }
 
@@ -175,6 +177,35 @@ TEST_F(ExecutorTest, SimpleAdd) {
   EXPECT_EQ(2.0, V(out));  // out = 1.0 + 1.0 = 2.0
 }
 
+TEST_F(ExecutorTest, RecordsRequestCost) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto in0 = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  auto in1 = test::graph::Recv(g.get(), "b", "float", ALICE, 1, BOB);
+  auto tmp = test::graph::Add(g.get(), in0, in1);
+  test::graph::Send(g.get(), tmp, "c", BOB, 1, ALICE);
+  Create(std::move(g));
+  RequestCost request_cost;
+  for (int step = 0; step < 2; ++step) {
+    Rendezvous::Args args;
+    TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args,
+                               V(1.0), false));
+    TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "b"), args,
+                               V(1.0), false));
+    TF_ASSERT_OK(Run(rendez_, &request_cost));
+    Tensor out = V(-1);
+    bool is_dead = false;
+    TF_ASSERT_OK(rendez_->Recv(Key(BOB, kIncarnation, ALICE, "c"), args, &out,
+                               &is_dead));
+    EXPECT_EQ(2.0, V(out));
+  }
+
+  // The costs of both steps are accumulated under a single type.
+  const auto costs = request_cost.GetCosts();
+  ASSERT_EQ(costs.size(), 1);
+  ASSERT_TRUE(costs.contains("cpu"));
+  EXPECT_GT(costs.at("cpu"), absl::ZeroDuration());
+}
+
 TEST_F(ExecutorTest, SelfAdd) {
   // v0 <- a
   // v1 = v0 + v0
@@ -255,6 +286,34 @@ TEST_F(ExecutorTest, RandomTree) {
   EXPECT_EQ(4096.0, V(out));
 }
 
+TEST_F(ExecutorTest, StaticPlan) {
+  // Same as `SelfAdd`, but with a constant input so that the graph can be
+  // frozen into a static execution plan.
+  setenv("TF_EXECUTOR_USE_STATIC_PLAN", "true", /*overwrite=*/1);
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto v = test::graph::Constant(g.get(), V(1.0));
+  auto ctrl = test::graph::NoOp(g.get(), {v});
+  const int N = 10;
+  for (int i = 1; i <= N; ++i) {
+    v = test::graph::Add(g.get(), v, v);
+  }
+  g->AddControlEdge(ctrl, v);
+  test::graph::Send(g.get(), v, "b", BOB, 1, ALICE);
+  Create(std::move(g));
+  unsetenv("TF_EXECUTOR_USE_STATIC_PLAN");
+  for (int iters = 0; iters < 4; ++iters) {
+    Rendezvous* rendez = NewLocalRendezvous();
+    TF_ASSERT_OK(Run(rendez));
+    Rendezvous::Args args;
+    Tensor out = V(-1);
+    bool is_dead = false;
+    TF_ASSERT_OK(
+        rendez->Recv(Key(BOB, kIncarnation, ALICE, "b"), args, &out, &is_dead));
+    EXPECT_EQ(1024.0, V(out));
+    rendez->Unref();
+  }
+}
+
 void BuildConcurrentAddAssign(Graph* g) {
   auto one = test::graph::Constant(g, V(1.0));
   // A variable holds one float.
@@ -329,6 +388,46 @@ TEST_F(ExecutorTest, SimpleSwitchDead) {
   EXPECT_TRUE(is_dead);
 }
 
+// Builds a loop that increments the float received as "a" until it reaches 10,
+// and sends the result as "c".
+static void BuildCountingLoop(Graph* g) {
+  auto in0 = test::graph::Recv(g, "a", "float", ALICE, 1, BOB);
+  auto enter = test::graph::Enter(g, in0, "loop");
+  auto merge = test::graph::Merge(g, enter, {"next_iter"});
+  auto limit = test::graph::Constant(g, V(10.0));
+  g->AddControlEdge(merge, limit);
+  auto one = test::graph::Constant(g, V(1.0));
+  g->AddControlEdge(merge, one);
+  auto cond = test::graph::LoopCond(g, test::graph::Less(g, merge, limit));
+  auto sw = test::graph::Switch(g, merge, cond);
+  auto add = test::graph::Add(g, test::graph::Identity(g, sw, 1), one);
+  test::graph::Next(g, "next_iter", add);
+  test::graph::Send(g, test::graph::Exit(g, sw), "c", BOB, 1, ALICE);
+}
+
+TEST_F(ExecutorTest, LockFreeRootFrame) {
+  // Read when the executor is created.
+  setenv("TF_EXECUTOR_LOCK_FREE_ROOT_FRAME", "true", /*overwrite=*/1);
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  BuildCountingLoop(g.get());
+  Create(std::move(g));
+  unsetenv("TF_EXECUTOR_LOCK_FREE_ROOT_FRAME");
+  for (int iters = 0; iters < 16; ++iters) {
+    Rendezvous* rendez = NewLocalRendezvous();
+    Rendezvous::Args args;
+    TF_ASSERT_OK(rendez->Send(Key(ALICE, kIncarnation, BOB, "a"), args,
+                              V(iters % 10), false));
+    TF_ASSERT_OK(Run(rendez));
+    Tensor out = V(-1);
+    bool is_dead = false;
+    TF_ASSERT_OK(
+        rendez->Recv(Key(BOB, kIncarnation, ALICE, "c"), args, &out, &is_dead));
+    EXPECT_EQ(10.0, V(out));
+    EXPECT_FALSE(is_dead);
+    rendez->Unref();
+  }
+}
+
 TEST_F(ExecutorTest, Abort) {
   // e = a + b + c + d
   auto g = std::make_unique<Graph>(OpRegistry::Global());
@@ -164,14 +164,33 @@ GpuCudaMallocAsyncAllocator::GpuCudaMallocAsyncAllocator(
            "old, "
         << " OS not supported, CUDA version too old(request CUDA11.2+).";
 
-  if (auto status =
-          cuDeviceGetDefaultMemPool(&pool_, platform_device_id.value()))
+  // By default all the allocators of a GPU share its default pool, even when
+  // they serve different streams (e.g. for virtual devices). If
+  // TF_CUDA_MALLOC_ASYNC_PER_STREAM_POOL is set, give this allocator, and so
+  // its stream, a pool of its own. Like the allocator, the pool is never
+  // destroyed.
+  bool per_stream_pool = false;
+  TF_CHECK_OK(tensorflow::ReadBoolFromEnvVar(
+      "TF_CUDA_MALLOC_ASYNC_PER_STREAM_POOL", /*default_val=*/false,
+      &per_stream_pool));
+  if (per_stream_pool) {
+    CUmemPoolProps pool_props = {};
+    pool_props.allocType = CU_MEM_ALLOCATION_TYPE_PINNED;
+    pool_props.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    pool_props.location.id = platform_device_id.value();
+    if (auto status = cuMemPoolCreate(&pool_, &pool_props))
+      LOG(FATAL) <<  // Crash OK.
+          "Failed to create CUDA pool: " << GetCudaErrorMessage(status);
+  } else if (auto status = cuDeviceGetDefaultMemPool(
+                 &pool_, platform_device_id.value())) {
     LOG(FATAL) <<  // Crash OK.
         "Failed to get default CUDA pool: " << GetCudaErrorMessage(status);
+  }
 
   VLOG(1) << Name() << " CudaMallocAsync initialized on platform: "
-          << platform_device_id.value() << " with pool size of: " << pool_size
-          << " this ptr: " << this;
+          << platform_device_id.value() << " with "
+          << (per_stream_pool ? "a per-stream" : "the default")
+          << " pool, pool size of: " << pool_size << " this ptr: " << this;
   uint64_t pool_size_64 = pool_size;
   if (auto status = cuMemPoolSetAttribute(
           pool_, CU_MEMPOOL_ATTR_RELEASE_THRESHOLD, &pool_size_64))
@@ -59,6 +59,11 @@ namespace tensorflow {
 // would have allocated. This is useful when benchmarking as it doesn't
 // change when driver allocations are done.
 //
+// All the allocators of a GPU share its default CUDA pool. Set the
+// environment variable `TF_CUDA_MALLOC_ASYNC_PER_STREAM_POOL=true` to give
+// each allocator, and so each stream (e.g. of a virtual device), its own pool
+// instead, so that the pools' release thresholds and reuse do not interfere.
+//
 // Here, the pool_size isn't the absolute max as for [Gpu]BFCAllocator.
 // The pool can grow above that up to the total GPU memory.  But the
 // driver can return the excess memory to other processes.
@@ -108,7 +113,8 @@ class GpuCudaMallocAsyncAllocator : public Allocator {
   // Not owned.
   CUstream cuda_stream_;
 
-  // Not owned. The default pool of the associated GPU.
+  // The default pool of the associated GPU (not owned), or the pool created
+  // for this allocator with TF_CUDA_MALLOC_ASYNC_PER_STREAM_POOL.
   // If null, then the instanciation failed and the first allocation
   // will return an error.
   CUmemoryPool pool_;
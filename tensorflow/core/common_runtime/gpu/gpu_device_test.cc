@@ -202,6 +202,31 @@ TEST_F(GPUDeviceTest, DISABLED_ON_GPU_ROCM(CudaMallocAsyncPreallocate)) {
   EXPECT_EQ(status.code(), error::OK);
 }
 
+TEST_F(GPUDeviceTest, DISABLED_ON_GPU_ROCM(CudaMallocAsyncPerStreamPool)) {
+  // Two virtual devices on the same GPU, each with its own stream and pool.
+  SessionOptions opts = MakeSessionOptions("0", 0, 1, {{64, 64}}, {}, {},
+                                           /*use_cuda_malloc_async=*/true);
+  setenv("TF_CUDA_MALLOC_ASYNC_PER_STREAM_POOL", "true", 1);
+  std::vector<std::unique_ptr<Device>> devices;
+  Status status = DeviceFactory::GetFactory("GPU")->CreateDevices(
+      opts, kDeviceNamePrefix, &devices);
+  unsetenv("TF_CUDA_MALLOC_ASYNC_PER_STREAM_POOL");
+  TF_ASSERT_OK(status);
+  ASSERT_THAT(devices, SizeIs(2));
+
+  AllocatorAttributes allocator_attributes = AllocatorAttributes();
+  allocator_attributes.set_gpu_compatible(true);
+  Allocator* allocator0 = devices[0]->GetAllocator(allocator_attributes);
+  Allocator* allocator1 = devices[1]->GetAllocator(allocator_attributes);
+  EXPECT_NE(allocator0, allocator1);
+  void* ptr0 = allocator0->AllocateRaw(Allocator::kAllocatorAlignment, 1024);
+  void* ptr1 = allocator1->AllocateRaw(Allocator::kAllocatorAlignment, 1024);
+  EXPECT_NE(ptr0, nullptr);
+  EXPECT_NE(ptr1, nullptr);
+  allocator0->DeallocateRaw(ptr0);
+  allocator1->DeallocateRaw(ptr1);
+}
+
 TEST_F(GPUDeviceTest, FailedToParseVisibleDeviceList) {
   SessionOptions opts = MakeSessionOptions("0,abc");
   std::vector<std::unique_ptr<Device>> devices;
@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
 #include "tensorflow/core/common_runtime/gpu_device_context.h"
+#include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_reference.h"
@@ -362,14 +363,30 @@ void GPUUtil::CopyCPUTensorToGPU(const Tensor* cpu_tensor,
     if (do_staging) {
       staging_buffer = host_memory_allocator->AllocateRaw(
           tensorflow::Allocator::kAllocatorAlignment, total_bytes);
+      if (staging_buffer == nullptr) {
+        LOG_FIRST_N(WARNING, 1)
+            << "Failed to allocate " << total_bytes
+            << " bytes from the host memory allocator to stage data for "
+               "CPU->GPU transfer. Copying from pageable memory instead.";
+        do_staging = false;
+      }
+    }
+
+    if (do_staging) {
       std::memcpy(staging_buffer, src_ptr, total_bytes);
       input_ref.Unref();
 
       recv_host_to_device_stream->ThenMemcpy(&gpu_dst_ptr, staging_buffer,
                                              total_bytes);
+      metrics::RecordHostToDeviceCopy(metrics::HostToDeviceCopySource::kStaged,
+                                      total_bytes);
     } else {
       recv_host_to_device_stream->ThenMemcpy(&gpu_dst_ptr, src_ptr,
                                              total_bytes);
+      metrics::RecordHostToDeviceCopy(
+          NeedStaging(cpu_tensor) ? metrics::HostToDeviceCopySource::kPageable
+                                  : metrics::HostToDeviceCopySource::kPinned,
+          total_bytes);
     }
   }
 
@@ -0,0 +1,296 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/hierarchical_reducer.h"
+
+#include <utility>
+
+#include "tensorflow/core/common_runtime/collective_rma_local.h"
+#include "tensorflow/core/common_runtime/collective_util.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/device_base.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/profiler/lib/traceme.h"
+
+namespace tensorflow {
+
+Status HierarchicalReducer::InitializeCollectiveParams(
+    CollectiveParams* col_params) {
+  if (col_params->instance.type != REDUCTION_COLLECTIVE) {
+    return errors::Internal("HierarchicalReducer only supports reductions, got",
+                            " collective type ", col_params->instance.type);
+  }
+  return OkStatus();
+}
+
+Status HierarchicalReducer::InitializeCollectiveContext(
+    std::shared_ptr<CollectiveContext> col_ctx) {
+  DCHECK(col_ctx->dev_mgr);
+  col_ctx_ = col_ctx;
+  col_params_ = col_ctx->col_params.get();
+  rank_ = col_params_->default_rank;
+  const auto& members = col_params_->group.members;
+  if (rank_ < 0 || rank_ >= members.size()) {
+    return errors::Internal("Invalid rank ", rank_, " in a group of ",
+                            members.size(), " devices");
+  }
+  task_ranks_.clear();
+  leader_ranks_.clear();
+  for (int r = 0; r < members.size(); ++r) {
+    if (members[r].task == members[rank_].task) {
+      task_ranks_.push_back(r);
+    }
+    bool is_leader = true;
+    for (int l : leader_ranks_) {
+      if (members[l].task == members[r].task) {
+        is_leader = false;
+        break;
+      }
+    }
+    if (is_leader) {
+      leader_ranks_.push_back(r);
+    }
+  }
+  return collective_util::InitializeDeviceAndLocality(
+      col_ctx->dev_mgr, col_ctx->device_name, &col_ctx->device,
+      &col_ctx->device_locality);
+}
+
+void HierarchicalReducer::Run(StatusCallback done) {
+  CHECK(col_ctx_);
+  CHECK(col_params_);
+  // Like `RingReducer`, this doesn't require non-overlapping collectives.
+  col_ctx_->col_exec->UnblockDependencies(*col_params_);
+
+  Status status;
+  // Start by copying input to output if they're not already the same, i.e. if
+  // we're not computing in-place on the input tensor.
+  if ((col_ctx_->input != col_ctx_->output) &&
+      (DMAHelper::base(col_ctx_->input) != DMAHelper::base(col_ctx_->output))) {
+    Notification note;
+    profiler::TraceMe activity("MemCpyAsync", profiler::TraceMeLevel::kInfo);
+    CollectiveRemoteAccessLocal::MemCpyAsync(
+        col_ctx_->op_ctx->op_device_context(),
+        col_ctx_->op_ctx->op_device_context(), col_ctx_->device,
+        col_ctx_->device, col_ctx_->op_ctx->input_alloc_attr(0),
+        col_ctx_->op_ctx->output_alloc_attr(0), col_ctx_->input,
+        col_ctx_->output, 0 /*dev_to_dev_stream_index*/,
+        [&note, &status](const Status& s) {
+          status.Update(s);
+          note.Notify();
+        });
+    note.WaitForNotification();
+    if (!status.ok()) {
+      done(status);
+      return;
+    }
+  }
+
+  const bool is_leader = task_ranks_[0] == rank_;
+  status = ReduceWithinTask();
+  if (status.ok() && is_leader) {
+    status = ReduceAcrossTasks();
+  }
+  if (status.ok() && is_leader) {
+    status = Finalize();
+  }
+  if (status.ok()) {
+    status = BroadcastWithinTask();
+  }
+  if (!status.ok()) {
+    StartAbort(status);
+  }
+  done(status);
+}
+
+Status HierarchicalReducer::ReduceWithinTask() {
+  profiler::TraceMe activity("ReduceWithinTask", profiler::TraceMeLevel::kInfo);
+  Tensor* output = col_ctx_->output;
+  if (task_ranks_[0] != rank_) {
+    return Send(task_ranks_[0], BufKey("gather", 0, rank_), output);
+  }
+  if (task_ranks_.size() == 1) {
+    return OkStatus();
+  }
+  // The tensors are received one at a time into the same buffer, since they
+  // can only be reduced one after the other anyway.
+  Tensor tmp(col_ctx_->device->GetAllocator(
+                 col_ctx_->op_ctx->output_alloc_attr(0)),
+             output->dtype(), output->shape());
+  for (int i = 1; i < task_ranks_.size(); ++i) {
+    const int src_rank = task_ranks_[i];
+    TF_RETURN_IF_ERROR(Recv(src_rank, BufKey("gather", 0, src_rank), &tmp));
+    TF_RETURN_IF_ERROR(ComputeBinOp(col_params_->merge_op, output, &tmp));
+  }
+  return OkStatus();
+}
+
+Status HierarchicalReducer::ReduceAcrossTasks() {
+  profiler::TraceMe activity("ReduceAcrossTasks",
+                             profiler::TraceMeLevel::kInfo);
+  const int num_leaders = leader_ranks_.size();
+  if (num_leaders == 1) {
+    return OkStatus();
+  }
+  int t = 0;
+  while (leader_ranks_[t] != rank_) ++t;
+  const int next_rank = leader_ranks_[(t + 1) % num_leaders];
+  const int prev_rank = leader_ranks_[(t + num_leaders - 1) % num_leaders];
+
+  AllocatorAttributes attr = col_ctx_->op_ctx->output_alloc_attr(0);
+  std::unique_ptr<CollectiveAdapter> ca(MakeCollectiveAdapter(
+      col_ctx_->output, num_leaders, col_ctx_->device->GetAllocator(attr)));
+  // Reduce-scatter: in step s leader t sends its partial sum of chunk t - s
+  // and reduces the partial sum of chunk t - s - 1 it receives, so that after
+  // num_leaders - 1 steps it holds the complete sum of chunk t + 1.
+  for (int s = 0; s < num_leaders - 1; ++s) {
+    Tensor send_chunk = ca->ChunkAlias((t - s + num_leaders) % num_leaders);
+    const int recv_idx = (t - s - 1 + 2 * num_leaders) % num_leaders;
+    Tensor recv_chunk = ca->ChunkAlias(recv_idx);
+    Tensor tmp_chunk = ca->TempChunk(recv_idx);
+    TF_RETURN_IF_ERROR(Exchange(next_rank, BufKey("scatter", s, rank_),
+                                &send_chunk, prev_rank,
+                                BufKey("scatter", s, prev_rank), &tmp_chunk));
+    TF_RETURN_IF_ERROR(
+        ComputeBinOp(col_params_->merge_op, &recv_chunk, &tmp_chunk));
+  }
+  // All-gather: in step s leader t forwards the complete chunk t + 1 - s and
+  // receives the complete chunk t - s in place.
+  for (int s = 0; s < num_leaders - 1; ++s) {
+    Tensor send_chunk = ca->ChunkAlias((t + 1 - s + num_leaders) % num_leaders);
+    Tensor recv_chunk = ca->ChunkAlias((t - s + num_leaders) % num_leaders);
+    TF_RETURN_IF_ERROR(
+        Exchange(next_rank, BufKey("allgather", s, rank_), &send_chunk,
+                 prev_rank, BufKey("allgather", s, prev_rank), &recv_chunk));
+  }
+  ca->ConsumeFinalValue(col_ctx_->output);
+  return OkStatus();
+}
+
+Status HierarchicalReducer::Finalize() {
+  if (col_params_->final_op == nullptr) {
+    return OkStatus();
+  }
+  AllocatorAttributes attr = col_ctx_->op_ctx->output_alloc_attr(0);
+  std::unique_ptr<CollectiveAdapter> ca(MakeCollectiveAdapter(
+      col_ctx_->output, 1, col_ctx_->device->GetAllocator(attr)));
+  Tensor group_size = ca->Scalar(col_params_->group.group_size);
+  if (col_params_->group.device_type != "CPU") {
+    Tensor host_group_size = group_size;
+    group_size = ca->Scalar(col_ctx_->device->GetAllocator(attr),
+                            AllocationAttributes());
+    Notification note;
+    Status status;
+    col_ctx_->op_ctx->op_device_context()->CopyCPUTensorToDevice(
+        &host_group_size, col_ctx_->device, &group_size,
+        [&note, &status](const Status& s) {
+          status.Update(s);
+          note.Notify();
+        });
+    note.WaitForNotification();
+    TF_RETURN_IF_ERROR(status);
+  }
+  return ComputeBinOp(col_params_->final_op, col_ctx_->output, &group_size);
+}
+
+Status HierarchicalReducer::BroadcastWithinTask() {
+  profiler::TraceMe activity("BroadcastWithinTask",
+                             profiler::TraceMeLevel::kInfo);
+  if (task_ranks_[0] != rank_) {
+    return Recv(task_ranks_[0], BufKey("bcast", 0, rank_), col_ctx_->output);
+  }
+  for (int i = 1; i < task_ranks_.size(); ++i) {
+    TF_RETURN_IF_ERROR(Send(task_ranks_[i], BufKey("bcast", 0, task_ranks_[i]),
+                            col_ctx_->output));
+  }
+  return OkStatus();
+}
+
+Status HierarchicalReducer::Exchange(int send_to_rank, const string& send_key,
+                                     const Tensor* send_tensor,
+                                     int recv_from_rank, const string& recv_key,
+                                     Tensor* recv_tensor) {
+  const auto& members = col_params_->group.members;
+  mutex mu;
+  Status status;
+  int pending = (send_to_rank >= 0) + (recv_from_rank >= 0);
+  Notification note;
+  auto done = [&mu, &status, &pending, &note](const Status& s) {
+    mutex_lock l(mu);
+    status.Update(s);
+    if (--pending == 0) note.Notify();
+  };
+  VLOG(3) << "HierarchicalReducer rank " << rank_ << " send " << send_key
+          << " to " << send_to_rank << " recv " << recv_key << " from "
+          << recv_from_rank;
+  if (send_to_rank >= 0) {
+    col_ctx_->col_exec->remote_access()->PostToPeer(
+        members[send_to_rank].device.name(), members[send_to_rank].task,
+        send_key, col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
+        col_ctx_->op_ctx->output_alloc_attr(0), send_tensor,
+        col_ctx_->device_locality, col_ctx_->op_ctx->cancellation_manager(),
+        done);
+  }
+  if (recv_from_rank >= 0) {
+    col_ctx_->col_exec->remote_access()->RecvFromPeer(
+        members[recv_from_rank].device.name(), members[recv_from_rank].task,
+        members[recv_from_rank].is_local, recv_key, col_ctx_->device,
+        col_ctx_->op_ctx->op_device_context(),
+        col_ctx_->op_ctx->output_alloc_attr(0), recv_tensor,
+        col_ctx_->device_locality, 0 /*dev_to_dev_stream_index*/,
+        col_ctx_->op_ctx->cancellation_manager(), done);
+  }
+  note.WaitForNotification();
+  mutex_lock l(mu);
+  return status;
+}
+
+Status HierarchicalReducer::ComputeBinOp(OpKernel* op, Tensor* output,
+                                         Tensor* input) {
+  return collective_util::ComputeBinOp(col_ctx_->op_ctx, col_ctx_->op_params,
+                                       col_ctx_->device, op, output, input);
+}
+
+// Every transfer is identified by its phase, its step within the phase and a
+// rank that is unique among the transfers of that step: the sender for the
+// phases with one sender per receiver, and the receiver for the broadcast.
+string HierarchicalReducer::BufKey(const string& phase, int step,
+                                   int rank) const {
+  return strings::StrCat(col_ctx_->exec_key, ":hier:", phase, ":", step, ":",
+                         rank);
+}
+
+void HierarchicalReducer::StartAbort(const Status& s) {
+  LOG(ERROR) << "Aborting HierarchicalReduce with " << s;
+  // Abort the outstanding transfers of the other devices, unless this is a
+  // cancellation, which already cancels them.
+  if (col_ctx_->op_ctx->cancellation_manager() == nullptr ||
+      (!col_ctx_->op_ctx->cancellation_manager()->IsCancelled() &&
+       !col_ctx_->op_ctx->cancellation_manager()->IsCancelling())) {
+    col_ctx_->col_exec->StartAbort(s);
+  }
+}
+
+namespace {
+REGISTER_COLLECTIVE(HierarchicalReduce, HierarchicalReducer);
+}  // namespace
+
+}  // namespace tensorflow
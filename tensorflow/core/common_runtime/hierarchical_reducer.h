@@ -0,0 +1,90 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_REDUCER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_REDUCER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/base_collective_executor.h"
+#include "tensorflow/core/framework/collective.h"
+
+namespace tensorflow {
+class Device;
+
+// Two level implementation of collective all-reduce. The devices of each task
+// first reduce their tensors onto the first device of the task, the task
+// leader. The leaders then all-reduce the partial results with a ring
+// algorithm, and each leader finally sends the result back to the other
+// devices of its task. Only the leaders exchange data across tasks, and they
+// exchange a single tensor per task instead of one per device, which is
+// cheaper than a flat ring when the links between tasks are much slower than
+// those within a task.
+//
+// Selected by the "hierarchical" communication hint.
+class HierarchicalReducer : public CollectiveImplementationInterface {
+ public:
+  HierarchicalReducer() = default;
+  ~HierarchicalReducer() override = default;
+
+  Status InitializeCollectiveParams(CollectiveParams* col_params) override;
+
+  Status InitializeCollectiveContext(
+      std::shared_ptr<CollectiveContext> col_ctx) override;
+
+  // Runs the three phases of the reduction, blocking on each transfer.
+  // Must be called in a blockable thread.
+  void Run(StatusCallback done) override;
+
+ private:
+  // Reduces the tensors of the other devices of this task into the output.
+  Status ReduceWithinTask();
+  // All-reduces the output of the task leaders with a ring over the leaders.
+  Status ReduceAcrossTasks();
+  // Applies the final op, if any, to the output of a task leader.
+  Status Finalize();
+  // Exchanges the result between the leader and the devices of its task.
+  Status BroadcastWithinTask();
+
+  // Blocking wrappers of CollectiveRemoteAccess::PostToPeer/RecvFromPeer.
+  // Both may be given at once, in which case they run concurrently; the
+  // ranks of the unused ones must be -1.
+  Status Exchange(int send_to_rank, const string& send_key,
+                  const Tensor* send_tensor, int recv_from_rank,
+                  const string& recv_key, Tensor* recv_tensor);
+  Status Send(int rank, const string& key, const Tensor* tensor) {
+    return Exchange(rank, key, tensor, -1, "", nullptr);
+  }
+  Status Recv(int rank, const string& key, Tensor* tensor) {
+    return Exchange(-1, "", nullptr, rank, key, tensor);
+  }
+
+  Status ComputeBinOp(OpKernel* op, Tensor* output, Tensor* input);
+  string BufKey(const string& phase, int step, int source_rank) const;
+  void StartAbort(const Status& s);
+
+  std::shared_ptr<CollectiveContext> col_ctx_;
+  const CollectiveParams* col_params_;  // Not owned
+  int rank_ = -1;
+  // The ranks of the devices of this task, starting with its leader.
+  std::vector<int> task_ranks_;
+  // The ranks of the task leaders, in the order of the first appearance of
+  // their task in the group.
+  std::vector<int> leader_ranks_;
+};
+
+}  // namespace tensorflow
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_REDUCER_H_
@@ -0,0 +1,144 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/hierarchical_reducer.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/collective_test_util.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/public/version.h"
+
+namespace tensorflow {
+namespace {
+
+std::unique_ptr<OpKernel> GetBinaryKernel(const string& op, DataType dtype,
+                                          const DeviceType& device_type,
+                                          DeviceBase* device) {
+  NodeDef node_def;
+  TF_CHECK_OK(NodeDefBuilder(strings::StrCat(op, "_node"), op)
+                  .Attr("T", dtype)
+                  .Input(FakeInput(dtype))
+                  .Input(FakeInput(dtype))
+                  .Finalize(&node_def));
+  Status status;
+  std::unique_ptr<OpKernel> k = CreateOpKernel(
+      device_type, device, device->GetAllocator(AllocatorAttributes()),
+      node_def, TF_GRAPH_DEF_VERSION, &status);
+  TF_CHECK_OK(status);
+  return k;
+}
+
+class HierarchicalReducerTest : public ::testing::Test {
+ protected:
+  struct DeviceInstance {
+    Tensor tensor;
+    Device* device;
+    core::RefCountPtr<CollectiveParams> col_params;
+    std::unique_ptr<OpKernel> merge_op;
+    std::unique_ptr<OpKernel> final_op;
+    Status status;
+  };
+
+  // Reduces a float tensor of `tensor_len` elements over
+  // `num_workers` * `num_devices` devices and checks that every device gets
+  // the mean of the inputs.
+  void RunTest(int num_workers, int num_devices, int tensor_len,
+               int fail_after) {
+    test_env_ = CreateCollectiveTestEnv(num_workers, num_devices, DEVICE_CPU);
+    test_env_->remote_access->set_fail_after(fail_after);
+    const int group_size = num_workers * num_devices;
+    std::vector<float> expected(tensor_len, 0.0f);
+    std::vector<std::unique_ptr<DeviceInstance>> instances;
+    for (int rank = 0; rank < group_size; ++rank) {
+      auto instance = std::make_unique<DeviceInstance>();
+      instance->col_params = CreateCollectiveParams(
+          *test_env_, rank, "HierarchicalReduce", REDUCTION_COLLECTIVE,
+          DT_FLOAT, TensorShape({tensor_len}));
+      TF_CHECK_OK(test_env_->device_mgr->LookupDevice(
+          instance->col_params->group.members[rank].device.name(),
+          &instance->device));
+      instance->merge_op =
+          GetBinaryKernel("Add", DT_FLOAT, DEVICE_CPU, instance->device);
+      instance->final_op =
+          GetBinaryKernel("Div", DT_FLOAT, DEVICE_CPU, instance->device);
+      instance->col_params->merge_op = instance->merge_op.get();
+      instance->col_params->final_op = instance->final_op.get();
+      instance->tensor = Tensor(DT_FLOAT, TensorShape({tensor_len}));
+      for (int i = 0; i < tensor_len; ++i) {
+        const float value = rank * 10 + i;
+        instance->tensor.flat<float>()(i) = value;
+        expected[i] += value / group_size;
+      }
+      instances.push_back(std::move(instance));
+    }
+
+    std::atomic<int> done(0);
+    for (auto& instance : instances) {
+      SchedClosure([this, &instance, &done] {
+        instance->status =
+            RunCollective(test_env_.get(), instance->col_params.get(),
+                          instance->device, &instance->tensor,
+                          &instance->tensor);
+        ++done;
+      });
+    }
+    while (done < group_size) {
+      Env::Default()->SleepForMicroseconds(1000);
+    }
+
+    for (auto& instance : instances) {
+      if (fail_after > 0) {
+        EXPECT_NE(instance->status.error_message().find("Deliberate failure"),
+                  string::npos);
+      } else {
+        TF_EXPECT_OK(instance->status);
+        test::ExpectTensorNear<float>(test::AsTensor<float>(expected),
+                                      instance->tensor, 1e-4);
+      }
+    }
+  }
+
+  std::unique_ptr<CollectiveTestEnv> test_env_;
+};
+
+TEST_F(HierarchicalReducerTest, SingleTask) { RunTest(1, 4, 1001, 0); }
+
+TEST_F(HierarchicalReducerTest, OneDevicePerTask) { RunTest(3, 1, 1001, 0); }
+
+TEST_F(HierarchicalReducerTest, SeveralTasks) { RunTest(3, 4, 1001, 0); }
+
+TEST_F(HierarchicalReducerTest, FewerElementsThanTasks) {
+  RunTest(4, 2, 3, 0);
+}
+
+TEST_F(HierarchicalReducerTest, Failure) { RunTest(2, 3, 1001, 5); }
+
+}  // namespace
+}  // namespace tensorflow
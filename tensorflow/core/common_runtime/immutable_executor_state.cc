@@ -350,6 +350,38 @@ Status ImmutableExecutorState::BuildControlFlowInfo(const Graph* g,
   return OkStatus();
 }
 
+bool ImmutableExecutorState::BuildStaticPlan() {
+  if (has_static_plan_) return true;
+  if (requires_control_flow_) return false;
+  const int num_nodes = gview_.num_nodes();
+  for (int32_t id = 0; id < num_nodes; ++id) {
+    const NodeItem* item = gview_.node(id);
+    if (item && item->kernel_is_async) return false;
+  }
+
+  // Kahn's algorithm, seeded with the root nodes, so that nodes are visited
+  // in the same order that they would become ready in a sequential run.
+  std::vector<int32> pending(num_nodes);
+  for (int32_t id = 0; id < num_nodes; ++id) {
+    pending[id] = atomic_pending_counts_[id].load(std::memory_order_relaxed);
+  }
+  std::vector<const NodeItem*> plan(root_nodes_.begin(), root_nodes_.end());
+  plan.reserve(num_nodes);
+  for (size_t i = 0; i < plan.size(); ++i) {
+    const NodeItem* item = plan[i];
+    for (const EdgeInfo& e : item->output_edges()) {
+      if (--pending[e.dst_id] == 0) plan.push_back(&gview_.node_ref(e.dst_id));
+    }
+    for (const ControlEdgeInfo& e : item->output_control_edges()) {
+      if (--pending[e.dst_id] == 0) plan.push_back(&gview_.node_ref(e.dst_id));
+    }
+  }
+
+  static_plan_ = std::move(plan);
+  has_static_plan_ = true;
+  return true;
+}
+
 void ImmutableExecutorState::InitializePending(const Graph* graph,
                                                const ControlFlowInfo& cf_info) {
   for (auto& it : cf_info.unique_frame_names) {
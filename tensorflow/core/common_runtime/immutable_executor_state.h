@@ -101,6 +101,34 @@ class ImmutableExecutorState {
 
   bool requires_control_flow_support() const { return requires_control_flow_; }
 
+  // Computes a static execution plan for this graph: a topological order of
+  // its nodes that respects both data and control edges, which can be used to
+  // run the graph one node at a time without tracking pending counts (see
+  // `StaticPlanPropagatorState`).
+  //
+  // A plan is only built for graphs that do not require control flow support
+  // and do not contain asynchronous kernels, because running an asynchronous
+  // kernel (e.g. a `_Recv`) in a fixed order relative to unrelated nodes could
+  // deadlock. Returns true if a plan was built.
+  //
+  // REQUIRES: `Initialize()` has returned OK.
+  bool BuildStaticPlan();
+
+  bool has_static_plan() const { return has_static_plan_; }
+
+  // REQUIRES: `has_static_plan()`.
+  const std::vector<const NodeItem*>& static_plan() const {
+    DCHECK(has_static_plan_);
+    return static_plan_;
+  }
+
+  // If true, `PropagatorState` propagates the outputs of simple nodes in the
+  // root frame with atomic operations only, without acquiring the frame lock.
+  bool lock_free_root_frame() const { return lock_free_root_frame_; }
+  void set_lock_free_root_frame(bool lock_free_root_frame) {
+    lock_free_root_frame_ = lock_free_root_frame;
+  }
+
   // Copies the pending counts for nodes in this graph to the given array.
   //
   // This method provides a more efficient way of initializing
@@ -155,6 +183,12 @@ class ImmutableExecutorState {
   // Shallow copies of the constant tensors used in the graph.
   std::vector<Tensor> const_tensors_;
 
+  // If `has_static_plan_` is true, the nodes of the graph in execution order.
+  bool has_static_plan_ = false;
+  std::vector<const NodeItem*> static_plan_;
+
+  bool lock_free_root_frame_ = false;
+
   TF_DISALLOW_COPY_AND_ASSIGN(ImmutableExecutorState);
 };
 
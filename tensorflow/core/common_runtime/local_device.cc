@@ -86,6 +86,9 @@ struct LocalDevice::EigenThreadPoolInfo {
     }
     ThreadOptions thread_opts;
     thread_opts.numa_node = numa_node;
+    const auto& cpu_affinity =
+        options.config.experimental().intra_op_thread_cpu_affinity();
+    thread_opts.cpu_affinity.assign(cpu_affinity.begin(), cpu_affinity.end());
     eigen_worker_threads_.num_threads = intra_op_parallelism_threads;
     eigen_worker_threads_.workers = new thread::ThreadPool(
         options.env, thread_opts, strings::StrCat("numa_", numa_node, "_Eigen"),
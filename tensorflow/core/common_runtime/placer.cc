@@ -27,8 +27,11 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/graph/graph_node_util.h"
+#include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/util/device_name_utils.h"
 #include "tensorflow/core/util/dump_graph.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/port.h"
 
 namespace tensorflow {
@@ -127,6 +130,46 @@ void LogDeviceAssignment(const Node* node, bool log_device_placement) {
   }
 }
 
+// The estimated size of the tensors whose shape is not known.
+constexpr int64_t kUnknownTensorBytes = 1 << 10;
+
+// Returns the estimated size of the tensor sent along `edge`, from the
+// "_output_shapes" of its source if they are known.
+int64_t EstimateEdgeBytes(const Edge* edge) {
+  const Node* src = edge->src();
+  const DataType dtype = src->output_type(edge->src_output());
+  const int64_t element_size = DataTypeSize(BaseType(dtype));
+  std::vector<PartialTensorShape> shapes;
+  if (element_size > 0 &&
+      GetNodeAttr(src->attrs(), "_output_shapes", &shapes).ok() &&
+      edge->src_output() < static_cast<int>(shapes.size()) &&
+      shapes[edge->src_output()].IsFullyDefined()) {
+    return shapes[edge->src_output()].num_elements() * element_size;
+  }
+  return kUnknownTensorBytes;
+}
+
+// Returns the relative cost of sending `bytes` from `src` to `dst`. Copies
+// between devices of the same task are cheaper than copies between tasks,
+// and copies along a direct link between the devices, e.g. between GPUs
+// with peer access, are cheaper than those that go through the host.
+int64_t TransferCost(const Device* src, const Device* dst, int64_t bytes) {
+  if (src == dst) return 0;
+  if (!DeviceNameUtils::IsSameAddressSpace(src->parsed_name(),
+                                           dst->parsed_name())) {
+    return 8 * bytes;
+  }
+  if (src->device_type() == dst->device_type()) {
+    for (const InterconnectLink& link :
+         dst->attributes().locality().links().link()) {
+      if (link.device_id() == src->parsed_name().id && link.strength() > 0) {
+        return bytes;
+      }
+    }
+  }
+  return 2 * bytes;
+}
+
 Status AssignAndLog(int assigned_device, Node* node,
                     ColocationGraph* colocation_graph,
                     bool log_device_placement) {
@@ -151,7 +194,10 @@ Placer::Placer(Graph* graph, const string& function_name,
       devices_(devices),
       default_local_device_(default_local_device),
       allow_soft_placement_(allow_soft_placement),
-      log_device_placement_(log_device_placement) {}
+      log_device_placement_(log_device_placement) {
+  TF_CHECK_OK(ReadBoolFromEnvVar("TF_PLACER_MINIMIZE_TRANSFERS",
+                                 /*default_val=*/false, &minimize_transfers_));
+}
 
 Placer::Placer(Graph* graph, const string& function_name,
                const FunctionLibraryDefinition* flib_def,
@@ -250,6 +296,16 @@ Status Placer::Run() {
       }
     }
 
+    // Heuristic C: If enabled, place a node that has no requested device on
+    // the device that minimizes the cost of copying its inputs.
+    if (assigned_device == -1 && minimize_transfers_ &&
+        node->requested_device().empty()) {
+      const Device* device = DeviceWithCheapestInputs(*node, *devices);
+      if (device != nullptr) {
+        assigned_device = graph_->InternDeviceName(device->name());
+      }
+    }
+
     // Provide the default, if necessary.
     if (assigned_device == -1) {
       assigned_device = graph_->InternDeviceName((*devices)[0]->name());
@@ -306,6 +362,37 @@ Status Placer::Run() {
   return OkStatus();
 }
 
+const Device* Placer::DeviceWithCheapestInputs(
+    const Node& node, const std::vector<Device*>& devices) const {
+  // The estimated bytes of the inputs that come from each device.
+  std::vector<std::pair<const Device*, int64_t>> inputs;
+  for (const Edge* edge : node.in_edges()) {
+    if (edge->IsControlEdge()) continue;
+    const Device* src =
+        devices_->FindDeviceByName(edge->src()->assigned_device_name());
+    if (src == nullptr) continue;
+    inputs.emplace_back(src, EstimateEdgeBytes(edge));
+  }
+  if (inputs.empty()) return nullptr;
+
+  // Only the devices of the preferred type are considered, since moving a
+  // node to a device of another type could make it much slower.
+  const Device* best = nullptr;
+  int64_t best_cost = 0;
+  for (const Device* device : devices) {
+    if (device->device_type() != devices[0]->device_type()) continue;
+    int64_t cost = 0;
+    for (const auto& input : inputs) {
+      cost += TransferCost(input.first, device, input.second);
+    }
+    if (best == nullptr || cost < best_cost) {
+      best = device;
+      best_cost = cost;
+    }
+  }
+  return best;
+}
+
 bool Placer::CanAssignToDevice(const string& candidate_device_name,
                                const std::vector<Device*>& devices) const {
   if (!candidate_device_name.empty()) {
@@ -39,6 +39,11 @@ namespace tensorflow {
 // 4. Given nodes "A" and "B", if node "B" has a colocation group
 //    "@loc:A", nodes "A" and "B" will be colocated on the same device.
 //
+// If the TF_PLACER_MINIMIZE_TRANSFERS environment variable is set, a node
+// with no requested device is placed on the device of the preferred type
+// that minimizes the estimated cost of copying its inputs from the devices
+// they were placed on, rather than on the first such device.
+//
 // The implementation builds a constraint graph with the same set of
 // nodes, and edges that represent colocation constraints between
 // nodes.  Each connected component in the resulting constraint graph
@@ -93,6 +98,12 @@ class Placer {
   bool CanAssignToDevice(const string& candidate_device_name,
                          const std::vector<Device*>& devices) const;
 
+  // Returns the device of the type of 'devices[0]' in 'devices' that
+  // minimizes the cost of copying the inputs of 'node' that are already
+  // placed, or nullptr if none of them is.
+  const Device* DeviceWithCheapestInputs(
+      const Node& node, const std::vector<Device*>& devices) const;
+
   Graph* const graph_;  // Not owned.
   const string function_name_;
   const FunctionLibraryDefinition* const flib_def_;  // Not owned.
@@ -100,6 +111,7 @@ class Placer {
   const Device* default_local_device_;               // Not owned.
   const bool allow_soft_placement_;
   const bool log_device_placement_;
+  bool minimize_transfers_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(Placer);
 };
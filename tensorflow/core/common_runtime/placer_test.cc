@@ -430,6 +430,30 @@ TEST_F(PlacerTest, TestNoConstraints) {
   EXPECT_DEVICE_TYPE(g, "n2", "FakeGPU");
 }
 
+// Test that nodes without a requested device follow their inputs when the
+// placer minimizes transfers.
+TEST_F(PlacerTest, TestMinimizeTransfers) {
+  setenv("TF_PLACER_MINIMIZE_TRANSFERS", "true", 1);
+  Graph g(OpRegistry::Global());
+  {  // Scope for temporary variables used to construct g.
+    GraphDefBuilder b(GraphDefBuilder::kFailImmediately);
+    Node* input = ops::SourceOp("TestInput", b.opts().WithName("in"));
+    Node* n1 = ops::UnaryOp("TestRelu", ops::NodeOut(input, 0),
+                            b.opts().WithName("n1").WithDevice(
+                                "/job:a/replica:0/task:0/device:FakeGPU:3"));
+    ops::UnaryOp("TestRelu", n1, b.opts().WithName("n2"));
+    ops::UnaryOp("TestRelu", ops::NodeOut(input, 1), b.opts().WithName("n3"));
+    TF_EXPECT_OK(BuildGraph(b, &g));
+  }
+
+  TF_EXPECT_OK(Place(&g));
+  unsetenv("TF_PLACER_MINIMIZE_TRANSFERS");
+  EXPECT_DEVICE_CONTAINS(g, "n1", "/device:FakeGPU:3");
+  EXPECT_DEVICE_CONTAINS(g, "n2", "/device:FakeGPU:3");
+  // The input of n3 is on a CPU, so it goes to the first GPU as usual.
+  EXPECT_DEVICE_CONTAINS(g, "n3", "/device:FakeGPU:0");
+}
+
 // Test that a graph with no constraints but using kernels that have a specified
 // device priority will successfully assign nodes to the device with higher
 // priority
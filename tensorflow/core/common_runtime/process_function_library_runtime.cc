@@ -296,16 +296,6 @@ ProcessFunctionLibraryRuntime::AddMultiDeviceHandle(
   return h;
 }
 
-bool ProcessFunctionLibraryRuntime::HasMultiDeviceHandle(
-    FunctionLibraryRuntime::Handle handle) const {
-  bool multi_device;
-  {
-    tf_shared_lock l(mu_);
-    multi_device = mdevice_data_.find(handle) != mdevice_data_.end();
-  }
-  return multi_device;
-}
-
 FunctionLibraryRuntime::Handle ProcessFunctionLibraryRuntime::GetHandle(
     const string& function_key) const {
   tf_shared_lock l(mu_);
@@ -1150,6 +1140,8 @@ Status ProcessFunctionLibraryRuntime::InstantiateMultiDevice(
   }
   TF_RETURN_IF_ERROR(group.as_summary_status());
 
+  data->local_component_flr_ =
+      GetLocalComponentFLR(*data, options.input_devices.size());
   *handle = AddMultiDeviceHandle(std::move(data), function_key);
   VLOG(2) << "Instantiated MultiDevice function \"" << function_name
           << "\" with handle " << *handle;
@@ -1462,6 +1454,110 @@ void ProcessFunctionLibraryRuntime::RunMultiDeviceAsync(
   refcounted_done->Unref();
 }
 
+FunctionLibraryRuntime* ProcessFunctionLibraryRuntime::GetLocalComponentFLR(
+    const MultiDeviceFunctionData& data, int num_args) const {
+  if (data.glue_.size() != 1 || data.is_cross_process_) return nullptr;
+  const auto& pair = *data.glue_.begin();
+  const ComponentFunctionData& comp_data = pair.second;
+  if (comp_data.arg_indices.size() != num_args ||
+      comp_data.ret_indices.size() != data.num_outputs_) {
+    return nullptr;
+  }
+  for (int i = 0; i < comp_data.arg_indices.size(); ++i) {
+    // Packed arguments have a sub-index.
+    if (comp_data.arg_indices[i].index != i ||
+        comp_data.arg_indices[i].sub_index != -1) {
+      return nullptr;
+    }
+  }
+  for (int i = 0; i < comp_data.ret_indices.size(); ++i) {
+    if (comp_data.ret_indices[i] != i) return nullptr;
+  }
+  return GetFLR(pair.first);
+}
+
+FunctionLibraryRuntime::Options
+ProcessFunctionLibraryRuntime::GetLocalComponentOptions(
+    const FunctionLibraryRuntime::Options& opts,
+    const MultiDeviceFunctionData& data) {
+  const ComponentFunctionData& comp_data = data.glue_.begin()->second;
+  FunctionLibraryRuntime* flr = data.local_component_flr_;
+  FunctionLibraryRuntime::Options comp_opts = opts;
+  comp_opts.args_alloc_attrs = comp_data.arg_alloc_attrs;
+  comp_opts.rets_alloc_attrs = comp_data.ret_alloc_attrs;
+  comp_opts.remote_execution = false;
+  // When target device has private thread pool, use the target device runner
+  thread::ThreadPool* pool = flr->device()->tensorflow_device_thread_pool();
+  comp_opts.runner = (pool == nullptr) ? opts.runner : flr->runner();
+  return comp_opts;
+}
+
+void ProcessFunctionLibraryRuntime::RunLocalComponent(
+    const FunctionLibraryRuntime::Options& opts,
+    const MultiDeviceFunctionData& data, gtl::ArraySlice<Tensor> args,
+    std::vector<Tensor>* rets,
+    FunctionLibraryRuntime::DoneCallback done) const {
+  const ComponentFunctionData& comp_data = data.glue_.begin()->second;
+  FunctionLibraryRuntime::Options comp_opts =
+      GetLocalComponentOptions(opts, data);
+  // Nested function calls may use the rendezvous, so it's still created if
+  // the caller didn't provide one.
+  Rendezvous* created_rendezvous = nullptr;
+  if (!opts.rendezvous) {
+    Status s = CreateRendezvous(comp_opts, &created_rendezvous);
+    if (!s.ok()) {
+      done(s);
+      return;
+    }
+  }
+
+  VLOG(1) << "Running local component function from " << data.function_name_
+          << " with handle " << comp_data.handle;
+  VLOG(4) << "    with " << comp_opts.DebugString();
+  data.local_component_flr_->Run(
+      comp_opts, comp_data.handle, args, rets,
+      [this, &data, created_rendezvous, step_id = comp_opts.step_id,
+       done = std::move(done)](const Status& status) {
+        CleanupCreatedRendezvous(created_rendezvous, step_id);
+        if (!status.ok()) {
+          done(errors::CreateWithUpdatedMessage(
+              status, strings::StrCat(
+                          errors::FormatFunctionForError(data.function_name_),
+                          " ", status.error_message())));
+          return;
+        }
+        done(status);
+      });
+}
+
+Status ProcessFunctionLibraryRuntime::RunLocalComponentSync(
+    const FunctionLibraryRuntime::Options& opts,
+    const MultiDeviceFunctionData& data, gtl::ArraySlice<Tensor> args,
+    std::vector<Tensor>* rets) const {
+  const ComponentFunctionData& comp_data = data.glue_.begin()->second;
+  FunctionLibraryRuntime::Options comp_opts =
+      GetLocalComponentOptions(opts, data);
+  Rendezvous* created_rendezvous = nullptr;
+  if (!opts.rendezvous) {
+    TF_RETURN_IF_ERROR(CreateRendezvous(comp_opts, &created_rendezvous));
+  }
+
+  VLOG(1) << "Running local component function from " << data.function_name_
+          << " with handle " << comp_data.handle;
+  VLOG(4) << "    with " << comp_opts.DebugString();
+  Status status = data.local_component_flr_->RunSync(
+      comp_opts, comp_data.handle, args, rets);
+  CleanupCreatedRendezvous(created_rendezvous, comp_opts.step_id);
+  if (!status.ok()) {
+    if (opts.rendezvous != nullptr) opts.rendezvous->StartAbort(status);
+    return errors::CreateWithUpdatedMessage(
+        status,
+        strings::StrCat(errors::FormatFunctionForError(data.function_name_),
+                        " ", status.error_message()));
+  }
+  return OkStatus();
+}
+
 Status ProcessFunctionLibraryRuntime::Instantiate(
     const string& function_name, AttrSlice attrs,
     const FunctionLibraryRuntime::InstantiateOptions& options,
@@ -1720,6 +1816,12 @@ void ProcessFunctionLibraryRuntime::Run(
     FunctionLibraryRuntime::Handle handle, gtl::ArraySlice<Tensor> args,
     std::vector<Tensor>* rets,
     FunctionLibraryRuntime::DoneCallback done) const {
+  const MultiDeviceFunctionData* data = IsMultiDevice(handle);
+  if (data != nullptr && data->local_component_flr_ != nullptr &&
+      !opts.create_rendezvous) {
+    return RunLocalComponent(opts, *data, args, rets, std::move(done));
+  }
+
   FunctionLibraryRuntime::Options new_opts = opts;
   Rendezvous* created_rendezvous = nullptr;
   if (!opts.rendezvous) {
@@ -1742,8 +1844,7 @@ void ProcessFunctionLibraryRuntime::Run(
     delete function_rets;
     done(status);
   };
-  bool multi_device = HasMultiDeviceHandle(handle);
-  if (multi_device) {
+  if (data != nullptr) {
     auto get_component_args = [&args](const ComponentFunctionData& comp_data,
                                       InternalArgs* comp_args) -> Status {
       return GetComponentArgs(args, comp_data, comp_args);
@@ -1905,6 +2006,12 @@ Status ProcessFunctionLibraryRuntime::RunSync(
     FunctionLibraryRuntime::Handle handle, gtl::ArraySlice<Tensor> args,
     std::vector<Tensor>* rets) const {
   MultiDeviceFunctionData* multi_device_data = IsMultiDevice(handle);
+  if (multi_device_data && multi_device_data->local_component_flr_ &&
+      multi_device_data->enable_sync_execution &&
+      !orig_opts.create_rendezvous) {
+    metrics::IncrementTestCounter("pflr_runsync", "sync");
+    return RunLocalComponentSync(orig_opts, *multi_device_data, args, rets);
+  }
   if (multi_device_data && multi_device_data->enable_sync_execution) {
     metrics::IncrementTestCounter("pflr_runsync", "sync");
     FunctionLibraryRuntime::Options new_opts = orig_opts;
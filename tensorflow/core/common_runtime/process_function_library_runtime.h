@@ -327,6 +327,12 @@ class ProcessFunctionLibraryRuntime {
     //  Indicates if running this function synchronously is both allowed + safe.
     bool enable_sync_execution;
 
+    // Set if the function has a single component function, on a local device,
+    // which takes the arguments and returns the return values of the function
+    // in order. Run() then calls the component function through this
+    // FunctionLibraryRuntime directly.
+    FunctionLibraryRuntime* local_component_flr_ = nullptr;
+
     // Maps the device name to the information about the component function
     // be run on this device.
     std::unordered_map<string, ComponentFunctionData> glue_;
@@ -398,8 +404,6 @@ class ProcessFunctionLibraryRuntime {
       const std::unique_ptr<MultiDeviceFunctionData> data,
       const string& function_key);
 
-  bool HasMultiDeviceHandle(FunctionLibraryRuntime::Handle handle) const;
-
   void RunInternal(const FunctionLibraryRuntime::Options& opts,
                    FunctionLibraryRuntime::Handle handle,
                    gtl::ArraySlice<FunctionArg> args,
@@ -454,6 +458,31 @@ class ProcessFunctionLibraryRuntime {
                            InternalArgs* args)>
           get_component_args) const;
 
+  // Returns the FunctionLibraryRuntime to set as `local_component_flr_` of
+  // `data`, or nullptr if `data` doesn't qualify.
+  FunctionLibraryRuntime* GetLocalComponentFLR(
+      const MultiDeviceFunctionData& data, int num_args) const;
+
+  // Returns the options to run the component function of a function with a
+  // `local_component_flr_` with.
+  static FunctionLibraryRuntime::Options GetLocalComponentOptions(
+      const FunctionLibraryRuntime::Options& opts,
+      const MultiDeviceFunctionData& data);
+
+  // Runs a function with a `local_component_flr_`, skipping the
+  // bookkeeping RunMultiDeviceAsync() and RunMultiDeviceSync() need to split
+  // the arguments between several component functions and gather their
+  // return values.
+  void RunLocalComponent(const FunctionLibraryRuntime::Options& opts,
+                         const MultiDeviceFunctionData& data,
+                         gtl::ArraySlice<Tensor> args,
+                         std::vector<Tensor>* rets,
+                         FunctionLibraryRuntime::DoneCallback done) const;
+  Status RunLocalComponentSync(const FunctionLibraryRuntime::Options& opts,
+                               const MultiDeviceFunctionData& data,
+                               gtl::ArraySlice<Tensor> args,
+                               std::vector<Tensor>* rets) const;
+
   // Data structure holding information for a single instantiated remote
   // (to be executed on `target_device`) function.
   class FunctionData {
@@ -1326,5 +1326,33 @@ TEST_F(ProcessFunctionLibraryRuntimeTest, PartitionedGraphRequiresAsync) {
   EXPECT_GT(async_recv_only.Get(), 0);
 }
 
+TEST_F(ProcessFunctionLibraryRuntimeTest, MultiDevice_SingleLocalComponent) {
+  Init({test::function::FindDevice(), test::function::XTimesTwo()});
+  FunctionLibraryRuntime::Options opts;
+  Tensor y;
+  TF_CHECK_OK(Run("FindDevice", opts, {}, MakeOptions("CPU:1", {}, {"CPU:1"}),
+                  {}, {&y}));
+  test::ExpectTensorEqual<tstring>(
+      y, test::AsTensor<tstring>({"/job:a/replica:0/task:0/device:CPU:1"},
+                                 TensorShape({})));
+  // The rendezvous is still created and cleaned up.
+  EXPECT_EQ(1, rendezvous_ref_counts_.size());
+  EXPECT_EQ(0, rendezvous_ref_counts_.begin()->second);
+
+  FunctionLibraryRuntime::InstantiateOptions inst_opts =
+      MakeOptions("CPU:1", {"CPU:1"}, {"CPU:1"});
+  TF_CHECK_OK(Run("XTimesTwo", opts, {{"T", DT_FLOAT}}, inst_opts,
+                  {test::AsTensor<float>({1, 2})}, {&y}));
+  test::ExpectTensorEqual<float>(y, test::AsTensor<float>({2, 4}));
+
+  // Errors name the function, as for functions with several components.
+  Status status = Run("XTimesTwo", opts, {{"T", DT_FLOAT}}, inst_opts,
+                      {test::AsTensor<int32>({1, 2})}, {&y});
+  EXPECT_TRUE(errors::IsInvalidArgument(status)) << status;
+  EXPECT_TRUE(absl::StrContains(status.error_message(),
+                                "{{function_node XTimesTwo}}"))
+      << status;
+}
+
 }  // anonymous namespace
 }  // namespace tensorflow
@@ -37,6 +37,8 @@ PropagatorState::PropagatorState(const ImmutableExecutorState& immutable_state,
   root_frame_->frame_id = 0;  // must be 0
   root_frame_->InitializeFrameInfo(immutable_state_.get_root_frame_info());
 
+  root_frame_->lock_free = immutable_state_.lock_free_root_frame();
+
   // Initialize iteration 0.
   root_frame_->SetIteration(
       0, new PropagatorState::IterationState(0, root_frame_->pending_counts,
@@ -277,6 +279,10 @@ void PropagatorState::FindOrCreateChildFrame(FrameState* frame,
     } else {
       mutex_lock frame_lock(frame->mu);
       iter_state->outstanding_frame_count++;
+      if (frame->lock_free) {
+        // Released in `CleanupFramesIterations()`.
+        iter_state->outstanding_ops++;
+      }
       outstanding_frames_[child_id] = temp;
       *child = temp;
       temp = nullptr;
@@ -306,6 +312,11 @@ void PropagatorState::DeleteFrame(FrameState* frame, TaggedNodeSeq* ready) {
       };
 
       auto propagate_to_non_merge = [&](PendingCounts::Handle dst_pending_id) {
+        if (parent_frame->lock_free) {
+          return !parent_iter_state
+                      ->adjust_for_activation_atomic(dst_pending_id, true)
+                      .any_pending;
+        }
         parent_iter_state->increment_dead_count(dst_pending_id);
         return parent_iter_state->decrement_pending(dst_pending_id, 1) == 0;
       };
@@ -369,7 +380,12 @@ void PropagatorState::CleanupFramesIterations(FrameState* frame,
   {
     mutex_lock frame_lock(frame->mu);
     iter_state->outstanding_frame_count--;
-    is_frame_done = frame->CleanupIterations(iter_state, ready);
+    if (frame->lock_free) {
+      // Release the outstanding op held by the child frame.
+      is_frame_done = frame->DecrementOutstandingOpsLocked(iter_state, ready);
+    } else {
+      is_frame_done = frame->CleanupIterations(iter_state, ready);
+    }
   }
   if (is_frame_done) {
     FrameState* parent_frame = frame->parent_frame;
@@ -512,8 +528,13 @@ int PropagatorState::FrameState::ActivateNodesSlowPath(
       // Handle all other (non-merge) nodes.
       const bool increment_dead =
           (is_dead || ((*outputs)[src_slot].state == Entry::State::NO_VALUE));
+      // Merge nodes are only ever activated under the exclusive lock, but
+      // other nodes of a lock-free frame may be activated concurrently.
       const PendingCounts::AdjustResult adjust_result =
-          iter_state->adjust_for_activation(dst_pending_id, increment_dead);
+          lock_free ? iter_state->adjust_for_activation_atomic(dst_pending_id,
+                                                               increment_dead)
+                    : iter_state->adjust_for_activation(dst_pending_id,
+                                                        increment_dead);
       dst_dead = adjust_result.any_dead;
       dst_ready = !adjust_result.any_pending;
     }
@@ -551,7 +572,10 @@ int PropagatorState::FrameState::ActivateNodesSlowPath(
     } else {
       // Handle all other (non-merge) nodes.
       const PendingCounts::AdjustResult adjust_result =
-          iter_state->adjust_for_activation(dst_pending_id, is_dead);
+          lock_free
+              ? iter_state->adjust_for_activation_atomic(dst_pending_id,
+                                                         is_dead)
+              : iter_state->adjust_for_activation(dst_pending_id, is_dead);
       dst_dead = adjust_result.any_dead;
       dst_ready = !adjust_result.any_pending;
     }
@@ -570,6 +594,11 @@ bool PropagatorState::FrameState::ActivateNodesAndAdjustOutstanding(
         ActivateNodesSlowPath(item, is_dead, iter_state, outputs, ready);
     return AdjustOutstandingOpsLocked(iter_state, activated - 1, ready);
   }
+  if (lock_free) {
+    int activated =
+        ActivateNodesFastPathLockFree(item, is_dead, iter_state, outputs, ready);
+    return AdjustOutstandingOps(iter_state, activated - 1, ready);
+  }
   {
     tf_shared_lock l(mu);
     int activated =
@@ -588,6 +617,9 @@ int PropagatorState::FrameState::ActivateNodesLocked(const NodeItem* item,
                                                      TaggedNodeSeq* ready) {
   if (TF_PREDICT_FALSE(item->is_any_consumer_merge_or_control_trigger)) {
     return ActivateNodesSlowPath(item, is_dead, iter_state, outputs, ready);
+  } else if (lock_free) {
+    return ActivateNodesFastPathLockFree(item, is_dead, iter_state, outputs,
+                                         ready);
   } else {
     return ActivateNodesFastPathLocked(item, is_dead, iter_state, outputs,
                                        ready);
@@ -750,6 +782,15 @@ bool PropagatorState::FrameState::AdjustOutstandingOps(
   if (delta == 0) {
     return false;
   }
+  if (lock_free) {
+    // Only the thread that drops the count to zero may clean up.
+    if (TF_PREDICT_TRUE(iter_state->outstanding_ops.fetch_add(delta) + delta !=
+                        0)) {
+      return false;
+    }
+    mutex_lock l(mu);
+    return CleanupIterations(iter_state, ready);
+  }
   {
     tf_shared_lock sl(mu);
     if (TF_PREDICT_TRUE(!AdjustOutstandingOpsFastPath(iter_state, delta))) {
@@ -777,6 +818,14 @@ bool PropagatorState::FrameState::DecrementOutstandingOpsLocked(
 
 bool PropagatorState::FrameState::AdjustOutstandingOpsLocked(
     IterationState* iter_state, int delta, TaggedNodeSeq* ready) {
+  if (lock_free) {
+    // Other threads may adjust the count without holding the lock.
+    auto new_val = iter_state->outstanding_ops.fetch_add(delta) + delta;
+    if (new_val != 0) {
+      return false;
+    }
+    return CleanupIterations(iter_state, ready);
+  }
   // We hold the lock, so we don't need to use an atomic modification.
   auto cur_val = iter_state->outstanding_ops.load(std::memory_order_relaxed);
   DCHECK(delta >= 0 || cur_val >= -delta)
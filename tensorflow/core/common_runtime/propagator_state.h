@@ -253,6 +253,20 @@ class PropagatorState {
     // The number of outstanding iterations.
     int num_outstanding_iterations TF_GUARDED_BY(mu) = 1;
 
+    // If true, the pending counts and outstanding op counts of this frame are
+    // only ever modified with atomic operations, so that simple nodes (no
+    // merge/control outputs) can be propagated without acquiring `mu`. Each
+    // live child frame also holds one outstanding op of the iteration that
+    // created it, so the iteration is done exactly when the outstanding op
+    // count drops to zero, and the thread that observes this is the only one
+    // that cleans it up.
+    //
+    // Only set for the root frame, whose single iteration is not deleted
+    // until the step completes. The iterations of a loop may be deleted by
+    // another thread as soon as they are done, so loop frames keep using the
+    // lock.
+    bool lock_free = false;
+
    private:
     // The active iteration states of this frame.
     gtl::InlinedVector<IterationState*, 12> iterations;
@@ -354,8 +368,8 @@ class PropagatorState {
     // indeterminate state after returning from this method.
     //
     // In the case that 'item' is a simple node (no merge/control outputs) this
-    // will acquire a shared lock and can run concurrently with other
-    // invocations.
+    // will acquire a shared lock (or no lock, if `lock_free` is true) and can
+    // run concurrently with other invocations.
     //
     // Return true if the frame is done after activation.
     bool ActivateNodesAndAdjustOutstanding(const NodeItem* item,
@@ -413,6 +427,19 @@ class PropagatorState {
                                                  outputs, ready);
     }
 
+    // REQUIRES: `lock_free` and
+    // `!item->is_any_consumer_merge_or_control_trigger`.
+    // This variant uses atomic operations to modify the pending counts, and
+    // may be called without holding `mu`.
+    int ActivateNodesFastPathLockFree(const NodeItem* item, const bool is_dead,
+                                      IterationState* iter_state,
+                                      EntryVector* outputs,
+                                      TaggedNodeSeq* ready) {
+      DCHECK(lock_free);
+      return ActivateNodesFastPathInternal<true>(item, is_dead, iter_state,
+                                                 outputs, ready);
+    }
+
     template <bool atomic>
     int ActivateNodesFastPathInternal(const NodeItem* item, const bool is_dead,
                                       IterationState* iter_state,
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
 
 #include <unordered_set>
+#include <vector>
 
 #include "tensorflow/core/common_runtime/copy_tensor.h"
 #include "tensorflow/core/common_runtime/device.h"
@@ -164,6 +165,51 @@ void IntraProcessRecvAsyncImpl(const DeviceMgr* device_mgr,
       });
 }
 
+void IntraProcessRecvManyAsyncImpl(
+    const DeviceMgr* device_mgr, LocalRendezvous* local,
+    absl::Span<const RendezvousInterface::ParsedKey> keys,
+    absl::Span<const Rendezvous::Args> recv_args,
+    RendezvousInterface::ManyDoneCallback done) {
+  VLOG(1) << "IntraProcessRendezvous RecvMany " << local << " " << keys.size()
+          << " keys";
+
+  profiler::ScopedMemoryDebugAnnotation op_annotation("RecvManyAsync");
+  local->RecvManyAsync(
+      keys, recv_args,
+      [device_mgr,
+       parsed = std::vector<Rendezvous::ParsedKey>(keys.begin(), keys.end()),
+       recv_args =
+           std::vector<Rendezvous::Args>(recv_args.begin(), recv_args.end()),
+       done = std::move(done)](
+          const Status& status,
+          const std::vector<Rendezvous::Args>& send_args,
+          const std::vector<Tensor>& in,
+          const std::vector<bool>& is_dead) mutable {
+        if (!status.ok() || in.empty()) {
+          done(status, send_args, in, is_dead);
+          return;
+        }
+        // Copies every tensor to its destination, as RecvAsync() does, and
+        // invokes `done` once all the copies have finished.
+        auto* collector =
+            new internal::RecvManyCollector(in.size(), std::move(done));
+        for (int i = 0; i < in.size(); ++i) {
+          if (!in[i].IsInitialized()) {
+            collector->Done(i, OkStatus(), send_args[i], in[i], is_dead[i]);
+            continue;
+          }
+          Tensor* out = new Tensor;
+          SameWorkerRecvDone(
+              device_mgr, parsed[i], send_args[i], recv_args[i], in[i], out,
+              [collector, i, send_args = send_args[i], out,
+               is_dead = is_dead[i]](const Status& s) {
+                collector->Done(i, s, send_args, *out, is_dead);
+                delete out;
+              });
+        }
+      });
+}
+
 }  // namespace
 
 RefCountedIntraProcessRendezvous::RefCountedIntraProcessRendezvous(
@@ -187,6 +233,13 @@ void RefCountedIntraProcessRendezvous::RecvAsync(const ParsedKey& key,
   IntraProcessRecvAsyncImpl(device_mgr_, &local_, key, args, std::move(done));
 }
 
+void RefCountedIntraProcessRendezvous::RecvManyAsync(
+    absl::Span<const ParsedKey> keys, absl::Span<const Rendezvous::Args> args,
+    ManyDoneCallback done) {
+  IntraProcessRecvManyAsyncImpl(device_mgr_, &local_, keys, args,
+                                std::move(done));
+}
+
 void RefCountedIntraProcessRendezvous::StartAbort(const Status& s) {
   local_.StartAbort(s);
 }
@@ -217,6 +270,13 @@ void PrivateIntraProcessRendezvous::RecvAsync(const ParsedKey& key,
   IntraProcessRecvAsyncImpl(device_mgr_, &local_, key, args, std::move(done));
 }
 
+void PrivateIntraProcessRendezvous::RecvManyAsync(
+    absl::Span<const ParsedKey> keys, absl::Span<const Rendezvous::Args> args,
+    ManyDoneCallback done) {
+  IntraProcessRecvManyAsyncImpl(device_mgr_, &local_, keys, args,
+                                std::move(done));
+}
+
 void PrivateIntraProcessRendezvous::StartAbort(const Status& s) {
   local_.StartAbort(s);
 }
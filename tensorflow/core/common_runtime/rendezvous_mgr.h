@@ -49,6 +49,9 @@ class RefCountedIntraProcessRendezvous : public Rendezvous {
               const Tensor& val, const bool is_dead) override;
   void RecvAsync(const ParsedKey& key, const Rendezvous::Args& args,
                  DoneCallback done) override;
+  void RecvManyAsync(absl::Span<const ParsedKey> keys,
+                     absl::Span<const Rendezvous::Args> args,
+                     ManyDoneCallback done) override;
   void StartAbort(const Status& status) override;
 
   // Returns the member LocalRendezvous' status.
@@ -85,6 +88,9 @@ class PrivateIntraProcessRendezvous : public RendezvousInterface {
               const Tensor& val, const bool is_dead) override;
   void RecvAsync(const ParsedKey& key, const Rendezvous::Args& args,
                  DoneCallback done) override;
+  void RecvManyAsync(absl::Span<const ParsedKey> keys,
+                     absl::Span<const Rendezvous::Args> args,
+                     ManyDoneCallback done) override;
   void StartAbort(const Status& status) override;
 
  private:
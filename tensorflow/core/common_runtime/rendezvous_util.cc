@@ -15,8 +15,6 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/rendezvous_util.h"
 #include "tensorflow/core/platform/mutex.h"
 
-#include "tensorflow/core/util/reffed_status_callback.h"
-
 namespace tensorflow {
 
 Status SendTensorsToRendezvous(
@@ -66,56 +64,47 @@ void RecvOutputsFromRendezvousAsync(
     done(errors::InvalidArgument(
         "keys and alloc_attrs are not the same size. ", "keys.size() = ",
         keys.size(), "; alloc_attrs.size() = ", alloc_attrs.size()));
+    return;
   }
 
   received_tensors->reserve(keys.size());
-  std::vector<
-      std::tuple<string, Tensor*, Rendezvous::ParsedKey, AllocatorAttributes>>
-      arguments;
+  std::vector<Rendezvous::ParsedKey> parsed_keys(keys.size());
+  std::vector<Rendezvous::Args> rendez_args(keys.size());
   for (int i = 0; i < keys.size(); ++i) {
-    Rendezvous::ParsedKey parsed;
-    Status s = Rendezvous::ParseKey(keys[i], &parsed);
+    Status s = Rendezvous::ParseKey(keys[i], &parsed_keys[i]);
     received_tensors->push_back(Tensor());
     if (!s.ok()) {
       done(s);
       return;
     }
-    AllocatorAttributes alloc_attr;
+    rendez_args[i].device_context = device_context;
     if (!alloc_attrs.empty()) {
-      alloc_attr = alloc_attrs[i];
+      rendez_args[i].alloc_attrs = alloc_attrs[i];
     }
-    arguments.emplace_back(keys[i], &((*received_tensors)[i]), parsed,
-                           alloc_attr);
+  }
+  // Pointers are only taken once `received_tensors` is no longer resized.
+  std::vector<Tensor*> vals(keys.size());
+  for (int i = 0; i < keys.size(); ++i) {
+    vals[i] = &(*received_tensors)[i];
   }
 
-  auto status_cb = new ReffedStatusCallback(std::move(done));
-  for (auto& p : arguments) {
-    const string& key = std::get<0>(p);
-    Tensor* val = std::get<1>(p);
-    Rendezvous::ParsedKey parsed = std::get<2>(p);
-    Rendezvous::Args rendez_args;
-    rendez_args.device_context = device_context;
-    rendez_args.alloc_attrs = std::get<3>(p);
-    status_cb->Ref();
-    rendezvous->RecvAsync(
-        parsed, rendez_args,
-        [val, key, status_cb](const Status& s,
-                              const Rendezvous::Args& send_args,
-                              const Rendezvous::Args& recv_args,
-                              const Tensor& v, const bool is_dead) {
-          Status status = s;
-          if (status.ok()) {
-            *val = v;
-            if (is_dead) {
-              status = errors::InvalidArgument("The tensor returned for ", key,
-                                               " was not valid.");
-            }
+  // All the keys are registered at once, and `done` is invoked when the last
+  // one has been received.
+  rendezvous->RecvManyAsync(
+      parsed_keys, rendez_args,
+      [vals = std::move(vals), keys, done = std::move(done)](
+          const Status& s, const std::vector<Rendezvous::Args>& send_args,
+          const std::vector<Tensor>& v, const std::vector<bool>& is_dead) {
+        Status status = s;
+        for (int i = 0; i < vals.size(); ++i) {
+          *vals[i] = v[i];
+          if (status.ok() && is_dead[i]) {
+            status = errors::InvalidArgument("The tensor returned for ",
+                                             keys[i], " was not valid.");
           }
-          status_cb->UpdateStatus(status);
-          status_cb->Unref();
-        });
-  }
-  status_cb->Unref();
+        }
+        done(status);
+      });
 }
 
 Status RecvOutputsFromRendezvous(RendezvousInterface* rendezvous,
@@ -0,0 +1,244 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Benchmarks of the fixed overheads of the runtime, as opposed to the cost of
+// kernels: dispatching a node in the executor, a DirectSession::Run call,
+// sending a tensor through a rendezvous, and calling a function. They use
+// trivial kernels on scalars so that the overheads dominate. The benchmarks
+// of the executor in executor_test.cc and of feeds and fetches in
+// direct_session_test.cc complement these, and the per-op cost of eager
+// execution is measured in eager/execute_benchmark_test.cc.
+//
+// Run with, e.g.,
+//   bazel run -c opt :runtime_overhead_benchmark_test -- --benchmarks=all
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/common_runtime/process_function_library_runtime.h"
+#include "tensorflow/core/common_runtime/rendezvous_mgr.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/rendezvous.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/notification.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/strcat.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/public/session.h"
+#include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/public/version.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr char kJob[] = "/job:localhost/replica:0/task:0";
+constexpr char kCpu0[] = "/job:localhost/replica:0/task:0/device:CPU:0";
+constexpr char kCpu1[] = "/job:localhost/replica:0/task:0/device:CPU:1";
+
+SessionOptions SessionOptionsWithCpus(int num_cpus) {
+  SessionOptions options;
+  (*options.config.mutable_device_count())["CPU"] = num_cpus;
+  return options;
+}
+
+std::unique_ptr<DeviceMgr> CreateDeviceMgr(int num_cpus) {
+  std::vector<std::unique_ptr<Device>> devices;
+  TF_CHECK_OK(DeviceFactory::AddDevices(SessionOptionsWithCpus(num_cpus), kJob,
+                                        &devices));
+  return std::make_unique<StaticDeviceMgr>(std::move(devices));
+}
+
+// Executes a chain of `depth` Identity nodes, so that every node only becomes
+// ready once the previous one is done. The time per item is the cost of
+// dispatching one node.
+void BM_ExecutorChain(::testing::benchmark::State& state) {
+  const int depth = state.range(0);
+
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* node = test::graph::Constant(g, test::AsScalar<float>(1.0));
+  for (int i = 0; i < depth; ++i) {
+    node = test::graph::Identity(g, node);
+  }
+  FixupSourceAndSinkEdges(g);
+  test::Benchmark("cpu", g, /*old_benchmark_api=*/false).Run(state);
+
+  state.SetLabel(strings::StrCat("Nodes = ", depth + 1));
+  state.SetItemsProcessed((depth + 1) *
+                          static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_ExecutorChain)->UseRealTime()->Arg(1)->Arg(16)->Arg(256);
+
+// The fixed cost of DirectSession::Run. With `fetch` set to 0, the step only
+// runs a NoOp target, so it measures the per-call bookkeeping (looking up the
+// executors, creating the rendezvous and the step's state). With `fetch` set
+// to 1, a scalar is fetched instead.
+void BM_DirectSessionRun(::testing::benchmark::State& state) {
+  const bool fetch = state.range(0);
+
+  Graph g(OpRegistry::Global());
+  Node* target = fetch ? test::graph::Constant(&g, test::AsScalar<float>(1.0))
+                       : test::graph::NoOp(&g, {});
+  GraphDef def;
+  g.ToGraphDef(&def);
+
+  std::unique_ptr<Session> session(NewSession(SessionOptionsWithCpus(1)));
+  TF_CHECK_OK(session->Create(def));
+  std::vector<string> output_names;
+  std::vector<string> target_names;
+  if (fetch) {
+    output_names.push_back(strings::StrCat(target->name(), ":0"));
+  } else {
+    target_names.push_back(target->name());
+  }
+  std::vector<Tensor> outputs;
+  for (auto s : state) {
+    outputs.clear();
+    TF_CHECK_OK(session->Run({}, output_names, target_names, &outputs));
+  }
+  TF_CHECK_OK(session->Close());
+}
+BENCHMARK(BM_DirectSessionRun)->Arg(0)->Arg(1);
+
+// Runs Const -> Identity, with the Identity on another device than the Const
+// if `cross_device` is set, which adds a _Send/_Recv pair and a second
+// partition to the step.
+void BM_DirectSessionRunCrossDevice(::testing::benchmark::State& state) {
+  const bool cross_device = state.range(0);
+
+  Graph g(OpRegistry::Global());
+  Node* value = test::graph::Constant(&g, test::AsScalar<float>(1.0));
+  value->set_requested_device(kCpu0);
+  Node* identity = test::graph::Identity(&g, value);
+  identity->set_requested_device(cross_device ? kCpu1 : kCpu0);
+  GraphDef def;
+  g.ToGraphDef(&def);
+
+  std::unique_ptr<Session> session(NewSession(SessionOptionsWithCpus(2)));
+  TF_CHECK_OK(session->Create(def));
+  const std::vector<string> output_names = {
+      strings::StrCat(identity->name(), ":0")};
+  std::vector<Tensor> outputs;
+  for (auto s : state) {
+    outputs.clear();
+    TF_CHECK_OK(session->Run({}, output_names, {}, &outputs));
+  }
+  TF_CHECK_OK(session->Close());
+}
+BENCHMARK(BM_DirectSessionRunCrossDevice)->Arg(0)->Arg(1);
+
+// Sends a scalar through an intra-process rendezvous and receives it, from
+// CPU:0 to either CPU:0 or, if `cross_device` is set, CPU:1. Tensors in host
+// memory are shared rather than copied, so this is the overhead the
+// rendezvous adds to every _Send/_Recv pair.
+void BM_IntraProcessSendRecv(::testing::benchmark::State& state) {
+  const bool cross_device = state.range(0);
+
+  std::unique_ptr<DeviceMgr> device_mgr = CreateDeviceMgr(/*num_cpus=*/2);
+  PrivateIntraProcessRendezvous rendezvous(device_mgr.get());
+  Rendezvous::ParsedKey key;
+  TF_CHECK_OK(Rendezvous::ParseKey(
+      Rendezvous::CreateKey(kCpu0, /*src_incarnation=*/1,
+                            cross_device ? kCpu1 : kCpu0, "x",
+                            FrameAndIter(0, 0)),
+      &key));
+  const Tensor value = test::AsScalar<float>(1.0);
+  Tensor received;
+  bool is_dead;
+  for (auto s : state) {
+    TF_CHECK_OK(
+        rendezvous.Send(key, Rendezvous::Args(), value, /*is_dead=*/false));
+    TF_CHECK_OK(rendezvous.Recv(key, Rendezvous::Args(), &received, &is_dead));
+  }
+}
+BENCHMARK(BM_IntraProcessSendRecv)->Arg(0)->Arg(1);
+
+// Calls XTimesTwo on a scalar on CPU:0. With `multi_device` set to 0, the
+// function is instantiated for a single device and run through
+// FunctionLibraryRuntime::Run. With `multi_device` set to 1, it's
+// instantiated as a multi-device function and run through
+// ProcessFunctionLibraryRuntime::Run, which is how PartitionedCall calls
+// functions, and which creates a rendezvous for each call.
+void BM_FunctionCall(::testing::benchmark::State& state) {
+  const bool multi_device = state.range(0);
+
+  std::unique_ptr<DeviceMgr> device_mgr = CreateDeviceMgr(/*num_cpus=*/1);
+  FunctionDefLibrary proto;
+  *proto.add_function() = test::function::XTimesTwo();
+  FunctionLibraryDefinition lib_def(OpRegistry::Global(), proto);
+  ProcessFunctionLibraryRuntime pflr(
+      device_mgr.get(), Env::Default(), /*config=*/nullptr,
+      TF_GRAPH_DEF_VERSION, &lib_def, OptimizerOptions(),
+      /*thread_pool=*/nullptr, /*parent=*/nullptr,
+      /*session_metadata=*/nullptr,
+      Rendezvous::Factory{[](const int64_t step_id,
+                             const DeviceMgr* device_mgr, Rendezvous** r) {
+        *r = new IntraProcessRendezvous(device_mgr);
+        return OkStatus();
+      }});
+
+  FunctionLibraryRuntime::InstantiateOptions instantiate_opts;
+  instantiate_opts.target = kCpu0;
+  if (multi_device) {
+    instantiate_opts.is_multi_device_function = true;
+    instantiate_opts.input_devices = {kCpu0};
+    instantiate_opts.output_devices = {kCpu0};
+  }
+  FunctionLibraryRuntime::Handle handle;
+  TF_CHECK_OK(pflr.Instantiate("XTimesTwo",
+                               test::function::Attrs({{"T", DT_FLOAT}}),
+                               instantiate_opts, &handle));
+  FunctionLibraryRuntime* flr = pflr.GetFLR(kCpu0);
+  CHECK(flr != nullptr);
+
+  // Runs the kernels inline, so that thread hops don't add noise.
+  std::function<void(std::function<void()>)> runner =
+      [](std::function<void()> fn) { fn(); };
+  FunctionLibraryRuntime::Options opts;
+  opts.runner = &runner;
+  const std::vector<Tensor> args = {test::AsScalar<float>(1.0)};
+  std::vector<Tensor> rets;
+  for (auto s : state) {
+    Notification done;
+    Status status;
+    auto done_callback = [&status, &done](const Status& run_status) {
+      status = run_status;
+      done.Notify();
+    };
+    rets.clear();
+    if (multi_device) {
+      pflr.Run(opts, handle, args, &rets, done_callback);
+    } else {
+      flr->Run(opts, handle, args, &rets, done_callback);
+    }
+    done.WaitForNotification();
+    TF_CHECK_OK(status);
+  }
+  TF_CHECK_OK(pflr.ReleaseHandle(handle));
+}
+BENCHMARK(BM_FunctionCall)->Arg(0)->Arg(1);
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,133 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/sampling_allocator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/profiler/lib/scoped_memory_debug_annotation.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Returns a double in (0, 1].
+double UniformOpenZero(uint64 bits) {
+  return (static_cast<double>(bits >> 11) + 1.0) / 9007199254740992.0;
+}
+
+}  // namespace
+
+SamplingAllocator::SamplingAllocator(Allocator* allocator,
+                                     int64_t sample_interval_bytes)
+    : allocator_(allocator), sample_interval_bytes_(sample_interval_bytes) {
+  CHECK_GT(sample_interval_bytes_, 0);
+}
+
+SamplingAllocator::~SamplingAllocator() {}
+
+bool SamplingAllocator::ShouldSample(size_t num_bytes) {
+  // The distances between samples follow an exponential distribution, so
+  // that every allocated byte is equally likely to be sampled regardless of
+  // the pattern of allocation sizes. The countdown is shared by all the
+  // sampling allocators used by the thread, which are expected to use the
+  // same interval.
+  thread_local int64_t bytes_until_sample = -1;
+  if (bytes_until_sample < 0) {
+    bytes_until_sample = static_cast<int64_t>(
+        -std::log(UniformOpenZero(random::New64())) * sample_interval_bytes_);
+  }
+  bytes_until_sample -= num_bytes;
+  if (bytes_until_sample >= 0) {
+    return false;
+  }
+  bytes_until_sample = static_cast<int64_t>(
+      -std::log(UniformOpenZero(random::New64())) * sample_interval_bytes_);
+  return true;
+}
+
+int64_t SamplingAllocator::SampleWeight(size_t num_bytes) const {
+  // An allocation of `num_bytes` is sampled with probability
+  // 1 - exp(-num_bytes / interval), so this is an unbiased estimate.
+  const double probability =
+      -std::expm1(-static_cast<double>(num_bytes) / sample_interval_bytes_);
+  return static_cast<int64_t>(num_bytes / probability);
+}
+
+void* SamplingAllocator::AllocateRaw(
+    size_t alignment, size_t num_bytes,
+    const AllocationAttributes& allocation_attr) {
+  void* ptr = allocator_->AllocateRaw(alignment, num_bytes, allocation_attr);
+  if (ptr == nullptr || num_bytes == 0 || !ShouldSample(num_bytes)) {
+    return ptr;
+  }
+
+  const char* op_name =
+      profiler::ScopedMemoryDebugAnnotation::CurrentAnnotation()
+          .pending_op_name;
+  const int64_t weight_bytes = SampleWeight(num_bytes);
+  mutex_lock l(mu_);
+  OpMemoryProfile& op_profile =
+      op_profiles_[op_name != nullptr ? op_name : "unknown"];
+  op_profile.live_bytes += weight_bytes;
+  op_profile.peak_bytes =
+      std::max(op_profile.peak_bytes, op_profile.live_bytes);
+  ++op_profile.num_live_samples;
+  live_samples_[ptr] = Sample{&op_profile, weight_bytes};
+  return ptr;
+}
+
+void SamplingAllocator::DeallocateRaw(void* ptr) {
+  if (ptr != nullptr) {
+    bool sampled;
+    {
+      tf_shared_lock l(mu_);
+      sampled = live_samples_.contains(ptr);
+    }
+    if (sampled) {
+      mutex_lock l(mu_);
+      auto it = live_samples_.find(ptr);
+      if (it != live_samples_.end()) {
+        OpMemoryProfile* op_profile = it->second.op_profile;
+        op_profile->live_bytes -= it->second.weight_bytes;
+        --op_profile->num_live_samples;
+        live_samples_.erase(it);
+      }
+    }
+  }
+  allocator_->DeallocateRaw(ptr);
+}
+
+std::vector<SamplingAllocator::OpMemoryProfile>
+SamplingAllocator::GetProfile() {
+  std::vector<OpMemoryProfile> profile;
+  {
+    mutex_lock l(mu_);
+    profile.reserve(op_profiles_.size());
+    for (const auto& it : op_profiles_) {
+      profile.push_back(it.second);
+      profile.back().op_name = it.first;
+    }
+  }
+  std::sort(profile.begin(), profile.end(),
+            [](const OpMemoryProfile& a, const OpMemoryProfile& b) {
+              return a.peak_bytes > b.peak_bytes;
+            });
+  return profile;
+}
+
+}  // namespace tensorflow
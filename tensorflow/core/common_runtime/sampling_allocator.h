@@ -0,0 +1,117 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_SAMPLING_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_SAMPLING_ALLOCATOR_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// SamplingAllocator wraps another allocator and keeps a sampled profile of
+// the memory held by each op, as named by the `ScopedMemoryDebugAnnotation`
+// that is active when an allocation is made.
+//
+// Unlike `TrackingAllocator`, it does not record every allocation: on average
+// one allocation is sampled for every `sample_interval_bytes` allocated bytes,
+// and each sample stands for the number of bytes that it statistically
+// represents. Allocations that are not sampled only pay for a thread-local
+// counter update and, on deallocation, a lookup under a shared lock. The
+// resulting live and peak bytes per op are estimates, whose accuracy improves
+// as the interval gets smaller relative to the allocation sizes.
+//
+// This class is thread safe.
+class SamplingAllocator : public Allocator {
+ public:
+  // The sampled memory usage of one op.
+  struct OpMemoryProfile {
+    std::string op_name;
+    // Estimated bytes currently allocated by the op.
+    int64_t live_bytes = 0;
+    // Estimated maximum of `live_bytes` since the allocator was created.
+    int64_t peak_bytes = 0;
+    // Number of sampled allocations of the op that are still live.
+    int64_t num_live_samples = 0;
+  };
+
+  // Does not take ownership of `allocator`, which must outlive this object.
+  SamplingAllocator(Allocator* allocator, int64_t sample_interval_bytes);
+  ~SamplingAllocator() override;
+
+  std::string Name() override { return allocator_->Name(); }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    return AllocateRaw(alignment, num_bytes, AllocationAttributes());
+  }
+  void* AllocateRaw(size_t alignment, size_t num_bytes,
+                    const AllocationAttributes& allocation_attr) override;
+  void DeallocateRaw(void* ptr) override;
+  bool TracksAllocationSizes() const override {
+    return allocator_->TracksAllocationSizes();
+  }
+  size_t RequestedSize(const void* ptr) const override {
+    return allocator_->RequestedSize(ptr);
+  }
+  size_t AllocatedSize(const void* ptr) const override {
+    return allocator_->AllocatedSize(ptr);
+  }
+  int64_t AllocationId(const void* ptr) const override {
+    return allocator_->AllocationId(ptr);
+  }
+  absl::optional<AllocatorStats> GetStats() override {
+    return allocator_->GetStats();
+  }
+  bool ClearStats() override { return allocator_->ClearStats(); }
+  AllocatorMemoryType GetMemoryType() const override {
+    return allocator_->GetMemoryType();
+  }
+
+  // Returns the sampled memory usage of every op that has made a sampled
+  // allocation, by decreasing peak bytes.
+  std::vector<OpMemoryProfile> GetProfile();
+
+ private:
+  struct Sample {
+    // Points into `op_profiles_`, whose nodes are never removed.
+    OpMemoryProfile* op_profile;
+    int64_t weight_bytes;
+  };
+
+  // Returns true if an allocation of `num_bytes` should be sampled.
+  bool ShouldSample(size_t num_bytes);
+  // Returns the number of bytes that a sampled allocation of `num_bytes`
+  // stands for.
+  int64_t SampleWeight(size_t num_bytes) const;
+
+  Allocator* const allocator_;  // Not owned.
+  const int64_t sample_interval_bytes_;
+
+  mutex mu_;
+  absl::flat_hash_map<const void*, Sample> live_samples_ TF_GUARDED_BY(mu_);
+  absl::node_hash_map<std::string, OpMemoryProfile> op_profiles_
+      TF_GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SamplingAllocator);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_SAMPLING_ALLOCATOR_H_
@@ -0,0 +1,96 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/sampling_allocator.h"
+
+#include <vector>
+
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/profiler/lib/scoped_memory_debug_annotation.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(SamplingAllocatorTest, AttributesMemoryToOps) {
+  // With a tiny interval every allocation is sampled with its own size.
+  SamplingAllocator allocator(cpu_allocator(), /*sample_interval_bytes=*/1);
+  std::vector<void*> a_ptrs;
+  {
+    profiler::ScopedMemoryDebugAnnotation annotation("op_a");
+    for (int i = 0; i < 4; ++i) {
+      a_ptrs.push_back(allocator.AllocateRaw(64, 1024));
+    }
+  }
+  void* b_ptr;
+  {
+    profiler::ScopedMemoryDebugAnnotation annotation("op_b");
+    b_ptr = allocator.AllocateRaw(64, 2048);
+  }
+
+  std::vector<SamplingAllocator::OpMemoryProfile> profile =
+      allocator.GetProfile();
+  ASSERT_EQ(profile.size(), 2);
+  EXPECT_EQ(profile[0].op_name, "op_a");
+  EXPECT_EQ(profile[0].live_bytes, 4096);
+  EXPECT_EQ(profile[0].peak_bytes, 4096);
+  EXPECT_EQ(profile[0].num_live_samples, 4);
+  EXPECT_EQ(profile[1].op_name, "op_b");
+  EXPECT_EQ(profile[1].live_bytes, 2048);
+
+  allocator.DeallocateRaw(a_ptrs[0]);
+  allocator.DeallocateRaw(a_ptrs[1]);
+  profile = allocator.GetProfile();
+  ASSERT_EQ(profile.size(), 2);
+  EXPECT_EQ(profile[0].op_name, "op_a");
+  EXPECT_EQ(profile[0].live_bytes, 2048);
+  EXPECT_EQ(profile[0].peak_bytes, 4096);
+  EXPECT_EQ(profile[0].num_live_samples, 2);
+
+  allocator.DeallocateRaw(a_ptrs[2]);
+  allocator.DeallocateRaw(a_ptrs[3]);
+  allocator.DeallocateRaw(b_ptr);
+  for (const auto& op_profile : allocator.GetProfile()) {
+    EXPECT_EQ(op_profile.live_bytes, 0);
+    EXPECT_EQ(op_profile.num_live_samples, 0);
+  }
+}
+
+TEST(SamplingAllocatorTest, EstimatesLiveBytes) {
+  constexpr int kNumAllocations = 10000;
+  constexpr int kAllocationSize = 256;
+  SamplingAllocator allocator(cpu_allocator(),
+                              /*sample_interval_bytes=*/4096);
+  std::vector<void*> ptrs;
+  {
+    profiler::ScopedMemoryDebugAnnotation annotation("op");
+    for (int i = 0; i < kNumAllocations; ++i) {
+      ptrs.push_back(allocator.AllocateRaw(64, kAllocationSize));
+    }
+  }
+  std::vector<SamplingAllocator::OpMemoryProfile> profile =
+      allocator.GetProfile();
+  ASSERT_EQ(profile.size(), 1);
+  // About 625 samples are expected, so the estimate is within a few percent.
+  const double expected_bytes = kNumAllocations * kAllocationSize;
+  EXPECT_NEAR(profile[0].live_bytes, expected_bytes, 0.2 * expected_bytes);
+  EXPECT_LT(profile[0].num_live_samples, kNumAllocations);
+  for (void* ptr : ptrs) {
+    allocator.DeallocateRaw(ptr);
+  }
+  EXPECT_EQ(allocator.GetProfile()[0].live_bytes, 0);
+}
+
+}  // namespace
+}  // namespace tensorflow
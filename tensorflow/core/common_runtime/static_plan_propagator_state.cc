@@ -0,0 +1,104 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/static_plan_propagator_state.h"
+
+#include "tensorflow/core/common_runtime/propagator_debug_utils.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/profiler/lib/traceme.h"
+
+namespace tensorflow {
+
+StaticPlanPropagatorState::StaticPlanPropagatorState(
+    const ImmutableExecutorState& immutable_state, int64_t step_id, bool vlog)
+    : immutable_state_(immutable_state),
+      step_id_(step_id),
+      vlog_(vlog || VLOG_IS_ON(1)),
+      plan_(immutable_state.static_plan()),
+      input_tensors_(immutable_state.get_root_frame_info().total_inputs) {
+  DCHECK(immutable_state.has_static_plan());
+}
+
+StaticPlanPropagatorState::~StaticPlanPropagatorState() {}
+
+void StaticPlanPropagatorState::ActivateRoots(
+    gtl::ArraySlice<const NodeItem*> roots, TaggedNodeSeq* ready) {
+  if (!plan_.empty()) {
+    ready->emplace_back(plan_[0], 0);
+  }
+}
+
+void StaticPlanPropagatorState::PropagateOutputs(const TaggedNode& tagged_node,
+                                                 EntryVector* outputs,
+                                                 TaggedNodeSeq* ready) {
+  profiler::TraceMe activity(
+      [&]() {
+        return strings::StrCat(
+            "ExecutorPropagateOutputs#", "id=", step_id_,
+            ",kernel_name=", tagged_node.node_item->kernel->name_view(),
+            ",num_output_edges=", tagged_node.node_item->num_output_edges,
+            ",num_output_control_edges=",
+            tagged_node.node_item->num_output_control_edges, "#");
+      },
+      profiler::GetTFTraceMeLevel(/*is_expensive=*/false));
+
+  DCHECK(ready->empty());
+
+  // Control edges are implied by the plan order, so only data edges need to be
+  // followed.
+  for (const EdgeInfo& e : tagged_node.node_item->output_edges()) {
+    const int src_slot = e.output_slot;
+    const int dst_loc = e.input_slot;
+    if (e.is_last) {
+      input_tensors_[dst_loc] = std::move((*outputs)[src_slot]);
+    } else {
+      input_tensors_[dst_loc] = (*outputs)[src_slot];
+    }
+  }
+
+  const int32 next_index = tagged_node.plan_index + 1;
+  if (next_index < static_cast<int32>(plan_.size())) {
+    ready->emplace_back(plan_[next_index], next_index);
+  }
+}
+
+void StaticPlanPropagatorState::DumpState() {
+  mutex_lock l(mu_);
+  // Dump any waiting nodes that are holding on to tensors.
+  const int32 first_pending = active_index_ + 1;
+  for (int32 i = first_pending; i < static_cast<int32>(plan_.size()); ++i) {
+    DumpPendingNodeState(*plan_[i], input_tensors_.data(), false);
+  }
+  // Then the active node.
+  if (active_index_ >= 0) {
+    DumpActiveNodeState(*plan_[active_index_], input_tensors_.data());
+  }
+  // Show all input tensors in use.
+  size_t total_bytes = 0;
+  for (size_t i = 0; i < input_tensors_.size(); ++i) {
+    const Entry& input = input_tensors_[i];
+    const Tensor* tensor = GetTensorValueForDump(input);
+    if (tensor && tensor->IsInitialized()) {
+      LOG(WARNING) << "    Input " << i << ": "
+                   << strings::StrCat(
+                          "Tensor<type: ", DataTypeString(tensor->dtype()),
+                          " shape: ", tensor->shape().DebugString(),
+                          ", bytes: ", tensor->TotalBytes(), ">");
+      total_bytes += tensor->TotalBytes();
+    }
+  }
+  LOG(WARNING) << "    Total bytes " << total_bytes;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,153 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_PLAN_PROPAGATOR_STATE_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_PLAN_PROPAGATOR_STATE_H_
+
+#include <vector>
+
+#include "tensorflow/core/common_runtime/entry.h"
+#include "tensorflow/core/common_runtime/immutable_executor_state.h"
+#include "tensorflow/core/framework/control_flow.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Represents the ephemeral "edge state" associated with one invocation of
+// `Executor::Run()`, for graphs that have a precomputed static execution plan
+// (see `ImmutableExecutorState::BuildStaticPlan()`).
+//
+// `StaticPlanPropagatorState` executes the nodes of the graph one at a time in
+// the order given by the plan. Since the order is fixed, it does not track
+// pending counts: after a node has been processed, its outputs are written to
+// the pre-assigned input slots of its consumers, and the next node in the plan
+// becomes ready. This trades inter-op parallelism for the lowest per-step
+// overhead, which suits small graphs of cheap kernels.
+//
+// NOTE: Like `SimplePropagatorState`, `StaticPlanPropagatorState` does not
+// support "v1-style" control flow, and additionally requires that the graph
+// contain no asynchronous kernels.
+class StaticPlanPropagatorState {
+ public:
+  StaticPlanPropagatorState(const ImmutableExecutorState& immutable_state,
+                            int64_t step_id, bool vlog);
+  ~StaticPlanPropagatorState();
+
+  // A `TaggedNode` corresponds to a single invocation of a node's kernel,
+  // and it is created when the kernel becomes runnable.
+  struct TaggedNode {
+    const NodeItem* node_item;
+    // The position of `node_item` in the static plan.
+    int32 plan_index;
+
+    TaggedNode(const NodeItem* node_item, int32 plan_index)
+        : node_item(node_item), plan_index(plan_index) {}
+
+    const NodeItem& get_node_item() const { return *node_item; }
+
+    bool get_is_dead() const { return false; }
+    int64_t get_iter_num() const { return 0; }
+  };
+
+  // At most one node is ever ready at a time, so the queue holds at most one
+  // element.
+  class TaggedNodeReadyQueue {
+   public:
+    void push_back(const TaggedNode& node) {
+      DCHECK(ready_.empty());
+      ready_.push_back(node);
+    }
+    TaggedNode front() const {
+      DCHECK(!ready_.empty());
+      return ready_.front();
+    }
+    void pop_front() {
+      DCHECK(!ready_.empty());
+      ready_.clear();
+    }
+    bool empty() const { return ready_.empty(); }
+
+   private:
+    gtl::InlinedVector<TaggedNode, 1> ready_;
+  };
+
+  typedef gtl::InlinedVector<TaggedNode, 1> TaggedNodeSeq;
+
+  // Adds a `TaggedNode` for the first node of the plan to `*ready`. The plan
+  // already includes `roots`, so they are otherwise ignored.
+  void ActivateRoots(gtl::ArraySlice<const NodeItem*> roots,
+                     TaggedNodeSeq* ready);
+
+  // After processing the outputs, propagates the outputs to their dsts, and
+  // adds the next node of the plan (if any) to `*ready`.
+  // Contents of *outputs are left in an indeterminate state after
+  // returning from this method.
+  void PropagateOutputs(const TaggedNode& tagged_node, EntryVector* outputs,
+                        TaggedNodeSeq* ready);
+
+  // Returns an array of `Entry` objects corresponding to the inputs of
+  // `tagged_node`.
+  Entry* GetInputTensors(const TaggedNode& tagged_node) {
+    return input_tensors_.data() + tagged_node.node_item->input_start;
+  }
+
+  FrameAndIter GetFrameAndIter(const TaggedNode& tagged_node) const {
+    return {0, 0};
+  }
+
+  // Provide debugging output of the state of the executor.
+  void DumpState();
+
+  // For debugging/logging only.
+  void MaybeMarkStarted(const TaggedNode& tagged_node) {
+    if (TF_PREDICT_FALSE(vlog_) && VLOG_IS_ON(1)) {
+      mutex_lock l(mu_);
+      active_index_ = tagged_node.plan_index;
+    }
+  }
+  void MaybeMarkCompleted(const TaggedNode& tagged_node) {
+    if (TF_PREDICT_FALSE(vlog_) && VLOG_IS_ON(1)) {
+      mutex_lock l(mu_);
+      active_index_ = -1;
+    }
+  }
+
+ private:
+  const ImmutableExecutorState& immutable_state_;
+  const int64_t step_id_;
+  const bool vlog_;
+  const std::vector<const NodeItem*>& plan_;
+
+  // The i-th node's j-th input is stored at
+  // `input_tensors[impl_->nodes[i].input_start + j]`.
+  //
+  // NOTE: No need to protect input_tensors[i] by any locks because nodes are
+  // processed one at a time, and the hand-off between consecutive nodes
+  // happens on the same thread or through the runner.
+  std::vector<Entry> input_tensors_;
+
+  // If `vlog_` is true, this stores the plan index of the active node, or -1
+  // if no node is active.
+  mutex mu_;
+  int32 active_index_ TF_GUARDED_BY(mu_) = -1;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_PLAN_PROPAGATOR_STATE_H_
@@ -0,0 +1,136 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+namespace {
+
+inline size_t RoundUp(size_t n, size_t alignment) {
+  return (n + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+StepArenaAllocator::StepArenaAllocator(Allocator* base_allocator)
+    : base_allocator_(base_allocator) {}
+
+StepArenaAllocator::~StepArenaAllocator() {
+  // Allocations made after `EndStep()` may have started a new current block.
+  if (current_block_ != nullptr) {
+    UnrefBlock(current_block_);
+  }
+  DCHECK_EQ(num_live_blocks_.load(), 0);
+}
+
+void* StepArenaAllocator::AllocateRaw(size_t alignment, size_t num_bytes) {
+  if (num_bytes > kMaxArenaAllocationSize ||
+      alignment > Allocator::kAllocatorAlignment) {
+    return AllocateFromBase(alignment, num_bytes);
+  }
+
+  Block* block;
+  Block* retired_block = nullptr;
+  char* ptr;
+  {
+    mutex_lock l(mu_);
+    size_t offset = RoundUp(current_offset_ + sizeof(Header), alignment);
+    if (current_block_ == nullptr || offset + num_bytes > kBlockSize) {
+      void* data = base_allocator_->AllocateRaw(
+          Allocator::kAllocatorAlignment, kBlockSize);
+      if (data == nullptr) {
+        // Leave the current block in place, and let the base allocator report
+        // the failure for the individual allocation.
+        return AllocateFromBase(alignment, num_bytes);
+      }
+      retired_block = current_block_;
+      current_block_ = new Block;
+      current_block_->data = static_cast<char*>(data);
+      num_live_blocks_.fetch_add(1, std::memory_order_relaxed);
+      offset = RoundUp(sizeof(Header), alignment);
+    }
+    block = current_block_;
+    block->refs.fetch_add(1, std::memory_order_relaxed);
+    current_offset_ = offset + num_bytes;
+    ptr = block->data + offset;
+  }
+  if (retired_block != nullptr) {
+    UnrefBlock(retired_block);
+  }
+
+  Header* header = reinterpret_cast<Header*>(ptr) - 1;
+  header->block = block;
+  header->base_ptr = nullptr;
+  Ref();
+  return ptr;
+}
+
+void* StepArenaAllocator::AllocateFromBase(size_t alignment,
+                                           size_t num_bytes) {
+  // Reserve a whole alignment unit in front of the allocation for the header,
+  // so that the returned pointer keeps the requested alignment.
+  const size_t header_bytes =
+      std::max(alignment, Allocator::kAllocatorAlignment);
+  void* base_ptr =
+      base_allocator_->AllocateRaw(header_bytes, header_bytes + num_bytes);
+  if (base_ptr == nullptr) return nullptr;
+  char* ptr = static_cast<char*>(base_ptr) + header_bytes;
+  Header* header = reinterpret_cast<Header*>(ptr) - 1;
+  header->block = nullptr;
+  header->base_ptr = base_ptr;
+  Ref();
+  return ptr;
+}
+
+void StepArenaAllocator::DeallocateRaw(void* ptr) {
+  if (ptr == nullptr) return;
+  const Header* header = reinterpret_cast<const Header*>(ptr) - 1;
+  if (header->block != nullptr) {
+    UnrefBlock(header->block);
+  } else {
+    base_allocator_->DeallocateRaw(header->base_ptr);
+  }
+  // May delete `this`.
+  Unref();
+}
+
+void StepArenaAllocator::UnrefBlock(Block* block) {
+  if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    base_allocator_->DeallocateRaw(block->data);
+    delete block;
+    num_live_blocks_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+void StepArenaAllocator::EndStep() {
+  Block* retired_block;
+  {
+    mutex_lock l(mu_);
+    retired_block = current_block_;
+    current_block_ = nullptr;
+    current_offset_ = 0;
+  }
+  if (retired_block != nullptr) {
+    UnrefBlock(retired_block);
+  }
+  // May delete `this`.
+  Unref();
+}
+
+}  // namespace tensorflow
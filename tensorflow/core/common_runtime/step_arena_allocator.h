@@ -0,0 +1,111 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
+
+#include <atomic>
+#include <string>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// StepArenaAllocator is a bump-pointer allocator for the host tensors that
+// kernels allocate during a single step. It carves allocations out of large
+// blocks obtained from a base allocator, so that most allocations take a
+// short critical section instead of a trip through the general purpose
+// allocator, and the blocks are returned to the base allocator in bulk.
+//
+// Tensors may outlive the step that allocated them (e.g. fetched outputs, or
+// values stored in resources), so blocks are not freed unconditionally at the
+// end of the step. Instead each block counts its live allocations, and is
+// returned to the base allocator once it is no longer used for new
+// allocations and all of its allocations have been deallocated. An escaping
+// tensor therefore pins at most the block it was allocated from. Allocations
+// larger than `kMaxArenaAllocationSize` bypass the arena altogether.
+//
+// The allocator is reference counted: the owner of the step holds one
+// reference, which it drops by calling `EndStep()`, and every live allocation
+// holds another, so the object is deleted after the step has ended and the
+// last allocation has been deallocated.
+class StepArenaAllocator : public Allocator, public core::RefCounted {
+ public:
+  // The size of the blocks requested from the base allocator.
+  static constexpr size_t kBlockSize = 1 << 20;
+  // Allocations larger than this are forwarded to the base allocator.
+  static constexpr size_t kMaxArenaAllocationSize = 64 << 10;
+
+  // Does not take ownership of `base_allocator`, which must outlive every
+  // allocation made through this allocator.
+  explicit StepArenaAllocator(Allocator* base_allocator);
+
+  std::string Name() override { return "step_arena"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void DeallocateRaw(void* ptr) override;
+  AllocatorMemoryType GetMemoryType() const override {
+    return base_allocator_->GetMemoryType();
+  }
+
+  // Stops serving allocations from the current block, and drops the
+  // reference held by the owner of the step. The caller must not use this
+  // allocator after calling `EndStep()`.
+  void EndStep();
+
+  // Returns the number of blocks that have been obtained from the base
+  // allocator and not yet returned. For testing.
+  int64_t NumLiveBlocksForTest() const {
+    return num_live_blocks_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Block {
+    char* data;
+    // The number of live allocations in this block, plus one while the block
+    // is current.
+    std::atomic<int64_t> refs{1};
+  };
+
+  // Stored immediately before every pointer returned by `AllocateRaw()`.
+  struct Header {
+    // The block that the allocation belongs to, or nullptr if the allocation
+    // was forwarded to the base allocator.
+    Block* block;
+    // If `block` is nullptr, the pointer returned by the base allocator.
+    void* base_ptr;
+  };
+
+  ~StepArenaAllocator() override;
+
+  void* AllocateFromBase(size_t alignment, size_t num_bytes);
+  // Drops a reference on `block`, and frees it if it was the last one.
+  void UnrefBlock(Block* block);
+
+  Allocator* const base_allocator_;
+  std::atomic<int64_t> num_live_blocks_{0};
+
+  mutex mu_;
+  Block* current_block_ TF_GUARDED_BY(mu_) = nullptr;
+  size_t current_offset_ TF_GUARDED_BY(mu_) = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(StepArenaAllocator);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
@@ -0,0 +1,117 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+bool IsAligned(void* ptr, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST(StepArenaAllocatorTest, SmallAllocationsShareBlocks) {
+  StepArenaAllocator* arena = new StepArenaAllocator(cpu_allocator());
+  arena->Ref();  // Keep the arena alive to inspect it after EndStep().
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 100; ++i) {
+    void* ptr = arena->AllocateRaw(Allocator::kAllocatorAlignment, 1000);
+    ASSERT_NE(nullptr, ptr);
+    EXPECT_TRUE(IsAligned(ptr, Allocator::kAllocatorAlignment));
+    memset(ptr, i, 1000);
+    ptrs.push_back(ptr);
+  }
+  EXPECT_EQ(1, arena->NumLiveBlocksForTest());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(static_cast<char>(i), static_cast<char*>(ptrs[i])[999]);
+    arena->DeallocateRaw(ptrs[i]);
+  }
+  // The current block is kept until the end of the step.
+  EXPECT_EQ(1, arena->NumLiveBlocksForTest());
+  arena->EndStep();
+  EXPECT_EQ(0, arena->NumLiveBlocksForTest());
+  arena->Unref();
+}
+
+TEST(StepArenaAllocatorTest, LargeAndOveralignedAllocationsBypassArena) {
+  StepArenaAllocator* arena = new StepArenaAllocator(cpu_allocator());
+  void* large = arena->AllocateRaw(Allocator::kAllocatorAlignment,
+                                   StepArenaAllocator::kMaxArenaAllocationSize +
+                                       1);
+  void* aligned = arena->AllocateRaw(4096, 16);
+  ASSERT_NE(nullptr, large);
+  ASSERT_NE(nullptr, aligned);
+  EXPECT_TRUE(IsAligned(large, Allocator::kAllocatorAlignment));
+  EXPECT_TRUE(IsAligned(aligned, 4096));
+  EXPECT_EQ(0, arena->NumLiveBlocksForTest());
+  arena->DeallocateRaw(large);
+  arena->DeallocateRaw(aligned);
+  arena->EndStep();
+}
+
+TEST(StepArenaAllocatorTest, TensorOutlivesStep) {
+  StepArenaAllocator* arena = new StepArenaAllocator(cpu_allocator());
+  Tensor t(arena, DT_FLOAT, TensorShape({4}));
+  test::FillValues<float>(&t, {1, 2, 3, 4});
+  arena->EndStep();
+  // The tensor still holds a reference on the arena and its block.
+  test::ExpectTensorEqual<float>(
+      t, test::AsTensor<float>({1, 2, 3, 4}, TensorShape({4})));
+}
+
+TEST(StepArenaAllocatorTest, ConcurrentAllocations) {
+  constexpr int kNumThreads = 8;
+  constexpr int kAllocsPerThread = 1000;
+  StepArenaAllocator* arena = new StepArenaAllocator(cpu_allocator());
+  {
+    thread::ThreadPool pool(Env::Default(), "test", kNumThreads);
+    for (int t = 0; t < kNumThreads; ++t) {
+      pool.Schedule([arena, t]() {
+        std::vector<void*> ptrs;
+        for (int i = 0; i < kAllocsPerThread; ++i) {
+          const size_t num_bytes = 16 + (i * 97) % 4096;
+          char* ptr = static_cast<char*>(
+              arena->AllocateRaw(Allocator::kAllocatorAlignment, num_bytes));
+          ptr[0] = static_cast<char>(t);
+          ptr[num_bytes - 1] = static_cast<char>(t);
+          ptrs.push_back(ptr);
+          if (i % 2 == 1) {
+            arena->DeallocateRaw(ptrs[i / 2]);
+            ptrs[i / 2] = nullptr;
+          }
+        }
+        for (void* ptr : ptrs) {
+          if (ptr == nullptr) continue;
+          EXPECT_EQ(static_cast<char>(t), static_cast<char*>(ptr)[0]);
+          arena->DeallocateRaw(ptr);
+        }
+      });
+    }
+  }
+  arena->EndStep();
+}
+
+}  // namespace
+}  // namespace tensorflow
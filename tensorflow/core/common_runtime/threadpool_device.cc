@@ -26,6 +26,8 @@ info. It does not have any negative impact on performance. */
 #endif
 #endif  // ENABLE_ONEDNN_OPENMP && ENABLE_MKL &&_OPENMP
 
+#include <vector>
+
 #include "absl/base/call_once.h"
 #include "absl/container/flat_hash_set.h"
 #include "tensorflow/core/common_runtime/local_device.h"
@@ -40,7 +42,11 @@ info. It does not have any negative impact on performance. */
 #include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/types.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/public/session_options.h"
@@ -53,6 +59,41 @@ info. It does not have any negative impact on performance. */
 
 namespace tensorflow {
 
+namespace {
+
+// Returns the inter-op thread pool for `numa_node`, whose threads are pinned to
+// that node. Like the intra-op pools of `LocalDevice`, the pool is shared by
+// all devices in the process on the same node, and is never deleted.
+thread::ThreadPool* NUMAInterOpThreadPool(const SessionOptions& options,
+                                          int numa_node) {
+  static mutex* mu = new mutex;
+  static std::vector<thread::ThreadPool*>* pools =
+      new std::vector<thread::ThreadPool*>;
+  mutex_lock l(*mu);
+  if (pools->size() <= static_cast<size_t>(numa_node)) {
+    pools->resize(numa_node + 1, nullptr);
+  }
+  thread::ThreadPool*& pool = (*pools)[numa_node];
+  if (pool == nullptr) {
+    int32_t num_threads = options.config.inter_op_parallelism_threads();
+    if (num_threads == 0) {
+      num_threads = port::MaxParallelism(numa_node);
+    }
+    VLOG(1) << "Creating inter op thread pool for NUMA node " << numa_node
+            << " with " << num_threads << " threads";
+    ThreadOptions thread_opts;
+    thread_opts.numa_node = numa_node;
+    pool = new thread::ThreadPool(
+        options.env, thread_opts,
+        strings::StrCat("numa_", numa_node, "_Compute"), num_threads,
+        !options.config.experimental().disable_thread_spinning(),
+        /*allocator=*/nullptr);
+  }
+  return pool;
+}
+
+}  // namespace
+
 ThreadPoolDevice::ThreadPoolDevice(const SessionOptions& options,
                                    const string& name, Bytes memory_limit,
                                    const DeviceLocality& locality,
@@ -61,6 +102,17 @@ ThreadPoolDevice::ThreadPoolDevice(const SessionOptions& options,
                                name, DEVICE_CPU, memory_limit, locality)),
       allocator_(allocator),
       scoped_allocator_mgr_(new ScopedAllocatorMgr(name)) {
+  // With NUMA affinity, run the kernels of this device on threads of its own
+  // NUMA node, rather than on the session's inter-op thread pool. A negative
+  // `inter_op_parallelism_threads` requests that kernels run inline in the
+  // caller, so keep the session's behavior in that case.
+  if (options.config.experimental().use_numa_affinity() &&
+      locality.numa_node() != port::kNUMANoAffinity &&
+      options.config.inter_op_parallelism_threads() >= 0) {
+    set_tensorflow_device_thread_pool(
+        NUMAInterOpThreadPool(options, locality.numa_node()));
+  }
+
   auto s = NodeFileWriter::GetNodeFileWriterIfEnabled(name, env());
   if (!s.ok()) {
     LOG(ERROR) << s.status();
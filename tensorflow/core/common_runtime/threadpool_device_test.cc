@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/threadpool_device.h"
 
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/public/session_options.h"
 
@@ -68,5 +69,28 @@ TEST(ThreadPoolDeviceTest, CopyTensor) {
   device_context->Unref();
 }
 
+TEST(ThreadPoolDeviceTest, NUMAAffinityUsesDeviceThreadPool) {
+  SessionOptions options;
+  ThreadPoolDevice default_device(options, "/device:CPU:0", Bytes(256),
+                                  DeviceLocality(), cpu_allocator());
+  EXPECT_EQ(nullptr, default_device.tensorflow_device_thread_pool());
+
+  options.config.mutable_experimental()->set_use_numa_affinity(true);
+  DeviceLocality locality;
+  locality.set_numa_node(0);
+  ThreadPoolDevice numa_device(options, "/device:CPU:1", Bytes(256), locality,
+                               cpu_allocator());
+  thread::ThreadPool* pool = numa_device.tensorflow_device_thread_pool();
+  ASSERT_NE(nullptr, pool);
+  // Devices on the same NUMA node share the pool.
+  ThreadPoolDevice other_device(options, "/device:CPU:2", Bytes(256), locality,
+                                cpu_allocator());
+  EXPECT_EQ(pool, other_device.tensorflow_device_thread_pool());
+
+  Notification note;
+  pool->Schedule([&note]() { note.Notify(); });
+  note.WaitForNotification();
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -0,0 +1,121 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_WORK_STEALING_READY_QUEUE_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_WORK_STEALING_READY_QUEUE_H_
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <utility>
+
+#include "absl/types/optional.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Returns a small integer identifying the calling thread. Ids are handed out
+// round-robin on first use and are stable for the lifetime of the thread.
+inline int WorkStealingThreadId() {
+  static std::atomic<int> next_id{0};
+  static thread_local int id = next_id.fetch_add(1, std::memory_order_relaxed);
+  return id;
+}
+
+// WorkStealingReadyQueue is a set of per-worker deques of ready items, used by
+// the executor to keep the successors of a node on the thread that produced
+// their inputs.
+//
+// The thread that makes an item ready pushes it to the back of its own deque
+// with `PushLocal()`, and later drains it with `PopLocal()`, which takes the
+// most recently pushed item (LIFO, so its inputs are likely still in cache).
+// Idle threads call `Steal()`, which takes the oldest item from their own deque
+// or, failing that, from the deques of other workers (FIFO).
+//
+// Each deque is protected by its own mutex, so that the owner and thieves only
+// contend when they operate on the same deque at the same time.
+//
+// Every pushed item is returned by exactly one call to `PopLocal()` or
+// `Steal()`.
+template <typename T>
+class WorkStealingReadyQueue {
+ public:
+  explicit WorkStealingReadyQueue(int num_workers)
+      : num_workers_(num_workers > 0 ? num_workers : 1),
+        queues_(new Queue[num_workers_]) {}
+
+  int num_workers() const { return num_workers_; }
+
+  // Adds `item` to the back of the calling thread's deque.
+  void PushLocal(const T& item) {
+    Queue& q = queues_[LocalIndex()];
+    mutex_lock l(q.mu);
+    q.items.push_back(item);
+    q.size.store(q.items.size(), std::memory_order_relaxed);
+  }
+
+  // Removes and returns the most recently pushed item from the calling
+  // thread's deque. Returns `absl::nullopt` if the deque is empty.
+  absl::optional<T> PopLocal() {
+    Queue& q = queues_[LocalIndex()];
+    if (q.size.load(std::memory_order_relaxed) == 0) return absl::nullopt;
+    mutex_lock l(q.mu);
+    if (q.items.empty()) return absl::nullopt;
+    absl::optional<T> item(std::move(q.items.back()));
+    q.items.pop_back();
+    q.size.store(q.items.size(), std::memory_order_relaxed);
+    return item;
+  }
+
+  // Removes and returns the oldest item from the first non-empty deque,
+  // starting with the calling thread's own deque. Returns `absl::nullopt` if
+  // all deques are empty.
+  absl::optional<T> Steal() {
+    const int start = LocalIndex();
+    for (int i = 0; i < num_workers_; ++i) {
+      Queue& q = queues_[(start + i) % num_workers_];
+      // Skip empty deques without taking their lock.
+      if (q.size.load(std::memory_order_relaxed) == 0) continue;
+      mutex_lock l(q.mu);
+      if (q.items.empty()) continue;
+      absl::optional<T> item(std::move(q.items.front()));
+      q.items.pop_front();
+      q.size.store(q.items.size(), std::memory_order_relaxed);
+      return item;
+    }
+    return absl::nullopt;
+  }
+
+ private:
+  // Aligned to avoid false sharing between the deques of different workers.
+  struct alignas(64) Queue {
+    mutex mu;
+    std::deque<T> items TF_GUARDED_BY(mu);
+    // Approximate size of `items`, readable without holding `mu`.
+    std::atomic<size_t> size{0};
+  };
+
+  int LocalIndex() const { return WorkStealingThreadId() % num_workers_; }
+
+  const int num_workers_;
+  std::unique_ptr<Queue[]> queues_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(WorkStealingReadyQueue);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_WORK_STEALING_READY_QUEUE_H_
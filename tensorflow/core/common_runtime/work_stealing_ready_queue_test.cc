@@ -0,0 +1,93 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/work_stealing_ready_queue.h"
+
+#include <atomic>
+#include <vector>
+
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(WorkStealingReadyQueueTest, PopLocalIsLifo) {
+  WorkStealingReadyQueue<int> queue(4);
+  for (int i = 0; i < 3; ++i) queue.PushLocal(i);
+  for (int i = 2; i >= 0; --i) {
+    absl::optional<int> item = queue.PopLocal();
+    ASSERT_TRUE(item.has_value());
+    EXPECT_EQ(i, *item);
+  }
+  EXPECT_FALSE(queue.PopLocal().has_value());
+}
+
+TEST(WorkStealingReadyQueueTest, StealIsFifo) {
+  WorkStealingReadyQueue<int> queue(4);
+  for (int i = 0; i < 3; ++i) queue.PushLocal(i);
+  for (int i = 0; i < 3; ++i) {
+    absl::optional<int> item = queue.Steal();
+    ASSERT_TRUE(item.has_value());
+    EXPECT_EQ(i, *item);
+  }
+  EXPECT_FALSE(queue.Steal().has_value());
+}
+
+TEST(WorkStealingReadyQueueTest, StealFromOtherThread) {
+  WorkStealingReadyQueue<int> queue(4);
+  queue.PushLocal(42);
+  absl::optional<int> stolen;
+  std::unique_ptr<Thread> thread(Env::Default()->StartThread(
+      ThreadOptions(), "thief", [&queue, &stolen]() {
+        // The thief's own deque may be empty, but the item is still found.
+        stolen = queue.Steal();
+      }));
+  thread.reset();
+  ASSERT_TRUE(stolen.has_value());
+  EXPECT_EQ(42, *stolen);
+  EXPECT_FALSE(queue.PopLocal().has_value());
+}
+
+TEST(WorkStealingReadyQueueTest, EveryItemReturnedOnce) {
+  constexpr int kNumThreads = 8;
+  constexpr int kItemsPerThread = 1000;
+  WorkStealingReadyQueue<int> queue(kNumThreads);
+  std::vector<std::atomic<int>> seen(kNumThreads * kItemsPerThread);
+  {
+    thread::ThreadPool pool(Env::Default(), "test", kNumThreads);
+    for (int t = 0; t < kNumThreads; ++t) {
+      pool.Schedule([&queue, &seen, t]() {
+        for (int i = 0; i < kItemsPerThread; ++i) {
+          queue.PushLocal(t * kItemsPerThread + i);
+          // Drain roughly half of the items locally and steal the rest.
+          absl::optional<int> item =
+              (i % 2 == 0) ? queue.PopLocal() : queue.Steal();
+          if (item) seen[*item].fetch_add(1);
+        }
+      });
+    }
+  }
+  while (absl::optional<int> item = queue.Steal()) {
+    seen[*item].fetch_add(1);
+  }
+  for (int i = 0; i < kNumThreads * kItemsPerThread; ++i) {
+    EXPECT_EQ(1, seen[i].load()) << "item " << i;
+  }
+}
+
+}  // namespace
+}  // namespace tensorflow
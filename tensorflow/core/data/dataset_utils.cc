@@ -907,6 +907,7 @@ namespace {
 REGISTER_DATASET_EXPERIMENT("allow_small_function_optimizations", 0);
 REGISTER_DATASET_EXPERIMENT(kFilterParallelizationOpt, 0);
 REGISTER_DATASET_EXPERIMENT("inject_prefetch", 100);
+REGISTER_DATASET_EXPERIMENT("map_vectorization", 0);
 REGISTER_DATASET_EXPERIMENT("min_outer_interleave_parallelism", 0);
 REGISTER_DATASET_EXPERIMENT("reduce_interleave_prefetch", 0);
 REGISTER_DATASET_EXPERIMENT("stage_based_autotune", 0);
@@ -15,6 +15,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_H_
 #define TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_H_
 
+#include <atomic>
+#include <algorithm>
 #include <cstddef>
 #include <deque>
 #include <functional>
@@ -46,7 +48,10 @@ namespace data {
 // collected when the cache becomes full. Consequently, trainers read from a
 // sliding window through the dataset and may not read the full dataset.
 //
-// The `CrossTrainerCache` class is thread-safe.
+// The `CrossTrainerCache` class is thread-safe. Trainers that read cached
+// elements only hold a shared lock, and advance their own read cursors with
+// atomic updates, so concurrent trainers do not serialize on cache hits. The
+// exclusive lock is only held to add new trainers and to extend the cache.
 //
 // Example usage:
 //
@@ -129,18 +134,24 @@ class CrossTrainerCache {
   // Returns the next element and metrics about this query.
   StatusOr<CacheQueryResult> GetCacheQueryResult(const std::string& trainer_id);
 
-  // Returns true if element is ready for `trainer_id`. An element is ready if
-  // other trainers have read the data and the data remains in the cache. If the
-  // data is not ready, one of the trainers need to extend the cache.
-  bool IsElementReady(const std::string& trainer_id);
+  // The absolute index relative to the dataset (not relative to the cached
+  // elements) of the next element a trainer reads. Trainers with concurrent
+  // `Get` calls update their cursor with compare-and-swap.
+  using ReadCursor = std::atomic<size_t>;
 
-  // Returns the absolute element index relative to the dataset (not relative to
-  // the cached elements).
-  size_t GetElementIndex(const std::string& trainer_id);
+  // Returns the read cursor of `trainer_id`, or nullptr if the trainer has not
+  // read from the cache yet.
+  ReadCursor* FindReadCursor(const std::string& trainer_id) const;
 
-  // Returns the next element for `trainer_id`.
-  StatusOr<std::shared_ptr<const ElementType>> GetElement(
-      const std::string& trainer_id);
+  // Returns the read cursor of `trainer_id`, adding it if needed.
+  ReadCursor* GetOrCreateReadCursor(const std::string& trainer_id);
+
+  // Returns the next element for `cursor` and advances it, or nullptr if the
+  // element is not ready. An element is ready if other trainers have read the
+  // data and the data remains in the cache. If the data is not ready, one of
+  // the trainers need to extend the cache.
+  StatusOr<std::shared_ptr<const ElementType>> GetElement(ReadCursor& cursor)
+      const;
 
   // Reads a new element and writes it into the cache.
   Status ExtendCache();
@@ -167,17 +178,21 @@ class CrossTrainerCache {
 
   // `cache_` stores the cached elements.
   std::deque<std::shared_ptr<const ElementType>> cache_ TF_GUARDED_BY(mu_);
-  size_t cache_size_bytes_ TF_GUARDED_BY(mu_) = 0;
   size_t cache_start_index_ TF_GUARDED_BY(mu_) = 0;
 
+  // The sum of `GetElementSizeBytes` of the cached elements. It is only
+  // updated under `mu_`, but may be read without it to record metrics.
+  std::atomic<size_t> cache_size_bytes_{0};
+
   // True if one thread is extending the cache.
   bool extending_cache_ TF_GUARDED_BY(mu_) = false;
 
-  // Maps trainer IDs to element indices. The indices are absolute indices
+  // Maps trainer IDs to their read cursors. The indices are absolute indices
   // within the dataset. The actual index to use with `cache_` would be
-  // `trainer_to_element_index_map_[trainer_id] - cache_start_index_`.
-  absl::flat_hash_map<std::string, size_t> trainer_to_element_index_map_
-      TF_GUARDED_BY(mu_);
+  // `*trainer_to_element_index_map_[trainer_id] - cache_start_index_`.
+  // The cursors may be updated while holding a shared lock on `mu_`.
+  absl::flat_hash_map<std::string, std::unique_ptr<ReadCursor>>
+      trainer_to_element_index_map_ TF_GUARDED_BY(mu_);
 };
 
 template <class ElementType>
@@ -213,11 +228,25 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
   bool should_extend_cache = false;
   while (true) {
     {
-      mutex_lock l(mu_);
+      tf_shared_lock l(mu_);
       TF_RETURN_IF_ERROR(status_);
-      if (IsElementReady(trainer_id)) {
+      ReadCursor* cursor = FindReadCursor(trainer_id);
+      if (cursor != nullptr) {
         TF_ASSIGN_OR_RETURN(std::shared_ptr<const ElementType> element,
-                            GetElement(trainer_id));
+                            GetElement(*cursor));
+        if (element != nullptr) {
+          return CacheQueryResult{element,
+                                  /*is_cache_hit=*/!should_extend_cache};
+        }
+      }
+    }
+
+    {
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(status_);
+      TF_ASSIGN_OR_RETURN(std::shared_ptr<const ElementType> element,
+                          GetElement(*GetOrCreateReadCursor(trainer_id)));
+      if (element != nullptr) {
         return CacheQueryResult{element,
                                 /*is_cache_hit=*/!should_extend_cache};
       }
@@ -245,36 +274,47 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
 }
 
 template <class ElementType>
-bool CrossTrainerCache<ElementType>::IsElementReady(
-    const std::string& trainer_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-  return GetElementIndex(trainer_id) < cache_start_index_ + cache_.size();
+typename CrossTrainerCache<ElementType>::ReadCursor*
+CrossTrainerCache<ElementType>::FindReadCursor(const std::string& trainer_id)
+    const TF_SHARED_LOCKS_REQUIRED(mu_) {
+  auto it = trainer_to_element_index_map_.find(trainer_id);
+  return it == trainer_to_element_index_map_.end() ? nullptr
+                                                   : it->second.get();
 }
 
 template <class ElementType>
-StatusOr<std::shared_ptr<const ElementType>>
-CrossTrainerCache<ElementType>::GetElement(const std::string& trainer_id)
-    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-  size_t element_index = GetElementIndex(trainer_id);
-  if (element_index >= std::numeric_limits<size_t>::max()) {
-    return errors::Internal(
-        "tf.data service caching element index exceeds integer limit. Got ",
-        element_index);
+typename CrossTrainerCache<ElementType>::ReadCursor*
+CrossTrainerCache<ElementType>::GetOrCreateReadCursor(
+    const std::string& trainer_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  std::unique_ptr<ReadCursor>& cursor =
+      trainer_to_element_index_map_[trainer_id];
+  if (cursor == nullptr) {
+    cursor = std::make_unique<ReadCursor>(0);
   }
-
-  std::shared_ptr<const ElementType> result =
-      cache_[element_index - cache_start_index_];
-  trainer_to_element_index_map_[trainer_id] = element_index + 1;
-  return result;
+  return cursor.get();
 }
 
 template <class ElementType>
-size_t CrossTrainerCache<ElementType>::GetElementIndex(
-    const std::string& trainer_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-  size_t element_index = trainer_to_element_index_map_[trainer_id];
-  if (element_index < cache_start_index_) {
-    element_index = cache_start_index_;
+StatusOr<std::shared_ptr<const ElementType>>
+CrossTrainerCache<ElementType>::GetElement(ReadCursor& cursor) const
+    TF_SHARED_LOCKS_REQUIRED(mu_) {
+  size_t next_index = cursor.load(std::memory_order_relaxed);
+  while (true) {
+    // Trainers that fall behind skip the elements that have been freed.
+    const size_t element_index = std::max(next_index, cache_start_index_);
+    if (element_index >= cache_start_index_ + cache_.size()) {
+      return std::shared_ptr<const ElementType>();
+    }
+    if (element_index >= std::numeric_limits<size_t>::max()) {
+      return errors::Internal(
+          "tf.data service caching element index exceeds integer limit. Got ",
+          element_index);
+    }
+    if (cursor.compare_exchange_weak(next_index, element_index + 1,
+                                     std::memory_order_relaxed)) {
+      return cache_[element_index - cache_start_index_];
+    }
   }
-  return element_index;
 }
 
 template <class ElementType>
@@ -293,7 +333,8 @@ Status CrossTrainerCache<ElementType>::ExtendCache() TF_LOCKS_EXCLUDED(mu_) {
   TF_RETURN_IF_ERROR(status_);
   FreeSpace(new_element_size_bytes);
   cache_.push_back(std::make_shared<ElementType>(std::move(element)));
-  cache_size_bytes_ += new_element_size_bytes;
+  cache_size_bytes_.fetch_add(new_element_size_bytes,
+                              std::memory_order_relaxed);
   return OkStatus();
 }
 
@@ -301,19 +342,22 @@ template <class ElementType>
 void CrossTrainerCache<ElementType>::FreeSpace(size_t new_element_size_bytes)
     TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   size_t num_elements_discarded = 0;
+  size_t cache_size_bytes = cache_size_bytes_.load(std::memory_order_relaxed);
   while (!cache_.empty() &&
-         cache_size_bytes_ + new_element_size_bytes > max_cache_size_bytes_) {
+         cache_size_bytes + new_element_size_bytes > max_cache_size_bytes_) {
     size_t free_bytes =
         cachable_sequence_->GetElementSizeBytes(*cache_.front());
     cache_.pop_front();
-    cache_size_bytes_ -= free_bytes;
+    cache_size_bytes -= free_bytes;
     ++cache_start_index_;
     ++num_elements_discarded;
   }
 
+  cache_size_bytes_.store(cache_size_bytes, std::memory_order_relaxed);
+
   VLOG(3) << "Freed " << num_elements_discarded << " element(s) from "
           << "tf.data service cross-trainer cache. Memory usage: "
-          << FormatBytes(cache_size_bytes_) << ".";
+          << FormatBytes(cache_size_bytes) << ".";
 }
 
 template <class ElementType>
@@ -332,7 +376,7 @@ void CrossTrainerCache<ElementType>::Cancel(Status status)
 template <class ElementType>
 bool CrossTrainerCache<ElementType>::IsCancelled() const
     TF_LOCKS_EXCLUDED(mu_) {
-  mutex_lock l(mu_);
+  tf_shared_lock l(mu_);
   return !status_.ok();
 }
 
@@ -340,12 +384,8 @@ template <class ElementType>
 void CrossTrainerCache<ElementType>::RecordMetrics(
     const CacheQueryResult& result) {
   metrics::RecordTFDataServiceCrossTrainerCacheQuery(result.cache_hit);
-  size_t cache_size_bytes = 0;
-  {
-    mutex_lock l(mu_);
-    cache_size_bytes = cache_size_bytes_;
-  }
-  metrics::RecordTFDataServiceCrossTrainerCacheSizeBytes(cache_size_bytes);
+  metrics::RecordTFDataServiceCrossTrainerCacheSizeBytes(
+      cache_size_bytes_.load(std::memory_order_relaxed));
 }
 
 }  // namespace data
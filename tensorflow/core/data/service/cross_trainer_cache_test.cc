@@ -355,6 +355,35 @@ TEST(CrossTrainerCacheTest, ConcurrentReadersFromOneTrainer) {
   EXPECT_THAT(results, UnorderedElementsAreArray(GetRange(1000)));
 }
 
+TEST(CrossTrainerCacheTest, ConcurrentTrainersReadCachedElements) {
+  size_t num_trainers = 16;
+  size_t num_elements_to_read = 500;
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/num_elements_to_read * sizeof(int64_t),
+      std::make_unique<InfiniteRange>());
+
+  std::vector<std::vector<int64_t>> results(num_trainers);
+  std::vector<std::unique_ptr<Thread>> reader_threads;
+  for (size_t i = 0; i < num_trainers; ++i) {
+    std::vector<int64_t>& result = results[i];
+    reader_threads.push_back(absl::WrapUnique(Env::Default()->StartThread(
+        /*thread_options=*/{}, /*name=*/absl::StrCat("Trainer_", i),
+        [&cache, num_elements_to_read, &result, i]() {
+          for (size_t j = 0; j < num_elements_to_read; ++j) {
+            TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<const int64_t> next,
+                                    cache.Get(absl::StrCat("Trainer_", i)));
+            result.push_back(*next);
+          }
+        })));
+  }
+  reader_threads.clear();
+
+  // Nothing is evicted, so every trainer reads every element once, in order.
+  for (const std::vector<int64_t>& result : results) {
+    EXPECT_EQ(result, GetRange(num_elements_to_read));
+  }
+}
+
 TEST(CrossTrainerCacheTest, Cancel) {
   size_t num_trainers = 10;
   CrossTrainerCache<Tensor> cache(
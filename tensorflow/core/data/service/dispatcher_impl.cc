@@ -64,6 +64,7 @@ limitations under the License.
 #include "tensorflow/core/protobuf/data_service.pb.h"
 #include "tensorflow/core/protobuf/service_config.pb.h"
 #include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -108,6 +109,19 @@ std::string DatasetsDir(const std::string& work_dir) {
   return io::JoinPath(work_dir, kDatasetsDir);
 }
 
+// Returns true if the dispatcher should compact its journal after restoring
+// its state from it. This is controlled by the
+// TF_DATA_DISPATCHER_COMPACT_JOURNAL environment variable.
+bool CompactJournalOnRestore() {
+  static const bool compact = [] {
+    bool compact;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_DATA_DISPATCHER_COMPACT_JOURNAL",
+                                   /*default_val=*/false, &compact));
+    return compact;
+  }();
+  return compact;
+}
+
 std::string DatasetKey(const std::string& dataset_id, uint64 fingerprint) {
   return absl::StrCat("id_", dataset_id, "_fp_", fingerprint);
 }
@@ -224,6 +238,9 @@ Status DataServiceDispatcherImpl::Start() {
       TF_RETURN_IF_ERROR(ApplyWithoutJournaling(update));
       TF_RETURN_IF_ERROR(reader.Read(update, end_of_journal));
     }
+    if (CompactJournalOnRestore()) {
+      TF_RETURN_IF_ERROR(CompactJournal(env_, JournalDir(config_.work_dir())));
+    }
   }
   for (const auto& iteration : state_.ListIterations()) {
     if (IsDynamicShard(iteration->job->processing_mode)) {
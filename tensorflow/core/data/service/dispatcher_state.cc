@@ -83,6 +83,8 @@ Status DispatcherState::Apply(const Update& update) {
     case Update::kFinishTask:
       FinishTask(update.finish_task());
       break;
+    case Update::kCompactedJournal:
+      break;
     case Update::UPDATE_TYPE_NOT_SET:
       return errors::Internal("Update type not set.");
   }
@@ -190,7 +192,8 @@ void DispatcherState::ProduceSplit(const ProduceSplitUpdate& produce_split) {
     state.indices[provider_index] = 0;
     return;
   }
-  state.indices[provider_index]++;
+  state.indices[provider_index] +=
+      std::max<int64_t>(produce_split.num_splits(), 1);
 }
 
 void DispatcherState::AcquireIterationClient(
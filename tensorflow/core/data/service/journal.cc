@@ -16,9 +16,15 @@ limitations under the License.
 #include "tensorflow/core/data/service/journal.h"
 
 #include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
 #include "tensorflow/core/data/service/journal.pb.h"
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/record_writer.h"
@@ -41,6 +47,90 @@ Status ParseSequenceNumber(const std::string& journal_file,
   }
   return OkStatus();
 }
+
+// Lists the sequence numbers of the journal files in `journal_dir`.
+Status ListSequenceNumbers(Env* env, const std::string& journal_dir,
+                           std::vector<int64_t>& sequence_numbers) {
+  std::vector<std::string> journal_files;
+  TF_RETURN_IF_ERROR(env->GetChildren(journal_dir, &journal_files));
+  for (const auto& file : journal_files) {
+    int64_t sequence_number;
+    TF_RETURN_IF_ERROR(ParseSequenceNumber(file, &sequence_number));
+    sequence_numbers.push_back(sequence_number);
+  }
+  return OkStatus();
+}
+
+// Returns true if `journal_file` starts with a `CompactedJournalUpdate`.
+bool IsCompactedJournalFile(Env* env, const std::string& journal_file) {
+  std::unique_ptr<RandomAccessFile> file;
+  if (!env->NewRandomAccessFile(journal_file, &file).ok()) {
+    return false;
+  }
+  io::SequentialRecordReader reader(file.get());
+  tstring record;
+  Update update;
+  return reader.ReadRecord(&record).ok() && update.ParseFromString(record) &&
+         update.has_compacted_journal();
+}
+
+// Writes the updates of a journal to a compacted journal file, merging the
+// non-final splits that each split provider produces in a row.
+class CompactedJournalWriter {
+ public:
+  explicit CompactedJournalWriter(WritableFile* file) : writer_(file) {}
+
+  Status Start() {
+    Update update;
+    update.mutable_compacted_journal();
+    return WriteRecord(update);
+  }
+
+  Status Write(const Update& update) {
+    if (!update.has_produce_split()) {
+      return WriteRecord(update);
+    }
+    const ProduceSplitUpdate& produce_split = update.produce_split();
+    const std::pair<int64_t, int64_t> split_provider = {
+        produce_split.iteration_id(), produce_split.split_provider_index()};
+    auto it = pending_splits_.find(split_provider);
+    if (produce_split.finished()) {
+      if (it != pending_splits_.end()) {
+        TF_RETURN_IF_ERROR(WriteRecord(it->second));
+        pending_splits_.erase(it);
+      }
+      return WriteRecord(update);
+    }
+    const int64_t num_splits = std::max<int64_t>(produce_split.num_splits(), 1);
+    if (it == pending_splits_.end()) {
+      it = pending_splits_.emplace(split_provider, update).first;
+      it->second.mutable_produce_split()->set_num_splits(num_splits);
+    } else {
+      ProduceSplitUpdate* pending = it->second.mutable_produce_split();
+      pending->set_num_splits(pending->num_splits() + num_splits);
+    }
+    return OkStatus();
+  }
+
+  Status Finish() {
+    for (const auto& pending_split : pending_splits_) {
+      TF_RETURN_IF_ERROR(WriteRecord(pending_split.second));
+    }
+    pending_splits_.clear();
+    return writer_.Close();
+  }
+
+ private:
+  Status WriteRecord(const Update& update) {
+    return writer_.WriteRecord(update.SerializeAsString());
+  }
+
+  io::RecordWriter writer_;
+  // The merged splits that have not been written yet, keyed by iteration id
+  // and split provider index. Only the ProduceSplit updates are reordered,
+  // since the other updates do not depend on the number of splits produced.
+  std::map<std::pair<int64_t, int64_t>, Update> pending_splits_;
+};
 }  // namespace
 
 std::string DataServiceJournalFile(const std::string& journal_dir,
@@ -56,13 +146,11 @@ Status FileJournalWriter::EnsureInitialized() {
   if (writer_) {
     return OkStatus();
   }
-  std::vector<std::string> journal_files;
   TF_RETURN_IF_ERROR(env_->RecursivelyCreateDir(journal_dir_));
-  TF_RETURN_IF_ERROR(env_->GetChildren(journal_dir_, &journal_files));
+  std::vector<int64_t> sequence_numbers;
+  TF_RETURN_IF_ERROR(ListSequenceNumbers(env_, journal_dir_, sequence_numbers));
   int64_t latest_sequence_number = -1;
-  for (const auto& file : journal_files) {
-    int64_t sequence_number;
-    TF_RETURN_IF_ERROR(ParseSequenceNumber(file, &sequence_number));
+  for (int64_t sequence_number : sequence_numbers) {
     latest_sequence_number = std::max(latest_sequence_number, sequence_number);
   }
   std::string journal_file =
@@ -89,6 +177,50 @@ Status FileJournalWriter::Write(const Update& update) {
   return OkStatus();
 }
 
+Status CompactJournal(Env* env, const std::string& journal_dir) {
+  std::vector<int64_t> sequence_numbers;
+  TF_RETURN_IF_ERROR(ListSequenceNumbers(env, journal_dir, sequence_numbers));
+  if (sequence_numbers.empty()) {
+    return OkStatus();
+  }
+  const int64_t latest_sequence_number =
+      *std::max_element(sequence_numbers.begin(), sequence_numbers.end());
+  // The compacted journal is written next to the journal directory, and
+  // renamed into it once it is complete, so that a failure while compacting
+  // leaves the journal as it was.
+  const std::string tmp_file = absl::StrCat(journal_dir, ".compacting");
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_RETURN_IF_ERROR(env->NewWritableFile(tmp_file, &file));
+    CompactedJournalWriter writer(file.get());
+    TF_RETURN_IF_ERROR(writer.Start());
+    FileJournalReader reader(env, journal_dir);
+    while (true) {
+      Update update;
+      bool end_of_journal = false;
+      TF_RETURN_IF_ERROR(reader.Read(update, end_of_journal));
+      if (end_of_journal) {
+        break;
+      }
+      TF_RETURN_IF_ERROR(writer.Write(update));
+    }
+    TF_RETURN_IF_ERROR(writer.Finish());
+    TF_RETURN_IF_ERROR(file->Sync());
+    TF_RETURN_IF_ERROR(file->Close());
+  }
+  const std::string compacted_file =
+      DataServiceJournalFile(journal_dir, latest_sequence_number + 1);
+  TF_RETURN_IF_ERROR(env->RenameFile(tmp_file, compacted_file));
+  // Readers start from the compacted journal file from now on, even if some
+  // of the files it replaces are not deleted.
+  for (int64_t sequence_number : sequence_numbers) {
+    TF_RETURN_IF_ERROR(
+        env->DeleteFile(DataServiceJournalFile(journal_dir, sequence_number)));
+  }
+  VLOG(1) << "Compacted journal " << journal_dir << " into " << compacted_file;
+  return OkStatus();
+}
+
 FileJournalReader::FileJournalReader(Env* env, StringPiece journal_dir)
     : env_(env), journal_dir_(journal_dir) {}
 
@@ -96,7 +228,24 @@ Status FileJournalReader::EnsureInitialized() {
   if (reader_) {
     return OkStatus();
   }
-  return UpdateFile(DataServiceJournalFile(journal_dir_, 0));
+  sequence_number_ = FirstSequenceNumber();
+  return UpdateFile(DataServiceJournalFile(journal_dir_, sequence_number_));
+}
+
+int64_t FileJournalReader::FirstSequenceNumber() {
+  std::vector<int64_t> sequence_numbers;
+  if (!ListSequenceNumbers(env_, journal_dir_, sequence_numbers).ok()) {
+    return 0;
+  }
+  std::sort(sequence_numbers.begin(), sequence_numbers.end(),
+            std::greater<int64_t>());
+  for (int64_t sequence_number : sequence_numbers) {
+    if (IsCompactedJournalFile(
+            env_, DataServiceJournalFile(journal_dir_, sequence_number))) {
+      return sequence_number;
+    }
+  }
+  return 0;
 }
 
 Status FileJournalReader::Read(Update& update, bool& end_of_journal) {
@@ -121,6 +270,9 @@ Status FileJournalReader::Read(Update& update, bool& end_of_journal) {
     if (!update.ParseFromString(record)) {
       return errors::DataLoss("Failed to parse journal record.");
     }
+    if (update.has_compacted_journal()) {
+      continue;
+    }
     if (VLOG_IS_ON(4)) {
       VLOG(4) << "Read journal entry: " << update.DebugString();
     }
@@ -75,6 +75,15 @@ class FileJournalWriter : public JournalWriter {
   std::unique_ptr<io::RecordWriter> writer_;
 };
 
+// Rewrites the journal in `journal_dir` into a single compacted journal file,
+// which replaces all the existing journal files, and deletes them. The
+// compacted journal merges the splits that a split provider produces in a row
+// into one update, so that replaying it gives the same state as replaying the
+// original journal.
+//
+// Must not be called while the journal is being written.
+Status CompactJournal(Env* env, const std::string& journal_dir);
+
 // Interface for reading from a journal.
 class JournalReader {
  public:
@@ -88,7 +97,9 @@ class JournalReader {
 // used by multiple threads.
 //
 // The journal reader reads through all journal files in the configured journal
-// directory, in order of their sequence numbers. See FileJournalWriter above.
+// directory, in order of their sequence numbers, starting from the latest
+// compacted journal file if there is one. See FileJournalWriter and
+// CompactJournal above.
 class FileJournalReader : public JournalReader {
  public:
   explicit FileJournalReader(Env* env, StringPiece journal_dir);
@@ -100,6 +111,9 @@ class FileJournalReader : public JournalReader {
  private:
   // Initializes the reader if it is not yet initialized.
   Status EnsureInitialized();
+  // Returns the sequence number of the latest compacted journal file, or 0 if
+  // the journal has never been compacted.
+  int64_t FirstSequenceNumber();
   // Updates the `FileJournalReader` to read from a new file.
   Status UpdateFile(const std::string& filename);
 
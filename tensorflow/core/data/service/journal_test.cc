@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/journal.h"
 
 #include <string>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "tensorflow/core/data/service/common.pb.h"
@@ -64,6 +65,16 @@ Update MakeRegisterDatasetUpdate() {
   return update;
 }
 
+Update MakeProduceSplitUpdate(int64_t iteration_id, int64_t num_splits,
+                              bool finished) {
+  Update update;
+  ProduceSplitUpdate* produce_split = update.mutable_produce_split();
+  produce_split->set_iteration_id(iteration_id);
+  produce_split->set_num_splits(num_splits);
+  produce_split->set_finished(finished);
+  return update;
+}
+
 Status CheckJournalContent(StringPiece journal_dir,
                            const std::vector<Update>& expected) {
   FileJournalReader reader(Env::Default(), journal_dir);
@@ -112,6 +123,54 @@ TEST(Journal, AppendExistingJournal) {
   TF_EXPECT_OK(CheckJournalContent(journal_dir, updates));
 }
 
+TEST(Journal, CompactJournal) {
+  std::string journal_dir;
+  EXPECT_TRUE(NewJournalDir(journal_dir));
+  std::vector<Update> updates = {
+      MakeCreateIterationUpdate(),
+      MakeProduceSplitUpdate(/*iteration_id=*/8, /*num_splits=*/0,
+                             /*finished=*/false),
+      MakeProduceSplitUpdate(/*iteration_id=*/9, /*num_splits=*/0,
+                             /*finished=*/false),
+      MakeProduceSplitUpdate(/*iteration_id=*/8, /*num_splits=*/0,
+                             /*finished=*/false),
+      MakeRegisterDatasetUpdate(),
+      MakeProduceSplitUpdate(/*iteration_id=*/8, /*num_splits=*/0,
+                             /*finished=*/true),
+      MakeProduceSplitUpdate(/*iteration_id=*/8, /*num_splits=*/0,
+                             /*finished=*/false),
+      MakeFinishTaskUpdate()};
+  for (const auto& update : updates) {
+    FileJournalWriter writer(Env::Default(), journal_dir);
+    TF_EXPECT_OK(writer.Write(update));
+  }
+
+  TF_EXPECT_OK(CompactJournal(Env::Default(), journal_dir));
+  std::vector<std::string> journal_files;
+  TF_ASSERT_OK(Env::Default()->GetChildren(journal_dir, &journal_files));
+  EXPECT_EQ(journal_files.size(), 1);
+  std::vector<Update> compacted = {
+      MakeCreateIterationUpdate(), MakeRegisterDatasetUpdate(),
+      MakeProduceSplitUpdate(/*iteration_id=*/8, /*num_splits=*/2,
+                             /*finished=*/false),
+      MakeProduceSplitUpdate(/*iteration_id=*/8, /*num_splits=*/0,
+                             /*finished=*/true),
+      MakeFinishTaskUpdate(),
+      MakeProduceSplitUpdate(/*iteration_id=*/8, /*num_splits=*/1,
+                             /*finished=*/false),
+      MakeProduceSplitUpdate(/*iteration_id=*/9, /*num_splits=*/1,
+                             /*finished=*/false)};
+  TF_EXPECT_OK(CheckJournalContent(journal_dir, compacted));
+
+  // New updates are appended after the compacted journal.
+  {
+    FileJournalWriter writer(Env::Default(), journal_dir);
+    TF_EXPECT_OK(writer.Write(MakeFinishTaskUpdate()));
+  }
+  compacted.push_back(MakeFinishTaskUpdate());
+  TF_EXPECT_OK(CheckJournalContent(journal_dir, compacted));
+}
+
 TEST(Journal, MissingFile) {
   std::string journal_dir;
   EXPECT_TRUE(NewJournalDir(journal_dir));
@@ -72,8 +72,9 @@ constexpr int64_t kDefaultDispatcherTimeoutMs = 60 * 60 * 1000;  // 1 hour.
 using WorkerConfig = experimental::WorkerConfig;
 
 // Moves the element into the response. If the tensor contains a single
-// CompressedElement variant, the move will be zero-copy. Otherwise, the tensor
-// data will be serialized as TensorProtos.
+// CompressedElement variant that no one else refers to, e.g. a cached copy of
+// the element, the move will be zero-copy. Otherwise, the tensor data will be
+// copied, or serialized as TensorProtos.
 Status MoveElementToResponse(std::vector<Tensor>&& element,
                              GetElementResponse& resp) {
   if (element.size() != 1 || element[0].dtype() != DT_VARIANT ||
@@ -92,7 +93,11 @@ Status MoveElementToResponse(std::vector<Tensor>&& element,
         "it produced ",
         variant.TypeName());
   }
-  *resp.mutable_compressed() = *compressed;
+  if (element[0].RefCountIsOne()) {
+    *resp.mutable_compressed() = std::move(*compressed);
+  } else {
+    *resp.mutable_compressed() = *compressed;
+  }
   return OkStatus();
 }
 
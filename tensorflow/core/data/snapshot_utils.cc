@@ -16,7 +16,9 @@ limitations under the License.
 #include "tensorflow/core/data/snapshot_utils.h"
 
 #include <algorithm>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <queue>
 #include <string>
 #include <utility>
@@ -27,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/lib/io/record_writer.h"
@@ -38,12 +41,14 @@ limitations under the License.
 #include "tensorflow/core/platform/coding.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/random.h"
 #include "tensorflow/core/platform/strcat.h"
 #include "tensorflow/core/platform/stringprintf.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
 #include "tensorflow/core/protobuf/snapshot.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -150,6 +155,26 @@ Status TFRecordWriter::WriteTensors(const std::vector<Tensor>& tensors) {
   return OkStatus();
 }
 
+Status TFRecordWriter::EncodeTensors(const std::vector<Tensor>& tensors,
+                                     std::vector<std::string>* records) const {
+  records->clear();
+  records->reserve(tensors.size());
+  for (const auto& tensor : tensors) {
+    TensorProto proto;
+    tensor.AsProtoTensorContent(&proto);
+    records->push_back(proto.SerializeAsString());
+  }
+  return OkStatus();
+}
+
+Status TFRecordWriter::WriteEncodedTensors(
+    const std::vector<std::string>& records) {
+  for (const auto& record : records) {
+    TF_RETURN_IF_ERROR(record_writer_->WriteRecord(StringPiece(record)));
+  }
+  return OkStatus();
+}
+
 Status TFRecordWriter::Sync() {
   TF_RETURN_IF_ERROR(record_writer_->Flush());
   return dest_->Flush();
@@ -233,6 +258,24 @@ Status CustomWriter::WriteTensors(const std::vector<Tensor>& tensors) {
 #endif  // TF_CORD_SUPPORT
   }
 
+  std::vector<std::string> records;
+  TF_RETURN_IF_ERROR(EncodeTensors(tensors, &records));
+  return WriteEncodedTensors(records);
+}
+
+Status CustomWriter::EncodeTensors(const std::vector<Tensor>& tensors,
+                                   std::vector<std::string>* records) const {
+  records->clear();
+  if (compression_type_ != io::compression::kSnappy) {
+    experimental::SnapshotRecord record;
+    for (const auto& tensor : tensors) {
+      TensorProto* t = record.add_tensor();
+      tensor.AsProtoTensorContent(t);
+    }
+    records->push_back(record.SerializeAsString());
+    return OkStatus();
+  }
+
   std::vector<const TensorBuffer*> tensor_buffers;
   tensor_buffers.reserve(num_simple_);
   std::vector<TensorProto> tensor_protos;
@@ -278,22 +321,20 @@ Status CustomWriter::WriteTensors(const std::vector<Tensor>& tensors) {
   }
   DCHECK_EQ(position, uncompressed.data() + total_size);
 
-  string output;
+  std::string output;
   if (!port::Snappy_Compress(uncompressed.data(), total_size, &output)) {
     return errors::Internal("Failed to compress using snappy.");
   }
+  records->push_back(metadata.SerializeAsString());
+  records->push_back(std::move(output));
+  return OkStatus();
+}
 
-#if defined(TF_CORD_SUPPORT)
-  auto metadata_buffer = new std::string();
-  metadata.SerializeToString(metadata_buffer);
-  absl::Cord metadata_serialized = absl::MakeCordFromExternal(
-      *metadata_buffer,
-      [metadata_buffer](absl::string_view) { delete metadata_buffer; });
-#else
-  std::string metadata_serialized = metadata.SerializeAsString();
-#endif  // TF_CORD_SUPPORT
-  TF_RETURN_IF_ERROR(WriteRecord(metadata_serialized));
-  TF_RETURN_IF_ERROR(WriteRecord(output));
+Status CustomWriter::WriteEncodedTensors(
+    const std::vector<std::string>& records) {
+  for (const auto& record : records) {
+    TF_RETURN_IF_ERROR(WriteRecord(StringPiece(record)));
+  }
   return OkStatus();
 }
 
@@ -1077,6 +1118,16 @@ Status AsyncWriter::WriterThread(Env* env, const std::string& shard_directory,
       env, GetCheckpointFileName(shard_directory, checkpoint_id), compression,
       version, std::move(output_types), &writer));
 
+  static const int64_t num_encoder_threads = [] {
+    int64_t num_threads;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_DATA_SNAPSHOT_ENCODER_THREADS",
+                                    /*default_val=*/1, &num_threads));
+    return num_threads;
+  }();
+  if (num_encoder_threads > 1) {
+    return WriteEncodedElements(env, num_encoder_threads, writer.get());
+  }
+
   while (true) {
     ElementOrEOF be;
     Consume(&be);
@@ -1091,6 +1142,50 @@ Status AsyncWriter::WriterThread(Env* env, const std::string& shard_directory,
   return OkStatus();
 }
 
+Status AsyncWriter::WriteEncodedElements(Env* env, int64_t num_encoder_threads,
+                                         Writer* writer) {
+  struct EncodedElement {
+    Notification encoded;
+    Status status;
+    std::vector<std::string> records;
+  };
+  // The elements that are being encoded, in the order of the input. At most
+  // two elements per encoder thread are in flight, which bounds the memory
+  // used by the encoded elements that are waiting to be written.
+  std::deque<std::unique_ptr<EncodedElement>> in_flight;
+  auto write_oldest = [&in_flight, writer]() -> Status {
+    std::unique_ptr<EncodedElement> element = std::move(in_flight.front());
+    in_flight.pop_front();
+    element->encoded.WaitForNotification();
+    TF_RETURN_IF_ERROR(element->status);
+    return writer->WriteEncodedTensors(element->records);
+  };
+  // Declared after `in_flight`, so that the pool waits for the encoders
+  // before the elements that they write to are destroyed.
+  thread::ThreadPool pool(env, "snapshot_encoder", num_encoder_threads);
+  while (true) {
+    ElementOrEOF be;
+    Consume(&be);
+
+    if (be.end_of_sequence) {
+      while (!in_flight.empty()) {
+        TF_RETURN_IF_ERROR(write_oldest());
+      }
+      return writer->Close();
+    }
+
+    if (in_flight.size() >= 2 * num_encoder_threads) {
+      TF_RETURN_IF_ERROR(write_oldest());
+    }
+    in_flight.push_back(std::make_unique<EncodedElement>());
+    EncodedElement* element = in_flight.back().get();
+    pool.Schedule([writer, element, tensors = std::move(be.value)]() {
+      element->status = writer->EncodeTensors(tensors, &element->records);
+      element->encoded.Notify();
+    });
+  }
+}
+
 namespace {
 
 REGISTER_KERNEL_BUILDER(Name("SnapshotDatasetReader").Device(DEVICE_CPU),
@@ -82,6 +82,18 @@ class Writer {
   // Writes a vector of tensors to the snapshot writer file.
   virtual Status WriteTensors(const std::vector<Tensor>& tensors) = 0;
 
+  // Serializes the given tensors into the records that `WriteTensors` would
+  // append to the file, compressing them if the file format compresses each
+  // element separately. Unlike the other methods, this may be called
+  // concurrently, so that elements can be encoded in parallel and then
+  // written in order with `WriteEncodedTensors`.
+  virtual Status EncodeTensors(const std::vector<Tensor>& tensors,
+                               std::vector<std::string>* records) const = 0;
+
+  // Appends records returned by `EncodeTensors` to the snapshot writer file.
+  virtual Status WriteEncodedTensors(
+      const std::vector<std::string>& records) = 0;
+
   // Flushes any in-memory buffers to disk.
   virtual Status Sync() = 0;
 
@@ -103,6 +115,11 @@ class TFRecordWriter : public Writer {
 
   Status WriteTensors(const std::vector<Tensor>& tensors) override;
 
+  Status EncodeTensors(const std::vector<Tensor>& tensors,
+                       std::vector<std::string>* records) const override;
+
+  Status WriteEncodedTensors(const std::vector<std::string>& records) override;
+
   Status Sync() override;
 
   Status Close() override;
@@ -135,6 +152,11 @@ class CustomWriter : public Writer {
 
   Status WriteTensors(const std::vector<Tensor>& tensors) override;
 
+  Status EncodeTensors(const std::vector<Tensor>& tensors,
+                       std::vector<std::string>* records) const override;
+
+  Status WriteEncodedTensors(const std::vector<std::string>& records) override;
+
   Status Sync() override;
 
   Status Close() override;
@@ -348,6 +370,11 @@ struct ElementOrEOF {
 // }
 // writer->SignalEOF();
 // writer = nullptr;  // This will block until writes are flushed.
+//
+// If the TF_DATA_SNAPSHOT_ENCODER_THREADS environment variable is greater than
+// 1, the elements are serialized and compressed by a pool of that many
+// threads, and the writer thread only appends the encoded elements to the
+// file, in order.
 class AsyncWriter {
  public:
   explicit AsyncWriter(Env* env, int64_t file_index,
@@ -370,6 +397,10 @@ class AsyncWriter {
   Status WriterThread(Env* env, const std::string& shard_directory,
                       uint64 checkpoint_id, const std::string& compression,
                       int64_t version, DataTypeVector output_types);
+  // Encodes the elements on `num_encoder_threads` threads and writes them in
+  // order with `writer`, until the end of input.
+  Status WriteEncodedElements(Env* env, int64_t num_encoder_threads,
+                              Writer* writer);
 
   mutex mu_;
   std::deque<ElementOrEOF> deque_ TF_GUARDED_BY(mu_);
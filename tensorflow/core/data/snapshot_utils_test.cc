@@ -38,7 +38,8 @@ void GenerateTensorVector(tensorflow::DataTypeVector& dtypes,
   }
 }
 
-void SnapshotRoundTrip(std::string compression_type, int version) {
+void SnapshotRoundTrip(std::string compression_type, int version,
+                       bool encode_separately = false) {
   // Generate ground-truth tensors for writing and reading.
   std::vector<Tensor> tensors;
   tensorflow::DataTypeVector dtypes;
@@ -52,7 +53,13 @@ void SnapshotRoundTrip(std::string compression_type, int version) {
                               compression_type, version, dtypes, &writer));
 
   for (int i = 0; i < 100; ++i) {
-    TF_ASSERT_OK(writer->WriteTensors(tensors));
+    if (encode_separately) {
+      std::vector<std::string> records;
+      TF_ASSERT_OK(writer->EncodeTensors(tensors, &records));
+      TF_ASSERT_OK(writer->WriteEncodedTensors(records));
+    } else {
+      TF_ASSERT_OK(writer->WriteTensors(tensors));
+    }
   }
   TF_ASSERT_OK(writer->Close());
 
@@ -91,6 +98,16 @@ TEST(SnapshotUtilTest, CombinationRoundTripTest) {
   SnapshotRoundTrip(io::compression::kSnappy, 2);
 }
 
+TEST(SnapshotUtilTest, EncodedRoundTripTest) {
+  SnapshotRoundTrip(io::compression::kNone, 1, /*encode_separately=*/true);
+  SnapshotRoundTrip(io::compression::kGzip, 1, /*encode_separately=*/true);
+  SnapshotRoundTrip(io::compression::kSnappy, 1, /*encode_separately=*/true);
+
+  SnapshotRoundTrip(io::compression::kNone, 2, /*encode_separately=*/true);
+  SnapshotRoundTrip(io::compression::kGzip, 2, /*encode_separately=*/true);
+  SnapshotRoundTrip(io::compression::kSnappy, 2, /*encode_separately=*/true);
+}
+
 void SnapshotReaderBenchmarkLoop(::testing::benchmark::State& state,
                                  std::string compression_type, int version) {
   tensorflow::DataTypeVector dtypes;
@@ -354,6 +354,49 @@ void BaseRemoteRendezvous::RecvAsync(const ParsedKey& parsed,
   }
 }
 
+void BaseRemoteRendezvous::RecvManyAsync(
+    absl::Span<const ParsedKey> keys, absl::Span<const Rendezvous::Args> args,
+    ManyDoneCallback done) {
+  for (const ParsedKey& parsed : keys) {
+    if (!ValidateDevices(parsed, false /*!is_src*/).ok() ||
+        !IsSameWorker(parsed.src, parsed.dst)) {
+      // RecvAsync() reports the errors and receives from remote workers.
+      RemoteRendezvous::RecvManyAsync(keys, args, std::move(done));
+      return;
+    }
+  }
+
+  VLOG(1) << "RemoteRendezvous RecvMany " << this << " " << keys.size()
+          << " keys";
+  profiler::ScopedMemoryDebugAnnotation op_annotation("RecvManyAsync",
+                                                      step_id_);
+  local_->RecvManyAsync(
+      keys, args,
+      [this, parsed = std::vector<ParsedKey>(keys.begin(), keys.end()),
+       recv_args = std::vector<Rendezvous::Args>(args.begin(), args.end()),
+       done = std::move(done)](const Status& status,
+                               const std::vector<Rendezvous::Args>& send_args,
+                               const std::vector<Tensor>& in,
+                               const std::vector<bool>& is_dead) mutable {
+        if (!status.ok() || in.empty()) {
+          done(status, send_args, in, is_dead);
+          return;
+        }
+        auto* collector =
+            new internal::RecvManyCollector(in.size(), std::move(done));
+        for (int i = 0; i < in.size(); ++i) {
+          Tensor* out = new Tensor;
+          SameWorkerRecvDone(
+              parsed[i], send_args[i], recv_args[i], in[i], out,
+              [collector, i, send_args = send_args[i], out,
+               is_dead = is_dead[i]](const Status& s) {
+                collector->Done(i, s, send_args, *out, is_dead);
+                delete out;
+              });
+        }
+      });
+}
+
 void BaseRemoteRendezvous::RecvLocalAsync(const ParsedKey& parsed,
                                           DoneCallback done) {
   // Test whether the rendezvous is initialized using a shared lock, to avoid
@@ -144,6 +144,12 @@ class BaseRemoteRendezvous : public RemoteRendezvous {
   void RecvAsync(const ParsedKey& key, const Rendezvous::Args& args,
                  DoneCallback done) override;
 
+  // Receives all the keys from local_ at once when they are all produced on
+  // this worker, and falls back to one RecvAsync() per key otherwise.
+  void RecvManyAsync(absl::Span<const ParsedKey> keys,
+                     absl::Span<const Rendezvous::Args> args,
+                     ManyDoneCallback done) override;
+
   void StartAbort(const Status& status) override;
 
   // This method is called only by the local Worker, forwarded through
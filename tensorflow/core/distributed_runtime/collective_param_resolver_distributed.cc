@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace {
@@ -102,6 +103,9 @@ CollectiveParamResolverDistributed::CollectiveParamResolverDistributed(
           << config.experimental().collective_group_leader() << "}"
           << " config.collective_nccl={"
           << config.experimental().collective_nccl() << "}";
+  TF_CHECK_OK(ReadBoolFromEnvVar("TF_COLLECTIVE_CACHE_INSTANCE_PARAMS",
+                                 /*default_val=*/false,
+                                 &cache_instance_params_));
 }
 
 void CollectiveParamResolverDistributed::CompleteParamsAsync(
@@ -363,11 +367,25 @@ Status CollectiveParamResolverDistributed::UpdateInstanceCache(
 void CollectiveParamResolverDistributed::CompleteInstanceDistributed(
     const string& device, CollectiveParams* cp, CancellationManager* cancel_mgr,
     const StatusCallback& done) {
+  const string signature = InstanceSignature(*cp);
   if (group_leader_.empty()) {
     // This is the group leader so resolution is local.
     return CompleteInstanceLocal(device, cp, done);
   } else if (InstanceIsCached(cp->group.group_key, cp->instance.instance_key)) {
     return CompleteInstanceLocal(device, cp, done);
+  } else if (SignatureIsResolved(signature)) {
+    VLOG(2) << "CompleteInstanceDistributed resolves instance "
+            << cp->instance.instance_key << " locally like " << signature;
+    CompleteInstanceResponse resp;
+    resp.set_instance_key(cp->instance.instance_key);
+    resp.set_source_rank(-1);
+    Status s = UpdateInstanceCache(cp, resp);
+    if (s.ok()) {
+      CompleteInstanceLocal(device, cp, done);
+    } else {
+      done(s);
+    }
+    return;
   } else {
     CompleteInstanceCall* call = new CompleteInstanceCall(
         cp->group, cp->instance, cp->name, device, cp->is_source, cancel_mgr,
@@ -381,11 +399,16 @@ void CollectiveParamResolverDistributed::CompleteInstanceDistributed(
       delete call;
       return;
     }
-    call->Start([this, device, cp, call, abortion_token, done](Status s) {
+    call->Start([this, device, cp, call, abortion_token, signature,
+                 done](Status s) {
       abortion_cancel_mgr_.DeregisterCallback(abortion_token);
       if (s.ok()) {
         s = UpdateInstanceCache(cp, call->resp_);
       }
+      if (s.ok() && !signature.empty()) {
+        mutex_lock l(signature_mu_);
+        resolved_signatures_.insert(signature);
+      }
       if (s.ok()) {
         CompleteInstanceLocal(device, cp, done);
       } else {
@@ -397,6 +420,26 @@ void CollectiveParamResolverDistributed::CompleteInstanceDistributed(
   }
 }
 
+bool CollectiveParamResolverDistributed::SignatureIsResolved(
+    const string& signature) {
+  if (signature.empty()) {
+    return false;
+  }
+  mutex_lock l(signature_mu_);
+  return resolved_signatures_.contains(signature);
+}
+
+string CollectiveParamResolverDistributed::InstanceSignature(
+    const CollectiveParams& cp) const {
+  // The source rank of a broadcast depends on which member sends.
+  if (!cache_instance_params_ || cp.instance.type == BROADCAST_COLLECTIVE) {
+    return "";
+  }
+  return strings::StrCat(cp.group.group_key, ":", cp.instance.type, ":",
+                         DataTypeString(cp.instance.data_type), ":",
+                         cp.instance.shape.DebugString());
+}
+
 void CollectiveParamResolverDistributed::StartAbort(const Status& s) {
   {
     mutex_lock l(status_mu_);
@@ -15,6 +15,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_COLLECTIVE_PARAM_RESOLVER_DISTRIBUTED_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_COLLECTIVE_PARAM_RESOLVER_DISTRIBUTED_H_
 
+#include <string>
+
+#include "absl/container/flat_hash_set.h"
 #include "tensorflow/core/common_runtime/collective_param_resolver_local.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
@@ -26,6 +29,15 @@ class WorkerCacheInterface;
 class DeviceResolverDistributed;
 class DeviceMgr;
 
+// Resolves collective params with the help of the group leader.
+//
+// Every new instance key is resolved with an RPC to the leader, even when the
+// functions that use them are only retraced. If the
+// TF_COLLECTIVE_CACHE_INSTANCE_PARAMS environment variable is true, instances
+// other than broadcasts are resolved locally when an instance of the same
+// group with the same type, data type and shape was resolved by the leader
+// before: the leader would only send back an unused source rank for them.
+// This skips the check that all members agree on these new instances.
 class CollectiveParamResolverDistributed : public CollectiveParamResolverLocal {
  public:
   CollectiveParamResolverDistributed(
@@ -87,9 +99,23 @@ class CollectiveParamResolverDistributed : public CollectiveParamResolverLocal {
                                    const StatusCallback& done)
       TF_LOCKS_EXCLUDED(instance_mu_, group_mu_);
 
+  // Returns the key of the instances that are resolved alike, or an empty
+  // string if cp must always be resolved by the leader.
+  string InstanceSignature(const CollectiveParams& cp) const;
+
+  // Returns true iff an instance with this non-empty signature was resolved
+  // by the leader.
+  bool SignatureIsResolved(const string& signature)
+      TF_LOCKS_EXCLUDED(signature_mu_);
+
   WorkerCacheInterface* worker_cache_;  // Not owned
   const string group_leader_;
   CancellationManager abortion_cancel_mgr_;
+  bool cache_instance_params_ = false;
+  mutex signature_mu_;
+  // Signatures of the instances that have been resolved by the leader.
+  absl::flat_hash_set<string> resolved_signatures_
+      TF_GUARDED_BY(signature_mu_);
 };
 
 }  // namespace tensorflow
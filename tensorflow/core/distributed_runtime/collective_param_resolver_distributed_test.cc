@@ -28,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/util/device_name_utils.h"
 
@@ -350,6 +351,48 @@ TEST_F(DeviceResDistTest, DifferentIncarnation) {
   EXPECT_TRUE(errors::IsFailedPrecondition(status_[device_name]));
 }
 
+TEST_F(DeviceResDistTest, ResolveLikeCachedInstance) {
+  const int num_workers = 2;
+  const int num_devices = 1;
+  setenv("TF_COLLECTIVE_CACHE_INSTANCE_PARAMS", "true", 1);
+  DefineWorkers(num_workers, num_devices, "CPU", /*nccl*/ false);
+  unsetenv("TF_COLLECTIVE_CACHE_INSTANCE_PARAMS");
+  DefineCollectiveParams(num_workers, num_devices, "CPU");
+  IssueRequests(num_workers, num_devices);
+  ValidateCollectiveParams(num_workers, num_devices);
+
+  // The leader fails all requests from now on.
+  cp_resolvers_["/job:worker/replica:0/task:0"]->StartAbort(
+      errors::Unavailable("leader is gone"));
+  const string task_name = "/job:worker/replica:0/task:1";
+  Device* device = nullptr;
+  TF_ASSERT_OK(device_mgrs_[task_name]->LookupDevice(
+      absl::StrCat(task_name, "/device:CPU:0"), &device));
+  auto resolve = [&](int instance_key, const TensorShape& shape) {
+    core::RefCountPtr<CollectiveParams> cp(
+        CreateCollectiveParams(num_workers, num_devices, "CPU",
+                               REDUCTION_COLLECTIVE, /*is_source=*/false));
+    cp->instance.instance_key = instance_key;
+    cp->instance.shape = shape;
+    Notification note;
+    Status status;
+    cp_resolvers_[task_name]->CompleteParamsAsync(
+        device->attributes(), cp.get(), &cm_, [&](const Status& s) {
+          status = s;
+          note.Notify();
+        });
+    note.WaitForNotification();
+    if (status.ok()) {
+      EXPECT_EQ(cp->default_rank, 1);
+    }
+    return status;
+  };
+  // A new instance like the first one doesn't need the leader.
+  TF_EXPECT_OK(resolve(4, TensorShape({64})));
+  // A new instance with another shape still does.
+  EXPECT_FALSE(resolve(5, TensorShape({32})).ok());
+}
+
 TEST_F(DeviceResDistTest, BroadcastSourceRank0) {
   const int num_workers = 2;
   const int num_devices = 2;
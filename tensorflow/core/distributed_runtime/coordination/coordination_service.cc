@@ -391,9 +391,11 @@ void CoordinationServiceStandaloneImpl::StartCheckStaleness() {
             }
           }
           // Heartbeat check.
-          Status status = OkStatus();
           {
-            mutex_lock l(state_mu_);
+            // The scan only reads the task states, so that it does not block
+            // the heartbeats; the tasks that have timed out are then set in
+            // error under the exclusive lock.
+            tf_shared_lock l(state_mu_);
             for (const auto& [task_name, task_state] : cluster_state_) {
               // Skip tasks that are not registered or in error state
               if (task_state->GetState() != TaskState::State::CONNECTED) {
@@ -405,14 +407,32 @@ void CoordinationServiceStandaloneImpl::StartCheckStaleness() {
                       << " stale?=" << is_stale;
               if (is_stale) {
                 stale_task_names.push_back(task_name);
-                status = MakeCoordinationError(errors::Unavailable(
-                    "Task ", task_name,
-                    " heartbeat timeout. This indicates that the remote task "
-                    "has failed, got preempted, or crashed unexpectedly."));
-                SetTaskError(task_name, status);
               }
             }
           }
+          if (!stale_task_names.empty()) {
+            mutex_lock l(state_mu_);
+            std::vector<absl::string_view> timed_out_task_names;
+            for (absl::string_view task_name : stale_task_names) {
+              // Skips the tasks that have sent a heartbeat, or changed state,
+              // since the scan.
+              auto it = cluster_state_.find(task_name);
+              if (it == cluster_state_.end() ||
+                  it->second->GetState() != TaskState::State::CONNECTED ||
+                  it->second->TimeSinceLastHeartbeatMs() <=
+                      heartbeat_timeout_ms_) {
+                continue;
+              }
+              SetTaskError(task_name,
+                           MakeCoordinationError(errors::Unavailable(
+                               "Task ", task_name,
+                               " heartbeat timeout. This indicates that the "
+                               "remote task has failed, got preempted, or "
+                               "crashed unexpectedly.")));
+              timed_out_task_names.push_back(task_name);
+            }
+            stale_task_names.swap(timed_out_task_names);
+          }
           // Propagate heartbeat timeout errors to other connected tasks.
           if (!stale_task_names.empty()) {
             if (!has_service_to_client_connection) {
@@ -470,17 +490,18 @@ void CoordinationServiceStandaloneImpl::StartCheckStaleness() {
 }
 
 void CoordinationServiceStandaloneImpl::Stop(bool shut_staleness_thread) {
+  absl::flat_hash_map<std::string, std::vector<StatusOrValueCallback>> get_cb;
   {
     mutex_lock l(kv_mu_);
-    for (const auto& [key, get_kv_callbacks] : get_cb_) {
-      for (const auto& get_kv_callback : get_kv_callbacks) {
-        get_kv_callback(errors::Cancelled(
-            absl::StrCat("Coordination service is shutting down. Cancelling "
-                         "GetKeyValue() for key: ",
-                         key)));
-      }
+    std::swap(get_cb, get_cb_);
+  }
+  for (const auto& [key, get_kv_callbacks] : get_cb) {
+    for (const auto& get_kv_callback : get_kv_callbacks) {
+      get_kv_callback(errors::Cancelled(
+          absl::StrCat("Coordination service is shutting down. Cancelling "
+                       "GetKeyValue() for key: ",
+                       key)));
     }
-    get_cb_.clear();
   }
   {
     mutex_lock l(state_mu_);
@@ -645,26 +666,29 @@ Status CoordinationServiceStandaloneImpl::RecordHeartbeat(
   const std::string& task_name = GetTaskName(task);
   Status s = OkStatus();
   {
-    mutex_lock l(state_mu_);
-    if (!cluster_state_.contains(task_name)) {
+    // Heartbeats only read the task states, and record the time of the
+    // heartbeat under the lock of their task, so that the heartbeats of many
+    // tasks do not contend with each other.
+    tf_shared_lock l(state_mu_);
+    auto it = cluster_state_.find(task_name);
+    if (it == cluster_state_.end()) {
       return MakeCoordinationError(errors::InvalidArgument(
           "Unexpected task request with task_name=", task_name));
     }
-    if (!cluster_state_[task_name]->GetStatus().ok()) {
-      return cluster_state_[task_name]->GetStatus();
-    } else if (cluster_state_[task_name]->GetState() ==
-                   TaskState::State::DISCONNECTED &&
+    TaskState* task_state = it->second.get();
+    if (!task_state->GetStatus().ok()) {
+      return task_state->GetStatus();
+    } else if (task_state->GetState() == TaskState::State::DISCONNECTED &&
                // We accept heartbeats for a short grace period to account for
                // the lag time between the service recording the state change
                // and the agent stopping heartbeats.
                Env::Default()->NowMicros() >
-                   cluster_state_[task_name]
-                       ->GetDisconnectedGracePeriodMicros()) {
+                   task_state->GetDisconnectedGracePeriodMicros()) {
       return MakeCoordinationError(errors::InvalidArgument(
           "Task with task_name=", task_name,
           " must be registered before sending heartbeat messages"));
     }
-    s = cluster_state_[task_name]->RecordHeartbeat(incarnation);
+    s = task_state->RecordHeartbeat(incarnation);
   }
 
   // Set and propagate any heartbeat errors.
@@ -803,18 +827,24 @@ std::string NormalizeKey(const StringPiece orig_key) {
 Status CoordinationServiceStandaloneImpl::InsertKeyValue(
     const std::string& key, const std::string& value) {
   const std::string& norm_key = NormalizeKey(key);
-  mutex_lock l(kv_mu_);
-  if (kv_store_.find(norm_key) != kv_store_.end()) {
-    return MakeCoordinationError(
-        errors::AlreadyExists("Config key ", key, " already exists."));
-  }
-  kv_store_.emplace(norm_key, value);
-  auto iter = get_cb_.find(norm_key);
-  if (iter != get_cb_.end()) {
-    for (const auto& cb : iter->second) {
-      cb(value);
+  std::vector<StatusOrValueCallback> callbacks;
+  {
+    mutex_lock l(kv_mu_);
+    if (kv_store_.find(norm_key) != kv_store_.end()) {
+      return MakeCoordinationError(
+          errors::AlreadyExists("Config key ", key, " already exists."));
     }
-    get_cb_.erase(iter);
+    kv_store_.emplace(norm_key, value);
+    auto iter = get_cb_.find(norm_key);
+    if (iter != get_cb_.end()) {
+      callbacks = std::move(iter->second);
+      get_cb_.erase(iter);
+    }
+  }
+  // The callbacks send the responses of the pending GetKeyValue() calls, which
+  // must not block the other accesses to the store.
+  for (const auto& cb : callbacks) {
+    cb(value);
   }
   return OkStatus();
 }
@@ -822,24 +852,34 @@ Status CoordinationServiceStandaloneImpl::InsertKeyValue(
 void CoordinationServiceStandaloneImpl::GetKeyValueAsync(
     const std::string& key, StatusOrValueCallback done) {
   const std::string& norm_key = NormalizeKey(key);
-  mutex_lock l(kv_mu_);
-  const auto& iter = kv_store_.find(norm_key);
-  if (iter != kv_store_.end()) {
-    done(iter->second);
-    return;
+  std::string value;
+  bool found = false;
+  {
+    // Most keys are inserted before they are read, so the lookup first
+    // shares the lock with the other readers.
+    tf_shared_lock l(kv_mu_);
+    const auto& iter = kv_store_.find(norm_key);
+    if (iter != kv_store_.end()) {
+      value = iter->second;
+      found = true;
+    }
   }
-  auto cb_iter = get_cb_.find(norm_key);
-  if (cb_iter == get_cb_.end()) {
-    cb_iter =
-        get_cb_.emplace(norm_key, std::vector<StatusOrValueCallback>()).first;
+  if (!found) {
+    mutex_lock l(kv_mu_);
+    const auto& iter = kv_store_.find(norm_key);
+    if (iter == kv_store_.end()) {
+      get_cb_[norm_key].emplace_back(std::move(done));
+      return;
+    }
+    value = iter->second;
   }
-  cb_iter->second.emplace_back(std::move(done));
+  done(value);
 }
 
 StatusOr<std::string> CoordinationServiceStandaloneImpl::TryGetKeyValue(
     const std::string& key) {
   const std::string& norm_key = NormalizeKey(key);
-  mutex_lock l(kv_mu_);
+  tf_shared_lock l(kv_mu_);
   const auto& iter = kv_store_.find(norm_key);
   if (iter == kv_store_.end()) {
     return errors::NotFound("Config key ", key, " not found.");
@@ -853,7 +893,7 @@ std::vector<KeyValueEntry> CoordinationServiceStandaloneImpl::GetKeyValueDir(
   const std::string norm_key = NormalizeKey(directory_key);
   const std::string dir = absl::StrCat(norm_key, "/");
 
-  mutex_lock l(kv_mu_);
+  tf_shared_lock l(kv_mu_);
   // Find first key in ordered map that has the directory prefix.
   auto begin = kv_store_.lower_bound(dir);
   std::map<std::string, std::string>::iterator it;
@@ -510,6 +510,24 @@ TEST_F(CoordinateTwoTasksTest, TestSetGetValues) {
   EXPECT_FALSE(n4->HasBeenNotified());
 }
 
+TEST_F(CoordinateTwoTasksTest, GetKeyValueCallbackCanAccessStore) {
+  EnableCoordinationService();
+  absl::Notification n;
+  StatusOr<std::string> ret;
+  // The callback runs when the key is inserted, and inserts another key.
+  coord_service_->GetKeyValueAsync(
+      "key0", [&](const StatusOr<std::string>& status_or_value) {
+        TF_EXPECT_OK(status_or_value.status());
+        TF_EXPECT_OK(coord_service_->InsertKeyValue("key1", "value1"));
+        ret = coord_service_->TryGetKeyValue("key0");
+        n.Notify();
+      });
+  TF_ASSERT_OK(coord_service_->InsertKeyValue("key0", "value0"));
+  n.WaitForNotification();
+  EXPECT_EQ(ret.ValueOrDie(), "value0");
+  EXPECT_EQ(coord_service_->TryGetKeyValue("key1").ValueOrDie(), "value1");
+}
+
 TEST(CoordinationServiceTest, TryGetKeyValue) {
   const ServerDef& server_def = GetMultiClientServerDef("worker", 1);
   auto client_cache = std::make_unique<TestCoordinationClientCache>();
@@ -38,6 +38,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/worker_cache.h"
 #include "tensorflow/core/distributed_runtime/worker_env.h"
 #include "tensorflow/core/framework/rendezvous.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/host_info.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -529,25 +530,26 @@ void EagerServiceImpl::RunComponentFunction(
       });
 }
 
-Status EagerServiceImpl::ExecuteOp(CallOptions* call_opts,
-                                   const Operation& operation,
+Status EagerServiceImpl::ExecuteOp(const Operation& operation,
                                    EagerContext* eager_context,
                                    EagerExecutor* eager_executor,
+                                   CancellationManager* cancellation_manager,
+                                   EagerOperation* op,
                                    QueueResponse* queue_response) {
-  tensorflow::EagerOperation op(eager_context);
+  // Releases the inputs of the previous operation, and of this one once it
+  // has been executed.
+  op->Clear();
+  auto clear_op = gtl::MakeCleanup([op] { op->Clear(); });
   int num_retvals = 0;
   TF_RETURN_IF_ERROR(GetEagerOperationAndNumRetvals(
-      operation, eager_context, eager_executor, &op, &num_retvals));
-
-  auto cm = std::make_shared<CancellationManager>();
-  if (call_opts) {
-    op.SetCancellationManager(cm.get());
-    call_opts->SetCancelCallback([cm] { cm->StartCancel(); });
+      operation, eager_context, eager_executor, op, &num_retvals));
+  if (cancellation_manager != nullptr) {
+    op->SetCancellationManager(cancellation_manager);
   }
 
   absl::FixedArray<tensorflow::TensorHandle*> retvals(num_retvals);
   VLOG(3) << "ServerContext: Calling EagerExecute for op " << operation.id();
-  TF_RETURN_IF_ERROR(op.Execute(
+  TF_RETURN_IF_ERROR(op->Execute(
       absl::MakeSpan(
           reinterpret_cast<tensorflow::AbstractTensorHandle**>(retvals.data()),
           num_retvals),
@@ -557,7 +559,7 @@ Status EagerServiceImpl::ExecuteOp(CallOptions* call_opts,
   // Send the output devices of a function back to let a client know where the
   // outputs are. For a primitive op, an output devics is the op device which is
   // known on a client.
-  if (op.is_function()) {
+  if (op->is_function()) {
     add_device_fn = [queue_response] { return queue_response->add_device(); };
   }
 
@@ -586,12 +588,31 @@ Status EagerServiceImpl::Enqueue(CallOptions* call_opts,
           ? context->Context()->Executor()
           : context->Context()->RemoteMgr()->GetOrCreateExecutorForStream(
                 stream_id);
+  // The primitive operations of the request, which clients may batch, share
+  // one EagerOperation instead of setting one up for each of them, and all
+  // the operations share one CancellationManager.
+  std::unique_ptr<EagerOperation> primitive_op;
+  std::shared_ptr<CancellationManager> cm;
   Status s;
   for (const auto& item : request->queue()) {
     auto* queue_response = response->add_queue_response();
     if (item.has_operation()) {
-      s = ExecuteOp(call_opts, item.operation(), context->Context(), &executor,
-                    queue_response);
+      if (call_opts != nullptr && cm == nullptr) {
+        cm = std::make_shared<CancellationManager>();
+        call_opts->SetCancelCallback([cm] { cm->StartCancel(); });
+      }
+      if (item.operation().is_function()) {
+        // Functions keep their parameters in the op, so they are not shared.
+        EagerOperation function_op(context->Context());
+        s = ExecuteOp(item.operation(), context->Context(), &executor,
+                      cm.get(), &function_op, queue_response);
+      } else {
+        if (primitive_op == nullptr) {
+          primitive_op = std::make_unique<EagerOperation>(context->Context());
+        }
+        s = ExecuteOp(item.operation(), context->Context(), &executor,
+                      cm.get(), primitive_op.get(), queue_response);
+      }
     } else if (item.has_handle_to_decref()) {
       auto handle_to_decref = std::make_unique<RemoteTensorHandleInternal>(
           item.handle_to_decref());
@@ -208,9 +208,12 @@ class EagerServiceImpl {
   };
 
  private:
-  Status ExecuteOp(CallOptions* call_opts, const Operation& operation,
-                   EagerContext* eager_context, EagerExecutor* eager_executor,
-                   QueueResponse* queue_response);
+  // Executes `operation` with `op`, which is reset first, so that the
+  // operations of a request can share it.
+  Status ExecuteOp(const Operation& operation, EagerContext* eager_context,
+                   EagerExecutor* eager_executor,
+                   CancellationManager* cancellation_manager,
+                   EagerOperation* op, QueueResponse* queue_response);
   Status SendTensor(const SendTensorOp& send_tensor,
                     EagerContext* eager_context);
   Status SendPackedHandle(const SendPackedHandleOp& send_packed_handle,
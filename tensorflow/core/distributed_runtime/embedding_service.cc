@@ -0,0 +1,333 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/embedding_service.h"
+
+#include <cstring>
+#include <utility>
+
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/distributed_runtime/worker_env.h"
+#include "tensorflow/core/framework/bounds_check.h"
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/resource_var.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+
+namespace tensorflow {
+
+namespace {
+
+Status ParseIndices(const TensorProto& proto, std::vector<int64_t>* indices) {
+  Tensor tensor;
+  if (!tensor.FromProto(proto)) {
+    return errors::InvalidArgument("Malformed indices of embedding request");
+  }
+  if (tensor.dims() != 1) {
+    return errors::InvalidArgument("Indices must be a vector, got shape ",
+                                   tensor.shape().DebugString());
+  }
+  if (tensor.dtype() == DT_INT32) {
+    const auto flat = tensor.flat<int32>();
+    indices->assign(flat.data(), flat.data() + flat.size());
+  } else if (tensor.dtype() == DT_INT64) {
+    const auto flat = tensor.flat<int64_t>();
+    indices->assign(flat.data(), flat.data() + flat.size());
+  } else {
+    return errors::InvalidArgument("Indices must be int32 or int64, got ",
+                                   DataTypeString(tensor.dtype()));
+  }
+  return OkStatus();
+}
+
+// Checks that `indices` are rows of `params`, and returns the shape of a row.
+Status CheckRows(const Tensor& params, const std::vector<int64_t>& indices,
+                 TensorShape* row_shape) {
+  if (params.dims() < 1) {
+    return errors::InvalidArgument(
+        "Embedding variables must have at least one dimension, got shape ",
+        params.shape().DebugString());
+  }
+  const int64_t num_rows = params.dim_size(0);
+  for (int64_t i = 0; i < indices.size(); ++i) {
+    if (!FastBoundsCheck(indices[i], num_rows)) {
+      return errors::InvalidArgument("indices[", i, "] = ", indices[i],
+                                     " is not in [0, ", num_rows, ")");
+    }
+  }
+  *row_shape = params.shape();
+  row_shape->RemoveDim(0);
+  return OkStatus();
+}
+
+Status GatherRows(const Tensor& params, const std::vector<int64_t>& indices,
+                  Tensor* values) {
+  TensorShape values_shape;
+  TF_RETURN_IF_ERROR(CheckRows(params, indices, &values_shape));
+  const int64_t row_bytes =
+      values_shape.num_elements() * DataTypeSize(params.dtype());
+  values_shape.InsertDim(0, indices.size());
+  *values = Tensor(params.dtype(), values_shape);
+  const char* src = static_cast<const char*>(params.data());
+  char* dst = static_cast<char*>(values->data());
+  for (int64_t i = 0; i < indices.size(); ++i) {
+    std::memcpy(dst + i * row_bytes, src + indices[i] * row_bytes, row_bytes);
+  }
+  return OkStatus();
+}
+
+// Applies the valid updates of a batch to `var`, which must be locked
+// exclusively, and sets the status of each update.
+template <typename T>
+void ApplyUpdates(Device* device, Var* var,
+                  const std::vector<std::vector<int64_t>>& indices,
+                  const std::vector<Tensor>& gradients,
+                  const std::vector<float>& learning_rates,
+                  std::vector<Status>* statuses) {
+  Tensor* params = var->tensor();
+  // The rows that the batch updates, in the order of their first update, and
+  // the sums of their scaled gradients.
+  absl::flat_hash_map<int64_t, int64_t> slots;
+  std::vector<int64_t> rows;
+  std::vector<T> sums;
+  int64_t row_size = 0;
+  for (int i = 0; i < indices.size(); ++i) {
+    TensorShape row_shape;
+    Status& s = (*statuses)[i];
+    if (gradients[i].dtype() != params->dtype()) {
+      s = errors::InvalidArgument("Gradients must be ",
+                                  DataTypeString(params->dtype()), ", got ",
+                                  DataTypeString(gradients[i].dtype()));
+      continue;
+    }
+    s = CheckRows(*params, indices[i], &row_shape);
+    if (!s.ok()) continue;
+    TensorShape gradients_shape = row_shape;
+    gradients_shape.InsertDim(0, indices[i].size());
+    if (gradients[i].shape() != gradients_shape) {
+      s = errors::InvalidArgument("Gradients must have shape ",
+                                  gradients_shape.DebugString(), ", got ",
+                                  gradients[i].shape().DebugString());
+      continue;
+    }
+    row_size = row_shape.num_elements();
+    const T learning_rate = static_cast<T>(learning_rates[i]);
+    const T* grads = gradients[i].flat<T>().data();
+    for (int64_t j = 0; j < indices[i].size(); ++j) {
+      auto slot = slots.emplace(indices[i][j], rows.size());
+      if (slot.second) {
+        rows.push_back(indices[i][j]);
+        sums.resize(sums.size() + row_size, T(0));
+      }
+      T* sum = &sums[slot.first->second * row_size];
+      const T* grad = grads + j * row_size;
+      for (int64_t k = 0; k < row_size; ++k) {
+        sum[k] += learning_rate * grad[k];
+      }
+    }
+  }
+  if (rows.empty()) return;
+
+  // Like PrepareToUpdateVariable, writes to a copy of the tensor if it is
+  // aliased by the outputs of earlier reads.
+  if (!var->copy_on_read_mode.load() && !params->RefCountIsOne()) {
+    Tensor copy(device->GetAllocator(AllocatorAttributes()), params->dtype(),
+                params->shape());
+    std::memcpy(copy.data(), params->data(), params->TotalBytes());
+    *params = copy;
+  }
+  T* flat = params->flat<T>().data();
+  for (int64_t r = 0; r < rows.size(); ++r) {
+    T* row = flat + rows[r] * row_size;
+    const T* sum = &sums[r * row_size];
+    for (int64_t k = 0; k < row_size; ++k) {
+      row[k] -= sum[k];
+    }
+  }
+}
+
+}  // namespace
+
+EmbeddingService::EmbeddingService(WorkerEnv* env) : env_(env) {}
+
+EmbeddingService::~EmbeddingService() {
+  mutex_lock l(mu_);
+  while (num_scheduled_ > 0) {
+    pending_cv_.wait(l);
+  }
+}
+
+void EmbeddingService::LookupAsync(const EmbeddingLookupRequest* request,
+                                   EmbeddingLookupResponse* response,
+                                   StatusCallback done) {
+  Lookup lookup;
+  Status s = ParseIndices(request->indices(), &lookup.indices);
+  if (s.ok()) {
+    lookup.response = response;
+    lookup.done = done;
+    s = Enqueue(request->device(), request->container(),
+                request->variable_name(), &lookup, /*update=*/nullptr);
+  }
+  if (!s.ok()) done(s);
+}
+
+void EmbeddingService::UpdateAsync(const EmbeddingUpdateRequest* request,
+                                   EmbeddingUpdateResponse* response,
+                                   StatusCallback done) {
+  Update update;
+  Status s = ParseIndices(request->indices(), &update.indices);
+  if (s.ok() && !update.gradients.FromProto(request->gradients())) {
+    s = errors::InvalidArgument("Malformed gradients of embedding update");
+  }
+  if (s.ok()) {
+    update.learning_rate = request->learning_rate();
+    update.done = done;
+    s = Enqueue(request->device(), request->container(),
+                request->variable_name(), /*lookup=*/nullptr, &update);
+  }
+  if (!s.ok()) done(s);
+}
+
+Status EmbeddingService::Enqueue(const std::string& device_name,
+                                 const std::string& container,
+                                 const std::string& name, Lookup* lookup,
+                                 Update* update) {
+  Device* device = nullptr;
+  TF_RETURN_IF_ERROR(env_->device_mgr->LookupDevice(device_name, &device));
+  if (device->device_type() != DEVICE_CPU) {
+    return errors::Unimplemented(
+        "Embeddings can only be served from CPU devices, not from ",
+        device_name);
+  }
+  const std::string& resource_container =
+      container.empty() ? device->resource_manager()->default_container()
+                        : container;
+  const std::string key =
+      strings::StrCat(device->name(), "|", resource_container, "|", name);
+  Queue* queue;
+  {
+    mutex_lock l(mu_);
+    std::unique_ptr<Queue>& entry = queues_[key];
+    if (entry == nullptr) {
+      entry = absl::make_unique<Queue>();
+      entry->device = device;
+      entry->container = resource_container;
+      entry->name = name;
+    }
+    queue = entry.get();
+    if (lookup != nullptr) queue->lookups.push_back(std::move(*lookup));
+    if (update != nullptr) queue->updates.push_back(std::move(*update));
+    if (queue->scheduled) return OkStatus();
+    queue->scheduled = true;
+    ++num_scheduled_;
+  }
+  env_->compute_pool->Schedule([this, queue]() { ProcessBatches(queue); });
+  return OkStatus();
+}
+
+void EmbeddingService::ProcessBatches(Queue* queue) {
+  while (true) {
+    std::vector<Lookup> lookups;
+    std::vector<Update> updates;
+    {
+      mutex_lock l(mu_);
+      if (queue->lookups.empty() && queue->updates.empty()) {
+        queue->scheduled = false;
+        if (--num_scheduled_ == 0) pending_cv_.notify_all();
+        return;
+      }
+      lookups.swap(queue->lookups);
+      updates.swap(queue->updates);
+    }
+    VLOG(2) << "Embedding batch of " << lookups.size() << " lookups and "
+            << updates.size() << " updates of " << queue->name;
+
+    Var* var = nullptr;
+    Status s = queue->device->resource_manager()->Lookup(queue->container,
+                                                         queue->name, &var);
+    if (s.ok() && !var->is_initialized) {
+      s = errors::FailedPrecondition("Embedding variable ", queue->name,
+                                     " is not initialized");
+    }
+    if (!s.ok()) {
+      if (var != nullptr) var->Unref();
+      for (Lookup& lookup : lookups) lookup.done(s);
+      for (Update& update : updates) update.done(s);
+      continue;
+    }
+    core::ScopedUnref unref(var);
+
+    // The updates go first, so that a worker that pushes its gradients and
+    // then looks up the same rows reads the updated rows.
+    std::vector<Status> update_statuses(updates.size());
+    if (!updates.empty()) {
+      std::vector<std::vector<int64_t>> indices;
+      std::vector<Tensor> gradients;
+      std::vector<float> learning_rates;
+      for (Update& update : updates) {
+        indices.push_back(std::move(update.indices));
+        gradients.push_back(std::move(update.gradients));
+        learning_rates.push_back(update.learning_rate);
+      }
+      mutex_lock l(*var->mu());
+      const DataType dtype = var->tensor()->dtype();
+      switch (dtype) {
+        case DT_FLOAT:
+          ApplyUpdates<float>(queue->device, var, indices, gradients,
+                              learning_rates, &update_statuses);
+          break;
+        case DT_DOUBLE:
+          ApplyUpdates<double>(queue->device, var, indices, gradients,
+                               learning_rates, &update_statuses);
+          break;
+        default:
+          update_statuses.assign(updates.size(),
+                                 errors::Unimplemented(
+                                     "Embedding updates are not supported for ",
+                                     DataTypeString(dtype), " variables"));
+      }
+    }
+    for (int i = 0; i < updates.size(); ++i) {
+      updates[i].done(update_statuses[i]);
+    }
+
+    std::vector<Status> lookup_statuses(lookups.size());
+    std::vector<Tensor> values(lookups.size());
+    if (!lookups.empty()) {
+      tf_shared_lock l(*var->mu());
+      const Tensor& params = *var->tensor();
+      for (int i = 0; i < lookups.size(); ++i) {
+        if (!DataTypeCanUseMemcpy(params.dtype())) {
+          lookup_statuses[i] = errors::Unimplemented(
+              "Embedding lookups are not supported for ",
+              DataTypeString(params.dtype()), " variables");
+          continue;
+        }
+        lookup_statuses[i] = GatherRows(params, lookups[i].indices, &values[i]);
+      }
+    }
+    for (int i = 0; i < lookups.size(); ++i) {
+      if (lookup_statuses[i].ok()) {
+        values[i].AsProtoTensorContent(lookups[i].response->mutable_values());
+      }
+      lookups[i].done(lookup_statuses[i]);
+    }
+  }
+}
+
+}  // namespace tensorflow
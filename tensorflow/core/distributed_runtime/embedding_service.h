@@ -0,0 +1,99 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_EMBEDDING_SERVICE_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_EMBEDDING_SERVICE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/protobuf/worker.pb.h"
+
+namespace tensorflow {
+
+class Device;
+struct WorkerEnv;
+typedef std::function<void(const Status&)> StatusCallback;
+
+// Serves the EmbeddingLookup and EmbeddingUpdate methods of a worker, which
+// read rows of a resource variable and apply SGD updates to them without
+// running a graph step, e.g. for the embeddings on a parameter server.
+//
+// The requests for a variable are batched: while a batch is processed, the
+// requests that arrive are queued and processed together in the next batch.
+// A batch takes the variable's lock once for all its lookups and once for
+// all its updates, and the gradients of the rows that several updates of the
+// batch touch are summed first, so that each row is written once. Requests
+// are thus never delayed to wait for a batch to fill up. An invalid request
+// fails on its own, without failing the other requests of its batch.
+class EmbeddingService {
+ public:
+  explicit EmbeddingService(WorkerEnv* env);
+  // Waits for the pending requests.
+  ~EmbeddingService();
+
+  void LookupAsync(const EmbeddingLookupRequest* request,
+                   EmbeddingLookupResponse* response, StatusCallback done);
+
+  void UpdateAsync(const EmbeddingUpdateRequest* request,
+                   EmbeddingUpdateResponse* response, StatusCallback done);
+
+ private:
+  struct Lookup {
+    std::vector<int64_t> indices;
+    EmbeddingLookupResponse* response;
+    StatusCallback done;
+  };
+  struct Update {
+    std::vector<int64_t> indices;
+    Tensor gradients;
+    float learning_rate;
+    StatusCallback done;
+  };
+  // The requests for one variable that are waiting for the next batch.
+  struct Queue {
+    Device* device = nullptr;
+    std::string container;
+    std::string name;
+    std::vector<Lookup> lookups;
+    std::vector<Update> updates;
+    // Whether a closure is processing the batches of this queue.
+    bool scheduled = false;
+  };
+
+  // Looks up the queue of the variable, and schedules the processing of its
+  // batches if this is the first pending request.
+  Status Enqueue(const std::string& device_name, const std::string& container,
+                 const std::string& name, Lookup* lookup, Update* update);
+  // Processes the batches of `queue` until it is empty.
+  void ProcessBatches(Queue* queue);
+
+  WorkerEnv* const env_;  // Not owned.
+  mutex mu_;
+  condition_variable pending_cv_;
+  int64_t num_scheduled_ TF_GUARDED_BY(mu_) = 0;
+  absl::flat_hash_map<std::string, std::unique_ptr<Queue>> queues_
+      TF_GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(EmbeddingService);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_EMBEDDING_SERVICE_H_
@@ -0,0 +1,198 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/embedding_service.h"
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/common_runtime/threadpool_device.h"
+#include "tensorflow/core/distributed_runtime/worker_env.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/resource_var.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/notification.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/public/session_options.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr char kDevice[] = "/job:ps/replica:0/task:0/device:CPU:0";
+
+class EmbeddingServiceTest : public ::testing::Test {
+ protected:
+  EmbeddingServiceTest() : pool_(Env::Default(), "embedding_service_test", 4) {
+    device_mgr_ = absl::make_unique<StaticDeviceMgr>(
+        absl::make_unique<ThreadPoolDevice>(SessionOptions(), kDevice,
+                                            Bytes(256 << 20), DeviceLocality(),
+                                            cpu_allocator()));
+    env_.env = Env::Default();
+    env_.device_mgr = device_mgr_.get();
+    env_.compute_pool = &pool_;
+    service_ = absl::make_unique<EmbeddingService>(&env_);
+  }
+
+  Var* CreateVariable(const string& name, const Tensor& value) {
+    Device* device;
+    TF_CHECK_OK(device_mgr_->LookupDevice(kDevice, &device));
+    Var* var = new Var(value.dtype());
+    *var->tensor() = value;
+    var->is_initialized = true;
+    ResourceMgr* rm = device->resource_manager();
+    TF_CHECK_OK(rm->Create(rm->default_container(), name, var));
+    return var;
+  }
+
+  Status Lookup(const string& name, const std::vector<int64_t>& indices,
+                Tensor* values) {
+    EmbeddingLookupRequest request;
+    request.set_device(kDevice);
+    request.set_variable_name(name);
+    test::AsTensor<int64_t>(indices).AsProtoTensorContent(
+        request.mutable_indices());
+    EmbeddingLookupResponse response;
+    Status status;
+    Notification done;
+    service_->LookupAsync(&request, &response, [&](const Status& s) {
+      status = s;
+      done.Notify();
+    });
+    done.WaitForNotification();
+    if (status.ok()) {
+      CHECK(values->FromProto(response.values()));
+    }
+    return status;
+  }
+
+  static void MakeUpdate(const string& name,
+                         const std::vector<int64_t>& indices,
+                         const Tensor& gradients, float learning_rate,
+                         EmbeddingUpdateRequest* request) {
+    request->set_device(kDevice);
+    request->set_variable_name(name);
+    test::AsTensor<int64_t>(indices).AsProtoTensorContent(
+        request->mutable_indices());
+    gradients.AsProtoTensorContent(request->mutable_gradients());
+    request->set_learning_rate(learning_rate);
+  }
+
+  Status Update(const string& name, const std::vector<int64_t>& indices,
+                const Tensor& gradients, float learning_rate) {
+    EmbeddingUpdateRequest request;
+    MakeUpdate(name, indices, gradients, learning_rate, &request);
+    EmbeddingUpdateResponse response;
+    Status status;
+    Notification done;
+    service_->UpdateAsync(&request, &response, [&](const Status& s) {
+      status = s;
+      done.Notify();
+    });
+    done.WaitForNotification();
+    return status;
+  }
+
+  thread::ThreadPool pool_;
+  std::unique_ptr<DeviceMgr> device_mgr_;
+  WorkerEnv env_;
+  std::unique_ptr<EmbeddingService> service_;
+};
+
+TEST_F(EmbeddingServiceTest, LooksUpRows) {
+  CreateVariable("embeddings", test::AsTensor<float>({0, 1, 10, 11, 20, 21},
+                                                     TensorShape({3, 2})));
+  Tensor values;
+  TF_ASSERT_OK(Lookup("embeddings", {2, 0, 2}, &values));
+  test::ExpectTensorEqual<float>(
+      values, test::AsTensor<float>({20, 21, 0, 1, 20, 21}, {3, 2}));
+  TF_ASSERT_OK(Lookup("embeddings", {}, &values));
+  EXPECT_EQ(values.shape(), TensorShape({0, 2}));
+}
+
+TEST_F(EmbeddingServiceTest, LookupFailures) {
+  CreateVariable("embeddings",
+                 test::AsTensor<float>({0, 1, 10, 11}, TensorShape({2, 2})));
+  Tensor values;
+  EXPECT_TRUE(errors::IsInvalidArgument(Lookup("embeddings", {2}, &values)));
+  EXPECT_TRUE(errors::IsNotFound(Lookup("missing", {0}, &values)));
+}
+
+TEST_F(EmbeddingServiceTest, UpdateSumsGradientsOfSameRow) {
+  Var* var = CreateVariable(
+      "embeddings", test::AsTensor<float>({0, 1, 10, 11}, TensorShape({2, 2})));
+  // The tensor of an earlier read, which must not change.
+  Tensor aliased = *var->tensor();
+  TF_ASSERT_OK(Update("embeddings", {1, 1},
+                      test::AsTensor<float>({1, 2, 3, 4}, {2, 2}), 0.5));
+  Tensor values;
+  TF_ASSERT_OK(Lookup("embeddings", {0, 1}, &values));
+  test::ExpectTensorEqual<float>(values,
+                                 test::AsTensor<float>({0, 1, 8, 8}, {2, 2}));
+  test::ExpectTensorEqual<float>(
+      aliased, test::AsTensor<float>({0, 1, 10, 11}, {2, 2}));
+}
+
+TEST_F(EmbeddingServiceTest, InvalidUpdateDoesNotChangeVariable) {
+  CreateVariable("embeddings",
+                 test::AsTensor<float>({0, 1, 10, 11}, TensorShape({2, 2})));
+  EXPECT_TRUE(errors::IsInvalidArgument(
+      Update("embeddings", {0}, test::AsTensor<float>({1, 2, 3}, {1, 3}), 1)));
+  EXPECT_TRUE(errors::IsInvalidArgument(
+      Update("embeddings", {0}, test::AsTensor<double>({1, 2}, {1, 2}), 1)));
+  EXPECT_TRUE(errors::IsInvalidArgument(
+      Update("embeddings", {5}, test::AsTensor<float>({1, 2}, {1, 2}), 1)));
+  Tensor values;
+  TF_ASSERT_OK(Lookup("embeddings", {0, 1}, &values));
+  test::ExpectTensorEqual<float>(
+      values, test::AsTensor<float>({0, 1, 10, 11}, {2, 2}));
+}
+
+TEST_F(EmbeddingServiceTest, ConcurrentRequests) {
+  CreateVariable("embeddings",
+                 test::AsTensor<double>({0, 0, 0, 0}, TensorShape({2, 2})));
+  constexpr int kNumUpdates = 200;
+  std::vector<EmbeddingUpdateRequest> requests(kNumUpdates);
+  std::vector<EmbeddingUpdateResponse> responses(kNumUpdates);
+  std::vector<Status> statuses(kNumUpdates);
+  std::vector<Tensor> values(kNumUpdates);
+  BlockingCounter counter(kNumUpdates);
+  for (int i = 0; i < kNumUpdates; ++i) {
+    MakeUpdate("embeddings", {i % 2, 1},
+               test::AsTensor<double>({1, 1, 1, 1}, {2, 2}), 1, &requests[i]);
+    pool_.Schedule([&, i]() {
+      service_->UpdateAsync(&requests[i], &responses[i],
+                            [&, i](const Status& s) {
+                              statuses[i] = s;
+                              counter.DecrementCount();
+                            });
+    });
+  }
+  counter.Wait();
+  for (const Status& s : statuses) {
+    TF_EXPECT_OK(s);
+  }
+  Tensor result;
+  TF_ASSERT_OK(Lookup("embeddings", {0, 1}, &result));
+  test::ExpectTensorEqual<double>(
+      result, test::AsTensor<double>({-100, -100, -300, -300}, {2, 2}));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -290,6 +290,15 @@ Status GraphMgr::InitItem(const string& handle, const GraphDef& gdef,
       skip_cost_models_ = false;
     }
     TF_RETURN_IF_ERROR(NewLocalExecutor(params, *unit->graph, &unit->root));
+    // TODO(zhengxq): if the device picks its own threadpool, we need to assign
+    //     less threads to the main compute pool by default.
+    thread::ThreadPool* pool = unit->device->tensorflow_device_thread_pool();
+    if (pool == nullptr) {
+      pool = worker_env_->compute_pool;
+    }
+    unit->runner = [pool](std::function<void()> fn) {
+      pool->Schedule(std::move(fn));
+    };
   }
   return OkStatus();
 }
@@ -547,22 +556,8 @@ void GraphMgr::StartParallelExecutors(
   if (LogMemory::IsEnabled()) {
     LogMemory::RecordStep(args.step_id, handle);
   }
-  thread::ThreadPool* pool = worker_env_->compute_pool;
-  using std::placeholders::_1;
-  // Line below is equivalent to this code, but does one less indirect call:
-  //  args.runner = [pool](std::function<void()> fn) { pool->Schedule(fn); };
-  auto default_runner = std::bind(&thread::ThreadPool::Schedule, pool, _1);
   for (const auto& unit : item->units) {
-    // TODO(zhengxq): if the device picks its own threadpool, we need to assign
-    //     less threads to the main compute pool by default.
-    thread::ThreadPool* device_thread_pool =
-        unit.device->tensorflow_device_thread_pool();
-    if (!device_thread_pool) {
-      args.runner = default_runner;
-    } else {
-      args.runner =
-          std::bind(&thread::ThreadPool::Schedule, device_thread_pool, _1);
-    }
+    args.runner = unit.runner;
     unit.root->RunAsync(args, barrier->Get());
   }
 }
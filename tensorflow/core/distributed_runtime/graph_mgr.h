@@ -118,6 +118,10 @@ class GraphMgr {
     FunctionLibraryRuntime* lib = nullptr;  // not owned.
     // Build the cost model if this value is strictly positive.
     int64_t build_cost_model = 0;
+    // Schedules the closures of the executor on the device's thread pool, or
+    // on the worker's compute pool. It only captures the pool, so that the
+    // copies made for every step don't allocate.
+    Executor::Args::Runner runner;
   };
 
   struct Item : public core::RefCounted {
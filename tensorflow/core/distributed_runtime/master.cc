@@ -55,6 +55,7 @@ limitations under the License.
 #include "tensorflow/core/protobuf/worker.pb.h"
 #include "tensorflow/core/public/session_options.h"
 #include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -72,6 +73,13 @@ Master::Master(MasterEnv* env, double session_gc_seconds)
   // Otherwise, fetches do not work.
   CHECK(!env->local_devices.empty());
 
+  bool cache_remote_devices;
+  TF_CHECK_OK(ReadBoolFromEnvVar("TF_MASTER_CACHE_REMOTE_DEVICES",
+                                 /*default_val=*/false, &cache_remote_devices));
+  if (cache_remote_devices) {
+    remote_device_cache_ = std::make_unique<RemoteDeviceCache>();
+  }
+
   if (session_gc_seconds_ > 0.0) {
     gc_thread_ = env_->env->StartThread(ThreadOptions(), "TF_master_GC",
                                         [this]() { GC(); });
@@ -137,9 +145,10 @@ class DeviceFinder {
   static Status GetRemoteDevices(
       const protobuf::RepeatedPtrField<string>& device_filters, MasterEnv* env,
       WorkerCacheInterface* worker_cache,
-      std::vector<std::unique_ptr<Device>>* out_remote) {
+      std::vector<std::unique_ptr<Device>>* out_remote,
+      RemoteDeviceCache* cache = nullptr) {
     DeviceFinder finder(device_filters, env, worker_cache);
-    finder.Start();
+    finder.Start(cache);
     TF_RETURN_IF_ERROR(finder.Wait());
     finder.GetRemoteDevices(env->local_devices, out_remote);
     return OkStatus();
@@ -234,7 +243,9 @@ class DeviceFinder {
     for (Device* dev : found_) delete dev;
   }
 
-  void Start() {
+  // If `cache` is not null, the workers whose devices are in it are not
+  // contacted, and the devices of the others are added to it.
+  void Start(RemoteDeviceCache* cache) {
     {
       mutex_lock l(mu_);
       num_pending_ = targets_.size();
@@ -246,10 +257,43 @@ class DeviceFinder {
     using std::placeholders::_1;
     using std::placeholders::_2;
     for (size_t i = 0; i < targets_.size(); ++i) {
-      // TODO(mrry): Propagate a timeout here, since `this->WhenFound()` may
-      // never be called.
-      NewRemoteDevices(env_->env, worker_cache_, targets_[i],
-                       std::bind(&ME::WhenFound, this, i, _1, _2));
+      if (cache == nullptr) {
+        // TODO(mrry): Propagate a timeout here, since `this->WhenFound()` may
+        // never be called.
+        NewRemoteDevices(env_->env, worker_cache_, targets_[i],
+                         std::bind(&ME::WhenFound, this, i, _1, _2));
+        continue;
+      }
+      std::vector<Device*> devices;
+      bool cached = false;
+      {
+        mutex_lock l(cache->mu);
+        auto it = cache->devices.find(targets_[i]);
+        if (it != cache->devices.end()) {
+          cached = true;
+          for (const DeviceAttributes& attributes : it->second) {
+            devices.push_back(NewRemoteDevice(env_->env, attributes).release());
+          }
+        }
+      }
+      if (cached) {
+        WhenFound(i, OkStatus(), &devices);
+        continue;
+      }
+      NewRemoteDevices(
+          env_->env, worker_cache_, targets_[i],
+          [this, i, cache](const Status& s, std::vector<Device*>* devices) {
+            if (s.ok()) {
+              std::vector<DeviceAttributes> attributes;
+              attributes.reserve(devices->size());
+              for (const Device* device : *devices) {
+                attributes.push_back(device->attributes());
+              }
+              mutex_lock l(cache->mu);
+              cache->devices[targets_[i]] = std::move(attributes);
+            }
+            WhenFound(i, s, devices);
+          });
     }
   }
 
@@ -437,9 +481,9 @@ void Master::CreateSession(const CreateSessionRequest* req,
       worker_cache = env_->worker_cache;
       // Ping all the workers and build the list of devices that the
       // session will use.
-      status =
-          DeviceFinder::GetRemoteDevices(req->config().device_filters(), env_,
-                                         worker_cache, remote_devices.get());
+      status = DeviceFinder::GetRemoteDevices(
+          req->config().device_filters(), env_, worker_cache,
+          remote_devices.get(), remote_device_cache_.get());
       if (!status.ok()) return;
       device_set.reset(new DeviceSet);
       for (auto&& d : *remote_devices) {
@@ -601,7 +645,8 @@ void Master::ListDevices(const ListDevicesRequest* req,
     }
     std::vector<std::unique_ptr<Device>> remote_devices;
     Status s = DeviceFinder::GetRemoteDevices({}, env_, env_->worker_cache,
-                                              &remote_devices);
+                                              &remote_devices,
+                                              remote_device_cache_.get());
     if (s.ok()) {
       for (Device* dev : env_->local_devices) {
         *(resp->add_local_device()) = dev->attributes();
@@ -660,6 +705,11 @@ void Master::Reset(const ResetRequest* req, ResetResponse* resp,
     }
     sessions_.clear();
   }
+  if (remote_device_cache_ != nullptr) {
+    // The workers may have been restarted with other devices.
+    mutex_lock l(remote_device_cache_->mu);
+    remote_device_cache_->devices.clear();
+  }
 
   CleanupWorkers(*req);
 
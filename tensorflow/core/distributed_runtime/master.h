@@ -16,9 +16,12 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_MASTER_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_MASTER_H_
 
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/distributed_runtime/call_options.h"
 #include "tensorflow/core/distributed_runtime/master_env.h"
 #include "tensorflow/core/distributed_runtime/master_session.h"
@@ -33,6 +36,14 @@ limitations under the License.
 
 namespace tensorflow {
 
+// The attributes of the devices of the workers of a master's cluster, by
+// worker name.
+struct RemoteDeviceCache {
+  mutex mu;
+  std::unordered_map<string, std::vector<DeviceAttributes>> devices
+      TF_GUARDED_BY(mu);
+};
+
 class Master {
  public:
   explicit Master(MasterEnv* env, double session_gc_seconds);
@@ -99,6 +110,11 @@ class Master {
   // Used to track ids for incoming requests so we can detect duplicates.
   RecentRequestIds recent_request_ids_;
 
+  // If TF_MASTER_CACHE_REMOTE_DEVICES is set, the devices of the workers of
+  // `env_->worker_cache` are only listed once, rather than for every session,
+  // until the master is reset. Otherwise null.
+  std::unique_ptr<RemoteDeviceCache> remote_device_cache_;
+
   // Call CleanupAll on all workers.
   void CleanupWorkers(const ResetRequest& reset);
 
@@ -102,6 +102,14 @@ class MasterInterface {
                                  const ReleaseCallableRequest* request,
                                  ReleaseCallableResponse* response) = 0;
 
+  // Reads a part of a fetched tensor that a RunStep call with
+  // `max_fetch_bytes` returned as a ChunkedFetch.
+  virtual Status ReadFetchChunk(CallOptions* call_options,
+                                const ReadFetchChunkRequest* request,
+                                ReadFetchChunkResponse* response) {
+    return errors::Unimplemented("ReadFetchChunk is not supported");
+  }
+
  protected:
   // NOTE: This should only be called by implementations of this
   // interface whose CreateRunStepResponse() method returns a
@@ -104,6 +104,10 @@ void InMemoryRunStepRequest::set_store_errors_in_response_body(
   store_errors_in_response_body_ = store_errors;
 }
 
+void InMemoryRunStepRequest::set_max_fetch_bytes(int64_t max_fetch_bytes) {
+  max_fetch_bytes_ = max_fetch_bytes;
+}
+
 string InMemoryRunStepRequest::DebugString() const {
   return ToProto().DebugString();
 }
@@ -125,6 +129,7 @@ const RunStepRequest& InMemoryRunStepRequest::ToProto() const {
       proto_version_->add_target(target_name(i));
     }
     *proto_version_->mutable_options() = options();
+    proto_version_->set_max_fetch_bytes(max_fetch_bytes_);
   }
   return *proto_version_;
 }
@@ -212,6 +217,10 @@ void MutableProtoRunStepRequest::set_store_errors_in_response_body(
   request_.set_store_errors_in_response_body(store_errors);
 }
 
+void MutableProtoRunStepRequest::set_max_fetch_bytes(int64_t max_fetch_bytes) {
+  request_.set_max_fetch_bytes(max_fetch_bytes);
+}
+
 int64_t MutableProtoRunStepRequest::request_id() const {
   return request_.request_id();
 }
@@ -832,6 +841,13 @@ Status InMemoryRunStepResponse::TensorValue(size_t i,
   return OkStatus();
 }
 
+size_t InMemoryRunStepResponse::num_chunked_fetches() const { return 0; }
+
+const ChunkedFetch& InMemoryRunStepResponse::chunked_fetch(size_t i) const {
+  LOG(FATAL) << "An InMemoryRunStepResponse has no chunked fetches";
+  return ChunkedFetch::default_instance();
+}
+
 const RunMetadata& InMemoryRunStepResponse::metadata() const {
   return metadata_;
 }
@@ -882,6 +898,14 @@ Status OwnedProtoRunStepResponse::TensorValue(size_t i,
   }
 }
 
+size_t OwnedProtoRunStepResponse::num_chunked_fetches() const {
+  return response_.chunked_fetch_size();
+}
+
+const ChunkedFetch& OwnedProtoRunStepResponse::chunked_fetch(size_t i) const {
+  return response_.chunked_fetch(i);
+}
+
 const RunMetadata& OwnedProtoRunStepResponse::metadata() const {
   return response_.metadata();
 }
@@ -938,6 +962,15 @@ Status NonOwnedProtoRunStepResponse::TensorValue(size_t i,
   }
 }
 
+size_t NonOwnedProtoRunStepResponse::num_chunked_fetches() const {
+  return response_->chunked_fetch_size();
+}
+
+const ChunkedFetch& NonOwnedProtoRunStepResponse::chunked_fetch(
+    size_t i) const {
+  return response_->chunked_fetch(i);
+}
+
 const RunMetadata& NonOwnedProtoRunStepResponse::metadata() const {
   return response_->metadata();
 }
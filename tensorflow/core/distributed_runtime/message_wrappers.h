@@ -111,6 +111,7 @@ class MutableRunStepRequestWrapper : public RunStepRequestWrapper {
   virtual void add_target(const string& name) = 0;
   virtual RunOptions* mutable_options() = 0;
   virtual void set_store_errors_in_response_body(bool store_errors) = 0;
+  virtual void set_max_fetch_bytes(int64_t max_fetch_bytes) = 0;
 };
 
 // Specialized (and mutable) wrapper for RunStep requests between a client and
@@ -142,6 +143,7 @@ class InMemoryRunStepRequest : public MutableRunStepRequestWrapper {
   void add_target(const string& name) override;
   RunOptions* mutable_options() override;
   void set_store_errors_in_response_body(bool store_errors) override;
+  void set_max_fetch_bytes(int64_t max_fetch_bytes) override;
 
  private:
   string session_handle_;
@@ -151,6 +153,7 @@ class InMemoryRunStepRequest : public MutableRunStepRequestWrapper {
   gtl::InlinedVector<string, 4> targets_;
   RunOptions options_;
   bool store_errors_in_response_body_ = false;
+  int64_t max_fetch_bytes_ = 0;
 
   // Holds a cached and owned representation of the proto
   // representation of this request, if needed, so that `ToProto()`
@@ -193,6 +196,7 @@ class MutableProtoRunStepRequest : public MutableRunStepRequestWrapper {
   void add_target(const string& name) override;
   RunOptions* mutable_options() override;
   void set_store_errors_in_response_body(bool store_errors) override;
+  void set_max_fetch_bytes(int64_t max_fetch_bytes) override;
 
  private:
   RunStepRequest request_;
@@ -634,6 +638,12 @@ class MutableRunStepResponseWrapper {
   virtual const string& tensor_name(size_t i) const = 0;
   virtual Status TensorValue(size_t i, Tensor* out_tensor) const = 0;
 
+  // The fetched tensors that are returned as chunked fetches, if
+  // `max_fetch_bytes` is set in the request, and whose contents must be read
+  // with `MasterInterface::ReadFetchChunk()`.
+  virtual size_t num_chunked_fetches() const = 0;
+  virtual const ChunkedFetch& chunked_fetch(size_t i) const = 0;
+
   // Stores the i^{th} recv value in `run_graph_response` in this
   // response with the given `name`.
   virtual Status AddTensorFromRunGraphResponse(
@@ -672,6 +682,8 @@ class InMemoryRunStepResponse : public MutableRunStepResponseWrapper {
   size_t num_tensors() const override;
   const string& tensor_name(size_t i) const override;
   Status TensorValue(size_t i, Tensor* out_tensor) const override;
+  size_t num_chunked_fetches() const override;
+  const ChunkedFetch& chunked_fetch(size_t i) const override;
   Status AddTensorFromRunGraphResponse(
       const string& name, MutableRunGraphResponseWrapper* run_graph_response,
       size_t i) override;
@@ -702,6 +714,8 @@ class OwnedProtoRunStepResponse : public MutableRunStepResponseWrapper {
   size_t num_tensors() const override;
   const string& tensor_name(size_t i) const override;
   Status TensorValue(size_t i, Tensor* out_tensor) const override;
+  size_t num_chunked_fetches() const override;
+  const ChunkedFetch& chunked_fetch(size_t i) const override;
   Status AddTensorFromRunGraphResponse(
       const string& name, MutableRunGraphResponseWrapper* run_graph_response,
       size_t i) override;
@@ -728,6 +742,8 @@ class NonOwnedProtoRunStepResponse : public MutableRunStepResponseWrapper {
   size_t num_tensors() const override;
   const string& tensor_name(size_t i) const override;
   Status TensorValue(size_t i, Tensor* out_tensor) const override;
+  size_t num_chunked_fetches() const override;
+  const ChunkedFetch& chunked_fetch(size_t i) const override;
   Status AddTensorFromRunGraphResponse(
       const string& name, MutableRunGraphResponseWrapper* run_graph_response,
       size_t i) override;
@@ -72,6 +72,22 @@ bool EnableStreaming() {
   return result;
 }
 
+// Returns the value of the TF_EAGER_CLIENT_ENQUEUE_BATCH_MICROS environment
+// variable, 0 by default. If it is positive, the streaming enqueue requests of
+// a context that are sent within this many microseconds of each other are
+// merged into one request, which the remote worker executes in one batch.
+// This trades a little latency for fewer RPCs when many small remote ops are
+// dispatched.
+int64_t EnqueueBatchMicros() {
+  static const int64_t batch_micros = []() {
+    int64_t micros;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_EAGER_CLIENT_ENQUEUE_BATCH_MICROS", 0,
+                                    &micros));
+    return micros;
+  }();
+  return batch_micros;
+}
+
 // Ref-counted thread to handle callbacks for completed requests a GRPC
 // completion queue. The thread might be shared by multiple eager clients, and
 // each one of them should hold a reference count to ensure that the thread
@@ -177,14 +193,28 @@ class GrpcEagerClient : public EagerClient {
     VLOG(1) << "Sending RPC to close remote eager context "
             << request->DebugString();
 
-    mutex_lock l(mu_);
-    const auto& it = enqueue_dispatchers_.find(request->context_id());
-    if (it != enqueue_dispatchers_.end()) {
-      it->second.CancelCall();
-      enqueue_dispatchers_.erase(it);
-    } else if (EnableStreaming()) {
-      LOG(ERROR) << "Remote EagerContext with id " << request->context_id()
-                 << " does not seem to exist.";
+    std::unique_ptr<EnqueueBatch> batch;
+    {
+      mutex_lock l(mu_);
+      const auto& it = enqueue_dispatchers_.find(request->context_id());
+      if (it != enqueue_dispatchers_.end()) {
+        it->second.CancelCall();
+        enqueue_dispatchers_.erase(it);
+      } else if (EnableStreaming()) {
+        LOG(ERROR) << "Remote EagerContext with id " << request->context_id()
+                   << " does not seem to exist.";
+      }
+      const auto& batch_it = enqueue_batches_.find(request->context_id());
+      if (batch_it != enqueue_batches_.end()) {
+        batch = std::move(batch_it->second);
+        enqueue_batches_.erase(batch_it);
+      }
+    }
+    if (batch != nullptr) {
+      for (const StatusCallback& done : batch->done) {
+        done(errors::Cancelled("Remote EagerContext with id ",
+                               request->context_id(), " was closed"));
+      }
     }
   }
 
@@ -211,7 +241,32 @@ class GrpcEagerClient : public EagerClient {
         it = it_and_bool.first;
       }
       // TODO(haoyuzhang): Consider supporting cancellation for streaming RPC?
-      it->second.SendNextRequest(*request, response, std::move(done_wrapped));
+      const int64_t batch_micros = EnqueueBatchMicros();
+      if (batch_micros <= 0) {
+        it->second.SendNextRequest(*request, response,
+                                   std::move(done_wrapped));
+        return;
+      }
+      // All the requests of the context go through the batch, so that they
+      // are sent in order.
+      std::unique_ptr<EnqueueBatch>& batch =
+          enqueue_batches_[request->context_id()];
+      if (batch == nullptr) {
+        batch = std::make_unique<EnqueueBatch>();
+        batch->request.set_context_id(request->context_id());
+        Ref();
+        Env::Default()->SchedClosureAfter(
+            batch_micros, [this, context_id = request->context_id()]() {
+              SendEnqueueBatch(context_id);
+              Unref();
+            });
+      }
+      for (const QueueItem& item : request->queue()) {
+        *batch->request.add_queue() = item;
+      }
+      batch->num_items.push_back(request->queue_size());
+      batch->responses.push_back(response);
+      batch->done.push_back(std::move(done_wrapped));
     } else {
       Notification n;
       Status status;
@@ -237,6 +292,52 @@ class GrpcEagerClient : public EagerClient {
   std::unordered_map<uint64, StreamingRPCDispatcher<EnqueueResponse>>
       enqueue_dispatchers_ TF_GUARDED_BY(mu_);
 
+  // Streaming enqueue requests of a context that are merged into one request;
+  // see EnqueueBatchMicros().
+  struct EnqueueBatch {
+    EnqueueRequest request;
+    // The number of queue items, the response and the callback of each
+    // merged request.
+    std::vector<int> num_items;
+    std::vector<EnqueueResponse*> responses;
+    std::vector<StatusCallback> done;
+  };
+  std::unordered_map<uint64, std::unique_ptr<EnqueueBatch>> enqueue_batches_
+      TF_GUARDED_BY(mu_);
+
+  // Sends the batch of `context_id`, and splits its response between the
+  // merged requests. The remote worker stops at the first item that fails,
+  // so an error fails all the requests of the batch.
+  void SendEnqueueBatch(uint64 context_id) {
+    mutex_lock l(mu_);
+    auto batch_it = enqueue_batches_.find(context_id);
+    if (batch_it == enqueue_batches_.end()) {
+      // The context was closed.
+      return;
+    }
+    std::shared_ptr<EnqueueBatch> batch = std::move(batch_it->second);
+    enqueue_batches_.erase(batch_it);
+    auto it = enqueue_dispatchers_.find(context_id);
+    DCHECK(it != enqueue_dispatchers_.end());
+    VLOG(3) << "Sending " << batch->done.size()
+            << " enqueue requests in one request for context " << context_id;
+    auto response = std::make_shared<EnqueueResponse>();
+    it->second.SendNextRequest(
+        batch->request, response.get(),
+        [batch, response](const Status& status) {
+          int item = 0;
+          for (int i = 0; i < batch->done.size(); ++i) {
+            if (status.ok()) {
+              for (int j = 0; j < batch->num_items[i]; ++j, ++item) {
+                batch->responses[i]->add_queue_response()->Swap(
+                    response->mutable_queue_response(item));
+              }
+            }
+            batch->done[i](status);
+          }
+        });
+  }
+
   StatusCallback callback_wrapper(StatusCallback done) {
     Ref();
     return [this, done = std::move(done)](const Status& status) {
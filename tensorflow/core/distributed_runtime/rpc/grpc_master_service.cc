@@ -30,6 +30,10 @@ limitations under the License.
 // RunGraph on workers.
 #include "tensorflow/core/distributed_runtime/rpc/grpc_master_service.h"
 
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
 #include "grpcpp/alarm.h"
 #include "grpcpp/server_builder.h"
 #include "tensorflow/core/distributed_runtime/master.h"
@@ -37,6 +41,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/rpc/grpc_call.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_master_service_impl.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
+#include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/tracing.h"
@@ -116,6 +121,9 @@ class GrpcMasterService : public AsyncServiceInterface {
       ENQUEUE_REQUEST(RunCallable, true);
     }
     ENQUEUE_REQUEST(ReleaseCallable, false);
+    for (int i = 0; i < 10; ++i) {
+      ENQUEUE_REQUEST(ReadFetchChunk, false);
+    }
 
     void* tag;
     bool ok;
@@ -142,6 +150,16 @@ class GrpcMasterService : public AsyncServiceInterface {
   const ConfigProto default_session_config_;
   ::grpc::Alarm* shutdown_alarm_ = nullptr;
 
+  // The contents of a fetched tensor that is read with ReadFetchChunk.
+  struct PendingFetch {
+    string session_handle;
+    std::shared_ptr<const string> content;
+  };
+  mutex fetches_mu_;
+  int64_t next_fetch_handle_ TF_GUARDED_BY(fetches_mu_) = 0;
+  std::unordered_map<int64_t, PendingFetch> pending_fetches_
+      TF_GUARDED_BY(fetches_mu_);
+
   template <class RequestMessage, class ResponseMessage>
   using MasterCall = Call<GrpcMasterService, grpc::MasterService::AsyncService,
                           RequestMessage, ResponseMessage>;
@@ -196,13 +214,17 @@ class GrpcMasterService : public AsyncServiceInterface {
     call->SetCancelCallback([call_opts]() { call_opts->StartCancel(); });
     master_impl_->RunStep(
         call_opts, wrapped_request, wrapped_response,
-        [call, call_opts, wrapped_request, wrapped_response,
+        [this, call, call_opts, wrapped_request, wrapped_response,
          trace](const Status& status) {
           call->ClearCancelCallback();
           delete call_opts;
           delete wrapped_request;
           delete wrapped_response;
           delete trace;
+          if (status.ok() && call->request.max_fetch_bytes() > 0) {
+            ChunkLargeFetches(call->request.session_handle(),
+                              call->request.max_fetch_bytes(), &call->response);
+          }
           if (call->request.store_errors_in_response_body() && !status.ok()) {
             call->response.set_status_code(status.code());
             call->response.set_status_error_message(status.error_message());
@@ -217,6 +239,7 @@ class GrpcMasterService : public AsyncServiceInterface {
   // RPC handler for deleting a session.
   void CloseSessionHandler(
       MasterCall<CloseSessionRequest, CloseSessionResponse>* call) {
+    ReleaseFetches(&call->request.session_handle());
     master_impl_->CloseSession(&call->request, &call->response,
                                [call](const Status& status) {
                                  call->SendResponse(ToGrpcStatus(status));
@@ -236,6 +259,7 @@ class GrpcMasterService : public AsyncServiceInterface {
 
   // RPC handler for resetting all sessions.
   void ResetHandler(MasterCall<ResetRequest, ResetResponse>* call) {
+    ReleaseFetches(/*session_handle=*/nullptr);
     master_impl_->Reset(&call->request, &call->response,
                         [call](const Status& status) {
                           call->SendResponse(ToGrpcStatus(status));
@@ -283,8 +307,92 @@ class GrpcMasterService : public AsyncServiceInterface {
     ENQUEUE_REQUEST(ReleaseCallable, false);
   }
 
+  // RPC handler for reading a part of a chunked fetch.
+  void ReadFetchChunkHandler(
+      MasterCall<ReadFetchChunkRequest, ReadFetchChunkResponse>* call) {
+    Status status = ReadFetchChunk(call->request, &call->response);
+    call->SendResponse(ToGrpcStatus(status));
+    ENQUEUE_REQUEST(ReadFetchChunk, false);
+  }
+
 #undef ENQUEUE_REQUEST
 
+  // Moves the fetched tensors of `response` whose contents take more than
+  // `max_bytes` to `pending_fetches_`, and returns them as chunked fetches.
+  void ChunkLargeFetches(const string& session_handle, int64_t max_bytes,
+                         RunStepResponse* response) {
+    auto* tensors = response->mutable_tensor();
+    int num_kept = 0;
+    for (int i = 0; i < tensors->size(); ++i) {
+      NamedTensorProto* named_tensor = tensors->Mutable(i);
+      TensorProto* tensor = named_tensor->mutable_tensor();
+      const int64_t size = tensor->tensor_content().size();
+      if (size <= max_bytes) {
+        if (num_kept != i) tensors->SwapElements(num_kept, i);
+        ++num_kept;
+        continue;
+      }
+      ChunkedFetch* fetch = response->add_chunked_fetch();
+      fetch->set_name(named_tensor->name());
+      fetch->set_dtype(tensor->dtype());
+      fetch->mutable_tensor_shape()->Swap(tensor->mutable_tensor_shape());
+      fetch->set_size(size);
+      auto content = std::make_shared<string>();
+      content->swap(*tensor->mutable_tensor_content());
+      mutex_lock l(fetches_mu_);
+      fetch->set_fetch_handle(next_fetch_handle_);
+      pending_fetches_[next_fetch_handle_++] = {session_handle,
+                                                std::move(content)};
+    }
+    tensors->DeleteSubrange(num_kept, tensors->size() - num_kept);
+  }
+
+  Status ReadFetchChunk(const ReadFetchChunkRequest& request,
+                        ReadFetchChunkResponse* response) {
+    std::shared_ptr<const string> content;
+    int64_t size;
+    {
+      mutex_lock l(fetches_mu_);
+      auto it = pending_fetches_.find(request.fetch_handle());
+      if (it == pending_fetches_.end() ||
+          it->second.session_handle != request.session_handle()) {
+        return errors::InvalidArgument("Unknown fetch handle ",
+                                       request.fetch_handle(), " in session ",
+                                       request.session_handle());
+      }
+      content = it->second.content;
+      const int64_t content_size = content->size();
+      if (request.offset() < 0 || request.offset() >= content_size ||
+          request.max_bytes() <= 0) {
+        return errors::InvalidArgument(
+            "Invalid range of chunked fetch ", request.fetch_handle(),
+            ": offset ", request.offset(), ", max_bytes ", request.max_bytes(),
+            ", size ", content_size);
+      }
+      size = std::min(request.max_bytes(), content_size - request.offset());
+      // The fetch is released once its last chunk is read.
+      if (request.offset() + size == content_size) {
+        pending_fetches_.erase(it);
+      }
+    }
+    response->set_data(content->data() + request.offset(), size);
+    return OkStatus();
+  }
+
+  // Releases the chunked fetches of the given session, or of all the
+  // sessions if `session_handle` is null.
+  void ReleaseFetches(const string* session_handle) {
+    mutex_lock l(fetches_mu_);
+    for (auto it = pending_fetches_.begin(); it != pending_fetches_.end();) {
+      if (session_handle == nullptr ||
+          it->second.session_handle == *session_handle) {
+        it = pending_fetches_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
   // Start tracing, including the ID attached to the RPC.
   profiler::TraceMe* TraceRpc(
       StringPiece name,
@@ -72,6 +72,9 @@ class MasterService final {
     virtual ::grpc::Status ReleaseCallable(
         ::grpc::ClientContext* context, const ReleaseCallableRequest& request,
         ReleaseCallableResponse* response) = 0;
+    virtual ::grpc::Status ReadFetchChunk(::grpc::ClientContext* context,
+                                          const ReadFetchChunkRequest& request,
+                                          ReadFetchChunkResponse* response) = 0;
   };
   class Stub final : public StubInterface {
    public:
@@ -106,6 +109,9 @@ class MasterService final {
     ::grpc::Status ReleaseCallable(::grpc::ClientContext* context,
                                    const ReleaseCallableRequest& request,
                                    ReleaseCallableResponse* response) override;
+    ::grpc::Status ReadFetchChunk(::grpc::ClientContext* context,
+                                  const ReadFetchChunkRequest& request,
+                                  ReadFetchChunkResponse* response) override;
 
    private:
     std::shared_ptr< ::grpc::ChannelInterface> channel_;
@@ -119,6 +125,7 @@ class MasterService final {
     const ::grpc::internal::RpcMethod rpcmethod_MakeCallable_;
     const ::grpc::internal::RpcMethod rpcmethod_RunCallable_;
     const ::grpc::internal::RpcMethod rpcmethod_ReleaseCallable_;
+    const ::grpc::internal::RpcMethod rpcmethod_ReadFetchChunk_;
   };
   static std::unique_ptr<Stub> NewStub(
       const std::shared_ptr< ::grpc::ChannelInterface>& channel,
@@ -208,6 +215,14 @@ class MasterService final {
       ::grpc::Service::RequestAsyncUnary(9, context, request, response,
                                          new_call_cq, notification_cq, tag);
     }
+    void RequestReadFetchChunk(
+        ::grpc::ServerContext* context, ReadFetchChunkRequest* request,
+        ::grpc::ServerAsyncResponseWriter<ReadFetchChunkResponse>* response,
+        ::grpc::CompletionQueue* new_call_cq,
+        ::grpc::ServerCompletionQueue* notification_cq, void* tag) {
+      ::grpc::Service::RequestAsyncUnary(10, context, request, response,
+                                         new_call_cq, notification_cq, tag);
+    }
   };
 };
 
@@ -110,6 +110,12 @@ class GrpcRemoteMaster : public MasterInterface {
     return CallWithRetry(call_options, request, response,
                          &MasterServiceStub::ReleaseCallable);
   }
+  Status ReadFetchChunk(CallOptions* call_options,
+                        const ReadFetchChunkRequest* request,
+                        ReadFetchChunkResponse* response) override {
+    return CallWithRetry(call_options, request, response,
+                         &MasterServiceStub::ReadFetchChunk);
+  }
 
  private:
   // Start tracing, attaching a unique ID to both the trace and the RPC.
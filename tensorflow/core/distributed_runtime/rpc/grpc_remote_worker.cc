@@ -66,6 +66,9 @@ class GrpcRemoteWorker : public WorkerInterface {
         instancesource_(Method(GrpcWorkerMethod::kCompleteInstance)),
         getstepsequence_(Method(GrpcWorkerMethod::kGetStepSequence)),
         markrecvfinished_(Method(GrpcWorkerMethod::kMarkRecvFinished)),
+        recvtensors_(Method(GrpcWorkerMethod::kRecvTensors)),
+        embeddinglookup_(Method(GrpcWorkerMethod::kEmbeddingLookup)),
+        embeddingupdate_(Method(GrpcWorkerMethod::kEmbeddingUpdate)),
         logger_(logger),
         target_(target) {}
 
@@ -256,6 +259,25 @@ class GrpcRemoteWorker : public WorkerInterface {
     IssueRequest(request, response, recvtensor_, callback, call_opts);
   }
 
+  void RecvTensorsAsync(CallOptions* call_opts,
+                        const RecvTensorsRequest* request,
+                        RecvTensorsResponse* response,
+                        StatusCallback done) override {
+    IssueRequest(request, response, recvtensors_, std::move(done), call_opts);
+  }
+
+  void EmbeddingLookupAsync(const EmbeddingLookupRequest* request,
+                            EmbeddingLookupResponse* response,
+                            StatusCallback done) override {
+    IssueRequest(request, response, embeddinglookup_, std::move(done));
+  }
+
+  void EmbeddingUpdateAsync(const EmbeddingUpdateRequest* request,
+                            EmbeddingUpdateResponse* response,
+                            StatusCallback done) override {
+    IssueRequest(request, response, embeddingupdate_, std::move(done));
+  }
+
   void LoggingAsync(const LoggingRequest* request, LoggingResponse* response,
                     StatusCallback done) override {
     IssueRequest(request, response, logging_, done);
@@ -329,6 +351,9 @@ class GrpcRemoteWorker : public WorkerInterface {
   const ::grpc::string instancesource_;
   const ::grpc::string getstepsequence_;
   const ::grpc::string markrecvfinished_;
+  const ::grpc::string recvtensors_;
+  const ::grpc::string embeddinglookup_;
+  const ::grpc::string embeddingupdate_;
 
   // Support for logging.
   WorkerCacheLogger* logger_;
@@ -29,13 +29,16 @@ bool GrpcResponseCache::QueueRequest(int64_t request_id, int64_t step_id,
 
   if (entry.state == ResponseCacheEntry::State::FINISHED) {
     VLOG(1) << "Reuse cached response for " << request_id;
-    // Make a copy of the ResponseCacheEntry so that we can run FinishResponse
-    // outside the critical section. FinishResponse can be potentially
+    lru_.splice(lru_.begin(), lru_, entry.lru_position);
+    // Copy the response, which shares the buffer of the tensor, so that we
+    // can run `cb` outside the critical section. It can be potentially
     // expensive.
-    auto entry_copy = entry;
+    const Tensor tensor = entry.tensor;
+    const bool is_dead = entry.is_dead;
+    const Status status = entry.response_status;
 
     mu_.unlock();
-    entry_copy.FinishResponse(cb);
+    cb(tensor, is_dead, status);
     return true;
   }
 
@@ -59,7 +62,7 @@ bool GrpcResponseCache::QueueRequest(int64_t request_id, int64_t step_id,
 void GrpcResponseCache::OnRequestFinished(int64_t request_id,
                                           const Tensor& tensor, bool is_dead,
                                           const Status& status) {
-  absl::optional<ResponseCacheEntry> entry_copy;
+  std::vector<FinishResponseCB> callbacks;
 
   {
     mutex_lock m(mu_);
@@ -80,22 +83,28 @@ void GrpcResponseCache::OnRequestFinished(int64_t request_id,
     entry.is_dead = is_dead;
     entry.response_status = status;
     entry.state = ResponseCacheEntry::State::FINISHED;
+    entry.lru_position = lru_.insert(lru_.begin(), request_id);
+    bytes_ += tensor.TotalBytes();
 
-    // We copy the extra work out of the critical section in order to avoid
+    // We move the extra work out of the critical section in order to avoid
     // serializing the work for sending response.
-    entry_copy = entry;
-
-    entry.callbacks.clear();
+    callbacks.swap(entry.callbacks);
+    EvictEntries();
   }
 
-  for (auto& cb : entry_copy->callbacks) {
-    entry_copy->FinishResponse(cb);
+  for (auto& cb : callbacks) {
+    cb(tensor, is_dead, status);
   }
 }
 
 void GrpcResponseCache::EraseRequestId(int64_t request_id) {
   mutex_lock m(mu_);
-  response_cache_.erase(request_id);
+  auto it = response_cache_.find(request_id);
+  if (it == response_cache_.end()) return;
+  if (it->second.state == ResponseCacheEntry::State::FINISHED) {
+    ReleaseFinishedEntry(it->second);
+  }
+  response_cache_.erase(it);
 }
 
 void GrpcResponseCache::CleanEntriesForStep(int64_t step_id) {
@@ -105,6 +114,9 @@ void GrpcResponseCache::CleanEntriesForStep(int64_t step_id) {
        it != last;) {
     if (it->second.step_id == step_id) {
       VLOG(1) << "Erase stale GrpcResponseCache entry " << it->first;
+      if (it->second.state == ResponseCacheEntry::State::FINISHED) {
+        ReleaseFinishedEntry(it->second);
+      }
       it = response_cache_.erase(it);
     } else {
       ++it;
@@ -112,4 +124,22 @@ void GrpcResponseCache::CleanEntriesForStep(int64_t step_id) {
   }
 }
 
+void GrpcResponseCache::ReleaseFinishedEntry(const ResponseCacheEntry& entry) {
+  lru_.erase(entry.lru_position);
+  bytes_ -= entry.tensor.TotalBytes();
+}
+
+void GrpcResponseCache::EvictEntries() {
+  if (max_bytes_ <= 0) return;
+  while (bytes_ > max_bytes_ && !lru_.empty()) {
+    const int64_t request_id = lru_.back();
+    auto it = response_cache_.find(request_id);
+    DCHECK(it != response_cache_.end());
+    VLOG(1) << "Evict GrpcResponseCache entry " << request_id << " of "
+            << it->second.tensor.TotalBytes() << " bytes";
+    ReleaseFinishedEntry(it->second);
+    response_cache_.erase(it);
+  }
+}
+
 }  // namespace tensorflow
@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_RESPONSE_CACHE_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_RESPONSE_CACHE_H_
 
+#include <list>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -37,12 +38,20 @@ namespace tensorflow {
 // * PENDING: this is the first call of the RPC, and it will transition to
 // * ACTIVE: another thread is active processing this RPC
 // * FINISHED: the worker has finished processing the method
+//
+// The finished responses hold references to their tensors, which share the
+// buffers of the tensors that were sent rather than copies of them. If
+// `max_bytes` is positive, the least recently used finished responses are
+// dropped once their tensors take more than `max_bytes`; a retry of a dropped
+// request then runs the method again.
 
 class GrpcResponseCache {
  public:
   using FinishResponseCB = std::function<void(
       const Tensor& tensor, bool is_dead, const Status& status)>;
 
+  explicit GrpcResponseCache(int64_t max_bytes = 0) : max_bytes_(max_bytes) {}
+
   // Add the given request to the cache.
   // If the request is in the cache,
   //    If it is finished, invoke `cb` immediately
@@ -64,6 +73,12 @@ class GrpcResponseCache {
   // Erase cache entries with the given step_id
   void CleanEntriesForStep(int64_t step_id);
 
+  // The bytes of the tensors of the finished responses.
+  int64_t bytes() {
+    mutex_lock m(mu_);
+    return bytes_;
+  }
+
  private:
   struct ResponseCacheEntry {
     enum class State {
@@ -82,12 +97,24 @@ class GrpcResponseCache {
       cb(tensor, is_dead, response_status);
     }
     std::vector<FinishResponseCB> callbacks;
+    // The position of a finished entry in `lru_`.
+    std::list<int64_t>::iterator lru_position;
   };
 
+  // Removes a finished entry from `lru_` and from the bytes of the cache.
+  void ReleaseFinishedEntry(const ResponseCacheEntry& entry)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Drops the least recently used finished entries beyond `max_bytes_`.
+  void EvictEntries() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const int64_t max_bytes_;
   mutex mu_;
   // response_cache_ is expected to be small, as entries are cleared immediately
   // on ack from the receiver.
   gtl::FlatMap<int64_t, ResponseCacheEntry> response_cache_ TF_GUARDED_BY(mu_);
+  // The request ids of the finished entries, most recently used first.
+  std::list<int64_t> lru_ TF_GUARDED_BY(mu_);
+  int64_t bytes_ TF_GUARDED_BY(mu_) = 0;
 };
 
 }  // namespace tensorflow
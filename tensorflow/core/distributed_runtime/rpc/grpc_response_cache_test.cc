@@ -0,0 +1,87 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/rpc/grpc_response_cache.h"
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Returns true if `request_id` was served from `cache`, in which case the
+// cached tensor is stored in `tensor`.
+bool Lookup(GrpcResponseCache* cache, int64_t request_id, Tensor* tensor) {
+  return cache->QueueRequest(
+      request_id, /*step_id=*/1,
+      [tensor](const Tensor& t, bool is_dead, const Status& status) {
+        TF_EXPECT_OK(status);
+        *tensor = t;
+      });
+}
+
+TEST(GrpcResponseCacheTest, SharesCachedTensor) {
+  GrpcResponseCache cache;
+  Tensor value = test::AsTensor<float>({1, 2, 3, 4});
+  Tensor unused;
+  EXPECT_FALSE(Lookup(&cache, 1, &unused));
+  cache.OnRequestFinished(1, value, false, OkStatus());
+  EXPECT_EQ(cache.bytes(), value.TotalBytes());
+
+  Tensor cached;
+  EXPECT_TRUE(Lookup(&cache, 1, &cached));
+  EXPECT_EQ(cached.tensor_data().data(), value.tensor_data().data());
+
+  cache.EraseRequestId(1);
+  EXPECT_EQ(cache.bytes(), 0);
+}
+
+TEST(GrpcResponseCacheTest, EvictsLeastRecentlyUsed) {
+  const Tensor value = test::AsTensor<float>({1, 2, 3, 4});
+  GrpcResponseCache cache(/*max_bytes=*/2 * value.TotalBytes());
+  Tensor tensor;
+  for (int64_t request_id : {1, 2}) {
+    EXPECT_FALSE(Lookup(&cache, request_id, &tensor));
+    cache.OnRequestFinished(request_id, value, false, OkStatus());
+  }
+  // Using the first response makes the second one the least recently used.
+  EXPECT_TRUE(Lookup(&cache, 1, &tensor));
+  EXPECT_FALSE(Lookup(&cache, 3, &tensor));
+  cache.OnRequestFinished(3, value, false, OkStatus());
+  EXPECT_EQ(cache.bytes(), 2 * value.TotalBytes());
+
+  EXPECT_TRUE(Lookup(&cache, 1, &tensor));
+  EXPECT_TRUE(Lookup(&cache, 3, &tensor));
+  EXPECT_FALSE(Lookup(&cache, 2, &tensor));
+}
+
+TEST(GrpcResponseCacheTest, RunsPendingCallbacks) {
+  GrpcResponseCache cache;
+  const Tensor value = test::AsTensor<float>({1, 2});
+  Tensor first, second;
+  EXPECT_FALSE(Lookup(&cache, 1, &first));
+  EXPECT_TRUE(Lookup(&cache, 1, &second));
+  cache.OnRequestFinished(1, value, false, OkStatus());
+  test::ExpectTensorEqual<float>(first, value);
+  test::ExpectTensorEqual<float>(second, value);
+
+  cache.CleanEntriesForStep(1);
+  EXPECT_EQ(cache.bytes(), 0);
+}
+
+}  // namespace
+}  // namespace tensorflow
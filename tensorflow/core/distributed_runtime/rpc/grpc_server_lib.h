@@ -62,6 +62,14 @@ typedef std::function<std::unique_ptr<GrpcWorker>(WorkerEnv*,
                                                   const ConfigProto& config)>
     WorkerCreationFunction;
 
+// Subclasses of GrpcServer can move tensors over another transport, e.g.
+// RDMA, by setting these options in their Init(): `rendezvous_mgr_func` makes
+// a RendezvousMgr whose BaseRemoteRendezvous::RecvFromRemoteAsync() receives
+// tensors over that transport, `collective_mgr_func` makes the collective
+// executors use it too, through a CollectiveRemoteAccessDistributed subclass,
+// and `service_func` registers the gRPC service that the workers use to set up
+// the transport, e.g. to exchange the memory regions of their allocators. The
+// defaults receive the tensors over gRPC.
 struct GrpcServerOptions {
   ServiceInitFunction service_func = nullptr;
   RendezvousMgrCreationFunction rendezvous_mgr_func = nullptr;
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_session.h"
 
+#include <cstring>
 #include <unordered_map>
 
 #include "tensorflow/core/common_runtime/session_factory.h"
@@ -24,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/request_id.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_channel.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_remote_master.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/tensor.pb.h"
@@ -31,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/protobuf/master.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -38,7 +41,10 @@ const char* const kSchemePrefix = "grpc://";
 const size_t kSchemePrefixLength = strlen(kSchemePrefix);
 
 GrpcSession::GrpcSession(const SessionOptions& options)
-    : options_(options), current_graph_version_(-1) {}
+    : options_(options), current_graph_version_(-1) {
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRPC_SESSION_MAX_FETCH_BYTES",
+                                  /*default_val=*/0, &max_fetch_bytes_));
+}
 
 GrpcSession::~GrpcSession() {}
 
@@ -227,6 +233,11 @@ Status GrpcSession::RunHelper(
   // Support long error messages by storing the error code in the response body.
   req->set_store_errors_in_response_body(true);
 
+  // A local master returns the fetched tensors without copying them.
+  if (!is_local_ && max_fetch_bytes_ > 0) {
+    req->set_max_fetch_bytes(max_fetch_bytes_);
+  }
+
   // Build an index from fetch tensor name to first index in
   // output_tensor_names.
   std::unordered_map<string, int> output_name_to_offset;
@@ -265,6 +276,18 @@ Status GrpcSession::RunHelper(
     TF_RETURN_IF_ERROR(resp->TensorValue(i, &output));
     (*outputs)[fetch_it->second] = output;
   }
+  for (size_t i = 0; i < resp->num_chunked_fetches(); ++i) {
+    const ChunkedFetch& fetch = resp->chunked_fetch(i);
+    auto fetch_it = output_name_to_offset.find(fetch.name());
+    if (fetch_it == output_name_to_offset.end()) {
+      return errors::Internal("Received response for unrequested fetch: ",
+                              fetch.name());
+    }
+
+    Tensor output;
+    TF_RETURN_IF_ERROR(ReadChunkedFetch(&call_options, fetch, &output));
+    (*outputs)[fetch_it->second] = output;
+  }
   // In the unlikely event that output_tensor_names contains duplicates, fill in
   // the duplicate values.
   if (output_name_to_offset.size() != output_tensor_names.size()) {
@@ -313,6 +336,46 @@ Status GrpcSession::RunProto(CallOptions* call_options,
   return master_->RunStep(call_options, req, resp);
 }
 
+Status GrpcSession::ReadChunkedFetch(CallOptions* call_options,
+                                     const ChunkedFetch& fetch,
+                                     Tensor* out_tensor) {
+  if (!DataTypeCanUseMemcpy(fetch.dtype())) {
+    return errors::Internal("Unexpected chunked fetch ", fetch.name(),
+                            " of type ", DataTypeString(fetch.dtype()));
+  }
+  TensorShape shape;
+  TF_RETURN_IF_ERROR(
+      TensorShape::BuildTensorShape(fetch.tensor_shape(), &shape));
+  // The chunks are copied directly into the buffer of the fetched tensor.
+  Tensor tensor(cpu_allocator(), fetch.dtype(), shape);
+  const int64_t size = tensor.TotalBytes();
+  if (size != fetch.size()) {
+    return errors::Internal("Chunked fetch ", fetch.name(), " has ",
+                            fetch.size(), " bytes, expected ", size);
+  }
+  char* data = const_cast<char*>(tensor.tensor_data().data());
+
+  ReadFetchChunkRequest req;
+  TF_RETURN_IF_ERROR(Handle(req.mutable_session_handle()));
+  req.set_fetch_handle(fetch.fetch_handle());
+  req.set_max_bytes(max_fetch_bytes_);
+  ReadFetchChunkResponse resp;
+  for (int64_t offset = 0; offset < size;) {
+    req.set_offset(offset);
+    TF_RETURN_IF_ERROR(master_->ReadFetchChunk(call_options, &req, &resp));
+    const string& chunk = resp.data();
+    if (chunk.empty() || chunk.size() > size - offset) {
+      return errors::Internal("Invalid chunk of ", chunk.size(),
+                              " bytes at offset ", offset, " of fetch ",
+                              fetch.name());
+    }
+    std::memcpy(data + offset, chunk.data(), chunk.size());
+    offset += chunk.size();
+  }
+  *out_tensor = std::move(tensor);
+  return OkStatus();
+}
+
 Status GrpcSession::PRunSetup(const std::vector<string>& input_names,
                               const std::vector<string>& output_names,
                               const std::vector<string>& target_nodes,
@@ -127,6 +127,10 @@ class GrpcSession : public Session {
 
   bool is_local_ = false;
 
+  // If positive, the fetches larger than this are read from a remote master
+  // in chunks of this size (see RunStepRequest.max_fetch_bytes).
+  int64_t max_fetch_bytes_ = 0;
+
   Status Handle(string* out_handle) TF_LOCKS_EXCLUDED(mu_);
 
   Status RunHelper(const RunOptions& run_options,
@@ -139,6 +143,10 @@ class GrpcSession : public Session {
   Status RunProto(CallOptions* call_options, MutableRunStepRequestWrapper* req,
                   MutableRunStepResponseWrapper* resp);
 
+  // Reads the contents of `fetch` from the master into `out_tensor`.
+  Status ReadChunkedFetch(CallOptions* call_options, const ChunkedFetch& fetch,
+                          Tensor* out_tensor);
+
   // Implementations for all the public interfaces.
   Status CreateImpl(CallOptions* call_options, GraphDef graph);
   Status ExtendImpl(CallOptions* call_options, GraphDef graph);
@@ -286,6 +286,38 @@ TEST(GrpcSessionTest, FetchMultipleTimes) {
   TF_CHECK_OK(session->Close());
 }
 
+TEST(GrpcSessionTest, LargeFetchInChunks) {
+  Graph graph(OpRegistry::Global());
+  Tensor large(DT_FLOAT, TensorShape({1000}));
+  for (int i = 0; i < 1000; ++i) large.flat<float>()(i) = i;
+  Node* large_node = test::graph::Constant(&graph, large);
+  Tensor small(DT_FLOAT, TensorShape({2}));
+  test::FillValues<float>(&small, {1, 2});
+  Node* small_node = test::graph::Constant(&graph, small);
+  GraphDef graph_def;
+  test::graph::ToGraphDef(&graph, &graph_def);
+
+  std::unique_ptr<test::TestCluster> cluster;
+  TF_CHECK_OK(test::TestCluster::MakeTestCluster(Devices(1, 0), 1, &cluster));
+
+  // Fetches of more than 100 bytes are read in chunks of 100 bytes.
+  setenv("TF_GRPC_SESSION_MAX_FETCH_BYTES", "100", 1);
+  std::unique_ptr<Session> session(
+      NewRemote(Options(cluster->targets()[0], 1)));
+  unsetenv("TF_GRPC_SESSION_MAX_FETCH_BYTES");
+  ASSERT_TRUE(session != nullptr);
+
+  TF_CHECK_OK(session->Create(graph_def));
+  std::vector<Tensor> outputs;
+  TF_CHECK_OK(session->Run(
+      {}, {large_node->name() + ":0", small_node->name() + ":0"}, {},
+      &outputs));
+  ASSERT_EQ(2, outputs.size());
+  test::ExpectTensorEqual<float>(large, outputs[0]);
+  test::ExpectTensorEqual<float>(small, outputs[1]);
+  TF_CHECK_OK(session->Close());
+}
+
 TEST(GrpcSessionTest, DisableOutputPartitionGraphs) {
   GraphDef graph;
   string node_names[3];
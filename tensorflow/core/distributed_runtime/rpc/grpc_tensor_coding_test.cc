@@ -17,15 +17,37 @@ limitations under the License.
 
 #include "grpcpp/support/byte_buffer.h"
 #include "grpcpp/support/slice.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
+#include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/framework/device_attributes.pb.h"
+#include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 
 namespace tensorflow {
 
+class DummyDevice : public DeviceBase {
+ public:
+  explicit DummyDevice(Env* env) : DeviceBase(env) {
+    attr_.set_device_type("CPU");
+  }
+
+  const DeviceAttributes& attributes() const override { return attr_; }
+
+  Allocator* GetAllocator(AllocatorAttributes attr) override {
+    return cpu_allocator();
+  }
+
+ private:
+  DeviceAttributes attr_;
+};
+
 class GrpcTensorCodingTest : public ::testing::Test {
  public:
   void Validate(const Tensor& t, bool is_dead) {
@@ -100,4 +122,39 @@ TEST_F(GrpcTensorCodingTest, Simple) {
 
 TEST_F(GrpcTensorCodingTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+TEST_F(GrpcTensorCodingTest, ReceiveLargeTensorsInPlace) {
+  DummyDevice cpu_device(Env::Default());
+  for (int64_t elems : {10, 10000}) {
+    Tensor t(DT_FLOAT, TensorShape({elems}));
+    test::FillIota<float>(&t, 1.0f);
+    ::grpc::ByteBuffer buf;
+    grpc::EncodeTensorToByteBuffer(false, t, false, &buf);
+
+    TensorResponse response;
+    response.InitAlloc(&cpu_device, AllocatorAttributes());
+    GrpcByteSource source(&buf);
+    TF_ASSERT_OK(response.ParseFrom(&source));
+    test::ExpectTensorEqual<float>(t, response.tensor());
+    // The contents of large tensors are sent in a slice that references the
+    // tensor, which is aligned, so that they are received in place too.
+    const bool in_place =
+        response.tensor().tensor_data().data() == t.tensor_data().data();
+    EXPECT_EQ(in_place, elems == 10000);
+  }
+
+  // Tensors that are copied to GPUs are not received in place.
+  Tensor t(DT_FLOAT, TensorShape({10000}));
+  test::FillIota<float>(&t, 1.0f);
+  ::grpc::ByteBuffer buf;
+  grpc::EncodeTensorToByteBuffer(false, t, false, &buf);
+  TensorResponse response;
+  AllocatorAttributes gpu_compatible;
+  gpu_compatible.set_gpu_compatible(true);
+  response.InitAlloc(&cpu_device, gpu_compatible);
+  GrpcByteSource source(&buf);
+  TF_ASSERT_OK(response.ParseFrom(&source));
+  test::ExpectTensorEqual<float>(t, response.tensor());
+  EXPECT_NE(response.tensor().tensor_data().data(), t.tensor_data().data());
+}
+
 }  // namespace tensorflow
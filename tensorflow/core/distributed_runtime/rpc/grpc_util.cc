@@ -14,13 +14,36 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
+
+#include <vector>
+
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/lib/random/random.h"
 
 namespace tensorflow {
 
 namespace {
 
+// A tensor buffer in a received gRPC slice, which it keeps alive.
+class GrpcSliceBuffer : public TensorBuffer {
+ public:
+  GrpcSliceBuffer(::grpc::Slice slice, char* data, size_t size)
+      : TensorBuffer(data), slice_(std::move(slice)), size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("grpc");
+  }
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const ::grpc::Slice slice_;
+  const size_t size_;
+};
+
 double GenerateUniformRandomNumber() {
   return random::New64() * (1.0 / std::numeric_limits<uint64>::max());
 }
@@ -33,6 +56,20 @@ double GenerateUniformRandomNumberBetween(double a, double b) {
 
 }  // namespace
 
+TensorBuffer* GrpcByteSource::ReferenceContents(const char* data, size_t n) {
+  // The slices are the ones that the stream reads, unless the ByteBuffer is
+  // compressed, in which case they are decompressed again and do not match.
+  std::vector<::grpc::Slice> slices;
+  if (!buffer_->Dump(&slices).ok()) return nullptr;
+  for (::grpc::Slice& slice : slices) {
+    const char* begin = reinterpret_cast<const char*>(slice.begin());
+    if (data >= begin && data + n <= begin + slice.size()) {
+      return new GrpcSliceBuffer(std::move(slice), const_cast<char*>(data), n);
+    }
+  }
+  return nullptr;
+}
+
 int64_t ComputeBackoffMicroseconds(int current_retry_attempt, int64_t min_delay,
                                    int64_t max_delay) {
   DCHECK_GE(current_retry_attempt, 0);
@@ -57,6 +57,10 @@ class GrpcByteSource : public TensorResponse::Source {
     return stream_;
   }
 
+  // Returns a buffer that holds a reference to the slice of the ByteBuffer
+  // that contains the bytes, unless the ByteBuffer is compressed.
+  TensorBuffer* ReferenceContents(const char* data, size_t n) override;
+
  private:
   void DeleteStream() {
     if (stream_) {
@@ -56,6 +56,7 @@ limitations under the License.
 #include "tensorflow/core/profiler/lib/scoped_memory_debug_annotation.h"
 #include "tensorflow/core/protobuf/transport_options.pb.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -148,6 +149,9 @@ class GrpcWorkerServiceThread {
     SETUP_FOR_REQUEST(RunGraph, 100, true);
     SETUP_FOR_REQUEST(CleanupGraph, 100, false);
     SETUP_FOR_REQUEST(MarkRecvFinished, 10, false);
+    SETUP_FOR_REQUEST(RecvTensors, 100, true);
+    SETUP_FOR_REQUEST(EmbeddingLookup, 100, false);
+    SETUP_FOR_REQUEST(EmbeddingUpdate, 100, false);
 
     // TODO(ncteisen): Determine a better policy for enqueuing the
     // appropriate number of each request type.
@@ -284,6 +288,53 @@ class GrpcWorkerServiceThread {
     EnqueueRecvTensorRequestRaw();
   }
 
+  void RecvTensorsHandler(
+      WorkerCall<RecvTensorsRequest, RecvTensorsResponse>* call) {
+    Schedule([this, call]() {
+      CallOptions* call_opts = new CallOptions;
+      call->SetCancelCallback([call_opts]() { call_opts->StartCancel(); });
+      worker_->RecvTensorsAsync(
+          call_opts, &call->request, &call->response,
+          [call, call_opts](const Status& s) {
+            call->ClearCancelCallback();
+            delete call_opts;
+            if (!s.ok()) {
+              VLOG(3) << "Bad response from RecvTensors:" << s;
+            }
+            call->SendResponse(ToGrpcStatus(s));
+          });
+    });
+    ENQUEUE_REQUEST(RecvTensors, true);
+  }
+
+  void EmbeddingLookupHandler(
+      WorkerCall<EmbeddingLookupRequest, EmbeddingLookupResponse>* call) {
+    Schedule([this, call]() {
+      worker_->EmbeddingLookupAsync(
+          &call->request, &call->response, [call](const Status& s) {
+            if (!s.ok()) {
+              VLOG(3) << "Bad response from EmbeddingLookup:" << s;
+            }
+            call->SendResponse(ToGrpcStatus(s));
+          });
+    });
+    ENQUEUE_REQUEST(EmbeddingLookup, false);
+  }
+
+  void EmbeddingUpdateHandler(
+      WorkerCall<EmbeddingUpdateRequest, EmbeddingUpdateResponse>* call) {
+    Schedule([this, call]() {
+      worker_->EmbeddingUpdateAsync(
+          &call->request, &call->response, [call](const Status& s) {
+            if (!s.ok()) {
+              VLOG(3) << "Bad response from EmbeddingUpdate:" << s;
+            }
+            call->SendResponse(ToGrpcStatus(s));
+          });
+    });
+    ENQUEUE_REQUEST(EmbeddingUpdate, false);
+  }
+
   void RecvBufHandler(WorkerCall<RecvBufRequest, RecvBufResponse>* call) {
     Schedule([this, call]() {
       CallOptions* call_opts = new CallOptions;
@@ -417,6 +468,47 @@ class GrpcWorkerService : public AsyncServiceInterface {
   TF_DISALLOW_COPY_AND_ASSIGN(GrpcWorkerService);
 };
 
+// Calls `done` with `val`, which `src_dev` sent with `send_args`, or with a
+// copy of it in host memory if it is in the memory of an accelerator, so that
+// it can be returned on the wire.
+void ReturnOnHost(
+    Device* src_dev, const Rendezvous::Args& send_args, const Tensor& val,
+    bool is_dead, const string& key,
+    std::function<void(const Tensor&, bool, const Status&)> done) {
+  // DMA can only be used for Tensors that do not fall into
+  // the following three odd edge cases: 1) a zero-size
+  // buffer, 2) a dead tensor which has an uninit value, and
+  // 3) the tensor has the on_host allocation attribute,
+  // i.e. it's in CPU RAM *independent of its assigned
+  // device type*.
+  const bool on_host = send_args.alloc_attrs.on_host();
+  if (src_dev->tensorflow_accelerator_device_info() && (!on_host)) {
+    // Non-DMA cases.
+    DeviceContext* send_dev_context = send_args.device_context;
+    AllocatorAttributes alloc_attrs;
+    alloc_attrs.set_gpu_compatible(true);
+    alloc_attrs.set_on_host(true);
+    Allocator* alloc = src_dev->GetAllocator(alloc_attrs);
+    Tensor* copy = new Tensor(alloc, val.dtype(), val.shape());
+    CHECK(send_dev_context)
+        << "send dev name: " << src_dev->name()
+        << " gpu_info: " << src_dev->tensorflow_accelerator_device_info();
+    // "val" is on an accelerator device. Uses the device_context to
+    // fill the copy on host.
+    StatusCallback copy_ready = [done = std::move(done), copy,
+                                 is_dead](const Status& s) {
+      // The value is now ready to be returned on the wire.
+      done(*copy, is_dead, s);
+      delete copy;
+    };
+
+    CopyDeviceToHost(&val, alloc, alloc, key, src_dev, copy, send_dev_context,
+                     copy_ready);
+    return;
+  }
+  done(val, is_dead, OkStatus());
+}
+
 }  // namespace
 
 GrpcWorker::GrpcWorker(WorkerEnv* worker_env, const ConfigProto& config)
@@ -432,7 +524,11 @@ GrpcWorker::GrpcWorker(WorkerEnv* worker_env, const ConfigProto& config)
 
 void GrpcWorker::EnableResponseCache() {
   VLOG(3) << "Enabling gRPC tensor response cache.";
-  response_cache_ = std::make_unique<GrpcResponseCache>();
+  // The cache only grows until the steps finish by default.
+  int64_t max_bytes;
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRPC_RESPONSE_CACHE_MAX_BYTES",
+                                  /*default_val=*/0, &max_bytes));
+  response_cache_ = std::make_unique<GrpcResponseCache>(max_bytes);
 }
 
 // GrpcRecvTensorAsync: unlike the other Worker methods, which use protocol
@@ -521,45 +617,144 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
           const bool is_dead) {
         opts->ClearCancelCallback();
         if (status.ok()) {
-          // DMA can only be used for Tensors that do not fall into
-          // the following three odd edge cases: 1) a zero-size
-          // buffer, 2) a dead tensor which has an uninit value, and
-          // 3) the tensor has the on_host allocation attribute,
-          // i.e. it's in CPU RAM *independent of its assigned
-          // device type*.
-          const bool on_host = send_args.alloc_attrs.on_host();
-          {
-            // Non-DMA cases.
-            if (src_dev->tensorflow_accelerator_device_info() && (!on_host)) {
-              DeviceContext* send_dev_context = send_args.device_context;
-              AllocatorAttributes alloc_attrs;
-              alloc_attrs.set_gpu_compatible(true);
-              alloc_attrs.set_on_host(true);
-              Allocator* alloc = src_dev->GetAllocator(alloc_attrs);
-              Tensor* copy = new Tensor(alloc, val.dtype(), val.shape());
-              CHECK(send_dev_context)
-                  << "send dev name: " << src_dev->name() << " gpu_info: "
-                  << src_dev->tensorflow_accelerator_device_info();
-              // "val" is on an accelerator device. Uses the device_context to
-              // fill the copy on host.
-              StatusCallback copy_ready = [rendezvous_done, copy,
-                                           is_dead](const Status& s) {
-                // The value is now ready to be returned on the wire.
-                rendezvous_done(*copy, is_dead, s);
-                delete copy;
-              };
-
-              CopyDeviceToHost(&val, alloc, alloc, request->rendezvous_key(),
-                               src_dev, copy, send_dev_context, copy_ready);
-              return;
-            }
-          }
+          ReturnOnHost(src_dev, send_args, val, is_dead,
+                       request->rendezvous_key(), rendezvous_done);
+          return;
         }
-
         rendezvous_done(val, is_dead, status);
       });
 }
 
+void GrpcWorker::RecvTensorsAsync(CallOptions* opts,
+                                  const RecvTensorsRequest* request,
+                                  RecvTensorsResponse* response,
+                                  StatusCallback done) {
+  if (request->request_size() == 0) {
+    done(OkStatus());
+    return;
+  }
+  const int64_t step_id = request->request(0).step_id();
+  for (const RecvTensorRequest& sub_request : request->request()) {
+    if (sub_request.step_id() != step_id) {
+      done(errors::InvalidArgument("RecvTensors requests steps ", step_id,
+                                   " and ", sub_request.step_id()));
+      return;
+    }
+    if (sub_request.request_id() == 0) {
+      done(errors::InvalidArgument("RecvTensors requires request ids"));
+      return;
+    }
+  }
+
+  struct Pending {
+    mutex mu;
+    // Whether all the tensors were requested, and the response was sent.
+    bool started TF_GUARDED_BY(mu) = false;
+    bool responded TF_GUARDED_BY(mu) = false;
+    Status status TF_GUARDED_BY(mu);
+    // The indices of the requests that are ready, with their tensors.
+    std::vector<int> ready TF_GUARDED_BY(mu);
+    std::vector<Tensor> tensors TF_GUARDED_BY(mu);
+    std::vector<bool> is_dead TF_GUARDED_BY(mu);
+  };
+  auto pending = std::make_shared<Pending>();
+  // Runs once, after `pending->responded` is set.
+  auto respond = [this, opts, request, response, pending, done]() {
+    opts->ClearCancelCallback();
+    Status s;
+    {
+      mutex_lock l(pending->mu);
+      s = pending->status;
+      for (size_t i = 0; s.ok() && i < pending->ready.size(); ++i) {
+        const int index = pending->ready[i];
+        recv_tensors_cache_.EraseRequestId(
+            request->request(index).request_id());
+        response->add_request_index(index);
+        RecvTensorResponse* sub_response = response->add_response();
+        sub_response->set_is_dead(pending->is_dead[i]);
+        sub_response->set_send_start_micros(env_->env->NowMicros());
+        pending->tensors[i].AsProtoTensorContent(
+            sub_response->mutable_tensor());
+      }
+    }
+    done(s);
+  };
+
+  opts->SetCancelCallback([this, step_id]() {
+    LOG(WARNING) << "RecvTensors cancelled for " << step_id;
+    AbortStep(step_id);
+  });
+  for (int index = 0; index < request->request_size(); ++index) {
+    auto tensor_ready = [pending, respond, index](const Tensor& tensor,
+                                                  bool is_dead,
+                                                  const Status& status) {
+      {
+        mutex_lock l(pending->mu);
+        // Responses that are already sent leave the tensor in the cache for
+        // the next request.
+        if (pending->responded) return;
+        if (status.ok()) {
+          pending->ready.push_back(index);
+          pending->tensors.push_back(tensor);
+          pending->is_dead.push_back(is_dead);
+        } else {
+          pending->status.Update(status);
+        }
+        if (!pending->started) return;
+        pending->responded = true;
+      }
+      respond();
+    };
+    const RecvTensorRequest& sub_request = request->request(index);
+    const int64_t request_id = sub_request.request_id();
+    if (recv_tensors_cache_.QueueRequest(request_id, step_id, tensor_ready)) {
+      continue;
+    }
+
+    auto rendezvous_done = [this, request_id](const Tensor& tensor,
+                                              bool is_dead,
+                                              const Status& status) {
+      recv_tensors_cache_.OnRequestFinished(request_id, tensor, is_dead,
+                                            status);
+    };
+    Status s = recent_request_ids_.TrackUnique(
+        request_id, "RecvTensors (GrpcWorker)", sub_request);
+    Rendezvous::ParsedKey parsed;
+    if (s.ok()) {
+      s = Rendezvous::ParseKey(sub_request.rendezvous_key(), &parsed);
+    }
+    Device* src_dev = nullptr;
+    if (s.ok()) {
+      s = PrepareRecvTensor(parsed, &src_dev);
+    }
+    if (!s.ok()) {
+      rendezvous_done(Tensor(), false, s);
+      continue;
+    }
+    env_->rendezvous_mgr->RecvLocalAsync(
+        step_id, parsed,
+        [rendezvous_done, src_dev, key = sub_request.rendezvous_key()](
+            const Status& status, const Rendezvous::Args& send_args,
+            const Rendezvous::Args& recv_args, const Tensor& val,
+            const bool is_dead) {
+          if (status.ok()) {
+            ReturnOnHost(src_dev, send_args, val, is_dead, key,
+                         rendezvous_done);
+            return;
+          }
+          rendezvous_done(val, is_dead, status);
+        });
+  }
+
+  {
+    mutex_lock l(pending->mu);
+    pending->started = true;
+    if (pending->ready.empty() && pending->status.ok()) return;
+    pending->responded = true;
+  }
+  respond();
+}
+
 namespace {
 // If RecvBufRespExtra.tensor_content is a single large string, then gRPC
 // can stall on the recv side when the string buffer needs to be enlarged,
@@ -741,6 +936,7 @@ void GrpcWorker::CleanupGraphAsync(const CleanupGraphRequest* request,
     // a worker crashes before acking a request.
     response_cache_->CleanEntriesForStep(request->step_id());
   }
+  recv_tensors_cache_.CleanEntriesForStep(request->step_id());
   Worker::CleanupGraphAsync(request, response, done);
 }
 
@@ -46,6 +46,13 @@ class GrpcWorker : public Worker {
                                    ::grpc::ByteBuffer* response,
                                    StatusCallback done);
 
+  // Responds with the requested tensors that are available, as soon as there
+  // is at least one of them, and keeps receiving the others for the next
+  // request for them.
+  void RecvTensorsAsync(CallOptions* opts, const RecvTensorsRequest* request,
+                        RecvTensorsResponse* response,
+                        StatusCallback done) override;
+
   void LoggingAsync(const LoggingRequest* request, LoggingResponse* response,
                     StatusCallback done) override;
 
@@ -64,6 +71,9 @@ class GrpcWorker : public Worker {
 
  private:
   std::unique_ptr<GrpcResponseCache> response_cache_;
+  // The tensors requested by RecvTensors, which are kept until a response
+  // delivers them.
+  GrpcResponseCache recv_tensors_cache_;
   const int32 recv_buf_max_chunk_;
 };
 
@@ -60,6 +60,12 @@ const char* GrpcWorkerMethodName(GrpcWorkerMethod id) {
       return "/tensorflow.WorkerService/GetStepSequence";
     case GrpcWorkerMethod::kMarkRecvFinished:
       return "/tensorflow.WorkerService/MarkRecvFinished";
+    case GrpcWorkerMethod::kRecvTensors:
+      return "/tensorflow.WorkerService/RecvTensors";
+    case GrpcWorkerMethod::kEmbeddingLookup:
+      return "/tensorflow.WorkerService/EmbeddingLookup";
+    case GrpcWorkerMethod::kEmbeddingUpdate:
+      return "/tensorflow.WorkerService/EmbeddingUpdate";
   }
   // Shouldn't be reached.
   LOG(FATAL) << "Invalid id: this line shouldn't be reached.";
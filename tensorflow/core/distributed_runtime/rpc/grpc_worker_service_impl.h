@@ -86,10 +86,13 @@ enum class GrpcWorkerMethod {
   kCompleteInstance,
   kGetStepSequence,
   kMarkRecvFinished,
+  kRecvTensors,
+  kEmbeddingLookup,
+  kEmbeddingUpdate,
 };
 
 static const int kGrpcNumWorkerMethods =
-    static_cast<int>(GrpcWorkerMethod::kMarkRecvFinished) + 1;
+    static_cast<int>(GrpcWorkerMethod::kEmbeddingUpdate) + 1;
 
 const char* GrpcWorkerMethodName(GrpcWorkerMethod id);
 
@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
 
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
@@ -31,15 +35,24 @@ limitations under the License.
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
 namespace {
 
+// Requests to the same worker are sent in RecvTensors requests of at most this
+// many tensors.
+constexpr size_t kMaxRecvTensorsBatchSize = 256;
+
+class RpcRecvTensorCall;
+
 class RpcRemoteRendezvous : public BaseRemoteRendezvous {
  public:
-  RpcRemoteRendezvous(const WorkerEnv* env, int64_t step_id)
-      : BaseRemoteRendezvous(env, step_id) {}
+  RpcRemoteRendezvous(const WorkerEnv* env, int64_t step_id,
+                      int64_t recv_tensors_batch_micros)
+      : BaseRemoteRendezvous(env, step_id),
+        recv_tensors_batch_micros_(recv_tensors_batch_micros) {}
 
  protected:
   void RecvFromRemoteAsync(const Rendezvous::ParsedKey& parsed,
@@ -49,6 +62,19 @@ class RpcRemoteRendezvous : public BaseRemoteRendezvous {
  private:
   ~RpcRemoteRendezvous() override {}
 
+  // Sends "call" in the next RecvTensors request to its worker, which is sent
+  // `recv_tensors_batch_micros_` after the first call that waits for it.
+  void EnqueueBatchedCall(RpcRecvTensorCall* call);
+
+  // Sends the calls that wait for a RecvTensors request to "src_worker".
+  void SendBatch(const string& src_worker);
+
+  const int64_t recv_tensors_batch_micros_;
+
+  mutex batch_mu_;
+  absl::flat_hash_map<string, std::vector<RpcRecvTensorCall*>> batches_
+      TF_GUARDED_BY(batch_mu_);
+
   TF_DISALLOW_COPY_AND_ASSIGN(RpcRemoteRendezvous);
 };
 
@@ -85,8 +111,11 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     {
       mutex_lock l(mu_);
       status_ = OkStatus();
+      batch_opts_ = nullptr;
     }
     done_ = nullptr;
+    batched_ = false;
+    recv_done_ = nullptr;
   }
 
   ~RpcRecvTensorCall() override {
@@ -102,11 +131,16 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
   }
 
   void StartAbort(const Status& s) override {
+    std::shared_ptr<CallOptions> batch_opts;
     {
       mutex_lock l(mu_);
       status_.Update(s);
+      batch_opts = batch_opts_;
     }
     opts_.StartCancel();
+    if (batch_opts != nullptr) {
+      batch_opts->StartCancel();
+    }
   }
 
   Status status() const override {
@@ -131,6 +165,7 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
 
  private:
   friend class RpcRemoteRendezvous;
+  friend class RpcRecvTensorsCall;
 
   // Start the main RecvTensor call, checking for an async abort.
   void StartRTCall(std::function<void()> recv_done) {
@@ -177,12 +212,129 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
   Rendezvous::Args recv_args_;
   Rendezvous::DoneCallback done_;
 
+  // Whether the request was sent in a RecvTensors request, so that it must be
+  // sent in one again until its tensor is received.
+  bool batched_ = false;
+  // Called when the tensor is received with RecvTensors.
+  std::function<void()> recv_done_;
+
   mutable mutex mu_;
   Status status_ TF_GUARDED_BY(mu_);
+  // Cancels the RecvTensors request that is receiving the tensor, if any.
+  std::shared_ptr<CallOptions> batch_opts_ TF_GUARDED_BY(mu_);
 
   TF_DISALLOW_COPY_AND_ASSIGN(RpcRecvTensorCall);
 };
 
+// Receives the tensors of several calls to the same worker with one
+// RecvTensors request. The worker responds as soon as some of the tensors are
+// available, so the calls whose tensors were not must be sent again.
+class RpcRecvTensorsCall {
+ public:
+  explicit RpcRecvTensorsCall(std::vector<RpcRecvTensorCall*> calls)
+      : calls_(std::move(calls)), opts_(std::make_shared<CallOptions>()) {}
+
+  // Called with the calls that must be sent again.
+  using PendingCallback = std::function<void(std::vector<RpcRecvTensorCall*>)>;
+
+  // Runs the `recv_done_` callback of the calls that received their tensor or
+  // failed, and passes the others to "done". Deletes this object.
+  void Start(PendingCallback done) {
+    for (RpcRecvTensorCall* call : calls_) {
+      call->batched_ = true;
+      *req_.add_request() = call->req_;
+      call->resp_.InitAlloc(call->dst_device_, call->alloc_attrs_);
+      mutex_lock l(call->mu_);
+      call->batch_opts_ = opts_;
+    }
+    auto abort_checked = std::make_shared<Notification>();
+    calls_[0]->wi_->RecvTensorsAsync(
+        opts_.get(), &req_, &resp_,
+        [this, abort_checked, done = std::move(done)](const Status& s) {
+          abort_checked->WaitForNotification();
+          Finish(s, done);
+          delete this;
+        });
+    // As in RpcRecvTensorCall::StartRTCall(), the calls may have been aborted
+    // before the request could be cancelled.
+    for (RpcRecvTensorCall* call : calls_) {
+      if (!call->status().ok()) {
+        opts_->StartCancel();
+        break;
+      }
+    }
+    abort_checked->Notify();
+  }
+
+ private:
+  void Finish(const Status& s, const PendingCallback& done) {
+    if (errors::IsUnimplemented(s)) {
+      // The worker does not support RecvTensors.
+      for (RpcRecvTensorCall* call : calls_) {
+        {
+          mutex_lock l(call->mu_);
+          call->batch_opts_ = nullptr;
+        }
+        call->batched_ = false;
+        call->Start(std::move(call->recv_done_));
+      }
+      return;
+    }
+
+    Status status = s;
+    std::vector<bool> received(calls_.size(), false);
+    if (status.ok() && resp_.request_index_size() != resp_.response_size()) {
+      status = errors::Internal("Invalid RecvTensors response");
+    }
+    for (int i = 0; status.ok() && i < resp_.response_size(); ++i) {
+      const int index = resp_.request_index(i);
+      if (index < 0 || index >= static_cast<int>(calls_.size()) ||
+          received[index]) {
+        status = errors::Internal("Invalid RecvTensors response index ", index);
+        break;
+      }
+      received[index] = true;
+      RpcRecvTensorCall* call = calls_[index];
+      Status parsed = call->resp_.InitFrom(resp_.mutable_response(i));
+      if (!parsed.ok()) {
+        mutex_lock l(call->mu_);
+        call->status_.Update(parsed);
+      }
+    }
+
+    std::vector<RpcRecvTensorCall*> finished;
+    std::vector<RpcRecvTensorCall*> pending;
+    for (size_t i = 0; i < calls_.size(); ++i) {
+      RpcRecvTensorCall* call = calls_[i];
+      bool failed;
+      {
+        mutex_lock l(call->mu_);
+        call->batch_opts_ = nullptr;
+        call->status_.Update(status);
+        failed = !call->status_.ok();
+      }
+      if (received[i] || failed) {
+        finished.push_back(call);
+      } else {
+        pending.push_back(call);
+      }
+    }
+    done(std::move(pending));
+    for (RpcRecvTensorCall* call : finished) {
+      // The callback releases "call".
+      std::function<void()> recv_done = std::move(call->recv_done_);
+      recv_done();
+    }
+  }
+
+  std::vector<RpcRecvTensorCall*> calls_;
+  std::shared_ptr<CallOptions> opts_;
+  RecvTensorsRequest req_;
+  RecvTensorsResponse resp_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(RpcRecvTensorsCall);
+};
+
 class RpcRecvTensorFreeList {
  public:
   RpcRecvTensorFreeList() {}
@@ -287,7 +439,7 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
 
   // Start "call".
   Ref();
-  call->Start([this, call, recv_args, worker_cache]() {
+  auto recv_done = [this, call, recv_args, worker_cache]() {
     // Removes "call" from calls_. Prevent StartAbort().
     DeregisterCall(call, recv_args);
     // If StartAbort was called prior to DeregisterCall, then the
@@ -300,17 +452,89 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
     call->done()(s, Args(), call->recv_args(), call->tensor(), call->is_dead());
     get_call_freelist()->Release(call);
     Unref();
-  });
+  };
+  if (recv_tensors_batch_micros_ > 0) {
+    call->recv_done_ = std::move(recv_done);
+    EnqueueBatchedCall(call);
+  } else {
+    call->Start(std::move(recv_done));
+  }
+}
+
+void RpcRemoteRendezvous::EnqueueBatchedCall(RpcRecvTensorCall* call) {
+  const string src_worker = call->src_worker_;
+  bool first;
+  bool full;
+  {
+    mutex_lock l(batch_mu_);
+    std::vector<RpcRecvTensorCall*>& batch = batches_[src_worker];
+    batch.push_back(call);
+    first = batch.size() == 1;
+    full = batch.size() >= kMaxRecvTensorsBatchSize;
+  }
+  if (full) {
+    // The timer of the batch then finds an empty or a newer batch, which it
+    // sends early.
+    SendBatch(src_worker);
+  } else if (first) {
+    Ref();
+    env_->env->SchedClosureAfter(recv_tensors_batch_micros_,
+                                 [this, src_worker]() {
+                                   SendBatch(src_worker);
+                                   Unref();
+                                 });
+  }
+}
+
+void RpcRemoteRendezvous::SendBatch(const string& src_worker) {
+  std::vector<RpcRecvTensorCall*> calls;
+  {
+    mutex_lock l(batch_mu_);
+    auto it = batches_.find(src_worker);
+    if (it == batches_.end()) return;
+    calls.swap(it->second);
+    batches_.erase(it);
+  }
+  if (calls.size() == 1 && !calls[0]->batched_) {
+    // A lone RecvTensor request costs the same, and receives large tensors
+    // without copying them.
+    calls[0]->Start(std::move(calls[0]->recv_done_));
+    return;
+  }
+  // The pending calls hold references to this rendezvous.
+  (new RpcRecvTensorsCall(std::move(calls)))
+      ->Start([this](std::vector<RpcRecvTensorCall*> pending) {
+        for (RpcRecvTensorCall* call : pending) {
+          EnqueueBatchedCall(call);
+        }
+      });
+}
+
+// Returns the batching window given by TF_RPC_RECV_TENSORS_BATCH_MICROS.
+int64_t RecvTensorsBatchMicros() {
+  static const int64_t batch_micros = []() {
+    int64_t micros;
+    TF_CHECK_OK(
+        ReadInt64FromEnvVar("TF_RPC_RECV_TENSORS_BATCH_MICROS", 0, &micros));
+    return micros;
+  }();
+  return batch_micros;
 }
 
 }  // namespace
 
 RpcRendezvousMgr::RpcRendezvousMgr(const WorkerEnv* env)
-    : BaseRendezvousMgr(env) {}
+    : RpcRendezvousMgr(env, RecvTensorsBatchMicros()) {}
+
+RpcRendezvousMgr::RpcRendezvousMgr(const WorkerEnv* env,
+                                   int64_t recv_tensors_batch_micros)
+    : BaseRendezvousMgr(env),
+      recv_tensors_batch_micros_(recv_tensors_batch_micros) {}
 
 BaseRemoteRendezvous* RpcRendezvousMgr::Create(int64_t step_id,
                                                const WorkerEnv* worker_env) {
-  return new RpcRemoteRendezvous(worker_env, step_id);
+  return new RpcRemoteRendezvous(worker_env, step_id,
+                                 recv_tensors_batch_micros_);
 }
 
 }  // end namespace tensorflow
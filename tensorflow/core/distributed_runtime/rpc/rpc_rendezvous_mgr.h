@@ -44,12 +44,23 @@ class DeviceMgr;
 // RendezvousMgr must have keys generated by Rendezvous::CreateKey.
 class RpcRendezvousMgr : public BaseRendezvousMgr {
  public:
+  // Batches the RecvTensor requests if the TF_RPC_RECV_TENSORS_BATCH_MICROS
+  // environment variable is set (see below).
   explicit RpcRendezvousMgr(const WorkerEnv* env);
 
+  // The requests for tensors from the same worker are sent together in one
+  // RecvTensors request if they are made within `recv_tensors_batch_micros`
+  // of the first one, which saves round trips when a step receives many small
+  // tensors, e.g. the variables of a parameter server. Every worker must then
+  // support the RecvTensors method. Zero disables the batching.
+  RpcRendezvousMgr(const WorkerEnv* env, int64_t recv_tensors_batch_micros);
+
  protected:
   BaseRemoteRendezvous* Create(int64_t step_id, const WorkerEnv* worker_env);
 
  private:
+  const int64_t recv_tensors_batch_micros_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(RpcRendezvousMgr);
 };
 
@@ -15,13 +15,17 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
 
+#include <atomic>
+
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/distributed_runtime/test_utils.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/control_flow.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
@@ -66,6 +70,27 @@ class DummyWorker : public TestWorkerInterface {
       done(OkStatus());
     });
   }
+
+  void RecvTensorsAsync(CallOptions* opts, const RecvTensorsRequest* request,
+                        RecvTensorsResponse* response,
+                        StatusCallback done) override {
+    ++num_recv_tensors_requests_;
+    SchedClosure([request, response, done = std::move(done)]() {
+      // Only the first half of the tensors are ready, so that the others are
+      // requested again. Each tensor holds its rendezvous key.
+      for (int i = 0; i < (request->request_size() + 1) / 2; ++i) {
+        response->add_request_index(i);
+        V(request->request(i).rendezvous_key())
+            .AsProtoTensorContent(response->add_response()->mutable_tensor());
+      }
+      done(OkStatus());
+    });
+  }
+
+  int num_recv_tensors_requests() const { return num_recv_tensors_requests_; }
+
+ private:
+  std::atomic<int> num_recv_tensors_requests_{0};
 };
 
 // Fake cache implementation for WorkerEnv.
@@ -95,6 +120,9 @@ class DummyWorkerCache : public WorkerCacheInterface {
   void GetDeviceLocalityAsync(const string& device, DeviceLocality* locality,
                               StatusCallback done) override {}
 
+ public:
+  DummyWorker* dummy_remote_worker() const { return dummy_remote_worker_; }
+
  private:
   DummyWorker* dummy_remote_worker_ = nullptr;
 };
@@ -104,7 +132,9 @@ static Device* CreateDevice(const char* type, const char* name) {
    public:
     explicit FakeDevice(const DeviceAttributes& attr) : Device(nullptr, attr) {}
     Status Sync() override { return OkStatus(); }
-    Allocator* GetAllocator(AllocatorAttributes) override { return nullptr; }
+    Allocator* GetAllocator(AllocatorAttributes) override {
+      return cpu_allocator();
+    }
   };
   DeviceAttributes attr;
   attr.set_name(name);
@@ -348,4 +378,48 @@ TEST_F(RpcRendezvousMgrTest, RemoteRecvAsyncMany) {
   rmgr_.Cleanup(step_id);
 }
 
+TEST_F(RpcRendezvousMgrTest, RemoteRecvBatched) {
+  const int64_t step_id = 123;
+  RpcRendezvousMgr rmgr(&env, /*recv_tensors_batch_micros=*/10000);
+  {
+    RemoteRendezvous* rendez = rmgr.Find(step_id);
+    TF_ASSERT_OK(rendez->Initialize(&worker_session_));
+    core::ScopedUnref unref(rendez);
+    Rendezvous::Args args;
+
+    const int num_requests = 100;
+    std::vector<string> keys(num_requests);
+    std::vector<string> values(num_requests);
+    mutex mu;
+    Status status = OkStatus();
+    BlockingCounter counter(num_requests);
+    for (int i = 0; i < num_requests; i++) {
+      keys[i] = Rendezvous::CreateKey("/job:worker/replica:1/task:2/cpu:0",
+                                      7890, "/job:mnist/replica:1/task:2/cpu:1",
+                                      strings::StrCat("foo", i),
+                                      FrameAndIter(0, 0));
+      rendez->RecvAsync(
+          MakeKey(keys[i]), args,
+          [&mu, &status, &values, &counter, i](
+              const Status& s, const Rendezvous::Args&,
+              const Rendezvous::Args&, const Tensor& val, const bool) {
+            {
+              mutex_lock l(mu);
+              status.Update(s);
+              if (s.ok()) values[i] = V(val);
+            }
+            counter.DecrementCount();
+          });
+    }
+    counter.Wait();
+    TF_ASSERT_OK(status);
+    EXPECT_EQ(keys, values);
+    // The first request receives half of the tensors, the second request a
+    // quarter of them, and so on.
+    EXPECT_LT(cache_->dummy_remote_worker()->num_recv_tensors_requests(),
+              num_requests / 4);
+  }
+  rmgr.Cleanup(step_id);
+}
+
 }  // namespace tensorflow
@@ -64,6 +64,15 @@ class TensorResponse {
     // Ownership of the returned stream is retained by the Source and
     // should not be deleted by the caller.
     virtual ::tensorflow::protobuf::io::ZeroCopyInputStream* contents() = 0;
+
+    // Returns a new reference to a buffer that holds the "n" bytes at "data"
+    // and keeps them alive, if they are in the data that the stream returned
+    // by the last call to contents() reads in place.  Otherwise returns
+    // nullptr, and the caller copies the bytes.  This lets large tensors be
+    // received without copying their contents.
+    virtual TensorBuffer* ReferenceContents(const char* data, size_t n) {
+      return nullptr;
+    }
   };
 
   // Parse the RecvTensorResponse encoded in the data yielded by
@@ -92,8 +101,15 @@ class TensorResponse {
   DeviceBase* device() const { return device_; }
 
  private:
-  bool ParseTensorSubmessage(protobuf::io::CodedInputStream* input,
+  bool ParseTensorSubmessage(Source* source,
+                             protobuf::io::CodedInputStream* input,
                              TensorProto* tensor_meta);
+  // Sets tensor_ to a tensor that references the "num_bytes" of tensor
+  // content at the current position of "input" in place, and skips them, if
+  // the source allows it.
+  bool ReferenceTensorContent(Source* source,
+                              protobuf::io::CodedInputStream* input,
+                              const TensorProto& tensor_meta, int num_bytes);
   bool ParseFast(Source* source);
   bool ParseSlow(Source* source);
 
@@ -31,7 +31,8 @@ limitations under the License.
 
 namespace tensorflow {
 
-Worker::Worker(WorkerEnv* env) : env_(env), recent_request_ids_(100000) {
+Worker::Worker(WorkerEnv* env)
+    : env_(env), recent_request_ids_(100000), embedding_service_(env) {
   // Enable log history collection in StatusGroup so that recent warning and
   // error log messages will be attached to the root error status to be
   // forwarded to the master.
@@ -461,6 +462,18 @@ void Worker::GetStepSequenceAsync(const GetStepSequenceRequest* request,
   }
 }
 
+void Worker::EmbeddingLookupAsync(const EmbeddingLookupRequest* request,
+                                  EmbeddingLookupResponse* response,
+                                  StatusCallback done) {
+  embedding_service_.LookupAsync(request, response, std::move(done));
+}
+
+void Worker::EmbeddingUpdateAsync(const EmbeddingUpdateRequest* request,
+                                  EmbeddingUpdateResponse* response,
+                                  StatusCallback done) {
+  embedding_service_.UpdateAsync(request, response, std::move(done));
+}
+
 // Helper for RecvTensor. Validates "key" and returns the source
 // device in "*src_dev".
 Status Worker::PrepareRecvTensor(const Rendezvous::ParsedKey& parsed,
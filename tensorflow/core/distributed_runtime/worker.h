@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <unordered_map>
 
+#include "tensorflow/core/distributed_runtime/embedding_service.h"
 #include "tensorflow/core/distributed_runtime/graph_mgr.h"
 #include "tensorflow/core/distributed_runtime/partial_run_mgr.h"
 #include "tensorflow/core/distributed_runtime/recent_request_ids.h"
@@ -108,6 +109,14 @@ class Worker : public WorkerInterface {
                             GetStepSequenceResponse* response,
                             StatusCallback done) override;
 
+  void EmbeddingLookupAsync(const EmbeddingLookupRequest* request,
+                            EmbeddingLookupResponse* response,
+                            StatusCallback done) override;
+
+  void EmbeddingUpdateAsync(const EmbeddingUpdateRequest* request,
+                            EmbeddingUpdateResponse* response,
+                            StatusCallback done) override;
+
  protected:
   WorkerEnv* const env_;  // Not owned.
   RecentRequestIds recent_request_ids_;
@@ -122,6 +131,8 @@ class Worker : public WorkerInterface {
 
   CancellationManager cancellation_manager_;
 
+  EmbeddingService embedding_service_;
+
   Status PrepareRunGraph(RunGraphRequestWrapper* req,
                          GraphMgr::NamedTensors* in,
                          GraphMgr::NamedTensors* out);
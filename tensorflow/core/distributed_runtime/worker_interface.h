@@ -20,6 +20,7 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/call_options.h"
 #include "tensorflow/core/distributed_runtime/message_wrappers.h"
+#include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/types.h"
@@ -106,6 +107,16 @@ class WorkerInterface {
                                TensorResponse* response,
                                StatusCallback done) = 0;
 
+  // Receives several small tensors in one round trip; see RecvTensorsRequest.
+  // Workers that do not support it fail with Unimplemented, and the tensors
+  // must then be received one at a time with RecvTensorAsync.
+  virtual void RecvTensorsAsync(CallOptions* opts,
+                                const RecvTensorsRequest* request,
+                                RecvTensorsResponse* response,
+                                StatusCallback done) {
+    done(errors::Unimplemented("RecvTensorsAsync"));
+  }
+
   virtual void LoggingAsync(const LoggingRequest* request,
                             LoggingResponse* response, StatusCallback done) = 0;
 
@@ -129,6 +140,21 @@ class WorkerInterface {
                                     GetStepSequenceResponse* response,
                                     StatusCallback done) = 0;
 
+  // Reads and updates rows of a resource variable of the worker without
+  // running a graph step; see EmbeddingLookupRequest and
+  // EmbeddingUpdateRequest.
+  virtual void EmbeddingLookupAsync(const EmbeddingLookupRequest* request,
+                                    EmbeddingLookupResponse* response,
+                                    StatusCallback done) {
+    done(errors::Unimplemented("EmbeddingLookupAsync"));
+  }
+
+  virtual void EmbeddingUpdateAsync(const EmbeddingUpdateRequest* request,
+                                    EmbeddingUpdateResponse* response,
+                                    StatusCallback done) {
+    done(errors::Unimplemented("EmbeddingUpdateAsync"));
+  }
+
   Status GetStatus(const GetStatusRequest* request,
                    GetStatusResponse* response) {
     Status ret;
@@ -16,8 +16,8 @@ limitations under the License.
 #include "tensorflow/core/framework/cancellation.h"
 
 #include <forward_list>
+#include <vector>
 
-#include "absl/memory/memory.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/status.h"
@@ -43,37 +43,45 @@ void CancellationManager::StartCancel() {
 }
 
 void CancellationManager::StartCancelWithStatus(const Status& status) {
-  gtl::FlatMap<CancellationToken, CallbackConfiguration> callbacks_to_run;
+  std::vector<CallbackConfiguration> callbacks_to_run;
   std::forward_list<CancellationManager*> children_to_cancel;
-  Notification* cancelled_notification = nullptr;
+  State* state;
   {
     mutex_lock l(mu_);
     if (is_cancelled_.load(std::memory_order_relaxed) || is_cancelling_) {
       return;
     }
     is_cancelling_ = true;
-    if (state_) {
-      std::swap(state_->callbacks, callbacks_to_run);
-
+    state = state_.load(std::memory_order_relaxed);
+    if (state) {
       // Remove all children from the list of children.
-      CancellationManager* child = state_->first_child;
+      CancellationManager* child = state->first_child;
       while (child != nullptr) {
         children_to_cancel.push_front(child);
         child->is_removed_from_parent_ = true;
         child = child->next_sibling_;
       }
-      state_->first_child = nullptr;
-
-      cancelled_notification = &state_->cancelled_notification;
+      state->first_child = nullptr;
+    }
+  }
+  if (state) {
+    // A state created from now on starts with closed shards, see
+    // GetOrCreateStateLocked().
+    for (CallbackShard& shard : state->callback_shards) {
+      mutex_lock l(shard.mu);
+      shard.closed = true;
+      for (auto& key_and_value : shard.callbacks) {
+        callbacks_to_run.push_back(std::move(key_and_value.second));
+      }
+      shard.callbacks.clear();
     }
   }
-  // We call these callbacks without holding mu_, so that concurrent
+  // We call these callbacks without holding any lock, so that concurrent
   // calls to DeregisterCallback, which can happen asynchronously, do
   // not block. The callbacks remain valid because any concurrent call
   // to DeregisterCallback will block until the
   // cancelled_notification_ is notified.
-  for (auto key_and_value : callbacks_to_run) {
-    CallbackConfiguration& config = key_and_value.second;
+  for (CallbackConfiguration& config : callbacks_to_run) {
     if (!status.ok() && config.log_error) {
       LOG(WARNING) << "Cancellation callback \"" << config.name
                    << "\" is triggered due to a "
@@ -85,10 +93,16 @@ void CancellationManager::StartCancelWithStatus(const Status& status) {
   for (CancellationManager* child : children_to_cancel) {
     child->StartCancelWithStatus(status);
   }
+  Notification* cancelled_notification = nullptr;
   {
     mutex_lock l(mu_);
     is_cancelling_ = false;
     is_cancelled_.store(true, std::memory_order_release);
+    // The state may have been created during the cancellation.
+    state = state_.load(std::memory_order_relaxed);
+    if (state) {
+      cancelled_notification = &state->cancelled_notification;
+    }
   }
   if (cancelled_notification) {
     cancelled_notification->Notify();
@@ -108,44 +122,69 @@ bool CancellationManager::RegisterCallbackWithErrorLogging(
       token, CallbackConfiguration{callback, std::string(callback_name), true});
 }
 
+CancellationManager::State* CancellationManager::GetOrCreateState() {
+  State* state = state_.load(std::memory_order_acquire);
+  if (TF_PREDICT_TRUE(state != nullptr)) {
+    return state;
+  }
+  mutex_lock l(mu_);
+  return GetOrCreateStateLocked();
+}
+
+CancellationManager::State* CancellationManager::GetOrCreateStateLocked() {
+  State* state = state_.load(std::memory_order_relaxed);
+  if (state == nullptr) {
+    state = new State;
+    if (is_cancelled_.load(std::memory_order_relaxed) || is_cancelling_) {
+      // StartCancel() has already looked for callbacks.
+      for (CallbackShard& shard : state->callback_shards) {
+        mutex_lock l(shard.mu);
+        shard.closed = true;
+      }
+    }
+    state_.store(state, std::memory_order_release);
+  }
+  return state;
+}
+
 bool CancellationManager::RegisterCallbackConfig(CancellationToken token,
                                                  CallbackConfiguration config) {
   DCHECK_LT(token, next_cancellation_token_) << "Invalid cancellation token";
-  mutex_lock l(mu_);
-  bool should_register = !is_cancelled_ && !is_cancelling_;
-  if (should_register) {
-    if (!state_) {
-      state_ = absl::make_unique<State>();
-    }
-    std::swap(state_->callbacks[token], config);
+  if (is_cancelled_.load(std::memory_order_acquire)) {
+    return false;
   }
-  return should_register;
+  CallbackShard& shard = GetCallbackShard(GetOrCreateState(), token);
+  mutex_lock l(shard.mu);
+  if (shard.closed) {
+    return false;
+  }
+  std::swap(shard.callbacks[token], config);
+  return true;
 }
 
 bool CancellationManager::DeregisterCallback(CancellationToken token) {
-  mu_.lock();
-  if (is_cancelled_) {
-    mu_.unlock();
-    return false;
-  } else if (is_cancelling_) {
-    Notification* cancelled_notification =
-        state_ ? &state_->cancelled_notification : nullptr;
-    mu_.unlock();
+  State* state = state_.load(std::memory_order_acquire);
+  if (state == nullptr) {
+    // No callback was ever registered.
+    mutex_lock l(mu_);
+    return !is_cancelled_.load(std::memory_order_relaxed) && !is_cancelling_;
+  }
+  CallbackShard& shard = GetCallbackShard(state, token);
+  {
+    mutex_lock l(shard.mu);
+    if (!shard.closed) {
+      shard.callbacks.erase(token);
+      return true;
+    }
+  }
+  if (!is_cancelled_.load(std::memory_order_acquire)) {
     // Wait for all of the cancellation callbacks to be called. This
     // wait ensures that the caller of DeregisterCallback does not
     // return immediately and free objects that may be used in the
     // execution of any currently pending callbacks in StartCancel.
-    if (cancelled_notification) {
-      cancelled_notification->WaitForNotification();
-    }
-    return false;
-  } else {
-    if (state_) {
-      state_->callbacks.erase(token);
-    }
-    mu_.unlock();
-    return true;
+    state->cancelled_notification.WaitForNotification();
   }
+  return false;
 }
 
 bool CancellationManager::RegisterChild(CancellationManager* child) {
@@ -155,13 +194,11 @@ bool CancellationManager::RegisterChild(CancellationManager* child) {
     return true;
   }
 
-  if (!state_) {
-    state_ = absl::make_unique<State>();
-  }
+  State* state = GetOrCreateStateLocked();
 
   // Push `child` onto the front of the list of children.
-  CancellationManager* current_head = state_->first_child;
-  state_->first_child = child;
+  CancellationManager* current_head = state->first_child;
+  state->first_child = child;
   child->prev_sibling_ = nullptr;
   child->next_sibling_ = current_head;
   if (current_head) {
@@ -176,14 +213,15 @@ void CancellationManager::DeregisterChild(CancellationManager* child) {
   Notification* cancelled_notification = nullptr;
   {
     mutex_lock l(mu_);
+    State* state = state_.load(std::memory_order_relaxed);
     if (!child->is_removed_from_parent_) {
       // Remove the child from this manager's list of children.
-      DCHECK(state_);
+      DCHECK(state);
 
       if (child->prev_sibling_ == nullptr) {
         // The child was at the head of the list.
-        DCHECK_EQ(state_->first_child, child);
-        state_->first_child = child->next_sibling_;
+        DCHECK_EQ(state->first_child, child);
+        state->first_child = child->next_sibling_;
       } else {
         child->prev_sibling_->next_sibling_ = child->next_sibling_;
       }
@@ -195,7 +233,7 @@ void CancellationManager::DeregisterChild(CancellationManager* child) {
       child->is_removed_from_parent_ = true;
     }
     if (is_cancelling_) {
-      cancelled_notification = &state_->cancelled_notification;
+      cancelled_notification = &state->cancelled_notification;
     }
   }
 
@@ -208,23 +246,29 @@ void CancellationManager::DeregisterChild(CancellationManager* child) {
 }
 
 bool CancellationManager::TryDeregisterCallback(CancellationToken token) {
-  mutex_lock lock(mu_);
-  if (is_cancelled_ || is_cancelling_) {
+  State* state = state_.load(std::memory_order_acquire);
+  if (state == nullptr) {
+    // No callback was ever registered.
+    mutex_lock l(mu_);
+    return !is_cancelled_.load(std::memory_order_relaxed) && !is_cancelling_;
+  }
+  CallbackShard& shard = GetCallbackShard(state, token);
+  mutex_lock l(shard.mu);
+  if (shard.closed) {
     return false;
-  } else {
-    if (state_) {
-      state_->callbacks.erase(token);
-    }
-    return true;
   }
+  shard.callbacks.erase(token);
+  return true;
 }
 
 CancellationManager::~CancellationManager() {
   if (parent_) {
     parent_->DeregisterChild(this);
   }
-  if (state_) {
+  State* state = state_.load(std::memory_order_acquire);
+  if (state) {
     StartCancel();
+    delete state;
   }
 }
 
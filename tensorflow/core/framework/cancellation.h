@@ -16,14 +16,17 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_CANCELLATION_H_
 #define TENSORFLOW_CORE_FRAMEWORK_CANCELLATION_H_
 
+#include <array>
 #include <atomic>
 #include <functional>
 
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/mutex_contention.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/stringpiece.h"
 #include "tensorflow/core/platform/thread_annotations.h"
@@ -168,9 +171,21 @@ class CancellationManager {
     bool log_error = false;
   };
 
+  // The callbacks are spread over shards by token, so that concurrent
+  // registrations and deregistrations seldom contend on the same lock.
+  static constexpr int kNumCallbackShards = 8;
+  struct alignas(64) CallbackShard {
+    mutex mu;
+    // Set once StartCancel() has taken the callbacks of the shard, after which
+    // no callback can be registered in it.
+    bool closed TF_GUARDED_BY(mu) = false;
+    absl::flat_hash_map<CancellationToken, CallbackConfiguration> callbacks
+        TF_GUARDED_BY(mu);
+  };
+
   struct State {
     Notification cancelled_notification;
-    gtl::FlatMap<CancellationToken, CallbackConfiguration> callbacks;
+    std::array<CallbackShard, kNumCallbackShards> callback_shards;
 
     // If this CancellationManager has any children, this member points to the
     // head of a doubly-linked list of its children.
@@ -180,6 +195,16 @@ class CancellationManager {
   bool RegisterCallbackConfig(CancellationToken token,
                               CallbackConfiguration config);
 
+  // Returns `state_`, creating it if needed.
+  State* GetOrCreateState();
+  State* GetOrCreateStateLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  static CallbackShard& GetCallbackShard(State* state,
+                                         CancellationToken token) {
+    return state->callback_shards[static_cast<uint64>(token) %
+                                  kNumCallbackShards];
+  }
+
   bool RegisterChild(CancellationManager* child);
   void DeregisterChild(CancellationManager* child);
 
@@ -203,7 +228,10 @@ class CancellationManager {
       nullptr;  // Not owned.
 
   mutex mu_;
-  std::unique_ptr<State> state_ TF_GUARDED_BY(mu_);
+  MutexContentionSite mu_site_{&mu_, "CancellationManager"};
+  // Owned. Created under `mu_` on first use and never changed afterwards, so
+  // that callbacks can be registered without acquiring `mu_`.
+  std::atomic<State*> state_{nullptr};
 };
 
 // Registers the given cancellation callback, returning a function that can be
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/framework/cancellation.h"
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <numeric>
 #include <random>
@@ -128,6 +129,36 @@ TEST(Cancellation, CancelMultiple) {
   EXPECT_FALSE(is_cancelled_3);
 }
 
+TEST(Cancellation, ConcurrentRegisterDeregisterAndCancel) {
+  auto manager = std::make_unique<CancellationManager>();
+  std::atomic<int> num_registered{0};
+  std::atomic<int> num_called{0};
+  std::atomic<int> num_deregistered{0};
+  {
+    thread::ThreadPool w(Env::Default(), "test", 8);
+    for (int t = 0; t < 8; ++t) {
+      w.Schedule([&]() {
+        for (int i = 0; i < 1000; ++i) {
+          CancellationToken token = manager->get_cancellation_token();
+          if (!manager->RegisterCallback(token, [&num_called]() {
+                num_called.fetch_add(1);
+              })) {
+            continue;
+          }
+          num_registered.fetch_add(1);
+          if (manager->DeregisterCallback(token)) {
+            num_deregistered.fetch_add(1);
+          }
+        }
+      });
+    }
+    w.Schedule([&manager]() { manager->StartCancel(); });
+  }
+  EXPECT_TRUE(manager->IsCancelled());
+  // Every registered callback is either deregistered or called, never both.
+  EXPECT_EQ(num_registered.load(), num_called.load() + num_deregistered.load());
+}
+
 TEST(Cancellation, IsCancelled) {
   auto cm = std::make_unique<CancellationManager>();
   thread::ThreadPool w(Env::Default(), "test", 4);
@@ -153,6 +153,11 @@ struct CollectiveParams : public core::RefCounted {
   std::vector<int> subdiv_rank;
   OpKernel* merge_op = nullptr;  // reduction only
   OpKernel* final_op = nullptr;  // reduction only
+  // If set, a reduction converts its input with encode_op, e.g. to a smaller
+  // floating point type to send less data, reduces the converted tensor with
+  // merge_op and final_op, and converts the result back with decode_op.
+  OpKernel* encode_op = nullptr;  // reduction only
+  OpKernel* decode_op = nullptr;  // reduction only
   string ToString() const;
   bool run_group_initialization = true;
 };
@@ -0,0 +1,167 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_FRAMEWORK_KERNEL_SHAPE_CACHE_H_
+#define TENSORFLOW_CORE_FRAMEWORK_KERNEL_SHAPE_CACHE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+// A small cache, meant to be a member of an OpKernel, of state that the kernel
+// derives from the shapes of its inputs, e.g. a BCast or a reshape plan.
+// Serving graphs run the same kernels on the same shapes over and over, and
+// on small tensors this setup is a large fraction of the kernel's time.
+//
+// The cache keeps the `capacity` most recently used entries. Its capacity
+// defaults to the value of the TF_KERNEL_SHAPE_CACHE_CAPACITY environment
+// variable, and it is disabled (it never stores anything) when the capacity
+// is 0, which is the default.
+//
+// Usage:
+//   KernelShapeCache<BCast>::Key key;
+//   key.AddShape(in0.shape());
+//   key.AddShape(in1.shape());
+//   std::shared_ptr<const BCast> bcast = cache_.Lookup(key);
+//   if (bcast == nullptr) {
+//     bcast = cache_.Insert(std::move(key), std::make_shared<BCast>(...));
+//   }
+//
+// This class is thread safe.
+template <typename T>
+class KernelShapeCache {
+ public:
+  // The inputs that the cached state is derived from, e.g. the input shapes
+  // and any small attribute or host-memory input values that it depends on.
+  class Key {
+   public:
+    void AddValue(int64_t value) {
+      values_.push_back(value);
+      hash_ = Hash64Combine(hash_, static_cast<uint64>(value));
+    }
+    void AddShape(const TensorShape& shape) {
+      AddValue(shape.dims());
+      for (int i = 0; i < shape.dims(); ++i) {
+        AddValue(shape.dim_size(i));
+      }
+    }
+
+    bool operator==(const Key& other) const {
+      return hash_ == other.hash_ && values_ == other.values_;
+    }
+
+   private:
+    gtl::InlinedVector<int64_t, 8> values_;
+    uint64 hash_ = 0;
+  };
+
+  KernelShapeCache() : KernelShapeCache(DefaultCapacity()) {}
+  explicit KernelShapeCache(int capacity) : capacity_(capacity) {
+    DCHECK_GE(capacity_, 0);
+  }
+
+  bool enabled() const { return capacity_ > 0; }
+
+  // Returns the value cached for `key`, or nullptr if there is none.
+  std::shared_ptr<const T> Lookup(const Key& key) const {
+    if (!enabled()) return nullptr;
+    tf_shared_lock l(mu_);
+    for (const auto& entry : entries_) {
+      if (entry->key == key) {
+        entry->last_use.store(clock_.fetch_add(1, std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+        return entry->value;
+      }
+    }
+    return nullptr;
+  }
+
+  // Caches `value` for `key`, evicting the least recently used entry if the
+  // cache is full, and returns the cached value. If another thread cached a
+  // value for `key` first, returns that value instead.
+  std::shared_ptr<const T> Insert(Key key, std::shared_ptr<const T> value) {
+    if (!enabled()) return value;
+    mutex_lock l(mu_);
+    Entry* victim = nullptr;
+    for (const auto& entry : entries_) {
+      if (entry->key == key) {
+        return entry->value;
+      }
+      if (victim == nullptr ||
+          entry->last_use.load(std::memory_order_relaxed) <
+              victim->last_use.load(std::memory_order_relaxed)) {
+        victim = entry.get();
+      }
+    }
+    if (entries_.size() < static_cast<size_t>(capacity_)) {
+      entries_.push_back(std::make_unique<Entry>());
+      victim = entries_.back().get();
+    }
+    victim->key = std::move(key);
+    victim->value = value;
+    victim->last_use.store(clock_.fetch_add(1, std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+    return value;
+  }
+
+  // Returns the number of cached entries.
+  int size() const {
+    tf_shared_lock l(mu_);
+    return entries_.size();
+  }
+
+  // Returns the capacity given by TF_KERNEL_SHAPE_CACHE_CAPACITY.
+  static int DefaultCapacity() {
+    static const int capacity = [] {
+      int64_t capacity;
+      TF_CHECK_OK(ReadInt64FromEnvVar("TF_KERNEL_SHAPE_CACHE_CAPACITY",
+                                      /*default_val=*/0, &capacity));
+      return static_cast<int>(std::max<int64_t>(capacity, 0));
+    }();
+    return capacity;
+  }
+
+ private:
+  struct Entry {
+    Key key;
+    std::shared_ptr<const T> value;
+    // The value of `clock_` when the entry was last used.
+    std::atomic<uint64> last_use{0};
+  };
+
+  const int capacity_;
+  mutable std::atomic<uint64> clock_{0};
+  mutable mutex mu_;
+  std::vector<std::unique_ptr<Entry>> entries_ TF_GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(KernelShapeCache);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_FRAMEWORK_KERNEL_SHAPE_CACHE_H_
@@ -0,0 +1,96 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/kernel_shape_cache.h"
+
+#include <memory>
+
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+using Cache = KernelShapeCache<int>;
+
+Cache::Key MakeKey(const TensorShape& a, const TensorShape& b) {
+  Cache::Key key;
+  key.AddShape(a);
+  key.AddShape(b);
+  return key;
+}
+
+TEST(KernelShapeCacheTest, LookupAfterInsert) {
+  Cache cache(2);
+  EXPECT_EQ(nullptr, cache.Lookup(MakeKey({2, 3}, {3})));
+  cache.Insert(MakeKey({2, 3}, {3}), std::make_shared<int>(1));
+  ASSERT_NE(nullptr, cache.Lookup(MakeKey({2, 3}, {3})));
+  EXPECT_EQ(1, *cache.Lookup(MakeKey({2, 3}, {3})));
+  // The same dimensions split differently between the shapes are a
+  // different key.
+  EXPECT_EQ(nullptr, cache.Lookup(MakeKey({2}, {3, 3})));
+  // An existing entry is not replaced.
+  EXPECT_EQ(1, *cache.Insert(MakeKey({2, 3}, {3}), std::make_shared<int>(2)));
+  EXPECT_EQ(1, cache.size());
+}
+
+TEST(KernelShapeCacheTest, EvictsLeastRecentlyUsed) {
+  Cache cache(2);
+  cache.Insert(MakeKey({1}, {1}), std::make_shared<int>(1));
+  cache.Insert(MakeKey({2}, {2}), std::make_shared<int>(2));
+  // Makes {2} the least recently used entry.
+  EXPECT_NE(nullptr, cache.Lookup(MakeKey({1}, {1})));
+  cache.Insert(MakeKey({3}, {3}), std::make_shared<int>(3));
+  EXPECT_EQ(2, cache.size());
+  EXPECT_NE(nullptr, cache.Lookup(MakeKey({1}, {1})));
+  EXPECT_EQ(nullptr, cache.Lookup(MakeKey({2}, {2})));
+  EXPECT_NE(nullptr, cache.Lookup(MakeKey({3}, {3})));
+}
+
+TEST(KernelShapeCacheTest, Disabled) {
+  Cache cache(0);
+  EXPECT_FALSE(cache.enabled());
+  // The value is still returned, but not cached.
+  EXPECT_EQ(1, *cache.Insert(MakeKey({1}, {1}), std::make_shared<int>(1)));
+  EXPECT_EQ(nullptr, cache.Lookup(MakeKey({1}, {1})));
+  EXPECT_EQ(0, cache.size());
+}
+
+TEST(KernelShapeCacheTest, Concurrent) {
+  Cache cache(4);
+  {
+    thread::ThreadPool pool(Env::Default(), "test", 8);
+    for (int t = 0; t < 8; ++t) {
+      pool.Schedule([&cache]() {
+        for (int i = 0; i < 1000; ++i) {
+          const int n = i % 6;
+          Cache::Key key;
+          key.AddValue(n);
+          std::shared_ptr<const int> value = cache.Lookup(key);
+          if (value == nullptr) {
+            value = cache.Insert(std::move(key), std::make_shared<int>(n));
+          }
+          EXPECT_EQ(n, *value);
+        }
+      });
+    }
+  }
+  EXPECT_EQ(4, cache.size());
+}
+
+}  // namespace
+}  // namespace tensorflow
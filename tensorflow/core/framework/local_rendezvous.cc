@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/framework/local_rendezvous.h"
 
+#include <utility>
+#include <vector>
+
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/errors.h"
@@ -354,6 +357,94 @@ void LocalRendezvous::RecvAsync(const Rendezvous::ParsedKey& key,
   }
 }
 
+void LocalRendezvous::RecvManyAsync(
+    absl::Span<const Rendezvous::ParsedKey> keys,
+    absl::Span<const Rendezvous::Args> recv_args,
+    Rendezvous::ManyDoneCallback done) {
+  DCHECK_EQ(keys.size(), recv_args.size());
+  if (keys.empty()) {
+    done(OkStatus(), {}, {}, {});
+    return;
+  }
+  auto* collector =
+      new internal::RecvManyCollector(keys.size(), std::move(done));
+  for (const Rendezvous::Args& args : recv_args) {
+    if (args.cancellation_manager != nullptr) {
+      // Cancellation callbacks are registered per key, so there is nothing to
+      // gain from batching.
+      for (int i = 0; i < keys.size(); ++i) {
+        RecvAsync(keys[i], recv_args[i], collector->Callback(i));
+      }
+      return;
+    }
+  }
+
+  std::vector<uint64> key_hashes(keys.size());
+  for (int i = 0; i < keys.size(); ++i) {
+    key_hashes[i] = KeyHash(keys[i].FullKey());
+  }
+  // The messages that have already arrived, with the index of their key.
+  std::vector<std::pair<int, Item*>> sent_items;
+
+  mu_.lock();
+  if (!status_.ok()) {
+    // Rendezvous has been aborted.
+    Status s = status_;
+    mu_.unlock();
+    for (int i = 0; i < keys.size(); ++i) {
+      collector->Done(i, s, Rendezvous::Args(), Tensor(), false);
+    }
+    return;
+  }
+
+  for (int i = 0; i < keys.size(); ++i) {
+    ItemQueue* queue = &table_[key_hashes[i]];
+    if (queue->head == nullptr || queue->head->type == Item::kRecv) {
+      DVLOG(2) << "Enqueue Recv Item (key:" << keys[i].FullKey() << "). ";
+      queue->push_back(new Item(recv_args[i], collector->Callback(i),
+                                CancellationManager::kInvalidToken));
+      continue;
+    }
+    DVLOG(2) << "Consume Send Item (key:" << keys[i].FullKey() << "). ";
+    Item* item = queue->head;
+    if (item->next == nullptr) {
+      table_.erase(key_hashes[i]);
+    } else {
+      queue->head = item->next;
+    }
+    sent_items.emplace_back(i, item);
+  }
+
+  if (sent_items.empty()) {
+    // The senders will complete `collector`.
+    mu_.unlock();
+    return;
+  }
+
+  // See Send() for why the owner must stay alive while callbacks run.
+  core::RefCountPtr<const Rendezvous> rc_owner_ref;
+  if (rc_owner_) {
+    rc_owner_ref.reset(rc_owner_);
+    rc_owner_->Ref();
+  }
+  pending_callback_counter_++;
+  mu_.unlock();
+  for (const auto& p : sent_items) {
+    Item* item = p.second;
+    DCHECK_EQ(item->type, Item::kSend);
+    collector->Done(p.first, OkStatus(), item->args, *item->send_state.value,
+                    item->send_state.is_dead);
+    delete item;
+  }
+  {
+    mutex_lock l(mu_);
+    pending_callback_counter_--;
+    if (pending_callback_counter_ == 0) {
+      pending_callback_cond_var_.notify_all();
+    }
+  }
+}
+
 void LocalRendezvous::StartAbort(const Status& status) {
   CHECK(!status.ok());
   Table table;
@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/mutex_contention.h"
 #include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
@@ -49,6 +50,11 @@ class LocalRendezvous {
   void RecvAsync(const Rendezvous::ParsedKey& key,
                  const Rendezvous::Args& recv_args,
                  Rendezvous::DoneCallback done);
+  // Registers all the keys under a single acquisition of the lock, and
+  // invokes `done` once all of them have been received.
+  void RecvManyAsync(absl::Span<const Rendezvous::ParsedKey> keys,
+                     absl::Span<const Rendezvous::Args> recv_args,
+                     Rendezvous::ManyDoneCallback done);
   void StartAbort(const Status& status);
   Status status();
 
@@ -73,6 +79,7 @@ class LocalRendezvous {
 
   // TODO(zhifengc): shard table_.
   mutex mu_;
+  MutexContentionSite mu_site_{&mu_, "LocalRendezvous"};
   Table table_ TF_GUARDED_BY(mu_);
   Status status_ TF_GUARDED_BY(mu_);
   // Track the number of pening callbacks using a counter.
@@ -65,6 +65,31 @@ auto* graph_unused_outputs = monitoring::Counter<1>::New(
     "/tensorflow/core/graph_unused_outputs",
     "The number of unused outputs for ops of a given type.", "name");
 
+auto* executor_cache_events = monitoring::Counter<1>::New(
+    "/tensorflow/core/direct_session_executor_cache_events",
+    "The number of hits, misses and evictions in the cache of executors that "
+    "DirectSession keeps per feed/fetch/target signature.",
+    "event");
+
+auto* tensor_list_copies = monitoring::Counter<1>::New(
+    "/tensorflow/core/tensor_list_copies",
+    "The number of times an op that updates a TensorList copied it, because "
+    "its input could not be updated in place.",
+    "op");
+
+auto* tensor_list_copied_elements = monitoring::Counter<1>::New(
+    "/tensorflow/core/tensor_list_copied_elements",
+    "The number of elements of the TensorLists copied by ops that update "
+    "them, because their input could not be updated in place.",
+    "op");
+
+auto* host_to_device_copy_bytes = monitoring::Counter<1>::New(
+    "/tensorflow/core/host_to_device_copy_bytes",
+    "The number of bytes copied from host tensors to devices, by kind of host "
+    "buffer the DMA was issued from: the tensor itself if it is in pinned "
+    "memory, a pinned staging buffer, or pageable memory.",
+    "source");
+
 auto* tf_data_autotune_counter = monitoring::Counter<1>::New(
     "/tensorflow/data/autotune", "tf.data autotuning", "name");
 
@@ -511,6 +536,40 @@ void RecordUnusedOutput(const string& op_name) {
   graph_unused_outputs->GetCell(op_name)->IncrementBy(1);
 }
 
+void RecordExecutorCacheLookup(bool hit) {
+  static auto* hit_cell = executor_cache_events->GetCell("hit");
+  static auto* miss_cell = executor_cache_events->GetCell("miss");
+  (hit ? hit_cell : miss_cell)->IncrementBy(1);
+}
+
+void RecordExecutorCacheEviction() {
+  static auto* eviction_cell = executor_cache_events->GetCell("eviction");
+  eviction_cell->IncrementBy(1);
+}
+
+void RecordHostToDeviceCopy(HostToDeviceCopySource source,
+                            int64_t num_bytes) {
+  static auto* pinned_cell = host_to_device_copy_bytes->GetCell("pinned");
+  static auto* staged_cell = host_to_device_copy_bytes->GetCell("staged");
+  static auto* pageable_cell = host_to_device_copy_bytes->GetCell("pageable");
+  switch (source) {
+    case HostToDeviceCopySource::kPinned:
+      pinned_cell->IncrementBy(num_bytes);
+      break;
+    case HostToDeviceCopySource::kStaged:
+      staged_cell->IncrementBy(num_bytes);
+      break;
+    case HostToDeviceCopySource::kPageable:
+      pageable_cell->IncrementBy(num_bytes);
+      break;
+  }
+}
+
+void RecordTensorListCopy(const string& op_name, int64_t num_elements) {
+  tensor_list_copies->GetCell(op_name)->IncrementBy(1);
+  tensor_list_copied_elements->GetCell(op_name)->IncrementBy(num_elements);
+}
+
 void IncrementTestCounter(const string& name, const string& label) {
   test_counters->GetCell(name, label)->IncrementBy(1);
 }
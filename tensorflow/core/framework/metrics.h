@@ -177,6 +177,32 @@ void UpdateGraphPendingQueueLength(uint64 len);
 // Records that one output of an op of type `op_name` was unused.
 void RecordUnusedOutput(const string& op_name);
 
+// Records the outcome of looking up the executors for a feed/fetch/target
+// signature in the cache of a DirectSession.
+void RecordExecutorCacheLookup(bool hit);
+
+// Records that a DirectSession evicted the executors for a signature from its
+// cache.
+void RecordExecutorCacheEviction();
+
+// The host buffer that a host-to-device copy was issued from.
+enum class HostToDeviceCopySource {
+  // The host tensor itself, which is in pinned memory (or memory of unknown
+  // type, which the driver stages if needed).
+  kPinned,
+  // A pinned buffer that the pageable host tensor was staged into.
+  kStaged,
+  // The pageable host tensor itself.
+  kPageable,
+};
+
+// Records the number of bytes copied from a host tensor to a device.
+void RecordHostToDeviceCopy(HostToDeviceCopySource source, int64_t num_bytes);
+
+// Records that an op of type `op_name` copied a TensorList of `num_elements`
+// elements instead of updating it in place.
+void RecordTensorListCopy(const string& op_name, int64_t num_elements);
+
 // Updates the metrics stored about time spent building graphs.
 //
 // By "GraphBuild", we refer to building a client graph, which is a sub-graph of
@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 #include <cmath>
 #include <memory>
+#include <numeric>
 #include <queue>
 
 #include "absl/time/clock.h"
@@ -28,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/platform/host_info.h"
 #include "tensorflow/core/platform/mem.h"
 #include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -191,6 +193,83 @@ void RecordAutotuneRamUsage(int64 ram_budget, double max_buffered_bytes) {
       max_buffered_bytes / static_cast<double>(ram_budget));
 }
 
+// Returns the free memory below which autotuning reduces its RAM budget, as
+// given by the TF_DATA_AUTOTUNE_MIN_FREE_RAM_MB environment variable. Returns
+// 0, which disables the reduction, if the variable is not set.
+int64_t MinFreeRamBytes() {
+  static const int64_t min_free_bytes = [] {
+    int64_t min_free_mb;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_DATA_AUTOTUNE_MIN_FREE_RAM_MB",
+                                    /*default_val=*/0, &min_free_mb));
+    return std::max<int64_t>(0, min_free_mb) * 1024 * 1024;
+  }();
+  return min_free_bytes;
+}
+
+// Whether the models that autotune at the same time share the CPU budget
+// instead of each using all of it, as given by the
+// TF_DATA_AUTOTUNE_SHARE_CPU_BUDGET environment variable.
+bool ShareCpuBudget() {
+  static const bool share_cpu_budget = [] {
+    bool share_cpu_budget;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_DATA_AUTOTUNE_SHARE_CPU_BUDGET",
+                                   /*default_val=*/false, &share_cpu_budget));
+    return share_cpu_budget;
+  }();
+  return share_cpu_budget;
+}
+
+// The models of the process that are running their optimization loop, and the
+// total parallelism that each of them asked for in its last optimization.
+class CpuBudgetShares {
+ public:
+  static CpuBudgetShares* Get() {
+    static CpuBudgetShares* shares = new CpuBudgetShares();
+    return shares;
+  }
+
+  // Until it asks for less, a model asks for the whole CPU budget.
+  void Register(const Model* model, int64_t cpu_budget) {
+    mutex_lock l(mu_);
+    demands_[model] = cpu_budget;
+  }
+
+  void Unregister(const Model* model) {
+    mutex_lock l(mu_);
+    demands_.erase(model);
+  }
+
+  // Records the total parallelism that `model` asked for. Does nothing if the
+  // model is not registered.
+  void SetDemand(const Model* model, int64_t demand) {
+    mutex_lock l(mu_);
+    auto it = demands_.find(model);
+    if (it != demands_.end()) {
+      it->second = demand;
+    }
+  }
+
+  // Returns the share of `cpu_budget` of `model`.
+  int64_t Share(const Model* model, int64_t cpu_budget) {
+    mutex_lock l(mu_);
+    std::vector<int64_t> demands;
+    demands.reserve(demands_.size());
+    size_t index = demands_.size();
+    for (const auto& [other, demand] : demands_) {
+      if (other == model) {
+        index = demands.size();
+      }
+      demands.push_back(demand);
+    }
+    if (index == demands.size()) return cpu_budget;
+    return FairShareCpuBudgets(cpu_budget, demands)[index];
+  }
+
+ private:
+  mutex mu_;
+  absl::flat_hash_map<const Model*, int64_t> demands_ TF_GUARDED_BY(mu_);
+};
+
 // Helper function for node traversal that doesn't skip any nodes.
 inline bool IsAnyNode(const std::shared_ptr<Node> node) { return true; }
 
@@ -1834,6 +1913,25 @@ void Node::CollectBufferParametersToUpsize(
   }
 }
 
+void Node::CollectBufferParameters(
+    absl::flat_hash_map<Node*, Parameter*>& node_parameters) {
+  {
+    tf_shared_lock l(mu_);
+    for (auto& [node_name, parameter] : parameters_) {
+      if ((parameter->name != kBufferSize) ||
+          (parameter->state == nullptr || !parameter->state->tunable)) {
+        continue;
+      }
+      node_parameters[this] = parameter.get();
+    }
+  }
+  for (auto& [node, parameter] : node_parameters) {
+    if (node != this) continue;
+    tf_shared_lock l(*parameter->state->mu);
+    parameter->value = parameter->state->value;
+  }
+}
+
 Node::NodeVector Node::CollectNodesLocked(
     TraversalOrder order, bool collect_node(const std::shared_ptr<Node>)) const
     TF_SHARED_LOCKS_REQUIRED(mu_) {
@@ -2146,6 +2244,38 @@ void Model::FlushMetrics() {
   }
 }
 
+int64_t MemoryPressureRamBudget(int64_t ram_budget, double buffered_bytes,
+                                int64_t free_bytes, int64_t min_free_bytes) {
+  if (free_bytes >= min_free_bytes) {
+    return ram_budget;
+  }
+  const double reduced_ram_budget =
+      std::max(0.0, buffered_bytes + static_cast<double>(free_bytes) -
+                        static_cast<double>(min_free_bytes));
+  return std::min(ram_budget, static_cast<int64_t>(reduced_ram_budget));
+}
+
+std::vector<int64_t> FairShareCpuBudgets(int64_t cpu_budget,
+                                         const std::vector<int64_t>& demands) {
+  std::vector<size_t> order(demands.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&demands](size_t a, size_t b) { return demands[a] < demands[b]; });
+  std::vector<int64_t> shares(demands.size());
+  int64_t remaining = cpu_budget;
+  for (size_t i = 0; i < order.size(); ++i) {
+    // The pipelines that ask for less than an equal share of what is left
+    // leave the rest to the pipelines that ask for more.
+    const int64_t equal_share =
+        remaining / static_cast<int64_t>(order.size() - i);
+    const int64_t share =
+        std::max<int64_t>(1, std::min(demands[order[i]], equal_share));
+    shares[order[i]] = share;
+    remaining = std::max<int64_t>(0, remaining - share);
+  }
+  return shares;
+}
+
 void Model::Optimize(AutotuneAlgorithm algorithm, int64_t cpu_budget,
                      int64_t ram_budget, double model_input_time,
                      CancellationManager* cancellation_manager) {
@@ -2157,6 +2287,18 @@ void Model::Optimize(AutotuneAlgorithm algorithm, int64_t cpu_budget,
   if (!port::JobName().empty()) {
     RecordAutotuneRamUsage(ram_budget, TotalMaximumBufferedBytes(snapshot));
   }
+  const int64_t min_free_bytes = MinFreeRamBytes();
+  if (ram_budget > 0 && min_free_bytes > 0) {
+    const int64_t reduced_ram_budget =
+        MemoryPressureRamBudget(ram_budget, TotalBufferedBytes(snapshot),
+                                port::GetMemoryInfo().free, min_free_bytes);
+    if (reduced_ram_budget < ram_budget) {
+      VLOG(2) << "Free memory is low, reducing the autotune RAM budget from "
+              << ram_budget << " to " << reduced_ram_budget << " bytes.";
+      ram_budget = reduced_ram_budget;
+      ShrinkBuffers(snapshot, ram_budget);
+    }
+  }
   OptimizationParams optimization_params;
   optimization_params.set_algorithm(algorithm);
   optimization_params.set_cpu_budget(cpu_budget);
@@ -2228,6 +2370,20 @@ absl::flat_hash_map<Node*, Parameter*> Model::CollectBufferParametersToUpsize(
   return node_parameters;
 }
 
+absl::flat_hash_map<Node*, Parameter*> Model::CollectBufferParameters(
+    std::shared_ptr<Node> snapshot) {
+  Node::NodeVector nodes =
+      snapshot->CollectNodes(TraversalOrder::BFS, IsAsyncNode);
+  absl::flat_hash_map<Node*, Parameter*> node_parameters;
+  if (snapshot->IsAsync()) {
+    snapshot->CollectBufferParameters(node_parameters);
+  }
+  for (auto& node : nodes) {
+    node->CollectBufferParameters(node_parameters);
+  }
+  return node_parameters;
+}
+
 bool Model::ShouldStop(int64_t cpu_budget, int64_t ram_budget,
                        const Model::ModelParameters& parameters,
                        const Model::ModelParameters& parallelism_parameters,
@@ -2265,6 +2421,16 @@ Status Model::OptimizeLoop(AutotuneAlgorithm algorithm, int64_t cpu_budget,
       },
       /*deregister_fn=*/&unused));
 
+  const bool share_cpu_budget = ShareCpuBudget();
+  if (share_cpu_budget) {
+    CpuBudgetShares::Get()->Register(this, cpu_budget);
+  }
+  auto unregister = gtl::MakeCleanup([this, share_cpu_budget]() {
+    if (share_cpu_budget) {
+      CpuBudgetShares::Get()->Unregister(this);
+    }
+  });
+
   int64_t last_optimization_ms = 0;
   int64_t current_time_ms = EnvTime::NowMicros() / EnvTime::kMillisToMicros;
   while (true) {
@@ -2292,7 +2458,13 @@ Status Model::OptimizeLoop(AutotuneAlgorithm algorithm, int64_t cpu_budget,
     if (algorithm == AutotuneAlgorithm::STAGE_BASED) {
       model_input_time = ComputeTargetTimeNsec();
     }
-    Optimize(algorithm, cpu_budget, ram_budget, model_input_time,
+    int64_t optimization_cpu_budget = cpu_budget;
+    if (share_cpu_budget) {
+      optimization_cpu_budget = CpuBudgetShares::Get()->Share(this, cpu_budget);
+      VLOG(2) << "Optimizing with a CPU budget share of "
+              << optimization_cpu_budget << " out of " << cpu_budget << ".";
+    }
+    Optimize(algorithm, optimization_cpu_budget, ram_budget, model_input_time,
              cancellation_manager);
     int64_t end_ms = EnvTime::NowMicros() / EnvTime::kMillisToMicros;
     VLOG(2) << "Optimized for " << end_ms - start_ms << " ms.";
@@ -2374,6 +2546,9 @@ void Model::OptimizeGradientDescent(
   for (auto& pair : parameters) {
     pair.second->value = std::round(pair.second->value);
   }
+  if (ShareCpuBudget()) {
+    LimitParallelism(optimization_params.cpu_budget(), &parameters);
+  }
   UpdateStateValues(&parameters);
 }
 
@@ -2448,6 +2623,9 @@ void Model::OptimizeHillClimbHelper(
     }
     best_parameter->value++;
   }
+  if (ShareCpuBudget()) {
+    LimitParallelism(optimization_params.cpu_budget(), &parameters);
+  }
   UpdateStateValues(&parameters);
 }
 void Model::RecordIteratorGapTime(uint64_t duration_usec) {
@@ -2482,6 +2660,103 @@ double Model::ComputeTargetTimeNsec() {
          1.0e3;
 }
 
+PipelineReport Model::ComputePipelineReport() {
+  PipelineReport report;
+  std::shared_ptr<Node> snapshot;
+  {
+    tf_shared_lock l(mu_);
+    if (!output_) return report;
+    snapshot = output_->Snapshot();
+  }
+  ModelTiming model_timing(snapshot);
+  NodeParallelismParameters node_parallelism;
+  for (const auto& root : model_timing.GetStageRoots()) {
+    const ModelTiming::NodeTiming* root_timing =
+        model_timing.GetTiming(root.get());
+    if (root_timing == nullptr || root->num_elements() <= 0) continue;
+    PipelineReport::Stage stage;
+    stage.root = root->long_name();
+    stage.total_time_nsec =
+        root_timing->total_time_nsec * root_timing->pipeline_ratio;
+    stage.root_self_time_nsec =
+        root_timing->self_time_nsec * root_timing->pipeline_ratio;
+    for (const auto& node : model_timing.GetStageNodes(root)) {
+      const ModelTiming::NodeTiming* timing =
+          model_timing.GetTiming(node.get());
+      if (timing == nullptr) continue;
+      const double time_nsec = timing->self_time_nsec * timing->pipeline_ratio;
+      if (stage.slowest_node.empty() ||
+          time_nsec > stage.slowest_node_time_nsec) {
+        stage.slowest_node = node->long_name();
+        stage.slowest_node_time_nsec = time_nsec;
+      }
+    }
+    const Parameter* parallelism = node_parallelism.Get(root.get());
+    if (parallelism != nullptr) {
+      stage.parallelism = parallelism->value;
+      stage.max_parallelism = parallelism->max;
+    }
+    const StatusOr<double> buffer_size = root->ParameterValue(kBufferSize);
+    if (buffer_size.ok() && buffer_size.ValueOrDie() > 0) {
+      stage.buffer_utilization =
+          static_cast<double>(root->buffered_elements()) /
+          buffer_size.ValueOrDie();
+    }
+    report.stages.push_back(std::move(stage));
+  }
+  if (report.stages.empty()) return report;
+  std::stable_sort(
+      report.stages.begin(), report.stages.end(),
+      [](const PipelineReport::Stage& a, const PipelineReport::Stage& b) {
+        return a.total_time_nsec > b.total_time_nsec;
+      });
+
+  const PipelineReport::Stage& bottleneck = report.stages.front();
+  if (bottleneck.max_parallelism <= 0) {
+    report.suggestion = strings::StrCat(
+        "The stage that ends with ", bottleneck.root,
+        " is not parallel. Consider a parallel version of its slowest node, ",
+        bottleneck.slowest_node,
+        ", e.g. with `num_parallel_calls`, or moving work out of it.");
+  } else if (bottleneck.parallelism < bottleneck.max_parallelism) {
+    report.suggestion = strings::StrCat(
+        "Increase the parallelism of ", bottleneck.root, " from ",
+        bottleneck.parallelism, " towards its maximum of ",
+        bottleneck.max_parallelism, ", e.g. by increasing the CPU budget.");
+  } else {
+    report.suggestion = strings::StrCat(
+        bottleneck.root, " runs at its maximum parallelism of ",
+        bottleneck.max_parallelism, ". Reduce the work per element of ",
+        bottleneck.slowest_node, ", or move it out of the input pipeline.");
+  }
+  return report;
+}
+
+std::string PipelineReport::DebugString() const {
+  if (stages.empty()) return "The pipeline has not produced elements yet.";
+  std::string result = strings::StrCat(
+      "Bottleneck: ", stages.front().root, ". ", suggestion, "\n",
+      "Stages, slowest first, with their time per output element:");
+  for (const Stage& stage : stages) {
+    strings::StrAppend(
+        &result, "\n  ", stage.root, ": ", stage.total_time_nsec / 1.0e3,
+        " us total, ", stage.root_self_time_nsec / 1.0e3, " us computing, ",
+        (stage.total_time_nsec - stage.root_self_time_nsec) / 1.0e3,
+        " us waiting on input; slowest node ", stage.slowest_node, " (",
+        stage.slowest_node_time_nsec / 1.0e3, " us)");
+    if (stage.max_parallelism > 0) {
+      strings::StrAppend(&result, "; parallelism ", stage.parallelism, "/",
+                         stage.max_parallelism);
+    }
+    if (stage.buffer_utilization >= 0) {
+      strings::StrAppend(&result, "; buffer ",
+                         static_cast<int>(100 * stage.buffer_utilization),
+                         "% full");
+    }
+  }
+  return result;
+}
+
 void Model::OptimizeStageBased(std::shared_ptr<Node> snapshot,
                                const OptimizationParams& optimization_params,
                                CancellationManager* cancellation_manager) {
@@ -2607,6 +2882,82 @@ void Model::UpsizeBuffers(std::shared_ptr<Node> snapshot, int64_t ram_budget) {
   }
 }
 
+void Model::ShrinkBuffers(std::shared_ptr<Node> snapshot, int64_t ram_budget) {
+  const double excess_bytes =
+      TotalMaximumBufferedBytes(snapshot) - static_cast<double>(ram_budget);
+  if (excess_bytes <= 0) {
+    return;
+  }
+  absl::flat_hash_map<Node*, Parameter*> node_parameters =
+      CollectBufferParameters(snapshot);
+
+  // Compute memory used by all buffers that can be shrunk.
+  double max_buffered_bytes = 0;
+  for (auto& [node, parameter] : node_parameters) {
+    if (node->buffered_elements() == 0) {
+      continue;
+    }
+    max_buffered_bytes += static_cast<double>(node->buffered_bytes()) /
+                          static_cast<double>(node->buffered_elements()) *
+                          parameter->value;
+  }
+  if (max_buffered_bytes <= 0) {
+    return;
+  }
+
+  // Scale all buffers down by the same factor, which frees `excess_bytes` if
+  // the buffers hold enough of them.
+  const double scaling_factor =
+      std::max(0.0, 1.0 - excess_bytes / max_buffered_bytes);
+  for (auto& [node, parameter] : node_parameters) {
+    double old_value = parameter->value;
+    // Scale the new buffer_size value. Use the min value if it is smaller.
+    parameter->value = std::max(
+        std::max(1.0, parameter->min),
+        static_cast<double>(static_cast<int64_t>(old_value * scaling_factor)));
+    parameter->value = std::min(old_value, parameter->value);
+    if (parameter->value == old_value) {
+      continue;
+    }
+    VLOG(2) << "Shrink buffer " << node->long_name() << "::" << parameter->name
+            << " from " << old_value << " to " << parameter->value;
+    {
+      mutex_lock l(*parameter->state->mu);
+      parameter->state->value = parameter->value;
+      parameter->state->cond_var->notify_all();
+    }
+    node->ResetBufferWatermarks();
+  }
+}
+
+void Model::LimitParallelism(int64_t cpu_budget, ModelParameters* parameters) {
+  int64_t total_parallelism = 0;
+  for (const auto& pair : *parameters) {
+    if (pair.second->name == kParallelism) {
+      total_parallelism += std::round(pair.second->value);
+    }
+  }
+  CpuBudgetShares::Get()->SetDemand(this, total_parallelism);
+  if (total_parallelism <= cpu_budget) {
+    return;
+  }
+  const double scaling_factor =
+      static_cast<double>(cpu_budget) / static_cast<double>(total_parallelism);
+  for (auto& pair : *parameters) {
+    auto& parameter = pair.second;
+    if (parameter->name != kParallelism) {
+      continue;
+    }
+    parameter->value = std::max(
+        std::max(1.0, parameter->min),
+        static_cast<double>(static_cast<int64_t>(parameter->value *
+                                                 scaling_factor)));
+    VLOG(2) << "Limiting " << pair.first << "::" << parameter->name << " to "
+            << parameter->value << " to fit the CPU budget share of "
+            << cpu_budget << ".";
+  }
+}
+
 void Model::OptimizeHillClimb(std::shared_ptr<Node> snapshot,
                               const OptimizationParams& optimization_params,
                               CancellationManager* cancellation_manager) {
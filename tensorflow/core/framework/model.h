@@ -480,6 +480,10 @@ class Node {
   void CollectBufferParametersToUpsize(
       absl::flat_hash_map<Node*, Parameter*>& node_parameters);
 
+  // Collects the tunable buffer parameters of this node.
+  void CollectBufferParameters(
+      absl::flat_hash_map<Node*, Parameter*>& node_parameters);
+
  protected:
   // Used for (incrementally) recording metrics. The class is thread-safe.
   class Metrics {
@@ -744,6 +748,58 @@ std::shared_ptr<Node> MakeAsyncUnknownRatioNode(
 // as pass-through between inputs and output.
 std::shared_ptr<Node> MakeUnknownNode(Node::Args args);
 
+// Returns the part of `ram_budget` that autotuning may use when the pipeline
+// buffers `buffered_bytes` and `free_bytes` of memory are free. Once the free
+// memory falls below `min_free_bytes`, the budget is reduced to the bytes that
+// are buffered now plus the free memory above `min_free_bytes`, so that the
+// buffers stop growing, and shrink as the free memory keeps falling.
+int64_t MemoryPressureRamBudget(int64_t ram_budget, double buffered_bytes,
+                                int64_t free_bytes, int64_t min_free_bytes);
+
+// Splits `cpu_budget` between the input pipelines of a process that autotune at
+// the same time, given the total parallelism that each of them would use on
+// its own, `demands`. The split is max-min fair: the pipelines that ask for
+// less than an equal share get what they ask for, and the others split the
+// rest equally. Every pipeline gets at least 1.
+std::vector<int64_t> FairShareCpuBudgets(int64_t cpu_budget,
+                                         const std::vector<int64_t>& demands);
+
+// Summarizes where an input pipeline spends its time, to find its bottleneck.
+// Like for the `STAGE_BASED` algorithm, the pipeline is split in stages that
+// end at asynchronous nodes, which run concurrently with their consumers. The
+// pipeline produces elements at the rate of its slowest stage.
+struct PipelineReport {
+  struct Stage {
+    // The `long_name()` of the node that the stage ends with.
+    std::string root;
+    // The time the stage takes to produce the elements needed for one element
+    // of the pipeline's output.
+    double total_time_nsec = 0.0;
+    // The part of `total_time_nsec` that the root spends computing. The rest
+    // is spent waiting on its synchronous inputs.
+    double root_self_time_nsec = 0.0;
+    // The node of the stage that takes the most time, and its part of
+    // `total_time_nsec`.
+    std::string slowest_node;
+    double slowest_node_time_nsec = 0.0;
+    // The tunable parallelism of the root, or 0 if it has none.
+    double parallelism = 0.0;
+    double max_parallelism = 0.0;
+    // The fraction of the root's buffer that is full, or -1 if the root has
+    // no buffer. A buffer that stays full means that its consumers are slower
+    // than the stage.
+    double buffer_utilization = -1.0;
+  };
+
+  // The stages, slowest first, i.e. the bottleneck is `stages[0]`.
+  std::vector<Stage> stages;
+  // A suggestion of how to speed up the bottleneck, if there is one.
+  std::string suggestion;
+
+  // Returns a human-readable, multi-line representation of the report.
+  std::string DebugString() const;
+};
+
 // Abstract representation of a TensorFlow input pipeline that can be used
 // for collecting runtime information and optimizing performance. It collects
 // runtime information about execution of the input pipeline that is used to
@@ -807,6 +863,11 @@ class Model {
   // respecting the ram budget.
   void OptimizeBuffers(std::shared_ptr<Node> snapshot, int64_t ram_budget);
 
+  // Scales down the tunable buffers in the pipeline rooted at `snapshot` so
+  // that the estimated maximum number of buffered bytes fits in `ram_budget`,
+  // e.g. after the budget was reduced because free memory is running low.
+  void ShrinkBuffers(std::shared_ptr<Node> snapshot, int64_t ram_budget);
+
   // Collects the output time and if `gradients` is not `nullptr`, the output
   // time gradient w.r.t. tunable parameters of the subtree rooted in the given
   // node.
@@ -840,6 +901,11 @@ class Model {
   // algorithm.
   double ComputeTargetTimeNsec();
 
+  // Returns a report of where the pipeline spends its time, computed from a
+  // snapshot of the model. The report has no stages if the model has no
+  // output node or no node has produced an element yet.
+  PipelineReport ComputePipelineReport();
+
  private:
   // Determines whether optimization should stop given total processing time,
   // estimated output time, and estimated number of buffers bytes.
@@ -866,6 +932,16 @@ class Model {
   absl::flat_hash_map<Node*, Parameter*> CollectBufferParametersToUpsize(
       std::shared_ptr<Node> snapshot);
 
+  // Collects the tunable buffer parameters of all nodes in the model.
+  absl::flat_hash_map<Node*, Parameter*> CollectBufferParameters(
+      std::shared_ptr<Node> snapshot);
+
+  // Scales down the parallelism `parameters` so that their total fits in
+  // `cpu_budget`, which is this model's share of the CPU budget of the process
+  // when it is shared between models, and records the total before scaling as
+  // the demand of this model for that share.
+  void LimitParallelism(int64_t cpu_budget, ModelParameters* parameters);
+
   // Flushes metrics recorded by the model.
   void FlushMetrics() TF_LOCKS_EXCLUDED(mu_);
 
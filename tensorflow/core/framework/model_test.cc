@@ -2195,6 +2195,102 @@ TEST_F(BufferSizeTest, OptimizeBuffers_TightMemory) {
   EXPECT_DOUBLE_EQ(7.0, node_4->parameter_value(kBufferSize));
 }
 
+TEST_F(BufferSizeTest, ShrinkBuffers) {
+  ReadModel(R"pb(
+    nodes: {
+      key: 1
+      value: {
+        id: 1
+        name: "Prefetch"
+        autotune: true
+        bytes_produced: 10000
+        num_elements: 100
+        processing_time: 2000
+        node_class: ASYNC_KNOWN_RATIO
+        inputs: 2
+        ratio: 1
+        parameters: {
+          name: "buffer_size"
+          value: 10
+          state_value: 10
+          min: 1
+          max: 10
+          tunable: true
+        }
+      }
+    }
+    nodes: {
+      key: 2
+      value: {
+        id: 2
+        name: "Prefetch"
+        autotune: true
+        bytes_produced: 10000
+        num_elements: 100
+        processing_time: 2000
+        node_class: ASYNC_KNOWN_RATIO
+        ratio: 1
+        parameters: {
+          name: "buffer_size"
+          value: 10
+          state_value: 10
+          min: 4
+          max: 10
+          tunable: true
+        }
+      }
+    }
+    output: 1
+  )pb");
+
+  std::shared_ptr<Node> node_1 = GetNode(1);
+  std::shared_ptr<Node> node_2 = GetNode(2);
+  node_1->record_buffer_event(500, 5);
+  node_2->record_buffer_event(500, 5);
+  // Each buffer may hold 10 elements of 100 bytes.
+  EXPECT_DOUBLE_EQ(2000.0, node_1->TotalMaximumBufferedBytes());
+
+  // The budget is not exceeded, so the buffers are not changed.
+  model_->ShrinkBuffers(node_1, 2000);
+  EXPECT_DOUBLE_EQ(10.0, node_1->parameter_value(kBufferSize));
+  EXPECT_DOUBLE_EQ(10.0, node_2->parameter_value(kBufferSize));
+
+  model_->ShrinkBuffers(node_1, 1000);
+  EXPECT_DOUBLE_EQ(5.0, node_1->parameter_value(kBufferSize));
+  EXPECT_DOUBLE_EQ(5.0, node_2->parameter_value(kBufferSize));
+
+  // Buffers are not shrunk below their min value.
+  model_->ShrinkBuffers(node_1, 0);
+  EXPECT_DOUBLE_EQ(1.0, node_1->parameter_value(kBufferSize));
+  EXPECT_DOUBLE_EQ(4.0, node_2->parameter_value(kBufferSize));
+}
+
+TEST(MemoryPressureRamBudgetTest, ReducesBudgetWhenFreeMemoryIsLow) {
+  // Enough free memory.
+  EXPECT_EQ(1000, MemoryPressureRamBudget(1000, 500, 300, 100));
+  EXPECT_EQ(1000, MemoryPressureRamBudget(1000, 500, 100, 100));
+  // The buffers may keep the bytes that are buffered now, less the missing
+  // free memory.
+  EXPECT_EQ(450, MemoryPressureRamBudget(1000, 500, 50, 100));
+  EXPECT_EQ(0, MemoryPressureRamBudget(1000, 500, 0, 1000));
+  // The budget is never increased.
+  EXPECT_EQ(200, MemoryPressureRamBudget(200, 500, 50, 100));
+}
+
+TEST(FairShareCpuBudgetsTest, SplitsBudgetMaxMinFairly) {
+  EXPECT_EQ(std::vector<int64_t>({}), FairShareCpuBudgets(8, {}));
+  EXPECT_EQ(std::vector<int64_t>({8}), FairShareCpuBudgets(8, {16}));
+  EXPECT_EQ(std::vector<int64_t>({3}), FairShareCpuBudgets(8, {3}));
+  // Pipelines that ask for more than an equal share split the budget.
+  EXPECT_EQ(std::vector<int64_t>({4, 4}), FairShareCpuBudgets(8, {16, 8}));
+  // What a pipeline does not ask for goes to the others.
+  EXPECT_EQ(std::vector<int64_t>({5, 1, 2}), FairShareCpuBudgets(8, {8, 1, 2}));
+  EXPECT_EQ(std::vector<int64_t>({3, 3, 2}), FairShareCpuBudgets(8, {8, 8, 2}));
+  // Every pipeline gets at least 1.
+  EXPECT_EQ(std::vector<int64_t>({1, 1, 1}), FairShareCpuBudgets(2, {4, 4, 4}));
+  EXPECT_EQ(std::vector<int64_t>({1, 7}), FairShareCpuBudgets(8, {0, 8}));
+}
+
 TEST_F(ModelTimingTest, OptimizeStageBased_OneStage) {
   BuildModelFromProto(R"pb(
     nodes: {
@@ -2545,6 +2641,86 @@ TEST_F(ModelTimingTest, ComputeTargetTime_TestWindow) {
   EXPECT_DOUBLE_EQ(10.0, model_->ComputeTargetTimeNsec() * 1e-3);
 }
 
+TEST_F(ModelTimingTest, ComputePipelineReport) {
+  BuildModelFromProto(R"pb(
+    nodes: {
+      key: 1
+      value: {
+        id: 1
+        name: "ParallelMapV2"
+        autotune: true
+        num_elements: 100
+        processing_time: 25000
+        bytes_produced: 10000
+        node_class: ASYNC_KNOWN_RATIO
+        ratio: 1
+        inputs: 2
+        parameters: {
+          name: "parallelism"
+          value: 4
+          min: 1
+          max: 16
+          tunable: true
+        }
+      }
+    }
+    nodes: {
+      key: 2
+      value: {
+        id: 2
+        name: "ParallelMapV2"
+        autotune: true
+        num_elements: 100
+        processing_time: 20000
+        bytes_produced: 10000
+        node_class: ASYNC_KNOWN_RATIO
+        ratio: 1
+        inputs: 3
+        parameters: {
+          name: "parallelism"
+          value: 16
+          min: 1
+          max: 16
+          tunable: true
+        }
+      }
+    }
+    nodes: {
+      key: 3
+      value: {
+        id: 3
+        name: "SSTable"
+        autotune: true
+        num_elements: 100
+        processing_time: 10000
+        node_class: KNOWN_RATIO
+        ratio: 1
+      }
+    }
+    output: 1
+  )pb");
+
+  PipelineReport report = model_->ComputePipelineReport();
+  ASSERT_EQ(report.stages.size(), 2);
+  // The second stage takes 200 / 16 nsec in node 2 and 100 nsec in node 3 per
+  // element, and the first stage takes 250 / 4 nsec in node 1.
+  const PipelineReport::Stage& bottleneck = report.stages[0];
+  EXPECT_EQ(bottleneck.root, GetNode(/*node_id=*/2)->long_name());
+  EXPECT_DOUBLE_EQ(bottleneck.total_time_nsec, 112.5);
+  EXPECT_DOUBLE_EQ(bottleneck.root_self_time_nsec, 12.5);
+  EXPECT_EQ(bottleneck.slowest_node, GetNode(/*node_id=*/3)->long_name());
+  EXPECT_DOUBLE_EQ(bottleneck.slowest_node_time_nsec, 100);
+  EXPECT_DOUBLE_EQ(bottleneck.parallelism, 16);
+  EXPECT_DOUBLE_EQ(bottleneck.max_parallelism, 16);
+  EXPECT_EQ(report.stages[1].root, GetNode(/*node_id=*/1)->long_name());
+  EXPECT_DOUBLE_EQ(report.stages[1].total_time_nsec, 62.5);
+  // Node 2 cannot be more parallel, so the suggestion is about node 3.
+  EXPECT_THAT(report.suggestion,
+              ::testing::HasSubstr("maximum parallelism of 16"));
+  EXPECT_THAT(report.suggestion,
+              ::testing::HasSubstr(GetNode(/*node_id=*/3)->long_name()));
+}
+
 TEST_F(ModelTimingTest, SelfTime) {
   BuildModelFromProto(R"pb(
     nodes: {
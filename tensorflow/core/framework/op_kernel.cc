@@ -57,6 +57,7 @@ limitations under the License.
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/profiler/lib/scoped_memory_debug_annotation.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/ptr_util.h"
 
 namespace tensorflow {
@@ -378,6 +379,8 @@ Allocator* OpKernelContext::get_allocator(AllocatorAttributes attr) {
   if (TF_PREDICT_FALSE(attr.scope_id > 0)) {
     allocator = params_->device->GetScopedAllocator(attr, step_id());
     CHECK(allocator);
+  } else if (params_->step_allocator != nullptr && attr.value == 0) {
+    allocator = params_->step_allocator;
   } else {
     allocator = params_->device->GetAllocator(attr);
   }
@@ -716,10 +719,37 @@ Status OpKernelContext::allocate_output(StringPiece name,
   return allocate_output(start, shape, tensor, attr);
 }
 
+namespace {
+
+// Returns true if tiny host tensors allocated by kernels should store their
+// data inline in their buffer (see `Tensor::HostInline()`).
+bool InlineSmallHostTensors() {
+  static const bool inline_small_host_tensors = [] {
+    bool value;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_INLINE_SMALL_HOST_TENSORS",
+                                   /*default_val=*/false, &value));
+    return value;
+  }();
+  return inline_small_host_tensors;
+}
+
+}  // namespace
+
 Status OpKernelContext::allocate_tensor(
     DataType type, const TensorShape& shape, Tensor* out_tensor,
     AllocatorAttributes attr, const AllocationAttributes& allocation_attr) {
   Allocator* a = get_allocator(attr);
+  // Tiny host tensors, such as loop counters, predicates and shapes, can skip
+  // the allocator, unless their allocations must be accounted or freed in a
+  // particular way.
+  if (TF_PREDICT_FALSE(InlineSmallHostTensors()) && attr.scope_id == 0 &&
+      shape.num_elements() > 0 && Tensor::CanUseHostInline(type, shape) &&
+      a->GetMemoryType() == AllocatorMemoryType::kHostPageable &&
+      !track_allocations() && !params_->log_memory &&
+      allocation_attr.freed_by_func == nullptr) {
+    *out_tensor = Tensor::HostInline(type, shape);
+    return OkStatus();
+  }
   Tensor new_tensor(
       a, type, shape,
       AllocationAttributes(
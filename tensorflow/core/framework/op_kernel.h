@@ -606,6 +606,11 @@ class OpKernelContext {
     bool track_allocations = false;
     bool log_memory = false;
 
+    // If not nullptr, serves the allocations that this op kernel invocation
+    // makes with default allocator attributes, in place of the device's
+    // allocator. Set by executors that scope host allocations to the step.
+    Allocator* step_allocator = nullptr;
+
     // Array indexed by output number for this node
     const AllocatorAttributes* output_attr_array = nullptr;
 
@@ -149,6 +149,77 @@ Status RendezvousInterface::Recv(const ParsedKey& key, const Args& args,
   return Recv(key, args, val, is_dead, no_timeout);
 }
 
+void RendezvousInterface::RecvManyAsync(absl::Span<const ParsedKey> keys,
+                                        absl::Span<const Args> args,
+                                        ManyDoneCallback done) {
+  DCHECK_EQ(keys.size(), args.size());
+  if (keys.empty()) {
+    done(OkStatus(), {}, {}, {});
+    return;
+  }
+  auto* collector =
+      new internal::RecvManyCollector(keys.size(), std::move(done));
+  for (int i = 0; i < keys.size(); ++i) {
+    RecvAsync(keys[i], args[i], collector->Callback(i));
+  }
+}
+
+namespace internal {
+
+RecvManyCollector::RecvManyCollector(
+    int num_keys, RendezvousInterface::ManyDoneCallback done)
+    : done_(std::move(done)),
+      send_args_(num_keys),
+      vals_(num_keys),
+      is_dead_(new bool[num_keys]()),
+      num_pending_(num_keys) {}
+
+RecvManyCollector::~RecvManyCollector() {
+  for (const RendezvousInterface::Args& args : send_args_) {
+    if (args.device_context) {
+      args.device_context->Unref();
+    }
+  }
+}
+
+void RecvManyCollector::Done(int index, const Status& status,
+                             const RendezvousInterface::Args& send_args,
+                             const Tensor& val, bool is_dead) {
+  if (!status.ok()) {
+    mutex_lock l(mu_);
+    status_.Update(status);
+  }
+  // The sender's device context is only guaranteed to be live while the
+  // per-key callback runs.
+  if (send_args.device_context) {
+    send_args.device_context->Ref();
+  }
+  send_args_[index] = send_args;
+  vals_[index] = val;
+  is_dead_[index] = is_dead;
+  if (num_pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    Status s;
+    {
+      mutex_lock l(mu_);
+      s = status_;
+    }
+    done_(s, send_args_, vals_,
+          std::vector<bool>(is_dead_.get(), is_dead_.get() + vals_.size()));
+    delete this;
+  }
+}
+
+RendezvousInterface::DoneCallback RecvManyCollector::Callback(int index) {
+  return [this, index](const Status& status,
+                       const RendezvousInterface::Args& send_args,
+                       const RendezvousInterface::Args& recv_args,
+                       const Tensor& val, const bool is_dead) {
+    Done(index, status, send_args, val, is_dead);
+  };
+}
+
+}  // namespace internal
+
 namespace {
 class LocalRendezvousWrapper : public Rendezvous {
  public:
@@ -164,6 +235,12 @@ class LocalRendezvousWrapper : public Rendezvous {
     impl_.RecvAsync(key, recv_args, std::move(done));
   }
 
+  void RecvManyAsync(absl::Span<const ParsedKey> keys,
+                     absl::Span<const Args> recv_args,
+                     ManyDoneCallback done) override {
+    impl_.RecvManyAsync(keys, recv_args, std::move(done));
+  }
+
   void StartAbort(const Status& status) override { impl_.StartAbort(status); }
 
  private:
@@ -16,14 +16,20 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_RENDEZVOUS_H_
 #define TENSORFLOW_CORE_FRAMEWORK_RENDEZVOUS_H_
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "absl/types/span.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/control_flow.h"
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/refcount.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/util/device_name_utils.h"
 
 namespace tensorflow {
@@ -104,6 +110,25 @@ class RendezvousInterface {
   virtual void RecvAsync(const ParsedKey& key, const Args& args,
                          DoneCallback done) = 0;
 
+  // Callback provided by a consumer waiting on several tensors at once. It is
+  // invoked once, after every tensor is available or has failed, with the
+  // first non-OK status if any. The vectors have one entry per key, in the
+  // order of the keys.
+  typedef std::function<void(const Status&, const std::vector<Args>&,
+                             const std::vector<Tensor>&,
+                             const std::vector<bool>&)>
+      ManyDoneCallback;
+
+  // Receives the tensors of all the "keys", using "args[i]" for "keys[i]".
+  //
+  // The default implementation calls RecvAsync() for every key.
+  // Implementations may instead register all the keys at once, which saves
+  // the per-key overhead when many tensors cross the same boundary, e.g. the
+  // outputs of a partition.
+  virtual void RecvManyAsync(absl::Span<const ParsedKey> keys,
+                             absl::Span<const Args> args,
+                             ManyDoneCallback done);
+
   // Synchronous wrapper for RecvAsync.
   Status Recv(const ParsedKey& key, const Args& args, Tensor* val,
               bool* is_dead, int64_t timeout_ms);
@@ -178,6 +203,39 @@ class Rendezvous : public RendezvousInterface, public core::RefCounted {
   static Status ParseKey(StringPiece key, ParsedKey* out);
 };
 
+namespace internal {
+
+// Gathers the results of the RecvAsync() calls that make up a RecvManyAsync(),
+// and invokes its callback once all of them have completed. Deletes itself
+// after invoking the callback.
+class RecvManyCollector {
+ public:
+  RecvManyCollector(int num_keys, RendezvousInterface::ManyDoneCallback done);
+  ~RecvManyCollector();
+
+  // Records the result for the "index"-th key. Must be called exactly once
+  // for every key.
+  void Done(int index, const Status& status,
+            const RendezvousInterface::Args& send_args, const Tensor& val,
+            bool is_dead);
+
+  // Returns a callback that calls Done() for the "index"-th key.
+  RendezvousInterface::DoneCallback Callback(int index);
+
+ private:
+  const RendezvousInterface::ManyDoneCallback done_;
+  std::vector<RendezvousInterface::Args> send_args_;
+  std::vector<Tensor> vals_;
+  std::unique_ptr<bool[]> is_dead_;
+  std::atomic<int> num_pending_;
+  mutex mu_;
+  Status status_ TF_GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(RecvManyCollector);
+};
+
+}  // namespace internal
+
 // Returns a Rendezvous instance that is limited to use only by
 // producers and consumers in the local process.  The caller assumes
 // ownership of one Ref() on the returned object.
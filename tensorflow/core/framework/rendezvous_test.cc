@@ -331,6 +331,48 @@ TEST_F(LocalRendezvousTest, RandomSendRecv) {
   state.done.WaitForNotification();
 }
 
+TEST_F(LocalRendezvousTest, RecvMany) {
+  Rendezvous::Args args;
+  // "foo" is sent before the batch is registered, "bar" after.
+  TF_ASSERT_OK(rendez_->Send(KeyFoo(), args, V("hello"), false));
+  const std::vector<Rendezvous::ParsedKey> keys = {KeyFoo(), KeyBar()};
+  const std::vector<Rendezvous::Args> recv_args(keys.size());
+  Notification n;
+  rendez_->RecvManyAsync(
+      keys, recv_args,
+      [&n](const Status& s, const std::vector<Rendezvous::Args>& send_args,
+           const std::vector<Tensor>& vals, const std::vector<bool>& is_dead) {
+        TF_EXPECT_OK(s);
+        ASSERT_EQ(2, vals.size());
+        EXPECT_EQ("hello", V(vals[0]));
+        EXPECT_EQ("world", V(vals[1]));
+        EXPECT_FALSE(is_dead[0]);
+        EXPECT_TRUE(is_dead[1]);
+        n.Notify();
+      });
+  EXPECT_FALSE(n.HasBeenNotified());
+  TF_ASSERT_OK(rendez_->Send(KeyBar(), args, V("world"), true));
+  n.WaitForNotification();
+}
+
+TEST_F(LocalRendezvousTest, RecvManyAbort) {
+  const std::vector<Rendezvous::ParsedKey> keys = {KeyFoo(), KeyBar()};
+  const std::vector<Rendezvous::Args> recv_args(keys.size());
+  Notification n;
+  rendez_->RecvManyAsync(
+      keys, recv_args,
+      [&n](const Status& s, const std::vector<Rendezvous::Args>& send_args,
+           const std::vector<Tensor>& vals, const std::vector<bool>& is_dead) {
+        EXPECT_TRUE(errors::IsAborted(s));
+        n.Notify();
+      });
+  TF_ASSERT_OK(rendez_->Send(KeyFoo(), Rendezvous::Args(), V("hello"), false));
+  // The batch only completes once the pending key has failed as well.
+  EXPECT_FALSE(n.HasBeenNotified());
+  rendez_->StartAbort(errors::Aborted(""));
+  n.WaitForNotification();
+}
+
 void RandomSleep() {
   if (std::rand() % 10 == 0) {
     Env::Default()->SleepForMicroseconds(1000);
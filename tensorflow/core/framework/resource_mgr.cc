@@ -16,11 +16,13 @@ limitations under the License.
 #include "tensorflow/core/framework/resource_mgr.h"
 
 #include <atomic>
+#include <vector>
 
 #include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/lib/strings/scanner.h"
 #include "tensorflow/core/lib/strings/str_util.h"
@@ -135,21 +137,69 @@ ResourceMgr::ResourceMgr(const string& default_container)
 
 ResourceMgr::~ResourceMgr() { Clear(); }
 
+ResourceMgr::Shard& ResourceMgr::GetShard(const string& container,
+                                          uint64 type_hash_code,
+                                          StringPiece name) const {
+  const uint64 hash = Hash64Combine(Hash64(container),
+                                    KeyHash()(Key(type_hash_code, name)));
+  return shards_[hash % kNumShards];
+}
+
+void ResourceMgr::LockAllShards() const {
+  for (const Shard& shard : shards_) {
+    shard.mu.lock();
+  }
+}
+
+void ResourceMgr::UnlockAllShards() const {
+  for (auto it = shards_.rbegin(); it != shards_.rend(); ++it) {
+    it->mu.unlock();
+  }
+}
+
+Status ResourceMgr::ResourceNotFound(const string& container,
+                                     const string& resource_name,
+                                     const string& type_name) const {
+  bool container_exists;
+  {
+    tf_shared_lock l(mu_);
+    container_exists = container_names_.contains(container);
+  }
+  if (!container_exists) {
+    return errors::NotFound("Container ", container,
+                            " does not exist. (Could not find resource: ",
+                            container, "/", resource_name, ")");
+  }
+  return errors::NotFound("Resource ", container, "/", resource_name, "/",
+                          type_name, " does not exist.");
+}
+
 void ResourceMgr::Clear() {
   // We do the deallocation outside of the lock to avoid a potential deadlock
   // in case any of the destructors access the resource manager.
-  absl::flat_hash_map<string, Container*> tmp_containers;
+  std::vector<absl::flat_hash_map<string, Container*>> tmp_containers;
+  tmp_containers.reserve(kNumShards);
+  LockAllShards();
+  for (Shard& shard : shards_) {
+    tmp_containers.push_back(std::move(shard.containers));
+    shard.containers.clear();
+  }
   {
     mutex_lock l(mu_);
-    tmp_containers = std::move(containers_);
+    container_names_.clear();
   }
-  for (const auto& p : tmp_containers) {
-    delete p.second;
+  UnlockAllShards();
+  for (const auto& containers : tmp_containers) {
+    for (const auto& p : containers) {
+      delete p.second;
+    }
   }
   tmp_containers.clear();
 }
 
 string ResourceMgr::DebugString() const {
+  LockAllShards();
+  auto unlock = gtl::MakeCleanup([this] { UnlockAllShards(); });
   mutex_lock l(mu_);
   struct Line {
     const string* container;
@@ -158,15 +208,18 @@ string ResourceMgr::DebugString() const {
     const string detail;
   };
   std::vector<Line> lines;
-  for (const auto& p : containers_) {
-    const string& container = p.first;
-    for (const auto& q : *p.second) {
-      const Key& key = q.first;
-      const char* type = DebugTypeName(key.first);
-      const core::RefCountPtr<ResourceBase> resource = q.second.GetResource();
-      Line l{&container, port::Demangle(type), q.second.name.get(),
-             resource ? resource->DebugString() : "<nullptr>"};
-      lines.push_back(l);
+  for (const Shard& shard : shards_) {
+    for (const auto& p : shard.containers) {
+      const string& container = p.first;
+      for (const auto& q : *p.second) {
+        const Key& key = q.first;
+        const char* type = DebugTypeName(key.first);
+        const core::RefCountPtr<ResourceBase> resource =
+            q.second.GetResource();
+        Line l{&container, port::Demangle(type), q.second.name.get(),
+               resource ? resource->DebugString() : "<nullptr>"};
+        lines.push_back(l);
+      }
     }
   }
   std::vector<string> text;
@@ -180,11 +233,11 @@ string ResourceMgr::DebugString() const {
   return absl::StrJoin(text, "\n");
 }
 
-Status ResourceMgr::DoCreate(const string& container_name, TypeIndex type,
-                             const string& name, ResourceBase* resource,
-                             bool owns_resource) {
-  Container* container = [&]() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    Container** ptr = &containers_[container_name];
+Status ResourceMgr::DoCreate(Shard* shard, const string& container_name,
+                             TypeIndex type, const string& name,
+                             ResourceBase* resource, bool owns_resource) {
+  Container* container = [&]() TF_EXCLUSIVE_LOCKS_REQUIRED(shard->mu) {
+    Container** ptr = &shard->containers[container_name];
     if (*ptr == nullptr) {
       *ptr = new Container;
     }
@@ -200,8 +253,8 @@ Status ResourceMgr::DoCreate(const string& container_name, TypeIndex type,
   if (owns_resource) {
     resource_and_name.resource = core::RefCountPtr<ResourceBase>(resource);
   } else {
-    auto cleanup_fn = [this, container, type, borrowed_name]() {
-      mutex_lock l(mu_);
+    auto cleanup_fn = [shard, container, type, borrowed_name]() {
+      mutex_lock l(shard->mu);
       auto iter = container->find({type.hash_code(), borrowed_name});
       if (iter != container->end()) {
         container->erase(iter);
@@ -215,6 +268,8 @@ Status ResourceMgr::DoCreate(const string& container_name, TypeIndex type,
                                       std::move(resource_and_name));
 
   auto st = container->insert(std::move(key_and_value));
+  mutex_lock l(mu_);
+  container_names_.insert(container_name);
   if (st.second) {
     TF_RETURN_IF_ERROR(InsertDebugTypeName(type.hash_code(), type.name()));
     return OkStatus();
@@ -225,26 +280,28 @@ Status ResourceMgr::DoCreate(const string& container_name, TypeIndex type,
 
 Status ResourceMgr::Lookup(const ResourceHandle& handle,
                            ResourceBase** resource) const {
-  tf_shared_lock l(mu_);
-  return DoLookup(handle.container(), handle.hash_code(),
+  const Shard& shard =
+      GetShard(handle.container(), handle.hash_code(), handle.name());
+  tf_shared_lock l(shard.mu);
+  return DoLookup(shard, handle.container(), handle.hash_code(),
                   /*type_name=*/"ResourceBase", handle.name(), resource);
 }
 
-Status ResourceMgr::DoLookup(const string& container, TypeIndex type,
-                             const string& name,
+Status ResourceMgr::DoLookup(const Shard& shard, const string& container,
+                             TypeIndex type, const string& name,
                              ResourceBase** resource) const {
-  return DoLookup(container, type.hash_code(), type.name(), name, resource);
+  return DoLookup(shard, container, type.hash_code(), type.name(), name,
+                  resource);
 }
 
-Status ResourceMgr::DoLookup(const string& container, uint64 type_hash_code,
-                             const string& type_name,
+Status ResourceMgr::DoLookup(const Shard& shard, const string& container,
+                             uint64 type_hash_code, const string& type_name,
                              const string& resource_name,
                              ResourceBase** resource) const {
-  const Container* b = gtl::FindPtrOrNull(containers_, container);
+  const Container* b = gtl::FindPtrOrNull(shard.containers, container);
   if (b == nullptr) {
-    return errors::NotFound("Container ", container,
-                            " does not exist. (Could not find resource: ",
-                            container, "/", resource_name, ")");
+    // The container may still have resources in other shards.
+    return ResourceNotFound(container, resource_name, type_name);
   }
   auto iter = b->find({type_hash_code, resource_name});
   if (iter == b->end()) {
@@ -265,10 +322,20 @@ Status ResourceMgr::PopResourceAndName(const string& container,
                                        const string& resource_name,
                                        const string& type_name,
                                        ResourceAndName& resource_and_name) {
-  mutex_lock l(mu_);
-  Container* b = gtl::FindPtrOrNull(containers_, container);
+  Shard& shard = GetShard(container, type_hash_code, resource_name);
+  mutex_lock l(shard.mu);
+  Container* b = gtl::FindPtrOrNull(shard.containers, container);
   if (b == nullptr) {
-    return errors::NotFound("Container ", container, " does not exist.");
+    bool container_exists;
+    {
+      tf_shared_lock l(mu_);
+      container_exists = container_names_.contains(container);
+    }
+    if (!container_exists) {
+      return errors::NotFound("Container ", container, " does not exist.");
+    }
+    return errors::NotFound("Resource ", container, "/", resource_name, "/",
+                            type_name, " does not exist.");
   }
   auto iter = b->find({type_hash_code, resource_name});
   if (iter == b->end()) {
@@ -311,24 +378,33 @@ Status ResourceMgr::Delete(const ResourceHandle& handle) {
 Status ResourceMgr::Cleanup(const string& container) {
   {
     tf_shared_lock l(mu_);
-    if (!gtl::FindOrNull(containers_, container)) {
+    if (!container_names_.contains(container)) {
       // Nothing to cleanup.
       return OkStatus();
     }
   }
-  Container* b = nullptr;
+  // The container is removed from all the shards at once, so that a
+  // concurrent lookup never sees a partially cleaned up container.
+  std::vector<Container*> parts;
+  LockAllShards();
   {
     mutex_lock l(mu_);
-    auto iter = containers_.find(container);
-    if (iter == containers_.end()) {
-      // Nothing to cleanup, it's OK (concurrent cleanup).
-      return OkStatus();
+    // Nothing to cleanup if the container is gone, it's OK (concurrent
+    // cleanup).
+    if (container_names_.erase(container) > 0) {
+      for (Shard& shard : shards_) {
+        auto iter = shard.containers.find(container);
+        if (iter != shard.containers.end()) {
+          parts.push_back(iter->second);
+          shard.containers.erase(iter);
+        }
+      }
     }
-    b = iter->second;
-    containers_.erase(iter);
   }
-  CHECK(b != nullptr);
-  delete b;
+  UnlockAllShards();
+  for (Container* b : parts) {
+    delete b;
+  }
   return OkStatus();
 }
 
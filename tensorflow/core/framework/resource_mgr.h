@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_RESOURCE_MGR_H_
 #define TENSORFLOW_CORE_FRAMEWORK_RESOURCE_MGR_H_
 
+#include <array>
 #include <memory>
 #include <string>
 #include <typeindex>
@@ -23,6 +24,7 @@ limitations under the License.
 #include <unordered_map>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/types/variant.h"
 #include "tensorflow/core/framework/common_shape_fns.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
@@ -39,6 +41,7 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/mutex_contention.h"
 #include "tensorflow/core/platform/thread_annotations.h"
 
 namespace tensorflow {
@@ -194,9 +197,9 @@ class ResourceMgr {
   Status Lookup(const ResourceHandle& handle,
                 ResourceBase** resource) const TF_MUST_USE_RESULT;
 
-  // Similar to Lookup, but looks up multiple resources at once, with only a
-  // single lock acquisition.  If containers_and_names[i] is uninitialized
-  // then this function does not modify resources[i].
+  // Similar to Lookup, but looks up multiple resources at once.  If
+  // containers_and_names[i] is uninitialized then this function does not
+  // modify resources[i].
   template <typename T, bool use_dynamic_cast = false>
   Status LookupMany(absl::Span<std::pair<const string*, const string*> const>
                         containers_and_names,
@@ -271,31 +274,57 @@ class ResourceMgr {
   typedef absl::flat_hash_map<Key, ResourceAndName, KeyHash, KeyEqual>
       Container;
 
+  // The resources are spread over shards by the hash of their container, type
+  // and name, so that lookups of different resources seldom contend on the
+  // same lock. Each shard has its own map from container name to the part of
+  // the container that belongs to the shard.
+  static constexpr int kNumShards = 16;
+  struct alignas(64) Shard {
+    mutable mutex mu;
+    MutexContentionSite mu_site{&mu, "ResourceMgr::Shard"};
+    absl::flat_hash_map<string, Container*> containers TF_GUARDED_BY(mu);
+  };
+
   const std::string default_container_;
+  mutable std::array<Shard, kNumShards> shards_;
+
+  // Guards the container names and the debug type names. When both are held,
+  // a shard lock must be acquired before `mu_`.
   mutable mutex mu_;
-  absl::flat_hash_map<string, Container*> containers_ TF_GUARDED_BY(mu_);
+  MutexContentionSite mu_site_{&mu_, "ResourceMgr"};
+  // The names of the containers that exist, i.e. that were used to create a
+  // resource and were not cleaned up since.
+  absl::flat_hash_set<string> container_names_ TF_GUARDED_BY(mu_);
+
+  Shard& GetShard(const std::string& container, uint64 type_hash_code,
+                  StringPiece name) const;
+  // Acquires the locks of all the shards, in order.
+  void LockAllShards() const TF_NO_THREAD_SAFETY_ANALYSIS;
+  void UnlockAllShards() const TF_NO_THREAD_SAFETY_ANALYSIS;
+  // Returns the error for a resource that is not in its shard.
+  Status ResourceNotFound(const std::string& container,
+                          const std::string& resource_name,
+                          const std::string& type_name) const;
 
   template <typename T, bool use_dynamic_cast = false>
-  Status LookupInternal(const std::string& container, const std::string& name,
-                        T** resource) const
-      TF_SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
-  Status LookupInternal(const std::string& container, uint64 type_hash_code,
-                        const std::string& name, ResourceBase** resource) const
-      TF_SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
-
-  Status DoCreate(const std::string& container, TypeIndex type,
+  Status LookupInternal(const Shard& shard, const std::string& container,
+                        const std::string& name, T** resource) const
+      TF_SHARED_LOCKS_REQUIRED(shard.mu) TF_MUST_USE_RESULT;
+
+  Status DoCreate(Shard* shard, const std::string& container, TypeIndex type,
                   const std::string& name, ResourceBase* resource,
                   bool owns_resource)
-      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+      TF_EXCLUSIVE_LOCKS_REQUIRED(shard->mu) TF_MUST_USE_RESULT;
 
-  Status DoLookup(const std::string& container, TypeIndex type,
-                  const std::string& name, ResourceBase** resource) const
-      TF_SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
-  Status DoLookup(const std::string& container, uint64 type_hash_code,
-                  const std::string& type_name,
+  Status DoLookup(const Shard& shard, const std::string& container,
+                  TypeIndex type, const std::string& name,
+                  ResourceBase** resource) const
+      TF_SHARED_LOCKS_REQUIRED(shard.mu) TF_MUST_USE_RESULT;
+  Status DoLookup(const Shard& shard, const std::string& container,
+                  uint64 type_hash_code, const std::string& type_name,
                   const std::string& resource_name,
                   ResourceBase** resource) const
-      TF_SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+      TF_SHARED_LOCKS_REQUIRED(shard.mu) TF_MUST_USE_RESULT;
 
   Status DoDelete(const std::string& container, uint64 type_hash_code,
                   const std::string& resource_name,
@@ -632,8 +661,10 @@ Status ResourceMgr::Create(const std::string& container,
                            const std::string& name, T* resource) {
   CheckDeriveFromResourceBase<T>();
   CHECK(resource != nullptr);
-  mutex_lock l(mu_);
-  return DoCreate(container, TypeIndex::Make<T>(), name, resource,
+  const TypeIndex type = TypeIndex::Make<T>();
+  Shard& shard = GetShard(container, type.hash_code(), name);
+  mutex_lock l(shard.mu);
+  return DoCreate(&shard, container, type, name, resource,
                   /* owns_resource */ true);
 }
 
@@ -641,8 +672,10 @@ template <typename T>
 Status ResourceMgr::CreateUnowned(const std::string& container,
                                   const std::string& name, T* resource) {
   CheckDeriveFromResourceBase<T>();
-  mutex_lock l(mu_);
-  return DoCreate(container, TypeIndex::Make<T>(), name, resource,
+  const TypeIndex type = TypeIndex::Make<T>();
+  Shard& shard = GetShard(container, type.hash_code(), name);
+  mutex_lock l(shard.mu);
+  return DoCreate(&shard, container, type, name, resource,
                   /* owns_resource */ false);
 }
 
@@ -650,8 +683,10 @@ template <typename T, bool use_dynamic_cast>
 Status ResourceMgr::Lookup(const std::string& container,
                            const std::string& name, T** resource) const {
   CheckDeriveFromResourceBase<T>();
-  tf_shared_lock l(mu_);
-  return LookupInternal<T, use_dynamic_cast>(container, name, resource);
+  const Shard& shard =
+      GetShard(container, TypeIndex::Make<T>().hash_code(), name);
+  tf_shared_lock l(shard.mu);
+  return LookupInternal<T, use_dynamic_cast>(shard, container, name, resource);
 }
 
 template <typename T, bool use_dynamic_cast>
@@ -660,13 +695,16 @@ Status ResourceMgr::LookupMany(
         containers_and_names,
     std::vector<std::unique_ptr<T, core::RefCountDeleter>>* resources) const {
   CheckDeriveFromResourceBase<T>();
-  tf_shared_lock l(mu_);
+  const uint64 type_hash_code = TypeIndex::Make<T>().hash_code();
   resources->resize(containers_and_names.size());
   for (size_t i = 0; i < containers_and_names.size(); ++i) {
+    const std::string& container = *containers_and_names[i].first;
+    const std::string& name = *containers_and_names[i].second;
+    const Shard& shard = GetShard(container, type_hash_code, name);
+    tf_shared_lock l(shard.mu);
     T* resource;
-    Status s = LookupInternal<T, use_dynamic_cast>(
-        *containers_and_names[i].first, *containers_and_names[i].second,
-        &resource);
+    Status s =
+        LookupInternal<T, use_dynamic_cast>(shard, container, name, &resource);
     if (s.ok()) {
       (*resources)[i].reset(resource);
     }
@@ -686,11 +724,12 @@ struct TypeCastFunctor<T, true> {
 };
 
 template <typename T, bool use_dynamic_cast>
-Status ResourceMgr::LookupInternal(const std::string& container,
+Status ResourceMgr::LookupInternal(const Shard& shard,
+                                   const std::string& container,
                                    const std::string& name,
                                    T** resource) const {
   ResourceBase* found = nullptr;
-  Status s = DoLookup(container, TypeIndex::Make<T>(), name, &found);
+  Status s = DoLookup(shard, container, TypeIndex::Make<T>(), name, &found);
   if (s.ok()) {
     // It's safe to down cast 'found' to T* since
     // typeid(T).hash_code() is part of the map key.
@@ -705,17 +744,19 @@ Status ResourceMgr::LookupOrCreate(const std::string& container,
                                    std::function<Status(T**)> creator) {
   CheckDeriveFromResourceBase<T>();
   *resource = nullptr;
+  const TypeIndex type = TypeIndex::Make<T>();
+  Shard& shard = GetShard(container, type.hash_code(), name);
   Status s;
   {
-    tf_shared_lock l(mu_);
-    s = LookupInternal<T, use_dynamic_cast>(container, name, resource);
+    tf_shared_lock l(shard.mu);
+    s = LookupInternal<T, use_dynamic_cast>(shard, container, name, resource);
     if (s.ok()) return s;
   }
-  mutex_lock l(mu_);
-  s = LookupInternal<T, use_dynamic_cast>(container, name, resource);
+  mutex_lock l(shard.mu);
+  s = LookupInternal<T, use_dynamic_cast>(shard, container, name, resource);
   if (s.ok()) return s;
   TF_RETURN_IF_ERROR(creator(resource));
-  s = DoCreate(container, TypeIndex::Make<T>(), name, *resource,
+  s = DoCreate(&shard, container, type, name, *resource,
                /* owns_resource */ true);
   if (!s.ok()) {
     return errors::Internal("LookupOrCreate failed unexpectedly");
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/framework/resource_mgr.h"
 
 #include <memory>
+#include <vector>
 
 #include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
@@ -248,6 +249,74 @@ TEST(ResourceMgrTest, CreateOrLookupRaceCondition) {
   EXPECT_EQ(1, atomic_int);
 }
 
+TEST(ResourceMgrTest, ManyResourcesInOneContainer) {
+  ResourceMgr rm;
+  // Enough resources to span all the shards of the manager.
+  constexpr int kNumResources = 100;
+  for (int i = 0; i < kNumResources; ++i) {
+    TF_CHECK_OK(rm.Create("foo", strings::StrCat("r", i),
+                          new Resource(strings::StrCat(i))));
+  }
+  for (int i = 0; i < kNumResources; ++i) {
+    EXPECT_EQ(strings::StrCat("R/", i),
+              Find<Resource>(rm, "foo", strings::StrCat("r", i)));
+  }
+  std::vector<std::pair<const string*, const string*>> containers_and_names;
+  const string container = "foo";
+  std::vector<string> names;
+  for (int i = 0; i < kNumResources; ++i) {
+    names.push_back(strings::StrCat("r", i));
+  }
+  for (const string& name : names) {
+    containers_and_names.push_back({&container, &name});
+  }
+  std::vector<std::unique_ptr<Resource, core::RefCountDeleter>> resources;
+  TF_CHECK_OK(rm.LookupMany<Resource>(containers_and_names, &resources));
+  for (int i = 0; i < kNumResources; ++i) {
+    ASSERT_NE(nullptr, resources[i]);
+    EXPECT_EQ(strings::StrCat("R/", i), resources[i]->DebugString());
+  }
+
+  // The container exists even in the shards that none of its resources are
+  // in.
+  HasError(FindErr<Other>(rm, "foo", "r0"), error::NOT_FOUND,
+           "Resource foo/r0");
+  HasError(rm.Delete<Other>("foo", "r0"), error::NOT_FOUND,
+           "Resource foo/r0");
+
+  TF_CHECK_OK(rm.Cleanup("foo"));
+  for (int i = 0; i < kNumResources; ++i) {
+    HasError(FindErr<Resource>(rm, "foo", strings::StrCat("r", i)),
+             error::NOT_FOUND, "Container foo");
+  }
+}
+
+TEST(ResourceMgrTest, ConcurrentLookups) {
+  ResourceMgr rm;
+  constexpr int kNumResources = 32;
+  for (int i = 0; i < kNumResources; ++i) {
+    TF_CHECK_OK(rm.Create("foo", strings::StrCat("r", i),
+                          new Resource(strings::StrCat(i))));
+  }
+  {
+    thread::ThreadPool threads(Env::Default(), "concurrent_lookups", 8);
+    for (int t = 0; t < 8; ++t) {
+      threads.Schedule([&rm, t] {
+        for (int i = 0; i < 1000; ++i) {
+          const int j = (i + t) % kNumResources;
+          EXPECT_EQ(strings::StrCat("R/", j),
+                    Find<Resource>(rm, "foo", strings::StrCat("r", j)));
+          // Concurrently create and delete resources of another type.
+          const string name = strings::StrCat("o", t);
+          TF_CHECK_OK(rm.Create("foo", name, new Other(name)));
+          TF_CHECK_OK(rm.Delete<Other>("foo", name));
+        }
+      });
+    }
+  }
+  TF_CHECK_OK(rm.Cleanup("foo"));
+}
+
 Status ComputePolicy(const string& attr_container,
                      const string& attr_shared_name,
                      bool use_node_name_as_default, string* result) {
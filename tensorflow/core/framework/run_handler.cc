@@ -748,6 +748,20 @@ class RunHandler::Impl {
   internal::ThreadWorkSource* tws() { return &tws_; }
 
   int64_t priority() { return options_.priority(); }
+  int64_t deadline_micros() { return options_.deadline_micros(); }
+
+  // Returns true if the ops of this request should be scheduled before those
+  // of `other`: higher priorities first, then earlier deadlines among requests
+  // with the same priority. Requests without a deadline never go before others
+  // with the same priority, which keeps them in arrival order.
+  bool ScheduledBefore(Impl* other) {
+    if (priority() != other->priority()) {
+      return priority() > other->priority();
+    }
+    return deadline_micros() > 0 &&
+           (other->deadline_micros() == 0 ||
+            deadline_micros() < other->deadline_micros());
+  }
 
  private:
   class ThreadPoolInterfaceWrapper : public thread::ThreadPoolInterface {
@@ -866,20 +880,19 @@ class RunHandlerPool::Impl {
           return nullptr;
         }
       }
-      // Remove the last entry from free_handlers_ and add to the end of
-      // sorted_active_handlers_.
+      // Remove the last entry from free_handlers_ and insert it into
+      // sorted_active_handlers_ after the handlers scheduled before it.
       handler_impl = free_handlers_.back();
       handler_impl->Reset(step_id, options);
       free_handlers_.pop_back();
 
       num_active_requests = sorted_active_handlers_.size() + 1;
       thread_work_sources->resize(num_active_requests);
-      int priority = options.priority();
       auto it = sorted_active_handlers_.cbegin();
       bool new_handler_inserted = false;
       for (int i = 0; i < num_active_requests; ++i) {
         if (!new_handler_inserted && (it == sorted_active_handlers_.cend() ||
-                                      priority > (*it)->priority())) {
+                                      handler_impl->ScheduledBefore(*it))) {
           sorted_active_handlers_.insert(it, handler_impl);
           new_handler_inserted = true;
           // Point to the newly added handler.
@@ -935,6 +948,16 @@ class RunHandlerPool::Impl {
     return ret;
   }
 
+  std::vector<int64_t> GetActiveHandlerStepIdsForTesting()
+      TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    std::vector<int64_t> ret;
+    for (const auto& handler_impl : sorted_active_handlers_) {
+      ret.push_back(handler_impl->step_id());
+    }
+    return ret;
+  }
+
  private:
   void RecomputePoolStats(
       int num_active_requests, uint64 version,
@@ -954,8 +977,8 @@ class RunHandlerPool::Impl {
 
   std::unique_ptr<internal::RunHandlerThreadPool> run_handler_thread_pool_;
   // Thread compatible part used only by lock under RunHandlerPool.
-  // Handlers are sorted by start time.
-  // TODO(azaks): sort by the remaining latency budget.
+  // Handlers are sorted by priority, then by deadline, then by start time (see
+  // RunHandler::Impl::ScheduledBefore()).
   // TODO(chaox): Consider other data structure for maintaining the sorted
   // active handlers if the searching overhead(currently O(n)) becomes the
   // bottleneck.
@@ -1104,6 +1127,10 @@ std::vector<int64_t> RunHandlerPool::GetActiveHandlerPrioritiesForTesting()
   return impl_->GetActiveHandlerPrioritiesForTesting();
 }
 
+std::vector<int64_t> RunHandlerPool::GetActiveHandlerStepIdsForTesting() const {
+  return impl_->GetActiveHandlerStepIdsForTesting();
+}
+
 RunHandler::RunHandler(Impl* impl) : impl_(impl) {}
 
 void RunHandler::ScheduleInterOpClosure(std::function<void()> fn) {
@@ -883,6 +883,107 @@ void Tensor::HostScalarTensorBufferBase::FillAllocationDescription(
   proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
 }
 
+// A buffer over caller-owned memory, which calls `releaser` when it is
+// destroyed.
+class ExternalBuffer : public TensorBuffer {
+ public:
+  ExternalBuffer(void* data, size_t num_bytes, std::function<void()> releaser)
+      : TensorBuffer(data),
+        num_bytes_(num_bytes),
+        releaser_(std::move(releaser)) {}
+
+  size_t size() const override { return num_bytes_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(num_bytes_);
+    proto->set_allocator_name("ExternalBuffer");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  ~ExternalBuffer() override {
+    if (releaser_) releaser_();
+  }
+
+  const size_t num_bytes_;
+  std::function<void()> releaser_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ExternalBuffer);
+};
+
+// A buffer whose data is stored in the same aligned heap block, right after
+// the buffer object.
+class InlineBuffer : public TensorBuffer {
+ public:
+  static InlineBuffer* New(size_t num_bytes) {
+    const size_t alignment = std::max(1, EIGEN_MAX_ALIGN_BYTES);
+    const size_t data_offset =
+        (sizeof(InlineBuffer) + alignment - 1) & ~(alignment - 1);
+    void* block = port::AlignedMalloc(data_offset + num_bytes, alignment);
+    return new (block)
+        InlineBuffer(static_cast<char*>(block) + data_offset, num_bytes);
+  }
+
+  size_t size() const override { return num_bytes_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(num_bytes_);
+    proto->set_allocator_name("InlineBuffer");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  // Frees the whole block when `Unref()` deletes the buffer.
+  static void operator delete(void* ptr) { port::AlignedFree(ptr); }
+  static void operator delete(void*, void*) {}
+
+ private:
+  InlineBuffer(void* data, size_t num_bytes)
+      : TensorBuffer(data), num_bytes_(num_bytes) {}
+  ~InlineBuffer() override {}
+
+  const size_t num_bytes_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(InlineBuffer);
+};
+
+Tensor Tensor::HostInline(DataType type, const TensorShape& shape) {
+  DCHECK(CanUseHostInline(type, shape));
+  Tensor ret;
+  ret.shape_ = shape;
+  ret.set_dtype(type);
+  ret.buf_ = InlineBuffer::New(shape.num_elements() * DataTypeSize(type));
+  return ret;
+}
+
+Status Tensor::FromExternal(DataType type, const TensorShape& shape,
+                            void* data, size_t num_bytes,
+                            std::function<void()> releaser,
+                            Tensor* out_tensor) {
+  if (!DataTypeCanUseMemcpy(type)) {
+    return errors::InvalidArgument(
+        "Cannot create a tensor of type ", DataTypeString(type),
+        " over external memory");
+  }
+  const size_t required_bytes = DataTypeSize(type) * shape.num_elements();
+  if (num_bytes < required_bytes) {
+    return errors::InvalidArgument("External buffer of ", num_bytes,
+                                   " bytes is too small for a tensor of shape ",
+                                   shape.DebugString(), " and type ",
+                                   DataTypeString(type), ", which needs ",
+                                   required_bytes, " bytes");
+  }
+  const int alignment = std::max(1, EIGEN_MAX_ALIGN_BYTES);
+  if (reinterpret_cast<intptr_t>(data) % alignment != 0) {
+    return errors::InvalidArgument("External buffer at ", data,
+                                   " is not aligned to ", alignment, " bytes");
+  }
+  auto* buf = new ExternalBuffer(data, num_bytes, std::move(releaser));
+  *out_tensor = Tensor(type, shape, buf);
+  buf->Unref();
+  return OkStatus();
+}
+
 template <typename T>
 class SubBuffer : public TensorBuffer {
  public:
@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_FRAMEWORK_TENSOR_H_
 
 #include <cstdint>
+#include <functional>
 #include <type_traits>
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
@@ -184,6 +185,39 @@ class Tensor {
   static Status BuildTensor(DataType type, const TensorShape& shape,
                             Tensor* out_tensor);
 
+  /// \brief Initializes a tensor with the input `type` and `shape` over
+  /// `num_bytes` of caller-owned memory at `data`, without copying it, or
+  /// returns an error and leaves `out_tensor` unmodified.
+  ///
+  /// `releaser` is called exactly once, when the last tensor referring to the
+  /// memory is destroyed; until then the memory must remain valid. This can
+  /// be used to feed shared memory, RDMA-registered buffers or mmap'd files to
+  /// the runtime. `type` must be a type that can be memcpy'd, `data` must be
+  /// suitably aligned (see `EIGEN_MAX_ALIGN_BYTES`), and `num_bytes` must be
+  /// large enough for `shape`. On error `releaser` is not called.
+  static Status FromExternal(DataType type, const TensorShape& shape,
+                             void* data, size_t num_bytes,
+                             std::function<void()> releaser,
+                             Tensor* out_tensor);
+
+  /// The largest size, in bytes, of the tensors that `HostInline()` creates.
+  static constexpr size_t kMaxInlineBytes = 64;
+
+  /// \brief Creates a host tensor of the given `type` and `shape` whose data
+  /// is stored in the same heap block as its buffer, bypassing `Allocator`s
+  /// (and their accounting). This saves an allocation for scalars and other
+  /// tiny tensors. Requires that `type` can be memcpy'd and that the tensor
+  /// is at most `kMaxInlineBytes` large (see `CanUseHostInline()`). The
+  /// contents of the tensor are uninitialized.
+  static Tensor HostInline(DataType type, const TensorShape& shape);
+
+  /// Returns true if `HostInline()` can create a tensor of `type` and
+  /// `shape`.
+  static bool CanUseHostInline(DataType type, const TensorShape& shape) {
+    return DataTypeCanUseMemcpy(type) &&
+           shape.num_elements() * DataTypeSize(type) <= kMaxInlineBytes;
+  }
+
  private:
   // A tag type for selecting the `Tensor` constructor overload that creates a
   // scalar tensor in host memory.
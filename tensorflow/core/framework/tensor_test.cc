@@ -902,6 +902,59 @@ TEST(Tensor_HostScalar, Basics) {
   }
 }
 
+TEST(TensorTest, FromExternal) {
+  // At least EIGEN_MAX_ALIGN_BYTES.
+  alignas(64) float data[6] = {1, 2, 3, 4, 5, 6};
+  int num_releases = 0;
+  {
+    Tensor t;
+    ASSERT_TRUE(Tensor::FromExternal(DT_FLOAT, TensorShape({2, 3}), data,
+                                     sizeof(data),
+                                     [&num_releases]() { ++num_releases; },
+                                     &t)
+                    .ok());
+    // The tensor aliases the external memory.
+    EXPECT_EQ(t.flat<float>().data(), data);
+    EXPECT_EQ(t.matrix<float>()(1, 2), 6);
+    Tensor slice = t.Slice(1, 2);
+    t = Tensor();
+    EXPECT_EQ(num_releases, 0);
+    EXPECT_EQ(slice.matrix<float>()(0, 0), 4);
+  }
+  EXPECT_EQ(num_releases, 1);
+
+  Tensor t;
+  auto releaser = [&num_releases]() { ++num_releases; };
+  EXPECT_FALSE(Tensor::FromExternal(DT_FLOAT, TensorShape({2, 4}), data,
+                                    sizeof(data), releaser, &t)
+                   .ok());
+  EXPECT_FALSE(Tensor::FromExternal(DT_STRING, TensorShape({1}), data,
+                                    sizeof(data), releaser, &t)
+                   .ok());
+  EXPECT_EQ(num_releases, 1);
+}
+
+TEST(TensorTest, HostInline) {
+  EXPECT_TRUE(Tensor::CanUseHostInline(DT_INT64, TensorShape({8})));
+  EXPECT_FALSE(Tensor::CanUseHostInline(DT_INT64, TensorShape({9})));
+  EXPECT_FALSE(Tensor::CanUseHostInline(DT_STRING, TensorShape({})));
+
+  Tensor t = Tensor::HostInline(DT_INT32, TensorShape({2, 2}));
+  EXPECT_EQ(t.dtype(), DT_INT32);
+  EXPECT_EQ(t.shape(), TensorShape({2, 2}));
+  EXPECT_EQ(t.TotalBytes(), 4 * sizeof(int32));
+  EXPECT_TRUE(t.IsAligned());
+  test::FillValues<int32>(&t, {1, 2, 3, 4});
+  Tensor copy = t;
+  t = Tensor();
+  test::ExpectTensorEqual<int32>(
+      copy, test::AsTensor<int32>({1, 2, 3, 4}, TensorShape({2, 2})));
+  Tensor slice = copy.Slice(1, 2);
+  copy = Tensor();
+  test::ExpectTensorEqual<int32>(
+      slice, test::AsTensor<int32>({3, 4}, TensorShape({1, 2})));
+}
+
 TEST(Tensor_Float, Reshape_And_Slice_Assignment) {
   // A test to experiment with a way to assign to a subset of a tensor
   Tensor t(DT_FLOAT, TensorShape({10, 4, 3, 2}));
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/costs/graph_properties.h"
 
+#include <list>
+
 #include "absl/types/optional.h"
 #include "tensorflow/core/common_runtime/function.h"
 #include "tensorflow/core/common_runtime/graph_constructor.h"
@@ -36,7 +38,11 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils/topological_sort.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/gtl/flatset.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -2512,10 +2518,121 @@ Status GraphProperties::UpdateEnqueue(
   return OkStatus();
 }
 
+namespace {
+
+// The properties inferred statically for a graph.
+struct StaticProperties {
+  absl::flat_hash_map<string, std::vector<OpInfo::TensorProperties>>
+      input_properties;
+  absl::flat_hash_map<string, std::vector<OpInfo::TensorProperties>>
+      output_properties;
+  std::unordered_set<string> incompatible_shape_nodes;
+};
+
+// A process-wide cache of the most recently inferred static properties,
+// keyed by a fingerprint of the graph and of the inference options. Several
+// optimizers of a meta optimizer pass infer the properties of the same graph,
+// e.g. whenever the optimizers that run between them leave it unchanged.
+class StaticPropertiesCache {
+ public:
+  static StaticPropertiesCache* Global() {
+    static StaticPropertiesCache* cache = new StaticPropertiesCache();
+    return cache;
+  }
+
+  // Copies the properties cached for `key` into `properties`, and returns
+  // false if there are none.
+  bool Lookup(uint64 key, StaticProperties* properties) {
+    mutex_lock l(mu_);
+    auto it = index_.find(key);
+    if (it == index_.end()) return false;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    *properties = it->second->second;
+    return true;
+  }
+
+  // Caches `properties` for `key`, keeping at most `capacity` graphs.
+  void Insert(uint64 key, const StaticProperties& properties,
+              int64_t capacity) {
+    mutex_lock l(mu_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+    entries_.emplace_front(key, properties);
+    index_[key] = entries_.begin();
+    while (static_cast<int64_t>(entries_.size()) > capacity) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+ private:
+  using Entry = std::pair<uint64, StaticProperties>;
+
+  mutex mu_;
+  // Most recently used first.
+  std::list<Entry> entries_ TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<uint64, std::list<Entry>::iterator> index_
+      TF_GUARDED_BY(mu_);
+};
+
+// Returns the number of graphs whose static properties are cached, which is
+// set by the TF_GRAPPLER_GRAPH_PROPERTIES_CACHE_SIZE environment variable.
+// The cache is disabled by default.
+int64_t StaticPropertiesCacheCapacity() {
+  int64_t capacity;
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRAPPLER_GRAPH_PROPERTIES_CACHE_SIZE",
+                                  /*default_val=*/0, &capacity));
+  return capacity;
+}
+
+// Returns the cache key of the properties of `item`, i.e. a fingerprint of
+// everything InferStatically depends on.
+uint64 StaticPropertiesCacheKey(const GrapplerItem& item,
+                                bool assume_valid_feeds,
+                                bool aggressive_shape_inference,
+                                bool include_input_tensor_values,
+                                bool include_output_tensor_values) {
+  string serialized_graph;
+  SerializeToStringDeterministic(item.graph, &serialized_graph);
+  uint64 key = Fingerprint64(serialized_graph);
+  if (!assume_valid_feeds) {
+    for (const auto& feed : item.feed) {
+      key = FingerprintCat64(key, Fingerprint64(feed.first));
+    }
+  }
+  const uint64 options = (assume_valid_feeds ? 1 : 0) |
+                         (aggressive_shape_inference ? 2 : 0) |
+                         (include_input_tensor_values ? 4 : 0) |
+                         (include_output_tensor_values ? 8 : 0);
+  return FingerprintCat64(key, options);
+}
+
+}  // namespace
+
 Status GraphProperties::InferStatically(bool assume_valid_feeds,
                                         bool aggressive_shape_inference,
                                         bool include_input_tensor_values,
                                         bool include_output_tensor_values) {
+  const int64_t cache_capacity = StaticPropertiesCacheCapacity();
+  uint64 cache_key = 0;
+  if (cache_capacity > 0) {
+    cache_key = StaticPropertiesCacheKey(
+        item_, assume_valid_feeds, aggressive_shape_inference,
+        include_input_tensor_values, include_output_tensor_values);
+    StaticProperties properties;
+    if (StaticPropertiesCache::Global()->Lookup(cache_key, &properties)) {
+      VLOG(2) << "Reusing the cached properties of " << item_.id;
+      input_properties_ = std::move(properties.input_properties);
+      output_properties_ = std::move(properties.output_properties);
+      incompatible_shape_nodes_ =
+          std::move(properties.incompatible_shape_nodes);
+      return OkStatus();
+    }
+  }
+
   FunctionLibraryDefinition function_library(OpRegistry::Global(),
                                              item_.graph.library());
   absl::flat_hash_map<string, absl::flat_hash_set<int>> fed_ports;
@@ -2754,6 +2871,15 @@ Status GraphProperties::InferStatically(bool assume_valid_feeds,
   TF_RETURN_IF_ERROR(VerboseShapeInferenceLogging(item_.graph, refiner.get(),
                                                   shape_manager.get()));
 
+  if (cache_capacity > 0) {
+    StaticProperties properties;
+    properties.input_properties = input_properties_;
+    properties.output_properties = output_properties_;
+    properties.incompatible_shape_nodes = incompatible_shape_nodes_;
+    StaticPropertiesCache::Global()->Insert(cache_key, properties,
+                                            cache_capacity);
+  }
+
   return OkStatus();
 }
 
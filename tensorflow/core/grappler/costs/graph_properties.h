@@ -96,6 +96,9 @@ class GraphProperties {
   // will included in the input properties.
   // If include_output_tensor_values is true, the values of constant tensors
   // will be included in the output properties.
+  // If the TF_GRAPPLER_GRAPH_PROPERTIES_CACHE_SIZE environment variable is
+  // positive, the properties of that many recently inferred graphs are cached
+  // in the process, and are reused for graphs and options that are the same.
   Status InferStatically(bool assume_valid_feeds,
                          bool aggressive_shape_inference,
                          bool include_input_tensor_values,
@@ -233,6 +233,34 @@ TEST_F(GraphPropertiesTest, Clear) {
   EXPECT_FALSE(properties.has_properties());
 }
 
+TEST_F(GraphPropertiesTest, CachedStaticProperties) {
+  setenv("TF_GRAPPLER_GRAPH_PROPERTIES_CACHE_SIZE", "2", /*overwrite=*/1);
+  const auto make_item = [](const PartialTensorShape& shape) {
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+    Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                                ops::Placeholder::Shape(shape));
+    Output y = ops::Identity(s.WithOpName("y"), x);
+    GrapplerItem item;
+    TF_CHECK_OK(s.ToGraphDef(&item.graph));
+    return item;
+  };
+  const auto output_shape = [this](const GrapplerItem& item) {
+    GraphProperties properties(item);
+    TF_CHECK_OK(properties.InferStatically(false));
+    return PropToString(properties.GetOutputProperties("y").at(0));
+  };
+
+  const GrapplerItem item_2x3 = make_item(PartialTensorShape({2, 3}));
+  const GrapplerItem item_4x5 = make_item(PartialTensorShape({4, 5}));
+  EXPECT_EQ("float: [2,3]", output_shape(item_2x3));
+  // Graphs that differ are not mistaken for each other.
+  EXPECT_EQ("float: [4,5]", output_shape(item_4x5));
+  // The properties are read from the cache.
+  EXPECT_EQ("float: [2,3]", output_shape(item_2x3));
+  EXPECT_EQ("float: [4,5]", output_shape(item_4x5));
+  unsetenv("TF_GRAPPLER_GRAPH_PROPERTIES_CACHE_SIZE");
+}
+
 TEST_F(GraphPropertiesTest, DynamicProperties) {
   TrivialTestGraphInputYielder fake_input(4, 1, 10, false,
                                           cluster_->GetDeviceNames());
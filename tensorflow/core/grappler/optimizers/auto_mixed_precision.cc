@@ -29,6 +29,8 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/costs/graph_properties.h"
+#include "tensorflow/core/grappler/costs/op_level_cost_estimator.h"
 #include "tensorflow/core/grappler/costs/virtual_placer.h"
 #include "tensorflow/core/grappler/devices.h"
 #include "tensorflow/core/grappler/grappler_item.h"
@@ -41,6 +43,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/util/env_var.h"
@@ -63,6 +66,50 @@ bool ShouldSimulateGpu() {
   return is_enabled;
 }
 
+// A helper function to decide whether to ignore the effect on performance when
+// rewriting the graph. This can be useful for testing the numerical effects of
+// reduced precision on systems that have poor mixed precision performance.
+bool ShouldIgnorePerformance() {
+  static bool is_enabled = [] {
+    bool ret = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar(
+        "TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_IGNORE_PERFORMANCE",
+        /*default_val=*/false, &ret));
+    return ret;
+  }();
+  return is_enabled;
+}
+
+// The native bfloat16 support of the host CPU.
+enum class CpuBf16Isa { kNone, kAvx512Bf16, kAmx };
+
+CpuBf16Isa GetCpuBf16Isa() {
+  static const CpuBf16Isa isa = [] {
+    if (port::TestCPUFeature(port::CPUFeature::AMX_BF16)) {
+      return CpuBf16Isa::kAmx;
+    }
+    if (port::TestCPUFeature(port::CPUFeature::AVX512_BF16)) {
+      return CpuBf16Isa::kAvx512Bf16;
+    }
+    return CpuBf16Isa::kNone;
+  }();
+  return isa;
+}
+
+// Rough speedup of bfloat16 over float32 for the allowlist ops (matrix
+// multiplications and convolutions) on a CPU with the given bfloat16 support.
+double Bf16AllowlistSpeedup(CpuBf16Isa isa) {
+  switch (isa) {
+    case CpuBf16Isa::kAmx:
+      return 8.0;
+    case CpuBf16Isa::kAvx512Bf16:
+      return 2.0;
+    case CpuBf16Isa::kNone:
+      return 1.0;
+  }
+  return 1.0;
+}
+
 #if GOOGLE_CUDA
 const std::pair<int, int> kMinGPUArch = {7, 0};
 #else
@@ -1057,7 +1104,9 @@ class AutoMixedPrecisionImpl {
         return std::make_unique<AutoMixedPrecisionListsCuda>(cuda_version_,
                                                              cudnn_version_);
       case AutoMixedPrecisionMode::MKL:
-        return std::make_unique<AutoMixedPrecisionListsMkl>();
+        return std::make_unique<AutoMixedPrecisionListsMkl>(
+            /*has_amx=*/ShouldIgnorePerformance() ||
+            GetCpuBf16Isa() == CpuBf16Isa::kAmx);
       case AutoMixedPrecisionMode::CPU:
         // Note: this is not a typo here. AutoMixedPrecisionListsCuda is used
         // intentionally to make CPU and GPU have the same fp16 ops.
@@ -1105,6 +1154,8 @@ class AutoMixedPrecisionImpl {
       absl::flat_hash_set<int>* allow_set) const;
   void MakeCastsAllowIfAllOutputsAllow(
       absl::flat_hash_set<int>* allow_set) const;
+  StatusOr<bool> IsBf16RewriteProfitable(
+      const absl::flat_hash_set<int>& allow_set) const;
   NodeDef BuildCastNode(const MutableGraphView::OutputPort& src,
                         const MutableGraphView::InputPort& dst, bool to_f16,
                         const string& device) const;
@@ -1350,20 +1401,6 @@ void AutoMixedPrecisionImpl::ConvertBatchNormOpsToV2() {
   }
 }
 
-// A helper function to decide whether to ignore the effect on performance when
-// rewriting the graph. This can be useful for testing the numerical effects of
-// reduced precision on systems that have poor mixed precision performance.
-bool ShouldIgnorePerformance() {
-  static bool is_enabled = [] {
-    bool ret = false;
-    TF_CHECK_OK(ReadBoolFromEnvVar(
-        "TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_IGNORE_PERFORMANCE",
-        /*default_val=*/false, &ret));
-    return ret;
-  }();
-  return is_enabled;
-}
-
 Status AutoMixedPrecisionImpl::Optimize() {
   string optimization_level;
   TF_RETURN_IF_ERROR(ReadStringFromEnvVar(
@@ -1531,6 +1568,15 @@ Status AutoMixedPrecisionImpl::Optimize() {
   VLOG(2) << "Finding existing casts that can be made allow";
   MakeCastsAllowIfAllOutputsAllow(&allow_set);
 
+  if (mode_ == AutoMixedPrecisionMode::MKL && !ShouldIgnorePerformance()) {
+    TF_ASSIGN_OR_RETURN(bool profitable, IsBf16RewriteProfitable(allow_set));
+    if (!profitable) {
+      LOG(INFO) << "Converting to bfloat16 is estimated to be slower than "
+                   "float32 because of the casts, nothing to do";
+      return OkStatus();
+    }
+  }
+
   VLOG(2) << "Beginning final pass to change type attributes and insert Cast "
              "ops at paint boundaries";
   TF_RETURN_IF_ERROR(ChangeTypeAttrsAndAddCasts(allow_set));
@@ -1541,6 +1587,96 @@ Status AutoMixedPrecisionImpl::Optimize() {
   return OkStatus();
 }
 
+// Estimates with the grappler cost model whether the time saved by running the
+// allowlist ops of `allow_set` in bfloat16 exceeds the time spent in the Cast
+// ops that are needed at the boundaries of `allow_set`. Allowlist ops whose
+// cost can't be estimated (e.g. because of unknown shapes) are assumed to be
+// worth converting.
+StatusOr<bool> AutoMixedPrecisionImpl::IsBf16RewriteProfitable(
+    const absl::flat_hash_set<int>& allow_set) const {
+  absl::flat_hash_set<const NodeDef*> allow_nodes;
+  for (int node_type_idx : allow_set) {
+    allow_nodes.insert(graph_type_view_.GetNode(node_type_idx)->node);
+  }
+
+  GrapplerItem item;
+  item.graph = *graph_;
+  GraphProperties properties(item);
+  TF_RETURN_IF_ERROR(properties.InferStatically(
+      /*assume_valid_feeds=*/false,
+      /*aggressive_shape_inference=*/false,
+      /*include_tensor_values=*/false));
+
+  OpLevelCostEstimator estimator;
+  auto make_op_context = [&](const NodeDef& node) {
+    OpContext op_context;
+    op_context.name = node.name();
+    op_context.device_name = node.device();
+    op_context.op_info.set_op(node.op());
+    *op_context.op_info.mutable_attr() = node.attr();
+    *op_context.op_info.mutable_device() = virtual_placer_.get_device(node);
+    return op_context;
+  };
+  absl::flat_hash_set<string> cast_tensors;
+  int64_t saved_ns = 0;
+  int64_t cast_ns = 0;
+  auto add_cast = [&](const string& tensor, const NodeDef& node,
+                      const OpInfo::TensorProperties& tensor_properties) {
+    if (tensor_properties.dtype() != DT_FLOAT ||
+        !cast_tensors.insert(tensor).second) {
+      return;
+    }
+    OpContext op_context = make_op_context(node);
+    op_context.op_info.set_op("Cast");
+    op_context.op_info.clear_attr();
+    *op_context.op_info.add_inputs() = tensor_properties;
+    OpInfo::TensorProperties* output = op_context.op_info.add_outputs();
+    *output = tensor_properties;
+    output->set_dtype(DT_BFLOAT16);
+    cast_ns += estimator.PredictCosts(op_context).execution_time.count();
+  };
+
+  const double speedup = Bf16AllowlistSpeedup(GetCpuBf16Isa());
+  for (const NodeDef* node : allow_nodes) {
+    const auto& inputs = properties.GetInputProperties(node->name());
+    const auto& outputs = properties.GetOutputProperties(node->name());
+    if (f16_allowlist_.count(node->op())) {
+      OpContext op_context = make_op_context(*node);
+      for (const auto& input : inputs) *op_context.op_info.add_inputs() = input;
+      for (const auto& output : outputs) {
+        *op_context.op_info.add_outputs() = output;
+      }
+      const Costs costs = estimator.PredictCosts(op_context);
+      if (costs.inaccurate) return true;
+      saved_ns += static_cast<int64_t>(costs.compute_time.count() *
+                                       (1.0 - 1.0 / speedup));
+    }
+    for (int i = 0; i < node->input_size() && i < inputs.size(); ++i) {
+      const string& input = node->input(i);
+      if (IsControlInput(input)) break;
+      const NodeDef* fanin = graph_view_.GetNode(NodeName(input));
+      if (fanin != nullptr && !allow_nodes.contains(fanin)) {
+        add_cast(input, *node, inputs[i]);
+      }
+    }
+    for (int port = 0; port < outputs.size(); ++port) {
+      for (const auto& fanout :
+           graph_view_.GetFanout(MutableGraphView::OutputPort(
+               const_cast<NodeDef*>(node), port))) {
+        if (!allow_nodes.contains(fanout.node)) {
+          add_cast(absl::StrCat(node->name(), ":", port), *node,
+                   outputs[port]);
+          break;
+        }
+      }
+    }
+  }
+  VLOG(1) << "Estimated time saved by bfloat16 allowlist ops: " << saved_ns
+          << " ns, spent in " << cast_tensors.size() << " cast(s): " << cast_ns
+          << " ns";
+  return saved_ns > cast_ns;
+}
+
 // If node is a Tensor List op with a float32 data type attribute then this
 // returns a pointer to the NodeTypeId representing that type attribute. In
 // all other cases this returns nullptr.
@@ -2290,6 +2426,14 @@ Status AutoMixedPrecision::Optimize(Cluster* cluster, const GrapplerItem& item,
                  << " graph optimizer";
     return OkStatus();
   }
+  if (mode_ == AutoMixedPrecisionMode::MKL && !ShouldIgnorePerformance() &&
+      GetCpuBf16Isa() == CpuBf16Isa::kNone) {
+    // Without native bfloat16 support, the casts only slow the graph down.
+    LOG(WARNING) << "No CPU support for AVX512_BF16 or AMX_BF16 detected, "
+                    "skipping "
+                 << name() << " graph optimizer";
+    return OkStatus();
+  }
 
   // Optimize the output graph in-place.
   AutoMixedPrecisionImpl optimizer(cluster, item.NodesToPreserve(), output,
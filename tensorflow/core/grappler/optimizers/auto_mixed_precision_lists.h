@@ -359,7 +359,10 @@ class AutoMixedPrecisionListsCuda : public AutoMixedPrecisionLists {
 
 class AutoMixedPrecisionListsMkl : public AutoMixedPrecisionLists {
  public:
-  AutoMixedPrecisionListsMkl() {}
+  // `has_amx` tells whether the CPU computes bfloat16 matrix multiplications on
+  // AMX tiles; otherwise only AVX512_BF16 dot products are assumed.
+  explicit AutoMixedPrecisionListsMkl(bool has_amx = true)
+      : has_amx_(has_amx) {}
 
   // Only ops which are supported by MKL in bfloat16 should be added to the
   // allow list, infer list, or clear list.
@@ -425,6 +428,18 @@ class AutoMixedPrecisionListsMkl : public AutoMixedPrecisionLists {
                                      "Sqrt",
                                      "Tanh",
                                      "TanhGrad"};
+    if (!has_amx_) {
+      // Without AMX, the speedup of the allowlist ops is too small to also pay
+      // for running the element-wise ops that oneDNN does not fuse into them
+      // in bfloat16, so those stay in float32.
+      for (const char* op :
+           {"Elu", "EluGrad", "FloorDiv", "Log", "Log1p", "LogSoftmax", "Prod",
+            "RealDiv", "Reciprocal", "Selu", "SeluGrad", "Sigmoid",
+            "SigmoidGrad", "Softmax", "Softplus", "SoftplusGrad", "Softsign",
+            "SoftsignGrad", "Sqrt", "Tanh", "TanhGrad"}) {
+        list.erase(op);
+      }
+    }
     UpdateList("INFERLIST", &list);
     // For backwards compatibility, keeping the original env variable here.
     // TODO(reedwm): This should be removed if we don't have active users.
@@ -549,6 +564,9 @@ class AutoMixedPrecisionListsMkl : public AutoMixedPrecisionLists {
     UpdateList("CLEARLIST", &list);
     return list;
   }
+
+ private:
+  bool has_amx_;
 };
 
 }  // end namespace grappler
@@ -31,6 +31,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/clusters/virtual_cluster.h"
 #include "tensorflow/core/grappler/devices.h"
 #include "tensorflow/core/grappler/graph_view.h"
+#include "tensorflow/core/grappler/optimizers/auto_mixed_precision_lists.h"
 #include "tensorflow/core/grappler/utils/grappler_test.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/random/random.h"
@@ -1450,6 +1451,10 @@ TEST_F(AutoMixedPrecisionSimulateGpuTest, Simple_SimulatedGpu_CpuScope) {
 class AutoMixedPrecisionMklTest : public GrapplerTest {
  protected:
   void SetUp() override {
+    // The test graphs are too small for bfloat16 to pay off, and the host
+    // may not support bfloat16 natively.
+    setenv("TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_IGNORE_PERFORMANCE", "true",
+           1 /* replace */);
     virtual_cluster_.reset(new SingleMachine(/* timeout_s = */ 10, 1, 0));
     TF_CHECK_OK(virtual_cluster_->Provision());
   }
@@ -1707,6 +1712,18 @@ TEST_F(AutoMixedPrecisionMklTest, InferFollowUpStreamDeny) {
     test::ExpectClose(tensors_expected[i], tensors[i]);
   }
 }
+
+TEST(AutoMixedPrecisionListsMklTest, InferListWithoutAmx) {
+  AutoMixedPrecisionListsMkl amx_lists(/*has_amx=*/true);
+  AutoMixedPrecisionListsMkl avx512_lists(/*has_amx=*/false);
+  const auto amx_infer = amx_lists.InferList();
+  const auto avx512_infer = avx512_lists.InferList();
+  EXPECT_EQ(amx_lists.AllowList(), avx512_lists.AllowList());
+  EXPECT_TRUE(amx_infer.count("Tanh"));
+  EXPECT_FALSE(avx512_infer.count("Tanh"));
+  EXPECT_TRUE(avx512_infer.count("BiasAdd"));
+  EXPECT_TRUE(avx512_infer.count("AddV2"));
+}
 #endif  // INTEL_MKL
 
 }  // namespace
@@ -71,6 +71,8 @@ const ConfigList& DefaultPluginConfigs() {
                       {"remapping", RewriterConfig::ON},
                       {"loop_optimization", RewriterConfig::ON},
                       {"dependency_optimization", RewriterConfig::ON},
+                      {"horizontal_fusion", RewriterConfig::ON},
+                      {"int8_quantization", RewriterConfig::ON},
                       {"auto_parallel", RewriterConfig::ON},
                       {"memory_optimization", RewriterConfig::ON},
                       {"scoped_allocator_optimization", RewriterConfig::ON}});
@@ -0,0 +1,238 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/map_vectorization.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/match.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/mutable_graph_view.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/grappler/utils.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr char kMapDataset[] = "MapDataset";
+constexpr char kParallelMapDataset[] = "ParallelMapDataset";
+constexpr char kParallelMapDatasetV2[] = "ParallelMapDatasetV2";
+
+// Element-wise ops with one input, which compute each output value from the
+// input value at the same position.
+const auto* kUnaryOps = new absl::flat_hash_set<string>(
+    {"Abs", "Cast", "Ceil", "Cos", "Erf", "Exp", "Expm1", "Floor", "Identity",
+     "IsFinite", "IsInf", "IsNan", "Log", "Log1p", "LogicalNot", "Neg",
+     "Reciprocal", "Relu", "Relu6", "Round", "Rsqrt", "Sigmoid", "Sign", "Sin",
+     "Sqrt", "Square", "Tanh"});
+
+// Element-wise ops with two inputs of the same shape, or one scalar input.
+const auto* kBinaryOps = new absl::flat_hash_set<string>(
+    {"Add", "AddV2", "Div", "DivNoNan", "Equal", "FloorDiv", "FloorMod",
+     "Greater", "GreaterEqual", "Less", "LessEqual", "LogicalAnd", "LogicalOr",
+     "Maximum", "Minimum", "Mul", "NotEqual", "Pow", "RealDiv",
+     "SquaredDifference", "Sub", "TruncateDiv"});
+
+// The values of tensors in the function body that are not computed from an
+// argument.
+constexpr int kScalarConstant = -1;
+constexpr int kNotVectorizable = -2;
+
+bool IsMap(const NodeDef& node) {
+  return node.op() == kMapDataset || node.op() == kParallelMapDataset ||
+         node.op() == kParallelMapDatasetV2;
+}
+
+bool IsScalarConst(const NodeDef& node) {
+  if (node.op() != "Const" || node.input_size() != 0) return false;
+  const AttrValue* value = gtl::FindOrNull(node.attr(), "value");
+  return value != nullptr && value->has_tensor() &&
+         value->tensor().tensor_shape().dim_size() == 0;
+}
+
+// Returns the name of the function argument or node that produces `input`,
+// which is either an argument name or has the form "node:output:index".
+string InputName(const string& input) {
+  return input.substr(0, input.find(':'));
+}
+
+NodeDef MakeBatchNode(const NodeDef& batch_node, const NodeDef& map_node,
+                      const DataTypeVector& input_types,
+                      MutableGraphView* graph) {
+  NodeDef new_batch = batch_node;
+  graph_utils::SetUniqueGraphNodeName(batch_node.op(), graph->graph(),
+                                      &new_batch);
+  new_batch.set_input(0, map_node.input(0));
+  // The batched elements have the types of the input elements. Their shapes
+  // are left unknown, since they are only known to the map function.
+  AttrValue types;
+  AttrValue shapes;
+  for (DataType type : input_types) {
+    types.mutable_list()->add_type(type);
+    PartialTensorShape().AsProto(shapes.mutable_list()->add_shape());
+  }
+  (*new_batch.mutable_attr())["output_types"] = types;
+  (*new_batch.mutable_attr())["output_shapes"] = shapes;
+  return new_batch;
+}
+
+NodeDef MakeMapNode(const NodeDef& map_node, const NodeDef& batch_node,
+                    const NodeDef& new_batch, MutableGraphView* graph) {
+  NodeDef new_map = map_node;
+  graph_utils::SetUniqueGraphNodeName(map_node.op(), graph->graph(), &new_map);
+  new_map.set_input(0, new_batch.name());
+  graph_utils::CopyShapesAndTypesAttrs(batch_node, &new_map);
+  return new_map;
+}
+
+}  // namespace
+
+bool IsFunctionVectorizable(const FunctionDef& function) {
+  // Maps each argument and node to the index of the argument that it is
+  // computed from, or to `kScalarConstant`. All values computed from the same
+  // argument with element-wise ops have the shape of that argument.
+  absl::flat_hash_map<string, int> values;
+  const auto& args = function.signature().input_arg();
+  for (int i = 0; i < args.size(); ++i) {
+    values[args[i].name()] = i;
+  }
+  const auto value_of = [&values](const string& input) {
+    if (absl::StartsWith(input, "^")) return kNotVectorizable;
+    auto it = values.find(InputName(input));
+    return it == values.end() ? kNotVectorizable : it->second;
+  };
+
+  // The nodes are not necessarily topologically sorted, so visit them once all
+  // of their inputs have been visited.
+  std::vector<const NodeDef*> pending;
+  for (const NodeDef& node : function.node_def()) {
+    const bool unary = kUnaryOps->contains(node.op()) && node.input_size() == 1;
+    const bool binary =
+        kBinaryOps->contains(node.op()) && node.input_size() == 2;
+    if (!IsScalarConst(node) && !unary && !binary) {
+      VLOG(2) << "Function " << function.signature().name()
+              << " is not vectorizable because of node " << node.name();
+      return false;
+    }
+    pending.push_back(&node);
+  }
+  while (!pending.empty()) {
+    std::vector<const NodeDef*> next;
+    for (const NodeDef* node : pending) {
+      std::vector<int> inputs;
+      for (const string& input : node->input()) {
+        if (values.contains(InputName(input))) {
+          inputs.push_back(value_of(input));
+        }
+      }
+      if (inputs.size() < static_cast<size_t>(node->input_size())) {
+        next.push_back(node);
+        continue;
+      }
+      int value = kScalarConstant;
+      for (int input : inputs) {
+        if (input == kNotVectorizable ||
+            (value != kScalarConstant && input != kScalarConstant &&
+             input != value)) {
+          // A control input, or operands computed from different arguments,
+          // which may have different shapes.
+          return false;
+        }
+        if (input != kScalarConstant) value = input;
+      }
+      values[node->name()] = value;
+    }
+    if (next.size() == pending.size()) {
+      // The remaining nodes have inputs that are not produced by any node.
+      return false;
+    }
+    pending = std::move(next);
+  }
+
+  // The outputs must have the batch dimension, so they cannot be constants.
+  for (const auto& ret : function.ret()) {
+    const int value = value_of(ret.second);
+    if (value == kNotVectorizable || value == kScalarConstant) return false;
+  }
+  return true;
+}
+
+Status MapVectorization::OptimizeAndCollectStats(Cluster* cluster,
+                                                 const GrapplerItem& item,
+                                                 GraphDef* output,
+                                                 OptimizationStats* stats) {
+  *output = item.graph;
+  MutableGraphView graph(output);
+  absl::flat_hash_set<string> nodes_to_delete;
+  FunctionLibraryDefinition function_library(OpRegistry::Global(),
+                                             item.graph.library());
+  for (const NodeDef& node : item.graph.node()) {
+    if (node.op() != "BatchDataset" && node.op() != "BatchDatasetV2") {
+      continue;
+    }
+    const NodeDef& batch_node = node;
+    NodeDef* map_node = graph_utils::GetInputNode(batch_node, graph);
+    if (map_node == nullptr || !IsMap(*map_node) ||
+        nodes_to_delete.contains(map_node->name())) {
+      continue;
+    }
+    // Captured inputs are not batched, so functions with captured inputs are
+    // not vectorized. The map must also feed only the batch, since it is
+    // removed.
+    const AttrValue* captured_types =
+        gtl::FindOrNull(map_node->attr(), "Targuments");
+    if (captured_types == nullptr || captured_types->list().type_size() > 0 ||
+        graph.GetFanouts(*map_node, /*include_controlled_nodes=*/true).size() !=
+            1) {
+      continue;
+    }
+    const FunctionDef* function =
+        function_library.Find(map_node->attr().at("f").func().name());
+    if (function == nullptr || !IsFunctionVectorizable(*function)) {
+      continue;
+    }
+    NodeDef* input_node = graph_utils::GetInputNode(*map_node, graph);
+    DataTypeVector input_types;
+    if (input_node == nullptr ||
+        !graph_utils::GetDatasetOutputTypesAttr(*input_node, &input_types)
+             .ok() ||
+        input_types.size() != function->signature().input_arg_size()) {
+      continue;
+    }
+
+    NodeDef* new_batch = graph.AddNode(
+        MakeBatchNode(batch_node, *map_node, input_types, &graph));
+    NodeDef* new_map = graph.AddNode(
+        MakeMapNode(*map_node, batch_node, *new_batch, &graph));
+    TF_RETURN_IF_ERROR(graph.UpdateFanouts(batch_node.name(), new_map->name()));
+    nodes_to_delete.insert(map_node->name());
+    nodes_to_delete.insert(batch_node.name());
+    stats->num_changes++;
+  }
+
+  TF_RETURN_IF_ERROR(graph.DeleteNodes(nodes_to_delete));
+  return OkStatus();
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(MapVectorization, "map_vectorization");
+
+}  // namespace grappler
+}  // namespace tensorflow
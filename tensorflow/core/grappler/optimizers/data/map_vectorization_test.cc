@@ -0,0 +1,114 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/map_vectorization.h"
+
+#include "tensorflow/core/framework/attr_value_util.h"
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_test_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+using graph_tests_utils::MakeBatchV2Node;
+using graph_tests_utils::MakeMapNode;
+using graph_tests_utils::MakeParallelMapV2Node;
+using test::function::NDef;
+
+GrapplerItem MakeMapBatchItem(const NodeDef& map_node) {
+  GrapplerItem item;
+  item.graph = test::function::GDef(
+      {NDef("start", "Const", {}, {{"value", 0}, {"dtype", DT_INT64}}),
+       NDef("stop", "Const", {}, {{"value", 10}, {"dtype", DT_INT64}}),
+       NDef("step", "Const", {}, {{"value", 1}, {"dtype", DT_INT64}}),
+       NDef("range", "RangeDataset", {"start", "stop", "step"},
+            {{"output_shapes", gtl::ArraySlice<TensorShape>{{}}},
+             {"output_types", gtl::ArraySlice<DataType>{DT_INT64}}}),
+       NDef("num_parallel_calls", "Const", {},
+            {{"value", 2}, {"dtype", DT_INT64}}),
+       map_node,
+       NDef("batch_size", "Const", {}, {{"value", 4}, {"dtype", DT_INT64}}),
+       NDef("drop_remainder", "Const", {},
+            {{"value", false}, {"dtype", DT_BOOL}}),
+       MakeBatchV2Node("batch", "map", "batch_size", "drop_remainder",
+                       /*parallel_copy=*/false),
+       NDef("Sink", "Identity", {"batch"}, {})},
+      // FunctionLib
+      {test::function::XTimesTwo(), test::function::XAddY(),
+       test::function::RandomUniform()});
+  item.fetch.push_back("Sink");
+  return item;
+}
+
+TEST(MapVectorizationTest, VectorizeMap) {
+  for (const NodeDef& map_node :
+       {MakeMapNode("map", "range", "XTimesTwo"),
+        MakeParallelMapV2Node("map", "range", "num_parallel_calls",
+                              "XTimesTwo", "default")}) {
+    GrapplerItem item = MakeMapBatchItem(map_node);
+    MapVectorization optimizer;
+    GraphDef output;
+    TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+    EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("map", output));
+    EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("batch", output));
+    const NodeDef& new_batch = output.node(
+        graph_utils::FindGraphNodeWithOp("BatchDatasetV2", output));
+    const NodeDef& new_map =
+        output.node(graph_utils::FindGraphNodeWithOp(map_node.op(), output));
+    const NodeDef& sink =
+        output.node(graph_utils::FindGraphNodeWithName("Sink", output));
+    EXPECT_EQ(new_batch.input(0), "range");
+    EXPECT_EQ(new_batch.input(1), "batch_size");
+    EXPECT_EQ(new_batch.attr().at("output_types").list().type(0), DT_INT64);
+    EXPECT_EQ(new_map.input(0), new_batch.name());
+    EXPECT_EQ(sink.input(0), new_map.name());
+    EXPECT_TRUE(AreAttrValuesEqual(new_map.attr().at("f"),
+                                   map_node.attr().at("f")));
+  }
+}
+
+TEST(MapVectorizationTest, FunctionNotVectorizable) {
+  for (const string& function_name : {"XAddY", "RandomUniformFn"}) {
+    GrapplerItem item =
+        MakeMapBatchItem(MakeMapNode("map", "range", function_name));
+    MapVectorization optimizer;
+    GraphDef output;
+    TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+    EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("map", output));
+    EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("batch", output));
+  }
+}
+
+TEST(MapVectorizationTest, IsFunctionVectorizable) {
+  EXPECT_TRUE(IsFunctionVectorizable(test::function::XTimesTwo()));
+  EXPECT_TRUE(IsFunctionVectorizable(test::function::XAddX()));
+  EXPECT_TRUE(IsFunctionVectorizable(test::function::NonZero()));
+  // The arguments may have different shapes.
+  EXPECT_FALSE(IsFunctionVectorizable(test::function::XAddY()));
+  // Function calls and ops that are not element-wise are not vectorized.
+  EXPECT_FALSE(IsFunctionVectorizable(test::function::XTimesFour()));
+  EXPECT_FALSE(IsFunctionVectorizable(test::function::RandomUniform()));
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
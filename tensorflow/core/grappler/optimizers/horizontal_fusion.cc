@@ -0,0 +1,202 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/horizontal_fusion.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <unordered_set>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/costs/graph_properties.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/frame.h"
+#include "tensorflow/core/grappler/utils/topological_sort.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr char kFusedOp[] = "_MultiTensorBinaryOp";
+constexpr char kPrefix[] = "HorizontalFusion";
+
+// Only tensors up to this size are fused: for larger tensors the kernel launch
+// overhead is negligible compared to the computation.
+constexpr int64_t kMaxNumElements = 1 << 16;
+// Upper bound on the number of nodes packed into one fused node.
+constexpr int kMaxGroupSize = 128;
+
+bool IsSupportedBinaryOp(const NodeDef& node) {
+  static const auto* const kOps = new absl::flat_hash_set<string>(
+      {"AddV2", "Sub", "Mul", "RealDiv", "Maximum", "Minimum"});
+  return kOps->contains(node.op());
+}
+
+bool IsSupportedType(DataType dtype) {
+  return dtype == DT_HALF || dtype == DT_BFLOAT16 || dtype == DT_FLOAT ||
+         dtype == DT_DOUBLE;
+}
+
+// Returns true if the inputs of `node` have static shapes that the fused
+// kernel supports without broadcasting: equal shapes, or a scalar on one side.
+bool HasSupportedShapes(const NodeDef& node,
+                        const GraphProperties& properties) {
+  const auto& inputs = properties.GetInputProperties(node.name());
+  if (inputs.size() != 2) return false;
+  const PartialTensorShape x(inputs[0].shape());
+  const PartialTensorShape y(inputs[1].shape());
+  if (!x.IsFullyDefined() || !y.IsFullyDefined()) return false;
+  if (!x.IsIdenticalTo(y) && x.dims() != 0 && y.dims() != 0) return false;
+  return std::max(x.num_elements(), y.num_elements()) <= kMaxNumElements;
+}
+
+// Returns true if the fused kernel is available on the device `node` runs on.
+// Only a CPU kernel is registered, so unplaced nodes are only fused when the
+// cluster has no GPU they could otherwise be placed on.
+bool IsOnSupportedDevice(const NodeDef& node, const Cluster* cluster) {
+  if (NodeIsOnCpu(&node)) return true;
+  if (!node.device().empty()) return false;
+  if (cluster == nullptr) return true;
+  for (const auto& device : cluster->GetDevices()) {
+    if (device.second.type() != "CPU") return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+Status HorizontalFusion::Optimize(Cluster* cluster, const GrapplerItem& item,
+                                  GraphDef* output) {
+  const std::unordered_set<string> nodes_to_preserve = item.NodesToPreserve();
+  std::vector<const NodeDef*> candidates;
+  for (const NodeDef& node : item.graph.node()) {
+    if (IsSupportedBinaryOp(node) && !HasControlInputs(node) &&
+        IsSupportedType(GetDataTypeFromAttr(node, "T")) &&
+        nodes_to_preserve.find(node.name()) == nodes_to_preserve.end() &&
+        IsOnSupportedDevice(node, cluster)) {
+      candidates.push_back(&node);
+    }
+  }
+  if (candidates.size() < 2) {
+    return errors::Aborted("Nothing to do.");
+  }
+
+  GraphProperties properties(item);
+  TF_RETURN_IF_ERROR(properties.InferStatically(
+      /*assume_valid_feeds=*/false,
+      /*aggressive_shape_inference=*/false,
+      /*include_tensor_values=*/false));
+  // Nodes inside while loops are left alone: fusing them could delay the loop
+  // iterations on each other.
+  FrameView frames;
+  TF_RETURN_IF_ERROR(frames.InferFromGraph(item.graph));
+
+  // Two nodes at the same depth (the length of the longest path from a source
+  // node) cannot depend on each other, so they can be computed together.
+  std::vector<const NodeDef*> topo_order;
+  TF_RETURN_IF_ERROR(ComputeTopologicalOrder(item.graph, &topo_order));
+  absl::flat_hash_map<string, int> depth;
+  for (const NodeDef* node : topo_order) {
+    int node_depth = 0;
+    for (const string& input : node->input()) {
+      auto it = depth.find(NodeName(input));
+      if (it != depth.end()) node_depth = std::max(node_depth, it->second + 1);
+    }
+    depth[node->name()] = node_depth;
+  }
+
+  // Groups are keyed by everything that must match for nodes to be fused, and
+  // kept in graph order so that the rewrite is deterministic.
+  std::map<string, std::vector<const NodeDef*>> groups;
+  for (const NodeDef* node : candidates) {
+    if (frames.IsInFrame(*node) || !HasSupportedShapes(*node, properties)) {
+      continue;
+    }
+    const string key = absl::StrCat(
+        node->op(), "|", DataTypeString(GetDataTypeFromAttr(*node, "T")), "|",
+        node->device(), "|", depth[node->name()]);
+    groups[key].push_back(node);
+  }
+
+  *output = item.graph;
+  NodeMap node_map(output);
+  // Maps each original node to the output of the fused node replacing it.
+  absl::flat_hash_map<string, string> fused_outputs;
+  std::set<string> nodes_to_delete;
+  for (const auto& group : groups) {
+    const std::vector<const NodeDef*>& nodes = group.second;
+    for (int begin = 0; begin + 1 < nodes.size(); begin += kMaxGroupSize) {
+      const int end = std::min<int>(begin + kMaxGroupSize, nodes.size());
+      const NodeDef& first = *nodes[begin];
+      const string fused_name = AddPrefixToNodeName(first.name(), kPrefix);
+      if (node_map.NodeExists(fused_name)) continue;
+
+      NodeDef* fused = output->add_node();
+      fused->set_name(fused_name);
+      fused->set_op(kFusedOp);
+      fused->set_device(first.device());
+      for (int operand = 0; operand < 2; ++operand) {
+        for (int i = begin; i < end; ++i) {
+          fused->add_input(nodes[i]->input(operand));
+        }
+      }
+      (*fused->mutable_attr())["T"] = first.attr().at("T");
+      (*fused->mutable_attr())["N"].set_i(end - begin);
+      (*fused->mutable_attr())["binary_op"].set_s(first.op());
+      for (int i = begin; i < end; ++i) {
+        fused_outputs[nodes[i]->name()] =
+            absl::StrCat(fused_name, ":", i - begin);
+        nodes_to_delete.insert(nodes[i]->name());
+      }
+      VLOG(2) << "Fused " << end - begin << " " << first.op()
+              << " nodes into " << fused_name;
+    }
+  }
+  if (nodes_to_delete.empty()) {
+    return errors::Aborted("Nothing to do.");
+  }
+
+  // The fused nodes only have one output, so every regular fanin refers to
+  // port 0. Control dependencies move to the fused node.
+  for (NodeDef& node : *output->mutable_node()) {
+    bool updated_control_input = false;
+    for (string& input : *node.mutable_input()) {
+      const TensorId tensor = ParseTensorName(input);
+      auto it = fused_outputs.find(tensor.node());
+      if (it == fused_outputs.end()) continue;
+      if (IsControlInput(tensor)) {
+        input = AsControlDependency(NodeName(it->second));
+        updated_control_input = true;
+      } else {
+        input = it->second;
+      }
+    }
+    if (updated_control_input) DedupControlInputs(&node);
+  }
+  EraseNodesFromGraph(nodes_to_delete, output);
+  return OkStatus();
+}
+
+}  // end namespace grappler
+}  // end namespace tensorflow
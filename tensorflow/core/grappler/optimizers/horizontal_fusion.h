@@ -0,0 +1,44 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_HORIZONTAL_FUSION_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_HORIZONTAL_FUSION_H_
+
+#include "tensorflow/core/grappler/optimizers/graph_optimizer.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// HorizontalFusion packs independent small pointwise binary ops (e.g. the
+// per-variable Mul and AddV2 nodes of an optimizer update) that have the same
+// op, type, device and topological depth into a single _MultiTensorBinaryOp
+// node, so that they are computed by one kernel instead of many tiny ones.
+class HorizontalFusion : public GraphOptimizer {
+ public:
+  HorizontalFusion() {}
+  ~HorizontalFusion() override {}
+
+  string name() const override { return "horizontal_fusion"; };
+
+  bool UsesFunctionLibrary() const override { return false; }
+
+  Status Optimize(Cluster* cluster, const GrapplerItem& item,
+                  GraphDef* output) override;
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_HORIZONTAL_FUSION_H_
@@ -0,0 +1,122 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/horizontal_fusion.h"
+
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/utils/grappler_test.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+class HorizontalFusionTest : public GrapplerTest {};
+
+TEST_F(HorizontalFusionTest, NothingToFuse) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output x = ops::Placeholder(s, DT_FLOAT, ops::Placeholder::Shape({2}));
+  Output y = ops::Placeholder(s, DT_FLOAT, ops::Placeholder::Shape({2}));
+  Output mul = ops::Mul(s, x, y);
+  Output result = ops::Identity(s, mul);
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  HorizontalFusion optimizer;
+  GraphDef output;
+  EXPECT_EQ(optimizer.Optimize(nullptr, item, &output),
+            errors::Aborted("Nothing to do."));
+}
+
+TEST_F(HorizontalFusionTest, FuseIndependentBinaryOps) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output a = ops::Placeholder(s.WithOpName("a"), DT_FLOAT,
+                              ops::Placeholder::Shape({2}));
+  Output b = ops::Placeholder(s.WithOpName("b"), DT_FLOAT,
+                              ops::Placeholder::Shape({2}));
+  Output c = ops::Placeholder(s.WithOpName("c"), DT_FLOAT,
+                              ops::Placeholder::Shape({3}));
+  Output scale = ops::Const(s.WithOpName("scale"), 0.5f, {});
+  Output mul_ab = ops::Mul(s.WithOpName("mul_ab"), a, b);
+  Output mul_c = ops::Mul(s.WithOpName("mul_c"), scale, c);
+  // Depends on mul_ab, so it can't be fused with it.
+  Output mul_chained = ops::Mul(s.WithOpName("mul_chained"), mul_ab, a);
+  // Different op.
+  Output add = ops::AddV2(s.WithOpName("add"), a, b);
+  Output out_ab = ops::Identity(s.WithOpName("out_ab"), mul_ab);
+  Output out_c = ops::Identity(s.WithOpName("out_c"), mul_c);
+  Output out_chained = ops::Identity(s.WithOpName("out_chained"), mul_chained);
+  Output out_add = ops::Identity(s.WithOpName("out_add"), add);
+
+  GrapplerItem item;
+  item.fetch = {"out_ab", "out_c", "out_chained", "out_add"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  HorizontalFusion optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "mul_ab");
+    EXPECT_NE(node.name(), "mul_c");
+    if (node.name() == "HorizontalFusion/mul_ab") {
+      ++found;
+      EXPECT_EQ(node.op(), "_MultiTensorBinaryOp");
+      EXPECT_EQ(node.attr().at("binary_op").s(), "Mul");
+      EXPECT_EQ(node.attr().at("N").i(), 2);
+      ASSERT_EQ(node.input_size(), 4);
+      EXPECT_EQ(node.input(0), "a");
+      EXPECT_EQ(node.input(1), "scale");
+      EXPECT_EQ(node.input(2), "b");
+      EXPECT_EQ(node.input(3), "c");
+    } else if (node.name() == "out_ab") {
+      ++found;
+      EXPECT_EQ(node.input(0), "HorizontalFusion/mul_ab:0");
+    } else if (node.name() == "out_c") {
+      ++found;
+      EXPECT_EQ(node.input(0), "HorizontalFusion/mul_ab:1");
+    } else if (node.name() == "mul_chained") {
+      ++found;
+      EXPECT_EQ(node.op(), "Mul");
+      EXPECT_EQ(node.input(0), "HorizontalFusion/mul_ab:0");
+    } else if (node.name() == "add") {
+      ++found;
+      EXPECT_EQ(node.op(), "AddV2");
+    }
+  }
+  EXPECT_EQ(found, 5);
+
+  auto a_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({2}));
+  auto b_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({2}));
+  auto c_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({3}));
+  std::vector<std::pair<string, Tensor>> feed = {
+      {"a", a_t}, {"b", b_t}, {"c", c_t}};
+  auto expected = EvaluateNodes(item.graph, item.fetch, feed);
+  auto actual = EvaluateNodes(output, item.fetch, feed);
+  ASSERT_EQ(expected.size(), 4);
+  ASSERT_EQ(actual.size(), 4);
+  for (int i = 0; i < 4; ++i) {
+    test::ExpectTensorNear<float>(expected[i], actual[i], 1e-6);
+  }
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
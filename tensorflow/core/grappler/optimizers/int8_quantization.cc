@@ -0,0 +1,311 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/int8_quantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/op_types.h"
+#include "tensorflow/core/grappler/utils.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr char kQuantizedOp[] = "QuantizedMatMulWithBiasAndDequantize";
+constexpr char kPrefix[] = "Int8Quantization";
+constexpr char kCalibrationRangeAttr[] = "_int8_calibration_range";
+
+// Smaller MatMuls are left in float: the cost of quantizing their inputs
+// outweighs the speedup of the int8 kernel.
+constexpr int64_t kMinNumWeights = 1 << 12;
+
+// A MatMul to quantize, and the BiasAdd that it's fused with, if any.
+struct QuantizationCandidate {
+  NodeDef* matmul = nullptr;
+  NodeDef* bias_add = nullptr;
+};
+
+bool IsFloatConstant(const NodeDef* node) {
+  return node != nullptr && IsConstant(*node) && !HasControlInputs(*node) &&
+         GetDataTypeFromAttr(*node, "dtype") == DT_FLOAT;
+}
+
+bool GetConstantTensor(const NodeDef& node, Tensor* tensor) {
+  return node.attr().count("value") &&
+         tensor->FromProto(node.attr().at("value").tensor());
+}
+
+// Returns true if `node` runs on the CPU. Unplaced nodes are only quantized
+// when the cluster has no other devices they could be placed on.
+bool IsOnCpu(const NodeDef& node, const Cluster* cluster) {
+  if (NodeIsOnCpu(&node)) return true;
+  if (!node.device().empty()) return false;
+  if (cluster == nullptr) return true;
+  for (const auto& device : cluster->GetDevices()) {
+    if (device.second.type() != "CPU") return false;
+  }
+  return true;
+}
+
+bool IsQuantizableMatMul(const NodeDef& node, const NodeMap& node_map,
+                         const Cluster* cluster) {
+  if (node.op() != "MatMul" || HasControlInputs(node) ||
+      GetDataTypeFromAttr(node, "T") != DT_FLOAT || !IsOnCpu(node, cluster)) {
+    return false;
+  }
+  // The quantized kernel doesn't support transposed operands.
+  for (const char* attr : {"transpose_a", "transpose_b"}) {
+    if (node.attr().count(attr) && node.attr().at(attr).b()) return false;
+  }
+  const NodeDef* weights = node_map.GetNode(node.input(1));
+  if (!IsFloatConstant(weights) || !weights->attr().count("value")) {
+    return false;
+  }
+  const TensorShape shape(weights->attr().at("value").tensor().tensor_shape());
+  return shape.dims() == 2 && shape.num_elements() >= kMinNumWeights;
+}
+
+// Returns the BiasAdd with a constant bias that is the only consumer of
+// `matmul`, or nullptr if there is none.
+NodeDef* GetFusableBiasAdd(const NodeDef& matmul, const NodeMap& node_map,
+                           const std::unordered_set<string>& preserve) {
+  if (preserve.count(matmul.name())) return nullptr;
+  const auto& fanouts = node_map.GetOutputs(matmul.name());
+  if (fanouts.size() != 1) return nullptr;
+  NodeDef* bias_add = *fanouts.begin();
+  if (bias_add->op() != "BiasAdd" || HasControlInputs(*bias_add) ||
+      bias_add->input(0) != matmul.name() ||
+      bias_add->device() != matmul.device()) {
+    return nullptr;
+  }
+  if (bias_add->attr().count("data_format") &&
+      bias_add->attr().at("data_format").s() != "NHWC") {
+    return nullptr;
+  }
+  return IsFloatConstant(node_map.GetNode(bias_add->input(1))) ? bias_add
+                                                                : nullptr;
+}
+
+NodeDef* AddConstNode(const string& name, const string& device,
+                      const Tensor& value, GraphDef* graph) {
+  NodeDef* node = graph->add_node();
+  node->set_name(name);
+  node->set_op("Const");
+  node->set_device(device);
+  (*node->mutable_attr())["dtype"].set_type(value.dtype());
+  value.AsProtoTensorContent(
+      (*node->mutable_attr())["value"].mutable_tensor());
+  return node;
+}
+
+NodeDef* AddScalarConstNode(const string& name, const string& device,
+                            float value, GraphDef* graph) {
+  Tensor tensor(DT_FLOAT, TensorShape({}));
+  tensor.scalar<float>()() = value;
+  return AddConstNode(name, device, tensor, graph);
+}
+
+// Quantizes `weights` symmetrically to qint8, and returns the range that the
+// quantized values represent.
+Tensor QuantizeWeights(const Tensor& weights, float* min, float* max) {
+  const auto values = weights.flat<float>();
+  float max_abs = 0.0f;
+  for (int64_t i = 0; i < values.size(); ++i) {
+    max_abs = std::max(max_abs, std::abs(values(i)));
+  }
+  if (max_abs == 0.0f) max_abs = 1.0f;
+  const float scale = 127.0f / max_abs;
+
+  Tensor quantized(DT_QINT8, weights.shape());
+  auto quantized_values = quantized.flat<qint8>();
+  for (int64_t i = 0; i < values.size(); ++i) {
+    const float value = std::round(values(i) * scale);
+    quantized_values(i) = static_cast<int8>(
+        std::min(127.0f, std::max(-127.0f, value)));
+  }
+  *min = -max_abs;
+  *max = max_abs;
+  return quantized;
+}
+
+// Adds the nodes computing the range over which the input `x` of `matmul` is
+// quantized, and sets `min` and `max` to their outputs.
+void AddInputRange(const NodeDef& matmul, const string& prefix,
+                   GraphDef* graph, string* min, string* max) {
+  const string& device = matmul.device();
+  const auto& attr = matmul.attr();
+  if (attr.count(kCalibrationRangeAttr) &&
+      attr.at(kCalibrationRangeAttr).list().f_size() == 2) {
+    const auto& range = attr.at(kCalibrationRangeAttr).list().f();
+    *min = AddScalarConstNode(absl::StrCat(prefix, "/input_min"), device,
+                              range[0], graph)
+               ->name();
+    *max = AddScalarConstNode(absl::StrCat(prefix, "/input_max"), device,
+                              range[1], graph)
+               ->name();
+    return;
+  }
+
+  // Without calibration, each batch is quantized over its own range.
+  Tensor axes(DT_INT32, TensorShape({2}));
+  axes.flat<int32>()(0) = 0;
+  axes.flat<int32>()(1) = 1;
+  const string axes_name =
+      AddConstNode(absl::StrCat(prefix, "/input_axes"), device, axes, graph)
+          ->name();
+  for (const auto& reduction : {std::make_pair("Min", min),
+                                std::make_pair("Max", max)}) {
+    NodeDef* node = graph->add_node();
+    node->set_name(absl::StrCat(prefix, "/input_", reduction.first));
+    node->set_op(reduction.first);
+    node->set_device(device);
+    node->add_input(matmul.input(0));
+    node->add_input(axes_name);
+    (*node->mutable_attr())["T"].set_type(DT_FLOAT);
+    (*node->mutable_attr())["Tidx"].set_type(DT_INT32);
+    (*node->mutable_attr())["keep_dims"].set_b(false);
+    *reduction.second = node->name();
+  }
+}
+
+}  // namespace
+
+Status Int8Quantization::Optimize(Cluster* cluster, const GrapplerItem& item,
+                                  GraphDef* output) {
+  const std::unordered_set<string> nodes_to_preserve = item.NodesToPreserve();
+  *output = item.graph;
+  NodeMap node_map(output);
+
+  std::vector<QuantizationCandidate> candidates;
+  for (NodeDef& node : *output->mutable_node()) {
+    if (!IsQuantizableMatMul(node, node_map, cluster)) continue;
+    QuantizationCandidate candidate;
+    candidate.matmul = &node;
+    candidate.bias_add = GetFusableBiasAdd(node, node_map, nodes_to_preserve);
+    candidates.push_back(candidate);
+  }
+  if (candidates.empty()) {
+    return errors::Aborted("Nothing to do.");
+  }
+
+  std::set<string> nodes_to_delete;
+  int num_quantized = 0;
+  for (const QuantizationCandidate& candidate : candidates) {
+    const NodeDef& matmul = *candidate.matmul;
+    // The quantized node replaces the last node of the pattern, so that its
+    // consumers are unchanged.
+    NodeDef* replaced =
+        candidate.bias_add != nullptr ? candidate.bias_add : candidate.matmul;
+    const string prefix = AddPrefixToNodeName(replaced->name(), kPrefix);
+    if (node_map.NodeExists(prefix)) continue;
+    const string device = matmul.device();
+
+    const NodeDef* weights_node = node_map.GetNode(matmul.input(1));
+    Tensor weights;
+    if (!GetConstantTensor(*weights_node, &weights)) continue;
+    float min_weights, max_weights;
+    const Tensor quantized_weights =
+        QuantizeWeights(weights, &min_weights, &max_weights);
+    const string b =
+        AddConstNode(absl::StrCat(prefix, "/weights"), device,
+                     quantized_weights, output)
+            ->name();
+    const string min_b =
+        AddScalarConstNode(absl::StrCat(prefix, "/weights_min"), device,
+                           min_weights, output)
+            ->name();
+    const string max_b =
+        AddScalarConstNode(absl::StrCat(prefix, "/weights_max"), device,
+                           max_weights, output)
+            ->name();
+
+    string bias;
+    if (candidate.bias_add != nullptr) {
+      bias = candidate.bias_add->input(1);
+    } else {
+      Tensor zeros(DT_FLOAT, TensorShape({weights.dim_size(1)}));
+      zeros.flat<float>().setZero();
+      bias =
+          AddConstNode(absl::StrCat(prefix, "/bias"), device, zeros, output)
+              ->name();
+    }
+
+    string min_range, max_range;
+    AddInputRange(matmul, prefix, output, &min_range, &max_range);
+    NodeDef* quantize = output->add_node();
+    quantize->set_name(absl::StrCat(prefix, "/quantize"));
+    quantize->set_op("QuantizeV2");
+    quantize->set_device(device);
+    quantize->add_input(matmul.input(0));
+    quantize->add_input(min_range);
+    quantize->add_input(max_range);
+    (*quantize->mutable_attr())["T"].set_type(DT_QUINT8);
+    (*quantize->mutable_attr())["mode"].set_s("MIN_FIRST");
+
+    // The output range inputs are only used for quantized outputs.
+    const string unused_range =
+        AddScalarConstNode(absl::StrCat(prefix, "/unused_output_range"),
+                           device, 0.0f, output)
+            ->name();
+
+    const string name = replaced->name();
+    replaced->Clear();
+    replaced->set_name(name);
+    replaced->set_op(kQuantizedOp);
+    replaced->set_device(device);
+    replaced->add_input(quantize->name());
+    replaced->add_input(b);
+    replaced->add_input(bias);
+    replaced->add_input(absl::StrCat(quantize->name(), ":1"));
+    replaced->add_input(absl::StrCat(quantize->name(), ":2"));
+    replaced->add_input(min_b);
+    replaced->add_input(max_b);
+    replaced->add_input(unused_range);
+    replaced->add_input(unused_range);
+    auto* attr = replaced->mutable_attr();
+    (*attr)["T1"].set_type(DT_QUINT8);
+    (*attr)["T2"].set_type(DT_QINT8);
+    (*attr)["Tbias"].set_type(DT_FLOAT);
+    (*attr)["Toutput"].set_type(DT_FLOAT);
+    (*attr)["input_quant_mode"].set_s("MIN_FIRST");
+    if (candidate.bias_add != nullptr) {
+      nodes_to_delete.insert(candidate.matmul->name());
+    }
+    ++num_quantized;
+    VLOG(2) << "Quantized " << name << " to int8";
+  }
+  if (num_quantized == 0) {
+    return errors::Aborted("Nothing to do.");
+  }
+  EraseNodesFromGraph(nodes_to_delete, output);
+  return OkStatus();
+}
+
+}  // end namespace grappler
+}  // end namespace tensorflow
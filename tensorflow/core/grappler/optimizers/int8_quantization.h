@@ -0,0 +1,57 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_INT8_QUANTIZATION_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_INT8_QUANTIZATION_H_
+
+#include "tensorflow/core/grappler/optimizers/graph_optimizer.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Int8Quantization rewrites float MatMul nodes with constant weights on CPU,
+// and the BiasAdd that follows them if any, into the int8 matrix
+// multiplication that oneDNN provides:
+//
+//   x -> MatMul(w) -> BiasAdd(b)  =>  x -> QuantizeV2 ->
+//                                     QuantizedMatMulWithBiasAndDequantize(
+//                                         quantize(w), b)
+//
+// The weights are quantized symmetrically to qint8 when the graph is
+// optimized. The activations are quantized to quint8 at run time, over the
+// range given by a "_int8_calibration_range" attr ([min, max], e.g. recorded
+// by a calibration run over representative inputs) on the MatMul, or else
+// over the range of each batch. The output stays float, so the rest of the
+// graph is unchanged.
+//
+// The quantized kernels are only registered with oneDNN, so the meta
+// optimizer only runs this pass when oneDNN is enabled.
+class Int8Quantization : public GraphOptimizer {
+ public:
+  Int8Quantization() {}
+  ~Int8Quantization() override {}
+
+  string name() const override { return "int8_quantization"; };
+
+  bool UsesFunctionLibrary() const override { return false; }
+
+  Status Optimize(Cluster* cluster, const GrapplerItem& item,
+                  GraphDef* output) override;
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_INT8_QUANTIZATION_H_
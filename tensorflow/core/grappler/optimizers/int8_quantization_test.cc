@@ -0,0 +1,180 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/int8_quantization.h"
+
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/utils/grappler_test.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/util/util.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+class Int8QuantizationTest : public GrapplerTest {};
+
+TEST_F(Int8QuantizationTest, NothingToQuantize) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({8, 64}));
+  // Too small to be worth quantizing.
+  Output small_w = ops::Const(
+      s.WithOpName("small_w"),
+      GenerateTensorWithSetRandom<DT_FLOAT>(TensorShape({64, 2})));
+  Output small = ops::MatMul(s.WithOpName("small"), x, small_w);
+  // Not supported by the quantized kernel.
+  Output w = ops::Const(
+      s.WithOpName("w"),
+      GenerateTensorWithSetRandom<DT_FLOAT>(TensorShape({64, 64})));
+  Output transposed = ops::MatMul(s.WithOpName("transposed"), x, w,
+                                  ops::MatMul::TransposeB(true));
+  // Weights that aren't constant.
+  Output variable_w = ops::Placeholder(s.WithOpName("variable_w"), DT_FLOAT,
+                                       ops::Placeholder::Shape({64, 64}));
+  Output variable = ops::MatMul(s.WithOpName("variable"), x, variable_w);
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  Int8Quantization optimizer;
+  GraphDef output;
+  EXPECT_EQ(optimizer.Optimize(nullptr, item, &output),
+            errors::Aborted("Nothing to do."));
+}
+
+TEST_F(Int8QuantizationTest, QuantizeMatMulWithBiasAdd) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({8, 64}));
+  Output w = ops::Const(
+      s.WithOpName("w"),
+      GenerateTensorWithSetRandom<DT_FLOAT>(TensorShape({64, 64})));
+  Output b = ops::Const(s.WithOpName("b"),
+                        GenerateTensorWithSetRandom<DT_FLOAT>(
+                            TensorShape({64})));
+  Output matmul = ops::MatMul(s.WithOpName("matmul"), x, w);
+  Output bias_add = ops::BiasAdd(s.WithOpName("bias_add"), matmul, b);
+  Output fetch = ops::Identity(s.WithOpName("fetch"), bias_add);
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  Int8Quantization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "matmul");
+    if (node.name() == "bias_add") {
+      ++found;
+      EXPECT_EQ(node.op(), "QuantizedMatMulWithBiasAndDequantize");
+      ASSERT_EQ(node.input_size(), 9);
+      EXPECT_EQ(node.input(0), "Int8Quantization/bias_add/quantize");
+      EXPECT_EQ(node.input(1), "Int8Quantization/bias_add/weights");
+      EXPECT_EQ(node.input(2), "b");
+      EXPECT_EQ(node.input(3), "Int8Quantization/bias_add/quantize:1");
+      EXPECT_EQ(node.input(4), "Int8Quantization/bias_add/quantize:2");
+      EXPECT_EQ(node.attr().at("T1").type(), DT_QUINT8);
+      EXPECT_EQ(node.attr().at("T2").type(), DT_QINT8);
+      EXPECT_EQ(node.attr().at("input_quant_mode").s(), "MIN_FIRST");
+    } else if (node.name() == "Int8Quantization/bias_add/quantize") {
+      ++found;
+      EXPECT_EQ(node.op(), "QuantizeV2");
+      ASSERT_EQ(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "x");
+      // Without calibration, the input is quantized over its own range.
+      EXPECT_EQ(node.input(1), "Int8Quantization/bias_add/input_Min");
+      EXPECT_EQ(node.input(2), "Int8Quantization/bias_add/input_Max");
+    } else if (node.name() == "Int8Quantization/bias_add/weights") {
+      ++found;
+      EXPECT_EQ(node.attr().at("dtype").type(), DT_QINT8);
+    }
+  }
+  EXPECT_EQ(found, 3);
+
+  if (!IsMKLEnabled()) GTEST_SKIP() << "Test only applicable to oneDNN.";
+  auto x_t = GenerateTensorWithSetRandom<DT_FLOAT>(TensorShape({8, 64}));
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, {{"x", x_t}});
+  ASSERT_EQ(tensors_expected.size(), 1);
+  auto tensors = EvaluateNodes(output, item.fetch, {{"x", x_t}});
+  ASSERT_EQ(tensors.size(), 1);
+  test::ExpectClose(tensors[0], tensors_expected[0], 0.1, 0.02);
+}
+
+TEST_F(Int8QuantizationTest, QuantizeMatMulWithCalibrationRange) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({8, 64}));
+  Output w = ops::Const(
+      s.WithOpName("w"),
+      GenerateTensorWithSetRandom<DT_FLOAT>(TensorShape({64, 64})));
+  Output matmul = ops::MatMul(s.WithOpName("matmul"), x, w);
+  Output fetch = ops::Identity(s.WithOpName("fetch"), matmul);
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  for (NodeDef& node : *item.graph.mutable_node()) {
+    if (node.name() == "matmul") {
+      auto* range = (*node.mutable_attr())["_int8_calibration_range"]
+                        .mutable_list();
+      range->add_f(0.0f);
+      range->add_f(1.0f);
+    }
+  }
+
+  Int8Quantization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.op(), "Min");
+    EXPECT_NE(node.op(), "Max");
+    if (node.name() == "matmul") {
+      ++found;
+      EXPECT_EQ(node.op(), "QuantizedMatMulWithBiasAndDequantize");
+      ASSERT_EQ(node.input_size(), 9);
+      EXPECT_EQ(node.input(2), "Int8Quantization/matmul/bias");
+    } else if (node.name() == "Int8Quantization/matmul/input_min") {
+      ++found;
+      Tensor min;
+      ASSERT_TRUE(min.FromProto(node.attr().at("value").tensor()));
+      EXPECT_EQ(min.scalar<float>()(), 0.0f);
+    } else if (node.name() == "Int8Quantization/matmul/input_max") {
+      ++found;
+      Tensor max;
+      ASSERT_TRUE(max.FromProto(node.attr().at("value").tensor()));
+      EXPECT_EQ(max.scalar<float>()(), 1.0f);
+    }
+  }
+  EXPECT_EQ(found, 3);
+
+  if (!IsMKLEnabled()) GTEST_SKIP() << "Test only applicable to oneDNN.";
+  auto x_t = GenerateTensorWithSetRandom<DT_FLOAT>(TensorShape({8, 64}));
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, {{"x", x_t}});
+  ASSERT_EQ(tensors_expected.size(), 1);
+  auto tensors = EvaluateNodes(output, item.fetch, {{"x", x_t}});
+  ASSERT_EQ(tensors.size(), 1);
+  test::ExpectClose(tensors[0], tensors_expected[0], 0.1, 0.02);
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
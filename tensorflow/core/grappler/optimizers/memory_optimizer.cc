@@ -28,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.pb.h"  // NOLINT
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/grappler/clusters/virtual_cluster.h"
+#include "tensorflow/core/grappler/costs/analytical_cost_estimator.h"
 #include "tensorflow/core/grappler/costs/graph_memory.h"
 #include "tensorflow/core/grappler/costs/graph_properties.h"
 #include "tensorflow/core/grappler/costs/utils.h"
@@ -440,6 +441,18 @@ void RecomputeSubgraph(
   }
 }
 
+// Returns true if `node` is a node whose inputs we may want to recompute. This
+// matches node names that contain `recomputation_targets_name_scope` as a name
+// scope, meaning it either begins with or contains the name scope. Defaults to
+// "gradients/" which will match any node names that begins with "gradients/"
+// or contains "/gradients/".
+bool IsRecomputationTarget(const NodeDef& node,
+                           const string& recomputation_targets_name_scope) {
+  return absl::StartsWith(node.name(), recomputation_targets_name_scope) ||
+         static_cast<int>(
+             node.name().find("/" + recomputation_targets_name_scope)) != -1;
+}
+
 void RecomputationRewritingPass(RewriterConfig::MemOptType optimization_level,
                                 const string& recomputation_targets_name_scope,
                                 GraphDef* graph, const GrapplerItem& item) {
@@ -461,15 +474,7 @@ void RecomputationRewritingPass(RewriterConfig::MemOptType optimization_level,
   }
   std::function<bool(const NodeDef&)> is_target =
       [&recomputation_targets_name_scope](const NodeDef& node) {
-        // Nodes whose inputs we may want to recompute. This matches node names
-        // that contain recomputation_targets_name_scope as a name scope,
-        // meaning it either begins with or contains the name scope.
-        // Defaults to "gradients/" which will match any node names that begins
-        // with "gradients/" or contains "/gradients/".
-        return absl::StartsWith(node.name(),
-                                recomputation_targets_name_scope) ||
-               static_cast<int>(node.name().find(
-                   "/" + recomputation_targets_name_scope)) != -1;
+        return IsRecomputationTarget(node, recomputation_targets_name_scope);
       };
 
   if (optimization_level == RewriterConfig::RECOMPUTATION_HEURISTICS ||
@@ -1376,8 +1381,251 @@ Status FindAssignNodesToRelax(const GraphDef& graph,
   return OkStatus();
 }
 
+// Returns true if the statically estimated peak memory usage of any CPU device
+// in the cluster exceeds `budget_bytes`.
+bool CpuPeakMemoryExceedsBudget(Cluster* cluster, const GrapplerItem& item,
+                                int64_t budget_bytes) {
+  GraphMemory memory(item);
+  Status s = memory.InferStatically(cluster->GetDevices());
+  if (!s.ok()) {
+    VLOG(1) << "Failed to infer memory usage: " << s.error_message();
+    return false;
+  }
+  for (const auto& device : cluster->GetDevices()) {
+    if (device.second.type() != "CPU") {
+      continue;
+    }
+    const GraphMemory::MemoryUsage& mem_usage =
+        memory.GetPeakMemoryUsage(device.first);
+    if (mem_usage.used_memory > budget_bytes) {
+      VLOG(1) << "Estimated peak memory usage of " << mem_usage.used_memory
+              << " bytes on " << device.first << " exceeds the budget of "
+              << budget_bytes << " bytes";
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ClusterHasGpu(const Cluster& cluster) {
+  for (const auto& device : cluster.GetDevices()) {
+    if (device.second.type() == "GPU") return true;
+  }
+  return false;
+}
+
+// Simulated run time and peak memory usage of a graph.
+struct SimulatedCosts {
+  int64_t time_ns = 0;
+  int64_t peak_memory = 0;
+};
+
+// Simulates the execution of `item` with the virtual scheduler. The peak
+// memory usage is the largest one among the GPUs of the cluster, or among all
+// of its devices if it has no GPU.
+Status SimulateGraph(Cluster* cluster, const GrapplerItem& item,
+                     SimulatedCosts* costs) {
+  AnalyticalCostEstimator estimator(cluster, /*use_static_shapes=*/true,
+                                    /*use_aggressive_shape_inference=*/false);
+  TF_RETURN_IF_ERROR(estimator.Initialize(item));
+  Costs graph_costs;
+  TF_RETURN_IF_ERROR(
+      estimator.PredictCosts(item.graph, /*run_metadata=*/nullptr,
+                             &graph_costs));
+  const bool has_gpu = ClusterHasGpu(*cluster);
+  costs->time_ns = graph_costs.execution_time.count();
+  costs->peak_memory = 0;
+  for (const auto& peak : estimator.GetScheduler()->GetPeakMemoryUsage()) {
+    DeviceNameUtils::ParsedName parsed_name;
+    if (has_gpu && (!DeviceNameUtils::ParseFullName(peak.first, &parsed_name) ||
+                    parsed_name.type != "GPU")) {
+      continue;
+    }
+    costs->peak_memory = std::max(costs->peak_memory, peak.second);
+  }
+  return OkStatus();
+}
+
+// A memory saving rewrite considered by the simulated search: either
+// recomputing `node` for its consumers in the backward pass, or swapping input
+// `input` of `node` out to the host memory.
+struct MemoryRewrite {
+  string node;
+  int input = -1;  // -1 means recomputation.
+  int64_t bytes = 0;
+};
+
+// Returns the candidate rewrites of `item`, largest tensors first.
+std::vector<MemoryRewrite> FindMemoryRewriteCandidates(
+    Cluster* cluster, const GrapplerItem& item,
+    const string& recomputation_targets_name_scope) {
+  std::vector<MemoryRewrite> candidates;
+  GraphProperties properties(item);
+  if (!properties
+           .InferStatically(/*assume_valid_feeds=*/true,
+                            /*aggressive_shape_inference=*/false,
+                            /*include_tensor_values=*/false)
+           .ok()) {
+    return candidates;
+  }
+  std::unordered_set<string> feeds;
+  for (const auto& feed : item.feed) {
+    feeds.insert(NodeName(feed.first));
+  }
+  const bool has_gpu = ClusterHasGpu(*cluster);
+  GraphDef graph = item.graph;
+  NodeMap node_map(&graph);
+  for (const NodeDef& node : graph.node()) {
+    if (IsRecomputationTarget(node, recomputation_targets_name_scope)) {
+      // Inputs of the targets computed in the forward pass may be swapped out
+      // until the target needs them.
+      if (!has_gpu || !NodeIsOnGpu(&node) ||
+          node.attr().count("_swap_to_host") != 0) {
+        continue;
+      }
+      const auto& input_props = properties.GetInputProperties(node.name());
+      for (int i = 0; i < node.input_size() && i < input_props.size(); ++i) {
+        if (IsControlInput(node.input(i))) break;
+        const NodeDef* input = node_map.GetNode(node.input(i));
+        if (input == nullptr ||
+            IsRecomputationTarget(*input, recomputation_targets_name_scope) ||
+            !IsSwappable(MutableGraphView::InputPort(
+                const_cast<NodeDef*>(&node), i))) {
+          continue;
+        }
+        const int64_t bytes = CalculateTensorSize(input_props[i]);
+        if (bytes > 0) candidates.push_back({node.name(), i, bytes});
+      }
+      continue;
+    }
+    // Nodes feeding a target may be recomputed, unless they are fed,
+    // stateful, sources, or already annotated.
+    if (feeds.count(node.name()) != 0 || node.input_size() == 0 ||
+        node.attr().count(kRecomputeHint) != 0 || IsStateful(node)) {
+      continue;
+    }
+    bool feeds_target = false;
+    for (const NodeDef* output : node_map.GetOutputs(node.name())) {
+      if (IsRecomputationTarget(*output, recomputation_targets_name_scope)) {
+        feeds_target = true;
+        break;
+      }
+    }
+    if (!feeds_target) continue;
+    int64_t bytes = 0;
+    for (const auto& prop : properties.GetOutputProperties(node.name())) {
+      bytes += std::max<int64_t>(CalculateTensorSize(prop), 0);
+    }
+    if (bytes > 0) candidates.push_back({node.name(), -1, bytes});
+  }
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const MemoryRewrite& a, const MemoryRewrite& b) {
+                     return a.bytes > b.bytes;
+                   });
+  return candidates;
+}
+
+// Returns a copy of `item` with `rewrites` applied: they are turned into
+// manual annotations, which the MANUAL recomputation and swapping passes
+// then implement.
+GrapplerItem ApplyMemoryRewrites(
+    Cluster* cluster, const GrapplerItem& item,
+    const std::vector<MemoryRewrite>& rewrites,
+    const string& recomputation_targets_name_scope) {
+  GraphDef graph = item.graph;
+  std::unordered_map<string, NodeDef*> nodes;
+  for (NodeDef& node : *graph.mutable_node()) {
+    nodes[node.name()] = &node;
+  }
+  bool has_swaps = false;
+  for (const MemoryRewrite& rewrite : rewrites) {
+    NodeDef* node = nodes[rewrite.node];
+    if (rewrite.input < 0) {
+      (*node->mutable_attr())[kRecomputeHint].set_i(0);
+    } else {
+      (*node->mutable_attr())["_swap_to_host"].mutable_list()->add_i(
+          rewrite.input);
+      has_swaps = true;
+    }
+  }
+  GrapplerItem rewritten = item.WithGraph(std::move(graph));
+  RecomputationRewritingPass(RewriterConfig::MANUAL,
+                             recomputation_targets_name_scope,
+                             &rewritten.graph, item);
+  if (has_swaps) {
+    std::unique_ptr<GraphMemory> memory;
+    std::unordered_set<string> skip_list;
+    SwappingPass(RewriterConfig::MANUAL, cluster, &memory, &rewritten,
+                 &skip_list);
+  }
+  return rewritten;
+}
+
 }  // namespace
 
+Status MemoryOptimizer::SimulatedSearchPass(Cluster* cluster,
+                                            GrapplerItem* item) {
+  // Bound the number of simulations, since each one is as expensive as a cost
+  // estimation of the whole graph.
+  constexpr int kMaxCandidates = 16;
+  constexpr int kMaxRewrites = 8;
+
+  SimulatedCosts original_costs;
+  Status s = SimulateGraph(cluster, *item, &original_costs);
+  if (!s.ok()) {
+    VLOG(1) << "Failed to simulate the graph: " << s.error_message();
+    return OkStatus();
+  }
+  std::vector<MemoryRewrite> candidates =
+      FindMemoryRewriteCandidates(cluster, *item,
+                                  recomputation_targets_name_scope_);
+  if (candidates.size() > kMaxCandidates) candidates.resize(kMaxCandidates);
+  const int64_t max_time_ns = static_cast<int64_t>(
+      original_costs.time_ns * (1.0 + max_time_overhead_));
+
+  std::vector<MemoryRewrite> rewrites;
+  std::vector<bool> applied(candidates.size(), false);
+  SimulatedCosts costs = original_costs;
+  while (rewrites.size() < kMaxRewrites) {
+    int best_candidate = -1;
+    SimulatedCosts best_costs = costs;
+    for (int i = 0; i < candidates.size(); ++i) {
+      GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
+      if (applied[i]) continue;
+      rewrites.push_back(candidates[i]);
+      SimulatedCosts candidate_costs;
+      if (SimulateGraph(cluster,
+                        ApplyMemoryRewrites(cluster, *item, rewrites,
+                                            recomputation_targets_name_scope_),
+                        &candidate_costs)
+              .ok() &&
+          candidate_costs.time_ns <= max_time_ns &&
+          candidate_costs.peak_memory < best_costs.peak_memory) {
+        best_candidate = i;
+        best_costs = candidate_costs;
+      }
+      rewrites.pop_back();
+    }
+    if (best_candidate < 0) break;
+    VLOG(1) << (candidates[best_candidate].input < 0 ? "Recomputing "
+                                                     : "Swapping input of ")
+            << candidates[best_candidate].node << " lowers the peak memory to "
+            << best_costs.peak_memory << " bytes";
+    rewrites.push_back(candidates[best_candidate]);
+    applied[best_candidate] = true;
+    costs = best_costs;
+  }
+  if (rewrites.empty()) return OkStatus();
+
+  VLOG(1) << "Simulated peak memory usage lowered from "
+          << original_costs.peak_memory << " to " << costs.peak_memory
+          << " bytes, run time changed from " << original_costs.time_ns
+          << " to " << costs.time_ns << " ns";
+  *item = ApplyMemoryRewrites(cluster, *item, rewrites,
+                              recomputation_targets_name_scope_);
+  return OkStatus();
+}
+
 Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
                                  GraphDef* optimized_graph) {
   std::set<int> nodes_to_relax;
@@ -1387,6 +1635,14 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
       (optimization_level_ == RewriterConfig::RECOMPUTATION_HEURISTICS ||
        optimization_level_ == RewriterConfig::HEURISTICS ||
        optimization_level_ == RewriterConfig::MANUAL);
+  // Under CPU memory pressure, the recomputation heuristics are applied even
+  // if the optimization level does not request them. Estimating the peak
+  // memory usage requires fetches and a cluster.
+  bool check_cpu_memory_budget =
+      cpu_memory_budget_bytes_ > 0 && !item.fetch.empty() &&
+      cluster != nullptr &&
+      optimization_level_ != RewriterConfig::RECOMPUTATION_HEURISTICS &&
+      optimization_level_ != RewriterConfig::HEURISTICS;
   if (!run_recomputation_pass && nodes_to_relax.empty() && item.fetch.empty()) {
     return errors::Aborted("Nothing to do.");
   }
@@ -1394,12 +1650,32 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
   GrapplerItem optimized_item(item);
   RelaxAssignNodes(nodes_to_relax, &optimized_item.graph);
 
+  RewriterConfig::MemOptType recomputation_level = optimization_level_;
+  if (check_cpu_memory_budget &&
+      CpuPeakMemoryExceedsBudget(cluster, optimized_item,
+                                 cpu_memory_budget_bytes_)) {
+    // Apply the same heuristics as RECOMPUTATION_HEURISTICS, which also
+    // respect manual annotations.
+    recomputation_level = RewriterConfig::RECOMPUTATION_HEURISTICS;
+    run_recomputation_pass = true;
+  }
+
   if (run_recomputation_pass) {
-    RecomputationRewritingPass(optimization_level_,
+    RecomputationRewritingPass(recomputation_level,
                                recomputation_targets_name_scope_,
                                &optimized_item.graph, item);
   }
 
+  if (optimization_level_ == RewriterConfig::SIMULATED_SEARCH) {
+    // The search replaces the heuristic passes below, and implements the
+    // manual annotations along with the rewrites it picks.
+    if (!item.fetch.empty() && cluster != nullptr) {
+      TF_RETURN_IF_ERROR(SimulatedSearchPass(cluster, &optimized_item));
+    }
+    optimized_graph->Swap(&optimized_item.graph);
+    return OkStatus();
+  }
+
   std::unordered_set<string> skip_list;
   // Bound the number of rewrite passes to avoid long processing times on graphs
   // that simply won't fit in memory.
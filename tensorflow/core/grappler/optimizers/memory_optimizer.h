@@ -33,11 +33,20 @@ class MemoryOptimizer : public GraphOptimizer {
   // recomputation_targets_name_scope: Name scope for potential outputs of
   //   recomputations. See
   //   RewriterConfig::memory_optimizer_target_node_name_scope.
+  // cpu_memory_budget_bytes: If positive, apply the recomputation heuristics
+  //   when the estimated peak memory usage of a CPU device exceeds it. See
+  //   RewriterConfig::cpu_memory_budget_bytes.
+  // max_time_overhead: Maximum relative increase of the simulated run time
+  //   for SIMULATED_SEARCH. See
+  //   RewriterConfig::memory_optimizer_max_time_overhead.
   explicit MemoryOptimizer(
       RewriterConfig::MemOptType optimization_level,
-      const string& recomputation_targets_name_scope = "gradients/")
+      const string& recomputation_targets_name_scope = "gradients/",
+      int64_t cpu_memory_budget_bytes = 0, double max_time_overhead = 0)
       : optimization_level_(optimization_level),
-        recomputation_targets_name_scope_(recomputation_targets_name_scope) {}
+        recomputation_targets_name_scope_(recomputation_targets_name_scope),
+        cpu_memory_budget_bytes_(cpu_memory_budget_bytes),
+        max_time_overhead_(max_time_overhead > 0 ? max_time_overhead : 0.1) {}
   ~MemoryOptimizer() override {}
 
   string name() const override { return "memory_optimizer"; };
@@ -48,8 +57,15 @@ class MemoryOptimizer : public GraphOptimizer {
                   GraphDef* pruned_graph) override;
 
  private:
+  // Greedily applies the recomputations and swaps that lower the peak memory
+  // usage of `item` the most according to the virtual scheduler, as long as
+  // the simulated run time stays within the time overhead budget.
+  Status SimulatedSearchPass(Cluster* cluster, GrapplerItem* item);
+
   RewriterConfig::MemOptType optimization_level_;
   string recomputation_targets_name_scope_;
+  int64_t cpu_memory_budget_bytes_;
+  double max_time_overhead_;
 };
 
 }  // end namespace grappler
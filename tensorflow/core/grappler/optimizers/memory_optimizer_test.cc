@@ -346,6 +346,92 @@ TEST_F(MemoryOptimizerTest, SwappingHeuristics) {
 #endif
 }
 
+TEST_F(MemoryOptimizerTest, RecomputationOverCpuMemoryBudget) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output a = ops::Variable(s.WithOpName("a").WithDevice("/cpu:0"),
+                           {128, 128, 8}, DT_FLOAT);
+  Output b = ops::Relu(s.WithOpName("b").WithDevice("/cpu:0"), a);
+  Output c = ops::Exp(s.WithOpName("c").WithDevice("/cpu:0"), b);
+  Output d = ops::AddN(s.WithOpName("gradients/d").WithDevice("/cpu:0"), {c});
+  Output e =
+      ops::AddN(s.WithOpName("gradients/e").WithDevice("/cpu:0"), {d, b});
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"gradients/e"};
+
+  std::unique_ptr<VirtualCluster> cluster(CreateVirtualCluster());
+
+  auto is_recomputed = [](const GraphDef& graph) {
+    for (const auto& node : graph.node()) {
+      if (node.name() == "Recomputed/b") return true;
+    }
+    return false;
+  };
+
+  // The estimated peak fits in the budget: the graph is not rewritten.
+  MemoryOptimizer large_budget(RewriterConfig::DEFAULT_MEM_OPT, "gradients/",
+                               /*cpu_memory_budget_bytes=*/int64_t{1} << 40);
+  GraphDef output;
+  TF_EXPECT_OK(large_budget.Optimize(cluster.get(), item, &output));
+  EXPECT_FALSE(is_recomputed(output));
+
+  // The estimated peak exceeds the budget: the cheap Relu is recomputed.
+  MemoryOptimizer small_budget(RewriterConfig::DEFAULT_MEM_OPT, "gradients/",
+                               /*cpu_memory_budget_bytes=*/1024);
+  TF_EXPECT_OK(small_budget.Optimize(cluster.get(), item, &output));
+  EXPECT_TRUE(is_recomputed(output));
+}
+
+TEST_F(MemoryOptimizerTest, SimulatedSearchRecomputation) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output a = ops::Variable(s.WithOpName("a").WithDevice("/cpu:0"),
+                           {128, 128, 8}, DT_FLOAT);
+  Output b = ops::Relu(s.WithOpName("b").WithDevice("/cpu:0"), a);
+  Output c = ops::Exp(s.WithOpName("c").WithDevice("/cpu:0"), b);
+  Output d = ops::AddN(s.WithOpName("gradients/d").WithDevice("/cpu:0"), {c});
+  Output e =
+      ops::AddN(s.WithOpName("gradients/e").WithDevice("/cpu:0"), {d, b});
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"gradients/e"};
+
+  // Without a GPU, only recomputation is considered.
+  DeviceProperties cpu_device;
+  cpu_device.set_type("CPU");
+  cpu_device.set_frequency(1000);
+  cpu_device.set_num_cores(4);
+  cpu_device.set_bandwidth(32);
+  cpu_device.set_memory_size(1024 * 1024);
+  std::unordered_map<string, DeviceProperties> devices;
+  devices["/job:localhost/replica:0/task:0/cpu:0"] = cpu_device;
+  VirtualCluster cluster(devices);
+
+  auto is_recomputed = [](const GraphDef& graph) {
+    for (const auto& node : graph.node()) {
+      if (node.name() == "Recomputed/b") return true;
+    }
+    return false;
+  };
+
+  // Recomputing b keeps it from being alive across gradients/d, which lowers
+  // the peak memory usage.
+  MemoryOptimizer optimizer(RewriterConfig::SIMULATED_SEARCH, "gradients/",
+                            /*cpu_memory_budget_bytes=*/0,
+                            /*max_time_overhead=*/1.0);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(&cluster, item, &output));
+  EXPECT_TRUE(is_recomputed(output));
+
+  // The recomputation doesn't fit in a tiny time overhead budget.
+  MemoryOptimizer no_overhead(RewriterConfig::SIMULATED_SEARCH, "gradients/",
+                              /*cpu_memory_budget_bytes=*/0,
+                              /*max_time_overhead=*/1e-9);
+  TF_EXPECT_OK(no_overhead.Optimize(&cluster, item, &output));
+  EXPECT_FALSE(is_recomputed(output));
+}
+
 TEST_F(MemoryOptimizerTest, UnswappableInputs) {
   tensorflow::Scope s = tensorflow::Scope::NewRootScope();
   Output v = ops::Variable(s.WithOpName("v").WithDevice("/gpu:0"),
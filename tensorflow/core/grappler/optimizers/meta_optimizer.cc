@@ -43,7 +43,9 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/dependency_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/function_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/generic_layout_optimizer.h"
+#include "tensorflow/core/grappler/optimizers/horizontal_fusion.h"
 #include "tensorflow/core/grappler/optimizers/implementation_selector.h"
+#include "tensorflow/core/grappler/optimizers/int8_quantization.h"
 #include "tensorflow/core/grappler/optimizers/loop_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/memory_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/model_pruner.h"
@@ -58,8 +60,15 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils/tpu.h"
 #include "tensorflow/core/grappler/verifiers/structure_verifier.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/public/version.h"
 #include "tensorflow/core/util/dump_graph.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/ptr_util.h"
 #include "tensorflow/core/util/util.h"
 #include "tensorflow/core/util/xla_config_registry.h"
@@ -125,6 +134,60 @@ FunctionDefLibrary GetFunctionDefLibraryStub(
   return stub;
 }
 
+// Returns the path of the cached result of optimizing `item` with `cfg` on
+// `cluster` (which may be null), in the directory given by the
+// TF_GRAPPLER_OPTIMIZED_GRAPH_CACHE_DIR environment variable, or an empty
+// string if it is not set.
+//
+// The results are keyed by a fingerprint of everything the meta optimizer
+// reads, and of the version of TensorFlow. Custom optimizers registered in
+// the process are not part of the key, so the cache must be cleared when they
+// change.
+string OptimizedGraphCachePath(const Cluster* cluster, const GrapplerItem& item,
+                               const RewriterConfig& cfg) {
+  string cache_dir;
+  TF_CHECK_OK(ReadStringFromEnvVar("TF_GRAPPLER_OPTIMIZED_GRAPH_CACHE_DIR",
+                                   /*default_val=*/"", &cache_dir));
+  if (cache_dir.empty()) return "";
+
+  uint64 key = Fingerprint64(TF_VERSION_STRING);
+  const auto add_to_key = [&key](StringPiece s) {
+    key = FingerprintCat64(key, Fingerprint64(s));
+  };
+  const auto add_proto_to_key = [&](const protobuf::MessageLite& proto) {
+    string serialized;
+    SerializeToStringDeterministic(proto, &serialized);
+    add_to_key(serialized);
+  };
+  add_proto_to_key(item.graph);
+  add_proto_to_key(cfg);
+  for (const auto& feed : item.feed) add_to_key(feed.first);
+  add_to_key("fetch");
+  for (const string& fetch : item.fetch) add_to_key(fetch);
+  add_to_key("keep_ops");
+  for (const string& op : item.keep_ops) add_to_key(op);
+  add_to_key("init_ops");
+  for (const string& op : item.init_ops) add_to_key(op);
+  std::vector<string> devices(item.devices().begin(), item.devices().end());
+  if (cluster != nullptr) {
+    for (const auto& device : cluster->GetDevices()) {
+      devices.push_back(
+          absl::StrCat(device.first, ":", device.second.SerializeAsString()));
+    }
+  }
+  std::sort(devices.begin(), devices.end());
+  add_to_key("devices");
+  for (const string& device : devices) add_to_key(device);
+  const GrapplerItem::OptimizationOptions& options =
+      item.optimization_options();
+  add_to_key(absl::StrCat(options.allow_non_differentiable_rewrites,
+                          options.allow_pruning_stateful_and_dataset_ops,
+                          options.optimize_function_library,
+                          options.is_eager_mode));
+  return io::JoinPath(cache_dir,
+                      absl::StrCat(strings::FpToString(key), ".graphdef"));
+}
+
 uint64 DeadlineMicroSeconds(const RewriterConfig& cfg) {
   if (cfg.meta_optimizer_timeout_ms() <= 0) return 0;  // no deadline
   return Env::Default()->NowMicros() + cfg.meta_optimizer_timeout_ms() * 1000;
@@ -230,6 +293,7 @@ std::unique_ptr<GraphOptimizer> MetaOptimizer::MakeNewOptimizer(
   if (IsMKLEnabled()) {
     MK_OPT("auto_mixed_precision_mkl", "auto_mixed_precision_mkl",
            new AutoMixedPrecision(AutoMixedPrecisionMode::MKL));
+    MK_OPT("int8_quantization", "int8_quantization", new Int8Quantization());
   }
 #endif
   MK_OPT("auto_mixed_precision_cpu", "auto_mixed_precision_cpu",
@@ -247,6 +311,7 @@ std::unique_ptr<GraphOptimizer> MetaOptimizer::MakeNewOptimizer(
   MK_OPT("dependency", "dependency_optimization",
          new DependencyOptimizer(cfg_.dependency_optimization()));
   MK_OPT("debug_stripper", "debug_stripper", new DebugStripper());
+  MK_OPT("horizontal_fusion", "horizontal_fusion", new HorizontalFusion());
   MK_OPT("scoped_allocator", "scoped_allocator_optimization",
          new ScopedAllocatorOptimizer(cfg_.scoped_allocator_optimization(),
                                       cfg_.scoped_allocator_opts()));
@@ -376,6 +441,11 @@ Status MetaOptimizer::InitializeOptimizers(
     optimizers->push_back(
         MakeUnique<AutoMixedPrecision>(AutoMixedPrecisionMode::MKL));
   }
+  // The quantized kernels are only available with oneDNN.
+  if (USER_IS_ON(int8_quantization) && PLUGIN_NOT_OFF(int8_quantization) &&
+      IsMKLEnabled()) {
+    optimizers->push_back(MakeUnique<Int8Quantization>());
+  }
 #endif
   if (AutoMixedPrecisionEnabled(cfg_.auto_mixed_precision_cpu()) &&
       AutoMixedPrecisionEnabled(
@@ -445,17 +515,25 @@ Status MetaOptimizer::InitializeOptimizers(
           MakeUnique<DependencyOptimizer>(cfg_.dependency_optimization()));
     }
   }
+  if (USER_IS_ON(horizontal_fusion) && PLUGIN_NOT_OFF(horizontal_fusion)) {
+    optimizers->push_back(MakeUnique<HorizontalFusion>());
+  }
   if (MemoryOptimizerEnabled(cfg_.memory_optimization(),
                              xla_auto_clustering_on_) &&
       PLUGIN_NOT_OFF(memory_optimization)) {
     if (cfg_.memory_optimizer_target_node_name_scope().empty()) {
       optimizers->push_back(
           // Use the default target node name prefix "gradients/"
-          MakeUnique<MemoryOptimizer>(cfg_.memory_optimization()));
+          MakeUnique<MemoryOptimizer>(
+              cfg_.memory_optimization(), "gradients/",
+              cfg_.cpu_memory_budget_bytes(),
+              cfg_.memory_optimizer_max_time_overhead()));
     } else {
       optimizers->push_back(MakeUnique<MemoryOptimizer>(
           cfg_.memory_optimization(),
-          cfg_.memory_optimizer_target_node_name_scope()));
+          cfg_.memory_optimizer_target_node_name_scope(),
+          cfg_.cpu_memory_budget_bytes(),
+          cfg_.memory_optimizer_max_time_overhead()));
     }
   }
   if (cfg_.auto_parallel().enable() && PLUGIN_IS_ON(auto_parallel)) {
@@ -614,6 +692,8 @@ void MetaOptimizer::PrintUserAndPluginConfigs(
     PRINT_CFG(remapping)
     PRINT_CFG(loop_optimization)
     PRINT_CFG(dependency_optimization)
+    PRINT_CFG(horizontal_fusion)
+    PRINT_CFG(int8_quantization)
     PRINT_CFG(scoped_allocator_optimization)
 #undef PRINT_CFG
     user_cfg.toggle_config["auto_mixed_precision"] =
@@ -661,6 +741,8 @@ void MetaOptimizer::PrintUserAndPluginConfigs(
       PRINT_CFG("remap", "remapping")
       PRINT_CFG("loop", "loop_optimization")
       PRINT_CFG("dependency", "dependency_optimization")
+      PRINT_CFG("horizontal_fusion", "horizontal_fusion")
+      PRINT_CFG("int8_quantization", "int8_quantization")
       PRINT_CFG("memory", "memory_optimization")
       PRINT_CFG("autoparallel", "auto_parallel")
       PRINT_CFG("scoped_allocator", "scoped_allocator_optimization")
@@ -697,6 +779,8 @@ void MetaOptimizer::PrintUserAndPluginConfigs(
         pair.first == "auto_mixed_precision_mkl" ||
         pair.first == "auto_mixed_precision_cpu" ||
         pair.first == "pin_to_host_optimization" ||
+        pair.first == "horizontal_fusion" ||
+        pair.first == "int8_quantization" ||
         pair.first == "scoped_allocator_optimization") {
       // These optimizers are turned off by default.
       strings::StrAppend(
@@ -851,7 +935,10 @@ Status MetaOptimizer::OptimizeGraph(
                                    }) != optimization_result.results.end();
 
   // Record graph optimization result.
-  optimization_results_.push_back(optimization_result);
+  {
+    mutex_lock l(optimization_results_mu_);
+    optimization_results_.push_back(optimization_result);
+  }
 
   if (is_optimized) {
     TF_RETURN_IF_ERROR(TopologicalSort(optimized_graph));
@@ -900,7 +987,18 @@ Status MetaOptimizer::RunOptimizer(
   // resets optimized_graph to an empty graph.
   optimized_item->graph = std::move(*optimized_graph);
   *optimized_graph = GraphDef();
-  optimizer->set_deadline_usec(this->deadline_usec());
+  uint64 optimizer_deadline_usec = this->deadline_usec();
+  if (cfg_.optimizer_timeout_ms() > 0) {
+    // The optimizer fails with DeadlineExceeded once it runs out of its own
+    // budget, or of the budget of the meta optimizer, whichever comes first.
+    const uint64 budget_deadline_usec =
+        Env::Default()->NowMicros() + cfg_.optimizer_timeout_ms() * 1000;
+    if (optimizer_deadline_usec == 0 ||
+        budget_deadline_usec < optimizer_deadline_usec) {
+      optimizer_deadline_usec = budget_deadline_usec;
+    }
+  }
+  optimizer->set_deadline_usec(optimizer_deadline_usec);
   tensorflow::metrics::ScopedCounter<2> timings(
       tensorflow::metrics::GetGraphOptimizationCounter(),
       {kGrapplerCategory, optimizer->name()});
@@ -1017,7 +1115,18 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
       {kGrapplerCategory, "*"});
 
   VLOG(1) << "Starting optimization for grappler item: " << item.id;
-  optimization_results_.clear();
+  {
+    mutex_lock l(optimization_results_mu_);
+    optimization_results_.clear();
+  }
+
+  const string cache_path = OptimizedGraphCachePath(cluster, item, cfg_);
+  if (!cache_path.empty() &&
+      ReadBinaryProto(Env::Default(), cache_path, optimized_graph).ok()) {
+    VLOG(1) << "Read the optimized graph of grappler item " << item.id
+            << " from " << cache_path;
+    return OkStatus();
+  }
 
   // Constructs a FunctionLibraryDefinition with functions that are reachable
   // from the nodes of the graph.
@@ -1131,6 +1240,18 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
   while (optimize_function_library) {
     optimize_function_library = false;
 
+    // The functions optimized in this pass. They are optimized independently
+    // of each other, possibly in parallel, and then merged back into the
+    // library in the order of the library, so that the result does not depend
+    // on the order in which the optimizations finish.
+    struct FunctionToOptimize {
+      string name;
+      GrapplerFunctionItem item;
+      GraphDef optimized_graph;
+      Status status;
+    };
+    std::vector<FunctionToOptimize> funcs_to_optimize;
+
     int function_idx = 0;
     for (const FunctionDef& func : optimized_graph->library().function()) {
       GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
@@ -1164,7 +1285,10 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
       optimized_funcs.insert(func_name);
 
       // Make a GrapplerItem from a FunctionDef.
-      GrapplerFunctionItem func_item;
+      funcs_to_optimize.emplace_back();
+      FunctionToOptimize& func_to_optimize = funcs_to_optimize.back();
+      func_to_optimize.name = func_name;
+      GrapplerFunctionItem& func_item = func_to_optimize.item;
       TF_RETURN_IF_ERROR(
           MakeGrapplerFunctionItem(func, flib, producer, &func_item));
 
@@ -1187,9 +1311,11 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
       // function_optimizer.cc).
       func_item.optimization_options().allow_pruning_stateful_and_dataset_ops =
           false;
+    }
 
-      // Optimize function body graph.
-      GraphDef optimized_func_graph;
+    // Optimize function body graph.
+    const auto optimize_function = [&](FunctionToOptimize* func_to_optimize) {
+      const GrapplerFunctionItem& func_item = func_to_optimize->item;
       if (is_tpu_graph) {
         // Skip optimizing functions if this is a TPU graph. Currently, Grappler
         // passes do not handle TPU functions correctly in a variety of ways
@@ -1206,18 +1332,43 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
 
         // Implementation selector needs to have access to valid function
         // signature and attributes, and it doesn't need actual function body.
+        GrapplerFunctionItem func_item_copy = func_item;
         std::unique_ptr<FunctionDefLibrary> func_item_function_library(
-            func_item.graph.release_library());
-        *func_item.graph.mutable_library() =
+            func_item_copy.graph.release_library());
+        *func_item_copy.graph.mutable_library() =
             GetFunctionDefLibraryStub(*func_item_function_library);
 
-        TF_RETURN_IF_ERROR(implementation_selector.Optimize(
-            cluster, func_item, &optimized_func_graph));
+        func_to_optimize->status = implementation_selector.Optimize(
+            cluster, func_item_copy, &func_to_optimize->optimized_graph);
       } else {
         GrapplerFunctionItem func_item_copy = func_item;
-        TF_RETURN_IF_ERROR(OptimizeGraph(cluster, std::move(func_item_copy),
-                                         &optimized_func_graph));
+        func_to_optimize->status =
+            OptimizeGraph(cluster, std::move(func_item_copy),
+                          &func_to_optimize->optimized_graph);
+      }
+    };
+    const int num_threads = std::min<int>(cfg_.function_optimization_threads(),
+                                          funcs_to_optimize.size());
+    if (num_threads > 1) {
+      // The function library is only read while the functions are optimized,
+      // and the pool waits for all of them when it is destroyed.
+      thread::ThreadPool pool(Env::Default(), "grappler_function_optimization",
+                              num_threads);
+      for (FunctionToOptimize& func_to_optimize : funcs_to_optimize) {
+        pool.Schedule([&optimize_function, &func_to_optimize]() {
+          optimize_function(&func_to_optimize);
+        });
+      }
+    } else {
+      for (FunctionToOptimize& func_to_optimize : funcs_to_optimize) {
+        optimize_function(&func_to_optimize);
+        if (!func_to_optimize.status.ok()) break;
       }
+    }
+
+    for (FunctionToOptimize& func_to_optimize : funcs_to_optimize) {
+      TF_RETURN_IF_ERROR(func_to_optimize.status);
+      GraphDef& optimized_func_graph = func_to_optimize.optimized_graph;
 
       // Function body optimization might have created new specialized
       // functions for each instantiation context. Add them to the library.
@@ -1230,11 +1381,13 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
 
       // Convert optimized graph back to FunctionDef.
       FunctionDef optimized_func;
+      GrapplerFunctionItem& func_item = func_to_optimize.item;
       func_item.SwapFunctionBody(std::move(optimized_func_graph));
       TF_RETURN_IF_ERROR(MakeFunctionDef(func_item, flib, &optimized_func));
 
       // Replace optimized function with a new FunctionDef.
-      TF_RETURN_IF_ERROR(flib.ReplaceFunction(func_name, optimized_func));
+      TF_RETURN_IF_ERROR(
+          flib.ReplaceFunction(func_to_optimize.name, optimized_func));
     }
 
     // If optimized at least one function, update the graph library.
@@ -1278,11 +1431,29 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
         *optimized_graph);
   }
 
+  if (!cache_path.empty()) {
+    // Write to a temporary file first, so that concurrent readers never see a
+    // partial graph.
+    Env* env = Env::Default();
+    const string tmp_path = strings::StrCat(
+        cache_path, ".tmp", strings::FpToString(random::New64()));
+    Status s = env->RecursivelyCreateDir(string(io::Dirname(cache_path)));
+    if (s.ok() || errors::IsAlreadyExists(s)) {
+      s = WriteBinaryProto(env, tmp_path, *optimized_graph);
+    }
+    if (s.ok()) s = env->RenameFile(tmp_path, cache_path);
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to write the optimized graph of grappler item "
+                   << item.id << " to " << cache_path << ": " << s;
+    }
+  }
+
   return OkStatus();
 }
 
 string MetaOptimizer::GetResultString() const {
   std::string result_string;
+  mutex_lock l(optimization_results_mu_);
   for (const GraphOptimizationResult& graph_result : optimization_results_) {
     absl::StrAppend(&result_string,
                     "Optimization results for grappler item: ", graph_result.id,
@@ -1315,6 +1486,8 @@ bool MetaOptimizerEnabled(const ConfigProto& cfg) {
          rewrite_cfg.auto_parallel().enable() ||
          rewrite_cfg.memory_optimization() != RewriterConfig::NO_MEM_OPT ||
          rewrite_cfg.debug_stripper() == RewriterConfig::ON ||
+         rewrite_cfg.horizontal_fusion() == RewriterConfig::ON ||
+         rewrite_cfg.int8_quantization() == RewriterConfig::ON ||
 #ifndef ENABLE_MKL
          rewrite_cfg.scoped_allocator_optimization() == RewriterConfig::ON ||
 #endif
@@ -59,6 +59,12 @@ namespace grappler {
 //
 // Sigmoid + Mul -> _MklSwish  // This fusion only works on Intel CPU.
 //
+// Gather + SparseSegment{Sum,Mean,SqrtN}[WithNumSegments] ->
+//   Gather(ids) + SparseSegment{Sum,Mean,SqrtN}[WithNumSegments](params)
+//
+// BatchMatMul + [Mul] + [Add] + Softmax + BatchMatMul -> _FusedAttention
+//   // This fusion only works on CPU.
+//
 //
 // In all cases, the supported activation functions are Relu, Relu6, and Elu.
 //
@@ -73,6 +79,7 @@ constexpr char kFusedDepthwiseConv2dNative[] = "_FusedDepthwiseConv2dNative";
 constexpr char kFusedBatchNormEx[] = "_FusedBatchNormEx";
 constexpr char kFusedBatchNormGradEx[] = "_FusedBatchNormGradEx";
 constexpr char kTensorToHashBucket[] = "_TensorToHashBucketFast";
+constexpr char kFusedAttention[] = "_FusedAttention";
 
 constexpr char kDataFormat[] = "data_format";
 constexpr char kIsTraining[] = "is_training";
@@ -143,6 +150,29 @@ struct TensorToHashBucket {
   int string_to_hash_bucket = kMissingIndex;
 };
 
+// Gather of rows of `params`, followed by a sparse segment reduction of the
+// gathered rows, as in embedding_lookup_sparse.
+struct GatherWithSparseSegmentReduction {
+  GatherWithSparseSegmentReduction() = default;
+  GatherWithSparseSegmentReduction(int gather, int segment_reduction)
+      : gather(gather), segment_reduction(segment_reduction) {}
+
+  int gather = kMissingIndex;
+  int segment_reduction = kMissingIndex;
+};
+
+// Attention: BatchMatMul(Softmax(BatchMatMul(query, key^T) * scale + mask),
+// value), where the scaling and the mask are optional.
+struct Attention {
+  int scores = kMissingIndex;
+  int scale = kMissingIndex;
+  int mask = kMissingIndex;
+  int softmax = kMissingIndex;
+  int attention = kMissingIndex;
+  int mask_port = 0;
+  float scale_value = 1.0f;
+};
+
 // Pad followed by Conv3D/FusedConv3D
 struct PadWithConv3D {
   PadWithConv3D() = default;
@@ -1832,6 +1862,245 @@ bool FindTensorToHashBucket(const RemapperContext& ctx, int node_index,
   return true;
 }
 
+bool IsSparseSegmentReduction(const NodeDef& node) {
+  const auto& op = node.op();
+  return op == "SparseSegmentSum" || op == "SparseSegmentMean" ||
+         op == "SparseSegmentSqrtN" ||
+         op == "SparseSegmentSumWithNumSegments" ||
+         op == "SparseSegmentMeanWithNumSegments" ||
+         op == "SparseSegmentSqrtNWithNumSegments";
+}
+
+bool IsGatherOfRows(const NodeDef& node) {
+  return node.op() == "Gather" || node.op() == "GatherV2";
+}
+
+bool FindGatherWithSparseSegmentReduction(
+    const RemapperContext& ctx, int node_index,
+    GatherWithSparseSegmentReduction* matched) {
+  // Root of the pattern must be a sparse segment reduction.
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const auto* node_def = node_view->node();
+
+  if (!IsSparseSegmentReduction(*node_def) || !NodeIsOnCpu(node_def) ||
+      HasControlFaninOrFanout(*node_view) ||
+      node_view->NumRegularFanins() < 3 || !node_def->attr().contains("Tidx"))
+    return false;
+
+  // The data of the reduction must be a Gather that is only used by it.
+  const auto* gather_node_view = node_view->GetRegularFanin(0).node_view();
+  const auto* gather_node_def = gather_node_view->node();
+
+  if (!IsGatherOfRows(*gather_node_def) || !NodeIsOnCpu(gather_node_def) ||
+      HasControlFaninOrFanout(*gather_node_view) ||
+      !HasAtMostOneFanoutAtPort0(*gather_node_view) ||
+      IsInPreserveSet(ctx, gather_node_def) ||
+      !gather_node_def->attr().contains("Tindices"))
+    return false;
+
+  // GatherV2 must gather along axis 0, without batch dimensions.
+  if (gather_node_def->op() == "GatherV2") {
+    int batch_dims = 0;
+    if (TryGetNodeAttr(*gather_node_def, "batch_dims", &batch_dims) &&
+        batch_dims != 0)
+      return false;
+
+    if (gather_node_view->NumRegularFanins() < 3) return false;
+    const auto* axis_node_def =
+        gather_node_view->GetRegularFanin(2).node_view()->node();
+    Tensor axis;
+    if (!IsConstant(*axis_node_def) ||
+        !axis.FromProto(axis_node_def->attr().at("value").tensor()) ||
+        axis.NumElements() != 1)
+      return false;
+    const int64_t axis_value = axis.dtype() == DT_INT32
+                                   ? axis.flat<int32>()(0)
+                                   : axis.flat<int64_t>()(0);
+    if (axis_value != 0) return false;
+  }
+
+  // The ids must be a vector, so that every gathered row is a row of params.
+  if (!ctx.graph_properties.HasInputProperties(gather_node_def->name()))
+    return false;
+  const auto& props =
+      ctx.graph_properties.GetInputProperties(gather_node_def->name());
+  if (props.size() < 2) return false;
+  const TensorShapeProto& ids_shape = props[1].shape();
+  if (ids_shape.unknown_rank() || ids_shape.dim_size() != 1) return false;
+
+  // We successfully found a Gather + SparseSegmentReduction pattern.
+  const GatherWithSparseSegmentReduction pattern{gather_node_view->node_index(),
+                                                 node_index};
+  *matched = pattern;
+
+  return true;
+}
+
+bool IsBatchMatMulWithSingleType(const NodeDef& node) {
+  return node.op() == "BatchMatMul" || node.op() == "BatchMatMulV2";
+}
+
+// Returns true if the dimensions of `lhs` and `rhs` are known to be equal,
+// either because they are the same size or the same symbolic dimension.
+bool DimsAreEqual(const TensorShapeProto::Dim& lhs,
+                  const TensorShapeProto::Dim& rhs) {
+  return lhs.size() == rhs.size() && lhs.size() != -1;
+}
+
+// Returns true if the shapes of `lhs` and `rhs` have a known rank of at least
+// 3, and the same batch dimensions.
+bool HaveSameBatchDims(const TensorShapeProto& lhs,
+                       const TensorShapeProto& rhs) {
+  if (lhs.unknown_rank() || rhs.unknown_rank() || lhs.dim_size() < 3 ||
+      lhs.dim_size() != rhs.dim_size())
+    return false;
+  for (int i = 0; i < lhs.dim_size() - 2; ++i) {
+    if (!DimsAreEqual(lhs.dim(i), rhs.dim(i))) return false;
+  }
+  return true;
+}
+
+// Returns true if `node` is a float scalar constant, and stores its value.
+bool GetScalarFloatConstant(const NodeDef& node, float* value) {
+  if (!IsConstant(node) || !HasDataType(&node, DT_FLOAT, "dtype")) return false;
+  Tensor tensor;
+  if (!tensor.FromProto(node.attr().at("value").tensor()) ||
+      tensor.NumElements() != 1)
+    return false;
+  *value = tensor.flat<float>()(0);
+  return true;
+}
+
+bool FindAttention(const RemapperContext& ctx, int node_index,
+                   Attention* matched) {
+  // Root of the pattern must be the BatchMatMul of the attention weights with
+  // the values.
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const auto* node_def = node_view->node();
+
+  if (!IsBatchMatMulWithSingleType(*node_def) || !NodeIsOnCpu(node_def) ||
+      !HasDataType(node_def, DT_FLOAT) || HasControlFaninOrFanout(*node_view) ||
+      node_view->NumRegularFanins() != 2)
+    return false;
+  bool adj_x = false;
+  bool adj_y = false;
+  if (!TryGetNodeAttr(*node_def, "adj_x", &adj_x) || adj_x ||
+      !TryGetNodeAttr(*node_def, "adj_y", &adj_y) || adj_y)
+    return false;
+
+  // Returns true if the node can be fused, i.e. only the next node of the
+  // pattern reads it.
+  const auto is_fusable = [&ctx](const utils::MutableNodeView& view) {
+    const NodeDef* def = view.node();
+    return NodeIsOnCpu(def) && HasDataType(def, DT_FLOAT) &&
+           !HasControlFaninOrFanout(view) && HasAtMostOneFanoutAtPort0(view) &&
+           !IsInPreserveSet(ctx, def);
+  };
+
+  // The attention weights must be a Softmax.
+  Attention pattern;
+  auto* softmax_view = node_view->GetRegularFanin(0).node_view();
+  if (!IsSoftmax(*softmax_view->node()) || !is_fusable(*softmax_view))
+    return false;
+  pattern.softmax = softmax_view->node_index();
+
+  // Returns true if `view` is the scores, or the scaled scores.
+  const auto is_scores = [](const utils::MutableNodeView& view) {
+    if (IsBatchMatMulWithSingleType(*view.node())) return true;
+    if (!IsMul(*view.node()) || view.NumRegularFanins() != 2) return false;
+    return IsBatchMatMulWithSingleType(
+               *view.GetRegularFanin(0).node_view()->node()) ||
+           IsBatchMatMulWithSingleType(
+               *view.GetRegularFanin(1).node_view()->node());
+  };
+
+  // Of the optionally masked ...
+  auto* input_view = softmax_view->GetRegularFanin(0).node_view();
+  if (IsAdd(*input_view->node()) && is_fusable(*input_view) &&
+      input_view->NumRegularFanins() == 2) {
+    for (int port = 0; port < 2; ++port) {
+      auto* scores_view = input_view->GetRegularFanin(port).node_view();
+      if (is_scores(*scores_view)) {
+        pattern.mask = input_view->node_index();
+        pattern.mask_port = 1 - port;
+        input_view = scores_view;
+        break;
+      }
+    }
+    if (pattern.mask == kMissingIndex) return false;
+  }
+
+  // ... and optionally scaled ...
+  if (IsMul(*input_view->node()) && is_fusable(*input_view) &&
+      input_view->NumRegularFanins() == 2) {
+    for (int port = 0; port < 2; ++port) {
+      const NodeDef* scale =
+          input_view->GetRegularFanin(1 - port).node_view()->node();
+      if (GetScalarFloatConstant(*scale, &pattern.scale_value)) {
+        pattern.scale = input_view->node_index();
+        input_view = input_view->GetRegularFanin(port).node_view();
+        break;
+      }
+    }
+    if (pattern.scale == kMissingIndex) return false;
+  }
+
+  // ... scores of the queries against the keys.
+  const NodeDef* scores_def = input_view->node();
+  if (!IsBatchMatMulWithSingleType(*scores_def) || !is_fusable(*input_view) ||
+      input_view->NumRegularFanins() != 2)
+    return false;
+  if (!TryGetNodeAttr(*scores_def, "adj_x", &adj_x) || adj_x ||
+      !TryGetNodeAttr(*scores_def, "adj_y", &adj_y) || !adj_y)
+    return false;
+  pattern.scores = input_view->node_index();
+
+  // The fused kernel does not broadcast the queries, keys and values.
+  if (!ctx.graph_properties.HasInputProperties(scores_def->name()) ||
+      !ctx.graph_properties.HasInputProperties(node_def->name()) ||
+      !ctx.graph_properties.HasOutputProperties(scores_def->name()))
+    return false;
+  const auto& scores_props =
+      ctx.graph_properties.GetInputProperties(scores_def->name());
+  const auto& attention_props =
+      ctx.graph_properties.GetInputProperties(node_def->name());
+  const auto& scores_output_props =
+      ctx.graph_properties.GetOutputProperties(scores_def->name());
+  if (scores_props.size() != 2 || attention_props.size() != 2 ||
+      scores_output_props.empty())
+    return false;
+  const TensorShapeProto& query_shape = scores_props[0].shape();
+  const TensorShapeProto& scores_shape = scores_output_props[0].shape();
+  if (!HaveSameBatchDims(query_shape, scores_props[1].shape()) ||
+      !HaveSameBatchDims(query_shape, attention_props[1].shape()) ||
+      !HaveSameBatchDims(query_shape, scores_shape))
+    return false;
+
+  // The mask must broadcast to the scores, and not the scores to the mask.
+  if (pattern.mask != kMissingIndex) {
+    const NodeDef* mask_def = ctx.graph_view.GetNode(pattern.mask)->node();
+    if (!ctx.graph_properties.HasInputProperties(mask_def->name()))
+      return false;
+    const auto& mask_props =
+        ctx.graph_properties.GetInputProperties(mask_def->name());
+    if (mask_props.size() != 2) return false;
+    const TensorShapeProto& mask_shape = mask_props[pattern.mask_port].shape();
+    const int offset = scores_shape.dim_size() - mask_shape.dim_size();
+    if (mask_shape.unknown_rank() || offset < 0) return false;
+    for (int i = 0; i < mask_shape.dim_size(); ++i) {
+      if (mask_shape.dim(i).size() != 1 &&
+          !DimsAreEqual(mask_shape.dim(i), scores_shape.dim(offset + i)))
+        return false;
+    }
+  }
+
+  // We successfully found an attention pattern.
+  pattern.attention = node_index;
+  *matched = pattern;
+
+  return true;
+}
+
 bool FindFusedBatchMatMul(RemapperContext* ctx, int node_index,
                           std::map<string, int>* matched_nodes_map,
                           std::set<int>* remove_node_indices) {
@@ -2945,6 +3214,92 @@ Status AddTensorToHashBucketNode(RemapperContext* ctx,
   return OkStatus();
 }
 
+Status AddGatherWithSparseSegmentReductionNodes(
+    RemapperContext* ctx, const GatherWithSparseSegmentReduction& matched,
+    std::vector<bool>* invalidated_nodes, std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& gather = graph->node(matched.gather);
+  const NodeDef& segment_reduction = graph->node(matched.segment_reduction);
+  VLOG(2) << "Fuse Gather with " << segment_reduction.op() << ":"
+          << " gather=" << gather.name()
+          << " segment_reduction=" << segment_reduction.name();
+
+  // The reduction reads rows params[ids[indices]], so it can read them from
+  // `params` directly with the indices gathered from `ids`. This avoids
+  // materializing the gathered rows, which can be much larger than `ids`.
+  NodeDef gather_indices;
+  gather_indices.set_name(
+      AddPrefixToNodeName("GatherIndices", segment_reduction.name()));
+  gather_indices.set_op("Gather");
+  gather_indices.set_device(segment_reduction.device());
+  gather_indices.add_input(gather.input(1));             // 0: ids
+  gather_indices.add_input(segment_reduction.input(1));  // 1: indices
+  auto* gather_indices_attr = gather_indices.mutable_attr();
+  (*gather_indices_attr)["Tparams"] = gather.attr().at("Tindices");
+  (*gather_indices_attr)["Tindices"] = segment_reduction.attr().at("Tidx");
+  (*gather_indices_attr)["validate_indices"].set_b(true);
+
+  NodeDef reduction = segment_reduction;
+  reduction.set_input(0, gather.input(0));  // 0: params
+  reduction.set_input(1, gather_indices.name());
+  (*reduction.mutable_attr())["Tidx"] = gather.attr().at("Tindices");
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  Status status;
+  mutation->AddNode(std::move(gather_indices), &status);
+  TF_RETURN_IF_ERROR(status);
+  mutation->AddNode(std::move(reduction), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.segment_reduction] = true;
+  (*nodes_to_delete)[matched.gather] = true;
+
+  return OkStatus();
+}
+
+Status AddFusedAttentionNode(RemapperContext* ctx, const Attention& matched,
+                             std::vector<bool>* invalidated_nodes,
+                             std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& scores = graph->node(matched.scores);
+  const NodeDef& attention = graph->node(matched.attention);
+  VLOG(2) << "Fuse attention:"
+          << " scores=" << scores.name()
+          << " softmax=" << graph->node(matched.softmax).name()
+          << " attention=" << attention.name();
+
+  NodeDef fused_op;
+  fused_op.set_name(attention.name());
+  fused_op.set_op(kFusedAttention);
+  fused_op.set_device(attention.device());
+  fused_op.add_input(scores.input(0));     // 0: query
+  fused_op.add_input(scores.input(1));     // 1: key
+  fused_op.add_input(attention.input(1));  // 2: value
+  if (matched.mask != kMissingIndex) {
+    fused_op.add_input(graph->node(matched.mask).input(matched.mask_port));
+  }
+
+  auto* attr = fused_op.mutable_attr();
+  (*attr)["T"] = attention.attr().at("T");
+  SetAttrValue(matched.mask != kMissingIndex ? 1 : 0, &(*attr)["num_args"]);
+  SetAttrValue(matched.scale_value, &(*attr)["scale"]);
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  Status status;
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.attention] = true;
+  (*nodes_to_delete)[matched.scores] = true;
+  if (matched.scale != kMissingIndex) (*nodes_to_delete)[matched.scale] = true;
+  if (matched.mask != kMissingIndex) (*nodes_to_delete)[matched.mask] = true;
+  (*nodes_to_delete)[matched.softmax] = true;
+
+  return OkStatus();
+}
+
 Status AddFusedBatchMatMul(RemapperContext* ctx,
                            const std::map<string, int>& matched_nodes_map,
                            const std::set<int>& remove_node_indices,
@@ -3240,14 +3595,32 @@ bool RequiresInferredShapes(const RemapperContext& ctx, int node_index) {
     return false;
   };
 
+  // Candidate for a Gather + SparseSegmentReduction fusion.
+  const auto is_gather_segment_reduction_candidate = [&]() -> bool {
+    if (!IsSparseSegmentReduction(*node_def)) return false;
+
+    if (node_view->NumRegularFanins() < 1) return false;
+    return IsGatherOfRows(*node_view->GetRegularFanin(0).node_view()->node());
+  };
+
+  // Candidate for an attention fusion.
+  const auto is_attention_candidate = [&]() -> bool {
+    if (!IsBatchMatMulWithSingleType(*node_def)) return false;
+
+    if (node_view->NumRegularFanins() < 1) return false;
+    return IsSoftmax(*node_view->GetRegularFanin(0).node_view()->node());
+  };
+
   if (IsMKLEnabled())
     return is_batch_norm_candidate() || is_batch_norm_fusion_candidate() ||
            IsContractionWithAdd(ctx, node_index) ||
-           is_relu_biasadd_conv_candidate();
+           is_relu_biasadd_conv_candidate() ||
+           is_gather_segment_reduction_candidate() || is_attention_candidate();
 
   return is_relu_biasadd_conv_candidate() || is_batch_norm_candidate() ||
          is_batch_norm_fusion_candidate() ||
-         is_batch_norm_grad_fusion_candidate();
+         is_batch_norm_grad_fusion_candidate() ||
+         is_gather_segment_reduction_candidate() || is_attention_candidate();
 }
 }  // namespace
 
@@ -3381,6 +3754,16 @@ Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
       continue;
     }
 
+    // Remap BatchMatMul+[Mul]+[Add]+Softmax+BatchMatMul into the
+    // _FusedAttention, which never materializes the attention scores.
+    Attention attention;
+    if (allow_non_differentiable_rewrites &&
+        FindAttention(ctx, i, &attention)) {
+      TF_RETURN_IF_ERROR(AddFusedAttentionNode(
+          &ctx, attention, &invalidated_nodes, &nodes_to_delete));
+      continue;
+    }
+
     // Remap {Conv2D,DepthwiseConv2D,MatMul}+BiasAdd into the
     // _Fused{Conv2D,DepthwiseConv2dNative,MatMul}
     ContractionWithBiasAdd contract_with_bias;
@@ -3466,6 +3849,17 @@ Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
       continue;
     }
 
+    // Remap Gather+SparseSegmentReduction so that the reduction reads the
+    // rows of the Gather's params directly.
+    GatherWithSparseSegmentReduction gather_with_segment_reduction;
+    if (FindGatherWithSparseSegmentReduction(ctx, i,
+                                             &gather_with_segment_reduction)) {
+      TF_RETURN_IF_ERROR(AddGatherWithSparseSegmentReductionNodes(
+          &ctx, gather_with_segment_reduction, &invalidated_nodes,
+          &nodes_to_delete));
+      continue;
+    }
+
     // During inference, most of the inputs to FusedBatchNorm are constant, and
     // we can therefore replace the op with a much cheaper set of primitives.
     FusedBatchNorm fused_batch_norm;
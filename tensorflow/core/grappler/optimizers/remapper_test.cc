@@ -1352,6 +1352,130 @@ TEST_F(RemapperTensorToHashBucketTest, I32) { RunTest<DT_INT32>(); }
 
 TEST_F(RemapperTensorToHashBucketTest, I64) { RunTest<DT_INT64>(); }
 
+TEST_F(RemapperTest, FuseGatherWithSparseSegmentSum) {
+  using ::tensorflow::ops::Placeholder;
+
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto params_shape = ops::Placeholder::Shape({10, 4});
+  auto params = Placeholder(s.WithOpName("params"), DT_FLOAT, params_shape);
+  auto ids = ops::Const(s.WithOpName("ids"), {7, 2, 9}, {3});
+  auto axis = ops::Const(s.WithOpName("axis"), 0);
+  auto gather = ops::GatherV2(s.WithOpName("gather"), params, ids, axis);
+  auto indices = ops::Const(s.WithOpName("indices"), {0, 1, 2, 1, 0}, {5});
+  auto segment_ids =
+      ops::Const(s.WithOpName("segment_ids"), {0, 0, 1, 2, 2}, {5});
+  auto segment_sum = ops::SparseSegmentSum(s.WithOpName("segment_sum"),
+                                           gather, indices, segment_ids);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), segment_sum);
+
+  auto params_t = GenerateRandomTensor<DT_FLOAT>({10, 4});
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  item.feed = {{"params", params_t}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  // Place all nodes on CPU.
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "gather");
+    if (node.name() == "segment_sum") {
+      EXPECT_EQ(node.op(), "SparseSegmentSum");
+      ASSERT_GE(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "params");
+      EXPECT_EQ(node.input(2), "segment_ids");
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 1);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  ASSERT_EQ(tensors_expected.size(), 1);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  ASSERT_EQ(tensors.size(), 1);
+  test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-6);
+}
+
+TEST_F(RemapperTest, FuseAttention) {
+  using ::tensorflow::ops::Placeholder;
+
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto query_shape = ops::Placeholder::Shape({2, 4, 8, 16});
+  auto key_shape = ops::Placeholder::Shape({2, 4, 12, 16});
+  auto value_shape = ops::Placeholder::Shape({2, 4, 12, 8});
+  auto mask_shape = ops::Placeholder::Shape({2, 1, 1, 12});
+
+  auto query = Placeholder(s.WithOpName("query"), DT_FLOAT, query_shape);
+  auto key = Placeholder(s.WithOpName("key"), DT_FLOAT, key_shape);
+  auto value = Placeholder(s.WithOpName("value"), DT_FLOAT, value_shape);
+  auto mask = Placeholder(s.WithOpName("mask"), DT_FLOAT, mask_shape);
+  auto scores = ops::BatchMatMulV2(s.WithOpName("scores"), query, key,
+                                   ops::BatchMatMulV2::AdjY(true));
+  auto scale = ops::Const(s.WithOpName("scale"), 0.25f);
+  auto scaled = ops::Mul(s.WithOpName("scaled"), scores, scale);
+  auto masked = ops::AddV2(s.WithOpName("masked"), scaled, mask);
+  auto softmax = ops::Softmax(s.WithOpName("softmax"), masked);
+  auto attention =
+      ops::BatchMatMulV2(s.WithOpName("attention"), softmax, value);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), attention);
+
+  auto query_t = GenerateRandomTensor<DT_FLOAT>({2, 4, 8, 16});
+  auto key_t = GenerateRandomTensor<DT_FLOAT>({2, 4, 12, 16});
+  auto value_t = GenerateRandomTensor<DT_FLOAT>({2, 4, 12, 8});
+  auto mask_t = GenerateRandomTensor<DT_FLOAT>({2, 1, 1, 12});
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  item.feed = {{"query", query_t},
+               {"key", key_t},
+               {"value", value_t},
+               {"mask", mask_t}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  // Place all nodes on CPU.
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "scores");
+    EXPECT_NE(node.name(), "softmax");
+    if (node.name() == "attention") {
+      EXPECT_EQ(node.op(), "_FusedAttention");
+      ASSERT_EQ(node.input_size(), 4);
+      EXPECT_EQ(node.input(0), "query");
+      EXPECT_EQ(node.input(1), "key");
+      EXPECT_EQ(node.input(2), "value");
+      EXPECT_EQ(node.input(3), "mask");
+      EXPECT_EQ(node.attr().at("num_args").i(), 1);
+      EXPECT_FLOAT_EQ(node.attr().at("scale").f(), 0.25f);
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 1);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  ASSERT_EQ(tensors_expected.size(), 1);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  ASSERT_EQ(tensors.size(), 1);
+  test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-5);
+}
+
 class RemapperFuseMatMulWithBiasTest : public RemapperTest {
  public:
   template <DataType DTYPE>
@@ -34,6 +34,7 @@ limitations under the License.
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/platform/threadpool_interface.h"
 #include "tensorflow/core/platform/types.h"
@@ -47,6 +48,7 @@ class ASBSBatch;
 
 template <typename TaskType>
 class ASBSQueue;
+class ASBSLatencyTuner;
 }  // namespace internal
 
 // Shared batch scheduler designed to minimize latency. The scheduler keeps
@@ -168,6 +170,25 @@ class AdaptiveSharedBatchScheduler
                          int max_batch_size,
                          std::vector<std::unique_ptr<TaskType>>* output_tasks)>
         split_input_task_func;
+
+    // If positive, the latency target of the queue in microseconds, measured
+    // from the creation of a batch until it is processed, i.e. including both
+    // queueing and execution time. The queue then continuously tunes the size
+    // at which it closes batches (within 'max_batch_size' and, if specified,
+    // 'allowed_batch_sizes') and their timeout (within 'batch_timeout_micros')
+    // so that the 'target_latency_percentile' observed batch latency stays
+    // below the target: over the target it first shortens the timeout and then
+    // shrinks batches, and well under it it grows batches back and then
+    // lengthens the timeout again.
+    int64_t target_latency_micros = 0;
+    // Percentile of the batch latency compared against the target.
+    double target_latency_percentile = 99.0;
+    // Number of processed batches between two adjustments.
+    int64_t latency_tuning_window = 100;
+    // If not empty, the batch sizes the tuned batch size is chosen from, in
+    // increasing order and not exceeding 'max_batch_size'. Otherwise powers of
+    // two up to 'max_batch_size' are used.
+    std::vector<int32> allowed_batch_sizes;
   };
 
   using BatchProcessor = std::function<void(std::unique_ptr<Batch<TaskType>>)>;
@@ -328,6 +349,9 @@ class ASBSQueue : public BatchScheduler<TaskType> {
 
   std::shared_ptr<AdaptiveSharedBatchScheduler<TaskType>> scheduler_;
   const QueueOptions options_;
+  // Null unless 'options_.target_latency_micros' is positive. Shared with the
+  // batches, which may be processed after the queue is destroyed.
+  const std::shared_ptr<ASBSLatencyTuner> latency_tuner_;
   // Owned by scheduler_.
   ASBSBatch<TaskType>* current_batch_ TF_GUARDED_BY(mu_) = nullptr;
   int64_t num_enqueued_batches_ TF_GUARDED_BY(mu_) = 0;
@@ -336,16 +360,114 @@ class ASBSQueue : public BatchScheduler<TaskType> {
   TF_DISALLOW_COPY_AND_ASSIGN(ASBSQueue);
 };
 
+// Tunes the batch size and batch timeout of a queue so that the configured
+// percentile of the latency of its batches stays below a target.
+class ASBSLatencyTuner {
+ public:
+  // The tuned values start at the largest batch size and at
+  // 'max_batch_timeout_micros'.
+  ASBSLatencyTuner(int max_batch_size,
+                   const std::vector<int32>& allowed_batch_sizes,
+                   int64_t max_batch_timeout_micros,
+                   int64_t target_latency_micros,
+                   double target_latency_percentile, int64_t window_size)
+      : max_batch_timeout_micros_(max_batch_timeout_micros),
+        target_latency_micros_(target_latency_micros),
+        target_latency_percentile_(target_latency_percentile),
+        window_size_(window_size),
+        batch_timeout_micros_(max_batch_timeout_micros) {
+    if (allowed_batch_sizes.empty()) {
+      for (int size = 1; size < max_batch_size; size *= 2) {
+        batch_sizes_.push_back(size);
+      }
+      batch_sizes_.push_back(max_batch_size);
+    } else {
+      batch_sizes_.assign(allowed_batch_sizes.begin(),
+                          allowed_batch_sizes.end());
+    }
+    batch_size_index_ = batch_sizes_.size() - 1;
+    latencies_micros_.reserve(window_size_);
+  }
+
+  // The size at which batches are currently closed.
+  int max_batch_size() const {
+    mutex_lock l(mu_);
+    return batch_sizes_[batch_size_index_];
+  }
+
+  // The timeout of the batches currently created.
+  int64_t batch_timeout_micros() const {
+    mutex_lock l(mu_);
+    return batch_timeout_micros_;
+  }
+
+  // Records the latency of a processed batch, and adjusts the batch size and
+  // timeout once per 'window_size' batches.
+  void RecordLatency(int64_t latency_micros) {
+    mutex_lock l(mu_);
+    latencies_micros_.push_back(latency_micros);
+    if (latencies_micros_.size() < window_size_) return;
+
+    const size_t rank = std::min(
+        latencies_micros_.size() - 1,
+        static_cast<size_t>(target_latency_percentile_ / 100 *
+                            latencies_micros_.size()));
+    std::nth_element(latencies_micros_.begin(),
+                     latencies_micros_.begin() + rank, latencies_micros_.end());
+    const int64_t observed_latency_micros = latencies_micros_[rank];
+    latencies_micros_.clear();
+
+    if (observed_latency_micros > target_latency_micros_) {
+      // Waiting less for batches to fill up is the cheapest way to cut
+      // latency, so only shrink batches once the timeout is exhausted.
+      if (batch_timeout_micros_ > 0) {
+        batch_timeout_micros_ /= 2;
+      } else if (batch_size_index_ > 0) {
+        --batch_size_index_;
+      }
+    } else if (observed_latency_micros <
+               kLatencyHeadroom * target_latency_micros_) {
+      if (batch_size_index_ + 1 < batch_sizes_.size()) {
+        ++batch_size_index_;
+      } else if (batch_timeout_micros_ < max_batch_timeout_micros_) {
+        batch_timeout_micros_ = std::min(
+            max_batch_timeout_micros_,
+            std::max(2 * batch_timeout_micros_, kMinBatchTimeoutStepMicros));
+      }
+    }
+  }
+
+ private:
+  // Latencies below this fraction of the target leave room to batch more.
+  static constexpr double kLatencyHeadroom = 0.8;
+  // The smallest non-zero timeout set when lengthening the timeout.
+  static constexpr int64_t kMinBatchTimeoutStepMicros = 100;
+
+  const int64_t max_batch_timeout_micros_;
+  const int64_t target_latency_micros_;
+  const double target_latency_percentile_;
+  const size_t window_size_;
+  std::vector<int> batch_sizes_;
+
+  mutable mutex mu_;
+  size_t batch_size_index_ TF_GUARDED_BY(mu_);
+  int64_t batch_timeout_micros_ TF_GUARDED_BY(mu_);
+  std::vector<int64_t> latencies_micros_ TF_GUARDED_BY(mu_);
+  TF_DISALLOW_COPY_AND_ASSIGN(ASBSLatencyTuner);
+};
+
 // Batch which remembers when and by whom it was created.
 template <typename TaskType>
 class ASBSBatch : public Batch<TaskType> {
  public:
   ASBSBatch(ASBSQueue<TaskType>* queue, int64_t creation_time_micros,
-            int64_t batch_timeout_micros, uint64 traceme_context_id)
+            int64_t batch_timeout_micros, uint64 traceme_context_id,
+            std::shared_ptr<ASBSLatencyTuner> latency_tuner = nullptr)
       : queue_(queue),
         creation_time_micros_(creation_time_micros),
         schedulable_time_micros_(creation_time_micros + batch_timeout_micros),
-        traceme_context_id_(traceme_context_id) {}
+        traceme_context_id_(traceme_context_id),
+        latency_tuner_(std::move(latency_tuner)) {}
 
   ~ASBSBatch() override {}
 
@@ -357,11 +479,18 @@ class ASBSBatch : public Batch<TaskType> {
 
   uint64 traceme_context_id() const { return traceme_context_id_; }
 
+  // The tuner to report the latency of this batch to, if any. Unlike queue(),
+  // it remains valid after the batch is released by the queue.
+  const std::shared_ptr<ASBSLatencyTuner>& latency_tuner() const {
+    return latency_tuner_;
+  }
+
  private:
   ASBSQueue<TaskType>* queue_;
   const int64_t creation_time_micros_;
   const int64_t schedulable_time_micros_;
   const uint64 traceme_context_id_;
+  const std::shared_ptr<ASBSLatencyTuner> latency_tuner_;
   TF_DISALLOW_COPY_AND_ASSIGN(ASBSBatch);
 };
 }  // namespace internal
@@ -461,6 +590,39 @@ Status AdaptiveSharedBatchScheduler<TaskType>::AddQueue(
           options.max_batch_size);
     }
   }
+  if (options.target_latency_micros < 0) {
+    return errors::InvalidArgument(
+        "target_latency_micros must be non-negative; was ",
+        options.target_latency_micros);
+  }
+  if (options.target_latency_micros > 0) {
+    if (options.target_latency_percentile <= 0 ||
+        options.target_latency_percentile > 100) {
+      return errors::InvalidArgument(
+          "target_latency_percentile must be in (0, 100]; was ",
+          options.target_latency_percentile);
+    }
+    if (options.latency_tuning_window <= 0) {
+      return errors::InvalidArgument(
+          "latency_tuning_window must be positive; was ",
+          options.latency_tuning_window);
+    }
+  }
+  int32 last_allowed_batch_size = 0;
+  for (int32 allowed_batch_size : options.allowed_batch_sizes) {
+    if (allowed_batch_size <= last_allowed_batch_size) {
+      return errors::InvalidArgument(
+          "allowed_batch_sizes must be positive and increasing; got ",
+          allowed_batch_size, " after ", last_allowed_batch_size);
+    }
+    last_allowed_batch_size = allowed_batch_size;
+  }
+  if (last_allowed_batch_size > options.max_batch_size) {
+    return errors::InvalidArgument(
+        "allowed_batch_sizes must not exceed max_batch_size; got ",
+        last_allowed_batch_size, " and max_batch_size as ",
+        options.max_batch_size);
+  }
   internal::ASBSQueue<TaskType>* asbs_queue_raw;
   queue->reset(asbs_queue_raw = new internal::ASBSQueue<TaskType>(
                    this->shared_from_this(), options));
@@ -633,9 +795,15 @@ void AdaptiveSharedBatchScheduler<TaskType>::CallbackWrapper(
       profiler::ContextType::kAdaptiveSharedBatchScheduler,
       batch->traceme_context_id());
   const int64_t start_time = batch->creation_time_micros();
+  // The batch is destroyed by the callback.
+  const std::shared_ptr<internal::ASBSLatencyTuner> latency_tuner =
+      batch->latency_tuner();
   callback(std::unique_ptr<Batch<TaskType>>(
       const_cast<internal::ASBSBatch<TaskType>*>(batch)));
   int64_t end_time = GetEnv()->NowMicros();
+  if (latency_tuner != nullptr) {
+    latency_tuner->RecordLatency(end_time - start_time);
+  }
   mutex_lock l(mu_);
   if (is_express) {
     in_flight_express_batches_--;
@@ -701,7 +869,17 @@ template <typename TaskType>
 ASBSQueue<TaskType>::ASBSQueue(
     std::shared_ptr<AdaptiveSharedBatchScheduler<TaskType>> scheduler,
     const QueueOptions& options)
-    : scheduler_(scheduler), options_(options) {}
+    : scheduler_(scheduler),
+      options_(options),
+      latency_tuner_(options.target_latency_micros > 0
+                         ? std::make_shared<ASBSLatencyTuner>(
+                               options.max_batch_size,
+                               options.allowed_batch_sizes,
+                               options.batch_timeout_micros,
+                               options.target_latency_micros,
+                               options.target_latency_percentile,
+                               options.latency_tuning_window)
+                         : nullptr) {}
 
 template <typename TaskType>
 ASBSQueue<TaskType>::~ASBSQueue() {
@@ -735,6 +913,15 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
                                    options_.max_input_task_size.value());
   }
 
+  // The size at which batches are closed, and their timeout, as currently
+  // tuned for the latency target.
+  const int max_batch_size = latency_tuner_ != nullptr
+                                 ? latency_tuner_->max_batch_size()
+                                 : options_.max_batch_size;
+  const int64_t batch_timeout_micros =
+      latency_tuner_ != nullptr ? latency_tuner_->batch_timeout_micros()
+                                : options_.batch_timeout_micros;
+
   std::vector<std::unique_ptr<TaskType>> tasks_to_schedule;
   std::vector<ASBSBatch<TaskType>*> new_batches;
   bool closed_batch = false;
@@ -744,10 +931,17 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
       return errors::Unavailable("The batch scheduling queue is full");
     }
 
+    // The tuned batch size may have shrunk below the size of the current
+    // batch since it was created.
+    if (current_batch_ && current_batch_->size() >= max_batch_size) {
+      current_batch_->Close();
+      closed_batch = true;
+      current_batch_ = nullptr;
+    }
     int remaining_batch_size =
         current_batch_ == nullptr
-            ? options_.max_batch_size
-            : options_.max_batch_size - current_batch_->size();
+            ? max_batch_size
+            : max_batch_size - current_batch_->size();
     if (options_.split_input_task_func == nullptr ||
         size <= remaining_batch_size) {
       // Either we don't allow task splitting or task fits within the current
@@ -758,13 +952,12 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
       // Beyond this point Schedule should not fail, as the caller has been
       // promised that all of the split tasks will be scheduled.
       TF_RETURN_IF_ERROR(options_.split_input_task_func(
-          task, remaining_batch_size, options_.max_batch_size,
-          &tasks_to_schedule));
+          task, remaining_batch_size, max_batch_size, &tasks_to_schedule));
     }
     for (auto& task : tasks_to_schedule) {
       // Can't fit within current batch, close it off and try to create another.
       if (current_batch_ &&
-          current_batch_->size() + task->size() > options_.max_batch_size) {
+          current_batch_->size() + task->size() > max_batch_size) {
         current_batch_->Close();
         closed_batch = true;
         current_batch_ = nullptr;
@@ -776,8 +969,8 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
         // When multiple calls to "ASBS::Schedule" accumulate to one batch, they
         // are processed in the same batch and should share traceme_context_id.
         current_batch_ = new ASBSBatch<TaskType>(
-            this, scheduler_->GetEnv()->NowMicros(),
-            options_.batch_timeout_micros, NewTraceMeContextIdForBatch());
+            this, scheduler_->GetEnv()->NowMicros(), batch_timeout_micros,
+            NewTraceMeContextIdForBatch(), latency_tuner_);
         new_batches.push_back(current_batch_);
       }
 
@@ -797,8 +990,8 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
       bool reached_max_tasks =
           (options_.max_tasks_per_batch.has_value() &&
            current_batch_->num_tasks() >= options_.max_tasks_per_batch.value());
-      if (current_batch_->size() == options_.max_batch_size ||
-          reached_max_tasks) {
+      // A task larger than the tuned batch size gets a batch of its own.
+      if (current_batch_->size() >= max_batch_size || reached_max_tasks) {
         current_batch_->Close();
         closed_batch = true;
         current_batch_ = nullptr;
@@ -482,6 +482,84 @@ TEST(AdaptiveSharedBatchSchedulerTest, TruncateBatches) {
   }
 }
 
+TEST(AdaptiveSharedBatchSchedulerTest, BadLatencyTargetOptions) {
+  std::shared_ptr<AdaptiveSharedBatchScheduler<FakeTask>> scheduler;
+  TF_ASSERT_OK(AdaptiveSharedBatchScheduler<FakeTask>::Create({}, &scheduler));
+  auto queue_callback = [](std::unique_ptr<Batch<FakeTask>> batch) {};
+  std::unique_ptr<BatchScheduler<FakeTask>> queue;
+
+  AdaptiveSharedBatchScheduler<FakeTask>::QueueOptions queue_options;
+  queue_options.max_batch_size = 8;
+  queue_options.target_latency_micros = 1000;
+  queue_options.target_latency_percentile = 0;
+  EXPECT_FALSE(scheduler->AddQueue(queue_options, queue_callback, &queue).ok());
+  queue_options.target_latency_percentile = 99;
+  queue_options.allowed_batch_sizes = {4, 2, 8};
+  EXPECT_FALSE(scheduler->AddQueue(queue_options, queue_callback, &queue).ok());
+  queue_options.allowed_batch_sizes = {2, 4, 16};
+  EXPECT_FALSE(scheduler->AddQueue(queue_options, queue_callback, &queue).ok());
+  queue_options.allowed_batch_sizes = {2, 4, 8};
+  TF_EXPECT_OK(scheduler->AddQueue(queue_options, queue_callback, &queue));
+}
+
+TEST(AdaptiveSharedBatchSchedulerTest, LatencyTuner) {
+  internal::ASBSLatencyTuner tuner(
+      /*max_batch_size=*/8, /*allowed_batch_sizes=*/{},
+      /*max_batch_timeout_micros=*/1000, /*target_latency_micros=*/100,
+      /*target_latency_percentile=*/50, /*window_size=*/2);
+  EXPECT_EQ(tuner.max_batch_size(), 8);
+  EXPECT_EQ(tuner.batch_timeout_micros(), 1000);
+
+  // Over the target, the timeout is halved first.
+  tuner.RecordLatency(150);
+  EXPECT_EQ(tuner.batch_timeout_micros(), 1000);
+  tuner.RecordLatency(150);
+  EXPECT_EQ(tuner.batch_timeout_micros(), 500);
+  EXPECT_EQ(tuner.max_batch_size(), 8);
+
+  // Then batches shrink.
+  while (tuner.batch_timeout_micros() > 0) {
+    tuner.RecordLatency(150);
+    tuner.RecordLatency(150);
+  }
+  EXPECT_EQ(tuner.max_batch_size(), 8);
+  tuner.RecordLatency(150);
+  tuner.RecordLatency(150);
+  EXPECT_EQ(tuner.max_batch_size(), 4);
+
+  // Close to the target, nothing changes.
+  tuner.RecordLatency(90);
+  tuner.RecordLatency(90);
+  EXPECT_EQ(tuner.max_batch_size(), 4);
+  EXPECT_EQ(tuner.batch_timeout_micros(), 0);
+
+  // Well under the target, batches grow back first and then the timeout.
+  tuner.RecordLatency(10);
+  tuner.RecordLatency(10);
+  EXPECT_EQ(tuner.max_batch_size(), 8);
+  EXPECT_EQ(tuner.batch_timeout_micros(), 0);
+  tuner.RecordLatency(10);
+  tuner.RecordLatency(10);
+  EXPECT_EQ(tuner.batch_timeout_micros(), 100);
+  tuner.RecordLatency(10);
+  tuner.RecordLatency(10);
+  EXPECT_EQ(tuner.batch_timeout_micros(), 200);
+}
+
+TEST(AdaptiveSharedBatchSchedulerTest, LatencyTunerAllowedBatchSizes) {
+  internal::ASBSLatencyTuner tuner(
+      /*max_batch_size=*/100, /*allowed_batch_sizes=*/{16, 64},
+      /*max_batch_timeout_micros=*/0, /*target_latency_micros=*/100,
+      /*target_latency_percentile=*/99, /*window_size=*/1);
+  EXPECT_EQ(tuner.max_batch_size(), 64);
+  tuner.RecordLatency(150);
+  EXPECT_EQ(tuner.max_batch_size(), 16);
+  tuner.RecordLatency(150);
+  EXPECT_EQ(tuner.max_batch_size(), 16);
+  tuner.RecordLatency(10);
+  EXPECT_EQ(tuner.max_batch_size(), 64);
+}
+
 TEST(AdaptiveSharedBatchSchedulerTest, MaxTasksPerBatch) {
   mutex mu;
   int processed_batches = 0;
@@ -26,7 +26,6 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/request_cost_accessor.h"
 #include "tensorflow/core/common_runtime/request_cost_accessor_registry.h"
 #include "tensorflow/core/framework/ops_util.h"
-#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/kernels/batching_util/concat_split_util.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
@@ -491,10 +490,10 @@ Status BatchResourceBase::ConcatInputTensors(
         for (int i = 0; i < num_output; ++i) {
           Tensor output_tensor;
 
-          // Concat would memcpy each input tensor to one output tensor.
-          // In this context, Concat can be further optimized to get rid of
-          // some (probably all) memcpy when input tensors are slices of
-          // another copy.
+          // Concat would memcpy each input tensor to one output tensor, unless
+          // there is a single one. In this context, Concat can be further
+          // optimized to get rid of some (probably all) memcpy when input
+          // tensors are slices of another copy.
           std::vector<Tensor> to_concatenate;
           to_concatenate.reserve(output->size());
           for (int j = 0; j < output->size(); ++j) {
@@ -609,9 +608,12 @@ Status BatchResourceBase::SplitOutputTensors(
           "the 0th dimension sizes of the input tensors");
     }
 
+    // The per-task outputs alias 'output_tensor' whenever its rows are
+    // suitably aligned, and are only copied out otherwise.
     std::vector<Tensor> split_tensor;
-    const Status split_status = tensor::Split(
-        output_tensor, task_sizes_plus_optional_padding, &split_tensor);
+    const Status split_status =
+        Split(batch->task(0).context, output_tensor,
+              task_sizes_plus_optional_padding, &split_tensor);
     DCHECK(split_status.ok()) << split_status.ToString();
     if (!split_status.ok()) {
       return errors::Internal("Tensor split operation failed: ",
@@ -890,7 +892,10 @@ void BatchResourceBase::SplitBatchCosts(
     std::vector<std::unique_ptr<CostMeasurement>>& batch_cost_measurements,
     const int64_t processed_size, BatchT& batch) {
   for (auto& batch_cost_measurement : batch_cost_measurements) {
-    if (batch_cost_measurement->GetTotalCost() <= absl::ZeroDuration()) {
+    // Read once, as the cost of some measurements (e.g. CPU time) keeps
+    // growing.
+    const absl::Duration total_cost = batch_cost_measurement->GetTotalCost();
+    if (total_cost <= absl::ZeroDuration()) {
       return;
     }
     if (batch.size() == 0) {  // NOLINT: empty() checks the batch contains 0
@@ -905,7 +910,6 @@ void BatchResourceBase::SplitBatchCosts(
       return;
     }
     const absl::string_view cost_type = batch_cost_measurement->GetCostType();
-    const absl::Duration total_cost = batch_cost_measurement->GetTotalCost();
 
     for (int i = 0; i < batch.num_tasks(); i++) {
       RequestCost* request_cost = batch.task(i).request_cost;
@@ -64,6 +64,13 @@ class BatchTask {
   // Returns the size of the task, in terms of how much it contributes to the
   // size of a batch. (A batch's size is the sum of its task sizes.)
   virtual size_t size() const = 0;
+
+  // Returns the time, in microseconds as reported by the scheduler's Env,
+  // after which the task is no longer worth processing. Zero (the default)
+  // means the task has no deadline. Schedulers that support deadlines may drop
+  // expired tasks instead of placing them in a batch; see
+  // SharedBatchScheduler::QueueOptions::expired_task_callback.
+  virtual uint64 deadline_micros() const { return 0; }
 };
 
 // A thread-safe collection of BatchTasks, to be executed together in some
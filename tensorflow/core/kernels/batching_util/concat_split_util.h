@@ -69,6 +69,13 @@ Status Concat(OpKernelContext* context, const gtl::ArraySlice<Tensor> inputs,
     output_dim0 += input.dim_size(0);
   }
 
+  // Special case: a single input is its own concatenation, so share its
+  // buffer instead of copying it (e.g. a batch of one task without padding).
+  if (inputs.size() == 1) {
+    *output = inputs[0];
+    return OkStatus();
+  }
+
   TensorShape output_shape(input_shape);
   output_shape.set_dim(0, output_dim0);
   AllocatorAttributes attr;
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <deque>
 #include <functional>
 #include <list>
@@ -84,6 +85,13 @@ namespace serving {
 // BasicBatchScheduler instance, in the sense that it has maximum batch size and
 // timeout parameters, which govern when a batch is eligible to be processed.
 //
+// The round-robin can be skewed in two ways. A queue with a `weight` of w is
+// given up to w consecutive batches per turn, so e.g. with queues A and B
+// having weights 1 and 2 respectively, the servicing pattern is ABBABB... And
+// queues are grouped by `priority`: a batch thread only considers a queue if
+// no queue of a higher priority has a batch ready, which lets e.g. interactive
+// traffic for a model be served ahead of bulk traffic sent to a second queue.
+//
 // Each queue is independently configured with a maximum size (in terms of the
 // maximum number of batches worth of enqueued tasks). For online serving, it is
 // recommended that the queue sizes be configured such that the sum of the sizes
@@ -100,10 +108,6 @@ namespace serving {
 // For bulk processing jobs and throughput-oriented benchmarks, you may want to
 // set the maximum queue size to a large value.
 //
-// TODO(b/26539183): Support queue servicing policies other than round-robin.
-// E.g. let each queue specify a "share" (an int >= 1), so e.g. with queues A
-// and B having shares 1 and 2 respectively, the servicing pattern is ABBABB...
-//
 //
 // PERFORMANCE TUNING: See README.md.
 //
@@ -218,6 +222,28 @@ class SharedBatchScheduler
     // submit batches whose size is in a small set of allowed sizes, that can be
     // done by adding padding in the process-batch callback.
     size_t max_execution_batch_size = 1000;
+
+    // The number of consecutive batches a batch thread takes from this queue
+    // before moving on to the next queue of the same priority. Must be
+    // positive.
+    int weight = 1;
+
+    // The priority class of the queue. Queues of a higher priority are always
+    // asked for a batch before queues of a lower priority; queues of the same
+    // priority share the batch threads according to their weights.
+    int priority = 0;
+
+    // If set, tasks whose deadline (see BatchTask::deadline_micros()) has
+    // passed by the time their batch is dequeued for processing are removed
+    // from the batch and passed to this callback instead, so that they don't
+    // take up batch slots. The callback typically fails the task with a
+    // DEADLINE_EXCEEDED error. It is invoked on a batch thread while that
+    // thread looks for work, so it should be cheap, and it must not submit
+    // tasks to the scheduler.
+    //
+    // Not supported together with `enable_lazy_split`; an invalid-argument
+    // error is returned at queue creation time.
+    std::function<void(std::unique_ptr<TaskType>)> expired_task_callback;
   };
   Status AddQueue(const QueueOptions& options,
                   std::function<void(std::unique_ptr<Batch<TaskType>>)>
@@ -264,6 +290,10 @@ class SharedBatchScheduler
   // available batch thread should grab work.
   typename QueueList::iterator next_queue_to_schedule_ TF_GUARDED_BY(mu_);
 
+  // The number of consecutive batches taken from '*next_queue_to_schedule_',
+  // compared against the queue's weight.
+  int num_batches_from_next_queue_ TF_GUARDED_BY(mu_) = 0;
+
   // Used by idle batch threads to wait for work to enter the system. Notified
   // whenever a batch becomes schedulable.
   condition_variable schedulable_batch_cv_;
@@ -366,6 +396,10 @@ class Queue {
 
   bool closed() const TF_NO_THREAD_SAFETY_ANALYSIS { return closed_.load(); }
 
+  // The scheduling weight and priority class of the queue; see QueueOptions.
+  int weight() const { return options_.weight; }
+  int priority() const { return options_.priority; }
+
  private:
   // Computes the max_execution_batch_size of the queue based on queue options.
   static size_t GetMaxExecutionBatchSize(
@@ -386,6 +420,14 @@ class Queue {
   // Same as IsEmpty(), but assumes the caller already holds a lock on 'mu_'.
   bool IsEmptyInternal() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Moves the tasks of the closed `batch` whose deadline has passed to
+  // `expired_tasks`, keeping the remaining tasks in `batch` (which is replaced
+  // by a new closed batch if any task was removed).
+  void RemoveExpiredTasks(
+      std::unique_ptr<Batch<TaskType>>* batch,
+      std::vector<std::unique_ptr<TaskType>>* expired_tasks)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // Closes the open batch residing at the back of std::deque, and inserts a
   // fresh open batch behind it.
   void StartNewBatch() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
@@ -613,6 +655,17 @@ Status SharedBatchScheduler<TaskType>::AddQueueAfterRewritingOptions(
         options.max_execution_batch_size);
   }
 
+  if (options.weight <= 0) {
+    return errors::InvalidArgument("weight must be positive; was ",
+                                   options.weight);
+  }
+
+  if (options.enable_lazy_split && options.expired_task_callback != nullptr) {
+    return errors::InvalidArgument(
+        "expired_task_callback is not supported when enable_lazy_split is "
+        "enabled.");
+  }
+
   auto schedulable_batch_callback = [this] {
     mutex_lock l(mu_);
     schedulable_batch_cv_.notify_one();
@@ -665,39 +718,75 @@ void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
     BatchUniquePtr* batch_to_process_out) {
   BatchUniquePtr batch_to_process;
   internal::Queue<TaskType>* queue_for_batch = nullptr;
-  const int num_queues = queues_.size();
-  for (int num_queues_tried = 0;
-       (BatchExists(batch_to_process)) && num_queues_tried < num_queues;
-       ++num_queues_tried) {
-    DCHECK(next_queue_to_schedule_ != queues_.end());
 
-    // If a closed queue responds to ScheduleBatch() with nullptr, the queue
-    // will never yield any further batches so we can drop it. To avoid a
-    // race, we take a snapshot of the queue's closedness state *before*
-    // calling ScheduleBatch().
-    const bool queue_closed = (*next_queue_to_schedule_)->closed();
+  // The priority classes of the active queues, highest first.
+  std::vector<int> priorities;
+  for (const auto& queue : queues_) {
+    priorities.push_back(queue->priority());
+  }
+  std::sort(priorities.begin(), priorities.end(), std::greater<int>());
+  priorities.erase(std::unique(priorities.begin(), priorities.end()),
+                   priorities.end());
+
+  for (const int priority : priorities) {
+    // Within a priority class, try the queues in round-robin order starting
+    // at 'next_queue_to_schedule_'.
+    auto it = next_queue_to_schedule_;
+    const int num_queues = queues_.size();
+    for (int num_queues_tried = 0;
+         (BatchExists(batch_to_process)) && num_queues_tried < num_queues;
+         ++num_queues_tried) {
+      if (it == queues_.end()) {
+        // We've hit the end. Wrap to the first queue.
+        it = queues_.begin();
+      }
+      if ((*it)->priority() != priority) {
+        ++it;
+        continue;
+      }
 
-    // Ask '*next_queue_to_schedule_' if it wants us to process a batch.
-    batch_to_process = (*next_queue_to_schedule_)->ScheduleBatch();
+      // If a closed queue responds to ScheduleBatch() with nullptr, the queue
+      // will never yield any further batches so we can drop it. To avoid a
+      // race, we take a snapshot of the queue's closedness state *before*
+      // calling ScheduleBatch().
+      const bool queue_closed = (*it)->closed();
 
-    if (!BatchExists(batch_to_process)) {
-      queue_for_batch = next_queue_to_schedule_->get();
-    }
+      // Ask '*it' if it wants us to process a batch.
+      batch_to_process = (*it)->ScheduleBatch();
 
-    // Advance 'next_queue_to_schedule_'.
-    if (queue_closed && (*next_queue_to_schedule_)->IsEmpty() &&
-        (BatchExists(batch_to_process))) {
-      // We've encountered a closed queue with no work to do. Drop it.
-      DCHECK_NE(queue_for_batch, next_queue_to_schedule_->get());
-      next_queue_to_schedule_ = queues_.erase(next_queue_to_schedule_);
-    } else {
-      ++next_queue_to_schedule_;
+      if (!BatchExists(batch_to_process)) {
+        queue_for_batch = it->get();
+        // Stay on the queue until it has been given 'weight' batches in a
+        // row, then move 'next_queue_to_schedule_' past it.
+        if (it != next_queue_to_schedule_) {
+          next_queue_to_schedule_ = it;
+          num_batches_from_next_queue_ = 0;
+        }
+        if (++num_batches_from_next_queue_ >= (*it)->weight()) {
+          ++next_queue_to_schedule_;
+          num_batches_from_next_queue_ = 0;
+        }
+      } else if (queue_closed && (*it)->IsEmpty()) {
+        // We've encountered a closed queue with no work to do. Drop it.
+        if (it == next_queue_to_schedule_) {
+          next_queue_to_schedule_ = queues_.erase(it);
+          num_batches_from_next_queue_ = 0;
+          it = next_queue_to_schedule_;
+        } else {
+          it = queues_.erase(it);
+        }
+      } else {
+        ++it;
+      }
     }
-    if (next_queue_to_schedule_ == queues_.end() && !queues_.empty()) {
-      // We've hit the end. Wrap to the first queue.
-      next_queue_to_schedule_ = queues_.begin();
+    if (!BatchExists(batch_to_process)) {
+      break;
     }
   }
+  if (next_queue_to_schedule_ == queues_.end()) {
+    next_queue_to_schedule_ = queues_.begin();
+    num_batches_from_next_queue_ = 0;
+  }
   *queue_for_batch_out = queue_for_batch;
   *batch_to_process_out = std::move(batch_to_process);
 }
@@ -1017,28 +1106,80 @@ Queue<TaskType>::ScheduleBatchWithEagerSplit() {
   // The batch to schedule, which we may populate below. (If left as nullptr,
   // that means we are electing not to schedule a batch at this time.)
   std::unique_ptr<Batch<TaskType>> batch_to_schedule;
+  // Tasks dropped from dequeued batches because their deadline has passed.
+  std::vector<std::unique_ptr<TaskType>> expired_tasks;
 
   {
     mutex_lock l(mu_);
 
-    // Consider closing the open batch at this time, to schedule it.
-    if (batches_.size() == 1 && IsOpenBatchSchedulable()) {
-      StartNewBatch();
-    }
+    while (batch_to_schedule == nullptr) {
+      // Consider closing the open batch at this time, to schedule it.
+      if (batches_.size() == 1 && IsOpenBatchSchedulable()) {
+        StartNewBatch();
+      }
 
-    if (batches_.size() >= 2) {
+      if (batches_.size() < 2) {
+        schedulable_batch_ = false;
+        break;
+      }
       // There is at least one closed batch that is ready to be scheduled.
-      ++num_batches_being_processed_;
       batch_to_schedule = std::move(batches_.front());
       batches_.pop_front();
-    } else {
-      schedulable_batch_ = false;
+      if (options_.expired_task_callback != nullptr) {
+        RemoveExpiredTasks(&batch_to_schedule, &expired_tasks);
+      }
+    }
+    // Expired tasks count as a batch being processed until their callbacks
+    // return, so that the queue isn't considered empty (and destroyed) before.
+    if (batch_to_schedule != nullptr || !expired_tasks.empty()) {
+      ++num_batches_being_processed_;
     }
   }
 
+  if (!expired_tasks.empty()) {
+    for (auto& task : expired_tasks) {
+      options_.expired_task_callback(std::move(task));
+    }
+    if (batch_to_schedule == nullptr) {
+      mutex_lock l(mu_);
+      --num_batches_being_processed_;
+      if (empty_notification_ != nullptr && IsEmptyInternal()) {
+        empty_notification_->Notify();
+      }
+    }
+  }
   return batch_to_schedule;
 }
 
+template <typename TaskType>
+void Queue<TaskType>::RemoveExpiredTasks(
+    std::unique_ptr<Batch<TaskType>>* batch,
+    std::vector<std::unique_ptr<TaskType>>* expired_tasks) {
+  const uint64 now_micros = env_->NowMicros();
+  auto is_expired = [now_micros](const TaskType& task) {
+    return task.deadline_micros() != 0 && task.deadline_micros() <= now_micros;
+  };
+  bool has_expired_task = false;
+  for (int i = 0; i < (*batch)->num_tasks() && !has_expired_task; ++i) {
+    has_expired_task = is_expired((*batch)->task(i));
+  }
+  if (!has_expired_task) {
+    return;
+  }
+
+  auto live_batch =
+      std::make_unique<Batch<TaskType>>((*batch)->traceme_context_id());
+  for (auto& task : (*batch)->RemoveAllTasks()) {
+    if (is_expired(*task)) {
+      expired_tasks->push_back(std::move(task));
+    } else {
+      live_batch->AddTask(std::move(task));
+    }
+  }
+  live_batch->Close();
+  *batch = live_batch->empty() ? nullptr : std::move(live_batch);
+}
+
 template <typename TaskType>
 typename SharedBatchScheduler<TaskType>::BatchUniquePtr
 Queue<TaskType>::ScheduleBatch() {
@@ -42,14 +42,18 @@ namespace {
 
 class FakeTask : public BatchTask {
  public:
-  explicit FakeTask(size_t size) : size_(size) {}
+  explicit FakeTask(size_t size, uint64 deadline_micros = 0)
+      : size_(size), deadline_micros_(deadline_micros) {}
 
   ~FakeTask() override = default;
 
   size_t size() const override { return size_; }
 
+  uint64 deadline_micros() const override { return deadline_micros_; }
+
  private:
   const size_t size_;
+  const uint64 deadline_micros_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(FakeTask);
 };
@@ -791,6 +795,191 @@ TEST_P(SharedBatchSchedulerTest, ZeroQueueRewrittenToOneQueue) {
   }
 }
 
+// Schedules batch-filling tasks on queues with weights 1 and 2 while the only
+// batch thread is busy, and checks the order in which they are processed.
+TEST_P(SharedBatchSchedulerTest, QueueWeights) {
+  mutex mu;
+  string processing_order;
+  Notification first_batch_scheduled, first_batch_proceed;
+  auto make_callback = [&](char queue_name) {
+    return [&, queue_name](std::unique_ptr<Batch<FakeTask>> batch) {
+      {
+        mutex_lock l(mu);
+        processing_order.push_back(queue_name);
+      }
+      if (!first_batch_scheduled.HasBeenNotified()) {
+        first_batch_scheduled.Notify();
+        first_batch_proceed.WaitForNotification();
+      }
+    };
+  };
+
+  auto scheduler = CreateSharedBatchScheduler(1);
+  const size_t input_batch_size_limit = 10;
+  QueueOptions queue_options =
+      CreateQueueOptions(input_batch_size_limit, input_batch_size_limit,
+                         0 /* batch_timeout_micros */, 100);
+  queue_options.weight = 1;
+  auto queue_a = CreateQueue(scheduler, queue_options, make_callback('A'));
+  queue_options.weight = 2;
+  auto queue_b = CreateQueue(scheduler, queue_options, make_callback('B'));
+
+  TF_ASSERT_OK(ScheduleTask(10, queue_a.get()));
+  first_batch_scheduled.WaitForNotification();
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK(ScheduleTask(10, queue_a.get()));
+    TF_ASSERT_OK(ScheduleTask(10, queue_b.get()));
+  }
+  first_batch_proceed.Notify();
+  queue_a.reset();
+  queue_b.reset();
+
+  EXPECT_EQ(processing_order, "ABBABAA");
+}
+
+// Checks that batches of a higher-priority queue are processed before those
+// of a lower-priority queue, regardless of the round-robin position.
+TEST_P(SharedBatchSchedulerTest, QueuePriorities) {
+  mutex mu;
+  string processing_order;
+  Notification first_batch_scheduled, first_batch_proceed;
+  auto make_callback = [&](char queue_name) {
+    return [&, queue_name](std::unique_ptr<Batch<FakeTask>> batch) {
+      {
+        mutex_lock l(mu);
+        processing_order.push_back(queue_name);
+      }
+      if (!first_batch_scheduled.HasBeenNotified()) {
+        first_batch_scheduled.Notify();
+        first_batch_proceed.WaitForNotification();
+      }
+    };
+  };
+
+  auto scheduler = CreateSharedBatchScheduler(1);
+  const size_t input_batch_size_limit = 10;
+  QueueOptions queue_options =
+      CreateQueueOptions(input_batch_size_limit, input_batch_size_limit,
+                         0 /* batch_timeout_micros */, 100);
+  queue_options.priority = 0;
+  auto low_queue = CreateQueue(scheduler, queue_options, make_callback('L'));
+  queue_options.priority = 1;
+  auto high_queue = CreateQueue(scheduler, queue_options, make_callback('H'));
+
+  TF_ASSERT_OK(ScheduleTask(10, low_queue.get()));
+  first_batch_scheduled.WaitForNotification();
+  for (int i = 0; i < 2; ++i) {
+    TF_ASSERT_OK(ScheduleTask(10, low_queue.get()));
+    TF_ASSERT_OK(ScheduleTask(10, high_queue.get()));
+  }
+  first_batch_proceed.Notify();
+  high_queue.reset();
+  low_queue.reset();
+
+  EXPECT_EQ(processing_order, "LHHLL");
+}
+
+TEST_P(SharedBatchSchedulerTest, InvalidWeight) {
+  auto callback = [](std::unique_ptr<Batch<FakeTask>> batch) {
+    // do nothing.
+  };
+
+  auto scheduler = CreateSharedBatchScheduler(2);
+  QueueOptions queue_options = CreateQueueOptions(10, 10, 0, 2);
+  queue_options.weight = 0;
+  std::unique_ptr<Queue> queue;
+  EXPECT_THAT(scheduler->AddQueue(queue_options, callback, &queue),
+              testing::StatusIs(error::INVALID_ARGUMENT,
+                                "weight must be positive; was 0"));
+}
+
+// Tests that tasks past their deadline at dequeue time are handed to
+// `expired_task_callback` instead of being processed.
+TEST(SharedBatchSchedulerExpiredTaskTest, ExpiredTasksAreNotProcessed) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    mutex mu;
+    std::vector<size_t> expired_task_sizes;
+    Notification batch_processed;
+    auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+      ASSERT_TRUE(batch->IsClosed());
+      EXPECT_EQ(batch->num_tasks(), 2);
+      EXPECT_EQ(batch->size(), 2 + 3);
+      batch_processed.Notify();
+    };
+
+    auto scheduler = CreateSharedBatchScheduler(1, &env);
+    QueueOptions queue_options = CreateQueueOptions(
+        10, 10, 100 /* batch_timeout_micros */, 2,
+        false /* enable_large_batch_splitting */, false /* enable_lazy_split */,
+        nullptr /* split_func */);
+    queue_options.expired_task_callback =
+        [&](std::unique_ptr<FakeTask> task) {
+          mutex_lock l(mu);
+          expired_task_sizes.push_back(task->size());
+        };
+    auto queue = CreateQueue(scheduler, queue_options, callback);
+
+    const uint64 now_micros = env.NowMicros();
+    for (const auto& size_and_deadline :
+         std::vector<std::pair<size_t, uint64>>{{1, now_micros + 50},
+                                                {2, 0},
+                                                {3, now_micros + 1000},
+                                                {4, now_micros + 100}}) {
+      std::unique_ptr<FakeTask> task(new FakeTask(size_and_deadline.first,
+                                                  size_and_deadline.second));
+      TF_ASSERT_OK(queue->Schedule(&task));
+    }
+    env.AdvanceByMicroseconds(100);
+    batch_processed.WaitForNotification();
+    {
+      mutex_lock l(mu);
+      EXPECT_THAT(expired_task_sizes, ::testing::ElementsAre(1, 4));
+    }
+
+    // A batch made only of expired tasks is dropped without being processed.
+    std::unique_ptr<FakeTask> task(new FakeTask(5, env.NowMicros() + 10));
+    TF_ASSERT_OK(queue->Schedule(&task));
+    env.AdvanceByMicroseconds(100);
+    queue.reset();
+    {
+      mutex_lock l(mu);
+      EXPECT_THAT(expired_task_sizes, ::testing::ElementsAre(1, 4, 5));
+    }
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST(SharedBatchSchedulerExpiredTaskTest, InvalidWithLazySplit) {
+  auto callback = [](std::unique_ptr<Batch<FakeTask>> batch) {
+    // do nothing.
+  };
+
+  auto scheduler = CreateSharedBatchScheduler(2);
+  QueueOptions queue_options = CreateQueueOptions(
+      10, 10, 0, 2, true /* enable_large_batch_splitting */,
+      true /* enable_lazy_split */,
+      [](std::unique_ptr<FakeTask>* input_task, int first_output_task_size,
+         int input_batch_size_limit,
+         std::vector<std::unique_ptr<FakeTask>>* output_tasks) {
+        output_tasks->push_back(std::move(*input_task));
+        return OkStatus();
+      });
+  queue_options.expired_task_callback = [](std::unique_ptr<FakeTask> task) {};
+  std::unique_ptr<Queue> queue;
+  EXPECT_THAT(
+      scheduler->AddQueue(queue_options, callback, &queue),
+      testing::StatusIs(error::INVALID_ARGUMENT,
+                        "expired_task_callback is not supported when "
+                        "enable_lazy_split is enabled."));
+}
+
 // TODO(b/161857471):
 // Add test coverage when input-split and no-split returns differently.
 INSTANTIATE_TEST_SUITE_P(
@@ -17,6 +17,8 @@ limitations under the License.
 
 #define EIGEN_USE_GPU
 
+#include <algorithm>
+
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -196,12 +198,57 @@ __global__ void BincountColReduceSharedKernel(const Tidx* in, const T* weights,
       if (shared_col_bins[binIdx]) {
         out[binIdx] = shared_col_bins[binIdx];
       }
-    } else {
+    } else if (shared_col_bins[binIdx] != T(0)) {
       GpuAtomicAdd(out + binIdx, shared_col_bins[binIdx]);
     }
   }
 }
 
+// Like BincountColReduceSharedKernel, for outputs that are too large to fit
+// in shared memory but whose rows are not: each block counts a range of
+// `cols_per_block` columns of one row into a sub-histogram of the row's bins
+// in shared memory, and then adds the bins that it hit to the output. This
+// keeps the contention of skewed inputs in shared memory, and global atomics
+// down to one per block and bin hit.
+template <typename Tidx, typename T, bool binary_count>
+__global__ void BincountRowReduceSharedKernel(
+    const Tidx* in, const T* weights, const int weights_size, T* out,
+    const int num_cols, const int cols_per_block, const int blocks_per_row,
+    const Tidx num_bins) {
+  GPU_DYNAMIC_SHARED_MEM_DECL(sizeof(T), unsigned char, shared_row_mem);
+  T* shared_row_bins = reinterpret_cast<T*>(shared_row_mem);
+  for (int bin = threadIdx.x; bin < num_bins; bin += blockDim.x) {
+    shared_row_bins[bin] = T(0);
+  }
+  __syncthreads();
+  const int row = blockIdx.x / blocks_per_row;
+  const int col_begin = (blockIdx.x % blocks_per_row) * cols_per_block;
+  const int col_end = min(col_begin + cols_per_block, num_cols);
+  for (int col = col_begin + threadIdx.x; col < col_end; col += blockDim.x) {
+    const int index = row * num_cols + col;
+    Tidx bin = ldg(in + index);
+    if (bin >= 0 && bin < num_bins) {
+      if (binary_count) {
+        shared_row_bins[bin] = T(1);
+      } else {
+        T value = (weights_size == 0) ? T(1) : ldg(weights + index);
+        GpuAtomicAdd(shared_row_bins + bin, value);
+      }
+    }
+  }
+  __syncthreads();
+  T* out_row = out + static_cast<int64_t>(row) * num_bins;
+  for (int bin = threadIdx.x; bin < num_bins; bin += blockDim.x) {
+    if (shared_row_bins[bin] != T(0)) {
+      if (binary_count) {
+        out_row[bin] = T(1);
+      } else {
+        GpuAtomicAdd(out_row + bin, shared_row_bins[bin]);
+      }
+    }
+  }
+}
+
 template <typename Tidx, typename T, bool binary_count>
 struct BincountReduceFunctor<GPUDevice, Tidx, T, binary_count> {
   static Status Compute(OpKernelContext* context,
@@ -225,6 +272,20 @@ struct BincountReduceFunctor<GPUDevice, Tidx, T, binary_count> {
           in.data(), weights.data(), weights.size(), out.data(), num_rows,
           num_cols, num_bins);
     }
+    // Otherwise privatize the bins of each row, if they fit. Each block
+    // counts enough columns to amortize clearing and merging its bins.
+    const int row_smem_usage = num_bins * sizeof(T);
+    if (row_smem_usage < smem_max) {
+      const int cols_per_block = std::max<int>(
+          config.thread_per_block * 4, static_cast<int>(num_bins));
+      const int blocks_per_row =
+          std::max(1, (num_cols + cols_per_block - 1) / cols_per_block);
+      return GpuLaunchKernel(
+          BincountRowReduceSharedKernel<Tidx, T, binary_count>,
+          num_rows * blocks_per_row, config.thread_per_block, row_smem_usage,
+          d.stream(), in.data(), weights.data(), weights.size(), out.data(),
+          num_cols, cols_per_block, blocks_per_row, num_bins);
+    }
     return GpuLaunchKernel(
         BincountColReduceKernel<Tidx, T, binary_count>, config.block_count,
         config.thread_per_block, 0, d.stream(), in.data(), weights.data(),
@@ -697,13 +697,35 @@ class CollectiveReduceV2OpKernel : public CollectiveOpV2Kernel {
     OP_REQUIRES_OK(c, c->GetAttr("final_op", &final_op_name));
     OP_REQUIRES_OK(
         c, c->GetAttr("max_subdivs_per_device", &max_subdivs_per_device_));
+    string compression;
+    OP_REQUIRES_OK(c, c->GetAttr("compression", &compression));
+    // With compression the tensors are reduced, and sent, as 16 bit floats.
+    DataType reduce_type = data_type_;
+    if (compression != "none") {
+      OP_REQUIRES(c, data_type_ == DT_FLOAT || data_type_ == DT_DOUBLE,
+                  errors::InvalidArgument(
+                      "Collective compression ", compression,
+                      " requires float or double inputs, got ",
+                      DataTypeString(data_type_)));
+      reduce_type = compression == "float16" ? DT_HALF : DT_BFLOAT16;
+      NodeDef cast_node;
+      cast_node.add_input(c->def().input(0));
+      cast_node.set_device(c->def().device());
+      SetAttrValue(false, &(*cast_node.mutable_attr())["Truncate"]);
+      SetAttrValue(data_type_, &(*cast_node.mutable_attr())["SrcT"]);
+      SetAttrValue(reduce_type, &(*cast_node.mutable_attr())["DstT"]);
+      encode_op_ = BuildOpKernel(c, "Cast", &cast_node);
+      SetAttrValue(reduce_type, &(*cast_node.mutable_attr())["SrcT"]);
+      SetAttrValue(data_type_, &(*cast_node.mutable_attr())["DstT"]);
+      decode_op_ = BuildOpKernel(c, "Cast", &cast_node);
+    }
     // Prepare OpKernels for reduction and final operations.
     // The merge_op takes two inputs
     NodeDef sub_node;
     sub_node.add_input(c->def().input(0));
     sub_node.add_input(c->def().input(0));
     sub_node.set_device(c->def().device());
-    SetAttrValue(data_type_, &(*sub_node.mutable_attr())["T"]);
+    SetAttrValue(reduce_type, &(*sub_node.mutable_attr())["T"]);
     merge_op_ = BuildOpKernel(c, merge_op_name, &sub_node);
     final_op_ = BuildOpKernel(c, final_op_name, &sub_node);
     name_ = strings::StrCat(c->def().name(), ": ReduceV2(", merge_op_name, ",",
@@ -727,6 +749,8 @@ class CollectiveReduceV2OpKernel : public CollectiveOpV2Kernel {
     col_params->instance.shape = c->input(0).shape();
     col_params->merge_op = merge_op_.get();
     col_params->final_op = final_op_.get();
+    col_params->encode_op = encode_op_.get();
+    col_params->decode_op = decode_op_.get();
     VLOG(1) << "CollectiveReduceV2 group_size " << col_params->group.group_size
             << " group_key " << col_params->group.group_key << " instance_key "
             << col_params->instance.instance_key;
@@ -743,6 +767,8 @@ class CollectiveReduceV2OpKernel : public CollectiveOpV2Kernel {
   int max_subdivs_per_device_;
   std::unique_ptr<OpKernel> merge_op_;
   std::unique_ptr<OpKernel> final_op_;
+  std::unique_ptr<OpKernel> encode_op_;
+  std::unique_ptr<OpKernel> decode_op_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("CollectiveReduceV2").Device(DEVICE_CPU),
@@ -0,0 +1,84 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_KERNELS_CSV_UTIL_H_
+#define TENSORFLOW_CORE_KERNELS_CSV_UTIL_H_
+
+#include <cstddef>
+#include <cstring>
+
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace csv {
+
+namespace internal {
+
+constexpr uint64 kLowBits = 0x0101010101010101ULL;
+constexpr uint64 kHighBits = 0x8080808080808080ULL;
+
+// Returns a nonzero value if any byte of `word` is zero.
+inline uint64 HasZeroByte(uint64 word) {
+  return (word - kLowBits) & ~word & kHighBits;
+}
+
+}  // namespace internal
+
+// Returns the position of the first byte in `data[begin, end)` that ends an
+// unquoted CSV field or makes it invalid: `delim`, '\n', '\r' or, if
+// `check_quote` is true, '"'. Returns `end` if there is no such byte.
+//
+// Fields are usually much longer than one byte, so this tests eight bytes at
+// a time, and only looks at single bytes in the word that holds the match.
+inline size_t FindFieldEnd(const char* data, size_t begin, size_t end,
+                           char delim, bool check_quote) {
+  const uint64 delims = internal::kLowBits * static_cast<uint8>(delim);
+  // When quotes are not special, testing for the delimiter twice is cheaper
+  // than a branch in the loop.
+  const uint64 quotes =
+      internal::kLowBits * static_cast<uint8>(check_quote ? '"' : delim);
+  const uint64 newlines = internal::kLowBits * static_cast<uint8>('\n');
+  const uint64 returns = internal::kLowBits * static_cast<uint8>('\r');
+  size_t i = begin;
+  for (; i + sizeof(uint64) <= end; i += sizeof(uint64)) {
+    uint64 word;
+    std::memcpy(&word, data + i, sizeof(word));
+    if (internal::HasZeroByte(word ^ delims) |
+        internal::HasZeroByte(word ^ quotes) |
+        internal::HasZeroByte(word ^ newlines) |
+        internal::HasZeroByte(word ^ returns)) {
+      break;
+    }
+  }
+  for (; i < end; ++i) {
+    const char c = data[i];
+    if (c == delim || c == '\n' || c == '\r' || (check_quote && c == '"')) {
+      return i;
+    }
+  }
+  return end;
+}
+
+// Returns the position of the first '"' in `data[begin, end)`, or `end` if
+// there is none.
+inline size_t FindQuote(const char* data, size_t begin, size_t end) {
+  if (begin >= end) return end;
+  const void* quote = std::memchr(data + begin, '"', end - begin);
+  return quote == nullptr ? end : static_cast<const char*>(quote) - data;
+}
+
+}  // namespace csv
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_CSV_UTIL_H_
@@ -0,0 +1,65 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/csv_util.h"
+
+#include <string>
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace csv {
+namespace {
+
+// Finds the end of a comma-separated field of `s` that starts at `begin`.
+size_t FieldEnd(const std::string& s, size_t begin, bool check_quote) {
+  return FindFieldEnd(s.data(), begin, s.size(), ',', check_quote);
+}
+
+TEST(CsvUtilTest, FindFieldEnd) {
+  EXPECT_EQ(0, FieldEnd(",abc", 0, true));
+  EXPECT_EQ(3, FieldEnd("abc,def", 0, true));
+  EXPECT_EQ(7, FieldEnd("abc,def", 4, true));
+  EXPECT_EQ(2, FieldEnd("ab\ncd", 0, true));
+  EXPECT_EQ(2, FieldEnd("ab\rcd", 0, true));
+  EXPECT_EQ(1, FieldEnd("a\"bc,", 0, true));
+  EXPECT_EQ(4, FieldEnd("a\"bc,", 0, false));
+}
+
+TEST(CsvUtilTest, FindFieldEndInLongFields) {
+  // Puts the special byte at every position relative to the word boundaries.
+  for (int length = 0; length < 40; ++length) {
+    for (const char c : {',', '\n', '\r', '"'}) {
+      const std::string field = std::string(length, 'x') + c + "yyyyyyyyy";
+      for (int begin = 0; begin <= length; ++begin) {
+        EXPECT_EQ(length, FieldEnd(field, begin, true))
+            << "length=" << length << " begin=" << begin;
+      }
+    }
+    const std::string field(length, 'x');
+    EXPECT_EQ(length, FieldEnd(field, 0, true));
+  }
+}
+
+TEST(CsvUtilTest, FindQuote) {
+  const std::string s = "abc\"def";
+  EXPECT_EQ(3, FindQuote(s.data(), 0, s.size()));
+  EXPECT_EQ(3, FindQuote(s.data(), 3, s.size()));
+  EXPECT_EQ(7, FindQuote(s.data(), 4, s.size()));
+  EXPECT_EQ(2, FindQuote(s.data(), 2, 2));
+}
+
+}  // namespace
+}  // namespace csv
+}  // namespace tensorflow
@@ -52,10 +52,38 @@ void BinaryOpShared::SetComputeError(OpKernelContext* ctx) {
   }
 }
 
-BinaryOpShared::BinaryOpState::BinaryOpState(OpKernelContext* ctx)
+namespace {
+
+std::shared_ptr<const BCast> LookupOrInsertBCast(
+    const TensorShape& shape0, const TensorShape& shape1,
+    KernelShapeCache<BCast>* bcast_cache) {
+  if (bcast_cache == nullptr || !bcast_cache->enabled()) {
+    return nullptr;
+  }
+  KernelShapeCache<BCast>::Key key;
+  key.AddShape(shape0);
+  key.AddShape(shape1);
+  std::shared_ptr<const BCast> bcast = bcast_cache->Lookup(key);
+  if (bcast == nullptr) {
+    bcast = bcast_cache->Insert(
+        std::move(key), std::make_shared<BCast>(BCast::FromShape(shape0),
+                                                BCast::FromShape(shape1)));
+  }
+  return bcast;
+}
+
+}  // namespace
+
+BinaryOpShared::BinaryOpState::BinaryOpState(
+    OpKernelContext* ctx, KernelShapeCache<BCast>* bcast_cache)
     : in0(ctx->input(0)),
       in1(ctx->input(1)),
-      bcast(BCast::FromShape(in0.shape()), BCast::FromShape(in1.shape())) {
+      cached_bcast(
+          LookupOrInsertBCast(in0.shape(), in1.shape(), bcast_cache)),
+      bcast(cached_bcast != nullptr
+                ? *cached_bcast
+                : local_bcast.emplace(BCast::FromShape(in0.shape()),
+                                      BCast::FromShape(in1.shape()))) {
   if (!bcast.IsValid()) {
     bool incompatible_shape_error;
     bool has_attr =
@@ -22,9 +22,13 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <memory>
+
+#include "absl/types/optional.h"
 #include "tensorflow/core/platform/bfloat16.h"
 
 
+#include "tensorflow/core/framework/kernel_shape_cache.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor_types.h"
@@ -52,12 +56,18 @@ class BinaryOpShared : public OpKernel {
     // in-place computation.
     // Caller must check ctx->status() upon return for non-ok status.
     // If ctx->status().ok() is true, then out is guaranteed to be allocated.
-    explicit BinaryOpState(OpKernelContext* ctx);
+    // If bcast_cache is not null, bcast is taken from it when the shapes of
+    // in0 and in1 were seen before.
+    explicit BinaryOpState(OpKernelContext* ctx,
+                           KernelShapeCache<BCast>* bcast_cache = nullptr);
 
     const Tensor& in0;
     const Tensor& in1;
 
-    BCast bcast;
+    // bcast refers to either cached_bcast or local_bcast.
+    std::shared_ptr<const BCast> cached_bcast;
+    absl::optional<BCast> local_bcast;
+    const BCast& bcast;
     Tensor* out = nullptr;
     int64_t out_num_elements;
 
@@ -70,6 +80,9 @@ class BinaryOpShared : public OpKernel {
 
   void SetUnimplementedError(OpKernelContext* ctx);
   void SetComputeError(OpKernelContext* ctx);
+
+  // The broadcasts of the input shapes that were seen recently.
+  KernelShapeCache<BCast> bcast_cache_;
 };
 
 // Coefficient-wise binary operations:
@@ -147,7 +160,7 @@ class BinaryOp : public BinaryOpShared {
     }
 
     // 'state': Shared helper not dependent on T to reduce code size
-    BinaryOpState state(ctx);
+    BinaryOpState state(ctx, &bcast_cache_);
     if (ctx->status().code() == error::RESOURCE_EXHAUSTED) {
       // Stop when BinaryOpState's constructor failed due to OOM.
       return;
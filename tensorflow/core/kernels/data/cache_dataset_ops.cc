@@ -33,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
 namespace tensorflow {
@@ -70,6 +71,34 @@ constexpr char kIncompleteCacheErrorMessage[] =
     "contents of the dataset  will be discarded. This can happen if you have "
     "an input pipeline similar to `dataset.cache().take(k).repeat()`. You "
     "should use `dataset.take(k).cache().repeat()` instead.";
+
+// Whether file caches are written with their tensors aligned for memory
+// mapping, and read by mapping them where the filesystem supports it, so that
+// the epochs after the first read the tensors without copying them out of the
+// page cache. Given by the TF_DATA_CACHE_MMAP environment variable.
+bool MapCacheFiles() {
+  static const bool map_cache_files = [] {
+    bool map_cache_files;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_DATA_CACHE_MMAP", /*default_val=*/false,
+                                   &map_cache_files));
+    return map_cache_files;
+  }();
+  return map_cache_files;
+}
+
+BundleWriter::Options CacheWriterOptions() {
+  BundleWriter::Options options;
+  if (MapCacheFiles()) {
+    options.data_alignment = EIGEN_MAX_ALIGN_BYTES;
+  }
+  return options;
+}
+
+BundleReader::Options CacheReaderOptions() {
+  BundleReader::Options options;
+  options.map_data_files = MapCacheFiles();
+  return options;
+}
 }  // namespace
 
 class PartialCache {
@@ -438,7 +467,8 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         }
         filename_ = strings::StrCat(dataset()->filename_, "_", shard_id_);
         lockfile_ = strings::StrCat(filename_, kLockFileSuffix);
-        writer_ = std::make_unique<BundleWriter>(dataset()->env_, filename_);
+        writer_ = std::make_unique<BundleWriter>(dataset()->env_, filename_,
+                                                 CacheWriterOptions());
         return OkStatus();
       }
 
@@ -500,7 +530,8 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         // conditions are not met since BundleWriter's constructor creates
         // new temp files which can delete the temp files created by a
         // BundleWriter in another Session.
-        writer_ = std::make_unique<BundleWriter>(dataset()->env_, filename_);
+        writer_ = std::make_unique<BundleWriter>(dataset()->env_, filename_,
+                                                 CacheWriterOptions());
         lockfile_created_ = true;
         return OkStatus();
       }
@@ -554,7 +585,8 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
       explicit FileReaderIterator(const Params& params)
           : DatasetIterator<FileDatasetBase>(params),
             cur_index_(0),
-            reader_(dataset()->env_, dataset()->filename_),
+            reader_(dataset()->env_, dataset()->filename_,
+                    CacheReaderOptions()),
             iterator_restored_(false) {}
 
       Status GetNextInternal(IteratorContext* ctx,
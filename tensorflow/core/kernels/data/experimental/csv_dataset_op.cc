@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/shape_inference.h"
+#include "tensorflow/core/kernels/csv_util.h"
 #include "tensorflow/core/lib/io/inputstream_interface.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
@@ -413,6 +414,12 @@ class CSVDatasetOp : public DatasetOpKernel {
         Status result;
 
         while (!end_of_record) {  // Read till we reach \n, \r or EOF
+          if (!select_all && excluded.empty() &&
+              num_selected_parsed == selected.size()) {
+            // None of the remaining fields are selected.
+            result.Update(SkipRestOfRecord(ctx, out_tensors));
+            break;
+          }
           bool explicit_exclude = num_excluded_parsed < excluded.size() &&
                                   excluded[num_excluded_parsed] == num_parsed;
           bool include = select_all ||
@@ -467,6 +474,57 @@ class CSVDatasetOp : public DatasetOpKernel {
         return ParseUnquotedField(ctx, out_tensors, end_of_record, include);
       }
 
+      // Advances pos_ past the end of the current record, starting from the
+      // first char of a field. Wide records usually select few of their
+      // columns, so rather than parsing the remaining fields one at a time,
+      // this only stops at the bytes that may end the record: newlines, and
+      // quotes, which may start a quoted field that contains newlines.
+      Status SkipRestOfRecord(IteratorContext* ctx,
+                              std::vector<Tensor>* out_tensors)
+          TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        const char delim = dataset()->delim_;
+        const bool use_quote_delim = dataset()->use_quote_delim_;
+        // Whether the first char of buffer_ starts a field.
+        bool buffer_starts_field = true;
+        Status result;
+        while (true) {
+          if (pos_ >= buffer_.size()) {
+            if (pos_ > 0) buffer_starts_field = buffer_[pos_ - 1] == delim;
+            Status s = FillBuffer(&buffer_);
+            pos_ = 0;
+            // The end of the file also ends the record.
+            if (errors::IsOutOfRange(s)) return result;
+            TF_RETURN_IF_ERROR(s);
+          }
+
+          // Passing '\n' as the delimiter only stops at newlines and quotes.
+          pos_ = csv::FindFieldEnd(buffer_.data(), pos_, buffer_.size(),
+                                   /*delim=*/'\n', use_quote_delim);
+          if (pos_ >= buffer_.size()) continue;
+
+          const char ch = buffer_[pos_];
+          if (ch == '\n' || ch == '\r') {
+            pos_++;
+            if (ch == '\r') SkipNewLineIfNecessary();
+            return result;
+          }
+          // `ch` is a quote.
+          const bool starts_field =
+              pos_ > 0 ? buffer_[pos_ - 1] == delim : buffer_starts_field;
+          if (!starts_field) {
+            // Take note of the error, like ParseUnquotedField.
+            result.Update(errors::InvalidArgument(
+                "Unquoted fields cannot have quotes inside"));
+            pos_++;
+            continue;
+          }
+          bool end_of_record = false;
+          result.Update(ParseQuotedField(ctx, out_tensors, &end_of_record,
+                                         /*include=*/false));
+          if (end_of_record) return result;
+        }
+      }
+
       // For keeping track of relevant parts of a field from a previous buffer
       struct Piece {
         size_t start;
@@ -562,7 +620,8 @@ class CSVDatasetOp : public DatasetOpKernel {
             }
 
           } else {
-            pos_++;
+            // Skips to the next quote, or to the end of the buffer.
+            pos_ = csv::FindQuote(buffer_.data(), pos_, buffer_.size());
           }
         }
       }
@@ -657,6 +716,12 @@ class CSVDatasetOp : public DatasetOpKernel {
             }
           }
 
+          // Skips the bytes that cannot end the field.
+          pos_ = csv::FindFieldEnd(buffer_.data(), pos_, buffer_.size(),
+                                   dataset()->delim_,
+                                   dataset()->use_quote_delim_);
+          if (pos_ >= buffer_.size()) continue;
+
           char ch = buffer_[pos_];
 
           if (ch == dataset()->delim_) {
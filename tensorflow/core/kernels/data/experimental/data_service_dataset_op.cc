@@ -30,6 +30,7 @@ limitations under the License.
 #include "absl/strings/ascii.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
 #include "absl/time/time.h"
@@ -70,6 +71,7 @@ limitations under the License.
 #include "tensorflow/core/profiler/lib/traceme_encode.h"
 #include "tensorflow/core/protobuf/data_service.pb.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -113,12 +115,51 @@ constexpr const char kDistributedEpoch[] = "distributed_epoch";
 // Same timeout used by the RegisterDatasetOp.
 constexpr absl::Duration kGetMetadataRetryTimeout = absl::Hours(1);
 
+// The maximum number of concurrent requests for a task, when the task's worker
+// responds faster than the others. Strict round-robin reads make one request
+// per task at a time.
+constexpr int64_t kMaxRequestsPerTask = 4;
+// The weight of the latest latency in the average latency of a task.
+constexpr double kLatencyDecay = 0.1;
+
 bool IsColocatedTask(const TaskInfo& task) {
   return absl::c_any_of(task.worker_tags(), [](absl::string_view worker_tag) {
     return absl::AsciiStrToUpper(worker_tag) == kColocatedWorkerTag;
   });
 }
 
+// Returns the worker tags, from the comma-separated
+// TF_DATA_SERVICE_PREFERRED_WORKER_TAGS environment variable, of the workers
+// that this client should read from first, e.g. the tags that name the host,
+// rack or zone that the client runs in.
+const absl::flat_hash_set<std::string>& PreferredWorkerTags() {
+  static const auto* const tags = [] {
+    std::string tags_str;
+    TF_CHECK_OK(ReadStringFromEnvVar("TF_DATA_SERVICE_PREFERRED_WORKER_TAGS",
+                                     /*default_val=*/"", &tags_str));
+    auto* tags = new absl::flat_hash_set<std::string>();
+    for (absl::string_view tag :
+         absl::StrSplit(tags_str, ',', absl::SkipWhitespace())) {
+      tags->insert(std::string(absl::StripAsciiWhitespace(tag)));
+    }
+    return tags;
+  }();
+  return *tags;
+}
+
+// Returns true if the task runs on an in-process worker, or on a worker with
+// one of the preferred worker tags.
+bool IsPreferredTask(const TaskInfo& task) {
+  if (LocalWorkers::Get(task.worker_address()) != nullptr) {
+    return true;
+  }
+  const absl::flat_hash_set<std::string>& preferred_tags =
+      PreferredWorkerTags();
+  return absl::c_any_of(task.worker_tags(), [&](const std::string& tag) {
+    return preferred_tags.contains(tag);
+  });
+}
+
 StatusOr<DataServiceMetadata> GetDataServiceMetadata(
     const std::string& dataset_id, const tstring& address,
     const tstring& protocol) {
@@ -559,19 +600,28 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
     struct Task {
       Task(const TaskInfo& info,
            std::unique_ptr<DataServiceWorkerClient> worker)
-          : info(info), worker(std::move(worker)) {}
+          : info(info),
+            worker(std::move(worker)),
+            preferred(IsPreferredTask(info)) {}
 
       const TaskInfo info;
       // Client for fetching task elements from the tf.data service worker.
       const std::unique_ptr<DataServiceWorkerClient> worker;
+      // Whether the task is read before the other tasks when they are both
+      // ready, because it runs on a local worker. See `IsPreferredTask`.
+      const bool preferred;
       // The next round to read from the task.
       int64_t round = 0;
       // Whether the task has been removed. The task will eventually be
       // deleted from `tasks_` on the next dispatcher heartbeat.
       bool removed = false;
       bool skipped_previous_round = false;
-      // Indicates whether a worker thread is currently processing the task.
-      bool in_use TF_GUARDED_BY(&Iterator::mu_) = false;
+      // The number of requests that worker threads are currently processing
+      // for the task.
+      int64_t num_requests TF_GUARDED_BY(&Iterator::mu_) = 0;
+      // The moving average of the task's GetElement latency, or -1 if no
+      // element has been read from the task yet.
+      double average_latency_micros TF_GUARDED_BY(&Iterator::mu_) = -1;
       // Indicates whether the worker has returned end_of_sequence for the task.
       bool end_of_sequence TF_GUARDED_BY(&Iterator::mu_) = false;
     };
@@ -912,7 +962,7 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
         {
           mutex_lock l(mu_);
           if (task_to_process) {
-            task_to_process->in_use = false;
+            --task_to_process->num_requests;
             --outstanding_requests_;
             task_to_process = nullptr;
             worker_thread_cv_.notify_one();
@@ -930,7 +980,7 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
             worker_thread_cv_.wait(l);
           }
           DCHECK(task_to_process != nullptr);
-          task_to_process->in_use = true;
+          ++task_to_process->num_requests;
           ++outstanding_requests_;
           if (StrictRoundRobin()) {
             // Reserve a spot in the results_ queue.
@@ -950,7 +1000,7 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
           mutex_lock l(mu_);
           VLOG(1) << "Failed to get element from worker "
                   << task_to_process->info.worker_address() << ": " << s;
-          task_to_process->in_use = false;
+          --task_to_process->num_requests;
           --outstanding_requests_;
           status_ = errors::CreateWithUpdatedMessage(
               s, absl::StrCat("Failed to get element from worker ",
@@ -983,25 +1033,37 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
       if (!ShouldProcessTask()) {
         return nullptr;
       }
+      const double mean_latency_micros =
+          StrictRoundRobin() ? -1 : MeanTaskLatencyMicros();
+      if (!StrictRoundRobin()) {
+        std::shared_ptr<Task> task =
+            GetPreferredTaskToProcess(mean_latency_micros);
+        if (task) {
+          return task;
+        }
+      }
 
       for (int i = 0; i < tasks_.size(); ++i) {
         std::shared_ptr<Task>& task = tasks_[next_task_index_];
         if (StrictRoundRobin() &&
-            (task->in_use ||
+            (task->num_requests > 0 ||
              current_round_ >= round_robin_round_limit_.value_or(
                                    std::numeric_limits<int64_t>::max()))) {
-          VLOG(4) << "No round robin task found. in_use: " << task->in_use
+          VLOG(4) << "No round robin task found. num_requests: "
+                  << task->num_requests
                   << ". current_round: " << current_round_
                   << ". round_robin_round_limit: "
                   << round_robin_round_limit_.value_or(-1);
           return nullptr;
         }
-        if (current_round_ < task->info.starting_round() || task->in_use ||
+        if (current_round_ < task->info.starting_round() ||
+            task->num_requests >=
+                MaxRequestsForTask(*task, mean_latency_micros) ||
             task->end_of_sequence || task->removed) {
           VLOG(3) << "Skipping task " << next_task_index_
                   << ". starting round: " << task->info.starting_round()
                   << ". current round: " << current_round_
-                  << ". task->in_use: " << task->in_use
+                  << ". task->num_requests: " << task->num_requests
                   << ". end_of_sequence: " << task->end_of_sequence
                   << ". task->removed: " << task->removed;
           AdvanceTaskIndex();
@@ -1014,6 +1076,60 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
       return nullptr;
     }
 
+    // Searches for a preferred task to process, visiting the tasks in the
+    // same order as `GetTaskToProcess`. The other tasks are only read when
+    // none of the preferred tasks is ready, i.e. when reading from the local
+    // workers alone does not keep up with the outstanding requests.
+    std::shared_ptr<Task> GetPreferredTaskToProcess(double mean_latency_micros)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      for (int i = 0; i < tasks_.size(); ++i) {
+        const int64_t index = (next_task_index_ + i) % tasks_.size();
+        std::shared_ptr<Task>& task = tasks_[index];
+        if (!task->preferred || current_round_ < task->info.starting_round() ||
+            task->num_requests >=
+                MaxRequestsForTask(*task, mean_latency_micros) ||
+            task->end_of_sequence || task->removed) {
+          continue;
+        }
+        task->round = current_round_;
+        next_task_index_ = index;
+        AdvanceTaskIndex();
+        return task;
+      }
+      return nullptr;
+    }
+
+    // Returns the mean of the tasks' average latencies, or -1 if no element
+    // has been read yet.
+    double MeanTaskLatencyMicros() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      double total_latency_micros = 0;
+      int64_t num_tasks = 0;
+      for (const std::shared_ptr<Task>& task : tasks_) {
+        if (task->average_latency_micros >= 0 && !task->end_of_sequence &&
+            !task->removed) {
+          total_latency_micros += task->average_latency_micros;
+          ++num_tasks;
+        }
+      }
+      return num_tasks > 0 ? total_latency_micros / num_tasks : -1;
+    }
+
+    // Returns how many requests may be outstanding for `task` at once. A task
+    // whose worker responds n times faster than the average gets up to n
+    // requests, so that slow workers hold fewer of the outstanding requests.
+    int64_t MaxRequestsForTask(const Task& task,
+                               double mean_latency_micros) const
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (StrictRoundRobin() || mean_latency_micros <= 0 ||
+          task.average_latency_micros <= 0) {
+        return 1;
+      }
+      return std::clamp<int64_t>(
+          static_cast<int64_t>(mean_latency_micros /
+                               task.average_latency_micros),
+          1, kMaxRequestsPerTask);
+    }
+
     // Increments the next task index, starting over if all tasks have been
     // processed.
     void AdvanceTaskIndex() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -1042,19 +1158,27 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
 
     void ProcessGetElementResponse(bool enqueue_result,
                                    GetElementResult& get_element_result,
-                                   std::shared_ptr<Result> result, Task& task) {
+                                   std::shared_ptr<Result> result, Task& task,
+                                   int64_t latency_micros) {
       mutex_lock l(mu_);
       result->ready = true;
       result->end_of_sequence = get_element_result.end_of_sequence;
       result->skip = get_element_result.skip;
       if (!get_element_result.end_of_sequence && !get_element_result.skip) {
+        task.average_latency_micros =
+            task.average_latency_micros < 0
+                ? latency_micros
+                : (1 - kLatencyDecay) * task.average_latency_micros +
+                      kLatencyDecay * latency_micros;
         task.skipped_previous_round = false;
         result->element = std::move(get_element_result.components);
         result->element_index = get_element_result.element_index;
         result->task_id = task.info.task_id();
       } else if (get_element_result.skip) {
         task.skipped_previous_round = true;
-      } else {
+      } else if (!task.end_of_sequence) {
+        // With several requests for the task, more than one of them may
+        // return end_of_sequence.
         task.end_of_sequence = true;
         finished_tasks_++;
       }
@@ -1123,7 +1247,9 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
     Status GetElement(Task* task, int64_t deadline_micros, bool enqueue_result,
                       std::shared_ptr<Result> result) TF_LOCKS_EXCLUDED(mu_) {
       GetElementResult get_element_result;
+      int64_t start_micros;
       for (int num_retries = 0;; ++num_retries) {
+        start_micros = Env::Default()->NowMicros();
         Status s = TryGetElement(*task, get_element_result);
         if (s.ok()) break;
         // Retry all errors that could indicate preemption.
@@ -1157,7 +1283,8 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
         Env::Default()->SleepForMicroseconds(backoff_until - now_micros);
       }
       ProcessGetElementResponse(enqueue_result, get_element_result, result,
-                                *task);
+                                *task,
+                                Env::Default()->NowMicros() - start_micros);
       return OkStatus();
     }
 
@@ -47,6 +47,7 @@ limitations under the License.
 #include "tensorflow/core/framework/variant_op_registry.h"
 #include "tensorflow/core/framework/variant_tensor_data.h"
 #include "tensorflow/core/kernels/data/optional_ops.h"
+#include "tensorflow/core/kernels/data/shared_iterator.h"
 #include "tensorflow/core/kernels/ops_util.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/refcount.h"
@@ -239,9 +240,17 @@ Status IteratorResource::SetIteratorFromDataset(OpKernelContext* ctx,
   if (ctx->function_library()->device()->device_type() == DEVICE_CPU) {
     DatasetBase* finalized_dataset;
     TF_ASSIGN_OR_RETURN(finalized_dataset, GetFinalizedDataset(ctx, dataset));
-    TF_RETURN_IF_ERROR(finalized_dataset->MakeIterator(
-        IteratorContext(std::move(params)),
-        /*parent=*/nullptr, "Iterator", &iterator));
+    if (ShareIdenticalIterators()) {
+      IteratorContext iter_ctx(std::move(params));
+      TF_RETURN_IF_ERROR(MakeSharedIterator(&iter_ctx, finalized_dataset,
+                                            "Iterator",
+                                            kSharedIteratorMaxBufferedBytes,
+                                            &iterator));
+    } else {
+      TF_RETURN_IF_ERROR(finalized_dataset->MakeIterator(
+          IteratorContext(std::move(params)),
+          /*parent=*/nullptr, "Iterator", &iterator));
+    }
   } else {
     TF_RETURN_IF_ERROR(dataset->MakeIterator(IteratorContext(std::move(params)),
                                              /*parent=*/nullptr, "Iterator",
@@ -28,7 +28,11 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/stringprintf.h"
+#include "tensorflow/core/profiler/lib/traceme.h"
+#include "tensorflow/core/profiler/lib/traceme_encode.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/ptr_util.h"
 
 namespace tensorflow {
@@ -38,6 +42,19 @@ namespace {
 // Default share of available RAM that can be used by model's internal buffers.
 constexpr double kRamBudgetShare = 0.5;
 
+// Returns the period at which iterators report the bottleneck of their input
+// pipeline, given by the TF_DATA_PIPELINE_REPORT_PERIOD_SECS environment
+// variable. The reports are disabled when it is not positive, the default.
+int64_t PipelineReportPeriodSecs() {
+  static const int64_t period_secs = [] {
+    int64_t period_secs;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_DATA_PIPELINE_REPORT_PERIOD_SECS",
+                                    /*default_val=*/0, &period_secs));
+    return period_secs;
+  }();
+  return period_secs;
+}
+
 }  // namespace
 
 /* static */ constexpr const char* const ModelDatasetOp::kDatasetType;
@@ -135,7 +152,10 @@ class ModelDatasetOp::Dataset : public DatasetBase {
       model_ = std::make_shared<model::Model>();
     }
 
-    ~Iterator() override { cancellation_manager_->StartCancel(); }
+    ~Iterator() override {
+      stop_pipeline_reports_.Notify();
+      cancellation_manager_->StartCancel();
+    }
 
     Status Initialize(IteratorContext* ctx) override {
       return dataset()->input_->MakeIterator(IteratorContext(CreateParams(ctx)),
@@ -196,9 +216,39 @@ class ModelDatasetOp::Dataset : public DatasetBase {
           }
         });
       }
+      if (!pipeline_report_thread_ && PipelineReportPeriodSecs() > 0) {
+        pipeline_report_thread_ = ctx->StartThread(
+            "tf_data_pipeline_report", [this]() { PipelineReportLoop(); });
+      }
       return OkStatus();
     }
 
+    // Periodically logs a report of the bottleneck of the input pipeline, and
+    // records it as a trace event so that it shows up in profiles, until the
+    // iterator is destroyed.
+    void PipelineReportLoop() {
+      const int64_t period_us =
+          PipelineReportPeriodSecs() * EnvTime::kSecondsToMicros;
+      while (!WaitForNotificationWithTimeout(&stop_pipeline_reports_,
+                                             period_us)) {
+        const model::PipelineReport report = model_->ComputePipelineReport();
+        if (report.stages.empty()) continue;
+        const model::PipelineReport::Stage& bottleneck = report.stages.front();
+        profiler::TraceMe traceme(
+            [&] {
+              return profiler::TraceMeEncode(
+                  "PipelineReport",
+                  {{"bottleneck", bottleneck.root},
+                   {"total_time_nsec", bottleneck.total_time_nsec},
+                   {"root_self_time_nsec", bottleneck.root_self_time_nsec},
+                   {"slowest_node", bottleneck.slowest_node},
+                   {"suggestion", report.suggestion}});
+            },
+            profiler::kInfo);
+        LOG(INFO) << "tf.data pipeline report: " << report.DebugString();
+      }
+    }
+
     mutex mu_;
     std::shared_ptr<model::Model> model_;
     std::unique_ptr<IteratorBase> input_impl_;
@@ -208,6 +258,10 @@ class ModelDatasetOp::Dataset : public DatasetBase {
     // `model_thread_` so that `model_thread_` is destroyed first.
     std::unique_ptr<CancellationManager> cancellation_manager_;
     std::unique_ptr<Thread> model_thread_ TF_GUARDED_BY(mu_);
+    // Must be ordered before `pipeline_report_thread_` so that the thread is
+    // destroyed first.
+    Notification stop_pipeline_reports_;
+    std::unique_ptr<Thread> pipeline_report_thread_ TF_GUARDED_BY(mu_);
   };
 
   const DatasetBase* input_;
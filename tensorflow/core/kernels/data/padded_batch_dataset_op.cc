@@ -335,17 +335,19 @@ class PaddedBatchDatasetOp::Dataset : public DatasetBase {
                                   output_dtypes()[component_index],
                                   batch_component_shape);
         Tensor& batch_component = out_tensors->back();
-        TF_RETURN_IF_ERROR(batch_util::SetElementZero(
-            &batch_component, dataset()->padding_values_[component_index]));
+        const Tensor& padding_value =
+            dataset()->padding_values_[component_index];
 
         // Build the output tuple component by copying one slice from each input
-        // element in the batch.
+        // element in the batch. Each slice is written once: the elements that
+        // need padding are copied and padded in the same pass.
         TensorShape component_shape({});
         for (int i = 1; i < batch_component_shape.dims(); ++i) {
           component_shape.AddDim(batch_component_shape.dim_size(i));
         }
         auto copy_element_fn = [component_index, &batch_elements,
-                                &batch_component, &component_shape](int index) {
+                                &batch_component, &component_shape,
+                                &padding_value](int index) {
           // Take the fast path if possible.
           if (batch_elements[index][component_index].shape() ==
               component_shape) {
@@ -353,9 +355,9 @@ class PaddedBatchDatasetOp::Dataset : public DatasetBase {
                 batch_elements[index][component_index], &batch_component,
                 index));
           } else {
-            TF_RETURN_IF_ERROR(batch_util::CopyElementToLargerSlice(
-                batch_elements[index][component_index], &batch_component,
-                index));
+            TF_RETURN_IF_ERROR(batch_util::CopyElementToLargerSliceWithPadding(
+                batch_elements[index][component_index], padding_value,
+                &batch_component, index));
           }
           return OkStatus();
         };
@@ -697,8 +697,27 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         return ConsumeHelper(result);
       }
       // If we are allowed to be nondeterministic (i.e. return results out of
-      // order), try to find an element in the cycle that has a result
-      // available.
+      // order), return a result of the element with the most buffered
+      // results, so that an element whose input is slow does not hold up the
+      // others. Otherwise try to find an element in the cycle that has a
+      // result available.
+      int64_t fullest_index = -1;
+      for (int64_t i = 0; i <= last_valid_current_element_; ++i) {
+        const std::shared_ptr<Element>& element = current_elements_[i];
+        if (element && !element->results.empty() &&
+            (fullest_index == -1 ||
+             element->results.size() >
+                 current_elements_[fullest_index]->results.size())) {
+          fullest_index = i;
+        }
+      }
+      if (fullest_index != -1) {
+        if (fullest_index != cycle_index_) {
+          cycle_index_ = fullest_index;
+          block_index_ = 0;
+        }
+        return ConsumeHelper(result);
+      }
       for (int i = 0; i < dataset()->cycle_length_; ++i) {
         if (ConsumeHelper(result)) {
           return true;
@@ -892,6 +911,14 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
           // Look for an element that needs processing.
           element.reset();
           while (!cancelled_) {
+            if (!deterministic_ && !wait_for_checkpoint_) {
+              const int index = PopEmptiestElementToProcess();
+              if (index != -1) {
+                element_index = index;
+                element = current_elements_[index];
+                break;
+              }
+            }
             while (!elements_to_process_.empty() && !wait_for_checkpoint_) {
               int index = elements_to_process_.front();
               elements_to_process_.pop_front();
@@ -928,6 +955,14 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
               element->active = false;
               break;
             }
+            // Hand the element back if another element has fewer buffered
+            // results and no worker to process it.
+            if (ShouldYieldElement(element)) {
+              element->active = false;
+              elements_to_process_.push_back(element_index);
+              current_workers_cond_var_.notify_one();
+              break;
+            }
           }
         }
       }
@@ -1028,7 +1063,8 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         mutex_lock l(*mu_);
         element->results.push_back(std::move(result));
         NotifyElementUpdate(element);
-        if (element->results.size() == dataset()->buffer_output_elements_) {
+        if (element->results.size() == dataset()->buffer_output_elements_ ||
+            ShouldYieldElement(element)) {
           break;
         }
       }
@@ -1133,6 +1169,53 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
              element->results.size() < dataset()->buffer_output_elements_;
     }
 
+    // Removes and returns the index in `elements_to_process_` of the element
+    // with the fewest buffered results that needs processing, or returns -1
+    // if there is none. Indices of elements that do not need processing are
+    // dropped.
+    int PopEmptiestElementToProcess() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      std::deque<int> pending;
+      int emptiest_index = -1;
+      for (int index : elements_to_process_) {
+        const std::shared_ptr<Element>& e = current_elements_[index];
+        if (!NeedsProcessing(e) || e->active) {
+          continue;
+        }
+        pending.push_back(index);
+        if (emptiest_index == -1 ||
+            e->results.size() <
+                current_elements_[emptiest_index]->results.size()) {
+          emptiest_index = index;
+        }
+      }
+      if (emptiest_index != -1) {
+        pending.erase(
+            std::find(pending.begin(), pending.end(), emptiest_index));
+      }
+      elements_to_process_ = std::move(pending);
+      return emptiest_index;
+    }
+
+    // Returns true if, in nondeterministic mode, the worker processing the
+    // current element `element` should stop and switch to an element that has
+    // fewer buffered results and that no other worker is free to process.
+    // This rebalances the workers when the inputs of some elements are slow.
+    bool ShouldYieldElement(const std::shared_ptr<Element>& element)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (deterministic_ || element->cycle_index == -1 ||
+          num_current_active_workers_ < num_current_workers_) {
+        return false;
+      }
+      for (int index : elements_to_process_) {
+        const std::shared_ptr<Element>& e = current_elements_[index];
+        if (e != element && NeedsProcessing(e) && !e->active &&
+            e->results.size() < element->results.size()) {
+          return true;
+        }
+      }
+      return false;
+    }
+
     inline void IncrementCurrentWorkers() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       num_current_workers_++;
     }
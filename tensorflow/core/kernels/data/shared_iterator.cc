@@ -0,0 +1,385 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/shared_iterator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/data/hash_utils.h"
+#include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/framework/cancellation.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/model.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// The elements computed by one iterator of a dataset, which the iterators of
+// identical datasets read in order.
+class SharedElements {
+ public:
+  SharedElements(GraphDef graph, int64_t max_buffered_bytes)
+      : graph_(std::move(graph)), max_buffered_bytes_(max_buffered_bytes) {}
+
+  ~SharedElements() { Close(); }
+
+  // Creates the iterator that computes the elements of `dataset`. It uses a
+  // copy of `ctx` with its own cancellation manager, so that cancelling one of
+  // the readers does not cancel the computation for the others.
+  static StatusOr<std::shared_ptr<SharedElements>> Create(
+      IteratorContext* ctx, const DatasetBase* dataset, const string& prefix,
+      GraphDef graph, int64_t max_buffered_bytes) {
+    auto elements =
+        std::make_shared<SharedElements>(std::move(graph), max_buffered_bytes);
+    IteratorContext::Params params(ctx);
+    params.cancellation_manager = &elements->cancellation_manager_;
+    elements->ctx_ = std::make_unique<IteratorContext>(std::move(params));
+    std::unique_ptr<IteratorBase> iterator;
+    TF_RETURN_IF_ERROR(dataset->MakeIterator(elements->ctx_.get(),
+                                             /*parent=*/nullptr, prefix,
+                                             &iterator));
+    mutex_lock l(elements->mu_);
+    elements->iterator_ = std::move(iterator);
+    return elements;
+  }
+
+  const GraphDef& graph() const { return graph_; }
+
+  // Returns true if a new reader can read all the elements from the start.
+  bool CanJoin() {
+    mutex_lock l(mu_);
+    return !closed_ && first_index_ == 0;
+  }
+
+  // Gets the element at `index`, computing it if it is the next one. Readers
+  // must get the elements in order. Sets `*available` to false if the element
+  // has been dropped or can no longer be computed, in which case the reader
+  // must compute it itself.
+  Status Get(int64_t index, std::vector<Tensor>* out_tensors,
+             bool* end_of_sequence, bool* available) {
+    IteratorBase* iterator;
+    {
+      mutex_lock l(mu_);
+      while (producing_ && index >= end_index()) {
+        cv_.wait(l);
+      }
+      *available = true;
+      if (index < first_index_) {
+        *available = false;
+        return OkStatus();
+      }
+      if (index < end_index()) {
+        const Element& element = buffer_[index - first_index_];
+        *out_tensors = element.components;
+        return element.status;
+      }
+      if (end_of_sequence_) {
+        *end_of_sequence = true;
+        return OkStatus();
+      }
+      if (closed_) {
+        *available = false;
+        return OkStatus();
+      }
+      DCHECK_EQ(index, end_index());
+      producing_ = true;
+      iterator = iterator_.get();
+    }
+    Element element;
+    bool element_end_of_sequence = false;
+    element.status = iterator->GetNext(ctx_.get(), &element.components,
+                                       &element_end_of_sequence);
+    mutex_lock l(mu_);
+    producing_ = false;
+    cv_.notify_all();
+    if (closed_) {
+      // The iterator was cancelled, so the result may be a cancellation error
+      // that does not belong to the sequence.
+      *available = false;
+      return OkStatus();
+    }
+    if (element.status.ok() && element_end_of_sequence) {
+      end_of_sequence_ = true;
+      *end_of_sequence = true;
+      return OkStatus();
+    }
+    *out_tensors = element.components;
+    Status status = element.status;
+    for (const Tensor& component : element.components) {
+      buffered_bytes_ += component.TotalBytes();
+    }
+    buffer_.push_back(std::move(element));
+    while (buffer_.size() > 1 && buffered_bytes_ > max_buffered_bytes_) {
+      for (const Tensor& component : buffer_.front().components) {
+        buffered_bytes_ -= component.TotalBytes();
+      }
+      buffer_.pop_front();
+      ++first_index_;
+    }
+    return status;
+  }
+
+  // Stops computing elements, waiting for the element being computed, if any.
+  // The readers get the buffered elements before computing the others.
+  void Close() {
+    std::unique_ptr<IteratorBase> iterator;
+    {
+      mutex_lock l(mu_);
+      if (closed_) return;
+      closed_ = true;
+      cancellation_manager_.StartCancel();
+      while (producing_) {
+        cv_.wait(l);
+      }
+      iterator = std::move(iterator_);
+    }
+  }
+
+ private:
+  struct Element {
+    Status status;
+    std::vector<Tensor> components;
+  };
+
+  int64_t end_index() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return first_index_ + static_cast<int64_t>(buffer_.size());
+  }
+
+  const GraphDef graph_;
+  const int64_t max_buffered_bytes_;
+  CancellationManager cancellation_manager_;
+  std::unique_ptr<IteratorContext> ctx_;
+
+  mutex mu_;
+  condition_variable cv_;
+  std::unique_ptr<IteratorBase> iterator_ TF_GUARDED_BY(mu_);
+  // True while a reader is computing the next element, without holding `mu_`.
+  bool producing_ TF_GUARDED_BY(mu_) = false;
+  bool closed_ TF_GUARDED_BY(mu_) = false;
+  bool end_of_sequence_ TF_GUARDED_BY(mu_) = false;
+  std::deque<Element> buffer_ TF_GUARDED_BY(mu_);
+  // The index of the first buffered element.
+  int64_t first_index_ TF_GUARDED_BY(mu_) = 0;
+  int64_t buffered_bytes_ TF_GUARDED_BY(mu_) = 0;
+};
+
+// The elements of the live shared iterators, by the fingerprint of the graphs
+// of their datasets.
+struct SharedElementsRegistry {
+  mutex mu;
+  absl::flat_hash_map<uint64, std::vector<std::weak_ptr<SharedElements>>>
+      elements TF_GUARDED_BY(mu);
+};
+
+SharedElementsRegistry& GetRegistry() {
+  static SharedElementsRegistry* registry = new SharedElementsRegistry();
+  return *registry;
+}
+
+std::shared_ptr<SharedElements> FindSharedElements(uint64 fingerprint,
+                                                   const GraphDef& graph) {
+  SharedElementsRegistry& registry = GetRegistry();
+  mutex_lock l(registry.mu);
+  auto it = registry.elements.find(fingerprint);
+  if (it == registry.elements.end()) {
+    return nullptr;
+  }
+  std::shared_ptr<SharedElements> result;
+  auto& candidates = it->second;
+  for (auto candidate = candidates.begin(); candidate != candidates.end();) {
+    std::shared_ptr<SharedElements> elements = candidate->lock();
+    if (elements == nullptr) {
+      candidate = candidates.erase(candidate);
+      continue;
+    }
+    if (result == nullptr && elements->CanJoin() &&
+        CheckGraphsEqual(elements->graph(), graph).ok()) {
+      result = std::move(elements);
+    }
+    ++candidate;
+  }
+  if (candidates.empty()) {
+    registry.elements.erase(it);
+  }
+  return result;
+}
+
+void RegisterSharedElements(uint64 fingerprint,
+                            std::weak_ptr<SharedElements> elements) {
+  SharedElementsRegistry& registry = GetRegistry();
+  mutex_lock l(registry.mu);
+  registry.elements[fingerprint].push_back(std::move(elements));
+}
+
+class SharedIterator : public DatasetBaseIterator {
+ public:
+  SharedIterator(const BaseParams& params,
+                 std::shared_ptr<SharedElements> elements, bool owns_elements)
+      : DatasetBaseIterator(params),
+        elements_(std::move(elements)),
+        owns_elements_(owns_elements) {}
+
+  ~SharedIterator() override {
+    // The shared elements are computed with the context of this iterator, so
+    // they cannot be computed after it is destroyed.
+    if (owns_elements_) {
+      elements_->Close();
+    }
+  }
+
+ protected:
+  std::shared_ptr<model::Node> CreateNode(
+      IteratorContext* ctx, model::Node::Args args) const override {
+    return model::MakeKnownRatioNode(std::move(args), /*ratio=*/1);
+  }
+
+  Status GetNextInternal(IteratorContext* ctx,
+                         std::vector<Tensor>* out_tensors,
+                         bool* end_of_sequence) override {
+    mutex_lock l(mu_);
+    if (own_iterator_ == nullptr) {
+      bool available = false;
+      Status s = elements_->Get(next_index_, out_tensors, end_of_sequence,
+                                &available);
+      if (available) {
+        if (!*end_of_sequence) {
+          ++next_index_;
+        }
+        return s;
+      }
+      VLOG(1) << "Elements of " << dataset()->DebugString()
+              << " are no longer shared after " << next_index_
+              << " elements, continuing with a separate iterator.";
+      TF_RETURN_IF_ERROR(
+          dataset()->MakeIterator(ctx, this, prefix(), &own_iterator_));
+      TF_RETURN_IF_ERROR(SkipReadElements(ctx, end_of_sequence));
+      if (*end_of_sequence) {
+        return OkStatus();
+      }
+    }
+    return own_iterator_->GetNext(ctx, out_tensors, end_of_sequence);
+  }
+
+  Status SaveInternal(SerializationContext* ctx,
+                      IteratorStateWriter* writer) override {
+    return errors::Unimplemented(
+        "Iterators that share their elements with identical iterators do not "
+        "support checkpointing. Unset TF_DATA_SHARE_IDENTICAL_ITERATORS to "
+        "checkpoint them.");
+  }
+
+  Status RestoreInternal(IteratorContext* ctx,
+                         IteratorStateReader* reader) override {
+    return errors::Unimplemented(
+        "Iterators that share their elements with identical iterators do not "
+        "support checkpointing. Unset TF_DATA_SHARE_IDENTICAL_ITERATORS to "
+        "restore them.");
+  }
+
+ private:
+  // Skips the elements that were read from the shared elements.
+  Status SkipReadElements(IteratorContext* ctx, bool* end_of_sequence)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    int64_t num_to_skip = next_index_;
+    while (num_to_skip > 0 && !*end_of_sequence) {
+      int num_skipped = 0;
+      Status s = own_iterator_->Skip(
+          ctx, static_cast<int>(std::min<int64_t>(num_to_skip, kint32max)),
+          end_of_sequence, &num_skipped);
+      num_to_skip -= num_skipped;
+      if (!s.ok()) {
+        if (errors::IsCancelled(s)) {
+          return s;
+        }
+        // The error was already returned for the shared element.
+        --num_to_skip;
+      }
+    }
+    return OkStatus();
+  }
+
+  const std::shared_ptr<SharedElements> elements_;
+  const bool owns_elements_;
+
+  mutex mu_;
+  // The index of the next shared element to read.
+  int64_t next_index_ TF_GUARDED_BY(mu_) = 0;
+  // Set once the shared elements are no longer available.
+  std::unique_ptr<IteratorBase> own_iterator_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace
+
+bool ShareIdenticalIterators() {
+  static const bool share_identical_iterators = [] {
+    bool share;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_DATA_SHARE_IDENTICAL_ITERATORS",
+                                   /*default_val=*/false, &share));
+    return share;
+  }();
+  return share_identical_iterators;
+}
+
+Status MakeSharedIterator(
+    IteratorContext* ctx, const DatasetBase* dataset, const string& prefix,
+    int64_t max_buffered_bytes, std::unique_ptr<IteratorBase>* iterator) {
+  SerializationContext::Params params;
+  params.external_state_policy =
+      SerializationContext::ExternalStatePolicy::kFail;
+  GraphDef graph;
+  uint64 fingerprint = 0;
+  Status s = AsGraphDef(dataset, SerializationContext(params), &graph);
+  if (s.ok()) {
+    s = HashGraph(graph, &fingerprint);
+  }
+  if (!s.ok()) {
+    VLOG(1) << "Not sharing the elements of " << dataset->DebugString()
+            << ": " << s;
+    return dataset->MakeIterator(ctx, /*parent=*/nullptr, prefix, iterator);
+  }
+
+  std::shared_ptr<SharedElements> elements =
+      FindSharedElements(fingerprint, graph);
+  const bool owns_elements = elements == nullptr;
+  if (owns_elements) {
+    TF_ASSIGN_OR_RETURN(elements,
+                        SharedElements::Create(ctx, dataset, prefix,
+                                               std::move(graph),
+                                               max_buffered_bytes));
+    RegisterSharedElements(fingerprint, elements);
+  }
+  *iterator = std::make_unique<SharedIterator>(
+      DatasetBaseIterator::BaseParams{dataset, prefix}, std::move(elements),
+      owns_elements);
+  return OkStatus();
+}
+
+}  // namespace data
+}  // namespace tensorflow
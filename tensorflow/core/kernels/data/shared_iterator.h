@@ -0,0 +1,61 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_KERNELS_DATA_SHARED_ITERATOR_H_
+#define TENSORFLOW_CORE_KERNELS_DATA_SHARED_ITERATOR_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/platform/status.h"
+
+namespace tensorflow {
+namespace data {
+
+// The default budget of the elements buffered for the iterators that share
+// them.
+constexpr int64_t kSharedIteratorMaxBufferedBytes = 256 << 20;
+
+// Returns true if the TF_DATA_SHARE_IDENTICAL_ITERATORS environment variable
+// is set, in which case iterators of identical input pipelines in the same
+// process share their elements (see `MakeSharedIterator`).
+bool ShareIdenticalIterators();
+
+// Makes an iterator for `dataset` that reads its elements from an iterator of
+// an identical dataset in this process, if there is one that has not dropped
+// any element yet. Otherwise, the new iterator computes the elements itself
+// and lets the identical iterators created after it read them. This avoids
+// running the same input pipeline several times, e.g. when several models in
+// one process are evaluated on the same dataset.
+//
+// Two datasets are identical if their graphs, which include their functions
+// and the values of their input tensors, are equal. Datasets that depend on
+// external state, e.g. on stateful ops or resources, are never shared.
+//
+// The most recent elements are buffered, up to `max_buffered_bytes`. An
+// iterator that falls further behind continues on its own iterator of
+// `dataset`, which skips the elements it has already read, so that slow
+// readers never block the others. The elements are computed with the context
+// of the iterator that computes them, and only while that iterator is alive.
+// These iterators do not support checkpointing.
+Status MakeSharedIterator(
+    IteratorContext* ctx, const DatasetBase* dataset, const string& prefix,
+    int64_t max_buffered_bytes, std::unique_ptr<IteratorBase>* iterator);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_DATA_SHARED_ITERATOR_H_
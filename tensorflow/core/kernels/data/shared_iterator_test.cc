@@ -0,0 +1,118 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/shared_iterator.h"
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/data/dataset_test_base.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+class SharedIteratorTest : public DatasetOpsTestBase {
+ protected:
+  std::unique_ptr<IteratorBase> MakeIterator(int64_t max_buffered_bytes) {
+    std::unique_ptr<IteratorBase> iterator;
+    TF_CHECK_OK(MakeSharedIterator(iterator_ctx_.get(), dataset_, "Iterator",
+                                   max_buffered_bytes, &iterator));
+    return iterator;
+  }
+
+  // Gets the next element of `iterator`, or an empty tensor at the end of the
+  // sequence.
+  Tensor GetNext(IteratorBase* iterator) {
+    std::vector<Tensor> out_tensors;
+    bool end_of_sequence = false;
+    TF_CHECK_OK(
+        iterator->GetNext(iterator_ctx_.get(), &out_tensors, &end_of_sequence));
+    if (end_of_sequence) {
+      return Tensor();
+    }
+    CHECK_EQ(out_tensors.size(), 1);
+    return out_tensors[0];
+  }
+};
+
+TEST_F(SharedIteratorTest, SharesElements) {
+  TF_ASSERT_OK(Initialize(RangeDatasetParams(0, 10, 1)));
+  std::unique_ptr<IteratorBase> first = MakeIterator(1 << 20);
+  std::unique_ptr<IteratorBase> second = MakeIterator(1 << 20);
+  for (int64_t i = 0; i < 10; ++i) {
+    Tensor first_element = GetNext(first.get());
+    Tensor second_element = GetNext(second.get());
+    test::ExpectEqual(first_element, CreateTensor<int64_t>(TensorShape{}, {i}));
+    // The second iterator reads the tensors of the first one.
+    EXPECT_EQ(first_element.tensor_data().data(),
+              second_element.tensor_data().data());
+  }
+  EXPECT_FALSE(GetNext(first.get()).IsInitialized());
+  EXPECT_FALSE(GetNext(second.get()).IsInitialized());
+}
+
+TEST_F(SharedIteratorTest, SlowIteratorContinuesOnItsOwn) {
+  TF_ASSERT_OK(Initialize(RangeDatasetParams(0, 10, 1)));
+  // Only the most recent element is buffered.
+  std::unique_ptr<IteratorBase> fast = MakeIterator(/*max_buffered_bytes=*/0);
+  std::unique_ptr<IteratorBase> slow = MakeIterator(/*max_buffered_bytes=*/0);
+  test::ExpectEqual(GetNext(slow.get()),
+                    CreateTensor<int64_t>(TensorShape{}, {0}));
+  for (int64_t i = 0; i < 10; ++i) {
+    test::ExpectEqual(GetNext(fast.get()),
+                      CreateTensor<int64_t>(TensorShape{}, {i}));
+  }
+  EXPECT_FALSE(GetNext(fast.get()).IsInitialized());
+  for (int64_t i = 1; i < 10; ++i) {
+    test::ExpectEqual(GetNext(slow.get()),
+                      CreateTensor<int64_t>(TensorShape{}, {i}));
+  }
+  EXPECT_FALSE(GetNext(slow.get()).IsInitialized());
+}
+
+TEST_F(SharedIteratorTest, ContinuesAfterFirstIteratorIsDestroyed) {
+  TF_ASSERT_OK(Initialize(RangeDatasetParams(0, 10, 1)));
+  std::unique_ptr<IteratorBase> first = MakeIterator(1 << 20);
+  std::unique_ptr<IteratorBase> second = MakeIterator(1 << 20);
+  for (int64_t i = 0; i < 5; ++i) {
+    GetNext(first.get());
+  }
+  first.reset();
+  for (int64_t i = 0; i < 10; ++i) {
+    test::ExpectEqual(GetNext(second.get()),
+                      CreateTensor<int64_t>(TensorShape{}, {i}));
+  }
+  EXPECT_FALSE(GetNext(second.get()).IsInitialized());
+}
+
+TEST_F(SharedIteratorTest, DoesNotJoinAfterElementsAreDropped) {
+  TF_ASSERT_OK(Initialize(RangeDatasetParams(0, 3, 1)));
+  std::unique_ptr<IteratorBase> first = MakeIterator(/*max_buffered_bytes=*/0);
+  GetNext(first.get());
+  GetNext(first.get());
+  std::unique_ptr<IteratorBase> second = MakeIterator(/*max_buffered_bytes=*/0);
+  for (int64_t i = 0; i < 3; ++i) {
+    test::ExpectEqual(GetNext(second.get()),
+                      CreateTensor<int64_t>(TensorShape{}, {i}));
+  }
+  EXPECT_FALSE(GetNext(second.get()).IsInitialized());
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -14,7 +14,10 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/shuffle_dataset_op.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <cstring>
 #include <deque>
 #include <string>
 #include <tuple>
@@ -29,7 +32,9 @@ limitations under the License.
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/kernels/data/random_seed_ops.h"
+#include "tensorflow/core/kernels/random_index_shuffle.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
@@ -76,6 +81,165 @@ constexpr char kShuffleDatasetV3[] = "ShuffleDatasetV3";
 constexpr char kShuffleAndRepeatDatasetV1[] = "ShuffleAndRepeatDataset";
 constexpr char kShuffleAndRepeatDatasetV2[] = "ShuffleAndRepeatDatasetV2";
 
+namespace {
+
+// Elements larger than this are not packed into a slab: their per-element
+// overhead is small compared to their size, and packing them costs two copies.
+constexpr int64_t kMaxSlabElementBytes = 4096;
+
+// The elements buffered by a shuffle iterator, indexed by their position in
+// the buffer.
+//
+// If all components of the dataset's elements have fully defined shapes and
+// types that can be copied with memcpy, and the elements are small, they are
+// packed contiguously into one slab that grows as the buffer fills up. Large
+// buffers of small elements would otherwise use several times the memory of
+// their data for the tensors, their buffers and the allocator's bookkeeping.
+// Other elements, and elements that do not match the dataset's shapes, are
+// stored as vectors of tensors.
+class ShuffleBuffer {
+ public:
+  ShuffleBuffer(int64_t size, const DataTypeVector& dtypes,
+                const std::vector<PartialTensorShape>& shapes)
+      : size_(size), dtypes_(dtypes) {
+    int64_t element_bytes = 0;
+    bool packable = !dtypes.empty();
+    for (size_t i = 0; i < dtypes.size() && packable; ++i) {
+      TensorShape shape;
+      packable = DataTypeCanUseMemcpy(dtypes[i]) &&
+                 shapes[i].AsTensorShape(&shape) &&
+                 shape.num_elements() > 0;
+      if (packable) {
+        component_offsets_.push_back(element_bytes);
+        element_bytes += shape.num_elements() * DataTypeSize(dtypes[i]);
+        shapes_.push_back(shape);
+      }
+    }
+    if (packable && element_bytes <= kMaxSlabElementBytes) {
+      element_bytes_ = element_bytes;
+    } else {
+      elements_.resize(size_);
+    }
+  }
+
+  int64_t size() const { return size_; }
+
+  // Stores `element` at `index`, which must be empty.
+  void Put(int64_t index, std::vector<Tensor>&& element) {
+    if (element_bytes_ > 0 && !Matches(element)) {
+      ConvertToTensors();
+    }
+    if (element_bytes_ == 0) {
+      elements_[index] = std::move(element);
+      return;
+    }
+    if (slab_.size() < static_cast<size_t>((index + 1) * element_bytes_)) {
+      // Grow the slab geometrically, up to the size of the whole buffer.
+      const int64_t capacity = std::min(
+          size_, std::max(index + 1, static_cast<int64_t>(slab_.size() /
+                                                          element_bytes_) *
+                                         2));
+      slab_.resize(capacity * element_bytes_);
+      occupied_.resize(capacity, false);
+    }
+    char* slot = &slab_[index * element_bytes_];
+    for (size_t i = 0; i < element.size(); ++i) {
+      const StringPiece data = element[i].tensor_data();
+      std::memcpy(slot + component_offsets_[i], data.data(), data.size());
+    }
+    occupied_[index] = true;
+  }
+
+  // Moves the element at `index` to `element`, leaving `index` empty.
+  void Take(Allocator* allocator, int64_t index,
+            std::vector<Tensor>* element) {
+    if (element_bytes_ == 0) {
+      *element = std::move(elements_[index]);
+      elements_[index].clear();
+      return;
+    }
+    element->clear();
+    element->reserve(dtypes_.size());
+    const char* slot = &slab_[index * element_bytes_];
+    for (size_t i = 0; i < dtypes_.size(); ++i) {
+      element->emplace_back(allocator, dtypes_[i], shapes_[i]);
+      const StringPiece data = element->back().tensor_data();
+      std::memcpy(const_cast<char*>(data.data()), slot + component_offsets_[i],
+                  data.size());
+    }
+    occupied_[index] = false;
+  }
+
+  // Moves the element at `from` to `to`, which must be empty.
+  void Move(int64_t from, int64_t to) {
+    if (element_bytes_ == 0) {
+      elements_[to] = std::move(elements_[from]);
+      elements_[from].clear();
+      return;
+    }
+    std::memcpy(&slab_[to * element_bytes_], &slab_[from * element_bytes_],
+                element_bytes_);
+    occupied_[to] = true;
+    occupied_[from] = false;
+  }
+
+  // Returns copies of the buffered elements, for checkpointing. Empty
+  // positions are represented by empty vectors; trailing empty positions may
+  // be omitted.
+  std::vector<std::vector<Tensor>> Elements() const {
+    if (element_bytes_ == 0) {
+      return elements_;
+    }
+    std::vector<std::vector<Tensor>> elements(occupied_.size());
+    for (size_t index = 0; index < occupied_.size(); ++index) {
+      if (!occupied_[index]) continue;
+      const char* slot = &slab_[index * element_bytes_];
+      for (size_t i = 0; i < dtypes_.size(); ++i) {
+        elements[index].emplace_back(dtypes_[i], shapes_[i]);
+        const StringPiece data = elements[index].back().tensor_data();
+        std::memcpy(const_cast<char*>(data.data()),
+                    slot + component_offsets_[i], data.size());
+      }
+    }
+    return elements;
+  }
+
+ private:
+  bool Matches(const std::vector<Tensor>& element) const {
+    if (element.size() != dtypes_.size()) return false;
+    for (size_t i = 0; i < element.size(); ++i) {
+      if (element[i].dtype() != dtypes_[i] ||
+          element[i].shape() != shapes_[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Stops packing elements, and moves the packed ones to tensors.
+  void ConvertToTensors() {
+    std::vector<std::vector<Tensor>> elements = Elements();
+    elements.resize(size_);
+    elements_ = std::move(elements);
+    element_bytes_ = 0;
+    slab_ = std::vector<char>();
+    occupied_ = std::vector<bool>();
+  }
+
+  const int64_t size_;
+  const DataTypeVector dtypes_;
+  // The shape and offset in a slot of each component of packed elements.
+  std::vector<TensorShape> shapes_;
+  std::vector<int64_t> component_offsets_;
+  // The size of a packed element, or 0 if elements are stored as tensors.
+  int64_t element_bytes_ = 0;
+  std::vector<char> slab_;
+  std::vector<bool> occupied_;
+  std::vector<std::vector<Tensor>> elements_;
+};
+
+}  // namespace
+
 ShuffleDatasetOpBase::ShuffleDatasetOpBase(OpKernelConstruction* ctx)
     : UnaryDatasetOpKernel(ctx) {}
 
@@ -141,17 +305,14 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
   Status Get(OpKernelContext* ctx, int64 index,
              std::vector<Tensor>* out_tensors) const override {
     TF_RETURN_IF_ERROR(CheckRandomAccessCompatible(index));
-    {
-      mutex_lock l(mu_);
-      if (shuffled_indices_.empty()) {
-        InitializeRandomAccessIndices();
-      }
-    }
-    int64 shuffled_index;
-    {
-      tf_shared_lock l(mu_);
-      shuffled_index = shuffled_indices_[index];
-    }
+    // Each epoch is an independent permutation of the input indices. The
+    // permutation is computed one index at a time, so random access needs no
+    // memory and no setup however large the input is.
+    const int64_t input_cardinality = input_->Cardinality();
+    const int64_t epoch = index / input_cardinality;
+    const uint64 shuffled_index = random::index_shuffle(
+        static_cast<uint64>(index % input_cardinality), RandomAccessKey(epoch),
+        static_cast<uint64>(input_cardinality - 1));
     TF_RETURN_IF_ERROR(input_->Get(ctx, shuffled_index, out_tensors));
     return OkStatus();
   }
@@ -170,22 +331,14 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
         seed_generator_.get());
   }
 
-  void InitializeRandomAccessIndices() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    const int64 cardinality = Cardinality();
-    shuffled_indices_ = std::vector<std::int64_t>(cardinality);
-    std::iota(shuffled_indices_.begin(), shuffled_indices_.end(), 0);
-    int64_t shuffled_index = 0;
-    random::PhiloxRandom parent_generator =
-        random::PhiloxRandom(seed_generator_->seed(), seed_generator_->seed2());
-    random::SingleSampleAdapter<random::PhiloxRandom> generator =
-        random::SingleSampleAdapter<random::PhiloxRandom>(&parent_generator);
-
-    while (shuffled_index < cardinality) {
-      int64_t offset = generator() % (cardinality - shuffled_index);
-      std::swap(shuffled_indices_[shuffled_index + offset],
-                shuffled_indices_[shuffled_index]);
-      shuffled_index += 1;
-    }
+  // Returns the key of the random access permutation of `epoch`.
+  std::array<uint32_t, 3> RandomAccessKey(int64_t epoch) const {
+    const uint64 seeds = Hash64Combine(
+        static_cast<uint64>(seed_generator_->seed()),
+        static_cast<uint64>(seed_generator_->seed2()));
+    const uint64 epoch_seed = Hash64Combine(seeds, static_cast<uint64>(epoch));
+    return {static_cast<uint32_t>(seeds), static_cast<uint32_t>(seeds >> 32),
+            static_cast<uint32_t>(epoch_seed)};
   }
 
  protected:
@@ -196,8 +349,9 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
           seed_generator_(seed_generator),
           parent_generator_(seed_generator->seed(), seed_generator->seed2()),
           generator_(&parent_generator_) {
-      buffer_ = std::make_unique<std::vector<std::vector<Tensor>>>(
-          params.dataset->buffer_size_);
+      buffer_ = std::make_unique<ShuffleBuffer>(
+          params.dataset->buffer_size_, params.dataset->output_dtypes(),
+          params.dataset->output_shapes());
     }
 
     Status Initialize(IteratorContext* ctx) override {
@@ -226,10 +380,12 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       int64_t offset =
           Random() % (slices_.front()->end - slices_.front()->start);
       int64_t index = (slices_.front()->start + offset) % buffer_->size();
-      *out_tensors = std::move(buffer_->at(index));
+      buffer_->Take(ctx->allocator({}), index, out_tensors);
       this->RecordBufferDequeue(ctx, *out_tensors);
-      std::swap(buffer_->at(index),
-                buffer_->at(slices_.front()->start % buffer_->size()));
+      const int64_t start_index = slices_.front()->start % buffer_->size();
+      if (index != start_index) {
+        buffer_->Move(start_index, index);
+      }
       slices_.front()->start++;
       num_elements_--;
       return OkStatus();
@@ -275,7 +431,8 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       TF_RETURN_IF_ERROR(writer->WriteScalar(this->full_name(kEpoch), epoch_));
       TF_RETURN_IF_ERROR(
           writer->WriteScalar(this->full_name(kNumElements), num_elements_));
-      TF_RETURN_IF_ERROR(WriteElementsToCheckpoint(writer, prefix(), *buffer_));
+      TF_RETURN_IF_ERROR(
+          WriteElementsToCheckpoint(writer, prefix(), buffer_->Elements()));
       TF_RETURN_IF_ERROR(
           writer->WriteScalar(this->full_name(kSlicesSize), slices_.size()));
       for (size_t i = 0; i < slices_.size(); ++i) {
@@ -330,13 +487,23 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
             reader->ReadScalar(this->full_name(kSlicesSize), &temp));
         slices_size = static_cast<size_t>(temp);
       }
-      buffer_ = std::make_unique<std::vector<std::vector<Tensor>>>();
+      std::vector<std::vector<Tensor>> elements;
       TF_RETURN_IF_ERROR(
-          ReadElementsFromCheckpoint(ctx, reader, prefix(), buffer_.get()));
-      for (const auto& element : *buffer_) {
-        RecordBufferEnqueue(ctx, element);
+          ReadElementsFromCheckpoint(ctx, reader, prefix(), &elements));
+      if (elements.size() > static_cast<size_t>(dataset()->buffer_size_)) {
+        return errors::DataLoss("The checkpoint of the shuffle buffer has ",
+                                elements.size(), " elements, but the buffer ",
+                                "size is ", dataset()->buffer_size_);
+      }
+      buffer_ = std::make_unique<ShuffleBuffer>(dataset()->buffer_size_,
+                                                dataset()->output_dtypes(),
+                                                dataset()->output_shapes());
+      for (size_t i = 0; i < elements.size(); ++i) {
+        RecordBufferEnqueue(ctx, elements[i]);
+        if (!elements[i].empty()) {
+          buffer_->Put(i, std::move(elements[i]));
+        }
       }
-      buffer_->resize(dataset()->buffer_size_);
       slices_.clear();
       for (size_t i = 0; i < slices_size; ++i) {
         int64_t start;
@@ -459,7 +626,7 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       }
       this->RecordBufferEnqueue(ctx, element);
       size_t index = slices_.back()->end % buffer_->size();
-      buffer_->at(index) = std::move(element);
+      buffer_->Put(index, std::move(element));
       num_elements_++;
       slices_.back()->end++;
     }
@@ -481,8 +648,7 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
 
     mutex mu_;
     SeedGenerator* const seed_generator_ TF_GUARDED_BY(mu_);  // Not owned.
-    std::unique_ptr<std::vector<std::vector<Tensor>>> buffer_
-        TF_GUARDED_BY(mu_);
+    std::unique_ptr<ShuffleBuffer> buffer_ TF_GUARDED_BY(mu_);
     std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_) = nullptr;
     int64_t epoch_ TF_GUARDED_BY(mu_) = 0;
     int64_t num_elements_ TF_GUARDED_BY(mu_) = 0;
@@ -508,8 +674,6 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
   // responsible for repeating as well.
   const int64_t count_;
   const TraceMeMetadata traceme_metadata_;
-  mutable mutex mu_;
-  mutable std::vector<std::int64_t> shuffled_indices_ TF_GUARDED_BY(mu_);
 };  // ShuffleDatasetBase
 
 // This version of memory dataset has an exclusive ownership of the seed
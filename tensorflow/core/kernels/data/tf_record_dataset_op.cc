@@ -14,6 +14,9 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/tf_record_dataset_op.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/utils.h"
 #include "tensorflow/core/framework/metrics.h"
@@ -25,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -52,18 +56,46 @@ bool is_cloud_tpu_gcs_fs() {
   return false;
 }
 
+// Whether to use the index files written next to uncompressed TFRecord files
+// (see io::RecordIndexFilename()) to skip and randomly access their records
+// without scanning them, given by the TF_DATA_TFRECORD_USE_INDEX environment
+// variable. Files without an index are read sequentially.
+bool UseRecordIndex() {
+  static const bool use_index = [] {
+    bool use_index;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_DATA_TFRECORD_USE_INDEX",
+                                   /*default_val=*/false, &use_index));
+    return use_index;
+  }();
+  return use_index;
+}
+
 class TFRecordDatasetOp::Dataset : public DatasetBase {
  public:
-  explicit Dataset(OpKernelContext* ctx, std::vector<string> filenames,
-                   const string& compression_type, int64_t buffer_size)
+  // `record_offsets[i]` holds the offsets of the records of `filenames[i]`
+  // if the file has an index, and is null otherwise.
+  explicit Dataset(
+      OpKernelContext* ctx, std::vector<string> filenames,
+      const string& compression_type, int64_t buffer_size,
+      std::vector<std::unique_ptr<std::vector<uint64>>> record_offsets)
       : DatasetBase(DatasetContext(ctx)),
         filenames_(std::move(filenames)),
         compression_type_(compression_type),
         options_(io::RecordReaderOptions::CreateRecordReaderOptions(
-            compression_type)) {
+            compression_type)),
+        record_offsets_(std::move(record_offsets)) {
     if (buffer_size > 0) {
       options_.buffer_size = buffer_size;
     }
+    first_records_.reserve(record_offsets_.size() + 1);
+    first_records_.push_back(0);
+    for (const auto& offsets : record_offsets_) {
+      if (offsets == nullptr) {
+        first_records_.clear();
+        break;
+      }
+      first_records_.push_back(first_records_.back() + offsets->size());
+    }
   }
 
   std::unique_ptr<IteratorBase> MakeIteratorInternal(
@@ -93,6 +125,31 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
 
   Status CheckExternalState() const override { return OkStatus(); }
 
+  int64_t CardinalityInternal(CardinalityOptions options) const override {
+    if (first_records_.empty()) return kUnknownCardinality;
+    return first_records_.back();
+  }
+
+  Status Get(OpKernelContext* ctx, int64 index,
+             std::vector<Tensor>* out_tensors) const override {
+    TF_RETURN_IF_ERROR(CheckRandomAccessCompatible(index));
+    const size_t file_index =
+        std::upper_bound(first_records_.begin(), first_records_.end(), index) -
+        first_records_.begin() - 1;
+    std::unique_ptr<RandomAccessFile> file;
+    TF_RETURN_IF_ERROR(ctx->env()->NewRandomAccessFile(
+        TranslateFileName(filenames_[file_index]), &file));
+    // A single record is read, so buffering would only read ahead.
+    io::RecordReaderOptions options = options_;
+    options.buffer_size = 0;
+    io::RecordReader reader(file.get(), options);
+    uint64 offset =
+        (*record_offsets_[file_index])[index - first_records_[file_index]];
+    out_tensors->clear();
+    out_tensors->emplace_back(DT_STRING, TensorShape({}));
+    return reader.ReadRecord(&offset, &out_tensors->back().scalar<tstring>()());
+  }
+
  protected:
   Status AsGraphDefInternal(SerializationContext* ctx,
                             DatasetGraphDefBuilder* b,
@@ -167,7 +224,28 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       do {
         // We are currently processing a file, so try to skip reading
         // the next (num_to_skip - *num_skipped) record.
-        if (reader_) {
+        if (reader_ && record_offsets() != nullptr) {
+          // The records to skip are found in the index, without reading
+          // their headers.
+          const std::vector<uint64>& offsets = *record_offsets();
+          const int64_t next_record =
+              std::lower_bound(offsets.begin(), offsets.end(),
+                               reader_->TellOffset()) -
+              offsets.begin();
+          const int64_t last_num_skipped =
+              std::min<int64_t>(num_to_skip - *num_skipped,
+                                offsets.size() - next_record);
+          *num_skipped += last_num_skipped;
+          if (next_record + last_num_skipped <
+              static_cast<int64_t>(offsets.size())) {
+            TF_RETURN_IF_ERROR(
+                reader_->SeekOffset(offsets[next_record + last_num_skipped]));
+            *end_of_sequence = false;
+            return OkStatus();
+          }
+          ResetStreamsLocked();
+          ++current_file_index_;
+        } else if (reader_) {
           int last_num_skipped;
           Status s = reader_->SkipRecords(num_to_skip - *num_skipped,
                                           &last_num_skipped);
@@ -191,6 +269,19 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
           ++current_file_index_;
         }
 
+        // Indexed files whose records are all skipped are not opened.
+        while (current_file_index_ < dataset()->filenames_.size() &&
+               record_offsets() != nullptr &&
+               static_cast<int64_t>(record_offsets()->size()) <=
+                   num_to_skip - *num_skipped) {
+          *num_skipped += record_offsets()->size();
+          ++current_file_index_;
+        }
+        if (*num_skipped == num_to_skip) {
+          *end_of_sequence = false;
+          return OkStatus();
+        }
+
         // Iteration ends when there are no more files to process.
         if (current_file_index_ == dataset()->filenames_.size()) {
           *end_of_sequence = true;
@@ -261,6 +352,13 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       file_.reset();
     }
 
+    // Returns the offsets of the records of the file at `current_file_index_`,
+    // or nullptr if it has no index.
+    const std::vector<uint64>* record_offsets() const
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      return dataset()->record_offsets_[current_file_index_].get();
+    }
+
     mutex mu_;
     size_t current_file_index_ TF_GUARDED_BY(mu_) = 0;
 
@@ -273,6 +371,10 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
   const std::vector<string> filenames_;
   const tstring compression_type_;
   io::RecordReaderOptions options_;
+  const std::vector<std::unique_ptr<std::vector<uint64>>> record_offsets_;
+  // The index of the first record of each file, followed by the number of
+  // records, if all the files have an index. Empty otherwise.
+  std::vector<int64_t> first_records_;
 };
 
 TFRecordDatasetOp::TFRecordDatasetOp(OpKernelConstruction* ctx)
@@ -324,8 +426,21 @@ void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
     buffer_size = kS3BlockSize;
   }
 
-  *output =
-      new Dataset(ctx, std::move(filenames), compression_type, buffer_size);
+  std::vector<std::unique_ptr<std::vector<uint64>>> record_offsets(
+      filenames.size());
+  if (UseRecordIndex() && compression_type.empty()) {
+    for (size_t i = 0; i < filenames.size(); ++i) {
+      const string index_filename =
+          io::RecordIndexFilename(TranslateFileName(filenames[i]));
+      if (!ctx->env()->FileExists(index_filename).ok()) continue;
+      record_offsets[i] = std::make_unique<std::vector<uint64>>();
+      OP_REQUIRES_OK(ctx, io::ReadRecordIndex(ctx->env(), index_filename,
+                                              record_offsets[i].get()));
+    }
+  }
+
+  *output = new Dataset(ctx, std::move(filenames), compression_type,
+                        buffer_size, std::move(record_offsets));
 }
 
 namespace {
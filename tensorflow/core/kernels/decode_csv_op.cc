@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/csv_util.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/strings/numbers.h"
 
@@ -232,17 +233,17 @@ class DecodeCSVOp : public OpKernel {
         // This is the body of the field;
         string field;
         if (!quoted) {
-          while (static_cast<size_t>(current_idx) < input.size() &&
-                 input[current_idx] != delim_) {
-            OP_REQUIRES(ctx,
-                        (!use_quote_delim_ || input[current_idx] != '"') &&
-                            input[current_idx] != '\n' &&
-                            input[current_idx] != '\r',
-                        errors::InvalidArgument(
-                            "Unquoted fields cannot have quotes/CRLFs inside"));
-            if (include) field += input[current_idx];
-            current_idx++;
+          const size_t field_end =
+              csv::FindFieldEnd(input.data(), current_idx, input.size(),
+                                delim_, use_quote_delim_);
+          OP_REQUIRES(ctx,
+                      field_end == input.size() || input[field_end] == delim_,
+                      errors::InvalidArgument(
+                          "Unquoted fields cannot have quotes/CRLFs inside"));
+          if (include) {
+            field.assign(input.data() + current_idx, field_end - current_idx);
           }
+          current_idx = field_end;
 
           // Go to next field or the end
           current_idx++;
@@ -252,8 +253,14 @@ class DecodeCSVOp : public OpKernel {
               (static_cast<size_t>(current_idx) < input.size() - 1) &&
               (input[current_idx] != '"' || input[current_idx + 1] != delim_)) {
             if (input[current_idx] != '"') {
-              if (include) field += input[current_idx];
-              current_idx++;
+              // Copies the bytes up to the next quote at once.
+              const size_t run_end =
+                  csv::FindQuote(input.data(), current_idx, input.size() - 1);
+              if (include) {
+                field.append(input.data() + current_idx,
+                             run_end - current_idx);
+              }
+              current_idx = run_end;
             } else {
               OP_REQUIRES(
                   ctx, input[current_idx + 1] == '"',
@@ -27,6 +27,18 @@ limitations under the License.
 
 namespace tensorflow {
 
+namespace {
+
+bool IsTensorAligned(const void* ptr) {
+#if EIGEN_MAX_ALIGN_BYTES == 0
+  return true;
+#else
+  return reinterpret_cast<intptr_t>(ptr) % EIGEN_MAX_ALIGN_BYTES == 0;
+#endif
+}
+
+}  // namespace
+
 template <typename T>
 class DecodeRawOp : public OpKernel {
  public:
@@ -71,6 +83,23 @@ class DecodeRawOp : public OpKernel {
                                 ", the size of ", DataTypeString(out_type_)));
     const int64_t added_dim = str_size / sizeof(T);
     out_shape.AddDim(added_dim);
+
+    // A single string that is already in the host's byte order, and aligned
+    // like the data of a tensor, is aliased instead of copied. The output
+    // holds a reference to the input, which keeps the string alive, and does
+    // not own its memory, so that no kernel forwards it to write in place.
+    const char* str_data = flat_in(0).data();
+    if (flat_in.size() == 1 && (!convert_data_endianness_ || sizeof(T) == 1) &&
+        IsTensorAligned(str_data)) {
+      Tensor output;
+      OP_REQUIRES_OK(context, Tensor::FromExternal(
+                                  out_type_, out_shape,
+                                  const_cast<char*>(str_data), str_size,
+                                  [input]() {}, &output));
+      context->set_output(0, output);
+      return;
+    }
+
     Tensor* output_tensor = nullptr;
     OP_REQUIRES_OK(
         context, context->allocate_output("output", out_shape, &output_tensor));
@@ -23,6 +23,8 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/byte_order.h"
 #include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/prefetch.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace {
@@ -53,14 +55,29 @@ void FarmhashFingerprint64(TTypes<uint8, 2>::ConstTensor input,
 }
 
 void FarmhashFingerprint64(TTypes<tstring>::ConstFlat input,
-                           TTypes<uint8, 2>::Matrix output) {
+                           TTypes<uint8, 2>::Matrix output,
+                           const DeviceBase::CpuWorkerThreads& worker_threads) {
   DCHECK_EQ(output.dimension(0), input.dimension(0));
   DCHECK_EQ(output.dimension(1), sizeof(uint64));
-  for (int64_t i = 0; i < input.dimension(0); ++i) {
-    const uint64 fingerprint =
-        Fingerprint64({input(i).data(), input(i).size()});
-    CopyToBuffer(fingerprint, &output(i, 0));
-  }
+  // How many strings ahead of the one being fingerprinted to prefetch.
+  constexpr int64_t kPrefetchDistance = 8;
+  // Approximate number of cycles to fingerprint a short string.
+  constexpr int64_t kCostPerString = 100;
+  auto fingerprint_range = [&input, &output](int64_t start, int64_t limit) {
+    for (int64_t i = start; i < limit; ++i) {
+      // Long strings live in their own allocation, away from the contiguous
+      // tstring headers.
+      if (i + kPrefetchDistance < limit) {
+        port::prefetch<port::PREFETCH_HINT_T0>(
+            input(i + kPrefetchDistance).data());
+      }
+      const uint64 fingerprint =
+          Fingerprint64({input(i).data(), input(i).size()});
+      CopyToBuffer(fingerprint, &output(i, 0));
+    }
+  };
+  Shard(worker_threads.num_threads, worker_threads.workers, input.dimension(0),
+        kCostPerString, fingerprint_range);
 }
 
 class FingerprintOp : public OpKernel {
@@ -104,6 +121,8 @@ class FingerprintOp : public OpKernel {
                        0, TensorShape{dim0, kFingerprintSize}, &output));
 
     if (input.dtype() == DT_STRING) {
+      const DeviceBase::CpuWorkerThreads& worker_threads =
+          *context->device()->tensorflow_cpu_worker_threads();
       if (dim1 > 1) {
         Tensor temp;
         OP_REQUIRES_OK(context, context->allocate_temp(
@@ -115,14 +134,16 @@ class FingerprintOp : public OpKernel {
         // and each row contains the fingerprint value of corresponding string.
         // To compute fingerprints of multiple strings, this op fingerprints the
         // buffer containing the string fingerprints.
-        FarmhashFingerprint64(input.flat<tstring>(), temp.tensor<uint8, 2>());
+        FarmhashFingerprint64(input.flat<tstring>(), temp.tensor<uint8, 2>(),
+                              worker_threads);
         FarmhashFingerprint64(static_cast<const Tensor&>(temp).shaped<uint8, 2>(
                                   {dim0, dim1 * kFingerprintSize}),
                               output->matrix<uint8>());
       } else {
         // In case dim1 == 1, each string computes into its own fingerprint
         // value. There is no need to fingerprint twice.
-        FarmhashFingerprint64(input.flat<tstring>(), output->matrix<uint8>());
+        FarmhashFingerprint64(input.flat<tstring>(), output->matrix<uint8>(),
+                              worker_threads);
       }
     } else {
       auto data = input.bit_casted_shaped<uint8, 2>(
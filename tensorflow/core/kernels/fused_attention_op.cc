@@ -0,0 +1,253 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Implements the _FusedAttention op, which the remapper creates from the
+// BatchMatMul + Softmax + BatchMatMul pattern of attention layers.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "third_party/eigen3/Eigen/Core"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/math/math_util.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Number of queries and keys in a block of attention scores. A block of float
+// scores is 64KiB, so that it stays in cache between the two products that use
+// it.
+constexpr int64_t kQueryBlockSize = 64;
+constexpr int64_t kKeyBlockSize = 256;
+
+}  // namespace
+
+template <typename T>
+class FusedAttentionOp : public OpKernel {
+ public:
+  explicit FusedAttentionOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("scale", &scale_));
+    int num_args;
+    OP_REQUIRES_OK(context, context->GetAttr("num_args", &num_args));
+    OP_REQUIRES(context, num_args <= 1,
+                errors::InvalidArgument(
+                    "_FusedAttention supports at most one mask, got ",
+                    num_args, " args"));
+    has_mask_ = num_args == 1;
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& query = context->input(0);
+    const Tensor& key = context->input(1);
+    const Tensor& value = context->input(2);
+    const int rank = query.dims();
+    OP_REQUIRES(
+        context, rank >= 2 && key.dims() == rank && value.dims() == rank,
+        errors::InvalidArgument(
+            "query, key and value must have the same rank >= 2, got shapes ",
+            query.shape().DebugString(), ", ", key.shape().DebugString(),
+            " and ", value.shape().DebugString()));
+    int64_t num_batches = 1;
+    for (int i = 0; i < rank - 2; ++i) {
+      OP_REQUIRES(context,
+                  key.dim_size(i) == query.dim_size(i) &&
+                      value.dim_size(i) == query.dim_size(i),
+                  errors::InvalidArgument(
+                      "query, key and value must have the same batch "
+                      "dimensions, got shapes ",
+                      query.shape().DebugString(), ", ",
+                      key.shape().DebugString(), " and ",
+                      value.shape().DebugString()));
+      num_batches *= query.dim_size(i);
+    }
+    const int64_t num_queries = query.dim_size(rank - 2);
+    const int64_t depth = query.dim_size(rank - 1);
+    const int64_t num_keys = key.dim_size(rank - 2);
+    const int64_t value_depth = value.dim_size(rank - 1);
+    OP_REQUIRES(context, key.dim_size(rank - 1) == depth,
+                errors::InvalidArgument(
+                    "query and key must have the same depth, got shapes ",
+                    query.shape().DebugString(), " and ",
+                    key.shape().DebugString()));
+    OP_REQUIRES(context, value.dim_size(rank - 2) == num_keys,
+                errors::InvalidArgument(
+                    "key and value must have the same length, got shapes ",
+                    key.shape().DebugString(), " and ",
+                    value.shape().DebugString()));
+
+    TensorShape scores_shape = query.shape();
+    scores_shape.set_dim(rank - 1, num_keys);
+    TensorShape output_shape = query.shape();
+    output_shape.set_dim(rank - 1, value_depth);
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(0, output_shape, &output));
+    if (output->NumElements() == 0) return;
+    if (num_keys == 0) {
+      // Attending to no keys gives 0, like the product with empty weights.
+      output->flat<T>().setZero();
+      return;
+    }
+
+    // The mask broadcasts to the scores: the strides of its dimensions, as
+    // dimensions of the scores, are 0 along the broadcast ones.
+    const T* mask_data = nullptr;
+    std::vector<int64_t> mask_batch_offsets;
+    int64_t mask_query_stride = 0;
+    int64_t mask_key_stride = 0;
+    if (has_mask_) {
+      const Tensor& mask = context->input(3);
+      const int mask_offset = rank - mask.dims();
+      OP_REQUIRES(context, mask_offset >= 0,
+                  errors::InvalidArgument(
+                      "mask of shape ", mask.shape().DebugString(),
+                      " does not broadcast to the attention scores of shape ",
+                      scores_shape.DebugString()));
+      std::vector<int64_t> mask_strides(rank, 0);
+      int64_t stride = 1;
+      for (int i = rank - 1; i >= mask_offset; --i) {
+        const int64_t dim = mask.dim_size(i - mask_offset);
+        OP_REQUIRES(
+            context, dim == 1 || dim == scores_shape.dim_size(i),
+            errors::InvalidArgument(
+                "mask of shape ", mask.shape().DebugString(),
+                " does not broadcast to the attention scores of shape ",
+                scores_shape.DebugString()));
+        if (dim != 1) mask_strides[i] = stride;
+        stride *= dim;
+      }
+      mask_query_stride = mask_strides[rank - 2];
+      mask_key_stride = mask_strides[rank - 1];
+      mask_batch_offsets.resize(num_batches);
+      for (int64_t b = 0; b < num_batches; ++b) {
+        int64_t offset = 0;
+        int64_t index = b;
+        for (int i = rank - 3; i >= 0; --i) {
+          offset += (index % query.dim_size(i)) * mask_strides[i];
+          index /= query.dim_size(i);
+        }
+        mask_batch_offsets[b] = offset;
+      }
+      mask_data = mask.flat<T>().data();
+    }
+
+    using Matrix =
+        Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+    using Vector = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+    using ConstMatrixMap = Eigen::Map<const Matrix>;
+    using MatrixMap = Eigen::Map<Matrix>;
+    const T* query_data = query.flat<T>().data();
+    const T* key_data = key.flat<T>().data();
+    const T* value_data = value.flat<T>().data();
+    T* output_data = output->flat<T>().data();
+    const T scale = static_cast<T>(scale_);
+    const int64_t num_query_blocks =
+        MathUtil::CeilOfRatio(num_queries, kQueryBlockSize);
+
+    // Each unit of work computes the outputs of a block of queries. It goes
+    // over the keys one block at a time, and keeps the running maximum and sum
+    // of the exponentiated scores of each query, with which it rescales the
+    // weighted sum of the values whenever the maximum grows.
+    auto work = [&](int64_t begin, int64_t end) {
+      Matrix scores(kQueryBlockSize, kKeyBlockSize);
+      Matrix weighted_values(kQueryBlockSize, value_depth);
+      Vector row_max(kQueryBlockSize);
+      Vector row_sum(kQueryBlockSize);
+      for (int64_t unit = begin; unit < end; ++unit) {
+        const int64_t b = unit / num_query_blocks;
+        const int64_t q_begin = (unit % num_query_blocks) * kQueryBlockSize;
+        const int64_t nq = std::min(kQueryBlockSize, num_queries - q_begin);
+        ConstMatrixMap q(query_data + (b * num_queries + q_begin) * depth, nq,
+                         depth);
+        auto acc = weighted_values.topRows(nq);
+        acc.setZero();
+        row_max.setConstant(-std::numeric_limits<T>::infinity());
+        row_sum.setZero();
+
+        for (int64_t k_begin = 0; k_begin < num_keys;
+             k_begin += kKeyBlockSize) {
+          const int64_t nk = std::min(kKeyBlockSize, num_keys - k_begin);
+          ConstMatrixMap k(key_data + (b * num_keys + k_begin) * depth, nk,
+                           depth);
+          ConstMatrixMap v(
+              value_data + (b * num_keys + k_begin) * value_depth, nk,
+              value_depth);
+          auto s = scores.topLeftCorner(nq, nk);
+          s.noalias() = q * k.transpose();
+          s *= scale;
+          if (mask_data != nullptr) {
+            const T* mask_block = mask_data + mask_batch_offsets[b] +
+                                  q_begin * mask_query_stride +
+                                  k_begin * mask_key_stride;
+            for (int64_t r = 0; r < nq; ++r) {
+              for (int64_t c = 0; c < nk; ++c) {
+                s(r, c) +=
+                    mask_block[r * mask_query_stride + c * mask_key_stride];
+              }
+            }
+          }
+          for (int64_t r = 0; r < nq; ++r) {
+            const T new_max = std::max(row_max(r), s.row(r).maxCoeff());
+            if (new_max == -std::numeric_limits<T>::infinity()) {
+              // All the scores so far are masked out.
+              s.row(r).setZero();
+              continue;
+            }
+            const T correction = std::exp(row_max(r) - new_max);
+            s.row(r) = (s.row(r).array() - new_max).exp().matrix();
+            row_sum(r) = row_sum(r) * correction + s.row(r).sum();
+            acc.row(r) *= correction;
+            row_max(r) = new_max;
+          }
+          acc.noalias() += s * v;
+        }
+
+        MatrixMap out(output_data + (b * num_queries + q_begin) * value_depth,
+                      nq, value_depth);
+        out = (acc.array().colwise() / row_sum.head(nq).array()).matrix();
+      }
+    };
+    const int64_t cost_per_unit =
+        kQueryBlockSize * num_keys * (depth + value_depth) * 2;
+    const auto& worker_threads =
+        *(context->device()->tensorflow_cpu_worker_threads());
+    Shard(worker_threads.num_threads, worker_threads.workers,
+          num_batches * num_query_blocks, cost_per_unit, work);
+  }
+
+ private:
+  float scale_;
+  bool has_mask_;
+};
+
+#define REGISTER_CPU(T)                                                  \
+  REGISTER_KERNEL_BUILDER(                                               \
+      Name("_FusedAttention").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      FusedAttentionOp<T>);
+
+TF_CALL_float(REGISTER_CPU);
+
+#undef REGISTER_CPU
+
+}  // namespace tensorflow
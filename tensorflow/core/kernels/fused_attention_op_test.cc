@@ -0,0 +1,130 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class FusedAttentionOpTest : public OpsTestBase {
+ protected:
+  // Runs _FusedAttention on [batch, Sq, D] queries, [batch, Sk, D] keys and
+  // [batch, Sk, Dv] values, with an optional [Sk] mask, and checks it against
+  // the unfused computation.
+  void RunTest(int64_t batch, int64_t num_queries, int64_t num_keys,
+               int64_t depth, int64_t value_depth, bool with_mask) {
+    const float scale = 0.125f;
+    TF_ASSERT_OK(NodeDefBuilder("attention", "_FusedAttention")
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(with_mask ? 1 : 0, DT_FLOAT))
+                     .Attr("num_args", with_mask ? 1 : 0)
+                     .Attr("scale", scale)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+
+    Tensor query(DT_FLOAT, TensorShape({batch, num_queries, depth}));
+    Tensor key(DT_FLOAT, TensorShape({batch, num_keys, depth}));
+    Tensor value(DT_FLOAT, TensorShape({batch, num_keys, value_depth}));
+    Tensor mask(DT_FLOAT, TensorShape({num_keys}));
+    query.flat<float>().setRandom();
+    key.flat<float>().setRandom();
+    value.flat<float>().setRandom();
+    auto mask_values = mask.vec<float>();
+    for (int64_t j = 0; j < num_keys; ++j) {
+      // Mask out one key in three.
+      mask_values(j) = j % 3 == 0 ? -std::numeric_limits<float>::infinity()
+                                  : 0.1f * j;
+    }
+    AddInputFromArray<float>(query.shape(), query.flat<float>());
+    AddInputFromArray<float>(key.shape(), key.flat<float>());
+    AddInputFromArray<float>(value.shape(), value.flat<float>());
+    if (with_mask) AddInputFromArray<float>(mask.shape(), mask.flat<float>());
+    TF_ASSERT_OK(RunOpKernel());
+
+    Tensor expected(DT_FLOAT, TensorShape({batch, num_queries, value_depth}));
+    auto q = query.tensor<float, 3>();
+    auto k = key.tensor<float, 3>();
+    auto v = value.tensor<float, 3>();
+    auto out = expected.tensor<float, 3>();
+    for (int64_t b = 0; b < batch; ++b) {
+      for (int64_t i = 0; i < num_queries; ++i) {
+        std::vector<double> weights(num_keys);
+        double max_score = -std::numeric_limits<double>::infinity();
+        for (int64_t j = 0; j < num_keys; ++j) {
+          double score = 0;
+          for (int64_t d = 0; d < depth; ++d) score += q(b, i, d) * k(b, j, d);
+          weights[j] = score * scale + (with_mask ? mask_values(j) : 0.0);
+          max_score = std::max(max_score, weights[j]);
+        }
+        double sum = 0;
+        for (double& weight : weights) {
+          weight = std::exp(weight - max_score);
+          sum += weight;
+        }
+        for (int64_t d = 0; d < value_depth; ++d) {
+          double result = 0;
+          for (int64_t j = 0; j < num_keys; ++j) {
+            result += weights[j] * v(b, j, d);
+          }
+          out(b, i, d) = result / sum;
+        }
+      }
+    }
+    test::ExpectClose(expected, *GetOutput(0), /*atol=*/1e-5, /*rtol=*/1e-5);
+  }
+};
+
+TEST_F(FusedAttentionOpTest, Small) { RunTest(2, 3, 5, 4, 3, false); }
+
+TEST_F(FusedAttentionOpTest, SmallWithMask) { RunTest(2, 3, 5, 4, 3, true); }
+
+// Several blocks of queries and keys, which exercise the online softmax.
+TEST_F(FusedAttentionOpTest, Blocks) { RunTest(3, 130, 600, 16, 8, false); }
+
+TEST_F(FusedAttentionOpTest, BlocksWithMask) {
+  RunTest(3, 130, 600, 16, 8, true);
+}
+
+TEST_F(FusedAttentionOpTest, MaskMustBroadcast) {
+  TF_ASSERT_OK(NodeDefBuilder("attention", "_FusedAttention")
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(1, DT_FLOAT))
+                   .Attr("num_args", 1)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddInputFromArray<float>(TensorShape({1, 2, 1}), {1, 2});
+  AddInputFromArray<float>(TensorShape({1, 3, 1}), {1, 2, 3});
+  AddInputFromArray<float>(TensorShape({1, 3, 1}), {1, 2, 3});
+  AddInputFromArray<float>(TensorShape({2}), {0, 0});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+}  // namespace
+}  // namespace tensorflow
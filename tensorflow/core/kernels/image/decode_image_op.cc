@@ -15,8 +15,11 @@ limitations under the License.
 
 // See docs in ../ops/image_ops.cc
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "tensorflow/core/lib/gtl/cleanup.h"
 
@@ -37,6 +40,7 @@ limitations under the License.
 #include "tensorflow/core/platform/byte_order.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/util/tensor_bundle/byte_swap.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace {
@@ -86,20 +90,25 @@ class DecodeImageV2Op : public OpKernel {
     // Validate op type.
     OP_REQUIRES(context,
                 op_type_ == "DecodeJpeg" || op_type_ == "DecodeAndCropJpeg" ||
+                    op_type_ == "DecodeAndResizeJpeg" ||
                     op_type_ == "DecodePng" || op_type_ == "DecodeGif" ||
                     op_type_ == "DecodeBmp" || op_type_ == "DecodeImage",
                 errors::InvalidArgument("Bad op type ", op_type_));
 
-    // Get attributes from `DecodeJpeg` and `DecodeAndCropJpeg` op
-    // invocations. For `DecodeImage` op, set JPEG decoding setting to TF
-    // default.
-    if (op_type_ == "DecodeJpeg" || op_type_ == "DecodeAndCropJpeg") {
-      OP_REQUIRES_OK(context, context->GetAttr("ratio", &flags_.ratio));
-      OP_REQUIRES(context,
-                  flags_.ratio == 1 || flags_.ratio == 2 || flags_.ratio == 4 ||
-                      flags_.ratio == 8,
-                  errors::InvalidArgument("ratio must be 1, 2, 4, or 8, got ",
-                                          flags_.ratio));
+    // Get attributes from `DecodeJpeg`, `DecodeAndCropJpeg` and
+    // `DecodeAndResizeJpeg` op invocations. For `DecodeImage` op, set JPEG
+    // decoding setting to TF default.
+    if (op_type_ == "DecodeJpeg" || op_type_ == "DecodeAndCropJpeg" ||
+        op_type_ == "DecodeAndResizeJpeg") {
+      // `DecodeAndResizeJpeg` picks the ratio from the image and output sizes.
+      if (op_type_ != "DecodeAndResizeJpeg") {
+        OP_REQUIRES_OK(context, context->GetAttr("ratio", &flags_.ratio));
+        OP_REQUIRES(context,
+                    flags_.ratio == 1 || flags_.ratio == 2 ||
+                        flags_.ratio == 4 || flags_.ratio == 8,
+                    errors::InvalidArgument("ratio must be 1, 2, 4, or 8, got ",
+                                            flags_.ratio));
+      }
       OP_REQUIRES_OK(context, context->GetAttr("fancy_upscaling",
                                                &flags_.fancy_upscaling));
       OP_REQUIRES_OK(context,
@@ -229,7 +238,10 @@ class DecodeImageV2Op : public OpKernel {
     jpeg::UncompressFlags flags = flags_;
     flags.components = channels_;
 
-    if (op_type_ == "DecodeAndCropJpeg") {
+    if (op_type_ == "DecodeAndResizeJpeg") {
+      DecodeAndResizeJpegV2(context, input, flags);
+      return;
+    } else if (op_type_ == "DecodeAndCropJpeg") {
       flags.crop = true;
       // Update flags to include crop window.
       const Tensor& crop_window = context->input(1);
@@ -321,6 +333,119 @@ class DecodeImageV2Op : public OpKernel {
     }
   }
 
+  // Decodes the JPEG with the largest DCT scaling that keeps it at least as
+  // large as `size`, and then resizes it to `size` like ResizeBilinear with
+  // half pixel centers. Most of the pixels of a full decode would only be
+  // averaged away by the resize, so this skips computing them.
+  void DecodeAndResizeJpegV2(OpKernelContext* context, StringPiece input,
+                             jpeg::UncompressFlags flags) {
+    const Tensor& size = context->input(1);
+    OP_REQUIRES(context, size.dims() == 1 && size.dim_size(0) == 2,
+                errors::InvalidArgument("size must be 1-D with 2 elements, ",
+                                        "got shape ",
+                                        size.shape().DebugString()));
+    const int64_t out_height = size.vec<int32>()(0);
+    const int64_t out_width = size.vec<int32>()(1);
+    OP_REQUIRES(context, out_height > 0 && out_width > 0,
+                errors::InvalidArgument("size must be positive, got ",
+                                        out_height, "x", out_width));
+
+    int image_width, image_height;
+    OP_REQUIRES(context,
+                jpeg::GetImageInfo(input.data(), input.size(), &image_width,
+                                   &image_height, nullptr),
+                errors::InvalidArgument("Invalid JPEG data, size ",
+                                        input.size()));
+    // libjpeg rounds the scaled dimensions up.
+    flags.ratio = 1;
+    for (const int ratio : {8, 4, 2}) {
+      if ((image_height + ratio - 1) / ratio >= out_height &&
+          (image_width + ratio - 1) / ratio >= out_width) {
+        flags.ratio = ratio;
+        break;
+      }
+    }
+
+    Tensor decoded;
+    uint8* buffer = jpeg::Uncompress(
+        input.data(), input.size(), flags, nullptr /* nwarn */,
+        [&](int width, int height, int channels) -> uint8* {
+          Status status = context->allocate_temp(
+              DT_UINT8, TensorShape({height, width, channels}), &decoded);
+          if (!status.ok()) {
+            VLOG(1) << status;
+            context->SetStatus(status);
+            return nullptr;
+          }
+          return decoded.flat<uint8>().data();
+        });
+    OP_REQUIRES(context, buffer,
+                errors::InvalidArgument(
+                    "jpeg::Uncompress failed. Invalid JPEG data."));
+
+    const int64_t in_height = decoded.dim_size(0);
+    const int64_t in_width = decoded.dim_size(1);
+    const int64_t channels = decoded.dim_size(2);
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(
+                       0, TensorShape({out_height, out_width, channels}),
+                       &output));
+
+    // The two input rows or columns that each output row or column is
+    // interpolated from, and the weight of the second one.
+    struct Weight {
+      int64_t lower;
+      int64_t upper;
+      float lerp;
+    };
+    const auto compute_weights = [](int64_t out_size, int64_t in_size) {
+      const float scale = static_cast<float>(in_size) / out_size;
+      std::vector<Weight> weights(out_size);
+      for (int64_t i = 0; i < out_size; ++i) {
+        const float in = (i + 0.5f) * scale - 0.5f;
+        const float in_f = std::floor(in);
+        weights[i].lower = std::max(static_cast<int64_t>(in_f), int64_t{0});
+        weights[i].upper =
+            std::min(static_cast<int64_t>(std::ceil(in)), in_size - 1);
+        weights[i].lerp = in - in_f;
+      }
+      return weights;
+    };
+    const std::vector<Weight> ys = compute_weights(out_height, in_height);
+    const std::vector<Weight> xs = compute_weights(out_width, in_width);
+
+    const uint8* in_data = decoded.flat<uint8>().data();
+    float* out_data = output->flat<float>().data();
+    const int64_t in_row_size = in_width * channels;
+    const int64_t out_row_size = out_width * channels;
+    auto resize_rows = [&](int64_t begin, int64_t end) {
+      for (int64_t y = begin; y < end; ++y) {
+        const uint8* top = in_data + ys[y].lower * in_row_size;
+        const uint8* bottom = in_data + ys[y].upper * in_row_size;
+        const float y_lerp = ys[y].lerp;
+        float* out_row = out_data + y * out_row_size;
+        for (int64_t x = 0; x < out_width; ++x) {
+          const int64_t left = xs[x].lower * channels;
+          const int64_t right = xs[x].upper * channels;
+          const float x_lerp = xs[x].lerp;
+          for (int64_t c = 0; c < channels; ++c) {
+            const float top_value =
+                top[left + c] + (top[right + c] - top[left + c]) * x_lerp;
+            const float bottom_value =
+                bottom[left + c] +
+                (bottom[right + c] - bottom[left + c]) * x_lerp;
+            out_row[x * channels + c] =
+                top_value + (bottom_value - top_value) * y_lerp;
+          }
+        }
+      }
+    };
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, out_height,
+          out_row_size * 10, resize_rows);
+  }
+
   void DecodePngV2(OpKernelContext* context, StringPiece input) {
     int channel_bits = (data_type_ == DataType::DT_UINT8) ? 8 : 16;
     png::DecodeContext decode;
@@ -380,11 +505,12 @@ class DecodeImageV2Op : public OpKernel {
                   errors::InvalidArgument(
                       "Trying to decode PNG format using DecodeBmp op. Use "
                       "`decode_png` or `decode_image` instead."));
-    } else if (op_type_ == "DecodeAndCropJpeg") {
+    } else if (op_type_ == "DecodeAndCropJpeg" ||
+               op_type_ == "DecodeAndResizeJpeg") {
       OP_REQUIRES(context, false,
                   errors::InvalidArgument(
-                      "DecodeAndCropJpeg operation can run on JPEG only, but "
-                      "detected PNG."));
+                      op_type_,
+                      " operation can run on JPEG only, but detected PNG."));
     }
 
     if (data_type_ == DataType::DT_UINT8) {
@@ -441,11 +567,12 @@ class DecodeImageV2Op : public OpKernel {
                   errors::InvalidArgument(
                       "Trying to decode GIF format using DecodeBmp op. Use "
                       "`decode_gif` or `decode_image` instead."));
-    } else if (op_type_ == "DecodeAndCropJpeg") {
+    } else if (op_type_ == "DecodeAndCropJpeg" ||
+               op_type_ == "DecodeAndResizeJpeg") {
       OP_REQUIRES(context, false,
                   errors::InvalidArgument(
-                      "DecodeAndCropJpeg operation can run on JPEG only, but "
-                      "detected GIF."));
+                      op_type_,
+                      " operation can run on JPEG only, but detected GIF."));
     }
 
     // Decode GIF, allocating tensor if dtype is uint8, otherwise defer tensor
@@ -533,11 +660,12 @@ class DecodeImageV2Op : public OpKernel {
             "`channels` must be 0, 3 or 4 for BMP, but got ", channels_));
 
     if (op_type_ != "DecodeBmp" && op_type_ != "DecodeImage") {
-      if (op_type_ == "DecodeAndCropJpeg") {
+      if (op_type_ == "DecodeAndCropJpeg" ||
+          op_type_ == "DecodeAndResizeJpeg") {
         OP_REQUIRES(context, false,
                     errors::InvalidArgument(
-                        "DecodeAndCropJpeg operation can run on JPEG only, but "
-                        "detected BMP."));
+                        op_type_,
+                        " operation can run on JPEG only, but detected BMP."));
       } else {
         OP_REQUIRES(context, false,
                     errors::InvalidArgument(
@@ -677,6 +805,8 @@ REGISTER_KERNEL_BUILDER(Name("DecodePng").Device(DEVICE_CPU), DecodeImageV2Op);
 REGISTER_KERNEL_BUILDER(Name("DecodeGif").Device(DEVICE_CPU), DecodeImageV2Op);
 REGISTER_KERNEL_BUILDER(Name("DecodeAndCropJpeg").Device(DEVICE_CPU),
                         DecodeImageV2Op);
+REGISTER_KERNEL_BUILDER(Name("DecodeAndResizeJpeg").Device(DEVICE_CPU),
+                        DecodeImageV2Op);
 REGISTER_KERNEL_BUILDER(Name("DecodeImage").Device(DEVICE_CPU),
                         DecodeImageV2Op);
 REGISTER_KERNEL_BUILDER(Name("DecodeBmp").Device(DEVICE_CPU), DecodeImageV2Op);
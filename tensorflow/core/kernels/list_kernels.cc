@@ -29,6 +29,7 @@ limitations under the License.
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor_types.h"
@@ -100,6 +101,7 @@ Status ForwardInputOrCreateNewList(OpKernelContext* c, int32_t input_index,
       input_index, output_index, DT_VARIANT, TensorShape{},
       c->input_memory_type(input_index), AllocatorAttributes());
   Tensor* output_tensor;
+  bool list_is_shared = false;
   if (maybe_output != nullptr && maybe_output->dtype() == DT_VARIANT &&
       maybe_output->NumElements() == 1) {
     output_tensor = maybe_output.get();
@@ -115,10 +117,18 @@ Status ForwardInputOrCreateNewList(OpKernelContext* c, int32_t input_index,
       *output_list = tmp_out;
       return OkStatus();
     }
+    list_is_shared = true;
   }
 
   // If forwarding is not possible allocate a new output tensor and copy
-  // the `input_list` to it.
+  // the `input_list` to it. In a loop that appends to a list this makes each
+  // iteration linear in the length of the list, so the copies are counted.
+  VLOG(2) << c->op_kernel().name() << " copies a TensorList of "
+          << input_list.tensors().size() << " elements, because "
+          << (list_is_shared ? "its elements are shared with another list"
+                             : "its input tensor cannot be forwarded");
+  metrics::RecordTensorListCopy(c->op_kernel().type_string(),
+                                input_list.tensors().size());
   AllocatorAttributes attr;
   attr.set_on_host(true);
   TF_RETURN_IF_ERROR(
@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/shape_inference_testutil.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
@@ -100,5 +101,32 @@ TEST_F(LookupOpsTest, AnonymousHashTable_RefCounting) {
   EXPECT_FALSE(alive);
 }
 
+TEST(HashTableTest, FindInLargeTable) {
+  // Large enough for the lookups to be prefetched.
+  constexpr int64_t kSize = 1 << 17;
+  Tensor keys(DT_INT64, TensorShape({kSize}));
+  Tensor values(DT_INT64, TensorShape({kSize}));
+  for (int64_t i = 0; i < kSize; ++i) {
+    keys.flat<int64_t>()(i) = 2 * i;
+    values.flat<int64_t>()(i) = i;
+  }
+  auto* table = new lookup::HashTable<int64_t, int64_t>(nullptr, nullptr);
+  core::ScopedUnref unref(table);
+  TF_ASSERT_OK(table->ImportValues(nullptr, keys, values));
+
+  // Looks up every even key, which is in the table, and every odd one, which
+  // isn't.
+  Tensor query(DT_INT64, TensorShape({2 * kSize}));
+  for (int64_t i = 0; i < 2 * kSize; ++i) {
+    query.flat<int64_t>()(i) = i;
+  }
+  Tensor found(DT_INT64, TensorShape({2 * kSize}));
+  TF_ASSERT_OK(table->Find(nullptr, query, &found,
+                           test::AsScalar<int64_t>(-1)));
+  for (int64_t i = 0; i < 2 * kSize; ++i) {
+    EXPECT_EQ(found.flat<int64_t>()(i), i % 2 == 0 ? i / 2 : -1) << i;
+  }
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -16,17 +16,25 @@ limitations under the License.
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
+#include <array>
 #include <string>
 #include <type_traits>
 #include <utility>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/kernels/initializable_lookup_table.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/prefetch.h"
 #include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace lookup {
@@ -36,7 +44,102 @@ std::string UniqueNodeName(const std::string& base) {
   return strings::StrCat(base, "/", counter.fetch_add(1), "/", random::New64());
 }
 
-// Lookup table that wraps an unordered_map, where the key and value data type
+namespace {
+
+// A hash map split into shards by key, each with its own lock, used by the
+// mutable hash tables below so that concurrent Find and Insert calls only
+// contend when they touch keys of the same shard. Each shard is an
+// absl::flat_hash_map, which probes a group of slots at a time with SIMD
+// instructions.
+template <class K, class V>
+class ShardedHashMap {
+ public:
+  struct Hash {
+    template <typename T>
+    size_t operator()(const T& key) const {
+      return absl::Hash<T>()(key);
+    }
+    size_t operator()(const tstring& key) const {
+      return absl::Hash<absl::string_view>()(
+          absl::string_view(key.data(), key.size()));
+    }
+  };
+
+  struct alignas(64) Shard {
+    mutable mutex mu;
+    absl::flat_hash_map<K, V, Hash> map TF_GUARDED_BY(mu);
+  };
+
+  // Returns the shard that holds `key`. The shard is chosen from the top
+  // bits of the hash, which the map itself only uses for huge tables.
+  Shard& GetShard(const K& key) {
+    return shards_[static_cast<uint64>(Hash()(key)) >> (64 - kShardBits)];
+  }
+
+  // Returns the number of entries, which is only a snapshot if the map is
+  // concurrently modified.
+  size_t size() const {
+    size_t size = 0;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      size += shard.map.size();
+    }
+    return size;
+  }
+
+  // Returns the total number of slots of the shards.
+  size_t capacity() const {
+    size_t capacity = 0;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      capacity += shard.map.capacity();
+    }
+    return capacity;
+  }
+
+  // Locks all of the shards, in order, for operations on the whole map.
+  void LockAll() TF_NO_THREAD_SAFETY_ANALYSIS {
+    for (Shard& shard : shards_) shard.mu.lock();
+  }
+  void UnlockAll() TF_NO_THREAD_SAFETY_ANALYSIS {
+    for (Shard& shard : shards_) shard.mu.unlock();
+  }
+  void LockAllShared() const TF_NO_THREAD_SAFETY_ANALYSIS {
+    for (const Shard& shard : shards_) shard.mu.lock_shared();
+  }
+  void UnlockAllShared() const TF_NO_THREAD_SAFETY_ANALYSIS {
+    for (const Shard& shard : shards_) shard.mu.unlock_shared();
+  }
+
+  // The following require all of the shards to be locked.
+  size_t SizeLocked() const TF_NO_THREAD_SAFETY_ANALYSIS {
+    size_t size = 0;
+    for (const Shard& shard : shards_) size += shard.map.size();
+    return size;
+  }
+  void ClearLocked() TF_NO_THREAD_SAFETY_ANALYSIS {
+    for (Shard& shard : shards_) shard.map.clear();
+  }
+  void InsertOrUpdateLocked(const K& key,
+                            const V& value) TF_NO_THREAD_SAFETY_ANALYSIS {
+    gtl::InsertOrUpdate(&GetShard(key).map, key, value);
+  }
+  // Calls `fn(key, value)` for every entry.
+  template <typename Fn>
+  void ForEachLocked(Fn fn) const TF_NO_THREAD_SAFETY_ANALYSIS {
+    for (const Shard& shard : shards_) {
+      for (const auto& it : shard.map) fn(it.first, it.second);
+    }
+  }
+
+ private:
+  static constexpr int kShardBits = 4;
+  std::array<Shard, 1 << kShardBits> shards_;
+};
+
+}  // namespace
+
+// Lookup table that wraps a ShardedHashMap, where the key and value data type
 // is specified. Each individual value must be a scalar. If vector values are
 // required, use MutableHashTableOfTensors.
 //
@@ -55,10 +158,7 @@ class MutableHashTableOfScalars final : public LookupInterface {
  public:
   MutableHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel) {}
 
-  size_t size() const override {
-    tf_shared_lock l(mu_);
-    return table_.size();
-  }
+  size_t size() const override { return table_.size(); }
 
   Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
               const Tensor& default_value) override {
@@ -70,8 +170,10 @@ class MutableHashTableOfScalars final : public LookupInterface {
     int64_t default_total = default_flat.size();
     bool is_full_size_default = (total == default_total);
 
-    tf_shared_lock l(mu_);
     for (int64_t i = 0; i < key_values.size(); ++i) {
+      const K key = SubtleMustCopyIfIntegral(key_values(i));
+      auto& shard = table_.GetShard(key);
+      tf_shared_lock l(shard.mu);
       // is_full_size_default is true:
       //   Each key has an independent default value, key_values(i)
       //   corresponding uses default_flat(i) as its default value.
@@ -79,7 +181,7 @@ class MutableHashTableOfScalars final : public LookupInterface {
       // is_full_size_default is false:
       //   All keys will share the default_flat(0) as default value.
       value_values(i) = gtl::FindWithDefault(
-          table_, SubtleMustCopyIfIntegral(key_values(i)),
+          shard.map, key,
           is_full_size_default ? default_flat(i) : default_flat(0));
     }
 
@@ -90,12 +192,23 @@ class MutableHashTableOfScalars final : public LookupInterface {
     const auto key_values = keys.flat<K>();
     const auto value_values = values.flat<V>();
 
-    mutex_lock l(mu_);
     if (clear) {
-      table_.clear();
+      // Replaces the contents of the table at once.
+      table_.LockAll();
+      auto unlock = gtl::MakeCleanup([this] { table_.UnlockAll(); });
+      table_.ClearLocked();
+      for (int64_t i = 0; i < key_values.size(); ++i) {
+        const K key = SubtleMustCopyIfIntegral(key_values(i));
+        table_.InsertOrUpdateLocked(key,
+                                    SubtleMustCopyIfIntegral(value_values(i)));
+      }
+      return OkStatus();
     }
     for (int64_t i = 0; i < key_values.size(); ++i) {
-      gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
+      const K key = SubtleMustCopyIfIntegral(key_values(i));
+      auto& shard = table_.GetShard(key);
+      mutex_lock l(shard.mu);
+      gtl::InsertOrUpdate(&shard.map, key,
                           SubtleMustCopyIfIntegral(value_values(i)));
     }
     return OkStatus();
@@ -109,9 +222,11 @@ class MutableHashTableOfScalars final : public LookupInterface {
   Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
     const auto key_values = keys.flat<K>();
 
-    mutex_lock l(mu_);
     for (int64_t i = 0; i < key_values.size(); ++i) {
-      table_.erase(SubtleMustCopyIfIntegral(key_values(i)));
+      const K key = SubtleMustCopyIfIntegral(key_values(i));
+      auto& shard = table_.GetShard(key);
+      mutex_lock l(shard.mu);
+      shard.map.erase(key);
     }
     return OkStatus();
   }
@@ -122,8 +237,9 @@ class MutableHashTableOfScalars final : public LookupInterface {
   }
 
   Status ExportValues(OpKernelContext* ctx) override {
-    tf_shared_lock l(mu_);
-    int64_t size = table_.size();
+    table_.LockAllShared();
+    auto unlock = gtl::MakeCleanup([this] { table_.UnlockAllShared(); });
+    int64_t size = table_.SizeLocked();
 
     Tensor* keys;
     Tensor* values;
@@ -144,22 +260,13 @@ class MutableHashTableOfScalars final : public LookupInterface {
   TensorShape value_shape() const override { return TensorShape(); }
 
   int64_t MemoryUsed() const override {
-    int64_t ret = 0;
-    tf_shared_lock l(mu_);
-    for (unsigned i = 0; i < table_.bucket_count(); ++i) {
-      size_t bucket_size = table_.bucket_size(i);
-      if (bucket_size == 0) {
-        ret++;
-      } else {
-        ret += bucket_size;
-      }
-    }
-    return sizeof(MutableHashTableOfScalars) + ret;
+    return sizeof(MutableHashTableOfScalars) + table_.capacity();
   }
 
   Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override {
-    tf_shared_lock l(mu_);
-    int64_t size = table_.size();
+    table_.LockAllShared();
+    auto unlock = gtl::MakeCleanup([this] { table_.UnlockAllShared(); });
+    int64_t size = table_.SizeLocked();
     Tensor keys(key_dtype(), TensorShape({size}));
     Tensor values(value_dtype(), TensorShape({size}));
     ExportKeysAndValues(&keys, &values);
@@ -195,24 +302,26 @@ class MutableHashTableOfScalars final : public LookupInterface {
   }
 
  private:
+  using Table = ShardedHashMap<K, V>;
+
   // Writes all keys and values into `keys` and `values`. `keys` and `values`
-  // must point to tensors of size `table_.size()`.
-  void ExportKeysAndValues(Tensor* keys, Tensor* values) const
-      TF_SHARED_LOCKS_REQUIRED(mu_) {
+  // must point to tensors of size `table_.SizeLocked()`, and all of the shards
+  // of `table_` must be locked.
+  void ExportKeysAndValues(Tensor* keys, Tensor* values) const {
     auto keys_data = keys->flat<K>();
     auto values_data = values->flat<V>();
     int64_t i = 0;
-    for (auto it = table_.begin(); it != table_.end(); ++it, ++i) {
-      keys_data(i) = it->first;
-      values_data(i) = it->second;
-    }
+    table_.ForEachLocked([&](const K& key, const V& value) {
+      keys_data(i) = key;
+      values_data(i) = value;
+      ++i;
+    });
   }
 
-  mutable mutex mu_;
-  std::unordered_map<K, V> table_ TF_GUARDED_BY(mu_);
+  Table table_;
 };
 
-// Lookup table that wraps an unordered_map. Behaves identical to
+// Lookup table that wraps a ShardedHashMap. Behaves identical to
 // MutableHashTableOfScalars except that each value must be a vector.
 template <class K, class V>
 class MutableHashTableOfTensors final : public LookupInterface {
@@ -226,10 +335,7 @@ class MutableHashTableOfTensors final : public LookupInterface {
                                 value_shape_.DebugString()));
   }
 
-  size_t size() const override {
-    tf_shared_lock l(mu_);
-    return table_.size();
-  }
+  size_t size() const override { return table_.size(); }
 
   Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
               const Tensor& default_value) override {
@@ -242,10 +348,11 @@ class MutableHashTableOfTensors final : public LookupInterface {
     int64_t default_total = default_flat.size();
     bool is_full_size_default = (total == default_total);
 
-    tf_shared_lock l(mu_);
     for (int64_t i = 0; i < key_values.size(); ++i) {
-      ValueArray* value_vec =
-          gtl::FindOrNull(table_, SubtleMustCopyIfIntegral(key_values(i)));
+      const K key = SubtleMustCopyIfIntegral(key_values(i));
+      auto& shard = table_.GetShard(key);
+      tf_shared_lock l(shard.mu);
+      const ValueArray* value_vec = gtl::FindOrNull(shard.map, key);
       if (value_vec != nullptr) {
         for (int64_t j = 0; j < value_dim; j++) {
           value_values(i, j) = value_vec->at(j);
@@ -272,18 +379,31 @@ class MutableHashTableOfTensors final : public LookupInterface {
     const auto value_values = values.flat_inner_dims<V, 2>();
     int64_t value_dim = value_shape_.dim_size(0);
 
-    mutex_lock l(mu_);
-    if (clear) {
-      table_.clear();
-    }
-    for (int64_t i = 0; i < key_values.size(); ++i) {
+    auto make_value_vec = [&](int64_t i) {
       ValueArray value_vec;
       for (int64_t j = 0; j < value_dim; j++) {
         V value = value_values(i, j);
         value_vec.push_back(value);
       }
-      gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
-                          value_vec);
+      return value_vec;
+    };
+    if (clear) {
+      // Replaces the contents of the table at once.
+      table_.LockAll();
+      auto unlock = gtl::MakeCleanup([this] { table_.UnlockAll(); });
+      table_.ClearLocked();
+      for (int64_t i = 0; i < key_values.size(); ++i) {
+        const K key = SubtleMustCopyIfIntegral(key_values(i));
+        table_.InsertOrUpdateLocked(key, make_value_vec(i));
+      }
+      return OkStatus();
+    }
+    for (int64_t i = 0; i < key_values.size(); ++i) {
+      const K key = SubtleMustCopyIfIntegral(key_values(i));
+      ValueArray value_vec = make_value_vec(i);
+      auto& shard = table_.GetShard(key);
+      mutex_lock l(shard.mu);
+      gtl::InsertOrUpdate(&shard.map, key, value_vec);
     }
     return OkStatus();
   }
@@ -296,9 +416,11 @@ class MutableHashTableOfTensors final : public LookupInterface {
   Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
     const auto key_values = keys.flat<K>();
 
-    mutex_lock l(mu_);
     for (int64_t i = 0; i < key_values.size(); ++i) {
-      table_.erase(SubtleMustCopyIfIntegral(key_values(i)));
+      const K key = SubtleMustCopyIfIntegral(key_values(i));
+      auto& shard = table_.GetShard(key);
+      mutex_lock l(shard.mu);
+      shard.map.erase(key);
     }
     return OkStatus();
   }
@@ -309,8 +431,9 @@ class MutableHashTableOfTensors final : public LookupInterface {
   }
 
   Status ExportValues(OpKernelContext* ctx) override {
-    tf_shared_lock l(mu_);
-    int64_t size = table_.size();
+    table_.LockAllShared();
+    auto unlock = gtl::MakeCleanup([this] { table_.UnlockAllShared(); });
+    int64_t size = table_.SizeLocked();
     int64_t value_dim = value_shape_.dim_size(0);
 
     Tensor* keys;
@@ -332,22 +455,13 @@ class MutableHashTableOfTensors final : public LookupInterface {
   TensorShape value_shape() const override { return value_shape_; }
 
   int64_t MemoryUsed() const override {
-    int64_t ret = 0;
-    tf_shared_lock l(mu_);
-    for (unsigned i = 0; i < table_.bucket_count(); ++i) {
-      size_t bucket_size = table_.bucket_size(i);
-      if (bucket_size == 0) {
-        ret++;
-      } else {
-        ret += bucket_size;
-      }
-    }
-    return sizeof(MutableHashTableOfTensors) + ret;
+    return sizeof(MutableHashTableOfTensors) + table_.capacity();
   }
 
   Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override {
-    tf_shared_lock l(mu_);
-    int64_t size = table_.size();
+    table_.LockAllShared();
+    auto unlock = gtl::MakeCleanup([this] { table_.UnlockAllShared(); });
+    int64_t size = table_.SizeLocked();
     Tensor keys(key_dtype(), TensorShape({size}));
     Tensor values(value_dtype(), TensorShape({size, value_shape_.dim_size(0)}));
     ExportKeysAndValues(&keys, &values);
@@ -384,28 +498,28 @@ class MutableHashTableOfTensors final : public LookupInterface {
   }
 
  private:
+  typedef gtl::InlinedVector<V, 4> ValueArray;
+  using Table = ShardedHashMap<K, ValueArray>;
+
   // Writes all keys and values into `keys` and `values`. `keys` and `values`
-  // must point to tensors of size `table_.size()`.
-  void ExportKeysAndValues(Tensor* keys, Tensor* values) const
-      TF_SHARED_LOCKS_REQUIRED(mu_) {
+  // must point to tensors of size `table_.SizeLocked()`, and all of the shards
+  // of `table_` must be locked.
+  void ExportKeysAndValues(Tensor* keys, Tensor* values) const {
     int64_t value_dim = value_shape_.dim_size(0);
     auto keys_data = keys->flat<K>();
     auto values_data = values->matrix<V>();
     int64_t i = 0;
-    for (auto it = table_.begin(); it != table_.end(); ++it, ++i) {
-      K key = it->first;
-      ValueArray value = it->second;
+    table_.ForEachLocked([&](const K& key, const ValueArray& value) {
       keys_data(i) = key;
       for (int64_t j = 0; j < value_dim; j++) {
         values_data(i, j) = value[j];
       }
-    }
+      ++i;
+    });
   }
 
   TensorShape value_shape_;
-  mutable mutex mu_;
-  typedef gtl::InlinedVector<V, 4> ValueArray;
-  std::unordered_map<K, ValueArray> table_ TF_GUARDED_BY(mu_);
+  Table table_;
 };
 
 namespace {
@@ -513,54 +627,35 @@ class MutableDenseHashTable final : public LookupInterface {
     const auto default_flat = default_value.flat<V>();
 
     tf_shared_lock l(mu_);
-    const auto key_buckets_matrix = key_buckets_.template matrix<K>();
-    const auto value_buckets_matrix = value_buckets_.template matrix<V>();
-    const auto empty_key_matrix =
-        empty_key_.template shaped<K, 2>({1, key_size});
-    const auto deleted_key_matrix =
-        deleted_key_.template shaped<K, 2>({1, key_size});
-    const int64_t bit_mask = num_buckets_ - 1;
-    // TODO(andreasst): parallelize using work_sharder
-    for (int64_t i = 0; i < num_elements; ++i) {
-      const uint64 key_hash = HashKey(key_matrix, i);
-      if (empty_key_hash_ == key_hash &&
-          IsEqualKey(empty_key_matrix, 0, key_matrix, i)) {
-        return errors::InvalidArgument(
-            "Using the empty_key as a table key is not allowed");
-      }
-      if (deleted_key_hash_ == key_hash &&
-          IsEqualKey(deleted_key_matrix, 0, key_matrix, i)) {
-        return errors::InvalidArgument(
-            "Using the deleted_key as a table key is not allowed");
-      }
-      int64_t bucket_index = key_hash & bit_mask;
-      int64_t num_probes = 0;
-      while (true) {
-        if (IsEqualKey(key_buckets_matrix, bucket_index, key_matrix, i)) {
-          for (int64_t j = 0; j < value_size; ++j) {
-            // TODO(andreasst): check if we can get rid of SubtleMustCopy
-            // here and elsewhere in this file.
-            value_matrix(i, j) =
-                SubtleMustCopyIfIntegral(value_buckets_matrix(bucket_index, j));
-          }
-          break;
-        }
-        if (IsEqualKey(key_buckets_matrix, bucket_index, empty_key_matrix, 0)) {
-          for (int64_t j = 0; j < value_size; ++j) {
-            value_matrix(i, j) = SubtleMustCopyIfIntegral(default_flat(j));
-          }
-          break;
-        }
-        ++num_probes;
-        bucket_index =
-            (bucket_index + num_probes) & bit_mask;  // quadratic probing
-        if (num_probes >= num_buckets_) {
-          return errors::Internal(
-              "Internal error in MutableDenseHashTable lookup");
-        }
-      }
+    const Tensor& key_buckets = key_buckets_;
+    const Tensor& value_buckets = value_buckets_;
+    const int64_t num_buckets = num_buckets_;
+    auto find_range = [&](int64_t begin, int64_t end) {
+      return FindRange(key_buckets, value_buckets, num_buckets, key_matrix,
+                       default_flat, begin, end, &value_matrix);
+    };
+    auto* worker_threads =
+        ctx != nullptr && ctx->device() != nullptr
+            ? ctx->device()->tensorflow_cpu_worker_threads()
+            : nullptr;
+    if (worker_threads == nullptr ||
+        num_elements < kMinBatchSizePerShard * 2) {
+      return find_range(0, num_elements);
     }
-    return OkStatus();
+    // Large batches are split over the intra-op threads. The lookups are
+    // bound by memory latency, so the cost is mostly the cache misses.
+    mutex status_mu;
+    Status status;
+    const int64_t cost_per_key = 1000 + 10 * (key_size + value_size);
+    Shard(worker_threads->num_threads, worker_threads->workers, num_elements,
+          cost_per_key, [&](int64_t begin, int64_t end) {
+            Status s = find_range(begin, end);
+            if (!s.ok()) {
+              mutex_lock l(status_mu);
+              status.Update(s);
+            }
+          });
+    return status;
   }
 
   Status Insert(OpKernelContext* ctx, const Tensor& key,
@@ -743,6 +838,85 @@ class MutableDenseHashTable final : public LookupInterface {
     return OkStatus();
   }
 
+  // Looks up the keys in rows [begin, end) of `key_matrix` and writes their
+  // values, or the default value, to the same rows of `value_matrix`. The
+  // keys are processed in groups of kFindPrefetchGroupSize: the home buckets
+  // of a whole group are hashed and prefetched before any of them is probed,
+  // so that the cache misses of the group overlap instead of being taken one
+  // key at a time.
+  Status FindRange(const Tensor& key_buckets, const Tensor& value_buckets,
+                   int64_t num_buckets,
+                   typename TTypes<K>::ConstMatrix key_matrix,
+                   typename TTypes<V>::ConstFlat default_flat, int64_t begin,
+                   int64_t end,
+                   typename TTypes<V>::Matrix* value_matrix) const {
+    const auto key_buckets_matrix = key_buckets.template matrix<K>();
+    const auto value_buckets_matrix = value_buckets.template matrix<V>();
+    const int64_t key_size = key_shape_.num_elements();
+    const int64_t value_size = value_shape_.num_elements();
+    const auto empty_key_matrix =
+        empty_key_.template shaped<K, 2>({1, key_size});
+    const auto deleted_key_matrix =
+        deleted_key_.template shaped<K, 2>({1, key_size});
+    const int64_t bit_mask = num_buckets - 1;
+    int64_t home_buckets[kFindPrefetchGroupSize];
+    for (int64_t group_begin = begin; group_begin < end;
+         group_begin += kFindPrefetchGroupSize) {
+      const int64_t group_end =
+          std::min(group_begin + kFindPrefetchGroupSize, end);
+      for (int64_t i = group_begin; i < group_end; ++i) {
+        const uint64 key_hash = HashKey(key_matrix, i);
+        if (empty_key_hash_ == key_hash &&
+            IsEqualKey(empty_key_matrix, 0, key_matrix, i)) {
+          return errors::InvalidArgument(
+              "Using the empty_key as a table key is not allowed");
+        }
+        if (deleted_key_hash_ == key_hash &&
+            IsEqualKey(deleted_key_matrix, 0, key_matrix, i)) {
+          return errors::InvalidArgument(
+              "Using the deleted_key as a table key is not allowed");
+        }
+        const int64_t bucket_index = key_hash & bit_mask;
+        home_buckets[i - group_begin] = bucket_index;
+        port::prefetch<port::PREFETCH_HINT_T0>(
+            &key_buckets_matrix(bucket_index, 0));
+        port::prefetch<port::PREFETCH_HINT_T0>(
+            &value_buckets_matrix(bucket_index, 0));
+      }
+      for (int64_t i = group_begin; i < group_end; ++i) {
+        int64_t bucket_index = home_buckets[i - group_begin];
+        int64_t num_probes = 0;
+        while (true) {
+          if (IsEqualKey(key_buckets_matrix, bucket_index, key_matrix, i)) {
+            for (int64_t j = 0; j < value_size; ++j) {
+              // TODO(andreasst): check if we can get rid of SubtleMustCopy
+              // here and elsewhere in this file.
+              (*value_matrix)(i, j) = SubtleMustCopyIfIntegral(
+                  value_buckets_matrix(bucket_index, j));
+            }
+            break;
+          }
+          if (IsEqualKey(key_buckets_matrix, bucket_index, empty_key_matrix,
+                         0)) {
+            for (int64_t j = 0; j < value_size; ++j) {
+              (*value_matrix)(i, j) =
+                  SubtleMustCopyIfIntegral(default_flat(j));
+            }
+            break;
+          }
+          ++num_probes;
+          bucket_index =
+              (bucket_index + num_probes) & bit_mask;  // quadratic probing
+          if (num_probes >= num_buckets) {
+            return errors::Internal(
+                "Internal error in MutableDenseHashTable lookup");
+          }
+        }
+      }
+    }
+    return OkStatus();
+  }
+
   Status DoRemove(OpKernelContext* ctx, const Tensor& key)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
     const int64_t num_elements = key.dim_size(0);
@@ -853,9 +1027,9 @@ class MutableDenseHashTable final : public LookupInterface {
 
   // Use a template to allow this function to be used both with Matrix and
   // ConstMatrix types.
-  template <typename MT2>
-  bool IsEqualKey(typename TTypes<K>::Matrix tensor1, int64_t index1,
-                  MT2 tensor2, int64_t index2) const {
+  template <typename MT1, typename MT2>
+  bool IsEqualKey(MT1 tensor1, int64_t index1, MT2 tensor2,
+                  int64_t index2) const {
     for (int64_t i = 0; i < key_shape_.num_elements(); ++i) {
       if (tensor1(index1, i) != tensor2(index2, i)) {
         return false;
@@ -864,6 +1038,12 @@ class MutableDenseHashTable final : public LookupInterface {
     return true;
   }
 
+  // The number of keys whose home buckets are prefetched together by Find.
+  static constexpr int64_t kFindPrefetchGroupSize = 16;
+  // Find only uses the intra-op threads for batches of at least twice this
+  // many keys.
+  static constexpr int64_t kMinBatchSizePerShard = 16384;
+
   TensorShape key_shape_;
   TensorShape value_shape_;
   float max_load_factor_;
@@ -323,8 +323,17 @@ class HashTable : public InitializableLookupTable {
     const V default_val = default_value.flat<V>()(0);
     const auto key_values = key.flat<K>();
     auto value_values = value->flat<V>();
-
-    for (int64_t i = 0; i < key_values.size(); ++i) {
+    const int64_t num_keys = key_values.size();
+
+    // Lookups into a table that doesn't fit in the cache are bound by cache
+    // misses. The table doesn't change once initialized, so the slots of the
+    // keys a few lookups ahead are prefetched for their misses to overlap.
+    const bool prefetch = table_.size() * sizeof(std::pair<K, V>) >=
+                          kMinPrefetchTableBytes;
+    for (int64_t i = 0; i < num_keys; ++i) {
+      if (prefetch && i + kPrefetchDistance < num_keys) {
+        table_.prefetch(key_values(i + kPrefetchDistance));
+      }
       value_values(i) = gtl::FindWithDefault(
           table_, SubtleMustCopyIfIntegral(key_values(i)), default_val);
     }
@@ -340,6 +349,10 @@ class HashTable : public InitializableLookupTable {
   }
 
  private:
+  // Tables smaller than this are assumed to stay in the cache.
+  static constexpr size_t kMinPrefetchTableBytes = 1 << 20;
+  static constexpr int64_t kPrefetchDistance = 8;
+
   absl::flat_hash_map<K, V> table_;
 };
 
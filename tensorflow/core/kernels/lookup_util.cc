@@ -22,8 +22,12 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/graph/graph_def_builder.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace lookup {
@@ -56,6 +60,61 @@ Status GetNumLinesInTextFile(Env* env, const string& vocab_file,
   return OkStatus();
 }
 
+// Sets element `position` of `tensor` from the line `line_number` (zero-based)
+// of a text file, or from its `tokens` split by delimiter, based on 'index'.
+// The value is transformed to the data type of `tensor`.
+Status SetTextFileValue(const string& line, const std::vector<string>& tokens,
+                        int64_t index, int64_t line_number, int64_t offset,
+                        int64_t position, Tensor* tensor) {
+  if (index == kLineNumber) {
+    tensor->flat<int64_t>()(position) = line_number + offset;
+    return OkStatus();
+  }
+  const string& token = (index == kWholeLine) ? line : tokens[index];
+  const DataType& dtype = tensor->dtype();
+  switch (dtype) {
+    case DT_INT32: {
+      int32_t value;
+      if (!strings::safe_strto32(token.c_str(), &value)) {
+        return errors::InvalidArgument("Field ", token, " in line ",
+                                       line_number, " is not a valid int32.");
+      }
+      tensor->flat<int32>()(position) = value + offset;
+    } break;
+    case DT_INT64: {
+      int64_t value;
+      if (!strings::safe_strto64(token.c_str(), &value)) {
+        return errors::InvalidArgument("Field ", token, " in line ",
+                                       line_number, " is not a valid int64.");
+      }
+      tensor->flat<int64_t>()(position) = value;
+    } break;
+    case DT_FLOAT: {
+      float value;
+      if (!strings::safe_strtof(token.c_str(), &value)) {
+        return errors::InvalidArgument("Field ", token, " in line ",
+                                       line_number, " is not a valid float.");
+      }
+      tensor->flat<float>()(position) = value;
+    } break;
+    case DT_DOUBLE: {
+      double value;
+      if (!strings::safe_strtod(token.c_str(), &value)) {
+        return errors::InvalidArgument("Field ", token, " in line ",
+                                       line_number, " is not a valid double.");
+      }
+      tensor->flat<double>()(position) = value;
+    } break;
+    case DT_STRING:
+      tensor->flat<tstring>()(position) = token;
+      break;
+    default:
+      return errors::InvalidArgument("Data type ", DataTypeString(dtype),
+                                     " not supported.");
+  }
+  return OkStatus();
+}
+
 // Iterator that reads a text file. Each iteration process one line, it parses
 // the line and populates the keys and values tensors used for initialization
 // with a single key and corresponding value.
@@ -207,58 +266,8 @@ class TextFileLineIterator
   // tensor 't'. The value is transformed to the given data type 'dtype'.
   Status SetValue(const string& line, const std::vector<string>& tokens,
                   int64_t index, Tensor* tensor) {
-    if (index == kLineNumber) {
-      tensor->flat<int64_t>()(0) = next_id_ + offset_;
-      return OkStatus();
-    }
-    const string& token = (index == kWholeLine) ? line : tokens[index];
-    const DataType& dtype = tensor->dtype();
-    switch (dtype) {
-      case DT_INT32: {
-        int32_t value;
-        if (!strings::safe_strto32(token.c_str(), &value)) {
-          valid_ = false;
-          return errors::InvalidArgument("Field ", token, " in line ", next_id_,
-                                         " is not a valid int32.");
-        }
-        tensor->flat<int32>()(0) = value + offset_;
-      } break;
-      case DT_INT64: {
-        int64_t value;
-        if (!strings::safe_strto64(token.c_str(), &value)) {
-          valid_ = false;
-          return errors::InvalidArgument("Field ", token, " in line ", next_id_,
-                                         " is not a valid int64.");
-        }
-        tensor->flat<int64_t>()(0) = value;
-      } break;
-      case DT_FLOAT: {
-        float value;
-        if (!strings::safe_strtof(token.c_str(), &value)) {
-          valid_ = false;
-          return errors::InvalidArgument("Field ", token, " in line ", next_id_,
-                                         " is not a valid float.");
-        }
-        tensor->flat<float>()(0) = value;
-      } break;
-      case DT_DOUBLE: {
-        double value;
-        if (!strings::safe_strtod(token.c_str(), &value)) {
-          valid_ = false;
-          return errors::InvalidArgument("Field ", token, " in line ", next_id_,
-                                         " is not a valid double.");
-        }
-        tensor->flat<double>()(0) = value;
-      } break;
-      case DT_STRING:
-        tensor->flat<tstring>()(0) = token;
-        break;
-      default:
-        valid_ = false;
-        return errors::InvalidArgument("Data type ", DataTypeString(dtype),
-                                       " not supported.");
-    }
-    return OkStatus();
+    return SetTextFileValue(line, tokens, index, next_id_, offset_,
+                            /*position=*/0, tensor);
   }
 
   TF_DISALLOW_COPY_AND_ASSIGN(TextFileLineIterator);
@@ -284,6 +293,176 @@ Status GetTableHandle(StringPiece input_name, OpKernelContext* ctx,
   return OkStatus();
 }
 
+// Text files of at least this size are parsed by several threads.
+constexpr int64_t kParallelInitMinFileSize = 16 << 20;  // 16MB
+
+// The minimum number of bytes of a text file parsed by each thread.
+constexpr int64_t kParallelInitMinChunkSize = 4 << 20;  // 4MB
+
+// The maximum number of threads parsing a text file. Set
+// TF_LOOKUP_TABLE_INIT_THREADS=1 to always parse text files sequentially.
+int64_t GetNumParallelInitThreads() {
+  static const int64_t num_threads = []() {
+    int64_t num_threads;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_LOOKUP_TABLE_INIT_THREADS",
+                                    std::min(port::MaxParallelism(), 16),
+                                    &num_threads));
+    return num_threads;
+  }();
+  return num_threads;
+}
+
+// A byte range [start, limit) of a text file. It owns the lines starting in
+// the range.
+struct TextFileChunk {
+  int64_t start;
+  int64_t limit;
+  int64_t num_lines = 0;
+  // Zero-based line number of the first line of the chunk.
+  int64_t first_line = 0;
+};
+
+// Calls `fn` on every line owned by `chunk`, in order. Stops early, returning
+// OK, if `fn` returns OutOfRange.
+template <typename F>
+Status ForEachLineInChunk(Env* env, const string& filename,
+                          const TextFileChunk& chunk, F fn) {
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+  io::InputBuffer input_buffer(file.get(), kInputBufferSize);
+  string line;
+  if (chunk.start > 0) {
+    // Skip the rest of the line owned by the previous chunk.
+    TF_RETURN_IF_ERROR(input_buffer.Seek(chunk.start - 1));
+    TF_RETURN_IF_ERROR(input_buffer.ReadLine(&line));
+  }
+  while (input_buffer.Tell() < chunk.limit) {
+    Status s = input_buffer.ReadLine(&line);
+    if (errors::IsOutOfRange(s)) break;
+    TF_RETURN_IF_ERROR(s);
+    s = fn(line);
+    if (errors::IsOutOfRange(s)) break;
+    TF_RETURN_IF_ERROR(s);
+  }
+  return OkStatus();
+}
+
+// Initializes `table` from a large text file by parsing chunks of it on
+// several threads, and then inserting all the entries in one batch into the
+// table pre-sized for them.
+//
+// Returns false, leaving `serializer` untouched, if the file should be read
+// by TextFileLineIterator instead, e.g. because it is small or malformed, so
+// that errors are reported exactly as they are when reading sequentially.
+// Otherwise sets `status` to the result of the initialization.
+bool InitializeTableFromTextFileInParallel(
+    const string& filename, int64_t vocab_size, char delimiter,
+    int32_t key_index, int32_t value_index, int64_t offset, Env* env,
+    std::unique_ptr<InitializerSerializer>* serializer,
+    InitializableLookupTable* table, Status* status) {
+  const int64_t num_threads = GetNumParallelInitThreads();
+  // Re-initialization only checks the entries, which is cheap sequentially.
+  if (num_threads <= 1 || vocab_size == 0 || table->is_initialized()) {
+    return false;
+  }
+  uint64 file_size;
+  if (!env->GetFileSize(filename, &file_size).ok() ||
+      file_size < kParallelInitMinFileSize) {
+    return false;
+  }
+  const int64_t num_chunks = std::min<int64_t>(
+      num_threads, static_cast<int64_t>(file_size) / kParallelInitMinChunkSize);
+  if (num_chunks <= 1) return false;
+
+  std::vector<TextFileChunk> chunks(num_chunks);
+  for (int64_t i = 0; i < num_chunks; ++i) {
+    chunks[i].start = file_size * i / num_chunks;
+    chunks[i].limit = file_size * (i + 1) / num_chunks;
+  }
+
+  thread::ThreadPool pool(env, "init_table_from_text_file", num_chunks);
+  auto run_on_chunks = [&](const std::function<Status(int64_t)>& fn) {
+    std::vector<Status> statuses(num_chunks);
+    BlockingCounter counter(num_chunks);
+    for (int64_t i = 0; i < num_chunks; ++i) {
+      pool.Schedule([&, i]() {
+        statuses[i] = fn(i);
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+    for (const Status& s : statuses) {
+      if (!s.ok()) return false;
+    }
+    return true;
+  };
+
+  // Count the lines of each chunk, so that the entries can be parsed directly
+  // into their position in the key and value tensors.
+  if (!run_on_chunks([&](int64_t i) {
+        return ForEachLineInChunk(env, filename, chunks[i],
+                                  [&chunk = chunks[i]](const string& line) {
+                                    ++chunk.num_lines;
+                                    return OkStatus();
+                                  });
+      })) {
+    return false;
+  }
+  int64_t num_lines = 0;
+  for (TextFileChunk& chunk : chunks) {
+    chunk.first_line = num_lines;
+    num_lines += chunk.num_lines;
+  }
+  if (vocab_size != -1 && num_lines < vocab_size) return false;
+  const int64_t num_entries = vocab_size == -1 ? num_lines : vocab_size;
+  if (num_entries < num_lines) {
+    LOG(WARNING) << "Truncated " << filename << " before its end at "
+                 << vocab_size << " records.";
+  }
+
+  Tensor keys(table->key_dtype(), TensorShape({num_entries}));
+  Tensor values(table->value_dtype(), TensorShape({num_entries}));
+  const bool ignore_split = std::max(key_index, value_index) < 0;
+  const auto expected_size =
+      static_cast<size_t>(std::max(key_index, value_index) + 1);
+  if (!run_on_chunks([&](int64_t i) {
+        const int64_t end_line = std::min(
+            chunks[i].first_line + chunks[i].num_lines, num_entries);
+        int64_t line_number = chunks[i].first_line;
+        if (line_number >= end_line) return OkStatus();
+        return ForEachLineInChunk(
+            env, filename, chunks[i], [&](const string& line) -> Status {
+              if (line_number >= end_line) {
+                return errors::OutOfRange("Finished reading the chunk.");
+              }
+              if (line.empty()) {
+                return errors::InvalidArgument("Empty line.");
+              }
+              std::vector<string> tokens;
+              if (!ignore_split) {
+                tokens = str_util::Split(line, delimiter);
+                if (tokens.size() < expected_size) {
+                  return errors::InvalidArgument("Invalid number of columns.");
+                }
+              }
+              TF_RETURN_IF_ERROR(SetTextFileValue(line, tokens, key_index,
+                                                  line_number, offset,
+                                                  line_number, &keys));
+              TF_RETURN_IF_ERROR(SetTextFileValue(line, tokens, value_index,
+                                                  line_number, offset,
+                                                  line_number, &values));
+              ++line_number;
+              return OkStatus();
+            });
+      })) {
+    return false;
+  }
+
+  KeyValueTensorIterator iter(&keys, &values);
+  *status = table->Initialize(iter, std::move(*serializer));
+  return true;
+}
+
 }  // namespace
 
 Status GetResourceLookupTable(StringPiece input_name, OpKernelContext* ctx,
@@ -399,15 +578,20 @@ Status InitializeTableFromTextFile(
         DataTypeString(table->value_dtype()));
   }
 
-  TextFileLineIterator iter;
-  TF_RETURN_IF_ERROR(iter.Init(filename, vocab_size, delimiter, key_dtype,
-                               key_index, value_dtype, value_index, offset,
-                               env));
+  Status s;
+  if (!InitializeTableFromTextFileInParallel(
+          filename, vocab_size, delimiter, key_index, value_index, offset, env,
+          &serializer, table, &s)) {
+    TextFileLineIterator iter;
+    TF_RETURN_IF_ERROR(iter.Init(filename, vocab_size, delimiter, key_dtype,
+                                 key_index, value_dtype, value_index, offset,
+                                 env));
+    s = table->Initialize(iter, std::move(serializer));
+  }
   // For initialization from files, ignore if the table is already
   // initialized. The table shared name should contain the filename to
   // avoid trying to initialize the same table from the same file at the same
   // time.
-  Status s = table->Initialize(iter, std::move(serializer));
   if (errors::IsFailedPrecondition(s) && table->is_initialized()) {
     LOG(INFO) << "Table trying to initialize from file " << filename
               << " is already initialized.";
@@ -102,12 +102,13 @@ Status DoBlasLtMatmul(se::Stream* stream,
       return blas_lt->DoMatmul(stream, plan, se::HostOrDeviceScalar<float>(1.0),
                                b, a, se::HostOrDeviceScalar<float>(0.0), c, c,
                                algorithm, scratch_allocator, bias,
-                               profile_result);
+                               /*aux=*/{}, profile_result);
     }
   }
   return blas_lt->DoMatmul(stream, plan, se::HostOrDeviceScalar<T>(T(1.0)), b,
                            a, se::HostOrDeviceScalar<T>(T(0.0)), c, c,
-                           algorithm, scratch_allocator, bias, profile_result);
+                           algorithm, scratch_allocator, bias, /*aux=*/{},
+                           profile_result);
 }
 
 }  // namespace tensorflow
@@ -0,0 +1,118 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#define EIGEN_USE_THREADS
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/cwise_ops.h"
+#include "tensorflow/core/platform/errors.h"
+
+namespace tensorflow {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+
+// Computes a binary op over several pairs of tensors in one kernel, which
+// saves the dispatch of one kernel per pair when the tensors are small. The
+// horizontal fusion optimizer creates this op from independent nodes of the
+// same binary op.
+template <typename T>
+class MultiTensorBinaryOp : public OpKernel {
+ public:
+  explicit MultiTensorBinaryOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    string binary_op;
+    OP_REQUIRES_OK(context, context->GetAttr("binary_op", &binary_op));
+    if (binary_op == "AddV2") {
+      compute_fn_ = &ComputeBinary<functor::add<T>>;
+    } else if (binary_op == "Sub") {
+      compute_fn_ = &ComputeBinary<functor::sub<T>>;
+    } else if (binary_op == "Mul") {
+      compute_fn_ = &ComputeBinary<functor::mul<T>>;
+    } else if (binary_op == "RealDiv") {
+      compute_fn_ = &ComputeBinary<functor::div<T>>;
+    } else if (binary_op == "Maximum") {
+      compute_fn_ = &ComputeBinary<functor::maximum<T>>;
+    } else if (binary_op == "Minimum") {
+      compute_fn_ = &ComputeBinary<functor::minimum<T>>;
+    } else {
+      context->CtxFailure(
+          errors::InvalidArgument("Unsupported binary op: ", binary_op));
+    }
+  }
+
+  void Compute(OpKernelContext* context) override {
+    OpInputList x;
+    OpInputList y;
+    OP_REQUIRES_OK(context, context->input_list("x", &x));
+    OP_REQUIRES_OK(context, context->input_list("y", &y));
+    OpOutputList z;
+    OP_REQUIRES_OK(context, context->output_list("z", &z));
+    const CPUDevice& device = context->eigen_device<CPUDevice>();
+    for (int i = 0; i < x.size(); ++i) {
+      const TensorShape& x_shape = x[i].shape();
+      const TensorShape& y_shape = y[i].shape();
+      OP_REQUIRES(context,
+                  x_shape == y_shape || x_shape.dims() == 0 ||
+                      y_shape.dims() == 0,
+                  errors::InvalidArgument(
+                      "Inputs ", i, " must have the same shape, or one of "
+                      "them must be a scalar, got shapes ",
+                      x_shape.DebugString(), " and ", y_shape.DebugString()));
+      Tensor* output = nullptr;
+      OP_REQUIRES_OK(context,
+                     z.allocate(i, x_shape.dims() == 0 ? y_shape : x_shape,
+                                &output));
+      compute_fn_(device, x[i], y[i], output);
+    }
+  }
+
+ private:
+  template <typename Functor>
+  static void ComputeBinary(const CPUDevice& device, const Tensor& x,
+                      const Tensor& y, Tensor* z) {
+    typename Functor::func func;
+    auto out = z->flat<T>();
+    if (x.shape() == y.shape()) {
+      out.device(device) = x.flat<T>().binaryExpr(y.flat<T>(), func);
+    } else if (y.dims() == 0) {
+      auto in = x.flat<T>();
+      out.device(device) = in.binaryExpr(in.constant(y.scalar<T>()()), func);
+    } else {
+      auto in = y.flat<T>();
+      out.device(device) = in.constant(x.scalar<T>()()).binaryExpr(in, func);
+    }
+  }
+
+  void (*compute_fn_)(const CPUDevice& device, const Tensor& x,
+                      const Tensor& y, Tensor* z) = nullptr;
+};
+
+#define REGISTER_CPU(T)                                        \
+  REGISTER_KERNEL_BUILDER(Name("_MultiTensorBinaryOp")         \
+                              .Device(DEVICE_CPU)              \
+                              .TypeConstraint<T>("T"),         \
+                          MultiTensorBinaryOp<T>);
+
+TF_CALL_half(REGISTER_CPU);
+TF_CALL_bfloat16(REGISTER_CPU);
+TF_CALL_float(REGISTER_CPU);
+TF_CALL_double(REGISTER_CPU);
+
+#undef REGISTER_CPU
+
+}  // namespace tensorflow
@@ -0,0 +1,81 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class MultiTensorBinaryOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(const string& binary_op, int num_tensors) {
+    TF_ASSERT_OK(NodeDefBuilder("multi", "_MultiTensorBinaryOp")
+                     .Input(FakeInput(num_tensors, DT_FLOAT))
+                     .Input(FakeInput(num_tensors, DT_FLOAT))
+                     .Attr("binary_op", binary_op)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(MultiTensorBinaryOpTest, Mul) {
+  MakeOp("Mul", 3);
+  AddInputFromArray<float>(TensorShape({2}), {1, 2});
+  AddInputFromArray<float>(TensorShape({}), {2});
+  AddInputFromArray<float>(TensorShape({2, 2}), {1, 2, 3, 4});
+  AddInputFromArray<float>(TensorShape({2}), {3, 4});
+  AddInputFromArray<float>(TensorShape({2}), {3, 4});
+  AddInputFromArray<float>(TensorShape({2, 2}), {5, 6, 7, 8});
+  TF_ASSERT_OK(RunOpKernel());
+
+  test::ExpectTensorEqual<float>(
+      *GetOutput(0), test::AsTensor<float>({3, 8}, TensorShape({2})));
+  test::ExpectTensorEqual<float>(
+      *GetOutput(1), test::AsTensor<float>({6, 8}, TensorShape({2})));
+  test::ExpectTensorEqual<float>(
+      *GetOutput(2),
+      test::AsTensor<float>({5, 12, 21, 32}, TensorShape({2, 2})));
+}
+
+TEST_F(MultiTensorBinaryOpTest, SubIsNotCommutative) {
+  MakeOp("Sub", 2);
+  AddInputFromArray<float>(TensorShape({}), {10});
+  AddInputFromArray<float>(TensorShape({2}), {10, 20});
+  AddInputFromArray<float>(TensorShape({2}), {1, 2});
+  AddInputFromArray<float>(TensorShape({}), {5});
+  TF_ASSERT_OK(RunOpKernel());
+
+  test::ExpectTensorEqual<float>(
+      *GetOutput(0), test::AsTensor<float>({9, 8}, TensorShape({2})));
+  test::ExpectTensorEqual<float>(
+      *GetOutput(1), test::AsTensor<float>({5, 15}, TensorShape({2})));
+}
+
+TEST_F(MultiTensorBinaryOpTest, IncompatibleShapes) {
+  MakeOp("AddV2", 1);
+  AddInputFromArray<float>(TensorShape({2}), {1, 2});
+  AddInputFromArray<float>(TensorShape({3}), {1, 2, 3});
+  Status s = RunOpKernel();
+  EXPECT_TRUE(errors::IsInvalidArgument(s)) << s;
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,63 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/packed_strings.h"
+
+#include <cstring>
+
+namespace tensorflow {
+
+PackedStrings::PackedStrings(const tstring* strings, int64_t n) {
+  offsets_.resize(n + 1);
+  offsets_[0] = 0;
+  for (int64_t i = 0; i < n; ++i) {
+    offsets_[i + 1] = offsets_[i] + strings[i].size();
+  }
+  // Sizes the buffer once, so that each string is copied exactly once.
+  bytes_.resize(offsets_[n]);
+  for (int64_t i = 0; i < n; ++i) {
+    if (!strings[i].empty()) {
+      std::memcpy(&bytes_[offsets_[i]], strings[i].data(), strings[i].size());
+    }
+  }
+}
+
+PackedStrings PackedStrings::FromTensor(const Tensor& t) {
+  DCHECK_EQ(t.dtype(), DT_STRING);
+  auto flat = t.flat<tstring>();
+  return PackedStrings(flat.data(), flat.size());
+}
+
+void PackedStrings::Reserve(int64_t num_strings, int64_t num_bytes) {
+  offsets_.reserve(offsets_.size() + num_strings);
+  bytes_.reserve(bytes_.size() + num_bytes);
+}
+
+void PackedStrings::CopyTo(tstring* output) const {
+  for (int64_t i = 0; i < size(); ++i) {
+    const int64_t n = length(i);
+    output[i].resize_uninitialized(n);
+    if (n > 0) {
+      std::memcpy(output[i].mdata(), bytes_.data() + offsets_[i], n);
+    }
+  }
+}
+
+void PackedStrings::CopyTo(Tensor* t) const {
+  DCHECK_EQ(t->dtype(), DT_STRING);
+  DCHECK_EQ(t->NumElements(), size());
+  CopyTo(t->flat<tstring>().data());
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,94 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_KERNELS_PACKED_STRINGS_H_
+#define TENSORFLOW_CORE_KERNELS_PACKED_STRINGS_H_
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/stringpiece.h"
+#include "tensorflow/core/platform/tstring.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// A sequence of strings stored in columnar form: one contiguous buffer with
+// the bytes of all the strings, and the offset of each string in it.
+//
+// The elements of a DT_STRING tensor are separate tstrings, and those that do
+// not fit in the tstring itself each live in their own allocation. Kernels
+// that read every string several times, or that produce many strings, can
+// pack them once at the kernel boundary and then work on contiguous memory,
+// converting back to tstrings only when writing their outputs.
+class PackedStrings {
+ public:
+  PackedStrings() : offsets_({0}) {}
+
+  // Packs the `n` strings starting at `strings`.
+  PackedStrings(const tstring* strings, int64_t n);
+
+  // Packs the elements of the DT_STRING tensor `t`, in row-major order.
+  static PackedStrings FromTensor(const Tensor& t);
+
+  // Returns the number of strings.
+  int64_t size() const { return offsets_.size() - 1; }
+
+  // Returns the i-th string, which stays valid until the next call to Add or
+  // Reserve.
+  StringPiece operator[](int64_t i) const {
+    DCHECK_GE(i, 0);
+    DCHECK_LT(i, size());
+    return StringPiece(bytes_.data() + offsets_[i], length(i));
+  }
+
+  // Returns the length of the i-th string.
+  int64_t length(int64_t i) const { return offsets_[i + 1] - offsets_[i]; }
+
+  // Returns the total length of the strings [begin, end).
+  int64_t total_length(int64_t begin, int64_t end) const {
+    return offsets_[end] - offsets_[begin];
+  }
+
+  // Returns the contiguous bytes of the strings, and the size() + 1 offsets
+  // of the strings in them.
+  const std::string& bytes() const { return bytes_; }
+  const std::vector<int64_t>& offsets() const { return offsets_; }
+
+  // Reserves room for `num_strings` more strings of `num_bytes` bytes in all.
+  void Reserve(int64_t num_strings, int64_t num_bytes);
+
+  // Appends a string.
+  void Add(StringPiece s) {
+    bytes_.append(s.data(), s.size());
+    offsets_.push_back(bytes_.size());
+  }
+
+  // Copies the strings into `output[0, size())`.
+  void CopyTo(tstring* output) const;
+
+  // Copies the strings into the DT_STRING tensor `t`, which must have size()
+  // elements.
+  void CopyTo(Tensor* t) const;
+
+ private:
+  std::vector<int64_t> offsets_;
+  std::string bytes_;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_PACKED_STRINGS_H_
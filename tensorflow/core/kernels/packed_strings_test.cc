@@ -0,0 +1,55 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/packed_strings.h"
+
+#include <string>
+
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(PackedStringsTest, FromTensor) {
+  // The last string does not fit in a tstring and is stored out of line.
+  const std::string long_string(100, 'x');
+  Tensor t = test::AsTensor<tstring>({"a", "", "bcd", long_string}, {2, 2});
+  PackedStrings packed = PackedStrings::FromTensor(t);
+  ASSERT_EQ(4, packed.size());
+  EXPECT_EQ("a", packed[0]);
+  EXPECT_EQ("", packed[1]);
+  EXPECT_EQ("bcd", packed[2]);
+  EXPECT_EQ(long_string, packed[3]);
+  EXPECT_EQ(3, packed.length(2));
+  EXPECT_EQ(4, packed.total_length(0, 3));
+  EXPECT_EQ("abcd" + long_string, packed.bytes());
+  EXPECT_EQ(std::vector<int64_t>({0, 1, 1, 4, 104}), packed.offsets());
+}
+
+TEST(PackedStringsTest, AddAndCopyTo) {
+  PackedStrings packed;
+  EXPECT_EQ(0, packed.size());
+  packed.Reserve(3, 6);
+  packed.Add("foo");
+  packed.Add("");
+  packed.Add("bar");
+  Tensor t(DT_STRING, TensorShape({3}));
+  packed.CopyTo(&t);
+  test::ExpectTensorEqual<tstring>(test::AsTensor<tstring>({"foo", "", "bar"}),
+                                   t);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,206 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_RADIX_SORT_H_
+#define TENSORFLOW_CORE_KERNELS_RADIX_SORT_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "third_party/eigen3/Eigen/Core"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+namespace radix_sort_internal {
+
+template <int kBytes>
+struct UnsignedOfSize;
+template <>
+struct UnsignedOfSize<1> {
+  using Type = uint8_t;
+};
+template <>
+struct UnsignedOfSize<2> {
+  using Type = uint16_t;
+};
+template <>
+struct UnsignedOfSize<4> {
+  using Type = uint32_t;
+};
+template <>
+struct UnsignedOfSize<8> {
+  using Type = uint64_t;
+};
+
+// Maps a key to an unsigned integer with the same order, so that the keys
+// can be sorted one byte at a time. Floating point NaNs are mapped above all
+// other values, and -0 and +0 to the same value.
+template <typename K, typename Enable = void>
+struct RadixKey {
+  using Bits = typename UnsignedOfSize<sizeof(K)>::Type;
+  static constexpr Bits kSignBit = Bits{1} << (8 * sizeof(K) - 1);
+
+  static Bits ToBits(K key) {
+    if (Eigen::numext::isnan(key)) return std::numeric_limits<Bits>::max();
+    if (key == K(0)) return kSignBit;
+    const Bits bits = Eigen::numext::bit_cast<Bits>(key);
+    return (bits & kSignBit) ? static_cast<Bits>(~bits) : (bits | kSignBit);
+  }
+};
+
+template <typename K>
+struct RadixKey<K, typename std::enable_if<std::is_integral<K>::value>::type> {
+  using Bits = typename UnsignedOfSize<sizeof(K)>::Type;
+  static constexpr Bits kSignBit =
+      std::is_signed<K>::value ? Bits{1} << (8 * sizeof(K) - 1) : Bits{0};
+
+  static Bits ToBits(K key) { return static_cast<Bits>(key) ^ kSignBit; }
+};
+
+}  // namespace radix_sort_internal
+
+// Radix sorts are linear in the number of elements, and beat comparison sorts
+// once there are more than a few hundred of them.
+constexpr int64_t kMinRadixSortSize = 256;
+
+// Permutes `values[0, n)` so that their keys, where `keys[i]` is the key of
+// the value initially at `values[i]`, are in increasing order, or decreasing
+// order if `descending` is true. The sort is stable: values with equal keys
+// keep their relative order in both directions. `keys` is not modified.
+//
+// K may be any integral or floating point type, including Eigen::half and
+// bfloat16; NaNs are greater than all other keys, and -0 is equal to +0.
+// V must be trivially copyable, e.g. an index into another array.
+//
+// This is a least significant digit radix sort over the bytes of the keys,
+// which skips the bytes that are the same for all keys, e.g. the high bytes
+// of small indices. If `pool` is not null, large inputs are split in blocks
+// that are counted and scattered in parallel; the result does not depend on
+// the number of threads. Like Shard(), the caller blocks until all blocks are
+// done, so this should not be called from work that is running on `pool`.
+template <typename K, typename V>
+void RadixSortByKey(thread::ThreadPool* pool, int64_t n, const K* keys,
+                    V* values, bool descending = false) {
+  static_assert(std::is_trivially_copyable<V>::value,
+                "RadixSortByKey values must be trivially copyable");
+  using Traits = radix_sort_internal::RadixKey<K>;
+  using Bits = typename Traits::Bits;
+  constexpr int kRadixBits = 8;
+  constexpr int kRadix = 1 << kRadixBits;
+  constexpr int kNumPasses = sizeof(Bits);
+  // Each block counts and scatters at least this many elements.
+  constexpr int64_t kMinBlockSize = 1 << 16;
+  if (n <= 1) return;
+
+  int64_t num_blocks = 1;
+  if (pool != nullptr) {
+    num_blocks = std::max<int64_t>(
+        1, std::min<int64_t>(pool->NumThreads(), n / kMinBlockSize));
+  }
+  const auto block_begin = [n, num_blocks](int64_t b) {
+    return b * n / num_blocks;
+  };
+  const auto for_each_block = [pool, num_blocks](const auto& fn) {
+    if (num_blocks == 1) {
+      fn(0);
+      return;
+    }
+    pool->TransformRangeConcurrently(
+        1, num_blocks, [&fn](int64_t begin, int64_t end) {
+          for (int64_t b = begin; b < end; ++b) fn(b);
+        });
+  };
+
+  std::vector<Bits> bits(n);
+  std::vector<Bits> bits_buffer(n);
+  std::vector<V> values_buffer(n);
+  const Bits flip = descending ? std::numeric_limits<Bits>::max() : Bits{0};
+  // The histogram of every byte of the keys, which is used to skip the bytes
+  // that are the same for all keys.
+  std::vector<int64_t> block_totals(num_blocks * kNumPasses * kRadix, 0);
+  for_each_block([&](int64_t b) {
+    int64_t* totals = &block_totals[b * kNumPasses * kRadix];
+    for (int64_t i = block_begin(b); i < block_begin(b + 1); ++i) {
+      const Bits key = Traits::ToBits(keys[i]) ^ flip;
+      bits[i] = key;
+      for (int pass = 0; pass < kNumPasses; ++pass) {
+        const int digit = (key >> (pass * kRadixBits)) & (kRadix - 1);
+        ++totals[pass * kRadix + digit];
+      }
+    }
+  });
+
+  Bits* src_bits = bits.data();
+  Bits* dst_bits = bits_buffer.data();
+  V* src_values = values;
+  V* dst_values = values_buffer.data();
+  std::vector<int64_t> offsets(num_blocks * kRadix);
+  for (int pass = 0; pass < kNumPasses; ++pass) {
+    const int shift = pass * kRadixBits;
+    const Bits first_digit = (src_bits[0] >> shift) & (kRadix - 1);
+    int64_t first_digit_count = 0;
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      first_digit_count +=
+          block_totals[(b * kNumPasses + pass) * kRadix + first_digit];
+    }
+    if (first_digit_count == n) continue;
+
+    // The histogram of each block for this pass. The initial histograms can
+    // only be used for the first pass that is not skipped, since the blocks
+    // hold different elements after each pass.
+    for_each_block([&](int64_t b) {
+      int64_t* counts = &offsets[b * kRadix];
+      std::fill(counts, counts + kRadix, 0);
+      for (int64_t i = block_begin(b); i < block_begin(b + 1); ++i) {
+        ++counts[(src_bits[i] >> shift) & (kRadix - 1)];
+      }
+    });
+    // Block b writes its elements with digit d after the elements with
+    // smaller digits, and after those of the earlier blocks with digit d.
+    int64_t offset = 0;
+    for (int d = 0; d < kRadix; ++d) {
+      for (int64_t b = 0; b < num_blocks; ++b) {
+        const int64_t count = offsets[b * kRadix + d];
+        offsets[b * kRadix + d] = offset;
+        offset += count;
+      }
+    }
+    DCHECK_EQ(offset, n);
+    for_each_block([&](int64_t b) {
+      int64_t* block_offsets = &offsets[b * kRadix];
+      for (int64_t i = block_begin(b); i < block_begin(b + 1); ++i) {
+        const int64_t pos =
+            block_offsets[(src_bits[i] >> shift) & (kRadix - 1)]++;
+        dst_bits[pos] = src_bits[i];
+        dst_values[pos] = src_values[i];
+      }
+    });
+    std::swap(src_bits, dst_bits);
+    std::swap(src_values, dst_values);
+  }
+  if (src_values != values) {
+    std::memcpy(values, src_values, n * sizeof(V));
+  }
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_RADIX_SORT_H_
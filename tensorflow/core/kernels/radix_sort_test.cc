@@ -0,0 +1,116 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/radix_sort.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "tensorflow/core/framework/numeric_types.h"
+#include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/lib/random/simple_philox.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Returns the permutation of [0, keys.size()) that std::stable_sort gives.
+template <typename K>
+std::vector<int32> ExpectedOrder(const std::vector<K>& keys, bool descending) {
+  std::vector<int32> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int32 a, int32 b) {
+    return descending ? keys[b] < keys[a] : keys[a] < keys[b];
+  });
+  return order;
+}
+
+template <typename K>
+std::vector<int32> RadixOrder(thread::ThreadPool* pool,
+                              const std::vector<K>& keys, bool descending) {
+  std::vector<int32> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  RadixSortByKey(pool, keys.size(), keys.data(), order.data(), descending);
+  return order;
+}
+
+template <typename K>
+void TestRandomKeys(int64_t n, int64_t range) {
+  random::PhiloxRandom philox(301, 17);
+  random::SimplePhilox rnd(&philox);
+  std::vector<K> keys(n);
+  for (K& key : keys) {
+    key = static_cast<K>(static_cast<int64_t>(rnd.Uniform64(2 * range)) -
+                         (std::is_signed<K>::value ? range : 0));
+  }
+  thread::ThreadPool pool(Env::Default(), "radix_sort_test", 4);
+  for (bool descending : {false, true}) {
+    const std::vector<int32> expected = ExpectedOrder(keys, descending);
+    EXPECT_EQ(expected, RadixOrder<K>(nullptr, keys, descending));
+    EXPECT_EQ(expected, RadixOrder(&pool, keys, descending));
+  }
+}
+
+TEST(RadixSortTest, Empty) {
+  std::vector<int32> keys;
+  EXPECT_TRUE(RadixOrder<int32>(nullptr, keys, false).empty());
+}
+
+TEST(RadixSortTest, Integers) {
+  TestRandomKeys<int8>(1000, 100);
+  TestRandomKeys<uint8>(1000, 100);
+  TestRandomKeys<int16>(1000, 1000);
+  TestRandomKeys<int32>(1000, 1 << 20);
+  TestRandomKeys<uint32>(1000, 1 << 30);
+  TestRandomKeys<int64_t>(1000, int64_t{1} << 40);
+  TestRandomKeys<uint64>(1000, 10);
+}
+
+TEST(RadixSortTest, LargeParallel) {
+  TestRandomKeys<int32>(1 << 19, 1000);
+  TestRandomKeys<int64_t>(1 << 19, int64_t{1} << 50);
+  TestRandomKeys<float>(1 << 19, 1 << 20);
+}
+
+TEST(RadixSortTest, FloatingPoint) {
+  TestRandomKeys<float>(1000, 1000);
+  TestRandomKeys<double>(1000, 1 << 20);
+  TestRandomKeys<Eigen::half>(1000, 1000);
+  TestRandomKeys<bfloat16>(1000, 1000);
+
+  const float inf = std::numeric_limits<float>::infinity();
+  const std::vector<float> keys = {1.5f, -inf, 0.0f,   -2.25f,
+                                   inf,  -0.0f, 1e-40f, -1e-40f};
+  for (bool descending : {false, true}) {
+    EXPECT_EQ(ExpectedOrder(keys, descending),
+              RadixOrder<float>(nullptr, keys, descending));
+  }
+}
+
+TEST(RadixSortTest, NaNIsGreatest) {
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const std::vector<float> keys = {1.0f, -nan, 3.0f, nan, -1.0f};
+  EXPECT_EQ(std::vector<int32>({4, 0, 2, 1, 3}),
+            RadixOrder<float>(nullptr, keys, false));
+  EXPECT_EQ(std::vector<int32>({1, 3, 2, 0, 4}),
+            RadixOrder<float>(nullptr, keys, true));
+}
+
+}  // namespace
+}  // namespace tensorflow
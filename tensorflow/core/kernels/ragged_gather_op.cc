@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 #include <limits>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -22,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -30,23 +32,41 @@ namespace {
 // For each slice in `(start, limit)` in `value_slices`, append
 // `params_dense_values_in[start:limit] to `values_out`.  `value_size` indicates
 // the number of scalars contained in each value params_dense_values_in[i].
+//
+// Each slice is a contiguous block of `(limit - start) * value_size` scalars
+// in both tensors, so the slices are copied block by block, sharded over the
+// intra-op threads.
 template <typename VALUE_TYPE, typename SPLITS_TYPE>
 void WriteValueSlices(
     const Tensor& params_dense_values_in,
     const std::vector<std::pair<SPLITS_TYPE, SPLITS_TYPE>>& value_slices,
-    SPLITS_TYPE value_size, Tensor* values_out) {
-  const auto& params_dense_values =
-      params_dense_values_in.flat_outer_dims<VALUE_TYPE, 2>();
-  auto values = values_out->flat_outer_dims<VALUE_TYPE, 2>();
-  int out_pos = 0;
-  for (const auto& slice : value_slices) {
-    for (int i = slice.first; i < slice.second; ++i) {
-      for (int j = 0; j < value_size; ++j) {
-        values(out_pos, j) = params_dense_values(i, j);
-      }
-      ++out_pos;
-    }
+    SPLITS_TYPE value_size, const DeviceBase::CpuWorkerThreads& worker_threads,
+    Tensor* values_out) {
+  if (value_slices.empty() || value_size == 0) return;
+  const VALUE_TYPE* params_dense_values =
+      params_dense_values_in.flat<VALUE_TYPE>().data();
+  VALUE_TYPE* values = values_out->flat<VALUE_TYPE>().data();
+
+  // out_starts[i] is the row of `values_out` that slice i is copied to.
+  const int64_t num_slices = value_slices.size();
+  std::vector<int64_t> out_starts(num_slices + 1);
+  out_starts[0] = 0;
+  for (int64_t i = 0; i < num_slices; ++i) {
+    out_starts[i + 1] =
+        out_starts[i] + (value_slices[i].second - value_slices[i].first);
   }
+  auto copy_slices = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      std::copy_n(params_dense_values + value_slices[i].first * value_size,
+                  (out_starts[i + 1] - out_starts[i]) * value_size,
+                  values + out_starts[i] * value_size);
+    }
+  };
+  const int64_t cost_per_slice =
+      std::max<int64_t>(1, out_starts[num_slices] * value_size / num_slices) *
+      sizeof(VALUE_TYPE);
+  Shard(worker_threads.num_threads, worker_threads.workers, num_slices,
+        cost_per_slice, copy_slices);
 }
 
 }  // namespace
@@ -166,9 +186,28 @@ class RaggedGatherOpBase : public OpKernel {
     // splits.  E.g., if we are copying a ragged row with length 4, then we
     // should add a new split point to out_splits that is 4 greater than the
     // previous split point in out_splits.
-    for (int i = 0; i < indices.size(); ++i) {
-      int start = indices(i);
-      int limit = indices(i) + 1;
+    // Each index adds one row to the outermost ragged dimension, and as many
+    // rows to each inner one as its rows have values in the one above it.
+    // Sizing the splits up front avoids regrowing them as they are appended.
+    value_slices->reserve(indices.size());
+    std::vector<SPLITS_TYPE> num_rows(params_nested_splits.size(), 0);
+    for (int64_t i = 0; i < indices.size(); ++i) {
+      SPLITS_TYPE start = indices(i);
+      SPLITS_TYPE limit = indices(i) + 1;
+      for (int dim = 0; dim < params_nested_splits.size(); ++dim) {
+        num_rows[dim] += limit - start;
+        start = params_nested_splits[dim](start);
+        limit = params_nested_splits[dim](limit);
+      }
+    }
+    for (int dim = 0; dim < params_nested_splits.size(); ++dim) {
+      const int out_dim = dim + indices_in.dims() - 1;
+      if (out_dim >= 0) out_splits->at(out_dim).reserve(num_rows[dim] + 1);
+    }
+
+    for (int64_t i = 0; i < indices.size(); ++i) {
+      SPLITS_TYPE start = indices(i);
+      SPLITS_TYPE limit = indices(i) + 1;
 
       // Copy splits.
       for (int dim = 0; dim < params_nested_splits.size(); ++dim) {
@@ -176,7 +215,7 @@ class RaggedGatherOpBase : public OpKernel {
         int out_dim = dim + indices_in.dims() - 1;
         if (out_dim >= 0) {
           SPLITS_TYPE delta = out_splits->at(out_dim).back() - splits(start);
-          for (int j = start; j < limit; ++j) {
+          for (SPLITS_TYPE j = start; j < limit; ++j) {
             out_splits->at(out_dim).push_back(splits(j + 1) + delta);
           }
         }
@@ -252,6 +291,7 @@ class RaggedGatherOpBase : public OpKernel {
         num_elements == 0 ? 0
                           : (num_elements / params_dense_values_in.dim_size(0));
     CallWriteValueSlices(params_dense_values_in, value_slices, value_size,
+                         *context->device()->tensorflow_cpu_worker_threads(),
                          values_out);
     return OkStatus();
   }
@@ -265,7 +305,9 @@ class RaggedGatherOpBase : public OpKernel {
   virtual void CallWriteValueSlices(
       const Tensor& params_dense_values_in,
       const std::vector<std::pair<SPLITS_TYPE, SPLITS_TYPE>>& value_slices,
-      SPLITS_TYPE value_size, Tensor* values_out) const = 0;
+      SPLITS_TYPE value_size,
+      const DeviceBase::CpuWorkerThreads& worker_threads,
+      Tensor* values_out) const = 0;
 };
 
 template <typename INDEX_TYPE, typename VALUE_TYPE, typename SPLITS_TYPE>
@@ -277,9 +319,11 @@ class RaggedGatherOp : public RaggedGatherOpBase<INDEX_TYPE, SPLITS_TYPE> {
   void CallWriteValueSlices(
       const Tensor& params_dense_values_in,
       const std::vector<std::pair<SPLITS_TYPE, SPLITS_TYPE>>& value_slices,
-      SPLITS_TYPE value_size, Tensor* values_out) const override {
+      SPLITS_TYPE value_size,
+      const DeviceBase::CpuWorkerThreads& worker_threads,
+      Tensor* values_out) const override {
     WriteValueSlices<VALUE_TYPE>(params_dense_values_in, value_slices,
-                                 value_size, values_out);
+                                 value_size, worker_threads, values_out);
   }
 };
 
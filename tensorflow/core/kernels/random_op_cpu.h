@@ -21,6 +21,7 @@ limitations under the License.
 #include <algorithm>
 #include <cmath>
 #include <memory>
+#include <type_traits>
 
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -72,6 +73,58 @@ struct FillPhiloxRandom {
   }
 };
 
+// A generator that returns groups that were generated ahead of time by
+// PhiloxRandom::GenerateBatch, in order.
+class PhiloxBatchReader {
+ public:
+  using ResultType = PhiloxRandom::ResultType;
+  using ResultElementType = PhiloxRandom::ResultElementType;
+  static constexpr int kResultElementCount = PhiloxRandom::kResultElementCount;
+
+  explicit PhiloxBatchReader(const ResultType* groups) : next_(groups) {}
+
+  ResultType operator()() { return *next_++; }
+
+ private:
+  const ResultType* next_;
+};
+
+// Maps a distribution over PhiloxRandom to the same distribution over
+// PhiloxBatchReader, for the stateless distributions that call the generator
+// exactly once per output group. Those can be computed from groups that are
+// generated in batches, with the same results.
+template <class Distribution, typename Enable = void>
+struct BatchedPhiloxDistribution {
+  static constexpr bool kEnabled = false;
+};
+
+template <typename T>
+struct IsBatchedPhiloxType
+    : std::integral_constant<bool, std::is_same<T, Eigen::half>::value ||
+                                       std::is_same<T, bfloat16>::value ||
+                                       std::is_same<T, float>::value ||
+                                       std::is_same<T, double>::value> {};
+
+template <typename T>
+struct BatchedPhiloxDistribution<
+    random::UniformDistribution<PhiloxRandom, T>,
+    typename std::enable_if<IsBatchedPhiloxType<T>::value>::type> {
+  static constexpr bool kEnabled = true;
+  using Type = random::UniformDistribution<PhiloxBatchReader, T>;
+};
+
+template <typename T>
+struct BatchedPhiloxDistribution<
+    random::NormalDistribution<PhiloxRandom, T>,
+    typename std::enable_if<IsBatchedPhiloxType<T>::value>::type> {
+  static constexpr bool kEnabled = true;
+  using Type = random::NormalDistribution<PhiloxBatchReader, T>;
+};
+
+// The number of groups that PhiloxRandom::GenerateBatch computes at once. 16
+// groups fill a 512-bit register for each word of the counter.
+constexpr int kPhiloxBatchGroups = 16;
+
 // A class to fill a specified range of random groups
 template <class Distribution, bool VariableSamplesPerOutput>
 struct FillPhiloxRandomTask;
@@ -90,7 +143,22 @@ struct FillPhiloxRandomTask<Distribution, false> {
 
     // First fill all the full-size groups
     int64_t limit_group_full = std::min(limit_group, size / kGroupSize);
-    for (int64_t index = start_group; index < limit_group_full; ++index) {
+    int64_t index = start_group;
+    if constexpr (BatchedPhiloxDistribution<Distribution>::kEnabled) {
+      typename BatchedPhiloxDistribution<Distribution>::Type batch_dist;
+      PhiloxRandom::ResultType groups[kPhiloxBatchGroups];
+      for (; index + kPhiloxBatchGroups <= limit_group_full;
+           index += kPhiloxBatchGroups) {
+        gen.GenerateBatch<kPhiloxBatchGroups>(groups);
+        PhiloxBatchReader reader(groups);
+        for (int i = 0; i < kPhiloxBatchGroups; ++i) {
+          auto samples = batch_dist(&reader);
+          std::copy(&samples[0], &samples[0] + kGroupSize, data + offset);
+          offset += kGroupSize;
+        }
+      }
+    }
+    for (; index < limit_group_full; ++index) {
       auto samples = dist(&gen);
       std::copy(&samples[0], &samples[0] + kGroupSize, data + offset);
       offset += kGroupSize;
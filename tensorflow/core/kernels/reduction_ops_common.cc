@@ -32,7 +32,7 @@ TensorShape ReductionHelper::out_shape() const {
   return shape;
 }
 
-TensorShape ReductionHelper::shuffled_shape() {
+TensorShape ReductionHelper::shuffled_shape() const {
   const int dims = data_reshape_.size();
   TensorShape shape;
   for (int i = reduce_first_axis_; i < dims; i += 2) {
@@ -44,7 +44,7 @@ TensorShape ReductionHelper::shuffled_shape() {
   return shape;
 }
 
-gtl::InlinedVector<int32, 8> ReductionHelper::permutation() {
+gtl::InlinedVector<int32, 8> ReductionHelper::permutation() const {
   const int dims = data_reshape_.size();
   const int unreduced_dims = (dims + !reduce_first_axis_) / 2;
   gtl::InlinedVector<int32, 8> perm(dims);
@@ -23,9 +23,12 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <memory>
+
 #include "third_party/eigen3/Eigen/Core"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 
+#include "tensorflow/core/framework/kernel_shape_cache.h"
 #include "tensorflow/core/framework/numeric_op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -93,13 +96,13 @@ class ReductionHelper {
 
   // The output is reshaped.
   template <typename T, int N>
-  typename TTypes<T, N>::Tensor out(Tensor* out) {
+  typename TTypes<T, N>::Tensor out(Tensor* out) const {
     return out->shaped<T, N>(out_reshape_);
   }
 
   // The input is reshaped.
   template <typename T, int N>
-  typename TTypes<T, N>::ConstTensor in(const Tensor& data) {
+  typename TTypes<T, N>::ConstTensor in(const Tensor& data) const {
     return data.shaped<T, N>(data_reshape_);
   }
 
@@ -111,10 +114,10 @@ class ReductionHelper {
   }
 
   // Shape with all reduction dimensions at the end
-  TensorShape shuffled_shape();
+  TensorShape shuffled_shape() const;
 
   // Permutation of reduced dims needed to put reduction dimensions at the end
-  gtl::InlinedVector<int32, 8> permutation();
+  gtl::InlinedVector<int32, 8> permutation() const;
 
  private:
   bool reduce_first_axis_;  // True if need to reduce the 0-th dimension.
@@ -143,8 +146,26 @@ class ReductionOp : public OpKernel {
     VLOG(1) << "data shape: " << data.shape().DebugString();
     VLOG(1) << "axes      : " << axes.SummarizeValue(10);
 
-    ReductionHelper helper;
-    OP_REQUIRES_OK(ctx, helper.Simplify(data, axes, keep_dims_));
+    std::shared_ptr<const ReductionHelper> cached_helper;
+    ReductionHelper local_helper;
+    if (helper_cache_.enabled()) {
+      KernelShapeCache<ReductionHelper>::Key key;
+      key.AddShape(data.shape());
+      const auto axes_flat = axes.flat<Tperm>();
+      for (int64_t i = 0; i < axes_flat.size(); ++i) {
+        key.AddValue(axes_flat(i));
+      }
+      cached_helper = helper_cache_.Lookup(key);
+      if (cached_helper == nullptr) {
+        auto helper = std::make_shared<ReductionHelper>();
+        OP_REQUIRES_OK(ctx, helper->Simplify(data, axes, keep_dims_));
+        cached_helper = helper_cache_.Insert(std::move(key), std::move(helper));
+      }
+    } else {
+      OP_REQUIRES_OK(ctx, local_helper.Simplify(data, axes, keep_dims_));
+    }
+    const ReductionHelper& helper =
+        cached_helper != nullptr ? *cached_helper : local_helper;
     CHECK_GE(helper.ndims(), 0);
 
     bool is_scalar_identity = functor::ReducerTraits<Reducer>::IsScalarIdentity;
@@ -247,6 +268,8 @@ class ReductionOp : public OpKernel {
  private:
   // True if the number of dimensions should be maintained.
   bool keep_dims_;
+  // The reduction plans for the input shapes and axes that were seen recently.
+  KernelShapeCache<ReductionHelper> helper_cache_;
 };
 
 namespace functor {
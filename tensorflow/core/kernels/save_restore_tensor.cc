@@ -33,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
@@ -250,6 +251,38 @@ namespace {
 // Tensors larger than this threshold will be restored from a thread-pool.
 const int64_t kLargeShapeThreshold = 16 << 20;  // 16M
 
+// Tensors larger than this many bytes are read in ranges of this size, which
+// are read concurrently.
+const int64_t kParallelReadSize = 16 << 20;  // 16MB
+
+// The number of threads that read the ranges of large tensors, which can be
+// set with TF_RESTORE_READ_THREADS. 0 reads each tensor with a single read.
+int64_t NumRestoreReadThreads() {
+  static const int64_t num_threads = []() {
+    int64_t num_threads;
+    TF_CHECK_OK(
+        ReadInt64FromEnvVar("TF_RESTORE_READ_THREADS", 16, &num_threads));
+    return num_threads;
+  }();
+  return num_threads;
+}
+
+// Returns true if TF_RESTORE_MAP_DATA_FILES is set, in which case the full
+// tensors that are aligned in the data files (see TF_SAVE_ALIGNED_TENSORS) are
+// restored as read-only views of the memory-mapped files, e.g. for serving.
+// The processes that restore the same checkpoint then share its memory through
+// the page cache. Variables that are assigned such tensors copy them before
+// they are updated. The index of the checkpoint is mapped as well.
+bool MapDataFiles() {
+  static const bool map_data_files = []() {
+    bool map_data_files;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_RESTORE_MAP_DATA_FILES", false,
+                                   &map_data_files));
+    return map_data_files;
+  }();
+  return map_data_files;
+}
+
 // A restore operation for a single tensor.  Small tensors may be restored
 // directly from the op thread to improve read locality.  Large tensors can be
 // restored from a thread pool: this requires creating a separate BundleReader
@@ -283,8 +316,8 @@ struct RestoreOp {
   }
 
   // Run this restore operation using a new BundleReader.
-  void run_with_new_reader() {
-    BundleReader reader(Env::Default(), reader_prefix);
+  void run_with_new_reader(const BundleReader::Options& reader_options) {
+    BundleReader reader(Env::Default(), reader_prefix, reader_options);
     if (!reader.status().ok()) {
       status = reader.status();
       return;
@@ -301,7 +334,22 @@ struct RestoreOp {
     VLOG(1) << "Restoring tensor " << idx << " : " << tensor_name << " : "
             << restored_full_shape.num_elements();
     Tensor* restored_tensor;
-    if (shape_and_slice.empty()) {
+    bool map_full_tensor = false;
+    if (shape_and_slice.empty() && MapDataFiles()) {
+      // Partitioned tensors are assembled from their slices, so they cannot be
+      // mapped.
+      std::vector<TensorSlice> stored_slices;
+      TF_RETURN_IF_ERROR(
+          reader->LookupTensorSlices(tensor_name, &stored_slices));
+      map_full_tensor = stored_slices.empty();
+    }
+    if (map_full_tensor) {
+      // Lets the reader allocate the tensor, or map it.
+      Tensor restored;
+      TF_RETURN_IF_ERROR(reader->Lookup(tensor_name, &restored));
+      context->set_output(idx, restored);
+      restored_tensor = context->mutable_output(idx);
+    } else if (shape_and_slice.empty()) {
       // Lookup the full tensor.
       TF_RETURN_IF_ERROR(
           context->allocate_output(idx, restored_full_shape, &restored_tensor));
@@ -377,18 +425,30 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
                            shape_and_slices_flat(i), prefix_string, dtypes[i]});
   }
 
-  BundleReader default_reader(Env::Default(), prefix_string);
+  // The large tensors are read in ranges on `read_pool`. It is created after
+  // the dtypes are checked, and only if there are large tensors to restore.
+  std::unique_ptr<thread::ThreadPool> read_pool;
+  BundleReader::Options reader_options;
+  reader_options.parallel_read_size = kParallelReadSize;
+  reader_options.map_data_files = MapDataFiles();
+  reader_options.map_metadata = MapDataFiles();
+  BundleReader default_reader(Env::Default(), prefix_string, reader_options);
   TF_RETURN_IF_ERROR(default_reader.status());
 
   TF_RETURN_IF_ERROR(default_reader.SortForSequentialAccess<RestoreOp>(
       restore_ops, [](const RestoreOp& op) { return op.tensor_name; }));
 
   std::vector<string> mismatched_errors;
+  bool has_parallel_reads = false;
   for (const RestoreOp& restore_op : restore_ops) {
     TensorShape restored_full_shape;
     DataType original_dtype;
     TF_RETURN_IF_ERROR(default_reader.LookupDtypeAndShape(
         restore_op.tensor_name, &original_dtype, &restored_full_shape));
+    has_parallel_reads |= DataTypeCanUseMemcpy(original_dtype) &&
+                          restored_full_shape.num_elements() *
+                                  DataTypeSize(original_dtype) >
+                              kParallelReadSize;
     if (restore_op.dtype != original_dtype) {
       string error_msg = strings::StrCat(
           "tensor_name = ", restore_op.tensor_name, "; expected dtype ",
@@ -402,6 +462,13 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
     return errors::InvalidArgument(error_msg);
   }
 
+  if (has_parallel_reads && NumRestoreReadThreads() > 0) {
+    read_pool = std::make_unique<thread::ThreadPool>(
+        Env::Default(), "restore_reads", NumRestoreReadThreads());
+    reader_options.read_pool = read_pool.get();
+    default_reader.set_read_pool(read_pool.get());
+  }
+
   std::vector<RestoreOp*> pool_restore_ops;
   std::vector<RestoreOp*> direct_restore_ops;
   for (RestoreOp& restore_op : restore_ops) {
@@ -420,7 +487,9 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
       reader_pool.reset(
           new thread::ThreadPool(Env::Default(), "restore_tensors", 8));
       for (auto* op : pool_restore_ops) {
-        reader_pool->Schedule([op]() { op->run_with_new_reader(); });
+        reader_pool->Schedule([op, &reader_options]() {
+          op->run_with_new_reader(reader_options);
+        });
       }
     }
 
@@ -15,6 +15,8 @@ limitations under the License.
 
 // See docs in ../ops/io_ops.cc.
 
+#include <deque>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -30,7 +32,9 @@ limitations under the License.
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
@@ -39,6 +43,104 @@ namespace tensorflow {
 
 namespace {
 
+// Returns true if TF_SAVE_ALIGNED_TENSORS is set, in which case SaveV2 aligns
+// the tensor data in the data files so that it can be memory-mapped by
+// RestoreV2 (see TF_RESTORE_MAP_DATA_FILES).
+bool SaveAlignedTensors() {
+  static const bool aligned = []() {
+    bool aligned;
+    TF_CHECK_OK(
+        ReadBoolFromEnvVar("TF_SAVE_ALIGNED_TENSORS", false, &aligned));
+    return aligned;
+  }();
+  return aligned;
+}
+
+// Returns true if TF_ASYNC_CHECKPOINT_WRITES is set, in which case SaveV2 and
+// MergeV2Checkpoints return as soon as their inputs are captured, and write
+// the checkpoint in the background (see AsyncCheckpointWriter).
+bool AsyncCheckpointWrites() {
+  static const bool async = []() {
+    bool async;
+    TF_CHECK_OK(
+        ReadBoolFromEnvVar("TF_ASYNC_CHECKPOINT_WRITES", false, &async));
+    return async;
+  }();
+  return async;
+}
+
+// Runs the writes of the checkpoints in the background, one at a time and in
+// the order in which they are scheduled, so that MergeV2Checkpoints runs after
+// the SaveV2 ops of its shards. The errors of the writes are returned by the
+// next call to Schedule() or Wait(), and RestoreV2 waits for all the scheduled
+// writes before it reads a checkpoint.
+class AsyncCheckpointWriter {
+ public:
+  static AsyncCheckpointWriter* Get() {
+    static AsyncCheckpointWriter* writer = new AsyncCheckpointWriter();
+    return writer;
+  }
+
+  // Schedules `write`, and returns the first error of the writes that failed
+  // since the last call to Schedule() or Wait().
+  Status Schedule(std::function<Status()> write) {
+    mutex_lock l(mu_);
+    writes_.push_back(std::move(write));
+    cond_var_.notify_all();
+    return TakeStatus();
+  }
+
+  // Waits until the scheduled writes are done, and returns the first error of
+  // the writes that failed since the last call to Schedule() or Wait().
+  Status Wait() {
+    mutex_lock l(mu_);
+    while (!writes_.empty()) {
+      cond_var_.wait(l);
+    }
+    return TakeStatus();
+  }
+
+ private:
+  AsyncCheckpointWriter()
+      : thread_(Env::Default()->StartThread(
+            {}, "async_checkpoint_writer", [this]() { WriteLoop(); })) {}
+
+  void WriteLoop() {
+    while (true) {
+      std::function<Status()> write;
+      {
+        mutex_lock l(mu_);
+        while (writes_.empty()) {
+          cond_var_.wait(l);
+        }
+        write = writes_.front();
+      }
+      Status status = write();
+      if (!status.ok()) {
+        LOG(ERROR) << "Asynchronous checkpoint write failed: " << status;
+      }
+      mutex_lock l(mu_);
+      // The write is only removed once it is done, for Wait().
+      writes_.pop_front();
+      status_.Update(status);
+      cond_var_.notify_all();
+    }
+  }
+
+  Status TakeStatus() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    Status status = status_;
+    status_ = OkStatus();
+    return status;
+  }
+
+  mutex mu_;
+  condition_variable cond_var_;
+  std::deque<std::function<Status()>> writes_ TF_GUARDED_BY(mu_);
+  Status status_ TF_GUARDED_BY(mu_);
+  // Never destroyed, like the writer.
+  std::unique_ptr<Thread> thread_;
+};
+
 // Shared validations of the inputs to the SaveV2 and RestoreV2 ops.
 void ValidateInputs(bool is_save_op, OpKernelContext* context,
                     const Tensor& prefix, const Tensor& tensor_names,
@@ -87,6 +189,69 @@ void ValidateInputs(bool is_save_op, OpKernelContext* context,
   }
 }
 
+// Writes the tensors of a SaveV2 op to the bundle at `prefix`.
+Status WriteBundle(const string& prefix,
+                   const std::vector<string>& tensor_names,
+                   const std::vector<string>& shape_and_slices,
+                   const std::vector<Tensor>& tensors) {
+  BundleWriter::Options writer_options;
+  if (SaveAlignedTensors()) {
+    writer_options.data_alignment = EIGEN_MAX_ALIGN_BYTES;
+  }
+  BundleWriter writer(Env::Default(), prefix, writer_options);
+  TF_RETURN_IF_ERROR(writer.status());
+  VLOG(1) << "BundleWriter, prefix_string: " << prefix;
+
+  for (int i = 0; i < tensors.size(); ++i) {
+    const string& tensor_name = tensor_names[i];
+    const Tensor& tensor = tensors[i];
+    VLOG(2) << "Starting save of " << tensor_name;
+
+    if (!shape_and_slices[i].empty()) {
+      const string& shape_spec = shape_and_slices[i];
+      TensorShape shape;
+      TensorSlice slice(tensor.dims());
+      TensorShape slice_shape;
+
+      TF_RETURN_IF_ERROR(checkpoint::ParseShapeAndSlice(shape_spec, &shape,
+                                                        &slice, &slice_shape));
+      if (!slice_shape.IsSameSize(tensor.shape())) {
+        return errors::InvalidArgument(
+            "Slice in shape_and_slice "
+            "specification does not match the "
+            "shape of the tensor to  save: ",
+            shape_spec, ", tensor: ", tensor.shape().DebugString());
+      }
+
+      TF_RETURN_IF_ERROR(writer.AddSlice(tensor_name, shape, slice, tensor));
+    } else {
+      TF_RETURN_IF_ERROR(writer.Add(tensor_name, tensor));
+    }
+
+    if (VLOG_IS_ON(5)) {
+      if (tensor.dtype() == DT_FLOAT) {
+        const float* t_data = tensor.flat<float>().data();
+        float min = std::numeric_limits<float>::infinity();
+        float max = -std::numeric_limits<float>::infinity();
+        double avg = 0.0;
+        for (int i = 0; i < tensor.NumElements(); ++i) {
+          if (t_data[i] < min) min = t_data[i];
+          if (t_data[i] > max) max = t_data[i];
+          avg += t_data[i];
+        }
+        VLOG(5) << " min " << min << " max " << max << " avg "
+                << avg / tensor.NumElements() << " total elts "
+                << tensor.NumElements();
+      }
+    }
+
+    VLOG(2) << "Done save of " << tensor_name;
+  }
+  TF_RETURN_IF_ERROR(writer.Finish());
+  VLOG(1) << "Done BundleWriter, prefix_string: " << prefix;
+  return OkStatus();
+}
+
 }  // namespace
 
 // Saves a list of named tensors using the tensor bundle library.
@@ -108,61 +273,25 @@ class SaveV2 : public OpKernel {
     const auto& tensor_names_flat = tensor_names.flat<tstring>();
     const auto& shape_and_slices_flat = shape_and_slices.flat<tstring>();
 
-    BundleWriter writer(Env::Default(), prefix_string);
-    OP_REQUIRES_OK(context, writer.status());
-    VLOG(1) << "BundleWriter, prefix_string: " << prefix_string;
-
+    // The tensors share the buffers of the inputs, which resource variables
+    // copy before they are updated, so they stay a consistent snapshot while
+    // they are written asynchronously.
+    std::vector<string> names;
+    std::vector<string> slices;
+    std::vector<Tensor> tensors;
+    names.reserve(num_tensors);
+    slices.reserve(num_tensors);
+    tensors.reserve(num_tensors);
     for (int i = 0; i < num_tensors; ++i) {
-      const string& tensor_name = tensor_names_flat(i);
-      const Tensor& tensor = context->input(i + kFixedInputs);
-      VLOG(2) << "Starting save of " << tensor_name;
-
-      if (!shape_and_slices_flat(i).empty()) {
-        const string& shape_spec = shape_and_slices_flat(i);
-        TensorShape shape;
-        TensorSlice slice(tensor.dims());
-        TensorShape slice_shape;
-
-        OP_REQUIRES_OK(context, checkpoint::ParseShapeAndSlice(
-                                    shape_spec, &shape, &slice, &slice_shape));
-        OP_REQUIRES(context, slice_shape.IsSameSize(tensor.shape()),
-                    errors::InvalidArgument("Slice in shape_and_slice "
-                                            "specification does not match the "
-                                            "shape of the tensor to  save: ",
-                                            shape_spec, ", tensor: ",
-                                            tensor.shape().DebugString()));
-
-        OP_REQUIRES_OK(context,
-                       writer.AddSlice(tensor_name, shape, slice, tensor));
-      } else {
-        OP_REQUIRES_OK(context, writer.Add(tensor_name, tensor));
-      }
-
-      if (VLOG_IS_ON(5)) {
-        if (tensor.dtype() == DT_FLOAT) {
-          const float* t_data = tensor.flat<float>().data();
-          float min = std::numeric_limits<float>::infinity();
-          float max = -std::numeric_limits<float>::infinity();
-          double avg = 0.0;
-          for (int i = 0; i < tensor.NumElements(); ++i) {
-            if (t_data[i] < min) min = t_data[i];
-            if (t_data[i] > max) max = t_data[i];
-            avg += t_data[i];
-          }
-          VLOG(5) << " min " << min << " max " << max << " avg "
-                  << avg / tensor.NumElements() << " total elts "
-                  << tensor.NumElements();
-        }
-      }
-
-      VLOG(2) << "Done save of " << tensor_name;
+      names.push_back(tensor_names_flat(i));
+      slices.push_back(shape_and_slices_flat(i));
+      tensors.push_back(context->input(i + kFixedInputs));
     }
-    OP_REQUIRES_OK(context, writer.Finish());
-    VLOG(1) << "Done BundleWriter, prefix_string: " << prefix_string;
 
+    checkpoint::CheckpointCallbackManager* checkpoint_callback_manager =
+        nullptr;
     ResourceMgr* resource_manager = context->resource_manager();
     if (resource_manager != nullptr) {
-      checkpoint::CheckpointCallbackManager* checkpoint_callback_manager;
       OP_REQUIRES_OK(
           context,
           resource_manager
@@ -175,8 +304,22 @@ class SaveV2 : public OpKernel {
                     *out = new checkpoint::CheckpointCallbackManager();
                     return OkStatus();
                   }));
-      checkpoint_callback_manager->Save(prefix_string);
-      checkpoint_callback_manager->Unref();
+    }
+
+    string prefix_copy = prefix_string;
+    auto save = [prefix_copy, names, slices, tensors,
+                 checkpoint_callback_manager]() {
+      Status status = WriteBundle(prefix_copy, names, slices, tensors);
+      if (checkpoint_callback_manager != nullptr) {
+        if (status.ok()) checkpoint_callback_manager->Save(prefix_copy);
+        checkpoint_callback_manager->Unref();
+      }
+      return status;
+    };
+    if (AsyncCheckpointWrites()) {
+      OP_REQUIRES_OK(context, AsyncCheckpointWriter::Get()->Schedule(save));
+    } else {
+      OP_REQUIRES_OK(context, save());
     }
   }
 };
@@ -202,6 +345,10 @@ class RestoreV2 : public OpKernel {
     if (!context->status().ok()) return;
 
     const string& prefix_string = prefix.scalar<tstring>()();
+    if (AsyncCheckpointWrites()) {
+      // The checkpoint may still be being written.
+      OP_REQUIRES_OK(context, AsyncCheckpointWriter::Get()->Wait());
+    }
 
     // Intention: we plan to use the RestoreV2 op as a backward-compatible
     // reader as we upgrade to the V2 format.  This allows transparent upgrade.
@@ -277,24 +424,35 @@ class MergeV2Checkpoints : public OpKernel {
                     "Input destination_prefix should be a scalar tensor, got ",
                     destination_prefix.shape().DebugString(), " instead."));
 
-    const gtl::ArraySlice<tstring> input_prefixes =
-        gtl::ArraySlice<tstring>(checkpoint_prefixes.flat<tstring>());
-    Env* env = Env::Default();
-    const string& merged_prefix = destination_prefix.scalar<tstring>()();
-    OP_REQUIRES_OK(context,
-                   tensorflow::MergeBundles(env, input_prefixes, merged_prefix,
-                                            allow_missing_files_));
-
-    if (delete_old_dirs_) {
-      const string merged_dir(io::Dirname(merged_prefix));
-      for (const string& input_prefix : input_prefixes) {
-        const string dirname(io::Dirname(input_prefix));
-        if (dirname == merged_dir) continue;
-        Status status = env->DeleteDir(dirname);
-        // For sharded save, only the first delete will go through and all
-        // others will hit NotFound.  Use vlog to be less verbose.
-        if (!status.ok()) VLOG(1) << status;
+    const auto& input_prefixes_flat = checkpoint_prefixes.flat<tstring>();
+    const std::vector<tstring> input_prefixes(
+        input_prefixes_flat.data(),
+        input_prefixes_flat.data() + input_prefixes_flat.size());
+    const string merged_prefix = destination_prefix.scalar<tstring>()();
+    auto merge = [input_prefixes, merged_prefix,
+                  delete_old_dirs = delete_old_dirs_,
+                  allow_missing_files = allow_missing_files_]() {
+      Env* env = Env::Default();
+      TF_RETURN_IF_ERROR(tensorflow::MergeBundles(
+          env, input_prefixes, merged_prefix, allow_missing_files));
+
+      if (delete_old_dirs) {
+        const string merged_dir(io::Dirname(merged_prefix));
+        for (const tstring& input_prefix : input_prefixes) {
+          const string dirname(io::Dirname(input_prefix));
+          if (dirname == merged_dir) continue;
+          Status status = env->DeleteDir(dirname);
+          // For sharded save, only the first delete will go through and all
+          // others will hit NotFound.  Use vlog to be less verbose.
+          if (!status.ok()) VLOG(1) << status;
+        }
       }
+      return OkStatus();
+    };
+    if (AsyncCheckpointWrites()) {
+      OP_REQUIRES_OK(context, AsyncCheckpointWriter::Get()->Schedule(merge));
+    } else {
+      OP_REQUIRES_OK(context, merge());
     }
   }
 
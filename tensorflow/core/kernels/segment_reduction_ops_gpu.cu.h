@@ -234,6 +234,34 @@ Status LaunchSegmentOffsetsKernel(const GPUDevice& d, Tindex size,
                          segment_offsets);
 }
 
+// Maps the segment IDs that are outside [0, nsegments) to nsegments, which
+// SegmentOffsetsKernel ignores. The resulting keys can be sorted using only
+// the bits needed to represent nsegments, and invalid IDs sort after all of
+// the valid ones.
+template <typename Tindex, typename Tsegmentids>
+__global__ void ClipSegmentIdsKernel(
+    Tindex size, Tsegmentids nsegments,
+    const Tsegmentids* __restrict__ segment_ids,  // [size]
+    Tsegmentids* __restrict__ clipped_ids) {      // [size]
+  GPU_1D_KERNEL_LOOP(i, size) {
+    const Tsegmentids id = segment_ids[i];
+    clipped_ids[i] = (id >= 0 && id < nsegments) ? id : nsegments;
+  }
+}
+
+template <typename Tindex, typename Tsegmentids>
+Status LaunchClipSegmentIdsKernel(const GPUDevice& d, Tindex size,
+                                  Tsegmentids nsegments,
+                                  const Tsegmentids* segment_ids,  // [size]
+                                  Tsegmentids* clipped_ids) {      // [size]
+  GpuLaunchConfig config = GetGpuLaunchConfig(
+      size, d, &ClipSegmentIdsKernel<Tindex, Tsegmentids>,
+      /*dynamic_shared_memory_size=*/0, /*block_size_limit=*/0);
+  return GpuLaunchKernel(ClipSegmentIdsKernel<Tindex, Tsegmentids>,
+                         config.block_count, config.thread_per_block, 0,
+                         d.stream(), size, nsegments, segment_ids, clipped_ids);
+}
+
 template <typename T>
 struct RealTypeIfComplex {
   using type = T;
@@ -864,6 +892,17 @@ struct UnsortedSegmentFunctor<GPUDevice, T, Index, InitialValueF, ReductionF> {
 #if !defined(PLATFORM_WINDOWS)
       // Allocate temporary space and sort segment_ids, then call the sorted
       // implem.
+      Tensor clipped_segment_ids;
+      OP_REQUIRES_OK(
+          ctx, ctx->allocate_temp(
+                   DataTypeToEnum<Index>::value,
+                   TensorShape({static_cast<int64_t>(input_outer_dim_size)}),
+                   &clipped_segment_ids));
+      Index* clipped_segment_ids_ptr = clipped_segment_ids.flat<Index>().data();
+      OP_REQUIRES_OK(ctx, LaunchClipSegmentIdsKernel(
+                              ctx->eigen_gpu_device(), input_outer_dim_size,
+                              num_segments, unsorted_segment_ids.data(),
+                              clipped_segment_ids_ptr));
       Tensor segment_ids;
       OP_REQUIRES_OK(
           ctx, ctx->allocate_temp(
@@ -878,14 +917,17 @@ struct UnsortedSegmentFunctor<GPUDevice, T, Index, InitialValueF, ReductionF> {
                    TensorShape({static_cast<int64_t>(input_outer_dim_size)}),
                    &sorted_indices));
       Index* sorted_indices_ptr = sorted_indices.flat<Index>().data();
-      // Note: We must sort using all bits here because unsorted_segment_ids
-      // may contain negative values.
+      // The clipped IDs are in [0, num_segments], so only the low bits need
+      // to be sorted, which takes far fewer radix passes than sorting the
+      // original IDs with all of their bits. The sort is stable, so each
+      // segment is reduced in the order of its elements in the input.
       OP_REQUIRES_OK(
           ctx, GpuRadixSort(ctx, input_outer_dim_size,
-                            /*keys_in=*/unsorted_segment_ids.data(),
+                            /*keys_in=*/clipped_segment_ids_ptr,
                             /*keys_out=*/segment_ids_ptr,
                             /*indices_in=*/static_cast<const Index*>(nullptr),
-                            /*indices_out=*/sorted_indices_ptr));
+                            /*indices_out=*/sorted_indices_ptr,
+                            /*num_bits=*/Log2Ceiling64(num_segments + 1)));
       using Treduce = typename ReduceType<ReductionF, T>::type;
       OP_REQUIRES_OK(
           ctx,
@@ -21,13 +21,16 @@ limitations under the License.
 #include <numeric>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/radix_sort.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/util/overflow.h"
 #include "tensorflow/core/util/sparse/sparse_tensor.h"
 
 namespace tensorflow {
@@ -40,6 +43,36 @@ using GPUDevice = Eigen::GpuDevice;
 
 namespace functor {
 
+namespace {
+
+// Sets `keys` to the row-major linear index of each row of `ix` in `shape`.
+// Returns false, and leaves `keys` unspecified, if an index is out of bounds
+// or the number of elements of `shape` overflows int64.
+bool LinearizeIndices(TTypes<int64_t>::ConstMatrix ix,
+                      gtl::ArraySlice<int64_t> shape,
+                      std::vector<int64_t>* keys) {
+  int64_t num_elements = 1;
+  for (const int64_t dim : shape) {
+    num_elements = MultiplyWithoutOverflow(num_elements, dim);
+    if (num_elements < 0) return false;
+  }
+  const int64_t num_entries = ix.dimension(0);
+  const int64_t dims = ix.dimension(1);
+  keys->resize(num_entries);
+  for (int64_t i = 0; i < num_entries; ++i) {
+    int64_t key = 0;
+    for (int64_t d = 0; d < dims; ++d) {
+      const int64_t index = ix(i, d);
+      if (index < 0 || index >= shape[d]) return false;
+      key = key * shape[d] + index;
+    }
+    (*keys)[i] = key;
+  }
+  return true;
+}
+
+}  // namespace
+
 template <typename T>
 struct SparseReorderFunctor<CPUDevice, T> {
   void operator()(OpKernelContext* context, const Tensor& input_ind,
@@ -59,6 +92,36 @@ struct SparseReorderFunctor<CPUDevice, T> {
     if (input_sp.IndicesValid().ok()) {
       context->set_output(0, input_sp.indices());
       context->set_output(1, input_sp.values());
+      return;
+    }
+
+    // Radix sort the row-major linear indices when they fit in an int64.
+    const int64_t num_entries = input_ind.dim_size(0);
+    const auto ix = input_ind.matrix<int64_t>();
+    std::vector<int64_t> keys;
+    if (num_entries >= kMinRadixSortSize &&
+        LinearizeIndices(ix, input_shape, &keys)) {
+      std::vector<int64_t> order(num_entries);
+      std::iota(order.begin(), order.end(), 0);
+      RadixSortByKey(
+          context->device()->tensorflow_cpu_worker_threads()->workers,
+          num_entries, keys.data(), order.data());
+
+      Tensor* output_ind = nullptr;
+      OP_REQUIRES_OK(context, context->allocate_output(0, input_ind.shape(),
+                                                       &output_ind));
+      Tensor* output_val = nullptr;
+      OP_REQUIRES_OK(context, context->allocate_output(1, input_val.shape(),
+                                                       &output_val));
+      auto output_ix = output_ind->matrix<int64_t>();
+      const auto vals = input_val.vec<T>();
+      auto output_vals = output_val->vec<T>();
+      const int64_t dims = ix.dimension(1);
+      for (int64_t i = 0; i < num_entries; ++i) {
+        const int64_t src = order[i];
+        for (int64_t d = 0; d < dims; ++d) output_ix(i, d) = ix(src, d);
+        output_vals(i) = vals(src);
+      }
     } else {
       // Deep-copy the input Tensors, then reorder in-place
       sparse::SparseTensor reordered_sp;
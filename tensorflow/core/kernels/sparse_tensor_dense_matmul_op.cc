@@ -19,10 +19,14 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/sparse_tensor_dense_matmul_op.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/kernels/fill_functor.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/bfloat16.h"
 
 namespace tensorflow {
@@ -321,6 +325,110 @@ Status SparseTensorDenseMatMulImpl(
   }
   return OkStatus();
 }
+
+// Below this many multiply-adds, sorting the nonzeros by row costs more than
+// using more threads saves.
+constexpr int64_t kMinParallelWork = 1 << 18;
+
+// Like SparseTensorDenseMatMulImpl, but sorts the nonzeros of `a` by output
+// row into CSR form, and computes blocks of rows with about the same number
+// of nonzeros on different threads. Each output row is only written by one
+// thread, and sums its terms in the same order as the serial implementation,
+// so the results are identical to it.
+template <typename T, typename Tsum, typename Tindices, bool ADJ_A, bool ADJ_B>
+Status SparseTensorDenseMatMulParallelImpl(
+    const DeviceBase::CpuWorkerThreads& worker_threads,
+    typename TTypes<Tsum>::Matrix out,
+    typename TTypes<Tindices>::ConstMatrix a_indices,
+    typename TTypes<T>::ConstVec a_values, typename TTypes<T>::ConstMatrix b) {
+  const int64_t nnz = a_values.size();
+  const int64_t num_rows = out.dimension(0);
+  const std::size_t rhs_right = (ADJ_B ? b.dimension(0) : b.dimension(1));
+  const std::size_t lhs_right = (ADJ_B ? b.dimension(1) : b.dimension(0));
+  const int lhs_index_a = ADJ_A ? 1 : 0;
+  const int rhs_index_a = ADJ_A ? 0 : 1;
+
+  // Copies the indices once, so that a concurrent modification of the input
+  // cannot invalidate the bounds checks.
+  std::vector<Tindices> rows(nnz);
+  std::vector<Tindices> cols(nnz);
+  std::vector<int64_t> row_begin(num_rows + 1, 0);
+  for (int64_t i = 0; i < nnz; ++i) {
+    const Tindices m = internal::SubtleMustCopy(a_indices(i, lhs_index_a));
+    const Tindices k = internal::SubtleMustCopy(a_indices(i, rhs_index_a));
+    if (!FastBoundsCheck(k, lhs_right)) {
+      return KOutOfBoundsError(k, i, rhs_index_a, lhs_right);
+    }
+    if (!FastBoundsCheck(m, num_rows)) {
+      return MOutOfBoundsError(m, i, lhs_index_a, num_rows);
+    }
+    rows[i] = m;
+    cols[i] = k;
+    ++row_begin[m + 1];
+  }
+  for (int64_t m = 0; m < num_rows; ++m) {
+    row_begin[m + 1] += row_begin[m];
+  }
+  std::vector<Tindices> csr_cols(nnz);
+  std::vector<Tsum> csr_values(nnz);
+  {
+    std::vector<int64_t> next(row_begin.begin(), row_begin.end() - 1);
+    for (int64_t i = 0; i < nnz; ++i) {
+      const int64_t pos = next[rows[i]]++;
+      csr_cols[pos] = cols[i];
+      csr_values[pos] = static_cast<Tsum>(ADJ_A ? MaybeConj(a_values(i))
+                                                : a_values(i));
+    }
+  }
+
+  // The rows of op(b), contiguous in memory.
+  const T* b_rows = b.data();
+  Eigen::Tensor<T, 2, Eigen::RowMajor> adjoint_b;
+  if (ADJ_B) {
+    Eigen::array<int, 2> shuffle(1, 0);
+    adjoint_b = b.shuffle(shuffle).conjugate();
+    b_rows = adjoint_b.data();
+  }
+
+  // Splits the rows into blocks of about nnz / num_blocks nonzeros. A row
+  // with more nonzeros than that gets a block of its own.
+  const int64_t num_blocks = std::min<int64_t>(
+      num_rows, 4 * static_cast<int64_t>(worker_threads.num_threads));
+  std::vector<int64_t> block_begin(num_blocks + 1);
+  for (int64_t j = 0; j < num_blocks; ++j) {
+    block_begin[j] =
+        std::lower_bound(row_begin.begin(), row_begin.end(),
+                         nnz * j / num_blocks) -
+        row_begin.begin();
+  }
+  block_begin[0] = 0;
+  block_begin[num_blocks] = num_rows;
+
+  auto compute_blocks = [&](int64_t first, int64_t last) {
+    for (int64_t j = first; j < last; ++j) {
+      for (int64_t m = block_begin[j]; m < block_begin[j + 1]; ++m) {
+        Tsum* out_row = &out(m, 0);
+        for (int64_t p = row_begin[m]; p < row_begin[m + 1]; ++p) {
+          const T* b_row = b_rows + csr_cols[p] * rhs_right;
+          const Tsum a_value = csr_values[p];
+          for (std::size_t n = 0; n < rhs_right; ++n) {
+            out_row[n] += a_value * static_cast<Tsum>(b_row[n]);
+          }
+        }
+      }
+    }
+  };
+  worker_threads.workers->TransformRangeConcurrently(
+      /*block_size=*/1, num_blocks, compute_blocks);
+  return OkStatus();
+}
+
+// Returns true if the product should use SparseTensorDenseMatMulParallelImpl.
+bool UseParallelImpl(const DeviceBase::CpuWorkerThreads& worker_threads,
+                     int64_t nnz, int64_t num_rows, int64_t rhs_right) {
+  return worker_threads.num_threads > 1 && num_rows > 1 &&
+         nnz * rhs_right >= kMinParallelWork;
+}
 }  // namespace
 
 template <typename T, typename Tindices, bool ADJ_A, bool ADJ_B>
@@ -330,6 +438,11 @@ struct SparseTensorDenseMatMulFunctor<CPUDevice, T, Tindices, ADJ_A, ADJ_B> {
                         typename TTypes<T>::ConstVec a_values,
                         typename TTypes<T>::ConstMatrix b) {
     using Tsum = typename SumType<T>::type;
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *ctx->device()->tensorflow_cpu_worker_threads();
+    const bool use_parallel_impl =
+        UseParallelImpl(worker_threads, a_values.size(), out.dimension(0),
+                        out.dimension(1));
     Tensor temp_out_t;
     if (!std::is_same<T, Tsum>::value) {
       TF_RETURN_IF_ERROR(ctx->allocate_temp(
@@ -337,9 +450,16 @@ struct SparseTensorDenseMatMulFunctor<CPUDevice, T, Tindices, ADJ_A, ADJ_B> {
           TensorShape({out.dimension(0), out.dimension(1)}), &temp_out_t));
       auto temp_out = temp_out_t.matrix<Tsum>();
       temp_out.setZero();
-      TF_RETURN_IF_ERROR(
-          SparseTensorDenseMatMulImpl<T, Tsum, Tindices, ADJ_A, ADJ_B>(
-              temp_out, a_indices, a_values, b));
+      if (use_parallel_impl) {
+        TF_RETURN_IF_ERROR((
+            SparseTensorDenseMatMulParallelImpl<T, Tsum, Tindices, ADJ_A,
+                                                ADJ_B>(
+                worker_threads, temp_out, a_indices, a_values, b)));
+      } else {
+        TF_RETURN_IF_ERROR(
+            SparseTensorDenseMatMulImpl<T, Tsum, Tindices, ADJ_A, ADJ_B>(
+                temp_out, a_indices, a_values, b));
+      }
       out = temp_out.template cast<T>();
     } else {
       out.setZero();
@@ -347,9 +467,16 @@ struct SparseTensorDenseMatMulFunctor<CPUDevice, T, Tindices, ADJ_A, ADJ_B> {
       // is only used if Tsum == T.
       auto out_workaround =
           *reinterpret_cast<typename TTypes<Tsum>::Matrix*>(&out);
-      TF_RETURN_IF_ERROR(
-          SparseTensorDenseMatMulImpl<T, Tsum, Tindices, ADJ_A, ADJ_B>(
-              out_workaround, a_indices, a_values, b));
+      if (use_parallel_impl) {
+        TF_RETURN_IF_ERROR((
+            SparseTensorDenseMatMulParallelImpl<T, Tsum, Tindices, ADJ_A,
+                                                ADJ_B>(
+                worker_threads, out_workaround, a_indices, a_values, b)));
+      } else {
+        TF_RETURN_IF_ERROR(
+            SparseTensorDenseMatMulImpl<T, Tsum, Tindices, ADJ_A, ADJ_B>(
+                out_workaround, a_indices, a_values, b));
+      }
     }
     return OkStatus();
   }
@@ -21,6 +21,7 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/op_requires.h"
+#include "tensorflow/core/kernels/packed_strings.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/types.h"
 
@@ -139,8 +140,11 @@ class StringNGramsOp : public tensorflow::OpKernel {
             0, TensorShape({ngrams_splits_data[num_batch_items]}), &ngrams));
     auto ngrams_data = ngrams->flat<tstring>().data();
 
+    // Every token is read by up to sum(ngram_widths) ngrams, so pack them
+    // once into contiguous memory instead of chasing a pointer per read.
+    const PackedStrings tokens(input_data, input_data_size);
     for (int i = 0; i < num_batch_items; ++i) {
-      auto data_start = &input_data[splits_vec(i)];
+      const int64_t data_start = splits_vec(i);
       int output_start_idx = ngrams_splits_data[i];
       for (int ngram_width : ngram_widths_) {
         auto output_start = &ngrams_data[output_start_idx];
@@ -148,7 +152,8 @@ class StringNGramsOp : public tensorflow::OpKernel {
         auto ngrams_or = get_num_ngrams(length, ngram_width);
         OP_REQUIRES_OK(context, ngrams_or.status());
         int num_ngrams = ngrams_or.ValueOrDie();
-        CreateNgrams(data_start, output_start, num_ngrams, ngram_width);
+        CreateNgrams(tokens, data_start, output_start, num_ngrams,
+                     ngram_width);
         output_start_idx += num_ngrams;
       }
       // If we're preserving short sequences, check to see if no sequence was
@@ -179,20 +184,24 @@ class StringNGramsOp : public tensorflow::OpKernel {
         int ngram_width = data_length + 2 * pad_width_;
         auto output_start = &ngrams_data[output_start_idx];
         int num_ngrams = 1;
-        CreateNgrams(data_start, output_start, num_ngrams, ngram_width);
+        CreateNgrams(tokens, data_start, output_start, num_ngrams,
+                     ngram_width);
       }
     }
   }
 
-  void CreateNgrams(const tstring* data, tstring* output, int num_ngrams,
-                    int ngram_width) const {
+  // Writes the ngrams of the sequence of tokens that starts at
+  // `tokens[data_start]`.
+  void CreateNgrams(const PackedStrings& tokens, int64_t data_start,
+                    tstring* output, int num_ngrams, int ngram_width) const {
     for (int ngram_index = 0; ngram_index < num_ngrams; ++ngram_index) {
       int pad_width = get_pad_width(ngram_width);
       int left_padding = std::max(0, pad_width - ngram_index);
       int right_padding =
           std::max(0, pad_width - (num_ngrams - (ngram_index + 1)));
       int num_tokens = ngram_width - (left_padding + right_padding);
-      int data_start_index = left_padding > 0 ? 0 : ngram_index - pad_width;
+      int64_t data_start_index =
+          data_start + (left_padding > 0 ? 0 : ngram_index - pad_width);
 
       // Calculate the total expected size of the ngram so we can reserve the
       // correct amount of space in the string.
@@ -200,9 +209,8 @@ class StringNGramsOp : public tensorflow::OpKernel {
       // Size of the left padding.
       ngram_size += left_padding * left_pad_.length();
       // Size of the tokens.
-      for (int n = 0; n < num_tokens; ++n) {
-        ngram_size += data[data_start_index + n].length();
-      }
+      ngram_size +=
+          tokens.total_length(data_start_index, data_start_index + num_tokens);
       // Size of the right padding.
       ngram_size += right_padding * right_pad_.length();
       // Size of the separators.
@@ -218,7 +226,8 @@ class StringNGramsOp : public tensorflow::OpKernel {
       }
       // Only output first num_tokens - 1 pairs of data and separator
       for (int n = 0; n < num_tokens - 1; ++n) {
-        ngram->append(data[data_start_index + n]);
+        const StringPiece token = tokens[data_start_index + n];
+        ngram->append(token.data(), token.size());
         ngram->append(separator_);
       }
       // Handle case when there are no tokens or no right padding as these can
@@ -227,7 +236,8 @@ class StringNGramsOp : public tensorflow::OpKernel {
         // If we have tokens, then output last and then pair each separator with
         // the right padding that follows, to ensure ngram ends either with the
         // token or with the right pad.
-        ngram->append(data[data_start_index + num_tokens - 1]);
+        const StringPiece token = tokens[data_start_index + num_tokens - 1];
+        ngram->append(token.data(), token.size());
         for (int n = 0; n < right_padding; ++n) {
           ngram->append(separator_);
           ngram->append(right_pad_);
@@ -23,6 +23,8 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/prefetch.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -44,18 +46,41 @@ class StringToHashBucketOp : public OpKernel {
                                             &output_tensor));
     auto output_flat = output_tensor->flat<int64_t>();
 
-    typedef decltype(input_flat.size()) Index;
-    for (Index i = 0; i < input_flat.size(); ++i) {
-      const uint64 input_hash = hash(input_flat(i));
-      const uint64 bucket_id = input_hash % num_buckets_;
-      // The number of buckets is always in the positive range of int64 so is
-      // the resulting bucket_id. Casting the bucket_id from uint64 to int64 is
-      // safe.
-      output_flat(i) = static_cast<int64_t>(bucket_id);
-    }
+    const tstring* input = input_flat.data();
+    int64_t* output = output_flat.data();
+    const uint64 num_buckets = num_buckets_;
+    auto hash_range = [input, output, num_buckets](int64_t start,
+                                                   int64_t limit) {
+      for (int64_t i = start; i < limit; ++i) {
+        // Strings that do not fit in the tstring itself live in their own
+        // allocation, so fetch the bytes of a later string while this one is
+        // hashed. The tstring headers are contiguous and are prefetched by
+        // the hardware.
+        if (i + kPrefetchDistance < limit) {
+          port::prefetch<port::PREFETCH_HINT_T0>(
+              input[i + kPrefetchDistance].data());
+        }
+        const uint64 input_hash = hash(input[i]);
+        const uint64 bucket_id = input_hash % num_buckets;
+        // The number of buckets is always in the positive range of int64 so
+        // is the resulting bucket_id. Casting the bucket_id from uint64 to
+        // int64 is safe.
+        output[i] = static_cast<int64_t>(bucket_id);
+      }
+    };
+    // Shard runs small batches inline on the calling thread.
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers,
+          input_flat.size(), kCostPerString, hash_range);
   }
 
  private:
+  // How many strings ahead of the one being hashed to prefetch.
+  static constexpr int kPrefetchDistance = 8;
+  // Approximate number of cycles to hash a short string and find its bucket.
+  static constexpr int64_t kCostPerString = 100;
+
   int64_t num_buckets_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(StringToHashBucketOp);
@@ -20,14 +20,19 @@ limitations under the License.
 #include "tensorflow/core/kernels/topk_op.h"
 
 #include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
 #include <numeric>
 #include <vector>
+
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/radix_sort.h"
 #include "tensorflow/core/lib/gtl/top_n.h"
 #include "tensorflow/core/util/work_sharder.h"
 
@@ -109,6 +114,54 @@ class TopK : public OpKernel {
 
 namespace functor {
 
+// Rows with at least this many columns, and more than k, are first filtered
+// with a threshold, and only the columns that pass it are pushed to the heap.
+constexpr int64_t kMinColsToFilter = 4096;
+// The minimum number of columns filtered by each thread when a row is
+// filtered over the intra-op threads.
+constexpr int64_t kMinColsPerFilterShard = 1 << 16;
+// Rows with at least this many columns, all of which are selected, are each
+// radix sorted over the intra-op threads when there are few rows.
+constexpr int64_t kMinColsToSortInParallel = 1 << 17;
+
+// Sets `*threshold` to a value such that at least k of the `num_cols` values
+// of `row` are not less than it: the k-th largest value of an evenly strided
+// sample of the row. Returns false if the sample has a NaN, in which case the
+// row should not be filtered.
+template <typename T>
+bool TopKThreshold(const T* row, int64_t num_cols, int k, T* threshold) {
+  // The sample size balances the cost of sampling against the number of
+  // columns that pass the threshold, which is about num_cols * k / size.
+  const int64_t sample_size = std::min<int64_t>(
+      num_cols,
+      std::max<int64_t>(4 * k, std::sqrt(static_cast<double>(num_cols) * k)));
+  if (sample_size < k) return false;
+  const int64_t stride = num_cols / sample_size;
+  std::vector<T> sample(sample_size);
+  for (int64_t i = 0; i < sample_size; ++i) {
+    sample[i] = row[i * stride];
+    if (Eigen::numext::isnan(sample[i])) return false;
+  }
+  std::nth_element(sample.begin(), sample.begin() + (k - 1), sample.end(),
+                   std::greater<T>());
+  *threshold = sample[k - 1];
+  return true;
+}
+
+// Writes the columns in [begin, end) of `row` whose value is not less than
+// `threshold` to `candidates`, in increasing order, and returns their number.
+// The loop has no data-dependent branch, so it vectorizes into compares.
+template <typename T>
+int64_t FilterTopKCandidates(const T* row, int64_t begin, int64_t end,
+                             T threshold, int32* candidates) {
+  int64_t n = 0;
+  for (int64_t c = begin; c < end; ++c) {
+    candidates[n] = c;
+    n += !(row[c] < threshold);
+  }
+  return n;
+}
+
 template <typename T>
 struct TopKFunctor<CPUDevice, T> {
   static EIGEN_ALWAYS_INLINE Status Compute(
@@ -141,19 +194,111 @@ struct TopKFunctor<CPUDevice, T> {
       return OkStatus();
     }
 
+    // Writes the top k columns of row b, among the candidate columns that
+    // `for_each_candidate(fn)` passes to `fn` in increasing order, to
+    // `indices`. The candidates must include the top k columns of the row.
+    auto SelectTopK = [&](int64_t b, const auto& for_each_candidate) {
+      const T* input_data = &input(b, 0);
+      const auto stable_comp = [input_data](const int32_t a, const int32_t b) {
+        if (input_data[b] < input_data[a]) {
+          return true;
+        } else if (input_data[b] > input_data[a]) {
+          return false;
+        } else {
+          return a < b;
+        }
+      };
+      // Use the TopN heap object to sort.
+      gtl::TopN<int32, decltype(stable_comp)> filter(k, stable_comp);
+      filter.reserve(num_cols);
+      for_each_candidate([&filter](int32_t c) { filter.push(c); });
+
+      int32_t i = 0;
+      if (sorted) {
+        std::unique_ptr<std::vector<int32>> top_k(filter.Extract());
+        for (auto top_k_it = top_k->begin(); top_k_it != top_k->end();
+             ++top_k_it, ++i) {
+          indices(b, i) = *top_k_it;
+        }
+      } else {
+        for (auto top_k_it = filter.unsorted_begin();
+             top_k_it != filter.unsorted_end(); ++top_k_it, ++i) {
+          indices(b, i) = *top_k_it;
+        }
+      }
+    };
+
+    // Copies the values of the top k columns of row b, in the order of
+    // `indices`.
+    auto CopyValues = [&](int64_t b) {
+      std::transform(&indices(b, 0), &indices(b, k), &values(b, 0),
+                     [b, &input](const int32_t loc) { return input(b, loc); });
+    };
+
+    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    const bool filter_rows = k < num_cols && num_cols >= kMinColsToFilter;
+
+    // A few long rows are each filtered over the intra-op threads, since
+    // filtering is most of the work.
+    if (filter_rows && num_rows < worker_threads.num_threads &&
+        num_cols >= 2 * kMinColsPerFilterShard) {
+      std::unique_ptr<int32[]> candidates(new int32[num_cols]);
+      const int64_t num_shards = num_cols / kMinColsPerFilterShard;
+      std::vector<int64_t> num_shard_candidates(num_shards);
+      for (int64_t b = 0; b < num_rows; ++b) {
+        const T* input_data = &input(b, 0);
+        T threshold;
+        if (!TopKThreshold(input_data, num_cols, k, &threshold)) {
+          SelectTopK(b, [&](const auto& fn) {
+            for (int32_t c = 0; c < num_cols; ++c) fn(c);
+          });
+          CopyValues(b);
+          continue;
+        }
+        // Shard s filters the columns [s * num_cols / num_shards,
+        // (s + 1) * num_cols / num_shards) into the same range of
+        // `candidates`.
+        Shard(worker_threads.num_threads, worker_threads.workers, num_shards,
+              kMinColsPerFilterShard * 4, [&](int64_t begin, int64_t end) {
+                for (int64_t s = begin; s < end; ++s) {
+                  const int64_t col_begin = s * num_cols / num_shards;
+                  const int64_t col_end = (s + 1) * num_cols / num_shards;
+                  num_shard_candidates[s] =
+                      FilterTopKCandidates(input_data, col_begin, col_end,
+                                           threshold, &candidates[col_begin]);
+                }
+              });
+        SelectTopK(b, [&](const auto& fn) {
+          for (int64_t s = 0; s < num_shards; ++s) {
+            const int32* shard_candidates =
+                &candidates[s * num_cols / num_shards];
+            for (int64_t i = 0; i < num_shard_candidates[s]; ++i) {
+              fn(shard_candidates[i]);
+            }
+          }
+        });
+        CopyValues(b);
+      }
+      return OkStatus();
+    }
+
+    // A few long rows are each sorted over the intra-op threads.
+    if (k == num_cols && num_rows < worker_threads.num_threads &&
+        num_cols >= kMinColsToSortInParallel) {
+      for (int64_t b = 0; b < num_rows; ++b) {
+        std::iota(&indices(b, 0), &indices(b, k), 0);
+        RadixSortByKey<T>(worker_threads.workers, num_cols, &input(b, 0),
+                          &indices(b, 0), /*descending=*/true);
+        CopyValues(b);
+      }
+      return OkStatus();
+    }
+
     auto SortIndices = [&](int64_t start_batch, int64_t limit_batch) {
+      std::unique_ptr<int32[]> candidates;
+      if (filter_rows) candidates.reset(new int32[num_cols]);
       for (int32_t b = start_batch; b < limit_batch; ++b) {
         const T* input_data = &input(b, 0);
-        const auto stable_comp = [input_data](const int32_t a,
-                                              const int32_t b) {
-          if (input_data[b] < input_data[a]) {
-            return true;
-          } else if (input_data[b] > input_data[a]) {
-            return false;
-          } else {
-            return a < b;
-          }
-        };
         const auto comp = [input_data](const int32_t a, const int32_t b) {
           return input_data[b] < input_data[a];
         };
@@ -162,11 +307,19 @@ struct TopKFunctor<CPUDevice, T> {
         // values 0..num_cols - 1 and then use std::partial_sort_copy
         // of this into indices. Choosing the appropriate minimum k or
         // ratio of k/num_cols will require some experimentation.
+        T threshold;
         if (k == num_cols) {
           auto* begin = &indices(b, 0);
           auto* end = &indices(b, k);
           // Set the initial array of indices 0 ... k - 1.
           std::iota(begin, end, 0);
+          if (num_cols >= kMinRadixSortSize) {
+            // A stable descending sort orders equal values by index.
+            RadixSortByKey<T>(/*pool=*/nullptr, num_cols, input_data, begin,
+                              /*descending=*/true);
+            CopyValues(b);
+            continue;
+          }
           // We want an in-place sort, but we can cheat because we're sorting
           // indices that started out sorted.  First, do a std::sort, which
           // is notably faster than std::stable_sort.
@@ -184,33 +337,22 @@ struct TopKFunctor<CPUDevice, T> {
             }
             run_begin = run_end;
           }
+        } else if (filter_rows &&
+                   TopKThreshold(input_data, num_cols, k, &threshold)) {
+          // Only the columns that can be in the top k are pushed to the heap.
+          const int64_t num_candidates = FilterTopKCandidates(
+              input_data, 0, num_cols, threshold, candidates.get());
+          SelectTopK(b, [&](const auto& fn) {
+            for (int64_t i = 0; i < num_candidates; ++i) fn(candidates[i]);
+          });
         } else {
-          // Use the TopN heap object to sort.
-          gtl::TopN<int32, decltype(stable_comp)> filter(k, stable_comp);
-          filter.reserve(num_cols);
-          for (int32_t c = 0; c < num_cols; ++c) {
-            filter.push(c);
-          }
-
-          int32_t i = 0;
-          if (sorted) {
-            std::unique_ptr<std::vector<int32>> top_k(filter.Extract());
-            for (auto top_k_it = top_k->begin(); top_k_it != top_k->end();
-                 ++top_k_it, ++i) {
-              indices(b, i) = *top_k_it;
-            }
-          } else {
-            for (auto top_k_it = filter.unsorted_begin();
-                 top_k_it != filter.unsorted_end(); ++top_k_it, ++i) {
-              indices(b, i) = *top_k_it;
-            }
-          }
+          SelectTopK(b, [&](const auto& fn) {
+            for (int32_t c = 0; c < num_cols; ++c) fn(c);
+          });
         }
         // Now that the indices are sorted, copy the values over in
         // sorted order.
-        std::transform(
-            &indices(b, 0), &indices(b, k), &values(b, 0),
-            [b, &input](const int32_t loc) { return input(b, loc); });
+        CopyValues(b);
       }  // for (int32 b = ...
     };
 
@@ -228,7 +370,6 @@ struct TopKFunctor<CPUDevice, T> {
     const int64_t final_cost = (total_cost >= static_cast<double>(kint64max))
                                    ? kint64max
                                    : static_cast<int64_t>(total_cost);
-    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
     Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
           final_cost, SortIndices);
 
@@ -17,6 +17,8 @@ limitations under the License.
 #include "tensorflow/core/kernels/training_ops.h"
 
 #include <algorithm>  // NOLINT
+#include <numeric>
+#include <vector>
 
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -40,6 +42,51 @@ inline T sgn(const T x) {
   T one(1);
   return (x == zero ? zero : (x < zero ? -one : one));
 }
+
+// Calls `fn(i)` for every position i of `indices`, over the threads of `d`.
+// The positions are split into shards by the index they hold, and each shard
+// is processed by one thread in increasing order of position. Concurrent
+// calls therefore never update the same row, and the updates for a
+// duplicated index are applied in the same order as in a serial loop, so the
+// result is deterministic without any locking. `cost` is the cost of one
+// call. All of the indices must be in range.
+template <typename Tindex, typename Fn>
+void ParallelForEachIndex(const CPUDevice& d,
+                          typename TTypes<Tindex>::ConstVec indices,
+                          const Eigen::TensorOpCost& cost, const Fn& fn) {
+  const Tindex N = static_cast<Tindex>(indices.dimension(0));
+  // More shards than threads balance the load when some rows are hot.
+  const int64_t num_shards =
+      std::min<int64_t>(N, 4 * static_cast<int64_t>(d.numThreads()));
+  if (d.numThreads() <= 1 || num_shards <= 1) {
+    for (Tindex i = 0; i < N; ++i) fn(i);
+    return;
+  }
+  auto shard_of = [&](Tindex i) {
+    return static_cast<uint64>(internal::SubtleMustCopy(indices(i))) %
+           num_shards;
+  };
+  // Sorts the positions by shard, keeping their order within each shard.
+  std::vector<Tindex> shard_begin(num_shards + 1, 0);
+  for (Tindex i = 0; i < N; ++i) ++shard_begin[shard_of(i) + 1];
+  for (int64_t s = 0; s < num_shards; ++s) {
+    shard_begin[s + 1] += shard_begin[s];
+  }
+  std::vector<Tindex> order(N);
+  {
+    std::vector<Tindex> next(shard_begin.begin(), shard_begin.end() - 1);
+    for (Tindex i = 0; i < N; ++i) order[next[shard_of(i)]++] = i;
+  }
+  d.parallelFor(num_shards, cost * (static_cast<double>(N) / num_shards),
+                [&](Index start, Index end) {
+                  for (Index s = start; s < end; ++s) {
+                    for (Tindex k = shard_begin[s]; k < shard_begin[s + 1];
+                         ++k) {
+                      fn(order[k]);
+                    }
+                  }
+                });
+}
 }  // namespace
 
 namespace functor {
@@ -191,24 +238,20 @@ struct SparseApplyAdagrad<CPUDevice, T, Tindex, has_epsilon> {
         }
       }
 
-      const auto shard = [&](Tindex start_idx, Tindex end_idx) -> void {
-        for (Tindex i = start_idx; i < end_idx; ++i) {
-          const Tindex index = internal::SubtleMustCopy(indices(i));
-          auto a = accum.template chip<0>(index);
-          auto g = grad.template chip<0>(i);
-          auto v = var.template chip<0>(index);
-          if (update_slots) {
-            a += g.square();
-          }
-          if (has_epsilon) {
-            v -= g.constant(lr_scalar) * g / (a.sqrt() + a.constant(epsilon()));
-          } else {
-            v -= g.constant(lr_scalar) * g * a.rsqrt();
-          }
+      ParallelForEachIndex<Tindex>(d, indices, cost, [&](Tindex i) {
+        const Tindex index = internal::SubtleMustCopy(indices(i));
+        auto a = accum.template chip<0>(index);
+        auto g = grad.template chip<0>(i);
+        auto v = var.template chip<0>(index);
+        if (update_slots) {
+          a += g.square();
         }
-      };
-
-      d.parallelFor(N, cost, shard);
+        if (has_epsilon) {
+          v -= g.constant(lr_scalar) * g / (a.sqrt() + a.constant(epsilon()));
+        } else {
+          v -= g.constant(lr_scalar) * g * a.rsqrt();
+        }
+      });
     } else {
       for (Tindex i = 0; i < N; ++i) {
         const Tindex index = internal::SubtleMustCopy(indices(i));
@@ -219,23 +262,19 @@ struct SparseApplyAdagrad<CPUDevice, T, Tindex, has_epsilon> {
         }
       }
 
-      const auto shard = [&](Tindex start_idx, Tindex end_idx) -> void {
-        for (Tindex i = start_idx; i < end_idx; ++i) {
-          const Tindex index = internal::SubtleMustCopy(indices(i));
-          T& a = accum(index);
-          const T& g = grad(i);
-          if (update_slots) {
-            a += g * g;
-          }
-          if (has_epsilon) {
-            var(index) -= lr_scalar * g / (Eigen::numext::sqrt(a) + epsilon());
-          } else {
-            var(index) -= lr_scalar * g / Eigen::numext::sqrt(a);
-          }
+      ParallelForEachIndex<Tindex>(d, indices, cost, [&](Tindex i) {
+        const Tindex index = internal::SubtleMustCopy(indices(i));
+        T& a = accum(index);
+        const T& g = grad(i);
+        if (update_slots) {
+          a += g * g;
         }
-      };
-
-      d.parallelFor(N, cost, shard);
+        if (has_epsilon) {
+          var(index) -= lr_scalar * g / (Eigen::numext::sqrt(a) + epsilon());
+        } else {
+          var(index) -= lr_scalar * g / Eigen::numext::sqrt(a);
+        }
+      });
     }
 
     return OkStatus();
@@ -286,14 +325,22 @@ struct SparseApplyProximalAdagrad<CPUDevice, T, Tindex> {
     const T lr_scalar = lr();
     const T l1_scalar = l1();
     const T l2_scalar = l2();
+    for (Tindex i = 0; i < N; i++) {
+      const Tindex index = internal::SubtleMustCopy(indices(i));
+      if (!FastBoundsCheck(index, first_dim_size)) {
+        return errors::InvalidArgument(
+            strings::StrCat("Index ", index, " at offset ", i,
+                            " in indices is out of range"));
+      }
+    }
+    const Eigen::TensorOpCost cost(
+        inner_dim * sizeof(T) * 3, inner_dim * sizeof(T) * 2,
+        inner_dim * (Eigen::TensorOpCost::AddCost<T>() * 4 +
+                     Eigen::TensorOpCost::MulCost<T>() * 6 +
+                     Eigen::TensorOpCost::DivCost<T>() * 2));
     if (inner_dim > 1) {
-      for (Tindex i = 0; i < N; i++) {
+      ParallelForEachIndex<Tindex>(d, indices, cost, [&](Tindex i) {
         const Tindex index = internal::SubtleMustCopy(indices(i));
-        if (!FastBoundsCheck(index, first_dim_size)) {
-          return errors::InvalidArgument(
-              strings::StrCat("Index ", index, " at offset ", i,
-                              " in indices is out of range"));
-        }
         auto a = accum.template chip<0>(index);
         auto g = grad.template chip<0>(i);
         auto v = var.template chip<0>(index);
@@ -313,15 +360,10 @@ struct SparseApplyProximalAdagrad<CPUDevice, T, Tindex> {
           v = prox_v /
               (v.constant(1.0) + v.constant(l2_scalar) * learning_rate);
         }
-      }
+      });
     } else {
-      for (Tindex i = 0; i < N; i++) {
+      ParallelForEachIndex<Tindex>(d, indices, cost, [&](Tindex i) {
         const Tindex index = internal::SubtleMustCopy(indices(i));
-        if (!FastBoundsCheck(index, first_dim_size)) {
-          return errors::InvalidArgument(
-              strings::StrCat("Index ", index, " at offset ", i,
-                              " in indices is out of range"));
-        }
         T& a = accum(index);
         const T& g = grad(i);
         a += g * g;
@@ -336,7 +378,7 @@ struct SparseApplyProximalAdagrad<CPUDevice, T, Tindex> {
         } else {
           var(index) = prox_v / (1.0 + l2_scalar * learning_rate);
         }
-      }
+      });
     }
     return OkStatus();
   }
@@ -608,17 +650,24 @@ struct SparseApplyFtrl<CPUDevice, T, Tindex, has_l2_shrinkage> {
         l2_shrinkage_scalar = l2_shrinkage();
       }
       T lr_power_scalar = lr_power();
+      const Tindex first_dim_size = static_cast<Tindex>(var_flat.dimension(0));
+      for (Tindex i = 0; i < N; i++) {
+        const Tindex index = internal::SubtleMustCopy(indices_vec(i));
+        if (!FastBoundsCheck(index, first_dim_size)) {
+          return errors::InvalidArgument(
+              strings::StrCat("Index ", index, " at offset ", i,
+                              " in indices is out of range"));
+        }
+      }
+      // The two pows per element dominate the cost of the update.
+      const Eigen::TensorOpCost cost(
+          inner_dim * sizeof(T) * 4, inner_dim * sizeof(T) * 3,
+          inner_dim * (Eigen::TensorOpCost::AddCost<T>() * 6 +
+                       Eigen::TensorOpCost::MulCost<T>() * 40 +
+                       Eigen::TensorOpCost::DivCost<T>() * 2));
       if (inner_dim > 1) {
-        const Tindex first_dim_size =
-            static_cast<Tindex>(var_flat.dimension(0));
-
-        for (Tindex i = 0; i < N; i++) {
+        ParallelForEachIndex<Tindex>(d, indices_vec, cost, [&](Tindex i) {
           const Tindex index = internal::SubtleMustCopy(indices_vec(i));
-          if (!FastBoundsCheck(index, first_dim_size)) {
-            return errors::InvalidArgument(
-                strings::StrCat("Index ", index, " at offset ", i,
-                                " in indices is out of range"));
-          }
           auto accum = accum_flat.template chip<0>(index);
           auto linear = linear_flat.template chip<0>(index);
           auto grad = grad_flat.template chip<0>(i);
@@ -642,17 +691,10 @@ struct SparseApplyFtrl<CPUDevice, T, Tindex, has_l2_shrinkage> {
                         /*lr_power_scalar=*/lr_power_scalar,
                         /*lr_scalar=*/lr_scalar);
           }
-        }
+        });
       } else {
-        const Tindex first_dim_size = accum_flat.size();
-
-        for (Tindex i = 0; i < N; i++) {
+        ParallelForEachIndex<Tindex>(d, indices_vec, cost, [&](Tindex i) {
           const Tindex index = internal::SubtleMustCopy(indices_vec(i));
-          if (!FastBoundsCheck(index, first_dim_size)) {
-            return errors::InvalidArgument(
-                strings::StrCat("Index ", index, " at offset ", i,
-                                " in indices is out of range"));
-          }
           T& a = accum_flat(index);
           T& l = linear_flat(index);
           T& v = var_flat(index);
@@ -676,7 +718,7 @@ struct SparseApplyFtrl<CPUDevice, T, Tindex, has_l2_shrinkage> {
                           lr_power_scalar, multiply_linear_by_lr);
           a = updated_a;
           l = updated_l;
-        }
+        });
       }
     }
     return OkStatus();
@@ -3654,6 +3696,160 @@ REGISTER_KERNELS(GPU, complex128);
 #undef REGISTER_CPU_KERNELS
 #undef REGISTER_KERNELS
 
+// Applies Adam to N resource variables that share their hyperparameters. The
+// updates of all of the variables are split into chunks of about the same
+// size, which run in a single parallelFor, so that a model with many small
+// variables does not pay for a kernel and a parallelFor per variable.
+template <typename T>
+class MultiApplyAdamOp : public OpKernel {
+ public:
+  explicit MultiApplyAdamOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("N", &num_vars_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_nesterov", &use_nesterov_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    const bool sparse = false;
+    const int n = num_vars_;
+    std::vector<int> var_inputs(3 * n);
+    std::iota(var_inputs.begin(), var_inputs.end(), 0);
+    auto locks = MaybeLockVariableInputMutexesInOrder<CPUDevice, T>(
+        ctx, use_exclusive_lock_, sparse, var_inputs);
+
+    // The var, m and v tensors of variable i are at 3 * i, 3 * i + 1 and
+    // 3 * i + 2.
+    std::vector<Tensor> slots(3 * n);
+    for (int i = 0; i < 3 * n; ++i) {
+      const int input = (i % 3) * n + i / 3;
+      OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                              ctx, input, use_exclusive_lock_, sparse,
+                              &slots[i]));
+      OP_REQUIRES(ctx, slots[i].IsInitialized(),
+                  errors::FailedPrecondition(
+                      "Attempting to use uninitialized variables: ",
+                      requested_input(input)));
+    }
+
+    // The chunks of different variables are updated concurrently, so they
+    // must not share a buffer.
+    std::vector<const void*> buffers;
+    for (const Tensor& slot : slots) {
+      if (slot.NumElements() > 0) buffers.push_back(slot.tensor_data().data());
+    }
+    std::sort(buffers.begin(), buffers.end());
+    OP_REQUIRES(ctx,
+                std::adjacent_find(buffers.begin(), buffers.end()) ==
+                    buffers.end(),
+                errors::InvalidArgument("The variables and slots passed to ",
+                                        type_string(),
+                                        " must all be distinct"));
+
+    const char* const kScalarNames[] = {"beta1_power", "beta2_power",
+                                        "lr",          "beta1",
+                                        "beta2",       "epsilon"};
+    T scalars[6];
+    for (int i = 0; i < 6; ++i) {
+      const Tensor& scalar = ctx->input(3 * n + i);
+      OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(scalar.shape()),
+                  errors::InvalidArgument(kScalarNames[i], " is not a scalar: ",
+                                          scalar.shape().DebugString()));
+      scalars[i] = scalar.scalar<T>()();
+    }
+    const T beta1_power = scalars[0];
+    const T beta2_power = scalars[1];
+    const T alpha = scalars[2] * Eigen::numext::sqrt(T(1) - beta2_power) /
+                    (T(1) - beta1_power);
+    const T beta1 = scalars[3];
+    const T beta2 = scalars[4];
+    const T epsilon = scalars[5];
+
+    struct Chunk {
+      T* var;
+      T* m;
+      T* v;
+      const T* grad;
+      int64_t size;
+    };
+    std::vector<Chunk> chunks;
+    for (int i = 0; i < n; ++i) {
+      const Tensor& var = slots[3 * i];
+      const Tensor& grad = ctx->input(3 * n + 6 + i);
+      OP_REQUIRES(ctx, var.shape().IsSameSize(slots[3 * i + 1].shape()),
+                  errors::InvalidArgument(
+                      "var and m do not have the same shape",
+                      var.shape().DebugString(), " ",
+                      slots[3 * i + 1].shape().DebugString()));
+      OP_REQUIRES(ctx, var.shape().IsSameSize(slots[3 * i + 2].shape()),
+                  errors::InvalidArgument(
+                      "var and v do not have the same shape",
+                      var.shape().DebugString(), " ",
+                      slots[3 * i + 2].shape().DebugString()));
+      OP_REQUIRES(ctx, var.shape().IsSameSize(grad.shape()),
+                  errors::InvalidArgument(
+                      "var and grad do not have the same shape",
+                      var.shape().DebugString(), " ",
+                      grad.shape().DebugString()));
+      T* var_ptr = slots[3 * i].flat<T>().data();
+      T* m_ptr = slots[3 * i + 1].flat<T>().data();
+      T* v_ptr = slots[3 * i + 2].flat<T>().data();
+      const T* grad_ptr = grad.flat<T>().data();
+      const int64_t size = var.NumElements();
+      for (int64_t begin = 0; begin < size; begin += kChunkSize) {
+        chunks.push_back({var_ptr + begin, m_ptr + begin, v_ptr + begin,
+                          grad_ptr + begin,
+                          std::min(kChunkSize, size - begin)});
+      }
+    }
+
+    const bool use_nesterov = use_nesterov_;
+    auto apply_chunks = [&](int64_t first, int64_t last) {
+      for (int64_t c = first; c < last; ++c) {
+        const Chunk& chunk = chunks[c];
+        auto var = typename TTypes<T>::UnalignedTensor(chunk.var, chunk.size);
+        auto m = typename TTypes<T>::UnalignedTensor(chunk.m, chunk.size);
+        auto v = typename TTypes<T>::UnalignedTensor(chunk.v, chunk.size);
+        auto g =
+            typename TTypes<T>::UnalignedConstTensor(chunk.grad, chunk.size);
+        m += (g - m) * (T(1) - beta1);
+        v += (g.square() - v) * (T(1) - beta2);
+        if (use_nesterov) {
+          var -= ((g * (T(1) - beta1) + beta1 * m) * alpha) /
+                 (v.sqrt() + epsilon);
+        } else {
+          var -= (m * alpha) / (v.sqrt() + epsilon);
+        }
+      }
+    };
+    // Input data: var, v, m, grad. Output data: var, v, m.
+    const Eigen::TensorOpCost cost(
+        kChunkSize * sizeof(T) * 4, kChunkSize * sizeof(T) * 3,
+        kChunkSize * (Eigen::TensorOpCost::AddCost<T>() * 10 +
+                      Eigen::TensorOpCost::MulCost<T>() * 6 +
+                      Eigen::TensorOpCost::DivCost<T>()));
+    ctx->eigen_device<CPUDevice>().parallelFor(chunks.size(), cost,
+                                               apply_chunks);
+  }
+
+ private:
+  // The number of elements updated by one unit of parallel work.
+  static constexpr int64_t kChunkSize = 4096;
+
+  int num_vars_;
+  bool use_exclusive_lock_;
+  bool use_nesterov_;
+};
+
+#define REGISTER_CPU_KERNELS(T)                                \
+  REGISTER_KERNEL_BUILDER(Name("_MultiResourceApplyAdam")      \
+                              .Device(DEVICE_CPU)              \
+                              .TypeConstraint<T>("T"),         \
+                          MultiApplyAdamOp<T>);
+
+TF_CALL_FLOAT_TYPES(REGISTER_CPU_KERNELS);
+TF_CALL_COMPLEX_TYPES(REGISTER_CPU_KERNELS);
+#undef REGISTER_CPU_KERNELS
+
 template <typename Device, typename T>
 class ApplyAdamWithAmsgradOp : public OpKernel {
  public:
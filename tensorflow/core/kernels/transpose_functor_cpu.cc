@@ -16,6 +16,10 @@ limitations under the License.
 #define EIGEN_USE_THREADS
 
 #include <complex>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/attr_value.pb.h"
@@ -25,6 +29,12 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+#if !defined(IS_MOBILE_PLATFORM)
+#include "tensorflow/compiler/xla/pjrt/transpose.h"
+#endif  // !defined(IS_MOBILE_PLATFORM)
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 
@@ -68,12 +78,68 @@ void TransposeSimple(const CPUDevice& device, const Tensor& in,
   device.parallelFor(in.NumElements(), cost, std::move(transpose_fn));
 }
 
+#if !defined(IS_MOBILE_PLATFORM)
+// Below this many elements, a transpose is too cheap for the cost of looking
+// up its plan to pay off.
+constexpr int64_t kMinTransposePlanElements = 1024;
+
+// The number of transpose plans to keep, keyed by element size, shape,
+// permutation and number of threads.
+constexpr int kTransposePlanCacheCapacity = 64;
+
+// Transposes `in` into `out` with a cache-blocked plan from the XLA transpose
+// planner, which handles arbitrary permutations much closer to memory
+// bandwidth than an Eigen shuffle. Returns false, without touching `out`, if
+// the planner does not support the transpose.
+template <typename T>
+bool TransposeUsingPlan(const CPUDevice& d, const Tensor& in,
+                        const gtl::ArraySlice<int32> perm, Tensor* out) {
+  static mutex* mu = new mutex;
+  static xla::TransposePlanCache* cache TF_GUARDED_BY(*mu) =
+      new xla::TransposePlanCache(kTransposePlanCacheCapacity);
+
+  gtl::InlinedVector<int64_t, 8> dims(in.dims());
+  gtl::InlinedVector<int64_t, 8> permutation(perm.size());
+  for (int i = 0; i < in.dims(); ++i) {
+    dims[i] = in.dim_size(i);
+    permutation[i] = perm[i];
+  }
+  std::shared_ptr<xla::TransposePlan> plan;
+  {
+    mutex_lock l(*mu);
+    auto plan_or = cache->GetOrCreate(
+        sizeof(T), dims, permutation, xla::TransposePlan::Tiling{},
+        xla::TransposePlan::Tiling{}, xla::TransposePlan::Transformation::kNone,
+        d.numThreads());
+    if (!plan_or.ok()) {
+      VLOG(1) << "Falling back to Eigen for transpose: " << plan_or.status();
+      return false;
+    }
+    plan = std::move(plan_or).value();
+  }
+  plan->Execute(in.tensor_data().data(),
+                const_cast<char*>(out->tensor_data().data()),
+                [&d](std::function<void()> fn) {
+                  d.enqueueNoNotification(std::move(fn));
+                });
+  return true;
+}
+#endif  // !defined(IS_MOBILE_PLATFORM)
+
 }  // namespace
 
 template <typename T, bool conjugate>
 struct Transpose<CPUDevice, T, conjugate> {
   static void run(const CPUDevice& d, const Tensor& in,
                   const gtl::ArraySlice<int32> perm, Tensor* out) {
+#if !defined(IS_MOBILE_PLATFORM)
+    // The planner only moves bytes, so it cannot conjugate or copy strings.
+    if (!conjugate && std::is_trivially_copyable<T>::value &&
+        in.NumElements() >= kMinTransposePlanElements &&
+        TransposeUsingPlan<T>(d, in, perm, out)) {
+      return;
+    }
+#endif  // !defined(IS_MOBILE_PLATFORM)
     switch (in.dims()) {
       case 2:
         internal::TransposeUsingEigen<CPUDevice, T, 2>(d, in, perm, conjugate,
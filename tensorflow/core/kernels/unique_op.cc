@@ -13,9 +13,11 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <functional>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/framework/bounds_check.h"
@@ -26,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace {
@@ -68,6 +71,207 @@ struct UniqueOpHashMap<bfloat16, TIndex> {
   using map_type = std::unordered_map<bfloat16, TIndex>;
 };
 
+// Unique of a vector, split over the intra-op threads. The elements are
+// partitioned by hash so that equal elements fall in the same partition, each
+// partition is deduplicated on its own, and the unique elements are then
+// numbered in order of first occurrence, as in the serial implementation.
+//
+// Usage:
+//   ParallelUnique<T, TIndex> unique(worker_threads, input.vec<T>());
+//   const int64_t uniq_size = unique.Deduplicate(/*count=*/false);
+//   ... allocate the outputs for `uniq_size` unique elements ...
+//   unique.WriteOutputs(idx_vec, output_vec, /*count_output=*/nullptr);
+template <typename T, typename TIndex>
+class ParallelUnique {
+ public:
+  using MapType = typename UniqueOpHashMap<T, TIndex>::map_type;
+
+  // Inputs with fewer elements are deduplicated on the calling thread.
+  static constexpr int64_t kMinParallelSize = 1 << 17;
+
+  // Requires `worker_threads.num_threads > 1`.
+  ParallelUnique(const DeviceBase::CpuWorkerThreads& worker_threads,
+                 typename TTypes<T>::ConstVec input)
+      : worker_threads_(worker_threads), input_(input), size_(input.size()) {
+    DCHECK_GT(worker_threads_.num_threads, 1);
+    // More partitions than threads balance skewed partitions better.
+    while (num_partitions_ < 4 * worker_threads_.num_threads &&
+           num_partitions_ < kMaxPartitions) {
+      num_partitions_ *= 2;
+      ++partition_bits_;
+    }
+  }
+
+  // Deduplicates the input, also counting the occurrences of each unique
+  // element if `count` is true, and returns the number of unique elements.
+  int64_t Deduplicate(bool count) {
+    PartitionElements();
+    DeduplicatePartitions(count);
+    return NumberUniqueElements();
+  }
+
+  // Writes the index of the unique element of every input element to `idx`,
+  // the unique elements to `output`, and, if `Deduplicate(true)` was called,
+  // their number of occurrences to `*count_output`.
+  void WriteOutputs(typename TTypes<TIndex>::Vec idx,
+                    typename TTypes<T>::Vec output,
+                    typename TTypes<TIndex>::Vec* count_output) {
+    ForEachPartition([&](int p) {
+      const std::vector<int32>& first = first_occurrence_[p];
+      for (int32 k = partition_begin_[p]; k < partition_begin_[p + 1]; ++k) {
+        idx(order_[k]) = rank_[first[local_id_[k]]];
+      }
+      for (size_t j = 0; j < first.size(); ++j) {
+        const int32 rank = rank_[first[j]];
+        output(rank) = input_(first[j]);
+        if (count_output != nullptr) {
+          (*count_output)(rank) = counts_[p][j];
+        }
+      }
+    });
+  }
+
+ private:
+  static constexpr int kMaxPartitions = 256;
+  static constexpr int64_t kBlockSize = 1 << 14;
+
+  int64_t num_blocks() const { return (size_ + kBlockSize - 1) / kBlockSize; }
+
+  void ForEachBlock(const std::function<void(int64_t)>& fn) {
+    Shard(worker_threads_.num_threads, worker_threads_.workers, num_blocks(),
+          /*cost_per_unit=*/kBlockSize * 50, [&](int64_t begin, int64_t end) {
+            for (int64_t b = begin; b < end; ++b) fn(b);
+          });
+  }
+
+  void ForEachPartition(const std::function<void(int)>& fn) {
+    const int64_t cost_per_partition = size_ / num_partitions_ * 200;
+    Shard(worker_threads_.num_threads, worker_threads_.workers,
+          num_partitions_, cost_per_partition,
+          [&](int64_t begin, int64_t end) {
+            for (int64_t p = begin; p < end; ++p) fn(p);
+          });
+  }
+
+  int PartitionOf(int64_t i) const {
+    const uint64 hash =
+        typename MapType::hasher()(typename MapType::key_type(input_(i)));
+    // The maps use the low bits of the hash, so the partition is taken from
+    // the high bits of a multiplicative hash of it.
+    return (hash * 0x9E3779B97F4A7C15ULL) >> (64 - partition_bits_);
+  }
+
+  // Fills `order_` with the positions of the elements grouped by partition,
+  // in increasing order within each partition.
+  void PartitionElements() {
+    partition_.resize(size_);
+    std::vector<int32> block_offsets(num_blocks() * num_partitions_, 0);
+    ForEachBlock([&](int64_t b) {
+      int32* counts = &block_offsets[b * num_partitions_];
+      const int64_t end = std::min(size_, (b + 1) * kBlockSize);
+      for (int64_t i = b * kBlockSize; i < end; ++i) {
+        partition_[i] = PartitionOf(i);
+        ++counts[partition_[i]];
+      }
+    });
+    // Turns the counts into the offset of each block in each partition.
+    partition_begin_.resize(num_partitions_ + 1);
+    int32 offset = 0;
+    for (int p = 0; p < num_partitions_; ++p) {
+      partition_begin_[p] = offset;
+      for (int64_t b = 0; b < num_blocks(); ++b) {
+        const int32 count = block_offsets[b * num_partitions_ + p];
+        block_offsets[b * num_partitions_ + p] = offset;
+        offset += count;
+      }
+    }
+    partition_begin_[num_partitions_] = offset;
+    order_.resize(size_);
+    ForEachBlock([&](int64_t b) {
+      int32* offsets = &block_offsets[b * num_partitions_];
+      const int64_t end = std::min(size_, (b + 1) * kBlockSize);
+      for (int64_t i = b * kBlockSize; i < end; ++i) {
+        order_[offsets[partition_[i]]++] = i;
+      }
+    });
+  }
+
+  // Deduplicates each partition, recording the local id of every element and
+  // the position of the first occurrence of every unique element.
+  void DeduplicatePartitions(bool count) {
+    local_id_.resize(size_);
+    is_first_.assign(size_, 0);
+    first_occurrence_.resize(num_partitions_);
+    counts_.resize(num_partitions_);
+    ForEachPartition([&](int p) {
+      std::vector<int32>& first = first_occurrence_[p];
+      std::vector<int32>& counts = counts_[p];
+      MapType uniq;
+      uniq.reserve(2 * (partition_begin_[p + 1] - partition_begin_[p]));
+      for (int32 k = partition_begin_[p]; k < partition_begin_[p + 1]; ++k) {
+        const int32 i = order_[k];
+        auto it = uniq.emplace(input_(i), first.size());
+        local_id_[k] = it.first->second;
+        if (it.second) {
+          first.push_back(i);
+          is_first_[i] = 1;
+          if (count) counts.push_back(0);
+        }
+        if (count) ++counts[local_id_[k]];
+      }
+    });
+  }
+
+  // Numbers the first occurrences by position, and returns their number.
+  int64_t NumberUniqueElements() {
+    rank_.resize(size_);
+    std::vector<int32> block_offsets(num_blocks() + 1, 0);
+    ForEachBlock([&](int64_t b) {
+      const int64_t end = std::min(size_, (b + 1) * kBlockSize);
+      int32 count = 0;
+      for (int64_t i = b * kBlockSize; i < end; ++i) {
+        count += is_first_[i];
+      }
+      block_offsets[b + 1] = count;
+    });
+    for (int64_t b = 0; b < num_blocks(); ++b) {
+      block_offsets[b + 1] += block_offsets[b];
+    }
+    ForEachBlock([&](int64_t b) {
+      const int64_t end = std::min(size_, (b + 1) * kBlockSize);
+      int32 rank = block_offsets[b];
+      for (int64_t i = b * kBlockSize; i < end; ++i) {
+        if (is_first_[i]) rank_[i] = rank++;
+      }
+    });
+    return block_offsets[num_blocks()];
+  }
+
+  const DeviceBase::CpuWorkerThreads& worker_threads_;
+  typename TTypes<T>::ConstVec input_;
+  const int64_t size_;
+  int num_partitions_ = 1;
+  int partition_bits_ = 0;
+
+  // The partition of each element.
+  std::vector<uint8> partition_;
+  // The positions of the elements of partition p are order_[k] for k in
+  // [partition_begin_[p], partition_begin_[p + 1]).
+  std::vector<int32> partition_begin_;
+  std::vector<int32> order_;
+  // The id of element order_[k] among the unique elements of its partition.
+  std::vector<int32> local_id_;
+  // The positions of the first occurrences of the unique elements of each
+  // partition, by local id, and their number of occurrences.
+  std::vector<std::vector<int32>> first_occurrence_;
+  std::vector<std::vector<int32>> counts_;
+  // Whether each element is the first occurrence of its value, and if so its
+  // index among the unique elements. A byte per element, so that partitions
+  // can set them concurrently.
+  std::vector<uint8> is_first_;
+  std::vector<int32> rank_;
+};
+
 // `UniqueOp` computes the unique elements in the input tensor.
 //
 // * `T` is the element type.
@@ -143,7 +347,33 @@ class UniqueOp : public OpKernel {
     auto idx_vec = idx->template vec<TIndex>();
 
     int64_t uniq_size;
-    if (new_sizes[0] == 1 && new_sizes[2] == 1) {
+    const auto* worker_threads =
+        context->device()->tensorflow_cpu_worker_threads();
+    if (new_sizes[0] == 1 && new_sizes[2] == 1 && worker_threads != nullptr &&
+        worker_threads->num_threads > 1 &&
+        new_sizes[1] >= ParallelUnique<T, TIndex>::kMinParallelSize) {
+      // Large vectors are deduplicated in parallel.
+      ParallelUnique<T, TIndex> unique(*worker_threads, input.flat<T>());
+      const bool count = num_outputs() > 2;
+      uniq_size = unique.Deduplicate(count);
+      TensorShape output_shape(input.shape());
+      output_shape.set_dim(axis, uniq_size);
+      Tensor* output = nullptr;
+      OP_REQUIRES_OK(context,
+                     context->allocate_output(0, output_shape, &output));
+      Tensor* count_output = nullptr;
+      if (count) {
+        OP_REQUIRES_OK(context, context->allocate_output(
+                                    2, TensorShape({uniq_size}),
+                                    &count_output));
+      }
+      auto count_output_vec =
+          count ? count_output->template vec<TIndex>()
+                : typename TTypes<TIndex>::Vec(nullptr, 0);
+      unique.WriteOutputs(idx_vec, output->flat<T>(),
+                          count ? &count_output_vec : nullptr);
+      return;
+    } else if (new_sizes[0] == 1 && new_sizes[2] == 1) {
       // Specialized and faster implementation when unique is run over single
       // elements. Here we put T directly into the map rather than ints pointing
       // to them as in the general case.
@@ -15,11 +15,16 @@ limitations under the License.
 
 #include <functional>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/graph/algorithm.h"
@@ -37,6 +42,67 @@ namespace {
 
 const int kMaxStrLen = 40;
 
+class UniqueOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(const string& op_name) {
+    TF_ASSERT_OK(NodeDefBuilder("unique_op", op_name)
+                     .Input(FakeInput(DT_INT64))
+                     .Attr("out_idx", DT_INT32)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  // Checks the outputs against a serial reference implementation.
+  void CheckOutputs(const std::vector<int64_t>& input, bool with_counts) {
+    std::unordered_map<int64_t, int32> index;
+    std::vector<int64_t> expected_y;
+    std::vector<int32> expected_idx;
+    std::vector<int32> expected_count;
+    for (int64_t value : input) {
+      auto it = index.emplace(value, expected_y.size());
+      if (it.second) {
+        expected_y.push_back(value);
+        expected_count.push_back(0);
+      }
+      expected_idx.push_back(it.first->second);
+      ++expected_count[it.first->second];
+    }
+    test::ExpectTensorEqual<int64_t>(
+        *GetOutput(0), test::AsTensor<int64_t>(expected_y));
+    test::ExpectTensorEqual<int32>(*GetOutput(1),
+                                   test::AsTensor<int32>(expected_idx));
+    if (with_counts) {
+      test::ExpectTensorEqual<int32>(*GetOutput(2),
+                                     test::AsTensor<int32>(expected_count));
+    }
+  }
+};
+
+std::vector<int64_t> RandomInts(int size, int max_int) {
+  std::vector<int64_t> values(size);
+  for (int64_t& value : values) value = std::rand() % max_int;
+  return values;
+}
+
+TEST_F(UniqueOpTest, LargeInput) {
+  // Large enough to be deduplicated in parallel.
+  const std::vector<int64_t> input = RandomInts(300000, 50000);
+  MakeOp("Unique");
+  AddInputFromArray<int64_t>(TensorShape({static_cast<int64_t>(input.size())}),
+                             input);
+  TF_ASSERT_OK(RunOpKernel());
+  CheckOutputs(input, /*with_counts=*/false);
+}
+
+TEST_F(UniqueOpTest, LargeInputWithCounts) {
+  const std::vector<int64_t> input = RandomInts(300000, 1000);
+  MakeOp("UniqueWithCounts");
+  AddInputFromArray<int64_t>(TensorShape({static_cast<int64_t>(input.size())}),
+                             input);
+  TF_ASSERT_OK(RunOpKernel());
+  CheckOutputs(input, /*with_counts=*/true);
+}
+
 TensorProto GetRandomInt32TensorProto(int dim, int max_int) {
   TensorProto tensor_proto;
   tensor_proto.set_dtype(DT_INT32);
@@ -15,8 +15,11 @@ limitations under the License.
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
-// SSE4.2 accelerated CRC32c.
+#include <algorithm>
+
+// SSE4.2 and ARMv8 CRC32 accelerated CRC32c.
 
 // See if the SSE4.2 crc32c instruction is available.
 #undef USE_SSE_CRC32C
@@ -37,14 +40,24 @@ limitations under the License.
 #undef USE_SSE_CRC32C
 #endif
 
-#ifdef USE_SSE_CRC32C
+// See if the ARMv8 CRC32 extension is available.
+#undef USE_ARM_CRC32C
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32) && defined(__linux__)
+#define USE_ARM_CRC32C 1
+#endif
+
+#if defined(USE_SSE_CRC32C)
 #include <nmmintrin.h>
+#elif defined(USE_ARM_CRC32C)
+#include <arm_acle.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
 #endif
 
 namespace tensorflow {
 namespace crc32c {
 
-#ifndef USE_SSE_CRC32C
+#if !defined(USE_SSE_CRC32C) && !defined(USE_ARM_CRC32C)
 
 bool CanAccelerate() { return false; }
 uint32_t AcceleratedExtend(uint32_t crc, const char *buf, size_t size) {
@@ -54,10 +67,126 @@ uint32_t AcceleratedExtend(uint32_t crc, const char *buf, size_t size) {
 
 #else
 
+namespace {
+
+#if defined(USE_SSE_CRC32C)
+
 // SSE4.2 optimized crc32c computation.
+inline uint32_t CrcByte(uint32_t crc, uint8_t v) {
+  return _mm_crc32_u8(crc, v);
+}
+inline uint32_t CrcWord(uint32_t crc, uint64_t v) {
+  return static_cast<uint32_t>(_mm_crc32_u64(crc, v));
+}
+
+#else
+
+// ARMv8 CRC32 extension optimized crc32c computation.
+inline uint32_t CrcByte(uint32_t crc, uint8_t v) { return __crc32cb(crc, v); }
+inline uint32_t CrcWord(uint32_t crc, uint64_t v) { return __crc32cd(crc, v); }
+
+#endif
+
+// The crc32 instructions have a latency of 3 cycles but a throughput of one
+// per cycle, so long buffers are processed as three interleaved streams of
+// kLongBlock, then kShortBlock, bytes whose crcs are combined: the crc of the
+// concatenation of A and B is the crc of A shifted by the length of B, which
+// is a linear operation, xor the crc of B from a zero initial value.
+constexpr size_t kLongBlock = 8192;
+constexpr size_t kShortBlock = 256;
+
+// The reflected CRC-32C polynomial.
+constexpr uint32_t kPoly = 0x82f63b78u;
+
+// Multiplies the 32x32 GF(2) matrix `mat` by the vector `vec`.
+uint32_t MatrixTimes(const uint32_t *mat, uint32_t vec) {
+  uint32_t sum = 0;
+  while (vec != 0) {
+    if (vec & 1) sum ^= *mat;
+    vec >>= 1;
+    ++mat;
+  }
+  return sum;
+}
+
+void MatrixSquare(uint32_t *square, const uint32_t *mat) {
+  for (int n = 0; n < 32; ++n) {
+    square[n] = MatrixTimes(mat, mat[n]);
+  }
+}
+
+// The tables that shift a crc by `len` zero bytes, one byte of the crc at a
+// time. `len` must be a power of 2.
+struct ShiftTables {
+  explicit ShiftTables(size_t len) {
+    // The operator for one zero bit, then for len zero bytes.
+    uint32_t op[32];
+    uint32_t square[32];
+    op[0] = kPoly;
+    for (int n = 1; n < 32; ++n) {
+      op[n] = 1u << (n - 1);
+    }
+    for (size_t bits = 1; bits < 8 * len; bits *= 2) {
+      MatrixSquare(square, op);
+      std::copy(square, square + 32, op);
+    }
+    for (uint32_t n = 0; n < 256; ++n) {
+      table[0][n] = MatrixTimes(op, n);
+      table[1][n] = MatrixTimes(op, n << 8);
+      table[2][n] = MatrixTimes(op, n << 16);
+      table[3][n] = MatrixTimes(op, n << 24);
+    }
+  }
+
+  uint32_t Shift(uint32_t crc) const {
+    return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff] ^
+           table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+  }
+
+  uint32_t table[4][256];
+};
+
+inline uint64_t Load64(const uint8_t *p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+// Processes as many blocks of three streams of `block` bytes as fit in
+// [*p, e).
+inline uint32_t ExtendInterleaved(uint32_t crc0, size_t block,
+                                  const ShiftTables &shift, const uint8_t **p,
+                                  const uint8_t *e) {
+  const uint8_t *next = *p;
+  while (static_cast<size_t>(e - next) >= 3 * block) {
+    uint32_t crc1 = 0;
+    uint32_t crc2 = 0;
+    const uint8_t *end = next + block;
+    do {
+      crc0 = CrcWord(crc0, Load64(next));
+      crc1 = CrcWord(crc1, Load64(next + block));
+      crc2 = CrcWord(crc2, Load64(next + 2 * block));
+      next += 8;
+    } while (next < end);
+    crc0 = shift.Shift(crc0) ^ crc1;
+    crc0 = shift.Shift(crc0) ^ crc2;
+    next += 2 * block;
+  }
+  *p = next;
+  return crc0;
+}
+
+}  // namespace
+
+#if defined(USE_SSE_CRC32C)
 bool CanAccelerate() { return __builtin_cpu_supports("sse4.2"); }
+#else
+bool CanAccelerate() { return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0; }
+#endif
 
 uint32_t AcceleratedExtend(uint32_t crc, const char *buf, size_t size) {
+  static const ShiftTables *long_shift = new ShiftTables(kLongBlock);
+  static const ShiftTables *short_shift = new ShiftTables(kShortBlock);
   const uint8_t *p = reinterpret_cast<const uint8_t *>(buf);
   const uint8_t *e = p + size;
   uint32_t l = crc ^ 0xffffffffu;
@@ -70,23 +199,23 @@ uint32_t AcceleratedExtend(uint32_t crc, const char *buf, size_t size) {
   if (x <= e) {
     // Process bytes until finished or p is 8-byte aligned
     while (p != x) {
-      l = _mm_crc32_u8(l, *p);
+      l = CrcByte(l, *p);
       p++;
     }
   }
 
-  // Process bytes 16 at a time
-  uint64_t l64 = l;
-  while ((e - p) >= 16) {
-    l64 = _mm_crc32_u64(l64, *reinterpret_cast<const uint64_t *>(p));
-    l64 = _mm_crc32_u64(l64, *reinterpret_cast<const uint64_t *>(p + 8));
-    p += 16;
+  l = ExtendInterleaved(l, kLongBlock, *long_shift, &p, e);
+  l = ExtendInterleaved(l, kShortBlock, *short_shift, &p, e);
+
+  // Process bytes 8 at a time
+  while ((e - p) >= 8) {
+    l = CrcWord(l, Load64(p));
+    p += 8;
   }
 
   // Process remaining bytes one at a time.
-  l = l64;
   while (p < e) {
-    l = _mm_crc32_u8(l, *p);
+    l = CrcByte(l, *p);
     p++;
   }
 
@@ -14,6 +14,10 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/lib/hash/crc32c.h"
+
+#include <algorithm>
+#include <vector>
+
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
@@ -62,6 +66,25 @@ TEST(CRC, Extend) {
   ASSERT_EQ(Value("hello world", 11), Extend(Value("hello ", 6), "world", 5));
 }
 
+TEST(CRC, LongBuffers) {
+  // Long buffers are checksummed in interleaved blocks, which must give the
+  // same results as checksumming them in small pieces.
+  std::vector<char> buf(100000);
+  for (size_t i = 0; i < buf.size(); ++i) {
+    buf[i] = static_cast<char>((i * 7919) >> 3);
+  }
+  for (size_t offset : {0, 1, 5}) {
+    for (size_t size : {767, 768, 24575, 24576, 24577, 99990}) {
+      uint32 crc = 0;
+      for (size_t i = 0; i < size; i += 100) {
+        crc = Extend(crc, buf.data() + offset + i,
+                     std::min<size_t>(100, size - i));
+      }
+      ASSERT_EQ(crc, Value(buf.data() + offset, size)) << offset << " " << size;
+    }
+  }
+}
+
 TEST(CRC, Mask) {
   uint32 crc = Value("foo", 3);
   ASSERT_NE(crc, Mask(crc));
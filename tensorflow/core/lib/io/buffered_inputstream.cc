@@ -15,17 +15,33 @@ limitations under the License.
 
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 
+#include <cstdlib>
+#include <cstring>
+
 #include "tensorflow/core/lib/io/random_inputstream.h"
 
 namespace tensorflow {
 namespace io {
 
+namespace {
+
+bool PrefetchByDefault() {
+  static const bool prefetch = []() {
+    const char* value = std::getenv("TF_BUFFERED_INPUT_PREFETCH");
+    return value != nullptr && strcmp(value, "1") == 0;
+  }();
+  return prefetch;
+}
+
+}  // namespace
+
 BufferedInputStream::BufferedInputStream(InputStreamInterface* input_stream,
                                          size_t buffer_bytes,
                                          bool owns_input_stream)
     : input_stream_(input_stream),
       size_(buffer_bytes),
-      owns_input_stream_(owns_input_stream) {
+      owns_input_stream_(owns_input_stream),
+      prefetch_(PrefetchByDefault()) {
   buf_.reserve(size_);
 }
 
@@ -35,6 +51,8 @@ BufferedInputStream::BufferedInputStream(RandomAccessFile* file,
                           true) {}
 
 BufferedInputStream::~BufferedInputStream() {
+  WaitForPrefetch();
+  prefetch_thread_.reset();
   if (owns_input_stream_) {
     delete input_stream_;
   }
@@ -46,15 +64,69 @@ Status BufferedInputStream::FillBuffer() {
     limit_ = 0;
     return file_status_;
   }
-  Status s = input_stream_->ReadNBytes(size_, &buf_);
+  Status s;
+  if (prefetching_) {
+    WaitForPrefetch();
+    prefetching_ = false;
+    buf_.swap(prefetch_buf_);
+    s = prefetch_status_;
+  } else {
+    s = input_stream_->ReadNBytes(size_, &buf_);
+  }
   pos_ = 0;
   limit_ = buf_.size();
   if (!s.ok()) {
     file_status_ = s;
+  } else if (prefetch_) {
+    StartPrefetch();
   }
   return s;
 }
 
+void BufferedInputStream::StartPrefetch() {
+  if (prefetch_thread_ == nullptr) {
+    prefetch_thread_ = std::make_unique<thread::ThreadPool>(
+        Env::Default(), "buffered_input_prefetch", 1);
+  }
+  prefetching_ = true;
+  prefetch_offset_ = input_stream_->Tell();
+  {
+    mutex_lock l(mu_);
+    prefetch_pending_ = true;
+  }
+  prefetch_thread_->Schedule([this]() {
+    prefetch_status_ = input_stream_->ReadNBytes(size_, &prefetch_buf_);
+    mutex_lock l(mu_);
+    prefetch_pending_ = false;
+    cond_var_.notify_all();
+  });
+}
+
+void BufferedInputStream::WaitForPrefetch() {
+  mutex_lock l(mu_);
+  while (prefetch_pending_) {
+    cond_var_.wait(l);
+  }
+}
+
+void BufferedInputStream::MergePrefetch() {
+  if (!prefetching_) return;
+  WaitForPrefetch();
+  prefetching_ = false;
+  if (pos_ < limit_) {
+    tstring unread(buf_.data() + pos_, limit_ - pos_);
+    unread.append(prefetch_buf_);
+    buf_.swap(unread);
+  } else {
+    buf_.swap(prefetch_buf_);
+  }
+  pos_ = 0;
+  limit_ = buf_.size();
+  if (!prefetch_status_.ok()) {
+    file_status_ = prefetch_status_;
+  }
+}
+
 template <typename StringType>
 Status BufferedInputStream::ReadLineHelper(StringType* result,
                                            bool include_eol) {
@@ -136,6 +208,9 @@ Status BufferedInputStream::SkipNBytes(int64_t bytes_to_skip) {
     return errors::InvalidArgument("Can only skip forward, not ",
                                    bytes_to_skip);
   }
+  if (pos_ + bytes_to_skip >= limit_) {
+    MergePrefetch();
+  }
   if (pos_ + bytes_to_skip < limit_) {
     // If we aren't skipping too much, then we can just move pos_;
     pos_ += bytes_to_skip;
@@ -155,6 +230,9 @@ Status BufferedInputStream::SkipNBytes(int64_t bytes_to_skip) {
 }
 
 int64_t BufferedInputStream::Tell() const {
+  if (prefetching_) {
+    return prefetch_offset_ - (limit_ - pos_);
+  }
   return input_stream_->Tell() - (limit_ - pos_);
 }
 
@@ -164,6 +242,7 @@ Status BufferedInputStream::Seek(int64_t position) {
                                    position);
   }
 
+  MergePrefetch();
   // Position of the buffer's lower limit within file.
   const int64_t buf_lower_limit = input_stream_->Tell() - limit_;
   if (position < buf_lower_limit) {
@@ -206,6 +285,8 @@ template Status BufferedInputStream::ReadAll<std::string>(std::string* result);
 template Status BufferedInputStream::ReadAll<tstring>(tstring* result);
 
 Status BufferedInputStream::Reset() {
+  WaitForPrefetch();
+  prefetching_ = false;
   TF_RETURN_IF_ERROR(input_stream_->Reset());
   pos_ = 0;
   limit_ = 0;
@@ -16,14 +16,25 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_LIB_IO_BUFFERED_INPUTSTREAM_H_
 #define TENSORFLOW_CORE_LIB_IO_BUFFERED_INPUTSTREAM_H_
 
+#include <memory>
+
 #include "tensorflow/core/lib/io/inputstream_interface.h"
 #include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace tensorflow {
 namespace io {
 
 // Provides a buffer on top of an InputStreamInterface. A single instance of
 // BufferedInputStream is NOT safe for concurrent use by multiple threads.
+//
+// If prefetching is enabled, which it is by default when the
+// TF_BUFFERED_INPUT_PREFETCH environment variable is set to 1, the stream is
+// double buffered: as soon as the buffer is filled, the next `buffer_bytes`
+// are read in the background, on a thread of the stream, so that sequential
+// reads do not wait for the input stream when the buffer drains. The input
+// stream is then used from that thread too, but never concurrently.
 class BufferedInputStream : public InputStreamInterface {
  public:
   // Does not take ownership of input_stream unless owns_input_stream is set
@@ -93,8 +104,19 @@ class BufferedInputStream : public InputStreamInterface {
 
   tensorflow::Status Reset() override;
 
+  // Enables or disables prefetching, overriding TF_BUFFERED_INPUT_PREFETCH.
+  // Must be called before the first read.
+  void set_prefetch(bool prefetch) { prefetch_ = prefetch; }
+
  private:
   tensorflow::Status FillBuffer();
+  // Starts reading the bytes after the buffer into prefetch_buf_.
+  void StartPrefetch();
+  // Waits for the read started by StartPrefetch(), if any.
+  void WaitForPrefetch() TF_LOCKS_EXCLUDED(mu_);
+  // Appends the prefetched bytes to the unread bytes of the buffer, so that
+  // the input stream is positioned just past the end of the buffer.
+  void MergePrefetch();
   template <typename StringType>
   tensorflow::Status ReadLineHelper(StringType* result, bool include_eol);
 
@@ -109,6 +131,19 @@ class BufferedInputStream : public InputStreamInterface {
   // buffer allocations.
   tensorflow::Status file_status_ = OkStatus();
 
+  bool prefetch_;
+  // True if the bytes after the buffer are being, or have been, prefetched
+  // into prefetch_buf_ and prefetch_status_, starting at prefetch_offset_.
+  bool prefetching_ = false;
+  int64_t prefetch_offset_ = 0;
+  tstring prefetch_buf_;
+  tensorflow::Status prefetch_status_;
+  mutex mu_;
+  condition_variable cond_var_;
+  // True while the background read is running.
+  bool prefetch_pending_ TF_GUARDED_BY(mu_) = false;
+  std::unique_ptr<thread::ThreadPool> prefetch_thread_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(BufferedInputStream);
 };
 
@@ -487,6 +487,42 @@ TEST(BufferedInputStream, Seek_NotReset) {
   EXPECT_EQ(before_tell, after_tell);
 }
 
+TEST(BufferedInputStream, Prefetch) {
+  Env* env = Env::Default();
+  string fname;
+  ASSERT_TRUE(env->LocalTempFilename(&fname));
+  TF_ASSERT_OK(WriteStringToFile(env, fname, "line one\nline two\n0123456789"));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(env->NewRandomAccessFile(fname, &file));
+
+  for (auto buf_size : BufferSizes()) {
+    std::unique_ptr<RandomAccessInputStream> input_stream(
+        new RandomAccessInputStream(file.get()));
+    BufferedInputStream in(input_stream.get(), buf_size);
+    in.set_prefetch(true);
+    string line;
+    tstring read;
+    TF_ASSERT_OK(in.ReadLine(&line));
+    EXPECT_EQ(line, "line one");
+    EXPECT_EQ(9, in.Tell());
+    TF_ASSERT_OK(in.SkipNBytes(5));
+    TF_ASSERT_OK(in.ReadNBytes(3, &read));
+    EXPECT_EQ(read, "two");
+    EXPECT_EQ(17, in.Tell());
+    TF_ASSERT_OK(in.Seek(21));
+    TF_ASSERT_OK(in.ReadNBytes(3, &read));
+    EXPECT_EQ(read, "345");
+    TF_ASSERT_OK(in.Seek(5));
+    TF_ASSERT_OK(in.ReadLine(&line));
+    EXPECT_EQ(line, "one");
+    EXPECT_TRUE(errors::IsOutOfRange(in.SkipNBytes(100)));
+    EXPECT_TRUE(errors::IsOutOfRange(in.ReadNBytes(1, &read)));
+    TF_ASSERT_OK(in.Reset());
+    TF_ASSERT_OK(in.ReadNBytes(4, &read));
+    EXPECT_EQ(read, "line");
+  }
+}
+
 TEST(BufferedInputStream, ReadAll_Empty) {
   Env* env = Env::Default();
   string fname;
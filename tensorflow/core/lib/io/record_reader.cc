@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/compression.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/strcat.h"
 
 namespace tensorflow {
 namespace io {
@@ -245,5 +246,28 @@ SequentialRecordReader::SequentialRecordReader(
     RandomAccessFile* file, const RecordReaderOptions& options)
     : underlying_(file, options), offset_(0) {}
 
+std::string RecordIndexFilename(StringPiece filename) {
+  return strings::StrCat(filename, ".index");
+}
+
+Status ReadRecordIndex(Env* env, const std::string& index_filename,
+                       std::vector<uint64>* offsets) {
+  std::string contents;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, index_filename, &contents));
+  if (contents.size() % sizeof(uint64) != 0) {
+    return errors::DataLoss("truncated record index ", index_filename);
+  }
+  offsets->resize(contents.size() / sizeof(uint64));
+  for (size_t i = 0; i < offsets->size(); ++i) {
+    (*offsets)[i] = core::DecodeFixed64(contents.data() + i * sizeof(uint64));
+    if (i > 0 && (*offsets)[i] < (*offsets)[i - 1] + RecordReader::kHeaderSize +
+                                     RecordReader::kFooterSize) {
+      return errors::DataLoss("corrupted record index ", index_filename,
+                              " at entry ", i);
+    }
+  }
+  return OkStatus();
+}
+
 }  // namespace io
 }  // namespace tensorflow
@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_LIB_IO_RECORD_READER_H_
 #define TENSORFLOW_CORE_LIB_IO_RECORD_READER_H_
 
+#include <string>
+#include <vector>
+
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
 #include "tensorflow/core/lib/io/inputstream_interface.h"
@@ -30,6 +33,7 @@ limitations under the License.
 
 namespace tensorflow {
 
+class Env;
 class RandomAccessFile;
 
 namespace io {
@@ -174,6 +178,19 @@ class SequentialRecordReader {
   uint64 offset_ = 0;
 };
 
+// Returns the name of the index file of the TFRecord file `filename`.
+std::string RecordIndexFilename(StringPiece filename);
+
+// Reads the offsets of the records of a TFRecord file from the index file
+// `index_filename`, which is written by a RecordWriter with
+// `RecordWriterOptions::index_dest` set. With the offsets, the records of an
+// uncompressed file can be skipped or read in any order without decoding the
+// headers of the records before them. Returns DATA_LOSS if the index file is
+// malformed. An index that is out of date with its TFRecord file is detected
+// when a record is read at one of its offsets, by the checksum of the header.
+Status ReadRecordIndex(Env* env, const std::string& index_filename,
+                       std::vector<uint64>* offsets);
+
 }  // namespace io
 }  // namespace tensorflow
 
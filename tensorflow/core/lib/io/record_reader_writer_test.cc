@@ -328,4 +328,50 @@ TEST(RecordReaderWriterTest, TestUseAfterClose) {
   }
 }
 
+TEST(RecordReaderWriterTest, TestIndex) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_index_test";
+  const std::vector<string> records = {"abc", "", "defgh", "ij"};
+
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+    std::unique_ptr<WritableFile> index_file;
+    TF_CHECK_OK(
+        env->NewWritableFile(io::RecordIndexFilename(fname), &index_file));
+
+    io::RecordWriterOptions options;
+    options.index_dest = index_file.get();
+    io::RecordWriter writer(file.get(), options);
+    for (const string& record : records) {
+      TF_EXPECT_OK(writer.WriteRecord(record));
+    }
+    TF_CHECK_OK(writer.Close());
+    TF_CHECK_OK(file->Close());
+    TF_CHECK_OK(index_file->Close());
+  }
+
+  std::vector<uint64> offsets;
+  TF_CHECK_OK(
+      io::ReadRecordIndex(env, io::RecordIndexFilename(fname), &offsets));
+  ASSERT_EQ(records.size(), offsets.size());
+
+  std::unique_ptr<RandomAccessFile> read_file;
+  TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+  io::RecordReader reader(read_file.get());
+  // The records can be read in any order.
+  for (int i = records.size() - 1; i >= 0; --i) {
+    uint64 offset = offsets[i];
+    tstring record;
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ(records[i], record);
+  }
+
+  // An index with a partial entry is rejected.
+  TF_CHECK_OK(WriteStringToFile(env, io::RecordIndexFilename(fname), "abc"));
+  EXPECT_EQ(
+      io::ReadRecordIndex(env, io::RecordIndexFilename(fname), &offsets).code(),
+      error::DATA_LOSS);
+}
+
 }  // namespace tensorflow
@@ -112,7 +112,8 @@ Status RecordWriter::WriteRecord(StringPiece data) {
   PopulateFooter(footer, data.data(), data.size());
   TF_RETURN_IF_ERROR(dest_->Append(StringPiece(header, sizeof(header))));
   TF_RETURN_IF_ERROR(dest_->Append(data));
-  return dest_->Append(StringPiece(footer, sizeof(footer)));
+  TF_RETURN_IF_ERROR(dest_->Append(StringPiece(footer, sizeof(footer))));
+  return AppendToIndex(data.size());
 }
 
 #if defined(TF_CORD_SUPPORT)
@@ -132,10 +133,20 @@ Status RecordWriter::WriteRecord(const absl::Cord& data) {
   PopulateFooter(footer, data);
   TF_RETURN_IF_ERROR(dest_->Append(StringPiece(header, sizeof(header))));
   TF_RETURN_IF_ERROR(dest_->Append(data));
-  return dest_->Append(StringPiece(footer, sizeof(footer)));
+  TF_RETURN_IF_ERROR(dest_->Append(StringPiece(footer, sizeof(footer))));
+  return AppendToIndex(data.size());
 }
 #endif
 
+Status RecordWriter::AppendToIndex(size_t n) {
+  const uint64 offset = offset_;
+  offset_ += kHeaderSize + n + kFooterSize;
+  if (options_.index_dest == nullptr) return OkStatus();
+  char entry[sizeof(uint64)];
+  core::EncodeFixed64(entry, offset);
+  return options_.index_dest->Append(StringPiece(entry, sizeof(entry)));
+}
+
 Status RecordWriter::Close() {
   if (dest_ == nullptr) return OkStatus();
   if (IsZlibCompressed(options_) || IsSnappyCompressed(options_)) {
@@ -48,6 +48,14 @@ struct RecordWriterOptions {
   static RecordWriterOptions CreateRecordWriterOptions(
       const string& compression_type);
 
+  // If not null, the writer appends the offset of every record it writes to
+  // this file, as a fixed64, so that readers can seek to any record without
+  // scanning the file; see ReadRecordIndex() in record_reader.h. The offsets
+  // are positions in the uncompressed stream. The file is usually the one
+  // named by RecordIndexFilename(), and must remain live while the writer is
+  // in use; the writer does not flush or close it.
+  WritableFile* index_dest = nullptr;
+
 #if !defined(IS_SLIM_BUILD)
   // Options specific to compression.
   tensorflow::io::ZlibCompressionOptions zlib_options;
@@ -111,8 +119,12 @@ class RecordWriter {
 #endif
 
  private:
+  Status AppendToIndex(size_t n);
+
   WritableFile* dest_;
   RecordWriterOptions options_;
+  // The offset of the next record in the uncompressed stream.
+  uint64 offset_ = 0;
 
   inline static uint32 MaskedCrc(const char* data, size_t n) {
     return crc32c::Mask(crc32c::Value(data, n));
@@ -15,10 +15,14 @@ limitations under the License.
 
 #include "tensorflow/core/lib/io/table.h"
 
+#include <algorithm>
+#include <memory>
+
 #include "tensorflow/core/lib/core/coding.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/io/block.h"
 #include "tensorflow/core/lib/io/cache.h"
+#include "tensorflow/core/lib/io/filter_block.h"
 #include "tensorflow/core/lib/io/format.h"
 #include "tensorflow/core/lib/io/table_options.h"
 #include "tensorflow/core/lib/io/two_level_iterator.h"
@@ -27,14 +31,53 @@ limitations under the License.
 namespace tensorflow {
 namespace table {
 
+namespace {
+
+// A RandomAccessFile over a mapped table, whose reads return pointers into
+// the mapping rather than copies.
+class MemoryRegionFile : public RandomAccessFile {
+ public:
+  explicit MemoryRegionFile(ReadOnlyMemoryRegion* region)
+      : region_(region) {}
+
+  Status Read(uint64 offset, size_t n, StringPiece* result,
+              char* scratch) const override {
+    const uint64 length = region_->length();
+    if (offset > length) {
+      *result = StringPiece();
+      return errors::OutOfRange("Read past the end of the mapped table");
+    }
+    const size_t available = std::min<uint64>(n, length - offset);
+    *result = StringPiece(static_cast<const char*>(region_->data()) + offset,
+                          available);
+    if (available < n) {
+      return errors::OutOfRange("Read less bytes than requested");
+    }
+    return OkStatus();
+  }
+
+ private:
+  ReadOnlyMemoryRegion* const region_;
+};
+
+}  // namespace
+
 struct Table::Rep {
-  ~Rep() { delete index_block; }
+  ~Rep() {
+    delete filter;
+    delete[] filter_data;
+    delete index_block;
+  }
 
   Options options;
   Status status;
   RandomAccessFile* file;
+  std::unique_ptr<RandomAccessFile> owned_file;  // Set for mapped tables
   uint64 cache_id;
 
+  FilterBlockReader* filter = nullptr;
+  const char* filter_data = nullptr;  // Owned if not null
+
   BlockHandle metaindex_handle;  // Handle to metaindex_block: saved from footer
   Block* index_block;
 };
@@ -74,6 +117,7 @@ Status Table::Open(const Options& options, RandomAccessFile* file, uint64 size,
     rep->index_block = index_block;
     rep->cache_id = (options.block_cache ? options.block_cache->NewId() : 0);
     *table = new Table(rep);
+    (*table)->ReadMeta(footer.metaindex_handle());
   } else {
     if (index_block) delete index_block;
   }
@@ -81,6 +125,48 @@ Status Table::Open(const Options& options, RandomAccessFile* file, uint64 size,
   return s;
 }
 
+Status Table::Open(const Options& options, ReadOnlyMemoryRegion* region,
+                   Table** table) {
+  std::unique_ptr<RandomAccessFile> file(new MemoryRegionFile(region));
+  Status s = Open(options, file.get(), region->length(), table);
+  if (s.ok()) {
+    (*table)->rep_->owned_file = std::move(file);
+  }
+  return s;
+}
+
+void Table::ReadMeta(const BlockHandle& metaindex_handle) {
+  BlockContents contents;
+  if (!ReadBlock(rep_->file, metaindex_handle, &contents).ok()) {
+    // Do not propagate errors since meta info is not needed for operation
+    return;
+  }
+  Block* meta = new Block(contents);
+  Iterator* iter = meta->NewIterator();
+  iter->Seek(kFilterBlockKey);
+  if (iter->Valid() && iter->key() == StringPiece(kFilterBlockKey)) {
+    ReadFilter(iter->value());
+  }
+  delete iter;
+  delete meta;
+}
+
+void Table::ReadFilter(const StringPiece& filter_handle_value) {
+  StringPiece v = filter_handle_value;
+  BlockHandle filter_handle;
+  if (!filter_handle.DecodeFrom(&v).ok()) {
+    return;
+  }
+  BlockContents block;
+  if (!ReadBlock(rep_->file, filter_handle, &block).ok()) {
+    return;
+  }
+  if (block.heap_allocated) {
+    rep_->filter_data = block.data.data();  // Will need to delete later
+  }
+  rep_->filter = new FilterBlockReader(block.data);
+}
+
 Table::~Table() { delete rep_; }
 
 static void DeleteBlock(void* arg, void* ignored) {
@@ -126,8 +212,12 @@ Iterator* Table::BlockReader(void* arg, const StringPiece& index_value) {
         s = ReadBlock(table->rep_->file, handle, &contents);
         if (s.ok()) {
           block = new Block(contents);
-          cache_handle = block_cache->Insert(key, block, block->size(),
-                                             &DeleteCachedBlock);
+          // Blocks that are read in place, e.g. from mapped tables, are not
+          // worth caching.
+          if (contents.cacheable) {
+            cache_handle = block_cache->Insert(key, block, block->size(),
+                                               &DeleteCachedBlock);
+          }
         }
       }
     } else {
@@ -164,6 +254,14 @@ Status Table::InternalGet(const StringPiece& k, void* arg,
   Iterator* iiter = rep_->index_block->NewIterator();
   iiter->Seek(k);
   if (iiter->Valid()) {
+    BlockHandle handle;
+    StringPiece input = iiter->value();
+    if (rep_->filter != nullptr && handle.DecodeFrom(&input).ok() &&
+        !rep_->filter->KeyMayMatch(handle.offset(), k)) {
+      // Not found
+      delete iiter;
+      return s;
+    }
     Iterator* block_iter = BlockReader(this, iiter->value());
     block_iter->Seek(k);
     if (block_iter->Valid()) {
@@ -179,6 +277,23 @@ Status Table::InternalGet(const StringPiece& k, void* arg,
   return s;
 }
 
+bool Table::MayContain(const StringPiece& key) const {
+  Iterator* index_iter = rep_->index_block->NewIterator();
+  index_iter->Seek(key);
+  bool result;
+  if (index_iter->Valid()) {
+    BlockHandle handle;
+    StringPiece input = index_iter->value();
+    result = rep_->filter == nullptr || !handle.DecodeFrom(&input).ok() ||
+             rep_->filter->KeyMayMatch(handle.offset(), key);
+  } else {
+    // The key is past the last key in the table, unless the index is corrupt.
+    result = !index_iter->status().ok();
+  }
+  delete index_iter;
+  return result;
+}
+
 uint64 Table::ApproximateOffsetOf(const StringPiece& key) const {
   Iterator* index_iter = rep_->index_block->NewIterator();
   index_iter->Seek(key);
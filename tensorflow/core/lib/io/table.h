@@ -23,9 +23,11 @@ limitations under the License.
 namespace tensorflow {
 
 class RandomAccessFile;
+class ReadOnlyMemoryRegion;
 
 namespace table {
 
+class BlockHandle;
 struct Options;
 
 // A Table is a sorted map from strings to strings.  Tables are
@@ -46,6 +48,14 @@ class Table {
   static Status Open(const Options& options, RandomAccessFile* file,
                      uint64 file_size, Table** table);
 
+  // Like Open() above, but for a table that is mapped into memory, e.g. by
+  // Env::NewReadOnlyMemoryRegionFromFile().  Uncompressed blocks are then read
+  // in place, without copies and without the block cache.  The client must
+  // ensure that "region" remains live for the duration of the returned
+  // table's lifetime.
+  static Status Open(const Options& options, ReadOnlyMemoryRegion* region,
+                     Table** table);
+
   ~Table();
 
   // Returns a new iterator over the table contents.
@@ -61,6 +71,12 @@ class Table {
   // be close to the file length.
   uint64 ApproximateOffsetOf(const StringPiece& key) const;
 
+  // Returns false if the table certainly does not contain "key".  This reads
+  // no data block, but only tables built with Bloom filters (see
+  // Options::filter_bits_per_key) rule out keys before the last one; for
+  // other tables, this returns true for all keys up to the last one.
+  bool MayContain(const StringPiece& key) const;
+
  private:
   struct Rep;
   Rep* rep_;
@@ -68,6 +84,9 @@ class Table {
   explicit Table(Rep* rep) { rep_ = rep; }
   static Iterator* BlockReader(void*, const StringPiece&);
 
+  void ReadMeta(const BlockHandle& metaindex_handle);
+  void ReadFilter(const StringPiece& filter_handle_value);
+
   // Calls (*handle_result)(arg, ...) with the entry found after a call
   // to Seek(key).  May not make such a call if filter policy says
   // that key is not present.
@@ -63,6 +63,14 @@ struct Options {
   // efficiently detect that and will switch to uncompressed mode.
   CompressionType compression = kSnappyCompression;
 
+  // If positive, store a Bloom filter with about this many bits per key for
+  // each data block, so that Table::MayContain() can rule out keys without
+  // reading any data block.  10 bits per key give a false positive rate of
+  // about 1%.  Readers that do not use filters ignore them.
+  //
+  // Default: 0, which stores no filters.
+  int filter_bits_per_key = 0;
+
   // Control over blocks (user data is stored in a set of blocks, and
   // a block is the unit of reading from disk).
 
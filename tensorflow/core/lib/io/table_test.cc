@@ -22,12 +22,15 @@ limitations under the License.
 
 #include "absl/strings/escaping.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/io/block.h"
 #include "tensorflow/core/lib/io/block_builder.h"
 #include "tensorflow/core/lib/io/format.h"
 #include "tensorflow/core/lib/io/iterator.h"
 #include "tensorflow/core/lib/io/table_builder.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/test.h"
@@ -245,6 +248,10 @@ class TableConstructor : public Constructor {
     return table_->ApproximateOffsetOf(key);
   }
 
+  bool MayContain(const StringPiece& key) const {
+    return table_->MayContain(key);
+  }
+
   uint64 BytesRead() const { return source_->BytesRead(); }
 
  private:
@@ -633,5 +640,96 @@ TEST(TableTest, SeekToFirstKeyDoesNotReadTooMuch) {
   EXPECT_LT(c.BytesRead(), 200);
 }
 
+static string NumberedKey(int i) { return strings::Printf("k%06d", i); }
+
+TEST(TableTest, BloomFilters) {
+  const int kNumKeys = 10000;
+  for (int bits_per_key : {0, 10}) {
+    TableConstructor c;
+    for (int i = 0; i < kNumKeys; i += 2) {
+      c.Add(NumberedKey(i), "value");
+    }
+    std::vector<string> keys;
+    KVMap kvmap;
+    Options options;
+    options.block_size = 1024;
+    options.compression = kNoCompression;
+    options.filter_bits_per_key = bits_per_key;
+    c.Finish(options, &keys, &kvmap);
+
+    const uint64 bytes_read_at_open = c.BytesRead();
+    int false_positives = 0;
+    for (int i = 0; i < kNumKeys; ++i) {
+      if (i % 2 == 0) {
+        EXPECT_TRUE(c.MayContain(NumberedKey(i))) << i;
+      } else if (c.MayContain(NumberedKey(i))) {
+        ++false_positives;
+      }
+    }
+    EXPECT_FALSE(c.MayContain("xyz"));
+    // No data block is read.
+    EXPECT_EQ(c.BytesRead(), bytes_read_at_open);
+    if (bits_per_key == 0) {
+      EXPECT_EQ(false_positives, kNumKeys / 2);
+    } else {
+      // The false positive rate is about 1%.
+      EXPECT_LT(false_positives, kNumKeys / 2 / 30);
+    }
+
+    // Tables with filters are read like the others.
+    Iterator* iter = c.NewIterator();
+    iter->Seek(NumberedKey(1234));
+    ASSERT_TRUE(iter->Valid());
+    EXPECT_EQ(iter->key(), NumberedKey(1234));
+    iter->Seek(NumberedKey(1235));
+    ASSERT_TRUE(iter->Valid());
+    EXPECT_EQ(iter->key(), NumberedKey(1236));
+    delete iter;
+  }
+}
+
+class StringMemoryRegion : public ReadOnlyMemoryRegion {
+ public:
+  explicit StringMemoryRegion(const string& contents) : contents_(contents) {}
+  const void* data() override { return contents_.data(); }
+  uint64 length() override { return contents_.size(); }
+
+ private:
+  const string contents_;
+};
+
+TEST(TableTest, MappedTable) {
+  StringSink sink;
+  Options options;
+  options.block_size = 1024;
+  options.compression = kNoCompression;
+  options.filter_bits_per_key = 10;
+  TableBuilder builder(options, &sink);
+  for (int i = 0; i < 1000; ++i) {
+    builder.Add(NumberedKey(i), strings::StrCat("value", i));
+  }
+  TF_ASSERT_OK(builder.Finish());
+
+  StringMemoryRegion region(sink.contents());
+  const char* begin = static_cast<const char*>(region.data());
+  const char* end = begin + region.length();
+  Table* table;
+  TF_ASSERT_OK(Table::Open(options, &region, &table));
+  Iterator* iter = table->NewIterator();
+  int i = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++i) {
+    EXPECT_EQ(iter->key(), NumberedKey(i));
+    EXPECT_EQ(iter->value(), strings::StrCat("value", i));
+    // Values are read in place.
+    EXPECT_GE(iter->value().data(), begin);
+    EXPECT_LT(iter->value().data(), end);
+  }
+  EXPECT_EQ(i, 1000);
+  EXPECT_TRUE(table->MayContain(NumberedKey(123)));
+  EXPECT_FALSE(table->MayContain("xyz"));
+  delete iter;
+  delete table;
+}
+
 }  // namespace table
 }  // namespace tensorflow
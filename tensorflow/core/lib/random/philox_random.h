@@ -190,6 +190,58 @@ class PhiloxRandom {
     return counter;
   }
 
+#if !defined(__CUDA_ARCH__) && !defined(__HIP_DEVICE_COMPILE__)
+  // Writes the results of the next `kNumGroups` calls to operator() to
+  // `results`, and advances the stream past them. The groups are computed side
+  // by side, one array per element of the counter, so that the compiler can
+  // vectorize the rounds over the groups with SIMD integer multiplies; this is
+  // several times faster than calling operator() `kNumGroups` times.
+  template <int kNumGroups>
+  void GenerateBatch(ResultType* results) {
+    uint32_t c0[kNumGroups], c1[kNumGroups], c2[kNumGroups], c3[kNumGroups];
+    if (counter_[0] <= ~uint32_t{0} - kNumGroups) {
+      // The common case, where the low word of the counter does not carry.
+      for (int g = 0; g < kNumGroups; ++g) {
+        c0[g] = counter_[0] + g;
+        c1[g] = counter_[1];
+        c2[g] = counter_[2];
+        c3[g] = counter_[3];
+      }
+      counter_[0] += kNumGroups;
+    } else {
+      for (int g = 0; g < kNumGroups; ++g) {
+        c0[g] = counter_[0];
+        c1[g] = counter_[1];
+        c2[g] = counter_[2];
+        c3[g] = counter_[3];
+        SkipOne();
+      }
+    }
+    Key key = key_;
+    for (int round = 0; round < 10; ++round) {
+      const uint32_t k0 = key[0];
+      const uint32_t k1 = key[1];
+      for (int g = 0; g < kNumGroups; ++g) {
+        const uint64_t product0 = static_cast<uint64_t>(kPhiloxM4x32A) * c0[g];
+        const uint64_t product1 = static_cast<uint64_t>(kPhiloxM4x32B) * c2[g];
+        const uint32_t r0 = static_cast<uint32_t>(product1 >> 32) ^ c1[g] ^ k0;
+        const uint32_t r2 = static_cast<uint32_t>(product0 >> 32) ^ c3[g] ^ k1;
+        c1[g] = static_cast<uint32_t>(product1);
+        c3[g] = static_cast<uint32_t>(product0);
+        c0[g] = r0;
+        c2[g] = r2;
+      }
+      RaiseKey(&key);
+    }
+    for (int g = 0; g < kNumGroups; ++g) {
+      results[g][0] = c0[g];
+      results[g][1] = c1[g];
+      results[g][2] = c2[g];
+      results[g][3] = c3[g];
+    }
+  }
+#endif
+
  private:
   // We use the same constants as recommended by the original paper.
   static constexpr uint32_t kPhiloxW32A = 0x9E3779B9;
@@ -68,6 +68,33 @@ TEST(PhiloxRandomTest, SkipMatchTest) {
   }
 }
 
+// This test checks that generating a batch of groups gives the same groups
+// as generating them one at a time, including across carries in the counter.
+TEST(PhiloxRandomTest, GenerateBatchMatchTest) {
+  constexpr int kNumGroups = 16;
+  const uint64 test_seed = GetTestSeed();
+  for (const uint64 counter_lo : {uint64{0}, ~uint64{0} - 5}) {
+    PhiloxRandom batch_gen(test_seed, ~uint64{0});
+    batch_gen.Skip(counter_lo);
+    PhiloxRandom gen = batch_gen;
+
+    PhiloxRandom::ResultType batch[kNumGroups];
+    batch_gen.GenerateBatch<kNumGroups>(batch);
+    for (int g = 0; g < kNumGroups; ++g) {
+      const PhiloxRandom::ResultType expected = gen();
+      for (int i = 0; i < PhiloxRandom::kResultElementCount; ++i) {
+        ASSERT_EQ(expected[i], batch[g][i]);
+      }
+    }
+    // Both generators continue from the same counter.
+    const PhiloxRandom::ResultType expected = gen();
+    const PhiloxRandom::ResultType actual = batch_gen();
+    for (int i = 0; i < PhiloxRandom::kResultElementCount; ++i) {
+      ASSERT_EQ(expected[i], actual[i]);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace random
 }  // namespace tensorflow
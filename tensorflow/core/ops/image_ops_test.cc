@@ -153,6 +153,28 @@ TEST(ImageOpsTest, DecodeAndCropJpeg_ShapeFn) {
   INFER_ERROR("channels must be non-negative, got -1", op, "[];[]");
 }
 
+TEST(ImageOpsTest, DecodeAndResizeJpeg_ShapeFn) {
+  const char* op_name = "DecodeAndResizeJpeg";
+  ShapeInferenceTestOp op(op_name);
+
+  INFER_ERROR("Wrong number of inputs passed: 1 while 2 expected", op, "[1]");
+  INFER_ERROR("Shape must be rank 0 but is rank 1", op, "[1];?");
+
+  TF_ASSERT_OK(NodeDefBuilder("test", op_name)
+                   .Input({"img", 0, DT_STRING})
+                   .Input({"size", 1, DT_INT32})
+                   .Attr("channels", 3)
+                   .Finalize(&op.node_def));
+  INFER_OK(op, "[];[?]", "[?,?,3]");
+  INFER_ERROR("Dimension must be 2 but is 3", op, "[];[3]");
+
+  // The output size is known when `size` is a constant.
+  Tensor size = test::AsTensor<int32>({224, 160});
+  op.input_tensors.resize(2);
+  op.input_tensors[1] = &size;
+  INFER_OK(op, "[];[2]", "[224,160,3]");
+}
+
 TEST(ImageOpsTest, DecodeAndCropJpeg_InvalidCropWindow) {
   const char* op_name = "DecodeAndCropJpeg";
   ShapeInferenceTestOp op(op_name);
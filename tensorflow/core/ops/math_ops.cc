@@ -337,6 +337,42 @@ REGISTER_OP("_UnaryOpsComposition")
 expected to create these operators.
 )doc");
 
+REGISTER_OP("_MultiTensorBinaryOp")
+    .Input("x: N * T")
+    .Input("y: N * T")
+    .Output("z: N * T")
+    .Attr("T: {half, bfloat16, float, double}")
+    .Attr("N: int >= 1")
+    .Attr(
+        "binary_op: {'AddV2', 'Sub', 'Mul', 'RealDiv', 'Maximum', 'Minimum'}")
+    .SetShapeFn([](InferenceContext* c) {
+      int n;
+      TF_RETURN_IF_ERROR(c->GetAttr("N", &n));
+      for (int i = 0; i < n; ++i) {
+        // Either both inputs have the same shape, or one of them is a scalar.
+        ShapeHandle x = c->input(i);
+        ShapeHandle y = c->input(n + i);
+        if (c->RankKnown(x) && c->Rank(x) == 0) {
+          c->set_output(i, y);
+        } else if (c->RankKnown(y) && c->Rank(y) == 0) {
+          c->set_output(i, x);
+        } else {
+          ShapeHandle z;
+          TF_RETURN_IF_ERROR(c->Merge(x, y, &z));
+          c->set_output(i, z);
+        }
+      }
+      return OkStatus();
+    })
+    .Doc(R"doc(
+Computes `z[i] = binary_op(x[i], y[i])` for each pair of inputs, in a single
+kernel. Either `x[i]` and `y[i]` have the same shape, or one of them is a
+scalar.
+
+*NOTE*: Do not invoke this operator directly in Python. Graph rewrite pass is
+expected to create these operators.
+)doc");
+
 #undef UNARY
 #undef UNARY_REAL
 #undef UNARY_COMPLEX
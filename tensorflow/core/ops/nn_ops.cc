@@ -1228,6 +1228,63 @@ REGISTER_OP("LogSoftmax")
 
 // --------------------------------------------------------------------------
 
+REGISTER_OP("_FusedAttention")
+    .Input("query: T")
+    .Input("key: T")
+    .Input("value: T")
+    .Input("args: num_args * T")
+    .Output("output: T")
+    .Attr("T: {float}")
+    .Attr("num_args: int >= 0")
+    .Attr("scale: float = 1.0")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle query;
+      ShapeHandle key;
+      ShapeHandle value;
+      TF_RETURN_IF_ERROR(c->WithRankAtLeast(c->input(0), 2, &query));
+      TF_RETURN_IF_ERROR(c->WithRankAtLeast(c->input(1), 2, &key));
+      TF_RETURN_IF_ERROR(c->WithRankAtLeast(c->input(2), 2, &value));
+
+      // The queries, keys and values have the same batch dimensions.
+      ShapeHandle batch;
+      ShapeHandle key_batch;
+      ShapeHandle value_batch;
+      TF_RETURN_IF_ERROR(c->Subshape(query, 0, -2, &batch));
+      TF_RETURN_IF_ERROR(c->Subshape(key, 0, -2, &key_batch));
+      TF_RETURN_IF_ERROR(c->Subshape(value, 0, -2, &value_batch));
+      TF_RETURN_IF_ERROR(c->Merge(batch, key_batch, &batch));
+      TF_RETURN_IF_ERROR(c->Merge(batch, value_batch, &batch));
+
+      // The queries and keys have the same depth, and the keys and values
+      // the same sequence length.
+      DimensionHandle unused;
+      TF_RETURN_IF_ERROR(
+          c->Merge(c->Dim(query, -1), c->Dim(key, -1), &unused));
+      TF_RETURN_IF_ERROR(
+          c->Merge(c->Dim(key, -2), c->Dim(value, -2), &unused));
+
+      ShapeHandle output;
+      TF_RETURN_IF_ERROR(c->Concatenate(
+          batch, c->Matrix(c->Dim(query, -2), c->Dim(value, -1)), &output));
+      c->set_output(0, output);
+      return OkStatus();
+    })
+    .Doc(R"doc(
+Computes softmax(scale * query * key^T + mask) * value.
+
+`query` is [..., Sq, D], `key` is [..., Sk, D], `value` is [..., Sk, Dv] and
+the output is [..., Sq, Dv]. The optional mask in `args` is added to the
+attention scores, and broadcasts to their shape [..., Sq, Sk].
+
+The scores are computed and normalized one block at a time, with an online
+softmax, so that the [..., Sq, Sk] scores are never materialized.
+
+*NOTE*: Do not invoke this operator directly in Python. Grappler is
+expected to create these operators.
+)doc");
+
+// --------------------------------------------------------------------------
+
 REGISTER_OP("SoftmaxCrossEntropyWithLogits")
     .Input("features: T")
     .Input("labels: T")
@@ -826,6 +826,49 @@ REGISTER_OP("ResourceApplyAdam")
     .Attr("use_nesterov: bool = false")
     .SetShapeFn(ApplyAdamShapeFn</*is_resource=*/true>);
 
+static Status MultiApplyAdamShapeFn(InferenceContext* c) {
+  int n;
+  TF_RETURN_IF_ERROR(c->GetAttr("N", &n));
+  ShapeHandle unused;
+  for (int i = 3 * n; i < 3 * n + 6; ++i) {
+    // beta1_power, beta2_power, lr, beta1, beta2 and epsilon.
+    TF_RETURN_IF_ERROR(c->WithRank(c->input(i), 0, &unused));
+  }
+  for (int i = 0; i < n; ++i) {
+    ShapeHandle s = ShapeOrHandleShape<true>(c, i);  // var
+    TF_RETURN_IF_ERROR(
+        c->Merge(s, ShapeOrHandleShape<true>(c, n + i), &s));  // m
+    TF_RETURN_IF_ERROR(
+        c->Merge(s, ShapeOrHandleShape<true>(c, 2 * n + i), &s));  // v
+    TF_RETURN_IF_ERROR(c->Merge(s, c->input(3 * n + 6 + i), &s));  // grad
+  }
+  return OkStatus();
+}
+
+REGISTER_OP("_MultiResourceApplyAdam")
+    .Input("var: N * resource")
+    .Input("m: N * resource")
+    .Input("v: N * resource")
+    .Input("beta1_power: T")
+    .Input("beta2_power: T")
+    .Input("lr: T")
+    .Input("beta1: T")
+    .Input("beta2: T")
+    .Input("epsilon: T")
+    .Input("grad: N * T")
+    .Attr("N: int >= 1")
+    .Attr("T: numbertype")
+    .Attr("use_locking: bool = false")
+    .Attr("use_nesterov: bool = false")
+    .SetShapeFn(MultiApplyAdamShapeFn)
+    .Doc(R"doc(
+Applies ResourceApplyAdam to N variables in a single kernel.
+
+var[i], m[i], v[i] and grad[i] are updated exactly as by a ResourceApplyAdam op
+with those inputs, and the scalar hyperparameters shared by all of the
+variables.
+)doc");
+
 template <bool is_resource>
 static Status ApplyAdamWithAmsgradShapeFn(InferenceContext* c) {
   ShapeHandle unused;
@@ -13,8 +13,10 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/shape_inference_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -289,6 +291,28 @@ TEST(TrainingOpsTest, ApplyAdam_ShapeFn) {
   INFER_ERROR(err, op, "?;?;?;?;?;?;?;?;[?];?");
 }
 
+TEST(TrainingOpsTest, MultiResourceApplyAdam_ShapeFn) {
+  ShapeInferenceTestOp op("_MultiResourceApplyAdam");
+  std::vector<NodeDefBuilder::NodeOut> vars = {{"var0", 0, DT_RESOURCE},
+                                               {"var1", 0, DT_RESOURCE}};
+  std::vector<NodeDefBuilder::NodeOut> grads = {{"grad0", 0, DT_FLOAT},
+                                                {"grad1", 0, DT_FLOAT}};
+  NodeDefBuilder builder("test", "_MultiResourceApplyAdam");
+  builder.Input(vars).Input(vars).Input(vars);
+  for (int i = 0; i < 6; ++i) {
+    builder.Input("scalar", i, DT_FLOAT);
+  }
+  TF_ASSERT_OK(builder.Input(grads).Finalize(&op.node_def));
+
+  // The variables have no known shapes, so each grad can have any shape.
+  INFER_OK(op, "[];[];[];[];[];[];[];[];[];[];[];[];[1];[2,3]", "");
+
+  // beta1_power, beta2_power, lr, beta1, beta2, and epsilon must be scalars.
+  const char err[] = "Shape must be rank 0 but is rank 1";
+  INFER_ERROR(err, op, "?;?;?;?;?;?;[?];?;?;?;?;?;?;?");
+  INFER_ERROR(err, op, "?;?;?;?;?;?;?;?;?;?;?;[?];?;?");
+}
+
 TEST(TrainingOpsTest, ApplyRMSProp_ShapeFn) {
   ShapeInferenceTestOp op("ApplyRMSProp");
 
@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/scanner.h"
 #include "tensorflow/core/platform/str_util.h"
 #include "tensorflow/core/platform/types.h"
@@ -47,7 +48,13 @@ class LibCurlProxy : public LibCurl {
     return libcurl;
   }
 
-  CURL* curl_easy_init() override { return ::curl_easy_init(); }
+  CURL* curl_easy_init() override {
+    CURL* curl = ::curl_easy_init();
+    if (curl != nullptr && share_ != nullptr) {
+      CHECK_CURL_OK(::curl_easy_setopt(curl, CURLOPT_SHARE, share_));
+    }
+    return curl;
+  }
 
   CURLcode curl_easy_setopt(CURL* curl, CURLoption option,
                             uint64 param) override {
@@ -114,6 +121,62 @@ class LibCurlProxy : public LibCurl {
   }
 
   void curl_free(void* p) override { ::curl_free(p); }
+
+ private:
+  LibCurlProxy() {
+    bool share_connections;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_CURL_SHARE_CONNECTIONS",
+                                   /*default_val=*/true, &share_connections));
+    if (share_connections) {
+      share_ = MakeShareHandle();
+    }
+  }
+
+  // Returns a share handle through which all requests share their connection
+  // cache, DNS cache and TLS sessions, so that a new request reuses an idle
+  // connection to the same host instead of resolving the host and doing a TLS
+  // handshake again. Returns nullptr if libcurl does not support it.
+  static CURLSH* MakeShareHandle() {
+    CURLSH* share = ::curl_share_init();
+    if (share == nullptr) {
+      return nullptr;
+    }
+    if (::curl_share_setopt(share, CURLSHOPT_LOCKFUNC, &LockShare) !=
+            CURLSHE_OK ||
+        ::curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, &UnlockShare) !=
+            CURLSHE_OK ||
+        ::curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT) !=
+            CURLSHE_OK ||
+        ::curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS) !=
+            CURLSHE_OK ||
+        ::curl_share_setopt(share, CURLSHOPT_SHARE,
+                            CURL_LOCK_DATA_SSL_SESSION) != CURLSHE_OK) {
+      LOG(WARNING) << "libcurl does not support sharing connections between "
+                      "requests.";
+      ::curl_share_cleanup(share);
+      return nullptr;
+    }
+    return share;
+  }
+
+  // The locks of the data shared between the requests, by curl_lock_data.
+  static mutex* ShareLocks() {
+    static mutex* locks = new mutex[CURL_LOCK_DATA_LAST];
+    return locks;
+  }
+
+  static void LockShare(CURL* curl, curl_lock_data data,
+                        curl_lock_access access, void* userptr)
+      TF_NO_THREAD_SAFETY_ANALYSIS {
+    ShareLocks()[data].lock();
+  }
+
+  static void UnlockShare(CURL* curl, curl_lock_data data, void* userptr)
+      TF_NO_THREAD_SAFETY_ANALYSIS {
+    ShareLocks()[data].unlock();
+  }
+
+  CURLSH* share_ = nullptr;  // Not owned, lives until the process exits.
 };
 }  // namespace
 
@@ -147,6 +210,8 @@ CurlHttpRequest::CurlHttpRequest(LibCurl* libcurl, Env* env)
   // TODO(b/74351157): Enable HTTP/2.
   CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_HTTP_VERSION,
                                            CURL_HTTP_VERSION_1_1));
+  // Keep idle connections alive, so that they can be reused by later requests.
+  CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_TCP_KEEPALIVE, 1L));
 
   // Set up the progress meter.
   CHECK_CURL_OK(
@@ -101,6 +101,11 @@ class FileBlockCache {
   virtual bool ValidateAndUpdateFileSignature(const string& filename,
                                               int64_t file_signature) = 0;
 
+  /// Records that `filename` is `file_size` bytes long. Caches that read ahead
+  /// of sequential reads only do so for files of known size, so that they never
+  /// read past the end of the file.
+  virtual void UpdateFileSize(const string& filename, size_t file_size) {}
+
   /// Remove all cached blocks for `filename`.
   virtual void RemoveFile(const string& filename) = 0;
 
@@ -35,6 +35,7 @@ limitations under the License.
 #endif
 #include "absl/base/macros.h"
 #include "json/json.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/platform/cloud/curl_http_request.h"
 #include "tensorflow/core/platform/cloud/file_block_cache.h"
@@ -44,6 +45,7 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/numbers.h"
 #include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/protobuf.h"
@@ -51,6 +53,7 @@ limitations under the License.
 #include "tensorflow/core/platform/str_util.h"
 #include "tensorflow/core/platform/stringprintf.h"
 #include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
 
 #ifdef _WIN32
@@ -148,12 +151,44 @@ constexpr char kAppendMode[] = "GCS_APPEND_MODE";
 // default as the multiple API calls required add a risk of stranding temporary
 // objects.
 constexpr char kComposeAppend[] = "compose";
+// The environment variable that enables parallel composite uploads: files of
+// at least this many MB are uploaded in parts of this size, in parallel and
+// while they are being written, and the parts are composed into the object
+// when the file is synced. The parts are temporary objects, which are deleted
+// when the file is destroyed. Parallel uploads are disabled by default, and
+// are not used in the GCS_APPEND_MODE=compose mode.
+constexpr char kCompositeUploadPartSize[] = "GCS_COMPOSITE_UPLOAD_PART_SIZE_MB";
+// The maximum number of parts of a file that are uploaded concurrently.
+constexpr int kCompositeUploadThreads = 16;
+// The maximum number of source objects of a compose request.
+constexpr size_t kMaxComposeSources = 32;
 
 Status GetTmpFilename(string* filename) {
   *filename = io::GetTempFilename("");
   return OkStatus();
 }
 
+/// Copies `size` bytes of `src` starting at `offset` to a new file `dst`.
+Status CopyFileRange(const string& src, uint64 offset, uint64 size,
+                     const string& dst) {
+  std::ifstream in(src, std::ifstream::binary);
+  std::ofstream out(dst, std::ofstream::binary | std::ofstream::trunc);
+  in.seekg(offset);
+  std::vector<char> buffer(std::min<uint64>(size, 1 << 20));
+  while (size > 0 && in.good() && out.good()) {
+    const uint64 n = std::min<uint64>(size, buffer.size());
+    in.read(buffer.data(), n);
+    out.write(buffer.data(), in.gcount());
+    size -= in.gcount();
+  }
+  out.close();
+  if (size > 0 || !out.good()) {
+    return errors::Internal(
+        "Could not copy a part of the internal temporary file.");
+  }
+  return OkStatus();
+}
+
 /// Appends a trailing slash if the name doesn't already have one.
 string MaybeAppendSlash(const string& name) {
   if (name.empty()) {
@@ -428,7 +463,8 @@ class GcsWritableFile : public WritableFile {
                   RetryConfig retry_config, bool compose_append,
                   SessionCreator session_creator,
                   ObjectUploader object_uploader, StatusPoller status_poller,
-                  GenerationGetter generation_getter)
+                  GenerationGetter generation_getter,
+                  uint64 composite_upload_part_size = 0)
       : bucket_(bucket),
         object_(object),
         filesystem_(filesystem),
@@ -441,7 +477,9 @@ class GcsWritableFile : public WritableFile {
         session_creator_(std::move(session_creator)),
         object_uploader_(std::move(object_uploader)),
         status_poller_(std::move(status_poller)),
-        generation_getter_(std::move(generation_getter)) {
+        generation_getter_(std::move(generation_getter)),
+        composite_upload_part_size_(
+            compose_append ? 0 : composite_upload_part_size) {
     // TODO: to make it safer, outfile_ should be constructed from an FD
     VLOG(3) << "GcsWritableFile: " << GetGcsPath();
     if (GetTmpFilename(&tmp_content_filename_).ok()) {
@@ -475,7 +513,8 @@ class GcsWritableFile : public WritableFile {
         session_creator_(std::move(session_creator)),
         object_uploader_(std::move(object_uploader)),
         status_poller_(std::move(status_poller)),
-        generation_getter_(std::move(generation_getter)) {
+        generation_getter_(std::move(generation_getter)),
+        composite_upload_part_size_(0) {
     VLOG(3) << "GcsWritableFile: " << GetGcsPath() << "with existing file "
             << tmp_content_filename;
     tmp_content_filename_ = tmp_content_filename;
@@ -485,6 +524,9 @@ class GcsWritableFile : public WritableFile {
 
   ~GcsWritableFile() override {
     Close().IgnoreError();
+    // Destroying upload_pool_ will block until the part uploads are done.
+    upload_pool_.reset();
+    DeleteCompositeParts();
     std::remove(tmp_content_filename_.c_str());
   }
 
@@ -497,6 +539,9 @@ class GcsWritableFile : public WritableFile {
       return errors::Internal(
           "Could not append to the internal temporary file.");
     }
+    if (composite_upload_part_size_ > 0) {
+      return StartCompositeUploads(/*include_tail=*/false);
+    }
     return OkStatus();
   }
 
@@ -556,6 +601,9 @@ class GcsWritableFile : public WritableFile {
       return errors::Internal(
           "Could not write to the internal temporary file.");
     }
+    if (!composite_parts_.empty()) {
+      return SyncCompositeParts();
+    }
     UploadSessionHandle session_handle;
     uint64 start_offset = 0;
     string object_to_upload = object_;
@@ -714,6 +762,174 @@ class GcsWritableFile : public WritableFile {
     return status;
   }
 
+  /// \brief A part of the file that is uploaded to a temporary object, in
+  /// parallel with the other parts, for a parallel composite upload.
+  struct CompositePart {
+    uint64 offset;
+    uint64 size;
+    string object;
+    /// The status of the last upload, which is set before `done` is notified.
+    Status status;
+    std::unique_ptr<Notification> done;
+  };
+
+  /// Starts uploading the parts of the file that have not been uploaded yet.
+  /// The last part is only uploaded if it is full, unless `include_tail`.
+  Status StartCompositeUploads(bool include_tail) {
+    uint64 file_size;
+    TF_RETURN_IF_ERROR(GetCurrentFileSize(&file_size));
+    if (file_size - composite_end_ < composite_upload_part_size_ &&
+        !include_tail) {
+      return OkStatus();
+    }
+    // The parts are copied from the temporary file.
+    outfile_.flush();
+    if (!outfile_.good()) {
+      return errors::Internal(
+          "Could not write to the internal temporary file.");
+    }
+    while (composite_end_ < file_size) {
+      const uint64 size =
+          std::min(composite_upload_part_size_, file_size - composite_end_);
+      if (size < composite_upload_part_size_ && !include_tail) {
+        break;
+      }
+      auto part = std::make_unique<CompositePart>();
+      part->offset = composite_end_;
+      part->size = size;
+      part->object =
+          strings::StrCat(io::Dirname(object_), "/.tmpcompose/",
+                          io::Basename(object_), ".part.", composite_end_);
+      composite_end_ += size;
+      StartCompositeUpload(part.get());
+      composite_parts_.push_back(std::move(part));
+    }
+    return OkStatus();
+  }
+
+  void StartCompositeUpload(CompositePart* part) {
+    if (upload_pool_ == nullptr) {
+      upload_pool_ = std::make_unique<thread::ThreadPool>(
+          Env::Default(), "gcs_composite_upload", kCompositeUploadThreads);
+    }
+    part->done = std::make_unique<Notification>();
+    upload_pool_->Schedule([this, part]() {
+      part->status = UploadCompositePart(*part);
+      part->done->Notify();
+    });
+  }
+
+  /// Uploads `part` from a copy of its range of the temporary file, so that
+  /// the file can be appended to during the upload.
+  Status UploadCompositePart(const CompositePart& part) {
+    string part_filename;
+    TF_RETURN_IF_ERROR(GetTmpFilename(&part_filename));
+    auto remove_part_file = gtl::MakeCleanup(
+        [&part_filename]() { std::remove(part_filename.c_str()); });
+    TF_RETURN_IF_ERROR(CopyFileRange(tmp_content_filename_, part.offset,
+                                     part.size, part_filename));
+    return RetryingUtils::CallWithRetries(
+        [&part, &part_filename, this]() {
+          UploadSessionHandle session_handle;
+          TF_RETURN_IF_ERROR(session_creator_(
+              /*start_offset=*/0, part.object, bucket_, part.size,
+              GetGcsPathWithObject(part.object), &session_handle));
+          return object_uploader_(session_handle.session_uri,
+                                  /*start_offset=*/0,
+                                  /*already_uploaded=*/0, part_filename,
+                                  part.size, GetGcsPathWithObject(part.object));
+        },
+        retry_config_);
+  }
+
+  /// Uploads the rest of the file, waits for all the parts to be uploaded,
+  /// and composes them into the object.
+  Status SyncCompositeParts() {
+    // Retry the parts that failed to upload in the previous Sync().
+    for (auto& part : composite_parts_) {
+      if (part->done->HasBeenNotified() && !part->status.ok()) {
+        StartCompositeUpload(part.get());
+      }
+    }
+    TF_RETURN_IF_ERROR(StartCompositeUploads(/*include_tail=*/true));
+    Status status;
+    for (auto& part : composite_parts_) {
+      part->done->WaitForNotification();
+      status.Update(part->status);
+    }
+    if (!status.ok()) {
+      // The failed parts are uploaded again when RetryingFileSystem retries
+      // Sync().
+      return errors::Unavailable(strings::StrCat(
+          "Upload to gs://", bucket_, "/", object_,
+          " failed, caused by: ", status.error_message()));
+    }
+    // A compose request has at most kMaxComposeSources sources, so the parts
+    // are appended to the object in several requests if there are more.
+    std::vector<string> sources;
+    size_t next_part = 0;
+    while (next_part < composite_parts_.size()) {
+      sources.clear();
+      if (next_part > 0) {
+        sources.push_back(object_);
+      }
+      while (sources.size() < kMaxComposeSources &&
+             next_part < composite_parts_.size()) {
+        sources.push_back(composite_parts_[next_part++]->object);
+      }
+      TF_RETURN_IF_ERROR(ComposeObjects(sources));
+    }
+    // Erase the file from the file cache on every successful write.
+    file_cache_erase_();
+    return OkStatus();
+  }
+
+  /// Replaces the object with the concatenation of `sources`.
+  Status ComposeObjects(const std::vector<string>& sources) {
+    VLOG(3) << "ComposeObjects: " << sources.size() << " objects to "
+            << GetGcsPath();
+    string source_objects;
+    for (const string& source : sources) {
+      strings::StrAppend(&source_objects, source_objects.empty() ? "" : ",",
+                         "{'name': '", source, "'}");
+    }
+    const string request_body =
+        strings::StrCat("{'sourceObjects': [", source_objects, "]}");
+    return RetryingUtils::CallWithRetries(
+        [&request_body, this]() {
+          std::unique_ptr<HttpRequest> request;
+          TF_RETURN_IF_ERROR(filesystem_->CreateHttpRequest(&request));
+          request->SetUri(strings::StrCat(kGcsUriBase, "b/", bucket_, "/o/",
+                                          request->EscapeString(object_),
+                                          "/compose"));
+          request->SetTimeouts(timeouts_->connect, timeouts_->idle,
+                               timeouts_->metadata);
+          request->AddHeader("content-type", "application/json");
+          request->SetPostFromBuffer(request_body.c_str(), request_body.size());
+          TF_RETURN_WITH_CONTEXT_IF_ERROR(request->Send(),
+                                          " when composing to ", GetGcsPath());
+          return OkStatus();
+        },
+        retry_config_);
+  }
+
+  /// Deletes the temporary objects of the parts of the file.
+  void DeleteCompositeParts() {
+    for (const auto& part : composite_parts_) {
+      const string part_path = GetGcsPathWithObject(part->object);
+      Status status = RetryingUtils::DeleteWithRetries(
+          [&part_path, this]() {
+            return filesystem_->DeleteFile(part_path, nullptr);
+          },
+          retry_config_);
+      if (!status.ok() && !errors::IsNotFound(status)) {
+        LOG(WARNING) << "Could not delete the temporary object " << part_path
+                     << ": " << status;
+      }
+    }
+    composite_parts_.clear();
+  }
+
   string GetGcsPathWithObject(string object) const {
     return strings::StrCat("gs://", bucket_, "/", object);
   }
@@ -735,6 +951,14 @@ class GcsWritableFile : public WritableFile {
   const ObjectUploader object_uploader_;
   const StatusPoller status_poller_;
   const GenerationGetter generation_getter_;
+  // The size of the parts of parallel composite uploads, or 0 if they are
+  // disabled.
+  const uint64 composite_upload_part_size_;
+  // The parts of the file that are uploaded in parallel, in order.
+  std::vector<std::unique_ptr<CompositePart>> composite_parts_;
+  // The end of the last part.
+  uint64 composite_end_ = 0;
+  std::unique_ptr<thread::ThreadPool> upload_pool_;
 };
 
 class GcsReadOnlyMemoryRegion : public ReadOnlyMemoryRegion {
@@ -803,12 +1027,22 @@ GcsFileSystem::GcsFileSystem(bool make_default_cache) {
   if (GetEnvVar(kMaxStaleness, strings::safe_strtou64, &value)) {
     max_staleness = value;
   }
+
+  if (GetEnvVar(kReadaheadBlocks, strings::safe_strtou64, &value)) {
+    readahead_blocks_ = value;
+  }
+
+  if (GetEnvVar(kScanResistantCache, strings::safe_strtou64, &value)) {
+    scan_resistant_cache_ = value != 0;
+  }
   if (!make_default_cache) {
     max_bytes = 0;
   }
   VLOG(1) << "GCS cache max size = " << max_bytes << " ; "
           << "block size = " << block_size_ << " ; "
-          << "max staleness = " << max_staleness;
+          << "max staleness = " << max_staleness << " ; "
+          << "readahead blocks = " << readahead_blocks_ << " ; "
+          << "scan resistant = " << scan_resistant_cache_;
   file_block_cache_ = MakeFileBlockCache(block_size_, max_bytes, max_staleness);
   // Apply overrides for the stat cache max age and max entries, if provided.
   uint64 stat_cache_max_age = kStatCacheDefaultMaxAge;
@@ -929,6 +1163,10 @@ GcsFileSystem::GcsFileSystem(bool make_default_cache) {
   } else {
     compose_append_ = false;
   }
+
+  if (GetEnvVar(kCompositeUploadPartSize, strings::safe_strtou64, &value)) {
+    composite_upload_part_size_ = value * 1024 * 1024;
+  }
 }
 
 GcsFileSystem::GcsFileSystem(
@@ -983,6 +1221,7 @@ Status GcsFileSystem::NewRandomAccessFile(
             << "File signature has been changed. Refreshing the cache. Path: "
             << fname;
       }
+      file_block_cache_->UpdateFileSize(fname, stat.base.length);
       *result = StringPiece();
       size_t bytes_transferred;
       TF_RETURN_IF_ERROR(file_block_cache_->Read(fname, offset, n, scratch,
@@ -1036,7 +1275,8 @@ std::unique_ptr<FileBlockCache> GcsFileSystem::MakeFileBlockCache(
              size_t* bytes_transferred) {
         return LoadBufferFromGCS(filename, offset, n, buffer,
                                  bytes_transferred);
-      }));
+      },
+      Env::Default(), readahead_blocks_, scan_resistant_cache_));
 
   // Check if cache is enabled here to avoid unnecessary mutex contention.
   cache_enabled_ = file_block_cache->IsCacheEnabled();
@@ -1303,7 +1543,7 @@ Status GcsFileSystem::NewWritableFile(const string& fname,
       bucket, object, this, &timeouts_,
       [this, fname]() { ClearFileCaches(fname); }, retry_config_,
       compose_append_, session_creator, object_uploader, status_poller,
-      generation_getter));
+      generation_getter, composite_upload_part_size_));
   return OkStatus();
 }
 
@@ -62,6 +62,14 @@ constexpr size_t kDefaultMaxCacheSize = 0;
 // will be evicted on the next read.
 constexpr char kMaxStaleness[] = "GCS_READ_CACHE_MAX_STALENESS";
 constexpr uint64 kDefaultMaxStaleness = 0;
+// The environment variable that sets the maximum number of blocks that are
+// fetched concurrently ahead of sequential reads from GCS. A value of 0, the
+// default, disables readahead.
+constexpr char kReadaheadBlocks[] = "GCS_READ_CACHE_READAHEAD_BLOCKS";
+// The environment variable that, if set to a non-zero value, makes the block
+// cache scan resistant, so that files that are read once from start to end do
+// not evict the blocks that are read repeatedly (see RamFileBlockCache).
+constexpr char kScanResistantCache[] = "GCS_READ_CACHE_SCAN_RESISTANT";
 
 // Helper function to extract an environment variable and convert it into a
 // value of type T.
@@ -415,6 +423,14 @@ class GcsFileSystem : public FileSystem {
   // Reads smaller than block_size_ will trigger a read of block_size_.
   uint64 block_size_;
 
+  // The maximum number of blocks that the block cache reads ahead of
+  // sequential reads.
+  size_t readahead_blocks_ = 0;
+
+  // True if the block cache protects blocks that are read repeatedly from
+  // sequential scans.
+  bool scan_resistant_cache_ = false;
+
   // block_cache_lock_ protects the file_block_cache_ pointer (Note that
   // FileBlockCache instances are themselves threadsafe).
   mutex block_cache_lock_;
@@ -435,6 +451,9 @@ class GcsFileSystem : public FileSystem {
   std::unique_ptr<BucketLocationCache> bucket_location_cache_;
   std::unordered_set<string> allowed_locations_;
   bool compose_append_;
+  // Files of at least this many bytes are uploaded in parts of this size, in
+  // parallel, and composed into their object. 0 disables parallel uploads.
+  uint64 composite_upload_part_size_ = 0;
 
   GcsStatsInterface* stats_ = nullptr;  // Not owned.
 
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/platform/cloud/ram_file_block_cache.h"
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include "tensorflow/core/lib/gtl/cleanup.h"
@@ -63,21 +64,56 @@ void RamFileBlockCache::Trim() {
   while (!lru_list_.empty() && cache_size_ > max_bytes_) {
     RemoveBlock(block_map_.find(lru_list_.back()));
   }
+  while (!protected_list_.empty() && cache_size_ > max_bytes_) {
+    RemoveBlock(block_map_.find(protected_list_.back()));
+  }
+}
+
+void RamFileBlockCache::Protect(const Key& key,
+                                const std::shared_ptr<Block>& block) {
+  lru_list_.erase(block->lru_iterator);
+  protected_list_.push_front(key);
+  block->lru_iterator = protected_list_.begin();
+  block->is_protected = true;
+  protected_size_ += block->data.capacity();
+  // Move the least recently used protected blocks back to the front of the
+  // probationary segment.
+  while (protected_size_ > max_protected_bytes_ &&
+         protected_list_.size() > 1) {
+    const std::shared_ptr<Block>& demoted =
+        block_map_.find(protected_list_.back())->second;
+    lru_list_.push_front(protected_list_.back());
+    protected_list_.pop_back();
+    demoted->lru_iterator = lru_list_.begin();
+    demoted->is_protected = false;
+    protected_size_ -= demoted->data.capacity();
+  }
 }
 
 /// Move the block to the front of the LRU list if it isn't already there.
 Status RamFileBlockCache::UpdateLRU(const Key& key,
-                                    const std::shared_ptr<Block>& block) {
+                                    const std::shared_ptr<Block>& block,
+                                    size_t read_begin, size_t read_end) {
   mutex_lock lock(mu_);
   if (block->timestamp == 0) {
     // The block was evicted from another thread. Allow it to remain evicted.
     return OkStatus();
   }
-  if (block->lru_iterator != lru_list_.begin()) {
+  if (block->is_protected) {
+    if (block->lru_iterator != protected_list_.begin()) {
+      protected_list_.erase(block->lru_iterator);
+      protected_list_.push_front(key);
+      block->lru_iterator = protected_list_.begin();
+    }
+  } else if (max_protected_bytes_ > 0 && read_begin < block->read_end) {
+    // The block is read again, rather than scanned.
+    Protect(key, block);
+  } else if (block->lru_iterator != lru_list_.begin()) {
     lru_list_.erase(block->lru_iterator);
     lru_list_.push_front(key);
     block->lru_iterator = lru_list_.begin();
   }
+  block->read_end = std::max(block->read_end, read_end);
 
   // Check for inconsistent state. If there is a block later in the same file
   // in the cache, and our current block is not block size, this likely means
@@ -182,6 +218,7 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
   if (finish < offset + n) {
     finish += block_size_;
   }
+  MaybeReadAhead(filename, offset, n, finish);
   size_t total_bytes_transferred = 0;
   // Now iterate through the blocks, reading them one at a time.
   for (size_t pos = start; pos < finish; pos += block_size_) {
@@ -191,9 +228,11 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
     std::shared_ptr<Block> block = Lookup(key);
     DCHECK(block) << "No block for key " << key.first << "@" << key.second;
     TF_RETURN_IF_ERROR(MaybeFetch(key, block));
-    TF_RETURN_IF_ERROR(UpdateLRU(key, block));
     // Copy the relevant portion of the block into the result buffer.
     const auto& data = block->data;
+    TF_RETURN_IF_ERROR(UpdateLRU(
+        key, block, offset > pos ? offset - pos : 0,
+        std::min(offset + n - pos, static_cast<size_t>(data.size()))));
     if (offset >= pos + data.size()) {
       // The requested offset is at or beyond the end of the file. This can
       // happen if `offset` is not block-aligned, and the read returns the last
@@ -244,6 +283,68 @@ bool RamFileBlockCache::ValidateAndUpdateFileSignature(const string& filename,
   return true;
 }
 
+void RamFileBlockCache::UpdateFileSize(const string& filename,
+                                       size_t file_size) {
+  if (readahead_pool_ == nullptr) {
+    return;
+  }
+  mutex_lock lock(mu_);
+  readahead_[filename].file_size = file_size;
+}
+
+void RamFileBlockCache::MaybeReadAhead(const string& filename, size_t offset,
+                                       size_t n, size_t finish) {
+  if (readahead_pool_ == nullptr) {
+    return;
+  }
+  std::vector<Key> keys;
+  {
+    mutex_lock lock(mu_);
+    auto entry = readahead_.find(filename);
+    if (entry == readahead_.end()) {
+      // The file size is unknown, or the file has been read to the end.
+      return;
+    }
+    ReadaheadState& state = entry->second;
+    if (offset + n >= state.file_size) {
+      readahead_.erase(entry);
+      return;
+    }
+    if (offset != state.next_offset) {
+      state.next_offset = offset + n;
+      state.num_blocks = 0;
+      state.end = 0;
+      return;
+    }
+    state.next_offset = offset + n;
+    state.num_blocks = std::min(max_readahead_blocks_,
+                                std::max<size_t>(1, 2 * state.num_blocks));
+    // The blocks of this read are fetched by the reader.
+    const size_t end = std::min(finish + state.num_blocks * block_size_,
+                                state.file_size);
+    for (size_t pos = std::max(state.end, finish); pos < end;
+         pos += block_size_) {
+      Key key = std::make_pair(filename, pos);
+      if (block_map_.find(key) == block_map_.end()) {
+        keys.push_back(std::move(key));
+      }
+    }
+    state.end = std::max(state.end, end);
+  }
+  for (Key& key : keys) {
+    readahead_pool_->Schedule(
+        [this, key = std::move(key)]() { ReadAhead(key); });
+  }
+}
+
+void RamFileBlockCache::ReadAhead(const Key& key) {
+  std::shared_ptr<Block> block = Lookup(key);
+  // If the fetch fails, the reader fetches the block again.
+  if (MaybeFetch(key, block).ok()) {
+    UpdateLRU(key, block, /*read_begin=*/0, /*read_end=*/0).IgnoreError();
+  }
+}
+
 size_t RamFileBlockCache::CacheSize() const {
   mutex_lock lock(mu_);
   return cache_size_;
@@ -270,7 +371,10 @@ void RamFileBlockCache::Flush() {
   mutex_lock lock(mu_);
   block_map_.clear();
   lru_list_.clear();
+  protected_list_.clear();
+  protected_size_ = 0;
   lra_list_.clear();
+  readahead_.clear();
   cache_size_ = 0;
 }
 
@@ -280,6 +384,7 @@ void RamFileBlockCache::RemoveFile(const string& filename) {
 }
 
 void RamFileBlockCache::RemoveFile_Locked(const string& filename) {
+  readahead_.erase(filename);
   Key begin = std::make_pair(filename, 0);
   auto it = block_map_.lower_bound(begin);
   while (it != block_map_.end() && it->first.first == filename) {
@@ -293,7 +398,12 @@ void RamFileBlockCache::RemoveBlock(BlockMap::iterator entry) {
   // This signals that the block is removed, and should not be inadvertently
   // reinserted into the cache in UpdateLRU.
   entry->second->timestamp = 0;
-  lru_list_.erase(entry->second->lru_iterator);
+  if (entry->second->is_protected) {
+    protected_list_.erase(entry->second->lru_iterator);
+    protected_size_ -= entry->second->data.capacity();
+  } else {
+    lru_list_.erase(entry->second->lru_iterator);
+  }
   lra_list_.erase(entry->second->lra_iterator);
   cache_size_ -= entry->second->data.capacity();
   block_map_.erase(entry);
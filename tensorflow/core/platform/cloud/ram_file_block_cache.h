@@ -30,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/stringpiece.h"
 #include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
@@ -50,22 +51,50 @@ class RamFileBlockCache : public FileBlockCache {
                                size_t* bytes_transferred)>
       BlockFetcher;
 
+  /// If `max_readahead_blocks` is positive, sequential reads of a file of known
+  /// size (see `UpdateFileSize`) fetch the blocks that follow them from a pool
+  /// of `max_readahead_blocks` threads, so that several blocks are fetched
+  /// concurrently ahead of the reader. The number of blocks read ahead of a
+  /// file doubles with each sequential read, up to `max_readahead_blocks`, and
+  /// drops to zero when the file is read at another offset.
+  ///
+  /// If `scan_resistant` is true, the cache is a segmented LRU cache: blocks
+  /// are first cached in a probationary segment, and only move to a protected
+  /// segment, of up to `kProtectedFraction` of `max_bytes`, when a part of
+  /// them that has already been read is read again. Blocks are evicted from
+  /// the probationary segment first, so that a file that is read once from
+  /// start to end, e.g. a checkpoint that is restored, does not evict the
+  /// blocks that are read repeatedly, e.g. of vocabulary files.
   RamFileBlockCache(size_t block_size, size_t max_bytes, uint64 max_staleness,
-                    BlockFetcher block_fetcher, Env* env = Env::Default())
+                    BlockFetcher block_fetcher, Env* env = Env::Default(),
+                    size_t max_readahead_blocks = 0,
+                    bool scan_resistant = false)
       : block_size_(block_size),
         max_bytes_(max_bytes),
         max_staleness_(max_staleness),
         block_fetcher_(block_fetcher),
-        env_(env) {
+        env_(env),
+        max_readahead_blocks_(IsCacheEnabled() ? max_readahead_blocks : 0),
+        max_protected_bytes_(
+            scan_resistant ? static_cast<size_t>(max_bytes * kProtectedFraction)
+                           : 0) {
     if (max_staleness_ > 0) {
       pruning_thread_.reset(env_->StartThread(ThreadOptions(), "TF_prune_FBC",
                                               [this] { Prune(); }));
     }
+    if (max_readahead_blocks_ > 0) {
+      readahead_pool_ = std::make_unique<thread::ThreadPool>(
+          env_, "TF_readahead_FBC", max_readahead_blocks_);
+    }
     VLOG(1) << "GCS file block cache is "
-            << (IsCacheEnabled() ? "enabled" : "disabled");
+            << (IsCacheEnabled() ? "enabled" : "disabled")
+            << ", reading ahead up to " << max_readahead_blocks_ << " blocks";
   }
 
   ~RamFileBlockCache() override {
+    // Destroying readahead_pool_ will block until the blocks being read ahead
+    // have been fetched.
+    readahead_pool_.reset();
     if (pruning_thread_) {
       stop_pruning_thread_.Notify();
       // Destroying pruning_thread_ will block until Prune() receives the above
@@ -99,6 +128,9 @@ class RamFileBlockCache : public FileBlockCache {
                                       int64_t file_signature) override
       TF_LOCKS_EXCLUDED(mu_);
 
+  void UpdateFileSize(const string& filename, size_t file_size) override
+      TF_LOCKS_EXCLUDED(mu_);
+
   /// Remove all cached blocks for `filename`.
   void RemoveFile(const string& filename) override TF_LOCKS_EXCLUDED(mu_);
 
@@ -119,6 +151,9 @@ class RamFileBlockCache : public FileBlockCache {
     return block_size_ > 0 && max_bytes_ > 0;
   }
 
+  /// The fraction of the cache that scan resistant caches protect from scans.
+  static constexpr double kProtectedFraction = 0.8;
+
  private:
   /// The size of the blocks stored in the LRU cache, as well as the size of the
   /// reads from the underlying filesystem.
@@ -131,6 +166,11 @@ class RamFileBlockCache : public FileBlockCache {
   const BlockFetcher block_fetcher_;
   /// The Env from which we read timestamps.
   Env* const env_;  // not owned
+  /// The maximum number of blocks fetched ahead of sequential reads of a file.
+  const size_t max_readahead_blocks_;
+  /// The maximum number of bytes in the protected segment of the cache, or 0
+  /// if the cache is a plain LRU cache.
+  const size_t max_protected_bytes_;
 
   /// \brief The key type for the file block cache.
   ///
@@ -169,8 +209,14 @@ class RamFileBlockCache : public FileBlockCache {
   struct Block {
     /// The block data.
     std::vector<char> data;
-    /// A list iterator pointing to the block's position in the LRU list.
+    /// A list iterator pointing to the block's position in the LRU list, or in
+    /// the protected list if `is_protected`.
     std::list<Key>::iterator lru_iterator;
+    /// True if the block is in the protected segment of the cache.
+    bool is_protected = false;
+    /// The end of the part of the block that has been read, relative to the
+    /// start of the block.
+    size_t read_end = 0;
     /// A list iterator pointing to the block's position in the LRA list.
     std::list<Key>::iterator lra_iterator;
     /// The timestamp (seconds since epoch) at which the block was cached.
@@ -203,9 +249,15 @@ class RamFileBlockCache : public FileBlockCache {
   /// Trim the block cache to make room for another entry.
   void Trim() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
-  /// Update the LRU iterator for the block at `key`.
-  Status UpdateLRU(const Key& key, const std::shared_ptr<Block>& block)
-      TF_LOCKS_EXCLUDED(mu_);
+  /// Update the LRU iterator for the block at `key`, after a read of the
+  /// bytes [read_begin, read_end) of the block. Reads ahead of the reader
+  /// read no bytes.
+  Status UpdateLRU(const Key& key, const std::shared_ptr<Block>& block,
+                   size_t read_begin, size_t read_end) TF_LOCKS_EXCLUDED(mu_);
+
+  /// Move the probationary block at `key` to the protected segment.
+  void Protect(const Key& key, const std::shared_ptr<Block>& block)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
   /// Remove all blocks of a file, with mu_ already held.
   void RemoveFile_Locked(const string& filename)
@@ -215,6 +267,26 @@ class RamFileBlockCache : public FileBlockCache {
   /// cache size accordingly.
   void RemoveBlock(BlockMap::iterator entry) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  /// Schedule the fetches of the blocks that follow a read of `n` bytes at
+  /// `offset`, whose blocks end at `finish`, if the file is read sequentially.
+  void MaybeReadAhead(const string& filename, size_t offset, size_t n,
+                      size_t finish) TF_LOCKS_EXCLUDED(mu_);
+
+  /// Fetch the block at `key` ahead of the reader.
+  void ReadAhead(const Key& key) TF_LOCKS_EXCLUDED(mu_);
+
+  /// \brief The readahead state of a file.
+  struct ReadaheadState {
+    /// The size of the file.
+    size_t file_size = 0;
+    /// The offset at which the next read is sequential.
+    size_t next_offset = 0;
+    /// The number of blocks to read ahead of the next sequential read.
+    size_t num_blocks = 0;
+    /// The end of the blocks that have been scheduled to be read ahead.
+    size_t end = 0;
+  };
+
   /// The cache pruning thread that removes files with expired blocks.
   std::unique_ptr<Thread> pruning_thread_;
 
@@ -228,9 +300,16 @@ class RamFileBlockCache : public FileBlockCache {
   BlockMap block_map_ TF_GUARDED_BY(mu_);
 
   /// The LRU list of block keys. The front of the list identifies the most
-  /// recently accessed block.
+  /// recently accessed block. In scan resistant caches, this is the list of
+  /// the probationary blocks.
   std::list<Key> lru_list_ TF_GUARDED_BY(mu_);
 
+  /// The LRU list of the keys of the protected blocks.
+  std::list<Key> protected_list_ TF_GUARDED_BY(mu_);
+
+  /// The combined number of bytes in the protected blocks.
+  size_t protected_size_ TF_GUARDED_BY(mu_) = 0;
+
   /// The LRA (least recently added) list of block keys. The front of the list
   /// identifies the most recently added block.
   ///
@@ -243,6 +322,14 @@ class RamFileBlockCache : public FileBlockCache {
 
   // A filename->file_signature map.
   std::map<string, int64_t> file_signature_map_ TF_GUARDED_BY(mu_);
+
+  /// The readahead state of the files of known size that have not been read
+  /// to the end.
+  std::map<string, ReadaheadState> readahead_ TF_GUARDED_BY(mu_);
+
+  /// The threads that fetch blocks ahead of the readers, if readahead is
+  /// enabled.
+  std::unique_ptr<thread::ThreadPool> readahead_pool_;
 };
 
 }  // namespace tensorflow
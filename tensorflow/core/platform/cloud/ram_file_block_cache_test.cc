@@ -15,7 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/platform/cloud/ram_file_block_cache.h"
 
+#include <algorithm>
 #include <cstring>
+#include <map>
+#include <vector>
 
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/blocking_counter.h"
@@ -566,5 +569,102 @@ TEST(RamFileBlockCacheTest, Flush) {
   EXPECT_EQ(calls, 2);
 }
 
+TEST(RamFileBlockCacheTest, ReadAhead) {
+  const size_t block_size = 8;
+  const size_t file_size = 10 * block_size - 3;
+  mutex mu;
+  std::map<size_t, int> fetches;
+  auto fetcher = [&mu, &fetches, file_size](
+                     const string& filename, size_t offset, size_t n,
+                     char* buffer, size_t* bytes_transferred) {
+    {
+      mutex_lock l(mu);
+      ++fetches[offset];
+    }
+    EXPECT_LT(offset, file_size);
+    *bytes_transferred = std::min(n, file_size - offset);
+    memset(buffer, 'a' + offset / block_size, *bytes_transferred);
+    return OkStatus();
+  };
+  {
+    RamFileBlockCache cache(block_size, 100 * block_size, 0, fetcher,
+                            Env::Default(), /*max_readahead_blocks=*/4);
+    cache.UpdateFileSize("a", file_size);
+    std::vector<char> out;
+    for (size_t offset = 0; offset < file_size; offset += block_size) {
+      Status status = ReadCache(&cache, "a", offset, block_size, &out);
+      if (offset + block_size <= file_size) {
+        TF_EXPECT_OK(status);
+      }
+      ASSERT_FALSE(out.empty());
+      EXPECT_EQ(out[0], 'a' + offset / block_size);
+    }
+  }
+  // Every block was fetched once, either by the reader or ahead of it.
+  EXPECT_EQ(fetches.size(), 10);
+  for (const auto& fetch : fetches) {
+    EXPECT_EQ(fetch.second, 1) << "offset " << fetch.first;
+  }
+}
+
+TEST(RamFileBlockCacheTest, NoReadAheadOfRandomReads) {
+  const size_t block_size = 8;
+  mutex mu;
+  std::vector<size_t> fetches;
+  auto fetcher = [&mu, &fetches](const string& filename, size_t offset,
+                                 size_t n, char* buffer,
+                                 size_t* bytes_transferred) {
+    {
+      mutex_lock l(mu);
+      fetches.push_back(offset);
+    }
+    memset(buffer, 'x', n);
+    *bytes_transferred = n;
+    return OkStatus();
+  };
+  {
+    RamFileBlockCache cache(block_size, 100 * block_size, 0, fetcher,
+                            Env::Default(), /*max_readahead_blocks=*/4);
+    cache.UpdateFileSize("a", 10 * block_size);
+    std::vector<char> out;
+    TF_EXPECT_OK(ReadCache(&cache, "a", 5 * block_size, block_size, &out));
+    TF_EXPECT_OK(ReadCache(&cache, "a", 2 * block_size, block_size, &out));
+    // Files of unknown size are not read ahead.
+    TF_EXPECT_OK(ReadCache(&cache, "b", 0, block_size, &out));
+    TF_EXPECT_OK(ReadCache(&cache, "b", block_size, block_size, &out));
+  }
+  EXPECT_EQ(fetches.size(), 4);
+}
+
+TEST(RamFileBlockCacheTest, ScanResistant) {
+  const size_t block_size = 16;
+  std::map<string, int> fetches;
+  auto fetcher = [&fetches](const string& filename, size_t offset, size_t n,
+                            char* buffer, size_t* bytes_transferred) {
+    ++fetches[filename];
+    memset(buffer, 'x', n);
+    *bytes_transferred = n;
+    return OkStatus();
+  };
+  for (bool scan_resistant : {false, true}) {
+    fetches.clear();
+    RamFileBlockCache cache(block_size, 4 * block_size, 0, fetcher,
+                            Env::Default(), /*max_readahead_blocks=*/0,
+                            scan_resistant);
+    std::vector<char> out;
+    // The first block of "hot" is read twice, and "scan" is read once from
+    // start to end, with more blocks than the cache holds.
+    TF_EXPECT_OK(ReadCache(&cache, "hot", 0, block_size, &out));
+    TF_EXPECT_OK(ReadCache(&cache, "hot", 0, block_size, &out));
+    for (size_t offset = 0; offset < 10 * block_size; offset += block_size) {
+      TF_EXPECT_OK(ReadCache(&cache, "scan", offset, block_size, &out));
+    }
+    TF_EXPECT_OK(ReadCache(&cache, "hot", 0, block_size, &out));
+    EXPECT_EQ(fetches["hot"], scan_resistant ? 1 : 2);
+    EXPECT_EQ(fetches["scan"], 10);
+    EXPECT_LE(cache.CacheSize(), 4 * block_size);
+  }
+}
+
 }  // namespace
 }  // namespace tensorflow
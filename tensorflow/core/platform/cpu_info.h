@@ -64,6 +64,11 @@ int NumTotalCPUs();
 // identified.  If successful, the return value will be in [0, NumTotalCPUs()).
 int GetCurrentCPU();
 
+// Restricts the calling thread to run on CPU `cpu` only, as numbered by
+// GetCurrentCPU(). Returns false if the thread could not be pinned, e.g.
+// because the platform doesn't support it.
+bool SetCurrentThreadCPUAffinity(int cpu);
+
 // Returns an estimate of the number of hyperthreads per physical core
 // on the CPU
 int NumHyperthreadsPerCore();
@@ -17,10 +17,17 @@ limitations under the License.
 
 #include <time.h>
 
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "nsync_cv.h"       // NOLINT
 #include "nsync_mu.h"       // NOLINT
 #include "nsync_mu_wait.h"  // NOLINT
 #include "nsync_time.h"     // NOLINT
+#include "tensorflow/core/platform/env_time.h"
+#include "tensorflow/core/platform/mutex_contention.h"
 
 namespace tensorflow {
 
@@ -40,13 +47,36 @@ mutex::mutex() { nsync::nsync_mu_init(mu_cast(&mu_)); }
 
 mutex::mutex(LinkerInitialized x) {}
 
-void mutex::lock() { nsync::nsync_mu_lock(mu_cast(&mu_)); }
+// Acquires `mu` with `lock`, timing the wait of a sample of the contended
+// acquisitions while contention profiling is enabled.
+template <int (*TryLock)(nsync::nsync_mu *), void (*Lock)(nsync::nsync_mu *)>
+static inline void LockAndProfileContention(const mutex *m, nsync::nsync_mu *mu,
+                                            bool shared) {
+  if (TF_PREDICT_FALSE(internal::MutexContentionProfilingEnabled())) {
+    if (TryLock(mu)) return;
+    if (internal::ShouldSampleMutexContention()) {
+      const uint64 start_ns = EnvTime::NowNanos();
+      Lock(mu);
+      internal::RecordMutexContention(m, shared, start_ns, EnvTime::NowNanos());
+      return;
+    }
+  }
+  Lock(mu);
+}
+
+void mutex::lock() {
+  LockAndProfileContention<nsync::nsync_mu_trylock, nsync::nsync_mu_lock>(
+      this, mu_cast(&mu_), /*shared=*/false);
+}
 
 bool mutex::try_lock() { return nsync::nsync_mu_trylock(mu_cast(&mu_)) != 0; };
 
 void mutex::unlock() { nsync::nsync_mu_unlock(mu_cast(&mu_)); }
 
-void mutex::lock_shared() { nsync::nsync_mu_rlock(mu_cast(&mu_)); }
+void mutex::lock_shared() {
+  LockAndProfileContention<nsync::nsync_mu_rtrylock, nsync::nsync_mu_rlock>(
+      this, mu_cast(&mu_), /*shared=*/true);
+}
 
 bool mutex::try_lock_shared() {
   return nsync::nsync_mu_rtrylock(mu_cast(&mu_)) != 0;
@@ -99,6 +129,101 @@ void condition_variable::notify_all() {
   nsync::nsync_cv_broadcast(cv_cast(&cv_));
 }
 
+namespace {
+
+// The contention profile. It's guarded by a std::mutex, since waiting on a
+// tensorflow::mutex here would record contention recursively.
+struct ContentionProfile {
+  std::mutex mu;
+  std::unordered_map<const mutex *, const char *> sites;
+  std::unordered_map<std::string, MutexContentionStats> stats;
+  MutexContentionListener listener = nullptr;
+};
+
+ContentionProfile &GetContentionProfile() {
+  static ContentionProfile *profile = new ContentionProfile;
+  return *profile;
+}
+
+// True while the thread records contention, whose own locking isn't profiled.
+thread_local bool recording_contention = false;
+
+}  // namespace
+
+namespace internal {
+
+std::atomic<int> g_mutex_contention_sampling_period{0};
+
+bool ShouldSampleMutexContention() {
+  static thread_local uint32 num_contentions = 0;
+  if (recording_contention) return false;
+  const int sampling_period =
+      g_mutex_contention_sampling_period.load(std::memory_order_relaxed);
+  return sampling_period > 0 && ++num_contentions % sampling_period == 0;
+}
+
+void RecordMutexContention(const mutex *mu, bool shared, uint64 start_ns,
+                           uint64 end_ns) {
+  recording_contention = true;
+  ContentionProfile &profile = GetContentionProfile();
+  MutexContentionEvent event{kUnnamedMutexContentionSite, shared, start_ns,
+                             end_ns};
+  MutexContentionListener listener;
+  {
+    std::lock_guard<std::mutex> lock(profile.mu);
+    auto it = profile.sites.find(mu);
+    if (it != profile.sites.end()) event.site = it->second;
+    MutexContentionStats &stats = profile.stats[event.site];
+    const int64_t wait_ns = end_ns > start_ns ? end_ns - start_ns : 0;
+    ++stats.num_contentions;
+    stats.total_wait_ns += wait_ns;
+    if (wait_ns > stats.max_wait_ns) stats.max_wait_ns = wait_ns;
+    listener = profile.listener;
+  }
+  if (listener != nullptr) listener(event);
+  recording_contention = false;
+}
+
+}  // namespace internal
+
+void SetMutexContentionSamplingPeriod(int sampling_period) {
+  internal::g_mutex_contention_sampling_period.store(
+      sampling_period > 0 ? sampling_period : 0, std::memory_order_relaxed);
+}
+
+MutexContentionSite::MutexContentionSite(const mutex *mu, const char *name)
+    : mu_(mu), named_(internal::MutexContentionProfilingEnabled()) {
+  if (!named_) return;
+  ContentionProfile &profile = GetContentionProfile();
+  std::lock_guard<std::mutex> lock(profile.mu);
+  profile.sites[mu_] = name;
+}
+
+MutexContentionSite::~MutexContentionSite() {
+  if (!named_) return;
+  ContentionProfile &profile = GetContentionProfile();
+  std::lock_guard<std::mutex> lock(profile.mu);
+  profile.sites.erase(mu_);
+}
+
+void SetMutexContentionListener(MutexContentionListener listener) {
+  ContentionProfile &profile = GetContentionProfile();
+  std::lock_guard<std::mutex> lock(profile.mu);
+  profile.listener = listener;
+}
+
+std::vector<MutexContentionStats> GetMutexContentionStats() {
+  ContentionProfile &profile = GetContentionProfile();
+  std::lock_guard<std::mutex> lock(profile.mu);
+  std::vector<MutexContentionStats> result;
+  result.reserve(profile.stats.size());
+  for (const auto &site_and_stats : profile.stats) {
+    result.push_back(site_and_stats.second);
+    result.back().site = site_and_stats.first;
+  }
+  return result;
+}
+
 namespace internal {
 std::cv_status wait_until_system_clock(
     CVData *cv_data, MuData *mu_data,
@@ -22,6 +22,13 @@ limitations under the License.
 
 #if defined(__linux__)
 #include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
 #endif
 #include <sys/stat.h>
 #include <sys/time.h>
@@ -29,11 +36,18 @@ limitations under the License.
 #include <time.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+
 #include "tensorflow/core/platform/default/posix_file_system.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/file_system_helper.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/strcat.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
@@ -45,6 +59,215 @@ using ::tensorflow::errors::IOError;
 // 128KB of copy buffer
 constexpr size_t kPosixCopyFileBufferSize = 128 * 1024;
 
+#if defined(__linux__) && defined(IORING_OFF_SQ_RING) && \
+    defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define TF_POSIX_IO_URING 1
+#endif
+
+#if defined(TF_POSIX_IO_URING)
+namespace {
+
+// A process-wide io_uring that posix files submit their asynchronous reads
+// to, so that a few threads can keep many reads in flight. A single thread
+// reaps the completions and runs the callbacks.
+//
+// The ring is only created if the TF_POSIX_IO_URING_ENTRIES environment
+// variable is set to its number of entries, which bounds the number of reads
+// in flight. Reads beyond that are done synchronously by their caller.
+class IoUring {
+ public:
+  struct Request {
+    int fd;
+    const string* filename;
+    uint64 offset;
+    size_t n;
+    char* scratch;
+    // The number of bytes read so far.
+    size_t bytes_read = 0;
+    struct iovec iov;
+    std::function<void(const Status&, StringPiece)> done;
+  };
+
+  // Returns the process-wide ring, or nullptr if it is disabled or the kernel
+  // does not support io_uring.
+  static IoUring* Get() {
+    static IoUring* ring = []() -> IoUring* {
+      const char* entries = std::getenv("TF_POSIX_IO_URING_ENTRIES");
+      if (entries == nullptr) return nullptr;
+      const long num_entries = std::strtol(entries, nullptr, 10);
+      if (num_entries <= 0) return nullptr;
+      IoUring* ring = new IoUring();
+      if (!ring->Init(num_entries)) {
+        delete ring;
+        return nullptr;
+      }
+      return ring;
+    }();
+    return ring;
+  }
+
+  // Submits `request`, and takes its ownership, unless the ring is full, in
+  // which case returns false.
+  bool Submit(Request* request) {
+    mutex_lock l(mu_);
+    if (num_in_flight_ == num_entries_) return false;
+    ++num_in_flight_;
+    SubmitLocked(request);
+    return true;
+  }
+
+ private:
+  IoUring() = default;
+
+  bool Init(unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd_ = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd_ < 0) {
+      LOG(WARNING) << "Not using io_uring for file reads: "
+                   << strerror(errno);
+      return false;
+    }
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ =
+        params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sq_ring_ = Map(sq_ring_size_, IORING_OFF_SQ_RING);
+    cq_ring_ = Map(cq_ring_size_, IORING_OFF_CQ_RING);
+    void* sqes = Map(sqes_size_, IORING_OFF_SQES);
+    if (sq_ring_ == nullptr || cq_ring_ == nullptr || sqes == nullptr) {
+      LOG(WARNING) << "Not using io_uring for file reads: " << strerror(errno);
+      if (sq_ring_ != nullptr) munmap(sq_ring_, sq_ring_size_);
+      if (cq_ring_ != nullptr) munmap(cq_ring_, cq_ring_size_);
+      if (sqes != nullptr) munmap(sqes, sqes_size_);
+      close(fd_);
+      return false;
+    }
+    sq_tail_ = RingField<unsigned>(sq_ring_, params.sq_off.tail);
+    sq_mask_ = *RingField<unsigned>(sq_ring_, params.sq_off.ring_mask);
+    sq_array_ = RingField<unsigned>(sq_ring_, params.sq_off.array);
+    sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+    cq_head_ = RingField<unsigned>(cq_ring_, params.cq_off.head);
+    cq_tail_ = RingField<unsigned>(cq_ring_, params.cq_off.tail);
+    cq_mask_ = *RingField<unsigned>(cq_ring_, params.cq_off.ring_mask);
+    cqes_ = RingField<struct io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+    // There are at least as many completion entries as submission entries,
+    // so bounding the reads in flight by the latter never overflows the
+    // completion queue.
+    num_entries_ = params.sq_entries;
+    reaper_.reset(Env::Default()->StartThread(ThreadOptions(), "tf_io_uring",
+                                              [this]() { ReapCompletions(); }));
+    return true;
+  }
+
+  void* Map(size_t size, off_t offset) {
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, fd_, offset);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+  }
+
+  template <typename T>
+  static T* RingField(void* ring, unsigned offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+  }
+
+  // Submits a read of the rest of `request`.
+  void SubmitLocked(Request* request) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    // The tail is only written under `mu_`, and the kernel consumes every
+    // entry on io_uring_enter(), so the entry at the tail is free.
+    const unsigned tail = *sq_tail_;
+    const unsigned index = tail & sq_mask_;
+    struct io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    // Some platforms throw EINVAL if asked to read more than fits in a 32-bit
+    // integer, as for pread().
+    request->iov.iov_base = request->scratch + request->bytes_read;
+    request->iov.iov_len =
+        std::min<size_t>(request->n - request->bytes_read, INT32_MAX);
+    sqe->opcode = IORING_OP_READV;
+    sqe->fd = request->fd;
+    sqe->addr = reinterpret_cast<uint64>(&request->iov);
+    sqe->len = 1;
+    sqe->off = request->offset + request->bytes_read;
+    sqe->user_data = reinterpret_cast<uint64>(request);
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    int ret;
+    do {
+      ret = syscall(__NR_io_uring_enter, fd_, 1, 0, 0, nullptr, 0);
+    } while (ret < 0 && (errno == EINTR || errno == EAGAIN));
+    if (ret < 0) {
+      LOG(FATAL) << "io_uring_enter() failed: " << strerror(errno);
+    }
+  }
+
+  void ReapCompletions() {
+    while (true) {
+      const int ret = syscall(__NR_io_uring_enter, fd_, 0, 1,
+                              IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (ret < 0 && errno != EINTR) {
+        LOG(FATAL) << "io_uring_enter() failed: " << strerror(errno);
+      }
+      unsigned head = *cq_head_;
+      while (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        const struct io_uring_cqe& cqe = cqes_[head & cq_mask_];
+        Request* request = reinterpret_cast<Request*>(cqe.user_data);
+        const int result = cqe.res;
+        __atomic_store_n(cq_head_, ++head, __ATOMIC_RELEASE);
+        Complete(request, result);
+      }
+    }
+  }
+
+  // Handles the completion of a read of `request` that returned `result`.
+  void Complete(Request* request, int result) {
+    Status s;
+    {
+      // Holding `mu_`, which the request was submitted under, also orders
+      // these accesses to it after its submission for race detectors, which
+      // do not know that the kernel does.
+      mutex_lock l(mu_);
+      if (result > 0) {
+        request->bytes_read += result;
+      } else if (result == 0) {
+        s = Status(error::OUT_OF_RANGE, "Read less bytes than requested");
+      } else if (result != -EINTR && result != -EAGAIN) {
+        s = IOError(*request->filename, -result);
+      }
+      if (s.ok() && request->bytes_read < request->n) {
+        SubmitLocked(request);
+        return;
+      }
+      --num_in_flight_;
+    }
+    request->done(s, StringPiece(request->scratch, request->bytes_read));
+    delete request;
+  }
+
+  int fd_ = -1;
+  void* sq_ring_ = nullptr;
+  void* cq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  size_t cq_ring_size_ = 0;
+  size_t sqes_size_ = 0;
+  unsigned* sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned* sq_array_ = nullptr;
+  struct io_uring_sqe* sqes_ = nullptr;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  struct io_uring_cqe* cqes_ = nullptr;
+  std::unique_ptr<Thread> reaper_;
+
+  mutex mu_;
+  unsigned num_entries_ = 0;
+  unsigned num_in_flight_ TF_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace
+#endif  // TF_POSIX_IO_URING
+
 // pread() based random-access
 class PosixRandomAccessFile : public RandomAccessFile {
  private:
@@ -96,6 +319,30 @@ class PosixRandomAccessFile : public RandomAccessFile {
     return s;
   }
 
+#if defined(TF_POSIX_IO_URING)
+  void ReadAsync(
+      uint64 offset, size_t n, char* scratch,
+      std::function<void(const Status&, StringPiece)> done) const override {
+    IoUring* ring = IoUring::Get();
+    if (ring == nullptr || n == 0) {
+      RandomAccessFile::ReadAsync(offset, n, scratch, std::move(done));
+      return;
+    }
+    auto request = std::make_unique<IoUring::Request>();
+    request->fd = fd_;
+    request->filename = &filename_;
+    request->offset = offset;
+    request->n = n;
+    request->scratch = scratch;
+    request->done = std::move(done);
+    if (ring->Submit(request.get())) {
+      request.release();
+      return;
+    }
+    RandomAccessFile::ReadAsync(offset, n, scratch, std::move(request->done));
+  }
+#endif
+
 #if defined(TF_CORD_SUPPORT)
   Status Read(uint64 offset, size_t n, absl::Cord* cord) const override {
     if (n == 0) {
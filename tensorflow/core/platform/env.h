@@ -596,6 +596,9 @@ struct ThreadOptions {
   /// Guard area size to use near thread stacks to use (in bytes)
   size_t guard_size = 0;  // 0: use system default value
   int numa_node = port::kNUMANoAffinity;
+  /// If not empty, the CPUs a thread::ThreadPool pins its threads to: its
+  /// i-th thread only runs on CPU cpu_affinity[i % cpu_affinity.size()].
+  std::vector<int> cpu_affinity;
 };
 
 /// A utility routine: copy contents of `src` in file system `src_fs`
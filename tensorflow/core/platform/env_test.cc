@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/cord.h"
 #include "tensorflow/core/platform/null_file_system.h"
 #include "tensorflow/core/platform/path.h"
@@ -90,6 +91,43 @@ TEST_F(DefaultEnvTest, IncompleteReadOutOfRange) {
   EXPECT_EQ(input, result);
 }
 
+TEST_F(DefaultEnvTest, ReadAsync) {
+  // Uses io_uring for the asynchronous reads of local files where the kernel
+  // supports it, and synchronous reads elsewhere.
+#if defined(__linux__)
+  setenv("TF_POSIX_IO_URING_ENTRIES", "4", /*overwrite=*/0);
+#endif
+  const string filename = io::JoinPath(BaseDir(), "read_async");
+  const string input = CreateTestFile(env_, filename, 1000);
+  std::unique_ptr<RandomAccessFile> f;
+  TF_EXPECT_OK(env_->NewRandomAccessFile(filename, &f));
+
+  constexpr int kNumReads = 16;
+  std::vector<string> scratch(kNumReads, string(100, 0));
+  std::vector<Status> statuses(kNumReads);
+  std::vector<string> results(kNumReads);
+  BlockingCounter counter(kNumReads);
+  for (int i = 0; i < kNumReads; ++i) {
+    f->ReadAsync(i * 64, 100, &scratch[i][0],
+                 [&, i](const Status& s, StringPiece result) {
+                   statuses[i] = s;
+                   results[i] = string(result);
+                   counter.DecrementCount();
+                 });
+  }
+  counter.Wait();
+  for (int i = 0; i < kNumReads; ++i) {
+    const uint64 offset = i * 64;
+    if (offset + 100 <= input.size()) {
+      TF_EXPECT_OK(statuses[i]);
+    } else {
+      // Reading past EOF gives an OUT_OF_RANGE error and the bytes before it.
+      EXPECT_EQ(error::OUT_OF_RANGE, statuses[i].code());
+    }
+    EXPECT_EQ(input.substr(offset, 100), results[i]);
+  }
+}
+
 TEST_F(DefaultEnvTest, ReadFileToString) {
   for (const int length : {0, 1, 1212, 2553, 4928, 8196, 9000, (1 << 20) - 1,
                            1 << 20, (1 << 20) + 1, (256 << 20) + 100}) {
@@ -774,6 +774,26 @@ class RandomAccessFile {
   virtual tensorflow::Status Read(uint64 offset, size_t n, StringPiece* result,
                                   char* scratch) const = 0;
 
+  /// \brief Starts reading up to `n` bytes from the file starting at
+  /// `offset`, and calls `done` with the status and result that `Read()`
+  /// would have returned once the read completes.
+  ///
+  /// `scratch[0..n-1]` and the file must be live until `done` is called.
+  /// `done` may be called before this returns, or on a thread owned by the
+  /// filesystem, so it should not block. This lets a single thread keep many
+  /// reads in flight on filesystems that support asynchronous I/O.
+  ///
+  /// The default implementation calls `Read()` and then `done`.
+  ///
+  /// Safe for concurrent use by multiple threads.
+  virtual void ReadAsync(
+      uint64 offset, size_t n, char* scratch,
+      std::function<void(const Status&, StringPiece)> done) const {
+    StringPiece result;
+    Status s = Read(offset, n, &result, scratch);
+    done(s, result);
+  }
+
 #if defined(TF_CORD_SUPPORT)
   /// \brief Read up to `n` bytes from the file starting at `offset`.
   virtual tensorflow::Status Read(uint64 offset, size_t n,
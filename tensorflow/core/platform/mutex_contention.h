@@ -0,0 +1,121 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_PLATFORM_MUTEX_CONTENTION_H_
+#define TENSORFLOW_CORE_PLATFORM_MUTEX_CONTENTION_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/types.h"
+
+// Lock contention profiling for tensorflow::mutex.
+//
+// While profiling is enabled, tensorflow::mutex::lock() and lock_shared()
+// first try to acquire the mutex without blocking. One in `sampling_period` of
+// the acquisitions that fail, i.e. that have to wait for another thread, is
+// timed and attributed to the site of the mutex: the name given to it with a
+// MutexContentionSite, or kUnnamedMutexContentionSite. Uncontended
+// acquisitions only pay for the extra try_lock, and while profiling is
+// disabled the only cost is a relaxed atomic load per lock.
+//
+// The waits are accumulated per site (see GetMutexContentionStats()) and
+// passed to the listener, if any, which e.g. exports them to traces. Only the
+// default (nsync-based) mutex implementation records contention.
+
+namespace tensorflow {
+
+class mutex;
+
+inline constexpr char kUnnamedMutexContentionSite[] = "unnamed";
+
+// Starts profiling one in `sampling_period` contended acquisitions of all
+// mutexes, or stops profiling if `sampling_period` is not positive.
+void SetMutexContentionSamplingPeriod(int sampling_period);
+
+// Names the site of a mutex, e.g. "BFCAllocator", in the contention profile
+// for as long as the MutexContentionSite is alive. It should be declared right
+// after the mutex it names so that it's destroyed first:
+//
+//   mutable mutex mu_;
+//   MutexContentionSite mu_site_{&mu_, "ResourceMgr"};
+//
+// `name` must outlive the MutexContentionSite. To keep sites free while
+// profiling is disabled, a mutex is only named if profiling is enabled when
+// its MutexContentionSite is constructed.
+class MutexContentionSite {
+ public:
+  MutexContentionSite(const mutex* mu, const char* name);
+  ~MutexContentionSite();
+
+ private:
+  const mutex* const mu_;
+  const bool named_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(MutexContentionSite);
+};
+
+// A sampled contended acquisition of a mutex.
+struct MutexContentionEvent {
+  const char* site;
+  // Whether the mutex was acquired in shared mode.
+  bool shared;
+  // The wait, as given by EnvTime::NowNanos().
+  uint64 start_ns;
+  uint64 end_ns;
+};
+
+// Called on the thread that waited, right after it acquired the mutex. The
+// contention of mutexes acquired by the listener itself isn't recorded.
+using MutexContentionListener = void (*)(const MutexContentionEvent& event);
+
+// Sets the listener of the sampled contentions, or removes it if `listener` is
+// nullptr.
+void SetMutexContentionListener(MutexContentionListener listener);
+
+// The contention of one site, accumulated since the start of the process.
+struct MutexContentionStats {
+  std::string site;
+  // The number of sampled contended acquisitions.
+  int64_t num_contentions = 0;
+  int64_t total_wait_ns = 0;
+  int64_t max_wait_ns = 0;
+};
+
+// Returns the contention of the sites that had any.
+std::vector<MutexContentionStats> GetMutexContentionStats();
+
+namespace internal {
+
+TF_EXPORT extern std::atomic<int> g_mutex_contention_sampling_period;
+
+inline bool MutexContentionProfilingEnabled() {
+  return g_mutex_contention_sampling_period.load(std::memory_order_relaxed) >
+         0;
+}
+
+// Returns whether the calling thread should time its current contended
+// acquisition.
+bool ShouldSampleMutexContention();
+
+// Records that `mu` was waited for from `start_ns` to `end_ns`.
+void RecordMutexContention(const mutex* mu, bool shared, uint64 start_ns,
+                           uint64 end_ns);
+
+}  // namespace internal
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_PLATFORM_MUTEX_CONTENTION_H_
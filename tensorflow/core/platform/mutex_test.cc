@@ -14,6 +14,14 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/platform/mutex.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex_contention.h"
+#include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -35,5 +43,87 @@ struct SharedMutexLockTest {
   mutex mu;
 };
 
+// Returns the contention recorded so far for `site`.
+MutexContentionStats GetSiteContentionStats(const std::string& site) {
+  for (const MutexContentionStats& stats : GetMutexContentionStats()) {
+    if (stats.site == site) return stats;
+  }
+  return MutexContentionStats();
+}
+
+// Acquires `mu` while another thread holds it for a while.
+void ContendFor(mutex* mu, bool shared) {
+  Notification locked;
+  std::unique_ptr<Thread> holder(
+      Env::Default()->StartThread(ThreadOptions(), "holder", [&] {
+        mutex_lock lock(*mu);
+        locked.Notify();
+        Env::Default()->SleepForMicroseconds(20 * 1000);
+      }));
+  locked.WaitForNotification();
+  if (shared) {
+    tf_shared_lock lock(*mu);
+  } else {
+    mutex_lock lock(*mu);
+  }
+}
+
+std::vector<MutexContentionEvent>* listened_events = nullptr;
+
+void ListenToContention(const MutexContentionEvent& event) {
+  listened_events->push_back(event);
+}
+
+TEST(MutexContentionTest, RecordsContentionOfNamedSite) {
+  // Sites are only named while profiling is enabled.
+  SetMutexContentionSamplingPeriod(1);
+  mutex mu;
+  MutexContentionSite site(&mu, "MutexContentionTest");
+  SetMutexContentionSamplingPeriod(0);
+  std::vector<MutexContentionEvent> events;
+  listened_events = &events;
+  SetMutexContentionListener(&ListenToContention);
+
+  // Nothing is recorded while profiling is disabled.
+  ContendFor(&mu, /*shared=*/false);
+  EXPECT_EQ(GetSiteContentionStats("MutexContentionTest").num_contentions, 0);
+
+  SetMutexContentionSamplingPeriod(1);
+  {
+    // Uncontended acquisitions aren't recorded.
+    mutex_lock lock(mu);
+  }
+  EXPECT_EQ(GetSiteContentionStats("MutexContentionTest").num_contentions, 0);
+
+  ContendFor(&mu, /*shared=*/false);
+  ContendFor(&mu, /*shared=*/true);
+  SetMutexContentionSamplingPeriod(0);
+  SetMutexContentionListener(nullptr);
+
+  const MutexContentionStats stats =
+      GetSiteContentionStats("MutexContentionTest");
+  EXPECT_EQ(stats.num_contentions, 2);
+  EXPECT_GE(stats.total_wait_ns, stats.max_wait_ns);
+  EXPECT_GT(stats.max_wait_ns, 0);
+
+  ASSERT_EQ(events.size(), 2);
+  EXPECT_STREQ(events[0].site, "MutexContentionTest");
+  EXPECT_FALSE(events[0].shared);
+  EXPECT_TRUE(events[1].shared);
+  EXPECT_LE(events[1].start_ns, events[1].end_ns);
+}
+
+TEST(MutexContentionTest, SamplesContention) {
+  SetMutexContentionSamplingPeriod(2);
+  mutex mu;
+  MutexContentionSite site(&mu, "SampledMutexContentionTest");
+  for (int i = 0; i < 4; ++i) {
+    ContendFor(&mu, /*shared=*/false);
+  }
+  SetMutexContentionSamplingPeriod(0);
+  EXPECT_EQ(
+      GetSiteContentionStats("SampledMutexContentionTest").num_contentions, 2);
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -21,6 +21,7 @@ limitations under the License.
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/denormal.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -45,12 +46,21 @@ struct EigenEnvironment {
   Env* const env_;
   const ThreadOptions thread_options_;
   const string name_;
+  // The index of the next thread created. Eigen creates all the threads of a
+  // pool from its constructor.
+  int next_thread_index_ = 0;
 
   EigenEnvironment(Env* env, const ThreadOptions& thread_options,
                    const string& name)
       : env_(env), thread_options_(thread_options), name_(name) {}
 
   EnvThread* CreateThread(std::function<void()> f) {
+    const int cpu =
+        thread_options_.cpu_affinity.empty()
+            ? port::kUnknownCPU
+            : thread_options_.cpu_affinity[next_thread_index_ %
+                                           thread_options_.cpu_affinity.size()];
+    ++next_thread_index_;
     return env_->StartThread(thread_options_, name_, [=]() {
       // Set the processor flag to flush denormals to zero.
       port::ScopedFlushDenormal flush;
@@ -59,6 +69,10 @@ struct EigenEnvironment {
       if (thread_options_.numa_node != port::kNUMANoAffinity) {
         port::NUMASetThreadNodeAffinity(thread_options_.numa_node);
       }
+      if (cpu != port::kUnknownCPU && !port::SetCurrentThreadCPUAffinity(cpu)) {
+        LOG(WARNING) << "Could not pin a thread of " << name_ << " to CPU "
+                     << cpu;
+      }
       f();
     });
   }
@@ -209,6 +209,12 @@ MemoryBandwidthInfo GetMemoryBandwidthInfo() {
   return membw_info;
 }
 
+bool SetCurrentThreadCPUAffinity(int cpu) {
+  // Like GetCurrentCPU(), this only handles the current processor group.
+  if (cpu < 0 || cpu >= sizeof(DWORD_PTR) * 8) return false;
+  return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu) != 0;
+}
+
 int NumHyperthreadsPerCore() {
   static const int ht_per_core = tensorflow::port::CPUIDNumSMT();
   return (ht_per_core > 0) ? ht_per_core : 1;
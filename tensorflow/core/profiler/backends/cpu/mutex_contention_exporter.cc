@@ -0,0 +1,78 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <string>
+
+#include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex_contention.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/profiler/backends/cpu/traceme_recorder.h"
+#include "tensorflow/core/profiler/lib/traceme.h"
+#include "tensorflow/core/profiler/lib/traceme_encode.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace profiler {
+namespace {
+
+auto* mutex_contentions = monitoring::Counter<1>::New(
+    "/tensorflow/core/mutex_contentions",
+    "The number of sampled contended acquisitions of tensorflow::mutex.",
+    "site");
+
+auto* mutex_contention_wait_usecs = monitoring::Counter<1>::New(
+    "/tensorflow/core/mutex_contention_wait_usecs",
+    "The time waited in the sampled contended acquisitions of "
+    "tensorflow::mutex.",
+    "site");
+
+// Exports a sampled contention to the monitoring counters and, while the
+// profiler is active, as a TraceMe on the waiting thread, so that it appears
+// in the host threads XPlane.
+void ExportMutexContention(const MutexContentionEvent& event) {
+  const uint64 wait_ns =
+      event.end_ns > event.start_ns ? event.end_ns - event.start_ns : 0;
+  mutex_contentions->GetCell(event.site)->IncrementBy(1);
+  mutex_contention_wait_usecs->GetCell(event.site)->IncrementBy(wait_ns /
+                                                                1000);
+  if (TraceMeRecorder::Active(TraceMeLevel::kInfo)) {
+    TraceMeRecorder::Record(
+        {TraceMeEncode("MutexContention", {{"site", event.site},
+                                           {"shared", event.shared ? 1 : 0}}),
+         static_cast<int64_t>(event.start_ns),
+         static_cast<int64_t>(event.end_ns)});
+  }
+}
+
+// Contention profiling is enabled for the whole process by setting
+// TF_MUTEX_CONTENTION_SAMPLING_PERIOD to the number of contended acquisitions
+// per sample, e.g. 100.
+auto register_mutex_contention_exporter = [] {
+  SetMutexContentionListener(&ExportMutexContention);
+  int64_t sampling_period = 0;
+  const Status status = ReadInt64FromEnvVar(
+      "TF_MUTEX_CONTENTION_SAMPLING_PERIOD", 0, &sampling_period);
+  if (!status.ok()) {
+    LOG(ERROR) << status.error_message();
+  } else if (sampling_period > 0) {
+    SetMutexContentionSamplingPeriod(static_cast<int>(sampling_period));
+  }
+  return 0;
+}();
+
+}  // namespace
+}  // namespace profiler
+}  // namespace tensorflow
@@ -0,0 +1,121 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/profiler/lib/sampling_profiler.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/profiler/lib/profiler_session.h"
+#include "tensorflow/core/profiler/utils/time_utils.h"
+
+namespace tensorflow {
+namespace profiler {
+
+SamplingProfiler::SamplingProfiler(const SamplingProfilerOptions& options)
+    : options_(options) {
+  DCHECK_GT(options_.sampling_period, 0);
+  DCHECK_GT(options_.max_captures, 0);
+}
+
+SamplingProfiler::Step::Step(SamplingProfiler* profiler)
+    : profiler_(profiler),
+      step_number_(profiler->num_steps_.fetch_add(1)),
+      start_time_ns_(0) {
+  session_ = profiler_->MaybeStartSession(step_number_);
+  if (session_ != nullptr) {
+    start_time_ns_ = GetCurrentTimeNanos();
+  }
+}
+
+SamplingProfiler::Step::~Step() {
+  if (session_ == nullptr) return;
+  const int64_t duration_ns = GetCurrentTimeNanos() - start_time_ns_;
+  profiler_->EndSession(std::move(session_), step_number_, duration_ns,
+                        triggered_);
+}
+
+std::unique_ptr<ProfilerSession> SamplingProfiler::MaybeStartSession(
+    int64_t step_number) {
+  if (step_number % options_.sampling_period != 0) return nullptr;
+  {
+    mutex_lock lock(mutex_);
+    if (session_active_) return nullptr;
+    session_active_ = true;
+  }
+  std::unique_ptr<ProfilerSession> session =
+      ProfilerSession::Create(options_.profile_options);
+  if (!session->Status().ok()) {
+    // Another session (e.g. an on-demand capture) is active.
+    VLOG(1) << "Not profiling sampled step " << step_number << ": "
+            << session->Status();
+    session.reset();
+    mutex_lock lock(mutex_);
+    session_active_ = false;
+  }
+  return session;
+}
+
+void SamplingProfiler::EndSession(std::unique_ptr<ProfilerSession> session,
+                                  int64_t step_number, int64_t duration_ns,
+                                  bool triggered) {
+  const bool slow = options_.slow_step_threshold_ns > 0 &&
+                    duration_ns >= options_.slow_step_threshold_ns;
+  const bool keep = triggered || slow || options_.slow_step_threshold_ns <= 0;
+
+  SampledStepCapture capture;
+  capture.step_number = step_number;
+  capture.duration_ns = duration_ns;
+  // Steps that aren't kept skip collecting (and post-processing) the data;
+  // destroying their session stops it.
+  Status status;
+  if (keep) {
+    status = session->CollectData(&capture.space);
+  }
+  session.reset();
+  {
+    mutex_lock lock(mutex_);
+    session_active_ = false;
+  }
+  if (!keep) return;
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to collect the profile of sampled step "
+                 << step_number << ": " << status;
+    return;
+  }
+
+  if ((slow || triggered) && options_.on_slow_step) {
+    options_.on_slow_step(capture);
+  }
+  mutex_lock lock(mutex_);
+  captures_.push_back(std::move(capture));
+  while (captures_.size() > static_cast<size_t>(options_.max_captures)) {
+    captures_.pop_front();
+  }
+}
+
+std::vector<SampledStepCapture> SamplingProfiler::TakeCaptures() {
+  mutex_lock lock(mutex_);
+  std::vector<SampledStepCapture> captures(
+      std::make_move_iterator(captures_.begin()),
+      std::make_move_iterator(captures_.end()));
+  captures_.clear();
+  return captures;
+}
+
+}  // namespace profiler
+}  // namespace tensorflow
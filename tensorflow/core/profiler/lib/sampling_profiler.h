@@ -0,0 +1,131 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_PROFILER_LIB_SAMPLING_PROFILER_H_
+#define TENSORFLOW_CORE_PROFILER_LIB_SAMPLING_PROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/profiler/lib/profiler_session.h"
+#include "tensorflow/core/profiler/profiler_options.pb.h"
+#include "tensorflow/core/profiler/protobuf/xplane.pb.h"
+
+namespace tensorflow {
+namespace profiler {
+
+// A profile of one sampled step.
+struct SampledStepCapture {
+  // The number of the step, counting from 0 for the first step started.
+  int64_t step_number = 0;
+  // The wall time of the step.
+  int64_t duration_ns = 0;
+  XSpace space;
+};
+
+struct SamplingProfilerOptions {
+  // The options of the ProfilerSession capturing a sampled step.
+  ProfileOptions profile_options = ProfilerSession::DefaultOptions();
+  // One in `sampling_period` steps is profiled.
+  int64_t sampling_period = 100;
+  // The number of most recent captures that are kept.
+  int max_captures = 8;
+  // If positive, only the captures of steps taking at least this long are
+  // kept, and `on_slow_step` is called for them.
+  int64_t slow_step_threshold_ns = 0;
+  // Called, outside of any lock, with each capture of a slow step.
+  std::function<void(const SampledStepCapture&)> on_slow_step;
+};
+
+// Continuously profiles a sample of the steps (e.g. training steps or
+// requests) of a program, so that rare slow steps can be inspected after the
+// fact, which on-demand captures can't catch.
+//
+// Steps that aren't sampled only cost an atomic increment: TraceMe events
+// aren't recorded while no ProfilerSession is active. Since only one
+// ProfilerSession can be active in the process, a sampled step isn't profiled
+// if another step (or an on-demand capture) is being profiled already.
+//
+// Thread-safety: SamplingProfiler is thread-safe.
+class SamplingProfiler {
+ public:
+  explicit SamplingProfiler(const SamplingProfilerOptions& options);
+
+  // Marks a step, from construction to destruction, e.g.
+  //
+  //   void HandleRequest(...) {
+  //     SamplingProfiler::Step step(&sampling_profiler);
+  //     ...
+  //   }
+  class Step {
+   public:
+    explicit Step(SamplingProfiler* profiler);
+    ~Step();
+
+    // True if the step is being profiled.
+    bool profiled() const { return session_ != nullptr; }
+
+    // Keeps the capture of this step (if it's profiled) even if it isn't
+    // slow, and reports it to `on_slow_step`.
+    void Trigger() { triggered_ = true; }
+
+   private:
+    SamplingProfiler* profiler_;
+    int64_t step_number_;
+    int64_t start_time_ns_;
+    bool triggered_ = false;
+    std::unique_ptr<ProfilerSession> session_;
+
+    Step(const Step&) = delete;
+    Step& operator=(const Step&) = delete;
+  };
+
+  // Returns the kept captures, oldest first, and clears them.
+  std::vector<SampledStepCapture> TakeCaptures() TF_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the number of steps started so far.
+  int64_t num_steps() const { return num_steps_.load(); }
+
+ private:
+  // Starts profiling step `step_number` if it's sampled and no other step is
+  // being profiled.
+  std::unique_ptr<ProfilerSession> MaybeStartSession(int64_t step_number)
+      TF_LOCKS_EXCLUDED(mutex_);
+
+  // Collects the profile of a finished step and keeps it if it should be.
+  void EndSession(std::unique_ptr<ProfilerSession> session,
+                  int64_t step_number, int64_t duration_ns, bool triggered)
+      TF_LOCKS_EXCLUDED(mutex_);
+
+  const SamplingProfilerOptions options_;
+  std::atomic<int64_t> num_steps_{0};
+
+  mutex mutex_;
+  bool session_active_ TF_GUARDED_BY(mutex_) = false;
+  std::deque<SampledStepCapture> captures_ TF_GUARDED_BY(mutex_);
+
+  SamplingProfiler(const SamplingProfiler&) = delete;
+  SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+};
+
+}  // namespace profiler
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_PROFILER_LIB_SAMPLING_PROFILER_H_
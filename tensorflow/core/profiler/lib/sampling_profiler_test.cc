@@ -0,0 +1,93 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/profiler/lib/sampling_profiler.h"
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/profiler/lib/profiler_session.h"
+
+namespace tensorflow {
+namespace profiler {
+namespace {
+
+std::vector<int64_t> StepNumbers(
+    const std::vector<SampledStepCapture>& captures) {
+  std::vector<int64_t> step_numbers;
+  for (const SampledStepCapture& capture : captures) {
+    step_numbers.push_back(capture.step_number);
+  }
+  return step_numbers;
+}
+
+TEST(SamplingProfilerTest, KeepsTheMostRecentSampledSteps) {
+  SamplingProfilerOptions options;
+  options.sampling_period = 3;
+  options.max_captures = 2;
+  SamplingProfiler profiler(options);
+  for (int i = 0; i < 8; ++i) {
+    SamplingProfiler::Step step(&profiler);
+    EXPECT_EQ(step.profiled(), i % 3 == 0);
+  }
+  EXPECT_EQ(profiler.num_steps(), 8);
+  EXPECT_EQ(StepNumbers(profiler.TakeCaptures()),
+            (std::vector<int64_t>{3, 6}));
+  EXPECT_TRUE(profiler.TakeCaptures().empty());
+}
+
+TEST(SamplingProfilerTest, OnlyOneStepIsProfiledAtATime) {
+  SamplingProfilerOptions options;
+  options.sampling_period = 1;
+  SamplingProfiler profiler(options);
+  {
+    SamplingProfiler::Step step0(&profiler);
+    SamplingProfiler::Step step1(&profiler);
+    EXPECT_TRUE(step0.profiled());
+    EXPECT_FALSE(step1.profiled());
+  }
+  {
+    // Nor while an on-demand capture is running.
+    std::unique_ptr<ProfilerSession> session =
+        ProfilerSession::Create(ProfilerSession::DefaultOptions());
+    SamplingProfiler::Step step(&profiler);
+    EXPECT_FALSE(step.profiled());
+  }
+  SamplingProfiler::Step step(&profiler);
+  EXPECT_TRUE(step.profiled());
+}
+
+TEST(SamplingProfilerTest, KeepsSlowAndTriggeredSteps) {
+  std::vector<int64_t> reported_steps;
+  SamplingProfilerOptions options;
+  options.sampling_period = 1;
+  // No step is this slow.
+  options.slow_step_threshold_ns = int64_t{1} << 62;
+  options.on_slow_step = [&](const SampledStepCapture& capture) {
+    reported_steps.push_back(capture.step_number);
+  };
+  SamplingProfiler profiler(options);
+  for (int i = 0; i < 4; ++i) {
+    SamplingProfiler::Step step(&profiler);
+    ASSERT_TRUE(step.profiled());
+    if (i == 2) step.Trigger();
+  }
+  EXPECT_EQ(reported_steps, (std::vector<int64_t>{2}));
+  EXPECT_EQ(StepNumbers(profiler.TakeCaptures()), (std::vector<int64_t>{2}));
+}
+
+}  // namespace
+}  // namespace profiler
+}  // namespace tensorflow
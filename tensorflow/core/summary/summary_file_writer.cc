@@ -14,6 +14,9 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/summary/summary_file_writer.h"
 
+#include <deque>
+#include <memory>
+
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "tensorflow/core/framework/graph.pb.h"
@@ -22,20 +25,38 @@ limitations under the License.
 #include "tensorflow/core/framework/summary.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/summary/summary_converter.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/events_writer.h"
 #include "tensorflow/core/util/ptr_util.h"
 
 namespace tensorflow {
 namespace {
 
+// Asynchronous writers drop the oldest summaries once this many times
+// max_queue of them are waiting to be written.
+constexpr int kMaxPendingQueues = 100;
+
+bool AsyncSummaryWrites() {
+  static const bool async_writes = []() {
+    bool async_writes;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_SUMMARY_ASYNC_WRITES", false,
+                                   &async_writes));
+    return async_writes;
+  }();
+  return async_writes;
+}
+
 class SummaryFileWriter : public SummaryWriterInterface {
  public:
-  SummaryFileWriter(int max_queue, int flush_millis, Env* env)
+  SummaryFileWriter(int max_queue, int flush_millis, bool async_writes,
+                    Env* env)
       : SummaryWriterInterface(),
         is_initialized_(false),
         max_queue_(max_queue),
         flush_millis_(flush_millis),
+        async_writes_(async_writes),
         env_(env) {}
 
   Status Initialize(const string& logdir, const string& filename_suffix) {
@@ -54,6 +75,7 @@ class SummaryFileWriter : public SummaryWriterInterface {
     string sep = absl::StartsWith(filename_suffix, ".") ? "" : ".";
     const string uniquified_filename_suffix = absl::StrCat(
         ".", pid, ".", file_id_counter.fetch_add(1), sep, filename_suffix);
+    mutex_lock wl(write_mu_);
     mutex_lock ml(mu_);
     events_writer_ =
         tensorflow::MakeUnique<EventsWriter>(io::JoinPath(logdir, "events"));
@@ -62,18 +84,41 @@ class SummaryFileWriter : public SummaryWriterInterface {
         "Could not initialize events writer.");
     last_flush_ = env_->NowMicros();
     is_initialized_ = true;
+    if (async_writes_) {
+      writer_thread_.reset(env_->StartThread(
+          ThreadOptions(), "summary_file_writer", [this]() { WriterLoop(); }));
+    }
     return OkStatus();
   }
 
   Status Flush() override {
-    mutex_lock ml(mu_);
-    if (!is_initialized_) {
-      return errors::FailedPrecondition("Class was not properly initialized.");
+    mutex_lock wl(write_mu_);
+    std::deque<std::unique_ptr<Event>> events;
+    {
+      mutex_lock ml(mu_);
+      if (!is_initialized_) {
+        return errors::FailedPrecondition(
+            "Class was not properly initialized.");
+      }
+      events.swap(queue_);
+      last_flush_ = env_->NowMicros();
     }
-    return InternalFlush();
+    Status status = InternalFlush(events);
+    status.Update(async_status_);
+    async_status_ = OkStatus();
+    return status;
   }
 
   ~SummaryFileWriter() override {
+    if (writer_thread_ != nullptr) {
+      {
+        mutex_lock ml(mu_);
+        shutdown_ = true;
+        flush_cond_.notify_one();
+      }
+      // Joins the thread.
+      writer_thread_.reset();
+    }
     (void)Flush();  // Ignore errors.
   }
 
@@ -150,13 +195,28 @@ class SummaryFileWriter : public SummaryWriterInterface {
   }
 
   Status WriteEvent(std::unique_ptr<Event> event) override {
-    mutex_lock ml(mu_);
-    queue_.emplace_back(std::move(event));
-    if (queue_.size() > max_queue_ ||
-        env_->NowMicros() - last_flush_ > 1000 * flush_millis_) {
-      return InternalFlush();
+    {
+      mutex_lock ml(mu_);
+      queue_.emplace_back(std::move(event));
+      if (queue_.size() <= max_queue_ &&
+          env_->NowMicros() - last_flush_ <= 1000 * flush_millis_) {
+        return OkStatus();
+      }
+      if (async_writes_) {
+        if (queue_.size() > kMaxPendingQueues * (max_queue_ + 1)) {
+          queue_.pop_front();
+          if (num_dropped_++ % 1000 == 0) {
+            LOG(WARNING) << "Dropped " << num_dropped_
+                         << " summaries that could not be written fast enough"
+                         << " to the events file.";
+          }
+        }
+        flush_requested_ = true;
+        flush_cond_.notify_one();
+        return OkStatus();
+      }
     }
-    return OkStatus();
+    return Flush();
   }
 
   string DebugString() const override { return "SummaryFileWriter"; }
@@ -166,26 +226,59 @@ class SummaryFileWriter : public SummaryWriterInterface {
     return static_cast<double>(env_->NowMicros()) / 1.0e6;
   }
 
-  Status InternalFlush() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    for (const std::unique_ptr<Event>& e : queue_) {
+  Status InternalFlush(const std::deque<std::unique_ptr<Event>>& events)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(write_mu_) {
+    for (const std::unique_ptr<Event>& e : events) {
       events_writer_->WriteEvent(*e);
     }
-    queue_.clear();
     TF_RETURN_WITH_CONTEXT_IF_ERROR(events_writer_->Flush(),
                                     "Could not flush events file.");
-    last_flush_ = env_->NowMicros();
     return OkStatus();
   }
 
+  // Writes the queued summaries in the background when WriteEvent() asks for
+  // it, until the writer is destroyed.
+  void WriterLoop() {
+    while (true) {
+      {
+        mutex_lock ml(mu_);
+        while (!flush_requested_ && !shutdown_) {
+          flush_cond_.wait(ml);
+        }
+        if (shutdown_) return;
+        flush_requested_ = false;
+      }
+      mutex_lock wl(write_mu_);
+      std::deque<std::unique_ptr<Event>> events;
+      {
+        mutex_lock ml(mu_);
+        events.swap(queue_);
+        last_flush_ = env_->NowMicros();
+      }
+      async_status_.Update(InternalFlush(events));
+    }
+  }
+
   bool is_initialized_;
   const int max_queue_;
   const int flush_millis_;
+  const bool async_writes_;
   uint64 last_flush_;
   Env* env_;
+  // Serializes the writes to the events file, so that the summaries are
+  // written in order. Acquired before mu_, which is not held while writing.
+  mutex write_mu_;
   mutex mu_;
-  std::vector<std::unique_ptr<Event>> queue_ TF_GUARDED_BY(mu_);
+  std::deque<std::unique_ptr<Event>> queue_ TF_GUARDED_BY(mu_);
   // A pointer to allow deferred construction.
-  std::unique_ptr<EventsWriter> events_writer_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<EventsWriter> events_writer_ TF_GUARDED_BY(write_mu_);
+  // The first error of the background writes since the last Flush().
+  Status async_status_ TF_GUARDED_BY(write_mu_);
+  condition_variable flush_cond_;
+  bool flush_requested_ TF_GUARDED_BY(mu_) = false;
+  bool shutdown_ TF_GUARDED_BY(mu_) = false;
+  int64_t num_dropped_ TF_GUARDED_BY(mu_) = 0;
+  std::unique_ptr<Thread> writer_thread_;
   std::vector<std::pair<string, SummaryMetadata>> registered_summaries_
       TF_GUARDED_BY(mu_);
 };
@@ -196,7 +289,18 @@ Status CreateSummaryFileWriter(int max_queue, int flush_millis,
                                const string& logdir,
                                const string& filename_suffix, Env* env,
                                SummaryWriterInterface** result) {
-  SummaryFileWriter* w = new SummaryFileWriter(max_queue, flush_millis, env);
+  return CreateSummaryFileWriter(max_queue, flush_millis, logdir,
+                                 filename_suffix, env, AsyncSummaryWrites(),
+                                 result);
+}
+
+Status CreateSummaryFileWriter(int max_queue, int flush_millis,
+                               const string& logdir,
+                               const string& filename_suffix, Env* env,
+                               bool async_writes,
+                               SummaryWriterInterface** result) {
+  SummaryFileWriter* w =
+      new SummaryFileWriter(max_queue, flush_millis, async_writes, env);
   const Status s = w->Initialize(logdir, filename_suffix);
   if (!s.ok()) {
     w->Unref();
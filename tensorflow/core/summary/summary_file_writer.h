@@ -33,9 +33,24 @@ namespace tensorflow {
 /// filename_suffix. The caller owns a reference to result if the
 /// returned status is ok. The Env object must not be destroyed until
 /// after the returned writer.
+///
+/// If the TF_SUMMARY_ASYNC_WRITES environment variable is true, the
+/// summaries are written as with `async_writes` below.
+Status CreateSummaryFileWriter(int max_queue, int flush_millis,
+                               const string& logdir,
+                               const string& filename_suffix, Env* env,
+                               SummaryWriterInterface** result);
+
+/// \brief Like the above, but if `async_writes` is true, the summaries are
+/// written and flushed on a background thread, so that writing them never
+/// blocks on the file system, except in Flush(). If the background thread
+/// falls behind by more than 100 times max_queue summaries, the oldest ones
+/// are dropped. Errors of the background writes are returned by the next
+/// Flush().
 Status CreateSummaryFileWriter(int max_queue, int flush_millis,
                                const string& logdir,
                                const string& filename_suffix, Env* env,
+                               bool async_writes,
                                SummaryWriterInterface** result);
 
 }  // namespace tensorflow
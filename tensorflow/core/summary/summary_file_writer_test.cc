@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/platform/env.h"
@@ -281,5 +282,47 @@ TEST_F(SummaryFileWriterTest, AvoidFilenameCollision) {
       << "files = [" << absl::StrJoin(files, ", ") << "]";
 }
 
+TEST_F(SummaryFileWriterTest, AsyncWrites) {
+  // Keep unique with all other test names in this file.
+  const string test_name = "async_writes_test";
+  const int num_events = 100;
+  {
+    SummaryWriterInterface* writer;
+    TF_CHECK_OK(CreateSummaryFileWriter(1, 1, testing::TmpDir(), test_name,
+                                        &env_, /*async_writes=*/true,
+                                        &writer));
+    core::ScopedUnref deleter(writer);
+    Tensor one(DT_FLOAT, TensorShape({}));
+    one.scalar<float>()() = 1.0;
+    for (int step = 0; step < num_events; ++step) {
+      TF_CHECK_OK(writer->WriteScalar(step, one, "name"));
+    }
+    TF_CHECK_OK(writer->Flush());
+  }
+  std::vector<string> files;
+  TF_CHECK_OK(env_.GetChildren(testing::TmpDir(), &files));
+  int num_files = 0;
+  for (const string& f : files) {
+    if (!absl::StrContains(f, test_name)) continue;
+    ++num_files;
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env_.NewRandomAccessFile(io::JoinPath(testing::TmpDir(), f),
+                                         &read_file));
+    io::RecordReader reader(read_file.get(), io::RecordReaderOptions());
+    tstring record;
+    uint64 offset = 0;
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));  // The file version.
+    // The summaries are written in order, and none is dropped.
+    for (int step = 0; step < num_events; ++step) {
+      TF_ASSERT_OK(reader.ReadRecord(&offset, &record));
+      Event e;
+      ASSERT_TRUE(e.ParseFromString(record));
+      EXPECT_EQ(e.step(), step);
+    }
+    EXPECT_TRUE(errors::IsOutOfRange(reader.ReadRecord(&offset, &record)));
+  }
+  EXPECT_EQ(num_files, 1);
+}
+
 }  // namespace
 }  // namespace tensorflow
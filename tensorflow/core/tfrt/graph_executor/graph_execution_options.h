@@ -50,6 +50,11 @@ struct GraphExecutionOptions {
   tensorflow::SessionMetadata model_metadata;
 
   tensorflow::TfrtCompileOptions compile_options;
+
+  // The maximum number of client graphs a GraphExecutor keeps loaded. The
+  // least recently used ones are evicted beyond it, and loaded again when
+  // requested. 0 means no limit.
+  int max_num_loaded_client_graphs = 0;
 };
 
 // Per-request options for graph execution.
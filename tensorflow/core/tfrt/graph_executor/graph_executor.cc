@@ -26,6 +26,7 @@ limitations under the License.
 #include <vector>
 
 #include "learning/brain/experimental/tfrt/native_lowering/saved_model/saved_model_translate.h"
+#include "absl/algorithm/container.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
@@ -36,6 +37,7 @@ limitations under the License.
 #include "tensorflow/compiler/mlir/tfrt/translate/import_model.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/statusor.h"
@@ -377,10 +379,11 @@ tensorflow::Status GraphExecutor::Run(
 
   // Load the client graph.
   TF_ASSIGN_OR_RETURN(
-      const LoadedClientGraph& loaded_client_graph,
+      std::shared_ptr<const LoadedClientGraph> loaded_client_graph_ptr,
       GetOrCreateLoadedClientGraph(
           sorted_input_names, sorted_input_dtypes, sorted_output_names,
           sorted_target_node_names, run_options.work_queue));
+  const LoadedClientGraph& loaded_client_graph = *loaded_client_graph_ptr;
 
   const auto* func = loaded_client_graph.bef_file->GetFunction(
       tensorflow::kImportModelDefaultGraphFuncName);
@@ -417,6 +420,70 @@ tensorflow::Status GraphExecutor::Extend(const GraphDef& graph) {
   return graph_execution_state_->Extend(graph);
 }
 
+tensorflow::Status GraphExecutor::Warmup(
+    const ClientGraphSignaturesProto& signatures) {
+  tensorflow::Status status;
+  for (const auto& signature : signatures.signatures()) {
+    if (signature.input_names_size() != signature.input_dtypes_size()) {
+      status.Update(tensorflow::errors::InvalidArgument(
+          "Client graph signature has ", signature.input_names_size(),
+          " inputs but ", signature.input_dtypes_size(), " input dtypes."));
+      continue;
+    }
+    // Sort the names the same way as `Run()` does, keeping the input names
+    // and dtypes together.
+    std::vector<std::string> input_names(signature.input_names().begin(),
+                                         signature.input_names().end());
+    std::vector<std::string> sorted_input_names;
+    std::vector<int> input_original_indices;
+    CreateSortedNamesAndOriginalIndices(input_names, sorted_input_names,
+                                        input_original_indices);
+    std::vector<tensorflow::DataType> sorted_input_dtypes;
+    sorted_input_dtypes.reserve(input_original_indices.size());
+    for (int original_index : input_original_indices) {
+      sorted_input_dtypes.push_back(signature.input_dtypes(original_index));
+    }
+    std::vector<std::string> sorted_output_names(
+        signature.output_names().begin(), signature.output_names().end());
+    std::sort(sorted_output_names.begin(), sorted_output_names.end());
+    std::vector<std::string> sorted_target_names(
+        signature.target_names().begin(), signature.target_names().end());
+    std::sort(sorted_target_names.begin(), sorted_target_names.end());
+
+    status.Update(GetOrCreateLoadedClientGraph(
+                      sorted_input_names, sorted_input_dtypes,
+                      sorted_output_names, sorted_target_names,
+                      /*work_queue=*/nullptr)
+                      .status());
+  }
+  return status;
+}
+
+void GraphExecutor::WarmupInBackground(ClientGraphSignaturesProto signatures) {
+  DCHECK(warmup_thread_ == nullptr) << "Only one warmup can be started.";
+  warmup_thread_.reset(tensorflow::Env::Default()->StartThread(
+      tensorflow::ThreadOptions(), "tfrt_graph_executor_warmup",
+      [this, signatures = std::move(signatures)]() {
+        auto start_time = absl::Now();
+        tensorflow::Status status = Warmup(signatures);
+        LOG(INFO) << "TFRT finished warming up "
+                  << signatures.signatures_size() << " client graphs. Took "
+                  << absl::ToInt64Milliseconds(absl::Now() - start_time)
+                  << " ms. Status: " << status;
+      }));
+}
+
+ClientGraphSignaturesProto GraphExecutor::GetObservedSignatures() const {
+  tensorflow::mutex_lock l(loaded_client_graphs_mu_);
+  return observed_signatures_;
+}
+
+tensorflow::Status GraphExecutor::WriteObservedSignatures(
+    const std::string& path) const {
+  return tensorflow::WriteTextProto(tensorflow::Env::Default(), path,
+                                    GetObservedSignatures());
+}
+
 StatusOr<std::unique_ptr<GraphExecutor::LoadedClientGraph>>
 GraphExecutor::ImportAndCompileClientGraph(
     const GraphExecutor::ClientGraph& client_graph) {
@@ -548,7 +615,7 @@ tensorflow::Status GraphExecutor::InitBef(
   return OkStatus();
 }
 
-StatusOr<std::reference_wrapper<const GraphExecutor::LoadedClientGraph>>
+StatusOr<std::shared_ptr<const GraphExecutor::LoadedClientGraph>>
 GraphExecutor::GetOrCreateLoadedClientGraph(
     absl::Span<const std::string> input_tensor_names,
     absl::Span<const tensorflow::DataType> input_tensor_dtypes,
@@ -564,13 +631,56 @@ GraphExecutor::GetOrCreateLoadedClientGraph(
       kArgumentTypeJoiningDelimiter,
       absl::StrJoin(target_tensor_names, kTensorNameJoiningDelimiter));
 
-  tensorflow::mutex_lock l(loaded_client_graphs_mu_);
+  std::shared_ptr<LoadedClientGraphEntry> entry;
+  bool load = false;
+  {
+    tensorflow::mutex_lock l(loaded_client_graphs_mu_);
+    auto& cached_entry = loaded_client_graphs_[joined_name];
+    if (cached_entry == nullptr) {
+      // Cache miss; this request loads the client graph below.
+      cached_entry = std::make_shared<LoadedClientGraphEntry>();
+      lru_joined_names_.push_front(joined_name);
+      cached_entry->lru_position = lru_joined_names_.begin();
+      load = true;
+
+      bool observed = false;
+      for (const auto& signature : observed_signatures_.signatures()) {
+        if (absl::c_equal(signature.input_names(), input_tensor_names) &&
+            absl::c_equal(signature.output_names(), output_tensor_names) &&
+            absl::c_equal(signature.target_names(), target_tensor_names)) {
+          observed = true;
+          break;
+        }
+      }
+      if (!observed) {
+        auto* signature = observed_signatures_.add_signatures();
+        for (int i = 0; i < input_tensor_names.size(); ++i) {
+          signature->add_input_names(input_tensor_names[i]);
+          signature->add_input_dtypes(input_tensor_dtypes[i]);
+        }
+        for (const auto& name : output_tensor_names) {
+          signature->add_output_names(name);
+        }
+        for (const auto& name : target_tensor_names) {
+          signature->add_target_names(name);
+        }
+      }
+    } else {
+      // Cache hit; mark it as most recently used.
+      lru_joined_names_.splice(lru_joined_names_.begin(), lru_joined_names_,
+                               cached_entry->lru_position);
+    }
+    entry = cached_entry;
+  }
 
-  // Cache hit; return immediately.
-  const auto iter = loaded_client_graphs_.find(joined_name);
-  if (iter != loaded_client_graphs_.end()) return {*iter->second};
+  if (!load) {
+    // The client graph may still be loaded by another request or a warmup.
+    entry->loaded.WaitForNotification();
+    TF_RETURN_IF_ERROR(entry->status);
+    return entry->loaded_client_graph;
+  }
 
-  // Cache miss; populate a `ClientGraph` and load it.
+  // Populate a `ClientGraph` and load it.
   tensorflow::GraphImportConfig::InputArrays input_nodes;
   DCHECK_EQ(input_tensor_names.size(), input_tensor_dtypes.size());
   for (int i = 0; i < input_tensor_names.size(); ++i) {
@@ -587,13 +697,47 @@ GraphExecutor::GetOrCreateLoadedClientGraph(
       std::move(input_nodes),
       {output_tensor_names.begin(), output_tensor_names.end()},
       {target_tensor_names.begin(), target_tensor_names.end()}};
-  TF_ASSIGN_OR_RETURN(auto loaded_client_graph,
-                      LoadClientGraph(client_graph, work_queue));
+  auto loaded_client_graph = LoadClientGraph(client_graph, work_queue);
+
+  {
+    tensorflow::mutex_lock l(loaded_client_graphs_mu_);
+    if (loaded_client_graph.ok()) {
+      entry->loaded_client_graph = std::move(loaded_client_graph).value();
+      MaybeEvictLoadedClientGraphs();
+    } else {
+      // Errors are not cached, so that a later request loads it again.
+      entry->status = loaded_client_graph.status();
+      auto iter = loaded_client_graphs_.find(joined_name);
+      if (iter != loaded_client_graphs_.end() && iter->second == entry) {
+        lru_joined_names_.erase(entry->lru_position);
+        loaded_client_graphs_.erase(iter);
+      }
+    }
+  }
+  entry->loaded.Notify();
+  TF_RETURN_IF_ERROR(entry->status);
+  return entry->loaded_client_graph;
+}
 
-  // Store the new loaded client graph in cache and return.
-  const auto* loaded_client_graph_ptr = loaded_client_graph.get();
-  loaded_client_graphs_[joined_name] = std::move(loaded_client_graph);
-  return {*loaded_client_graph_ptr};
+void GraphExecutor::MaybeEvictLoadedClientGraphs() {
+  const int max_num_loaded_client_graphs =
+      options_.max_num_loaded_client_graphs;
+  if (max_num_loaded_client_graphs <= 0) return;
+  // Graphs still being loaded are not evicted; they are waited for.
+  auto lru_position = lru_joined_names_.end();
+  while (loaded_client_graphs_.size() > max_num_loaded_client_graphs &&
+         lru_position != lru_joined_names_.begin()) {
+    --lru_position;
+    auto iter = loaded_client_graphs_.find(*lru_position);
+    DCHECK(iter != loaded_client_graphs_.end());
+    if (!iter->second->loaded.HasBeenNotified() &&
+        iter->second->loaded_client_graph == nullptr) {
+      continue;
+    }
+    LOG(INFO) << "TFRT evicting client graph " << *lru_position;
+    loaded_client_graphs_.erase(iter);
+    lru_position = lru_joined_names_.erase(lru_position);
+  }
 }
 
 }  // namespace tfrt_stub
@@ -16,14 +16,18 @@ limitations under the License.
 #define TENSORFLOW_CORE_TFRT_GRAPH_EXECUTOR_GRAPH_EXECUTOR_H_
 
 #include <functional>
+#include <list>
 #include <memory>
 #include <string>
 #include <utility>
 
 #include "mlir/IR/BuiltinOps.h"  // from @llvm-project
 #include "tensorflow/core/common_runtime/graph_execution_state.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/tfrt/fallback/fallback_state.h"
+#include "tensorflow/core/tfrt/graph_executor/client_graph_signatures.pb.h"
 #include "tensorflow/core/tfrt/graph_executor/graph_execution_options.h"
 #include "tensorflow/core/tfrt/runtime/work_queue_interface.h"
 #include "tensorflow/core/tfrt/tpu/tpu_resources.h"
@@ -132,6 +136,27 @@ class GraphExecutor {
   // Extends the current graph by `graph`.
   tensorflow::Status Extend(const GraphDef& graph);
 
+  // Loads the client graphs of `signatures` that are not loaded yet, so that
+  // the first requests using them do not pay for their compilation. Returns
+  // the first error, after trying all signatures.
+  tensorflow::Status Warmup(const ClientGraphSignaturesProto& signatures)
+      TF_LOCKS_EXCLUDED(loaded_client_graphs_mu_);
+
+  // Like `Warmup()`, but on a background thread. Requests are served while the
+  // warmup is in progress; a request for a client graph that is being loaded
+  // waits for it instead of loading it again. Warmup failures are logged. At
+  // most one background warmup may be started.
+  void WarmupInBackground(ClientGraphSignaturesProto signatures);
+
+  // Returns the signatures of all client graphs requested so far, in the
+  // order they were first requested, including evicted ones.
+  ClientGraphSignaturesProto GetObservedSignatures() const
+      TF_LOCKS_EXCLUDED(loaded_client_graphs_mu_);
+
+  // Writes `GetObservedSignatures()` as a text proto to `path`, e.g. to warm
+  // up the next version of the model.
+  tensorflow::Status WriteObservedSignatures(const std::string& path) const;
+
   tensorflow::tfrt_stub::TfrtGraphExecutionState& graph_execution_state()
       const {
     return *graph_execution_state_;
@@ -161,8 +186,9 @@ class GraphExecutor {
       tensorflow::tfrt_stub::WorkQueueInterface* work_queue);
 
   // Returns a `LoadedClientGraph` given input/output tensor info. If there is
-  // no existing one yet, creates one first.
-  StatusOr<std::reference_wrapper<const GraphExecutor::LoadedClientGraph>>
+  // no existing one yet, creates one first. The returned graph stays valid
+  // when it is evicted from the cache.
+  StatusOr<std::shared_ptr<const GraphExecutor::LoadedClientGraph>>
   GetOrCreateLoadedClientGraph(
       absl::Span<const std::string> input_tensor_names,
       absl::Span<const tensorflow::DataType> input_tensor_dtypes,
@@ -180,13 +206,37 @@ class GraphExecutor {
 
   tfrt::RequestDeadlineTracker req_deadline_tracker_;
 
-  tensorflow::mutex loaded_client_graphs_mu_;
-  // Caches `LoadedClientGraph` by the joined name.
-  // For pointer stability of values in `absl::flat_hash_map<>`, additional
-  // `std::unique_ptr<>` is necessary. (See https://abseil.io/tips/136.)
+  // A cached client graph. `loaded` is notified once loading is done, after
+  // which `status` and `loaded_client_graph` are set.
+  struct LoadedClientGraphEntry {
+    tensorflow::Notification loaded;
+    tensorflow::Status status;
+    std::shared_ptr<const LoadedClientGraph> loaded_client_graph;
+    // Position in `lru_joined_names_`.
+    std::list<std::string>::iterator lru_position;
+  };
+
+  // Evicts the least recently used loaded client graphs beyond
+  // `Options::max_num_loaded_client_graphs`.
+  void MaybeEvictLoadedClientGraphs()
+      TF_EXCLUSIVE_LOCKS_REQUIRED(loaded_client_graphs_mu_);
+
+  mutable tensorflow::mutex loaded_client_graphs_mu_;
+  // Caches `LoadedClientGraph` by the joined name. Graphs are loaded outside
+  // of the lock, so that loading one does not block requests for others.
   absl::flat_hash_map<std::string /*joined_name*/,
-                      std::unique_ptr<LoadedClientGraph>>
+                      std::shared_ptr<LoadedClientGraphEntry>>
       loaded_client_graphs_ TF_GUARDED_BY(loaded_client_graphs_mu_);
+  // Joined names of `loaded_client_graphs_`, most recently used first.
+  std::list<std::string> lru_joined_names_
+      TF_GUARDED_BY(loaded_client_graphs_mu_);
+  // The signatures of all client graphs requested so far, in request order.
+  ClientGraphSignaturesProto observed_signatures_
+      TF_GUARDED_BY(loaded_client_graphs_mu_);
+
+  // Declared last, so that a background warmup finishes before the rest of
+  // the executor is destroyed.
+  std::unique_ptr<tensorflow::Thread> warmup_thread_;
 };
 
 }  // namespace tfrt_stub
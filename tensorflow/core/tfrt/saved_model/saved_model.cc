@@ -37,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/monitoring/gauge.h"
 #include "tensorflow/core/platform/enable_tf2_utils.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -447,6 +448,23 @@ void GetSignaturesFromSignatureDef(
   }
 }
 
+// The op costs recorded by tfrt_stub::CostRecorder can be shipped with a
+// SavedModel at this path, relative to the SavedModel directory.
+constexpr char kOpCostMapFilePath[] = "assets.extra/tfrt_op_cost_map.pbtxt";
+
+void UpdateOpCostMapFile(SavedModel::Options& options,
+                         absl::string_view saved_model_dir) {
+  auto& compile_options = options.graph_execution_options.compile_options;
+  if (!compile_options.op_cost_map_file.empty()) return;
+
+  std::string op_cost_map_file =
+      tensorflow::io::JoinPath(saved_model_dir, kOpCostMapFilePath);
+  if (tensorflow::Env::Default()->FileExists(op_cost_map_file).ok()) {
+    LOG(INFO) << "TFRT using the op costs recorded in " << op_cost_map_file;
+    compile_options.op_cost_map_file = std::move(op_cost_map_file);
+  }
+}
+
 void UpdateCompileOptions(SavedModel::Options& options) {
   // Disable DecomposeResourceOpsPass for now, as DecomposeResourceGather does
   // not work well with GPU (b/232819415).
@@ -467,6 +485,7 @@ std::unique_ptr<SavedModel> SavedModelImpl::LoadSavedModel(
   UpdateTpuTargetByBridgeCompatibility(options.graph_execution_options,
                                        meta_graph_def.graph_def());
   UpdateCompileOptions(options);
+  UpdateOpCostMapFile(options, saved_model_dir);
 
   auto statusor_saved_model =
       [&]() -> tensorflow::StatusOr<std::unique_ptr<SavedModel>> {
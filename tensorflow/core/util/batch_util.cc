@@ -15,9 +15,12 @@ limitations under the License.
 
 #include "tensorflow/core/util/batch_util.h"
 
+#include <algorithm>
+
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
 
 #define TF_CALL_DATASET_TYPES(m) TF_CALL_ALL_TYPES(m) TF_CALL_QUANTIZED_TYPES(m)
 
@@ -397,6 +400,100 @@ Status CopyElementToLargerSlice(const Tensor& element, Tensor* parent,
   }
 }
 
+namespace {
+
+// Copies the `rank`-dimensional array `src` into the larger array `dst` and
+// sets the rest of `dst` to `padding`, where the arrays have dimensions
+// `src_dims` and `dst_dims`, and the i^th dimension of each array has stride
+// `*_strides[i]`.
+template <typename T>
+void CopyAndPad(const T* src, const int64_t* src_dims,
+                const int64_t* src_strides, T* dst, const int64_t* dst_dims,
+                const int64_t* dst_strides, int rank, const T& padding) {
+  if (rank == 1) {
+    std::copy(src, src + src_dims[0], dst);
+    std::fill(dst + src_dims[0], dst + dst_dims[0], padding);
+    return;
+  }
+  for (int64_t i = 0; i < src_dims[0]; ++i) {
+    CopyAndPad(src + i * src_strides[0], src_dims + 1, src_strides + 1,
+               dst + i * dst_strides[0], dst_dims + 1, dst_strides + 1,
+               rank - 1, padding);
+  }
+  // The rows past the end of `src` only hold padding.
+  std::fill(dst + src_dims[0] * dst_strides[0],
+            dst + dst_dims[0] * dst_strides[0], padding);
+}
+
+}  // namespace
+
+Status CopyElementToLargerSliceWithPadding(const Tensor& element,
+                                           const Tensor& padding,
+                                           Tensor* parent, int64_t index) {
+  const int rank = element.dims();
+  if (parent->dims() != rank + 1) {
+    return errors::Internal(
+        "Mismatched ranks.  Element's rank is: ", rank,
+        " but element is meant to be a slice in output Tensor having rank: ",
+        parent->dims(), " (should be: ", rank + 1, ")");
+  }
+  if (element.dtype() != parent->dtype() ||
+      padding.dtype() != parent->dtype()) {
+    return errors::Internal(
+        "CopyElementToLargerSliceWithPadding Mismatched data types: element ",
+        DataTypeString(element.dtype()), ", padding ",
+        DataTypeString(padding.dtype()), " and parent ",
+        DataTypeString(parent->dtype()));
+  }
+  gtl::InlinedVector<int64_t, 4> src_dims(rank), dst_dims(rank);
+  for (int i = 0; i < rank; ++i) {
+    src_dims[i] = element.dim_size(i);
+    dst_dims[i] = parent->dim_size(i + 1);
+    if (src_dims[i] > dst_dims[i]) {
+      TensorShape chip_shape = parent->shape();
+      chip_shape.RemoveDim(0);
+      return errors::Internal(
+          "CopyElementToLargerSliceWithPadding Cannot copy slice: element is "
+          "larger than the parent slice.  Shapes are: [element]: ",
+          element.shape().DebugString(),
+          ", [parent slice]: ", chip_shape.DebugString());
+    }
+  }
+  gtl::InlinedVector<int64_t, 4> src_strides(rank), dst_strides(rank);
+  int64_t src_stride = 1;
+  int64_t dst_stride = 1;
+  for (int i = rank - 1; i >= 0; --i) {
+    src_strides[i] = src_stride;
+    dst_strides[i] = dst_stride;
+    src_stride *= src_dims[i];
+    dst_stride *= dst_dims[i];
+  }
+  // `dst_stride` is now the number of values of a slice.
+
+#define HANDLE_TYPE(T)                                                 \
+  case DataTypeToEnum<T>::value: {                                     \
+    const T& pad = padding.scalar<T>()();                              \
+    T* dst = parent->flat<T>().data() + index * dst_stride;            \
+    if (rank == 0) {                                                   \
+      *dst = element.scalar<T>()();                                    \
+    } else {                                                           \
+      CopyAndPad(element.flat<T>().data(), src_dims.data(),            \
+                 src_strides.data(), dst, dst_dims.data(),             \
+                 dst_strides.data(), rank, pad);                       \
+    }                                                                  \
+    return OkStatus();                                                 \
+  }
+
+  switch (parent->dtype()) {
+    TF_CALL_DATASET_TYPES(HANDLE_TYPE);
+#undef HANDLE_TYPE
+    default:
+      return errors::Unimplemented(
+          "CopyElementToLargerSliceWithPadding Unhandled data type: ",
+          parent->dtype());
+  }
+}
+
 Status SetElementZero(Tensor* element, const Tensor& padding) {
 #define HANDLE_TYPE(T)                                     \
   if (element->dtype() == DataTypeToEnum<T>::value) {      \
@@ -60,6 +60,15 @@ Status SetElementZero(Tensor* element, const Tensor& padding);
 Status CopyElementToLargerSlice(const Tensor& element, Tensor* parent,
                                 int index);
 
+// Copies `element` into the index^th slice of `parent` (in the 0th dimension),
+// and sets the rest of the slice to the scalar stored in `padding`. The shape
+// of `element` must not be larger along any axis than a slice. Unlike
+// `SetElementZero` followed by `CopyElementToLargerSlice`, this writes every
+// value of the slice once, in order.
+Status CopyElementToLargerSliceWithPadding(const Tensor& element,
+                                           const Tensor& padding,
+                                           Tensor* parent, int64_t index);
+
 }  // namespace batch_util
 }  // namespace tensorflow
 
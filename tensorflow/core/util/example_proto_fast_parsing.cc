@@ -113,6 +113,37 @@ constexpr uint8 kVarintTag(uint32 tag) { return (tag << 3) | 0; }
 constexpr uint8 kDelimitedTag(uint32 tag) { return (tag << 3) | 2; }
 constexpr uint8 kFixed32Tag(uint32 tag) { return (tag << 3) | 5; }
 
+// Returns the number of varints in the packed buffer [begin, end). The loop
+// has no dependencies between iterations, so compilers vectorize it.
+inline size_t CountVarints(const uint8* begin, const uint8* end) {
+  size_t count = 0;
+  for (const uint8* p = begin; p < end; ++p) {
+    count += (*p & 0x80) == 0;
+  }
+  return count;
+}
+
+// Decodes the varint at `ptr` into `value`, and returns the position after it,
+// or nullptr if it is longer than 10 bytes or does not end before `end`.
+inline const uint8* DecodeVarint64(const uint8* ptr, const uint8* end,
+                                   protobuf_uint64* value) {
+  // Most values in practice, e.g. ids and counts, fit in one byte.
+  if (ptr < end && *ptr < 0x80) {
+    *value = *ptr;
+    return ptr + 1;
+  }
+  protobuf_uint64 result = 0;
+  for (int shift = 0; shift < 70 && ptr < end; shift += 7) {
+    const uint8 byte = *ptr++;
+    result |= static_cast<protobuf_uint64>(byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      *value = result;
+      return ptr;
+    }
+  }
+  return nullptr;
+}
+
 namespace parsed {
 
 // ParseDataType has to be called first, then appropriate ParseZzzzList.
@@ -299,15 +330,35 @@ class Feature {
         if (!stream.ExpectTag(kDelimitedTag(1))) return false;  // packed tag
         uint32 packed_length;
         if (!stream.ReadVarint32(&packed_length)) return false;
-        auto packed_limit = stream.PushLimit(packed_length);
-
-        while (!stream.ExpectAtEnd()) {
+        const size_t packed_begin = stream.CurrentPosition();
+        if (packed_length > serialized_.size() - packed_begin ||
+            static_cast<int>(packed_length) > stream.BytesUntilLimit()) {
+          return false;
+        }
+        const uint8* begin =
+            reinterpret_cast<const uint8*>(serialized_.data()) + packed_begin;
+        const uint8* end = begin + packed_length;
+
+        // Every varint ends with the only one of its bytes that does not have
+        // the continuation bit set, so counting those bytes gives the number
+        // of values, and the output is resized only once.
+        const size_t initial_size = int64_list->size();
+        const size_t num_values = CountVarints(begin, end);
+        int64_list->resize(initial_size + num_values);
+        // Like in ParseFloatList, a LimitedArraySlice may have room for fewer
+        // values than we requested. The remaining values are still decoded
+        // to validate them.
+        const size_t num_to_store =
+            std::min(num_values, int64_list->size() - initial_size);
+        int64_t* out = int64_list->data() + initial_size;
+        const uint8* ptr = begin;
+        for (size_t i = 0; i < num_values; ++i) {
           protobuf_uint64 n;  // There is no API for int64
-          if (!stream.ReadVarint64(&n)) return false;
-          int64_list->push_back(static_cast<int64_t>(n));
+          ptr = DecodeVarint64(ptr, end, &n);
+          if (ptr == nullptr) return false;
+          if (i < num_to_store) out[i] = static_cast<int64_t>(n);
         }
-
-        stream.PopLimit(packed_limit);
+        if (ptr != end || !stream.Skip(packed_length)) return false;
       } else {  // non-packed
         while (!stream.ExpectAtEnd()) {
           if (!stream.ExpectTag(kVarintTag(1))) return false;
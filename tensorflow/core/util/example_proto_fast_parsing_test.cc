@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <limits>
 #include <utility>
 
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
@@ -217,6 +218,22 @@ TEST(FastParse, SingleInt64) {
   TestCorrectness(Serialize(example));
 }
 
+TEST(FastParse, PackedInt64OfAllLengths) {
+  Example example;
+  auto* int64_list = (*example.mutable_features()->mutable_feature())["ids"]
+                         .mutable_int64_list();
+  // Varints of every length from 1 to 10 bytes.
+  for (int shift = 0; shift < 64; shift += 7) {
+    int64_list->add_value(int64_t{1} << shift);
+  }
+  for (int64_t value : {int64_t{0}, int64_t{127}, int64_t{128}, int64_t{-1},
+                        std::numeric_limits<int64_t>::max(),
+                        std::numeric_limits<int64_t>::min()}) {
+    int64_list->add_value(value);
+  }
+  TestCorrectness(Serialize(example));
+}
+
 static string ExampleWithSomeFeatures() {
   Example example;
 
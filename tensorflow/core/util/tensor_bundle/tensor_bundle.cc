@@ -21,6 +21,7 @@ limitations under the License.
 #include <memory>
 #include <utility>
 
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
@@ -41,6 +42,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/cord.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mem.h"
@@ -70,6 +72,27 @@ const char* const kHeaderEntryKey = "";
 
 namespace {
 
+// A tensor buffer that is a view of a memory-mapped data file, and keeps the
+// file mapped.
+class MappedTensorBuffer : public TensorBuffer {
+ public:
+  MappedTensorBuffer(std::shared_ptr<ReadOnlyMemoryRegion> region,
+                     char* data, size_t size)
+      : TensorBuffer(data), region_(std::move(region)), size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("mmap");
+  }
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const std::shared_ptr<ReadOnlyMemoryRegion> region_;
+  const size_t size_;
+};
+
 // Reads "num_elements" string elements from file[offset, offset+size) into the
 // length-N "destination".  Discards the original content of "destination".
 //
@@ -390,6 +413,9 @@ table::Options TableBuilderOptions() {
   // (version 1.2) with the intention that they will be enabled again at
   // some point (perhaps the 1.3 release?).
   o.compression = table::kNoCompression;
+  // Readers that do not use the filters, including older releases, ignore
+  // them.
+  o.filter_bits_per_key = 10;
   return o;
 }
 
@@ -755,13 +781,18 @@ Status MergeBundles(Env* env, gtl::ArraySlice<tstring> prefixes,
 // Interface for reading a tensor bundle.
 
 BundleReader::BundleReader(Env* env, StringPiece prefix)
+    : BundleReader(env, prefix, Options()) {}
+
+BundleReader::BundleReader(Env* env, StringPiece prefix,
+                           const Options& options)
     : env_(env),
       prefix_(prefix),
       metadata_(nullptr),
       table_(nullptr),
       index_cache_(nullptr),
       iter_(nullptr),
-      need_to_swap_bytes_(false) {
+      need_to_swap_bytes_(false),
+      options_(options) {
   const string filename = MetaFilename(prefix_);
   uint64 file_size;
   status_ = env_->GetFileSize(filename, &file_size);
@@ -782,7 +813,17 @@ BundleReader::BundleReader(Env* env, StringPiece prefix)
     o.block_cache = index_cache_;
   }
 
-  status_ = table::Table::Open(o, metadata_, file_size, &table_);
+  if (options_.map_metadata) {
+    std::unique_ptr<ReadOnlyMemoryRegion> region;
+    if (env_->NewReadOnlyMemoryRegionFromFile(filename, &region).ok()) {
+      mapped_metadata_ = std::move(region);
+    }
+  }
+  if (mapped_metadata_ != nullptr) {
+    status_ = table::Table::Open(o, mapped_metadata_.get(), &table_);
+  } else {
+    status_ = table::Table::Open(o, metadata_, file_size, &table_);
+  }
   if (!status_.ok()) return;
   iter_ = table_->NewIterator();
 
@@ -836,6 +877,9 @@ Status BundleReader::GetBundleEntryProto(StringPiece key,
                                          BundleEntryProto* entry) {
   entry->Clear();
   TF_CHECK_OK(status_);
+  if (!table_->MayContain(key)) {
+    return errors::NotFound("Key ", key, " not found in checkpoint");
+  }
   Seek(key);
   if (!iter_->Valid() || iter_->key() != key) {
     return errors::NotFound("Key ", key, " not found in checkpoint");
@@ -853,7 +897,59 @@ Status BundleReader::GetBundleEntryProto(StringPiece key,
   return OkStatus();
 }
 
+Status BundleReader::GetMappedValue(const BundleEntryProto& entry, Tensor* val,
+                                    bool* mapped) {
+  *mapped = false;
+  if (!options_.map_data_files || val->NumElements() != 0 ||
+      !DataTypeCanUseMemcpy(entry.dtype()) || need_to_swap_bytes_ ||
+      entry.size() == 0) {
+    return OkStatus();
+  }
+  const TensorShape stored_shape(entry.shape());
+  if (entry.size() !=
+      stored_shape.num_elements() * DataTypeSize(entry.dtype())) {
+    return errors::DataLoss("Invalid size in bundle entry: key ", key(),
+                            "; stored size ", entry.size());
+  }
+  auto it = mapped_data_.find(entry.shard_id());
+  if (it == mapped_data_.end()) {
+    std::unique_ptr<ReadOnlyMemoryRegion> region;
+    const Status s = env_->NewReadOnlyMemoryRegionFromFile(
+        DataFilename(prefix_, entry.shard_id(), num_shards_), &region);
+    if (!s.ok()) {
+      VLOG(1) << "Reading tensor bundle " << prefix_
+              << " without memory mapping: " << s;
+    }
+    it = mapped_data_.emplace(entry.shard_id(), std::move(region)).first;
+  }
+  const std::shared_ptr<ReadOnlyMemoryRegion>& region = it->second;
+  if (region == nullptr || entry.offset() + entry.size() > region->length()) {
+    return OkStatus();
+  }
+  const char* data = static_cast<const char*>(region->data()) + entry.offset();
+  if (reinterpret_cast<uintptr_t>(data) % EIGEN_MAX_ALIGN_BYTES != 0) {
+    return OkStatus();
+  }
+  const uint32 actual_crc32c = crc32c::Value(data, entry.size());
+  if (crc32c::Unmask(entry.crc32c()) != actual_crc32c) {
+    return errors::DataLoss(
+        "TensorBundle at ", prefix_, " shard ", entry.shard_id(), " (",
+        entry.size(), " bytes): Checksum does not match: stored ",
+        strings::Printf("%08u", crc32c::Unmask(entry.crc32c())),
+        " vs. calculated on the mapped bytes ", actual_crc32c);
+  }
+  core::RefCountPtr<TensorBuffer> buffer(
+      new MappedTensorBuffer(region, const_cast<char*>(data), entry.size()));
+  *val = Tensor(entry.dtype(), stored_shape, std::move(buffer));
+  *mapped = true;
+  return OkStatus();
+}
+
 Status BundleReader::GetValue(const BundleEntryProto& entry, Tensor* val) {
+  bool mapped;
+  TF_RETURN_IF_ERROR(GetMappedValue(entry, val, &mapped));
+  if (mapped) return OkStatus();
+
   Tensor* ret = val;
   const TensorShape stored_shape(TensorShape(entry.shape()));
   if (val->NumElements() == 0) {
@@ -900,7 +996,11 @@ Status BundleReader::GetValue(const BundleEntryProto& entry, Tensor* val) {
   if (DataTypeCanUseMemcpy(entry.dtype())) {
     char* backing_buffer = const_cast<char*>((ret->tensor_data().data()));
     size_t unused_bytes_read;
-    if (entry.size() > kBufferSize) {
+    if (options_.read_pool != nullptr &&
+        entry.size() > options_.parallel_read_size) {
+      TF_RETURN_IF_ERROR(ReadInParallel(buffered_file->file(), entry.offset(),
+                                        entry.size(), backing_buffer));
+    } else if (entry.size() > kBufferSize) {
       StringPiece sp;
       TF_RETURN_IF_ERROR(buffered_file->file()->Read(
           entry.offset(), entry.size(), &sp, backing_buffer));
@@ -949,6 +1049,32 @@ Status BundleReader::GetValue(const BundleEntryProto& entry, Tensor* val) {
   return OkStatus();
 }
 
+Status BundleReader::ReadInParallel(RandomAccessFile* file, uint64 offset,
+                                    size_t size, char* buffer) {
+  const int64_t range_size = options_.parallel_read_size;
+  const int64_t num_ranges = (size + range_size - 1) / range_size;
+  std::vector<Status> statuses(num_ranges);
+  BlockingCounter counter(num_ranges);
+  for (int64_t i = 0; i < num_ranges; ++i) {
+    options_.read_pool->Schedule([&, i]() {
+      const uint64 range_offset = i * range_size;
+      const size_t n = std::min<uint64>(range_size, size - range_offset);
+      char* dst = buffer + range_offset;
+      StringPiece sp;
+      statuses[i] = file->Read(offset + range_offset, n, &sp, dst);
+      if (statuses[i].ok() && sp.data() != dst) {
+        memmove(dst, sp.data(), sp.size());
+      }
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return OkStatus();
+}
+
 Status BundleReader::Lookup(StringPiece key, Tensor* val) {
   CHECK(val != nullptr);
   BundleEntryProto entry;
@@ -1117,6 +1243,7 @@ Status BundleReader::GetSliceValue(StringPiece full_tensor_key,
 }
 
 bool BundleReader::Contains(StringPiece key) {
+  if (!table_->MayContain(key)) return false;
   Seek(key);
   return Valid() && (this->key() == key);
 }
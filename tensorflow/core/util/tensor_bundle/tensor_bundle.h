@@ -72,6 +72,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_slice.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/lib/io/cache.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
@@ -196,13 +197,42 @@ Status MergeBundles(Env* env, gtl::ArraySlice<tstring> prefixes,
 // All threads accessing the same BundleReader must synchronize.
 class BundleReader {
  public:
+  struct Options {
+    Options() {}
+    // If true, the data files are memory-mapped where the filesystem supports
+    // it, and the tensors of types that can be memcpy'd are returned as views
+    // of the mapped files instead of copies, when the reader allocates them
+    // (see Lookup()) and their data is aligned to EIGEN_MAX_ALIGN_BYTES in the
+    // file, e.g. because the bundle was written with that
+    // `BundleWriter::Options::data_alignment`. Such tensors keep their file
+    // mapped while they are alive.
+    bool map_data_files{false};
+    // If true, the metadata table is memory-mapped where the filesystem
+    // supports it, so that its index blocks are read in place instead of
+    // being copied into the index cache.
+    bool map_metadata{false};
+    // If not null, the values of types that can be memcpy'd and that are
+    // larger than `parallel_read_size` bytes are read in ranges of that size,
+    // concurrently on this pool, so that large tensors keep several reads in
+    // flight. Not owned; must outlive the reader. The pool must not run the
+    // calls to this reader, since they block until their reads are done.
+    thread::ThreadPool* read_pool{nullptr};
+    int64_t parallel_read_size{16 << 20};
+  };
   BundleReader(Env* const env, StringPiece prefix);
+  BundleReader(Env* const env, StringPiece prefix, const Options& options);
   ~BundleReader();
 
   // Is ok() iff the reader construction is successful (completed the read of
   // the metadata).
   Status status() const { return status_; }
 
+  // Sets `Options::read_pool`, e.g. once the caller knows that there are
+  // values to read in parallel.
+  void set_read_pool(thread::ThreadPool* read_pool) {
+    options_.read_pool = read_pool;
+  }
+
   // Queries whether the bundle contains an entry keyed by "key".  Calls Seek()
   // internally, so this call invalidates the reader's current position.
   // REQUIRES: status().ok()
@@ -301,6 +331,18 @@ class BundleReader {
   Status GetValue(const BundleEntryProto& entry,
                   Tensor* val) TF_MUST_USE_RESULT;
 
+  // Sets "val" to a view of the tensor value described by "entry" in the
+  // mapped data file, and "mapped" to true, if `Options::map_data_files` is
+  // set and the value can be mapped. Sets "mapped" to false otherwise.
+  Status GetMappedValue(const BundleEntryProto& entry, Tensor* val,
+                        bool* mapped) TF_MUST_USE_RESULT;
+
+  // Reads "size" bytes of "file" at "offset" into "buffer", in ranges of
+  // `Options::parallel_read_size` bytes that are read concurrently on
+  // `Options::read_pool`.
+  Status ReadInParallel(RandomAccessFile* file, uint64 offset, size_t size,
+                        char* buffer) TF_MUST_USE_RESULT;
+
   // Reads the slice described by "slice_spec".  The corresponding full tensor
   // has key "ful_tensor_key" and metadata proto "full_tensor_entry".
   // REQUIRES: full_tensor_entry.slices_size() > 0
@@ -314,11 +356,16 @@ class BundleReader {
 
   Status status_;
   RandomAccessFile* metadata_;  // Owned.
+  // The mapped metadata table, if `Options::map_metadata`.
+  std::unique_ptr<ReadOnlyMemoryRegion> mapped_metadata_;
   table::Table* table_;
   table::Cache* index_cache_;
   table::Iterator* iter_;
   // Owned the InputBuffer objects and their underlying RandomAccessFile's.
   std::unordered_map<int32, io::InputBuffer*> data_;
+  // The mapped data files, or nullptr for the files that cannot be mapped.
+  std::unordered_map<int32, std::shared_ptr<ReadOnlyMemoryRegion>>
+      mapped_data_;
 
   // Maps each partitioned tensor's key to its stored slices (represented in a
   // TensorSliceSet).  Populated on-demand.
@@ -332,6 +379,8 @@ class BundleReader {
   // differs from that of the current system's processor architecture.
   bool need_to_swap_bytes_;
 
+  Options options_;
+
   friend class TensorBundleAlignmentTest;  // For testing data alignment.
 
   TF_DISALLOW_COPY_AND_ASSIGN(BundleReader);
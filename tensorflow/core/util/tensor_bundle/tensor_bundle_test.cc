@@ -19,6 +19,7 @@ limitations under the License.
 #include <string>
 #include <vector>
 
+#include "tensorflow/core/framework/tensor_description.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.pb.h"
@@ -1153,6 +1154,100 @@ TEST_F(TensorBundleAlignmentTest, AlignmentTest) {
   }
 }
 
+TEST(TensorBundleTest, ParallelReads) {
+  Tensor large(DT_FLOAT, TensorShape({1000}));
+  test::FillIota<float>(&large, 0.0f);
+  {
+    BundleWriter writer(Env::Default(), Prefix("foo"));
+    TF_EXPECT_OK(writer.Add("foo_000", Constant_2x3<float>(0)));
+    TF_EXPECT_OK(writer.Add("foo_001", large));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  thread::ThreadPool pool(Env::Default(), "parallel_reads", 4);
+  BundleReader::Options opts;
+  opts.read_pool = &pool;
+  // The large tensor is read in 4 ranges, the last of which is partial.
+  opts.parallel_read_size = 1024;
+  BundleReader reader(Env::Default(), Prefix("foo"), opts);
+  TF_ASSERT_OK(reader.status());
+  Tensor val;
+  TF_ASSERT_OK(reader.Lookup("foo_000", &val));
+  test::ExpectTensorEqual<float>(val, Constant_2x3<float>(0));
+  TF_ASSERT_OK(reader.Lookup("foo_001", &val));
+  test::ExpectTensorEqual<float>(val, large);
+}
+
+TEST(TensorBundleTest, MapDataFiles) {
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = EIGEN_MAX_ALIGN_BYTES;
+    BundleWriter writer(Env::Default(), Prefix("foo"), opts);
+    TF_EXPECT_OK(writer.Add("foo_000", Constant_2x3<float>(0)));
+    TF_EXPECT_OK(writer.Add("foo_001", Constant(true, TensorShape({3}))));
+    TF_EXPECT_OK(writer.Add("foo_002", Constant_2x3<double>(2)));
+    TF_EXPECT_OK(writer.Add("foo_003", Constant_2x3<tstring>("foo")));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  BundleReader::Options opts;
+  opts.map_data_files = true;
+  BundleReader reader(Env::Default(), Prefix("foo"), opts);
+  TF_ASSERT_OK(reader.status());
+  const auto allocator_name = [](const Tensor& t) {
+    TensorDescription description;
+    t.FillDescription(&description);
+    return description.allocation_description().allocator_name();
+  };
+  Tensor val;
+  TF_ASSERT_OK(reader.Lookup("foo_000", &val));
+  test::ExpectTensorEqual<float>(val, Constant_2x3<float>(0));
+  EXPECT_EQ("mmap", allocator_name(val));
+  Tensor bools;
+  TF_ASSERT_OK(reader.Lookup("foo_001", &bools));
+  test::ExpectTensorEqual<bool>(bools, Constant(true, TensorShape({3})));
+  EXPECT_EQ("mmap", allocator_name(bools));
+  TF_ASSERT_OK(reader.Lookup("foo_002", &val));
+  test::ExpectTensorEqual<double>(val, Constant_2x3<double>(2));
+  EXPECT_EQ("mmap", allocator_name(val));
+  // Strings are not stored as their in-memory representation.
+  Tensor strings;
+  TF_ASSERT_OK(reader.Lookup("foo_003", &strings));
+  test::ExpectTensorEqual<tstring>(strings, Constant_2x3<tstring>("foo"));
+  EXPECT_NE("mmap", allocator_name(strings));
+  // An allocated output tensor is filled in place.
+  Tensor allocated(DT_FLOAT, TensorShape({2, 3}));
+  TF_ASSERT_OK(reader.Lookup("foo_000", &allocated));
+  test::ExpectTensorEqual<float>(allocated, Constant_2x3<float>(0));
+  EXPECT_NE("mmap", allocator_name(allocated));
+}
+
+TEST(TensorBundleTest, MapMetadata) {
+  {
+    BundleWriter writer(Env::Default(), Prefix("foo"));
+    for (int i = 0; i < 100; ++i) {
+      TF_EXPECT_OK(writer.Add(strings::StrCat("foo_", i),
+                              Constant_2x3<float>(static_cast<float>(i))));
+    }
+    TF_ASSERT_OK(writer.Finish());
+  }
+  BundleReader::Options opts;
+  opts.map_metadata = true;
+  BundleReader reader(Env::Default(), Prefix("foo"), opts);
+  TF_ASSERT_OK(reader.status());
+  for (int i = 0; i < 100; ++i) {
+    const string key = strings::StrCat("foo_", i);
+    EXPECT_TRUE(reader.Contains(key));
+    Tensor val;
+    TF_ASSERT_OK(reader.Lookup(key, &val));
+    test::ExpectTensorEqual<float>(val,
+                                   Constant_2x3<float>(static_cast<float>(i)));
+  }
+  // The keys that are not in the bundle are ruled out by its Bloom filters.
+  EXPECT_FALSE(reader.Contains("foo_5a"));
+  EXPECT_FALSE(reader.Contains("bar"));
+  Tensor val;
+  EXPECT_TRUE(errors::IsNotFound(reader.Lookup("foo_5a", &val)));
+}
+
 static void BM_BundleAlignment(::testing::benchmark::State& state) {
   {
     const int alignment = state.range(0);
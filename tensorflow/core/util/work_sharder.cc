@@ -16,6 +16,8 @@ limitations under the License.
 #include "tensorflow/core/util/work_sharder.h"
 
 #include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env_time.h"
 #include "tensorflow/core/platform/logging.h"
 
 namespace tensorflow {
@@ -51,6 +53,83 @@ void Shard(int max_parallelism, thread::ThreadPool* workers, int64_t total,
       max_parallelism);
 }
 
+AdaptiveShardCost::AdaptiveShardCost(int64_t initial_cost_per_unit)
+    : initial_cost_per_unit_(initial_cost_per_unit) {
+  for (auto& ns_per_unit : ns_per_unit_) {
+    ns_per_unit.store(0.0, std::memory_order_relaxed);
+  }
+}
+
+int AdaptiveShardCost::Bucket(int64_t total) {
+  int bucket = 0;
+  while (bucket < kNumBuckets - 1 && (total >> (bucket + 1)) > 0) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+int64_t AdaptiveShardCost::CostPerUnit(int64_t total) const {
+  const double ns_per_unit =
+      ns_per_unit_[Bucket(total)].load(std::memory_order_relaxed);
+  if (ns_per_unit <= 0.0) {
+    return initial_cost_per_unit_;
+  }
+  // Shard() takes costs in cycles.
+  static const double cycles_per_ns = [] {
+    const double frequency = port::NominalCPUFrequency();
+    return frequency > 0.0 ? frequency / 1e9 : 1.0;
+  }();
+  return std::max<int64_t>(1, ns_per_unit * cycles_per_ns + 0.5);
+}
+
+bool AdaptiveShardCost::ShouldMeasure(int64_t total) {
+  if (ns_per_unit_[Bucket(total)].load(std::memory_order_relaxed) <= 0.0) {
+    return true;
+  }
+  return num_calls_.fetch_add(1, std::memory_order_relaxed) %
+             kSamplingPeriod ==
+         0;
+}
+
+void AdaptiveShardCost::RecordMeasurement(int64_t total, int64_t busy_ns) {
+  if (total <= 0) return;
+  // The weight of a new measurement in the moving average.
+  constexpr double kWeight = 0.25;
+  const double measured = std::max(static_cast<double>(busy_ns) / total, 1e-3);
+  std::atomic<double>& ns_per_unit = ns_per_unit_[Bucket(total)];
+  // Races between concurrent updates may lose a measurement, which the moving
+  // average doesn't need to be exact about.
+  const double previous = ns_per_unit.load(std::memory_order_relaxed);
+  ns_per_unit.store(previous <= 0.0
+                        ? measured
+                        : previous + kWeight * (measured - previous),
+                    std::memory_order_relaxed);
+}
+
+void AdaptiveShard(int max_parallelism, thread::ThreadPool* workers,
+                   int64_t total, AdaptiveShardCost* cost,
+                   std::function<void(int64_t, int64_t)> work) {
+  CHECK(cost != nullptr);
+  CHECK_GE(total, 0);
+  if (total == 0) {
+    return;
+  }
+  const int64_t cost_per_unit = cost->CostPerUnit(total);
+  if (!cost->ShouldMeasure(total)) {
+    Shard(max_parallelism, workers, total, cost_per_unit, std::move(work));
+    return;
+  }
+  std::atomic<int64_t> busy_ns(0);
+  Shard(max_parallelism, workers, total, cost_per_unit,
+        [&work, &busy_ns](int64_t start, int64_t limit) {
+          const uint64 start_ns = EnvTime::NowNanos();
+          work(start, limit);
+          busy_ns.fetch_add(EnvTime::NowNanos() - start_ns,
+                            std::memory_order_relaxed);
+        });
+  cost->RecordMeasurement(total, busy_ns.load(std::memory_order_relaxed));
+}
+
 // DEPRECATED: Prefer threadpool->ParallelFor with SchedulingStrategy, which
 // allows you to specify the strategy for choosing shard sizes, including using
 // a fixed shard size.
@@ -16,9 +16,11 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_UTIL_WORK_SHARDER_H_
 #define TENSORFLOW_CORE_UTIL_WORK_SHARDER_H_
 
+#include <atomic>
 #include <functional>
 
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
@@ -59,6 +61,60 @@ namespace tensorflow {
 void Shard(int max_parallelism, thread::ThreadPool* workers, int64_t total,
            int64_t cost_per_unit, std::function<void(int64_t, int64_t)> work);
 
+// Learns the cost per unit of the work of one Shard() call site from the
+// measured execution time of its shards, for call sites whose cost per unit is
+// hard to estimate up front. The cost often depends on the size of the work
+// (e.g. through cache effects), so it is learned separately for each power of
+// two of "total", as an exponentially weighted moving average. Once a size has
+// been measured, only one in kSamplingPeriod calls for it is timed.
+//
+// An AdaptiveShardCost is typically a static of the call site:
+//
+//   static AdaptiveShardCost* cost =
+//       new AdaptiveShardCost(/*initial_cost_per_unit=*/1000);
+//   AdaptiveShard(worker_threads.num_threads, worker_threads.workers, total,
+//                 cost, work);
+//
+// Thread-safe.
+class AdaptiveShardCost {
+ public:
+  static constexpr int kSamplingPeriod = 16;
+
+  // "initial_cost_per_unit" is used, like Shard()'s "cost_per_unit", until the
+  // cost of a size of work has been measured.
+  explicit AdaptiveShardCost(int64_t initial_cost_per_unit);
+
+  // Returns the estimated cost, in CPU cycles, of a unit of work of size
+  // "total".
+  int64_t CostPerUnit(int64_t total) const;
+
+  // Returns whether the next call for work of size "total" should be timed.
+  bool ShouldMeasure(int64_t total);
+
+  // Updates the estimate for work of size "total" with a measurement of the
+  // time, summed over all shards, it took to compute all the units.
+  void RecordMeasurement(int64_t total, int64_t busy_ns);
+
+ private:
+  static constexpr int kNumBuckets = 64;
+  static int Bucket(int64_t total);
+
+  const int64_t initial_cost_per_unit_;
+  std::atomic<uint32> num_calls_{0};
+  // The estimated nanoseconds per unit of each bucket, or 0 if unmeasured.
+  std::atomic<double> ns_per_unit_[kNumBuckets];
+
+  TF_DISALLOW_COPY_AND_ASSIGN(AdaptiveShardCost);
+};
+
+// Like Shard(), with the cost per unit learned by "cost" from the calls made
+// with it.
+//
+// REQUIRES: cost != nullptr
+void AdaptiveShard(int max_parallelism, thread::ThreadPool* workers,
+                   int64_t total, AdaptiveShardCost* cost,
+                   std::function<void(int64_t, int64_t)> work);
+
 // Each thread has an associated option to express the desired maximum
 // parallelism. Its default is a very large quantity.
 //
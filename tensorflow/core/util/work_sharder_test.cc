@@ -15,8 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/util/work_sharder.h"
 
+#include <algorithm>
 #include <atomic>
 #include <vector>
+
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -90,6 +92,51 @@ TEST(Shard, OverflowTest) {
   }
 }
 
+TEST(AdaptiveShard, CoversAllUnits) {
+  thread::ThreadPool threads(Env::Default(), "test", 4);
+  AdaptiveShardCost cost(/*initial_cost_per_unit=*/1000);
+  for (int call = 0; call < 3 * AdaptiveShardCost::kSamplingPeriod; ++call) {
+    for (const int64_t total : {0, 1, 7, 100, 10000}) {
+      mutex mu;
+      std::vector<bool> done(total, false);
+      AdaptiveShard(4, &threads, total, &cost,
+                    [&mu, &done](int64_t start, int64_t limit) {
+                      mutex_lock l(mu);
+                      for (; start < limit; ++start) {
+                        EXPECT_FALSE(done[start]);  // No duplicate
+                        done[start] = true;
+                      }
+                    });
+      EXPECT_EQ(std::count(done.begin(), done.end(), true), total);
+    }
+  }
+}
+
+TEST(AdaptiveShard, LearnsCostPerUnit) {
+  AdaptiveShardCost cost(/*initial_cost_per_unit=*/7);
+  EXPECT_EQ(cost.CostPerUnit(1000), 7);
+  EXPECT_TRUE(cost.ShouldMeasure(1000));
+
+  // 1000 units taking 1ms cost 1us each.
+  cost.RecordMeasurement(1000, 1000 * 1000);
+  const int64_t cost_per_unit = cost.CostPerUnit(1000);
+  EXPECT_GT(cost_per_unit, 7);
+  // Sizes in the same power of two share the estimate, others don't.
+  EXPECT_EQ(cost.CostPerUnit(600), cost_per_unit);
+  EXPECT_EQ(cost.CostPerUnit(2000), 7);
+
+  // The estimate moves towards new measurements.
+  cost.RecordMeasurement(1000, 10 * 1000 * 1000);
+  EXPECT_GT(cost.CostPerUnit(1000), cost_per_unit);
+
+  // Once measured, only a sample of the calls is timed.
+  int num_measured = 0;
+  for (int i = 0; i < 10 * AdaptiveShardCost::kSamplingPeriod; ++i) {
+    num_measured += cost.ShouldMeasure(1000);
+  }
+  EXPECT_EQ(num_measured, 10);
+}
+
 void BM_Sharding(::testing::benchmark::State& state) {
   const int arg = state.range(0);
 
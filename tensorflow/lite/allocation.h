@@ -82,6 +82,23 @@ class MMAPAllocation : public Allocation {
 
   int fd() const { return mmap_fd_; }
 
+  // Expected access patterns of mapped memory, see madvise(2).
+  enum class Advice {
+    kNormal,
+    // Pages are read in random order; don't read ahead when faulting them in.
+    kRandom,
+    // Pages will be read soon; start reading them in.
+    kWillNeed,
+    // Pages won't be read soon; they are dropped, and read again from the
+    // file if they are.
+    kDontNeed,
+  };
+
+  // Hints how the mapped bytes in [data, data + bytes) will be accessed. The
+  // range is extended to whole pages. Returns false if the range isn't part
+  // of this mapping or the hint isn't supported.
+  bool Advise(const void* data, size_t bytes, Advice advice) const;
+
   static bool IsSupported();
 
  protected:
@@ -97,6 +97,32 @@ TEST(MMAPAllocation, TestInvalidSizeAndOffset) {
   close(fd);
 }
 
+TEST(MMAPAllocation, TestAdvise) {
+  if (!MMAPAllocation::IsSupported()) {
+    return;
+  }
+
+  TestErrorReporter error_reporter;
+  MMAPAllocation allocation(
+      "tensorflow/lite/testdata/empty_model.bin", &error_reporter);
+  ASSERT_TRUE(allocation.valid());
+
+  const char* base = static_cast<const char*>(allocation.base());
+  for (MMAPAllocation::Advice advice :
+       {MMAPAllocation::Advice::kNormal, MMAPAllocation::Advice::kRandom,
+        MMAPAllocation::Advice::kWillNeed,
+        MMAPAllocation::Advice::kDontNeed}) {
+    EXPECT_TRUE(allocation.Advise(base, allocation.bytes(), advice));
+    // Ranges that don't start on a page boundary are extended to one.
+    EXPECT_TRUE(allocation.Advise(base + 1, allocation.bytes() - 1, advice));
+  }
+  // Ranges outside of the mapping are rejected.
+  EXPECT_FALSE(allocation.Advise(base, allocation.bytes() + 1,
+                                 MMAPAllocation::Advice::kWillNeed));
+  EXPECT_FALSE(allocation.Advise(base - 1, 1,
+                                 MMAPAllocation::Advice::kWillNeed));
+}
+
 TEST(MMAPAllocation, TestValidFileDescriptor) {
   if (!MMAPAllocation::IsSupported()) {
     return;
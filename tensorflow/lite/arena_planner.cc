@@ -20,6 +20,7 @@ limitations under the License.
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -32,6 +33,11 @@ namespace {
 
 constexpr int32_t kNodeNotAssigned = std::numeric_limits<int32_t>::max();
 
+// Up to this many tensors, both the size-ordered and the breadth-ordered
+// allocation are computed when planning a whole graph, and the one needing the
+// smaller arena is kept. Ordering by breadth takes O(#nodes * #tensors) time.
+constexpr size_t kMaxTensorsToCompareAllocationOrders = 2048;
+
 }  // namespace
 
 ArenaPlanner::ArenaPlanner(TfLiteContext* context,
@@ -59,6 +65,9 @@ std::intptr_t ArenaPlanner::BasePointer(TfLiteAllocationType type) {
 TfLiteStatus ArenaPlanner::ResetAllocations() {
   TF_LITE_ENSURE_STATUS(arena_.ClearPlan());
   TF_LITE_ENSURE_STATUS(persistent_arena_.ClearPlan());
+  if (reuse_plan_for_smaller_tensors_) {
+    previous_allocs_.swap(allocs_);
+  }
   allocs_.clear();
   allocs_.resize(graph_info_->num_tensors());
   return kTfLiteOk;
@@ -82,6 +91,7 @@ TfLiteStatus ArenaPlanner::ResetAllocationsAfter(int node) {
 TfLiteStatus ArenaPlanner::PlanAllocations() {
   // Invalidate any existing data.
   TF_LITE_ENSURE_STATUS(ResetAllocations());
+  previous_allocs_.clear();
   // Maybe other verb instead of 'Assigned'
   alloc_node_.assign(graph_info_->num_tensors(), kNodeNotAssigned);
   dealloc_node_.assign(graph_info_->num_tensors(), kNodeNotAssigned);
@@ -251,6 +261,24 @@ void ArenaPlanner::DumpDebugInfo(const std::vector<int>& execution_plan) const {
                                   execution_plan);
 }
 
+void ArenaPlanner::GetArenaHighWaterMarks(
+    std::vector<size_t>* high_water_marks) const {
+  const int num_nodes = graph_info_->num_execution_nodes();
+  high_water_marks->assign(num_nodes, 0);
+  for (int i = 0; i < static_cast<int>(allocs_.size()); ++i) {
+    const ArenaAllocWithUsageInterval& alloc = allocs_[i];
+    if (alloc.size == 0 || alloc.first_node < 0 ||
+        graph_info_->tensor(i)->allocation_type != kTfLiteArenaRw) {
+      continue;
+    }
+    const int last_node = std::min(alloc.last_node, num_nodes - 1);
+    for (int node = alloc.first_node; node <= last_node; ++node) {
+      (*high_water_marks)[node] =
+          std::max((*high_water_marks)[node], alloc.offset + alloc.size);
+    }
+  }
+}
+
 TfLiteStatus ArenaPlanner::Commit() {
   TF_LITE_ENSURE_STATUS(arena_.Commit(context_));
   TF_LITE_ENSURE_STATUS(persistent_arena_.Commit(context_));
@@ -298,9 +326,127 @@ std::vector<int32_t> ArenaPlanner::CreateTensorAllocationVector(int first_node,
   return tensor_order;
 }
 
+std::vector<int32_t> ArenaPlanner::CreateTensorAllocationVectorByBreadth(
+    const std::vector<int32_t>& tensor_order) const {
+  const int num_nodes = graph_info_->num_execution_nodes();
+  auto lives_through_inference = [this](int tensor_index) {
+    return alloc_node_[tensor_index] == 0 &&
+           dealloc_node_[tensor_index] == kNodeNotAssigned;
+  };
+  auto last_node_of = [this, num_nodes](int tensor_index) {
+    return std::min(dealloc_node_[tensor_index], num_nodes - 1);
+  };
+
+  // The breadth of each node: the total size of the arena tensors in use
+  // while it runs. (Computed from per-node differences, relying on unsigned
+  // wrap-around.)
+  std::vector<size_t> breadth(num_nodes + 1, 0);
+  for (const int32_t tensor_index : tensor_order) {
+    const TfLiteTensor& tensor = *graph_info_->tensor(tensor_index);
+    if (tensor.allocation_type != kTfLiteArenaRw ||
+        alloc_node_[tensor_index] >= num_nodes) {
+      continue;
+    }
+    breadth[alloc_node_[tensor_index]] += tensor.bytes;
+    breadth[last_node_of(tensor_index) + 1] -= tensor.bytes;
+  }
+  for (int node = 1; node < num_nodes; ++node) {
+    breadth[node] += breadth[node - 1];
+  }
+  std::vector<int> node_order(num_nodes);
+  std::iota(node_order.begin(), node_order.end(), 0);
+  std::stable_sort(node_order.begin(), node_order.end(),
+                   [&breadth](int node1, int node2) {
+                     return breadth[node1] > breadth[node2];
+                   });
+
+  std::vector<int32_t> breadth_order;
+  breadth_order.reserve(tensor_order.size());
+  std::vector<bool> ordered(tensor_order.size(), false);
+  for (size_t i = 0; i < tensor_order.size(); ++i) {
+    if (lives_through_inference(tensor_order[i])) {
+      breadth_order.push_back(tensor_order[i]);
+      ordered[i] = true;
+    }
+  }
+  // 'tensor_order' lists the remaining tensors by non-increasing size.
+  for (const int node : node_order) {
+    for (size_t i = 0; i < tensor_order.size(); ++i) {
+      const int32_t tensor_index = tensor_order[i];
+      if (!ordered[i] && alloc_node_[tensor_index] <= node &&
+          node <= last_node_of(tensor_index)) {
+        breadth_order.push_back(tensor_index);
+        ordered[i] = true;
+      }
+    }
+  }
+  for (size_t i = 0; i < tensor_order.size(); ++i) {
+    if (!ordered[i]) {
+      breadth_order.push_back(tensor_order[i]);
+    }
+  }
+  return breadth_order;
+}
+
+TfLiteStatus ArenaPlanner::AllocateInArena(
+    const std::vector<int32_t>& tensor_order, SimpleMemoryArena* arena,
+    std::vector<ArenaAllocWithUsageInterval>* allocs) const {
+  std::vector<int32_t> online_planned_tensors;
+  online_planned_tensors.reserve(tensor_order.size());
+  for (const auto& tensor_index : tensor_order) {
+    const TfLiteTensor& tensor = *graph_info_->tensor(tensor_index);
+    if (tensor.allocation_type != kTfLiteArenaRw) {
+      continue;
+    }
+    if (static_cast<size_t>(tensor_index) < offline_planned_offsets_.size() &&
+        offline_planned_offsets_[tensor_index] != kOnlinePlannedOffset) {
+      const int32_t offset = offline_planned_offsets_[tensor_index];
+      if (offset >= 0 && offset % tensor_alignment_ == 0 &&
+          arena->CanAllocateAt(offset, tensor.bytes, alloc_node_[tensor_index],
+                               dealloc_node_[tensor_index])) {
+        TF_LITE_ENSURE_STATUS(arena->AllocateAt(
+            context_, tensor_alignment_, offset, tensor.bytes, tensor_index,
+            alloc_node_[tensor_index], dealloc_node_[tensor_index],
+            &(*allocs)[tensor_index]));
+        continue;
+      }
+    }
+    online_planned_tensors.push_back(tensor_index);
+  }
+  for (const auto& tensor_index : online_planned_tensors) {
+    const TfLiteTensor& tensor = *graph_info_->tensor(tensor_index);
+    TF_LITE_ENSURE_STATUS(arena->Allocate(
+        context_, tensor_alignment_, tensor.bytes, tensor_index,
+        alloc_node_[tensor_index], dealloc_node_[tensor_index],
+        &(*allocs)[tensor_index]));
+  }
+  return kTfLiteOk;
+}
+
+bool ArenaPlanner::PreviousPlanFits(
+    const std::vector<int32_t>& tensor_order) const {
+  for (const auto& tensor_index : tensor_order) {
+    const TfLiteTensor& tensor = *graph_info_->tensor(tensor_index);
+    if (tensor.allocation_type != kTfLiteArenaRw) {
+      continue;
+    }
+    if (static_cast<size_t>(tensor_index) >= previous_allocs_.size()) {
+      return false;
+    }
+    const ArenaAllocWithUsageInterval& alloc = previous_allocs_[tensor_index];
+    if (alloc.tensor != tensor_index ||
+        alloc.first_node != alloc_node_[tensor_index] ||
+        alloc.last_node != dealloc_node_[tensor_index] ||
+        alloc.size < tensor.bytes) {
+      return false;
+    }
+  }
+  return true;
+}
+
 TfLiteStatus ArenaPlanner::CalculateAllocations(int first_node, int last_node) {
   // Indices of tensors in order their allocation offsets will be calculated.
-  const std::vector<int32_t> tensor_order =
+  std::vector<int32_t> tensor_order =
       CreateTensorAllocationVector(first_node, last_node);
 
   // Deallocate if the tensor was already allocated.
@@ -312,15 +458,51 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(int first_node, int last_node) {
     }
   }
 
-  // Vector of ids of already allocated tensors, ordered by offset.
+  const bool plans_whole_graph =
+      first_node == 0 &&
+      last_node >= static_cast<int>(graph_info_->num_execution_nodes()) - 1;
+  const bool reuses_previous_plan = first_node == 0 &&
+                                    reuse_plan_for_smaller_tensors_ &&
+                                    PreviousPlanFits(tensor_order);
+  if (reuses_previous_plan) {
+    // The arena is empty, and the previous allocations didn't overlap, so they
+    // can all be restored.
+    for (const auto& tensor_index : tensor_order) {
+      const TfLiteTensor& tensor = *graph_info_->tensor(tensor_index);
+      if (tensor.allocation_type != kTfLiteArenaRw) {
+        continue;
+      }
+      const ArenaAllocWithUsageInterval& alloc = previous_allocs_[tensor_index];
+      TF_LITE_ENSURE_STATUS(arena_.AllocateAt(
+          context_, tensor_alignment_, alloc.offset,
+          tensor.bytes == 0 ? 0 : alloc.size, tensor_index, alloc.first_node,
+          alloc.last_node, &allocs_[tensor_index]));
+    }
+  } else if (plans_whole_graph &&
+             tensor_order.size() <= kMaxTensorsToCompareAllocationOrders) {
+    // When planning the whole graph of a small enough model, also try
+    // ordering the tensors by breadth, which packs some graphs (e.g. ones with
+    // many long-lived medium-sized tensors) tighter, and keep the better order.
+    std::vector<int32_t> breadth_order =
+        CreateTensorAllocationVectorByBreadth(tensor_order);
+    std::vector<ArenaAllocWithUsageInterval> scratch_allocs(allocs_.size());
+    SimpleMemoryArena size_ordered_arena(kDefaultArenaAlignment);
+    TF_LITE_ENSURE_STATUS(
+        AllocateInArena(tensor_order, &size_ordered_arena, &scratch_allocs));
+    SimpleMemoryArena breadth_ordered_arena(kDefaultArenaAlignment);
+    TF_LITE_ENSURE_STATUS(AllocateInArena(breadth_order, &breadth_ordered_arena,
+                                          &scratch_allocs));
+    if (breadth_ordered_arena.RequiredBufferSize() <
+        size_ordered_arena.RequiredBufferSize()) {
+      tensor_order = std::move(breadth_order);
+    }
+  }
+
+  if (!reuses_previous_plan) {
+    TF_LITE_ENSURE_STATUS(AllocateInArena(tensor_order, &arena_, &allocs_));
+  }
   for (const auto& tensor_index : tensor_order) {
     TfLiteTensor& tensor = *graph_info_->tensor(tensor_index);
-    if (tensor.allocation_type == kTfLiteArenaRw) {
-      TF_LITE_ENSURE_STATUS(
-          arena_.Allocate(context_, tensor_alignment_, tensor.bytes,
-                          tensor_index, alloc_node_[tensor_index],
-                          dealloc_node_[tensor_index], &allocs_[tensor_index]));
-    }
     // Check allocs_[].size to prevent from reallocation of persistent tensors.
     if (tensor.allocation_type == kTfLiteArenaRwPersistent &&
         allocs_[tensor_index].size == 0) {
@@ -63,10 +63,36 @@ class ArenaPlanner : public MemoryPlanner {
   TfLiteStatus AcquireNonPersistentMemory() override;
   bool HasNonPersistentMemory() override;
   void DumpDebugInfo(const std::vector<int>& execution_plan) const override;
+  void GetArenaHighWaterMarks(
+      std::vector<size_t>* high_water_marks) const override;
 
   // Returns the base arena location for a given allocation type.
   std::intptr_t BasePointer(TfLiteAllocationType type);
 
+  // Marks a tensor without an offline planned offset; see below.
+  static constexpr int32_t kOnlinePlannedOffset = -1;
+
+  // Sets the offsets in the non-persistent arena at which an offline planner
+  // (e.g. the one recording the "OfflineMemoryAllocation" model metadata)
+  // placed the tensors: `offsets[i]` is the offset of tensor i, or
+  // kOnlinePlannedOffset to let this planner place it. A tensor whose offline
+  // offset is misaligned, or overlaps a tensor in use at the same time (e.g.
+  // after a resize), is planned online instead.
+  void SetOfflinePlannedOffsets(std::vector<int32_t> offsets) {
+    offline_planned_offsets_ = std::move(offsets);
+  }
+
+  // Lets ResetAllocations() keep the current plan of the non-persistent arena
+  // as a template: when the tensors are planned again from the first node and
+  // each of them still fits the space it was given, e.g. after inputs were
+  // resized to smaller shapes, the tensors keep their offsets (and the sizes
+  // of their slots) instead of being planned from scratch. The arena then
+  // stays as large as needed for the largest shapes seen since the last full
+  // planning.
+  void SetReusePlanForSmallerTensors(bool value) {
+    reuse_plan_for_smaller_tensors_ = value;
+  }
+
  private:
   // Make sure all the arenas have reserved enough memory to store all their
   // tensors.
@@ -82,6 +108,25 @@ class ArenaPlanner : public MemoryPlanner {
   std::vector<int32_t> CreateTensorAllocationVector(int first_node,
                                                     int last_node);
 
+  // Returns `tensor_order`, as created by CreateTensorAllocationVector(), with
+  // the tensors that don't live through the whole inference reordered greedy
+  // by breadth: operators are visited in non-increasing order of the total
+  // size of the tensors in use while they run, and each one appends the
+  // tensors it uses that aren't ordered yet, largest first.
+  std::vector<int32_t> CreateTensorAllocationVectorByBreadth(
+      const std::vector<int32_t>& tensor_order) const;
+
+  // Allocates the kTfLiteArenaRw tensors of `tensor_order` in `arena`: first
+  // the ones that fit at their offline planned offset, then the others in
+  // order.
+  TfLiteStatus AllocateInArena(
+      const std::vector<int32_t>& tensor_order, SimpleMemoryArena* arena,
+      std::vector<ArenaAllocWithUsageInterval>* allocs) const;
+
+  // Returns true if every kTfLiteArenaRw tensor of `tensor_order` has the same
+  // lifetime as in `previous_allocs_` and fits the space it had there.
+  bool PreviousPlanFits(const std::vector<int32_t>& tensor_order) const;
+
   // Traverse the allocation queue and reserve space in the appropriate arena
   // for all tensors affected by ops in the interval [first_node, last_node].
   TfLiteStatus CalculateAllocations(int first_node, int last_node);
@@ -127,6 +172,14 @@ class ArenaPlanner : public MemoryPlanner {
 
   // Number of bytes that tensor buffers should be aligned to.
   int tensor_alignment_;
+
+  // See SetOfflinePlannedOffsets().
+  std::vector<int32_t> offline_planned_offsets_;
+
+  // See SetReusePlanForSmallerTensors().
+  bool reuse_plan_for_smaller_tensors_ = false;
+  // The allocations before the last call to ResetAllocations().
+  std::vector<ArenaAllocWithUsageInterval> previous_allocs_;
 };
 
 }  // namespace tflite
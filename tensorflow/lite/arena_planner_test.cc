@@ -201,6 +201,10 @@ class ArenaPlannerTest : public ::testing::Test {
     CHECK(planner_->AcquireNonPersistentMemory() == kTfLiteOk);
   }
 
+  void ResetAllocations() {
+    CHECK(planner_->ResetAllocations() == kTfLiteOk);
+  }
+
   void ResetAllocationsAfter(int node) {
     CHECK(planner_->ResetAllocationsAfter(node) == kTfLiteOk);
   }
@@ -292,6 +296,33 @@ TEST_F(ArenaPlannerTest, SimpleGraph) {
   EXPECT_EQ(GetOffset(1), 4);
 }
 
+TEST_F(ArenaPlannerTest, ArenaHighWaterMarks) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},     // First op
+                      {{2, 0}, {4, 5}, {}},  // Second op
+                      {{4, 5}, {3}, {}}      // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+  Execute(0, 10);
+
+  std::vector<size_t> high_water_marks;
+  planner_->GetArenaHighWaterMarks(&high_water_marks);
+  ASSERT_EQ(high_water_marks.size(), 3);
+  auto end = [&](int tensor_index) {
+    return GetOffset(tensor_index) + (*graph.tensors())[tensor_index].bytes;
+  };
+  // The inputs stay allocated during the whole inference.
+  const size_t inputs_end = std::max(end(0), end(1));
+  EXPECT_EQ(high_water_marks[0], std::max(inputs_end, end(2)));
+  EXPECT_EQ(high_water_marks[1],
+            std::max({inputs_end, end(2), end(4), end(5)}));
+  EXPECT_EQ(high_water_marks[2],
+            std::max({inputs_end, end(3), end(4), end(5)}));
+}
+
 TEST_F(ArenaPlannerTest, SimpleGraphInputsPreserved) {
   TestGraph graph({0, 1},
                   {
@@ -688,6 +719,106 @@ TEST_F(ArenaPlannerTest, ComplexGraph) {
   EXPECT_EQ(GetOffset(8), 32);
 }
 
+// A graph whose tensors are packed tighter when ordered by breadth than by
+// size.
+class BreadthFriendlyGraph : public TestGraph {
+ public:
+  BreadthFriendlyGraph()
+      : TestGraph({0},
+                  {
+                      /* in, out, tmp */
+                      {{0}, {4}, {}},
+                      {{4}, {2}, {}},
+                      {{0}, {1, 3}, {}},
+                      {{1, 2, 3}, {5}, {}},
+                  },
+                  {5}) {
+    (*tensors())[0].bytes = 0;
+    (*tensors())[1].bytes = 16;
+    (*tensors())[2].bytes = 24;
+    (*tensors())[3].bytes = 12;
+    (*tensors())[4].bytes = 24;
+    (*tensors())[5].bytes = 0;
+  }
+};
+
+TEST_F(ArenaPlannerTest, GreedyByBreadthIfSmaller) {
+  BreadthFriendlyGraph graph;
+  SetGraph(&graph);
+  Execute(0, 10);
+
+  // Ordered by size (4, 2, 1, 3), the tensors would need 60 bytes. Node 2 has
+  // the largest breadth, so 2, 1 and 3 are placed first, then 4.
+  EXPECT_EQ(GetOffset(2), 0);
+  EXPECT_EQ(GetOffset(1), GetOffsetAfter(2));
+  EXPECT_EQ(GetOffset(3), GetOffsetAfter(1));
+  EXPECT_EQ(GetOffset(4), GetOffsetAfter(2));
+  EXPECT_EQ(GetOffsetAfter(3), 52);
+}
+
+TEST_F(ArenaPlannerTest, OfflinePlannedOffsets) {
+  BreadthFriendlyGraph graph;
+  SetGraph(&graph);
+  planner_->SetOfflinePlannedOffsets({ArenaPlanner::kOnlinePlannedOffset, 0,
+                                      32, 16, 0,
+                                      ArenaPlanner::kOnlinePlannedOffset});
+  Execute(0, 10);
+
+  EXPECT_EQ(GetOffset(1), 0);
+  EXPECT_EQ(GetOffset(2), 32);
+  EXPECT_EQ(GetOffset(3), 16);
+  EXPECT_EQ(GetOffset(4), 0);
+}
+
+TEST_F(ArenaPlannerTest, OfflinePlannedOffsetsOverlapFallBackToOnline) {
+  BreadthFriendlyGraph graph;
+  SetGraph(&graph);
+  // Tensor 3 would overlap tensor 1, and tensor 4 is misaligned.
+  planner_->SetOfflinePlannedOffsets({ArenaPlanner::kOnlinePlannedOffset, 0,
+                                      32, 8, 2,
+                                      ArenaPlanner::kOnlinePlannedOffset});
+  Execute(0, 10);
+
+  EXPECT_EQ(GetOffset(1), 0);
+  EXPECT_EQ(GetOffset(2), 32);
+  EXPECT_EQ(GetOffset(3), GetOffsetAfter(1));
+  EXPECT_EQ(GetOffset(4), 0);
+}
+
+TEST_F(ArenaPlannerTest, ReusePlanForSmallerTensors) {
+  BreadthFriendlyGraph graph;
+  SetGraph(&graph);
+  planner_->SetReusePlanForSmallerTensors(true);
+  Execute(0, 10);
+  EXPECT_EQ(GetOffset(2), 0);
+  EXPECT_EQ(GetOffset(1), 24);
+  EXPECT_EQ(GetOffset(3), 40);
+  EXPECT_EQ(GetOffset(4), 24);
+
+  // Shrinking a tensor keeps the plan, even though tensor 1 would now fit
+  // right after tensor 2.
+  (*graph.tensors())[2].bytes = 8;
+  ResetAllocations();
+  Execute(0, 10);
+  EXPECT_EQ(GetOffset(2), 0);
+  EXPECT_EQ(GetOffset(1), 24);
+  EXPECT_EQ(GetOffset(3), 40);
+  EXPECT_EQ(GetOffset(4), 24);
+
+  // Growing back to the original size still fits.
+  (*graph.tensors())[2].bytes = 24;
+  ResetAllocations();
+  Execute(0, 10);
+  EXPECT_EQ(GetOffset(1), 24);
+
+  // A tensor outgrowing its space makes the planner start over.
+  (*graph.tensors())[3].bytes = 100;
+  ResetAllocations();
+  Execute(0, 10);
+  EXPECT_EQ(GetOffset(3), 0);
+  EXPECT_EQ(GetOffset(4), 0);
+}
+
 TEST_F(ArenaPlannerTest, GraphWithIntermediates) {
   TestGraph graph({0, 1},
                   {
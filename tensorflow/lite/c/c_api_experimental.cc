@@ -115,6 +115,14 @@ int32_t TfLiteInterpreterGetOutputTensorIndex(
   return interpreter->impl->outputs()[output_index];
 }
 
+TfLiteStatus TfLiteInterpreterSetCustomAllocationForTensor(
+    TfLiteInterpreter* interpreter, int tensor_index,
+    const TfLiteCustomAllocation* allocation, int64_t flags) {
+  if (allocation == nullptr) return kTfLiteError;
+  return interpreter->impl->SetCustomAllocationForTensor(tensor_index,
+                                                         *allocation, flags);
+}
+
 int32_t TfLiteInterpreterGetSignatureCount(
     const TfLiteInterpreter* interpreter) {
   return static_cast<int32_t>(interpreter->impl->signature_keys().size());
@@ -168,6 +176,14 @@ TfLiteTensor* TfLiteSignatureRunnerGetInputTensor(
   return signature_runner->impl->input_tensor(input_name);
 }
 
+TfLiteStatus TfLiteSignatureRunnerSetCustomAllocationForInputTensor(
+    TfLiteSignatureRunner* signature_runner, const char* input_name,
+    const TfLiteCustomAllocation* allocation, int64_t flags) {
+  if (allocation == nullptr) return kTfLiteError;
+  return signature_runner->impl->SetCustomAllocationForInputTensor(
+      input_name, *allocation, flags);
+}
+
 TfLiteStatus TfLiteSignatureRunnerInvoke(
     TfLiteSignatureRunner* signature_runner) {
   return signature_runner->impl->Invoke();
@@ -192,6 +208,14 @@ const TfLiteTensor* TfLiteSignatureRunnerGetOutputTensor(
   return signature_runner->impl->output_tensor(output_name);
 }
 
+TfLiteStatus TfLiteSignatureRunnerSetCustomAllocationForOutputTensor(
+    TfLiteSignatureRunner* signature_runner, const char* output_name,
+    const TfLiteCustomAllocation* allocation, int64_t flags) {
+  if (allocation == nullptr) return kTfLiteError;
+  return signature_runner->impl->SetCustomAllocationForOutputTensor(
+      output_name, *allocation, flags);
+}
+
 void TfLiteSignatureRunnerDelete(TfLiteSignatureRunner* signature_runner) {
   delete signature_runner;
 }
@@ -225,6 +225,33 @@ TFL_CAPI_EXPORT extern int32_t TfLiteInterpreterGetInputTensorIndex(
 TFL_CAPI_EXPORT extern int32_t TfLiteInterpreterGetOutputTensorIndex(
     const TfLiteInterpreter* interpreter, int32_t output_index);
 
+/// Assigns (or reassigns) a custom memory allocation for the given tensor.
+/// `flags` is a bitmask, see TfLiteCustomAllocationFlags.
+/// The runtime does NOT take ownership of the underlying memory.
+///
+/// NOTE: User needs to call TfLiteInterpreterAllocateTensors() after this.
+/// Unless the tensor shapes change, that call does not re-plan the arena, so
+/// re-binding the tensor to a new buffer before each invocation is cheap.
+///
+/// Parameters should satisfy the following conditions:
+/// 1. tensor->allocation_type == kTfLiteArenaRw or kTfLiteArenaRwPersistent
+///    In general, this is true for I/O tensors & variable tensors.
+/// 2. allocation->data has the appropriate permissions for runtime access
+///    (Read-only for inputs, Read-Write for others), and outlives
+///    TfLiteInterpreter.
+/// 3. allocation->bytes >= tensor->bytes.
+///    This condition is checked again if any tensors are resized.
+/// 4. allocation->data should be aligned to kDefaultTensorAlignment
+///    defined in lite/util.h. (Currently 64 bytes)
+///    This check is skipped if kTfLiteCustomAllocationFlagsSkipAlignCheck is
+///    set through `flags`.
+///
+/// WARNING: This is an experimental API and subject to change.
+TFL_CAPI_EXPORT extern TfLiteStatus
+TfLiteInterpreterSetCustomAllocationForTensor(
+    TfLiteInterpreter* interpreter, int tensor_index,
+    const TfLiteCustomAllocation* allocation, int64_t flags);
+
 /// --------------------------------------------------------------------------
 /// SignatureRunner APIs
 ///
@@ -343,6 +370,19 @@ TFL_CAPI_EXPORT extern TfLiteStatus TfLiteSignatureRunnerAllocateTensors(
 TFL_CAPI_EXPORT extern TfLiteTensor* TfLiteSignatureRunnerGetInputTensor(
     TfLiteSignatureRunner* signature_runner, const char* input_name);
 
+/// Assigns (or reassigns) a custom memory allocation for the input tensor
+/// identified by `input_name`, which is then read in place when running the
+/// signature. The same conditions as for
+/// TfLiteInterpreterSetCustomAllocationForTensor() apply.
+///
+/// NOTE: User needs to call TfLiteSignatureRunnerAllocateTensors() after this.
+///
+/// WARNING: This is an experimental API and subject to change.
+TFL_CAPI_EXPORT extern TfLiteStatus
+TfLiteSignatureRunnerSetCustomAllocationForInputTensor(
+    TfLiteSignatureRunner* signature_runner, const char* input_name,
+    const TfLiteCustomAllocation* allocation, int64_t flags);
+
 /// Runs inference on a given signature.
 ///
 /// Before calling this function, the caller should first invoke
@@ -380,6 +420,19 @@ TFL_CAPI_EXPORT extern const char* TfLiteSignatureRunnerGetOutputName(
 TFL_CAPI_EXPORT extern const TfLiteTensor* TfLiteSignatureRunnerGetOutputTensor(
     const TfLiteSignatureRunner* signature_runner, const char* output_name);
 
+/// Assigns (or reassigns) a custom memory allocation for the output tensor
+/// identified by `output_name`, into which the results are then written in
+/// place. The same conditions as for
+/// TfLiteInterpreterSetCustomAllocationForTensor() apply.
+///
+/// NOTE: User needs to call TfLiteSignatureRunnerAllocateTensors() after this.
+///
+/// WARNING: This is an experimental API and subject to change.
+TFL_CAPI_EXPORT extern TfLiteStatus
+TfLiteSignatureRunnerSetCustomAllocationForOutputTensor(
+    TfLiteSignatureRunner* signature_runner, const char* output_name,
+    const TfLiteCustomAllocation* allocation, int64_t flags);
+
 /// Destroys the signature runner.
 ///
 /// WARNING: This is an experimental API and subject to change.
@@ -126,5 +126,70 @@ TEST(SignatureRunnerTest, TestMultiSignatures) {
   TfLiteModelDelete(model);
 }
 
+TEST(SignatureRunnerTest, TestCustomAllocations) {
+  TfLiteModel* model = TfLiteModelCreateFromFile(
+      "tensorflow/lite/testdata/multi_signatures.bin");
+  ASSERT_NE(model, nullptr);
+  TfLiteInterpreter* interpreter = TfLiteInterpreterCreate(model, nullptr);
+  ASSERT_NE(interpreter, nullptr);
+  TfLiteSignatureRunner* add_runner =
+      TfLiteInterpreterGetSignatureRunner(interpreter, "add");
+  ASSERT_NE(add_runner, nullptr);
+  std::array<int, 1> input_dims{2};
+  ASSERT_EQ(TfLiteSignatureRunnerResizeInputTensor(
+                add_runner, "x", input_dims.data(), input_dims.size()),
+            kTfLiteOk);
+  ASSERT_EQ(TfLiteSignatureRunnerAllocateTensors(add_runner), kTfLiteOk);
+
+  alignas(64) float inputs[2][16] = {{2, 4}, {5, 7}};
+  alignas(64) float outputs[2][16] = {};
+  TfLiteCustomAllocation input_allocation{inputs[0], sizeof(inputs[0])};
+  ASSERT_EQ(TfLiteSignatureRunnerSetCustomAllocationForInputTensor(
+                add_runner, "foo", &input_allocation,
+                kTfLiteCustomAllocationFlagsNone),
+            kTfLiteError);
+  TfLiteCustomAllocation output_allocation{outputs[0], sizeof(outputs[0])};
+  ASSERT_EQ(TfLiteSignatureRunnerSetCustomAllocationForOutputTensor(
+                add_runner, "foo", &output_allocation,
+                kTfLiteCustomAllocationFlagsNone),
+            kTfLiteError);
+
+  // Re-binds the buffers for every invocation; the results are written
+  // straight into the bound output buffer.
+  for (int i = 0; i < 2; ++i) {
+    input_allocation = {inputs[i], sizeof(inputs[i])};
+    output_allocation = {outputs[i], sizeof(outputs[i])};
+    ASSERT_EQ(TfLiteSignatureRunnerSetCustomAllocationForInputTensor(
+                  add_runner, "x", &input_allocation,
+                  kTfLiteCustomAllocationFlagsNone),
+              kTfLiteOk);
+    ASSERT_EQ(TfLiteSignatureRunnerSetCustomAllocationForOutputTensor(
+                  add_runner, "output_0", &output_allocation,
+                  kTfLiteCustomAllocationFlagsNone),
+              kTfLiteOk);
+    ASSERT_EQ(TfLiteSignatureRunnerAllocateTensors(add_runner), kTfLiteOk);
+    ASSERT_EQ(TfLiteSignatureRunnerGetInputTensor(add_runner, "x")->data.f,
+              inputs[i]);
+    ASSERT_EQ(TfLiteSignatureRunnerInvoke(add_runner), kTfLiteOk);
+    EXPECT_EQ(TfLiteSignatureRunnerGetOutputTensor(add_runner, "output_0")
+                  ->data.f,
+              outputs[i]);
+    EXPECT_EQ(outputs[i][0], inputs[i][0] + 2);
+    EXPECT_EQ(outputs[i][1], inputs[i][1] + 2);
+  }
+
+  // The buffer must be large enough for the tensor.
+  input_allocation = {inputs[0], sizeof(float)};
+  ASSERT_EQ(TfLiteSignatureRunnerSetCustomAllocationForInputTensor(
+                add_runner, "x", &input_allocation,
+                kTfLiteCustomAllocationFlagsNone),
+            kTfLiteOk);
+  EXPECT_NE(TfLiteSignatureRunnerAllocateTensors(add_runner), kTfLiteOk);
+
+  TfLiteSignatureRunnerDelete(add_runner);
+  TfLiteInterpreterDelete(interpreter);
+  TfLiteModelDelete(model);
+}
+
 }  // namespace
 }  // namespace tflite
@@ -0,0 +1,122 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/core/parallel_node_executor.h"
+
+namespace tflite {
+
+namespace {
+
+// The executor owning the calling thread, and the thread's worker index.
+struct WorkerIdentity {
+  const ParallelNodeExecutor* executor = nullptr;
+  int worker = 0;
+};
+
+thread_local WorkerIdentity current_worker_identity;
+
+}  // namespace
+
+ParallelNodeExecutor::ParallelNodeExecutor(int num_threads) {
+  for (int worker = 1; worker < num_threads; ++worker) {
+    workers_.emplace_back([this, worker] { WorkerLoop(worker); });
+  }
+}
+
+ParallelNodeExecutor::~ParallelNodeExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cond_var_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+int ParallelNodeExecutor::CurrentWorker() const {
+  return current_worker_identity.executor == this
+             ? current_worker_identity.worker
+             : 0;
+}
+
+TfLiteStatus ParallelNodeExecutor::Run(
+    const std::vector<std::vector<int>>& consumers,
+    const std::vector<int>& num_dependencies, const RunNodeFunction& run_node) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  consumers_ = &consumers;
+  run_node_ = &run_node;
+  num_pending_dependencies_ = num_dependencies;
+  status_ = kTfLiteOk;
+  const int num_nodes = num_dependencies.size();
+  for (int node = 0; node < num_nodes; ++node) {
+    if (num_dependencies[node] == 0) {
+      ready_nodes_.push_back(node);
+    }
+  }
+  cond_var_.notify_all();
+
+  while (!Done()) {
+    if (!ready_nodes_.empty()) {
+      RunReadyNode(&lock, /*worker=*/0);
+    } else {
+      cond_var_.wait(lock);
+    }
+  }
+  consumers_ = nullptr;
+  run_node_ = nullptr;
+  return status_;
+}
+
+void ParallelNodeExecutor::WorkerLoop(int worker) {
+  current_worker_identity = {this, worker};
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cond_var_.wait(lock, [this] { return shutdown_ || !ready_nodes_.empty(); });
+    if (shutdown_) {
+      return;
+    }
+    RunReadyNode(&lock, worker);
+  }
+}
+
+void ParallelNodeExecutor::RunReadyNode(std::unique_lock<std::mutex>* lock,
+                                        int worker) {
+  const int node = ready_nodes_.front();
+  ready_nodes_.pop_front();
+  ++num_running_nodes_;
+  lock->unlock();
+  const TfLiteStatus status = (*run_node_)(node, worker);
+  lock->lock();
+  --num_running_nodes_;
+
+  if (status != kTfLiteOk) {
+    if (status_ == kTfLiteOk) {
+      status_ = status;
+    }
+    // Don't start any more nodes.
+    ready_nodes_.clear();
+  } else if (status_ == kTfLiteOk) {
+    for (const int consumer : (*consumers_)[node]) {
+      if (--num_pending_dependencies_[consumer] == 0) {
+        ready_nodes_.push_back(consumer);
+      }
+    }
+  }
+  // Wakes up idle workers for the new ready nodes, and the thread in Run() if
+  // this was the last node.
+  cond_var_.notify_all();
+}
+
+}  // namespace tflite
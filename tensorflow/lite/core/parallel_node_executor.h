@@ -0,0 +1,89 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_CORE_PARALLEL_NODE_EXECUTOR_H_
+#define TENSORFLOW_LITE_CORE_PARALLEL_NODE_EXECUTOR_H_
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <deque>
+#include <functional>
+#include <mutex>   // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "tensorflow/lite/c/common.h"
+
+namespace tflite {
+
+// Runs the nodes of a dependency DAG on a fixed set of threads, starting each
+// node as soon as all the nodes it depends on have finished.
+//
+// The thread calling Run() is worker 0 and takes part in running the nodes;
+// the executor owns `num_threads - 1` more worker threads, which stay alive
+// (and idle) between calls to Run().
+//
+// WARNING: This is an experimental API and subject to change.
+class ParallelNodeExecutor {
+ public:
+  using RunNodeFunction = std::function<TfLiteStatus(int node, int worker)>;
+
+  explicit ParallelNodeExecutor(int num_threads);
+  ~ParallelNodeExecutor();
+
+  // Runs `run_node(node, worker)` once for every node in
+  // [0, num_dependencies.size()). `consumers[node]` lists the nodes that depend
+  // on `node`, and `num_dependencies[node]` is the number of nodes `node`
+  // depends on. Once a node fails, no further nodes are started and the
+  // status of the first failing node is returned after the running ones have
+  // finished. Run() must not be called concurrently with itself.
+  TfLiteStatus Run(const std::vector<std::vector<int>>& consumers,
+                   const std::vector<int>& num_dependencies,
+                   const RunNodeFunction& run_node);
+
+  // Returns the index of the worker running on the calling thread if it is one
+  // of this executor's own threads, and 0 otherwise.
+  int CurrentWorker() const;
+
+  int num_threads() const { return workers_.size() + 1; }
+
+ private:
+  void WorkerLoop(int worker);
+
+  // Pops a node from `ready_nodes_` and runs it with `lock` released.
+  void RunReadyNode(std::unique_lock<std::mutex>* lock, int worker);
+
+  bool Done() const { return ready_nodes_.empty() && num_running_nodes_ == 0; }
+
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  // Notified whenever a node becomes ready, a run completes, or on shutdown.
+  std::condition_variable cond_var_;
+  bool shutdown_ = false;
+
+  // State of the current Run(), guarded by `mutex_`.
+  const std::vector<std::vector<int>>* consumers_ = nullptr;
+  const RunNodeFunction* run_node_ = nullptr;
+  std::vector<int> num_pending_dependencies_;
+  std::deque<int> ready_nodes_;
+  int num_running_nodes_ = 0;
+  TfLiteStatus status_ = kTfLiteOk;
+
+  ParallelNodeExecutor(const ParallelNodeExecutor&) = delete;
+  ParallelNodeExecutor& operator=(const ParallelNodeExecutor&) = delete;
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_CORE_PARALLEL_NODE_EXECUTOR_H_
@@ -0,0 +1,111 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/core/parallel_node_executor.h"
+
+#include <atomic>
+#include <mutex>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace tflite {
+namespace {
+
+// A diamond: 0 -> {1, 2} -> 3.
+const std::vector<std::vector<int>>& DiamondConsumers() {
+  static const auto* consumers =
+      new std::vector<std::vector<int>>{{1, 2}, {3}, {3}, {}};
+  return *consumers;
+}
+const std::vector<int>& DiamondNumDependencies() {
+  static const auto* num_dependencies = new std::vector<int>{0, 1, 1, 2};
+  return *num_dependencies;
+}
+
+TEST(ParallelNodeExecutorTest, RunsNodesAfterTheirDependencies) {
+  ParallelNodeExecutor executor(3);
+  EXPECT_EQ(executor.num_threads(), 3);
+  for (int run = 0; run < 10; ++run) {
+    std::mutex mutex;
+    std::vector<int> order;
+    ASSERT_EQ(executor.Run(DiamondConsumers(), DiamondNumDependencies(),
+                           [&](int node, int worker) {
+                             EXPECT_GE(worker, 0);
+                             EXPECT_LT(worker, 3);
+                             std::lock_guard<std::mutex> lock(mutex);
+                             order.push_back(node);
+                             return kTfLiteOk;
+                           }),
+              kTfLiteOk);
+    ASSERT_EQ(order.size(), 4);
+    EXPECT_EQ(order.front(), 0);
+    EXPECT_EQ(order.back(), 3);
+    EXPECT_THAT(order, testing::UnorderedElementsAre(0, 1, 2, 3));
+  }
+}
+
+TEST(ParallelNodeExecutorTest, RunsIndependentNodesConcurrently) {
+  ParallelNodeExecutor executor(2);
+  // Nodes 1 and 2 only finish once both have started, which requires them to
+  // run on different threads.
+  std::atomic<int> num_started(0);
+  ASSERT_EQ(executor.Run(DiamondConsumers(), DiamondNumDependencies(),
+                         [&](int node, int worker) {
+                           if (node == 1 || node == 2) {
+                             ++num_started;
+                             while (num_started < 2) {
+                             }
+                           }
+                           return kTfLiteOk;
+                         }),
+            kTfLiteOk);
+  EXPECT_EQ(num_started, 2);
+}
+
+TEST(ParallelNodeExecutorTest, StopsAfterFailure) {
+  ParallelNodeExecutor executor(2);
+  std::atomic<bool> ran_last_node(false);
+  EXPECT_EQ(executor.Run(DiamondConsumers(), DiamondNumDependencies(),
+                         [&](int node, int worker) {
+                           if (node == 1) return kTfLiteError;
+                           if (node == 3) ran_last_node = true;
+                           return kTfLiteOk;
+                         }),
+            kTfLiteError);
+  EXPECT_FALSE(ran_last_node);
+
+  // The executor can be reused after a failure.
+  EXPECT_EQ(executor.Run(DiamondConsumers(), DiamondNumDependencies(),
+                         [](int node, int worker) { return kTfLiteOk; }),
+            kTfLiteOk);
+}
+
+TEST(ParallelNodeExecutorTest, CurrentWorker) {
+  ParallelNodeExecutor executor(2);
+  EXPECT_EQ(executor.CurrentWorker(), 0);
+  ParallelNodeExecutor other_executor(2);
+  ASSERT_EQ(executor.Run(DiamondConsumers(), DiamondNumDependencies(),
+                         [&](int node, int worker) {
+                           EXPECT_EQ(executor.CurrentWorker(), worker);
+                           EXPECT_EQ(other_executor.CurrentWorker(), 0);
+                           return kTfLiteOk;
+                         }),
+            kTfLiteOk);
+}
+
+}  // namespace
+}  // namespace tflite
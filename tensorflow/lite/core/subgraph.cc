@@ -19,6 +19,7 @@ limitations under the License.
 #include <stddef.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -38,6 +39,7 @@ limitations under the License.
 #include "tensorflow/lite/core/api/profiler.h"
 #include "tensorflow/lite/core/api/tensor_utils.h"
 #include "tensorflow/lite/core/macros.h"
+#include "tensorflow/lite/core/parallel_node_executor.h"
 #include "tensorflow/lite/experimental/resource/resource_base.h"
 #include "tensorflow/lite/graph_info.h"
 #include "tensorflow/lite/memory_planner.h"
@@ -188,6 +190,61 @@ TfLiteStatus VerifyCustomAllocationForTensor(
   return kTfLiteOk;
 }
 
+// Returns the number of `inputs` followed by, for each input, its number of
+// dimensions and its dimensions, or -1 for an optional input.
+std::vector<int> GetInputShapes(const TfLiteContext& context,
+                                const TfLiteIntArray* inputs) {
+  std::vector<int> shapes = {inputs->size};
+  for (int i = 0; i < inputs->size; ++i) {
+    const int tensor_index = inputs->data[i];
+    if (tensor_index == kTfLiteOptionalTensor) {
+      shapes.push_back(-1);
+      continue;
+    }
+    const TfLiteIntArray* dims = context.tensors[tensor_index].dims;
+    if (dims == nullptr) {
+      shapes.push_back(0);
+      continue;
+    }
+    shapes.push_back(dims->size);
+    shapes.insert(shapes.end(), dims->data, dims->data + dims->size);
+  }
+  return shapes;
+}
+
+#ifndef TFLITE_USE_SIMPLE_MEMORY_PLANNER
+// Metadata written by offline memory planners, in the same format as the one
+// used by TFLite Micro: an int32 array of
+//   [version (= 1), subgraph index, number of offsets, offsets...]
+// where there is one arena offset per tensor of the subgraph, and -1 stands
+// for a tensor to be planned online.
+constexpr char kOfflineMemoryAllocationMetadata[] = "OfflineMemoryAllocation";
+
+// Returns the offline planned arena offsets for subgraph `subgraph_index`, or
+// an empty vector if `metadata` has none (or malformed ones).
+std::vector<int32_t> GetOfflinePlannedOffsets(
+    const std::map<std::string, std::string>* metadata, int subgraph_index,
+    size_t num_tensors) {
+  if (metadata == nullptr) return {};
+  const auto it = metadata->find(kOfflineMemoryAllocationMetadata);
+  if (it == metadata->end()) return {};
+  const std::string& buffer = it->second;
+  constexpr size_t kHeaderSize = 3;
+  if (buffer.size() % sizeof(int32_t) != 0 ||
+      buffer.size() / sizeof(int32_t) < kHeaderSize) {
+    return {};
+  }
+  std::vector<int32_t> values(buffer.size() / sizeof(int32_t));
+  std::memcpy(values.data(), buffer.data(), buffer.size());
+  if (values[0] != 1 || values[1] != subgraph_index ||
+      values[2] != static_cast<int32_t>(num_tensors) ||
+      values.size() != kHeaderSize + num_tensors) {
+    return {};
+  }
+  return std::vector<int32_t>(values.begin() + kHeaderSize, values.end());
+}
+#endif
+
 }  // namespace
 
 // A trivial implementation of GraphInfo around the Interpreter.
@@ -471,6 +528,12 @@ TfLiteStatus Subgraph::ReplaceNodeSubsetsWithDelegateKernels(
 
 TfLiteExternalContext* Subgraph::GetExternalContext(
     TfLiteExternalContextType type) {
+  if (type == kTfLiteCpuBackendContext && parallel_executor_ != nullptr) {
+    const int worker = parallel_executor_->CurrentWorker();
+    if (worker > 0) {
+      return worker_cpu_backend_contexts_[worker - 1].get();
+    }
+  }
   if (static_cast<int>(type) >= 0 && type < kTfLiteMaxExternalContexts) {
     return external_contexts_[type];
   }
@@ -744,6 +807,7 @@ TfLiteStatus Subgraph::AllocateTensors() {
   next_execution_plan_index_to_prepare_ = 0;
   next_execution_plan_index_to_plan_allocation_ = 0;
   next_original_execution_plan_index_to_prepare_ = 0;
+  parallel_schedule_.valid = false;
   if (memory_planner_) {
     TF_LITE_ENSURE_STATUS(memory_planner_->ResetAllocations());
   }
@@ -762,6 +826,8 @@ TfLiteStatus Subgraph::AllocateTensors() {
   // index that uses the tensor.
   InitializeTensorReleaseMap();
 
+  ApplyLazyWeightPaging();
+
   return kTfLiteOk;
 }
 
@@ -1058,14 +1124,32 @@ TfLiteStatus Subgraph::PrepareOpsStartingAt(
     const TfLiteRegistration& registration =
         nodes_and_registration_[node_index].second;
     EnsureTensorsVectorCapacity();
+    // Nodes whose input shapes are the same as when they were last prepared
+    // would compute the same output shapes and temporaries again.
+    std::vector<int> input_shapes;
+    bool needs_prepare = true;
+    if (ShouldResizeIncrementally() && node.delegate == nullptr &&
+        !OpMightHaveSideEffect(&node, &registration)) {
+      input_shapes = GetInputShapes(context_, node.inputs);
+      if (prepared_input_shapes_.size() <= node_index) {
+        prepared_input_shapes_.resize(nodes_and_registration_.size());
+      }
+      needs_prepare = prepared_input_shapes_[node_index] != input_shapes;
+      prepared_input_shapes_[node_index].clear();
+    }
+    if (needs_prepare) {
 #ifdef TF_LITE_TENSORFLOW_PROFILER
-    tflite::OnTfLiteOpPrepare(GetTFLiteOpName(registration), node_index);
+      tflite::OnTfLiteOpPrepare(GetTFLiteOpName(registration), node_index);
 #endif  // TF_LITE_TENSORFLOW_PROFILER
-    const TfLiteStatus op_prepare_status = OpPrepare(registration, &node);
-    if (op_prepare_status != kTfLiteOk) {
-      ReportOpError(&context_, node, registration, node_index,
-                    "failed to prepare");
-      return op_prepare_status;
+      const TfLiteStatus op_prepare_status = OpPrepare(registration, &node);
+      if (op_prepare_status != kTfLiteOk) {
+        ReportOpError(&context_, node, registration, node_index,
+                      "failed to prepare");
+        return op_prepare_status;
+      }
+    }
+    if (!input_shapes.empty()) {
+      prepared_input_shapes_[node_index] = std::move(input_shapes);
     }
 
     *last_execution_plan_index_prepared = execution_plan_index;
@@ -1086,9 +1170,17 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
 #ifdef TFLITE_USE_SIMPLE_MEMORY_PLANNER
     memory_planner_.reset(new SimplePlanner(&context_, CreateGraphInfo()));
 #else
-    memory_planner_ = std::make_unique<ArenaPlanner>(
-        &context_, CreateGraphInfo(), ShouldPreserveAllTensors(),
+    // Concurrently running nodes may be in any order, so no intermediate
+    // tensor may reuse the memory of another one.
+    memory_plan_allows_parallel_execution_ =
+        ShouldPreserveAllTensors() || ShouldRunNodesInParallel();
+    auto arena_planner = std::make_unique<ArenaPlanner>(
+        &context_, CreateGraphInfo(), memory_plan_allows_parallel_execution_,
         kDefaultTensorAlignment);
+    arena_planner->SetOfflinePlannedOffsets(
+        GetOfflinePlannedOffsets(metadata_, subgraph_index_, tensors_.size()));
+    arena_planner->SetReusePlanForSmallerTensors(ShouldResizeIncrementally());
+    memory_planner_ = std::move(arena_planner);
 #endif
     memory_planner_->PlanAllocations();
   }
@@ -1208,6 +1300,22 @@ TfLiteStatus Subgraph::Invoke() {
   }
   TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(profiler_.get(), "Invoke");
 
+  if (ShouldRunNodesInParallel() && !profiler_) {
+    if (next_execution_plan_index_to_prepare_ == 0) {
+      TF_LITE_ENSURE_STATUS(PrepareOpsAndTensors());
+    }
+    // Only a plan without dynamic tensors is prepared in full ahead of time.
+    if (next_execution_plan_index_to_prepare_ ==
+        static_cast<int>(execution_plan_.size())) {
+      if (!parallel_schedule_.valid) {
+        BuildParallelSchedule();
+      }
+      if (parallel_schedule_.runnable) {
+        return InvokeNodesInParallel();
+      }
+    }
+  }
+
   // Invocations are always done in node order.
   // Note that calling Invoke repeatedly will cause the original memory plan to
   // be reused, unless either ResizeInputTensor() or AllocateTensors() has been
@@ -1275,6 +1383,12 @@ TfLiteStatus Subgraph::Invoke() {
       return kTfLiteError;
     }
 
+    // Reads in the weights of the next node while this one runs.
+    if (execution_plan_index == 0) {
+      PrefetchLazyWeights(execution_plan_index);
+    }
+    PrefetchLazyWeights(execution_plan_index + 1);
+
     EnsureTensorsVectorCapacity();
     tensor_resized_since_op_invoke_ = false;
     if (OpInvoke(registration, &node) != kTfLiteOk) {
@@ -1308,6 +1422,190 @@ TfLiteStatus Subgraph::Invoke() {
   return status;
 }
 
+void Subgraph::ApplyLazyWeightPaging() {
+  lazy_weight_prefetch_plan_.clear();
+  const int min_bytes = LazyWeightPagingMinBytes();
+  if (min_bytes <= 0) {
+    return;
+  }
+  auto get_mmap_allocation = [this, min_bytes](
+                                 int tensor_index) -> const MMAPAllocation* {
+    if (tensor_index == kTfLiteOptionalTensor) return nullptr;
+    const TfLiteTensor& tensor = tensors_[tensor_index];
+    if (tensor.allocation_type != kTfLiteMmapRo ||
+        tensor.allocation == nullptr ||
+        tensor.bytes < static_cast<size_t>(min_bytes)) {
+      return nullptr;
+    }
+    const auto* allocation = static_cast<const Allocation*>(tensor.allocation);
+    if (allocation->type() != Allocation::Type::kMMap) return nullptr;
+    return static_cast<const MMAPAllocation*>(allocation);
+  };
+
+  // Tensors read by nodes that aren't delegated, whose pages must be kept.
+  std::vector<bool> read_by_cpu_kernel(tensors_.size(), false);
+  lazy_weight_prefetch_plan_.resize(execution_plan_.size());
+  for (int i = 0; i < execution_plan_.size(); ++i) {
+    const TfLiteNode& node = nodes_and_registration_[execution_plan_[i]].first;
+    if (node.delegate != nullptr) continue;
+    for (int tensor_index : TfLiteIntArrayView(node.inputs)) {
+      if (get_mmap_allocation(tensor_index) == nullptr) continue;
+      read_by_cpu_kernel[tensor_index] = true;
+      lazy_weight_prefetch_plan_[i].push_back(tensor_index);
+    }
+  }
+  for (int tensor_index = 0; tensor_index < tensors_.size(); ++tensor_index) {
+    const MMAPAllocation* allocation = get_mmap_allocation(tensor_index);
+    if (allocation == nullptr) continue;
+    const TfLiteTensor& tensor = tensors_[tensor_index];
+    allocation->Advise(tensor.data.raw, tensor.bytes,
+                       MMAPAllocation::Advice::kRandom);
+    // Delegates have copied the tensors they read while being applied.
+    // Dropping the pages is safe regardless, since they are read back from
+    // the file if they're accessed again.
+    if (!read_by_cpu_kernel[tensor_index]) {
+      allocation->Advise(tensor.data.raw, tensor.bytes,
+                         MMAPAllocation::Advice::kDontNeed);
+    }
+  }
+}
+
+void Subgraph::PrefetchLazyWeights(int execution_plan_index) {
+  if (execution_plan_index >= lazy_weight_prefetch_plan_.size()) {
+    return;
+  }
+  for (int tensor_index : lazy_weight_prefetch_plan_[execution_plan_index]) {
+    const TfLiteTensor& tensor = tensors_[tensor_index];
+    static_cast<const MMAPAllocation*>(tensor.allocation)
+        ->Advise(tensor.data.raw, tensor.bytes,
+                 MMAPAllocation::Advice::kWillNeed);
+  }
+}
+
+void Subgraph::BuildParallelSchedule() {
+  parallel_schedule_.valid = true;
+  parallel_schedule_.runnable = false;
+  const int num_nodes = execution_plan_.size();
+  parallel_schedule_.consumers.assign(num_nodes, {});
+  parallel_schedule_.num_dependencies.assign(num_nodes, 0);
+  if (!memory_plan_allows_parallel_execution_ ||
+      ShouldOptimizeMemoryForLargeTensors()) {
+    return;
+  }
+
+  auto is_stateful_tensor = [this](int tensor_index) {
+    const TfLiteTensor& tensor = tensors_[tensor_index];
+    return tensor.is_variable || tensor.type == kTfLiteResource ||
+           tensor.type == kTfLiteVariant;
+  };
+
+  // The execution plan index of the node producing each tensor.
+  std::vector<int> producers(tensors_.size(), -1);
+  // Nodes reading or writing state are kept in execution plan order.
+  int last_stateful_node = -1;
+  std::vector<int> dependencies;
+  for (int i = 0; i < num_nodes; ++i) {
+    const TfLiteNode& node = nodes_and_registration_[execution_plan_[i]].first;
+    const TfLiteRegistration& registration =
+        nodes_and_registration_[execution_plan_[i]].second;
+    // Delegate kernels and control flow ops (which invoke other subgraphs)
+    // aren't known to be safe to run concurrently.
+    if (node.delegate != nullptr ||
+        registration.builtin_code == kTfLiteBuiltinWhile ||
+        registration.builtin_code == kTfLiteBuiltinIf ||
+        registration.builtin_code == kTfLiteBuiltinCallOnce ||
+        HasDynamicTensor(context_, node.outputs, nullptr)) {
+      return;
+    }
+
+    dependencies.clear();
+    bool is_stateful = false;
+    for (int tensor_index : TfLiteIntArrayView(node.inputs)) {
+      if (tensor_index == kTfLiteOptionalTensor) continue;
+      if (tensors_[tensor_index].delegate != nullptr) return;
+      if (producers[tensor_index] >= 0) {
+        dependencies.push_back(producers[tensor_index]);
+      }
+      is_stateful |= is_stateful_tensor(tensor_index);
+    }
+    for (int tensor_index : TfLiteIntArrayView(node.outputs)) {
+      if (tensor_index == kTfLiteOptionalTensor) continue;
+      is_stateful |= is_stateful_tensor(tensor_index);
+    }
+    if (is_stateful) {
+      if (last_stateful_node >= 0) {
+        dependencies.push_back(last_stateful_node);
+      }
+      last_stateful_node = i;
+    }
+    for (int tensor_index : TfLiteIntArrayView(node.outputs)) {
+      if (tensor_index == kTfLiteOptionalTensor) continue;
+      producers[tensor_index] = i;
+    }
+
+    std::sort(dependencies.begin(), dependencies.end());
+    dependencies.erase(std::unique(dependencies.begin(), dependencies.end()),
+                       dependencies.end());
+    for (int dependency : dependencies) {
+      parallel_schedule_.consumers[dependency].push_back(i);
+    }
+    parallel_schedule_.num_dependencies[i] = dependencies.size();
+  }
+  parallel_schedule_.runnable = true;
+}
+
+TfLiteStatus Subgraph::InvokeNodesInParallel() {
+  const int num_threads = options_->GetGraphParallelism();
+  if (parallel_executor_ == nullptr ||
+      parallel_executor_->num_threads() != num_threads) {
+    parallel_executor_.reset();
+    worker_cpu_backend_contexts_.clear();
+    for (int i = 1; i < num_threads; ++i) {
+      worker_cpu_backend_contexts_.push_back(
+          std::make_unique<ExternalCpuBackendContext>());
+    }
+    parallel_executor_ = std::make_unique<ParallelNodeExecutor>(num_threads);
+  }
+
+  EnsureTensorsVectorCapacity();
+  std::atomic<int> failed_node_index(-1);
+  std::atomic<bool> cancelled(false);
+  auto run_node = [this, &failed_node_index, &cancelled](
+                      int execution_plan_index, int /*worker*/) {
+    const int node_index = execution_plan_[execution_plan_index];
+    TfLiteNode& node = nodes_and_registration_[node_index].first;
+    const TfLiteRegistration& registration =
+        nodes_and_registration_[node_index].second;
+    if (IsCancelled()) {
+      cancelled = true;
+      return kTfLiteError;
+    }
+    if (OpInvoke(registration, &node) != kTfLiteOk) {
+      int no_failure = -1;
+      failed_node_index.compare_exchange_strong(no_failure, node_index);
+      return kTfLiteError;
+    }
+    return kTfLiteOk;
+  };
+  if (parallel_executor_->Run(parallel_schedule_.consumers,
+                              parallel_schedule_.num_dependencies,
+                              run_node) == kTfLiteOk) {
+    return kTfLiteOk;
+  }
+
+  if (failed_node_index >= 0) {
+    const auto& node_and_registration =
+        nodes_and_registration_[failed_node_index];
+    return ReportOpError(&context_, node_and_registration.first,
+                         node_and_registration.second, failed_node_index,
+                         "failed to invoke");
+  }
+  if (cancelled) {
+    ReportError("Client requested cancel during Invoke()");
+  }
+  return kTfLiteError;
+}
+
 TfLiteStatus Subgraph::ResizeTensor(TfLiteContext* context,
                                     TfLiteTensor* tensor,
                                     TfLiteIntArray* new_size) {
@@ -1628,6 +1926,8 @@ TfLiteStatus Subgraph::UndoAllDelegates() {
   // Reset execution plan.
   execution_plan_ = pre_delegation_execution_plan_;
   pre_delegation_execution_plan_.clear();
+  // Delegate kernels may have resized the outputs of the restored nodes.
+  prepared_input_shapes_.clear();
 
   // Handling FP16 delegation (if applies).
   //
@@ -1803,6 +2103,7 @@ TfLiteStatus Subgraph::ModifyGraphWithDelegate(TfLiteDelegate* delegate) {
     // plan.
     pre_delegation_execution_plan_ = execution_plan_;
   }
+  prepared_input_shapes_.clear();
 
   // STEP 2: Delegate replaces applicable nodes with delegate kernels.
   // =================================================================
@@ -1898,6 +2199,15 @@ void Subgraph::DumpMemoryPlannerDebugInfo() const {
   memory_planner_->DumpDebugInfo(execution_plan());
 }
 
+void Subgraph::GetArenaHighWaterMarks(
+    std::vector<size_t>* high_water_marks) const {
+  if (memory_planner_ == nullptr) {
+    high_water_marks->clear();
+    return;
+  }
+  memory_planner_->GetArenaHighWaterMarks(high_water_marks);
+}
+
 std::unique_ptr<GraphInfo> Subgraph::CreateGraphInfo() {
   return std::unique_ptr<GraphInfo>(new InterpreterInfo(this));
 }
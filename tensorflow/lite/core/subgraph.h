@@ -32,8 +32,10 @@ limitations under the License.
 #include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow/lite/core/api/profiler.h"
 #include "tensorflow/lite/core/macros.h"
+#include "tensorflow/lite/core/parallel_node_executor.h"
 #include "tensorflow/lite/experimental/resource/initialization_status.h"
 #include "tensorflow/lite/experimental/resource/resource_base.h"
+#include "tensorflow/lite/external_cpu_backend_context.h"
 #include "tensorflow/lite/graph_info.h"
 #include "tensorflow/lite/interpreter_options.h"
 #include "tensorflow/lite/memory_planner.h"
@@ -379,6 +381,12 @@ class Subgraph {
   // information about tenosrs and ops.
   void DumpMemoryPlannerDebugInfo() const;
 
+  // WARNING: This is an experimental API and subject to change.
+  // Fills `high_water_marks` with, for each node of the execution plan, the
+  // number of bytes of the non-persistent arena in use while it runs. Leaves it
+  // empty if the memory hasn't been planned or isn't allocated from an arena.
+  void GetArenaHighWaterMarks(std::vector<size_t>* high_water_marks) const;
+
   // WARNING: This is an experimental API and subject to change.
   // Set the given `InterpreterOptions` object.
   void SetOptions(InterpreterOptions* options) { options_ = options; }
@@ -412,6 +420,26 @@ class Subgraph {
     return (options_ && (options_->GetDynamicAllocationForLargeTensors() > 0));
   }
 
+  // WARNING: This is an experimental API and subject to change.
+  // True if independent nodes should be run concurrently.
+  bool ShouldRunNodesInParallel() const {
+    return (options_ && options_->GetGraphParallelism() > 1);
+  }
+
+  // WARNING: This is an experimental API and subject to change.
+  // True if nodes whose input shapes didn't change are not prepared again, and
+  // the memory plan is kept while tensors fit it.
+  bool ShouldResizeIncrementally() const {
+    return (options_ && options_->GetIncrementalResizing());
+  }
+
+  // WARNING: This is an experimental API and subject to change.
+  // The size threshold of the memory-mapped constant tensors whose pages are
+  // managed lazily, or 0 if lazy weight paging is disabled.
+  int LazyWeightPagingMinBytes() const {
+    return options_ ? options_->GetLazyWeightPagingMinBytes() : 0;
+  }
+
   // WARNING: This is an experimental API and subject to change.
   // Remove unused inputs of the subgraph. It checks usage of inputs and mark it
   // as kTfLiteOptionalTensor if the input is not used in graph execution.
@@ -691,6 +719,23 @@ class Subgraph {
   // Ensures the memory required is planned and allocated.
   TfLiteStatus EnsureMemoryAllocations();
 
+  // Computes `parallel_schedule_` from the prepared execution plan. The
+  // schedule is marked not runnable if any node can't safely run concurrently
+  // with others.
+  void BuildParallelSchedule();
+
+  // Runs the fully prepared execution plan according to `parallel_schedule_`.
+  TfLiteStatus InvokeNodesInParallel();
+
+  // Hints the access pattern of the large memory-mapped constant tensors to
+  // the kernel, and computes `lazy_weight_prefetch_plan_`, if lazy weight
+  // paging is enabled. See `InterpreterOptions::SetLazyWeightPaging`.
+  void ApplyLazyWeightPaging();
+
+  // Starts reading in the large memory-mapped constant inputs of the node at
+  // `execution_plan_index`, if there is one.
+  void PrefetchLazyWeights(int execution_plan_index);
+
   // Returns true if cancellation function returns true.
   bool IsCancelled();
 
@@ -825,6 +870,37 @@ class Subgraph {
 
   std::unique_ptr<MemoryPlanner> memory_planner_;
 
+  // True if `memory_planner_` never lets two tensors share memory, which is
+  // required to run nodes concurrently.
+  bool memory_plan_allows_parallel_execution_ = false;
+
+  // Dependencies between the nodes of the execution plan, used when
+  // `ShouldRunNodesInParallel()`. Nodes are identified by their index in
+  // `execution_plan_`.
+  struct ParallelSchedule {
+    // False if the schedule must be rebuilt before use.
+    bool valid = false;
+    // False if the plan must be run sequentially.
+    bool runnable = false;
+    std::vector<std::vector<int>> consumers;
+    std::vector<int> num_dependencies;
+  };
+  ParallelSchedule parallel_schedule_;
+
+  // For each node of the execution plan, the large memory-mapped constant
+  // tensors it reads that are prefetched before it's invoked. Empty unless
+  // lazy weight paging is enabled.
+  std::vector<std::vector<int>> lazy_weight_prefetch_plan_;
+
+  // Runs nodes according to `parallel_schedule_`; created on first use.
+  std::unique_ptr<ParallelNodeExecutor> parallel_executor_;
+
+  // The CPU backend contexts used by nodes running on the helper threads of
+  // `parallel_executor_` (indexed by worker - 1), since those contexts can't
+  // be shared by concurrently running kernels.
+  std::vector<std::unique_ptr<ExternalCpuBackendContext>>
+      worker_cpu_backend_contexts_;
+
   // Maps tensor index to custom allocation for all applicable tensors.
   std::map<int, TfLiteCustomAllocation> custom_allocations_;
 
@@ -854,6 +930,12 @@ class Subgraph {
   // is kept only for user error message.
   int dynamic_tensor_index_ = -1;
 
+  // WARNING: This is an experimental interface that is subject to change.
+  // When `ShouldResizeIncrementally()`, the shapes of the inputs of each node
+  // when it was last prepared successfully, as returned by GetInputShapes(),
+  // indexed by node index. Empty for nodes that must be prepared again.
+  std::vector<std::vector<int>> prepared_input_shapes_;
+
   // Reference to cancellation function that can cancel a request in the middle
   // of a call to Invoke(). When this function returns True, a kTfLiteError is
   // thrown by Invoke().
@@ -16,10 +16,13 @@ limitations under the License.
 #include "tensorflow/lite/core/subgraph.h"
 
 #include <algorithm>
+#include <map>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/interpreter.h"
+#include "tensorflow/lite/interpreter_options.h"
 
 namespace tflite {
 
@@ -27,6 +30,7 @@ namespace ops {
 namespace builtin {
 TfLiteRegistration* Register_PADV2();
 TfLiteRegistration* Register_NEG();
+TfLiteRegistration* Register_ADD();
 }  // namespace builtin
 }  // namespace ops
 
@@ -71,5 +75,105 @@ TEST(RemoveUnusedInputs, BypassInputsWithoutOp) {
   ASSERT_EQ(subgraph.inputs(), std::vector<int>({0, -1, 2}));
 }
 
+TEST(GraphParallelism, MatchesSequentialExecution) {
+  for (int graph_parallelism : {1, 3}) {
+    Interpreter interpreter;
+    InterpreterOptions options;
+    options.SetGraphParallelism(graph_parallelism);
+    ASSERT_EQ(interpreter.ApplyOptions(&options), kTfLiteOk);
+
+    // Two independent NEG branches joined by an ADD.
+    ASSERT_EQ(interpreter.AddTensors(4), kTfLiteOk);
+    ASSERT_EQ(interpreter.SetInputs({0}), kTfLiteOk);
+    ASSERT_EQ(interpreter.SetOutputs({3}), kTfLiteOk);
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_EQ(interpreter.SetTensorParametersReadWrite(
+                    i, kTfLiteFloat32, "", {2}, TfLiteQuantization()),
+                kTfLiteOk);
+    }
+    TfLiteRegistration* neg_op = tflite::ops::builtin::Register_NEG();
+    TfLiteRegistration* add_op = tflite::ops::builtin::Register_ADD();
+    auto* add_params =
+        static_cast<TfLiteAddParams*>(malloc(sizeof(TfLiteAddParams)));
+    add_params->activation = kTfLiteActNone;
+    add_params->pot_scale_int16 = false;
+    ASSERT_EQ(interpreter.AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr,
+                                                neg_op),
+              kTfLiteOk);
+    ASSERT_EQ(interpreter.AddNodeWithParameters({0}, {2}, nullptr, 0, nullptr,
+                                                neg_op),
+              kTfLiteOk);
+    ASSERT_EQ(interpreter.AddNodeWithParameters({1, 2}, {3}, nullptr, 0,
+                                                add_params, add_op),
+              kTfLiteOk);
+    ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+    for (float value : {1.f, 5.f}) {
+      interpreter.typed_input_tensor<float>(0)[0] = value;
+      interpreter.typed_input_tensor<float>(0)[1] = -value;
+      ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+      EXPECT_EQ(interpreter.typed_output_tensor<float>(0)[0], -2 * value);
+      EXPECT_EQ(interpreter.typed_output_tensor<float>(0)[1], 2 * value);
+    }
+  }
+}
+
+// NEG, counting how many times each node gets prepared.
+std::map<int, int>* prepare_counts_by_output = new std::map<int, int>();
+
+TfLiteStatus CountingNegPrepare(TfLiteContext* context, TfLiteNode* node) {
+  ++(*prepare_counts_by_output)[node->outputs->data[0]];
+  return tflite::ops::builtin::Register_NEG()->prepare(context, node);
+}
+
+TEST(IncrementalResizing, OnlyPreparesNodesWithResizedInputs) {
+  prepare_counts_by_output->clear();
+  Interpreter interpreter;
+  InterpreterOptions options;
+  options.SetIncrementalResizing();
+  ASSERT_EQ(interpreter.ApplyOptions(&options), kTfLiteOk);
+
+  // Two independent NEG nodes: 0 -> 2 and 1 -> 3.
+  ASSERT_EQ(interpreter.AddTensors(4), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetInputs({0, 1}), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetOutputs({2, 3}), kTfLiteOk);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(interpreter.SetTensorParametersReadWrite(
+                  i, kTfLiteFloat32, "", {2}, TfLiteQuantization()),
+              kTfLiteOk);
+  }
+  TfLiteRegistration neg_op = *tflite::ops::builtin::Register_NEG();
+  neg_op.prepare = CountingNegPrepare;
+  ASSERT_EQ(
+      interpreter.AddNodeWithParameters({0}, {2}, nullptr, 0, nullptr, &neg_op),
+      kTfLiteOk);
+  ASSERT_EQ(
+      interpreter.AddNodeWithParameters({1}, {3}, nullptr, 0, nullptr, &neg_op),
+      kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ((*prepare_counts_by_output)[2], 1);
+  EXPECT_EQ((*prepare_counts_by_output)[3], 1);
+
+  ASSERT_EQ(interpreter.ResizeInputTensor(1, {3}), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ((*prepare_counts_by_output)[2], 1);
+  EXPECT_EQ((*prepare_counts_by_output)[3], 2);
+  ASSERT_EQ(interpreter.tensor(3)->dims->size, 1);
+  EXPECT_EQ(interpreter.tensor(3)->dims->data[0], 3);
+
+  for (int i = 0; i < 2; ++i) interpreter.typed_input_tensor<float>(0)[i] = i;
+  for (int i = 0; i < 3; ++i) interpreter.typed_input_tensor<float>(1)[i] = i;
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  EXPECT_EQ(interpreter.typed_output_tensor<float>(0)[1], -1.f);
+  EXPECT_EQ(interpreter.typed_output_tensor<float>(1)[2], -2.f);
+
+  // Shrinking the input back reuses the arena plan.
+  const float* output_data = interpreter.typed_output_tensor<float>(1);
+  ASSERT_EQ(interpreter.ResizeInputTensor(1, {2}), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ((*prepare_counts_by_output)[3], 3);
+  EXPECT_EQ(interpreter.typed_output_tensor<float>(1), output_data);
+}
+
 }  // namespace
 }  // namespace tflite
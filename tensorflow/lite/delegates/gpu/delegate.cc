@@ -25,14 +25,17 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
 #include "tensorflow/lite/builtin_ops.h"
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/delegates/gpu/api.h"
 #include "tensorflow/lite/delegates/gpu/cl/api.h"
+#include "tensorflow/lite/delegates/gpu/cl/cl_device.h"
 #include "tensorflow/lite/delegates/gpu/cl/opencl_wrapper.h"
 #include "tensorflow/lite/delegates/gpu/cl/tensor_type_util.h"
 #include "tensorflow/lite/delegates/gpu/cl/util.h"
+#include "tensorflow/lite/delegates/gpu/common/gpu_info.h"
 #include "tensorflow/lite/delegates/gpu/common/model.h"
 #include "tensorflow/lite/delegates/gpu/common/model_builder.h"
 #include "tensorflow/lite/delegates/gpu/common/model_transformer.h"
@@ -80,6 +83,20 @@ InferenceUsage ToUsage(int32_t usage) {
   return InferenceUsage::UNKNOWN;
 }
 
+// Returns a key identifying the OpenCL device the delegate runs on and its
+// driver. Serialized programs can only be loaded by the driver that compiled
+// them, so data serialized on one device or driver version is not looked up
+// on another one (e.g. after an OS update).
+absl::Status GetOpenClDeviceKey(std::string* key) {
+  RETURN_IF_ERROR(cl::LoadOpenCL());
+  cl::CLDevice device;
+  RETURN_IF_ERROR(cl::CreateDefaultGPUDevice(&device));
+  const OpenClInfo& info = device.GetInfo().opencl_info;
+  *key = absl::StrCat(info.vendor_name, "|", info.device_name, "|",
+                      info.platform_version, "|", info.driver_version);
+  return absl::OkStatus();
+}
+
 // Forward declarations.
 TfLiteStatus DelegatePrepare(TfLiteContext* context, TfLiteDelegate* delegate);
 
@@ -399,6 +416,17 @@ class DelegateKernel {
     return absl::OkStatus();
   }
 
+  // Returns the key of the data serialized with `options` on the device
+  // identified by `device_key`.
+  static std::string GetSerializedDataKey(const cl::InferenceOptions& options,
+                                          const std::string& device_key) {
+    // We use a fingerprint of the options to ensure compatibility.
+    return absl::StrCat(
+        kSerializedDataPrefix,
+        delegates::StrFingerprint(&options, sizeof(cl::InferenceOptions)), "_",
+        delegates::StrFingerprint(device_key.data(), device_key.size()));
+  }
+
   // Returns Ok only if serialized data is successsfully found.
   absl::Status MaybeInitializeSerializedOpenCL(
       TfLiteContext* context, const TfLiteDelegateParams* delegate_params,
@@ -407,12 +435,10 @@ class DelegateKernel {
       cl::InferenceEnvironmentProperties* properties,
       Serialization* serialization) {
     if (!serialization) return absl::InvalidArgumentError("No serialization");
-    // We use a fingerprint of the options to ensure compatibility.
-    std::string options_fingerprint =
-        delegates::StrFingerprint(options, sizeof(cl::InferenceOptions));
+    std::string device_key;
+    RETURN_IF_ERROR(GetOpenClDeviceKey(&device_key));
     auto data_key = serialization->GetEntryForKernel(
-        std::string(kSerializedDataPrefix) + options_fingerprint, context,
-        delegate_params);
+        GetSerializedDataKey(*options, device_key), context, delegate_params);
 
     std::string model_data;
     auto model_data_status = data_key.GetData(context, &model_data);
@@ -439,14 +465,12 @@ class DelegateKernel {
       cl::InferenceOptions* options, Serialization* serialization,
       const std::vector<uint8_t>& serialized_model) {
     if (!serialization) return absl::InvalidArgumentError("No serialization");
-    // We use a fingerprint of the options to ensure compatibility.
-    std::string options_fingerprint =
-        delegates::StrFingerprint(options, sizeof(cl::InferenceOptions));
+    std::string device_key;
+    RETURN_IF_ERROR(GetOpenClDeviceKey(&device_key));
 
     // Save data.
     auto data_key = serialization->GetEntryForKernel(
-        std::string(kSerializedDataPrefix) + options_fingerprint, context,
-        delegate_params);
+        GetSerializedDataKey(*options, device_key), context, delegate_params);
     auto save_status = data_key.SetData(
         context, reinterpret_cast<const char*>(serialized_model.data()),
         serialized_model.size());
@@ -59,7 +59,8 @@ enum TfLiteGpuExperimentalFlags {
   // Enable serialization of GPU kernels & model data. Speeds up initilization
   // at the cost of space on disk.
   // Delegate performs serialization the first time it is applied with a new
-  // model or inference params. Later initializations are fast.
+  // model, inference params, GPU or GPU driver version. Later initializations
+  // are fast.
   // ModifyGraphWithDelegate will fail if data cannot be serialized.
   //
   // NOTE: User also needs to set serialization_dir & model_token in
@@ -72,6 +72,13 @@ TFL_CAPI_EXPORT void TfLiteXNNPackDelegateDelete(TfLiteDelegate* delegate);
 // instances.
 TFL_CAPI_EXPORT struct TfLiteXNNPackDelegateWeightsCache*
 TfLiteXNNPackDelegateWeightsCacheCreate();
+// Same as TfLiteXNNPackDelegateWeightsCacheCreate, but reserves `size` bytes
+// for packed weights up front. When `size` covers the packed weights of the
+// model(s) using the cache (e.g. as measured on a previous run), creating the
+// first delegate instance doesn't grow, and copy, the cache buffer.
+// Returns NULL on error.
+TFL_CAPI_EXPORT struct TfLiteXNNPackDelegateWeightsCache*
+TfLiteXNNPackDelegateWeightsCacheCreateWithSize(size_t size);
 // Soft-finalize a weights cache. Extra space will be left in the weights cache
 // to allow for cache "insertion" only if it is a cache hit. This has memory
 // overhead compared to TfLiteXNNPackDelegateWeightsCacheFinalizeHard. Use this
@@ -609,6 +609,21 @@ TfLiteStatus InterpreterBuilder::ParseTensors(
             return kTfLiteOk;
           }
         }
+        // The data of the buffer is stored after the flatbuffer.
+        if (buffer->offset() > 1 && buffer->size() > 0) {
+          if (allocation_ == nullptr ||
+              buffer->offset() > allocation_->bytes() ||
+              buffer->size() > allocation_->bytes() - buffer->offset()) {
+            TF_LITE_REPORT_ERROR(
+                error_reporter_,
+                "Tensor %d specifies buffer %d outside of the model.\n", i,
+                tensor->buffer());
+            return kTfLiteError;
+          }
+          *buffer_size = buffer->size();
+          *buffer_data =
+              static_cast<const char*>(allocation_->base()) + buffer->offset();
+        }
       }
       return kTfLiteOk;
     };
@@ -769,6 +784,16 @@ TfLiteStatus InterpreterBuilder::operator()(
   // Set Interpreter options
   (*interpreter)->ApplyOptionsImpl(&options_);
 
+  // With lazy weight paging, bring in just the pages of the model that are
+  // read from now on, instead of reading ahead around them.
+  if (options_.GetLazyWeightPagingMinBytes() > 0 && allocation_ != nullptr &&
+      allocation_->type() == Allocation::Type::kMMap) {
+    const auto* mmap_allocation =
+        static_cast<const MMAPAllocation*>(allocation_);
+    mmap_allocation->Advise(mmap_allocation->base(), mmap_allocation->bytes(),
+                            MMAPAllocation::Advice::kRandom);
+  }
+
   (*interpreter)
       ->SetProfilerImpl(tflite::profiling::MaybeCreatePlatformProfiler());
 
@@ -27,7 +27,10 @@ class InterpreterOptions {
   InterpreterOptions()
       : experimental_preserve_all_tensors_(false),
         experimental_ensure_dynamic_tensors_are_released_(false),
-        experimental_optimize_memory_for_large_tensors_(0) {}
+        experimental_optimize_memory_for_large_tensors_(0),
+        experimental_graph_parallelism_(1),
+        experimental_incremental_resizing_(false),
+        experimental_lazy_weight_paging_min_bytes_(0) {}
 
   /// Preserving all intermediates tensors for debugging.
   /// WARNING: This is an experimental API and subject to change.
@@ -76,10 +79,79 @@ class InterpreterOptions {
     return experimental_optimize_memory_for_large_tensors_;
   }
 
+  /// Run independent nodes of a subgraph concurrently on up to `num_threads`
+  /// threads, in addition to any parallelism inside the kernels. Nodes start
+  /// as soon as the nodes producing their inputs have finished, which lets
+  /// models with parallel branches (e.g. multi-tower models) use idle cores.
+  /// Since no two intermediate tensors share memory then, the arena grows to
+  /// the size it has with `SetPreserveAllTensors`. Subgraphs with dynamic
+  /// tensors, delegated nodes or control flow ops, and invocations with a
+  /// profiler installed, still run sequentially. Custom ops must be safe to
+  /// run concurrently with other ops. This must be applied before tensors are
+  /// allocated.
+  /// WARNING: This is an experimental API and subject to change.
+  void SetGraphParallelism(int num_threads) {
+    experimental_graph_parallelism_ = num_threads;
+  }
+
+  /// Returns the number of threads used to run independent nodes concurrently,
+  /// or 1 if nodes are run sequentially.
+  /// WARNING: This is an experimental API and subject to change.
+  int GetGraphParallelism() { return experimental_graph_parallelism_; }
+
+  /// Make `AllocateTensors` after `ResizeInputTensor` cheaper for models that
+  /// are run with varying input shapes (e.g. sequence lengths):
+  /// - Nodes whose input shapes didn't change since they were last prepared
+  ///   aren't prepared again, except for delegated nodes and ops that may
+  ///   have side effects (e.g. control flow ops).
+  /// - If every tensor still fits the space it was given in the arena, the
+  ///   arena keeps its plan instead of being planned again.
+  /// Resizing the inputs to their largest shapes and allocating tensors once
+  /// then plans the arena for all the smaller shapes, at the cost of keeping
+  /// the arena at its largest size. Kernels must only derive their state in
+  /// `Prepare` from the shapes of their inputs (and constant tensors).
+  /// WARNING: This is an experimental API and subject to change.
+  void SetIncrementalResizing(bool value = true) {
+    experimental_incremental_resizing_ = value;
+  }
+
+  /// Returns if the `experimental_incremental_resizing_` feature is enabled.
+  /// WARNING: This is an experimental API and subject to change.
+  bool GetIncrementalResizing() { return experimental_incremental_resizing_; }
+
+  /// Keep the pages of large memory-mapped constant tensors (of at least
+  /// `min_bytes`) out of memory until they are needed, for models loaded with
+  /// `FlatBufferModel::BuildFromFile` or similar:
+  /// - The kernel doesn't read ahead around the pages that are read, so
+  ///   loading the model and preparing it only brings in the pages touched.
+  /// - Once tensors are allocated, the pages of tensors that are only read by
+  ///   delegated nodes are dropped, since delegates have copied what they
+  ///   need by then.
+  /// - While invoking, the tensors of each node are read in while the
+  ///   previous node runs.
+  /// This mainly helps large models whose weights don't all fit in memory at
+  /// once, or which mostly run on a delegate.
+  /// WARNING: This is an experimental API and subject to change.
+  void SetLazyWeightPaging(int min_bytes = 64 * 1024) {
+    if (min_bytes > 0) {
+      experimental_lazy_weight_paging_min_bytes_ = min_bytes;
+    }
+  }
+
+  /// Returns the size (in bytes) threshold for lazy weight paging. It returns
+  /// zero if the feature is not enabled.
+  /// WARNING: This is an experimental API and subject to change.
+  int GetLazyWeightPagingMinBytes() {
+    return experimental_lazy_weight_paging_min_bytes_;
+  }
+
  private:
   bool experimental_preserve_all_tensors_;
   bool experimental_ensure_dynamic_tensors_are_released_;
   int experimental_optimize_memory_for_large_tensors_;
+  int experimental_graph_parallelism_;
+  bool experimental_incremental_resizing_;
+  int experimental_lazy_weight_paging_min_bytes_;
 };
 
 }  // namespace tflite
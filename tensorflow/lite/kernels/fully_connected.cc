@@ -928,15 +928,25 @@ bool VerifySparsity(const RuntimeShape& weights_shape,
   const int max_batch_index = batches - 1;
   const int max_output = max_batch_index * output_depth + w0_size;
   const int max_batch_depth = accum_depth * max_batch_index;
+  // Block sparse weights index blocks of `block_size` consecutive columns.
+  const int block_size =
+      sparsity->dim_metadata_size == kDimMetadataSizeBlockSparse
+          ? sparsity->dim_metadata[2].dense_size
+          : 1;
 
   // Verify output size is enough.
   if (output_elements < max_output) return false;
 
+  // Verify blocks tile the rows of the weights.
+  if (block_size <= 0 || accum_depth % block_size != 0) return false;
+
   // Verify index from sparse in input is valid.
   for (int i = 0; i < sparsity->dim_metadata[1].array_indices->size; ++i) {
-    if (input_elements <=
-        max_batch_depth + sparsity->dim_metadata[1].array_indices->data[i])
+    const int index = sparsity->dim_metadata[1].array_indices->data[i];
+    if (index < 0 ||
+        input_elements < max_batch_depth + (index + 1) * block_size) {
       return false;
+    }
   }
   return true;
 }
@@ -1020,10 +1030,9 @@ TfLiteStatus EvalQuantized(TfLiteContext* context, TfLiteNode* node,
                 "Invalid quantized and sparse fully-connected format.");
             return kTfLiteError;
           }
-          if (sparsity.dim_metadata_size == kDimMetadataSizeBlockSparse &&
-              sparsity.dim_metadata[2].dense_size == 16) {
-            // Block sparse with block size of 1x16.
-            optimized_ops::FullyConnectedSparseWeight1x16(
+          if (sparsity.dim_metadata_size == kDimMetadataSizeBlockSparse) {
+            // Block sparse with block size of 1xN.
+            optimized_ops::FullyConnectedSparseWeight1xN(
                 sparsity, op_params, input_shape, GetTensorData<int8_t>(input),
                 filter_shape, GetTensorData<int8_t>(filter), bias_shape,
                 GetTensorData<int32_t>(bias), output_shape,
@@ -1210,10 +1219,9 @@ TfLiteStatus EvalFloat(TfLiteContext* context, TfLiteNode* node,
             filter_shape, GetTensorData<float>(filter),  // Disable formatting
             bias_shape, GetTensorData<float>(bias),      // Disable formatting
             output_shape, GetTensorData<float>(output));
-      } else if (sparsity.dim_metadata_size == kDimMetadataSizeBlockSparse &&
-                 sparsity.dim_metadata[2].dense_size == 4) {
-        // Block sparse with block size of 1x4.
-        optimized_ops::FullyConnectedSparseWeight1x4(
+      } else if (sparsity.dim_metadata_size == kDimMetadataSizeBlockSparse) {
+        // Block sparse with block size of 1xN.
+        optimized_ops::FullyConnectedSparseWeight1xN(
             sparsity, op_params,                         // Disable formatting
             input_shape, GetTensorData<float>(input),    // Disable formatting
             filter_shape, GetTensorData<float>(filter),  // Disable formatting
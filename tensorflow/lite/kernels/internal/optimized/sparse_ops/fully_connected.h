@@ -76,7 +76,15 @@ inline void FullyConnectedSparseWeight(
   }
 }
 
-inline void FullyConnectedSparseWeight1x16Impl(
+// Block sparse kernels for weights stored in 1 x `block_size` blocks along the
+// accumulation dimension. The 1x4 (float) and 1x16 (int8) patterns have
+// specialized kernels, other block sizes fall back to generic loops.
+inline int SparseWeightBlockSize(const TfLiteSparsity& sparsity) {
+  return sparsity.dim_metadata_size == 3 ? sparsity.dim_metadata[2].dense_size
+                                         : 1;
+}
+
+inline void FullyConnectedSparseWeight1xNImpl(
     const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
     const RuntimeShape& input_shape, const int8_t* input_data,
     const RuntimeShape& weights_shape, const int8_t* weights_data,
@@ -84,7 +92,7 @@ inline void FullyConnectedSparseWeight1x16Impl(
     const RuntimeShape& output_shape, int8_t* output_data, int thread_start,
     int thread_end, const CpuBackendContext& cpu_backend_context) {
   ruy::profiler::ScopeLabel label("FullyConnected");
-  ruy::profiler::ScopeLabel inner_label("1x16 Block Sparse");
+  ruy::profiler::ScopeLabel inner_label("1xN Block Sparse");
 
   const int input_dims_count = input_shape.DimensionsCount();
   const int output_dims_count = output_shape.DimensionsCount();
@@ -101,18 +109,29 @@ inline void FullyConnectedSparseWeight1x16Impl(
   const int32_t output_activation_min = params.quantized_activation_min;
   const int32_t output_activation_max = params.quantized_activation_max;
 
+  const int block_size = SparseWeightBlockSize(sparsity);
   const int* w1_segments = sparsity.dim_metadata[1].array_segments->data;
   const int* w1_indices = sparsity.dim_metadata[1].array_indices->data;
 
-  tensor_utils::SparseMatrixBatchVectorMultiplyAccumulate1x16(
-      weights_data, w1_segments, w1_indices, weights_shape.Dims(0),
-      weights_shape.Dims(1), input_data + thread_start * input_depth, bias_data,
-      batches, input_offset, output_multiplier, output_shift, output_offset,
-      output_activation_min, output_activation_max,
-      output_data + thread_start * output_depth);
+  if (block_size == 16) {
+    tensor_utils::SparseMatrixBatchVectorMultiplyAccumulate1x16(
+        weights_data, w1_segments, w1_indices, weights_shape.Dims(0),
+        weights_shape.Dims(1), input_data + thread_start * input_depth,
+        bias_data, batches, input_offset, output_multiplier, output_shift,
+        output_offset, output_activation_min, output_activation_max,
+        output_data + thread_start * output_depth);
+  } else {
+    tensor_utils::SparseMatrixBatchVectorMultiplyAccumulate1xN(
+        weights_data, w1_segments, w1_indices, weights_shape.Dims(0),
+        weights_shape.Dims(1), block_size,
+        input_data + thread_start * input_depth, bias_data, batches,
+        input_offset, output_multiplier, output_shift, output_offset,
+        output_activation_min, output_activation_max,
+        output_data + thread_start * output_depth);
+  }
 }
 
-inline void FullyConnectedSparseWeight1x4Impl(
+inline void FullyConnectedSparseWeight1xNImpl(
     const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
     const RuntimeShape& input_shape, const float* input_data,
     const RuntimeShape& weights_shape, const float* weights_data,
@@ -120,7 +139,7 @@ inline void FullyConnectedSparseWeight1x4Impl(
     const RuntimeShape& output_shape, float* output_data, int thread_start,
     int thread_end, const CpuBackendContext& cpu_backend_context) {
   ruy::profiler::ScopeLabel label("FullyConnected");
-  ruy::profiler::ScopeLabel inner_label("1x4 Block Sparse");
+  ruy::profiler::ScopeLabel inner_label("1xN Block Sparse");
   const float output_activation_min = params.float_activation_min;
   const float output_activation_max = params.float_activation_max;
 
@@ -132,13 +151,22 @@ inline void FullyConnectedSparseWeight1x4Impl(
                                       input_shape, input_dims_count - 1);
   const int output_depth = MatchingDim(weights_shape, weights_dims_count - 2,
                                        output_shape, output_dims_count - 1);
+  const int block_size = SparseWeightBlockSize(sparsity);
   const int* w1_segments = sparsity.dim_metadata[1].array_segments->data;
   const int* w1_indices = sparsity.dim_metadata[1].array_indices->data;
 
-  tensor_utils::SparseMatrixBatchVectorMultiplyAccumulate1x4(
-      weights_data, w1_segments, w1_indices, weights_shape.Dims(0),
-      weights_shape.Dims(1), input_data + thread_start * input_depth, batches,
-      output_data + thread_start * output_depth);
+  if (block_size == 4) {
+    tensor_utils::SparseMatrixBatchVectorMultiplyAccumulate1x4(
+        weights_data, w1_segments, w1_indices, weights_shape.Dims(0),
+        weights_shape.Dims(1), input_data + thread_start * input_depth,
+        batches, output_data + thread_start * output_depth);
+  } else {
+    tensor_utils::SparseMatrixBatchVectorMultiplyAccumulate1xN(
+        weights_data, w1_segments, w1_indices, weights_shape.Dims(0),
+        weights_shape.Dims(1), block_size,
+        input_data + thread_start * input_depth, batches,
+        output_data + thread_start * output_depth);
+  }
 
   ruy::profiler::ScopeLabel activation_label("activation function");
   for (int b = thread_start; b < thread_end; ++b) {
@@ -151,13 +179,14 @@ inline void FullyConnectedSparseWeight1x4Impl(
   }
 }
 
-struct FullyConnectedSparseWeight1x4Task : cpu_backend_threadpool::Task {
-  FullyConnectedSparseWeight1x4Task(
+template <typename T, typename BiasT>
+struct FullyConnectedSparseWeight1xNTask : cpu_backend_threadpool::Task {
+  FullyConnectedSparseWeight1xNTask(
       const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
-      const RuntimeShape& input_shape, const float* input_data,
-      const RuntimeShape& weights_shape, const float* weights_data,
-      const RuntimeShape& bias_shape, const float* bias_data,
-      const RuntimeShape& output_shape, float* output_data, int thread_start,
+      const RuntimeShape& input_shape, const T* input_data,
+      const RuntimeShape& weights_shape, const T* weights_data,
+      const RuntimeShape& bias_shape, const BiasT* bias_data,
+      const RuntimeShape& output_shape, T* output_data, int thread_start,
       int thread_end, const CpuBackendContext& cpu_backend_context_x)
       : sparsity(sparsity),
         params(params),
@@ -174,7 +203,7 @@ struct FullyConnectedSparseWeight1x4Task : cpu_backend_threadpool::Task {
         cpu_backend_context(cpu_backend_context_x) {}
 
   void Run() override {
-    FullyConnectedSparseWeight1x4Impl(
+    FullyConnectedSparseWeight1xNImpl(
         sparsity, params, input_shape, input_data, weights_shape, weights_data,
         bias_shape, bias_data, output_shape, output_data, thread_start,
         thread_end, cpu_backend_context);
@@ -184,63 +213,44 @@ struct FullyConnectedSparseWeight1x4Task : cpu_backend_threadpool::Task {
   const TfLiteSparsity& sparsity;
   const FullyConnectedParams& params;
   const RuntimeShape& input_shape;
-  const float* input_data;
+  const T* input_data;
   const RuntimeShape& weights_shape;
-  const float* weights_data;
+  const T* weights_data;
   const RuntimeShape& bias_shape;
-  const float* bias_data;
+  const BiasT* bias_data;
   const RuntimeShape& output_shape;
-  float* output_data;
+  T* output_data;
   int thread_start;
   int thread_end;
   const CpuBackendContext& cpu_backend_context;
 };
 
-inline void FullyConnectedSparseWeight1x16(
-    const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
-    const RuntimeShape& input_shape, const int8_t* input_data,
-    const RuntimeShape& weights_shape, const int8_t* weights_data,
-    const RuntimeShape& bias_shape, const int32_t* bias_data,
-    const RuntimeShape& output_shape, int8_t* output_data,
-    CpuBackendContext* cpu_backend_context) {
-  const int output_elements = output_shape.FlatSize();
-  memset(output_data, 0, output_elements * sizeof(int8_t));
-
-  const int batches =
-      FlatSizeSkipDim(output_shape, output_shape.DimensionsCount() - 1);
-
-  // TODO(b/220851507): Add multi-thread support for quantized sparse kernel.
-  return FullyConnectedSparseWeight1x16Impl(
-      sparsity, params, input_shape, input_data, weights_shape, weights_data,
-      bias_shape, bias_data, output_shape, output_data, 0, batches,
-      *cpu_backend_context);
-}
-
 // The multi-threaded kernel slices the workload along the batch dimension. If
 // there's not enough batches of data, the number of threads used is equal to
 // the batch size. We can improve this later with slicing along the row
 // dimension of the weight.
-inline void FullyConnectedSparseWeight1x4(
+template <typename T, typename BiasT>
+inline void FullyConnectedSparseWeight1xN(
     const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
-    const RuntimeShape& input_shape, const float* input_data,
-    const RuntimeShape& weights_shape, const float* weights_data,
-    const RuntimeShape& bias_shape, const float* bias_data,
-    const RuntimeShape& output_shape, float* output_data,
+    const RuntimeShape& input_shape, const T* input_data,
+    const RuntimeShape& weights_shape, const T* weights_data,
+    const RuntimeShape& bias_shape, const BiasT* bias_data,
+    const RuntimeShape& output_shape, T* output_data,
     CpuBackendContext* cpu_backend_context) {
   const int output_elements = output_shape.FlatSize();
-  memset(output_data, 0, output_elements * sizeof(float));
+  memset(output_data, 0, output_elements * sizeof(T));
 
   const int max_threads = cpu_backend_context->max_num_threads();
   const int batches =
       FlatSizeSkipDim(output_shape, output_shape.DimensionsCount() - 1);
   const int thread_count = std::max(1, std::min(batches, max_threads));
   if (thread_count == 1) {
-    return FullyConnectedSparseWeight1x4Impl(
+    return FullyConnectedSparseWeight1xNImpl(
         sparsity, params, input_shape, input_data, weights_shape, weights_data,
         bias_shape, bias_data, output_shape, output_data, 0, batches,
         *cpu_backend_context);
   }
-  std::vector<FullyConnectedSparseWeight1x4Task> tasks;
+  std::vector<FullyConnectedSparseWeight1xNTask<T, BiasT>> tasks;
   tasks.reserve(thread_count);
   int thread_start = 0;
   for (int i = 0; i < thread_count; ++i) {
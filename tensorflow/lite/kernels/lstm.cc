@@ -1277,6 +1277,76 @@ TfLiteStatus PopulatePrecomputedZPTimesWeightsWithBias(TfLiteContext* context,
   return kTfLiteOk;
 }
 
+// Stacks the input-to-gate and recurrent-to-gate weights of all the gates,
+// together with their effective biases, so that the int8x8_16 kernel can
+// compute the matmuls of every gate with one GEMM per step. Leaves the fused
+// weights empty (and the kernel on its per-gate path) unless all the weights
+// are constant and dense. Must run after
+// PopulatePrecomputedZPTimesWeightsWithBias.
+TfLiteStatus PopulateFusedGateWeights(TfLiteContext* context, OpData* op_data,
+                                      TfLiteNode* node) {
+  lstm_eval::IntegerLstmParameter* integer_lstm_params =
+      &op_data->integer_lstm_param;
+  if (!integer_lstm_params->fused_input_to_gate_weights.empty()) {
+    return kTfLiteOk;
+  }
+
+  // Gates in the order used by lstm_eval::IntegerLstmParameter.
+  const TfLiteTensor* input_weights[4] = {
+      GetOptionalInputTensor(context, node, kInputToInputWeightsTensor),
+      GetOptionalInputTensor(context, node, kInputToForgetWeightsTensor),
+      GetOptionalInputTensor(context, node, kInputToCellWeightsTensor),
+      GetOptionalInputTensor(context, node, kInputToOutputWeightsTensor)};
+  const TfLiteTensor* recurrent_weights[4] = {
+      GetOptionalInputTensor(context, node, kRecurrentToInputWeightsTensor),
+      GetOptionalInputTensor(context, node, kRecurrentToForgetWeightsTensor),
+      GetOptionalInputTensor(context, node, kRecurrentToCellWeightsTensor),
+      GetOptionalInputTensor(context, node, kRecurrentToOutputWeightsTensor)};
+  const int32_t* input_biases[4] = {
+      integer_lstm_params->input_to_input_effective_bias.get(),
+      integer_lstm_params->input_to_forget_effective_bias.get(),
+      integer_lstm_params->input_to_cell_effective_bias.get(),
+      integer_lstm_params->input_to_output_effective_bias.get()};
+  const int32_t* recurrent_biases[4] = {
+      integer_lstm_params->recurrent_to_input_effective_bias.get(),
+      integer_lstm_params->recurrent_to_forget_effective_bias.get(),
+      integer_lstm_params->recurrent_to_cell_effective_bias.get(),
+      integer_lstm_params->recurrent_to_output_effective_bias.get()};
+  // Without the input gate (CIFG), stacking starts at the forget gate.
+  const int first_gate = (input_weights[0] == nullptr) ? 1 : 0;
+  for (int gate = first_gate; gate < 4; ++gate) {
+    for (const TfLiteTensor* weights :
+         {input_weights[gate], recurrent_weights[gate]}) {
+      TF_LITE_ENSURE(context, weights != nullptr);
+      if (!IsConstantTensor(weights) || weights->sparsity != nullptr) {
+        return kTfLiteOk;
+      }
+    }
+    TF_LITE_ENSURE(context, input_biases[gate] != nullptr &&
+                                recurrent_biases[gate] != nullptr);
+  }
+
+  auto stack = [first_gate](const TfLiteTensor* const* weights,
+                            const int32_t* const* bias,
+                            std::vector<int8_t>* fused_weights,
+                            std::vector<int32_t>* fused_bias) {
+    for (int gate = first_gate; gate < 4; ++gate) {
+      const int8_t* data = GetTensorData<int8_t>(weights[gate]);
+      fused_weights->insert(fused_weights->end(), data,
+                            data + NumElements(weights[gate]));
+      const int n_rows = weights[gate]->dims->data[0];
+      fused_bias->insert(fused_bias->end(), bias[gate], bias[gate] + n_rows);
+    }
+  };
+  stack(input_weights, input_biases,
+        &integer_lstm_params->fused_input_to_gate_weights,
+        &integer_lstm_params->fused_input_to_gate_effective_bias);
+  stack(recurrent_weights, recurrent_biases,
+        &integer_lstm_params->fused_recurrent_to_gate_weights,
+        &integer_lstm_params->fused_recurrent_to_gate_effective_bias);
+  return kTfLiteOk;
+}
+
 // Resize the output, state tensors based on the sizes of the input tensors.
 // Allocate a temporary scratch tensor. Also check that the sizes of the input
 // tensors match each other.
@@ -1749,9 +1819,24 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
       PopulateQuantizedLstmParams8x8_16(context, node,
                                         &op_data->integer_lstm_param);
 
+      // Populate precomputed zp * weight.
+      TF_LITE_ENSURE_OK(context, PopulatePrecomputedZPTimesWeightsWithBias(
+                                     context, op_data, node));
+      // Batched inputs compute the matmuls of all the gates together, which
+      // pays off the copy of the weights this needs.
+      if (n_batch > 1) {
+        TF_LITE_ENSURE_OK(context,
+                          PopulateFusedGateWeights(context, op_data, node));
+      }
+      const bool use_fused_gates =
+          !op_data->integer_lstm_param.fused_input_to_gate_weights.empty();
+      const int n_fused_rows =
+          op_data->integer_lstm_param.fused_input_to_gate_effective_bias.size();
+
       // Allocate scratch buffer. Need 6 16bit buffer with size n_batch * n_cell
       // and 1 8bit buffer with size n_batch * n_cell. We also need 1 32 bit
-      // buffer with size n_batch * n_cell.
+      // buffer with size n_batch * n_cell, or n_batch * n_gates * n_cell for
+      // the fused gate matmuls.
       //
       // Handle cifg case as well, which might save one buffer.
       for (int scratch_index = 0; scratch_index < 6; ++scratch_index) {
@@ -1768,21 +1853,19 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
           scratch_tensor->type = kTfLiteInt32;
         }
         scratch_tensor->allocation_type = kTfLiteArenaRw;
-        const int scratch_dimension[2] = {n_batch, n_cell};
+        const int scratch_columns =
+            (scratch_index == 5 && use_fused_gates) ? n_fused_rows : n_cell;
+        const int scratch_dimension[2] = {n_batch, scratch_columns};
         if (!TfLiteIntArrayEqualsArray(scratch_tensor->dims, 2,
                                        scratch_dimension)) {
           TfLiteIntArray* scratch_buffer_size = TfLiteIntArrayCreate(2);
           scratch_buffer_size->data[0] = n_batch;
-          scratch_buffer_size->data[1] = n_cell;
+          scratch_buffer_size->data[1] = scratch_columns;
           TF_LITE_ENSURE_OK(context,
                             context->ResizeTensor(context, scratch_tensor,
                                                   scratch_buffer_size));
         }
       }
-
-      // Populate precomputed zp * weight.
-      TF_LITE_ENSURE_OK(context, PopulatePrecomputedZPTimesWeightsWithBias(
-                                     context, op_data, node));
     } else {
       // Integer LSTM prepare function for 8x8->8.
       // This code path needs 12 intermediate tensors per Op.
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -29,6 +30,8 @@ limitations under the License.
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/kernels/cpu_backend_context.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm_params.h"
 #include "tensorflow/lite/kernels/internal/compatibility.h"
 #include "tensorflow/lite/kernels/internal/kernel_utils.h"
 #include "tensorflow/lite/kernels/internal/optimized/optimized_ops.h"
@@ -524,6 +527,53 @@ void CalculateLstmOutputHybrid(
   }
 }
 
+// Applies the peephole connection, the layer normalization and the activation
+// of a single LSTM gate whose matmuls have been accumulated into `gate`,
+// int8x8_16 version.
+void FinishLstmGateInteger8x8_16(
+    // Cell state and weights
+    const int16_t* cell_state, const int16_t* cell_to_gate_weights,
+    const int32_t cell_to_gate_scale_a, const int32_t cell_to_gate_scale_b,
+    // Layer normalization parameters (layer norm LSTM)
+    const int16_t* layer_norm_coefficients, const int32_t* layer_norm_bias,
+    const int32_t layer_norm_input_scale_a,
+    const int32_t layer_norm_input_scale_b,
+    const int32_t layer_norm_variance_guard,
+    // Array sizes
+    const int n_batch, const int n_output, const int n_cell,
+    const TfLiteFusedActivation activation,
+    // Input and output
+    int16_t* gate) {
+  const bool use_peephole = (cell_to_gate_weights != nullptr);
+  const bool use_layer_norm = (layer_norm_coefficients != nullptr);
+
+  // For each batch and cell: compute cell_weight * cell_state (peephole LSTM)
+  if (use_peephole) {
+    tensor_utils::VectorBatchVectorCwiseProductAccumulate(
+        cell_to_gate_weights, n_output, cell_state, n_batch,
+        cell_to_gate_scale_a, cell_to_gate_scale_b, gate);
+  }
+  // Do layer normalization (if layer norm LSTM)
+  if (use_layer_norm) {
+    tensor_utils::ApplyLayerNorm(
+        gate, layer_norm_coefficients, layer_norm_bias,
+        layer_norm_input_scale_a, layer_norm_input_scale_b,
+        layer_norm_variance_guard, n_batch, n_cell, gate);
+  }
+  // Apply activation
+  switch (activation) {
+    case kTfLiteActSigmoid:
+      tensor_utils::ApplySigmoid(gate, n_batch, n_cell, gate);
+      break;
+    case kTfLiteActTanh:
+      tensor_utils::ApplyTanh(3, gate, n_batch, n_cell, gate);
+      break;
+    default:
+      // Only Sigmoid or Tanh is used.
+      TFLITE_ASSERT_FALSE;
+  }
+}
+
 // Calculates a single LSTM gate, int8x8_16 version.
 // Implements the same functionality as CalculateLstmGateFloat.
 void CalculateLstmGateInteger8x8_16(
@@ -553,9 +603,6 @@ void CalculateLstmGateInteger8x8_16(
     CpuBackendContext* context,
     // Scratch arrays
     int32_t* scratch5) {
-  const bool use_peephole = (cell_to_gate_weights != nullptr);
-  const bool use_layer_norm = (layer_norm_coefficients != nullptr);
-
   // Initialize scratch buffers with zeros. Note that unlike float and hybrid
   // versions, bias is only used in layer normalization.
   std::fill_n(gate, n_batch * n_cell, 0);
@@ -571,30 +618,58 @@ void CalculateLstmGateInteger8x8_16(
       output_state, recurrent_to_gate_bias, recurrent_to_gate_weights,
       recurrent_to_gate_scale_a, recurrent_to_gate_scale_b, n_batch, n_output,
       n_cell, 0, scratch5, gate, context);
-  // For each batch and cell: compute cell_weight * cell_state (peephole LSTM)
-  if (use_peephole) {
-    tensor_utils::VectorBatchVectorCwiseProductAccumulate(
-        cell_to_gate_weights, n_output, cell_state, n_batch,
-        cell_to_gate_scale_a, cell_to_gate_scale_b, gate);
-  }
-  // Do layer normalization (if layer norm LSTM)
-  if (use_layer_norm) {
-    tensor_utils::ApplyLayerNorm(
-        gate, layer_norm_coefficients, layer_norm_bias,
-        layer_norm_input_scale_a, layer_norm_input_scale_b,
-        layer_norm_variance_guard, n_batch, n_cell, gate);
-  }
-  // Apply activation
-  switch (activation) {
-    case kTfLiteActSigmoid:
-      tensor_utils::ApplySigmoid(gate, n_batch, n_cell, gate);
-      break;
-    case kTfLiteActTanh:
-      tensor_utils::ApplyTanh(3, gate, n_batch, n_cell, gate);
-      break;
-    default:
-      // Only Sigmoid or Tanh is used.
-      TFLITE_ASSERT_FALSE;
+  FinishLstmGateInteger8x8_16(
+      cell_state, cell_to_gate_weights, cell_to_gate_scale_a,
+      cell_to_gate_scale_b, layer_norm_coefficients, layer_norm_bias,
+      layer_norm_input_scale_a, layer_norm_input_scale_b,
+      layer_norm_variance_guard, n_batch, n_output, n_cell, activation, gate);
+}
+
+// Computes the input-to-gate (or recurrent-to-gate) matmuls of `n_gates` gates
+// as a single GEMM, int8x8_16 version. `fused_weights` and `fused_bias` stack
+// the weights and effective biases of the gates, `n_cell` rows each. The
+// product for gate i is rescaled by (scale_a[i], scale_b[i]) and accumulated
+// into gates[i] with saturation, as MatrixBatchVectorMultiplyAccumulate does.
+void FusedLstmGatesMatMulInteger8x8_16(
+    const int8_t* input, const int8_t* fused_weights, const int32_t* fused_bias,
+    const int32_t* scale_a, const int32_t* scale_b, const int n_gates,
+    const int n_batch, const int n_input, const int n_cell,
+    int16_t* const* gates, int32_t* scratch, CpuBackendContext* context) {
+  const int n_rows = n_gates * n_cell;
+  cpu_backend_gemm::MatrixParams<int8_t> lhs_params;
+  lhs_params.order = cpu_backend_gemm::Order::kRowMajor;
+  lhs_params.rows = n_rows;
+  lhs_params.cols = n_input;
+  // The fused weights are built once in Prepare() and never modified.
+  lhs_params.cache_policy =
+      cpu_backend_gemm::DefaultCachePolicy(/*is_constant_data=*/true);
+  cpu_backend_gemm::MatrixParams<int8_t> rhs_params;
+  rhs_params.order = cpu_backend_gemm::Order::kColMajor;
+  rhs_params.rows = n_input;
+  rhs_params.cols = n_batch;
+  cpu_backend_gemm::MatrixParams<int32_t> dst_params;
+  dst_params.order = cpu_backend_gemm::Order::kColMajor;
+  dst_params.rows = n_rows;
+  dst_params.cols = n_batch;
+  cpu_backend_gemm::GemmParams<int32_t, int32_t> gemm_params;
+  gemm_params.bias = fused_bias;
+  cpu_backend_gemm::Gemm(lhs_params, fused_weights, rhs_params, input,
+                         dst_params, scratch, gemm_params, context);
+
+  const int32_t output_max = std::numeric_limits<int16_t>::max();
+  const int32_t output_min = std::numeric_limits<int16_t>::min();
+  for (int g = 0; g < n_gates; ++g) {
+    int16_t* gate = gates[g];
+    for (int b = 0; b < n_batch; ++b) {
+      const int32_t* acc = scratch + b * n_rows + g * n_cell;
+      for (int c = 0; c < n_cell; ++c) {
+        int32_t value =
+            MultiplyByQuantizedMultiplier(acc[c], scale_a[g], scale_b[g]);
+        value += gate[b * n_cell + c];
+        gate[b * n_cell + c] = static_cast<int16_t>(
+            std::min(std::max(value, output_min), output_max));
+      }
+    }
   }
 }
 
@@ -1345,6 +1420,13 @@ inline void LstmStepHybrid(
 //   layer_norm_output_scale_a    - optional
 //   layer_norm_output_scale_b    - optional
 //
+// Stacked gate weights (optional, see IntegerLstmParameter). When present, the
+// matmuls of all the gates are computed with one GEMM each:
+//   fused_input_to_gate_weights
+//   fused_input_to_gate_effective_bias
+//   fused_recurrent_to_gate_weights
+//   fused_recurrent_to_gate_effective_bias
+//
 // Scalar values:
 //   quantized_cell_clip: quantized clip value for cell.
 //   quantized_proj_clip: quantized clip value for projection.
@@ -1362,7 +1444,8 @@ inline void LstmStepHybrid(
 //   scratch3
 //   scratch4
 //   scratch5: this scratch buffer is created purely for optimizing the
-//              MatrixBatchVectorMultiplyAccumulate.
+//              MatrixBatchVectorMultiplyAccumulate. With the stacked gate
+//              weights, it is of size n_batch * n_gates * n_cell.
 //
 // Outputs:
 //   output_state_ptr - size 'n_batch * n_output'
@@ -1428,8 +1511,12 @@ inline void LstmStepInteger8x8_16(
     const int32_t* recurrent_to_output_effective_bias,
     const int32_t* input_to_input_effective_bias,
     const int32_t* recurrent_to_input_effective_bias,
-    const int32_t* projection_effective_bias, int n_batch, int n_cell,
-    int n_input, int n_output, int8_t* output_state_ptr,
+    const int32_t* projection_effective_bias,
+    const int8_t* fused_input_to_gate_weights,
+    const int32_t* fused_input_to_gate_effective_bias,
+    const int8_t* fused_recurrent_to_gate_weights,
+    const int32_t* fused_recurrent_to_gate_effective_bias, int n_batch,
+    int n_cell, int n_input, int n_output, int8_t* output_state_ptr,
     int32_t output_state_zp, int16_t* cell_state_ptr, int8_t* output_ptr,
     int16_t* scratch0, int16_t* scratch1, int16_t* scratch2, int16_t* scratch3,
     int8_t* scratch4, int32_t* scratch5, CpuBackendContext* context) {
@@ -1459,7 +1546,80 @@ inline void LstmStepInteger8x8_16(
   if (use_projection) {
     TFLITE_DCHECK(projection_effective_bias);
   }
-  if (!use_cifg) {
+  const bool use_fused_gates = (fused_input_to_gate_weights != nullptr);
+  if (use_fused_gates) {
+    // Compute the matmuls of all the gates at once, then the rest of the
+    // input, forget and cell gates. The matmuls of the output gate don't
+    // depend on the cell state, so only its peephole waits for the update.
+    int n_gates = 0;
+    int16_t* gates[4];
+    int32_t input_to_gate_scale_a[4];
+    int32_t input_to_gate_scale_b[4];
+    int32_t recurrent_to_gate_scale_a[4];
+    int32_t recurrent_to_gate_scale_b[4];
+    auto add_gate = [&](int16_t* gate, int32_t input_scale_a,
+                        int32_t input_scale_b, int32_t recurrent_scale_a,
+                        int32_t recurrent_scale_b) {
+      std::fill_n(gate, n_batch * n_cell, 0);
+      gates[n_gates] = gate;
+      input_to_gate_scale_a[n_gates] = input_scale_a;
+      input_to_gate_scale_b[n_gates] = input_scale_b;
+      recurrent_to_gate_scale_a[n_gates] = recurrent_scale_a;
+      recurrent_to_gate_scale_b[n_gates] = recurrent_scale_b;
+      ++n_gates;
+    };
+    if (!use_cifg) {
+      add_gate(input_gate_scratch, effective_input_to_input_scale_a,
+               effective_input_to_input_scale_b,
+               effective_recurrent_to_input_scale_a,
+               effective_recurrent_to_input_scale_b);
+    }
+    add_gate(forget_gate_scratch, effective_input_to_forget_scale_a,
+             effective_input_to_forget_scale_b,
+             effective_recurrent_to_forget_scale_a,
+             effective_recurrent_to_forget_scale_b);
+    add_gate(cell_gate_scratch, effective_input_to_cell_scale_a,
+             effective_input_to_cell_scale_b,
+             effective_recurrent_to_cell_scale_a,
+             effective_recurrent_to_cell_scale_b);
+    add_gate(output_gate_scratch, effective_input_to_output_scale_a,
+             effective_input_to_output_scale_b,
+             effective_recurrent_to_output_scale_a,
+             effective_recurrent_to_output_scale_b);
+    FusedLstmGatesMatMulInteger8x8_16(
+        input_ptr, fused_input_to_gate_weights,
+        fused_input_to_gate_effective_bias, input_to_gate_scale_a,
+        input_to_gate_scale_b, n_gates, n_batch, n_input, n_cell, gates,
+        scratch5, context);
+    FusedLstmGatesMatMulInteger8x8_16(
+        output_state_ptr, fused_recurrent_to_gate_weights,
+        fused_recurrent_to_gate_effective_bias, recurrent_to_gate_scale_a,
+        recurrent_to_gate_scale_b, n_gates, n_batch, n_output, n_cell, gates,
+        scratch5, context);
+    if (!use_cifg) {
+      FinishLstmGateInteger8x8_16(
+          cell_state_ptr, cell_to_input_weight_ptr,
+          effective_cell_to_input_scale_a, effective_cell_to_input_scale_b,
+          layer_norm_input_weight_ptr, input_gate_bias_ptr,
+          layer_norm_input_scale_a, layer_norm_input_scale_b,
+          input_variance_guard, n_batch, n_output, n_cell, kTfLiteActSigmoid,
+          input_gate_scratch);
+    }
+    FinishLstmGateInteger8x8_16(
+        cell_state_ptr, cell_to_forget_weight_ptr,
+        effective_cell_to_forget_scale_a, effective_cell_to_forget_scale_b,
+        layer_norm_forget_weight_ptr, forget_gate_bias_ptr,
+        layer_norm_forget_scale_a, layer_norm_forget_scale_b,
+        forget_variance_guard, n_batch, n_output, n_cell, kTfLiteActSigmoid,
+        forget_gate_scratch);
+    FinishLstmGateInteger8x8_16(
+        cell_state_ptr, /*cell_to_gate_weights=*/nullptr,
+        /*cell_to_gate_scale_a=*/0, /*cell_to_gate_scale_b=*/0,
+        layer_norm_cell_weight_ptr, cell_gate_bias_ptr, layer_norm_cell_scale_a,
+        layer_norm_cell_scale_b, cell_variance_guard, n_batch, n_output, n_cell,
+        kTfLiteActTanh, cell_gate_scratch);
+  }
+  if (!use_cifg && !use_fused_gates) {
     // Calculate the input gate. (If not CIFG.)
     CalculateLstmGateInteger8x8_16(
         input_ptr, input_to_input_weight_ptr, input_to_input_effective_bias,
@@ -1473,48 +1633,62 @@ inline void LstmStepInteger8x8_16(
         input_variance_guard, n_batch, n_input, n_output, n_cell,
         kTfLiteActSigmoid, input_gate_scratch, context, scratch5);
   }
-  // Calculate the forget gate.
-  CalculateLstmGateInteger8x8_16(
-      input_ptr, input_to_forget_weight_ptr, input_to_forget_effective_bias,
-      effective_input_to_forget_scale_a, effective_input_to_forget_scale_b,
-      output_state_ptr, recurrent_to_forget_weight_ptr,
-      recurrent_to_forget_effective_bias, effective_recurrent_to_forget_scale_a,
-      effective_recurrent_to_forget_scale_b, cell_state_ptr,
-      cell_to_forget_weight_ptr, effective_cell_to_forget_scale_a,
-      effective_cell_to_forget_scale_b, layer_norm_forget_weight_ptr,
-      forget_gate_bias_ptr, layer_norm_forget_scale_a,
-      layer_norm_forget_scale_b, forget_variance_guard, n_batch, n_input,
-      n_output, n_cell, kTfLiteActSigmoid, forget_gate_scratch, context,
-      scratch5);
-  // Calculate the cell update gate.
-  CalculateLstmGateInteger8x8_16(
-      input_ptr, input_to_cell_weight_ptr, input_to_cell_effective_bias,
-      effective_input_to_cell_scale_a, effective_input_to_cell_scale_b,
-      output_state_ptr, recurrent_to_cell_weight_ptr,
-      recurrent_to_cell_effective_bias, effective_recurrent_to_cell_scale_a,
-      effective_recurrent_to_cell_scale_b, cell_state_ptr,
-      /*cell_to_gate_weights=*/nullptr, /*cell_to_gate_scale_a=*/0,
-      /*cell_to_gate_scale_b=*/0, layer_norm_cell_weight_ptr,
-      cell_gate_bias_ptr, layer_norm_cell_scale_a, layer_norm_cell_scale_b,
-      cell_variance_guard, n_batch, n_input, n_output, n_cell, kTfLiteActTanh,
-      cell_gate_scratch, context, scratch5);
+  if (!use_fused_gates) {
+    // Calculate the forget gate.
+    CalculateLstmGateInteger8x8_16(
+        input_ptr, input_to_forget_weight_ptr, input_to_forget_effective_bias,
+        effective_input_to_forget_scale_a, effective_input_to_forget_scale_b,
+        output_state_ptr, recurrent_to_forget_weight_ptr,
+        recurrent_to_forget_effective_bias,
+        effective_recurrent_to_forget_scale_a,
+        effective_recurrent_to_forget_scale_b, cell_state_ptr,
+        cell_to_forget_weight_ptr, effective_cell_to_forget_scale_a,
+        effective_cell_to_forget_scale_b, layer_norm_forget_weight_ptr,
+        forget_gate_bias_ptr, layer_norm_forget_scale_a,
+        layer_norm_forget_scale_b, forget_variance_guard, n_batch, n_input,
+        n_output, n_cell, kTfLiteActSigmoid, forget_gate_scratch, context,
+        scratch5);
+    // Calculate the cell update gate.
+    CalculateLstmGateInteger8x8_16(
+        input_ptr, input_to_cell_weight_ptr, input_to_cell_effective_bias,
+        effective_input_to_cell_scale_a, effective_input_to_cell_scale_b,
+        output_state_ptr, recurrent_to_cell_weight_ptr,
+        recurrent_to_cell_effective_bias, effective_recurrent_to_cell_scale_a,
+        effective_recurrent_to_cell_scale_b, cell_state_ptr,
+        /*cell_to_gate_weights=*/nullptr, /*cell_to_gate_scale_a=*/0,
+        /*cell_to_gate_scale_b=*/0, layer_norm_cell_weight_ptr,
+        cell_gate_bias_ptr, layer_norm_cell_scale_a, layer_norm_cell_scale_b,
+        cell_variance_guard, n_batch, n_input, n_output, n_cell,
+        kTfLiteActTanh, cell_gate_scratch, context, scratch5);
+  }
   // Update the cell state.
   UpdateLstmCellInteger(n_batch, n_cell, cell_state_ptr, cell_state_scale,
                         input_gate_scratch, forget_gate_scratch,
                         cell_gate_scratch, use_cifg, quantized_cell_clip);
   // Calculate the output gate.
-  CalculateLstmGateInteger8x8_16(
-      input_ptr, input_to_output_weight_ptr, input_to_output_effective_bias,
-      effective_input_to_output_scale_a, effective_input_to_output_scale_b,
-      output_state_ptr, recurrent_to_output_weight_ptr,
-      recurrent_to_output_effective_bias, effective_recurrent_to_output_scale_a,
-      effective_recurrent_to_output_scale_b, cell_state_ptr,
-      cell_to_output_weight_ptr, effective_cell_to_output_scale_a,
-      effective_cell_to_output_scale_b, layer_norm_output_weight_ptr,
-      output_gate_bias_ptr, layer_norm_output_scale_a,
-      layer_norm_output_scale_b, output_variance_guard, n_batch, n_input,
-      n_output, n_cell, kTfLiteActSigmoid, output_gate_scratch, context,
-      scratch5);
+  if (use_fused_gates) {
+    FinishLstmGateInteger8x8_16(
+        cell_state_ptr, cell_to_output_weight_ptr,
+        effective_cell_to_output_scale_a, effective_cell_to_output_scale_b,
+        layer_norm_output_weight_ptr, output_gate_bias_ptr,
+        layer_norm_output_scale_a, layer_norm_output_scale_b,
+        output_variance_guard, n_batch, n_output, n_cell, kTfLiteActSigmoid,
+        output_gate_scratch);
+  } else {
+    CalculateLstmGateInteger8x8_16(
+        input_ptr, input_to_output_weight_ptr, input_to_output_effective_bias,
+        effective_input_to_output_scale_a, effective_input_to_output_scale_b,
+        output_state_ptr, recurrent_to_output_weight_ptr,
+        recurrent_to_output_effective_bias,
+        effective_recurrent_to_output_scale_a,
+        effective_recurrent_to_output_scale_b, cell_state_ptr,
+        cell_to_output_weight_ptr, effective_cell_to_output_scale_a,
+        effective_cell_to_output_scale_b, layer_norm_output_weight_ptr,
+        output_gate_bias_ptr, layer_norm_output_scale_a,
+        layer_norm_output_scale_b, output_variance_guard, n_batch, n_input,
+        n_output, n_cell, kTfLiteActSigmoid, output_gate_scratch, context,
+        scratch5);
+  }
   // Update the output state.
   CalculateLstmOutputInteger8x8_16(
       n_batch, n_cell, n_output, cell_state_ptr, cell_state_scale,
@@ -2258,6 +2432,25 @@ TfLiteStatus EvalInteger8x8_16(
   const int output_batch_leading_dim =
       output->dims->data[output->dims->size - 1];
 
+  // The stacked gate weights, if they were prepared.
+  const bool use_fused_gates =
+      !integer_lstm_param->fused_input_to_gate_weights.empty();
+  const int8_t* fused_input_to_gate_weights =
+      use_fused_gates ? integer_lstm_param->fused_input_to_gate_weights.data()
+                      : nullptr;
+  const int32_t* fused_input_to_gate_effective_bias =
+      use_fused_gates
+          ? integer_lstm_param->fused_input_to_gate_effective_bias.data()
+          : nullptr;
+  const int8_t* fused_recurrent_to_gate_weights =
+      use_fused_gates
+          ? integer_lstm_param->fused_recurrent_to_gate_weights.data()
+          : nullptr;
+  const int32_t* fused_recurrent_to_gate_effective_bias =
+      use_fused_gates
+          ? integer_lstm_param->fused_recurrent_to_gate_effective_bias.data()
+          : nullptr;
+
   if (time_major) {
     const int input_step = n_batch * n_input;
     const int output_step = n_batch * output_batch_leading_dim;
@@ -2337,8 +2530,11 @@ TfLiteStatus EvalInteger8x8_16(
           integer_lstm_param->recurrent_to_output_effective_bias.get(),
           integer_lstm_param->input_to_input_effective_bias.get(),
           integer_lstm_param->recurrent_to_input_effective_bias.get(),
-          integer_lstm_param->projection_effective_bias.get(), n_batch, n_cell,
-          n_input, n_output, GetTensorData<int8_t>(output_state),
+          integer_lstm_param->projection_effective_bias.get(),
+          fused_input_to_gate_weights, fused_input_to_gate_effective_bias,
+          fused_recurrent_to_gate_weights,
+          fused_recurrent_to_gate_effective_bias, n_batch, n_cell, n_input,
+          n_output, GetTensorData<int8_t>(output_state),
           output_state_zp, GetTensorData<int16_t>(cell_state), output_ptr,
           GetTensorData<int16_t>(scratch0), GetTensorData<int16_t>(scratch1),
           GetTensorData<int16_t>(scratch2), GetTensorData<int16_t>(scratch3),
@@ -2436,8 +2632,11 @@ TfLiteStatus EvalInteger8x8_16(
             integer_lstm_param->recurrent_to_output_effective_bias.get(),
             integer_lstm_param->input_to_input_effective_bias.get(),
             integer_lstm_param->recurrent_to_input_effective_bias.get(),
-            integer_lstm_param->projection_effective_bias.get(), /*n_batch=*/1,
-            n_cell, n_input, n_output, output_state_ptr, output_state_zp,
+            integer_lstm_param->projection_effective_bias.get(),
+            fused_input_to_gate_weights, fused_input_to_gate_effective_bias,
+            fused_recurrent_to_gate_weights,
+            fused_recurrent_to_gate_effective_bias, /*n_batch=*/1, n_cell,
+            n_input, n_output, output_state_ptr, output_state_zp,
             cell_state_ptr, output_ptr, GetTensorData<int16_t>(scratch0),
             GetTensorData<int16_t>(scratch1), GetTensorData<int16_t>(scratch2),
             GetTensorData<int16_t>(scratch3), GetTensorData<int8_t>(scratch4),
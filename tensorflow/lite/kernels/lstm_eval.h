@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
@@ -88,6 +89,16 @@ struct IntegerLstmParameter {
   std::unique_ptr<int32_t[]> recurrent_to_input_effective_bias;
   std::unique_ptr<int32_t[]> projection_effective_bias;
 
+  // The input-to-gate and recurrent-to-gate weights of all the gates, with
+  // their effective biases, stacked in the order input (unless CIFG), forget,
+  // cell, output. When populated, the 8x8_16 step computes the matmuls of all
+  // the gates with one GEMM per operand, and needs scratch5 to hold
+  // n_batch * n_gates * n_cell values.
+  std::vector<int8_t> fused_input_to_gate_weights;
+  std::vector<int32_t> fused_input_to_gate_effective_bias;
+  std::vector<int8_t> fused_recurrent_to_gate_weights;
+  std::vector<int32_t> fused_recurrent_to_gate_effective_bias;
+
   // Scale and zero point for intermediate tensors.
   // Used only in the 8x8_8 case.
   int32_t intermediate_scale_a[8];
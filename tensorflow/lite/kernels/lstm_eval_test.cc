@@ -18,6 +18,7 @@ limitations under the License.
 #include <stdlib.h>
 
 #include <algorithm>
+#include <initializer_list>
 #include <memory>
 #include <vector>
 
@@ -462,6 +463,41 @@ class QuantizedLstmParam : public BaseLstmParam {
     return &integer_lstm_param_;
   }
 
+  // Stacks the gate weights and effective biases the way lstm.cc does for
+  // batched inputs, so that the kernel computes the matmuls of all the gates
+  // together.
+  void FuseGateWeights() {
+    ops::builtin::lstm_eval::IntegerLstmParameter* param = GetQuantParam();
+    auto stack = [this](std::initializer_list<const std::vector<int8_t>*>
+                            weights,
+                        std::initializer_list<const int32_t*> biases,
+                        std::vector<int8_t>* fused_weights,
+                        std::vector<int32_t>* fused_bias) {
+      for (const std::vector<int8_t>* gate_weights : weights) {
+        fused_weights->insert(fused_weights->end(), gate_weights->begin(),
+                              gate_weights->end());
+      }
+      for (const int32_t* gate_bias : biases) {
+        fused_bias->insert(fused_bias->end(), gate_bias, gate_bias + n_cell_);
+      }
+    };
+    stack({&i2i_, &i2f_, &i2c_, &i2o_},
+          {param->input_to_input_effective_bias.get(),
+           param->input_to_forget_effective_bias.get(),
+           param->input_to_cell_effective_bias.get(),
+           param->input_to_output_effective_bias.get()},
+          &param->fused_input_to_gate_weights,
+          &param->fused_input_to_gate_effective_bias);
+    stack({&r2i_, &r2f_, &r2c_, &r2o_},
+          {param->recurrent_to_input_effective_bias.get(),
+           param->recurrent_to_forget_effective_bias.get(),
+           param->recurrent_to_cell_effective_bias.get(),
+           param->recurrent_to_output_effective_bias.get()},
+          &param->fused_recurrent_to_gate_weights,
+          &param->fused_recurrent_to_gate_effective_bias);
+    scratch5_size_ = {n_batch_, 4 * n_cell_};
+  }
+
   // Create scratch buffers.
   TfLiteTensor* GetScratch0() {
     PackWeightToTensor(&scratch0_tensor_, scratch0_, scratch0_size_);
@@ -601,9 +637,12 @@ class QuantizedLstmParam : public BaseLstmParam {
   TfLiteTensor scratch5_tensor_;
 };
 
-void TestOneFullyQuantizedLSTM() {
+void TestOneFullyQuantizedLSTM(bool fuse_gates) {
   CpuBackendContext context;
   QuantizedLstmParam one_parameter;
+  if (fuse_gates) {
+    one_parameter.FuseGateWeights();
+  }
   auto activation = one_parameter.GetActivation();
   auto output = one_parameter.GetOutput();
   auto cell = one_parameter.GetCell();
@@ -636,7 +675,11 @@ void TestOneFullyQuantizedLSTM() {
 }
 
 TEST(TestOneFullyQuantizedLSTM, TestOneFullyQuantizedLSTM) {
-  TestOneFullyQuantizedLSTM();
+  TestOneFullyQuantizedLSTM(/*fuse_gates=*/false);
+}
+
+TEST(TestOneFullyQuantizedLSTM, TestOneFullyQuantizedLSTMWithFusedGates) {
+  TestOneFullyQuantizedLSTM(/*fuse_gates=*/true);
 }
 
 class HybridLstmParam : public BaseLstmParam {
@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_MEMORY_PLANNER_H_
 #define TENSORFLOW_LITE_MEMORY_PLANNER_H_
 
+#include <cstddef>
 #include <vector>
 
 #include "tensorflow/lite/c/common.h"
@@ -65,6 +66,13 @@ class MemoryPlanner {
   // Dumps the memory planning information against the specified op node
   // execution plan (i.e. `execution_plan`) for the purpose of debugging.
   virtual void DumpDebugInfo(const std::vector<int>& execution_plan) const = 0;
+
+  // Fills `high_water_marks` with, for each node of the execution plan, the
+  // number of bytes of the kTfLiteArenaRw arena spanned by the tensors that are
+  // allocated while the node runs. Leaves it empty if the planner doesn't
+  // allocate from an arena.
+  virtual void GetArenaHighWaterMarks(
+      std::vector<size_t>* high_water_marks) const = 0;
 };
 
 }  // namespace tflite
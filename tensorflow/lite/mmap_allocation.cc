@@ -20,6 +20,7 @@ limitations under the License.
 #include <unistd.h>
 
 #include <cerrno>
+#include <cstdint>
 
 #include "tensorflow/lite/allocation.h"
 #include "tensorflow/lite/core/api/error_reporter.h"
@@ -27,6 +28,15 @@ limitations under the License.
 namespace tflite {
 namespace {
 
+size_t GetPageSize() {
+#ifdef __ANDROID__
+  static const size_t pagesize = getpagesize();
+#else
+  static const size_t pagesize = sysconf(_SC_PAGE_SIZE);
+#endif
+  return pagesize;
+}
+
 size_t GetFdSizeBytes(int fd) {
   if (fd < 0) {
     return 0;
@@ -81,13 +91,7 @@ MMAPAllocation::MMAPAllocation(ErrorReporter* error_reporter, int owned_fd,
     return;
   }
 
-#ifdef __ANDROID__
-  static int pagesize = getpagesize();
-#else
-  static int pagesize = sysconf(_SC_PAGE_SIZE);
-#endif
-
-  offset_in_buffer_ = offset % pagesize;
+  offset_in_buffer_ = offset % GetPageSize();
 
   size_t file_size = GetFdSizeBytes(mmap_fd_);
   if (length + offset > file_size) {
@@ -128,6 +132,40 @@ size_t MMAPAllocation::bytes() const { return buffer_size_bytes_; }
 
 bool MMAPAllocation::valid() const { return mmapped_buffer_ != MAP_FAILED; }
 
+bool MMAPAllocation::Advise(const void* data, size_t bytes,
+                            Advice advice) const {
+  if (!valid()) {
+    return false;
+  }
+  const uintptr_t mapped_begin = reinterpret_cast<uintptr_t>(mmapped_buffer_);
+  const uintptr_t mapped_end =
+      mapped_begin + offset_in_buffer_ + buffer_size_bytes_;
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(data);
+  if (begin < mapped_begin || bytes > mapped_end - begin) {
+    return false;
+  }
+  // The mapping starts on a page boundary, so rounding down stays inside it.
+  const uintptr_t page_begin = begin - (begin - mapped_begin) % GetPageSize();
+
+  int native_advice = MADV_NORMAL;
+  switch (advice) {
+    case Advice::kNormal:
+      native_advice = MADV_NORMAL;
+      break;
+    case Advice::kRandom:
+      native_advice = MADV_RANDOM;
+      break;
+    case Advice::kWillNeed:
+      native_advice = MADV_WILLNEED;
+      break;
+    case Advice::kDontNeed:
+      native_advice = MADV_DONTNEED;
+      break;
+  }
+  return madvise(reinterpret_cast<void*>(page_begin),
+                 begin + bytes - page_begin, native_advice) == 0;
+}
+
 bool MMAPAllocation::IsSupported() { return true; }
 
 }  // namespace tflite
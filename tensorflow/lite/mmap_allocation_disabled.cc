@@ -41,6 +41,11 @@ size_t MMAPAllocation::bytes() const { return 0; }
 
 bool MMAPAllocation::valid() const { return false; }
 
+bool MMAPAllocation::Advise(const void* data, size_t bytes,
+                            Advice advice) const {
+  return false;
+}
+
 bool MMAPAllocation::IsSupported() { return false; }
 
 }  // namespace tflite
@@ -17,6 +17,7 @@ limitations under the License.
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -109,9 +110,11 @@ std::unique_ptr<FlatBufferModel> FlatBufferModel::VerifyAndBuildFromAllocation(
     return nullptr;
   }
 
+  // The flatbuffer itself is limited to 2GB: only buffer data stored after it
+  // (see Buffer.offset in the schema) can make the model larger.
   flatbuffers::Verifier base_verifier(
       reinterpret_cast<const uint8_t*>(allocation->base()),
-      allocation->bytes());
+      std::min<size_t>(allocation->bytes(), FLATBUFFERS_MAX_BUFFER_SIZE - 1));
   if (!VerifyModelBuffer(base_verifier)) {
     TF_LITE_REPORT_ERROR(error_reporter,
                          "The model is not a valid Flatbuffer buffer");
@@ -267,6 +267,71 @@ TEST(BasicFlatBufferModel, TestModelInInterpreter) {
   }
 }
 
+// Returns `model` serialized with the data of its buffer `buffer_index` stored
+// after the flatbuffer.
+std::string SerializeWithBufferAfterFlatbuffer(ModelT* model,
+                                               int buffer_index) {
+  BufferT* buffer = model->buffers[buffer_index].get();
+  const std::vector<uint8_t> data = std::move(buffer->data);
+  buffer->data.clear();
+  buffer->size = data.size();
+  // The offset doesn't change the size of the flatbuffer, which is built once
+  // first to find where the data goes.
+  buffer->offset = 1;
+  flatbuffers::FlatBufferBuilder builder;
+  FinishModelBuffer(builder, Model::Pack(builder, model));
+  const uint64_t offset = (builder.GetSize() + 15) / 16 * 16;
+  builder.Clear();
+  buffer->offset = offset;
+  FinishModelBuffer(builder, Model::Pack(builder, model));
+  EXPECT_LE(builder.GetSize(), offset);
+
+  std::string serialized(
+      reinterpret_cast<const char*>(builder.GetBufferPointer()),
+      builder.GetSize());
+  serialized.resize(offset, '\0');
+  serialized.append(data.begin(), data.end());
+  return serialized;
+}
+
+TEST(BasicFlatBufferModel, TestBufferAfterFlatbuffer) {
+  std::ifstream file("tensorflow/lite/testdata/test_model.bin",
+                     std::ios::binary);
+  const std::string original((std::istreambuf_iterator<char>(file)),
+                             std::istreambuf_iterator<char>());
+  ASSERT_FALSE(original.empty());
+  std::unique_ptr<ModelT> model(GetModel(original.data())->UnPack());
+  // Tensor 0 is a constant.
+  const int buffer_index = model->subgraphs[0]->tensors[0]->buffer;
+  const std::vector<uint8_t> data = model->buffers[buffer_index]->data;
+  ASSERT_FALSE(data.empty());
+  const std::string serialized =
+      SerializeWithBufferAfterFlatbuffer(model.get(), buffer_index);
+
+  auto flatbuffer_model =
+      FlatBufferModel::BuildFromBuffer(serialized.data(), serialized.size());
+  ASSERT_TRUE(flatbuffer_model);
+  std::unique_ptr<Interpreter> interpreter;
+  ASSERT_EQ(InterpreterBuilder(*flatbuffer_model,
+                               TrivialResolver(&dummy_reg))(&interpreter),
+            kTfLiteOk);
+  TfLiteTensor* constant = interpreter->tensor(0);
+  ASSERT_EQ(constant->allocation_type, kTfLiteMmapRo);
+  ASSERT_EQ(constant->bytes, data.size());
+  EXPECT_EQ(constant->data.raw,
+            serialized.data() + serialized.size() - data.size());
+  EXPECT_EQ(memcmp(constant->data.raw, data.data(), data.size()), 0);
+
+  // The data must be in the model.
+  const std::string truncated = serialized.substr(0, serialized.size() - 1);
+  auto truncated_model =
+      FlatBufferModel::BuildFromBuffer(truncated.data(), truncated.size());
+  ASSERT_TRUE(truncated_model);
+  EXPECT_EQ(InterpreterBuilder(*truncated_model,
+                               TrivialResolver(&dummy_reg))(&interpreter),
+            kTfLiteError);
+}
+
 TEST(BasicFlatBufferModel, TestWithNumThreads) {
   TestErrorReporter reporter;
   auto model = FlatBufferModel::BuildFromFile(
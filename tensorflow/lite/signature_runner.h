@@ -130,6 +130,26 @@ class SignatureRunner {
   /// Updates allocations for all tensors, related to the given signature.
   TfLiteStatus AllocateTensors() { return subgraph_->AllocateTensors(); }
 
+  /// Binds the input tensor identified by `input_name` to the user-provided
+  /// buffer in `allocation`, so that it is read in place without copying the
+  /// input data into the arena. See
+  /// Interpreter::SetCustomAllocationForTensor for the requirements on
+  /// `allocation` and the meaning of `flags`.
+  ///
+  /// The buffer can be re-bound between invocations (e.g. to the next camera
+  /// frame) without re-planning the arena, as long as it is large enough for
+  /// the current shape of the tensor.
+  TfLiteStatus SetCustomAllocationForInputTensor(
+      const char* input_name, const TfLiteCustomAllocation& allocation,
+      int64_t flags = kTfLiteCustomAllocationFlagsNone);
+
+  /// Same as SetCustomAllocationForInputTensor, for the output tensor
+  /// identified by `output_name`, into which the results are then written in
+  /// place.
+  TfLiteStatus SetCustomAllocationForOutputTensor(
+      const char* output_name, const TfLiteCustomAllocation& allocation,
+      int64_t flags = kTfLiteCustomAllocationFlagsNone);
+
   /// Invokes the signature runner (run the graph identified by the given
   /// signature in dependency order).
   TfLiteStatus Invoke();
@@ -76,6 +76,20 @@ class SimpleMemoryArena {
                         int32_t tensor, int32_t first_node, int32_t last_node,
                         ArenaAllocWithUsageInterval* new_alloc);
 
+  // Returns true if an allocation of `size` bytes at `offset`, used from
+  // first_node to last_node, doesn't overlap any scheduled allocation whose
+  // usage interval intersects it.
+  bool CanAllocateAt(size_t offset, size_t size, int32_t first_node,
+                     int32_t last_node) const;
+
+  // Same as Allocate(), but places the allocation at a given `offset`, e.g. one
+  // planned offline. `offset` must be a multiple of `alignment`, and
+  // CanAllocateAt() must hold.
+  TfLiteStatus AllocateAt(TfLiteContext* context, size_t alignment,
+                          size_t offset, size_t size, int32_t tensor,
+                          int32_t first_node, int32_t last_node,
+                          ArenaAllocWithUsageInterval* new_alloc);
+
   TfLiteStatus Deallocate(TfLiteContext* context,
                           const ArenaAllocWithUsageInterval& alloc);
 
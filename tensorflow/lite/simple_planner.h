@@ -91,6 +91,10 @@ class SimplePlanner : public MemoryPlanner {
   TfLiteStatus AcquireNonPersistentMemory() override;
   bool HasNonPersistentMemory() override { return true; };
   void DumpDebugInfo(const std::vector<int>& execution_plan) const override{};
+  void GetArenaHighWaterMarks(
+      std::vector<size_t>* high_water_marks) const override {
+    high_water_marks->clear();
+  }
 
  private:
   // Free all the all allocations.
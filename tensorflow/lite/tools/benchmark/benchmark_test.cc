@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <utility>
@@ -226,6 +227,25 @@ TEST(BenchmarkTest, DoesntCrashMultiPerfOptionsWithProfiling) {
   all_options_benchmark.Run();
 }
 
+TEST(BenchmarkTest, WritesJsonProfile) {
+  ASSERT_THAT(g_fp32_model_path, testing::NotNull());
+  const std::string json_file_path = ::testing::TempDir() + "/profile.json";
+  BenchmarkParams params = CreateFp32Params();
+  params.Set<bool>("enable_op_profiling", true);
+  params.Set<std::string>("profiling_output_json_file", json_file_path);
+  params.Set<bool>("enable_perf_event_counters", true);
+  TestBenchmark benchmark(std::move(params));
+  EXPECT_EQ(benchmark.Run(), kTfLiteOk);
+
+  std::ifstream json_file(json_file_path);
+  ASSERT_TRUE(json_file.good());
+  const std::string json((std::istreambuf_iterator<char>(json_file)),
+                         std::istreambuf_iterator<char>());
+  EXPECT_THAT(json, testing::HasSubstr("\"p50_us\""));
+  EXPECT_THAT(json, testing::HasSubstr("\"p99_us\""));
+  EXPECT_THAT(json, testing::HasSubstr("\"arena_high_water_bytes\""));
+}
+
 TEST(BenchmarkTest, DoesntCrashWithExplicitInputFp32Model) {
   ASSERT_THAT(g_fp32_model_path, testing::NotNull());
 
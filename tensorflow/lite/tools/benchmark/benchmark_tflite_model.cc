@@ -327,6 +327,10 @@ BenchmarkParams BenchmarkTfLiteModel::DefaultParams() {
                           BenchmarkParam::Create<bool>(false));
   default_params.AddParam("profiling_output_csv_file",
                           BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("profiling_output_json_file",
+                          BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("enable_perf_event_counters",
+                          BenchmarkParam::Create<bool>(false));
 
   default_params.AddParam("print_preinvoke_state",
                           BenchmarkParam::Create<bool>(false));
@@ -398,6 +402,13 @@ std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
           "profiling_output_csv_file", &params_,
           "File path to export profile data as CSV, if not set "
           "prints to stdout."),
+      CreateFlag<std::string>(
+          "profiling_output_json_file", &params_,
+          "File path to export the per-op latency percentiles and the arena "
+          "high-water mark of each node as JSON."),
+      CreateFlag<bool>("enable_perf_event_counters", &params_,
+                       "export the hardware performance counters of the "
+                       "benchmark thread to the JSON profile (Linux only)"),
       CreateFlag<bool>(
           "print_preinvoke_state", &params_,
           "print out the interpreter internals just before calling Invoke. The "
@@ -447,6 +458,10 @@ void BenchmarkTfLiteModel::LogParams() {
                       verbose);
   LOG_BENCHMARK_PARAM(std::string, "profiling_output_csv_file",
                       "CSV File to export profiling data to", verbose);
+  LOG_BENCHMARK_PARAM(std::string, "profiling_output_json_file",
+                      "JSON File to export profiling data to", verbose);
+  LOG_BENCHMARK_PARAM(bool, "enable_perf_event_counters",
+                      "Enable perf event counters", verbose);
   LOG_BENCHMARK_PARAM(bool, "print_preinvoke_state",
                       "Print pre-invoke interpreter state", verbose);
   LOG_BENCHMARK_PARAM(bool, "print_postinvoke_state",
@@ -828,7 +843,9 @@ BenchmarkTfLiteModel::MayCreateProfilingListener() const {
       params_.Get<bool>("allow_dynamic_profiling_buffer_increase"),
       params_.Get<std::string>("profiling_output_csv_file"),
       CreateProfileSummaryFormatter(
-          !params_.Get<std::string>("profiling_output_csv_file").empty())));
+          !params_.Get<std::string>("profiling_output_csv_file").empty()),
+      params_.Get<std::string>("profiling_output_json_file"),
+      params_.Get<bool>("enable_perf_event_counters")));
 }
 
 TfLiteStatus BenchmarkTfLiteModel::RunImpl() { return interpreter_->Invoke(); }
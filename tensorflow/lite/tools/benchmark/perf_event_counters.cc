@@ -0,0 +1,112 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/tools/benchmark/perf_event_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+namespace tflite {
+namespace benchmark {
+
+#ifdef __linux__
+
+namespace {
+
+int OpenHardwareCounter(uint64_t config) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return syscall(__NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                 /*group_fd=*/-1, /*flags=*/0);
+}
+
+}  // namespace
+
+PerfEventCounters::PerfEventCounters() {
+  const std::pair<const char*, uint64_t> kCounters[] = {
+      {"cpu_cycles", PERF_COUNT_HW_CPU_CYCLES},
+      {"instructions", PERF_COUNT_HW_INSTRUCTIONS},
+      {"cache_references", PERF_COUNT_HW_CACHE_REFERENCES},
+      {"cache_misses", PERF_COUNT_HW_CACHE_MISSES},
+      {"branch_misses", PERF_COUNT_HW_BRANCH_MISSES},
+  };
+  for (const auto& counter : kCounters) {
+    const int fd = OpenHardwareCounter(counter.second);
+    if (fd >= 0) {
+      counters_.push_back({counter.first, fd});
+    }
+  }
+}
+
+PerfEventCounters::~PerfEventCounters() {
+  for (const Counter& counter : counters_) {
+    close(counter.fd);
+  }
+}
+
+void PerfEventCounters::Start() {
+  for (const Counter& counter : counters_) {
+    ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+void PerfEventCounters::Stop() {
+  for (const Counter& counter : counters_) {
+    ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+  }
+}
+
+std::vector<std::pair<std::string, uint64_t>> PerfEventCounters::Read() const {
+  std::vector<std::pair<std::string, uint64_t>> values;
+  for (const Counter& counter : counters_) {
+    uint64_t value = 0;
+    if (read(counter.fd, &value, sizeof(value)) == sizeof(value)) {
+      values.emplace_back(counter.name, value);
+    }
+  }
+  return values;
+}
+
+#else  // __linux__
+
+PerfEventCounters::PerfEventCounters() {}
+
+PerfEventCounters::~PerfEventCounters() {}
+
+void PerfEventCounters::Start() {}
+
+void PerfEventCounters::Stop() {}
+
+std::vector<std::pair<std::string, uint64_t>> PerfEventCounters::Read() const {
+  return {};
+}
+
+#endif  // __linux__
+
+}  // namespace benchmark
+}  // namespace tflite
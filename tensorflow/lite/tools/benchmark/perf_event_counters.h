@@ -0,0 +1,64 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_TOOLS_BENCHMARK_PERF_EVENT_COUNTERS_H_
+#define TENSORFLOW_LITE_TOOLS_BENCHMARK_PERF_EVENT_COUNTERS_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tflite {
+namespace benchmark {
+
+// Hardware performance counters (cycles, instructions, cache and branch
+// misses) of the calling thread, read through perf_event_open(2). Counters are
+// only available on Linux, and only the ones the kernel lets the process open
+// (see /proc/sys/kernel/perf_event_paranoid); elsewhere Read() returns nothing.
+// Work done on other threads, e.g. by a multi-threaded kernel, isn't counted.
+class PerfEventCounters {
+ public:
+  PerfEventCounters();
+  ~PerfEventCounters();
+
+  PerfEventCounters(const PerfEventCounters&) = delete;
+  PerfEventCounters& operator=(const PerfEventCounters&) = delete;
+
+  // Returns true if at least one counter could be opened.
+  bool IsSupported() const { return !counters_.empty(); }
+
+  // Resets the counters and starts counting.
+  void Start();
+
+  // Stops counting.
+  void Stop();
+
+  // Returns the name and value of every counter, as counted between the last
+  // calls to Start() and Stop().
+  std::vector<std::pair<std::string, uint64_t>> Read() const;
+
+ private:
+  struct Counter {
+    std::string name;
+    int fd;
+  };
+  std::vector<Counter> counters_;
+};
+
+}  // namespace benchmark
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_TOOLS_BENCHMARK_PERF_EVENT_COUNTERS_H_
@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/lite/tools/benchmark/profiling_listener.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <fstream>
 #include <string>
 
@@ -22,18 +25,54 @@ limitations under the License.
 
 namespace tflite {
 namespace benchmark {
+namespace {
+
+// Returns the JSON string literal for `str`.
+std::string ToJsonString(const std::string& str) {
+  std::string json = "\"";
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      json += '\\';
+      json += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[7];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      json += escaped;
+    } else {
+      json += c;
+    }
+  }
+  return json + "\"";
+}
+
+// Returns the nearest-rank `percentile` of the sorted `values`.
+int64_t Percentile(const std::vector<int64_t>& values, double percentile) {
+  const int rank = std::ceil(percentile / 100.0 * values.size());
+  return values[std::max(rank, 1) - 1];
+}
+
+}  // namespace
 
 ProfilingListener::ProfilingListener(
     Interpreter* interpreter, uint32_t max_num_initial_entries,
     bool allow_dynamic_buffer_increase, const std::string& csv_file_path,
-    std::shared_ptr<profiling::ProfileSummaryFormatter> summarizer_formatter)
+    std::shared_ptr<profiling::ProfileSummaryFormatter> summarizer_formatter,
+    const std::string& json_file_path, bool enable_perf_event_counters)
     : run_summarizer_(summarizer_formatter),
       init_summarizer_(summarizer_formatter),
       csv_file_path_(csv_file_path),
       interpreter_(interpreter),
-      profiler_(max_num_initial_entries, allow_dynamic_buffer_increase) {
+      profiler_(max_num_initial_entries, allow_dynamic_buffer_increase),
+      json_file_path_(json_file_path) {
   TFLITE_TOOLS_CHECK(interpreter);
   interpreter_->SetProfiler(&profiler_);
+  if (enable_perf_event_counters) {
+    perf_event_counters_ = std::make_unique<PerfEventCounters>();
+    if (!perf_event_counters_->IsSupported()) {
+      TFLITE_LOG(WARN) << "Hardware performance counters are not available.";
+      perf_event_counters_.reset();
+    }
+  }
 
   // We start profiling here in order to catch events that are recorded during
   // the benchmark run preparation stage where TFLite interpreter is
@@ -56,13 +95,42 @@ void ProfilingListener::OnSingleRunStart(RunType run_type) {
   if (run_type == REGULAR) {
     profiler_.Reset();
     profiler_.StartProfiling();
+    if (perf_event_counters_) {
+      perf_event_counters_->Start();
+      perf_event_counters_running_ = true;
+    }
   }
 }
 
 void ProfilingListener::OnSingleRunEnd() {
+  if (perf_event_counters_running_) {
+    perf_event_counters_->Stop();
+    perf_event_counters_running_ = false;
+    for (const auto& counter : perf_event_counters_->Read()) {
+      perf_event_counter_totals_[counter.first] += counter.second;
+    }
+    ++num_counted_runs_;
+  }
   profiler_.StopProfiling();
   auto profile_events = profiler_.GetProfileEvents();
   run_summarizer_.ProcessProfiles(profile_events, *interpreter_);
+  if (!json_file_path_.empty()) {
+    RecordOperatorLatencies(profile_events);
+  }
+}
+
+void ProfilingListener::RecordOperatorLatencies(
+    const std::vector<const profiling::ProfileEvent*>& profile_events) {
+  for (const profiling::ProfileEvent* event : profile_events) {
+    if (event->event_type != Profiler::EventType::OPERATOR_INVOKE_EVENT) {
+      continue;
+    }
+    // See ProfileSummarizer::ProcessProfiles() for the event metadata.
+    OperatorLatencies& latencies =
+        op_latencies_[{event->extra_event_metadata, event->event_metadata}];
+    if (latencies.type.empty()) latencies.type = event->tag;
+    latencies.elapsed_us.push_back(event->elapsed_time);
+  }
 }
 
 void ProfilingListener::OnBenchmarkEnd(const BenchmarkResults& results) {
@@ -81,6 +149,64 @@ void ProfilingListener::OnBenchmarkEnd(const BenchmarkResults& results) {
                 run_summarizer_.GetOutputString(),
                 output_stream == nullptr ? &TFLITE_LOG(INFO) : output_stream);
   }
+  if (!json_file_path_.empty()) {
+    std::ofstream json_file(json_file_path_);
+    if (json_file.good()) {
+      WriteJsonOutput(&json_file);
+    } else {
+      TFLITE_LOG(ERROR) << "Failed to open " << json_file_path_
+                        << " for writing the profiling data.";
+    }
+  }
+}
+
+void ProfilingListener::WriteJsonOutput(std::ostream* stream) const {
+  (*stream) << "{\n  \"operators\": [";
+  bool first = true;
+  for (const auto& op_latencies : op_latencies_) {
+    std::vector<int64_t> elapsed_us = op_latencies.second.elapsed_us;
+    std::sort(elapsed_us.begin(), elapsed_us.end());
+    int64_t total_us = 0;
+    for (const int64_t us : elapsed_us) total_us += us;
+    (*stream) << (first ? "\n" : ",\n") << "    {\"subgraph\": "
+              << op_latencies.first.first
+              << ", \"node\": " << op_latencies.first.second
+              << ", \"type\": " << ToJsonString(op_latencies.second.type)
+              << ", \"count\": " << elapsed_us.size() << ", \"avg_us\": "
+              << static_cast<double>(total_us) / elapsed_us.size()
+              << ", \"p50_us\": " << Percentile(elapsed_us, 50)
+              << ", \"p90_us\": " << Percentile(elapsed_us, 90)
+              << ", \"p99_us\": " << Percentile(elapsed_us, 99) << "}";
+    first = false;
+  }
+  (*stream) << "\n  ],\n  \"memory\": [";
+  std::vector<size_t> high_water_marks;
+  const int num_subgraphs = interpreter_->subgraphs_size();
+  for (int i = 0; i < num_subgraphs; ++i) {
+    const Subgraph& subgraph = *interpreter_->subgraph(i);
+    subgraph.GetArenaHighWaterMarks(&high_water_marks);
+    (*stream) << (i == 0 ? "\n" : ",\n") << "    {\"subgraph\": " << i
+              << ", \"nodes\": [";
+    for (int j = 0; j < static_cast<int>(high_water_marks.size()); ++j) {
+      (*stream) << (j == 0 ? "" : ", ")
+                << "{\"node\": " << subgraph.execution_plan()[j]
+                << ", \"arena_high_water_bytes\": " << high_water_marks[j]
+                << "}";
+    }
+    (*stream) << "]}";
+  }
+  (*stream) << "\n  ]";
+  if (num_counted_runs_ > 0) {
+    (*stream) << ",\n  \"perf_event_counters_per_run\": {";
+    first = true;
+    for (const auto& counter : perf_event_counter_totals_) {
+      (*stream) << (first ? "" : ", ") << ToJsonString(counter.first) << ": "
+                << static_cast<double>(counter.second) / num_counted_runs_;
+      first = false;
+    }
+    (*stream) << "}";
+  }
+  (*stream) << "\n}\n";
 }
 
 void ProfilingListener::WriteOutput(const std::string& header,
@@ -16,25 +16,37 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_TOOLS_BENCHMARK_PROFILING_LISTENER_H_
 #define TENSORFLOW_LITE_TOOLS_BENCHMARK_PROFILING_LISTENER_H_
 
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "tensorflow/lite/profiling/buffered_profiler.h"
 #include "tensorflow/lite/profiling/profile_summarizer.h"
 #include "tensorflow/lite/profiling/profile_summary_formatter.h"
 #include "tensorflow/lite/tools/benchmark/benchmark_model.h"
+#include "tensorflow/lite/tools/benchmark/perf_event_counters.h"
 
 namespace tflite {
 namespace benchmark {
 
 // Dumps profiling events if profiling is enabled.
+//
+// If `json_file_path` is set, the per-operator latency distribution of the
+// regular runs (mean, p50, p90 and p99) and the arena high-water mark of every
+// node are also written to it as JSON, together with the mean of the hardware
+// performance counters per run if `enable_perf_event_counters` is set.
 class ProfilingListener : public BenchmarkListener {
  public:
   ProfilingListener(
       Interpreter* interpreter, uint32_t max_num_initial_entries,
       bool allow_dynamic_buffer_increase, const std::string& csv_file_path = "",
       std::shared_ptr<profiling::ProfileSummaryFormatter> summarizer_formatter =
-          std::make_shared<profiling::ProfileSummaryDefaultFormatter>());
+          std::make_shared<profiling::ProfileSummaryDefaultFormatter>(),
+      const std::string& json_file_path = "",
+      bool enable_perf_event_counters = false);
 
   void OnBenchmarkStart(const BenchmarkParams& params) override;
 
@@ -50,10 +62,30 @@ class ProfilingListener : public BenchmarkListener {
   std::string csv_file_path_;
 
  private:
+  // The latencies of all the invocations of an operator.
+  struct OperatorLatencies {
+    std::string type;
+    std::vector<int64_t> elapsed_us;
+  };
+
   void WriteOutput(const std::string& header, const string& data,
                    std::ostream* stream);
+  // Records the latency of every operator invocation in `profile_events`.
+  void RecordOperatorLatencies(
+      const std::vector<const profiling::ProfileEvent*>& profile_events);
+  void WriteJsonOutput(std::ostream* stream) const;
+
   Interpreter* interpreter_;
   profiling::BufferedProfiler profiler_;
+
+  std::string json_file_path_;
+  // Keyed by (subgraph index, node index).
+  std::map<std::pair<int64_t, int64_t>, OperatorLatencies> op_latencies_;
+
+  std::unique_ptr<PerfEventCounters> perf_event_counters_;
+  bool perf_event_counters_running_ = false;
+  int num_counted_runs_ = 0;
+  std::map<std::string, uint64_t> perf_event_counter_totals_;
 };
 
 }  // namespace benchmark
@@ -534,6 +534,23 @@ class CsvDatasetTest(test_base.DatasetTestBase, parameterized.TestCase):
     self._test_dataset_on_buffer_sizes(
         inputs, expected, linebreak='\r\n', record_defaults=record_defaults)
 
+  @combinations.generate(test_base.default_test_combinations())
+  def testWithBufferSizeAndQuotedUnselectedCols(self):
+    # The unselected columns at the end of each record are skipped without
+    # parsing them one by one, across buffer boundaries.
+    record_defaults = [['NA']]
+    inputs = [['abc,"\n,\r","d""e"', '0,1,"2\n"', ',"",x']]
+    expected = [['abc'], ['0'], ['NA']]
+    for linebreak in ['\n', '\r', '\r\n']:
+      for buffer_size in list(range(1, 21)) + [None]:
+        self._test_dataset(
+            inputs,
+            expected,
+            linebreak=linebreak,
+            record_defaults=record_defaults,
+            select_cols=[0],
+            buffer_size=buffer_size)
+
   @combinations.generate(test_base.default_test_combinations())
   def testWithGzipCompressionType(self):
     record_defaults = [['NA']] * 3
@@ -28,6 +28,7 @@ from tensorflow.python.eager import cancellation
 from tensorflow.python.eager import context
 from tensorflow.python.eager import def_function
 from tensorflow.python.framework import constant_op
+from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import errors
 from tensorflow.python.framework import ops
 from tensorflow.python.ops import array_ops
@@ -529,6 +530,62 @@ class AllReduceWithSubdivisionsTest(test.TestCase, parameterized.TestCase):
       self.assertAllClose(result, [2.], rtol=1e-5, atol=1e-5)
 
 
+@combinations.generate(
+    combinations.times(
+        combinations.combine(
+            mode='eager', compression=['float16', 'bfloat16']),
+        device_combination))
+class AllReduceWithCompressionTest(test.TestCase, parameterized.TestCase):
+
+  def setUp(self):
+    _setup_context()
+    super().setUp()
+
+  def testReduce(self, device, communication, compression):
+    dev0 = '/device:%s:0' % device
+    dev1 = '/device:%s:1' % device
+
+    @def_function.function
+    def run_all_reduce_2devices():
+      collectives = []
+      for i, dev in enumerate([dev0, dev1]):
+        with ops.device(dev):
+          in_value = constant_op.constant([1.25 * (i + 1), 0.5, -3.])
+          collectives.append(
+              CollectiveOpsV2.all_reduce(
+                  in_value,
+                  group_size=2,
+                  group_key=1,
+                  instance_key=1,
+                  merge_op='Add',
+                  final_op='Div',
+                  communication_hint=communication,
+                  compression=compression))
+      return collectives
+
+    for result in run_all_reduce_2devices():
+      self.assertEqual(result.dtype, dtypes.float32)
+      self.assertAllClose(result, [1.875, 0.5, -3.], rtol=1e-2, atol=1e-2)
+
+  def testIntegerInputIsInvalid(self, device, communication, compression):
+    dev0 = '/device:%s:0' % device
+
+    @def_function.function
+    def run_all_reduce():
+      with ops.device(dev0):
+        return CollectiveOpsV2.all_reduce(
+            constant_op.constant([1, 2]),
+            group_size=1,
+            group_key=1,
+            instance_key=1,
+            communication_hint=communication,
+            compression=compression)
+
+    with self.assertRaisesRegex(errors.InvalidArgumentError,
+                                'requires float or double inputs'):
+      run_all_reduce()
+
+
 @combinations.generate(
     combinations.combine(required_physical_gpus=2, mode='eager'))
 class XlaTest(test.TestCase, parameterized.TestCase):
@@ -359,6 +359,21 @@ class TFRecordWriterZlibTest(TFCompressionTestCase):
     self.assertEqual(actual, original)
 
 
+  def testSnappyReadWrite(self):
+    """Verify that snappy compressed records can be read back."""
+    original = [b"foo", b"bar", _TEXT * 1024]
+    options = tf_record.TFRecordOptions(TFRecordCompressionType.SNAPPY)
+    fn = self._WriteRecordsToFile(
+        original, "snappy_read_write.tfrecord", options=options)
+    self.assertEqual(
+        "SNAPPY",
+        tf_record.TFRecordOptions.get_compression_type_string(options))
+
+    actual = list(tf_record.tf_record_iterator(fn, options=options))
+    self.assertEqual(actual, original)
+    actual = list(tf_record.tf_record_iterator(fn, options="SNAPPY"))
+    self.assertEqual(actual, original)
+
 class TFRecordIteratorTest(TFCompressionTestCase):
   """TFRecordIterator test"""
 
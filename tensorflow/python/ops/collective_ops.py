@@ -42,7 +42,8 @@ def all_reduce(t,
       be done.
     communication_hint: preferred collective communication.  The implementation
       may fall back to another mechanism.  Options include `auto`, `ring`, and
-      `nccl`.
+      `nccl`. `hierarchical` reduces within each task before reducing across
+      the tasks.
     timeout: a float. If set to a non zero, set a completion timeout to detect
       staleness.  If the timer goes off, a DeadlineExceededError is raised.  The
       timeout value in seconds. This feature is experimental.
@@ -102,6 +103,7 @@ def all_reduce_v2(t,
                   timeout=0,
                   ordering_token=None,
                   max_subdivs_per_device=-1,
+                  compression='none',
                   name=None):
   """Reduces tensors collectively, across devices.
 
@@ -118,7 +120,8 @@ def all_reduce_v2(t,
       value.  Can be 'Id' for no operation.
     communication_hint: preferred collective communication.  The implementation
       may fall back to another mechanism.  Options include `auto`, `ring`, and
-      `nccl`.
+      `nccl`. `hierarchical` reduces within each task before reducing across
+      the tasks.
     timeout: a float. If set to a non zero, set a completion timeout to detect
       staleness.  If the timer goes off, a DeadlineExceededError is raised.  The
       timeout value in seconds. This feature is experimental.
@@ -132,6 +135,10 @@ def all_reduce_v2(t,
       parallelize processing of each per-device tensor. Setting to -1 disables
       subdivision and reverts to previous behavior of not sub-dividing tensor.
       Setting to 0 uses sytem defaults.
+    compression: `none`, `float16` or `bfloat16`. With the last two, float32
+      and float64 tensors are cast to that type before they are reduced, which
+      halves the data sent at the cost of precision, and the result is cast
+      back.
     name: name of the Op.
 
   Returns:
@@ -153,6 +160,7 @@ def all_reduce_v2(t,
       timeout_seconds=timeout,
       ordering_token=ordering_token,
       max_subdivs_per_device=max_subdivs_per_device,
+      compression=compression,
       name=name)
 
 
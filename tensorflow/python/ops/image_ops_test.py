@@ -4487,6 +4487,26 @@ class JpegTest(test_util.TensorFlowTestCase):
           result = image_ops.decode_and_crop_jpeg(jpeg0, crop_window)
           self.evaluate(result)
 
+  def testDecodeAndResizeJpeg(self):
+    with self.cached_session():
+      base = "tensorflow/core/lib/jpeg/testdata"
+      jpeg0 = io_ops.read_file(os.path.join(base, "jpeg_merge_test1.jpg"))
+
+      # The image is 256x128. Each size is paired with the largest DCT
+      # downscaling ratio that keeps the decoded image at least that large.
+      for size, ratio in [([256, 128], 1), ([100, 50], 2), ([40, 30], 4),
+                          ([20, 10], 8), ([300, 100], 1)]:
+        # Explicit two stages: decode + resize.
+        image1 = image_ops.decode_jpeg(jpeg0, channels=3, ratio=ratio)
+        image1 = gen_image_ops.resize_bilinear(
+            array_ops.expand_dims(image1, 0), size,
+            half_pixel_centers=True)[0]
+
+        # Combined decode+resize.
+        image2 = gen_image_ops.decode_and_resize_jpeg(jpeg0, size, channels=3)
+        self.assertAllEqual(size + [3], image2.get_shape().as_list())
+        self.assertAllClose(*self.evaluate([image1, image2]), atol=1e-3)
+
   def testSynthetic(self):
     with self.cached_session():
       # Encode it, then decode it, then encode it
@@ -114,6 +114,20 @@ port::StatusOr<cublasLtEpilogue_t> AsCublasLtEpilogue(
 #else
       return port::InternalError(absl::StrCat(
           "CUBLASLT_EPILOGUE_GELU_BIAS epilog requires cublasLt >= 11.4"));
+#endif
+    case BlasLt::Epilogue::kGeLUWithAux:
+#if CUDA_VERSION >= 11040
+      return CUBLASLT_EPILOGUE_GELU_AUX;
+#else
+      return port::InternalError(absl::StrCat(
+          "CUBLASLT_EPILOGUE_GELU_AUX epilog requires cublasLt >= 11.4"));
+#endif
+    case BlasLt::Epilogue::kBiasThenGeLUApproximateWithAux:
+#if CUDA_VERSION >= 11040
+      return CUBLASLT_EPILOGUE_GELU_AUX_BIAS;
+#else
+      return port::InternalError(absl::StrCat(
+          "CUBLASLT_EPILOGUE_GELU_AUX_BIAS epilog requires cublasLt >= 11.4"));
 #endif
   }
 }
@@ -260,7 +274,7 @@ port::Status BlasLt::DoMatmul(Stream* stream, const BlasLt::MatmulPlan& plan,
                               DeviceMemoryBase c, DeviceMemoryBase d,
                               const BlasLt::MatmulAlgorithm& algorithm,
                               ScratchAllocator& scratch_allocator,
-                              DeviceMemoryBase bias,
+                              DeviceMemoryBase bias, DeviceMemoryBase aux,
                               blas::ProfileResult* profile_result) {
   std::unique_ptr<gpu::GpuTimer, gpu::GpuTimerDeleter> timer;
   if (profile_result != nullptr) {
@@ -287,6 +301,24 @@ port::Status BlasLt::DoMatmul(Stream* stream, const BlasLt::MatmulPlan& plan,
                                  CUBLASLT_MATMUL_DESC_BIAS_POINTER,
                                  bias.opaque()));
     }
+#if CUDA_VERSION >= 11040
+    if (aux != nullptr) {
+      TF_RETURN_IF_ERROR(SetAttr(plan.op_desc.get(),
+                                 CUBLASLT_MATMUL_DESC_EPILOGUE_AUX_POINTER,
+                                 aux.opaque()));
+      // The auxiliary output has the same layout as the result.
+      TF_ASSIGN_OR_RETURN(
+          int64_t aux_ld,
+          GetAttr<int64_t>(plan.d_desc.get(), CUBLASLT_MATRIX_LAYOUT_LD));
+      TF_RETURN_IF_ERROR(SetAttr(plan.op_desc.get(),
+                                 CUBLASLT_MATMUL_DESC_EPILOGUE_AUX_LD, aux_ld));
+    }
+#else
+    if (aux != nullptr) {
+      return port::InternalError(
+          "Auxiliary epilogue output requires cublasLt >= 11.4");
+    }
+#endif
 
     gpu::ScopedActivateExecutorContext sac{parent_};
 
@@ -75,8 +75,11 @@ class BlasLt {
     kBias = 4,                      // Add broadcasted bias vector
     kBiasThenReLU = kBias | kReLU,  // Apply bias and then ReLU transform
     kGeLU = 32,  // Apply GELU point-wise transform to the results
+    kGeLUWithAux = 32 | 1024,  // Apply GELU with auxiliary output.
     kBiasThenGeLUApproximate =
         kBias | kGeLU,  // Apply bias and then GeLU Tanh transform
+    kBiasThenGeLUApproximateWithAux =
+        kBiasThenGeLUApproximate | 1024,  // With auxiliary output.
   };
 
   // Describes the location of pointers for the scaling factors alpha and beta.
@@ -159,6 +162,7 @@ class BlasLt {
                         const MatmulAlgorithm& algorithm,
                         ScratchAllocator& scratch_allocator,
                         const DeviceMemory<CD>& bias = {},
+                        const DeviceMemory<CD>& aux = {},
                         blas::ProfileResult* profile_result = nullptr) {
     if (AsCudaDataType(blas::ToDataType<Scale>::value) !=
         plan.op_desc.scale_type()) {
@@ -193,7 +197,7 @@ class BlasLt {
     }
 
     return DoMatmul(stream, plan, alpha.opaque(), a, b, beta.opaque(), c, d,
-                    algorithm, scratch_allocator, bias, profile_result);
+                    algorithm, scratch_allocator, bias, aux, profile_result);
   }
 
  private:
@@ -203,7 +207,7 @@ class BlasLt {
                         DeviceMemoryBase c, DeviceMemoryBase d,
                         const MatmulAlgorithm& algorithm,
                         ScratchAllocator& scratch_allocator,
-                        DeviceMemoryBase bias,
+                        DeviceMemoryBase bias, DeviceMemoryBase aux,
                         blas::ProfileResult* profile_result);
 
   gpu::GpuExecutor* parent_;
@@ -461,9 +461,11 @@ port::Status GpuExecutor::Launch(Stream* stream, const ThreadDim& thread_dims,
   }
 
   if (cuda_kernel->GetPreferredCacheConfig() !=
-      KernelCacheConfig::kNoPreference) {
+          KernelCacheConfig::kNoPreference &&
+      !cuda_kernel->cache_config_applied()) {
     TF_RETURN_IF_ERROR(GpuDriver::FuncSetCacheConfig(
         cufunc, cuda_kernel->GetGpuCacheConfig()));
+    cuda_kernel->set_cache_config_applied();
   }
 
   void** kernel_params = const_cast<void**>(args.argument_addresses().data());
@@ -409,6 +409,40 @@ class GpuDriver {
   // the stream immediately after this returns).
   static bool IsStreamIdle(GpuContext* context, GpuStreamHandle stream);
 
+  // Begins capturing the work enqueued onto stream into a graph instead of
+  // executing it, via cuStreamBeginCapture. Capture is thread-local: other
+  // threads may keep enqueuing work onto their own streams meanwhile.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__STREAM.html
+  static port::Status StreamBeginCapture(GpuContext* context,
+                                         GpuStreamHandle stream);
+
+  // Ends the capture started by StreamBeginCapture and returns the captured
+  // graph, via cuStreamEndCapture. The caller owns the returned graph.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__STREAM.html
+  static port::Status StreamEndCapture(GpuContext* context,
+                                       GpuStreamHandle stream,
+                                       GpuGraphHandle* graph);
+
+  // Instantiates graph into an executable graph, via cuGraphInstantiate. The
+  // caller owns the returned executable graph.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html
+  static port::Status GraphInstantiate(GpuContext* context,
+                                       GpuGraphHandle graph,
+                                       GpuGraphExecHandle* graph_exec);
+
+  // Enqueues graph_exec onto stream, via cuGraphLaunch.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html
+  static port::Status GraphLaunch(GpuContext* context,
+                                  GpuGraphExecHandle graph_exec,
+                                  GpuStreamHandle stream);
+
+  // Destroys graph, via cuGraphDestroy.
+  static port::Status DestroyGraph(GpuContext* context, GpuGraphHandle graph);
+
+  // Destroys graph_exec, via cuGraphExecDestroy.
+  static port::Status DestroyGraphExec(GpuContext* context,
+                                       GpuGraphExecHandle graph_exec);
+
   // Returns whether code in the from context can access memory in the to
   // context via cuDeviceCanAccessPeer.
   // http://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__PEER__ACCESS.html#group__CUDA__PEER__ACCESS_1g496bdaae1f632ebfb695b99d2c40f19e
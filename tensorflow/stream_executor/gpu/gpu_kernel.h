@@ -22,6 +22,8 @@ limitations under the License.
 #ifndef TENSORFLOW_STREAM_EXECUTOR_GPU_GPU_KERNEL_H_
 #define TENSORFLOW_STREAM_EXECUTOR_GPU_GPU_KERNEL_H_
 
+#include <atomic>
+
 #include "tensorflow/stream_executor/gpu/gpu_driver.h"
 #include "tensorflow/stream_executor/kernel_cache_config.h"
 #include "tensorflow/stream_executor/platform/logging.h"
@@ -68,6 +70,7 @@ class GpuKernel : public internal::KernelInterface {
   // configuration preference.
   void SetPreferredCacheConfig(KernelCacheConfig config) override {
     preferred_cache_config_ = config;
+    cache_config_applied_ = false;
   }
 
   // Returns the current kernel cache configuration preference.
@@ -79,12 +82,18 @@ class GpuKernel : public internal::KernelInterface {
   // CUfunc_cache.
   GpuFuncCachePreference GetGpuCacheConfig() const;
 
+  // Whether the preferred cache configuration has been applied to the
+  // function since it was last set. Lets launches skip the driver call.
+  bool cache_config_applied() const { return cache_config_applied_; }
+  void set_cache_config_applied() const { cache_config_applied_ = true; }
+
  private:
   GpuFunctionHandle gpu_function_;  // Wrapped CUDA kernel handle.
   unsigned arity_;  // Number of formal parameters the kernel takes.
 
   // Preferred (but not required) cache configuration for this kernel.
   KernelCacheConfig preferred_cache_config_;
+  mutable std::atomic<bool> cache_config_applied_{false};
 };
 
 // Given a platform-independent kernel datatype, returns the (const) internal
@@ -494,6 +494,62 @@ class KernelArgsArray : public KernelArgsArrayBase {
   size_t number_of_generic_arguments_ = 0;
 };
 
+// A list of device memory arguments for repeated calls of one kernel.
+//
+// The number of arguments is fixed at construction, and the argument addresses
+// handed to the platform never change. Rebinding the arguments for the next
+// launch only overwrites the device pointers, so unlike KernelArgsArray,
+// repeated launches don't repack or reallocate anything. This is meant for
+// launchers that keep one array per loaded kernel, e.g., XLA's kernel thunks.
+class KernelArgsDeviceMemoryArray : public KernelArgsArrayBase {
+ public:
+  explicit KernelArgsDeviceMemoryArray(size_t number_of_arguments)
+      : device_memory_opaque_pointers_(number_of_arguments),
+        argument_addresses_(number_of_arguments),
+        argument_sizes_(number_of_arguments, sizeof(void *)) {
+    for (size_t i = 0; i < number_of_arguments; ++i) {
+      argument_addresses_[i] = &device_memory_opaque_pointers_[i];
+    }
+  }
+
+  KernelArgsDeviceMemoryArray(const KernelArgsDeviceMemoryArray &) = delete;
+  KernelArgsDeviceMemoryArray &operator=(const KernelArgsDeviceMemoryArray &) =
+      delete;
+
+  // Rebinds the arguments to `args`, which must have as many elements as there
+  // are arguments.
+  void Bind(port::ArraySlice<DeviceMemoryBase> args) {
+    CHECK_EQ(args.size(), device_memory_opaque_pointers_.size());
+    for (size_t i = 0; i < args.size(); ++i) {
+      device_memory_opaque_pointers_[i] = args[i].opaque();
+    }
+  }
+
+  size_t number_of_arguments() const override {
+    return argument_addresses_.size();
+  }
+
+  uint64_t number_of_shared_bytes() const override { return 0; }
+
+  port::ArraySlice<const void *> argument_addresses() const override {
+    return port::ArraySlice<const void *>(argument_addresses_.data(),
+                                          argument_addresses_.size());
+  }
+
+  KernelArgIterator arg_iterator() const override {
+    return KernelArgIterator(argument_addresses_.size(),
+                             /*number_of_shared_memory_arguments=*/0,
+                             argument_addresses_.data(), argument_sizes_.data(),
+                             /*shmem_bytes_data=*/nullptr,
+                             /*shmem_indices_data=*/nullptr);
+  }
+
+ private:
+  std::vector<const void *> device_memory_opaque_pointers_;
+  std::vector<const void *> argument_addresses_;
+  std::vector<size_t> argument_sizes_;
+};
+
 // Typed variant of KernelBase, like a typed device function pointer. See the
 // file comment for details and example usage.
 //
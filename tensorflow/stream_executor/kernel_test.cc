@@ -0,0 +1,105 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/stream_executor/kernel.h"
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/stream_executor/device_memory.h"
+
+namespace stream_executor {
+namespace {
+
+std::vector<DeviceMemoryBase> MakeArgs(int n, int offset) {
+  std::vector<DeviceMemoryBase> args;
+  for (int i = 0; i < n; ++i) {
+    args.push_back(
+        DeviceMemoryBase(reinterpret_cast<void *>(0x1000 * (i + offset)), 4));
+  }
+  return args;
+}
+
+TEST(KernelArgsDeviceMemoryArrayTest, Rebind) {
+  KernelArgsDeviceMemoryArray kernel_args(3);
+  EXPECT_EQ(kernel_args.number_of_arguments(), 3);
+  EXPECT_EQ(kernel_args.number_of_shared_bytes(), 0);
+
+  kernel_args.Bind(MakeArgs(3, /*offset=*/1));
+  port::ArraySlice<const void *> addresses = kernel_args.argument_addresses();
+  ASSERT_EQ(addresses.size(), 3);
+  EXPECT_EQ(*static_cast<void *const *>(addresses[1]),
+            reinterpret_cast<void *>(0x2000));
+
+  // Rebinding keeps the argument addresses, and only changes the values.
+  kernel_args.Bind(MakeArgs(3, /*offset=*/5));
+  EXPECT_EQ(kernel_args.argument_addresses().data(), addresses.data());
+  EXPECT_EQ(*static_cast<void *const *>(addresses[1]),
+            reinterpret_cast<void *>(0x6000));
+}
+
+TEST(KernelArgsDeviceMemoryArrayTest, MatchesKernelArgsArray) {
+  std::vector<DeviceMemoryBase> args = MakeArgs(4, /*offset=*/1);
+  KernelArgsArray<4> packed;
+  for (const DeviceMemoryBase &arg : args) {
+    packed.add_device_memory_argument(arg);
+  }
+  KernelArgsDeviceMemoryArray bound(4);
+  bound.Bind(args);
+
+  KernelArgIterator packed_it = packed.arg_iterator();
+  KernelArgIterator bound_it = bound.arg_iterator();
+  while (packed_it.has_next()) {
+    ASSERT_TRUE(bound_it.has_next());
+    KernelArg packed_arg = packed_it.next();
+    KernelArg bound_arg = bound_it.next();
+    EXPECT_EQ(bound_arg.is_shared, packed_arg.is_shared);
+    EXPECT_EQ(bound_arg.size, packed_arg.size);
+    EXPECT_EQ(*static_cast<void *const *>(bound_arg.address),
+              *static_cast<void *const *>(packed_arg.address));
+  }
+  EXPECT_FALSE(bound_it.has_next());
+}
+
+// Per-launch argument packing cost, as done by XLA before each launch.
+void BM_PackKernelArgsArray(::testing::benchmark::State &state) {
+  std::vector<DeviceMemoryBase> args = MakeArgs(state.range(0), 1);
+  for (auto s : state) {
+    auto kernel_args = std::make_unique<KernelArgsArray<64>>();
+    for (const DeviceMemoryBase &arg : args) {
+      kernel_args->add_device_memory_argument(arg);
+    }
+    tensorflow::testing::DoNotOptimize(
+        kernel_args->argument_addresses().data());
+  }
+}
+
+// Per-launch argument cost when the arguments array is kept per kernel.
+void BM_BindKernelArgsDeviceMemoryArray(::testing::benchmark::State &state) {
+  std::vector<DeviceMemoryBase> args = MakeArgs(state.range(0), 1);
+  KernelArgsDeviceMemoryArray kernel_args(args.size());
+  for (auto s : state) {
+    kernel_args.Bind(args);
+    tensorflow::testing::DoNotOptimize(kernel_args.argument_addresses().data());
+  }
+}
+
+BENCHMARK(BM_PackKernelArgsArray)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK(BM_BindKernelArgsDeviceMemoryArray)->Arg(4)->Arg(16)->Arg(64);
+
+}  // namespace
+}  // namespace stream_executor
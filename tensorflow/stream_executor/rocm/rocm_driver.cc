@@ -840,6 +840,44 @@ GpuDriver::ContextGetSharedMemConfig(GpuContext* context) {
   return false;
 }
 
+/* static */ port::Status GpuDriver::StreamBeginCapture(
+    GpuContext* context, GpuStreamHandle stream) {
+  return port::Status{port::error::UNIMPLEMENTED,
+                      "Stream capture is not supported on ROCm"};
+}
+
+/* static */ port::Status GpuDriver::StreamEndCapture(GpuContext* context,
+                                                      GpuStreamHandle stream,
+                                                      GpuGraphHandle* graph) {
+  return port::Status{port::error::UNIMPLEMENTED,
+                      "Stream capture is not supported on ROCm"};
+}
+
+/* static */ port::Status GpuDriver::GraphInstantiate(
+    GpuContext* context, GpuGraphHandle graph, GpuGraphExecHandle* graph_exec) {
+  return port::Status{port::error::UNIMPLEMENTED,
+                      "Graphs are not supported on ROCm"};
+}
+
+/* static */ port::Status GpuDriver::GraphLaunch(GpuContext* context,
+                                                 GpuGraphExecHandle graph_exec,
+                                                 GpuStreamHandle stream) {
+  return port::Status{port::error::UNIMPLEMENTED,
+                      "Graphs are not supported on ROCm"};
+}
+
+/* static */ port::Status GpuDriver::DestroyGraph(GpuContext* context,
+                                                  GpuGraphHandle graph) {
+  return port::Status{port::error::UNIMPLEMENTED,
+                      "Graphs are not supported on ROCm"};
+}
+
+/* static */ port::Status GpuDriver::DestroyGraphExec(
+    GpuContext* context, GpuGraphExecHandle graph_exec) {
+  return port::Status{port::error::UNIMPLEMENTED,
+                      "Graphs are not supported on ROCm"};
+}
+
 /* static */ port::Status GpuDriver::SynchronousMemcpyD2H(
     GpuContext* context, void* host_dst, hipDeviceptr_t gpu_src,
     uint64_t size) {
@@ -318,9 +318,11 @@ port::Status GpuExecutor::Launch(Stream* stream, const ThreadDim& thread_dims,
   }
 
   if (rocm_kernel->GetPreferredCacheConfig() !=
-      KernelCacheConfig::kNoPreference) {
+          KernelCacheConfig::kNoPreference &&
+      !rocm_kernel->cache_config_applied()) {
     TF_RETURN_IF_ERROR(GpuDriver::FuncSetCacheConfig(
         hipfunc, rocm_kernel->GetGpuCacheConfig()));
+    rocm_kernel->set_cache_config_applied();
   }
 
   // prepare kernargs